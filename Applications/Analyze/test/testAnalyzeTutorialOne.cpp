@@ -33,6 +33,7 @@ int main()
 {
     try {
         AnalyzeTool analyze1("PlotterTool.xml");
+        const string statesFileName = analyze1.getStatesFileName();
         analyze1.getModel().print("testAnalyzeTutorialOne.osim");
         analyze1.run();
         /* Once this runs to completion we'll make the test more meaningful by comparing output 
@@ -53,6 +54,21 @@ int main()
         CHECK_STORAGE_AGAINST_STANDARD(resultFiberLengthHip45, 
             standardFiberLength45, std::vector<double>(100, 0.0001),
             __FILE__, __LINE__, "testAnalyzeTutorialOne at Hip45 failed");
+
+        // Analyzing the frames on several threads gives the same results.
+        AnalyzeTool analyze2("PlotterTool.xml");
+        analyze2.setStatesFileName(statesFileName);
+        analyze2.setName("BothLegsParallel");
+        analyze2.setNumThreads(3);
+        analyze2.run();
+        Storage resultFiberLengthParallel(
+            "testPlotterTool/BothLegsParallel__FiberLength.sto");
+        ASSERT(resultFiberLengthParallel.getSize() ==
+               resultFiberLength.getSize(), __FILE__, __LINE__,
+               "Expected the same number of frames from several threads.");
+        CHECK_STORAGE_AGAINST_STANDARD(resultFiberLengthParallel,
+            standardFiberLength, std::vector<double>(100, 0.0001),
+            __FILE__, __LINE__, "testAnalyzeTutorialOne on threads failed");
         cout << "testAnalyzeTutorialOne passed" << endl;
     }
     catch (const exception& e) {
@@ -29,6 +29,7 @@
 #include <OpenSim/Tools/AnalyzeTool.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Analyses/InducedAccelerationsSolver.h>
+#include <OpenSim/Analyses/InducedAccelerations.h>
 
 using namespace OpenSim;
 using namespace SimTK;
@@ -37,6 +38,7 @@ using namespace std;
 // Prototypes
 void testDoublePendulumWithSolver();
 void testDoublePendulum();
+void testSharedFactorizationMatchesPerContributor();
 Vector calcDoublePendulumUdot(const Model &model, State &s, double Torq1, double Torq2, bool gravity, bool velocity);
 
 int main()
@@ -56,6 +58,8 @@ int main()
             std::vector<double>(result1.getSmallestNumberOfStates(), 0.15),
             __FILE__, __LINE__, "Induced Accelerations of Running failed");
         cout << "Induced Accelerations of Running passed\n" << endl;
+
+        testSharedFactorizationMatchesPerContributor();
     }
     catch (const OpenSim::Exception& e) {
         e.print(cerr);
@@ -65,6 +69,36 @@ int main()
     return 0;
 }
 
+void testSharedFactorizationMatchesPerContributor()
+{
+    // Reporting the constraint reactions solves the constrained system for
+    // each contributor separately, as all contributors were solved before
+    // they shared one factorization of the constraints per frame.
+    auto runIAA = [](bool reportConstraintReactions, const string& resultsDir) {
+        AnalyzeTool analyze("subject02_Setup_IAA_02_232.xml");
+        analyze.setResultsDir(resultsDir);
+        auto& iaa = dynamic_cast<InducedAccelerations&>(
+            analyze.getAnalysisSet().get("InducedAccelerations"));
+        iaa.setReportConstraintReactions(reportConstraintReactions);
+        analyze.run();
+        return Storage(resultsDir + "/subject02_running_arms_"
+            "InducedAccelerations_center_of_mass.sto");
+    };
+    Storage shared = runIAA(false, "ResultsInducedAccelerations_Shared");
+    Storage perContributor =
+        runIAA(true, "ResultsInducedAccelerations_PerContributor");
+
+    ASSERT(shared.getSize() == perContributor.getSize(), __FILE__, __LINE__,
+        "Induced Accelerations with a shared factorization produced a "
+        "different number of frames.");
+    CHECK_STORAGE_AGAINST_STANDARD(shared, perContributor,
+        std::vector<double>(shared.getSmallestNumberOfStates(), 1e-6),
+        __FILE__, __LINE__,
+        "Induced Accelerations with a shared factorization failed");
+    cout << "Induced Accelerations with a shared factorization passed\n"
+         << endl;
+}
+
 void testDoublePendulumWithSolver()
 {
     std::clock_t startTime = std::clock();
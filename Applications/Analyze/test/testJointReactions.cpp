@@ -28,6 +28,12 @@
 using namespace OpenSim;
 using namespace std;
 
+// Verify that the reactions computed for all the joints at once match those
+// computed joint by joint, on the child and on the parent.
+void testAllJointsAtOnceMatchPerJoint();
+// Verify that the forces of the forces_file are applied to the actuators.
+void testForcesFileOverridesActuators();
+
 int main()
 {
     try {
@@ -46,6 +52,12 @@ int main()
             std::vector<double>(standard2.getSmallestNumberOfStates(), 1e-5), __FILE__, __LINE__,
             "DoublePendulum3D failed");
         cout << "DoublePendulum3D passed" << endl;
+
+        testAllJointsAtOnceMatchPerJoint();
+        cout << "testAllJointsAtOnceMatchPerJoint passed" << endl;
+
+        testForcesFileOverridesActuators();
+        cout << "testForcesFileOverridesActuators passed" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -54,3 +66,179 @@ int main()
     cout << "Done" << endl;
     return 0;
 }
+
+// Compute the reaction of a joint on its child or parent, expressed in the
+// given frame, one joint at a time as JointReaction used to.
+static void calcReactionPerJoint(const Model& model, const SimTK::State& s,
+        const Joint& joint, bool onChild, const Frame& inFrame,
+        SimTK::Vec3& force, SimTK::Vec3& moment, SimTK::Vec3& point)
+{
+    const Ground& ground = model.getGround();
+    SimTK::SpatialVec reaction = onChild ?
+        joint.calcReactionOnChildExpressedInGround(s) :
+        joint.calcReactionOnParentExpressedInGround(s);
+    SimTK::Vec3 pointInGround = onChild ?
+        joint.getChildFrame().getTransformInGround(s).p() :
+        joint.getParentFrame().getTransformInGround(s).p();
+    force = ground.expressVectorInAnotherFrame(s, reaction[1], inFrame);
+    moment = ground.expressVectorInAnotherFrame(s, reaction[0], inFrame);
+    point = ground.findStationLocationInAnotherFrame(s, pointInGround, inFrame);
+}
+
+// Check the reaction loads reported by the analysis against the reactions
+// computed joint by joint at the given states.
+static void checkAgainstPerJoint(const Model& model,
+        const vector<SimTK::State>& states, const Storage& result,
+        const vector<string>& jointNames, const vector<bool>& onChild,
+        const vector<string>& inFrames)
+{
+    ASSERT(result.getSize() == (int)states.size(), __FILE__, __LINE__,
+        "JointReaction recorded a different number of frames.");
+    for (int i = 0; i < result.getSize(); ++i) {
+        const Array<double>& row = result.getStateVector(i)->getData();
+        for (size_t j = 0; j < jointNames.size(); ++j) {
+            SimTK::Vec3 force, moment, point;
+            calcReactionPerJoint(model, states[i],
+                model.getJointSet().get(jointNames[j]), onChild[j],
+                model.getComponent<Frame>(inFrames[j]), force, moment, point);
+            for (int k = 0; k < 3; ++k) {
+                ASSERT_EQUAL(force[k], row[9*(int)j+k], 1e-8,
+                    __FILE__, __LINE__, "Reaction force differs.");
+                ASSERT_EQUAL(moment[k], row[9*(int)j+k+3], 1e-8,
+                    __FILE__, __LINE__, "Reaction moment differs.");
+                ASSERT_EQUAL(point[k], row[9*(int)j+k+6], 1e-8,
+                    __FILE__, __LINE__, "Point of application differs.");
+            }
+        }
+    }
+}
+
+// Run the analysis directly on the given states and read back its results.
+static Storage runJointReaction(JointReaction& jr, vector<SimTK::State>& states,
+        const string& baseName)
+{
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (i == 0) jr.begin(states[i]);
+        else jr.step(states[i], (int)i);
+    }
+    IO::SetPrecision(20);
+    jr.printResults(baseName);
+    return Storage(baseName + "_" + jr.getName() + "_ReactionLoads.sto");
+}
+
+void testAllJointsAtOnceMatchPerJoint()
+{
+    Model model("DoublePendulum3D.osim");
+    JointReaction* jr = new JointReaction();
+    jr->setName("JointReaction");
+    Array<string> jointNames("", 4), onBody("", 4), inFrame("", 4);
+    const vector<string> joints{"pin1", "pin2", "pin1", "pin2"};
+    const vector<bool> onChild{true, true, false, false};
+    const vector<string> frames{"rod1", "ground", "ground", "rod2"};
+    for (int j = 0; j < 4; ++j) {
+        jointNames[j] = joints[j];
+        onBody[j] = onChild[j] ? "child" : "parent";
+        inFrame[j] = frames[j];
+    }
+    jr->setJointNames(jointNames);
+    jr->setOnBody(onBody);
+    jr->setInFrame(inFrame);
+    model.addAnalysis(jr);
+    SimTK::State& s = model.initSystem();
+    jr->setModel(model);
+
+    Storage statesStore("DoublePendulum3D_states.sto");
+    const CoordinateSet& coords = model.getCoordinateSet();
+    vector<SimTK::State> states;
+    for (int i = 0; i < statesStore.getSize(); i += 10) {
+        const StateVector& row = *statesStore.getStateVector(i);
+        s.updTime() = row.getTime();
+        for (int c = 0; c < coords.getSize(); ++c) {
+            const string& name = coords[c].getName();
+            coords[c].setValue(s,
+                row.getData()[statesStore.getStateIndex(name)], false);
+            coords[c].setSpeedValue(s,
+                row.getData()[statesStore.getStateIndex(name + "_u")]);
+        }
+        model.realizeAcceleration(s);
+        states.push_back(s);
+    }
+
+    Storage result = runJointReaction(*jr, states,
+        "DoublePendulum3D_AllJointsAtOnce");
+    checkAgainstPerJoint(model, states, result, joints, onChild, frames);
+}
+
+void testForcesFileOverridesActuators()
+{
+    // Forces that differ from those of the model's (zero) controls.
+    const string forcesFile = "double_pendulum_JointReaction_forces.sto";
+    const double torq1 = 10.0, torq2 = -5.0;
+    {
+        Storage forces;
+        Array<string> labels;
+        labels.append("time");
+        labels.append("Torq1");
+        labels.append("Torq2");
+        forces.setColumnLabels(labels);
+        const double values[] = {torq1, torq2};
+        forces.append(0.0, 2, values);
+        forces.append(1.0, 2, values);
+        forces.print(forcesFile);
+    }
+
+    Model model("double_pendulum.osim");
+    JointReaction* jr = new JointReaction();
+    jr->setName("JointReaction");
+    jr->setForcesFileName(forcesFile);
+    model.addAnalysis(jr);
+    SimTK::State& s = model.initSystem();
+    jr->setModel(model);
+
+    const CoordinateSet& coords = model.getCoordinateSet();
+    vector<SimTK::State> states, statesWithForces;
+    for (int i = 0; i < 5; ++i) {
+        s.updTime() = 0.25*i;
+        coords[0].setValue(s, 0.3*i - 0.5, false);
+        coords[1].setValue(s, 0.2*i, false);
+        coords[0].setSpeedValue(s, 1.0 - 0.4*i);
+        coords[1].setSpeedValue(s, 0.5*i);
+        model.realizeAcceleration(s);
+        states.push_back(s);
+
+        SimTK::State sWithForces = s;
+        const Set<Actuator>& actuators = model.getActuators();
+        const double values[] = {torq1, torq2};
+        for (int a = 0; a < 2; ++a) {
+            const auto& act = dynamic_cast<const ScalarActuator&>(
+                actuators.get(a == 0 ? "Torq1" : "Torq2"));
+            act.overrideActuation(sWithForces, true);
+            act.setOverrideActuation(sWithForces, values[a]);
+        }
+        model.realizeAcceleration(sWithForces);
+        statesWithForces.push_back(sWithForces);
+    }
+
+    Storage result = runJointReaction(*jr, states,
+        "double_pendulum_ForcesFile");
+
+    vector<string> joints, frames;
+    for (int j = 0; j < model.getJointSet().getSize(); ++j) {
+        joints.push_back(model.getJointSet()[j].getName());
+        frames.push_back("ground");
+    }
+    const vector<bool> onChild(joints.size(), true);
+    checkAgainstPerJoint(model, statesWithForces, result,
+        joints, onChild, frames);
+
+    // The forces must make a difference, or the test above would pass even
+    // if the actuators were not overridden.
+    SimTK::Vec3 force, moment, point, forceWithForces;
+    calcReactionPerJoint(model, states.back(), model.getJointSet()[0], true,
+        model.getGround(), force, moment, point);
+    calcReactionPerJoint(model, statesWithForces.back(),
+        model.getJointSet()[0], true, model.getGround(),
+        forceWithForces, moment, point);
+    ASSERT((force - forceWithForces).norm() > 1e-3, __FILE__, __LINE__,
+        "The forces of the forces file do not change the reactions.");
+}
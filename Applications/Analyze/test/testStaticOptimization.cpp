@@ -42,6 +42,10 @@ void testLapackErrorDLASD4();
 
 void testModelWithPassiveForces();
 
+void testQuadraticProgramMatchesOptimizer();
+
+void testParallelMatchesSerial();
+
 int main()
 {
     Array<string> muscleModelNames;
@@ -77,6 +81,22 @@ int main()
         failures.push_back("testModelWithPassiveForces");
     }
     
+    try {
+        testQuadraticProgramMatchesOptimizer();
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testQuadraticProgramMatchesOptimizer");
+    }
+
+    try {
+        testParallelMatchesSerial();
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testParallelMatchesSerial");
+    }
+
     try {
         testLapackErrorDLASD4();
     }
@@ -200,6 +220,93 @@ void testModelWithPassiveForces() {
 
 }
 
+void testQuadraticProgramMatchesOptimizer() {
+    // With an activation exponent of 2, the frames are solved directly as
+    // quadratic programs; the general optimizer must find the same solution.
+    auto runSO = [](bool useQuadraticProgram, const string& resultsDir) {
+        AnalyzeTool analyze("arm26_Setup_StaticOptimization.xml");
+        analyze.setResultsDir(resultsDir);
+        auto& so = dynamic_cast<StaticOptimization&>(
+            analyze.getAnalysisSet().get("StaticOptimization"));
+        so.setUseQuadraticProgram(useQuadraticProgram);
+        so.setConvergenceCriterion(1e-6);
+        so.setMaxIterations(1000);
+        analyze.run();
+    };
+    runSO(true, "Results_arm26_QuadraticProgram");
+    runSO(false, "Results_arm26_Optimizer");
+
+    Storage qpActivations(
+        "Results_arm26_QuadraticProgram/arm26_StaticOptimization_activation.sto");
+    Storage activations(
+        "Results_arm26_Optimizer/arm26_StaticOptimization_activation.sto");
+    Storage qpForces(
+        "Results_arm26_QuadraticProgram/arm26_StaticOptimization_force.sto");
+    Storage forces(
+        "Results_arm26_Optimizer/arm26_StaticOptimization_force.sto");
+
+    ASSERT(qpActivations.getSize() == activations.getSize(),
+        __FILE__, __LINE__, "Quadratic program solved a different number "
+        "of frames than the optimizer.");
+
+    CHECK_STORAGE_AGAINST_STANDARD(qpActivations, activations,
+        std::vector<double>(6, 1e-3),
+        __FILE__, __LINE__,
+        "Arm26 quadratic program activations differ from the optimizer's.");
+
+    CHECK_STORAGE_AGAINST_STANDARD(qpForces, forces,
+        std::vector<double>(6, 1.0),
+        __FILE__, __LINE__,
+        "Arm26 quadratic program forces differ from the optimizer's.");
+    cout << "testQuadraticProgramMatchesOptimizer passed." << endl;
+}
+
+void testParallelMatchesSerial() {
+    // Solving the frames in chunks on several threads must give the same
+    // solution, in the same order, as solving them one after the other.
+    auto runSO = [](int numThreads, const string& resultsDir) {
+        AnalyzeTool analyze("arm26_Setup_StaticOptimization.xml");
+        analyze.setResultsDir(resultsDir);
+        auto& so = dynamic_cast<StaticOptimization&>(
+            analyze.getAnalysisSet().get("StaticOptimization"));
+        so.setNumThreads(numThreads);
+        analyze.run();
+    };
+    runSO(1, "Results_arm26_serial");
+    runSO(4, "Results_arm26_parallel");
+
+    Storage serialActivations(
+        "Results_arm26_serial/arm26_StaticOptimization_activation.sto");
+    Storage activations(
+        "Results_arm26_parallel/arm26_StaticOptimization_activation.sto");
+    Storage serialForces(
+        "Results_arm26_serial/arm26_StaticOptimization_force.sto");
+    Storage forces(
+        "Results_arm26_parallel/arm26_StaticOptimization_force.sto");
+
+    ASSERT(activations.getSize() == serialActivations.getSize(),
+        __FILE__, __LINE__, "Parallel static optimization solved a "
+        "different number of frames than serial static optimization.");
+
+    Array<double> serialTime, time;
+    serialActivations.getTimeColumn(serialTime);
+    activations.getTimeColumn(time);
+    for (int i = 0; i < serialTime.getSize(); ++i)
+        ASSERT_EQUAL(serialTime[i], time[i], SimTK::Eps, __FILE__, __LINE__,
+            "Parallel static optimization frames are out of order.");
+
+    CHECK_STORAGE_AGAINST_STANDARD(activations, serialActivations,
+        std::vector<double>(6, 1e-4),
+        __FILE__, __LINE__,
+        "Arm26 parallel activations differ from the serial ones.");
+
+    CHECK_STORAGE_AGAINST_STANDARD(forces, serialForces,
+        std::vector<double>(6, 0.1),
+        __FILE__, __LINE__,
+        "Arm26 parallel forces differ from the serial ones.");
+    cout << "testParallelMatchesSerial passed." << endl;
+}
+
 void testLapackErrorDLASD4() {
     // With OpenSim 3.2 64bit, the 64 bit lapack library (in Simbody 3.3.1) 
     // crashes with an error[1] if there are not enough actuators (or under 
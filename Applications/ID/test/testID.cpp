@@ -51,6 +51,20 @@ int main()
             std::vector<double>(23, 2.0), __FILE__, __LINE__,
             "testGait failed");
         cout << "testGait passed" << endl;
+
+        // Solving the frames on several threads must give the same
+        // generalized forces as solving them serially.
+        InverseDynamicsTool id3("subject01_Setup_InverseDynamics.xml");
+        id3.setOutputGenForceFileName("subject01_InverseDynamics_parallel");
+        id3.setNumThreads(4);
+        id3.run();
+        Storage result3("Results/subject01_InverseDynamics_parallel.sto");
+        ASSERT(result3.getSize() == result2.getSize(), __FILE__, __LINE__,
+            "Parallel ID produced a different number of frames than serial ID.");
+        CHECK_STORAGE_AGAINST_STANDARD(result3, result2,
+            std::vector<double>(23, 1e-6), __FILE__, __LINE__,
+            "testGaitParallel failed");
+        cout << "testGaitParallel passed" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
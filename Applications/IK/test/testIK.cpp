@@ -23,11 +23,17 @@
 
 
 // INCLUDES
+#include <fstream>
+#include <memory>
 #include <string>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/ScaleSet.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Tools/InverseAnalysisPipeline.h>
+#include <OpenSim/Analyses/Kinematics.h>
 #include <OpenSim/Tools/IKTaskSet.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
@@ -36,6 +42,7 @@ using namespace std;
 
 void testMarkerWeightAssignments(const std::string& ikSetupFile);
 void checkMarkersReferenceConsistencyFromTool(InverseKinematicsTool& ik);
+void testInverseAnalysisPipeline();
 
 int main()
 {
@@ -65,6 +72,9 @@ int main()
         InverseKinematicsTool ik3("constraintTest_setup_ik.xml");
         ik3.run();
         cout << "testInverseKinematicsCosntraintTest passed" << endl;
+
+        testInverseAnalysisPipeline();
+        cout << "testInverseAnalysisPipeline passed" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -168,3 +178,62 @@ void checkMarkersReferenceConsistencyFromTool(InverseKinematicsTool& ik)
         }
     }
 }
+
+void testInverseAnalysisPipeline()
+{
+    // Inverse dynamics on the motion in memory gives the same generalized
+    // forces as on the motion written by the tool.
+    auto makeInverseDynamicsTool = [](const std::string& outputFile) {
+        InverseDynamicsTool* id = new InverseDynamicsTool();
+        id->setName("pipeline");
+        id->setResultsDir("pipeline_results");
+        id->setOutputGenForceFileName(outputFile);
+        id->setLowpassCutoffFrequency(6);
+        id->setStartTime(0.5);
+        id->setEndTime(1.5);
+        return std::unique_ptr<InverseDynamicsTool>(id);
+    };
+
+    InverseKinematicsTool ik("subject01_Setup_InverseKinematics.xml");
+    ik.setOutputMotionFileName("subject01_walk1_ik_pipeline.mot");
+    auto id = makeInverseDynamicsTool("pipeline_id.sto");
+
+    AnalyzeTool analyze;
+    analyze.setName("pipeline");
+    analyze.setResultsDir("pipeline_results");
+    analyze.setLowpassCutoffFrequency(6);
+    analyze.setInitialTime(0.5);
+    analyze.setFinalTime(1.5);
+    analyze.getAnalysisSet().adoptAndAppend(new Kinematics());
+
+    InverseAnalysisPipeline pipeline;
+    pipeline.setInverseKinematicsTool(ik);
+    pipeline.setInverseDynamicsTool(id.get());
+    pipeline.setAnalyzeTool(&analyze);
+    pipeline.run();
+
+    Storage standard("std_subject01_walk1_ik.mot");
+    Storage motion(pipeline.getMotion());
+    CHECK_STORAGE_AGAINST_STANDARD(motion, standard,
+        std::vector<double>(24, 0.2), __FILE__, __LINE__,
+        "testInverseAnalysisPipeline: motion differs from standard");
+    // The cutoff frequencies are restored after filtering once.
+    ASSERT(id->getLowpassCutoffFrequency() == 6);
+    ASSERT(analyze.getLowpassCutoffFrequency() == 6);
+
+    Model model("subject01_simbody.osim");
+    auto idFromFile = makeInverseDynamicsTool("file_id.sto");
+    idFromFile->setModel(model);
+    idFromFile->setCoordinatesFileName("subject01_walk1_ik_pipeline.mot");
+    idFromFile->run();
+
+    Storage fromPipeline("pipeline_results/pipeline_id.sto");
+    Storage fromFile("pipeline_results/file_id.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(fromPipeline, fromFile,
+        std::vector<double>(fromFile.getColumnLabels().getSize(), 1e-2),
+        __FILE__, __LINE__,
+        "testInverseAnalysisPipeline: inverse dynamics results differ");
+
+    std::ifstream kinematics("pipeline_results/pipeline_Kinematics_q.sto");
+    ASSERT(kinematics.good());
+}
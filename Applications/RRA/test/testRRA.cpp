@@ -33,6 +33,9 @@ using namespace std;
 void checkCOM(string resultsFile, string body, 
                 const SimTK::Vec3 &standardCOM, 
                 const Array<double> &tolerances);
+// Verify that a two-pass run matches running RRA again on the results of
+// the first run.
+void testTwoPassesMatchSecondRun();
 
 int main() {
     try {
@@ -50,6 +53,7 @@ int main() {
         else{
             throw(Exception("testRRA FAILED to run to completion."));
         }
+        testTwoPassesMatchSecondRun();
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -73,3 +77,45 @@ void checkCOM(string resultsFile, string body, const SimTK::Vec3 &standardCOM, c
     for (int i = 0; i < 3; ++i)
         ASSERT_EQUAL(standardCOM[i], com[i], tolerances[i]);
 }
+
+void testTwoPassesMatchSecondRun() {
+    const string setup = "subject01_Setup_RRA.xml";
+
+    // Run RRA again as users did before number_of_passes, on the model and
+    // the kinematics produced by the first run in main().
+    RRATool second(setup, false);
+    second.setModelFilename("subject01_RRA_adjusted.osim");
+    second.loadModel(setup);
+    second.updateModelForces(second.getModel(), setup);
+    second.setModel(second.getModel());
+    second.setToolOwnsModel(true);
+    second.setDesiredKinematicsFileName(
+        "ResultsRRA/subject01_walk1_RRA_Kinematics_q.sto");
+    second.setResultsDir("ResultsRRA_SecondRun");
+    second.setOutputModelFileName("subject01_RRA_adjusted_second_run.osim");
+    if (!second.run())
+        throw Exception("testRRA: second run FAILED to run to completion.");
+
+    RRATool twoPasses(setup);
+    twoPasses.setNumberOfPasses(2);
+    twoPasses.setResultsDir("ResultsRRA_TwoPasses");
+    twoPasses.setOutputModelFileName("subject01_RRA_adjusted_two_passes.osim");
+    if (!twoPasses.run())
+        throw Exception("testRRA: two passes FAILED to run to completion.");
+
+    Model secondModel("subject01_RRA_adjusted_second_run.osim");
+    const SimTK::Vec3& secondCOM =
+        secondModel.getBodySet().get("torso").getMassCenter();
+    checkCOM("subject01_RRA_adjusted_two_passes.osim", "torso", secondCOM,
+             Array<double>(1e-4, 3));
+
+    Storage result("ResultsRRA_TwoPasses/subject01_walk1_RRA_Kinematics_q.sto"),
+            standard("ResultsRRA_SecondRun/subject01_walk1_RRA_Kinematics_q.sto");
+    ASSERT(result.getSize() == standard.getSize(), __FILE__, __LINE__,
+        "testRRA: two passes produced a different number of frames than a "
+        "second run.");
+    CHECK_STORAGE_AGAINST_STANDARD(result, standard,
+        std::vector<double>(24, 0.05),
+        __FILE__, __LINE__, "testRRA: two passes differ from a second run");
+    cout << "testTwoPassesMatchSecondRun passed" << endl;
+}
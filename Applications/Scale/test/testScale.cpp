@@ -134,6 +134,22 @@ void scaleGait2354()
     Model model(setupFilePath + "subject01_simbody.osim");
     compareModelMarkers(model, "std_subject01_simbody.osim", 1.0e-6);
 
+    // Scale a copy of a generic model that was processed beforehand, as
+    // when scaling many subjects.
+    file2Remove = IO::OpenFile(setupFilePath+"subject01_scaleSet_applied.xml", "w");
+    fclose(file2Remove);
+    std::unique_ptr<Model> genericModel(
+            subject->getGenericModelMaker().processModel(setupFilePath));
+    ASSERT(genericModel != nullptr);
+    subject->setGenericModel(*genericModel);
+    subject->run();
+    {
+        const ScaleSet& computedScaleSet = ScaleSet(
+                setupFilePath+"subject01_scaleSet_applied.xml");
+        ASSERT(compareStdScaleToComputed(stdScaleSet, computedScaleSet));
+    }
+    Model modelFromGeneric(setupFilePath + "subject01_simbody.osim");
+    compareModelMarkers(modelFromGeneric, "std_subject01_simbody.osim", 1.0e-6);
 }
 
 void scaleGait2354_GUI(bool useMarkerPlacement)
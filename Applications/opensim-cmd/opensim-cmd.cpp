@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "opensim-cmd_run-tool.h"
+#include "opensim-cmd_run-batch.h"
 #include "opensim-cmd_print-xml.h"
 #include "opensim-cmd_info.h"
 #include "opensim-cmd_update-file.h"
@@ -38,7 +39,8 @@ static const char HELP[] =
 R"(OpenSim: musculoskeletal modeling and simulation.
 
 Usage:
-  opensim-cmd [--library=<path>]... <command> [<args>...]
+  opensim-cmd [--library=<path>]... [--threads=<n>] [--deterministic]
+              <command> [<args>...]
   opensim-cmd -h | --help
   opensim-cmd -V | --version
 
@@ -49,11 +51,20 @@ Options:
                  library's extension (e.g., .dll, .so, .dylib). If <path>
                  contains spaces, surround <path> in quotes. You can load
                  multiple plugins by repeating this option.
+  --threads <n>  The largest number of threads that compute at once (e.g., to
+                 solve the frames of a tool in parallel). The default is the
+                 value of the environment variable OPENSIM_NUM_THREADS, if
+                 set, or else the number of hardware threads.
+  --deterministic  Give the same results, bit for bit, for any number of
+                 threads, by splitting the frames of the tools into the same
+                 chunks whatever the number of threads (see
+                 OPENSIM_DETERMINISTIC).
   -h, --help     Show this help description.
   -V, --version  Show the version number.
 
 Available commands:
   run-tool     Run a tool (e.g., Inverse Kinematics) from an XML setup file.
+  run-batch    Run many tools, listed in a manifest file, in one process.
   print-xml    Print a template XML file for a Tool or class.
   info         Show description of properties in an OpenSim class.
   update-file  Update an .xml file (.osim or setup) to this version's format.
@@ -62,12 +73,14 @@ Available commands:
 
 Examples:
   opensim-cmd run-tool InverseDynamics_Setup.xml
+  opensim-cmd run-batch --jobs 8 trials.txt
   opensim-cmd print-xml cmc
   opensim-cmd info PathActuator
   opensim-cmd update-file lowerlimb_v3.3.osim lowerlimb_updated.osim
   opensim-cmd -L C:\Plugins\osimMyCustomForce.dll run-tool CMC_setup.xml
   opensim-cmd --library ../plugins/libosimMyPlugin.so print-xml MyCustomTool
   opensim-cmd --library=libosimMyCustomForce.dylib info MyCustomForce
+  opensim-cmd --threads 4 run-tool IK_setup.xml
 
 )";
 
@@ -83,6 +96,7 @@ int main(int argc, const char** argv) {
 
     commands["print-xml"] = print_xml;
     commands["run-tool"] = run_tool;
+    commands["run-batch"] = run_batch;
     commands["info"] = info;
     commands["update-file"] = update_file;
 
@@ -111,6 +125,23 @@ int main(int argc, const char** argv) {
         }
     }
 
+    // Limit the number of threads.
+    // -----------------------------
+    if (args["--threads"]) {
+        const std::string& value = args["--threads"].asString();
+        int numThreads = 0;
+        try { numThreads = std::stoi(value); }
+        catch (const std::exception&) {}
+        if (numThreads < 1) {
+            std::cout << "Expected --threads to be a positive integer, but "
+                << "got '" << value << "'." << std::endl;
+            return EXIT_FAILURE;
+        }
+        ThreadPool::setMaxNumThreads(numThreads);
+    }
+    if (args["--deterministic"] && args["--deterministic"].asBool())
+        ThreadPool::setDeterministic(true);
+
     // Did the user provide a valid command?
     // -------------------------------------
     if (!args["<command>"]) {
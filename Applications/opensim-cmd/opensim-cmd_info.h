@@ -35,10 +35,13 @@ R"(Show description of properties in an OpenSim class.
 
 Usage:
   opensim-cmd [options]... info [<class> [<property>]]
+  opensim-cmd [options]... info --memory <model-file>
   opensim-cmd info -h | --help
 
 Options:
   -L <path>, --library <path>  Load a plugin.
+  --threads <n>  The largest number of threads that compute at once.
+  --deterministic  Give the same results for any number of threads.
 
 Description:
   If you do not supply any arguments, you get a list of all registered
@@ -48,10 +51,14 @@ Description:
   class. If you supply <property> as well, you also get a description
   of that property. You can also get descriptions for classes from plugins.
 
+  With --memory, the model in <model-file> is loaded and an estimate of the
+  memory held by each type of component in it is printed.
+
 Examples:
   opensim-cmd info
   opensim-cmd info PathActuator
   opensim-cmd info Model gravity
+  opensim-cmd info --memory arm26.osim
 )";
 
 int info(int argc, const char** argv) {
@@ -62,6 +69,14 @@ int info(int argc, const char** argv) {
             HELP_INFO, { argv + 1, argv + argc },
             true); // show help if requested
 
+    // Memory footprint of a model.
+    if (args["--memory"].asBool()) {
+        Model model(args["<model-file>"].asString());
+        model.finalizeFromProperties();
+        model.printMemoryFootprint();
+        return EXIT_SUCCESS;
+    }
+
     // No arguments were provided.
     if (!args["<class>"]) {
         Object::PrintPropertyInfo(std::cout, "", false);
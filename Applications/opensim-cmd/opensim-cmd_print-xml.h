@@ -39,6 +39,8 @@ Usage:
 
 Options:
   -L <path>, --library <path>  Load a plugin.
+  --threads <n>  The largest number of threads that compute at once.
+  --deterministic  Give the same results for any number of threads.
 
 Description:
   The argument <tool-or-class> can be the name of a Tool
@@ -0,0 +1,612 @@
+#ifndef OPENSIM_CMD_RUN_BATCH_H_
+#define OPENSIM_CMD_RUN_BATCH_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  opensim-cmd_run-batch.h                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+
+#ifndef _WIN32
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+#include <docopt.h>
+#include "parse_arguments.h"
+
+#include <OpenSim/OpenSim.h>
+
+static const char HELP_RUN_BATCH[] =
+R"(Run many tools, listed in a manifest file, in one process.
+
+Usage:
+  opensim-cmd [options]... run-batch <manifest-file>
+  opensim-cmd run-batch -h | --help
+
+Options:
+  -L <path>, --library <path>  Load a plugin.
+  --threads <n>  The largest number of threads that compute at once.
+  --deterministic  Give the same results for any number of threads.
+  -j <N>, --jobs <N>  Number of jobs to run at once [default: 1].
+  -s <file>, --summary <file>  CSV file to which the status and duration of
+                 each job are written [default: batch_summary.csv].
+  --log-dir <dir>  Directory in which the output of each job is written when
+                 several jobs run at once [default: .].
+  --shard <i/N>  Run only the i-th of N shares of the jobs [default: 1/1].
+  --journal <file>  File in which each job that succeeds is recorded; jobs
+                 already recorded in it are not run again.
+
+Description:
+  Each line of <manifest-file> names a setup file, as would be given to
+  `opensim-cmd run-tool`, optionally followed by values that override
+  properties of the tool, in the form <property>=<value>. Surround a <value>
+  that contains spaces in double quotes. Blank lines and lines that start
+  with # are ignored.
+
+  Plugins are loaded and all setup files are read before any job runs. The
+  Inverse Kinematics and Inverse Dynamics jobs that name the same model file
+  share one parsed copy of the model, and the Scale jobs that name the same
+  generic model and marker set files (e.g., ../generic.osim from the
+  directory of each subject) share one generic model, from which each job
+  scales its own copy. The files named in a Scale setup file are relative to
+  the setup file. A cohort of subjects can thus be scaled by listing the
+  Scale setup file of each subject.
+
+  If --jobs is greater than 1, each job runs in a worker process forked from
+  this one, since tools change the working directory of their process. The
+  console output of job <k> is then written to job<k>.log in --log-dir. On
+  Windows, jobs run one after another.
+
+  To split the manifest across the nodes of a cluster, run the same command
+  on each node with --shard 1/N, ..., --shard N/N. Shard i runs jobs i, i+N,
+  i+2N, ... in the order of the manifest, so each job belongs to exactly one
+  shard however many jobs there are. Jobs are numbered by their position in
+  the manifest in all shards, in the output, the summary and the log files.
+
+  With --journal, the command can be run again after it was interrupted or
+  some jobs failed: jobs that succeeded are skipped and the others are run
+  again, rewriting their outputs. A job is identified in the journal by its
+  setup file and overrides, so lines can be added to the manifest between
+  runs. Give each shard its own journal.
+
+  The command succeeds only if all jobs succeed.
+
+Examples:
+  opensim-cmd run-batch trials.txt
+  opensim-cmd run-batch --jobs 8 --summary trials.csv trials.txt
+  opensim-cmd run-batch --shard 3/50 --journal done3.txt trials.txt
+
+  where trials.txt could contain:
+
+    # Inverse kinematics of each trial, with one model.
+    subject01_Setup_IK.xml
+    subject01_Setup_IK.xml marker_file=walk2.trc output_motion_file=walk2.mot
+    subject01_Setup_ID.xml time_range="0.5 1.5"
+    subject02/subject02_Setup_Scale.xml
+)";
+
+// A job listed in the manifest.
+struct BatchJob {
+    std::string setupFile;
+    std::vector<std::pair<std::string, std::string>> overrides;
+    std::unique_ptr<OpenSim::Object> tool;
+    // The parsed model shared with other jobs, if any.
+    const OpenSim::Model* model = nullptr;
+    // Why the job could not be prepared or did not succeed, if known.
+    std::string error;
+    // Whether the job is in this shard, and is not recorded in the journal
+    // as having succeeded already.
+    bool inShard = true;
+    bool alreadyDone = false;
+    bool succeeded = false;
+    double seconds = 0;
+
+    bool isSelected() const { return inShard && !alreadyDone; }
+    // Identifies the job in the journal.
+    std::string getJournalKey() const {
+        std::string key = setupFile;
+        for (const auto& value : overrides)
+            key += "\t" + value.first + "=" + value.second;
+        return key;
+    }
+};
+
+// Split a line of the manifest at whitespace that is not within quotes.
+static std::vector<std::string> splitManifestLine(const std::string& line) {
+    std::vector<std::string> tokens;
+    std::string token;
+    bool inToken = false;
+    bool quoted = false;
+    for (const char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            inToken = true;
+        } else if (!quoted && std::isspace(static_cast<unsigned char>(c))) {
+            if (inToken) tokens.push_back(token);
+            token.clear();
+            inToken = false;
+        } else {
+            token += c;
+            inToken = true;
+        }
+    }
+    if (quoted) {
+        throw OpenSim::Exception("Unmatched quote in manifest line '" +
+                line + "'.");
+    }
+    if (inToken) tokens.push_back(token);
+    return tokens;
+}
+
+static std::vector<BatchJob> readManifest(const std::string& manifestFile) {
+    std::ifstream manifest(manifestFile);
+    if (!manifest) {
+        throw OpenSim::Exception("Could not open manifest file '" +
+                manifestFile + "'.");
+    }
+    std::vector<BatchJob> jobs;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        const auto tokens = splitManifestLine(line);
+        if (tokens.empty() || tokens[0][0] == '#') continue;
+        jobs.emplace_back();
+        BatchJob& job = jobs.back();
+        job.setupFile = tokens[0];
+        for (size_t i = 1; i < tokens.size(); ++i) {
+            const size_t equals = tokens[i].find('=');
+            if (equals == std::string::npos || equals == 0) {
+                throw OpenSim::Exception("Expected <property>=<value> but "
+                        "got '" + tokens[i] + "' in manifest line '" + line +
+                        "'.");
+            }
+            job.overrides.emplace_back(tokens[i].substr(0, equals),
+                                       tokens[i].substr(equals + 1));
+        }
+    }
+    return jobs;
+}
+
+// Set a property of a tool from its value as it would appear in XML.
+static void overrideProperty(OpenSim::Object& tool, const std::string& name,
+        const std::string& value) {
+    using namespace OpenSim;
+    if (tool.hasProperty(name)) {
+        SimTK::Xml::Element parent(tool.getConcreteClassName());
+        parent.appendNode(SimTK::Xml::Element(name, value));
+        tool.updPropertyByName(name).readFromXMLParentElement(parent,
+                XMLDocument::getLatestVersion());
+        return;
+    }
+
+    Property_Deprecated* prop = tool.getPropertySet().contains(name);
+    if (prop == nullptr) {
+        throw Exception("No property with name '" + name +
+                "' found in class '" + tool.getConcreteClassName() + "'.");
+    }
+    std::vector<double> values;
+    switch (prop->getPropertyType()) {
+    case Property_Deprecated::Bool:
+        prop->setValue(value == "true");
+        break;
+    case Property_Deprecated::Int:
+        prop->setValue(std::stoi(value));
+        break;
+    case Property_Deprecated::Dbl:
+        prop->setValue(std::stod(value));
+        break;
+    case Property_Deprecated::Str:
+        prop->setValue(value);
+        break;
+    case Property_Deprecated::DblArray:
+        if (!IO::ParseDoubles(value, values)) {
+            throw Exception("Could not read numbers from '" + value +
+                    "' for property '" + name + "'.");
+        }
+        prop->setValue((int)values.size(), values.data());
+        break;
+    default:
+        throw Exception("Property '" + name + "' of class '" +
+                tool.getConcreteClassName() + "' cannot be overridden.");
+    }
+    prop->setValueIsDefault(false);
+}
+
+// Remove the "." and "dir/.." components of a relative or absolute path, so
+// that the files of jobs in different directories can be recognized as the
+// same, e.g., subject01/../generic.osim and subject02/../generic.osim.
+static std::string normalizeBatchPath(const std::string& path) {
+    std::vector<std::string> parts;
+    std::string part;
+    for (size_t i = 0; i <= path.size(); ++i) {
+        if (i < path.size() && path[i] != '/' && path[i] != '\\') {
+            part += path[i];
+            continue;
+        }
+        if (part == ".." && !parts.empty() && parts.back() != ".." &&
+                !parts.back().empty()) {
+            parts.pop_back();
+        } else if (part != "." && !(part.empty() && !parts.empty())) {
+            parts.push_back(part);
+        }
+        part.clear();
+    }
+    std::string normalized;
+    for (size_t i = 0; i < parts.size(); ++i)
+        normalized += (i == 0 ? "" : "/") + parts[i];
+    return normalized;
+}
+
+// Read the tool of each job, apply its overrides, and load each model file
+// named by Inverse Kinematics and Inverse Dynamics jobs, and each generic
+// model of Scale jobs, once. Jobs that cannot be prepared are given an error,
+// and are not run.
+static void prepareJobs(std::vector<BatchJob>& jobs,
+        std::map<std::string, std::unique_ptr<OpenSim::Model>>& models) {
+    using namespace OpenSim;
+    for (auto& job : jobs) {
+        if (!job.isSelected()) continue;
+        try {
+            job.tool.reset(Object::makeObjectFromFile(job.setupFile));
+            if (!job.tool) {
+                throw Exception("A problem occurred when trying to load "
+                        "file '" + job.setupFile + "'.");
+            }
+            Object& tool = *job.tool;
+            if (!dynamic_cast<AbstractTool*>(&tool) &&
+                    !dynamic_cast<Tool*>(&tool) &&
+                    !dynamic_cast<ScaleTool*>(&tool)) {
+                throw Exception("The provided file '" + job.setupFile +
+                        "' does not define an OpenSim Tool. Did you intend "
+                        "to load a plugin?");
+            }
+            for (const auto& value : job.overrides)
+                overrideProperty(tool, value.first, value.second);
+
+            // These tools use a model given to them instead of loading one.
+            if (dynamic_cast<InverseKinematicsTool*>(&tool) ||
+                    dynamic_cast<InverseDynamicsTool*>(&tool)) {
+                const Property_Deprecated* modelFile =
+                        tool.getPropertySet().contains("model_file");
+                if (modelFile && !modelFile->getValueStr().empty()) {
+                    auto& model = models[modelFile->getValueStr()];
+                    if (!model)
+                        model.reset(new Model(modelFile->getValueStr()));
+                    job.model = model.get();
+                }
+            } else if (auto* scale = dynamic_cast<ScaleTool*>(&tool)) {
+                // As for the `scale` command, the files of the subject are
+                // relative to the setup file.
+                scale->setPathToSubject(
+                        IO::getParentDirectory(job.setupFile));
+                if (!scale->isDefaultGenericModelMaker()) {
+                    const GenericModelMaker& maker =
+                            scale->getGenericModelMaker();
+                    // The generic model has the marker set of the maker.
+                    const std::string key = normalizeBatchPath(
+                            scale->getPathToSubject() +
+                            maker.getModelFileName()) + "\n" +
+                            normalizeBatchPath(scale->getPathToSubject() +
+                            maker.getMarkerSetFileName());
+                    auto& model = models[key];
+                    if (!model) {
+                        model.reset(maker.processModel(
+                                scale->getPathToSubject()));
+                    }
+                    if (!model) {
+                        throw Exception("Unable to load generic model '" +
+                                maker.getModelFileName() + "'.");
+                    }
+                    job.model = model.get();
+                }
+            }
+        } catch (const std::exception& e) {
+            job.tool.reset();
+            job.error = e.what();
+        }
+    }
+}
+
+// Run the tool of a prepared job, giving it its own copy of the shared model.
+static bool runBatchJob(BatchJob& job) {
+    using namespace OpenSim;
+    Object& tool = *job.tool;
+    // The ScaleTool copies its generic model itself.
+    std::unique_ptr<Model> model;
+    if (job.model && !dynamic_cast<ScaleTool*>(&tool))
+        model.reset(job.model->clone());
+
+    std::cout << "Preparing to run " << tool.getConcreteClassName() << "."
+              << std::endl;
+    if (auto* ik = dynamic_cast<InverseKinematicsTool*>(&tool)) {
+        if (model) ik->setModel(*model);
+        return ik->run();
+    } else if (auto* id = dynamic_cast<InverseDynamicsTool*>(&tool)) {
+        if (model) id->setModel(*model);
+        return id->run();
+    } else if (auto* abstractTool = dynamic_cast<AbstractTool*>(&tool)) {
+        return abstractTool->run();
+    } else if (auto* otherTool = dynamic_cast<Tool*>(&tool)) {
+        return otherTool->run();
+    } else {
+        auto& scale = dynamic_cast<ScaleTool&>(tool);
+        if (job.model) scale.setGenericModel(*job.model);
+        return scale.run();
+    }
+}
+
+// Report the outcome of a job, and record it in the journal (if any) if it
+// succeeded.
+static void finishBatchJob(const std::vector<BatchJob>& jobs, size_t index,
+        std::ostream* journal) {
+    const BatchJob& job = jobs[index];
+    std::cout << "Job " << index + 1 << " of " << jobs.size() << " ("
+              << job.setupFile << ") "
+              << (job.succeeded ? "succeeded" : "failed") << " after "
+              << job.seconds << " s."
+              << (job.error.empty() ? "" : " " + job.error) << std::endl;
+    // Flush so that an interrupted batch does not lose the record.
+    if (journal && job.succeeded)
+        *journal << job.getJournalKey() << std::endl;
+}
+
+static std::string getBatchJobLogFile(const std::string& logDir,
+        size_t index) {
+    return logDir + "/job" + std::to_string(index + 1) + ".log";
+}
+
+#ifndef _WIN32
+// Run the prepared jobs in at most numWorkers child processes at a time.
+// Each child inherits the plugins, tools and models of this process, so they
+// are not loaded again.
+static void runBatchJobsInWorkers(std::vector<BatchJob>& jobs, int numWorkers,
+        const std::string& logDir, std::ostream* journal) {
+    using Clock = std::chrono::steady_clock;
+    std::map<pid_t, std::pair<size_t, Clock::time_point>> running;
+    size_t next = 0;
+    while (next < jobs.size() || !running.empty()) {
+        if (next < jobs.size() && (int)running.size() < numWorkers) {
+            const size_t index = next++;
+            BatchJob& job = jobs[index];
+            if (!job.isSelected()) continue;
+            if (!job.tool) {
+                finishBatchJob(jobs, index, journal);
+                continue;
+            }
+            const std::string logFile = getBatchJobLogFile(logDir, index);
+            // Do not let the child repeat output still in our buffers.
+            std::cout.flush();
+            std::fflush(nullptr);
+            const pid_t pid = fork();
+            if (pid < 0) {
+                throw OpenSim::Exception("Could not start a worker process.");
+            }
+            if (pid == 0) {
+                int code = EXIT_FAILURE;
+                const int log = open(logFile.c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                if (log >= 0) {
+                    dup2(log, STDOUT_FILENO);
+                    dup2(log, STDERR_FILENO);
+                    close(log);
+                    try {
+                        if (runBatchJob(job)) code = EXIT_SUCCESS;
+                    } catch (const std::exception& e) {
+                        std::cerr << e.what() << std::endl;
+                    }
+                }
+                std::cout.flush();
+                std::cerr.flush();
+                std::fflush(nullptr);
+                // Skip the destructors and exit handlers of this process.
+                _exit(code);
+            }
+            job.error = "See '" + logFile + "'.";
+            running[pid] = {index, Clock::now()};
+        } else {
+            int status = 0;
+            pid_t pid;
+            while ((pid = waitpid(-1, &status, 0)) < 0 && errno == EINTR) {}
+            if (pid < 0) {
+                throw OpenSim::Exception("Lost track of the worker "
+                        "processes.");
+            }
+            const auto it = running.find(pid);
+            if (it == running.end()) continue;
+            BatchJob& job = jobs[it->second.first];
+            job.seconds = std::chrono::duration<double>(
+                    Clock::now() - it->second.second).count();
+            job.succeeded = WIFEXITED(status) &&
+                            WEXITSTATUS(status) == EXIT_SUCCESS;
+            if (WIFSIGNALED(status)) {
+                job.error = "Terminated by signal " +
+                        std::to_string(WTERMSIG(status)) + ". " + job.error;
+            }
+            finishBatchJob(jobs, it->second.first, journal);
+            running.erase(it);
+        }
+    }
+}
+#endif
+
+static void runBatchJobsInOrder(std::vector<BatchJob>& jobs,
+        std::ostream* journal) {
+    using Clock = std::chrono::steady_clock;
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        BatchJob& job = jobs[index];
+        if (!job.isSelected()) continue;
+        if (job.tool) {
+            const auto start = Clock::now();
+            try {
+                job.succeeded = runBatchJob(job);
+            } catch (const std::exception& e) {
+                job.error = e.what();
+            }
+            job.seconds = std::chrono::duration<double>(
+                    Clock::now() - start).count();
+        }
+        finishBatchJob(jobs, index, journal);
+    }
+}
+
+// Quote a field of the CSV summary.
+static std::string quoteCSVField(const std::string& field) {
+    std::string quoted = "\"";
+    for (const char c : field) {
+        if (c == '"') quoted += '"';
+        quoted += (c == '\n' || c == '\r') ? ' ' : c;
+    }
+    return quoted + "\"";
+}
+
+static void writeBatchSummary(const std::vector<BatchJob>& jobs,
+        const std::string& summaryFile) {
+    std::ofstream summary(summaryFile);
+    if (!summary) {
+        throw OpenSim::Exception("Could not write summary file '" +
+                summaryFile + "'.");
+    }
+    summary << "job,setup_file,status,seconds,message\n";
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        const BatchJob& job = jobs[index];
+        if (!job.inShard) continue;
+        const char* status = job.alreadyDone ? "skipped" :
+                             job.succeeded ? "succeeded" : "failed";
+        summary << index + 1 << "," << quoteCSVField(job.setupFile) << ","
+                << status << "," << job.seconds << ","
+                << quoteCSVField(job.error) << "\n";
+    }
+}
+
+// Parse the --shard argument, "i/N", into the 1-based shard i and count N.
+static std::pair<size_t, size_t> parseBatchShard(const std::string& shard) {
+    size_t index = 0, count = 0;
+    const size_t slash = shard.find('/');
+    try {
+        index = std::stoul(shard.substr(0, slash));
+        if (slash != std::string::npos)
+            count = std::stoul(shard.substr(slash + 1));
+    } catch (const std::exception&) {}
+    if (index < 1 || index > count) {
+        throw OpenSim::Exception("Expected a shard i/N with 1 <= i <= N, "
+                "but got '" + shard + "'.");
+    }
+    return {index, count};
+}
+
+// Mark the jobs that are not in the given shard, and those that the journal
+// (if it exists) records as having succeeded.
+static void selectBatchJobs(std::vector<BatchJob>& jobs,
+        const std::pair<size_t, size_t>& shard,
+        const std::string& journalFile) {
+    std::set<std::string> done;
+    if (!journalFile.empty()) {
+        std::ifstream journal(journalFile);
+        std::string line;
+        while (std::getline(journal, line))
+            if (!line.empty()) done.insert(line);
+    }
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        BatchJob& job = jobs[index];
+        job.inShard = index % shard.second == shard.first - 1;
+        job.alreadyDone = job.inShard && done.count(job.getJournalKey());
+    }
+}
+
+int run_batch(int argc, const char** argv) {
+
+    using namespace OpenSim;
+
+    std::map<std::string, docopt::value> args = OpenSim::parse_arguments(
+            HELP_RUN_BATCH, { argv + 1, argv + argc },
+            true); // show help if requested
+
+    int numWorkers = 0;
+    try {
+        numWorkers = std::stoi(args["--jobs"].asString());
+    } catch (const std::exception&) {}
+    if (numWorkers < 1) {
+        throw Exception("Expected a positive number of jobs, but got '" +
+                args["--jobs"].asString() + "'.");
+    }
+    const auto shard = parseBatchShard(args["--shard"].asString());
+    const std::string journalFile =
+            args["--journal"] ? args["--journal"].asString() : "";
+
+    std::vector<BatchJob> jobs =
+            readManifest(args["<manifest-file>"].asString());
+    selectBatchJobs(jobs, shard, journalFile);
+    size_t numInShard = 0, numAlreadyDone = 0;
+    for (const auto& job : jobs) {
+        numInShard += job.inShard ? 1 : 0;
+        numAlreadyDone += job.alreadyDone ? 1 : 0;
+    }
+    std::cout << "Preparing " << numInShard - numAlreadyDone << " jobs";
+    if (shard.second > 1) {
+        std::cout << " of shard " << shard.first << "/" << shard.second;
+    }
+    if (numAlreadyDone > 0) {
+        std::cout << " (" << numAlreadyDone << " already done)";
+    }
+    std::cout << "." << std::endl;
+    std::map<std::string, std::unique_ptr<Model>> models;
+    prepareJobs(jobs, models);
+
+    std::unique_ptr<std::ofstream> journal;
+    if (!journalFile.empty()) {
+        journal.reset(new std::ofstream(journalFile, std::ios_base::app));
+        if (!*journal) {
+            throw Exception("Could not write journal file '" + journalFile +
+                    "'.");
+        }
+    }
+
+    #ifndef _WIN32
+        if (numWorkers > 1) {
+            runBatchJobsInWorkers(jobs, numWorkers,
+                    args["--log-dir"].asString(), journal.get());
+        } else {
+            runBatchJobsInOrder(jobs, journal.get());
+        }
+    #else
+        runBatchJobsInOrder(jobs, journal.get());
+    #endif
+
+    const std::string& summaryFile = args["--summary"].asString();
+    writeBatchSummary(jobs, summaryFile);
+    size_t numSucceeded = 0;
+    for (const auto& job : jobs) numSucceeded += job.succeeded ? 1 : 0;
+    std::cout << numSucceeded + numAlreadyDone << " of " << numInShard
+              << " jobs succeeded. "
+              << "Summary written to '" << summaryFile << "'." << std::endl;
+    return numSucceeded + numAlreadyDone == numInShard ?
+            EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#endif // OPENSIM_CMD_RUN_BATCH_H_
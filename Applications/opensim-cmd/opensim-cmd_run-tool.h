@@ -34,11 +34,21 @@ static const char HELP_RUN_TOOL[] =
 R"(Run a tool (e.g., Inverse Kinematics) from an XML setup file.
 
 Usage:
-  opensim-cmd [options]... run-tool <setup-xml-file>
+  opensim-cmd [options]... run-tool [--profile [--trace]] [--profile-components] <setup-xml-file>
   opensim-cmd run-tool -h | --help
 
 Options:
   -L <path>, --library <path>  Load a plugin.
+  --threads <n>  The largest number of threads that compute at once.
+  --deterministic  Give the same results for any number of threads.
+  --profile  Write the time spent in each phase of the run (e.g., loading the
+             model, solving, writing outputs) to <name>_profile.json in the
+             results directory.
+  --trace    Also write <name>_trace.json, which can be opened in
+             chrome://tracing or Perfetto.
+  --profile-components  After each simulation, print the time spent in the
+             computations (realize, forces, outputs) of each component and
+             of each type of component.
 
 Description:
   The Tool to run is detected from the setup file you provide. Supported tools
@@ -58,6 +68,7 @@ Description:
 
 Examples:
   opensim-cmd run-tool CMC_setup.xml
+  opensim-cmd run-tool --profile --trace IK_setup.xml
   opensim-cmd -L C:\Plugins\osimMyCustomForce.dll run-tool CMC_setup.xml
   opensim-cmd --library ../plugins/libosimMyPlugin.so run-tool Forward_setup.xml
   opensim-cmd --library=libosimMyCustomForce.dylib run-tool CMC_setup.xml
@@ -71,6 +82,10 @@ int run_tool(int argc, const char** argv) {
             HELP_RUN_TOOL, { argv + 1, argv + argc },
             true); // show help if requested
 
+    ToolProfile::setReportsEnabled(args["--profile"].asBool());
+    ToolProfile::setChromeTraceEnabled(args["--trace"].asBool());
+    ComponentProfiler::setEnabled(args["--profile-components"].asBool());
+
     // Deserialize.
     const auto& setupFile = args["<setup-xml-file>"].asString();
     Object* obj = Object::makeObjectFromFile(setupFile);
@@ -23,6 +23,7 @@
 
 #include <SimTKcommon/Testing.h>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <regex>
@@ -205,6 +206,17 @@ void testNoCommand() {
         testCommand("-L=x --library=y -L=z", EXIT_FAILURE, output);
     }
 
+    // Threads option.
+    // ===============
+    testCommand("--threads", EXIT_FAILURE,
+            StartsWith("--threads requires an argument"));
+    testCommand("--threads 0 info", EXIT_FAILURE,
+            "Expected --threads to be a positive integer, but got '0'.\n");
+    testCommand("--threads=x info", EXIT_FAILURE,
+            "Expected --threads to be a positive integer, but got 'x'.\n");
+    testCommand("--threads 2 info PathActuator", EXIT_SUCCESS,
+            StartsWith("\nPROPERTIES FOR PathActuator"));
+
     // Unrecognized command.
     // =====================
     testCommand("bleepbloop", EXIT_FAILURE, 
@@ -325,6 +337,76 @@ void testRunTool() {
     testLoadPluginLibraries("run-tool");
 }
 
+void testRunBatch() {
+    // Help.
+    // =====
+    {
+        StartsWith output("Run many tools, ");
+        testCommand("run-batch -h", EXIT_SUCCESS, output);
+        testCommand("run-batch -help", EXIT_SUCCESS, output);
+    }
+
+    // Error messages.
+    // ===============
+    testCommand("run-batch", EXIT_FAILURE,
+            StartsWith("Arguments did not match expected patterns"));
+    testCommand("run-batch putes.txt", EXIT_FAILURE,
+            "Could not open manifest file 'putes.txt'.\n");
+    testCommand("run-batch --jobs 0 putes.txt", EXIT_FAILURE,
+            "Expected a positive number of jobs, but got '0'.\n");
+
+    // Jobs that fail are reported, and do not stop the others.
+    // ========================================================
+    testCommand("print-xml cmc testrunbatch_cmc_setup.xml", EXIT_SUCCESS,
+            "Printing 'testrunbatch_cmc_setup.xml'.\n");
+    testCommand("print-xml Model testrunbatch_Model.xml", EXIT_SUCCESS,
+            "Printing 'testrunbatch_Model.xml'.\n");
+    {
+        std::ofstream manifest("testrunbatch_manifest.txt");
+        manifest << "# A setup file without a model.\n"
+                 << "testrunbatch_cmc_setup.xml\n\n"
+                 << "testrunbatch_cmc_setup.xml final_time=\"0.5\"\n"
+                 << "testrunbatch_cmc_setup.xml x=1\n"
+                 << "testrunbatch_Model.xml\n";
+    }
+    const std::regex output(RE_ANY +
+            "Job 1 of 4 \\(testrunbatch_cmc_setup.xml\\) failed" + RE_ANY +
+            "Job 3 of 4 \\(testrunbatch_cmc_setup.xml\\) failed after 0 s. "
+            "No property with name 'x'" + RE_ANY +
+            "Job 4 of 4 \\(testrunbatch_Model.xml\\) failed" + RE_ANY +
+            "0 of 4 jobs succeeded. Summary written to "
+            "'testrunbatch_summary.csv'.\n");
+    testCommand("run-batch --summary testrunbatch_summary.csv "
+                "testrunbatch_manifest.txt", EXIT_FAILURE, output);
+    // Workers may finish in any order.
+    testCommand("run-batch --jobs 2 --summary testrunbatch_summary.csv "
+                "testrunbatch_manifest.txt", EXIT_FAILURE,
+            std::regex(RE_ANY + "0 of 4 jobs succeeded. Summary written to "
+                       "'testrunbatch_summary.csv'.\n"));
+
+    // Shards.
+    // =======
+    testCommand("run-batch --shard 3/2 testrunbatch_manifest.txt",
+            EXIT_FAILURE,
+            "Expected a shard i/N with 1 <= i <= N, but got '3/2'.\n");
+    testCommand("run-batch --shard 2/2 testrunbatch_manifest.txt",
+            EXIT_FAILURE,
+            std::regex("Preparing 2 jobs of shard 2/2." + RE_ANY +
+                       "Job 2 of 4 " + RE_ANY + "Job 4 of 4 " + RE_ANY +
+                       "0 of 2 jobs succeeded. " + RE_ANY));
+
+    // Jobs recorded in the journal are not run again.
+    // ===============================================
+    {
+        std::ofstream journal("testrunbatch_journal.txt");
+        journal << "testrunbatch_Model.xml\n";
+    }
+    testCommand("run-batch --journal testrunbatch_journal.txt "
+                "testrunbatch_manifest.txt", EXIT_FAILURE,
+            std::regex("Preparing 3 jobs \\(1 already done\\)." + RE_ANY +
+                       "1 of 4 jobs succeeded. " + RE_ANY));
+}
+
 void testPrintXML() {
     // Help.
     // =====
@@ -397,6 +479,11 @@ void testInfo() {
             StartsWith("\nPROPERTIES FOR PathSpring"));
     testCommand("info Body mass", EXIT_SUCCESS,
             "\nBody.mass\nThe mass of the body (kg)\n");
+    testCommand("print-xml Model testinfo_Model.osim", EXIT_SUCCESS,
+            "Printing 'testinfo_Model.osim'.\n");
+    testCommand("info --memory testinfo_Model.osim", EXIT_SUCCESS,
+            std::regex(RE_ANY + "Estimated memory footprint of Model" +
+                       RE_ANY));
 
     // Library option.
     // ===============
@@ -464,6 +551,7 @@ int main() {
     SimTK_START_TEST("testCommandLineInterface");
         SimTK_SUBTEST(testNoCommand);
         SimTK_SUBTEST(testRunTool);
+        SimTK_SUBTEST(testRunBatch);
         SimTK_SUBTEST(testPrintXML);
         SimTK_SUBTEST(testInfo);
         SimTK_SUBTEST(testUpdateFile);
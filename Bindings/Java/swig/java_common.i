@@ -214,6 +214,168 @@ SWIG_JAVABODY_PROXY(public, public, SWIGTYPE)
       comp.markAdopted();
       private_addComponent(comp);
   }
+
+  public double[] getStateVariableValuesAsJavaArray(State state) {
+      return getStateVariableValues(state).getAsJavaArray();
+  }
+
+  public void setStateVariableValues(State state, double[] values) {
+      setStateVariableValues(state, Vector.createFromJavaArray(values));
+  }
+%}
+
+// Bulk transfer
+// =============
+// Copy whole columns and matrices of Storages and tables to and from Java
+// arrays in a single JNI call; see VECTOR_BULK_TRANSFER in java_simbody.i.
+// Matrices are passed to the private helpers by row in flat arrays.
+%javamethodmodifiers OpenSim::Storage::copyTimeColumnToJavaArray "private";
+%javamethodmodifiers OpenSim::Storage::copyDataColumnToJavaArray "private";
+%javamethodmodifiers OpenSim::Storage::copyDataToJavaArray "private";
+%javamethodmodifiers OpenSim::Storage::appendJavaArrays "private";
+%extend OpenSim::Storage {
+    void copyTimeColumnToJavaArray(double values[]) {
+        for (int i = 0; i < self->getSize(); ++i)
+            values[i] = self->getStateVector(i)->getTime();
+    }
+    // Missing values, in rows shorter than the others, are NaN.
+    void copyDataColumnToJavaArray(const std::string& columnName,
+                                   double values[]) {
+        // The labels include the time column.
+        const int index = self->getColumnLabels().findIndex(columnName) - 1;
+        if (index < 0)
+            throw OpenSim::Exception("Storage has no column '" +
+                                     columnName + "'.");
+        for (int i = 0; i < self->getSize(); ++i) {
+            const Array<double>& row = self->getStateVector(i)->getData();
+            values[i] = index < row.getSize() ? row[index] : SimTK::NaN;
+        }
+    }
+    void copyDataToJavaArray(double values[], int numColumns) {
+        for (int i = 0; i < self->getSize(); ++i) {
+            const Array<double>& row = self->getStateVector(i)->getData();
+            for (int j = 0; j < numColumns; ++j)
+                values[i * numColumns + j] =
+                        j < row.getSize() ? row[j] : SimTK::NaN;
+        }
+    }
+    void appendJavaArrays(double times[], double values[],
+                          int numRows, int numColumns) {
+        for (int i = 0; i < numRows; ++i)
+            self->append(times[i], numColumns, values + i * numColumns);
+    }
+}
+%typemap(javacode) OpenSim::Storage %{
+  private int getNumDataColumns() {
+      return Math.max(getColumnLabels().getSize() - 1, 0);
+  }
+
+  public double[] getTimeColumnAsJavaArray() {
+      double[] values = new double[getSize()];
+      copyTimeColumnToJavaArray(values);
+      return values;
+  }
+
+  public double[] getDataColumnAsJavaArray(String columnName) {
+      double[] values = new double[getSize()];
+      copyDataColumnToJavaArray(columnName, values);
+      return values;
+  }
+
+  /** The data (without the time column), with a row for each time. */
+  public double[][] getDataAsJavaArray() {
+      int numColumns = getNumDataColumns();
+      double[] flat = new double[getSize() * numColumns];
+      copyDataToJavaArray(flat, numColumns);
+      return unflattenJavaArray(flat, getSize(), numColumns);
+  }
+
+  /** Append a row of data for each time. */
+  public void appendJavaArrays(double[] times, double[][] data) {
+      if (data.length != times.length)
+          throw new IllegalArgumentException("Expected a row of data for " +
+                  "each of the " + times.length + " times.");
+      int numColumns = data.length == 0 ? 0 : data[0].length;
+      appendJavaArrays(times, flattenJavaArray(data, numColumns),
+                       times.length, numColumns);
+  }
+
+  static double[][] unflattenJavaArray(double[] flat,
+                                       int numRows, int numColumns) {
+      double[][] values = new double[numRows][numColumns];
+      for (int i = 0; i < numRows; ++i)
+          System.arraycopy(flat, i * numColumns, values[i], 0, numColumns);
+      return values;
+  }
+
+  static double[] flattenJavaArray(double[][] values, int numColumns) {
+      double[] flat = new double[values.length * numColumns];
+      for (int i = 0; i < values.length; ++i) {
+          if (values[i].length != numColumns)
+              throw new IllegalArgumentException(
+                      "All rows must have the same length.");
+          System.arraycopy(values[i], 0, flat, i * numColumns, numColumns);
+      }
+      return flat;
+  }
+%}
+
+%javamethodmodifiers OpenSim::DataTable_<double, double>::copyIndependentColumnToJavaArray "private";
+%javamethodmodifiers OpenSim::DataTable_<double, double>::copyMatrixToJavaArray "private";
+%javamethodmodifiers OpenSim::DataTable_<double, double>::appendJavaArrays "private";
+%extend OpenSim::DataTable_<double, double> {
+    void copyIndependentColumnToJavaArray(double values[]) {
+        const auto& column = self->getIndependentColumn();
+        std::copy(column.begin(), column.end(), values);
+    }
+    void copyMatrixToJavaArray(double values[]) {
+        const auto matrix = self->getMatrix();
+        const int numColumns = matrix.ncol();
+        for (int i = 0; i < matrix.nrow(); ++i)
+            for (int j = 0; j < numColumns; ++j)
+                values[i * numColumns + j] = matrix.getElt(i, j);
+    }
+    void appendJavaArrays(double independent[], double values[],
+                          int numRows, int numColumns) {
+        self->reserve(self->getNumRows() + numRows);
+        SimTK::RowVector_<double> row(numColumns);
+        for (int i = 0; i < numRows; ++i) {
+            for (int j = 0; j < numColumns; ++j)
+                row[j] = values[i * numColumns + j];
+            self->appendRow(independent[i], row);
+        }
+    }
+}
+%typemap(javacode) OpenSim::DataTable_<double, double> %{
+  public double[] getIndependentColumnAsJavaArray() {
+      double[] values = new double[(int) getNumRows()];
+      copyIndependentColumnToJavaArray(values);
+      return values;
+  }
+
+  public double[] getDependentColumnAsJavaArray(String columnLabel) {
+      return getDependentColumn(columnLabel).getAsJavaArray();
+  }
+
+  /** The dependent columns, with a row for each row of the table. */
+  public double[][] getMatrixAsJavaArray() {
+      int numRows = (int) getNumRows();
+      int numColumns = (int) getNumColumns();
+      double[] flat = new double[numRows * numColumns];
+      copyMatrixToJavaArray(flat);
+      return Storage.unflattenJavaArray(flat, numRows, numColumns);
+  }
+
+  /** Append a row for each value of the independent column. */
+  public void appendJavaArrays(double[] independent, double[][] data) {
+      if (data.length != independent.length)
+          throw new IllegalArgumentException("Expected a row of data for " +
+                  "each of the " + independent.length + " rows.");
+      int numColumns = data.length == 0 ? 0 : data[0].length;
+      appendJavaArrays(independent,
+                       Storage.flattenJavaArray(data, numColumns),
+                       independent.length, numColumns);
+  }
 %}
 
 %import "java_simbody.i"
@@ -131,6 +131,71 @@ public:
      }
 }
 
+// Bulk transfer
+// =============
+// Copy all elements between a vector and a Java array in a single JNI call,
+// rather than calling get()/set() for each element. The private helpers
+// assume the Java array has the size of the vector, which the public Java
+// methods ensure.
+%define VECTOR_BULK_TRANSFER(VECTOR, ROW, COL)
+%javamethodmodifiers VECTOR::copyToJavaArray "private";
+%javamethodmodifiers VECTOR::copyFromJavaArray "private";
+%extend VECTOR {
+    void copyToJavaArray(double values[]) {
+        for (int i = 0; i < $self->size(); ++i)
+            values[i] = $self->getElt(ROW, COL);
+    }
+    void copyFromJavaArray(double values[]) {
+        for (int i = 0; i < $self->size(); ++i)
+            $self->updElt(ROW, COL) = values[i];
+    }
+}
+%typemap(javacode) VECTOR %{
+  /** Copy the elements into a new Java array. */
+  public double[] getAsJavaArray() {
+      double[] values = new double[size()];
+      copyToJavaArray(values);
+      return values;
+  }
+  /** Set the elements from a Java array of the same size. */
+  public void setFromJavaArray(double[] values) {
+      if (values.length != size())
+          throw new IllegalArgumentException("Expected " + size() +
+                  " values but got " + values.length + ".");
+      copyFromJavaArray(values);
+  }
+%}
+%enddef
+VECTOR_BULK_TRANSFER(SimTK::VectorBase<double>, i, 0);
+VECTOR_BULK_TRANSFER(SimTK::RowVectorBase<double>, 0, i);
+
+%javamethodmodifiers SimTK::Vector_<double>::createFromJavaArray "private";
+%extend SimTK::Vector_<double> {
+    static SimTK::Vector_<double> createFromJavaArray(double values[],
+                                                      int size) {
+        return SimTK::Vector_<double>(size, values);
+    }
+}
+%typemap(javacode) SimTK::Vector_<double> %{
+  /** Create a Vector with a copy of the elements of a Java array. */
+  public static Vector createFromJavaArray(double[] values) {
+      return createFromJavaArray(values, values.length);
+  }
+%}
+%javamethodmodifiers SimTK::RowVector_<double>::createFromJavaArray "private";
+%extend SimTK::RowVector_<double> {
+    static SimTK::RowVector_<double> createFromJavaArray(double values[],
+                                                         int size) {
+        return SimTK::RowVector_<double>(size, values);
+    }
+}
+%typemap(javacode) SimTK::RowVector_<double> %{
+  /** Create a RowVector with a copy of the elements of a Java array. */
+  public static RowVector createFromJavaArray(double[] values) {
+      return createFromJavaArray(values, values.length);
+  }
+%}
+
 %extend SimTK::RowVectorBase<SimTK::Vec3> {
      Vec3 get(size_t i) {
          if(i >= $self->nelt())
@@ -173,6 +173,14 @@ SWIG_JAVABODY_PROXY(public, public, SWIGTYPE)
   }
 %}
 
+%typemap(javacode) OpenSim::StatesTrajectory %{
+  /** The values of all state variables, with a row for each state; see
+  exportToTable() for the order of the columns. */
+  public double[][] exportToJavaArray(Model model) {
+      return exportToTable(model).getMatrixAsJavaArray();
+  }
+%}
+
 %extend OpenSim::Model {
     static void LoadOpenSimLibrary(std::string libraryName){
         LoadOpenSimLibrary(libraryName);
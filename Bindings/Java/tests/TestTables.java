@@ -732,6 +732,52 @@ class TestTables {
         }
     }
 
+    public static void test_bulkTransfer() {
+        System.out.println("Test copying vectors to and from Java arrays.");
+        double[] values = {1, 2, 3};
+        Vector vec = Vector.createFromJavaArray(values);
+        assert vec.size() == 3 && vec.get(2) == 3;
+        double[] copy = vec.getAsJavaArray();
+        assert java.util.Arrays.equals(copy, values);
+        vec.setFromJavaArray(new double[]{4, 5, 6});
+        assert vec.get(0) == 4 && vec.get(2) == 6;
+        RowVector rowVec = RowVector.createFromJavaArray(values);
+        assert java.util.Arrays.equals(rowVec.getAsJavaArray(), values);
+
+        System.out.println("Test copying tables to and from Java arrays.");
+        TimeSeriesTable table = new TimeSeriesTable();
+        StdVectorString labels = new StdVectorString();
+        labels.add("a"); labels.add("b");
+        table.setColumnLabels(labels);
+        double[] times = {0.1, 0.2, 0.3};
+        double[][] data = {{1, 2}, {3, 4}, {5, 6}};
+        table.appendJavaArrays(times, data);
+        assert table.getNumRows() == 3;
+        assert table.getRowAtIndex(2).get(1) == 6;
+        assert java.util.Arrays.equals(
+                table.getIndependentColumnAsJavaArray(), times);
+        assert java.util.Arrays.equals(
+                table.getDependentColumnAsJavaArray("b"),
+                new double[]{2, 4, 6});
+        assert java.util.Arrays.deepEquals(table.getMatrixAsJavaArray(),
+                                           data);
+
+        System.out.println("Test copying Storages to and from Java arrays.");
+        Storage storage = new Storage();
+        ArrayStr storageLabels = new ArrayStr();
+        storageLabels.append("time");
+        storageLabels.append("a");
+        storageLabels.append("b");
+        storage.setColumnLabels(storageLabels);
+        storage.appendJavaArrays(times, data);
+        assert storage.getSize() == 3;
+        assert java.util.Arrays.equals(storage.getTimeColumnAsJavaArray(),
+                                       times);
+        assert java.util.Arrays.equals(storage.getDataColumnAsJavaArray("a"),
+                                       new double[]{1, 3, 5});
+        assert java.util.Arrays.deepEquals(storage.getDataAsJavaArray(), data);
+    }
+
     public static void main(String[] args)  throws java.io.IOException {
         test_DataTable();
         test_DataTableVec3();
@@ -739,5 +785,6 @@ class TestTables {
         test_TimeSeriesTableVec3();
         test_FlattenWithIK();
         test_vector_rowvector();
+        test_bulkTransfer();
     }
 }
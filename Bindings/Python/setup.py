@@ -15,6 +15,7 @@ setup(name='opensim',
       url='http://opensim.stanford.edu/',
       license='Apache 2.0',
       packages=['opensim'],
+      install_requires=['numpy'],
       package_data={'opensim': ['_*.*']},
       include_package_data=True,
       classifiers=[
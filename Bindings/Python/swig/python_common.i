@@ -1,4 +1,4 @@
-%module(directors="1") common
+%module(directors="1", threads="1") common
 #pragma SWIG nowarn=822,451,503,516,325
 // 401 is "Nothing known about base class *some-class*.
 //         Maybe you forgot to instantiate *some-template* using %template."
@@ -19,6 +19,8 @@ using namespace SimTK;
 %}
 
 %include "python_preliminaries.i"
+// Before importing simbody, which also includes this file.
+%include "python_numpy.i"
 
 // Tell SWIG about the simbody module.
 %import "python_simbody.i"
@@ -292,6 +294,77 @@ note: ## is a "glue" operator: `a ## b` --> `ab`.
 %include <Bindings/preliminaries.i>
 %include <Bindings/common.i>
 
+// NumPy
+// =====
+// Views of the data of a table, as for SimTK::Matrix in python_simbody.i. The
+// views are invalid once rows are appended or removed.
+%extend OpenSim::DataTable_<double, double> {
+    PyObject* _numpyView(PyObject* owner) {
+        auto matrix = $self->updMatrix();
+        return opensimNumPyMatrixView(owner, matrix, true);
+    }
+    PyObject* _numpyIndependentView(PyObject* owner) {
+        // The independent column can only be edited through the table, which
+        // keeps it sorted.
+        auto& column = const_cast<std::vector<double>&>(
+                $self->getIndependentColumn());
+        npy_intp dims[1] = {(npy_intp)column.size()};
+        return opensimNumPyView(owner, 1, dims, NULL,
+                                column.empty() ? NULL : column.data(), false);
+    }
+%pythoncode %{
+    def to_numpy(self):
+        """A 2-D NumPy array (rows by columns) that shares memory with the
+        dependent columns of this table."""
+        return self._numpyView(self)
+
+    def independent_column_to_numpy(self):
+        """A read-only 1-D NumPy array that shares memory with the independent
+        column of this table."""
+        return self._numpyIndependentView(self)
+%}
+};
+%extend OpenSim::TimeSeriesTable_<double> {
+    // Create a table from an array of times and a 2-D array with a row for
+    // each time, copying each row once.
+    static OpenSim::TimeSeriesTable_<double> from_numpy(PyObject* times,
+            PyObject* data, const std::vector<std::string>& labels) {
+        PyArrayObject* timesArray = opensimNumPyAsArray(times, 1);
+        PyArrayObject* dataArray = NULL;
+        try {
+            dataArray = opensimNumPyAsArray(data, 2);
+        } catch (...) {
+            Py_DECREF(timesArray);
+            throw;
+        }
+        const npy_intp numRows = PyArray_DIM(dataArray, 0);
+        const npy_intp numColumns = PyArray_DIM(dataArray, 1);
+        OpenSim::TimeSeriesTable_<double> table;
+        try {
+            OPENSIM_THROW_IF(PyArray_DIM(timesArray, 0) != numRows, Exception,
+                    "Expected a time for each of the " +
+                    std::to_string(numRows) + " rows of the data.");
+            table.setColumnLabels(labels);
+            table.reserve(numRows);
+            const double* t = (const double*)PyArray_DATA(timesArray);
+            const double* row = (const double*)PyArray_DATA(dataArray);
+            SimTK::RowVector_<double> depRow((int)numColumns);
+            for (npy_intp i = 0; i < numRows; ++i, row += numColumns) {
+                for (npy_intp j = 0; j < numColumns; ++j)
+                    depRow[(int)j] = row[j];
+                table.appendRow(t[i], depRow);
+            }
+        } catch (...) {
+            Py_DECREF(timesArray);
+            Py_DECREF(dataArray);
+            throw;
+        }
+        Py_DECREF(timesArray);
+        Py_DECREF(dataArray);
+        return table;
+    }
+}
+
 
 // Memory management
 // =================
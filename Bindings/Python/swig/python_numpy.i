@@ -0,0 +1,73 @@
+// NumPy arrays that share the memory of SimTK and OpenSim objects.
+// ================================================================
+// This file must be %included (not only %imported) by each module that uses
+// these helpers, before any %import of another module that includes it, so
+// that the module initializes the NumPy C API.
+
+%{
+#include <numpy/arrayobject.h>
+%}
+
+%init %{
+    import_array();
+%}
+
+%{
+namespace {
+// A NumPy array of doubles over the given data (no copy). The array holds a
+// reference to owner, the Python object that owns the data, so that the data
+// outlives the array as long as owner does not reallocate it.
+PyObject* opensimNumPyView(PyObject* owner, int nd,
+                           npy_intp* dims, npy_intp* strides,
+                           double* data, bool writeable) {
+    PyObject* array = PyArray_New(&PyArray_Type, nd, dims, NPY_DOUBLE,
+            strides, data, 0, writeable ? NPY_ARRAY_WRITEABLE : 0, NULL);
+    if (!array) return NULL;
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject((PyArrayObject*)array, owner) < 0) {
+        Py_DECREF(array);
+        return NULL;
+    }
+    return array;
+}
+
+// A 1-D view of a SimTK vector or row vector of doubles, which may be
+// strided.
+template <class V>
+PyObject* opensimNumPyVectorView(PyObject* owner, V& v, bool writeable) {
+    npy_intp dims[1] = {v.size()};
+    npy_intp strides[1] = {sizeof(double)};
+    if (v.size() > 1)
+        strides[0] = (char*)&v[1] - (char*)&v[0];
+    return opensimNumPyView(owner, 1, dims, strides,
+                            v.size() ? &v[0] : NULL, writeable);
+}
+
+// A 2-D view of a SimTK matrix of doubles, which is stored by column.
+template <class M>
+PyObject* opensimNumPyMatrixView(PyObject* owner, M& m, bool writeable) {
+    npy_intp dims[2] = {m.nrow(), m.ncol()};
+    npy_intp strides[2] = {sizeof(double), sizeof(double)};
+    if (m.nrow() > 1)
+        strides[0] = (char*)&m(1, 0) - (char*)&m(0, 0);
+    if (m.ncol() > 1)
+        strides[1] = (char*)&m(0, 1) - (char*)&m(0, 0);
+    return opensimNumPyView(owner, 2, dims, strides,
+                            m.nelt() ? &m(0, 0) : NULL, writeable);
+}
+
+// Convert any sequence of numbers to a C-contiguous array of doubles with
+// the given number of dimensions. This copies only if obj is not already such
+// an array.
+PyArrayObject* opensimNumPyAsArray(PyObject* obj, int nd) {
+    PyArrayObject* array = (PyArrayObject*)PyArray_FROMANY(obj,
+            NPY_DOUBLE, nd, nd, NPY_ARRAY_IN_ARRAY);
+    if (!array) {
+        PyErr_Clear();
+        throw std::invalid_argument("Expected a " + std::to_string(nd) +
+                "-dimensional array of numbers.");
+    }
+    return array;
+}
+}
+%}
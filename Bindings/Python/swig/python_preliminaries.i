@@ -46,3 +46,7 @@ note: ## is a "glue" operator: `a ## b` --> `ab`.
 %}
 };
 %enddef
+
+// Threads
+// =======
+%include "python_threads.i"
@@ -1,4 +1,4 @@
-%module(directors="1") simbody
+%module(directors="1", threads="1") simbody
 #pragma SWIG nowarn=822,451,503,516,325
 // 401 is "Nothing known about base class *some-class*.
 //         Maybe you forgot to instantiate *some-template* using %template."
@@ -18,6 +18,7 @@ using namespace SimTK;
 
 
 %include "python_preliminaries.i"
+%include "python_numpy.i"
 
 
 // Relay exceptions to the target language.
@@ -149,3 +150,63 @@ These typemaps work, though.
     }
 };
 
+// NumPy
+// =====
+// to_numpy() returns a NumPy array that shares memory with the object, so
+// writing to the array writes to the object and no elements are copied. The
+// array keeps the object alive, but is invalid once the object is resized.
+// from_numpy() copies the array into a new object in a single pass.
+%extend SimTK::Vector_<double> {
+    PyObject* _numpyView(PyObject* owner) {
+        return opensimNumPyVectorView(owner, *$self, true);
+    }
+    static SimTK::Vector_<double> from_numpy(PyObject* obj) {
+        PyArrayObject* array = opensimNumPyAsArray(obj, 1);
+        SimTK::Vector_<double> v((int)PyArray_DIM(array, 0),
+                                 (const double*)PyArray_DATA(array));
+        Py_DECREF(array);
+        return v;
+    }
+%pythoncode %{
+    def to_numpy(self):
+        """A 1-D NumPy array that shares memory with this Vector."""
+        return self._numpyView(self)
+%}
+};
+%extend SimTK::RowVector_<double> {
+    PyObject* _numpyView(PyObject* owner) {
+        return opensimNumPyVectorView(owner, *$self, true);
+    }
+    static SimTK::RowVector_<double> from_numpy(PyObject* obj) {
+        PyArrayObject* array = opensimNumPyAsArray(obj, 1);
+        SimTK::RowVector_<double> v((int)PyArray_DIM(array, 0),
+                                    (const double*)PyArray_DATA(array));
+        Py_DECREF(array);
+        return v;
+    }
+%pythoncode %{
+    def to_numpy(self):
+        """A 1-D NumPy array that shares memory with this RowVector."""
+        return self._numpyView(self)
+%}
+};
+%extend SimTK::Matrix_<double> {
+    PyObject* _numpyView(PyObject* owner) {
+        return opensimNumPyMatrixView(owner, *$self, true);
+    }
+    static SimTK::Matrix_<double> from_numpy(PyObject* obj) {
+        PyArrayObject* array = opensimNumPyAsArray(obj, 2);
+        // The array is C-contiguous, i.e., stored by row.
+        SimTK::Matrix_<double> m((int)PyArray_DIM(array, 0),
+                                 (int)PyArray_DIM(array, 1),
+                                 (const double*)PyArray_DATA(array));
+        Py_DECREF(array);
+        return m;
+    }
+%pythoncode %{
+    def to_numpy(self):
+        """A 2-D NumPy array that shares memory with this Matrix."""
+        return self._numpyView(self)
+%}
+};
+
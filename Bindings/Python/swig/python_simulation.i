@@ -1,4 +1,4 @@
-%module(directors="1") simulation
+%module(directors="1", threads="1") simulation
 #pragma SWIG nowarn=822,451,503,516,325
 // 401 is "Nothing known about base class *some-class*.
 //         Maybe you forgot to instantiate *some-template* using %template."
@@ -114,9 +114,8 @@ MODEL_ADOPT_HELPER(Controller);
             for state in states:
                 model.calcMassCenterPosition(state)
         """
-        it = self.begin()
-        while it != self.end():
-            yield it.next()
+        for i in range(self.getSize()):
+            yield self.get(i)
 
     def getBetween(self, *args, **kwargs):
         iter_range = self._getBetween(*args, **kwargs)
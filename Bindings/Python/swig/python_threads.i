@@ -0,0 +1,52 @@
+// Releasing the GIL
+// ================
+// The modules are built with thread support (threads="1" in %module), which
+// lets the C++ code below run while other Python threads execute, and makes
+// director callbacks into Python reacquire the GIL. The GIL is released only
+// around the long-running calls listed here; all other wrappers keep it, as
+// most calls are too short for releasing it to pay off.
+//
+// Thread safety: a released call may run concurrently with any other Python
+// code, including another released call. This is safe as long as the threads
+// do not share C++ objects: give each thread its own Model, State, Manager
+// and Tool, and do not modify an object from Python while a released call on
+// it is running. Tools change the process's working directory to that of
+// their setup file while they run, so all the files of Tools that run
+// concurrently, including their results directories, must be given as
+// absolute paths.
+//
+// This file is included by python_preliminaries.i, so that the features are
+// declared in each module before any of the classes.
+
+%nothreadallow;
+
+// Simulation.
+%feature("nothreadallow", "0") OpenSim::Model::Model;
+%feature("nothreadallow", "0") OpenSim::Model::initSystem;
+%feature("nothreadallow", "0") OpenSim::Manager::integrate;
+%feature("nothreadallow", "0") OpenSim::Manager::integrateFromCheckpoint;
+
+// Tools.
+%feature("nothreadallow", "0") OpenSim::AnalyzeTool::run;
+%feature("nothreadallow", "0") OpenSim::CMCTool::run;
+%feature("nothreadallow", "0") OpenSim::ForwardTool::run;
+%feature("nothreadallow", "0") OpenSim::InverseDynamicsTool::run;
+%feature("nothreadallow", "0") OpenSim::InverseKinematicsTool::run;
+%feature("nothreadallow", "0") OpenSim::RRATool::run;
+%feature("nothreadallow", "0") OpenSim::ScaleTool::run;
+
+// Reading and writing files.
+%feature("nothreadallow", "0") OpenSim::Storage::Storage;
+%feature("nothreadallow", "0") OpenSim::TimeSeriesTable_::TimeSeriesTable_;
+%feature("nothreadallow", "0") OpenSim::FileAdapter::readFile;
+%feature("nothreadallow", "0") OpenSim::FileAdapter::writeFile;
+%feature("nothreadallow", "0") OpenSim::STOFileAdapter_::read;
+%feature("nothreadallow", "0") OpenSim::STOFileAdapter_::write;
+%feature("nothreadallow", "0") OpenSim::BinaryFileAdapter::read;
+%feature("nothreadallow", "0") OpenSim::BinaryFileAdapter::write;
+%feature("nothreadallow", "0") OpenSim::CSVFileAdapter::read;
+%feature("nothreadallow", "0") OpenSim::CSVFileAdapter::write;
+%feature("nothreadallow", "0") OpenSim::TRCFileAdapter::read;
+%feature("nothreadallow", "0") OpenSim::TRCFileAdapter::write;
+%feature("nothreadallow", "0") OpenSim::C3DFileAdapter::read;
+%feature("nothreadallow", "0") OpenSim::C3DFileAdapter::write;
@@ -0,0 +1,59 @@
+"""
+Test the NumPy views of vectors, matrices and tables.
+"""
+import unittest
+
+import numpy as np
+import opensim as osim
+
+class TestNumPy(unittest.TestCase):
+    def test_vector(self):
+        v = osim.Vector([1, 2, 3])
+        a = v.to_numpy()
+        assert a.shape == (3,)
+        assert list(a) == [1, 2, 3]
+        # The array shares memory with the Vector.
+        a[1] = 20
+        assert v[1] == 20
+        v[2] = 30
+        assert a[2] == 30
+
+        v = osim.Vector.from_numpy(np.array([4.0, 5.0]))
+        assert v.size() == 2 and v[0] == 4 and v[1] == 5
+
+        row = osim.RowVector([1, 2])
+        row.to_numpy()[0] = 10
+        assert row[0] == 10
+
+    def test_matrix(self):
+        a = np.arange(6.0).reshape(2, 3)
+        m = osim.Matrix.from_numpy(a)
+        assert m.nrow() == 2 and m.ncol() == 3
+        assert m.get(1, 0) == 3 and m.get(0, 2) == 2
+        view = m.to_numpy()
+        assert np.array_equal(view, a)
+        view[1, 2] = 50
+        assert m.get(1, 2) == 50
+
+        self.assertRaises(RuntimeError, osim.Matrix.from_numpy, [1, 2])
+
+    def test_table(self):
+        times = np.array([0.0, 0.1, 0.2])
+        data = np.arange(6.0).reshape(3, 2)
+        table = osim.TimeSeriesTable.from_numpy(times, data, ['a', 'b'])
+        assert table.getNumRows() == 3 and table.getNumColumns() == 2
+        assert list(table.getColumnLabels()) == ['a', 'b']
+        assert table.getRowAtIndex(2)[1] == 5
+
+        assert np.array_equal(table.independent_column_to_numpy(), times)
+        self.assertRaises(ValueError,
+                table.independent_column_to_numpy().__setitem__, 0, 1.0)
+
+        view = table.to_numpy()
+        assert np.array_equal(view, data)
+        view[0, 1] = 10
+        assert table.getDependentColumn('b')[0] == 10
+
+        # Times must match the rows.
+        self.assertRaises(RuntimeError, osim.TimeSeriesTable.from_numpy,
+                          times[:2], data, ['a', 'b'])
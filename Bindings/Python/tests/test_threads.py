@@ -0,0 +1,40 @@
+"""
+Test that simulations in separate Python threads run with the GIL released
+and give the same results as running them one after the other.
+"""
+import os
+import threading
+import unittest
+
+import opensim as osim
+
+test_dir = os.path.join(os.path.dirname(os.path.abspath(osim.__file__)),
+                        'tests')
+
+# Silence warning messages if mesh (.vtp) files cannot be found.
+osim.Model.setDebugLevel(0)
+
+def simulate(results, index):
+    model = osim.Model(os.path.join(test_dir, "arm26.osim"))
+    state = model.initSystem()
+    manager = osim.Manager(model)
+    manager.setInitialTime(0)
+    manager.setFinalTime(0.05)
+    manager.integrate(state)
+    results[index] = [state.getY()[i] for i in range(state.getNY())]
+
+class TestThreads(unittest.TestCase):
+    def test_concurrent_simulations(self):
+        serial = [None]
+        simulate(serial, 0)
+
+        results = [None] * 4
+        threads = [threading.Thread(target=simulate, args=(results, i))
+                   for i in range(len(results))]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        for result in results:
+            assert result == serial[0]
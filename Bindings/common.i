@@ -90,6 +90,7 @@ namespace OpenSim {
 
 namespace OpenSim {
     %ignore ComponentListIterator::operator++; // ignore warning 383.
+    %ignore ComponentListBucket;
 }
 %include <OpenSim/Common/ComponentList.h>
 
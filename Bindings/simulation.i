@@ -17,6 +17,7 @@
 
 %include <OpenSim/Simulation/Solver.h>
 %include <OpenSim/Simulation/InverseDynamicsSolver.h>
+%include <OpenSim/Simulation/StreamingInverseDynamicsSolver.h>
 %include <OpenSim/Simulation/MomentArmSolver.h>
 
 %include <OpenSim/Simulation/Model/Frame.h>
@@ -98,6 +99,7 @@
 %include <OpenSim/Simulation/Model/ExternalLoads.h>
 %include <OpenSim/Simulation/Model/PrescribedForce.h>
 %include <OpenSim/Simulation/Model/CoordinateLimitForce.h>
+%include <OpenSim/Simulation/Model/BatchedCoordinateLimitForce.h>
 
 %include <OpenSim/Simulation/Model/ContactGeometry.h>
 %template(SetContactGeometry) OpenSim::Set<OpenSim::ContactGeometry>;
@@ -108,6 +110,7 @@
 %include <OpenSim/Simulation/Model/ContactSphere.h>
 %include <OpenSim/Simulation/Model/ElasticFoundationForce.h>
 %include <OpenSim/Simulation/Model/HuntCrossleyForce.h>
+%include <OpenSim/Simulation/Model/SphereHalfSpaceContactForce.h>
 
 %include <OpenSim/Simulation/Model/Actuator.h>
 %template(SetActuators) OpenSim::Set<OpenSim::Actuator>;
@@ -124,6 +127,9 @@
 %include <OpenSim/Simulation/Control/ControlLinear.h>
 %include <OpenSim/Simulation/Control/Controller.h>
 %include <OpenSim/Simulation/Control/PrescribedController.h>
+%include <OpenSim/Simulation/Control/LiveController.h>
+%include <OpenSim/Simulation/Control/TaskSpaceController.h>
+%include <OpenSim/Simulation/Control/ReflexController.h>
 
 %include <OpenSim/Simulation/Manager/Manager.h>
 %include <OpenSim/Simulation/Model/AbstractTool.h>
@@ -181,6 +187,10 @@
 %include <OpenSim/Simulation/Model/PathActuator.h>
 %include <OpenSim/Simulation/Model/Muscle.h>
 %include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
+%include <OpenSim/Simulation/Model/MuscleGroup.h>
+%include <OpenSim/Simulation/Model/Condition.h>
+%include <OpenSim/Simulation/Model/FunctionThresholdCondition.h>
+%include <OpenSim/Simulation/Model/ConditionEvent.h>
 %include <OpenSim/Simulation/Model/PointToPointSpring.h>
 %include <OpenSim/Simulation/Model/ExpressionBasedPointToPointForce.h>
 %include <OpenSim/Simulation/Model/ExpressionBasedCoordinateForce.h>
@@ -189,18 +199,25 @@
 %include <OpenSim/Simulation/Model/BushingForce.h>
 %include <OpenSim/Simulation/Model/FunctionBasedBushingForce.h>
 %include <OpenSim/Simulation/Model/ExpressionBasedBushingForce.h>
+%include <OpenSim/Simulation/Model/BatchedBushingForce.h>
 
 %include <OpenSim/Simulation/Solver.h>
 %include <OpenSim/Simulation/Reference.h>
 
 %template(ReferenceVec3) OpenSim::Reference_<SimTK::Vec3>;
 %template(ReferenceDouble) OpenSim::Reference_<double>;
+%template(ReferenceRotation) OpenSim::Reference_<SimTK::Rotation_<double>>;
 %template(ArrayCoordinateReference) SimTK::Array_<OpenSim::CoordinateReference>;
 
 %include <OpenSim/Simulation/MarkersReference.h>
+%include <OpenSim/Simulation/StreamingMarkersReference.h>
+%include <OpenSim/Simulation/OrientationsReference.h>
+%template(SetOrientationWeights) OpenSim::Set<OpenSim::OrientationWeight>;
+%include <OpenSim/Simulation/StreamingOrientationsReference.h>
 %include <OpenSim/Simulation/CoordinateReference.h>
 %include <OpenSim/Simulation/AssemblySolver.h>
 %include <OpenSim/Simulation/InverseKinematicsSolver.h>
+%include <OpenSim/Simulation/GaussNewtonIKSolver.h>
 
 %include <OpenSim/Simulation/StatesTrajectory.h>
 // This enables iterating using the getBetween() method.
@@ -34,3 +34,4 @@
 %include <OpenSim/Tools/RRATool.h>
 %include <OpenSim/Tools/AnalyzeTool.h>
 %include <OpenSim/Tools/InverseKinematicsTool.h>
+%include <OpenSim/Tools/MuscleAtlasTool.h>
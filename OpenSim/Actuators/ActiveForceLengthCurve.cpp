@@ -80,6 +80,7 @@ void ActiveForceLengthCurve::constructProperties()
     constructProperty_max_norm_active_fiber_length(1.8123);
     constructProperty_shallow_ascending_slope(0.8616);
     constructProperty_minimum_value(0.1);
+    constructProperty_tabulation_tolerance(0.0);
 }
 
 void ActiveForceLengthCurve::buildCurve()
@@ -87,6 +88,7 @@ void ActiveForceLengthCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    m_curve.tabulate(get_tabulation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
@@ -148,6 +150,15 @@ void ActiveForceLengthCurve::setMinValue(double minimumValue)
     ensureCurveUpToDate();
 }
 
+double ActiveForceLengthCurve::getTabulationTolerance() const
+{   return get_tabulation_tolerance(); }
+
+void ActiveForceLengthCurve::setTabulationTolerance(double tolerance)
+{
+    set_tabulation_tolerance(tolerance);
+    ensureCurveUpToDate();
+}
+
 //==============================================================================
 // SERVICES
 //==============================================================================
@@ -158,6 +169,14 @@ double ActiveForceLengthCurve::calcValue(double normFiberLength) const
     return m_curve.calcValue(normFiberLength);
 }
 
+void ActiveForceLengthCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "ActiveForceLengthCurve: Curve is not up-to-date with its properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double ActiveForceLengthCurve::calcDerivative(double normFiberLength,
                                               int order) const
 {
@@ -128,6 +128,9 @@ public:
     OpenSim_DECLARE_PROPERTY(minimum_value, double,
         "Minimum value of the active-force-length curve");
 
+    OpenSim_DECLARE_PROPERTY(tabulation_tolerance, double,
+        "Largest error of the values and slopes of the curve evaluated from a table, or 0 to evaluate the curve exactly");
+
 //==============================================================================
 // PUBLIC METHODS
 //==============================================================================
@@ -207,7 +210,13 @@ public:
 
     /** Evaluates the active-force-length curve at a normalized fiber length of
     'normFiberLength'. */
-    double calcValue(double normFiberLength) const;
+    double calcValue(double normFiberLength) const override;
+
+    /** Evaluates the active-force-length curve at each of the normalized fiber lengths in 'x', as
+    calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
 
     /** Calculates the derivative of the active-force-length multiplier with
@@ -220,7 +229,7 @@ public:
         The derivative of the active-force-length curve with respect to the
         normalized fiber length.
     */
-    double calcDerivative(double normFiberLength, int order) const;
+    double calcDerivative(double normFiberLength, int order) const override;
 
     /** Returns a SimTK::Vec2 containing the lower (0th element) and upper (1st
     element) bounds on the domain of the curve. Outside this domain, the curve
@@ -264,6 +273,17 @@ public:
     void printMuscleCurveToCSVFile(const std::string& path);
 
     void ensureCurveUpToDate();
+
+    /** @returns The largest error allowed in the values and slopes of the
+    curve evaluated from a table, or 0 if the curve is evaluated exactly. */
+    double getTabulationTolerance() const;
+
+    /** Evaluate the values and slopes of the curve from a table with at most
+    the given error, which is much cheaper than evaluating the curve exactly.
+    The curves of all the muscles with identical curve parameters share one
+    table. A tolerance of 0 evaluates the curve exactly (the default). See
+    SmoothSegmentedFunction::tabulate() for details. */
+    void setTabulationTolerance(double tolerance);
 //==============================================================================
 // PRIVATE
 //==============================================================================
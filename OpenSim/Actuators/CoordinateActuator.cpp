@@ -203,6 +203,26 @@ void CoordinateActuator::computeForce( const SimTK::State& s,
     }
 }
 
+bool CoordinateActuator::findDynamicsDependencies(const SimTK::State& s,
+        std::vector<int>& yIndices, std::vector<int>& controlIndices,
+        std::vector<int>& uIndices) const
+{
+    if (!isCoordinateValid()) return false;
+
+    const SimTK::MobilizedBody& mobod =
+        _model->getMatterSubsystem().getMobilizedBody(_coord->getBodyIndex());
+    uIndices.push_back(
+        int(mobod.getFirstUIndex(s)) + _coord->getMobilizerQIndex());
+
+    // The states of a derived actuator (a CoordinateActuator has none).
+    for (int y : getStateVariableYIndices(s))
+        if (y >= 0) yIndices.push_back(y);
+
+    for (int i = 0; i < numControls(); ++i)
+        controlIndices.push_back(_controlIndex + i);
+    return true;
+}
+
 double CoordinateActuator::
 getSpeed( const SimTK::State& s) const
 {
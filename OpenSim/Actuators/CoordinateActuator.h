@@ -85,6 +85,12 @@ public:
     /** Get a pointer to the Coordinate to which this actuator refers. **/
     Coordinate* getCoordinate() const;
 
+    /** The force depends on the controls (and any states) of the actuator
+    alone, and acts on the mobility of its coordinate. **/
+    bool findDynamicsDependencies(const SimTK::State& s,
+            std::vector<int>& yIndices, std::vector<int>& controlIndices,
+            std::vector<int>& uIndices) const override;
+
 //==============================================================================
 // PRIVATE
 //==============================================================================
@@ -235,6 +235,15 @@ double FiberCompressiveForceCosPennationCurve::
     return m_curve.calcValue(cosPennationAngle);
 }
 
+void FiberCompressiveForceCosPennationCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
+        "FiberCompressiveCosPennationCurve: Curve is not"
+        " to date with its properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double FiberCompressiveForceCosPennationCurve::
     calcDerivative(double cosPennationAngle, int order) const
 {
@@ -296,7 +296,13 @@ public:
     \endverbatim
 
     */
-    double calcValue(double cosPennationAngle) const;
+    double calcValue(double cosPennationAngle) const override;
+
+    /** Evaluates the curve at each of the cosines of the pennation angle in
+    'x', as calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
 
     /** Implement the generic OpenSim::Function interface **/
@@ -325,7 +331,7 @@ public:
     \endverbatim
 
     */
-    double calcDerivative(double cosPennationAngle, int order) const;
+    double calcDerivative(double cosPennationAngle, int order) const override;
 
     /**     
     @param cosPennationAngle
@@ -224,6 +224,15 @@ double FiberCompressiveForceLengthCurve::calcValue(double aNormLength) const
     return m_curve.calcValue(aNormLength);
 }
 
+void FiberCompressiveForceLengthCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
+        "FiberCompressiveForceLengthCurve: Curve is not"
+        " to date with its properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double FiberCompressiveForceLengthCurve::calcIntegral(double aNormLength) const
 {    
     SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
@@ -233,7 +233,13 @@ public:
     \endverbatim
 
     */
-    double calcValue(double aNormLength) const;
+    double calcValue(double aNormLength) const override;
+
+    /** Evaluates the curve at each of the normalized fiber lengths in 'x', as
+    calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
  
     /** Implement the generic OpenSim::Function interface **/
@@ -266,7 +272,7 @@ public:
     \endverbatim
 
     */
-    double calcDerivative(double aNormLength, int order) const;
+    double calcDerivative(double aNormLength, int order) const override;
 
     /**     
     @param aNormLength
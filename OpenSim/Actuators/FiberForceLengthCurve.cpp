@@ -77,6 +77,7 @@ void FiberForceLengthCurve::constructProperties()
     constructProperty_stiffness_at_low_force();
     constructProperty_stiffness_at_one_norm_force();
     constructProperty_curviness();
+    constructProperty_tabulation_tolerance(0.0);
 }
 
 void FiberForceLengthCurve::buildCurve(bool computeIntegral)
@@ -93,6 +94,7 @@ void FiberForceLengthCurve::buildCurve(bool computeIntegral)
 
     m_curve = *f;
     delete f;
+    m_curve.tabulate(get_tabulation_tolerance());
 
     setObjectIsUpToDateWithProperties();
 }
@@ -209,6 +211,15 @@ void FiberForceLengthCurve::setOptionalProperties(double aStiffnessAtLowForce,
     ensureCurveUpToDate();
 }
 
+double FiberForceLengthCurve::getTabulationTolerance() const
+{   return get_tabulation_tolerance(); }
+
+void FiberForceLengthCurve::setTabulationTolerance(double tolerance)
+{
+    set_tabulation_tolerance(tolerance);
+    ensureCurveUpToDate();
+}
+
 //==============================================================================
 // SERVICES
 //==============================================================================
@@ -219,6 +230,14 @@ double FiberForceLengthCurve::calcValue(double normFiberLength) const
     return m_curve.calcValue(normFiberLength);
 }
 
+void FiberForceLengthCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "FiberForceLengthCurve: Curve is not up-to-date with its properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double FiberForceLengthCurve::calcDerivative(double normFiberLength,
                                              int order) const
 {
@@ -173,6 +173,9 @@ public:
     OpenSim_DECLARE_OPTIONAL_PROPERTY(curviness, double,
         "Fiber curve bend, from linear (0) to maximum bend (1)");
 
+    OpenSim_DECLARE_PROPERTY(tabulation_tolerance, double,
+        "Largest error of the values and slopes of the curve evaluated from a table, or 0 to evaluate the curve exactly");
+
 //==============================================================================
 // PUBLIC METHODS
 //==============================================================================
@@ -277,7 +280,13 @@ public:
 
     /** Evaluates the fiber-force-length curve at a normalized fiber length of
     'normFiberLength'. */
-    double calcValue(double normFiberLength) const;
+    double calcValue(double normFiberLength) const override;
+
+    /** Evaluates the fiber-force-length curve at each of the normalized fiber lengths in 'x', as
+    calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
     /** Calculates the derivative of the fiber-force-length multiplier with
     respect to the normalized fiber length.
@@ -289,7 +298,7 @@ public:
         The derivative of the fiber-force-length curve with respect to the
         normalized fiber length.
     */
-    double calcDerivative(double normFiberLength, int order) const;
+    double calcDerivative(double normFiberLength, int order) const override;
 
     /** Calculates the normalized area under the curve. Since it is expensive to
     construct, the curve is built only when necessary.
@@ -343,6 +352,17 @@ public:
     void printMuscleCurveToCSVFile(const std::string& path);
 
     void ensureCurveUpToDate();
+
+    /** @returns The largest error allowed in the values and slopes of the
+    curve evaluated from a table, or 0 if the curve is evaluated exactly. */
+    double getTabulationTolerance() const;
+
+    /** Evaluate the values and slopes of the curve from a table with at most
+    the given error, which is much cheaper than evaluating the curve exactly.
+    The curves of all the muscles with identical curve parameters share one
+    table. A tolerance of 0 evaluates the curve exactly (the default). See
+    SmoothSegmentedFunction::tabulate() for details. */
+    void setTabulationTolerance(double tolerance);
 //==============================================================================
 // PRIVATE
 //==============================================================================
@@ -82,6 +82,7 @@ void ForceVelocityCurve::constructProperties()
     constructProperty_max_eccentric_velocity_force_multiplier(1.4);
     constructProperty_concentric_curviness(0.6);
     constructProperty_eccentric_curviness(0.9);
+    constructProperty_tabulation_tolerance(0.0);
 }
 
 void ForceVelocityCurve::buildCurve()
@@ -89,6 +90,7 @@ void ForceVelocityCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    m_curve.tabulate(get_tabulation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
@@ -166,6 +168,15 @@ void ForceVelocityCurve::setEccentricCurviness(double aEccentricCurviness)
     ensureCurveUpToDate();
 }
 
+double ForceVelocityCurve::getTabulationTolerance() const
+{   return get_tabulation_tolerance(); }
+
+void ForceVelocityCurve::setTabulationTolerance(double tolerance)
+{
+    set_tabulation_tolerance(tolerance);
+    ensureCurveUpToDate();
+}
+
 //==============================================================================
 // SERVICES
 //==============================================================================
@@ -176,6 +187,14 @@ double ForceVelocityCurve::calcValue(double normFiberVelocity) const
     return m_curve.calcValue(normFiberVelocity);
 }
 
+void ForceVelocityCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "ForceVelocityCurve: Curve is not up-to-date with its properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double ForceVelocityCurve::calcDerivative(double normFiberVelocity,
                                           int order) const
 {
@@ -159,6 +159,9 @@ public:
     OpenSim_DECLARE_PROPERTY(eccentric_curviness, double,
         "Eccentric curve shape, from linear (0) to maximal curve (1)");
 
+    OpenSim_DECLARE_PROPERTY(tabulation_tolerance, double,
+        "Largest error of the values and slopes of the curve evaluated from a table, or 0 to evaluate the curve exactly");
+
 //==============================================================================
 // PUBLIC METHODS
 //==============================================================================
@@ -303,7 +306,13 @@ public:
 
     /** Evaluates the force-velocity curve at a normalized fiber velocity of
     'normFiberVelocity'. */
-    double calcValue(double normFiberVelocity) const;
+    double calcValue(double normFiberVelocity) const override;
+
+    /** Evaluates the force-velocity curve at each of the normalized fiber velocities in 'x', as
+    calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
     /** Calculates the derivative of the force-velocity multiplier with respect
     to the normalized fiber velocity.
@@ -315,7 +324,7 @@ public:
         The derivative of the force-velocity curve with respect to the
         normalized fiber velocity.
     */
-    double calcDerivative(double normFiberVelocity, int order) const;
+    double calcDerivative(double normFiberVelocity, int order) const override;
 
     /** Returns a SimTK::Vec2 containing the lower (0th element) and upper (1st
     element) bounds on the domain of the curve. Outside this domain, the curve
@@ -358,6 +367,17 @@ public:
     void printMuscleCurveToCSVFile(const std::string& path);
 
     void ensureCurveUpToDate();
+
+    /** @returns The largest error allowed in the values and slopes of the
+    curve evaluated from a table, or 0 if the curve is evaluated exactly. */
+    double getTabulationTolerance() const;
+
+    /** Evaluate the values and slopes of the curve from a table with at most
+    the given error, which is much cheaper than evaluating the curve exactly.
+    The curves of all the muscles with identical curve parameters share one
+    table. A tolerance of 0 evaluates the curve exactly (the default). See
+    SmoothSegmentedFunction::tabulate() for details. */
+    void setTabulationTolerance(double tolerance);
 //==============================================================================
 // PRIVATE
 //==============================================================================
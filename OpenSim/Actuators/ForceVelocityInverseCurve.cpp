@@ -83,6 +83,7 @@ void ForceVelocityInverseCurve::constructProperties()
     constructProperty_max_eccentric_velocity_force_multiplier(1.4);
     constructProperty_concentric_curviness(0.6);
     constructProperty_eccentric_curviness(0.9);
+    constructProperty_tabulation_tolerance(0.0);
 }
 
 void ForceVelocityInverseCurve::buildCurve()
@@ -90,6 +91,7 @@ void ForceVelocityInverseCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    m_curve.tabulate(get_tabulation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
@@ -168,6 +170,15 @@ setEccentricCurviness(double aEccentricCurviness)
     ensureCurveUpToDate();
 }
 
+double ForceVelocityInverseCurve::getTabulationTolerance() const
+{   return get_tabulation_tolerance(); }
+
+void ForceVelocityInverseCurve::setTabulationTolerance(double tolerance)
+{
+    set_tabulation_tolerance(tolerance);
+    ensureCurveUpToDate();
+}
+
 //==============================================================================
 // SERVICES
 //==============================================================================
@@ -180,6 +191,15 @@ calcValue(double aForceVelocityMultiplier) const
     return m_curve.calcValue(aForceVelocityMultiplier);
 }
 
+void ForceVelocityInverseCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "FiberForceVelocityInverseCurve: Curve is not up-to-date with its "
+        "properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double ForceVelocityInverseCurve::
 calcDerivative(double aForceVelocityMultiplier, int order) const
 {
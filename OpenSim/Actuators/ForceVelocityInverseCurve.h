@@ -127,6 +127,9 @@ public:
     OpenSim_DECLARE_PROPERTY(eccentric_curviness, double,
         "Shape of eccentric branch of force-velocity curve, from linear (0) to maximal curve (1)");
 
+    OpenSim_DECLARE_PROPERTY(tabulation_tolerance, double,
+        "Largest error of the values and slopes of the curve evaluated from a table, or 0 to evaluate the curve exactly");
+
 //==============================================================================
 // PUBLIC METHODS
 //==============================================================================
@@ -271,7 +274,13 @@ public:
 
     /** Evaluates the inverse force-velocity curve at a force-velocity
     multiplier value of 'aForceVelocityMultiplier'. */
-    double calcValue(double aForceVelocityMultiplier) const;
+    double calcValue(double aForceVelocityMultiplier) const override;
+
+    /** Evaluates the inverse force-velocity curve at each of the force-velocity multipliers in 'x', as
+    calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
     /** Calculates the derivative of the inverse force-velocity curve with
     respect to the force-velocity multiplier.
@@ -283,7 +292,7 @@ public:
         The derivative of the inverse force-velocity curve with respect to the
         force-velocity multiplier.
     */
-    double calcDerivative(double aForceVelocityMultiplier, int order) const;
+    double calcDerivative(double aForceVelocityMultiplier, int order) const override;
 
     /** Returns a SimTK::Vec2 containing the lower (0th element) and upper (1st
     element) bounds on the domain of the curve. Outside this domain, the curve
@@ -326,6 +335,17 @@ public:
     void printMuscleCurveToCSVFile(const std::string& path);
 
     void ensureCurveUpToDate();
+
+    /** @returns The largest error allowed in the values and slopes of the
+    curve evaluated from a table, or 0 if the curve is evaluated exactly. */
+    double getTabulationTolerance() const;
+
+    /** Evaluate the values and slopes of the curve from a table with at most
+    the given error, which is much cheaper than evaluating the curve exactly.
+    The curves of all the muscles with identical curve parameters share one
+    table. A tolerance of 0 evaluates the curve exactly (the default). See
+    SmoothSegmentedFunction::tabulate() for details. */
+    void setTabulationTolerance(double tolerance);
 //==============================================================================
 // PRIVATE
 //==============================================================================
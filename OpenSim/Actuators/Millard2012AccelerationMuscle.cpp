@@ -206,7 +206,15 @@ void Millard2012AccelerationMuscle::buildMuscle()
     fseCurve.ensureCurveUpToDate();
     fkCurve.ensureCurveUpToDate();
     fcphi.ensureCurveUpToDate();
-    
+
+    // The potential energy of the muscle uses the integrals of these curves,
+    // which are otherwise built the first time they are evaluated. Build them
+    // now so that the curves are not modified while the muscle is evaluated
+    // (possibly by several threads sharing the model).
+    fpeCurve.calcIntegral(1.0);
+    fseCurve.calcIntegral(1.0);
+    fkCurve.calcIntegral(1.0);
+    fcphi.calcIntegral(1.0);
    
     setObjectIsUpToDateWithProperties();
 }
@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 #include "Millard2012EquilibriumMuscle.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/Logger.h>
 
 using namespace std;
 using namespace OpenSim;
@@ -89,6 +90,14 @@ void Millard2012EquilibriumMuscle::extendFinalizeFromProperties()
     // we remain sufficiently far from the numerical singularity at beta=0.
     use_fiber_damping = (getFiberDamping() >= MIN_NONZERO_DAMPING_COEFFICIENT);
 
+    if(get_ignore_tendon_compliance())
+        m_fiberVelocityModel = FiberVelocityModel::RigidTendon;
+    else if(!use_fiber_damping)
+        m_fiberVelocityModel = FiberVelocityModel::ElasticTendon;
+    else
+        m_fiberVelocityModel = FiberVelocityModel::DampedElasticTendon;
+    m_ignoreActivationDynamics = get_ignore_activation_dynamics();
+
     // To initialize, we need to construct an *inverse* force-velocity curve
     // from the parameters of the force-velocity curve.
     double conSlopeAtVmax   = fvCurve.getConcentricSlopeAtVmax();
@@ -240,6 +249,29 @@ const MuscleFirstOrderActivationDynamicModel& Millard2012EquilibriumMuscle::
 getActivationModel() const
 { return getMemberSubcomponent<MuscleFirstOrderActivationDynamicModel>(actMdlIdx); }
 
+bool Millard2012EquilibriumMuscle::getFirstOrderActivationParameters(
+        double& minimumActivation, double& activationTimeConstant,
+        double& deactivationTimeConstant) const
+{
+    if (get_ignore_activation_dynamics())
+        return false;
+    const MuscleFirstOrderActivationDynamicModel& actMdl = getActivationModel();
+    minimumActivation = actMdl.get_minimum_activation();
+    activationTimeConstant = actMdl.get_activation_time_constant();
+    deactivationTimeConstant = actMdl.get_deactivation_time_constant();
+    return true;
+}
+
+double Millard2012EquilibriumMuscle::
+getClampedActivation(const SimTK::State& s) const
+{
+    if(!m_ignoreActivationDynamics) {
+        return getActivationModel().clampActivation(
+                getStateVariableValue(s, STATE_ACTIVATION_NAME));
+    }
+    return getActivationModel().clampActivation(getControl(s));
+}
+
 double Millard2012EquilibriumMuscle::getMinimumFiberLength() const
 {   return m_minimumFiberLength; }
 double Millard2012EquilibriumMuscle::getMinimumFiberLengthAlongTendon() const
@@ -263,6 +295,11 @@ getActivationDerivative(const SimTK::State& s) const
     if (get_ignore_activation_dynamics())
         return 0.0;
 
+    // Computed by the Model together with those of other muscles.
+    double adot;
+    if (getBatchedActivationDerivative(s, adot))
+        return adot;
+
     return getActivationModel().calcDerivative(getActivation(s),
                                                getExcitation(s));
 }
@@ -293,6 +330,10 @@ getPassiveFiberDampingForceAlongTendon(const SimTK::State& s) const
            getMuscleLengthInfo(s).cosPennationAngle;
 }
 
+double Millard2012EquilibriumMuscle::
+getEquilibriumIterations(const SimTK::State& s) const
+{   return (double)_equilibriumIterations.get(); }
+
 
 //==============================================================================
 // SET METHODS
@@ -400,6 +441,11 @@ computeInitialFiberEquilibrium(SimTK::State& s) const
         getActivationModel().clampActivation(getActivation(s));
     setActivation(s,clampedActivation);
 
+    // The fiber length in the state (e.g., the solution at the previous time
+    // step) is used as the initial guess for the Newton iterations.
+    const double previousFiberLength =
+        getStateVariableValue(s, STATE_FIBER_LENGTH_NAME);
+
     // Initialize the multibody system to the initial state vector.
     setFiberLength(s, getOptimalFiberLength());
     _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
@@ -420,8 +466,9 @@ computeInitialFiberEquilibrium(SimTK::State& s) const
     try {
         std::pair<StatusFromEstimateMuscleFiberState,
                   ValuesFromEstimateMuscleFiberState> result =
-            estimateMuscleFiberState(clampedActivation, pathLength,
-                                     pathLengtheningSpeed, tol, maxIter);
+            estimateMuscleFiberStateFrom(previousFiberLength,
+                                         clampedActivation, pathLength,
+                                         pathLengtheningSpeed, tol, maxIter);
 
         switch(result.first) {
 
@@ -431,9 +478,9 @@ computeInitialFiberEquilibrium(SimTK::State& s) const
             break;
 
         case StatusFromEstimateMuscleFiberState::Warning_FiberAtLowerBound:
-            printf("\n\nMillard2012EquilibriumMuscle initialization:"
-                   " %s is at its minimum fiber length of %f\n",
-                   getName().c_str(), result.second["fiber_length"]);
+            OPENSIM_WARN("\n\nMillard2012EquilibriumMuscle initialization: "
+                << getName() << " is at its minimum fiber length of "
+                << result.second["fiber_length"]);
             setActuation(s, result.second["tendon_force"]);
             setFiberLength(s, result.second["fiber_length"]);
             break;
@@ -456,6 +503,148 @@ computeInitialFiberEquilibrium(SimTK::State& s) const
     }
 }
 
+SimTK::Mat23 Millard2012EquilibriumMuscle::
+calcFiberEquilibriumSensitivities(const SimTK::State& s) const
+{
+    const MuscleLengthInfo& mli = getMuscleLengthInfo(s);
+    const FiberVelocityInfo& fvi = getFiberVelocityInfo(s);
+    const MuscleFixedWidthPennationModel& penMdl = getPennationModel();
+
+    double fiso   = getMaxIsometricForce();
+    double ofl    = getOptimalFiberLength();
+    double tsl    = getTendonSlackLength();
+    double vmax   = getMaxContractionVelocity();
+    double beta   = getFiberDamping();
+    double a      = getClampedActivation(s);
+    double lce    = mli.fiberLength;
+    double sinphi = mli.sinPennationAngle;
+    double cosphi = mli.cosPennationAngle;
+    double fal    = mli.fiberActiveForceLengthMultiplier;
+    double fv     = fvi.fiberForceVelocityMultiplier;
+    double dlceN  = fvi.normFiberVelocity;
+    double dml    = getLengtheningSpeed(s);
+
+    // Partial derivatives of the fiber force along the tendon.
+    SimTK::Vec4 fiberForceV = calcFiberForce(fiso, a, fal, fv,
+            mli.fiberPassiveForceLengthMultiplier, dlceN);
+    double dFm_dlce      = calcFiberStiffness(fiso, a, fv,
+                                              mli.normFiberLength, ofl);
+    double dFmAT_dlce    = calc_DFiberForceAT_DFiberLength(fiberForceV[0],
+                               dFm_dlce, lce, sinphi, cosphi);
+    double dFmAT_da      = fiso*fal*fv*cosphi;
+    double dFmAT_ddlceN  = calc_DFiberForce_DNormFiberVelocity(fiso, a, fal,
+                               beta, dlceN)*cosphi;
+
+    SimTK::Mat23 sensitivities;
+    sensitivities.setToZero();
+    bool clamped = fvi.userDefinedVelocityExtras[0] > 0.5;
+
+    if(m_fiberVelocityModel == FiberVelocityModel::RigidTendon) {
+        // The fiber length follows from the path length alone, and the tendon
+        // transmits the fiber force along the tendon.
+        if(mli.tendonLength < tsl - SimTK::SignificantReal) {
+            // The tendon is buckling, so it transmits no force.
+            return sensitivities;
+        }
+        double dlce_dml = clamped ? 0.0 : cosphi;
+        double dphi_dlce = penMdl.calc_DPennationAngle_DfiberLength(lce);
+        // The fiber velocity is dml*cosphi.
+        double ddlceN_dml  = -dml*sinphi*dphi_dlce*dlce_dml/(vmax*ofl);
+        double ddlceN_ddml = clamped ? 0.0 : cosphi/(vmax*ofl);
+
+        sensitivities(0,1) = dlce_dml;
+        sensitivities(1,0) = dFmAT_da;
+        sensitivities(1,1) = dFmAT_dlce*dlce_dml + dFmAT_ddlceN*ddlceN_dml;
+        sensitivities(1,2) = dFmAT_ddlceN*ddlceN_ddml;
+        return sensitivities;
+    }
+
+    // Partial derivatives of the tendon force.
+    const TendonForceLengthCurve& fseCurve = get_TendonForceLengthCurve();
+    double dFt_dtl  = fseCurve.calcDerivative(mli.normTendonLength,1)*fiso/tsl;
+    double dFt_dlce = calc_DTendonForce_DFiberLength(dFt_dtl, lce, sinphi,
+                                                     cosphi);
+    if(clamped) {
+        sensitivities(1,1) = dFt_dtl;
+        return sensitivities;
+    }
+
+    // The fiber velocity along the tendon, as shared between the fiber and the
+    // tendon by estimateMuscleFiberState().
+    double dFmAT_dlceAT = calc_DFiberForceAT_DFiberLengthAT(dFmAT_dlce, sinphi,
+                                                            cosphi, lce);
+    double ddlceN_ddml = cosphi/(vmax*ofl);
+    if(abs(dFmAT_dlceAT + dFt_dtl) > SimTK::SignificantReal
+       && mli.normTendonLength > 1.0) {
+        ddlceN_ddml *= dFt_dtl/(dFmAT_dlceAT + dFt_dtl);
+    } else {
+        ddlceN_ddml = 0.0;
+    }
+
+    // Equilibrium error: ferr = FmAT(lce, dlceN, a) - Ft(ml - lceAT(lce)).
+    double dferr_dlce = dFmAT_dlce - dFt_dlce;
+    SimTK::Vec3 dferr_dp(dFmAT_da, -dFt_dtl, dFmAT_ddlceN*ddlceN_ddml);
+    if(abs(dferr_dlce) <= SimTK::SignificantReal) {
+        sensitivities.setToNaN();
+        return sensitivities;
+    }
+
+    for(int i = 0; i < 3; ++i) {
+        double dlce_dp = -dferr_dp[i]/dferr_dlce;
+        sensitivities(0,i) = dlce_dp;
+        sensitivities(1,i) = dFt_dlce*dlce_dp;
+    }
+    sensitivities(1,1) += dFt_dtl;
+    return sensitivities;
+}
+
+void Millard2012EquilibriumMuscle::
+calcActiveFiberForcesAlongTendon(const SimTK::Vector& activations,
+                                 const SimTK::Vector& fiberLengths,
+                                 const SimTK::Vector& fiberVelocities,
+                                 SimTK::Vector& forces) const
+{
+    const int n = activations.size();
+    OPENSIM_THROW_IF_FRMOBJ(
+        fiberLengths.size() != n || fiberVelocities.size() != n, Exception,
+        "Expected " + std::to_string(n) + " fiber lengths and velocities, "
+        "but got " + std::to_string(fiberLengths.size()) + " and " +
+        std::to_string(fiberVelocities.size()) + ".");
+    forces.resize(n);
+
+    double fiso = getMaxIsometricForce();
+    double ofl  = getOptimalFiberLength();
+    double vmax = getMaxContractionVelocity();
+
+    // Normalize the fiber lengths and velocities of all lanes, then evaluate
+    // each curve at all of them at once.
+    SimTK::Vector lceN(n), dlceN(n);
+    for(int i = 0; i < n; ++i) {
+        lceN[i]  = fiberLengths[i]/ofl;
+        dlceN[i] = fiberVelocities[i]/(ofl*vmax);
+    }
+    SimTK::Vector fal, fv, fpe;
+    get_ActiveForceLengthCurve().calcValues(lceN, fal);
+    get_ForceVelocityCurve().calcValues(dlceN, fv);
+    get_FiberForceLengthCurve().calcValues(lceN, fpe);
+
+    const MuscleFirstOrderActivationDynamicModel& actMdl =
+        getActivationModel();
+    const MuscleFixedWidthPennationModel& penMdl = getPennationModel();
+    double lceMin = getMinimumFiberLength();
+    for(int i = 0; i < n; ++i) {
+        if(fiberLengths[i] <= lceMin) {
+            forces[i] = 0.0;
+            continue;
+        }
+        double ca  = actMdl.clampActivation(activations[i]);
+        double phi = penMdl.calcPennationAngle(lceN[i]);
+        SimTK::Vec4 fiberForceV =
+            calcFiberForce(fiso, ca, fal[i], fv[i], fpe[i], dlceN[i]);
+        forces[i] = fiberForceV[1]*cos(phi);
+    }
+}
+
 void Millard2012EquilibriumMuscle::
 computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
 {
@@ -485,8 +674,10 @@ computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
     try {
         std::pair<StatusFromEstimateMuscleFiberState,
                   ValuesFromEstimateMuscleFiberState> result =
-            estimateMuscleFiberState(activation, pathLength, pathLengtheningSpeed,
-                                     tol, maxIter, true);
+            estimateMuscleFiberStateFrom(
+                getStateVariableValue(s, STATE_FIBER_LENGTH_NAME),
+                activation, pathLength, pathLengtheningSpeed,
+                tol, maxIter, true);
 
         switch(result.first) {
 
@@ -496,9 +687,9 @@ computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
             break;
 
         case StatusFromEstimateMuscleFiberState::Warning_FiberAtLowerBound:
-            printf("\n\nMillard2012EquilibriumMuscle static solution:"
-                   " %s is at its minimum fiber length of %f\n",
-                   getName().c_str(), result.second["fiber_length"]);
+            OPENSIM_WARN("\n\nMillard2012EquilibriumMuscle static solution: "
+                << getName() << " is at its minimum fiber length of "
+                << result.second["fiber_length"]);
             setActuation(s, result.second["tendon_force"]);
             setFiberLength(s, result.second["fiber_length"]);
             break;
@@ -554,10 +745,12 @@ void Millard2012EquilibriumMuscle::calcMuscleLengthInfo(const SimTK::State& s,
         const ActiveForceLengthCurve& falCurve = get_ActiveForceLengthCurve();
         const FiberForceLengthCurve&  fpeCurve = get_FiberForceLengthCurve();
         //const TendonForceLengthCurve& fseCurve = get_TendonForceLengthCurve();
+        const MuscleFixedWidthPennationModel& penMdl = getPennationModel();
+        const double mclLength = getLength(s);
 
-        if(get_ignore_tendon_compliance()) {                //rigid tendon
+        if(m_fiberVelocityModel == FiberVelocityModel::RigidTendon) {
             mli.fiberLength = clampFiberLength(
-                               getPennationModel().calcFiberLength(getLength(s),
+                               penMdl.calcFiberLength(mclLength,
                                tendonSlackLen));
         } else {                                            // elastic tendon
             mli.fiberLength = clampFiberLength(
@@ -565,17 +758,15 @@ void Millard2012EquilibriumMuscle::calcMuscleLengthInfo(const SimTK::State& s,
         }
 
         mli.normFiberLength   = mli.fiberLength / optFiberLength;
-        mli.pennationAngle    = getPennationModel().
-                                    calcPennationAngle(mli.fiberLength);
+        mli.pennationAngle    = penMdl.calcPennationAngle(mli.fiberLength);
         mli.cosPennationAngle = cos(mli.pennationAngle);
         mli.sinPennationAngle = sin(mli.pennationAngle);
         mli.fiberLengthAlongTendon = mli.fiberLength * mli.cosPennationAngle;
 
         // Necessary even for the rigid tendon, as it might have gone slack.
-        mli.tendonLength      = getPennationModel().
-                                    calcTendonLength(mli.cosPennationAngle,
-                                                     mli.fiberLength,
-                                                     getLength(s));
+        mli.tendonLength      = penMdl.calcTendonLength(mli.cosPennationAngle,
+                                                    mli.fiberLength,
+                                                    mclLength);
         mli.normTendonLength  = mli.tendonLength / tendonSlackLen;
         mli.tendonStrain      = mli.normTendonLength - 1.0;
 
@@ -659,8 +850,10 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
         const MuscleLengthInfo &mli = getMuscleLengthInfo(s);
 
         // Get the static properties of this muscle.
+        const MuscleFixedWidthPennationModel& penMdl = getPennationModel();
         double dlenMcl   = getLengtheningSpeed(s);
         double optFibLen = getOptimalFiberLength();
+        double vmax      = getMaxContractionVelocity();
 
         //======================================================================
         // Compute fv by inverting the force-velocity relationship in the
@@ -671,9 +864,9 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
         double fv    = SimTK::NaN;
 
         // Calculate fiber velocity.
-        if(get_ignore_tendon_compliance()) {
+        switch(m_fiberVelocityModel) {
 
-            // Rigid tendon.
+        case FiberVelocityModel::RigidTendon: {
 
             if(mli.tendonLength < getTendonSlackLength()
                                   - SimTK::SignificantReal) {
@@ -682,23 +875,19 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
                 dlceN = 0.0;
                 fv    = 1.0;
             } else {
-                dlce = getPennationModel().
-                         calcFiberVelocity(mli.cosPennationAngle, dlenMcl, 0.0);
-                dlceN = dlce/(optFibLen*getMaxContractionVelocity());
+                dlce = penMdl.calcFiberVelocity(mli.cosPennationAngle,
+                                                dlenMcl, 0.0);
+                dlceN = dlce/(optFibLen*vmax);
                 fv = get_ForceVelocityCurve().calcValue(dlceN);
             }
+            break;
+        }
 
-        } else if(!get_ignore_tendon_compliance() && !use_fiber_damping) {
+        case FiberVelocityModel::ElasticTendon: {
 
             // Elastic tendon, no damping.
 
-            double a = SimTK::NaN;
-            if(!get_ignore_activation_dynamics()) {
-                a = getActivationModel().clampActivation(
-                        getStateVariableValue(s, STATE_ACTIVATION_NAME));
-            } else {
-                a = getActivationModel().clampActivation(getControl(s));
-            }
+            double a = getClampedActivation(s);
 
             const TendonForceLengthCurve& fseCurve =
                 get_TendonForceLengthCurve();
@@ -721,19 +910,15 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
 
             // Evaluate the inverse force-velocity curve.
             dlceN = fvInvCurve.calcValue(fv);
-            dlce  = dlceN*getMaxContractionVelocity()*optFibLen;
+            dlce  = dlceN*vmax*optFibLen;
+            break;
+        }
 
-        } else {
+        case FiberVelocityModel::DampedElasticTendon: {
 
             // Elastic tendon, with damping.
 
-            double a = SimTK::NaN;
-            if(!get_ignore_activation_dynamics()) {
-                a = getActivationModel().clampActivation(
-                        getStateVariableValue(s, STATE_ACTIVATION_NAME));
-            } else {
-                a = getActivationModel().clampActivation(getControl(s));
-            }
+            double a = getClampedActivation(s);
 
             const TendonForceLengthCurve& fseCurve =
                 get_TendonForceLengthCurve();
@@ -757,8 +942,7 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
             // If the Newton method converged, update the fiber velocity.
             if(fiberVelocityV[2] > 0.5) { //flag is set to 0.0 or 1.0
                 dlceN = fiberVelocityV[0];
-                dlce  = dlceN*getOptimalFiberLength()
-                        *getMaxContractionVelocity();
+                dlce  = dlceN*optFibLen*vmax;
                 fv = get_ForceVelocityCurve().calcValue(dlceN);
             } else {
                 // Throw an exception here because there is no point integrating
@@ -769,19 +953,21 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
                 throw (OpenSim::Exception(getName() +
                        " Fiber velocity Newton method did not converge"));
             }
+            break;
+        }
         }
 
         // Compute the other velocity-related components.
-        double dphidt = getPennationModel().calcPennationAngularVelocity(
+        double dphidt = penMdl.calcPennationAngularVelocity(
             tan(mli.pennationAngle), mli.fiberLength, dlce);
-        double dlceAT = getPennationModel().calcFiberVelocityAlongTendon(
+        double dlceAT = penMdl.calcFiberVelocityAlongTendon(
             mli.fiberLength, dlce, mli.sinPennationAngle, mli.cosPennationAngle,
             dphidt);
-        double dmcldt = getLengtheningSpeed(s);
+        double dmcldt = dlenMcl;
         double dtl = 0;
 
-        if(!get_ignore_tendon_compliance()) {
-            dtl = getPennationModel().calcTendonVelocity(mli.cosPennationAngle,
+        if(m_fiberVelocityModel != FiberVelocityModel::RigidTendon) {
+            dtl = penMdl.calcTendonVelocity(mli.cosPennationAngle,
                 mli.sinPennationAngle, dphidt, mli.fiberLength, dlce, dmcldt);
         }
 
@@ -836,14 +1022,11 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
         //double penHeight      = penMdl.getParallelogramHeight();
         const TendonForceLengthCurve& fseCurve = get_TendonForceLengthCurve();
 
+        const bool rigidTendon =
+            m_fiberVelocityModel == FiberVelocityModel::RigidTendon;
+
         // Compute dynamic quantities.
-        double a = SimTK::NaN;
-        if(!get_ignore_activation_dynamics()) {
-            a = getActivationModel().clampActivation(
-                    getStateVariableValue(s, STATE_ACTIVATION_NAME));
-        } else {
-            a = getActivationModel().clampActivation(getControl(s));
-        }
+        double a = getClampedActivation(s);
 
         // Compute the stiffness of the muscle fiber.
         SimTK_ERRCHK_ALWAYS(mli.fiberLength > SimTK::SignificantReal,
@@ -883,7 +1066,7 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
             // compressive force. Here, we must enforce that the fiber generates
             // only tensile forces by saturating the damping force generated by
             // the parallel element.
-            if(get_ignore_tendon_compliance()) {
+            if(rigidTendon) {
                 if(fm < 0) {
                     fm   = 0.0;
                     p2Fm = -aFm - p1Fm;
@@ -903,7 +1086,7 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
                 mli.sinPennationAngle, mli.cosPennationAngle, mli.fiberLength);
 
             // Compute the stiffness of the tendon.
-            if(!get_ignore_tendon_compliance()) {
+            if(!rigidTendon) {
                 dFt_dtl = fseCurve.calcDerivative(mli.normTendonLength,1)
                           *(fiso/tendonSlackLen);
 
@@ -919,7 +1102,7 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
         }
 
         double fse = 0.0;
-        if(!get_ignore_tendon_compliance()) {
+        if(!rigidTendon) {
             fse = fseCurve.calcValue(mli.normTendonLength);
         } else {
             fse = fmAT/fiso;
@@ -960,16 +1143,15 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
         // Store quantities unique to this Muscle: the passive conservative
         // (elastic) fiber force and the passive non-conservative (damping)
         // fiber force.
-        SimTK::Vector dynExtras = SimTK::Vector(2);
-        dynExtras[0] = p1Fm; //elastic
-        dynExtras[1] = p2Fm; //damping
-        mdi.userDefinedDynamicsExtras = dynExtras;
+        mdi.userDefinedDynamicsExtras.resize(2);
+        mdi.userDefinedDynamicsExtras[0] = p1Fm; //elastic
+        mdi.userDefinedDynamicsExtras[1] = p2Fm; //damping
 
     } catch(const std::exception &x) {
         std::string msg = "Exception caught in Millard2012EquilibriumMuscle::"
                           "calcMuscleDynamicsInfo from " + getName() + "\n"
                           + x.what();
-        cerr << msg << endl;
+        OPENSIM_ERROR(msg);
         throw OpenSim::Exception(msg);
     }
 }
@@ -1279,13 +1461,40 @@ double Millard2012EquilibriumMuscle::clampFiberLength(double lce) const
 
 std::pair<Millard2012EquilibriumMuscle::StatusFromEstimateMuscleFiberState,
           Millard2012EquilibriumMuscle::ValuesFromEstimateMuscleFiberState>
-Millard2012EquilibriumMuscle::estimateMuscleFiberState(
+Millard2012EquilibriumMuscle::estimateMuscleFiberStateFrom(
+                                    double initialFiberLength,
                                     const double aActivation,
                                     const double pathLength,
                                     const double pathLengtheningSpeed,
                                     const double aSolTolerance,
                                     const int aMaxIterations,
                                     bool staticSolution) const
+{
+    // When the muscle is equilibrated at successive frames, the previous
+    // solution is usually within a few iterations of the new one.
+    if(SimTK::isFinite(initialFiberLength) && initialFiberLength > 0) {
+        std::pair<StatusFromEstimateMuscleFiberState,
+                  ValuesFromEstimateMuscleFiberState> result =
+            estimateMuscleFiberState(aActivation, pathLength,
+                pathLengtheningSpeed, aSolTolerance, aMaxIterations,
+                staticSolution, initialFiberLength);
+        if(result.first == StatusFromEstimateMuscleFiberState::Success_Converged)
+            return result;
+    }
+    return estimateMuscleFiberState(aActivation, pathLength,
+        pathLengtheningSpeed, aSolTolerance, aMaxIterations, staticSolution);
+}
+
+std::pair<Millard2012EquilibriumMuscle::StatusFromEstimateMuscleFiberState,
+          Millard2012EquilibriumMuscle::ValuesFromEstimateMuscleFiberState>
+Millard2012EquilibriumMuscle::estimateMuscleFiberState(
+                                    const double aActivation,
+                                    const double pathLength,
+                                    const double pathLengtheningSpeed,
+                                    const double aSolTolerance,
+                                    const int aMaxIterations,
+                                    bool staticSolution,
+                                    double initialFiberLength) const
 {
     // If seeking a static solution, set velocities to zero and avoid the
     // velocity-sharing algorithm below, as it can produce nonzero fiber and
@@ -1317,10 +1526,17 @@ Millard2012EquilibriumMuscle::estimateMuscleFiberState(
     double lce = 0.0;
     double tl  = getTendonSlackLength()*1.01;  // begin with small tendon force
 
-    lce = clampFiberLength(getPennationModel().calcFiberLength(ml,tl));
-
-    double phi    = getPennationModel().calcPennationAngle(lce);
-    double cosphi = cos(phi);
+    double phi, cosphi;
+    if(SimTK::isFinite(initialFiberLength)) {
+        lce    = clampFiberLength(initialFiberLength);
+        phi    = getPennationModel().calcPennationAngle(lce);
+        cosphi = cos(phi);
+        tl     = getPennationModel().calcTendonLength(cosphi,lce,ml);
+    } else {
+        lce    = clampFiberLength(getPennationModel().calcFiberLength(ml,tl));
+        phi    = getPennationModel().calcPennationAngle(lce);
+        cosphi = cos(phi);
+    }
     double sinphi = sin(phi);
     double tlN    = tl/tsl;
     double lceN   = lce/ofl;
@@ -1470,6 +1686,7 @@ Millard2012EquilibriumMuscle::estimateMuscleFiberState(
         }
         iter++;
     }
+    _equilibriumIterations.add(iter);
 
     // Populate the result map.
     ValuesFromEstimateMuscleFiberState resultValues;
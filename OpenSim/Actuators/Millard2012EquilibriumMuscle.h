@@ -34,6 +34,7 @@
 //    6. ignore_tendon_compliance
 //    7. ignore_activation_dynamics
 #include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Common/IterationCounter.h>
 
 // Sub-models used by this muscle model
 #include <OpenSim/Actuators/MuscleFirstOrderActivationDynamicModel.h>
@@ -238,6 +239,8 @@ public:
             getPassiveFiberDampingForce, SimTK::Stage::Dynamics);
     OpenSim_DECLARE_OUTPUT(passive_fiber_damping_force_along_tendon, double,
             getPassiveFiberDampingForceAlongTendon, SimTK::Stage::Dynamics);
+    OpenSim_DECLARE_OUTPUT(equilibrium_iterations, double,
+            getEquilibriumIterations, SimTK::Stage::Model);
 
 //==============================================================================
 // CONSTRUCTORS
@@ -306,6 +309,14 @@ public:
     model. */
     const MuscleFirstOrderActivationDynamicModel& getActivationModel() const;
 
+    /** The parameters of the MuscleFirstOrderActivationDynamicModel of this
+    muscle, so that the Model computes its activation derivative together
+    with those of other muscles. Returns false if activation dynamics are
+    ignored. */
+    bool getFirstOrderActivationParameters(double& minimumActivation,
+            double& activationTimeConstant,
+            double& deactivationTimeConstant) const override;
+
     /** @returns The minimum fiber length, which is the maximum of two values:
     the smallest fiber length allowed by the pennation model, and the minimum
     fiber length on the active-force-length curve. When the fiber reaches this
@@ -349,6 +360,11 @@ public:
     /** get the portion of the passive fiber force generated by the damping
         element only, projected onto the tendon direction (N) */
     double getPassiveFiberDampingForceAlongTendon(const SimTK::State& s) const;
+    /** get the total number of Newton iterations taken to solve the
+        equilibrium of the fiber and tendon (e.g., when computing the initial
+        fiber length) since this muscle was constructed or copied; this does
+        not depend on the state */
+    double getEquilibriumIterations(const SimTK::State& s) const;
 
 //==============================================================================
 // SET METHODS
@@ -440,6 +456,44 @@ public:
     void computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const 
         override;
 
+    /** Computes the sensitivities of the fiber equilibrium found by
+    computeInitialFiberEquilibrium() at the fiber length in the given state,
+    using the implicit function theorem on the equilibrium equation rather
+    than solving the equilibrium again for perturbed inputs. The velocity is
+    shared between the fiber and the tendon as in
+    computeInitialFiberEquilibrium(), with their stiffnesses held fixed, so
+    the sensitivities with respect to the lengthening speed are exact only
+    when the musculotendon actuator is not lengthening.
+        @param[in] s The state of the system, realized to
+                     SimTK::Stage::Velocity, in which the fiber is in
+                     equilibrium.
+        @returns The partial derivatives of the fiber length (m, row 0) and
+    tendon force (N, row 1) with respect to activation (column 0), the length
+    of the musculotendon actuator (m, column 1) and its lengthening speed
+    (m/s, column 2). The entries are NaN if the equilibrium is singular (the
+    fiber and the tendon have the same stiffness along the tendon). If the
+    fiber is at its minimum length, the fiber length does not change. */
+    SimTK::Mat23 calcFiberEquilibriumSensitivities(const SimTK::State& s)
+        const;
+
+    /** Computes the active fiber forces along the tendon of an ensemble of
+    lanes of this muscle (e.g., the members of a Monte Carlo ensemble), each
+    with its own activation, fiber length and fiber velocity, as
+    calcActiveFiberForceAlongTendon() does for each lane. Each curve is
+    evaluated at all lanes in one pass (see
+    SmoothSegmentedFunction::calcDerivatives()), and the lanes are read from
+    and written to contiguous arrays.
+        @param activations the activation of each lane
+        @param fiberLengths the fiber length of each lane (m)
+        @param fiberVelocities the fiber velocity of each lane (m/s)
+        @param[out] forces the force generated by the fiber of each lane that
+    is associated only with activation, along the tendon (N). It is resized to
+    the number of lanes. */
+    void calcActiveFiberForcesAlongTendon(const SimTK::Vector& activations,
+                                          const SimTK::Vector& fiberLengths,
+                                          const SimTK::Vector& fiberVelocities,
+                                          SimTK::Vector& forces) const;
+
 //==============================================================================
 // TO BE DEPRECATED
 //==============================================================================
@@ -556,6 +610,24 @@ private:
     // dampingCoefficient < 0.001).
     bool use_fiber_damping;
 
+    // The ways in which the fiber velocity is computed, in the order in which
+    // ignore_tendon_compliance and use_fiber_damping select them.
+    enum class FiberVelocityModel {
+        RigidTendon,
+        ElasticTendon,
+        DampedElasticTendon
+    };
+
+    // The configuration of the muscle, determined by
+    // extendFinalizeFromProperties() so that the functions called at every
+    // realization do not look up the properties again.
+    FiberVelocityModel m_fiberVelocityModel;
+    bool m_ignoreActivationDynamics;
+
+    // Returns the clamped activation, from the activation state or, if
+    // activation dynamics are ignored, from the control.
+    double getClampedActivation(const SimTK::State& s) const;
+
     void setNull();
     void constructProperties();
 
@@ -752,6 +824,9 @@ private:
            give up attempting to initialize the model
     @param staticSolution set to true to calculate the static equilibrium
            solution, setting fiber and tendon velocities to zero
+    @param initialFiberLength the fiber length to start the Newton iterations
+           from (e.g., the solution at the previous time step), or NaN to
+           start from a fiber length that develops a small tendon force
     */
     std::pair<StatusFromEstimateMuscleFiberState,
               ValuesFromEstimateMuscleFiberState>
@@ -760,8 +835,23 @@ private:
                                  const double pathLengtheningSpeed,
                                  const double aSolTolerance,
                                  const int aMaxIterations,
-                                 bool staticSolution=false) const;
+                                 bool staticSolution=false,
+                                 double initialFiberLength=SimTK::NaN) const;
 
+    /* Calls estimateMuscleFiberState() starting from the given fiber length,
+    and again from the default initial guess if that does not converge. */
+    std::pair<StatusFromEstimateMuscleFiberState,
+              ValuesFromEstimateMuscleFiberState>
+        estimateMuscleFiberStateFrom(double initialFiberLength,
+                                     const double aActivation,
+                                     const double pathLength,
+                                     const double pathLengtheningSpeed,
+                                     const double aSolTolerance,
+                                     const int aMaxIterations,
+                                     bool staticSolution=false) const;
+
+    // Newton iterations taken by estimateMuscleFiberState().
+    IterationCounter _equilibriumIterations;
 };
 } //end of namespace OpenSim
 
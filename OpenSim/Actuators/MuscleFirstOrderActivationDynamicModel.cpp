@@ -91,6 +91,29 @@ calcDerivative(double activation, double excitation) const
     return (clampedExcitation - clampedActivation) / tau;
 }
 
+void MuscleFirstOrderActivationDynamicModel::
+calcDerivatives(const SimTK::Vector& activations,
+                const SimTK::Vector& excitations,
+                SimTK::Vector& derivatives) const
+{
+    const int n = activations.size();
+    OPENSIM_THROW_IF_FRMOBJ(excitations.size() != n, Exception,
+        "Expected " + std::to_string(n) + " excitations, but got " +
+        std::to_string(excitations.size()) + ".");
+    derivatives.resize(n);
+
+    const double amin = get_minimum_activation();
+    const double tauAct = get_activation_time_constant();
+    const double tauDeact = get_deactivation_time_constant();
+    for (int i = 0; i < n; ++i) {
+        const double a = clamp(amin, activations[i], 1.0);
+        const double u = clamp(amin, excitations[i], 1.0);
+        const double f = 0.5 + 1.5*a;
+        const double tau = u > a ? tauAct*f : tauDeact/f;
+        derivatives[i] = (u - a)/tau;
+    }
+}
+
 //==============================================================================
 // COMPONENT INTERFACE
 //==============================================================================
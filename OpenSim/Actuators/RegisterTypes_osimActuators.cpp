@@ -77,19 +77,19 @@ OSIMACTUATORS_API void RegisterTypes_osimActuators()
 {
   try {
 
-    Object::registerType( CoordinateActuator() );
-    Object::registerType( PointActuator() );
-    Object::registerType( TorqueActuator() );
-    Object::registerType( BodyActuator() );
-    Object::registerType( PointToPointActuator() );
-    Object::registerType( ClutchedPathSpring() );
-
-    Object::registerType( Thelen2003Muscle() );
-    Object::registerType( Thelen2003Muscle_Deprecated() );
-    Object::registerType( Schutte1993Muscle_Deprecated() );
-    Object::registerType( Delp1990Muscle_Deprecated() );
-    Object::registerType( SpringGeneralizedForce() );
-    Object::registerType( RigidTendonMuscle() );
+    Object::registerType<CoordinateActuator>();
+    Object::registerType<PointActuator>();
+    Object::registerType<TorqueActuator>();
+    Object::registerType<BodyActuator>();
+    Object::registerType<PointToPointActuator>();
+    Object::registerType<ClutchedPathSpring>();
+
+    Object::registerType<Thelen2003Muscle>();
+    Object::registerType<Thelen2003Muscle_Deprecated>();
+    Object::registerType<Schutte1993Muscle_Deprecated>();
+    Object::registerType<Delp1990Muscle_Deprecated>();
+    Object::registerType<SpringGeneralizedForce>();
+    Object::registerType<RigidTendonMuscle>();
 
     Object::RegisterType( ActiveForceLengthCurve() );
     Object::RegisterType( ForceVelocityCurve() );
@@ -202,8 +202,13 @@ calcMuscleDynamicsInfo(const State& s, MuscleDynamicsInfo& mdi) const
  */
 double RigidTendonMuscle::computeActuation(const State& s) const
 {
-    const MuscleLengthInfo& mli = getMuscleLengthInfo(s);
-    double force = getFiberForce(s)*mli.cosPennationAngle;
+    // The fiber kinematics follow from the path alone, so the force is
+    // computed directly rather than through the muscle's info cache entries,
+    // which are only filled if something asks for them.
+    double activeForce, passiveForce;
+    calcFiberForcesAlongTendon(getLength(s), getLengtheningSpeed(s),
+                               getControl(s), activeForce, passiveForce);
+    double force = activeForce + passiveForce;
     // store force in the system cache so if needed again it won't have to be
     // recalculated
     setActuation(s, force);
@@ -211,6 +216,43 @@ double RigidTendonMuscle::computeActuation(const State& s) const
     return(force);
 }
 
+double RigidTendonMuscle::
+calcInextensibleTendonActiveFiberForce(State& s, double aActivation) const
+{
+    double activeForce, passiveForce;
+    calcFiberForcesAlongTendon(getLength(s), getLengtheningSpeed(s),
+                               aActivation, activeForce, passiveForce);
+    return activeForce;
+}
+
+void RigidTendonMuscle::
+calcFiberForcesAlongTendon(double pathLength, double lengtheningSpeed,
+                           double activation, double& activeForce,
+                           double& passiveForce) const
+{
+    // Same as calcMuscleLengthInfo(), calcFiberVelocityInfo() and
+    // calcMuscleDynamicsInfo(), keeping only what the force needs.
+    double zeroPennateLength = pathLength - getTendonSlackLength();
+    zeroPennateLength = zeroPennateLength < 0 ? 0 : zeroPennateLength;
+    const double fiberLength =
+        sqrt(square(zeroPennateLength) + square(_muscleWidth)) + Eps;
+    const double cosPennationAngle = zeroPennateLength/fiberLength;
+
+    const double optimalFiberLength = getOptimalFiberLength();
+    Vector arg(1, fiberLength/optimalFiberLength);
+    const double activeForceLength =
+        get_active_force_length_curve().calcValue(arg);
+    const double passiveForceLength =
+        SimTK::clamp(0, get_passive_force_length_curve().calcValue(arg), 10);
+
+    arg[0] = lengtheningSpeed / (optimalFiberLength*getMaxContractionVelocity());
+    const double forceVelocity = get_force_velocity_curve().calcValue(arg);
+
+    const double forceAlongTendon = getMaxIsometricForce()*cosPennationAngle;
+    activeForce = forceAlongTendon*activation*activeForceLength*forceVelocity;
+    passiveForce = forceAlongTendon*passiveForceLength;
+}
+
 
 double RigidTendonMuscle::computeIsometricForce(State& s, double activation) const
 {
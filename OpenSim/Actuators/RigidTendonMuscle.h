@@ -83,6 +83,13 @@ public:
     /** activation level for this muscle */
     void setActivation(SimTK::State& s, double activation) const override {setExcitation(s, activation); }
 
+    ///@cond
+    /** Evaluated directly from the path length and lengthening speed, without
+        computing the muscle's length and velocity info. */
+    double calcInextensibleTendonActiveFiberForce(SimTK::State& s,
+                                          double aActivation) const override;
+    ///@endcond
+
 protected:
 
     /** calculate muscle's length related values such fiber and tendon lengths,
@@ -117,6 +124,15 @@ private:
     void setNull();
     void constructProperties();
 
+    /** calculate the active and passive fiber forces along the tendon for the
+        given path length, lengthening speed and activation. This is the same
+        model as the calc*Info methods above fused into one evaluation, which
+        computeActuation() uses so that realizing the forces does not fill the
+        muscle's length, velocity and dynamics info cache entries. */
+    void calcFiberForcesAlongTendon(double pathLength, double lengtheningSpeed,
+                                    double activation, double& activeForce,
+                                    double& passiveForce) const;
+
 protected:
 
 //==============================================================================
@@ -88,6 +88,7 @@ void TendonForceLengthCurve::constructProperties()
     constructProperty_stiffness_at_one_norm_force();
     constructProperty_norm_force_at_toe_end();
     constructProperty_curviness();
+    constructProperty_tabulation_tolerance(0.0);
 }
 
 void TendonForceLengthCurve::buildCurve(bool computeIntegral)
@@ -101,6 +102,7 @@ void TendonForceLengthCurve::buildCurve(bool computeIntegral)
                                      getName());
     m_curve = *f;
     delete f;
+    m_curve.tabulate(get_tabulation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
@@ -198,6 +200,15 @@ void TendonForceLengthCurve::setOptionalProperties(
     ensureCurveUpToDate();
 }
 
+double TendonForceLengthCurve::getTabulationTolerance() const
+{   return get_tabulation_tolerance(); }
+
+void TendonForceLengthCurve::setTabulationTolerance(double tolerance)
+{
+    set_tabulation_tolerance(tolerance);
+    ensureCurveUpToDate();
+}
+
 //==============================================================================
 // OpenSim::Function Interface
 //==============================================================================
@@ -223,6 +234,14 @@ double TendonForceLengthCurve::calcValue(double aNormLength) const
     return m_curve.calcValue(aNormLength);
 }
 
+void TendonForceLengthCurve::calcValues(const SimTK::Vector& x,
+        SimTK::Vector& values) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "TendonForceLengthCurve: Tendon is not up-to-date with its properties");
+    m_curve.calcDerivatives(x, values, 0);
+}
+
 double TendonForceLengthCurve::calcDerivative(double aNormLength,
                                               int order) const
 {
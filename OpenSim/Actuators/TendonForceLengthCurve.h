@@ -159,6 +159,9 @@ public:
     OpenSim_DECLARE_OPTIONAL_PROPERTY(curviness, double,
         "Tendon curve bend, from linear (0) to maximum bend (1)");
 
+    OpenSim_DECLARE_PROPERTY(tabulation_tolerance, double,
+        "Largest error of the values and slopes of the curve evaluated from a table, or 0 to evaluate the curve exactly");
+
 //==============================================================================
 // PUBLIC METHODS
 //==============================================================================
@@ -261,7 +264,13 @@ public:
 
     /** Evaluates the tendon-force-length curve at a normalized tendon length of
     'aNormLength'. */
-    double calcValue(double aNormLength) const;
+    double calcValue(double aNormLength) const override;
+
+    /** Evaluates the tendon-force-length curve at each of the normalized tendon lengths in 'x', as
+    calcValue(double) does, in one pass over the curve; see
+    SmoothSegmentedFunction::calcDerivatives(). */
+    void calcValues(const SimTK::Vector& x,
+                    SimTK::Vector& values) const override;
 
     /** Calculates the derivative of the tendon-force-length multiplier with
     respect to the normalized tendon length.
@@ -273,7 +282,7 @@ public:
         The derivative of the tendon-force-length curve with respect to the
         normalized tendon length.
     */
-    double calcDerivative(double aNormLength, int order) const;
+    double calcDerivative(double aNormLength, int order) const override;
 
     /** Calculates the normalized area under the curve. Since it is expensive to
     construct, the curve is built only when necessary.
@@ -327,6 +336,17 @@ public:
     void printMuscleCurveToCSVFile(const std::string& path);
 
     void ensureCurveUpToDate();
+
+    /** @returns The largest error allowed in the values and slopes of the
+    curve evaluated from a table, or 0 if the curve is evaluated exactly. */
+    double getTabulationTolerance() const;
+
+    /** Evaluate the values and slopes of the curve from a table with at most
+    the given error, which is much cheaper than evaluating the curve exactly.
+    The curves of all the muscles with identical curve parameters share one
+    table. A tolerance of 0 evaluates the curve exactly (the default). See
+    SmoothSegmentedFunction::tabulate() for details. */
+    void setTabulationTolerance(double tolerance);
 //==============================================================================
 // PRIVATE
 //==============================================================================
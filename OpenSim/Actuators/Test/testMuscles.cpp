@@ -105,6 +105,12 @@ void testMillard2012EquilibriumMuscle();
 void testMillard2012AccelerationMuscle();
 void testSchutte1993Muscle();
 void testDelp1990Muscle();
+void testChangeParametersWithoutInitSystem();
+void testMillard2012EquilibriumSensitivities();
+void testRigidTendonMuscleDirectForce();
+void testBatchedActivationDerivatives();
+void testMuscleGroup();
+void testMuscleLaneKernels();
 
 int main()
 {
@@ -165,6 +171,48 @@ int main()
         failures.push_back("testMillard2012AccelerationMuscle");
     }
 
+    try { testChangeParametersWithoutInitSystem();
+        cout << "ChangeParametersWithoutInitSystem Test passed" << endl;
+    }catch (const Exception& e){
+        e.print(cerr);
+        failures.push_back("testChangeParametersWithoutInitSystem");
+    }
+
+    try { testMillard2012EquilibriumSensitivities();
+        cout << "Millard2012EquilibriumSensitivities Test passed" << endl;
+    }catch (const Exception& e){
+        e.print(cerr);
+        failures.push_back("testMillard2012EquilibriumSensitivities");
+    }
+
+    try { testRigidTendonMuscleDirectForce();
+        cout << "RigidTendonMuscleDirectForce Test passed" << endl;
+    }catch (const Exception& e){
+        e.print(cerr);
+        failures.push_back("testRigidTendonMuscleDirectForce");
+    }
+
+    try { testBatchedActivationDerivatives();
+        cout << "BatchedActivationDerivatives Test passed" << endl;
+    }catch (const Exception& e){
+        e.print(cerr);
+        failures.push_back("testBatchedActivationDerivatives");
+    }
+
+    try { testMuscleGroup();
+        cout << "MuscleGroup Test passed" << endl;
+    }catch (const Exception& e){
+        e.print(cerr);
+        failures.push_back("testMuscleGroup");
+    }
+
+    try { testMuscleLaneKernels();
+        cout << "MuscleLaneKernels Test passed" << endl;
+    }catch (const Exception& e){
+        e.print(cerr);
+        failures.push_back("testMuscleLaneKernels");
+    }
+
     printf("\n\n");
     cout <<"************************************************************"<<endl;
     cout <<"************************************************************"<<endl;
@@ -841,6 +889,32 @@ void testThelen2003Muscle()
         musc.finalizeFromProperties();
     }
 
+    // Test that the solution does not depend on the fiber length in the state,
+    // which is used as the initial guess.
+    {
+        auto model = Model();
+
+        auto musc = new Thelen2003Muscle("muscle", 100., 0.1, 0.2, 0.);
+        musc->addNewPathPoint("p1", model.updGround(), SimTK::Vec3(0));
+        musc->addNewPathPoint("p2", model.updGround(),
+                              SimTK::Vec3(0, 0, 0.32));
+        model.addForce(musc);
+
+        SimTK::State& state = model.initSystem();
+        musc->setActivation(state, 0.5);
+        model.equilibrateMuscles(state);
+        const double fiberLength = musc->getFiberLength(state);
+
+        for (double guess : {fiberLength, 1.05*fiberLength, 0.5*fiberLength,
+                             10.*fiberLength, -1.}) {
+            musc->setFiberLength(state, guess);
+            model.equilibrateMuscles(state);
+            ASSERT_EQUAL(fiberLength, musc->getFiberLength(state), 1e-6,
+                __FILE__, __LINE__,
+                "Equilibrium fiber length depends on the initial guess.");
+        }
+    }
+
     // Ensure the properties of MuscleFixedWidthPennationModel and
     // MuscleFirstOrderActivationDynamicModel are being set by Thelen2003Muscle
     // when they are subcomponents of the Muscle. Here, we set the properties
@@ -948,6 +1022,35 @@ void testThelen2003Muscle()
         ASSERT_THROW( MuscleCannotEquilibrate,
                       muscle->computeInitialFiberEquilibrium(state) );
     }
+
+    // Test that the solution does not depend on the fiber length in the state,
+    // which is used as the initial guess.
+    {
+        auto model = Model();
+
+        auto muscle = new Millard2012EquilibriumMuscle("muscle", 100.,
+                          0.1, 0.2, 0.);
+        muscle->addNewPathPoint("p1", model.updGround(), SimTK::Vec3(0));
+        muscle->addNewPathPoint("p2", model.updGround(),
+                                SimTK::Vec3(0, 0, 0.32));
+        model.addForce(muscle);
+
+        SimTK::State& state = model.initSystem();
+        muscle->setActivation(state, 0.5);
+        model.equilibrateMuscles(state);
+        const double fiberLength = muscle->getFiberLength(state);
+
+        // Nearby guesses converge from the guess, distant ones fall back on
+        // the default initial guess.
+        for (double guess : {fiberLength, 1.05*fiberLength, 0.5*fiberLength,
+                             10.*fiberLength, -1., SimTK::NaN}) {
+            muscle->setFiberLength(state, guess);
+            model.equilibrateMuscles(state);
+            ASSERT_EQUAL(fiberLength, muscle->getFiberLength(state), 1e-6,
+                __FILE__, __LINE__,
+                "Equilibrium fiber length depends on the initial guess.");
+        }
+    }
 }
 
 
@@ -1114,3 +1217,417 @@ void testDelp1990Muscle()
         false);
 
 }
+
+/*==============================================================================
+    Changing the maximum isometric force and the tendon slack length of a muscle
+    in a state must give the same muscle quantities as building the model again
+    with the new values.
+================================================================================
+*/
+Model* buildSliderWithMuscle(double maxIsometricForce, double tendonSlackLength)
+{
+    Model* model = new Model();
+    model->setName("slider_with_muscle");
+    Body* block = new Body("block", 1.0, SimTK::Vec3(0),
+                           SimTK::Inertia::brick(0.05, 0.05, 0.05));
+    model->addBody(block);
+    SliderJoint* slider = new SliderJoint("slider",
+        model->getGround(), SimTK::Vec3(0), SimTK::Vec3(0),
+        *block, SimTK::Vec3(0), SimTK::Vec3(0));
+    slider->updCoordinate().setName("x");
+    model->addJoint(slider);
+
+    RigidTendonMuscle* muscle = new RigidTendonMuscle("muscle",
+        maxIsometricForce, OptimalFiberLength0, tendonSlackLength,
+        PennationAngle0);
+    muscle->addNewPathPoint("origin", model->updGround(), SimTK::Vec3(-0.2, 0, 0));
+    muscle->addNewPathPoint("insertion", *block, SimTK::Vec3(0));
+    model->addForce(muscle);
+    return model;
+}
+
+void testChangeParametersWithoutInitSystem()
+{
+    const double newMaxIsometricForce = 2*MaxIsometricForce0;
+    const double newTendonSlackLength = 0.8*TendonSlackLength0;
+    // Stretch the fiber past its optimal length so that it is in tension.
+    const double x =
+        TendonSlackLength0 + 1.4*OptimalFiberLength0 - 0.2;
+
+    unique_ptr<Model> model{
+        buildSliderWithMuscle(MaxIsometricForce0, TendonSlackLength0) };
+    SimTK::State& s = model->initSystem();
+    model->getCoordinateSet()[0].setValue(s, x);
+    Muscle& muscle = model->updMuscles()[0];
+    model->realizeDynamics(s);
+    const double force0 = muscle.getActuation(s);
+
+    const SimTK::System* system = &model->getSystem();
+    muscle.setMaxIsometricForce(s, newMaxIsometricForce);
+    muscle.setTendonSlackLength(s, newTendonSlackLength);
+    ASSERT(muscle.isObjectUpToDateWithProperties(), __FILE__, __LINE__,
+        "Changing a parameter in a state should not call for initSystem().");
+    ASSERT(&model->getSystem() == system, __FILE__, __LINE__,
+        "Changing a parameter in a state should keep the System.");
+    model->realizeDynamics(s);
+
+    unique_ptr<Model> rebuilt{
+        buildSliderWithMuscle(newMaxIsometricForce, newTendonSlackLength) };
+    SimTK::State& s2 = rebuilt->initSystem();
+    rebuilt->getCoordinateSet()[0].setValue(s2, x);
+    rebuilt->realizeDynamics(s2);
+    const Muscle& expected = rebuilt->getMuscles()[0];
+
+    ASSERT(std::abs(muscle.getActuation(s) - force0) > SimTK::SqrtEps,
+        __FILE__, __LINE__, "Expected the muscle force to change.");
+    ASSERT_EQUAL(expected.getFiberLength(s2), muscle.getFiberLength(s),
+        SimTK::SqrtEps, __FILE__, __LINE__,
+        "Fiber length does not reflect the new tendon slack length.");
+    ASSERT_EQUAL(expected.getActuation(s2), muscle.getActuation(s),
+        SimTK::SqrtEps, __FILE__, __LINE__,
+        "Muscle force does not reflect the new parameters.");
+
+    // Without a System there is no state to update.
+    RigidTendonMuscle unconnected("muscle", MaxIsometricForce0,
+        OptimalFiberLength0, TendonSlackLength0, PennationAngle0);
+    ASSERT_THROW(ComponentHasNoSystem,
+        unconnected.setMaxIsometricForce(s, newMaxIsometricForce));
+}
+
+/*==============================================================================
+    RigidTendonMuscle computes its force directly from the path; it must match
+    the force computed from the muscle's length, velocity and dynamics info.
+================================================================================
+*/
+void testRigidTendonMuscleDirectForce()
+{
+    unique_ptr<Model> model{
+        buildSliderWithMuscle(MaxIsometricForce0, TendonSlackLength0) };
+    SimTK::State& s = model->initSystem();
+    const Muscle& muscle = model->getMuscles()[0];
+    const Coordinate& x = model->getCoordinateSet()[0];
+
+    // Slack, stretched, shortening and lengthening fibers.
+    const double lengths[] = {0.2 + 0.5*OptimalFiberLength0,
+                              0.2 + OptimalFiberLength0,
+                              0.2 + 1.4*OptimalFiberLength0};
+    const double speeds[] = {-0.5, 0, 0.3};
+    for (double length : lengths) {
+        for (double speed : speeds) {
+            x.setValue(s, TendonSlackLength0 + length - 0.2);
+            x.setSpeedValue(s, speed);
+            muscle.setActivation(s, 0.6);
+            model->realizeDynamics(s);
+            const double force = muscle.getActuation(s);
+            ASSERT_EQUAL(muscle.getTendonForce(s), force,
+                1e-12*MaxIsometricForce0, __FILE__, __LINE__,
+                "Direct force does not match the muscle dynamics info.");
+            ASSERT_EQUAL(muscle.getActiveFiberForceAlongTendon(s),
+                muscle.calcInextensibleTendonActiveFiberForce(s, 0.6),
+                1e-12*MaxIsometricForce0, __FILE__, __LINE__,
+                "Direct active force does not match the muscle info.");
+        }
+    }
+}
+
+/*==============================================================================
+    The Model computes the activation derivatives of all muscles with
+    first-order activation dynamics together; each must match the derivative
+    of the muscle's own activation model, and muscles that do not apply force
+    must keep a zero derivative.
+================================================================================
+*/
+void testBatchedActivationDerivatives()
+{
+    unique_ptr<Model> model{
+        buildSliderWithMuscle(MaxIsometricForce0, TendonSlackLength0) };
+    const Body& block = model->getBodySet().get("block");
+
+    Thelen2003Muscle* thelen1 = new Thelen2003Muscle("thelen1",
+        MaxIsometricForce0, OptimalFiberLength0, TendonSlackLength0,
+        PennationAngle0);
+    Thelen2003Muscle* thelen2 = new Thelen2003Muscle("thelen2",
+        MaxIsometricForce0, OptimalFiberLength0, TendonSlackLength0,
+        PennationAngle0);
+    thelen2->setActivationTimeConstant(0.02);
+    thelen2->setDeactivationTimeConstant(0.07);
+    thelen2->setMinimumActivation(0.05);
+    Millard2012EquilibriumMuscle* millard = new Millard2012EquilibriumMuscle(
+        "millard", MaxIsometricForce0, OptimalFiberLength0,
+        TendonSlackLength0, PennationAngle0);
+    millard->set_ignore_tendon_compliance(true);
+    std::vector<Muscle*> muscles{thelen1, thelen2, millard};
+    for (Muscle* muscle : muscles) {
+        muscle->addNewPathPoint("origin", model->updGround(),
+                                SimTK::Vec3(-0.2, 0, 0));
+        muscle->addNewPathPoint("insertion", block, SimTK::Vec3(0));
+        model->addForce(muscle);
+    }
+
+    SimTK::State& s = model->initSystem();
+    model->getCoordinateSet()[0].setValue(s,
+        TendonSlackLength0 + OptimalFiberLength0 - 0.2);
+    model->equilibrateMuscles(s);
+
+    const MuscleFirstOrderActivationDynamicModel* activationModels[] = {
+        &thelen1->getActivationModel(), &thelen2->getActivationModel(),
+        &millard->getActivationModel()};
+
+    // Activating, deactivating, and below the minimum activation.
+    const double activations[] = {0.2, 0.7, 0.01};
+    const double excitations[] = {0.9, 0.1, 0.0};
+    for (int k = 0; k < 3; ++k) {
+        for (size_t i = 0; i < muscles.size(); ++i) {
+            muscles[i]->setActivation(s, activations[k] + 0.05*i);
+            muscles[i]->setExcitation(s, excitations[k]);
+        }
+        model->realizeAcceleration(s);
+        for (size_t i = 0; i < muscles.size(); ++i) {
+            const double expected = activationModels[i]->calcDerivative(
+                muscles[i]->getActivation(s), muscles[i]->getExcitation(s));
+            ASSERT_EQUAL(expected,
+                muscles[i]->getStateVariableDerivativeValue(s, "activation"),
+                1e-12, __FILE__, __LINE__,
+                "Batched activation derivative of " +
+                muscles[i]->getName() + " is incorrect.");
+        }
+    }
+
+    thelen2->setAppliesForce(s, false);
+    model->realizeAcceleration(s);
+    ASSERT_EQUAL(0.0, thelen2->getStateVariableDerivativeValue(s, "activation"),
+        0.0, __FILE__, __LINE__,
+        "A muscle that applies no force must have no activation derivative.");
+}
+
+/*==============================================================================
+    A MuscleGroup computes the fiber mechanics of its muscles together, on
+    several threads; the muscles must produce the same forces as without it.
+================================================================================
+*/
+void testMuscleGroup()
+{
+    // A block pulled by muscles with several tendon slack lengths.
+    const auto buildModel = [](bool withGroup, int numThreads) {
+        Model* model = buildSliderWithMuscle(MaxIsometricForce0,
+                                             TendonSlackLength0);
+        const Body& block = model->getBodySet().get("block");
+        MuscleGroup* group = new MuscleGroup();
+        group->setName("millard_muscles");
+        group->set_num_threads(numThreads);
+        for (int i = 0; i < 7; ++i) {
+            Millard2012EquilibriumMuscle* muscle =
+                new Millard2012EquilibriumMuscle("millard" + to_string(i),
+                    MaxIsometricForce0, OptimalFiberLength0,
+                    TendonSlackLength0*(0.9 + 0.05*i), PennationAngle0);
+            muscle->addNewPathPoint("origin", model->updGround(),
+                                    SimTK::Vec3(-0.2, 0.01*i, 0));
+            muscle->addNewPathPoint("insertion", block, SimTK::Vec3(0));
+            model->addForce(muscle);
+            group->addMuscle(muscle->getName());
+        }
+        if (withGroup) model->addModelComponent(group);
+        else delete group;
+        return model;
+    };
+
+    unique_ptr<Model> reference{ buildModel(false, 1) };
+    SimTK::State& s0 = reference->initSystem();
+    for (int numThreads : {1, 3}) {
+        unique_ptr<Model> model{ buildModel(true, numThreads) };
+        SimTK::State& s = model->initSystem();
+        const MuscleGroup& group =
+            *model->getComponentList<MuscleGroup>().begin();
+        ASSERT(group.getNumMuscles() == 7);
+        ASSERT(group.getMuscleType() == "Millard2012EquilibriumMuscle");
+
+        for (double speed : {-0.3, 0.0, 0.2}) {
+            for (SimTK::State* state : {&s0, &s}) {
+                const Model& m = (state == &s0) ? *reference : *model;
+                m.getCoordinateSet()[0].setValue(*state,
+                    TendonSlackLength0 + 1.1*OptimalFiberLength0 - 0.2);
+                m.getCoordinateSet()[0].setSpeedValue(*state, speed);
+                for (int i = 0; i < 7; ++i) {
+                    const Muscle& muscle =
+                        m.getMuscles().get("millard" + to_string(i));
+                    muscle.setActivation(*state, 0.1 + 0.1*i);
+                }
+                m.realizeDynamics(*state);
+            }
+            const SimTK::Vector forces = group.calcTendonForces(s);
+            const SimTK::Vector velocities = group.calcFiberVelocities(s);
+            for (int i = 0; i < 7; ++i) {
+                const string name = "millard" + to_string(i);
+                const Muscle& expected = reference->getMuscles().get(name);
+                ASSERT_EQUAL(expected.getTendonForce(s0), forces[i],
+                    1e-9*MaxIsometricForce0, __FILE__, __LINE__,
+                    "Tendon force of " + name + " differs in the group.");
+                ASSERT_EQUAL(expected.getFiberVelocity(s0), velocities[i],
+                    1e-9, __FILE__, __LINE__,
+                    "Fiber velocity of " + name + " differs in the group.");
+                ASSERT_EQUAL(forces[i], group.getTendonForce(s, name), 0.0,
+                    __FILE__, __LINE__, "tendon_force output is incorrect.");
+            }
+        }
+    }
+
+    // All muscles of a group must be of the same type.
+    unique_ptr<Model> mixed{ buildModel(true, 1) };
+    mixed->updComponentList<MuscleGroup>().begin()->addMuscle("muscle");
+    ASSERT_THROW(Exception, mixed->initSystem());
+}
+
+void testMillard2012EquilibriumSensitivities()
+{
+    // Compare the sensitivities to central differences of the equilibrium,
+    // with rigid, elastic and damped elastic tendons.
+    for (int config = 0; config < 3; ++config) {
+        Model model;
+        Body* block = new Body("block", 1.0, SimTK::Vec3(0),
+                               SimTK::Inertia::brick(0.05, 0.05, 0.05));
+        model.addBody(block);
+        SliderJoint* slider = new SliderJoint("slider",
+            model.getGround(), SimTK::Vec3(0), SimTK::Vec3(0),
+            *block, SimTK::Vec3(0), SimTK::Vec3(0));
+        model.addJoint(slider);
+
+        auto muscle = new Millard2012EquilibriumMuscle("muscle", 100.,
+                          0.1, 0.2, 0.1);
+        muscle->set_ignore_tendon_compliance(config == 0);
+        if (config == 1) muscle->setFiberDamping(0.0);
+        muscle->addNewPathPoint("origin", model.updGround(),
+                                SimTK::Vec3(-0.2, 0, 0));
+        muscle->addNewPathPoint("insertion", *block, SimTK::Vec3(0));
+        model.addForce(muscle);
+
+        SimTK::State& state = model.initSystem();
+        const Coordinate& coord = slider->getCoordinate();
+        auto solve = [&](double activation, double x, double speed) {
+            muscle->setActivation(state, activation);
+            coord.setValue(state, x, false);
+            coord.setSpeedValue(state, speed);
+            muscle->computeInitialFiberEquilibrium(state);
+            model.realizeDynamics(state);
+            return SimTK::Vec2(muscle->getFiberLength(state),
+                               muscle->getTendonForce(state));
+        };
+
+        const SimTK::Vec3 p(0.5, 0.12, 0.0);
+        const double h = 1e-4;
+        const SimTK::Mat23 expected = [&]() {
+            SimTK::Mat23 fd;
+            for (int i = 0; i < 3; ++i) {
+                SimTK::Vec3 dp(0);
+                dp[i] = h;
+                SimTK::Vec3 pp = p + dp, pm = p - dp;
+                fd.col(i) = (solve(pp[0], pp[1], pp[2]) -
+                             solve(pm[0], pm[1], pm[2]))/(2*h);
+            }
+            return fd;
+        }();
+        solve(p[0], p[1], p[2]);
+        const SimTK::Mat23 sensitivities =
+            muscle->calcFiberEquilibriumSensitivities(state);
+
+        for (int i = 0; i < 2; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                ASSERT_EQUAL(expected(i,j), sensitivities(i,j),
+                    2e-3*std::abs(expected(i,j)) + (i == 0 ? 1e-5 : 1e-2),
+                    __FILE__, __LINE__,
+                    "Sensitivity (" + std::to_string(i) + ", " +
+                    std::to_string(j) + ") does not match finite differences "
+                    "in configuration " + std::to_string(config) + ".");
+            }
+        }
+    }
+}
+
+void testMuscleLaneKernels()
+{
+    // The lanes of an ensemble must reproduce the computations of the muscle
+    // for each member alone.
+    Model model;
+    Body* block = new Body("block", 1.0, SimTK::Vec3(0),
+                           SimTK::Inertia::brick(0.05, 0.05, 0.05));
+    model.addBody(block);
+    SliderJoint* slider = new SliderJoint("slider",
+        model.getGround(), SimTK::Vec3(0), SimTK::Vec3(0),
+        *block, SimTK::Vec3(0), SimTK::Vec3(0));
+    model.addJoint(slider);
+    auto muscle = new Millard2012EquilibriumMuscle("muscle", 100., 0.1, 0.2,
+                                                   0.1);
+    muscle->addNewPathPoint("origin", model.updGround(),
+                            SimTK::Vec3(-0.2, 0, 0));
+    muscle->addNewPathPoint("insertion", *block, SimTK::Vec3(0));
+    model.addForce(muscle);
+    model.initSystem();
+
+    // Lanes that span the domains of the curves, beyond their ends, and
+    // fiber lengths below the minimum.
+    const int n = 257;
+    const double ofl = muscle->getOptimalFiberLength();
+    const double vmax = muscle->getMaxContractionVelocity();
+    SimTK::Vector activations(n), excitations(n), lengths(n), velocities(n);
+    for (int i = 0; i < n; ++i) {
+        const double t = double(i)/(n - 1);
+        activations[i] = 1.1*std::fmod(7.3*t, 1.0) - 0.05;
+        excitations[i] = 1.1*std::fmod(3.1*t + 0.4, 1.0) - 0.05;
+        lengths[i] = ofl*(0.01 + 2.2*t);
+        velocities[i] = ofl*vmax*(1.2*std::sin(11.*t));
+    }
+
+    // The curves.
+    SimTK::Vector lceN = lengths/ofl;
+    SimTK::Vector values;
+    const ActiveForceLengthCurve& falCurve =
+        muscle->get_ActiveForceLengthCurve();
+    falCurve.calcValues(lceN, values);
+    ASSERT(values.size() == n, __FILE__, __LINE__,
+           "calcValues() has the wrong size.");
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQUAL(falCurve.calcValue(lceN[i]), values[i], 1e-12,
+                     __FILE__, __LINE__,
+                     "Lane " + std::to_string(i) + " of the "
+                     "active-force-length curve differs.");
+    const TendonForceLengthCurve& fseCurve =
+        muscle->get_TendonForceLengthCurve();
+    SimTK::Vector ltN = 0.95*SimTK::Vector(n, 1.0) + lceN/20;
+    fseCurve.calcValues(ltN, values);
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQUAL(fseCurve.calcValue(ltN[i]), values[i], 1e-12,
+                     __FILE__, __LINE__,
+                     "Lane " + std::to_string(i) + " of the "
+                     "tendon-force-length curve differs.");
+
+    // Activation dynamics.
+    const MuscleFirstOrderActivationDynamicModel& actMdl =
+        muscle->getActivationModel();
+    SimTK::Vector derivatives;
+    actMdl.calcDerivatives(activations, excitations, derivatives);
+    ASSERT(derivatives.size() == n, __FILE__, __LINE__,
+           "calcDerivatives() has the wrong size.");
+    for (int i = 0; i < n; ++i)
+        ASSERT_EQUAL(actMdl.calcDerivative(activations[i], excitations[i]),
+                     derivatives[i], 1e-12, __FILE__, __LINE__,
+                     "Lane " + std::to_string(i) + " of the activation "
+                     "derivatives differs.");
+    ASSERT_THROW(OpenSim::Exception,
+        actMdl.calcDerivatives(activations,
+                               SimTK::Vector(excitations(0, n - 1)),
+                               derivatives));
+
+    // Active fiber forces.
+    SimTK::Vector forces;
+    muscle->calcActiveFiberForcesAlongTendon(activations, lengths, velocities,
+                                             forces);
+    ASSERT(forces.size() == n, __FILE__, __LINE__,
+           "calcActiveFiberForcesAlongTendon() has the wrong size.");
+    for (int i = 0; i < n; ++i) {
+        const double expected = muscle->calcActiveFiberForceAlongTendon(
+            activations[i], lengths[i], velocities[i]);
+        ASSERT_EQUAL(expected, forces[i], 1e-9*(1 + std::abs(expected)),
+                     __FILE__, __LINE__,
+                     "Lane " + std::to_string(i) + " of the active fiber "
+                     "forces differs.");
+    }
+}
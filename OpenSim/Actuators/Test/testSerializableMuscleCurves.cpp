@@ -45,6 +45,7 @@ void testTendonForceLengthCurve();
 void testFiberForceLengthCurve();
 void testFiberCompressiveForceLengthCurve();
 void testFiberCompressiveForceCosPennationCurve();
+void testTabulatedCurves();
 
 int main(int argc, char* argv[])
 {
@@ -59,6 +60,7 @@ int main(int argc, char* argv[])
             testFiberForceLengthCurve();
             testFiberCompressiveForceLengthCurve();
             testFiberCompressiveForceCosPennationCurve();
+            testTabulatedCurves();
 
             cout << "================================================" << endl;
             cout << "                   Timing Tests                 " << endl;
@@ -1227,3 +1229,54 @@ void testFiberCompressiveForceCosPennationCurve()
         cout <<"________________________________________________________"<<endl;
 
 }
+
+// Compare a curve evaluated from a table with the same curve evaluated
+// exactly, over its domain and the linear extrapolations beyond it.
+template <typename CurveType>
+void compareTabulatedCurve(const CurveType& exact, double tolerance)
+{
+    CurveType tabulated(exact);
+    tabulated.setTabulationTolerance(tolerance);
+    SimTK_TEST(tabulated.getTabulationTolerance() == tolerance);
+
+    // A copy shares the table of the curve it was copied from.
+    CurveType copy(tabulated);
+    copy.ensureCurveUpToDate();
+
+    SimTK::Vec2 domain = exact.getCurveDomain();
+    double range = domain(1) - domain(0);
+    int n = 1000;
+    for(int i=0; i <= n; ++i){
+        double x = domain(0) - 0.1*range + 1.2*range*i/n;
+        SimTK_TEST_EQ_TOL(tabulated.calcValue(x), exact.calcValue(x),
+                          tolerance);
+        SimTK_TEST_EQ_TOL(tabulated.calcDerivative(x,1),
+                          exact.calcDerivative(x,1), tolerance);
+        SimTK_TEST(tabulated.calcDerivative(x,2) == exact.calcDerivative(x,2));
+        SimTK_TEST(copy.calcValue(x) == tabulated.calcValue(x));
+    }
+
+    // A tolerance of 0 evaluates the curve exactly again.
+    tabulated.setTabulationTolerance(0);
+    double x = domain(0) + 0.37*range;
+    SimTK_TEST(tabulated.calcValue(x) == exact.calcValue(x));
+}
+
+void testTabulatedCurves()
+{
+    cout << "________________________________________________________" << endl;
+    cout << "          TESTING tabulated curves                      " << endl;
+    cout << "________________________________________________________" << endl;
+
+    const double tolerance = 1e-6;
+    compareTabulatedCurve(ActiveForceLengthCurve(), tolerance);
+    compareTabulatedCurve(ForceVelocityCurve(), tolerance);
+    compareTabulatedCurve(ForceVelocityInverseCurve(), tolerance);
+    compareTabulatedCurve(FiberForceLengthCurve(), tolerance);
+    compareTabulatedCurve(TendonForceLengthCurve(), tolerance);
+
+    ActiveForceLengthCurve fal;
+    SimTK_TEST_MUST_THROW(fal.setTabulationTolerance(-1));
+
+    cout << "Passed: tabulated curves match the exact curves" << endl;
+}
@@ -25,6 +25,7 @@
 //=============================================================================
 #include <fstream>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/Logger.h>
 #include "Thelen2003Muscle.h"
 
 //=============================================================================
@@ -181,6 +182,17 @@ getActivationModel() const
            actMdlIdx);
 }
 
+bool Thelen2003Muscle::getFirstOrderActivationParameters(
+        double& minimumActivation, double& activationTimeConstant,
+        double& deactivationTimeConstant) const
+{
+    const MuscleFirstOrderActivationDynamicModel& actMdl = getActivationModel();
+    minimumActivation = actMdl.get_minimum_activation();
+    activationTimeConstant = actMdl.get_activation_time_constant();
+    deactivationTimeConstant = actMdl.get_deactivation_time_constant();
+    return true;
+}
+
 const MuscleFixedWidthPennationModel& Thelen2003Muscle::
 getPennationModel() const
 {   return getMemberSubcomponent<MuscleFixedWidthPennationModel>(pennMdlIdx); }
@@ -315,8 +327,21 @@ void Thelen2003Muscle::computeInitialFiberEquilibrium(SimTK::State& s) const
     }
     int maxIter = 200;  //Should this be user settable?
 
-    std::pair<StatusFromInitMuscleState, ValuesFromInitMuscleState> result =
-        initMuscleState(s, activation, tol, maxIter);
+    // Start from the fiber length in the state, which is usually close to the
+    // solution when the muscle is equilibrated at successive frames, and from
+    // the default initial guess if that does not converge.
+    std::pair<StatusFromInitMuscleState, ValuesFromInitMuscleState> result;
+    bool converged = false;
+    const double previousFiberLength =
+        getStateVariableValue(s, STATE_FIBER_LENGTH_NAME);
+    if(SimTK::isFinite(previousFiberLength) && previousFiberLength > 0) {
+        result = initMuscleState(s, activation, tol, maxIter,
+                                 previousFiberLength);
+        converged =
+            result.first == StatusFromInitMuscleState::Success_Converged;
+    }
+    if(!converged)
+        result = initMuscleState(s, activation, tol, maxIter);
 
     switch(result.first) {
 
@@ -326,9 +351,9 @@ void Thelen2003Muscle::computeInitialFiberEquilibrium(SimTK::State& s) const
         break;
 
     case StatusFromInitMuscleState::Warning_FiberAtLowerBound:
-        printf("\n\nThelen2003Muscle initialization:"
-               " %s is at its minimum fiber length of %f\n",
-               getName().c_str(), result.second["fiber_length"]);
+        OPENSIM_WARN("\n\nThelen2003Muscle initialization: "
+            << getName() << " is at its minimum fiber length of "
+            << result.second["fiber_length"]);
         setActuation(s, result.second["tendon_force"]);
         setFiberLength(s, result.second["fiber_length"]);
         break;
@@ -674,6 +699,11 @@ bool Thelen2003Muscle::
 /** Get the rate change of activation */
 double Thelen2003Muscle::calcActivationRate(const SimTK::State& s) const 
 {    
+    // Computed by the Model together with those of other muscles.
+    double adot;
+    if (getBatchedActivationDerivative(s, adot))
+        return adot;
+
     double excitation = getExcitation(s);
     double activation = getActivation(s);
     double dadt = getActivationModel().calcDerivative(activation,excitation);
@@ -692,7 +722,8 @@ std::pair<Thelen2003Muscle::StatusFromInitMuscleState,
 Thelen2003Muscle::initMuscleState(const SimTK::State& s,
                                   const double aActivation,
                                   const double aSolTolerance,
-                                  const int aMaxIterations) const
+                                  const int aMaxIterations,
+                                  double initialFiberLength) const
 {
     //I'm using smaller variable names here to make it possible to write out 
     //lengthy equations
@@ -719,10 +750,17 @@ Thelen2003Muscle::initMuscleState(const SimTK::State& s,
     double lce = 0;
     double tl  = getTendonSlackLength()*1.01;
 
-    lce = getPennationModel().calcFiberLength( ml, tl);
-    
-    double phi      = getPennationModel().calcPennationAngle(lce);
-    double cosphi   = cos(phi);
+    double phi, cosphi;
+    if(SimTK::isFinite(initialFiberLength)) {
+        lce    = getPennationModel().clampFiberLength(initialFiberLength);
+        phi    = getPennationModel().calcPennationAngle(lce);
+        cosphi = cos(phi);
+        tl     = getPennationModel().calcTendonLength(cosphi, lce, ml);
+    } else {
+        lce    = getPennationModel().calcFiberLength( ml, tl);
+        phi    = getPennationModel().calcPennationAngle(lce);
+        cosphi = cos(phi);
+    }
     double sinphi   = sin(phi);  
 
     //Normalized quantities
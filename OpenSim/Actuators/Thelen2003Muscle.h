@@ -200,6 +200,13 @@ public:
    */
     const MuscleFirstOrderActivationDynamicModel& getActivationModel() const;
 
+    /** The parameters of the MuscleFirstOrderActivationDynamicModel of this
+    muscle, so that the Model computes its activation derivative together
+    with those of other muscles. */
+    bool getFirstOrderActivationParameters(double& minimumActivation,
+            double& activationTimeConstant,
+            double& deactivationTimeConstant) const override;
+
     /**
    @returns the MuscleFixedWidthPennationModel 
             that this muscle model uses
@@ -322,12 +329,16 @@ private:
            solution
     @param aMaxIterations the maximum number of Newton steps allowed before we
            give up attempting to initialize the model
+    @param initialFiberLength the fiber length to start the Newton iterations
+           from (e.g., the solution at the previous time step), or NaN to
+           start from a fiber length that develops a small tendon force
     */
     std::pair<StatusFromInitMuscleState, ValuesFromInitMuscleState>
         initMuscleState(const SimTK::State& s,
                         const double aActivation,
                         const double aSolTolerance,
-                        const int aMaxIterations) const;
+                        const int aMaxIterations,
+                        double initialFiberLength=SimTK::NaN) const;
 
     double calcFm(double ma, double fal, double fv, 
                  double fpe, double fiso) const;
@@ -28,6 +28,7 @@
 #include "Actuation.h"
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/Actuator.h>
+#include <OpenSim/Simulation/Model/PathActuator.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -134,17 +135,13 @@ Actuation& Actuation::operator=(const Actuation &aActuation)
     // BASE CLASS
     Analysis::operator=(aActuation);
 
-    // Deallocate _fsp if already allocated
-    if (_fsp != NULL) { delete[] _fsp;  _fsp = NULL; }
-
     // STORAGE
     deleteStorage();
     allocateStorage();
 
     // CHECK MODEL
     if (_model != NULL) {
-        _na = getNumEnabledActuators();
-        _fsp = new double[_na];
+        bindActuators();
         constructColumnLabels();
     }
 
@@ -159,12 +156,8 @@ void Actuation::setModel(Model& aModel)
     // BASE CLASS
     Analysis::setModel(aModel);
 
-    // NUMBER OF ACTUATORS
-    if (_model){
-        _na = getNumEnabledActuators();
-    }
-    else
-        _na = 0;
+    // ACTUATORS
+    bindActuators();
 
     if (_na <= 0){
         cout << "WARNING: Actuation analysis canceled. There are no Actuators in the model." << endl;
@@ -368,29 +361,25 @@ record(const SimTK::State& s)
     // TIME NORMALIZATION
     double tReal = s.getTime();
 
-    // FORCE
-    const Set<Actuator>& fSet = _model->getActuators();
-    for (int i = 0, iact = 0; i<fSet.getSize(); i++) {
-        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fSet[i]);
-        if(fSet.get(i).get_appliesForce())
-            _fsp[iact++] = act->getActuation(s);
+    // FORCES AND SPEEDS
+    double* forces = _fsp;
+    double* speeds = _fsp + _na;
+    double* powers = _fsp + 2*_na;
+    for (int i = 0; i < _na; i++) {
+        const ScalarActuator* act = _scalarActuators[i];
+        forces[i] = act ? act->getActuation(s) : SimTK::NaN;
+        speeds[i] = act ? act->getSpeed(s) : SimTK::NaN;
     }
-    _forceStore->append(tReal, _na, _fsp);
 
-    // SPEED
-    for (int i = 0, iact = 0; i<fSet.getSize(); i++) {
-        ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fSet[i]);
-        if(fSet.get(i).get_appliesForce())
-            _fsp[iact++] = act->getSpeed(s);
-    }
-    _speedStore->append(tReal, _na, _fsp);
+    // POWERS
+    for (int i = 0; i < _na; i++)
+        powers[i] = _powerSigns[i]*forces[i]*speeds[i];
+    for (int i = 0; i < _na; i++)
+        if (_powerSigns[i] == 0) powers[i] = _actuators[i]->getPower(s);
 
-    // POWER
-    for (int i = 0, iact = 0; i<fSet.getSize(); i++) {
-        if(fSet.get(i).get_appliesForce())
-            _fsp[iact++] = fSet.get(i).getPower(s);
-    }
-    _powerStore->append(tReal, _na, _fsp);
+    _forceStore->append(tReal, _na, forces);
+    _speedStore->append(tReal, _na, speeds);
+    _powerStore->append(tReal, _na, powers);
 
 
     return(0);
@@ -417,12 +406,8 @@ begin(SimTK::State& s)
 {
     if (!proceed()) return(0);
 
-    // NUMBER OF ACTUATORS
-    int na = _model->getActuators().getSize();
-    _na = na;
-    // WORK ARRAY
-    if (_fsp != NULL) delete[] _fsp;
-    _fsp = new double[_na];
+    // ACTUATORS AND WORK ARRAY
+    bindActuators();
 
     // RESET STORAGE
     if (_forceStore == NULL)
@@ -535,22 +520,32 @@ const string &aExtension)
 }
 //_____________________________________________________________________________
 /**
-* Utility to get number of "Enabled" actuators in model where Enabled is based
-* on the "Property" rather than the live/state value.
-*
-*
-* @return number of Actuators which are enabled
+* Find the actuators that apply force, how their powers are to be computed,
+* and allocate the work array.
 */
-int Actuation::
-getNumEnabledActuators()
+void Actuation::
+bindActuators()
 {
+    _actuators.clear();
+    _scalarActuators.clear();
+    _powerSigns.clear();
+    if (_model) {
+        const Set<Actuator>& actuators = _model->getActuators();
+        for (int i = 0; i < actuators.getSize(); i++) {
+            const Actuator& act = actuators[i];
+            if (!act.get_appliesForce()) continue;
+            const ScalarActuator* scalar =
+                dynamic_cast<const ScalarActuator*>(&act);
+            _actuators.push_back(&act);
+            _scalarActuators.push_back(scalar);
+            if (dynamic_cast<const PathActuator*>(&act))
+                _powerSigns.push_back(-1.0);
+            else
+                _powerSigns.push_back(scalar ? 1.0 : 0.0);
+        }
+    }
+    _na = (int)_actuators.size();
 
-    const Set<Actuator>& actuators = _model->getActuators();
-    int numActuators = actuators.getSize();
-    int numEnabled = numActuators;
-    for (int i = 0; i< numActuators; i++)
-        if(!actuators[i].get_appliesForce())
-            numEnabled--;
-
-    return numEnabled;
+    if (_fsp != NULL) delete[] _fsp;
+    _fsp = new double[3*_na];
 }
@@ -30,6 +30,8 @@
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
 
+#include <vector>
+
 
 #ifdef SWIG
 #ifdef OSIMANALYSES_API
@@ -41,12 +43,22 @@
 //=============================================================================
 namespace OpenSim {
 
+class Actuator;
+class ScalarActuator;
 class Storage;
 
     /**
     * A class for recording the basic actuator information for a model
     * during a simulation.
     *
+    * The actuators that apply force are found when the model is set and at
+    * the beginning of an analysis. At each frame, the forces and speeds of
+    * all of them are gathered into one array, and the powers are computed
+    * from it in one pass: for a ScalarActuator, the power is its actuation
+    * times its speed, negated for a PathActuator (whose speed is its
+    * lengthening speed), as those classes define it. The power of any other
+    * actuator is obtained from its getPower().
+    *
     * @author Frank C. Anderson
     * @version 1.0
     */
@@ -57,11 +69,19 @@ class Storage;
         // DATA
         //=============================================================================
     private:
+        // The actuators that apply force, in the order of the columns.
+        std::vector<const Actuator*> _actuators;
+        // The same actuators as ScalarActuators, or nullptr.
+        std::vector<const ScalarActuator*> _scalarActuators;
+        // The sign of actuation times speed that gives the power of each
+        // actuator, or 0 if the power is to be obtained from getPower().
+        std::vector<double> _powerSigns;
 
     protected:
         /** Number of actuators. */
         int _na;
-        /** Work array for storing forces, speeds, or powers. */
+        /** Work array for storing forces, speeds, and powers, one row after
+        the other. */
         double *_fsp;
         /** Force storage. */
         Storage *_forceStore;
@@ -86,7 +106,8 @@ class Storage;
         void allocateStorage();
         void deleteStorage();
 
-        int getNumEnabledActuators();
+        // Find the actuators that apply force and size the work array.
+        void bindActuators();
     public:
         //--------------------------------------------------------------------------
         // OPERATORS
@@ -115,6 +136,11 @@ class Storage;
             step(const SimTK::State& s, int setNumber) override;
         int
             end(SimTK::State& s) override;
+        /** The actuator forces are available once forces are computed. */
+        SimTK::Stage getRequiredStage() const override
+        {   return SimTK::Stage::Dynamics; }
+        /** Each frame is recorded independently of the others. */
+        bool canMerge() const override { return true; }
     protected:
         virtual int
             record(const SimTK::State& s);
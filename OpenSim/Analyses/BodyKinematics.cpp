@@ -37,6 +37,23 @@ using namespace std;
 #define MAXLEN 10000
 #define CENTER_OF_MASS_NAME string("center_of_mass")
 
+namespace {
+// Kinematics, in ground, of a station (given in a body frame B) from the
+// transform, velocity and acceleration of B in ground.
+inline void findStationKinematics(const SimTK::Transform& X_GB,
+        const SimTK::SpatialVec& V_GB, const SimTK::SpatialVec& A_GB,
+        const SimTK::Vec3& station,
+        SimTK::Vec3& p, SimTK::Vec3& v, SimTK::Vec3& a)
+{
+    const SimTK::Vec3& w = V_GB[0];
+    const SimTK::Vec3 r = X_GB.R()*station;
+    const SimTK::Vec3 wxr = w % r;
+    p = X_GB.p() + r;
+    v = V_GB[1] + wxr;
+    a = A_GB[1] + A_GB[0] % r + w % wxr;
+}
+}
+
 
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
@@ -59,7 +76,10 @@ BodyKinematics::~BodyKinematics()
 BodyKinematics::BodyKinematics(Model *aModel, bool aInDegrees) :
     Analysis(aModel),
     _bodies(_bodiesProp.getValueStrArray()),
-    _expressInLocalFrame(_expressInLocalFrameProp.getValueBool())
+    _expressInLocalFrame(_expressInLocalFrameProp.getValueBool()),
+    _pointNames(_pointNamesProp.getValueStrArray()),
+    _pointBodies(_pointBodiesProp.getValueStrArray()),
+    _pointLocations(_pointLocationsProp.getValueDblArray())
 {
      setNull();
 
@@ -81,7 +101,10 @@ BodyKinematics::BodyKinematics(Model *aModel, bool aInDegrees) :
 BodyKinematics::BodyKinematics(const std::string &aFileName):
     Analysis(aFileName, false),
     _bodies(_bodiesProp.getValueStrArray()),
-    _expressInLocalFrame(_expressInLocalFrameProp.getValueBool())
+    _expressInLocalFrame(_expressInLocalFrameProp.getValueBool()),
+    _pointNames(_pointNamesProp.getValueStrArray()),
+    _pointBodies(_pointBodiesProp.getValueStrArray()),
+    _pointLocations(_pointLocationsProp.getValueDblArray())
 {
     setNull();
 
@@ -99,7 +122,10 @@ BodyKinematics::BodyKinematics(const std::string &aFileName):
 BodyKinematics::BodyKinematics(const BodyKinematics &aBodyKinematics):
     Analysis(aBodyKinematics),
     _bodies(_bodiesProp.getValueStrArray()),
-    _expressInLocalFrame(_expressInLocalFrameProp.getValueBool())
+    _expressInLocalFrame(_expressInLocalFrameProp.getValueBool()),
+    _pointNames(_pointNamesProp.getValueStrArray()),
+    _pointBodies(_pointBodiesProp.getValueStrArray()),
+    _pointLocations(_pointLocationsProp.getValueDblArray())
 {
     setNull();
     // COPY TYPE AND NAME
@@ -125,6 +151,9 @@ operator=(const BodyKinematics &aBodyKinematics)
     Analysis::operator=(aBodyKinematics);
     _bodies = aBodyKinematics._bodies;
     _expressInLocalFrame = aBodyKinematics._expressInLocalFrame;
+    _pointNames = aBodyKinematics._pointNames;
+    _pointBodies = aBodyKinematics._pointBodies;
+    _pointLocations = aBodyKinematics._pointLocations;
     return(*this);
 }
 
@@ -169,6 +198,22 @@ setupProperties()
         "This flag is set to false by default.");
     _expressInLocalFrameProp.setValue(false);
     _propertySet.append(&_expressInLocalFrameProp);
+
+    _pointNamesProp.setName("point_names");
+    _pointNamesProp.setComment("Names of points, fixed on bodies, to record "
+        "kinematics for. The positions, velocities and accelerations of the "
+        "points are always given in the global frame.");
+    _propertySet.append(&_pointNamesProp);
+
+    _pointBodiesProp.setName("point_bodies");
+    _pointBodiesProp.setComment("Names of the bodies the points are fixed "
+        "on, one per point.");
+    _propertySet.append(&_pointBodiesProp);
+
+    _pointLocationsProp.setName("point_locations");
+    _pointLocationsProp.setComment("Locations of the points in the local "
+        "frames of their bodies, three values per point.");
+    _propertySet.append(&_pointLocationsProp);
 }
 
 //=============================================================================
@@ -189,9 +234,10 @@ constructDescription()
     strcat(descrip,"velocities and angular velocities, or");
     strcat(descrip," accelerations and angular accelerations)\n");
     strcat(descrip,"of the centers of mass");
-    sprintf(tmp," of the body segments in model %s.\n",
+    sprintf(tmp," of the body segments in model %s,\n",
         _model->getName().c_str());
     strcat(descrip,tmp);
+    strcat(descrip,"and of points fixed on them (always in the global frame).\n");
     strcat(descrip,"\nBody segment orientations are described using");
     strcat(descrip," body-fixed X-Y-Z Euler angles.\n");
     strcat(descrip,"\nAngular velocities and accelerations are given about");
@@ -235,6 +281,12 @@ constructColumnLabels()
         labels.append(CENTER_OF_MASS_NAME + "_Z");
     }
 
+    for(int i=0; i<_pointNames.getSize(); i++) {
+        labels.append(_pointNames[i] + "_X");
+        labels.append(_pointNames[i] + "_Y");
+        labels.append(_pointNames[i] + "_Z");
+    }
+
     setColumnLabels(labels);
 }
 
@@ -279,11 +331,43 @@ deleteStorage()
 
 //_____________________________________________________________________________
 /**
- * Update bodies to record
+ * Append the kinematics recorded by a copy of this analysis.
+ */
+void BodyKinematics::
+merge(Analysis& aAnalysis)
+{
+    BodyKinematics& other = dynamic_cast<BodyKinematics&>(aAnalysis);
+    appendRows(*_pStore, *other._pStore);
+    appendRows(*_vStore, *other._vStore);
+    appendRows(*_aStore, *other._aStore);
+}
+
+//_____________________________________________________________________________
+/**
+ * Add a point, fixed on a body, whose kinematics are to be recorded.
+ */
+int BodyKinematics::
+addPoint(const std::string& aName, const std::string& aBodyName,
+         const SimTK::Vec3& aLocation)
+{
+    _pointNames.append(aName);
+    _pointBodies.append(aBodyName);
+    for(int j=0; j<3; j++) _pointLocations.append(aLocation[j]);
+    return getNumPoints() - 1;
+}
+
+//_____________________________________________________________________________
+/**
+ * Update bodies and points to record, and the frames whose kinematics are
+ * obtained at each step.
  */
 void BodyKinematics::
 updateBodiesToRecord()
 {
+    _frames.clear();
+    _bodyFrames.clear();
+    _massFrames.clear();
+    _pointFrames.clear();
     if(!_model) {
         _bodyIndices.setSize(0);
         _kin.setSize(0);
@@ -309,7 +393,43 @@ updateBodiesToRecord()
             throw Exception("BodyKinematics: ERR- Could not find body named '"+_bodies[i]+"'",__FILE__,__LINE__);
         _bodyIndices.append(index);
     }
-    _kin.setSize(6*_bodyIndices.getSize()+(_recordCenterOfMass?3:0));
+
+    const int np = _pointNames.getSize();
+    OPENSIM_THROW_IF_FRMOBJ(_pointBodies.getSize() != np, Exception,
+        "Expected a body for each of the " + std::to_string(np) +
+        " points, but got " + std::to_string(_pointBodies.getSize()) + ".");
+    OPENSIM_THROW_IF_FRMOBJ(_pointLocations.getSize() != 3*np, Exception,
+        "Expected 3 location values for each of the " + std::to_string(np) +
+        " points, but got " + std::to_string(_pointLocations.getSize()) +
+        ".");
+
+    // Each body of the model is queried at most once per frame.
+    std::vector<int> frameOfBody(bs.getSize(), -1);
+    const auto frameIndex = [&](int index) {
+        if(frameOfBody[index] < 0) {
+            frameOfBody[index] = (int)_frames.size();
+            _frames.push_back(&bs.get(index));
+        }
+        return frameOfBody[index];
+    };
+    for(int i=0; i<_bodyIndices.getSize(); i++)
+        _bodyFrames.push_back(frameIndex(_bodyIndices[i]));
+    if(_recordCenterOfMass)
+        for(int i=0; i<bs.getSize(); i++) _massFrames.push_back(frameIndex(i));
+    for(int i=0; i<np; i++) {
+        const int index = bs.getIndex(_pointBodies[i]);
+        OPENSIM_THROW_IF_FRMOBJ(index < 0, Exception,
+            "Could not find body named '" + _pointBodies[i] +
+            "' for point '" + _pointNames[i] + "'.");
+        _pointFrames.push_back(frameIndex(index));
+    }
+    _X_GB.resize(_frames.size());
+    _V_GB.resize(_frames.size());
+    _A_GB.resize(_frames.size());
+
+    // The rows of positions, velocities and accelerations, one after the
+    // other.
+    _kin.setSize(3*(6*_bodyIndices.getSize()+(_recordCenterOfMass?3:0)+3*np));
 
     if(_kin.getSize()==0) cout << "WARNING: BodyKinematics analysis has no bodies to record kinematics for" << endl;
 }
@@ -439,153 +559,100 @@ record(const SimTK::State& s)
 
     // Realize to Acceleration first since we'll ask for Accelerations 
     _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-    // VARIABLES
-    SimTK::Vec3 vec,angVec;
-    double Mass = 0.0;
 
-    // GROUND BODY
-    const Ground &ground = _model->getGround();
-
-    // POSITION
-    BodySet& bs = _model->updBodySet();
-
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
-        // GET POSITIONS AND EULER ANGLES
-        vec = body.findStationLocationInGround(s, com);
-        angVec = body.getTransformInGround(s).R().convertRotationToBodyFixedXYZ();
-
-        // CONVERT TO DEGREES?
-        if(getInDegrees()) {
-            angVec[0] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[1] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[2] *= SimTK_RADIAN_TO_DEGREE;
-        }           
-
-        // FILL KINEMATICS ARRAY
-        int I=6*i;
-        memcpy(&_kin[I],&vec[0],3*sizeof(double));
-        memcpy(&_kin[I+3],&angVec[0],3*sizeof(double));
+    // KINEMATICS OF THE FRAMES, EACH OBTAINED ONCE
+    for(size_t f=0; f<_frames.size(); f++) {
+        const SimTK::MobilizedBody& mobod = _frames[f]->getMobilizedBody();
+        _X_GB[f] = mobod.getBodyTransform(s);
+        _V_GB[f] = mobod.getBodyVelocity(s);
+        _A_GB[f] = mobod.getBodyAcceleration(s);
     }
 
-    if(_recordCenterOfMass) {
-        double rP[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            vec = body.findStationLocationInGround(s, com);
-            // ADD TO WHOLE BODY MASS
-            Mass += body.get_mass();
-            rP[0] += body.get_mass() * vec[0];
-            rP[1] += body.get_mass() * vec[1];
-            rP[2] += body.get_mass() * vec[2];
-        }
-
-        //COMPUTE COM OF WHOLE BODY AND ADD TO ARRAY
-        rP[0] /= Mass;
-        rP[1] /= Mass;
-        rP[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rP,3*sizeof(double));
-    }
-    
-    _pStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
+    // The rows of positions, velocities and accelerations.
+    const int n = _kin.getSize()/3;
+    double* pos = &_kin[0];
+    double* vel = pos + n;
+    double* acc = vel + n;
+    SimTK::Vec3 p, v, a;
 
-    // VELOCITY
+    BodySet& bs = _model->updBodySet();
     for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
-        // GET VELOCITIES AND ANGULAR VELOCITIES
-        vec = body.findStationVelocityInGround(s, com);
-        angVec = body.getVelocityInGround(s)[0];
-        if (_expressInLocalFrame) {
-            vec = ground.expressVectorInAnotherFrame(s, vec, body);
-            angVec = ground.expressVectorInAnotherFrame(s, angVec, body);
-        }
-
-        // CONVERT TO DEGREES?
-        if(getInDegrees()) {
-            angVec[0] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[1] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[2] *= SimTK_RADIAN_TO_DEGREE;
-        }           
-
-        // FILL KINEMATICS ARRAY
-        int I = 6*i;
-        memcpy(&_kin[I],&vec[0],3*sizeof(double));
-        memcpy(&_kin[I+3],&angVec[0],3*sizeof(double));
-    }
-
-    if(_recordCenterOfMass) {
-        double rV[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            vec = body.findStationVelocityInGround(s, com);
-            rV[0] += body.get_mass() * vec[0];
-            rV[1] += body.get_mass() * vec[1];
-            rV[2] += body.get_mass() * vec[2];
+        const int f = _bodyFrames[i];
+        const Body& body = *_frames[f];
+        const SimTK::Rotation& R_GB = _X_GB[f].R();
+        findStationKinematics(_X_GB[f], _V_GB[f], _A_GB[f],
+                              body.get_mass_center(), p, v, a);
+        // Body segment orientations as body-fixed X-Y-Z Euler angles.
+        SimTK::Vec3 angPos = R_GB.convertRotationToBodyFixedXYZ();
+        SimTK::Vec3 angVel = _V_GB[f][0];
+        SimTK::Vec3 angAcc = _A_GB[f][0];
+        if(_expressInLocalFrame) {
+            v = ~R_GB*v;
+            angVel = ~R_GB*angVel;
+            a = ~R_GB*a;
+            angAcc = ~R_GB*angAcc;
         }
 
-        //COMPUTE VELOCITY OF COM OF WHOLE BODY AND ADD TO ARRAY
-        rV[0] /= Mass;
-        rV[1] /= Mass;
-        rV[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rV,3*sizeof(double));
+        // FILL KINEMATICS ARRAYS
+        int I=6*i;
+        memcpy(&pos[I],&p[0],3*sizeof(double));
+        memcpy(&pos[I+3],&angPos[0],3*sizeof(double));
+        memcpy(&vel[I],&v[0],3*sizeof(double));
+        memcpy(&vel[I+3],&angVel[0],3*sizeof(double));
+        memcpy(&acc[I],&a[0],3*sizeof(double));
+        memcpy(&acc[I+3],&angAcc[0],3*sizeof(double));
     }
 
-    _vStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
-
-    // ACCELERATIONS
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
-
-        // GET ACCELERATIONS AND ANGULAR ACCELERATIONS
-        vec = body.findStationAccelerationInGround(s, com);
-        angVec = body.getAccelerationInGround(s)[0];
-        if(_expressInLocalFrame) {
-            vec = ground.expressVectorInAnotherFrame(s, vec, body);
-            angVec = ground.expressVectorInAnotherFrame(s, angVec, body);
+    // CONVERT TO DEGREES?
+    if(getInDegrees()) {
+        for(int i=0;i<_bodyIndices.getSize();i++) {
+            for(int j=6*i+3; j<6*i+6; j++) {
+                pos[j] *= SimTK_RADIAN_TO_DEGREE;
+                vel[j] *= SimTK_RADIAN_TO_DEGREE;
+                acc[j] *= SimTK_RADIAN_TO_DEGREE;
+            }
         }
-
-        // CONVERT TO DEGREES?
-        if(getInDegrees()) {
-            angVec[0] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[1] *= SimTK_RADIAN_TO_DEGREE;
-            angVec[2] *= SimTK_RADIAN_TO_DEGREE;
-        }           
-
-        // FILL KINEMATICS ARRAY
-        int I = 6*i;
-        memcpy(&_kin[I],&vec[0],3*sizeof(double));
-        memcpy(&_kin[I+3],&angVec[0],3*sizeof(double));
     }
 
+    int I = 6*_bodyIndices.getSize();
     if(_recordCenterOfMass) {
-        double rA[3] = { 0.0, 0.0, 0.0 };
+        // COMPUTE COM OF WHOLE BODY AND ITS DERIVATIVES
+        double Mass = 0.0;
+        SimTK::Vec3 rP(0), rV(0), rA(0);
         for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            vec = body.findStationAccelerationInGround(s, com);
-            rA[0] += body.get_mass() * vec[0];
-            rA[1] += body.get_mass() * vec[1];
-            rA[2] += body.get_mass() * vec[2];
+            const int f = _massFrames[i];
+            const Body& body = *_frames[f];
+            findStationKinematics(_X_GB[f], _V_GB[f], _A_GB[f],
+                                  body.get_mass_center(), p, v, a);
+            // ADD TO WHOLE BODY MASS
+            Mass += body.get_mass();
+            rP += body.get_mass() * p;
+            rV += body.get_mass() * v;
+            rA += body.get_mass() * a;
         }
+        rP /= Mass;
+        rV /= Mass;
+        rA /= Mass;
+        memcpy(&pos[I],&rP[0],3*sizeof(double));
+        memcpy(&vel[I],&rV[0],3*sizeof(double));
+        memcpy(&acc[I],&rA[0],3*sizeof(double));
+        I += 3;
+    }
 
-        //COMPUTE ACCELERATION OF COM OF WHOLE BODY AND ADD TO ARRAY
-        rA[0] /= Mass;
-        rA[1] /= Mass;
-        rA[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rA,3*sizeof(double));
+    // POINTS
+    for(int i=0;i<_pointNames.getSize();i++, I+=3) {
+        const int f = _pointFrames[i];
+        findStationKinematics(_X_GB[f], _V_GB[f], _A_GB[f],
+            SimTK::Vec3::getAs(&_pointLocations[3*i]), p, v, a);
+        memcpy(&pos[I],&p[0],3*sizeof(double));
+        memcpy(&vel[I],&v[0],3*sizeof(double));
+        memcpy(&acc[I],&a[0],3*sizeof(double));
     }
 
-    _aStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
+    _pStore->append(s.getTime(),n,pos);
+    _vStore->append(s.getTime(),n,vel);
+    _aStore->append(s.getTime(),n,acc);
 
-    //printf("BodyKinematics:\taT:\t%.16f\trA[1]:\t%.16f\n",s.getTime(),rA[1]);
     return(0);
 }
 //_____________________________________________________________________________
@@ -29,18 +29,31 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include <OpenSim/Common/PropertyStrArray.h>
+#include <OpenSim/Common/PropertyDblArray.h>
 #include "osimAnalysesDLL.h"
 
+#include <vector>
+
 
 //=============================================================================
 //=============================================================================
 namespace OpenSim { 
 
+class Body;
 class Model;
 /**
  * A class for recording the kinematics of the bodies
  * of a model during a simulation.
  *
+ * The kinematics of any number of points fixed on the bodies (e.g., markers
+ * to be tracked) may be recorded as well, in the same files, instead of with
+ * a PointKinematics analysis per point. The position, velocity and
+ * acceleration of each point are given in the ground frame.
+ *
+ * The transform, velocity and acceleration of each body involved are
+ * obtained once per frame, and those of the centers of mass and the points
+ * are computed from them.
+ *
  * @author Frank C. Anderson
  * @version 1.0
  */
@@ -63,10 +76,34 @@ protected:
     PropertyBool _expressInLocalFrameProp;
     bool &_expressInLocalFrame;
 
+    /** Names of the points whose kinematics are to be recorded. */
+    PropertyStrArray _pointNamesProp;
+    Array<std::string> &_pointNames;
+    /** Names of the bodies the points are fixed on, one per point. */
+    PropertyStrArray _pointBodiesProp;
+    Array<std::string> &_pointBodies;
+    /** Locations of the points in their bodies, three values per point. */
+    PropertyDblArray _pointLocationsProp;
+    Array<double> &_pointLocations;
+
     Array<int> _bodyIndices;
     bool _recordCenterOfMass;
+    /** The rows of positions, velocities and accelerations, one after the
+    other. */
     Array<double> _kin;
 
+    // The bodies whose kinematics are obtained at each frame, each once: the
+    // recorded bodies, all bodies for the center of mass and the bodies of
+    // the points. The recorded bodies and the points refer to them by index.
+    std::vector<const Body*> _frames;
+    std::vector<int> _bodyFrames;
+    std::vector<int> _massFrames;
+    std::vector<int> _pointFrames;
+    // Work arrays of the transforms, velocities and accelerations of _frames.
+    std::vector<SimTK::Transform> _X_GB;
+    std::vector<SimTK::SpatialVec> _V_GB;
+    std::vector<SimTK::SpatialVec> _A_GB;
+
     Storage *_pStore;
     Storage *_vStore;
     Storage *_aStore;
@@ -111,6 +148,13 @@ public:
     void setRecordCenterOfMass(bool aTrueFalse) {_recordCenterOfMass = aTrueFalse;}
     void setBodiesToRecord(Array<std::string> &listOfBodies) {_bodies = listOfBodies;}
 
+    /** Record the kinematics of a point fixed on a body, in columns labeled
+    with the name of the point. Call before setModel().
+    @return the index of the point */
+    int addPoint(const std::string& aName, const std::string& aBodyName,
+                 const SimTK::Vec3& aLocation);
+    int getNumPoints() const { return _pointNames.getSize(); }
+
 
     void setModel(Model& aModel) override;
     //--------------------------------------------------------------------------
@@ -122,6 +166,12 @@ public:
         step(const SimTK::State& s, int setNumber ) override;
     int
         end(SimTK::State& s ) override;
+    /** The accelerations of the bodies are always recorded. */
+    SimTK::Stage getRequiredStage() const override
+    {   return SimTK::Stage::Acceleration; }
+    /** Each frame is recorded independently of the others. */
+    bool canMerge() const override { return true; }
+    void merge(Analysis& aAnalysis) override;
 protected:
     virtual int
         record(const SimTK::State& s );
@@ -28,6 +28,8 @@
 #include "ForceReporter.h"
 #include <OpenSim/Simulation/Model/Model.h>
 
+#include <algorithm>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -210,6 +212,16 @@ void ForceReporter::constructColumnLabels(const SimTK::State& s)
         
         auto forces = _model->getComponentList<Force>();
 
+        // Size the row buffer for all the forces, so that recording does not
+        // allocate even if forces are enabled later.
+        _numRecordValues.clear();
+        int numValues = 0;
+        for(auto& force : forces) {
+            _numRecordValues.push_back(force.getNumRecordValues());
+            numValues += _numRecordValues.back();
+        }
+        _recordValues.resize(numValues);
+
         for(auto& force : forces) {
             // If body force we need to record six values for torque+force
             // If muscle we record one scalar
@@ -261,17 +273,19 @@ int ForceReporter::record(const SimTK::State& s)
     // MAKE SURE ALL ForceReporter QUANTITIES ARE VALID
     _model->getMultibodySystem().realize(s, SimTK::Stage::Dynamics );
 
-    StateVector nextRow(s.getTime());
-
-    // Model Forces
+    // Model Forces, written straight into the row buffer
     auto forces = _model->getComponentList<Force>();
+    if(_numRecordValues.empty()) constructColumnLabels(s);
 
+    int numValues = 0;
+    int iForce = 0;
     for(auto& force : forces) {
         // If body force we need to record six values for torque+force
         // If muscle we record one scalar
+        const int n = _numRecordValues[iForce++];
         if(!force.appliesForce(s)) continue;
-        Array<double> values = force.getRecordValues(s);
-        nextRow.getData().append(values);
+        force.writeRecordValues(s, _recordValues.data() + numValues);
+        numValues += n;
     }
 
     if(_includeConstraintForces){
@@ -281,10 +295,13 @@ int ForceReporter::record(const SimTK::State& s)
             if (!constraint.isEnforced(s))
                 continue;
             Array<double> values = constraint.getRecordValues(s);
-            nextRow.getData().append(values);
+            _recordValues.resize(numValues + values.getSize());
+            std::copy(values.get(), values.get() + values.getSize(),
+                      _recordValues.data() + numValues);
+            numValues += values.getSize();
         }
     }
-    _forceStore.append(nextRow);
+    _forceStore.append(s.getTime(), numValues, _recordValues.data());
 
     return(0);
 }
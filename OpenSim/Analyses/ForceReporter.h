@@ -30,6 +30,8 @@
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
 
+#include <vector>
+
 #ifdef SWIG
     #ifdef OSIMANALYSES_API
         #undef OSIMANALYSES_API
@@ -64,6 +66,12 @@ protected:
     /** Force storage. */
     Storage _forceStore;
 
+    /** Number of values recorded for each Force of the model, in the order
+    of the model's list of Forces. */
+    std::vector<int> _numRecordValues;
+    /** Row of values being recorded. */
+    std::vector<double> _recordValues;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -118,6 +126,12 @@ public:
     int begin(SimTK::State& s ) override;
     int step(const SimTK::State& s, int setNumber ) override;
     int end(SimTK::State& s ) override;
+    /** Dynamics, or Acceleration to include the constraint forces. */
+    SimTK::Stage getRequiredStage() const override
+    {   return _includeConstraintForces ? SimTK::Stage::Acceleration
+                                        : SimTK::Stage::Dynamics; }
+    /** Each frame is recorded independently of the others. */
+    bool canMerge() const override { return true; }
 
 protected:
     virtual int
@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/ExternalForce.h>
 #include "InducedAccelerations.h"
@@ -37,6 +38,19 @@ using namespace std;
 //=============================================================================
 #define CENTER_OF_MASS_NAME string("center_of_mass")
 
+namespace {
+    // Acceleration in ground of a station on a body, given the spatial
+    // acceleration of the body.
+    SimTK::Vec3 calcStationAcceleration(const SimTK::State& s,
+            const SimTK::MobilizedBody& mobod, const SimTK::SpatialVec& A_GB,
+            const SimTK::Vec3& station)
+    {
+        const SimTK::Vec3 r = mobod.getBodyRotation(s)*station;
+        const SimTK::Vec3& w = mobod.getBodyAngularVelocity(s);
+        return A_GB[1] + A_GB[0] % r + w % (w % r);
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -171,6 +185,7 @@ void InducedAccelerations::setNull()
     _bodyNames[0] = CENTER_OF_MASS_NAME;
     _computePotentialsOnly = false;
     _reportConstraintReactions = false;
+    _haveConstraintFactorization = false;
     // Analysis does not own contents of these sets
     _coordSet.setMemoryOwner(false);
     _bodySet.setMemoryOwner(false);
@@ -501,7 +516,7 @@ int InducedAccelerations::record(const SimTK::State& s)
 {
     int nu = _model->getNumSpeeds();
     double aT = s.getTime();
-    cout << "time = " << aT << endl;
+    OPENSIM_INFO("time = " << aT);
 
     SimTK::Vector Q = s.getQ();
 
@@ -537,6 +552,30 @@ int InducedAccelerations::record(const SimTK::State& s)
     // DO NOT recreate the system, will lose location of constraint
     _model->initStateWithoutRecreatingSystem(s_analysis);
 
+    // Without the total, the contributors other than the muscles disable all
+    // the actuators, so the muscles can be overridden once for all of them
+    // rather than realizing the model again for each muscle.
+    if(_computePotentialsOnly){
+        const Set<Muscle>& muscles = _model->getMuscles();
+        for(int f=0; f<muscles.getSize(); f++){
+            muscles[f].overrideActuation(s_analysis, true);
+            muscles[f].setOverrideActuation(s_analysis, 1.0);
+        }
+        _model->getMultibodySystem().realizeModel(s_analysis);
+    }
+
+    // Solve for the accelerations of the contributors but the total with one
+    // factorization of the constraint equations, unless the reactions, which
+    // come from the multipliers Simbody computes, are reported or there is
+    // prescribed motion, which the factorization does not account for.
+    bool solveDirectly = !_reportConstraintReactions;
+    const CoordinateSet& modelCoords = _model->getCoordinateSet();
+    for(int i=0; i<modelCoords.getSize() && solveDirectly; i++)
+        solveDirectly = !modelCoords[i].isPrescribed(s_analysis);
+    _haveConstraintFactorization = false;
+
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+
     // Cycle through the force contributors to the system acceleration
     for(int c=0; c< _contributors.getSize(); c++){          
         //cout << "Solving for contributor: " << _contributors[c] << endl;
@@ -619,6 +658,9 @@ int InducedAccelerations::record(const SimTK::State& s)
             // This should also push changes to defaults for unilateral conditions
             _model->setPropertiesFromState(s_analysis);
 
+            // The constraints enforced may have changed.
+            _haveConstraintFactorization = false;
+
         }
         else if(_contributors[c] == "gravity"){
             // Set gravity ON
@@ -681,19 +723,9 @@ int InducedAccelerations::record(const SimTK::State& s)
                 throw Exception("InducedAcceleration: ERR- Could not find actuator '"+_contributors[c],__FILE__,__LINE__);
             
             Actuator &actuator = _model->getActuators().get(ai);
-            ScalarActuator* act = dynamic_cast<ScalarActuator*>(&actuator);
-            act->setAppliesForce(s_analysis, true);
-            act->overrideActuation(s_analysis, false);
-            Muscle *muscle = dynamic_cast<Muscle *>(&actuator);
-            if(muscle){
-                if(_computePotentialsOnly){
-                    muscle->overrideActuation(s_analysis, true);
-                    muscle->setOverrideActuation(s_analysis, 1.0);
-                }
-            }
+            actuator.setAppliesForce(s_analysis, true);
 
             // Set the configuration (gen. coords and speeds) of the model.
-            _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Model);
             _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Velocity);
 
         }// End of if to select contributor 
@@ -703,7 +735,15 @@ int InducedAccelerations::record(const SimTK::State& s)
 
         // After setting the state of the model and applying forces
         // Compute the derivative of the multibody system (speeds and accelerations)
-        _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
+        if(solveDirectly && _contributors[c] != "total"){
+            _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Dynamics);
+            solveForAccelerations(s_analysis);
+        }
+        else{
+            _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Acceleration);
+            _udot = s_analysis.getUDot();
+            matter.calcBodyAccelerationFromUDot(s_analysis, _udot, _A_GB);
+        }
 
         // Sanity check that constraints hasn't totally changed the configuration of the model
         // double error = (Q-s_analysis.getQ()).norm();
@@ -723,7 +763,10 @@ int InducedAccelerations::record(const SimTK::State& s)
 
         // Get Accelerations for kinematics of bodies
         for(int i=0;i<_coordSet.getSize();i++) {
-            double acc = _coordSet.get(i).getAccelerationValue(s_analysis);
+            const Coordinate& coord = _coordSet.get(i);
+            double acc = matter.getMobilizedBody(coord.getBodyIndex())
+                .getOneFromUPartition(s_analysis, coord.getMobilizerQIndex(),
+                                      _udot);
 
             if(getInDegrees()) 
                 acc *= SimTK_RADIAN_TO_DEGREE;  
@@ -739,8 +782,11 @@ int InducedAccelerations::record(const SimTK::State& s)
             const SimTK::Vec3& com = body.get_mass_center();
             
             // Get the body acceleration
-            vec = body.findStationAccelerationInGround(s_analysis, com);
-            angVec = body.getAccelerationInGround(s_analysis)[0];
+            const SimTK::MobilizedBody& mobod = body.getMobilizedBody();
+            const SimTK::SpatialVec& A_GB =
+                _A_GB[mobod.getMobilizedBodyIndex()];
+            vec = calcStationAcceleration(s_analysis, mobod, A_GB, com);
+            angVec = A_GB[0];
 
             // CONVERT TO DEGREES?
             if(getInDegrees()) 
@@ -754,7 +800,16 @@ int InducedAccelerations::record(const SimTK::State& s)
         // Get Accelerations for kinematics of COM
         if(_includeCOM){
             // Get the body acceleration in ground
-            vec = _model->getMultibodySystem().getMatterSubsystem().calcSystemMassCenterAccelerationInGround(s_analysis);
+            double mass = 0;
+            vec = 0;
+            for(SimTK::MobilizedBodyIndex b(1); b<matter.getNumBodies(); ++b){
+                const SimTK::MobilizedBody& mobod = matter.getMobilizedBody(b);
+                double m = mobod.getBodyMass(s_analysis);
+                vec += m*calcStationAcceleration(s_analysis, mobod, _A_GB[b],
+                    mobod.getBodyMassCenterStation(s_analysis));
+                mass += m;
+            }
+            vec /= mass;
 
             // FILL KINEMATICS ARRAY
             _comIndAccs.append(3, &vec[0]);
@@ -792,6 +847,60 @@ int InducedAccelerations::record(const SimTK::State& s)
     return(0);
 }
 
+//_____________________________________________________________________________
+/**
+ * Solve for the accelerations due to the forces applied in a state realized
+ * to Dynamics, with the constraints enforced in that state, using the
+ * factorization of the constraint equations shared by the contributors at
+ * this frame. The generalized and body accelerations are held in _udot and
+ * _A_GB.
+ *
+ * The constraint multipliers lambda satisfy W*lambda = G*udot0 - b, where
+ * udot0 are the accelerations ignoring the constraints and W = G*M^-1*~G,
+ * which depends only on the configuration, so it is the same for all the
+ * contributors.
+ */
+void InducedAccelerations::solveForAccelerations(const SimTK::State& s)
+{
+    const SimTK::MultibodySystem& system = _model->getMultibodySystem();
+    const SimTK::SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+
+    matter.calcAccelerationIgnoringConstraints(s,
+        system.getMobilityForces(s, SimTK::Stage::Dynamics),
+        system.getRigidBodyForces(s, SimTK::Stage::Dynamics), _udot, _A_GB);
+
+    if(!_haveConstraintFactorization){
+        SimTK::Matrix W;
+        matter.calcProjectedMInv(s, W);
+        int m = W.nrow();
+        if(m > 0)
+            _constraintFactorization.factor(W);
+
+        // Columns of M^-1*~G
+        _mInvGt.resize(s.getNU(), m);
+        SimTK::Vector e(m, 0.0), Gt, MInvGt;
+        for(int j=0; j<m; j++){
+            e[j] = 1;
+            matter.multiplyByGTranspose(s, e, Gt);
+            matter.multiplyByMInv(s, Gt, MInvGt);
+            _mInvGt(j) = MInvGt;
+            e[j] = 0;
+        }
+        _haveConstraintFactorization = true;
+    }
+
+    if(_mInvGt.ncol() > 0){
+        SimTK::Vector bias, Gudot, lambda;
+        matter.calcBiasForMultiplyByG(s, bias);
+        matter.multiplyByG(s, _udot, bias, Gudot);
+        // bias = -b
+        matter.calcBiasForAccelerationConstraints(s, bias);
+        _constraintFactorization.solve(Gudot + bias, lambda);
+        _udot -= _mInvGt*lambda;
+    }
+    matter.calcBodyAccelerationFromUDot(s, _udot, _A_GB);
+}
+
 /**
  * This method is called at the beginning of an analysis so that any
  * necessary initializations may be performed.
@@ -30,6 +30,7 @@
 #include <OpenSim/Common/PropertyObj.h>
 #include <OpenSim/Common/PropertyStrArray.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
+#include <simmath/LinearAlgebra.h>
 // Header to define analysis (DLL) interface
 #include "osimAnalysesDLL.h"
 
@@ -123,6 +124,16 @@ protected:
     // Hold the actual model gravity since we will be changing it back and forth from 0
     SimTK::Vec3 _gravity;
 
+    // The constraints enforced are the same for all the contributors but the
+    // total, so the constraint equations are factored once per frame and
+    // used to solve for the accelerations of each of those contributors.
+    bool _haveConstraintFactorization;
+    SimTK::FactorQTZ _constraintFactorization;
+    SimTK::Matrix _mInvGt;
+    // Induced accelerations of the current contributor
+    SimTK::Vector _udot;
+    SimTK::Vector_<SimTK::SpatialVec> _A_GB;
+
 
 //=============================================================================
 // METHODS
@@ -185,6 +196,14 @@ public:
     // GET AND SET
     //-------------------------------------------------------------------------
     void setModel(Model &aModel) override;
+    /** Report the contributions to the constraint reactions. These are solved
+        for each contributor separately, which is slower. */
+    void setReportConstraintReactions(bool aReport) {
+        _reportConstraintReactions = aReport;
+    }
+    bool getReportConstraintReactions() const {
+        return _reportConstraintReactions;
+    }
 
     //-------------------------------------------------------------------------
     // INTEGRATION
@@ -215,6 +234,7 @@ protected:
     Array<std::string> constructColumnLabelsForCOM();
     Array<std::string> constructColumnLabelsForConstraintReactions();
     void setupStorage();
+    void solveForAccelerations(const SimTK::State& s);
 
     Array<bool> applyConstraintsAccordingToExternalForces(SimTK::State &s);
 
@@ -326,14 +326,18 @@ record(const SimTK::State& s)
 
 //cout << "\nQ= " << s.getQ() << endl;
 //cout << "\nU= " << s.getU() << endl;
+    // The work arrays of this frame are taken from the scratch arena.
+    ScratchArena& scratch = updScratch();
+    ScratchArena::Scope scope(scratch);
+
     // Build linear constraint matrix and constant constraint vector
-    SimTK::Vector f(nf), c(nacc);
-    f = 0;
-    computeAcceleration(sWorkingCopy, &f[0], &_constraintVector[0]);
+    double* f = scratch.allocate<double>(nf, 0.0);
+    double* c = scratch.allocate<double>(nacc);
+    computeAcceleration(sWorkingCopy, f, &_constraintVector[0]);
 
     for(int j=0; j<nf; j++) {
         f[j] = 1;
-        computeAcceleration(sWorkingCopy, &f[0], &c[0]);
+        computeAcceleration(sWorkingCopy, f, c);
         for(int i=0; i<nacc; i++) _constraintMatrix(i,j) = (c[i] - _constraintVector[i]);
         f[j] = 0;
     }
@@ -367,17 +371,22 @@ record(const SimTK::State& s)
     // NOTE: It destroys the matrices/vectors we pass to it, so we need to pass it copies of performanceMatrix and performanceVector (don't bother making
     // copies of _constraintMatrix/Vector since those are reinitialized each time anyway)
     int info;
-    SimTK::Matrix performanceMatrixCopy = _performanceMatrix;
-    SimTK::Vector performanceVectorCopy = _performanceVector;
+    double* performanceMatrixCopy = scratch.allocate<double>(nf*nf);
+    double* performanceVectorCopy = scratch.allocate<double>(nf);
+    for(int j=0; j<nf; j++) {
+        for(int i=0; i<nf; i++)
+            performanceMatrixCopy[i+j*nf] = _performanceMatrix(i,j);
+        performanceVectorCopy[j] = _performanceVector[j];
+    }
 //cout << "performanceMatrixCopy : " << performanceMatrixCopy << endl;
 //cout << "performanceVectorCopy : " << performanceVectorCopy << endl;
 //cout << "_constraintMatrix : " << _constraintMatrix << endl;
 //cout << "_constraintVector : " << _constraintVector << endl;
 //cout << "nf=" << nf << "  nacc=" << nacc << endl;
-    dgglse_(nf, nf, nacc, &performanceMatrixCopy(0,0), nf, &_constraintMatrix(0,0), nacc, &performanceVectorCopy[0], &_constraintVector[0], &f[0], &_lapackWork[0], _lapackWork.size(), info);
+    dgglse_(nf, nf, nacc, performanceMatrixCopy, nf, &_constraintMatrix(0,0), nacc, performanceVectorCopy, &_constraintVector[0], f, &_lapackWork[0], _lapackWork.size(), info);
 
     // Record inverse dynamics forces
-    _storage->append(sWorkingCopy.getTime(),nf,&f[0]);
+    _storage->append(sWorkingCopy.getTime(),nf,f);
 
 //cout << "\n ** f : " << f << endl << endl;
 
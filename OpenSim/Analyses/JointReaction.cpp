@@ -398,6 +398,7 @@ void JointReaction::loadForcesFromFile()
         // check if actuator set and forces file have the same actuators
         bool _containsAllActuators = true;
         int actuatorSetSize = _model->getActuators().getSize();
+        _actuatorStorageIndices.setSize(0);
         if(actuatorSetSize > storeSize){
             cout << "The forces file does not contain enough actuators." << endl;
             _containsAllActuators = false;
@@ -411,12 +412,15 @@ void JointReaction::loadForcesFromFile()
                     cout << "\nThe actuator " << actuatorName << " was not found in the forces file." << endl;
                     _containsAllActuators = false;
                 }
+                _actuatorStorageIndices.append(storageIndex);
             }
         }
 
         if(_containsAllActuators) {
             if(storeSize> actuatorSetSize) cout << "\nWARNING:  The forces file contains actuators that are not in the model's actuator set." << endl;
             _useForceStorage = true;
+            _actuatorForces.setSize(storeSize);
+            _actuationCursor.reset();
             cout << "WARNING:  Ignoring fiber lengths and activations from the states since " << _forcesFileNameProp.getName() << " is also set." << endl;
             cout << "Actuator forces will be constructed from " << _forcesFileName << "." << endl;
         }
@@ -454,6 +458,19 @@ setupStorage()
 
 }
 
+//_____________________________________________________________________________
+/**
+ * Find the mobilized body of each joint in the reaction list, once the
+ * system of the model has been created.
+ */
+void JointReaction::setupMobilizedBodyIndices()
+{
+    for(int i=0; i<_reactionList.getSize(); i++) {
+        _reactionList[i].mobilizedBodyIndex =
+            _reactionList[i].joint->getChildFrame().getMobilizedBodyIndex();
+    }
+}
+
 
 //=============================================================================
 // GET AND SET
@@ -508,87 +525,75 @@ record(const SimTK::State& s)
 {
     /** if a forces file is specified replace the computed actuation with the 
         forces from storage.*/
-    SimTK::State s_analysis = s;
-
-    _model->updMultibodySystem().realize(s_analysis, s.getSystemStage());
+    const SimTK::State* state = &s;
     if(_useForceStorage){
-
-        const Set<Actuator> *actuatorSet = &_model->getActuators();
-        int nA = actuatorSet->getSize();
-        Array<double> forces(0,nA);
-        _storeActuation->getDataAtTime(s.getTime(),nA,forces);
-        int storageIndex = -1;
+        SimTK::State& s_analysis = _stateWithForces;
+        s_analysis = s;
+        _model->updMultibodySystem().realize(s_analysis, s.getSystemStage());
+
+        const Set<Actuator>& actuatorSet = _model->getActuators();
+        int nA = actuatorSet.getSize();
+        _storeActuation->getDataAtTime(s.getTime(),
+            _actuatorForces.getSize(), &_actuatorForces[0], _actuationCursor);
         for(int actuatorIndex=0;actuatorIndex<nA;actuatorIndex++)
         {
-            //Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(actuatorIndex));
-            std::string actuatorName = actuatorSet->get(actuatorIndex).getName();
-            storageIndex = _storeActuation->getStateIndex(actuatorName, 0);
-            if(storageIndex == -1){
-                cout << "The actuator, " << actuatorName << ", was not found in the forces file." << endl;
-                break;
-            }
-            const ScalarActuator* act = dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
+            const ScalarActuator* act =
+                dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
             if (act){
                 act->overrideActuation(s_analysis, true);
-                act->setOverrideActuation(s_analysis, forces[storageIndex]);
+                act->setOverrideActuation(s_analysis,
+                    _actuatorForces[_actuatorStorageIndices[actuatorIndex]]);
             }
         }
+        state = &_stateWithForces;
     }
-    // VARIABLES
-    const Ground& ground = _model->getGround();
-    int numJoints = _model->getNumJoints();
 
-    _model->realizeAcceleration(s_analysis);
+    _model->realizeAcceleration(*state);
+
+    /* compute the reactions of all the mobilizers at once, rather than once
+    *  per joint, then convert the desired joint reactions to the desired
+    *  bodies and reference frames*/
+    const SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    matter.calcMobilizerReactionForces(*state, _mobilizerReactions);
 
-    /* retrieved desired joint reactions, convert to desired bodies, and convert
-    *  to desired reference frames*/
     int numOutputJoints = _reactionList.getSize();
-    Vector_<Vec3> forcesVec(numOutputJoints), momentsVec(numOutputJoints), pointsVec(numOutputJoints);
     for(int i=0; i<numOutputJoints; i++) {
-        JointReactionKey currentKey = _reactionList[i];
-        const Joint& joint = *currentKey.joint;
-        const Frame& expressedInBody = *currentKey.expressedInFrame;
-        SpatialVec jointReaction;
-        Vec3 pointOfApplication;
-        
+        const JointReactionKey& currentKey = _reactionList[i];
+        const MobilizedBody& mobod =
+            matter.getMobilizedBody(currentKey.mobilizedBodyIndex);
+        const Transform& X_GE =
+            currentKey.expressedInFrame->getTransformInGround(*state);
+
+        // reaction on the child at the mobilizer frame M, expressed in ground
+        SpatialVec jointReaction = _mobilizerReactions[mobod.getMobilizedBodyIndex()];
+        Vec3 pointInGround =
+            mobod.getBodyTransform(*state)*mobod.getOutboardFrame(*state).p();
+
         // check if the load requested is on the parent or child
         if(!currentKey.isAppliedOnChild){
-            jointReaction = joint.calcReactionOnParentExpressedInGround(s_analysis);
-
-            // find the point of application in immediate parent frame, then
-            // transform to the base frame of the parent (expressedInBody)
-            Vec3 parentLocationInGlobal = joint.getParentFrame().getTransformInGround(s_analysis).p();
-            pointOfApplication = 
-                ground.findStationLocationInAnotherFrame(s_analysis, parentLocationInGlobal, expressedInBody);
-        }
-        else{
-            jointReaction = joint.calcReactionOnChildExpressedInGround(s_analysis);
-
-            // find the point of application in immediate child frame, then
-            // transform to the base frame of the child (expressedInBody)
-            Vec3 childLocationInGlobal = joint.getChildFrame().getTransformInGround(s_analysis).p();
-            pointOfApplication =
-                ground.findStationLocationInAnotherFrame(s_analysis, childLocationInGlobal, expressedInBody);
+            // the reaction on the parent at the mobilizer frame F is equal
+            // and opposite to the reaction on the child, shifted to F
+            Vec3 parentPointInGround =
+                mobod.getParentMobilizedBody().getBodyTransform(*state)*
+                mobod.getInboardFrame(*state).p();
+            jointReaction[0] += (pointInGround - parentPointInGround) %
+                                jointReaction[1];
+            jointReaction = -jointReaction;
+            pointInGround = parentPointInGround;
         }
 
-        // transform SpatialVec of reaction forces and moments to the
-        // requested base frame (expressedInBody)
-        Vec3 force = ground.expressVectorInAnotherFrame(s_analysis, jointReaction[1], expressedInBody);
-        Vec3 moment = ground.expressVectorInAnotherFrame(s_analysis, jointReaction[0], expressedInBody);
-
-        /* place results in the truncated loads vectors*/
-        forcesVec[i] = force;
-        momentsVec[i] = moment;
-        pointsVec[i] = pointOfApplication;
-    }
+        // express the reaction forces and moments and the point of
+        // application in the requested frame (expressedInBody)
+        const Vec3 force = ~X_GE.R()*jointReaction[1];
+        const Vec3 moment = ~X_GE.R()*jointReaction[0];
+        const Vec3 pointOfApplication = ~X_GE*pointInGround;
 
-    /* fill out row construction array*/
-    for(int i=0;i<numOutputJoints;i++) {
+        /* fill out row construction array*/
         int I = 9*i;
         for(int j=0;j<3;j++) {
-            _Loads[I+j] = forcesVec[i][j];
-            _Loads[I+j+3] = momentsVec[i][j];
-            _Loads[I+j+6] = pointsVec[i][j];
+            _Loads[I+j] = force[j];
+            _Loads[I+j+3] = moment[j];
+            _Loads[I+j+6] = pointOfApplication[j];
         }
     }
     /* Write the reaction data to storage*/
@@ -613,6 +618,7 @@ begin(SimTK::State& s)
     if(!proceed()) return(0);
     // Read forces file here rather than during initialization
     setupStorage();
+    setupMobilizedBodyIndices();
 
     // RESET STORAGE
     _storeReactionLoads.reset(s.getTime());
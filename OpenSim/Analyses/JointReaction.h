@@ -79,6 +79,9 @@ private:
         const Frame* appliedOnBody;
         /* The reference Frame in which the force should be expressed. */
         const Frame* expressedInFrame;
+        /* The mobilized body of the child frame of the joint, whose
+           mobilizer reaction is the reaction of the joint. Set in begin(). */
+        SimTK::MobilizedBodyIndex mobilizedBodyIndex;
     };
 
 protected:
@@ -135,6 +138,20 @@ protected:
     *   desired joints, onBody, and inFrame to be output*/
     Array<JointReactionKey> _reactionList;
 
+    /** Internal work array for holding the mobilizer reactions of all the
+    *   mobilized bodies, computed at once for all the joints. */
+    SimTK::Vector_<SimTK::SpatialVec> _mobilizerReactions;
+
+    /** Column of each actuator in the forces storage, and the work array
+    *   holding a row of the forces storage. */
+    Array<int> _actuatorStorageIndices;
+    Array<double> _actuatorForces;
+    Storage::Cursor _actuationCursor;
+
+    /** Copy of the state in which the actuation is overridden by the forces
+    *   storage. */
+    SimTK::State _stateWithForces;
+
     bool _useForceStorage;
 
 //=============================================================================
@@ -208,6 +225,7 @@ protected:
     void constructColumnLabels();
     void setupStorage();
     void loadForcesFromFile();
+    void setupMobilizedBodyIndices();
 
 //=============================================================================
 }; // END of class JointReaction
@@ -352,12 +352,8 @@ setStorageCapacityIncrements(int aIncrement)
  */
 int Kinematics::record(const SimTK::State& s)
 {
-    if(_recordAccelerations){
-        _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-    }
-    else{
-        _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
-    }
+    _model->getMultibodySystem().realize(s, getRequiredStage());
+
     // RECORD RESULTS
     const CoordinateSet& cs = _model->getCoordinateSet();
     int nvalues = _coordinateIndices.getSize();
@@ -418,11 +414,6 @@ begin( SimTK::State& s )
     // RECORD
     int status = 0;
     if(_pStore->getSize()<=0) {
-        if(_recordAccelerations && s.getSystemStage() < SimTK::Stage::Acceleration ) 
-            _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-        else
-            _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
-
         status = record(s);
     }
 
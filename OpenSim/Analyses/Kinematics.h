@@ -97,6 +97,13 @@ public:
 
     void setRecordAccelerations(bool aRecordAccelerations) { _recordAccelerations = aRecordAccelerations; } // TODO: re-allocate storage or delete storage
 
+    /** Acceleration if accelerations are recorded, Velocity otherwise. */
+    SimTK::Stage getRequiredStage() const override
+    {   return _recordAccelerations ? SimTK::Stage::Acceleration
+                                    : SimTK::Stage::Velocity; }
+    /** Each frame is recorded independently of the others. */
+    bool canMerge() const override { return true; }
+
     //--------------------------------------------------------------------------
     // ANALYSIS
     //--------------------------------------------------------------------------
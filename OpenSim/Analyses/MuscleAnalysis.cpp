@@ -27,9 +27,14 @@
 // INCLUDES
 //=============================================================================
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/ThreadPool.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include "MuscleAnalysis.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -59,7 +64,8 @@ MuscleAnalysis::~MuscleAnalysis()
  * @param aModel Model for which the MuscleAnalysis are to be recorded.
  */
 MuscleAnalysis::MuscleAnalysis(Model *aModel) :
-    Analysis(aModel)
+    Analysis(aModel),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     // NULL
     setNull();
@@ -80,7 +86,8 @@ MuscleAnalysis::MuscleAnalysis(Model *aModel) :
  * @param aFileName File name of the document.
  */
 MuscleAnalysis::MuscleAnalysis(const std::string &aFileName):
-Analysis(aFileName, false)
+Analysis(aFileName, false),
+_numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     updateFromXMLDocument();
@@ -92,7 +99,8 @@ Analysis(aFileName, false)
  *
  */
 MuscleAnalysis::MuscleAnalysis(const MuscleAnalysis &aMuscleAnalysis):
-Analysis(aMuscleAnalysis)
+Analysis(aMuscleAnalysis),
+_numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     *this = aMuscleAnalysis;
@@ -165,6 +173,13 @@ void MuscleAnalysis::setupProperties()
     _computeMomentsProp.setName("compute_moments");
     _propertySet.append( &_computeMomentsProp );
 
+    _numThreadsProp.setComment("Number of threads used to evaluate the "
+        "muscles at each time. With more than one thread, the muscles are "
+        "divided among the threads, each with its own copy of the state.");
+    _numThreadsProp.setName("number_of_threads");
+    _numThreadsProp.setValue(1);
+    _propertySet.append( &_numThreadsProp );
+
 }
 //-----------------------------------------------------------------------------
 // DESCRIPTION
@@ -410,7 +425,9 @@ MuscleAnalysis& MuscleAnalysis::operator=(const MuscleAnalysis &aAnalysis)
     _muscleListProp = aAnalysis._muscleListProp;
     _coordinateListProp = aAnalysis._coordinateListProp;
     _computeMomentsProp = aAnalysis._computeMomentsProp;
+    _numThreadsProp = aAnalysis._numThreadsProp;
     _computeMoments = _computeMomentsProp.getValueBool();
+    _maSolver.reset();
     allocateStorageObjects();
 
     return (*this);
@@ -430,6 +447,7 @@ MuscleAnalysis& MuscleAnalysis::operator=(const MuscleAnalysis &aAnalysis)
 void MuscleAnalysis::setModel(Model& aModel)
 {
     Super::setModel(aModel);
+    _maSolver.reset();
     allocateStorageObjects();
 }
 //_____________________________________________________________________________
@@ -506,168 +524,245 @@ int MuscleAnalysis::record(const SimTK::State& s)
     // LOOP THROUGH MUSCLES
     int nm = _muscleArray.getSize();
 
-    double nan = SimTK::NaN;
-    // Angles and lengths
-    Array<double> penang(nan,nm);
-    Array<double> len(nan,nm), tlen(nan,nm);
-    Array<double> fiblen(nan,nm), normfiblen(nan,nm);
-
-    // Muscle velocity information
-    Array<double> fibVel(nan,nm), normFibVel(nan,nm);
-    Array<double> penAngVel(nan,nm);
-
-    // Muscle component forces
-    Array<double> force(nan, nm), fibforce(nan, nm);
-    Array<double> actfibforce(nan,nm), passfibforce(nan,nm);
-    Array<double> actfibforcealongten(nan,nm), passfibforcealongten(nan,nm);
-
-    // Muscle and component powers
-    Array<double> fibActivePower(nan,nm), fibPassivePower(nan,nm),
-                  tendonPower(nan,nm), muscPower(nan,nm);
+    // The work buffer is normally allocated in begin(), but the muscles may
+    // have changed since then.
+    if ((int)_muscleValues.size() != NumMuscleQuantities*nm)
+        allocateMuscleValues();
+    std::fill(_muscleValues.begin(), _muscleValues.end(), SimTK::NaN);
 
     double sysMass = _model->getMatterSubsystem().calcSystemMass(s);
     bool hasMass = sysMass > SimTK::Eps;
 
     // Just warn once per instant
-    bool lengthWarning = false;
-    bool forceWarning = false;
-    bool dynamicsWarning = false;
-
-    for(int i=0; i<nm; ++i) {
-        try{
-            len[i] = _muscleArray[i]->getLength(s);
-            tlen[i] = _muscleArray[i]->getTendonLength(s);
-            fiblen[i] = _muscleArray[i]->getFiberLength(s);
-            normfiblen[i] = _muscleArray[i]->getNormalizedFiberLength(s);
-            penang[i] = _muscleArray[i]->getPennationAngle(s);
-        }
-        catch (const std::exception& e) {
-            if(!lengthWarning){
-                cout << "WARNING- MuscleAnalysis::record() unable to evaluate ";
-                cout << "muscle length at time " << s.getTime() << " for reason: ";
-                cout << e.what() << endl;
-                lengthWarning = true;
-            }
-            continue;
+    std::string lengthWarning, forceWarning, dynamicsWarning;
+
+    const int nThreads = std::min(ThreadPool::getNumThreads(_numThreads), nm);
+    if (nThreads > 1) {
+        // Quantities shared by all the muscles are evaluated here, once, so
+        // that the threads only fill the cache entries of their own muscles.
+        _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+        _model->getControls(s);
+
+        // Each thread evaluates its muscles on its own copy of the state so
+        // that the threads do not write to the same cache.
+        std::vector<SimTK::State> states(nThreads, s);
+        std::vector<std::string> lengthWarnings(nThreads),
+            forceWarnings(nThreads), dynamicsWarnings(nThreads);
+        ThreadPool::parallelForRanges(nm, nThreads,
+            [&](int c, int first, int last) {
+                computeMuscleForces(states[c], first, last,
+                    lengthWarnings[c], forceWarnings[c]);
+                if (hasMass)
+                    computeMuscleDynamics(states[c], first, last,
+                        dynamicsWarnings[c]);
+            });
+
+        for (int c = 0; c < nThreads; ++c) {
+            if (lengthWarning.empty()) lengthWarning = lengthWarnings[c];
+            if (forceWarning.empty()) forceWarning = forceWarnings[c];
+            if (dynamicsWarning.empty()) dynamicsWarning = dynamicsWarnings[c];
         }
+    }
+    else {
+        computeMuscleForces(s, 0, nm, lengthWarning, forceWarning);
 
-        try{
-            // Compute muscle forces that are dependent on Positions, Velocities
-            // so that later quantities are valid and setForce is called
-            _muscleArray[i]->computeActuation(s);
-            force[i] = _muscleArray[i]->getActuation(s);
-            fibforce[i] = _muscleArray[i]->getFiberForce(s);
-            actfibforce[i] = _muscleArray[i]->getActiveFiberForce(s);
-            passfibforce[i] = _muscleArray[i]->getPassiveFiberForce(s);
-            actfibforcealongten[i] = _muscleArray[i]->getActiveFiberForceAlongTendon(s);
-            passfibforcealongten[i] = _muscleArray[i]->getPassiveFiberForceAlongTendon(s);
-        }
-        catch (const std::exception& e) {
-            if(!forceWarning){
-                cout << "WARNING- MuscleAnalysis::record() unable to evaluate ";
-                cout << "muscle forces at time " << s.getTime() << " for reason: ";
-                cout << e.what() << endl;
-                forceWarning = true;
-            }
-            continue;
+        // Cannot compute system dynamics without mass
+        if(hasMass){
+            // state derivatives (activation rate and fiber velocity) evaluated at dynamics
+            _model->getMultibodySystem().realize(s,SimTK::Stage::Dynamics);
+            computeMuscleDynamics(s, 0, nm, dynamicsWarning);
         }
     }
 
-    // Cannot compute system dynamics without mass
-    if(hasMass){
-        // state derivatives (activation rate and fiber velocity) evaluated at dynamics
-        _model->getMultibodySystem().realize(s,SimTK::Stage::Dynamics);
-
-        for(int i=0; i<nm; ++i) {
-            try{
-                //Velocities
-                fibVel[i] = _muscleArray[i]->getFiberVelocity(s);
-                normFibVel[i] =  _muscleArray[i]->getNormalizedFiberVelocity(s);
-                penAngVel[i] =  _muscleArray[i]->getPennationAngularVelocity(s);
-                //Powers
-                fibActivePower[i] = _muscleArray[i]->getFiberActivePower(s);
-                fibPassivePower[i] = _muscleArray[i]->getFiberPassivePower(s);
-                tendonPower[i] = _muscleArray[i]->getTendonPower(s);
-                muscPower[i] = _muscleArray[i]->getMusclePower(s);
-            }
-            catch (const std::exception& e) {
-                if(!dynamicsWarning){
-                    cout << "WARNING- MuscleAnalysis::record() unable to evaluate ";
-                    cout << "muscle forces at time " << s.getTime() << " for reason: ";
-                    cout << e.what() << endl;
-                    dynamicsWarning = true;
-                }
-            continue;
-            }
-        }
+    if(!lengthWarning.empty()){
+        OPENSIM_WARN("WARNING- MuscleAnalysis::record() unable to evaluate "
+            << "muscle length at time " << s.getTime() << " for reason: "
+            << lengthWarning);
     }
-    else {
-        if(!dynamicsWarning){
-            cout << "WARNING- MuscleAnalysis::record() unable to evaluate ";
-            cout << "muscle dynamics at time " << s.getTime() << " because ";
-            cout << "model has no mass and system dynamics cannot be computed." << endl;
-            dynamicsWarning = true;
-        }
+    if(!forceWarning.empty()){
+        OPENSIM_WARN("WARNING- MuscleAnalysis::record() unable to evaluate "
+            << "muscle forces at time " << s.getTime() << " for reason: "
+            << forceWarning);
+    }
+    if(!hasMass){
+        OPENSIM_WARN("WARNING- MuscleAnalysis::record() unable to evaluate "
+            << "muscle dynamics at time " << s.getTime() << " because "
+            << "model has no mass and system dynamics cannot be computed.");
+    }
+    else if(!dynamicsWarning.empty()){
+        OPENSIM_WARN("WARNING- MuscleAnalysis::record() unable to evaluate "
+            << "muscle forces at time " << s.getTime() << " for reason: "
+            << dynamicsWarning);
     }
 
     // APPEND TO STORAGE
-    _pennationAngleStore->append(tReal,penang.getSize(),&penang[0]);
-    _lengthStore->append(tReal,len.getSize(),&len[0]);
-    _fiberLengthStore->append(tReal,fiblen.getSize(),&fiblen[0]);
+    _pennationAngleStore->append(tReal,nm,updMuscleValues(PennationAngle));
+    _lengthStore->append(tReal,nm,updMuscleValues(Length));
+    _fiberLengthStore->append(tReal,nm,updMuscleValues(FiberLength));
     _normalizedFiberLengthStore
-        ->append(tReal,normfiblen.getSize(),&normfiblen[0]);
-    _tendonLengthStore->append(tReal,tlen.getSize(),&tlen[0]);
+        ->append(tReal,nm,updMuscleValues(NormalizedFiberLength));
+    _tendonLengthStore->append(tReal,nm,updMuscleValues(TendonLength));
 
-    _fiberVelocityStore->append(tReal,fibVel.getSize(),&fibVel[0]);
-    _normFiberVelocityStore->append(tReal,normFibVel.getSize(),&normFibVel[0]);
+    _fiberVelocityStore->append(tReal,nm,updMuscleValues(FiberVelocity));
+    _normFiberVelocityStore
+        ->append(tReal,nm,updMuscleValues(NormalizedFiberVelocity));
     _pennationAngularVelocityStore
-        ->append(tReal,penAngVel.getSize(),&penAngVel[0]);
+        ->append(tReal,nm,updMuscleValues(PennationAngularVelocity));
 
-    _forceStore->append(tReal,force.getSize(),&force[0]);
-    _fiberForceStore->append(tReal,fibforce.getSize(),&fibforce[0]);
-    _activeFiberForceStore->append(tReal,actfibforce.getSize(),&actfibforce[0]);
+    _forceStore->append(tReal,nm,updMuscleValues(Force));
+    _fiberForceStore->append(tReal,nm,updMuscleValues(FiberForce));
+    _activeFiberForceStore->append(tReal,nm,updMuscleValues(ActiveFiberForce));
     _passiveFiberForceStore
-        ->append(tReal,passfibforce.getSize(),&passfibforce[0]);
+        ->append(tReal,nm,updMuscleValues(PassiveFiberForce));
     _activeFiberForceAlongTendonStore
-        ->append(tReal,actfibforcealongten.getSize(),&actfibforcealongten[0]);
+        ->append(tReal,nm,updMuscleValues(ActiveFiberForceAlongTendon));
     _passiveFiberForceAlongTendonStore
-        ->append(tReal,passfibforcealongten.getSize(),&passfibforcealongten[0]);
+        ->append(tReal,nm,updMuscleValues(PassiveFiberForceAlongTendon));
 
     _fiberActivePowerStore
-        ->append(tReal,fibActivePower.getSize(),&fibActivePower[0]);
+        ->append(tReal,nm,updMuscleValues(FiberActivePower));
     _fiberPassivePowerStore
-        ->append(tReal,fibPassivePower.getSize(),&fibPassivePower[0]);
-    _tendonPowerStore->append(tReal,tendonPower.getSize(),&tendonPower[0]);
-    _musclePowerStore->append(tReal,muscPower.getSize(),&muscPower[0]);
+        ->append(tReal,nm,updMuscleValues(FiberPassivePower));
+    _tendonPowerStore->append(tReal,nm,updMuscleValues(TendonPower));
+    _musclePowerStore->append(tReal,nm,updMuscleValues(MusclePower));
 
     if (_computeMoments){
         // LOOP OVER ACTIVE MOMENT ARM STORAGE OBJECTS
-        Coordinate *q = NULL;
         Storage *maStore=NULL, *mStore=NULL;
         int nq = _momentArmStorageArray.getSize();
-        Array<double> ma(0.0,nm),m(0.0,nm);
+        const double* force = updMuscleValues(Force);
+        double* ma = updMuscleValues(MomentArm);
+        double* m = updMuscleValues(Moment);
+
+        // Solve for the moment arms of all muscles about all coordinates at
+        // once, rather than muscle by muscle and coordinate by coordinate.
+        std::vector<const Coordinate*> coordinates(nq);
+        for(int i=0; i<nq; i++)
+            coordinates[i] = _momentArmStorageArray[i]->q;
+        std::vector<const GeometryPath*> paths(nm);
+        for(int j=0; j<nm; j++)
+            paths[j] = &_muscleArray[j]->getGeometryPath();
+
+        if (!_maSolver)
+            _maSolver.reset(new MomentArmSolver(*_model));
+        _model->getMultibodySystem().realize(s, s.getSystemStage());
+        const SimTK::Matrix momentArms =
+            _maSolver->solve(s, coordinates, paths);
 
         for(int i=0; i<nq; i++) {
 
-            q = _momentArmStorageArray[i]->q;
             maStore = _momentArmStorageArray[i]->momentArmStore;
             mStore = _momentArmStorageArray[i]->momentStore;
-           
-            // bool locked = q->getLocked(s);
 
-            _model->getMultibodySystem().realize(s, s.getSystemStage());
             // LOOP OVER MUSCLES
             for(int j=0; j<nm; j++) {
-                ma[j] = _muscleArray[j]->computeMomentArm(s,*q);
+                ma[j] = momentArms(i, j);
                 m[j] = ma[j] * force[j];
             }
-            maStore->append(s.getTime(),nm,&ma[0]);
-            mStore->append(s.getTime(),nm,&m[0]);
+            maStore->append(s.getTime(),nm,ma);
+            mStore->append(s.getTime(),nm,m);
         }
     }
     return 0;
 }
 //_____________________________________________________________________________
+/**
+ * Evaluate the lengths and forces of a range of muscles.
+ */
+void MuscleAnalysis::computeMuscleForces(const SimTK::State& s,
+    int first, int last, std::string& lengthWarning, std::string& forceWarning)
+{
+    // Angles and lengths
+    double* penang = updMuscleValues(PennationAngle);
+    double* len = updMuscleValues(Length);
+    double* tlen = updMuscleValues(TendonLength);
+    double* fiblen = updMuscleValues(FiberLength);
+    double* normfiblen = updMuscleValues(NormalizedFiberLength);
+
+    // Muscle component forces
+    double* force = updMuscleValues(Force);
+    double* fibforce = updMuscleValues(FiberForce);
+    double* actfibforce = updMuscleValues(ActiveFiberForce);
+    double* passfibforce = updMuscleValues(PassiveFiberForce);
+    double* actfibforcealongten = updMuscleValues(ActiveFiberForceAlongTendon);
+    double* passfibforcealongten =
+        updMuscleValues(PassiveFiberForceAlongTendon);
+
+    for(int i=first; i<last; ++i) {
+        try{
+            len[i] = _muscleArray[i]->getLength(s);
+            tlen[i] = _muscleArray[i]->getTendonLength(s);
+            fiblen[i] = _muscleArray[i]->getFiberLength(s);
+            normfiblen[i] = _muscleArray[i]->getNormalizedFiberLength(s);
+            penang[i] = _muscleArray[i]->getPennationAngle(s);
+        }
+        catch (const std::exception& e) {
+            if(lengthWarning.empty()) lengthWarning = e.what();
+            continue;
+        }
+
+        try{
+            // Compute muscle forces that are dependent on Positions, Velocities
+            // so that later quantities are valid and setForce is called
+            _muscleArray[i]->computeActuation(s);
+            force[i] = _muscleArray[i]->getActuation(s);
+            fibforce[i] = _muscleArray[i]->getFiberForce(s);
+            actfibforce[i] = _muscleArray[i]->getActiveFiberForce(s);
+            passfibforce[i] = _muscleArray[i]->getPassiveFiberForce(s);
+            actfibforcealongten[i] = _muscleArray[i]->getActiveFiberForceAlongTendon(s);
+            passfibforcealongten[i] = _muscleArray[i]->getPassiveFiberForceAlongTendon(s);
+        }
+        catch (const std::exception& e) {
+            if(forceWarning.empty()) forceWarning = e.what();
+            continue;
+        }
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate the velocities and powers of a range of muscles.
+ */
+void MuscleAnalysis::computeMuscleDynamics(const SimTK::State& s,
+    int first, int last, std::string& dynamicsWarning)
+{
+    // Muscle velocity information
+    double* fibVel = updMuscleValues(FiberVelocity);
+    double* normFibVel = updMuscleValues(NormalizedFiberVelocity);
+    double* penAngVel = updMuscleValues(PennationAngularVelocity);
+
+    // Muscle and component powers
+    double* fibActivePower = updMuscleValues(FiberActivePower);
+    double* fibPassivePower = updMuscleValues(FiberPassivePower);
+    double* tendonPower = updMuscleValues(TendonPower);
+    double* muscPower = updMuscleValues(MusclePower);
+
+    for(int i=first; i<last; ++i) {
+        try{
+            //Velocities
+            fibVel[i] = _muscleArray[i]->getFiberVelocity(s);
+            normFibVel[i] =  _muscleArray[i]->getNormalizedFiberVelocity(s);
+            penAngVel[i] =  _muscleArray[i]->getPennationAngularVelocity(s);
+            //Powers
+            fibActivePower[i] = _muscleArray[i]->getFiberActivePower(s);
+            fibPassivePower[i] = _muscleArray[i]->getFiberPassivePower(s);
+            tendonPower[i] = _muscleArray[i]->getTendonPower(s);
+            muscPower[i] = _muscleArray[i]->getMusclePower(s);
+        }
+        catch (const std::exception& e) {
+            if(dynamicsWarning.empty()) dynamicsWarning = e.what();
+            continue;
+        }
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Size the work buffer for the muscles being analyzed.
+ */
+void MuscleAnalysis::allocateMuscleValues()
+{
+    _muscleValues.assign(NumMuscleQuantities*_muscleArray.getSize(), 0.0);
+}
+//_____________________________________________________________________________
 /**
  * This method is called at the beginning of an analysis so that any
  * necessary initializations may be performed.
@@ -688,6 +783,10 @@ int MuscleAnalysis::begin(SimTK::State& s )
 
     allocateStorageObjects();
 
+    // The solver works on a copy of the state of the model's current system.
+    if (_model) _maSolver.reset(new MomentArmSolver(*_model));
+    allocateMuscleValues();
+
     // RESET STORAGE
     Storage *store;
     int size = _storageList.getSize();
@@ -30,6 +30,7 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Simulation/MomentArmSolver.h>
 #include "osimAnalysesDLL.h"
 
 
@@ -87,6 +88,10 @@ private:
     /** Compute moments and moment arms. */
     PropertyBool _computeMomentsProp;
 
+    /** Number of threads used to evaluate the muscles at each time. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
     /** Pennation angle storage. */
     Storage *_pennationAngleStore;
     /** Muscle-tendon length storage. */
@@ -141,6 +146,24 @@ private:
     /** Array of active muscles. */
     ArrayPtrs<Muscle> _muscleArray;
 
+    /** Solver for the moment arms of all the muscles about all the
+    coordinates, created for the model's system in begin(). */
+    SimTK::ResetOnCopy<std::unique_ptr<MomentArmSolver> > _maSolver;
+
+    /** Quantities evaluated for each muscle at each time, in the order in
+    which they are stored in _muscleValues. */
+    enum MuscleQuantity {
+        PennationAngle, Length, TendonLength, FiberLength,
+        NormalizedFiberLength, FiberVelocity, NormalizedFiberVelocity,
+        PennationAngularVelocity, Force, FiberForce, ActiveFiberForce,
+        PassiveFiberForce, ActiveFiberForceAlongTendon,
+        PassiveFiberForceAlongTendon, FiberActivePower, FiberPassivePower,
+        TendonPower, MusclePower, MomentArm, Moment, NumMuscleQuantities
+    };
+    /** Work buffer holding the value of each quantity for every muscle,
+    quantity by quantity. Allocated in begin() rather than in record(). */
+    std::vector<double> _muscleValues;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -212,6 +235,14 @@ public:
     void setMuscles(Array<std::string>& aMuscles);
     void setCoordinates(Array<std::string>& aCoordinates);
 
+    /** %Set the number of threads used to evaluate the lengths, forces and
+    powers of the muscles at each time. With more than one thread, the muscles
+    are divided among the threads and each thread evaluates its muscles with
+    its own copy of the state. Moment arms are always solved for on the
+    calling thread. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
     void setComputeMoments(bool aTrueFalse) {
         _computeMoments = aTrueFalse;
     }
@@ -230,9 +261,26 @@ public:
         step(const SimTK::State& s, int setNumber ) override;
     int
         end( SimTK::State& s ) override;
+    /** Each frame is recorded independently of the others. */
+    bool canMerge() const override { return true; }
 protected:
     virtual int
         record(const SimTK::State& s );
+private:
+    /** Size the work buffer for the current set of muscles. */
+    void allocateMuscleValues();
+    double* updMuscleValues(MuscleQuantity quantity) {
+        return _muscleValues.data() + quantity*_muscleArray.getSize();
+    }
+    /** Evaluate the lengths and forces of the muscles with indices in
+    [first, last). The reason for the first failure, if any, is returned in
+    lengthWarning or forceWarning. */
+    void computeMuscleForces(const SimTK::State& s, int first, int last,
+        std::string& lengthWarning, std::string& forceWarning);
+    /** Evaluate the velocities and powers of the muscles with indices in
+    [first, last). */
+    void computeMuscleDynamics(const SimTK::State& s, int first, int last,
+        std::string& dynamicsWarning);
     //--------------------------------------------------------------------------
     // IO
     //--------------------------------------------------------------------------
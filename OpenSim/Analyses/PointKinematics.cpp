@@ -292,6 +292,19 @@ deleteStorage()
     if(_pStore!=NULL) { delete _pStore;  _pStore=NULL; }
 }
 
+//_____________________________________________________________________________
+/**
+ * Append the kinematics recorded by a copy of this analysis.
+ */
+void PointKinematics::
+merge(Analysis& aAnalysis)
+{
+    PointKinematics& other = dynamic_cast<PointKinematics&>(aAnalysis);
+    appendRows(*_pStore, *other._pStore);
+    appendRows(*_vStore, *other._vStore);
+    appendRows(*_aStore, *other._aStore);
+}
+
 
 //=============================================================================
 // GET AND SET
@@ -517,7 +530,7 @@ record(const SimTK::State& s)
     SimTK::Vec3 vec;
 
     const double& time = s.getTime();
-    Ground ground = _model->getGround();
+    const Ground& ground = _model->getGround();
 
     // POSITION
     vec = _body->findStationLocationInGround(s, _point);
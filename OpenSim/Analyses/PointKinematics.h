@@ -150,6 +150,12 @@ public:
         step(const SimTK::State& s, int setNumber) override;
     int
         end( SimTK::State& s) override;
+    /** The acceleration of the point is always recorded. */
+    SimTK::Stage getRequiredStage() const override
+    {   return SimTK::Stage::Acceleration; }
+    /** Each frame is recorded independently of the others. */
+    bool canMerge() const override { return true; }
+    void merge(Analysis& aAnalysis) override;
 protected:
     virtual int
         record(const SimTK::State& s );
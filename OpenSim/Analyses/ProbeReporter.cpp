@@ -137,6 +137,9 @@ void ProbeReporter::setModel(Model& aModel)
 {
     // BASE CLASS
     Super::setModel(aModel);
+
+    // The probes are collected again for the new model.
+    _enabledProbes.clear();
 }
 
 //_____________________________________________________________________________
@@ -192,6 +195,8 @@ void ProbeReporter::constructColumnLabels(const SimTK::State& s)
         // ASSIGN
         Array<string> columnLabels;
         columnLabels.append("time");
+        _enabledProbes.clear();
+        int nOutputs = 0;
         int nP=_model->getProbeSet().getSize();
 
         for(int i=0 ; i<nP ; i++) {
@@ -202,7 +207,10 @@ void ProbeReporter::constructColumnLabels(const SimTK::State& s)
             // Get column names for the probe after the operation
             Array<string> probeLabels = p.getProbeOutputLabels();
             columnLabels.append(probeLabels);
+            _enabledProbes.push_back(&p);
+            nOutputs += p.getNumProbeInputs();
         }
+        _probeRow.resize(nOutputs);
         //cout << "COL SIZE = " << columnLabels.getSize() << endl;
         _probeStore.setColumnLabels(columnLabels);
     }
@@ -235,25 +243,16 @@ int ProbeReporter::record(const SimTK::State& s)
     // MAKE SURE ALL ProbeReporter QUANTITIES ARE VALID
     _model->getMultibodySystem().realize(s, SimTK::Stage::Report );
 
-    StateVector nextRow(s.getTime());
-
-    // NUMBER OF Probes
-    const ProbeSet& probes = _model->getProbeSet();
-    int nP = probes.getSize();
-
-    for(int i=0 ; i<nP ; i++) {
-        Probe& nextProbe = (Probe&)probes[i];
-
-        if (nextProbe.isEnabled())
-        {
-            // Get probe values after the probe operation
-            SimTK::Vector values = nextProbe.getProbeOutputs(s);
-            for (int i=0; i<values.size(); i++)
-                nextRow.getData().append(values(i));
-        }
+    // Write the values of all the probes after the probe operation into one
+    // row, set up with the column labels.
+    if (_enabledProbes.empty()) constructColumnLabels(s);
+    int offset = 0;
+    for (const Probe* probe : _enabledProbes) {
+        probe->getProbeOutputs(s, &_probeRow[offset]);
+        offset += probe->getNumProbeInputs();
     }
 
-    _probeStore.append(nextRow);
+    _probeStore.append(s.getTime(), _probeRow);
 
     return 0;
 }
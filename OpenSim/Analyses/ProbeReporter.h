@@ -91,6 +91,12 @@ protected:
     /** Probe storage. */
     Storage _probeStore;
 
+private:
+    // The enabled probes of the model, and a row of their outputs, set up by
+    // constructColumnLabels() so that record() does not allocate.
+    std::vector<const Probe*> _enabledProbes;
+    SimTK::Vector _probeRow;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -200,12 +200,14 @@ record(const SimTK::State& s)
 {
     if(_model==NULL) return(-1);
 
-    // MAKE SURE ALL StatesReporter QUANTITIES ARE VALID
-    _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity );
-
-    SimTK::Vector stateValues = _model->getStateVariableValues(s);
-    StateVector nextRow(s.getTime(), stateValues);
-    _statesStore.append(nextRow);
+    // Gather the values into the scratch arena rather than a new Vector.
+    ScratchArena& scratch = updScratch();
+    ScratchArena::Scope scope(scratch);
+    const int n = _model->getNumStateVariables();
+    double* values = scratch.allocate<double>(n);
+    SimTK::Vector stateValues(n, values, true);
+    _model->getStateVariableValues(s, stateValues);
+    _statesStore.append(s.getTime(), n, values);
 
     return(0);
 }
@@ -104,6 +104,11 @@ public:
         step(const SimTK::State& s, int setNumber ) override;
     int
         end(SimTK::State& s ) override;
+    /** The state variables are recorded without realizing the state. */
+    SimTK::Stage getRequiredStage() const override
+    {   return SimTK::Stage::Model; }
+    /** Each frame is recorded independently of the others. */
+    bool canMerge() const override { return true; }
 protected:
     virtual int
         record(const SimTK::State& s );
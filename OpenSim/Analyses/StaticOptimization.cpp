@@ -26,6 +26,7 @@
 // INCLUDES
 //=============================================================================
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/ThreadPool.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Actuators/CoordinateActuator.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
@@ -47,6 +48,8 @@ using namespace std;
 StaticOptimization::~StaticOptimization()
 {
     deleteStorage();
+    _optimizer.reset();
+    _target.reset();
     delete _modelWorkingCopy;
     if(_ownsForceSet) delete _forceSet;
 }
@@ -61,6 +64,8 @@ StaticOptimization::StaticOptimization(Model *aModel) :
     _useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
     _convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
     _maximumIterations(_maximumIterationsProp.getValueInt()),
+    _numThreads(_numThreadsProp.getValueInt()),
+    _useQuadraticProgram(_useQuadraticProgramProp.getValueBool()),
     _modelWorkingCopy(NULL)
 {
     setNull();
@@ -82,6 +87,8 @@ StaticOptimization::StaticOptimization(const StaticOptimization &aStaticOptimiza
     _useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
     _convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
     _maximumIterations(_maximumIterationsProp.getValueInt()),
+    _numThreads(_numThreadsProp.getValueInt()),
+    _useQuadraticProgram(_useQuadraticProgramProp.getValueBool()),
     _modelWorkingCopy(NULL)
 {
     setNull();
@@ -108,13 +115,17 @@ operator=(const StaticOptimization &aStaticOptimization)
     // BASE CLASS
     Analysis::operator=(aStaticOptimization);
 
-    _modelWorkingCopy = aStaticOptimization._modelWorkingCopy;
+    // The working copy of the model belongs to the analysis that made it.
     _numCoordinateActuators = aStaticOptimization._numCoordinateActuators;
     _useModelForceSet = aStaticOptimization._useModelForceSet;
     _activationExponent=aStaticOptimization._activationExponent;
     _convergenceCriterion=aStaticOptimization._convergenceCriterion;
     _maximumIterations=aStaticOptimization._maximumIterations;
+    _numThreads=aStaticOptimization._numThreads;
+    _useQuadraticProgram=aStaticOptimization._useQuadraticProgram;
     _forceReporter = nullptr;
+    _optimizer = nullptr;
+    _target = nullptr;
     _useMusclePhysiology=aStaticOptimization._useMusclePhysiology;
     return(*this);
 }
@@ -138,6 +149,8 @@ void StaticOptimization::setNull()
     _numCoordinateActuators = 0;
     _convergenceCriterion = 1e-4;
     _maximumIterations = 100;
+    _numThreads = 1;
+    _useQuadraticProgram = true;
     _forceReporter = nullptr;
     setName("StaticOptimization");
 }
@@ -173,6 +186,22 @@ setupProperties()
         "An integer for setting the maximum number of iterations the optimizer can use at each time.  ");
     _maximumIterationsProp.setName("optimizer_max_iterations");
     _propertySet.append(&_maximumIterationsProp);
+
+    _numThreadsProp.setComment(
+        "Number of threads used to solve the frames. With more than one "
+        "thread, the frames after the first are split into contiguous chunks, "
+        "each solved with its own copy of the model.");
+    _numThreadsProp.setName("number_of_threads");
+    _numThreadsProp.setValue(1);
+    _propertySet.append(&_numThreadsProp);
+
+    _useQuadraticProgramProp.setComment(
+        "If true (the default), frames are solved directly as quadratic "
+        "programs when the activation exponent is 2, falling back to the "
+        "optimizer only when that fails.");
+    _useQuadraticProgramProp.setName("use_quadratic_program");
+    _useQuadraticProgramProp.setValue(true);
+    _propertySet.append(&_useQuadraticProgramProp);
 }
 
 //=============================================================================
@@ -323,47 +352,13 @@ record(const SimTK::State& s)
     int na = fs.getSize();
     int nacc = _accelerationIndices.getSize();
 
-    // IPOPT
-    _numericalDerivativeStepSize = 0.0001;
-    _optimizerAlgorithm = "ipopt";
-    _printLevel = 0;
-    //_optimizationConvergenceTolerance = 1e-004;
-    //_maxIterations = 2000;
-
-    // Optimization target
-    _modelWorkingCopy->setAllControllersEnabled(false);
-    StaticOptimizationTarget target(sWorkingCopy,_modelWorkingCopy,na,nacc,_useMusclePhysiology);
-    target.setStatesStore(_statesStore);
-    target.setStatesSplineSet(_statesSplineSet);
-    target.setActivationExponent(_activationExponent);
-    target.setDX(_numericalDerivativeStepSize);
-
-    // Pick optimizer algorithm
-    SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
-    //SimTK::OptimizerAlgorithm algorithm = SimTK::CFSQP;
-
-    // Optimizer
-    SimTK::Optimizer *optimizer = new SimTK::Optimizer(target, algorithm);
-
-    // Optimizer options
-    //cout<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
-    optimizer->setDiagnosticsLevel(_printLevel);
-    //cout<<"Setting optimizer convergence criterion to "<<_convergenceCriterion<<".\n";
-    optimizer->setConvergenceTolerance(_convergenceCriterion);
-    //cout<<"Setting optimizer maximum iterations to "<<_maximumIterations<<".\n";
-    optimizer->setMaxIterations(_maximumIterations);
-    optimizer->useNumericalGradient(false);
-    optimizer->useNumericalJacobian(false);
-    if(algorithm == SimTK::InteriorPoint) {
-        // Some IPOPT-specific settings
-        optimizer->setLimitedMemoryHistory(500); // works well for our small systems
-        optimizer->setAdvancedBoolOption("warm_start",true);
-        optimizer->setAdvancedRealOption("obj_scaling_factor",1);
-        optimizer->setAdvancedRealOption("nlp_scaling_max_gradient",1);
-    }
+    // The work arrays of this frame are taken from the scratch arena.
+    ScratchArena& scratch = updScratch();
+    ScratchArena::Scope scope(scratch);
 
     // Parameter bounds
-    SimTK::Vector lowerBounds(na), upperBounds(na);
+    SimTK::Vector lowerBounds(na, scratch.allocate<double>(na), true);
+    SimTK::Vector upperBounds(na, scratch.allocate<double>(na), true);
     for(int i=0,j=0;i<fs.getSize();i++) {
         ScalarActuator* act = dynamic_cast<ScalarActuator*>(&fs.get(i));
         if (act) {
@@ -372,10 +367,59 @@ record(const SimTK::State& s)
             j++;
         }
     }
-    
-    target.setParameterLimits(lowerBounds, upperBounds);
 
-    _parameters = 0; // Set initial guess to zeros
+    _modelWorkingCopy->setAllControllersEnabled(false);
+    if(!_optimizer) {
+        // IPOPT
+        _numericalDerivativeStepSize = 0.0001;
+        _optimizerAlgorithm = "ipopt";
+        _printLevel = 0;
+        //_optimizationConvergenceTolerance = 1e-004;
+        //_maxIterations = 2000;
+
+        // Optimization target
+        _target.reset(new StaticOptimizationTarget(sWorkingCopy,
+                _modelWorkingCopy, na, nacc, _useMusclePhysiology));
+        _target->setStatesStore(_statesStore);
+        _target->setStatesSplineSet(_statesSplineSet);
+        _target->setActivationExponent(_activationExponent);
+        _target->setDX(_numericalDerivativeStepSize);
+        _target->setParameterLimits(lowerBounds, upperBounds);
+
+        // Pick optimizer algorithm
+        SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
+        //SimTK::OptimizerAlgorithm algorithm = SimTK::CFSQP;
+
+        // Optimizer
+        _optimizer.reset(new SimTK::Optimizer(*_target, algorithm));
+
+        // Optimizer options
+        //cout<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
+        _optimizer->setDiagnosticsLevel(_printLevel);
+        //cout<<"Setting optimizer convergence criterion to "<<_convergenceCriterion<<".\n";
+        _optimizer->setConvergenceTolerance(_convergenceCriterion);
+        //cout<<"Setting optimizer maximum iterations to "<<_maximumIterations<<".\n";
+        _optimizer->setMaxIterations(_maximumIterations);
+        _optimizer->useNumericalGradient(false);
+        _optimizer->useNumericalJacobian(false);
+        if(algorithm == SimTK::InteriorPoint) {
+            // Some IPOPT-specific settings
+            _optimizer->setLimitedMemoryHistory(500); // works well for our small systems
+            _optimizer->setAdvancedBoolOption("warm_start",true);
+            _optimizer->setAdvancedRealOption("obj_scaling_factor",1);
+            _optimizer->setAdvancedRealOption("nlp_scaling_max_gradient",1);
+        }
+
+        _parameters = 0; // Set initial guess to zeros
+    }
+    StaticOptimizationTarget& target = *_target;
+
+    // Start from the solution of the previous frame, within the bounds in
+    // case that solution failed.
+    for(int i=0;i<na;i++) {
+        _parameters[i] = SimTK::isNaN(_parameters[i]) ? 0 :
+            SimTK::clamp(lowerBounds[i], _parameters[i], upperBounds[i]);
+    }
 
     // Static optimization
     _modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
@@ -390,7 +434,12 @@ record(const SimTK::State& s)
 
     try {
         target.setCurrentState( &sWorkingCopy );
-        optimizer->optimize(_parameters);
+        // With a quadratic cost, the problem is a quadratic program that is
+        // solved directly, unless it is too degenerate for that solver.
+        if(!_useQuadraticProgram || _activationExponent != 2 ||
+                !target.solveQuadraticProgram(lowerBounds, upperBounds,
+                                              _parameters))
+            _optimizer->optimize(_parameters);
     }
     catch (const SimTK::Exception::Base& ex) {
         cout << ex.getMessage() << endl;
@@ -487,7 +536,7 @@ record(const SimTK::State& s)
 
     _activationStorage->append(sWorkingCopy.getTime(),na,&_parameters[0]);
 
-    SimTK::Vector forces(na);
+    SimTK::Vector forces(na, scratch.allocate<double>(na), true);
     target.getActuation(const_cast<SimTK::State&>(sWorkingCopy), _parameters,forces);
 
     _forceReporter->step(sWorkingCopy, 1);
@@ -510,7 +559,43 @@ begin(SimTK::State& s )
 {
     if(!proceed()) return(0);
 
+    _frames.clear();
+    _statesSplineSet=GCVSplineSet(5,_statesStore);
+    prepareWorkingCopy(s);
+
+    // RECORD
+    int status = 0;
+    if(_activationStorage->getSize()<=0) {
+        status = record(s);
+        const Set<Actuator>& fs = _modelWorkingCopy->getActuators();
+        for(int k=0;k<fs.getSize();k++) {
+            ScalarActuator* act = dynamic_cast<ScalarActuator *>(&fs[k]);
+            if (act){
+                cout << "Bounds for " << act->getName() << ": "
+                    << act->getMinControl() << " to "
+                    << act->getMaxControl() << endl;
+            }
+            else{
+                std::string msg = getConcreteClassName();
+                msg += "::can only process scalar Actuator types.";
+                throw Exception(msg);
+            }
+        }
+    }
+
+    return(status);
+}
+//_____________________________________________________________________________
+/**
+ * Make the working copy of the model, the force set to optimize and the
+ * storage for the results, starting at the given state.
+ */
+void StaticOptimization::
+prepareWorkingCopy(const SimTK::State& s)
+{
     // Make a working copy of the model
+    _optimizer.reset();
+    _target.reset();
     delete _modelWorkingCopy;
     _modelWorkingCopy = _model->clone();
     _modelWorkingCopy->initSystem();
@@ -585,8 +670,6 @@ begin(SimTK::State& s )
         _parameters = 0;
     }
 
-    _statesSplineSet=GCVSplineSet(5,_statesStore);
-
     // DESCRIPTION AND LABELS
     constructDescription();
     constructColumnLabels();
@@ -597,28 +680,6 @@ begin(SimTK::State& s )
     // RESET STORAGE
     _activationStorage->reset(s.getTime());
     _forceReporter->updForceStorage().reset(s.getTime());
-
-    // RECORD
-    int status = 0;
-    if(_activationStorage->getSize()<=0) {
-        status = record(s);
-        const Set<Actuator>& fs = _modelWorkingCopy->getActuators();
-        for(int k=0;k<fs.getSize();k++) {
-            ScalarActuator* act = dynamic_cast<ScalarActuator *>(&fs[k]);
-            if (act){
-                cout << "Bounds for " << act->getName() << ": "
-                    << act->getMinControl() << " to "
-                    << act->getMaxControl() << endl;
-            }
-            else{
-                std::string msg = getConcreteClassName();
-                msg += "::can only process scalar Actuator types.";
-                throw Exception(msg);
-            }
-        }
-    }
-
-    return(status);
 }
 //_____________________________________________________________________________
 /**
@@ -639,7 +700,8 @@ step(const SimTK::State& s, int stepNumber )
 {
     if(!proceed(stepNumber)) return(0);
 
-    record(s);
+    if(_numThreads > 1 || ThreadPool::getDeterministic()) _frames.push_back(s);
+    else record(s);
 
     return(0);
 }
@@ -657,10 +719,63 @@ end( SimTK::State& s )
 {
     if(!proceed()) return(0);
 
-    record(s);
+    if(_numThreads > 1 || ThreadPool::getDeterministic()) {
+        _frames.push_back(s);
+        solveFramesInParallel();
+    }
+    else record(s);
 
     return(0);
 }
+//_____________________________________________________________________________
+/**
+ * Solve the kept frames by splitting them into contiguous chunks, one per
+ * thread (or as many as ThreadPool::getNumRanges() says in deterministic
+ * mode, whatever the number of threads). Each chunk is solved by its own copy
+ * of this analysis, with its own working copy of the model, and the results
+ * are appended in time order.
+ */
+void StaticOptimization::
+solveFramesInParallel()
+{
+    const int nFrames = (int)_frames.size();
+    const int nChunks = ThreadPool::getNumRanges(nFrames, _numThreads);
+
+    // The copies are prepared on this thread since initSystem() is not
+    // guaranteed to be thread-safe.
+    std::vector<std::unique_ptr<StaticOptimization>> chunks;
+    for(int c=0; c<nChunks; c++) {
+        const int first = int((long long)nFrames*c/nChunks);
+        chunks.emplace_back(new StaticOptimization(*this));
+        StaticOptimization& chunk = *chunks.back();
+        chunk.setModel(*_model);
+        chunk.setStatesStore(*_statesStore);
+        chunk._statesSplineSet = _statesSplineSet;
+        chunk.prepareWorkingCopy(_frames[first]);
+    }
+
+    try {
+        ThreadPool::parallelForRanges(nFrames, nChunks, _numThreads,
+            [&](int c, int first, int last) {
+                for(int i=first; i<last; i++) chunks[c]->record(_frames[i]);
+            });
+    }
+    catch (...) {
+        _frames.clear();
+        throw;
+    }
+    _frames.clear();
+
+    Storage& forceStorage = _forceReporter->updForceStorage();
+    for(const auto& chunk : chunks) {
+        const Storage& activations = *chunk->_activationStorage;
+        for(int i=0; i<activations.getSize(); i++)
+            _activationStorage->append(*activations.getStateVector(i));
+        const Storage& forces = chunk->_forceReporter->getForceStorage();
+        for(int i=0; i<forces.getSize(); i++)
+            forceStorage.append(*forces.getStateVector(i));
+    }
+}
 
 
 //=============================================================================
@@ -29,6 +29,7 @@
 //=============================================================================
 #include "osimAnalysesDLL.h"
 #include <memory>
+#include <vector>
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include "ForceReporter.h"
@@ -41,6 +42,7 @@ namespace OpenSim {
 
 class Model;
 class ForceSet;
+class StaticOptimizationTarget;
 
 /**
  * This class implements static optimization to compute Muscle Forces and 
@@ -76,6 +78,14 @@ protected:
     PropertyInt _maximumIterationsProp;
     int &_maximumIterations;
 
+    /** Number of threads used to solve the frames after the first. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
+    /** Solve frames with a quadratic cost directly as quadratic programs. */
+    PropertyBool _useQuadraticProgramProp;
+    bool &_useQuadraticProgram;
+
     Storage *_activationStorage;
     Storage *_forceStorage;
     GCVSplineSet _statesSplineSet;
@@ -93,6 +103,16 @@ protected:
 
     Model *_modelWorkingCopy;
 
+    // The optimization target and optimizer are created at the first frame
+    // and reused for the remaining frames, since the number of parameters
+    // and constraints does not change within a run.
+    std::unique_ptr<StaticOptimizationTarget> _target;
+    std::unique_ptr<SimTK::Optimizer> _optimizer;
+
+    // With more than one thread, the states of the frames after the first
+    // are kept until end() and solved together.
+    std::vector<SimTK::State> _frames;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -114,6 +134,8 @@ private:
     void constructColumnLabels();
     void allocateStorage();
     void deleteStorage();
+    void prepareWorkingCopy(const SimTK::State& s);
+    void solveFramesInParallel();
 
 public:
     //--------------------------------------------------------------------------
@@ -135,6 +157,18 @@ public:
     double getConvergenceCriterion() { return _convergenceCriterion; }
     void setMaxIterations( const int maxIt) { _maximumIterations = maxIt; }
     int getMaxIterations() {return _maximumIterations; }
+    /** %Set the number of threads used to solve the frames. With more than
+    one thread, the frames after the first are kept until end(), then split
+    into contiguous chunks, each solved on its own thread with its own copy
+    of the model and starting from the solution of the previous frame in the
+    chunk. The results are stored in time order. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+    /** %Set whether frames are solved directly as quadratic programs when
+    the activation exponent is 2 (the default). If false, every frame is
+    solved by the general optimizer. */
+    void setUseQuadraticProgram(bool useIt) { _useQuadraticProgram = useIt; }
+    bool getUseQuadraticProgram() const { return _useQuadraticProgram; }
     //--------------------------------------------------------------------------
     // ANALYSIS
     //--------------------------------------------------------------------------
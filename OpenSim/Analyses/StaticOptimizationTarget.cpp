@@ -30,7 +30,11 @@
 // INCLUDES
 //=============================================================================
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
 #include "StaticOptimizationTarget.h"
+#include <OpenSim/Common/OptimizationTarget.h>
+#include <OpenSim/Common/Logger.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -127,17 +131,75 @@ prepareToOptimize(SimTK::State& s, double *x)
     pVector = 0;
     computeConstraintVector(s, pVector,_constraintVector);
 
-    for(int p=0; p<np; p++) {
-        pVector[p] = 1;
-        computeConstraintVector(s, pVector, cVector);
-        for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
-        pVector[p] = 0;
+    // Without constraints on the motion, the accelerations caused by an
+    // actuator are M^-1 times its generalized forces. For muscles and
+    // coordinate actuators, whose generalized forces are known, these are
+    // computed directly instead of realizing the accelerations again.
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    bool constrained = false;
+    for(SimTK::ConstraintIndex cx(0); cx < matter.getNumConstraints(); ++cx)
+        if(!matter.getConstraint(cx).isDisabled(s)) constrained = true;
+
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces(matter.getNumBodies());
+    Vector mobilityForces(s.getNU()), generalizedForces(s.getNU());
+    Vector udot(s.getNU());
+    for(int i=0, p=0; i<fSet.getSize() && p<np; i++) {
+        const ScalarActuator* act =
+            dynamic_cast<const ScalarActuator*>(&fSet.get(i));
+        if(!act) continue;
+        const Muscle* mus = dynamic_cast<const Muscle*>(act);
+        const CoordinateActuator* coordAct =
+            dynamic_cast<const CoordinateActuator*>(act);
+        const Coordinate* coord = coordAct ? coordAct->getCoordinate() : NULL;
+
+        if(!constrained && (mus || coord)) {
+            bodyForces.setToZero();
+            mobilityForces.setToZero();
+            if(mus) {
+                mus->getGeometryPath().addInEquivalentForces(s,
+                    _optimalForce[p], bodyForces, mobilityForces);
+            } else {
+                matter.addInMobilityForce(s, coord->getBodyIndex(),
+                    SimTK::MobilizerUIndex(coord->getMobilizerQIndex()),
+                    _optimalForce[p], mobilityForces);
+            }
+            matter.multiplyBySystemJacobianTranspose(s, bodyForces,
+                                                     generalizedForces);
+            generalizedForces += mobilityForces;
+            matter.multiplyByMInv(s, generalizedForces, udot);
+            for(int c=0; c<nc; c++)
+                _constraintMatrix(c,p) = -udot[_accelerationIndices[c]];
+        } else {
+            pVector[p] = 1;
+            computeConstraintVector(s, pVector, cVector);
+            for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
+            pVector[p] = 0;
+        }
+        p++;
     }
 #endif
 
     // return false to indicate that we still need to proceed with optimization
     return false;
 }
+//______________________________________________________________________________
+/**
+ * Solve the problem as a quadratic program, starting from the bounds active at
+ * the previous solution.
+ */
+bool StaticOptimizationTarget::
+solveQuadraticProgram(const Vector& lowerBounds, const Vector& upperBounds,
+                      Vector& x)
+{
+#ifndef USE_LINEAR_CONSTRAINT_MATRIX
+    // The constraint matrix is not computed.
+    return false;
+#endif
+    return OptimizationTarget::SolveQuadraticProgram(
+            Vector(getNumParameters(), 1.0), _constraintMatrix,
+            _constraintVector, lowerBounds, upperBounds, _activeBounds, x);
+}
+
 //==============================================================================
 // SET AND GET
 //==============================================================================
@@ -314,9 +376,8 @@ printPerformance(const SimTK::State& s, double *parameters)
     objectiveFunc(SimTK::Vector(getNumParameters(),parameters,true),true,p);
     SimTK::Vector constraints(getNumConstraints());
     constraintFunc(SimTK::Vector(getNumParameters(),parameters,true),true,constraints);
-    cout << endl;
-    cout << "time = " << s.getTime() <<" Performance =" << p << 
-    " Constraint violation = " << sqrt(~constraints*constraints) << endl;
+    OPENSIM_INFO("\ntime = " << s.getTime() << " Performance =" << p <<
+        " Constraint violation = " << sqrt(~constraints*constraints));
 }
 
 //______________________________________________________________________________
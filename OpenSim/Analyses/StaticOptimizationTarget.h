@@ -68,6 +68,11 @@ private:
     const Storage *_statesStore;
     GCVSplineSet _statesSplineSet;
 
+    /** Bounds of the parameters active at the last solution of
+    solveQuadraticProgram(): -1 at the lower bound, 1 at the upper bound and 0
+    for free parameters. */
+    Array<int> _activeBounds;
+
 protected:
     double _activationExponent;
     bool   _useMusclePhysiology;
@@ -113,6 +118,18 @@ public:
 
     bool prepareToOptimize(SimTK::State& s, double *x);
 
+    /** Solve the problem as the quadratic program it is when the activation
+    exponent is 2: minimize the sum of the squared parameters subject to the
+    linear acceleration constraints and the bounds on the parameters. This
+    uses a primal-dual active set method, whose first guess of the active
+    bounds is the set active at the previous solution.
+    @return false, leaving x unchanged, if no solution satisfying the
+    optimality conditions was found, in which case the general optimizer
+    should be used */
+    bool solveQuadraticProgram(const SimTK::Vector& lowerBounds,
+                               const SimTK::Vector& upperBounds,
+                               SimTK::Vector& x);
+
     //--------------------------------------------------------------------------
     // REQUIRED OPTIMIZATION TARGET METHODS
     //--------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  benchMacro.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Macro benchmarks of whole simulations and tools on the models and data
+ * of the tests of the applications: a forward simulation of
+ * gait2354_simbody.osim, static optimization of arm26, and inverse
+ * kinematics and inverse dynamics of subject01's walk. The tools write their
+ * results next to their setup files, as they would when run by a user. */
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace OpenSim;
+
+namespace {
+
+void BM_ForwardGait2354(benchmark::State& state)
+{
+    Model model("gait2354_simbody.osim");
+    SimTK::State& initialState = model.initSystem();
+    model.equilibrateMuscles(initialState);
+    for (auto _ : state) {
+        SimTK::State s = initialState;
+        Manager manager(model);
+        manager.setWriteToStorage(false);
+        manager.setInitialTime(0);
+        manager.setFinalTime(0.05);
+        manager.integrate(s);
+    }
+}
+
+// Each run loads its model and data, as a user's run would.
+template <typename ToolType>
+void BM_Tool(benchmark::State& state, const std::string& setupFile)
+{
+    for (auto _ : state) {
+        ToolType tool(setupFile);
+        if (!tool.run()) {
+            state.SkipWithError(("Could not run " + setupFile).c_str());
+            break;
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_ForwardGait2354)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Tool<AnalyzeTool>, StaticOptimizationArm26,
+                  std::string("SO/arm26_Setup_StaticOptimization.xml"))
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Tool<InverseKinematicsTool>, InverseKinematicsSubject01,
+                  std::string("IK/subject01_Setup_InverseKinematics.xml"))
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Tool<InverseDynamicsTool>, InverseDynamicsSubject01,
+                  std::string("ID/subject01_Setup_InverseDynamics.xml"))
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,237 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  benchMicro.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Micro benchmarks of the computations that dominate simulations and tools:
+ * computing geometry paths with each type of wrap object, solving for muscle
+ * equilibrium, evaluating muscle curves, interpolating Storage and reading
+ * delimited files. */
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/PathSpring.h>
+#include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
+#include <OpenSim/Simulation/Wrap/WrapCylinder.h>
+#include <OpenSim/Simulation/Wrap/WrapCylinderObst.h>
+#include <OpenSim/Simulation/Wrap/WrapEllipsoid.h>
+#include <OpenSim/Simulation/Wrap/WrapSphere.h>
+#include <OpenSim/Simulation/Wrap/WrapSphereObst.h>
+#include <OpenSim/Simulation/Wrap/WrapTorus.h>
+#include <OpenSim/Actuators/ActiveForceLengthCurve.h>
+#include <OpenSim/Actuators/ForceVelocityCurve.h>
+#include <OpenSim/Actuators/Millard2012EquilibriumMuscle.h>
+#include <OpenSim/Actuators/Thelen2003Muscle.h>
+#include <OpenSim/Common/CSVFileAdapter.h>
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Common/Storage.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+
+using namespace OpenSim;
+using SimTK::Vec3;
+
+namespace {
+
+// A block that slides along y past a wrap object at the origin of ground,
+// with a path spring from ground to the block that wraps over the object.
+std::unique_ptr<Model> createWrapModel(WrapObject* wrap)
+{
+    std::unique_ptr<Model> model(new Model());
+    auto block = new Body("block", 1, Vec3(0), SimTK::Inertia(0.01));
+    model->addBody(block);
+    auto slider = new SliderJoint("slider", model->getGround(),
+        Vec3(0), Vec3(0, 0, SimTK::Pi/2), *block, Vec3(0),
+        Vec3(0, 0, SimTK::Pi/2));
+    model->addJoint(slider);
+
+    wrap->setName("wrap");
+    model->updGround().addWrapObject(wrap);
+
+    auto spring = new PathSpring("spring", 0.3, 10, 0.1);
+    spring->updGeometryPath().appendNewPathPoint("origin",
+        model->updGround(), Vec3(-0.2, 0, 0));
+    spring->updGeometryPath().appendNewPathPoint("insertion",
+        *block, Vec3(0.2, 0, 0));
+    model->addForce(spring);
+    spring->updGeometryPath().addPathWrap(*wrap);
+    return model;
+}
+
+WrapObject* createWrapObject(const std::string& type)
+{
+    if (type == "WrapCylinder") {
+        auto wrap = new WrapCylinder();
+        wrap->set_radius(0.05);
+        wrap->set_length(0.2);
+        return wrap;
+    }
+    // The other wrap objects still have deprecated properties.
+    WrapObject* wrap = dynamic_cast<WrapObject*>(
+            Object::newInstanceOfType(type));
+    PropertySet& properties = wrap->getPropertySet();
+    if (type == "WrapSphere" || type == "WrapSphereObst" ||
+            type == "WrapCylinderObst") {
+        properties.get("radius")->setValue(0.05);
+        if (properties.contains("length"))
+            properties.get("length")->setValue(0.2);
+    } else if (type == "WrapEllipsoid") {
+        const double dimensions[] = {0.05, 0.08, 0.1};
+        properties.get("dimensions")->setValue(3, dimensions);
+    } else if (type == "WrapTorus") {
+        properties.get("inner_radius")->setValue(0.03);
+        properties.get("outer_radius")->setValue(0.06);
+        // The path passes through the hole of the torus.
+        wrap->set_xyz_body_rotation(Vec3(0, SimTK::Pi/2, 0));
+    }
+    return wrap;
+}
+
+void BM_GeometryPath(benchmark::State& state, const std::string& type)
+{
+    std::unique_ptr<Model> model = createWrapModel(createWrapObject(type));
+    SimTK::State& s = model->initSystem();
+    const Coordinate& coord = model->getCoordinateSet()[0];
+    const GeometryPath& path =
+        model->getComponent<PathSpring>("spring").getGeometryPath();
+    int i = 0;
+    for (auto _ : state) {
+        // Each new position of the block invalidates the path.
+        coord.setValue(s, -0.1 + 0.01 * (i++ % 20), false);
+        benchmark::DoNotOptimize(path.getLength(s));
+    }
+}
+
+// A block, at the end of a muscle, that slides along x.
+template <typename MuscleType>
+void BM_MuscleEquilibrium(benchmark::State& state)
+{
+    Model model;
+    auto block = new Body("block", 1, Vec3(0), SimTK::Inertia(0.01));
+    model.addBody(block);
+    auto slider = new SliderJoint("slider", model.getGround(), *block);
+    slider->updCoordinate().setDefaultValue(0.3);
+    model.addJoint(slider);
+    auto muscle = new MuscleType("muscle", 1000, 0.1, 0.2, 0.0);
+    muscle->addNewPathPoint("origin", model.updGround(), Vec3(0));
+    muscle->addNewPathPoint("insertion", *block, Vec3(0));
+    model.addForce(muscle);
+    SimTK::State& s = model.initSystem();
+    int i = 0;
+    for (auto _ : state) {
+        muscle->setActivation(s, 0.05 + 0.05 * (i++ % 19));
+        model.equilibrateMuscles(s);
+    }
+}
+
+template <typename CurveType>
+void BM_MuscleCurve(benchmark::State& state)
+{
+    const CurveType curve;
+    double x = 0.5;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(curve.calcValue(x));
+        x = x < 1.5 ? x + 0.001 : 0.5;
+    }
+}
+
+Storage createStorage(int numRows, int numColumns)
+{
+    Storage storage(numRows);
+    Array<std::string> labels("time", numColumns + 1);
+    for (int c = 0; c < numColumns; ++c)
+        labels[c + 1] = "column" + std::to_string(c);
+    storage.setColumnLabels(labels);
+    for (int r = 0; r < numRows; ++r) {
+        SimTK::Vector row(numColumns);
+        for (int c = 0; c < numColumns; ++c) row[c] = std::sin(0.01 * r + c);
+        storage.append(StateVector(0.01 * r, row));
+    }
+    return storage;
+}
+
+void BM_StorageGetDataAtTime(benchmark::State& state)
+{
+    const int numRows = (int)state.range(0);
+    const int numColumns = 50;
+    const Storage storage = createStorage(numRows, numColumns);
+    const double lastTime = storage.getLastTime();
+    Array<double> values(0.0, numColumns);
+    double t = 0;
+    for (auto _ : state) {
+        storage.getDataAtTime(t, numColumns, values);
+        t = t + 0.0137 < lastTime ? t + 0.0137 : 0;
+    }
+}
+
+TimeSeriesTable createTable(int numRows, int numColumns)
+{
+    TimeSeriesTable table;
+    std::vector<std::string> labels;
+    for (int c = 0; c < numColumns; ++c)
+        labels.push_back("column" + std::to_string(c));
+    table.setColumnLabels(labels);
+    SimTK::RowVector row(numColumns);
+    for (int r = 0; r < numRows; ++r) {
+        for (int c = 0; c < numColumns; ++c) row[c] = std::sin(0.01 * r + c);
+        table.appendRow(0.01 * r, row);
+    }
+    return table;
+}
+
+void BM_STOFileAdapterRead(benchmark::State& state)
+{
+    const std::string fileName = "benchMicro_read.sto";
+    STOFileAdapter::write(createTable((int)state.range(0), 50), fileName);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(STOFileAdapter::read(fileName));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_CSVFileAdapterRead(benchmark::State& state)
+{
+    const std::string fileName = "benchMicro_read.csv";
+    CSVFileAdapter::write(createTable((int)state.range(0), 50), fileName);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(CSVFileAdapter::read(fileName));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_GeometryPath, WrapCylinder, std::string("WrapCylinder"));
+BENCHMARK_CAPTURE(BM_GeometryPath, WrapSphere, std::string("WrapSphere"));
+BENCHMARK_CAPTURE(BM_GeometryPath, WrapEllipsoid,
+                  std::string("WrapEllipsoid"));
+BENCHMARK_CAPTURE(BM_GeometryPath, WrapTorus, std::string("WrapTorus"));
+BENCHMARK_CAPTURE(BM_GeometryPath, WrapCylinderObst,
+                  std::string("WrapCylinderObst"));
+BENCHMARK_CAPTURE(BM_GeometryPath, WrapSphereObst,
+                  std::string("WrapSphereObst"));
+BENCHMARK_TEMPLATE(BM_MuscleEquilibrium, Millard2012EquilibriumMuscle);
+BENCHMARK_TEMPLATE(BM_MuscleEquilibrium, Thelen2003Muscle);
+BENCHMARK_TEMPLATE(BM_MuscleCurve, ActiveForceLengthCurve);
+BENCHMARK_TEMPLATE(BM_MuscleCurve, ForceVelocityCurve);
+BENCHMARK(BM_StorageGetDataAtTime)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_STOFileAdapterRead)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CSVFileAdapterRead)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -74,6 +74,7 @@ namespace OpenSim {
     AbstractDataTable::setDependentsMetaData(const DependentsMetaData& 
                                              dependentsMetaData) {
         _dependentsMetaData = dependentsMetaData;
+        updateColumnIndex();
         validateDependentsMetaData();
     }
 
@@ -147,6 +148,7 @@ namespace OpenSim {
 
         _dependentsMetaData.removeValueArrayForKey("labels");
         _dependentsMetaData.setValueArrayForKey("labels", newLabels);
+        updateColumnIndex();
 
         validateDependentsMetaData();
     }
@@ -156,13 +158,10 @@ namespace OpenSim {
         OPENSIM_THROW_IF(!hasColumnLabels(),
                          NoColumnLabels);
 
-        const auto& absArray = 
-            _dependentsMetaData.getValueArrayForKey("labels");
-        for(size_t i = 0; i < absArray.size(); ++i)
-            if(absArray[i].getValue<std::string>() == columnLabel)
-                return i;
-        
-        OPENSIM_THROW(KeyNotFound, columnLabel);
+        const auto iter = _columnIndex.find(columnLabel);
+        OPENSIM_THROW_IF(iter == _columnIndex.end(),
+                         KeyNotFound, columnLabel);
+        return iter->second;
     }
 
     bool 
@@ -170,13 +169,21 @@ namespace OpenSim {
         OPENSIM_THROW_IF(!hasColumnLabels(),
                          NoColumnLabels);
 
+        return _columnIndex.count(columnLabel) > 0;
+    }
+
+    void
+    AbstractDataTable::updateColumnIndex() {
+        _columnIndex.clear();
+        if(!hasColumnLabels())
+            return;
+
         const auto& absArray = 
             _dependentsMetaData.getValueArrayForKey("labels");
+        _columnIndex.reserve(absArray.size());
+        // emplace() keeps the first column with a label.
         for(size_t i = 0; i < absArray.size(); ++i)
-            if(absArray[i].getValue<std::string>() == columnLabel)
-                return true;
-
-        return false;
+            _columnIndex.emplace(absArray[i].getValue<std::string>(), i);
     }
 
     bool 
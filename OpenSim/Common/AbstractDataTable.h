@@ -33,6 +33,7 @@ provide an in-memory container for data access and manipulation.              */
 #include "OpenSim/Common/ValueArrayDictionary.h"
 
 #include <ostream>
+#include <unordered_map>
 
 namespace OpenSim {
 
@@ -368,6 +369,7 @@ public:
             labels.upd().push_back(SimTK::Value<std::string>(*it));
         _dependentsMetaData.removeValueArrayForKey("labels");
         _dependentsMetaData.setValueArrayForKey("labels", labels);
+        updateColumnIndex();
 
         validateDependentsMetaData();
     }
@@ -415,7 +417,9 @@ public:
     void setColumnLabel(const size_t columnIndex,
                         const std::string& columnLabel);
 
-    /** Get index of a column label.                                          
+    /** Get index of a column label. If several columns have the label, the
+    index of the first. Labels are looked up in an index that is kept up to
+    date with the labels, so this takes constant time.
 
     \throw NoColumnLabels If table has no column labels.
     \throw KeyNotFound If columnLabel is not found to be label for any column.*/
@@ -446,9 +450,20 @@ protected:
     classes.                                                                  */
     virtual void validateDependentsMetaData() const  = 0;
 
+    /** Rebuild the index of column labels from the "labels" of the dependents
+    metadata. Call it after changing the labels directly in
+    _dependentsMetaData.                                                      */
+    void updateColumnIndex();
+
     TableMetaData       _tableMetaData;
     DependentsMetaData  _dependentsMetaData;
     IndependentMetaData _independentMetaData;
+
+private:
+    // Index of the first column with each label, for getColumnIndex() and
+    // hasColumn() (which tables with hundreds of columns, e.g., of EMG or
+    // markers, call for every column).
+    std::unordered_map<std::string, size_t> _columnIndex;
 }; // AbstractDataTable
 
 } // namespace OpenSim
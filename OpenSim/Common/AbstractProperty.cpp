@@ -25,6 +25,7 @@
 //============================================================================
 #include "AbstractProperty.h"
 #include "Object.h"
+#include "XMLWriter.h"
 
 #include <limits>
 
@@ -231,3 +232,26 @@ void AbstractProperty::writeToXMLParentElement(Xml::Element& parent) const {
     obj.updateXMLNode(parent);
 }
 
+// Writes exactly what writeToXMLParentElement() appends.
+void AbstractProperty::writeToXMLStream(XMLWriter& writer) const {
+    if (!getComment().empty())
+        writer.writeComment(getComment());
+
+    if (!isOneObjectProperty()) {
+        assert(!getName().empty());
+        writeElementToXMLStream(writer);
+        return;
+    }
+
+    // KLUDGE: as in writeToXMLParentElement().
+    const Object& obj = getValueAsObject();
+    (const_cast<Object&>(obj)).setName(isUnnamedProperty() ? "" : getName());
+    obj.writeToXMLStream(writer);
+}
+
+void AbstractProperty::writeElementToXMLStream(XMLWriter& writer) const {
+    Xml::Element propElement(getName());
+    writeToXMLElement(propElement);
+    writer.writeElement(propElement);
+}
+
@@ -34,6 +34,7 @@
 namespace OpenSim {
 
 class Object;
+class XMLWriter;
 template <class T> class Property;
 
 //==============================================================================
@@ -215,6 +216,11 @@ public:
     the serialized form of this property. **/
     void writeToXMLParentElement(SimTK::Xml::Element& parent) const;
 
+    /** Write the serialized form of this property, as
+    writeToXMLParentElement() would append it to the element being written,
+    directly to the given XMLWriter. **/
+    void writeToXMLStream(XMLWriter& writer) const;
+
 
     /** %Set the property name. **/
     void setName(const std::string& name){ _name = name; }
@@ -332,12 +338,24 @@ protected:
     virtual void writeToXMLElement
        (SimTK::Xml::Element& propertyElement) const = 0;
 
+    /** Write the property element that writeToXMLElement() fills, tag and
+    all, to the given XMLWriter. By default the element is built as a
+    SimTK::Xml::Element first; simple and object properties write it
+    directly. **/
+    virtual void writeElementToXMLStream(XMLWriter& writer) const;
+
 
     /** How may values are currently stored in this property? If this is an
     object property you can use this with getValueAsObject() to iterate over
     the contained objects. **/
     virtual int getNumValues() const = 0;
 
+    /** Estimate the heap memory, in bytes, held by the values of this
+    property if they are of simple type; the objects of an object property
+    are not counted. Values shared with copies of the property are divided
+    among them. **/
+    virtual size_t estimateValueMemory() const { return 0; }
+
     /** If the concrete property allows it, clear the value list. **/
     virtual void clearValues() = 0;
 
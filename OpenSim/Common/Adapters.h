@@ -26,9 +26,16 @@
 #include "DelimFileAdapter.h"
 #include "STOFileAdapter.h"
 #include "CSVFileAdapter.h"
+#include "BinaryFileAdapter.h"
 
 #ifdef WITH_BTK
 
 #include "C3DFileAdapter.h"
 
 #endif
+
+#ifdef WITH_ARROW
+
+#include "ArrowFileAdapter.h"
+
+#endif
@@ -0,0 +1,240 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  ArrowFileAdapter.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_ARROW
+
+#include "ArrowFileAdapter.h"
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
+namespace OpenSim {
+
+namespace {
+
+void checkStatus(const arrow::Status& status, const std::string& fileName) {
+    OPENSIM_THROW_IF(!status.ok(),
+                     IOError,
+                     "Error accessing Arrow file '" + fileName + "': " +
+                     status.ToString());
+}
+
+template<typename T>
+T valueOrThrow(arrow::Result<T> result, const std::string& fileName) {
+    checkStatus(result.status(), fileName);
+    return std::move(result).ValueOrDie();
+}
+
+// The values of a field of a record batch as doubles. A field of doubles
+// without nulls is used in place; other fields are converted into 'buffer'.
+const double* getValues(const arrow::Field& field,
+                        const arrow::Array& array,
+                        std::vector<double>& buffer) {
+    const auto numRows = array.length();
+    if(array.type_id() == arrow::Type::DOUBLE) {
+        const auto& doubles = static_cast<const arrow::DoubleArray&>(array);
+        if(doubles.null_count() == 0)
+            return doubles.raw_values();
+        buffer.assign(doubles.raw_values(), doubles.raw_values() + numRows);
+    } else if(array.type_id() == arrow::Type::FLOAT) {
+        const auto& floats = static_cast<const arrow::FloatArray&>(array);
+        buffer.assign(floats.raw_values(), floats.raw_values() + numRows);
+    } else {
+        OPENSIM_THROW(IncorrectTableType,
+                      "Expected field '" + field.name() + "' to hold "
+                      "floating point values, but it holds " +
+                      array.type()->ToString() + ".");
+    }
+    for(int64_t r = 0; r < numRows; ++r)
+        if(array.IsNull(r))
+            buffer[r] = SimTK::NaN;
+    return buffer.data();
+}
+
+// Make a table of the rows of the given record batches, which all have the
+// given schema.
+TimeSeriesTable makeTable(const arrow::Schema& schema,
+                    const std::vector<const arrow::RecordBatch*>& batches) {
+    const int numFields = schema.num_fields();
+    OPENSIM_THROW_IF(numFields == 0,
+                     IncorrectTableType,
+                     "Expected a time field, but the record batch has no "
+                     "fields.");
+
+    TimeSeriesTable table{};
+    std::vector<std::string> labels{};
+    for(int f = 1; f < numFields; ++f)
+        labels.push_back(schema.field(f)->name());
+    table.setColumnLabels(labels);
+    if(const auto& metadata = schema.metadata())
+        for(int64_t i = 0; i < metadata->size(); ++i)
+            table.addTableMetaData(metadata->key(i), metadata->value(i));
+
+    int64_t numRows = 0;
+    for(const auto* batch : batches)
+        numRows += batch->num_rows();
+    table.reserve(static_cast<size_t>(numRows));
+
+    std::vector<std::vector<double>> buffers(numFields);
+    std::vector<const double*> values(numFields);
+    SimTK::RowVector row(numFields - 1);
+    for(const auto* batch : batches) {
+        for(int f = 0; f < numFields; ++f)
+            values[f] = getValues(*schema.field(f), *batch->column(f),
+                                  buffers[f]);
+        for(int64_t r = 0; r < batch->num_rows(); ++r) {
+            for(int c = 1; c < numFields; ++c)
+                row[c - 1] = values[c][r];
+            table.appendRow(values[0][r], row);
+        }
+    }
+    return table;
+}
+
+} // anonymous namespace
+
+ArrowFileAdapter*
+ArrowFileAdapter::clone() const {
+    return new ArrowFileAdapter{*this};
+}
+
+const std::string
+ArrowFileAdapter::tableString() {
+    return "table";
+}
+
+std::shared_ptr<arrow::RecordBatch>
+ArrowFileAdapter::toRecordBatch(const TimeSeriesTable& table) {
+    const auto numRows = static_cast<int64_t>(table.getNumRows());
+    const auto& labels = table.getColumnLabels();
+
+    // Only metadata values that are strings are kept.
+    std::vector<std::string> keys{}, values{};
+    for(const auto& key : table.getTableMetaDataKeys()) {
+        try {
+            values.push_back(table.getTableMetaData<std::string>(key));
+            keys.push_back(key);
+        } catch(const InvalidTemplateArgument&) {}
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> fields{};
+    std::vector<std::shared_ptr<arrow::Array>> arrays{};
+    fields.push_back(arrow::field("time", arrow::float64()));
+    for(const auto& label : labels)
+        fields.push_back(arrow::field(label, arrow::float64()));
+
+    // Each column is appended into a buffer of the final size.
+    const auto finish = [&](arrow::DoubleBuilder& builder) {
+        std::shared_ptr<arrow::Array> array{};
+        checkStatus(builder.Finish(&array), "<record batch>");
+        arrays.push_back(std::move(array));
+    };
+    arrow::DoubleBuilder builder{};
+    checkStatus(builder.AppendValues(table.getIndependentColumn()),
+                "<record batch>");
+    finish(builder);
+    const auto matrix = table.getMatrix();
+    for(int c = 0; c < static_cast<int>(labels.size()); ++c) {
+        checkStatus(builder.Reserve(numRows), "<record batch>");
+        for(int r = 0; r < static_cast<int>(numRows); ++r)
+            builder.UnsafeAppend(matrix.getElt(r, c));
+        finish(builder);
+    }
+
+    return arrow::RecordBatch::Make(
+        arrow::schema(fields, arrow::key_value_metadata(keys, values)),
+        numRows, arrays);
+}
+
+TimeSeriesTable
+ArrowFileAdapter::fromRecordBatch(const arrow::RecordBatch& batch) {
+    return makeTable(*batch.schema(), {&batch});
+}
+
+TimeSeriesTable
+ArrowFileAdapter::read(const std::string& fileName) {
+    auto file = valueOrThrow(arrow::io::ReadableFile::Open(fileName),
+                             fileName);
+    auto reader = valueOrThrow(
+        arrow::ipc::RecordBatchFileReader::Open(file), fileName);
+
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches{};
+    std::vector<const arrow::RecordBatch*> batchPointers{};
+    for(int i = 0; i < reader->num_record_batches(); ++i) {
+        batches.push_back(valueOrThrow(reader->ReadRecordBatch(i), fileName));
+        batchPointers.push_back(batches.back().get());
+    }
+    return makeTable(*reader->schema(), batchPointers);
+}
+
+void
+ArrowFileAdapter::write(const TimeSeriesTable& table,
+                        const std::string& fileName) {
+    const auto batch = toRecordBatch(table);
+    auto sink = valueOrThrow(arrow::io::FileOutputStream::Open(fileName),
+                             fileName);
+    auto writer = valueOrThrow(
+        arrow::ipc::MakeFileWriter(sink, batch->schema()), fileName);
+    checkStatus(writer->WriteRecordBatch(*batch), fileName);
+    checkStatus(writer->Close(), fileName);
+    checkStatus(sink->Close(), fileName);
+}
+
+ArrowFileAdapter::OutputTables
+ArrowFileAdapter::extendRead(const std::string& fileName) const {
+    OutputTables output_tables{};
+    output_tables.emplace(tableString(),
+                          std::make_shared<TimeSeriesTable>(read(fileName)));
+    return output_tables;
+}
+
+void
+ArrowFileAdapter::extendWrite(const InputTables& absTables,
+                              const std::string& fileName) const {
+    OPENSIM_THROW_IF(absTables.empty(),
+                     NoTableFound);
+    OPENSIM_THROW_IF(fileName.empty(),
+                     EmptyFileName);
+
+    const AbstractDataTable* absTable{};
+    try {
+        absTable = absTables.at(tableString());
+    } catch(std::out_of_range&) {
+        OPENSIM_THROW(KeyMissing,
+                      tableString());
+    }
+
+    const auto* table = dynamic_cast<const TimeSeriesTable*>(absTable);
+    OPENSIM_THROW_IF(!table,
+                     IncorrectTableType,
+                     "ArrowFileAdapter supports TimeSeriesTable_ with "
+                     "elements of type double; flatten tables of other "
+                     "elements first.");
+    write(*table, fileName);
+}
+
+} // namespace OpenSim
+
+#endif // WITH_ARROW
@@ -0,0 +1,115 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ArrowFileAdapter.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef OPENSIM_ARROW_FILE_ADAPTER_H_
+#define OPENSIM_ARROW_FILE_ADAPTER_H_
+
+#ifdef WITH_ARROW
+
+#include "FileAdapter.h"
+#include "TimeSeriesTable.h"
+
+#include <memory>
+
+namespace arrow {
+class RecordBatch;
+}
+
+namespace OpenSim {
+
+/** ArrowFileAdapter is a FileAdapter that reads and writes TimeSeriesTable
+objects as Apache Arrow record batches, in Arrow IPC files (extension ".arrow",
+or ".feather" for Feather version 2, which is the same format). Such files are
+read directly by pandas, Polars, Spark and other tools that speak Arrow, with
+no text to parse.
+
+A table maps to a record batch whose first field is the time column, named
+"time", followed by one field of 64-bit floats per column of the table, named
+with its column label. The string-valued table metadata are stored in the
+metadata of the schema. A record batch read from elsewhere may have any name
+for its first field, which must hold increasing floating-point times; its
+other fields must hold 64-bit floats (null entries are read as NaN), and all
+the metadata of its schema is read as string-valued table metadata. A file
+with several record batches is read as one table, the rows of each batch
+after those of the previous one.
+
+Tables of Vec3 and other elements can be written once flattened
+(TimeSeriesTable_::flatten()), and the table of a StatesTrajectory once
+exported (StatesTrajectory::exportToTable()).
+
+Available only when OpenSim is built with Arrow (WITH_ARROW).               */
+class OSIMCOMMON_API ArrowFileAdapter : public FileAdapter {
+public:
+    ArrowFileAdapter()                                   = default;
+    ArrowFileAdapter(const ArrowFileAdapter&)            = default;
+    ArrowFileAdapter(ArrowFileAdapter&&)                 = default;
+    ArrowFileAdapter& operator=(const ArrowFileAdapter&) = default;
+    ArrowFileAdapter& operator=(ArrowFileAdapter&&)      = default;
+    ~ArrowFileAdapter()                                  = default;
+
+    ArrowFileAdapter* clone() const override;
+
+    /** Read a table from the given Arrow IPC (or Feather version 2) file.
+
+    \throws IOError If the file cannot be read as an Arrow IPC file.
+    \throws IncorrectTableType If a field of the file does not hold floating
+                               point values.                                 */
+    static
+    TimeSeriesTable read(const std::string& fileName);
+
+    /** Write a table to the given file in the Arrow IPC file format.
+
+    \throws IOError If the file cannot be written.                          */
+    static
+    void write(const TimeSeriesTable& table, const std::string& fileName);
+
+    /** Make a record batch holding the time column, the columns and the
+    string-valued metadata of the given table.                               */
+    static
+    std::shared_ptr<arrow::RecordBatch>
+    toRecordBatch(const TimeSeriesTable& table);
+
+    /** Make a table from a record batch, as read().
+
+    \throws IncorrectTableType If a field of the batch does not hold floating
+                               point values.                                 */
+    static
+    TimeSeriesTable fromRecordBatch(const arrow::RecordBatch& batch);
+
+    /** Key used for table associative array returned/accepted by write/read. */
+    static const std::string tableString();
+
+protected:
+    /** Implementation of the read functionality.                             */
+    OutputTables extendRead(const std::string& fileName) const override;
+
+    /** Implementation of the write functionality.                            */
+    void extendWrite(const InputTables& tables,
+                     const std::string& fileName) const override;
+};
+
+} // namespace OpenSim
+
+#endif // WITH_ARROW
+
+#endif // OPENSIM_ARROW_FILE_ADAPTER_H_
@@ -0,0 +1,101 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  BackgroundFileWriter.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "BackgroundFileWriter.h"
+#include "Exception.h"
+
+#include <algorithm>
+
+using namespace OpenSim;
+
+BackgroundFileWriter::BackgroundFileWriter(const std::string& fileName,
+                                           int maxPendingChunks) :
+    _fileName(fileName), _maxPendingChunks(std::max(maxPendingChunks, 1)),
+    _stream(fileName), _done(false)
+{
+    OPENSIM_THROW_IF(!_stream, Exception,
+        "BackgroundFileWriter: could not open file '" + fileName + "'.");
+    _thread = std::thread(&BackgroundFileWriter::run, this);
+}
+
+BackgroundFileWriter::~BackgroundFileWriter()
+{
+    stop();
+}
+
+void BackgroundFileWriter::write(Chunk chunk)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _notFull.wait(lock, [this]
+        { return (int)_chunks.size() < _maxPendingChunks || _error; });
+    if (_error) std::rethrow_exception(_error);
+    OPENSIM_THROW_IF(_done, Exception,
+        "BackgroundFileWriter: file '" + _fileName + "' is already closed.");
+    _chunks.push_back(std::move(chunk));
+    _notEmpty.notify_one();
+}
+
+void BackgroundFileWriter::close()
+{
+    stop();
+    if (_error) std::rethrow_exception(_error);
+}
+
+void BackgroundFileWriter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _notEmpty.notify_one();
+    }
+    if (_thread.joinable()) _thread.join();
+    if (_stream.is_open()) _stream.close();
+}
+
+void BackgroundFileWriter::run()
+{
+    while (true) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return !_chunks.empty() || _done; });
+        if (_chunks.empty()) break;
+        // Write the chunk at the front of the queue in place, so that the
+        // producer waits only for a free slot.
+        lock.unlock();
+        try {
+            _chunks.front()(_stream);
+            _stream.flush();
+            OPENSIM_THROW_IF(!_stream, Exception,
+                "BackgroundFileWriter: could not write to file '" +
+                _fileName + "'.");
+        }
+        catch (...) {
+            lock.lock();
+            _error = std::current_exception();
+            _chunks.clear();
+            _notFull.notify_one();
+            return;
+        }
+        lock.lock();
+        _chunks.pop_front();
+        _notFull.notify_one();
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef OPENSIM_BACKGROUND_FILE_WRITER_H_
+#define OPENSIM_BACKGROUND_FILE_WRITER_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  BackgroundFileWriter.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace OpenSim {
+
+/** Writes a file in chunks on a thread of its own, so that producing the
+data (e.g., a simulation) overlaps with formatting and writing it. A chunk is
+a function that writes to the file; the functions are called on the writer
+thread in the order they were given to write().
+
+At most a given number of chunks wait to be written. write() waits when that
+many are pending, so that the memory used stays bounded when the data is
+produced faster than it can be written.
+
+An error while writing stops the writer; it is rethrown by the next call to
+write() or by close().                                                       */
+class OSIMCOMMON_API BackgroundFileWriter {
+public:
+    typedef std::function<void(std::ostream&)> Chunk;
+
+    /** Create (or truncate) the given file and start the writer thread.
+    \throws Exception If the file cannot be opened.                          */
+    explicit BackgroundFileWriter(const std::string& fileName,
+                                  int maxPendingChunks = 2);
+
+    BackgroundFileWriter(const BackgroundFileWriter&) = delete;
+    BackgroundFileWriter& operator=(const BackgroundFileWriter&) = delete;
+
+    /** Write the pending chunks and close the file. Errors are ignored; call
+    close() to be notified of them.                                          */
+    ~BackgroundFileWriter();
+
+    /** Queue a chunk to be written, waiting while the queue is full.        */
+    void write(Chunk chunk);
+
+    /** Wait for the pending chunks to be written and close the file. No
+    chunks may be written afterwards.                                        */
+    void close();
+
+    const std::string& getFileName() const { return _fileName; }
+
+private:
+    void stop();
+    void run();
+
+    const std::string _fileName;
+    const int _maxPendingChunks;
+    std::ofstream _stream;
+    std::deque<Chunk> _chunks;
+    bool _done;
+    std::exception_ptr _error;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::thread _thread;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_BACKGROUND_FILE_WRITER_H_
@@ -0,0 +1,441 @@
+#include "BinaryFileAdapter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace OpenSim {
+
+namespace {
+
+// Layout of a file (all integers are unsigned 64-bit and all strings are
+// stored as their length followed by their characters):
+//   magic, version, byte order mark, data type, number of components per
+//   element, number of rows, number of columns, number of metadata pairs,
+//   metadata (key, value) pairs, column labels, time column (doubles), then
+//   each column of data as numRows * numComponents doubles (floats for tables
+//   of floats).
+const char          magic[8]{'O', 'S', 'I', 'M', 'O', 'T', 'B', '\0'};
+const std::uint64_t version{1};
+const std::uint64_t byteOrderMark{0x0102030405060708ull};
+
+struct BinaryHeader {
+    std::string   dataType{};
+    std::uint64_t numComponents{};
+    std::uint64_t numRows{};
+    std::uint64_t numColumns{};
+    std::vector<std::pair<std::string, std::string>> metadata{};
+    std::vector<std::string> labels{};
+    // Offset of the time column from the beginning of the file.
+    std::streamoff dataOffset{};
+};
+
+// Following specializations describe how each supported element type maps to
+// its components, which are stored as Scalars.
+template<typename T>
+struct Element;
+
+template<>
+struct Element<double> {
+    typedef double Scalar;
+    static const char* name() { return "double"; }
+    static const unsigned size{1};
+    static double get(const double& elem, unsigned) { return elem; }
+    static double make(const double* comps) { return comps[0]; }
+};
+
+template<>
+struct Element<float> {
+    typedef float Scalar;
+    static const char* name() { return "float"; }
+    static const unsigned size{1};
+    static float get(const float& elem, unsigned) { return elem; }
+    static float make(const float* comps) { return comps[0]; }
+};
+
+template<>
+struct Element<SimTK::Vec3> {
+    typedef double Scalar;
+    static const char* name() { return "Vec3"; }
+    static const unsigned size{3};
+    static double get(const SimTK::Vec3& elem, unsigned k) { return elem[k]; }
+    static SimTK::Vec3 make(const double* comps) {
+        return SimTK::Vec3{comps[0], comps[1], comps[2]};
+    }
+};
+
+template<>
+struct Element<SimTK::Quaternion> {
+    typedef double Scalar;
+    static const char* name() { return "Quaternion"; }
+    static const unsigned size{4};
+    static double get(const SimTK::Quaternion& elem, unsigned k) {
+        return elem[k];
+    }
+    static SimTK::Quaternion make(const double* comps) {
+        // The values were written from a Quaternion. Do not renormalize them.
+        return SimTK::Quaternion(SimTK::Vec4{comps[0], comps[1],
+                                             comps[2], comps[3]},
+                                 true);
+    }
+};
+
+template<>
+struct Element<SimTK::SpatialVec> {
+    typedef double Scalar;
+    static const char* name() { return "SpatialVec"; }
+    static const unsigned size{6};
+    static double get(const SimTK::SpatialVec& elem, unsigned k) {
+        return elem[k / 3][k % 3];
+    }
+    static SimTK::SpatialVec make(const double* comps) {
+        return SimTK::SpatialVec{{comps[0], comps[1], comps[2]},
+                                 {comps[3], comps[4], comps[5]}};
+    }
+};
+
+void writeUInt(std::ostream& stream, std::uint64_t value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ostream& stream, const std::string& str) {
+    writeUInt(stream, str.size());
+    stream.write(str.data(), str.size());
+}
+
+template<typename Scalar>
+void writeValues(std::ostream& stream, const std::vector<Scalar>& values) {
+    stream.write(reinterpret_cast<const char*>(values.data()),
+                 values.size() * sizeof(Scalar));
+}
+
+void readBytes(std::istream& stream, char* buffer, std::size_t count,
+               const std::string& fileName) {
+    stream.read(buffer, count);
+    OPENSIM_THROW_IF(static_cast<std::size_t>(stream.gcount()) != count,
+                     NotABinaryTableFile,
+                     fileName,
+                     "Unexpected end of file.");
+}
+
+std::uint64_t readUInt(std::istream& stream, const std::string& fileName) {
+    std::uint64_t value{};
+    readBytes(stream, reinterpret_cast<char*>(&value), sizeof(value),
+              fileName);
+    return value;
+}
+
+std::string readString(std::istream& stream, const std::string& fileName) {
+    std::string str(readUInt(stream, fileName), '\0');
+    if(!str.empty())
+        readBytes(stream, &str[0], str.size(), fileName);
+    return str;
+}
+
+template<typename Scalar>
+void readValues(std::istream& stream, Scalar* values, std::size_t count,
+                const std::string& fileName) {
+    readBytes(stream, reinterpret_cast<char*>(values), count * sizeof(Scalar),
+              fileName);
+}
+
+// Size of the stored components of the elements of the given data type.
+std::size_t componentSize(const std::string& dataType) {
+    return dataType == Element<float>::name() ? sizeof(float) : sizeof(double);
+}
+
+void openForReading(std::ifstream& stream, const std::string& fileName) {
+    OPENSIM_THROW_IF(fileName.empty(),
+                     EmptyFileName);
+
+    stream.open(fileName, std::ios_base::binary);
+    OPENSIM_THROW_IF(!stream.good(),
+                     FileDoesNotExist,
+                     fileName);
+}
+
+BinaryHeader readHeader(std::istream& stream, const std::string& fileName) {
+    char fileMagic[sizeof(magic)]{};
+    readBytes(stream, fileMagic, sizeof(fileMagic), fileName);
+    OPENSIM_THROW_IF(std::memcmp(fileMagic, magic, sizeof(magic)) != 0,
+                     NotABinaryTableFile,
+                     fileName,
+                     "File does not start with the expected identifier.");
+    const auto fileVersion = readUInt(stream, fileName);
+    OPENSIM_THROW_IF(fileVersion != version,
+                     NotABinaryTableFile,
+                     fileName,
+                     "Unsupported version " + std::to_string(fileVersion) +
+                     ".");
+    OPENSIM_THROW_IF(readUInt(stream, fileName) != byteOrderMark,
+                     NotABinaryTableFile,
+                     fileName,
+                     "File was written on a machine with a different byte "
+                     "order.");
+
+    BinaryHeader header{};
+    header.dataType      = readString(stream, fileName);
+    header.numComponents = readUInt(stream, fileName);
+    header.numRows       = readUInt(stream, fileName);
+    header.numColumns    = readUInt(stream, fileName);
+    const auto numMetadata = readUInt(stream, fileName);
+    for(std::uint64_t i = 0; i < numMetadata; ++i) {
+        auto key = readString(stream, fileName);
+        auto value = readString(stream, fileName);
+        header.metadata.emplace_back(std::move(key), std::move(value));
+    }
+    for(std::uint64_t i = 0; i < header.numColumns; ++i)
+        header.labels.push_back(readString(stream, fileName));
+    header.dataOffset = stream.tellg();
+
+    return header;
+}
+
+template<typename T>
+void writeTable(const TimeSeriesTable_<T>& table,
+                const std::string& fileName) {
+    std::ofstream stream{fileName, std::ios_base::binary};
+    OPENSIM_THROW_IF(!stream.good(),
+                     IOError,
+                     "Could not open file '" + fileName + "' for writing.");
+
+    const auto numRows = table.getNumRows();
+    const auto numColumns = table.getNumColumns();
+
+    stream.write(magic, sizeof(magic));
+    writeUInt(stream, version);
+    writeUInt(stream, byteOrderMark);
+    writeString(stream, Element<T>::name());
+    writeUInt(stream, Element<T>::size);
+    writeUInt(stream, numRows);
+    writeUInt(stream, numColumns);
+
+    // Only metadata values that are strings are written. The values of a
+    // table of floats are marked as rounded to single precision.
+    std::vector<std::pair<std::string, std::string>> metadata{};
+    for(const auto& key : table.getTableMetaDataKeys()) {
+        try {
+            metadata.emplace_back(key,
+                                  table.template
+                                  getTableMetaData<std::string>(key));
+        } catch(const InvalidTemplateArgument&) {}
+    }
+    if(std::is_same<T, float>::value &&
+            !table.hasTableMetaDataKey(getPrecisionMetaDataKey()))
+        metadata.emplace_back(getPrecisionMetaDataKey(), "single");
+    writeUInt(stream, metadata.size());
+    for(const auto& keyValue : metadata) {
+        writeString(stream, keyValue.first);
+        writeString(stream, keyValue.second);
+    }
+    for(const auto& label : table.getColumnLabels())
+        writeString(stream, label);
+
+    writeValues(stream, table.getIndependentColumn());
+
+    const auto& matrix = table.getMatrix();
+    std::vector<typename Element<T>::Scalar> column(numRows * Element<T>::size);
+    for(size_t c = 0; c < numColumns; ++c) {
+        auto value = column.begin();
+        for(size_t r = 0; r < numRows; ++r) {
+            const T& elem = matrix(static_cast<int>(r), static_cast<int>(c));
+            for(unsigned k = 0; k < Element<T>::size; ++k)
+                *value++ = Element<T>::get(elem, k);
+        }
+        writeValues(stream, column);
+    }
+
+    OPENSIM_THROW_IF(!stream.good(),
+                     IOError,
+                     "Error writing file '" + fileName + "'.");
+}
+
+template<typename T>
+std::shared_ptr<AbstractDataTable>
+readTable(std::istream& stream,
+          const BinaryHeader& header,
+          const std::string& fileName,
+          const ColumnSelection& selection,
+          double startTime,
+          double endTime) {
+    OPENSIM_THROW_IF(header.numComponents != Element<T>::size,
+                     NotABinaryTableFile,
+                     fileName,
+                     "Unexpected number of components per element.");
+
+    // Indices of the columns to read.
+    const auto columns = selection.findColumns(header.labels);
+
+    const size_t numRows = header.numRows;
+    const size_t numComps = Element<T>::size;
+    const size_t columnSize = numRows * numComps;
+
+    std::vector<double> time(numRows);
+    stream.seekg(header.dataOffset);
+    readValues(stream, time.data(), numRows, fileName);
+
+    // The time column is the index of the rows: find the rows in the time
+    // range, [firstRow, firstRow + numRowsRead).
+    const size_t firstRow = static_cast<size_t>(
+        std::lower_bound(time.begin(), time.end(), startTime) - time.begin());
+    const size_t endRow = static_cast<size_t>(
+        std::upper_bound(time.begin(), time.end(), endTime) - time.begin());
+    const size_t numRowsRead = endRow > firstRow ? endRow - firstRow : 0;
+    const size_t blockSize = numRowsRead * numComps;
+
+    // Seek straight to the rows in range of each of the requested columns.
+    using Scalar = typename Element<T>::Scalar;
+    std::vector<Scalar> data(columns.size() * blockSize);
+    for(size_t i = 0; i < columns.size() && blockSize > 0; ++i) {
+        const std::streamoff offset = header.dataOffset +
+            static_cast<std::streamoff>(numRows * sizeof(double) +
+                (columns[i] * columnSize + firstRow * numComps) *
+                sizeof(Scalar));
+        stream.seekg(offset);
+        readValues(stream, data.data() + i * blockSize, blockSize,
+                   fileName);
+    }
+
+    auto table = std::make_shared<TimeSeriesTable_<T>>();
+    for(const auto& keyValue : header.metadata)
+        table->updTableMetaData().setValueForKey(keyValue.first,
+                                                 keyValue.second);
+    std::vector<std::string> columnLabels{};
+    for(auto c : columns)
+        columnLabels.push_back(header.labels[c]);
+    table->setColumnLabels(columnLabels);
+
+    table->reserve(numRowsRead);
+    SimTK::RowVector_<T> row{static_cast<int>(columns.size())};
+    for(size_t r = 0; r < numRowsRead; ++r) {
+        for(size_t i = 0; i < columns.size(); ++i)
+            row[static_cast<int>(i)] =
+                Element<T>::make(data.data() + i * blockSize + r * numComps);
+        table->appendRow(time[firstRow + r], row);
+    }
+
+    return table;
+}
+
+} // anonymous namespace
+
+BinaryFileAdapter*
+BinaryFileAdapter::clone() const {
+    return new BinaryFileAdapter{*this};
+}
+
+const std::string
+BinaryFileAdapter::tableString() {
+    return "table";
+}
+
+std::vector<std::string>
+BinaryFileAdapter::readColumnLabels(const std::string& fileName) {
+    std::ifstream stream{};
+    openForReading(stream, fileName);
+    return readHeader(stream, fileName).labels;
+}
+
+std::string
+BinaryFileAdapter::readDataType(const std::string& fileName) {
+    std::ifstream stream{};
+    openForReading(stream, fileName);
+    return readHeader(stream, fileName).dataType;
+}
+
+BinaryFileAdapter::Layout
+BinaryFileAdapter::readLayout(const std::string& fileName) {
+    std::ifstream stream{};
+    openForReading(stream, fileName);
+    const auto header = readHeader(stream, fileName);
+
+    Layout layout{};
+    layout.dataType      = header.dataType;
+    layout.numComponents = header.numComponents;
+    layout.numRows       = header.numRows;
+    layout.scalarSize    = componentSize(header.dataType);
+    layout.labels        = header.labels;
+    layout.timeOffset    = header.dataOffset;
+    return layout;
+}
+
+BinaryFileAdapter::OutputTables
+BinaryFileAdapter::extendRead(const std::string& fileName) const {
+    return extendReadColumns(fileName, ColumnSelection{});
+}
+
+BinaryFileAdapter::OutputTables
+BinaryFileAdapter::extendReadColumns(const std::string& fileName,
+                                     const ColumnSelection& selection,
+                                     double startTime,
+                                     double endTime) const {
+    std::ifstream stream{};
+    openForReading(stream, fileName);
+    const auto header = readHeader(stream, fileName);
+
+    std::shared_ptr<AbstractDataTable> table{};
+    if(header.dataType == Element<double>::name())
+        table = readTable<double>(stream, header, fileName, selection,
+                                   startTime, endTime);
+    else if(header.dataType == Element<float>::name())
+        table = readTable<float>(stream, header, fileName, selection,
+                                   startTime, endTime);
+    else if(header.dataType == Element<SimTK::Vec3>::name())
+        table = readTable<SimTK::Vec3>(stream, header, fileName, selection,
+                                   startTime, endTime);
+    else if(header.dataType == Element<SimTK::Quaternion>::name())
+        table = readTable<SimTK::Quaternion>(stream, header, fileName, selection,
+                                   startTime, endTime);
+    else if(header.dataType == Element<SimTK::SpatialVec>::name())
+        table = readTable<SimTK::SpatialVec>(stream, header, fileName, selection,
+                                   startTime, endTime);
+    else
+        OPENSIM_THROW(BinaryDataTypeNotSupported,
+                      header.dataType);
+
+    OutputTables output_tables{};
+    output_tables.emplace(tableString(), table);
+
+    return output_tables;
+}
+
+void
+BinaryFileAdapter::extendWrite(const InputTables& absTables,
+                               const std::string& fileName) const {
+    OPENSIM_THROW_IF(absTables.empty(),
+                     NoTableFound);
+    OPENSIM_THROW_IF(fileName.empty(),
+                     EmptyFileName);
+
+    const AbstractDataTable* absTable{};
+    try {
+        absTable = absTables.at(tableString());
+    } catch(std::out_of_range&) {
+        OPENSIM_THROW(KeyMissing,
+                      tableString());
+    }
+
+    using namespace SimTK;
+    if(auto table = dynamic_cast<const TimeSeriesTable_<double>*>(absTable))
+        writeTable(*table, fileName);
+    else if(auto table =
+            dynamic_cast<const TimeSeriesTable_<float>*>(absTable))
+        writeTable(*table, fileName);
+    else if(auto table = dynamic_cast<const TimeSeriesTable_<Vec3>*>(absTable))
+        writeTable(*table, fileName);
+    else if(auto table =
+            dynamic_cast<const TimeSeriesTable_<Quaternion>*>(absTable))
+        writeTable(*table, fileName);
+    else if(auto table =
+            dynamic_cast<const TimeSeriesTable_<SpatialVec>*>(absTable))
+        writeTable(*table, fileName);
+    else
+        OPENSIM_THROW(IncorrectTableType,
+                      "BinaryFileAdapter supports TimeSeriesTable_ with "
+                      "elements of type double, float, Vec3, Quaternion "
+                      "and SpatialVec.");
+}
+
+} // namespace OpenSim
@@ -0,0 +1,242 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  BinaryFileAdapter.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#ifndef OPENSIM_BINARY_FILE_ADAPTER_H_
+#define OPENSIM_BINARY_FILE_ADAPTER_H_
+
+#include "FileAdapter.h"
+#include "TimeSeriesTable.h"
+
+#include <ios>
+
+namespace OpenSim {
+
+class NotABinaryTableFile : public IOError {
+public:
+    NotABinaryTableFile(const std::string& file,
+                        size_t line,
+                        const std::string& func,
+                        const std::string& filename,
+                        const std::string& reason) :
+        IOError(file, line, func) {
+        std::string msg = "Error reading file '" + filename + "'. ";
+        msg += reason;
+
+        addMessage(msg);
+    }
+};
+
+class BinaryDataTypeNotSupported : public InvalidArgument {
+public:
+    BinaryDataTypeNotSupported(const std::string& file,
+                               size_t line,
+                               const std::string& func,
+                               const std::string& datatype) :
+        InvalidArgument(file, line, func) {
+        std::string msg = "Datatype '" + datatype + "' is not supported by ";
+        msg += "BinaryFileAdapter.";
+
+        addMessage(msg);
+    }
+};
+
+/** BinaryFileAdapter is a FileAdapter that reads and writes TimeSeriesTable_
+objects in a binary, column-oriented format (extension ".otb"). Supported
+element types are double, float, SimTK::Vec3, SimTK::Quaternion and
+SimTK::SpatialVec. The file holds the string-valued table metadata, the column
+labels, the time column and then each column of data as a contiguous block of
+doubles. Values are stored exactly (no conversion to/from text) and a file is
+about a third of the size of the equivalent STO file.
+
+The values of a TimeSeriesTableFloat are stored as 4-byte floats, in half the
+space, and the table metadata of the file mark them as rounded to single
+precision (see getPrecisionMetaDataKey()). To archive a TimeSeriesTable in
+single precision, write toSinglePrecision(table).
+
+Because the columns are stored contiguously at offsets that are known from the
+header, readColumns() only reads the bytes for the columns asked for. This
+makes it cheap to pull a few columns out of a very large file.
+
+The byte order of the machine that wrote the file is recorded in the file and
+a file written on a machine with a different byte order is rejected.        */
+class OSIMCOMMON_API BinaryFileAdapter : public FileAdapter {
+public:
+    BinaryFileAdapter()                                    = default;
+    BinaryFileAdapter(const BinaryFileAdapter&)            = default;
+    BinaryFileAdapter(BinaryFileAdapter&&)                 = default;
+    BinaryFileAdapter& operator=(const BinaryFileAdapter&) = default;
+    BinaryFileAdapter& operator=(BinaryFileAdapter&&)      = default;
+    ~BinaryFileAdapter()                                   = default;
+
+    BinaryFileAdapter* clone() const override;
+
+    /** Read a table from the given file. The template argument must match the
+    element type the table was written with.
+
+    \throws IncorrectTableType If the file holds elements of another type.   */
+    template<typename T>
+    static
+    TimeSeriesTable_<T> read(const std::string& fileName);
+
+    /** Read only the selected columns from the given file: the columns with
+    the given labels (in the given order), or the columns whose labels match a
+    regular expression (see ColumnSelection). Only the time column and the
+    data of the selected columns are read from the file.
+
+    \throws KeyNotFound If the file has no column with one of the labels.
+    \throws IncorrectTableType If the file holds elements of another type.   */
+    template<typename T>
+    static
+    TimeSeriesTable_<T> readColumns(const std::string& fileName,
+                                    const ColumnSelection& selection);
+
+    /** Read the rows with times in [startTime, endTime], and only the
+    selected columns (all by default), from the given file. The time column
+    stored in the file serves as an index: only it and the bytes of the rows
+    in range of the selected columns are read, so the cost scales with the
+    size of the range rather than with the size of the file.
+
+    \throws KeyNotFound If the file has no column with one of the labels.
+    \throws IncorrectTableType If the file holds elements of another type.   */
+    template<typename T>
+    static
+    TimeSeriesTable_<T> readTimeRange(const std::string& fileName,
+                                      double startTime, double endTime,
+                           const ColumnSelection& selection = ColumnSelection{});
+
+    /** Read the column labels of the table in the given file without reading
+    any of its data.                                                          */
+    static
+    std::vector<std::string> readColumnLabels(const std::string& fileName);
+
+    /** Read the name of the element type ("double", "float", "Vec3",
+    "Quaternion" or "SpatialVec") of the table in the given file.             */
+    static
+    std::string readDataType(const std::string& fileName);
+
+    /** Where the data of the table in a binary file lie. Used by readers that
+    access parts of a file directly rather than reading it into a table (see
+    DiskBackedStorage).                                                       */
+    struct Layout {
+        std::string              dataType{};
+        size_t                   numComponents{};
+        size_t                   numRows{};
+        /** Size in bytes of a stored component (4 for "float" tables, else
+        8).                                                                   */
+        size_t                   scalarSize{sizeof(double)};
+        std::vector<std::string> labels{};
+        /** Offset of the time column from the beginning of the file.         */
+        std::streamoff           timeOffset{};
+
+        /** Offset from the beginning of the file of the values of the given
+        column, which are numRows * numComponents components of scalarSize
+        bytes.                                                                */
+        std::streamoff columnOffset(size_t column) const {
+            return timeOffset + static_cast<std::streamoff>(
+                numRows * sizeof(double) +
+                column * numRows * numComponents * scalarSize);
+        }
+    };
+
+    /** Read the layout of the table in the given file without reading any of
+    its data.                                                                 */
+    static
+    Layout readLayout(const std::string& fileName);
+
+    /** Write a table to the given file.                                      */
+    template<typename T>
+    static
+    void write(const TimeSeriesTable_<T>& table, const std::string& fileName);
+
+    /** Key used for table associative array returned/accepted by write/read. */
+    static const std::string tableString();
+
+protected:
+    /** Implementation of the read functionality.                             */
+    OutputTables extendRead(const std::string& fileName) const override;
+
+    /** Implementation of the write functionality.                            */
+    void extendWrite(const InputTables& tables,
+                     const std::string& fileName) const override;
+
+    /** Read the selected columns of the rows with times in [startTime,
+    endTime] from the given file.                                             */
+    OutputTables extendReadColumns(const std::string& fileName,
+                                   const ColumnSelection& selection,
+                                   double startTime = -SimTK::Infinity,
+                                   double endTime = SimTK::Infinity) const;
+
+private:
+    template<typename T>
+    static
+    TimeSeriesTable_<T> castTable(const OutputTables& tables);
+};
+
+template<typename T>
+TimeSeriesTable_<T>
+BinaryFileAdapter::castTable(const OutputTables& tables) {
+    auto table =
+        std::dynamic_pointer_cast<TimeSeriesTable_<T>>(
+                tables.at(tableString()));
+    OPENSIM_THROW_IF(!table,
+                     IncorrectTableType,
+                     "Element type of the table in the file does not match "
+                     "the requested element type.");
+    return *table;
+}
+
+template<typename T>
+TimeSeriesTable_<T>
+BinaryFileAdapter::read(const std::string& fileName) {
+    return castTable<T>(BinaryFileAdapter{}.extendRead(fileName));
+}
+
+template<typename T>
+TimeSeriesTable_<T>
+BinaryFileAdapter::readColumns(const std::string& fileName,
+                               const ColumnSelection& selection) {
+    return castTable<T>(BinaryFileAdapter{}.extendReadColumns(fileName,
+                                                              selection));
+}
+
+template<typename T>
+TimeSeriesTable_<T>
+BinaryFileAdapter::readTimeRange(const std::string& fileName,
+                                 double startTime, double endTime,
+                                 const ColumnSelection& selection) {
+    return castTable<T>(BinaryFileAdapter{}.extendReadColumns(fileName,
+                                                              selection,
+                                                              startTime,
+                                                              endTime));
+}
+
+template<typename T>
+void
+BinaryFileAdapter::write(const TimeSeriesTable_<T>& table,
+                         const std::string& fileName) {
+    InputTables tables{};
+    tables.emplace(tableString(), &table);
+    BinaryFileAdapter{}.extendWrite(tables, fileName);
+}
+
+} // namespace OpenSim
+
+#endif // OPENSIM_BINARY_FILE_ADAPTER_H_
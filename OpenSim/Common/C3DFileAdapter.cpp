@@ -111,19 +111,25 @@ C3DFileAdapter::extendRead(const std::string& fileName) const {
         marker_dep_metadata.setValueArrayForKey("labels", marker_labels);
         marker_table.setDependentsMetaData(marker_dep_metadata);
 
+        // Look up the values of each marker once instead of once per frame,
+        // and fill the same row for all frames.
+        std::vector<const btk::Point::Values*> marker_values{};
+        for(auto it = marker_pts->Begin();
+            it != marker_pts->End();
+            ++it)
+            marker_values.push_back(&(*it)->GetValues());
+
         double time_step{1.0 / acquisition->GetPointFrequency()};
-        for(int f = 0; 
-            f < marker_pts->GetFrontItem()->GetFrameNumber();
-            ++f) {
-            SimTK::RowVector_<SimTK::Vec3> row{marker_pts->GetItemNumber()};
-            int m{0};
-            for(auto it = marker_pts->Begin();
-                it != marker_pts->End();
-                ++it) {
-                auto pt = *it;
-                row[m++] = SimTK::Vec3{pt->GetValues().coeff(f, 0),
-                                       pt->GetValues().coeff(f, 1),
-                                       pt->GetValues().coeff(f, 2)};
+        const int num_marker_frames{
+            marker_pts->GetFrontItem()->GetFrameNumber()};
+        marker_table.reserve(num_marker_frames);
+        SimTK::RowVector_<SimTK::Vec3> row{(int)marker_values.size()};
+        for(int f = 0; f < num_marker_frames; ++f) {
+            for(size_t m = 0; m < marker_values.size(); ++m) {
+                const auto& values = *marker_values[m];
+                row[(int)m] = SimTK::Vec3{values.coeff(f, 0),
+                                          values.coeff(f, 1),
+                                          values.coeff(f, 2)};
             }
             marker_table.appendRow(0 + f * time_step, row);
         }
@@ -220,32 +226,32 @@ C3DFileAdapter::extendRead(const std::string& fileName) const {
         force_dep_metadata.setValueArrayForKey("units", units);
         force_table.setDependentsMetaData(force_dep_metadata);
 
+        // The columns are the force, moment and position of each platform
+        // in turn. Look up their values once instead of once per frame.
+        std::vector<const btk::Point::Values*> fp_values{};
+        for(auto fit = fp_force_pts->Begin(),
+            mit =     fp_moment_pts->Begin(),
+            pit =   fp_position_pts->Begin();
+            fit != fp_force_pts->End();
+            ++fit,
+            ++mit,
+            ++pit) {
+            fp_values.push_back(&(*fit)->GetValues());
+            fp_values.push_back(&(*mit)->GetValues());
+            fp_values.push_back(&(*pit)->GetValues());
+        }
+
         double time_step{1.0 / acquisition->GetAnalogFrequency()};
-        for(int f = 0;
-            f < fp_force_pts->GetFrontItem()->GetFrameNumber();
-            ++f) {
-            SimTK::RowVector_<SimTK::Vec3>
-                row{fp_force_pts->GetItemNumber() * 3};
-            int col{0};
-            for(auto fit = fp_force_pts->Begin(),
-                mit =     fp_moment_pts->Begin(),
-                pit =   fp_position_pts->Begin();
-                fit != fp_force_pts->End();
-                ++fit, 
-                ++mit,
-                ++pit) {
-                row[col] = SimTK::Vec3{(*fit)->GetValues().coeff(f, 0),
-                                       (*fit)->GetValues().coeff(f, 1),
-                                       (*fit)->GetValues().coeff(f, 2)};
-                ++col;
-                row[col] = SimTK::Vec3{(*mit)->GetValues().coeff(f, 0),
-                                       (*mit)->GetValues().coeff(f, 1),
-                                       (*mit)->GetValues().coeff(f, 2)};
-                ++col;
-                row[col] = SimTK::Vec3{(*pit)->GetValues().coeff(f, 0),
-                                       (*pit)->GetValues().coeff(f, 1),
-                                       (*pit)->GetValues().coeff(f, 2)};
-                ++col;
+        const int num_force_frames{
+            fp_force_pts->GetFrontItem()->GetFrameNumber()};
+        force_table.reserve(num_force_frames);
+        SimTK::RowVector_<SimTK::Vec3> row{(int)fp_values.size()};
+        for(int f = 0; f < num_force_frames; ++f) {
+            for(size_t col = 0; col < fp_values.size(); ++col) {
+                const auto& values = *fp_values[col];
+                row[(int)col] = SimTK::Vec3{values.coeff(f, 0),
+                                            values.coeff(f, 1),
+                                            values.coeff(f, 2)};
             }
             force_table.appendRow(0 + f * time_step, row);
         }
@@ -18,6 +18,26 @@ CSVFileAdapter::read(const std::string& fileName) {
     return static_cast<TimeSeriesTable&>(*abs_table);
 }
 
+TimeSeriesTable
+CSVFileAdapter::readColumns(const std::string& fileName,
+                            const ColumnSelection& selection) {
+    auto abs_table = CSVFileAdapter{}.
+                     extendReadColumns(fileName, selection).
+                     at(tableString());
+    return static_cast<TimeSeriesTable&>(*abs_table);
+}
+
+TimeSeriesTable
+CSVFileAdapter::readTimeRange(const std::string& fileName,
+                              double startTime, double endTime,
+                              const ColumnSelection& selection) {
+    auto abs_table = CSVFileAdapter{}.
+                     extendReadColumns(fileName, selection,
+                                       startTime, endTime).
+                     at(tableString());
+    return static_cast<TimeSeriesTable&>(*abs_table);
+}
+
 void 
 CSVFileAdapter::write(const TimeSeriesTable& table, 
                         const std::string& fileName) {
@@ -44,6 +44,21 @@ public:
     static
     TimeSeriesTable read(const std::string& fileName);
 
+    /** Read only the selected columns of a CSV file (see ColumnSelection).
+
+    \throws KeyNotFound If the file has no column with one of the labels.   */
+    static
+    TimeSeriesTable readColumns(const std::string& fileName,
+                                const ColumnSelection& selection);
+
+    /** Read the rows of a CSV file with times in [startTime, endTime], and
+    only the selected columns (all by default). See
+    STOFileAdapter_::readTimeRange().                                         */
+    static
+    TimeSeriesTable readTimeRange(const std::string& fileName,
+                                  double startTime, double endTime,
+                          const ColumnSelection& selection = ColumnSelection{});
+
     /** Write a CSV file.                                                     */
     static
     void write(const TimeSeriesTable& table, const std::string& fileName);
@@ -27,8 +27,21 @@
 #include "OpenSim/Common/IO.h"
 #include "XMLDocument.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
 using namespace SimTK;
 
+namespace {
+    // Guards the registries of the component trees, which are built lazily by
+    // const methods that may be called from several threads.
+    std::mutex registryMutex;
+}
+
 namespace OpenSim {
 
 //==============================================================================
@@ -63,6 +76,9 @@ public:
     :   SimTK::Measure_<T>::Implementation(0), _Component(c) {}
 
     // Implementations of Measure_<T>::Implementation virtual methods.
+    // Each realize() is timed if component profiling is enabled.
+    using Timer = ComponentProfiler::Timer;
+
 
     Implementation* cloneVirtual() const override final
     {   return new Implementation(*this); }
@@ -76,29 +92,38 @@ public:
     {   return this->getValueZero(); }
 
     void realizeMeasureTopologyVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeTopology(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeTopology);
+        _Component.extendRealizeTopology(s); }
     void realizeMeasureModelVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeModel(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeModel);
+        _Component.extendRealizeModel(s); }
     void realizeMeasureInstanceVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeInstance(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeInstance);
+        _Component.extendRealizeInstance(s); }
     void realizeMeasureTimeVirtual(const SimTK::State& s) const override final
-    {   _Component.extendRealizeTime(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeTime);
+        _Component.extendRealizeTime(s); }
     void realizeMeasurePositionVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizePosition(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizePosition);
+        _Component.extendRealizePosition(s); }
     void realizeMeasureVelocityVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeVelocity(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeVelocity);
+        _Component.extendRealizeVelocity(s); }
     void realizeMeasureDynamicsVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeDynamics(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeDynamics);
+        _Component.extendRealizeDynamics(s); }
     void realizeMeasureAccelerationVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeAcceleration(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeAcceleration);
+        _Component.extendRealizeAcceleration(s); }
     void realizeMeasureReportVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeReport(s); }
+    {   Timer timer(&_Component, ComponentProfiler::RealizeReport);
+        _Component.extendRealizeReport(s); }
 
 private:
     const Component& _Component;
@@ -127,16 +152,17 @@ Component::Component(SimTK::Xml::Element& element) : Object(element)
 void Component::addComponent(Component* subcomponent)
 {
     //get to the root Component
-    const Component* root = this;
-    while (root->hasParent()) {
-        root = &(root->getParent());
-    }
-
-    auto components = root->getComponentList<Component>();
-    for (auto& c : components) {
-        if (subcomponent == &c) {
-            OPENSIM_THROW( ComponentAlreadyPartOfOwnershipTree,
-                subcomponent->getName(), getName());
+    const Component& root = getRoot();
+
+    // A component in the tree leads up to its root, so only then does the
+    // tree need to be searched for it.
+    if (&subcomponent->getRoot() == &root) {
+        auto components = root.getComponentList<Component>();
+        for (auto& c : components) {
+            if (subcomponent == &c) {
+                OPENSIM_THROW( ComponentAlreadyPartOfOwnershipTree,
+                    subcomponent->getName(), getName());
+            }
         }
     }
 
@@ -151,6 +177,8 @@ void Component::addComponent(Component* subcomponent)
 void Component::finalizeFromProperties()
 {
     reset();
+    // The subcomponents may change, so the registry of the tree is stale.
+    invalidateRegistry();
 
     // TODO use a flag to set whether we are lenient on having nameless
     // Components. For backward compatibility we need to be able to 
@@ -170,21 +198,7 @@ void Component::finalizeFromProperties()
         comp->setParent(*this);
     }
     
-    // Provide sockets, inputs, and outputs with a pointer to its component
-    // (this) so that they can invoke the component's methods.
-    for (auto& it : _socketsTable) {
-        it.second->setOwner(*this);
-        // Let the Socket handle any errors in the connectee_name property.
-        it.second->checkConnecteeNameProperty();
-    }
-    for (auto& it : _inputsTable) {
-        it.second->setOwner(*this);
-        // Let the Socket handle any errors in the connectee_name property.
-        it.second->checkConnecteeNameProperty();
-    }
-    for (auto& it : _outputsTable) {
-        it.second->setOwner(*this);
-    }
+    finalizeSocketsInputsOutputs();
 
     markPropertiesAsSubcomponents();
     componentsFinalizeFromProperties();
@@ -219,6 +233,49 @@ void Component::finalizeConnections(Component &root)
         finalizeFromProperties();
     }
 
+    // Register the whole tree up front so that the connectees of all the
+    // sockets and inputs are looked up by their path names.
+    if (&root == this) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        getRegistry();
+    }
+
+    connectSocketsAndInputs(root);
+
+    // Allow derived Components to handle/check their connections and also 
+    // override the order in which its subcomponents are ordered when 
+    // adding subcomponents to the System
+    extendConnect(root);
+
+    // Allow subcomponents to form their connections
+    componentsConnect(root);
+
+    // Forming connections changes the Socket which is a property
+    // Remark as upToDate.
+    setObjectIsUpToDateWithProperties();
+}
+
+void Component::finalizeSocketsInputsOutputs()
+{
+    // Provide sockets, inputs, and outputs with a pointer to its component
+    // (this) so that they can invoke the component's methods.
+    for (auto& it : _socketsTable) {
+        it.second->setOwner(*this);
+        // Let the Socket handle any errors in the connectee_name property.
+        it.second->checkConnecteeNameProperty();
+    }
+    for (auto& it : _inputsTable) {
+        it.second->setOwner(*this);
+        // Let the Socket handle any errors in the connectee_name property.
+        it.second->checkConnecteeNameProperty();
+    }
+    for (auto& it : _outputsTable) {
+        it.second->setOwner(*this);
+    }
+}
+
+void Component::connectSocketsAndInputs(Component& root)
+{
     for (auto& it : _socketsTable) {
         auto& socket = it.second;
         socket->disconnect();
@@ -259,18 +316,6 @@ void Component::finalizeConnections(Component &root)
                 + " (details: " + x.what() + ").");
         }
     }
-
-    // Allow derived Components to handle/check their connections and also 
-    // override the order in which its subcomponents are ordered when 
-    // adding subcomponents to the System
-    extendConnect(root);
-
-    // Allow subcomponents to form their connections
-    componentsConnect(root);
-
-    // Forming connections changes the Socket which is a property
-    // Remark as upToDate.
-    setObjectIsUpToDateWithProperties();
 }
 
 // invoke connect on all (sub)components of this component
@@ -346,6 +391,9 @@ void Component::baseAddToSystem(SimTK::MultibodySystem& system) const
     // information associated with the System; that info is const after this.
     Component* mutableThis = const_cast<Component *>(this);
     mutableThis->_system = system;
+    // The state variables will be allocated again for the new System.
+    _statesAssociatedSystem.reset();
+    _allStateVariables.clear();
 
     // Allocate the ComponentMeasure, point it to this Component for 
     // making realize() calls, and add it to the system's default subsystem. 
@@ -582,6 +630,175 @@ unsigned Component::printComponentsMatching(const std::string& substring) const
     return count;
 }
 
+namespace {
+    // Heap memory of a string, assuming the small-string buffer of 15
+    // characters of the common standard libraries.
+    size_t estimateHeapMemory(const std::string& str)
+    {
+        return str.capacity() > 15 ? str.capacity() + 1 : 0;
+    }
+
+    // Memory of a node of a std::map, besides its key and value.
+    const size_t MapNodeOverhead = 4*sizeof(void*);
+
+    size_t estimateObjectMemory(const Object& obj);
+
+    // Memory of a property and of the Objects within it that are not
+    // Components; those are counted with the other components.
+    size_t estimatePropertyMemory(const AbstractProperty& prop)
+    {
+        size_t bytes = sizeof(AbstractProperty) + 
+            estimateHeapMemory(prop.getName()) + 
+            estimateHeapMemory(prop.getComment()) +
+            prop.estimateValueMemory();
+        if (prop.isObjectProperty()) {
+            for (int i = 0; i < prop.getNumValues(); ++i) {
+                const Object& value = prop.getValueAsObject(i);
+                if (dynamic_cast<const Component*>(&value) == nullptr)
+                    bytes += estimateObjectMemory(value);
+            }
+        }
+        return bytes;
+    }
+
+    size_t estimatePropertiesMemory(const Object& obj)
+    {
+        size_t bytes = 0;
+        for (int i = 0; i < obj.getNumProperties(); ++i)
+            bytes += estimatePropertyMemory(obj.getPropertyByIndex(i));
+        const PropertySet& deprecated = obj.getPropertySet();
+        for (int i = 0; i < deprecated.getSize(); ++i)
+            bytes += estimatePropertyMemory(*deprecated.get(i));
+        return bytes;
+    }
+
+    size_t estimateStringsMemory(const Object& obj)
+    {
+        return estimateHeapMemory(obj.getName()) +
+               estimateHeapMemory(obj.getDescription()) +
+               estimateHeapMemory(obj.getAuthors()) +
+               estimateHeapMemory(obj.getReferences());
+    }
+
+    size_t estimateObjectMemory(const Object& obj)
+    {
+        return sizeof(Object) + estimateStringsMemory(obj) +
+               estimatePropertiesMemory(obj);
+    }
+
+    // Memory of the XML elements within an element: their tags and values,
+    // and roughly what the parser allocates for each.
+    size_t estimateElementMemory(SimTK::Xml::Element& elt)
+    {
+        const size_t ElementOverhead = 16*sizeof(void*);
+        size_t bytes = ElementOverhead + elt.getElementTag().size();
+        if (elt.isValueElement())
+            bytes += elt.getValue().size();
+        for (auto it = elt.element_begin(); it != elt.element_end(); ++it)
+            bytes += estimateElementMemory(*it);
+        return bytes;
+    }
+}
+
+Component::MemoryFootprint Component::estimateMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.object = sizeof(Component);
+    footprint.strings = estimateStringsMemory(*this);
+    footprint.properties = estimatePropertiesMemory(*this);
+
+    for (const auto& it : _socketsTable)
+        footprint.connectors += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first) + sizeof(AbstractSocket) + 
+            estimateHeapMemory(it.second->getName());
+    for (const auto& it : _inputsTable)
+        footprint.connectors += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first) + sizeof(AbstractInput) + 
+            estimateHeapMemory(it.second->getName());
+    for (const auto& it : _outputsTable)
+        footprint.connectors += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first) + sizeof(Output<double>) + 
+            estimateHeapMemory(it.second->getName());
+
+    for (const auto& it : _namedModelingOptionInfo)
+        footprint.variables += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first);
+    for (const auto& it : _namedStateVariableInfo)
+        footprint.variables += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first);
+    for (const auto& it : _namedDiscreteVariableInfo)
+        footprint.variables += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first);
+    for (const auto& it : _namedCacheVariableInfo)
+        footprint.variables += MapNodeOverhead + sizeof(it) +
+            estimateHeapMemory(it.first);
+
+    if (getDocument()) {
+        SimTK::Xml::Element root = 
+            const_cast<XMLDocument*>(getDocument())->getRootElement();
+        for (auto it = root.element_begin(); it != root.element_end(); ++it)
+            footprint.document += estimateElementMemory(*it);
+    }
+    return footprint;
+}
+
+size_t Component::printMemoryFootprint() const
+{
+    // The number of components of each concrete class and their footprint.
+    std::map<std::string, std::pair<int, MemoryFootprint>> byClass;
+    auto add = [&byClass](const Component& comp) {
+        auto& entry = byClass[comp.getConcreteClassName()];
+        ++entry.first;
+        entry.second += comp.estimateMemoryFootprint();
+    };
+    add(*this);
+    for (const auto& comp : getComponentList())
+        add(comp);
+
+    std::vector<std::pair<std::string, std::pair<int, MemoryFootprint>>> 
+        rows(byClass.begin(), byClass.end());
+    std::sort(rows.begin(), rows.end(), [](
+            const std::pair<std::string, std::pair<int, MemoryFootprint>>& a,
+            const std::pair<std::string, std::pair<int, MemoryFootprint>>& b) {
+        return a.second.second.total() > b.second.second.total();
+    });
+
+    int numComponents = 0;
+    MemoryFootprint total;
+    for (const auto& row : rows) {
+        numComponents += row.second.first;
+        total += row.second.second;
+    }
+
+    const std::ios_base::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    std::cout << "Estimated memory footprint of " << getConcreteClassName()
+              << " '" << getName() << "' and its " << numComponents - 1
+              << " subcomponents, in kilobytes:" << std::endl;
+    auto printRow = [](const std::string& name, int count,
+                       const MemoryFootprint& fp) {
+        std::cout << std::left << std::setw(32) << name << std::right
+                  << std::setw(8) << count << std::fixed 
+                  << std::setprecision(1);
+        for (size_t bytes : {fp.total(), fp.object, fp.strings,
+                fp.properties, fp.connectors, fp.variables, fp.document})
+            std::cout << std::setw(12) << bytes/1024.;
+        std::cout << std::endl;
+    };
+    std::cout << std::left << std::setw(32) << "class" << std::right
+              << std::setw(8) << "count";
+    for (const char* heading : {"total", "object", "strings", "properties",
+            "connectors", "variables", "document"})
+        std::cout << std::setw(12) << heading;
+    std::cout << std::endl;
+    for (const auto& row : rows)
+        printRow(row.first, row.second.first, row.second.second);
+    printRow("(all)", numComponents, total);
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+    return total.total();
+}
+
 int Component::getNumStateVariables() const
 {
     // Must have already called initSystem.
@@ -715,6 +932,15 @@ Array<std::string> Component::getStateVariableNames() const
     // Must have already called initSystem.
     OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
 
+    getAllStateVariables();
+    return _allStateVariableNames;
+}
+
+Array<std::string> Component::computeStateVariableNames() const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+
     Array<std::string> names = getStateVariablesNamesAddedByComponent();
 
 /** TODO: Use component iterator  like below
@@ -734,7 +960,7 @@ Array<std::string> Component::getStateVariableNames() const
 
     // Include the states of its subcomponents
     for (unsigned int i = 0; i<_memberSubcomponents.size(); i++) {
-        Array<std::string> subnames = _memberSubcomponents[i]->getStateVariableNames();
+        Array<std::string> subnames = _memberSubcomponents[i]->computeStateVariableNames();
         int nsubs = subnames.getSize();
         const std::string& subCompName = _memberSubcomponents[i]->getName();
         std::string::size_type front = subCompName.find_first_not_of(" \t\r\n");
@@ -747,7 +973,7 @@ Array<std::string> Component::getStateVariableNames() const
         }
     }
     for(unsigned int i=0; i<_propertySubcomponents.size(); i++){
-        Array<std::string> subnames = _propertySubcomponents[i]->getStateVariableNames();
+        Array<std::string> subnames = _propertySubcomponents[i]->computeStateVariableNames();
         int nsubs = subnames.getSize();
         const std::string& subCompName =  _propertySubcomponents[i]->getName();
         // TODO: We should implement checks that names do not have whitespace at the time 
@@ -763,7 +989,7 @@ Array<std::string> Component::getStateVariableNames() const
     }
 
     for (unsigned int i = 0; i<_adoptedSubcomponents.size(); i++) {
-        Array<std::string> subnames = _adoptedSubcomponents[i]->getStateVariableNames();
+        Array<std::string> subnames = _adoptedSubcomponents[i]->computeStateVariableNames();
         int nsubs = subnames.getSize();
         const std::string& subCompName = _adoptedSubcomponents[i]->getName();
         std::string::size_type front = subCompName.find_first_not_of(" \t\r\n");
@@ -857,13 +1083,11 @@ void Component::
 
 bool Component::isAllStatesVariablesListValid() const
 {
-    int nsv = getNumStateVariables();
     // Consider the list of all StateVariables to be valid if all of 
     // the following conditions are true:
     // 1. Component is up-to-date with its Properties
     // 2. a System has been associated with the list of StateVariables
-    // 3. The list of all StateVariables is correctly sized (initialized)
-    // 4. The System associated with the StateVariables is the current System
+    // 3. The System associated with the StateVariables is the current System
     // TODO: Enable the isObjectUpToDateWithProperties() check when computing
     // the path of the GeomtryPath does not involve updating its PathPointSet.
     // This change dirties the GeometryPath which is a property of a Muscle which
@@ -872,42 +1096,132 @@ bool Component::isAllStatesVariablesListValid() const
     // See GeometryPath::computePath() for the corresponding TODO that must be
     // addressed before we can re-enable the isObjectUpToDateWithProperties
     // check.
-    // It has been verified that the adding Components will invalidate the state
-    // variables associated with the Model and force the list to be rebuilt.
+    // The list is cleared whenever the Component is added to a System (see
+    // baseAddToSystem()), so adding Components and calling initSystem() again
+    // forces the list to be rebuilt. That way we do not need to count the
+    // state variables of the whole subtree on every call.
     bool valid = //isObjectUpToDateWithProperties() &&                  // 1.
         !_statesAssociatedSystem.empty() &&                             // 2.
-        _allStateVariables.size() == nsv &&                             // 3.
-        getSystem().isSameSystem(_statesAssociatedSystem.getRef());     // 4.
+        getSystem().isSameSystem(_statesAssociatedSystem.getRef());     // 3.
 
     return valid;
 }
 
+const SimTK::Array_<SimTK::ReferencePtr<const Component::StateVariable> >&
+    Component::getAllStateVariables() const
+{
+    // if the StateVariables are invalid (see above) rebuild the list
+    if (!isAllStatesVariablesListValid()) {
+        Array<std::string> names = computeStateVariableNames();
+        const int nsv = names.getSize();
+        _statesAssociatedSystem.reset(&getSystem());
+        _allStateVariables.clear();
+        _allStateVariables.resize(nsv);
+        for (int i = 0; i < nsv; ++i)
+            _allStateVariables[i].reset(findStateVariable(names[i]));
+        _allStateVariableNames = names;
+        // The indices in Y are found at the first bulk access.
+        _allStateVariableYIndices.clear();
+        _allStateVariablesYLayout.clear();
+    }
+    return _allStateVariables;
+}
+
+const int* Component::
+    getAllStateVariableYIndices(const SimTK::State& state) const
+{
+    const auto& stateVariables = getAllStateVariables();
+    if (state.getSystemStage() < SimTK::Stage::Model)
+        return nullptr;
+
+    const SimTK::Array_<int> layout{state.getNQ(), state.getNU(),
+                                    state.getNZ()};
+    if (layout != _allStateVariablesYLayout) {
+        // Fill Y of a copy of the state with two patterns, and look for each
+        // state variable whose value is the entry of Y at the same index in
+        // both. The second pattern is not linear in the index, so that a
+        // value computed from an entry (e.g., scaled or offset) is not
+        // mistaken for another entry.
+        const int nsv = (int)stateVariables.size();
+        SimTK::State probe = state;
+        SimTK::Vector& y = probe.updY();
+        const int ny = y.size();
+        SimTK::Array_<double> first(nsv, SimTK::NaN);
+        SimTK::Array_<double> second(nsv, SimTK::NaN);
+        for (int pattern = 0; pattern < 2; ++pattern) {
+            for (int k = 0; k < ny; ++k)
+                y[k] = pattern == 0 ? k + 1.0 : (k + 1.0)*(k + 1.0);
+            auto& values = pattern == 0 ? first : second;
+            for (int i = 0; i < nsv; ++i) {
+                try {
+                    values[i] = stateVariables[i]->getValue(probe);
+                }
+                catch (const std::exception&) {
+                    // Leave it NaN, to be read through the state variable.
+                }
+            }
+        }
+        _allStateVariableYIndices.resize(nsv);
+        for (int i = 0; i < nsv; ++i) {
+            const double v = first[i];
+            const bool inY = v >= 1 && v <= ny && v == std::floor(v) &&
+                             second[i] == v*v;
+            _allStateVariableYIndices[i] = inY ? int(v) - 1 : -1;
+        }
+        _allStateVariablesYLayout = layout;
+    }
+    return _allStateVariableYIndices.data();
+}
+
+// Get the index in Y of each state variable allocated by this Component.
+// Includes state variables allocated by its subcomponents.
+SimTK::Array_<int> Component::
+    getStateVariableYIndices(const SimTK::State& state) const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+
+    const int* yIndices = getAllStateVariableYIndices(state);
+    OPENSIM_THROW_IF_FRMOBJ(!yIndices, Exception,
+        "Expected a state realized to at least Stage::Model.");
+    return SimTK::Array_<int>(yIndices,
+                              yIndices + getAllStateVariables().size());
+}
 
 // Get all values of the state variables allocated by this Component. Includes
 // state variables allocated by its subcomponents.
 SimTK::Vector Component::
     getStateVariableValues(const SimTK::State& state) const
+{
+    Vector stateVariableValues;
+    getStateVariableValues(state, stateVariableValues);
+    return stateVariableValues;
+}
+
+void Component::
+    getStateVariableValues(const SimTK::State& state,
+                           SimTK::Vector& values) const
 {
     // Must have already called initSystem.
     OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
 
-    int nsv = getNumStateVariables();
-    // if the StateVariables are invalid (see above) rebuild the list
-    if (!isAllStatesVariablesListValid()) {
-        _statesAssociatedSystem.reset(&getSystem());
-        _allStateVariables.clear();
-        _allStateVariables.resize(nsv);
-        Array<std::string> names = getStateVariableNames();
+    const auto& stateVariables = getAllStateVariables();
+    const int nsv = (int)stateVariables.size();
+    if (values.size() != nsv)
+        values.resize(nsv);
+
+    const int* yIndices = getAllStateVariableYIndices(state);
+    if (!yIndices) {
         for (int i = 0; i < nsv; ++i)
-            _allStateVariables[i].reset(findStateVariable(names[i]));
+            values[i] = stateVariables[i]->getValue(state);
+        return;
     }
 
-    Vector stateVariableValues(nsv, SimTK::NaN);
-    for(int i=0; i<nsv; ++i){
-        stateVariableValues[i]= _allStateVariables[i]->getValue(state);
+    const SimTK::Vector& y = state.getY();
+    for (int i = 0; i < nsv; ++i) {
+        values[i] = yIndices[i] >= 0 ? y[yIndices[i]]
+                                     : stateVariables[i]->getValue(state);
     }
-
-    return stateVariableValues;
 }
 
 // Set all values of the state variables allocated by this Component. Includes
@@ -919,27 +1233,63 @@ void Component::
     // Must have already called initSystem.
     OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
 
-    int nsv = getNumStateVariables();
+    const auto& stateVariables = getAllStateVariables();
+    int nsv = (int)stateVariables.size();
 
     SimTK_ASSERT(values.size() == nsv,
         "Component::setStateVariableValues() number values does not match the "
         "number of state variables.");
 
-    // if the StateVariables are invalid (see above) rebuild the list 
-    if (!isAllStatesVariablesListValid()) {
-        _statesAssociatedSystem.reset(&getSystem());
-        _allStateVariables.clear();
-        _allStateVariables.resize(nsv);
-        Array<std::string> names = getStateVariableNames();
+    const int* yIndices = getAllStateVariableYIndices(state);
+    if (!yIndices) {
         for (int i = 0; i < nsv; ++i)
-            _allStateVariables[i].reset(findStateVariable(names[i]));
+            stateVariables[i]->setValue(state, values[i]);
+        return;
     }
 
-    for(int i=0; i<nsv; ++i){
-        _allStateVariables[i]->setValue(state, values[i]);
+    // Write q, u and z separately, so that setting only z's (e.g., muscle
+    // activations) does not invalidate Stage::Position.
+    const int nq = state.getNQ();
+    const int nqu = nq + state.getNU();
+    SimTK::Vector* q = nullptr;
+    SimTK::Vector* u = nullptr;
+    SimTK::Vector* z = nullptr;
+    for (int i = 0; i < nsv; ++i) {
+        const int k = yIndices[i];
+        if (k < 0) continue;
+        if (k < nq)
+            (q ? *q : *(q = &state.updQ()))[k] = values[i];
+        else if (k < nqu)
+            (u ? *u : *(u = &state.updU()))[k - nq] = values[i];
+        else
+            (z ? *z : *(z = &state.updZ()))[k - nqu] = values[i];
+    }
+    for (int i = 0; i < nsv; ++i) {
+        if (yIndices[i] < 0)
+            stateVariables[i]->setValue(state, values[i]);
     }
 }
 
+// Get a handle to a state variable allocated by this Component or its
+// subcomponents, resolving its name once.
+Component::StateVariableHandle Component::
+    getStateVariableHandle(const std::string& name) const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+
+    const StateVariable* rsv = findStateVariable(name);
+    if (rsv) {
+        return StateVariableHandle(*rsv);
+    }
+
+    std::stringstream msg;
+    msg << "Component::getStateVariableHandle: ERR- state named '" << name 
+        << "' not found in " << getName() << " of type " 
+        << getConcreteClassName() << ".\n";
+    throw Exception(msg.str(),__FILE__,__LINE__);
+}
+
 // Set the derivative of a state variable computed by this Component by name.
 void Component::
     setStateVariableDerivativeValue(const State& state, 
@@ -1024,10 +1374,7 @@ bool Component::constructOutputForStateVariable(const std::string& name)
 // helper method to specify the order of subcomponents.
 void Component::setNextSubcomponentInSystem(const Component& sub) const
 {
-    auto it =
-        std::find(_orderedSubcomponents.begin(), _orderedSubcomponents.end(),
-            SimTK::ReferencePtr<const Component>(&sub));
-    if (it == _orderedSubcomponents.end()) {
+    if (_orderedSubcomponentSet.insert(&sub).second) {
         _orderedSubcomponents.push_back(SimTK::ReferencePtr<const Component>(&sub));
     }
 }
@@ -1076,6 +1423,7 @@ void Component::markPropertiesAsSubcomponents()
     // or the properties have been modified. In the latter case
     // we must make sure that pointers to old properties are cleared
     _propertySubcomponents.clear();
+    std::unordered_set<const Component*> marked;
 
     // Now mark properties that are Components as subcomponents
     //loop over all its properties
@@ -1088,7 +1436,7 @@ void Component::markPropertiesAsSubcomponents()
                 const Object& obj = prop.getValueAsObject(j);
                 // if the object is a Component mark it
                 if (const Component* comp = dynamic_cast<const Component*>(&obj) ) {
-                    markAsPropertySubcomponent(comp);
+                    markAsPropertySubcomponent(comp, marked);
                 }
                 else {
                     // otherwise it may be a Set (of objects), and
@@ -1108,7 +1456,7 @@ void Component::markPropertiesAsSubcomponents()
                             const Object& obj = objectsProp.getValueAsObject(k);
                             // if the object is a Component mark it
                             if (const Component* comp = dynamic_cast<const Component*>(&obj) )
-                                markAsPropertySubcomponent(comp);
+                                markAsPropertySubcomponent(comp, marked);
                         } // loop over objects and mark it if it is a component
                     } // end if property is a Set with "objects" inside
                 } // end of if/else property value is an Object or something else
@@ -1119,13 +1467,12 @@ void Component::markPropertiesAsSubcomponents()
 
 // mark a Component as a subcomponent of this one. If already a
 // subcomponent, it is not added to the list again.
-void Component::markAsPropertySubcomponent(const Component* component)
+void Component::markAsPropertySubcomponent(const Component* component,
+        std::unordered_set<const Component*>& marked)
 {
     // Only add if the component is not already a part of this Component
     SimTK::ReferencePtr<Component> compRef(const_cast<Component*>(component));
-    auto it =
-        std::find(_propertySubcomponents.begin(), _propertySubcomponents.end(), compRef);
-    if ( it == _propertySubcomponents.end() ){
+    if (marked.insert(component).second) {
         // Must reconstruct the reference pointer in place in order
         // to invoke move constructor from SimTK::Array::push_back 
         // otherwise it will copy and reset the Component pointer to null.
@@ -1133,8 +1480,6 @@ void Component::markAsPropertySubcomponent(const Component* component)
             SimTK::ReferencePtr<Component>(const_cast<Component*>(component)));
     }
     else{
-        auto compPath = component->getAbsolutePathName();
-        auto foundPath = it->get()->getAbsolutePathName();
         OPENSIM_THROW( ComponentAlreadyPartOfOwnershipTree,
                        component->getName(), getName());
     }
@@ -1150,19 +1495,6 @@ void Component::adoptSubcomponent(Component* subcomponent)
         ComponentAlreadyPartOfOwnershipTree,
         subcomponent->getName(), this->getName());
 
-    //get the top-level component
-    const Component* top = this;
-    while (top->hasParent())
-        top = &top->getParent();
-
-    // cycle through all components from the top level component
-    // down to verify the component is not already in the tree
-    for (auto& comp : top->getComponentList<Component>()) {
-        OPENSIM_THROW_IF(subcomponent->hasParent(),
-            ComponentAlreadyPartOfOwnershipTree,
-            subcomponent->getName(), comp.getName());
-    }
-
     subcomponent->setParent(*this);
     _adoptedSubcomponents.push_back(SimTK::ClonePtr<Component>(subcomponent));
 }
@@ -1353,10 +1685,21 @@ void Component::extendRealizeTopology(SimTK::State& s) const
         for (it = (mutableThis->_namedCacheVariableInfo).begin(); 
              it != _namedCacheVariableInfo.end(); ++it){
             CacheInfo& ci = it->second;
+            ci.subsystemIndex = subSys.getMySubsystemIndex();
             ci.index = subSys.allocateLazyCacheEntry
                (s, ci.dependsOnStage, ci.prototype->clone());
         }
     }
+
+    // Allocate the Cache Entries of the Outputs that cache their values
+    for (const auto& it : _outputsTable) {
+        const AbstractOutput& output = it.second.getRef();
+        output._cacheIndex.invalidate();
+        if (!output.getValueCaching()) continue;
+        output._cacheSubsystemIndex = subSys.getMySubsystemIndex();
+        output._cacheIndex = subSys.allocateLazyCacheEntry
+            (s, output.getDependsOnStage(), output.createCachePrototype());
+    }
 }
 
 
@@ -1372,7 +1715,11 @@ void Component::extendRealizeAcceleration(const SimTK::State& s) const
         const SimTK::Subsystem& subSys = getDefaultSubsystem();
 
         // evaluate and set component state derivative values (in cache) 
-        computeStateVariableDerivatives(s);
+        {
+            ComponentProfiler::Timer timer(this,
+                    ComponentProfiler::ComputeStateVariableDerivatives);
+            computeStateVariableDerivatives(s);
+        }
     
         std::map<std::string, StateVariableInfo>::const_iterator it;
 
@@ -1464,6 +1811,49 @@ void Component::AddedStateVariable::
 }
 
 
+//------------------------------------------------------------------------------
+//                          STATE VARIABLE HANDLE
+//------------------------------------------------------------------------------
+const Component::StateVariable&
+    Component::StateVariableHandle::getStateVariable() const
+{
+    OPENSIM_THROW_IF(!isValid(), Exception,
+        "Component::StateVariableHandle: the handle does not refer to a state "
+        "variable. Use Component::getStateVariableHandle() to obtain one.");
+    return *_stateVariable;
+}
+
+const std::string& Component::StateVariableHandle::getName() const
+{
+    return getStateVariable().getName();
+}
+
+const Component& Component::StateVariableHandle::getOwner() const
+{
+    return getStateVariable().getOwner();
+}
+
+double Component::StateVariableHandle::
+    getValue(const SimTK::State& state) const
+{
+    return getStateVariable().getValue(state);
+}
+
+void Component::StateVariableHandle::
+    setValue(SimTK::State& state, double value) const
+{
+    getStateVariable().setValue(state, value);
+}
+
+double Component::StateVariableHandle::
+    getDerivative(const SimTK::State& state) const
+{
+    const StateVariable& sv = getStateVariable();
+    sv.getOwner().computeStateVariableDerivatives(state);
+    return sv.getDerivative(state);
+}
+
+
 void Component::dumpSubcomponents(int depth) const
 {
     std::string tabs;
@@ -1525,6 +1915,265 @@ void Component::dumpConnections() const {
 }
 
 
+//=============================================================================
+// COMPONENT REGISTRY
+//=============================================================================
+struct Component::ComponentRegistry {
+    // A subcomponent is found by the position of its parent and its name, so
+    // a path is followed one name at a time without forming path strings.
+    struct ChildKey {
+        int parent;
+        std::string name;
+        bool operator==(const ChildKey& other) const
+        {   return parent == other.parent && name == other.name; }
+    };
+    struct ChildKeyHash {
+        size_t operator()(const ChildKey& key) const
+        {
+            return std::hash<std::string>()(key.name) ^
+                   (std::hash<int>()(key.parent) * 0x9e3779b9);
+        }
+    };
+
+    // All the components of the tree in traversal order, starting with the
+    // root.
+    std::vector<const Component*> components;
+    // One past the position of the last descendant of each component.
+    std::vector<int> subtreeEnds;
+    std::unordered_map<const Component*, int> positions;
+    std::unordered_map<ChildKey, int, ChildKeyHash> children;
+    // The components of each type that a ComponentList was requested for.
+    std::unordered_map<std::type_index,
+                       std::shared_ptr<const ComponentListBucket> > buckets;
+};
+
+const Component& Component::getRoot() const
+{
+    const Component* root = this;
+    while (root->hasParent())
+        root = &root->getParent();
+    return *root;
+}
+
+const Component::ComponentRegistry& Component::getRegistry() const
+{
+    if (!_registry) {
+        _registry.reset(new ComponentRegistry());
+        registerSubcomponents(*_registry, -1);
+    }
+    return *_registry;
+}
+
+void Component::registerSubcomponents(ComponentRegistry& registry,
+                                      int parentPosition) const
+{
+    const int position = (int)registry.components.size();
+    registry.components.push_back(this);
+    registry.subtreeEnds.push_back(position + 1);
+    registry.positions.emplace(this, position);
+    // The first of several components with the same path is the one found
+    // by traversePathToComponent().
+    if (parentPosition >= 0)
+        registry.children.emplace(
+            ComponentRegistry::ChildKey{parentPosition, getName()}, position);
+
+    for (const auto& comp : _memberSubcomponents)
+        comp->registerSubcomponents(registry, position);
+    for (const auto& comp : _propertySubcomponents)
+        comp->registerSubcomponents(registry, position);
+    for (const auto& comp : _adoptedSubcomponents)
+        comp->registerSubcomponents(registry, position);
+
+    registry.subtreeEnds[position] = (int)registry.components.size();
+}
+
+void Component::invalidateRegistry() const
+{
+    const Component& root = getRoot();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    _registry.reset();
+    root._registry.reset();
+}
+
+std::shared_ptr<const ComponentListBucket>
+Component::getRegisteredComponents(const std::type_info& type,
+                                   bool (*isA)(const Component&),
+                                   size_t& first, size_t& last) const
+{
+    const Component& root = getRoot();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    // Only the root builds the registry on demand. Until then (e.g., while
+    // the tree is being finalized) walking a subtree is cheaper than
+    // registering the whole tree.
+    if (!root._registry && &root != this)
+        return nullptr;
+    const ComponentRegistry* registry = &root.getRegistry();
+    auto it = registry->positions.find(this);
+    if (it == registry->positions.end()) {
+        // This component may have joined the tree since the registry was
+        // built.
+        root._registry.reset();
+        registry = &root.getRegistry();
+        it = registry->positions.find(this);
+        if (it == registry->positions.end())
+            return nullptr;
+    }
+
+    auto& bucket = root._registry->buckets[std::type_index(type)];
+    if (!bucket) {
+        auto components = std::make_shared<ComponentListBucket>();
+        for (size_t i = 0; i < registry->components.size(); ++i) {
+            if (isA(*registry->components[i])) {
+                components->components.push_back(registry->components[i]);
+                components->positions.push_back((int)i);
+            }
+        }
+        bucket = components;
+    }
+
+    // The descendants of this component follow it in the traversal; the
+    // component itself is not part of its own list.
+    const std::vector<int>& positions = bucket->positions;
+    const int begin = it->second + 1;
+    const int end = registry->subtreeEnds[it->second];
+    first = std::lower_bound(positions.begin(), positions.end(), begin)
+            - positions.begin();
+    last = std::lower_bound(positions.begin() + first, positions.end(), end)
+           - positions.begin();
+    return bucket;
+}
+
+const Component*
+Component::findRegisteredComponent(const ComponentPath& path) const
+{
+    // Follow the path the way traversePathToComponent() does: ".." goes up
+    // to the parent and a name that is the same as that of the current
+    // component is skipped. Leave to it the paths it treats specially.
+    const size_t numLevels = path.getNumPathLevels();
+    if (numLevels == 0)
+        return nullptr;
+    const std::string nameToFind = path.getComponentName();
+    const Component* base = this;
+    std::vector<std::string> names;
+    for (size_t i = 0; i < numLevels; ++i) {
+        const std::string name = path.getSubcomponentNameAtLevel(i);
+        if (name == "..") {
+            if (!names.empty() || !base->hasParent())
+                return nullptr;
+            base = &base->getParent();
+        }
+        else if (name == (names.empty() ? base->getName() : names.back()))
+            continue;
+        // traversePathToComponent() stops at the first component along the
+        // path that has the name being sought.
+        else if (name == nameToFind && i + 1 < numLevels)
+            return nullptr;
+        else
+            names.push_back(name);
+    }
+    if (names.empty())
+        return nullptr;
+
+    const Component& root = getRoot();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    const ComponentRegistry& registry = root.getRegistry();
+    auto it = registry.positions.find(base);
+    if (it == registry.positions.end())
+        return nullptr;
+    ComponentRegistry::ChildKey key{it->second, std::string()};
+    for (auto& name : names) {
+        key.name.swap(name);
+        auto found = registry.children.find(key);
+        if (found == registry.children.end())
+            return nullptr;
+        // Components may have been renamed since the registry was built.
+        if (registry.components[found->second]->getName() != key.name) {
+            root._registry.reset();
+            return nullptr;
+        }
+        key.parent = found->second;
+    }
+    return registry.components[key.parent];
+}
+
+bool Component::finalizeChangesInSystem()
+{
+    if (!hasSystem() || !isObjectUpToDateWithProperties())
+        return false;
+    Component& root = const_cast<Component&>(getRoot());
+
+    // The changed components, and the ancestors of each within this subtree
+    // along with their positions in the tree.
+    std::vector<Component*> changed;
+    std::vector<std::pair<int, Component*> > ancestors;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        // Without its registry, the tree may have changed since it was
+        // connected.
+        if (!root._registry)
+            return false;
+        const ComponentRegistry& registry = *root._registry;
+        auto it = registry.positions.find(this);
+        if (it == registry.positions.end())
+            return false;
+
+        // The connectees of the whole tree are found by their paths, so none
+        // of the components may have been renamed.
+        for (int i = 1; i < (int)registry.components.size(); ++i) {
+            const Component& comp = *registry.components[i];
+            auto parent = registry.positions.find(&comp.getParent());
+            if (parent == registry.positions.end())
+                return false;
+            auto found = registry.children.find(
+                ComponentRegistry::ChildKey{parent->second, comp.getName()});
+            if (found == registry.children.end() || found->second != i)
+                return false;
+        }
+
+        for (int i = it->second + 1; i < registry.subtreeEnds[it->second];
+                ++i) {
+            Component* comp = const_cast<Component*>(registry.components[i]);
+            if (comp->isObjectUpToDateWithProperties())
+                continue;
+            if (!comp->canFinalizeInSystem() || !comp->hasSystem() ||
+                    &comp->getSystem() != &getSystem())
+                return false;
+            changed.push_back(comp);
+            Component* ancestor = comp;
+            do {
+                ancestor = const_cast<Component*>(&ancestor->getParent());
+                ancestors.emplace_back(registry.positions.at(ancestor),
+                                       ancestor);
+            } while (ancestor != this);
+        }
+    }
+    if (changed.empty())
+        return false;
+
+    for (auto comp : changed)
+        comp->finalizeInSystem(root);
+
+    // Descendants follow their ancestors in the traversal of the tree.
+    std::sort(ancestors.begin(), ancestors.end(),
+        [](const std::pair<int, Component*>& a,
+           const std::pair<int, Component*>& b) { return a.first > b.first; });
+    ancestors.erase(std::unique(ancestors.begin(), ancestors.end()),
+                    ancestors.end());
+    for (auto& ancestor : ancestors)
+        ancestor.second->extendFinalizeChangesInSystem();
+    return true;
+}
+
+void Component::finalizeInSystem(Component& root)
+{
+    finalizeSocketsInputsOutputs();
+    extendFinalizeFromProperties();
+    connectSocketsAndInputs(root);
+    extendConnect(root);
+    setObjectIsUpToDateWithProperties();
+}
+
+
 void Component::initComponentTreeTraversal(const Component &root) const {
     // Going down the tree, node is followed by all its
     // children in order, last child's successor is the parent's successor.
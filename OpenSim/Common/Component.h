@@ -50,12 +50,16 @@
 #include "ComponentList.h"
 #include "ComponentPath.h"
 #include <functional>
+#include <memory>
+#include <typeinfo>
+#include <unordered_set>
 
 #include "simbody/internal/MultibodySystem.h"
 
 namespace OpenSim {
 
 class ModelDisplayHints;
+template <class T> class CacheVariable;
 
 
 //==============================================================================
@@ -389,6 +393,23 @@ public:
         of a tree of components.*/
     void finalizeConnections(Component& root);
 
+    /** Finalize from their properties, and connect again, only the
+        components of this Component's subtree whose properties changed since
+        they were last finalized (see Object::isObjectUpToDateWithProperties()),
+        keeping the System to which they were added, rather than the whole
+        tree. Each changed component is finalized alone, its subcomponents
+        untouched, so it must allow this (see canFinalizeInSystem()); then
+        extendFinalizeChangesInSystem() is invoked on its ancestors within this
+        subtree so they can update what they derive from it. This lets, e.g.,
+        the location of one path point be edited without finalizing and
+        building the whole Model again.
+        @returns false, having finalized nothing, unless this Component was
+        added to a System and is up to date with its properties, the tree is
+        unchanged since it was connected, and every changed component can be
+        finalized in the System; or if nothing changed. The tree must then be
+        finalized, connected and added to a new System as usual. */
+    bool finalizeChangesInSystem();
+
     /** Disconnect/clear this Component from its aggregate component. Empties 
         all component's sockets and sets them as disconnected.*/
     void clearConnections();
@@ -518,13 +539,19 @@ public:
      * The returned ComponentList does not permit modifying any components; if
      * you want to modify the components, see updComponentList().
      *
+     * The components are taken from a registry kept by the root of the tree,
+     * which lists all the components in traversal order and, for each type
+     * that has been asked for, those of that type. Iterating a list therefore
+     * only visits the components of type T. The registry is built by
+     * finalizeConnections() (or by asking the root for a list) and is dropped
+     * whenever the tree changes, i.e., by finalizeFromProperties().
+     *
      * @tparam T A subclass of Component (e.g., Body, Muscle).
      */
     template <typename T = Component>
     ComponentList<const T> getComponentList() const {
         static_assert(std::is_base_of<Component, T>::value,
                 "Template argument must be Component or a derived class.");
-        initComponentTreeTraversal(*this);
         return ComponentList<const T>(*this);
     }
     
@@ -547,7 +574,6 @@ public:
     ComponentList<T> updComponentList() {
         static_assert(std::is_base_of<Component, T>::value,
                 "Template argument must be Component or a derived class.");
-        initComponentTreeTraversal(*this);
         return ComponentList<T>(*this);
     }
 
@@ -698,6 +724,53 @@ public:
      * @returns The number of matches. */
     unsigned printComponentsMatching(const std::string& substring) const;
 
+#ifndef SWIG
+    /** An estimate, in bytes, of the memory held by a Component, not
+     * counting its subcomponents. Only the heap memory of strings, containers
+     * and property values is counted, along with the size of the Component
+     * class itself; the memory of the underlying Simbody System is not. */
+    struct MemoryFootprint {
+        size_t object = 0;      ///< The Component class itself.
+        size_t strings = 0;     ///< Name, description, authors, references.
+        /** Property names and values, and the Objects within properties
+         * that are not Components (e.g., Functions). */
+        size_t properties = 0;
+        size_t connectors = 0;  ///< Sockets, inputs and outputs.
+        /** Information about state, discrete and cache variables and
+         * modeling options. */
+        size_t variables = 0;
+        size_t document = 0;    ///< XML elements kept from a file.
+        size_t total() const {
+            return object + strings + properties + connectors + variables +
+                   document;
+        }
+        MemoryFootprint& operator+=(const MemoryFootprint& other) {
+            object += other.object;
+            strings += other.strings;
+            properties += other.properties;
+            connectors += other.connectors;
+            variables += other.variables;
+            document += other.document;
+            return *this;
+        }
+    };
+
+    /** Estimate the memory held by this Component, not counting its
+     * subcomponents.
+     * @see printMemoryFootprint() */
+    MemoryFootprint estimateMemoryFootprint() const;
+#endif
+
+    /** Print to the console an estimate of the memory held by this Component
+     * and its subcomponents, broken down by the concrete class of the
+     * components and by what holds the memory (see MemoryFootprint). The
+     * subcomponents are those found by getComponentList(), so this must be
+     * called after finalizeFromProperties(). Use Object's
+     * releaseDocumentElements() to free the XML elements kept from a file.
+     *
+     * @returns The estimated total, in bytes. */
+    size_t printMemoryFootprint() const;
+
     /**
      * Get the number of "continuous" state variables maintained by the
      * Component and its subcomponents.
@@ -708,7 +781,8 @@ public:
 
     /**
      * Get the names of "continuous" state variables maintained by the Component
-     * and its subcomponents.
+     * and its subcomponents. The names are collected once for each System the
+     * Component is added to (e.g., by initSystem()) and then kept.
      * @throws ComponentHasNoSystem if this Component has not been added to a
      *         System (i.e., if initSystem has not been called)
      */
@@ -1173,10 +1247,38 @@ public:
      */
     SimTK::Vector getStateVariableValues(const SimTK::State& state) const;
 
+    /**
+     * Get all values of the state variables allocated by this Component and
+     * its subcomponents into the given Vector, which is resized only if it
+     * does not already have one element per state variable. Call this at
+     * every step or row of a simulation to avoid allocating a new Vector each
+     * time.
+     *
+     * The values of state variables that are stored in the State's Y vector
+     * (e.g., the values and speeds of Coordinates, and the variables added by
+     * addStateVariable()) are gathered straight from it, through a map from
+     * the order of getStateVariableNames() to Y that is made once for each
+     * System and layout of Y.
+     *
+     * @param state   the State for which to get the values
+     * @param values  the values, in the order returned by
+     *                getStateVariableNames()
+     * @throws ComponentHasNoSystem if this Component has not been added to a
+     *         System (i.e., if initSystem has not been called)
+     */
+    void getStateVariableValues(const SimTK::State& state,
+                                SimTK::Vector& values) const;
+
     /**
      * %Set all values of the state variables allocated by this Component.
      * Includes state variables allocated by its subcomponents.
      *
+     * The values of state variables that are stored in the State's Y vector
+     * are written straight to it, as with SimTK::State::updY(). In
+     * particular, Coordinate values are not clamped to their range or held
+     * at their locked value, and constraints are not enforced; assemble the
+     * model afterwards if needed.
+     *
      * @param state   the State for which to get the value
      * @param values  Vector of state variable values of length
      *                getNumStateVariables() in the order returned by
@@ -1187,6 +1289,38 @@ public:
     void setStateVariableValues(SimTK::State& state,
                                 const SimTK::Vector& values) const;
 
+    /**
+     * Get the index in the State's Y vector of each state variable allocated
+     * by this Component and its subcomponents, in the order returned by
+     * getStateVariableNames(), or -1 for a state variable whose value is not
+     * stored in Y.
+     *
+     * @param state   a State realized to at least Stage::Model
+     * @throws ComponentHasNoSystem if this Component has not been added to a
+     *         System (i.e., if initSystem has not been called)
+     */
+    SimTK::Array_<int> getStateVariableYIndices(
+            const SimTK::State& state) const;
+
+    class StateVariableHandle;
+
+    /**
+     * Get a handle to a state variable allocated by this Component or its
+     * subcomponents, for reading and writing its value repeatedly without
+     * looking it up by name each time. The name may include the path to the
+     * subcomponent that allocates the state variable, as in
+     * getStateVariableNames().
+     *
+     * The handle remains valid until the System is rebuilt (e.g., by calling
+     * initSystem() again).
+     *
+     * @param name   the name of the state variable
+     * @return a handle to the state variable
+     * @throws ComponentHasNoSystem if this Component has not been added to a
+     *         System (i.e., if initSystem has not been called)
+     */
+    StateVariableHandle getStateVariableHandle(const std::string& name) const;
+
     /**
      * Get the value of a state variable derivative computed by this Component.
      *
@@ -1603,8 +1737,34 @@ protected:
     @endcode   */
     virtual void extendConnect(Component& root) {};
 
+    /** Whether a change to the properties of this Component takes effect by
+    finalizing and connecting it alone, within the System to which it was
+    already added (see finalizeChangesInSystem()). Return true only if
+    extendFinalizeFromProperties() and extendConnect() neither add nor
+    remove subcomponents and if what extendAddToSystem() adds to the System
+    (Simbody elements, state and cache variables) does not depend on the
+    values of the properties. False by default. */
+    virtual bool canFinalizeInSystem() const { return false; }
+
+    /** Update, within the System, what this Component derives from its
+    descendants after some of them were finalized again by
+    finalizeChangesInSystem(). It is invoked on each ancestor of the changed
+    components, descendants before their ancestors, once all of them are
+    finalized and connected.
+
+    If you override this method, be sure to invoke the base class method
+    first, using code like this:
+    @code
+    void MyComponent::extendFinalizeChangesInSystem() {
+        Super::extendFinalizeChangesInSystem(); // invoke parent class method
+        // ... your code goes here
+    }
+    @endcode   */
+    virtual void extendFinalizeChangesInSystem() {};
+
     /** Build the tree of Components from this component through its descendants. 
-    This method is invoked whenever a ComponentList<C> is requested. Note, all
+    This method is invoked when a ComponentList<C> is iterated and its root is
+    not in the registry of its tree (see getComponentList()). Note, all
     components must been added to the model (or its subcomponents), otherwise it
     will not be included in the tree and will not be found for iteration or for
     connection. The implementation populates _nextComponent ReferencePtr with a
@@ -1943,16 +2103,22 @@ protected:
     @param[in]      dependsOnStage      
         This is the highest computational stage on which this cache entry's
         value computation depends. State changes at this level or lower will
-        invalidate the cache entry. **/ 
-    template <class T> void 
+        invalidate the cache entry.
+    @return
+        A handle to the cache variable that accesses its value without looking
+        it up by name. The handle is only valid for the System created by the
+        call to addToSystem() in which it was returned, so store it in a
+        member that is set in extendAddToSystem() (see CacheVariable). **/ 
+    template <class T> CacheVariable<T>
     addCacheVariable(const std::string&     cacheVariableName,
                      const T&               variablePrototype, 
                      SimTK::Stage           dependsOnStage) const
     {
         // Note, cache index is invalid until the actual allocation occurs 
         // during realizeTopology.
-        _namedCacheVariableInfo[cacheVariableName] = 
-            CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+        CacheInfo& info = _namedCacheVariableInfo[cacheVariableName];
+        info = CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+        return CacheVariable<T>(&info);
     }
 
     
@@ -1997,6 +2163,8 @@ protected:
 #pragma clang diagnostic ignored "-Wunsupported-friend"
     template<class C>
     friend void Socket<C>::findAndConnect(const Component& root);
+    template<class T>
+    friend void Input<T>::findAndConnect(const Component& root);
 #pragma clang diagnostic pop
 
     /** Utility method to find a component in the list of sub components of this
@@ -2046,13 +2214,13 @@ protected:
         }
 
         ComponentList<const C> compsList = this->template getComponentList<C>();
+        // if a child of this Component, one should not need
+        // to specify this Component's absolute path name
+        ComponentPath thisAbsPathPlusSubname(thisAbsPath);
+        thisAbsPathPlusSubname.pushBack(subname);
         
         for (const C& comp : compsList) {
-            // if a child of this Component, one should not need
-            // to specify this Component's absolute path name
             ComponentPath compAbsPath(comp.getAbsolutePathName());
-            ComponentPath thisAbsPathPlusSubname(getAbsolutePathName());
-            thisAbsPathPlusSubname.pushBack(subname);
             if (compAbsPath == thisAbsPathPlusSubname) {
                 foundCs.push_back(&comp);
                 break;
@@ -2132,8 +2300,21 @@ protected:
     template<class C>
     const C* traversePathToComponent(const std::string& path) const
     {
+        return traversePathToComponent<C>(ComponentPath(path));
+    }
+
+    /** Same as above, for a path that has already been parsed; used
+        internally to avoid parsing a connectee's path again. */
+    template<class C>
+    const C* traversePathToComponent(const ComponentPath& pathToFind) const
+    {
+        // Most paths can be looked up directly in the registry of the tree.
+        if (const Component* comp = findRegisteredComponent(pathToFind)) {
+            if (const C* compC = dynamic_cast<const C*>(comp))
+                return compC;
+        }
+
         const Component* current = this;
-        ComponentPath pathToFind(path);
         std::string pathNameToFind = pathToFind.getComponentName();
         size_t numPathLevels = pathToFind.getNumPathLevels();
         size_t ind = 0;
@@ -2389,8 +2570,11 @@ private:
     void markPropertiesAsSubcomponents();
 
     // Internal use: mark as a subcomponent, a component that is owned by this 
-    // Component by virtue of being one of its properties.
-    void markAsPropertySubcomponent(const Component* subcomponent);
+    // Component by virtue of being one of its properties. The components
+    // marked so far are tracked in marked, so that a component that is
+    // marked twice is detected without searching the list.
+    void markAsPropertySubcomponent(const Component* subcomponent,
+            std::unordered_set<const Component*>& marked);
 
     /// Invoke finalizeFromProperties() on the (sub)components of this Component.
     void componentsFinalizeFromProperties() const;
@@ -2398,6 +2582,18 @@ private:
     /// Invoke connect() on the (sub)components of this Component.
     void componentsConnect(Component& root);
 
+    // Point the Sockets, Inputs and Outputs of this Component at it and check
+    // the connectee names of the Sockets and Inputs.
+    void finalizeSocketsInputsOutputs();
+
+    // Connect the Sockets and Inputs of this Component to their connectees
+    // in the tree of the given root.
+    void connectSocketsAndInputs(Component& root);
+
+    // Finalize this Component alone from its properties and connect it
+    // again, keeping its subcomponents and what it added to the System.
+    void finalizeInSystem(Component& root);
+
     /// Base Component must create underlying resources in computational System.
     void baseAddToSystem(SimTK::MultibodySystem& system) const;
 
@@ -2559,6 +2755,7 @@ protected:
     /// form the ordered list using setNextSubcomponentInSystem() above.
     void resetSubcomponentOrder() {
         _orderedSubcomponents.clear();
+        _orderedSubcomponentSet.clear();
     }
 
     /// Handle a change in XML syntax for Sockets.
@@ -2573,6 +2770,35 @@ private:
     // Reference pointer to the successor of the current Component in Pre-order traversal
     mutable SimTK::ReferencePtr<const Component> _nextComponent;
 
+    // Registry of all the components of the tree of which this Component is
+    // the root, built when first needed and dropped whenever the tree changes.
+    struct ComponentRegistry;
+    mutable SimTK::ResetOnCopy<std::shared_ptr<ComponentRegistry> > _registry;
+
+    // The root of the tree to which this Component belongs.
+    const Component& getRoot() const;
+    // Build the registry if it is not up to date; the caller must hold the
+    // lock on the registries.
+    const ComponentRegistry& getRegistry() const;
+    // Append this Component and its descendants to the registry; the parent
+    // is at the given position in it (-1 for the root).
+    void registerSubcomponents(ComponentRegistry& registry,
+                               int parentPosition) const;
+    // Drop the registry of the tree to which this Component belongs.
+    void invalidateRegistry() const;
+    // The components of the tree that satisfy isA; those in [first, last) are
+    // descendants of this Component. Returns null if this Component is not
+    // in the registry of its tree, or if the registry has not been built and
+    // this Component is not the root.
+    std::shared_ptr<const ComponentListBucket> getRegisteredComponents(
+            const std::type_info& type, bool (*isA)(const Component&),
+            size_t& first, size_t& last) const;
+    // Look up the component at the given path directly in the registry,
+    // building it if needed. Returns null for paths that
+    // traversePathToComponent() must resolve itself, including those of
+    // components that do not exist.
+    const Component* findRegisteredComponent(const ComponentPath& path) const;
+
     // Reference pointer to the system that this component belongs to.
     SimTK::ReferencePtr<SimTK::MultibodySystem> _system;
 
@@ -2614,6 +2840,9 @@ private:
     // If the Component does not reset the list, it is by default the ownership
     // tree order of its subcomponents.
     mutable std::vector<SimTK::ReferencePtr<const Component> > _orderedSubcomponents;
+    // The same components, for checking whether one is already in the list.
+    mutable SimTK::ResetOnCopy<std::unordered_set<const Component*> >
+        _orderedSubcomponentSet;
 
     // Structure to hold modeling option information. Modeling options are
     // integers 0..maxOptionValue. At run time we keep them in a Simbody
@@ -2698,6 +2927,9 @@ private:
         SimTK::DiscreteVariableIndex    index;
     };
 
+    // Give the CacheVariable handles access to the indices of their entries.
+    template <class T> friend class CacheVariable;
+
     // Structure to hold related info about cache variables 
     struct CacheInfo {
         CacheInfo() {}
@@ -2708,6 +2940,7 @@ private:
         SimTK::ClonePtr<SimTK::AbstractValue>   prototype;
         SimTK::Stage                            dependsOnStage;
         // System
+        SimTK::SubsystemIndex                   subsystemIndex;
         SimTK::CacheEntryIndex                  index;
     };
 
@@ -2735,12 +2968,29 @@ private:
     // cache information.
     mutable std::map<std::string, CacheInfo>            _namedCacheVariableInfo;
 
+    // Collect the names of the state variables of this Component and its
+    // subcomponents by walking the subtree.
+    Array<std::string> computeStateVariableNames() const;
     // Check that the list of _allStateVariables is valid
     bool isAllStatesVariablesListValid() const;
+    // Rebuild the list of _allStateVariables if it is not valid
+    const SimTK::Array_<SimTK::ReferencePtr<const StateVariable> >&
+        getAllStateVariables() const;
+    // Remake _allStateVariableYIndices if the numbers of q's, u's and z's of
+    // the state differ from those it was made for. Returns nullptr if the
+    // state is not yet realized to Stage::Model, when Y is not allocated.
+    const int* getAllStateVariableYIndices(const SimTK::State& state) const;
 
     // Array of all state variables for fast access during simulation
     mutable SimTK::Array_<SimTK::ReferencePtr<const StateVariable> > 
                                                             _allStateVariables;
+    // The names of _allStateVariables, in the same order
+    mutable Array<std::string> _allStateVariableNames;
+    // The index in Y of each of _allStateVariables, or -1 if its value is not
+    // stored in Y as is, and the numbers of q's, u's and z's of the State
+    // the indices were found in.
+    mutable SimTK::Array_<int> _allStateVariableYIndices;
+    mutable SimTK::Array_<int> _allStateVariablesYLayout;
     // A handle the System associated with the above state variables
     mutable SimTK::ReferencePtr<const SimTK::System> _statesAssociatedSystem;
 
@@ -2748,14 +2998,178 @@ private:
 };  // END of class Component
 //==============================================================================
 //==============================================================================
+
+//==============================================================================
+//                          STATE VARIABLE HANDLE
+//==============================================================================
+/**
+ * A handle to a state variable of a Component, as returned by
+ * Component::getStateVariableHandle(). The name of the state variable is
+ * resolved once, when the handle is created, so getting and setting the value
+ * through the handle costs the same as through the state variable itself:
+ * @code
+ * const auto knee = model.getStateVariableHandle("knee/knee_angle/value");
+ * for (auto& state : states)
+ *     knee.setValue(state, 0.5);
+ * @endcode
+ */
+class OSIMCOMMON_API Component::StateVariableHandle {
+public:
+    /** An empty handle that does not refer to any state variable. */
+    StateVariableHandle() = default;
+
+    /** Whether the handle refers to a state variable. */
+    bool isValid() const { return _stateVariable != nullptr; }
+
+    /** The name of the state variable within the Component that allocated
+    it. */
+    const std::string& getName() const;
+
+    /** The Component that allocated the state variable. */
+    const Component& getOwner() const;
+
+    /** Get the value of the state variable. */
+    double getValue(const SimTK::State& state) const;
+    /** %Set the value of the state variable. */
+    void setValue(SimTK::State& state, double value) const;
+    /** Get the derivative of the state variable. */
+    double getDerivative(const SimTK::State& state) const;
+
+private:
+    friend class Component;
+    explicit StateVariableHandle(const StateVariable& stateVariable)
+    :   _stateVariable(&stateVariable) {}
+
+    const StateVariable& getStateVariable() const;
+
+    const StateVariable* _stateVariable = nullptr;
+};
+
+//==============================================================================
+//                             CACHE VARIABLE
+//==============================================================================
+/**
+ * A typed handle to a cache variable allocated by a Component, as returned by
+ * Component::addCacheVariable(). Accessing the value through the handle goes
+ * straight to the cache entry in the State, without looking up the cache
+ * variable by name as the string-based accessors of Component
+ * (e.g., getCacheVariableValue()) must.
+ *
+ * A handle refers to the cache variable of the Component that created it, for
+ * the System made by the addToSystem() call in which it was created. Store it
+ * in a member of the Component that is set in extendAddToSystem(), wrapped in a
+ * SimTK::ResetOnCopy so that a copy of the Component does not refer to the
+ * cache variables of the original:
+ * @code
+ * void MyComponent::extendAddToSystem(SimTK::MultibodySystem& system) const {
+ *     Super::extendAddToSystem(system);
+ *     _lengthCV = addCacheVariable("length", 0.0, SimTK::Stage::Position);
+ * }
+ * ...
+ * mutable SimTK::ResetOnCopy<CacheVariable<double>> _lengthCV;
+ * @endcode
+ * The entry is allocated when the System is realized to Stage::Topology
+ * (e.g., by Model::initSystem()); until then, the accessors throw.
+ */
+template <class T>
+class CacheVariable {
+public:
+    /** An empty handle that does not refer to any cache variable. */
+    CacheVariable() = default;
+
+    /** Whether the handle refers to a cache variable that has been allocated
+    in the State. */
+    bool isAllocated() const
+    {   return _info && _info->index.isValid(); }
+
+    /** Get the value of the cache variable. */
+    const T& getValue(const SimTK::State& state) const
+    {
+        checkAllocated();
+        return SimTK::Value<T>::downcast(
+            state.getCacheEntry(_info->subsystemIndex, _info->index)).get();
+    }
+
+    /** Obtain a writable reference to the value of the cache variable. Mark
+    the value as valid (markValid()) after updating it. */
+    T& updValue(const SimTK::State& state) const
+    {
+        checkAllocated();
+        return SimTK::Value<T>::downcast(
+            state.updCacheEntry(_info->subsystemIndex, _info->index)).upd();
+    }
+
+    /** %Set the value of the cache variable and mark it as valid. */
+    void setValue(const SimTK::State& state, const T& value) const
+    {
+        updValue(state) = value;
+        state.markCacheValueRealized(_info->subsystemIndex, _info->index);
+    }
+
+    /** Mark the value of the cache variable as valid.
+    @see Component::markCacheVariableValid() */
+    void markValid(const SimTK::State& state) const
+    {
+        checkAllocated();
+        state.markCacheValueRealized(_info->subsystemIndex, _info->index);
+    }
+
+    /** Mark the value of the cache variable as invalid.
+    @see Component::markCacheVariableInvalid() */
+    void markInvalid(const SimTK::State& state) const
+    {
+        checkAllocated();
+        state.markCacheValueNotRealized(_info->subsystemIndex, _info->index);
+    }
+
+    /** Whether the value of the cache variable is valid.
+    @see Component::isCacheVariableValid() */
+    bool isValid(const SimTK::State& state) const
+    {
+        checkAllocated();
+        return state.isCacheValueRealized(_info->subsystemIndex, _info->index);
+    }
+
+private:
+    friend class Component;
+    explicit CacheVariable(const Component::CacheInfo* info) : _info(info) {}
+
+    void checkAllocated() const
+    {
+        OPENSIM_THROW_IF(!isAllocated(), Exception,
+            "CacheVariable: the cache variable has not been allocated. "
+            "You must call initSystem on the top-level Component "
+            "(i.e., Model) first.");
+    }
+
+    // The entry of the owning Component's map of cache variables, which holds
+    // the indices of the cache entry once it has been allocated.
+    const Component::CacheInfo* _info = nullptr;
+};
     
-// Implement methods for ComponentListIterator
+// Implement methods for ComponentList and ComponentListIterator
+template <typename T>
+void ComponentList<T>::findComponents() const {
+    typedef typename std::remove_const<T>::type NonConstT;
+    _components = _root.getRegisteredComponents(typeid(NonConstT),
+        [](const Component& comp) {
+            return dynamic_cast<const NonConstT*>(&comp) != nullptr;
+        }, _first, _last);
+    if (!_components)
+        _root.initComponentTreeTraversal(_root);
+}
+
 /// ComponentListIterator<T> pre-increment operator, advances the iterator to
 /// the next valid entry.
 template <typename T>
 ComponentListIterator<T>& ComponentListIterator<T>::operator++() {
     if (_node==nullptr)
         return *this;
+    if (_bucket) {
+        ++_index;
+        advanceToNextValidComponent();
+        return *this;
+    }
     // If _node has children then successor is first child
     // move _node to point to it
     if (_node->_memberSubcomponents.size() > 0) {
@@ -2780,6 +3194,13 @@ ComponentListIterator<T>& ComponentListIterator<T>::operator++() {
 /// Internal method to advance iterator to next valid component.
 template <typename T>
 void ComponentListIterator<T>::advanceToNextValidComponent() {
+    if (_bucket) {
+        // The bucket holds only components of type T under _root.
+        while (_index < _last && !_filter.isMatch(*_bucket->components[_index]))
+            ++_index;
+        _node = _index < _last ? _bucket->components[_index] : nullptr;
+        return;
+    }
     // Advance _node to next valid (of type T) if needed
     // Similar logic to operator++ but applies _filter->isMatch()
     while (_node != nullptr && (dynamic_cast<const T*>(_node) == nullptr || 
@@ -2810,17 +3231,11 @@ template<class C>
 void Socket<C>::findAndConnect(const Component& root) {
  
     ComponentPath path(getConnecteeName());
-    const C* comp = nullptr;
-
-    try {
-        if (path.isAbsolute()) {
-            comp =  &root.template getComponent<C>(path.toString());
-        }
-        else {
-            comp =  &getOwner().template getComponent<C>(path.toString());
-        }
-    }
-    catch (const ComponentNotFoundOnSpecifiedPath&) {
+    // Parse the connectee name once and look up the parsed path.
+    const C* comp = path.isAbsolute() ?
+            root.template traversePathToComponent<C>(path) :
+            getOwner().template traversePathToComponent<C>(path);
+    if (!comp) {
         // TODO leave out for hackathon std::cout << ex.getMessage() << std::endl;
         comp =  root.template findComponent<C>(path.toString());
     }
@@ -2941,25 +3356,20 @@ void Input<T>::findAndConnect(const Component& root) {
         parseConnecteeName(getConnecteeName(ix),
                            compPathStr, outputName, channelName, alias);
         ComponentPath compPath(compPathStr);
+        const Component& base = compPath.isAbsolute() ? root : getOwner();
         const AbstractOutput* output = nullptr;
 
-        if (compPath.isAbsolute()) { //absolute path string
-            if (compPathStr.empty()) {
-                output = &root.getOutput(outputName);
-            }
-            else {
-                output = &root.getComponent(compPathStr).getOutput(outputName);
-            }
+        if (compPathStr.empty()) {
+            output = &base.getOutput(outputName);
         }
-
-        else { // relative path string
-            if (compPathStr.empty()) {
-                output = &getOwner().getOutput(outputName);
-            }
-            else {
-                output = &getOwner().getComponent(compPathStr).getOutput(outputName);
-            }
-            
+        else {
+            // Look up the parsed path rather than parsing it again.
+            const Component* comp =
+                base.template traversePathToComponent<Component>(compPath);
+            OPENSIM_THROW_IF(comp == nullptr,
+                             ComponentNotFoundOnSpecifiedPath, compPathStr,
+                             Component::getClassName(), base.getName());
+            output = &comp->getOutput(outputName);
         }
         const auto& channel = output->getChannel(channelName);
         connect(channel, alias);
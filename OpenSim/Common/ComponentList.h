@@ -26,8 +26,10 @@
 
 // INCLUDES
 #include <OpenSim/Common/osimCommonDLL.h>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 #include "SimTKcommon/basics.h"
 
 namespace OpenSim {
@@ -35,6 +37,15 @@ namespace OpenSim {
 class Component;
 
 template <typename T> class ComponentListIterator;
+
+/** @internal The components of one type in a tree of components, in the
+order of the tree traversal. The registry of the root of the tree keeps one of
+these for each type that a ComponentList has been requested for. */
+struct ComponentListBucket {
+    std::vector<const Component*> components;
+    // Position of each of the components in the traversal of the whole tree.
+    std::vector<int> positions;
+};
 //==============================================================================
 //                            OPENSIM ComponentList
 //==============================================================================
@@ -103,10 +114,12 @@ iterator pointing to the first entry in the list then increment the iterator
 until end(). 
 The linked list is formed by tree pre-order traversal where each component is 
 visited followed by all its immediate subcomponents (recursively).
-@internal The traversal order is wired via
-    Component::initComponentTreeTraversal(), which is called just before
-    getting a ComponentList from a Component, either via
-    Component::getComponentList() or Component::updComponentList().
+@internal The list is taken from the registry of the root of the tree, which
+    holds all the components of the tree in traversal order and buckets them by
+    type, so iterating does not visit (or cast) any component that is not a T.
+    If the root component of the list is not in the registry of its tree, the
+    iterator instead walks the tree as wired by
+    Component::initComponentTreeTraversal().
 */
 template <typename T>
 class ComponentList {
@@ -153,17 +166,19 @@ public:
     to the ComponentList constructor. If T is non-const, then this iterator
     allows you to modify the elements of this list. */
     iterator begin() {
-        return iterator(&_root, _filter.getRef());
+        findComponents();
+        return iterator(&_root, _filter.getRef(), _components.get(),
+                        _first, _last);
     }
     /** Same as cbegin(). */
-    const_iterator begin() const {
-        return const_iterator(&_root, _filter.getRef());
-    }
+    const_iterator begin() const { return cbegin(); }
     /** Similar to begin(), except it does not permit
     modifying the elements of the list, even if T is non-const (e.g., 
     ComponentList<Body>). */
     const_iterator cbegin() const {
-        return const_iterator(&_root, _filter.getRef());
+        findComponents();
+        return const_iterator(&_root, _filter.getRef(), _components.get(),
+                              _first, _last);
     }
     /** Use this method to check if you have reached the end of the list.
     This points past the end of the list, *not* to the last item in the
@@ -190,6 +205,14 @@ private:
     // Internal method to setFilter to ComponentFilterMatchAll if no user specified
     // filter is provided.
     void setDefaultFilter() { setFilter(ComponentFilterMatchAll()); }
+    // Look up the components of type T under _root in the registry of the
+    // tree (defined in Component.h).
+    void findComponents() const;
+    // The components of type T in the tree; those in [_first, _last) are
+    // under _root. Null if _root is not in the registry.
+    mutable std::shared_ptr<const ComponentListBucket> _components;
+    mutable size_t _first = 0;
+    mutable size_t _last = 0;
 };
 
 //==============================================================================
@@ -288,8 +311,10 @@ public:
     // The const cast is required for the case when T is not const. In the
     // case where T is const, it is okay that we do the const cast,
     // since the return type is still const.
+    // The iterator only ever stops at components of type T, so there is no
+    // need for a dynamic_cast.
     T* operator->() const
-    { return const_cast<NonConstT*>(dynamic_cast<const T*>(_node)); }
+    { return const_cast<NonConstT*>(static_cast<const T*>(_node)); }
     
     /** Prefix increment operator to get the next item in the ComponentList.
      Prefer to use ++iter and not iter++. */
@@ -328,7 +353,10 @@ public:
         typename std::enable_if<std::is_convertible<FromT*, T*>::value>::type* = 0) :
         _node(source._node),
         _root(source._root),
-        _filter(source._filter)
+        _filter(source._filter),
+        _bucket(source._bucket),
+        _index(source._index),
+        _last(source._last)
     {/*No need to advanceToNextValid; was done when source was constructed.*/}
     
     /** @internal ComponentListIterator<const T> needs access to the members
@@ -353,16 +381,28 @@ private:
     /** Optional filter to further select Components under _root, defaults to
     Filter by type. */
     const ComponentFilter& _filter;
+    /** Components of type T taken from the registry of the tree, if any; the
+    iterator steps through those in [_index, _last) instead of walking the
+    tree. */
+    const ComponentListBucket* _bucket;
+    size_t _index;
+    size_t _last;
     
     /** Constructor that takes a Component and ComponentFilter.
      The iterator contains a const ref to filter and doesn't take ownership
      of it. A pointer is used since iterator at end() doesn't have a valid
-     Component underneath it. */
+     Component underneath it. If a bucket is given, the iterator goes through
+     its components in [first, last) instead of the subtree of node. */
     ComponentListIterator(const Component* node,
-                          const ComponentFilter& filter) :
+                          const ComponentFilter& filter,
+                          const ComponentListBucket* bucket = nullptr,
+                          size_t first = 0, size_t last = 0) :
         _node(node),
         _root(*node),
-        _filter(filter) {
+        _filter(filter),
+        _bucket(bucket),
+        _index(first),
+        _last(last) {
         advanceToNextValidComponent(); // in case node is not a match.
     }
 }; // end of ComponentListIterator
@@ -31,11 +31,13 @@
  */
 
 // INCLUDES
+#include "ComponentProfiler.h"
 #include "Exception.h"
 
 #include <functional>
 #include <map>
 
+#include <SimTKcommon/internal/ResetOnCopy.h>
 #include <SimTKcommon/internal/Stage.h>
 #include <SimTKcommon/internal/State.h>
 
@@ -142,6 +144,30 @@ public:
     void         setNumberOfSignificantDigits(unsigned int numSigFigs) 
     { _numSigFigs = numSigFigs; }
 
+    /** Whether this Output keeps its value in the State, so that it is
+    computed only once each time the stage it depends on is realized, however
+    many times it is read (e.g., by several Inputs or Reporters). This is off
+    by default and only worthwhile for Outputs that are costly to compute.
+    Turn it on before calling initSystem(), since the value is kept in a cache
+    entry allocated at that time.
+
+    @warning The cached value is recomputed only after a change to the State
+    invalidates the stage the Output depends on, so only cache Outputs whose
+    value does not depend on any variable of a later stage. For example, an
+    Output that depends on the Position stage but returns a velocity would
+    keep returning the velocity it had when it was first read. */
+    void setValueCaching(bool cacheValue) {
+        OPENSIM_THROW_IF(cacheValue && isListOutput(), Exception,
+                "Cannot cache the value of list Output '" + name + "'.");
+        OPENSIM_THROW_IF(cacheValue &&
+                dependsOnStage == SimTK::Stage::Infinity, Exception,
+                "Cannot cache the value of Output '" + name +
+                "', which does not depend on a stage.");
+        _valueCaching = cacheValue;
+        if (!cacheValue) _cacheIndex.invalidate();
+    }
+    bool getValueCaching() const { return _valueCaching; }
+
 protected:
 
     // Set the component that contains this Output.
@@ -151,11 +177,23 @@ protected:
 
     SimTK::ReferencePtr<const Component> _owner;
 
+    /** Whether the value is kept in the cache entry of the State given by
+    _cacheSubsystemIndex and _cacheIndex; see setValueCaching(). */
+    bool isValueCached() const { return _cacheIndex.isValid(); }
+
+    // The cache entry allocated for the value when value caching is on.
+    mutable SimTK::ResetOnCopy<SimTK::SubsystemIndex> _cacheSubsystemIndex;
+    mutable SimTK::ResetOnCopy<SimTK::CacheEntryIndex> _cacheIndex;
+
 private:
+    // A value of the type of this Output, for allocating its cache entry.
+    virtual SimTK::AbstractValue* createCachePrototype() const = 0;
+
     std::string name;
     SimTK::Stage dependsOnStage;
     unsigned int _numSigFigs = 8;
     bool _isList = false;
+    bool _valueCaching = false;
 
     // For calling setOwner().
     friend Component;
@@ -283,8 +321,7 @@ public:
                     state.getSystemStage(), getDependsOnStage(),
                     "Output::getValue(state)");
         }
-        _outputFcn(_owner.get(), state, "", _result);
-        return _result;
+        return computeValue(state, "", _result);
     }
     
     std::string getTypeName() const override
@@ -311,6 +348,30 @@ public:
     }
 
 private:
+    SimTK::AbstractValue* createCachePrototype() const override
+    {   return new SimTK::Value<T>(_result); }
+
+    // Compute the value of the given channel into result, or, if the value is
+    // cached, get it from the State, computing it first if it is not valid.
+    const T& computeValue(const SimTK::State& state,
+                          const std::string& channel, T& result) const {
+        using Timer = ComponentProfiler::Timer;
+        if (!isValueCached()) {
+            Timer timer(_owner.get(), ComponentProfiler::ComputeOutput);
+            _outputFcn(_owner.get(), state, channel, result);
+            return result;
+        }
+        if (state.isCacheValueRealized(_cacheSubsystemIndex, _cacheIndex))
+            return SimTK::Value<T>::downcast(state.getCacheEntry(
+                    _cacheSubsystemIndex, _cacheIndex)).get();
+        T& value = SimTK::Value<T>::updDowncast(state.updCacheEntry(
+                _cacheSubsystemIndex, _cacheIndex)).upd();
+        Timer timer(_owner.get(), ComponentProfiler::ComputeOutput);
+        _outputFcn(_owner.get(), state, channel, value);
+        state.markCacheValueRealized(_cacheSubsystemIndex, _cacheIndex);
+        return value;
+    }
+
     mutable T _result;
     std::function<void (const Component*,
                         const SimTK::State&,
@@ -332,8 +393,7 @@ public:
      : _output(output), _channelName(channelName) {}
     const T& getValue(const SimTK::State& state) const {
         // Must cache, since we're returning a reference.
-        _output->_outputFcn(_output->_owner.get(), state, _channelName, _result);
-        return _result;
+        return _output->computeValue(state, _channelName, _result);
     }
     const Output<T>& getOutput() const { return _output.getRef(); }
     const std::string& getChannelName() const override {
@@ -60,12 +60,12 @@ public:
     // Operators
     bool operator==(const ComponentPath& other) const
     {
-        return this->toString() == other.toString();
+        return isEqual(other);
     }
 
     bool operator!=(const ComponentPath& other) const
     {
-        return this->toString() != other.toString();
+        return !isEqual(other);
     }
 
     // Override virtual functions
@@ -103,4 +103,17 @@ private:
 
 
 } // end of namespace OpenSim
+
+namespace std {
+/// Allows a ComponentPath to be a key of an unordered container, using the
+/// hash computed when the path was formed.
+template <>
+struct hash<OpenSim::ComponentPath> {
+    size_t operator()(const OpenSim::ComponentPath& path) const
+    {
+        return path.getHash();
+    }
+};
+} // end of namespace std
+
 #endif // OPENSIM_COMPONENT_PATH_H_
@@ -0,0 +1,175 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ComponentProfiler.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ComponentProfiler.h"
+#include "Component.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace OpenSim {
+
+bool ComponentProfiler::_enabled = false;
+
+namespace {
+    std::mutex profilerMutex;
+    // The entries of the components, by address.
+    std::unordered_map<const Component*, ComponentProfiler::Entry> entries;
+
+    void sortBySeconds(std::vector<ComponentProfiler::Entry>& sorted)
+    {
+        std::stable_sort(sorted.begin(), sorted.end(),
+            [](const ComponentProfiler::Entry& a,
+               const ComponentProfiler::Entry& b)
+            {   return a.getTotalSeconds() > b.getTotalSeconds(); });
+    }
+
+    void printEntries(std::ostream& out,
+                      const std::vector<ComponentProfiler::Entry>& sorted,
+                      bool byType, int maxRows)
+    {
+        const int n = std::min((int)sorted.size(), maxRows);
+        for (int i = 0; i < n; ++i) {
+            const ComponentProfiler::Entry& entry = sorted[i];
+            out << "  " << std::setw(10) << entry.getTotalSeconds() << "s  "
+                << (byType ? entry.type
+                           : entry.path + " (" + entry.type + ")") << "\n";
+            for (int c = 0; c < ComponentProfiler::NumCategories; ++c) {
+                if (entry.calls[c] == 0) continue;
+                out << "  " << std::setw(10) << entry.seconds[c] << "s    "
+                    << ComponentProfiler::getCategoryName(
+                            ComponentProfiler::Category(c))
+                    << " (" << entry.calls[c] << " calls)\n";
+            }
+        }
+        if ((int)sorted.size() > n)
+            out << "  ... and " << sorted.size() - n << " more\n";
+    }
+}
+
+double ComponentProfiler::Entry::getTotalSeconds() const
+{
+    double total = 0;
+    for (int c = 0; c < NumCategories; ++c) {
+        // Nested categories are already part of realizeAcceleration.
+        if (c != ComputeStateVariableDerivatives) total += seconds[c];
+    }
+    return total;
+}
+
+double ComponentProfiler::now()
+{
+    return SimTK::realTime();
+}
+
+void ComponentProfiler::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void ComponentProfiler::record(const Component& component, Category category,
+                               double seconds)
+{
+    std::lock_guard<std::mutex> lock(profilerMutex);
+    auto found = entries.find(&component);
+    if (found == entries.end()) {
+        Entry entry;
+        entry.path = component.getAbsolutePathName();
+        entry.type = component.getConcreteClassName();
+        found = entries.emplace(&component, entry).first;
+    }
+    found->second.seconds[category] += seconds;
+    ++found->second.calls[category];
+}
+
+void ComponentProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(profilerMutex);
+    entries.clear();
+}
+
+std::vector<ComponentProfiler::Entry> ComponentProfiler::getComponentEntries()
+{
+    std::vector<Entry> sorted;
+    {
+        std::lock_guard<std::mutex> lock(profilerMutex);
+        for (const auto& it : entries) sorted.push_back(it.second);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Entry& a, const Entry& b) { return a.path < b.path; });
+    sortBySeconds(sorted);
+    return sorted;
+}
+
+std::vector<ComponentProfiler::Entry> ComponentProfiler::getTypeEntries()
+{
+    std::map<std::string, Entry> byType;
+    for (const Entry& entry : getComponentEntries()) {
+        Entry& sum = byType[entry.type];
+        sum.type = entry.type;
+        for (int c = 0; c < NumCategories; ++c) {
+            sum.seconds[c] += entry.seconds[c];
+            sum.calls[c] += entry.calls[c];
+        }
+    }
+    std::vector<Entry> sorted;
+    for (const auto& it : byType) sorted.push_back(it.second);
+    sortBySeconds(sorted);
+    return sorted;
+}
+
+void ComponentProfiler::printReport(std::ostream& out, int maxRows)
+{
+    const std::vector<Entry> components = getComponentEntries();
+    double total = 0;
+    for (const Entry& entry : components) total += entry.getTotalSeconds();
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(6);
+    out << "Time in component computations: " << total << "s\n";
+    out << "By type:\n";
+    printEntries(out, getTypeEntries(), true, maxRows);
+    out << "By component:\n";
+    printEntries(out, components, false, maxRows);
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+const char* ComponentProfiler::getCategoryName(Category category)
+{
+    static const char* names[NumCategories] = {
+        "realizeTopology", "realizeModel", "realizeInstance", "realizeTime",
+        "realizePosition", "realizeVelocity", "realizeDynamics",
+        "realizeAcceleration", "realizeReport",
+        "computeStateVariableDerivatives", "computeForce", "computeOutput"
+    };
+    return names[category];
+}
+
+} // namespace OpenSim
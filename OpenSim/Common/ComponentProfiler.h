@@ -0,0 +1,137 @@
+#ifndef OPENSIM_COMPONENT_PROFILER_H_
+#define OPENSIM_COMPONENT_PROFILER_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  ComponentProfiler.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+class Component;
+
+//=============================================================================
+//=============================================================================
+/**
+ * An opt-in record of the time spent in the computations of each Component of
+ * a model: its extendRealize*() methods, computeStateVariableDerivatives(),
+ * Force::computeForce() and the functions of its Outputs. Times are summed
+ * per component and per concrete type, so that a slow simulation shows
+ * whether, e.g., wrapping, muscle equilibrium or contact dominates it.
+ *
+ * Profiling is off by default, and then costs one test of a flag per
+ * computation. When it is on, Manager::integrate() prints a report at the
+ * end of each integration and then resets the profiler.
+ *
+ * @code
+ * ComponentProfiler::setEnabled(true);
+ * manager.integrate(state); // prints the report
+ * @endcode
+ *
+ * The time of computeStateVariableDerivatives() is also part of that of
+ * realizeAcceleration, and an Output computed while realizing a component is
+ * also part of that realize method; the times of nested computations are not
+ * subtracted.
+ */
+class OSIMCOMMON_API ComponentProfiler {
+public:
+    enum Category {
+        RealizeTopology,
+        RealizeModel,
+        RealizeInstance,
+        RealizeTime,
+        RealizePosition,
+        RealizeVelocity,
+        RealizeDynamics,
+        RealizeAcceleration,
+        RealizeReport,
+        ComputeStateVariableDerivatives,
+        ComputeForce,
+        ComputeOutput,
+        NumCategories
+    };
+
+    /** The time, in seconds, and the number of calls of each category of
+    computation of a component, or of all the components of a type. */
+    struct Entry {
+        /** The absolute path of the component; empty for a type. */
+        std::string path;
+        std::string type;
+        double seconds[NumCategories] = {};
+        long long calls[NumCategories] = {};
+        double getTotalSeconds() const;
+    };
+
+    /** Times a computation of a component from construction to destruction
+    if profiling is enabled. */
+    class Timer {
+    public:
+        Timer(const Component* component, Category category) :
+            _component(isEnabled() ? component : nullptr),
+            _category(category),
+            _start(_component ? now() : 0) {}
+        ~Timer() {
+            if (_component) record(*_component, _category, now() - _start);
+        }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    private:
+        const Component* _component;
+        Category _category;
+        double _start;
+    };
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return _enabled; }
+
+    /** Add the time of one computation of the given component. This may be
+    called from several threads. */
+    static void record(const Component& component, Category category,
+                       double seconds);
+    /** Forget the times recorded so far. Do this before destroying the
+    components that were profiled, as they are identified by address. */
+    static void reset();
+
+    /** The components for which times were recorded, slowest first. */
+    static std::vector<Entry> getComponentEntries();
+    /** The times summed over the components of each concrete type, slowest
+    first. */
+    static std::vector<Entry> getTypeEntries();
+
+    /** Print the slowest types and components, at most maxRows of each, with
+    the time of each category of computation. */
+    static void printReport(std::ostream& out, int maxRows = 20);
+
+    /** The name of a category, e.g., "realizeDynamics". */
+    static const char* getCategoryName(Category category);
+
+private:
+    static double now();
+    static bool _enabled;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_COMPONENT_PROFILER_H_
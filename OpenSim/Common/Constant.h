@@ -89,6 +89,14 @@ public:
     {
         return _value;
     }
+    double calcValue(double xUnused) const override
+    {
+        return _value;
+    }
+    double calcDerivative(double xUnused, int order) const override
+    {
+        return 0.0;
+    }
     const double getValue() const { return _value; }
     SimTK::Function* createSimTKFunction() const override;
 //=============================================================================
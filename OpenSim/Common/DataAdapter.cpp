@@ -44,8 +44,14 @@ bool
 registerAdapters{DataAdapter::registerDataAdapter("trc", TRCFileAdapter{}) 
         && DataAdapter::registerDataAdapter("mot", STOFileAdapter_<double>{}) 
         && DataAdapter::registerDataAdapter("csv", CSVFileAdapter{})
+        && DataAdapter::registerDataAdapter("otb", BinaryFileAdapter{})
 #ifdef WITH_BTK 
               && DataAdapter::registerDataAdapter("c3d", C3DFileAdapter{})
+#endif
+#ifdef WITH_ARROW
+              && DataAdapter::registerDataAdapter("arrow", ArrowFileAdapter{})
+              && DataAdapter::registerDataAdapter("feather",
+                                                  ArrowFileAdapter{})
 #endif
                 };
 
@@ -32,6 +32,7 @@ in-memory container for data access and manipulation.                         */
 #include "FileAdapter.h"
 #include "SimTKcommon/internal/BigMatrix.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <numeric>
 
@@ -220,14 +221,22 @@ public:
         // This calls validateDependentsMetadata, so no need for explicit call.
         setColumnLabels(thisLabels);
 
-        for(unsigned r = 0; r < that.getNumRows(); ++r) {
-            const auto& thatInd = that.getIndependentColumn().at(r);
-            const auto& thatRow = that.getRowAtIndex(r);
-            std::vector<ETY> thisRow{};
-            for(unsigned c = 0; c < that.getNumColumns(); ++c)
-                splitElementAndPushBack(thisRow, thatRow[c]);
-            appendRow(thatInd, thisRow);
-        }
+        // The matrix is allocated once, and each column of 'that' is split
+        // into its components column by column, without a temporary row.
+        const int numRows = static_cast<int>(that.getNumRows());
+        const int numColumns = static_cast<int>(that.getNumColumns());
+        const int numComponents =
+            static_cast<int>(that.numComponentsPerElement());
+        const auto thatMatrix = that.getMatrix();
+        _indData = that.getIndependentColumn();
+        _depData.resize(numRows, numColumns * numComponents);
+        for(int c = 0; c < numColumns; ++c)
+            for(int i = 0; i < numComponents; ++i) {
+                const int col = c * numComponents + i;
+                for(int r = 0; r < numRows; ++r)
+                    _depData.updElt(r, col) =
+                        getComponent(thatMatrix.getElt(r, c), i);
+            }
     }
 
     /** Construct this DataTable from a DataTable_<double, double>. This is the
@@ -644,9 +653,9 @@ public:
     void appendRow(const ETX& indRow, const RowVectorView& depRow) {
         validateRow(_indData.size(), indRow, depRow);
 
-        _indData.push_back(indRow);
+        const int numRows = static_cast<int>(_indData.size());
 
-        if(_depData.nrow() == 0 || _depData.ncol() == 0) {
+        if(numRows == 0 || _depData.ncol() == 0) {
             try {
                 auto& labels = 
                     _dependentsMetaData.getValueArrayForKey("labels");
@@ -658,11 +667,40 @@ public:
             } catch(KeyNotFound&) {
                 // No "labels". So no operation.
             }
-            _depData.resize(1, depRow.size());
-        } else
-            _depData.resizeKeep(_depData.nrow() + 1, _depData.ncol());
-            
-        _depData.updRow(_depData.nrow() - 1) = depRow;
+            // Keep any capacity that was reserved before the number of
+            // columns was known.
+            _depData.resize(std::max(_depData.nrow(), numRows + 1),
+                            depRow.size());
+        } else if(numRows == _depData.nrow())
+            // Grow geometrically so that appending is O(1) amortized.
+            _depData.resizeKeep(numRows + numRows / 2 + 1, _depData.ncol());
+
+        _depData.updRow(numRows) = depRow;
+        _indData.push_back(indRow);
+    }
+
+    /** Reserve memory for at least the given number of rows so that they can
+    be appended without reallocating the underlying matrix. Appending rows is
+    O(1) amortized anyway; reserving only avoids the intermediate copies when
+    the number of rows is known in advance.                                   */
+    void reserve(size_t numRows) {
+        if(static_cast<int>(numRows) > _depData.nrow())
+            _depData.resizeKeep(static_cast<int>(numRows), _depData.ncol());
+        _indData.reserve(numRows);
+    }
+
+    /** Get the number of rows that the table can hold before appendRow() has
+    to reallocate the underlying matrix.                                      */
+    size_t getRowCapacity() const {
+        return static_cast<size_t>(_depData.nrow());
+    }
+
+    /** Release the memory reserved for rows beyond the current number of rows
+    (see reserve()). Call this once the table is complete.                    */
+    void shrinkToFit() {
+        _depData.resizeKeep(static_cast<int>(_indData.size()),
+                            _depData.ncol());
+        _indData.shrink_to_fit();
     }
 
     /** Get row at index.                                                     
@@ -727,11 +765,10 @@ public:
                          RowIndexOutOfRange, 
                          index, 0, static_cast<unsigned>(_indData.size() - 1));
 
-        if(index < getNumRows() - 1)
-            for(size_t r = index; r < getNumRows() - 1; ++r)
-                _depData.updRow((int)index) = _depData.row((int)(index + 1));
-        
-        _depData.resizeKeep(_depData.nrow() - 1, _depData.ncol());
+        // Rows past the new last row become spare capacity.
+        for(size_t r = index; r + 1 < getNumRows(); ++r)
+            _depData.updRow((int)r) = _depData.row((int)(r + 1));
+
         _indData.erase(_indData.begin() + index);
     }
 
@@ -767,7 +804,7 @@ public:
                          ColumnIndexOutOfRange, index, 0,
                          static_cast<size_t>(_depData.ncol() - 1));
 
-        return _depData.col(static_cast<int>(index));
+        return getDepData().col(static_cast<int>(index));
     }
 
     /** Get dependent Column which has the given column label.                
@@ -775,7 +812,7 @@ public:
     \throws KeyNotFound If columnLabel is not found to be label of any existing
                         column.                                               */
     VectorView getDependentColumn(const std::string& columnLabel) const {
-        return _depData.col(static_cast<int>(getColumnIndex(columnLabel)));
+        return getDepData().col(static_cast<int>(getColumnIndex(columnLabel)));
     }
 
     /** Update dependent column at index.
@@ -787,7 +824,7 @@ public:
                          ColumnIndexOutOfRange, index, 0,
                          static_cast<size_t>(_depData.ncol() - 1));
 
-        return _depData.updCol(static_cast<int>(index));
+        return updDepData().updCol(static_cast<int>(index));
     }
 
     /** Update dependent Column which has the given column label.
@@ -795,7 +832,8 @@ public:
     \throws KeyNotFound If columnLabel is not found to be label of any existing
                         column.                                               */
     VectorView updDependentColumn(const std::string& columnLabel) {
-        return _depData.updCol(static_cast<int>(getColumnIndex(columnLabel)));
+        return updDepData().updCol(
+                static_cast<int>(getColumnIndex(columnLabel)));
     }
 
     /** %Set value of the independent column at index.
@@ -821,8 +859,8 @@ public:
     /// @{
 
     /** Get a read-only view to the underlying matrix.                        */
-    const MatrixView& getMatrix() const {
-        return _depData.getAsMatrixView();
+    MatrixView getMatrix() const {
+        return getDepData();
     }
 
     /** Get a read-only view of a block of the underlying matrix.             
@@ -842,11 +880,11 @@ public:
         OPENSIM_THROW_IF(isRowIndexOutOfRange(rowStart),
                          RowIndexOutOfRange,
                          rowStart, 0, 
-                         static_cast<unsigned>(_depData.nrow() - 1));
+                         static_cast<unsigned>(getNumRows() - 1));
         OPENSIM_THROW_IF(isRowIndexOutOfRange(rowStart + numRows - 1),
                          RowIndexOutOfRange,
                          rowStart + numRows - 1, 0, 
-                         static_cast<unsigned>(_depData.nrow() - 1));
+                         static_cast<unsigned>(getNumRows() - 1));
         OPENSIM_THROW_IF(isColumnIndexOutOfRange(columnStart),
                          ColumnIndexOutOfRange,
                          columnStart, 0, 
@@ -863,8 +901,8 @@ public:
     }
 
     /** Get a writable view to the underlying matrix.                         */
-    MatrixView& updMatrix() {
-        return _depData.updAsMatrixView();
+    MatrixView updMatrix() {
+        return updDepData();
     }
 
     /** Get a writable view of a block of the underlying matrix.
@@ -884,11 +922,11 @@ public:
         OPENSIM_THROW_IF(isRowIndexOutOfRange(rowStart),
                          RowIndexOutOfRange,
                          rowStart, 0, 
-                         static_cast<unsigned>(_depData.nrow() - 1));
+                         static_cast<unsigned>(getNumRows() - 1));
         OPENSIM_THROW_IF(isRowIndexOutOfRange(rowStart + numRows - 1),
                          RowIndexOutOfRange,
                          rowStart + numRows - 1, 0, 
-                         static_cast<unsigned>(_depData.nrow() - 1));
+                         static_cast<unsigned>(getNumRows() - 1));
         OPENSIM_THROW_IF(isColumnIndexOutOfRange(columnStart),
                          ColumnIndexOutOfRange,
                          columnStart, 0, 
@@ -1148,6 +1186,27 @@ protected:
                       "DataTable<double, ThatETY> where ThatETY is an "
                       "unsupported type.");
     }
+    // Get a component of an element, in the order of
+    // splitElementAndPushBack().
+    template<int N>
+    static
+    double getComponent(const SimTK::Vec<N>& elem, int i) {
+        return elem[i];
+    }
+    template<int M, int N>
+    static
+    double getComponent(const SimTK::Vec<M, SimTK::Vec<N>>& elem, int i) {
+        return elem[i / N][i % N];
+    }
+    // Unsupported type.
+    static
+    double getComponent(...) {
+        static_assert(!std::is_same<ETY, double>::value,
+                      "This constructor cannot be used to construct from "
+                      "DataTable<double, ThatETY> where ThatETY is an "
+                      "unsupported type.");
+        return 0;
+    }
     template<typename ELT>
     static
     std::vector<double> splitElement(const ELT& elt) {
@@ -1170,6 +1229,16 @@ protected:
                          "Expected: 1 Received: 0");
         elem = *begin;
     }
+    template<typename Iter>
+    static
+    void makeElement_helper(float& elem,
+                            Iter begin, Iter end) {
+        OPENSIM_THROW_IF(begin == end,
+                         InvalidArgument,
+                         "Iterators do not produce enough elements."
+                         "Expected: 1 Received: 0");
+        elem = static_cast<float>(*begin);
+    }
     template<int N, typename Iter>
     static
     void makeElement_helper(SimTK::Vec<N>& elem,
@@ -1221,7 +1290,7 @@ protected:
 
     /** Get number of rows.                                                   */
     size_t implementGetNumRows() const override {
-        return _depData.nrow();
+        return _indData.size();
     }
 
     /** Get number of columns.                                                */
@@ -1302,7 +1371,21 @@ protected:
         return M * N;
     }
 
+    /** View of the rows of the underlying matrix that are in use. The matrix
+    may have more rows than the table, reserved for rows to be appended.      */
+    MatrixView getDepData() const {
+        return _depData.block(0, 0,
+                              static_cast<int>(_indData.size()),
+                              _depData.ncol());
+    }
+    MatrixView updDepData() {
+        return _depData.updBlock(0, 0,
+                                 static_cast<int>(_indData.size()),
+                                 _depData.ncol());
+    }
+
     std::vector<ETX>    _indData;
+    // Only the first _indData.size() rows hold data; see reserve().
     SimTK::Matrix_<ETY> _depData;
 };  // DataTable_
 
@@ -26,10 +26,16 @@
 
 #include "FileAdapter.h"
 #include "TimeSeriesTable.h"
+#include "ThreadPool.h"
 
 #include <string>
+#include <cstdlib>
 #include <fstream>
 #include <regex>
+#include <sstream>
+#include <thread>
+#include <exception>
+#include <algorithm>
 
 namespace OpenSim {
 
@@ -114,10 +120,34 @@ public:
     /** Name of the data type T (template parameter).                         */
     static inline std::string dataTypeName();
 
+    /** Write the header of the file for the given table to the stream: the
+    table metadata, the data type, the version and the line of column labels.
+    Writing the header and then the rows of the table with writeRows(),
+    possibly in several chunks, gives the same file as writing the table at
+    once.                                                                     */
+    void writeHeader(std::ostream& stream,
+                     const TimeSeriesTable_<T>& table) const;
+
+    /** Write the rows of the given table to the stream, one line per row.
+    Large tables are formatted in blocks of rows on several threads, and each
+    block is written to the stream at once.                                   */
+    void writeRows(std::ostream& stream,
+                   const TimeSeriesTable_<T>& table) const;
+
 protected:
     /** Implementation of the read functionality.                             */
     OutputTables extendRead(const std::string& filename) const override;
 
+    /** Read the selected columns of the rows with times in [startTime,
+    endTime] from the file. Every line in that range is still split into
+    numbers, but the elements of the other columns are neither made nor
+    stored. Only the time is parsed out of the lines before the range, and
+    reading stops at the first line after it.                                 */
+    OutputTables extendReadColumns(const std::string& filename,
+                                   const ColumnSelection& selection,
+                                   double startTime = -SimTK::Infinity,
+                                   double endTime = SimTK::Infinity) const;
+
     /** Implementation of the write functionality.                            */
     void extendWrite(const InputTables& tables,
                      const std::string& filename) const override;
@@ -127,6 +157,15 @@ protected:
     inline SimTK::RowVector_<T> 
     readElems(const std::vector<std::string>& tokens) const;
 
+    /** Fill up a row of elements of type T (template parameter) from the
+    components parsed out of a line by parseNumbers(). The first `compOffset`
+    components and the first `elemOffset` elements are skipped.               */
+    inline void readElems(const std::vector<double>& values,
+                          const std::vector<unsigned>& numComps,
+                          size_t compOffset,
+                          size_t elemOffset,
+                          SimTK::RowVector_<T>& elems) const;
+
     /** Write an element of type T (template parameter) to stream with the
     specified precision.                                                      */
     inline void writeElem(std::ostream& stream, 
@@ -160,6 +199,26 @@ private:
     readElems_impl(const std::vector<std::string>& tokens,
                    SimTK::Vec<M>) const;
 
+    /** Following overloads give the number of components in an element.   */
+    static inline unsigned numComponents_impl(double);
+    static inline unsigned numComponents_impl(SimTK::UnitVec3);
+    static inline unsigned numComponents_impl(SimTK::Quaternion);
+    static inline unsigned numComponents_impl(SimTK::SpatialVec);
+    template<int M>
+    static inline unsigned numComponents_impl(SimTK::Vec<M>);
+
+    /** Following overloads construct an element from its components.        */
+    static inline double makeElem_impl(const double* comps, double);
+    static inline SimTK::UnitVec3 makeElem_impl(const double* comps,
+                                                SimTK::UnitVec3);
+    static inline SimTK::Quaternion makeElem_impl(const double* comps,
+                                                  SimTK::Quaternion);
+    static inline SimTK::SpatialVec makeElem_impl(const double* comps,
+                                                  SimTK::SpatialVec);
+    template<int M>
+    static inline SimTK::Vec<M> makeElem_impl(const double* comps,
+                                              SimTK::Vec<M>);
+
     /** Following overloads implement writeElem().                            */
     inline void writeElem_impl(std::ostream& stream,
                                const double& elem,
@@ -299,6 +358,15 @@ DelimFileAdapter<T>::clone() const {
 template<typename T>
 typename DelimFileAdapter<T>::OutputTables
 DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
+    return extendReadColumns(fileName, ColumnSelection{});
+}
+
+template<typename T>
+typename DelimFileAdapter<T>::OutputTables
+DelimFileAdapter<T>::extendReadColumns(const std::string& fileName,
+                                       const ColumnSelection& selection,
+                                       double startTime,
+                                       double endTime) const {
     OPENSIM_THROW_IF(fileName.empty(),
                      EmptyFileName);
 
@@ -352,14 +420,9 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
     }
     table->updTableMetaData().setValueForKey("header", header);
 
-    // Callable to get the next line in form of vector of tokens.
-    auto nextLine = [&] {
-        return getNextLine(in_stream, _delimitersRead);
-    };
-
     // Read the line containing column labels and fill up the column labels
     // container.
-    auto column_labels = nextLine();
+    auto column_labels = getNextLine(in_stream, _delimitersRead);
     ++line_num;
     // Column 0 is the time column. Check and get rid of it. The data in this
     // column is maintained separately from rest of the data.
@@ -369,38 +432,88 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
                      _timeColumnLabel,
                      column_labels[0]);
     column_labels.erase(column_labels.begin());
+    // Indices of the columns to read; the others are skipped.
+    const auto columns = selection.findColumns(column_labels);
     // Set the column labels as metadata.
     ValueArray<std::string> value_array{};
-    for(const auto& cl : column_labels)
-        value_array.upd().push_back(SimTK::Value<std::string>{cl});
+    for(auto c : columns)
+        value_array.upd().push_back(SimTK::Value<std::string>{
+                column_labels[c]});
     typename TimeSeriesTable_<T>::DependentsMetaData dep_metadata{};
     dep_metadata.setValueArrayForKey("labels", value_array);
     table->setDependentsMetaData(dep_metadata);
 
     // Read the rows one at a time and fill up the time column container and
-    // the data container.
-    auto row = nextLine();
-    while(!row.empty()) {
+    // the data container. The numbers are parsed straight out of the line
+    // and the buffers are reused from one row to the next. For elements that
+    // are plain doubles there are no components to separate.
+    const std::string comp_delims{
+        numComponents_impl(T{}) == 1 ? std::string{} : _compDelimRead};
+    const unsigned num_elem_comps{numComponents_impl(T{})};
+    std::vector<double> values{};
+    std::vector<unsigned> num_comps{};
+    std::vector<size_t> comp_offsets{};
+    SimTK::RowVector_<T> row_vector{static_cast<int>(columns.size())};
+    const bool all_times{startTime == -SimTK::Infinity &&
+                         endTime == SimTK::Infinity};
+    while(getNextLine(in_stream, _delimitersRead, line)) {
         ++line_num;
 
-        // Time is column 0.
-        double time = std::stod(row.front());
-        row.erase(row.begin());
+        // Rows are in increasing time. Look at the time alone to skip the
+        // rows before the range and to stop after it.
+        if(!all_times) {
+            const auto first = line.find_first_not_of(_delimitersRead);
+            const double time{std::strtod(line.c_str() + first, nullptr)};
+            if(time < startTime)
+                continue;
+            if(time > endTime)
+                break;
+        }
 
-        auto row_vector = readElems(row);
+        parseNumbers(line, _delimitersRead, comp_delims, values, num_comps);
+        if(num_comps.empty())
+            continue;
 
-        OPENSIM_THROW_IF(row_vector.size() != column_labels.size(),
+        OPENSIM_THROW_IF(num_comps.size() - 1 != column_labels.size(),
                          RowLengthMismatch,
                          fileName,
                          line_num,
                          column_labels.size(),
-                         static_cast<size_t>(row_vector.size()));
+                         num_comps.size() - 1);
 
-        // Column 1 is time.
-        table->appendRow(time, std::move(row_vector));
+        // Time is column 0.
+        OPENSIM_THROW_IF(num_comps.front() != 1,
+                         IncorrectNumTokens,
+                         "Expected a single number for time.");
+        const double time = values.front();
+
+        if(selection.selectsAll())
+            readElems(values, num_comps, 1, 1, row_vector);
+        else {
+            // Offset of the first component of each element, time excluded.
+            comp_offsets.resize(column_labels.size());
+            size_t offset{1};
+            for(size_t c = 0; c < comp_offsets.size(); ++c) {
+                comp_offsets[c] = offset;
+                offset += num_comps[c + 1];
+            }
+            for(size_t i = 0; i < columns.size(); ++i) {
+                OPENSIM_THROW_IF(num_comps[columns[i] + 1] != num_elem_comps,
+                                 IncorrectNumTokens,
+                                 "Expected " + 
+                                 std::to_string(num_elem_comps) +
+                                 "x (multiple of " + 
+                                 std::to_string(num_elem_comps) +
+                                 ") number of tokens.");
+                row_vector[static_cast<int>(i)] =
+                    makeElem_impl(values.data() + comp_offsets[columns[i]],
+                                  T{});
+            }
+        }
 
-        row = nextLine();
+        table->appendRow(time, row_vector);
     }
+    table->shrinkToFit();
 
     OutputTables output_tables{};
     output_tables.emplace(tableString(), table);
@@ -414,6 +527,89 @@ DelimFileAdapter<T>::readElems(const std::vector<std::string>& tokens) const {
     return readElems_impl(tokens, T{});
 }
 
+template<typename T>
+void
+DelimFileAdapter<T>::readElems(const std::vector<double>& values,
+                               const std::vector<unsigned>& numComps,
+                               size_t compOffset,
+                               size_t elemOffset,
+                               SimTK::RowVector_<T>& elems) const {
+    const unsigned num_comps = numComponents_impl(T{});
+    const double* comps = values.data() + compOffset;
+    for(auto i = elemOffset; i < numComps.size(); ++i) {
+        OPENSIM_THROW_IF(numComps[i] != num_comps,
+                         IncorrectNumTokens,
+                         "Expected " + std::to_string(num_comps) +
+                         "x (multiple of " + std::to_string(num_comps) +
+                         ") number of tokens.");
+        elems[static_cast<int>(i - elemOffset)] = makeElem_impl(comps, T{});
+        comps += num_comps;
+    }
+}
+
+template<typename T>
+unsigned
+DelimFileAdapter<T>::numComponents_impl(double) {
+    return 1;
+}
+
+template<typename T>
+unsigned
+DelimFileAdapter<T>::numComponents_impl(SimTK::UnitVec3) {
+    return 3;
+}
+
+template<typename T>
+unsigned
+DelimFileAdapter<T>::numComponents_impl(SimTK::Quaternion) {
+    return 4;
+}
+
+template<typename T>
+unsigned
+DelimFileAdapter<T>::numComponents_impl(SimTK::SpatialVec) {
+    return 6;
+}
+
+template<typename T>
+template<int M>
+unsigned
+DelimFileAdapter<T>::numComponents_impl(SimTK::Vec<M>) {
+    return M;
+}
+
+template<typename T>
+double
+DelimFileAdapter<T>::makeElem_impl(const double* comps, double) {
+    return comps[0];
+}
+
+template<typename T>
+SimTK::UnitVec3
+DelimFileAdapter<T>::makeElem_impl(const double* comps, SimTK::UnitVec3) {
+    return SimTK::UnitVec3{comps[0], comps[1], comps[2]};
+}
+
+template<typename T>
+SimTK::Quaternion
+DelimFileAdapter<T>::makeElem_impl(const double* comps, SimTK::Quaternion) {
+    return SimTK::Quaternion{comps[0], comps[1], comps[2], comps[3]};
+}
+
+template<typename T>
+SimTK::SpatialVec
+DelimFileAdapter<T>::makeElem_impl(const double* comps, SimTK::SpatialVec) {
+    return SimTK::SpatialVec{{comps[0], comps[1], comps[2]},
+                             {comps[3], comps[4], comps[5]}};
+}
+
+template<typename T>
+template<int M>
+SimTK::Vec<M>
+DelimFileAdapter<T>::makeElem_impl(const double* comps, SimTK::Vec<M>) {
+    return SimTK::Vec<M>(comps);
+}
+
 template<typename T>
 SimTK::RowVector_<double>
 DelimFileAdapter<T>::readElems_impl(const std::vector<std::string>& tokens,
@@ -526,10 +722,17 @@ DelimFileAdapter<T>::extendWrite(const InputTables& absTables,
                      EmptyFileName);
 
     std::ofstream out_stream{fileName};
+    writeHeader(out_stream, *table);
+    writeRows(out_stream, *table);
+}
 
+template<typename T>
+void
+DelimFileAdapter<T>::writeHeader(std::ostream& out_stream,
+                                 const TimeSeriesTable_<T>& table) const {
     // First line of the stream is the header.
     try {
-        out_stream << table->
+        out_stream << table.
                       getTableMetaData().
                       getValueForKey("header").
                       template getValue<std::string>() << "\n";
@@ -537,11 +740,11 @@ DelimFileAdapter<T>::extendWrite(const InputTables& absTables,
         // No operation. Continue with other keys in table metadata.
     }
     // Write rest of the key-value pairs and end the header.
-    for(const auto& key : table->getTableMetaDataKeys()) {
+    for(const auto& key : table.getTableMetaDataKeys()) {
         try {
             if(key != "header")
                 out_stream << key << "=" 
-                           << table->
+                           << table.
                               template getTableMetaData<std::string>(key) 
                            << "\n";
         } catch(const InvalidTemplateArgument&) {}
@@ -554,26 +757,55 @@ DelimFileAdapter<T>::extendWrite(const InputTables& absTables,
 
     // Line containing column labels.
     out_stream << _timeColumnLabel;
-    for(unsigned col = 0; col < table->getNumColumns(); ++col)
+    for(unsigned col = 0; col < table.getNumColumns(); ++col)
         out_stream << _delimiterWrite
-                   << table->
+                   << table.
                       getDependentsMetaData().
                       getValueArrayForKey("labels")[col].
                       template getValue<std::string>();
     out_stream << "\n";
+}
 
-    // Data rows.
-    for(unsigned row = 0; row < table->getNumRows(); ++row) {
-        constexpr auto prec = std::numeric_limits<double>::digits10 + 1;
-        out_stream << std::setprecision(prec)
-                   << table->getIndependentColumn()[row];
-        const auto& row_r = table->getRowAtIndex(row);
-        for(unsigned col = 0; col < table->getNumColumns(); ++col) {
-            const auto& elt = row_r[col];
-            out_stream << _delimiterWrite;
-            writeElem(out_stream, elt, prec);
+template<typename T>
+void
+DelimFileAdapter<T>::writeRows(std::ostream& out_stream,
+                               const TimeSeriesTable_<T>& table) const {
+    constexpr auto prec = std::numeric_limits<double>::digits10 + 1;
+    // Rows are formatted in blocks, several blocks at once on the threads of
+    // the ThreadPool, and each block is written to the stream in one go.
+    constexpr unsigned blockSize = 1024;
+    const unsigned numRows = table.getNumRows();
+    const unsigned numBlocks = (numRows + blockSize - 1) / blockSize;
+    const unsigned numThreads = std::min(numBlocks,
+        unsigned(ThreadPool::getMaxNumThreads()));
+
+    std::vector<std::string> buffers(numThreads);
+    auto formatBlock = [&](unsigned t, unsigned block) {
+        std::ostringstream stream{};
+        stream.copyfmt(out_stream);
+        const unsigned end = std::min(numRows, (block + 1) * blockSize);
+        for(unsigned row = block * blockSize; row < end; ++row) {
+            stream << std::setprecision(prec)
+                   << table.getIndependentColumn()[row];
+            const auto& row_r = table.getRowAtIndex(row);
+            for(unsigned col = 0; col < table.getNumColumns(); ++col) {
+                const auto& elt = row_r[col];
+                stream << _delimiterWrite;
+                writeElem(stream, elt, prec);
+            }
+            stream << "\n";
         }
-        out_stream << "\n";
+        buffers[t] = stream.str();
+    };
+
+    // Keep at most numThreads blocks in memory, and write them in order.
+    for(unsigned first = 0; first < numBlocks; first += numThreads) {
+        const unsigned n = std::min(numThreads, numBlocks - first);
+        ThreadPool::parallelFor(int(n), int(n), [&](int t) {
+            formatBlock(unsigned(t), first + unsigned(t));
+        });
+        for(unsigned t = 0; t < n; ++t)
+            out_stream.write(buffers[t].data(), buffers[t].size());
     }
 }
 
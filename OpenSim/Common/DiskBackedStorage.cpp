@@ -0,0 +1,199 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  DiskBackedStorage.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "DiskBackedStorage.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace OpenSim {
+
+DiskBackedStorage::DiskBackedStorage(const std::string& fileName,
+                                     int chunkSize,
+                                     int maxResidentChunks) :
+    _fileName(fileName),
+    _layout(BinaryFileAdapter::readLayout(fileName)),
+    _chunkSize(chunkSize),
+    _maxResidentChunks(maxResidentChunks) {
+    OPENSIM_THROW_IF(chunkSize < 1 || maxResidentChunks < 1, Exception,
+        "Expected chunks of at least one row and at least one resident "
+        "chunk.");
+    OPENSIM_THROW_IF(_layout.dataType != "double" ||
+                     _layout.numComponents != 1,
+                     IncorrectTableType,
+                     "DiskBackedStorage requires a file of doubles, but '" +
+                     fileName + "' holds " + _layout.dataType + ".");
+
+    _stream.open(fileName, std::ios_base::binary);
+    OPENSIM_THROW_IF(!_stream.good(), FileDoesNotExist, fileName);
+
+    _times.resize(_layout.numRows);
+    _stream.seekg(_layout.timeOffset);
+    _stream.read(reinterpret_cast<char*>(_times.data()),
+                 _times.size() * sizeof(double));
+    OPENSIM_THROW_IF(!_stream.good(), IOError,
+                     "Could not read the time column of '" + fileName + "'.");
+
+    _columnLabels.append("time");
+    for(const auto& label : _layout.labels)
+        _columnLabels.append(label);
+}
+
+int DiskBackedStorage::getStateIndex(const std::string& columnName) const {
+    const auto found = std::find(_layout.labels.begin(), _layout.labels.end(),
+                                 columnName);
+    if(found == _layout.labels.end())
+        return -1;
+    return (int)(found - _layout.labels.begin());
+}
+
+double DiskBackedStorage::getFirstTime() const {
+    return _times.empty() ? SimTK::NaN : _times.front();
+}
+
+double DiskBackedStorage::getLastTime() const {
+    return _times.empty() ? SimTK::NaN : _times.back();
+}
+
+int DiskBackedStorage::getTimeColumn(Array<double>& rTimes) const {
+    rTimes.setSize(getSize());
+    std::copy(_times.begin(), _times.end(), rTimes.get());
+    return getSize();
+}
+
+int DiskBackedStorage::findIndex(double aT) const {
+    if(_times.empty()) return -1;
+    const auto after = std::upper_bound(_times.begin(), _times.end(), aT);
+    return after == _times.begin() ? 0 : (int)(after - _times.begin()) - 1;
+}
+
+int DiskBackedStorage::getDataAtTime(double aT, int aN,
+                                     double* rData) const {
+    const int i = findIndex(aT);
+    if(rData == nullptr || i < 0) return 0;
+
+    // Interpolate between rows i1 and i2, as does Storage.
+    int i1 = i, i2 = i + 1;
+    if(i2 == getSize()) {
+        i1 = std::max(i1 - 1, 0);
+        i2 = std::max(i2 - 1, 0);
+    }
+    const int n = std::min(aN, (int)_layout.labels.size());
+    if(n <= 0) return 0;
+    const double den = _times[i2] - _times[i1];
+    const double pct = den < SimTK::Eps ? 0.0 : (aT - _times[i1]) / den;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Copy the first row out before the second chunk may evict its chunk.
+    const Chunk* chunk = &getChunk(i1 / _chunkSize);
+    size_t length = chunk->size() / _layout.labels.size();
+    size_t r = i1 % _chunkSize;
+    for(int j = 0; j < n; ++j)
+        rData[j] = (*chunk)[j * length + r];
+    if(pct == 0.0)
+        return n;
+
+    chunk = &getChunk(i2 / _chunkSize);
+    length = chunk->size() / _layout.labels.size();
+    r = i2 % _chunkSize;
+    for(int j = 0; j < n; ++j)
+        rData[j] += pct * ((*chunk)[j * length + r] - rData[j]);
+    return n;
+}
+
+int DiskBackedStorage::getDataAtTime(double aT, int aN,
+                                     Array<double>& rData) const {
+    return getDataAtTime(aT, aN, rData.get());
+}
+
+void DiskBackedStorage::getDataColumn(int aStateIndex,
+                                      Array<double>& rData) const {
+    OPENSIM_THROW_IF(aStateIndex < 0 ||
+                     aStateIndex >= (int)_layout.labels.size(),
+                     IndexOutOfRange, (size_t)aStateIndex, 0,
+                     _layout.labels.size() - 1);
+    rData.setSize(getSize());
+    if(getSize() == 0) return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    readColumn(aStateIndex, 0, _times.size(), rData.get());
+}
+
+void DiskBackedStorage::getDataColumn(const std::string& columnName,
+                                      Array<double>& rData) const {
+    const int index = getStateIndex(columnName);
+    OPENSIM_THROW_IF(index < 0, KeyNotFound, columnName);
+    getDataColumn(index, rData);
+}
+
+Storage DiskBackedStorage::getWindow(double startTime, double endTime) const {
+    Storage window(BinaryFileAdapter::readTimeRange<double>(_fileName,
+                                                            startTime,
+                                                            endTime));
+    window.setName(_fileName);
+    return window;
+}
+
+int DiskBackedStorage::getNumResidentChunks() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_chunks.size();
+}
+
+const DiskBackedStorage::Chunk& DiskBackedStorage::getChunk(int index) const {
+    auto found = _chunks.find(index);
+    if(found != _chunks.end()) {
+        _recentChunks.splice(_recentChunks.begin(), _recentChunks,
+                             found->second.second);
+        return found->second.first;
+    }
+
+    if((int)_chunks.size() >= _maxResidentChunks) {
+        _chunks.erase(_recentChunks.back());
+        _recentChunks.pop_back();
+    }
+
+    const size_t firstRow = (size_t)index * _chunkSize;
+    const size_t numRows = std::min((size_t)_chunkSize,
+                                    _times.size() - firstRow);
+    Chunk chunk(numRows * _layout.labels.size());
+    for(size_t c = 0; c < _layout.labels.size(); ++c)
+        readColumn(c, firstRow, numRows, chunk.data() + c * numRows);
+
+    _recentChunks.push_front(index);
+    auto& entry = _chunks[index];
+    entry.first.swap(chunk);
+    entry.second = _recentChunks.begin();
+    return entry.first;
+}
+
+void DiskBackedStorage::readColumn(size_t column, size_t firstRow,
+                                   size_t numRows, double* values) const {
+    _stream.clear();
+    _stream.seekg(_layout.columnOffset(column) +
+                  (std::streamoff)(firstRow * sizeof(double)));
+    _stream.read(reinterpret_cast<char*>(values), numRows * sizeof(double));
+    OPENSIM_THROW_IF(!_stream.good(), IOError,
+                     "Could not read column '" + _layout.labels[column] +
+                     "' of '" + _fileName + "'.");
+}
+
+} // namespace OpenSim
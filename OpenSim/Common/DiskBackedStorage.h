@@ -0,0 +1,146 @@
+#ifndef OPENSIM_DISK_BACKED_STORAGE_H_
+#define OPENSIM_DISK_BACKED_STORAGE_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  DiskBackedStorage.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "BinaryFileAdapter.h"
+#include "Storage.h"
+
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Read-only access to a time series that is too large to be held in memory,
+ * with the interface of Storage for looking up data. The data stay in a
+ * binary table file of doubles (see BinaryFileAdapter); only the time column
+ * and a bounded number of chunks of consecutive rows are held in memory. The
+ * least recently used chunk is dropped when another one must be read.
+ *
+ * Interpolating at successive times, as a tool stepping through a trial
+ * does, reads each chunk once. A column is read straight from the file
+ * without going through the chunks. Where a tool requires a Storage, the
+ * rows of a window of time can be read into one with getWindow().
+ *
+ * Lookups may be made from several threads at once.
+ *
+ * @code
+ * BinaryFileAdapter::write(recording, "ambulatory.otb");
+ * DiskBackedStorage emg("ambulatory.otb");
+ * Array<double> y(0.0, emg.getColumnLabels().getSize() - 1);
+ * emg.getDataAtTime(3600.25, y.getSize(), y);
+ * Storage hour = emg.getWindow(3600, 7200);
+ * @endcode
+ */
+class OSIMCOMMON_API DiskBackedStorage {
+public:
+    /** Open the given binary table file, which must hold a table of doubles.
+        At most maxResidentChunks chunks of chunkSize rows are held in memory
+        at a time.
+
+        @throws IncorrectTableType If the file holds elements of another type.
+    */
+    explicit DiskBackedStorage(const std::string& fileName,
+                               int chunkSize = 4096,
+                               int maxResidentChunks = 16);
+
+    DiskBackedStorage(const DiskBackedStorage&) = delete;
+    DiskBackedStorage& operator=(const DiskBackedStorage&) = delete;
+
+    const std::string& getFileName() const { return _fileName; }
+
+    //--------------------------------------------------------------------------
+    // SIZE AND LABELS
+    //--------------------------------------------------------------------------
+    /** The number of rows. */
+    int getSize() const { return (int)_times.size(); }
+    /** The column labels, "time" first, as for Storage. */
+    const Array<std::string>& getColumnLabels() const { return _columnLabels; }
+    /** The index of the column with the given label, not counting the time
+        column, or -1 if there is none, as for Storage. */
+    int getStateIndex(const std::string& columnName) const;
+
+    //--------------------------------------------------------------------------
+    // TIME
+    //--------------------------------------------------------------------------
+    double getFirstTime() const;
+    double getLastTime() const;
+    int getTimeColumn(Array<double>& rTimes) const;
+    /** The index of the row preceding or at the given time, 0 if the time is
+        before the first row, or -1 if there are no rows. */
+    int findIndex(double aT) const;
+
+    //--------------------------------------------------------------------------
+    // DATA
+    //--------------------------------------------------------------------------
+    /** Get the first aN values at the given time, linearly interpolated
+        between rows as by Storage::getDataAtTime(). Returns the number of
+        values set. */
+    int getDataAtTime(double aT, int aN, double* rData) const;
+    int getDataAtTime(double aT, int aN, Array<double>& rData) const;
+    /** Get the values of the column with the given index, not counting the
+        time column. */
+    void getDataColumn(int aStateIndex, Array<double>& rData) const;
+    /** Get the values of the column with the given label. */
+    void getDataColumn(const std::string& columnName,
+                       Array<double>& rData) const;
+    /** Read the rows with times in [startTime, endTime] into a Storage. */
+    Storage getWindow(double startTime, double endTime) const;
+
+    /** The number of chunks currently held in memory. */
+    int getNumResidentChunks() const;
+
+private:
+    // Values of the rows of a chunk, column after column.
+    typedef std::vector<double> Chunk;
+
+    // Get the chunk with the given index, reading it from the file if it is
+    // not resident. The mutex must be held; the reference is valid until the
+    // next call.
+    const Chunk& getChunk(int index) const;
+    void readColumn(size_t column, size_t firstRow, size_t numRows,
+                    double* values) const;
+
+    std::string _fileName;
+    BinaryFileAdapter::Layout _layout;
+    std::vector<double> _times;
+    Array<std::string> _columnLabels;
+    int _chunkSize;
+    int _maxResidentChunks;
+
+    // Resident chunks by index, and their indices from the most to the least
+    // recently used.
+    mutable std::list<int> _recentChunks;
+    mutable std::unordered_map<int,
+        std::pair<Chunk, std::list<int>::iterator>> _chunks;
+    mutable std::ifstream _stream;
+    mutable std::mutex _mutex;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_DISK_BACKED_STORAGE_H_
@@ -1,5 +1,10 @@
 #include "FileAdapter.h"
 
+#include <cctype>
+#include <cstdlib>
+#include <regex>
+#include <unordered_map>
+
 namespace OpenSim {
 
 std::shared_ptr<DataAdapter>
@@ -8,6 +13,49 @@ createSTOFileAdapterForReading(const std::string&);
 std::shared_ptr<DataAdapter>
 createSTOFileAdapterForWriting(const DataAdapter::InputTables&);
 
+ColumnSelection::ColumnSelection(const std::vector<std::string>& labels) :
+    _kind{Kind::Labels}, _labels{labels} {}
+
+ColumnSelection
+ColumnSelection::matching(const std::string& pattern) {
+    ColumnSelection selection{};
+    selection._kind = Kind::Pattern;
+    selection._pattern = pattern;
+    return selection;
+}
+
+std::vector<size_t>
+ColumnSelection::findColumns(const std::vector<std::string>& fileLabels) const {
+    std::vector<size_t> columns{};
+    switch(_kind) {
+    case Kind::All:
+        for(size_t c = 0; c < fileLabels.size(); ++c)
+            columns.push_back(c);
+        break;
+    case Kind::Labels: {
+        std::unordered_map<std::string, size_t> indices{};
+        for(size_t c = 0; c < fileLabels.size(); ++c)
+            indices.emplace(fileLabels[c], c);
+        for(const auto& label : _labels) {
+            auto found = indices.find(label);
+            OPENSIM_THROW_IF(found == indices.end(),
+                             KeyNotFound,
+                             label);
+            columns.push_back(found->second);
+        }
+        break;
+    }
+    case Kind::Pattern: {
+        const std::regex pattern{_pattern};
+        for(size_t c = 0; c < fileLabels.size(); ++c)
+            if(std::regex_match(fileLabels[c], pattern))
+                columns.push_back(c);
+        break;
+    }
+    }
+    return columns;
+}
+
 FileAdapter::OutputTables
 FileAdapter::readFile(const std::string& fileName) {
     auto extension = findExtension(fileName);
@@ -20,6 +68,12 @@ FileAdapter::readFile(const std::string& fileName) {
     return fileAdapter.extendRead(fileName);
 }
 
+std::future<FileAdapter::OutputTables>
+FileAdapter::readFileAsync(const std::string& fileName) {
+    return std::async(std::launch::async, 
+                      [fileName] { return readFile(fileName); });
+}
+
 void 
 FileAdapter::writeFile(const InputTables& tables, 
                        const std::string& fileName) {
@@ -89,4 +143,72 @@ FileAdapter::getNextLine(std::istream& stream,
     return {};
 }
 
+bool
+FileAdapter::getNextLine(std::istream& stream,
+                         const std::string& delims,
+                         std::string& line) const {
+    while(std::getline(stream, line)) {
+        if(line.find_first_not_of(delims) != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+void
+FileAdapter::parseNumbers(const std::string& line,
+                          const std::string& delims,
+                          const std::string& compDelims,
+                          std::vector<double>& values,
+                          std::vector<unsigned>& numComps) const {
+    values.clear();
+    numComps.clear();
+
+    auto isDelim = [&delims](char ch) {
+        return delims.find(ch) != std::string::npos;
+    };
+    auto isCompDelim = [&compDelims](char ch) {
+        return compDelims.find(ch) != std::string::npos;
+    };
+
+    const char* ptr = line.c_str();
+    const char* const end = ptr + line.size();
+    bool in_elem{false};
+    while(ptr < end) {
+        if(isDelim(*ptr)) {
+            in_elem = false;
+            ++ptr;
+            continue;
+        }
+        // Skip component delimiters and stray whitespace (e.g. a trailing
+        // '\r') that is not a delimiter.
+        if(isCompDelim(*ptr) ||
+           std::isspace(static_cast<unsigned char>(*ptr))) {
+            ++ptr;
+            continue;
+        }
+
+        char* num_end{};
+        const double value = std::strtod(ptr, &num_end);
+        if(num_end == ptr) {
+            const char* tok_end = ptr;
+            while(tok_end < end && !isDelim(*tok_end) && !isCompDelim(*tok_end))
+                ++tok_end;
+            OPENSIM_THROW(Exception,
+                          "Expected a number but found '" +
+                          std::string(ptr, tok_end) + "'.");
+        }
+
+        if(!in_elem) {
+            numComps.push_back(0);
+            in_elem = true;
+        }
+        values.push_back(value);
+        ++numComps.back();
+
+        ptr = num_end;
+        while(ptr < end && !isDelim(*ptr) && !isCompDelim(*ptr))
+            ++ptr;
+    }
+}
+
 } // namespace OpenSim
@@ -28,6 +28,8 @@
 */
 #include "DataAdapter.h"
 
+#include <future>
+#include <initializer_list>
 #include <vector>
 
 namespace OpenSim {
@@ -174,6 +176,46 @@ public:
     }
 };
 
+/** Selection of the columns of a table to be read from a file: either every
+column, the columns with the given labels (in the given order), or the columns
+whose labels match a regular expression (in the order of the file). Adapters
+that accept a selection skip the conversion and storage of the other columns;
+see, e.g., STOFileAdapter_::readColumns().                                    */
+class OSIMCOMMON_API ColumnSelection {
+public:
+    /** Select every column.                                                  */
+    ColumnSelection() = default;
+
+    /** Select the columns with the given labels, in the given order.         */
+    ColumnSelection(const std::vector<std::string>& labels);
+
+#ifndef SWIG
+    /** Select the columns with the given labels, in the given order.         */
+    ColumnSelection(std::initializer_list<std::string> labels) :
+        ColumnSelection(std::vector<std::string>(labels)) {}
+#endif
+
+    /** Select the columns whose labels match (entirely) the given ECMAScript
+    regular expression, in the order of the file.                             */
+    static ColumnSelection matching(const std::string& pattern);
+
+    /** Whether every column is selected.                                     */
+    bool selectsAll() const { return _kind == Kind::All; }
+
+    /** Get the indices, among the given labels of the columns in a file, of
+    the columns selected.
+
+    	hrows KeyNotFound If one of the labels selected is not in the file.    */
+    std::vector<size_t> 
+    findColumns(const std::vector<std::string>& fileLabels) const;
+
+private:
+    enum class Kind { All, Labels, Pattern };
+    Kind                     _kind{Kind::All};
+    std::vector<std::string> _labels{};
+    std::string              _pattern{};
+};
+
 /** FileAdapter is a DataAdapter that reads and writes files with methods
 readFile and writeFile respectively.                                          */
 class OSIMCOMMON_API FileAdapter : public DataAdapter {
@@ -191,6 +233,25 @@ public:
     the specific adapter's documentation to see what was returned.            */
     static OutputTables readFile(const std::string& fileName);
 
+#ifndef SWIG
+    /** Start reading a file with the given name on another thread and return
+    immediately. The tables are obtained from the returned future, which
+    rethrows any exception thrown while reading. Several files can be read at
+    once this way, e.g., the marker and force files of a trial:
+
+    @code
+    auto markers = FileAdapter::readFileAsync("walk.trc");
+    auto forces  = FileAdapter::readFileAsync("walk_grf.mot");
+    // ... build the model meanwhile.
+    auto markerTables = markers.get();
+    auto forceTables  = forces.get();
+    @endcode
+
+    Relative file names are resolved when the file is opened, so the working
+    directory must not be changed until the tables are obtained.             */
+    static std::future<OutputTables> readFileAsync(const std::string& fileName);
+#endif
+
     /** Write a collection of tables to the given file. Different file formats
     require different number/type of tables. See specific adapter's 
     documentation to see what is required.                                    */
@@ -213,6 +274,29 @@ protected:
     the given delimiters.                                                     */
     std::vector<std::string> getNextLine(std::istream& stream,
                                          const std::string& delims) const;
+
+    /** Get the next line from the stream that contains at least one character
+    other than the given delimiters. The line is read into the given string so
+    that its storage can be reused from one line to the next. Returns false if
+    the end of the stream is reached before such a line is found.             */
+    bool getNextLine(std::istream& stream,
+                     const std::string& delims,
+                     std::string& line) const;
+
+    /** Parse the numbers in a line without splitting the line into strings.
+    Elements are separated by any of the characters in `delims` and the
+    components within an element are separated by any of the characters in
+    `compDelims` (which may be empty). On return, `values` holds the
+    components of all the elements in order and `numComps` holds the number of
+    components found in each element. As with std::stod(), characters
+    following a number up to the next delimiter are ignored.
+
+    \throws Exception If an element/component does not start with a number.  */
+    void parseNumbers(const std::string& line,
+                      const std::string& delims,
+                      const std::string& compDelims,
+                      std::vector<double>& values,
+                      std::vector<unsigned>& numComps) const;
 };
 
 } // OpenSim namespace
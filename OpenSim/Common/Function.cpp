@@ -29,6 +29,10 @@
 // INCLUDES
 #include "Function.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
 
 using namespace OpenSim;
 using namespace std;
@@ -38,7 +42,23 @@ using SimTK::Vector;
 //=============================================================================
 // STATICS
 //=============================================================================
+namespace {
+    // Serialize the creation of the SimTK::Function of each function. A
+    // function uses one of these mutexes, chosen from its address, so that
+    // different functions (e.g., the splines of a GCVSplineSet) are usually
+    // created concurrently.
+    const int numSimTKFunctionMutexes = 64;
+    std::mutex simTKFunctionMutexes[numSimTKFunctionMutexes];
+
+    std::mutex& getSimTKFunctionMutex(const Function* function) {
+        const std::uintptr_t address =
+            reinterpret_cast<std::uintptr_t>(function);
+        return simTKFunctionMutexes[(address / 64) % numSimTKFunctionMutexes];
+    }
 
+    // The source of the revisions of all functions.
+    std::atomic<long long> lastRevision(0);
+}
 
 //=============================================================================
 // DESTRUCTOR AND CONSTRUCTORS
@@ -49,15 +69,15 @@ using SimTK::Vector;
  */
 Function::~Function()
 {
-    if (_function != NULL)
-        delete _function;
+    delete _function.load();
 }
 //_____________________________________________________________________________
 /**
  * Default constructor.
  */
 Function::Function() :
-    _function(NULL)
+    _function(NULL),
+    _revision(++lastRevision)
 {
     setNull();
 }
@@ -69,7 +89,8 @@ Function::Function() :
  */
 Function::Function(const Function &aFunction) :
     Object(aFunction),
-    _function(NULL)
+    _function(NULL),
+    _revision(++lastRevision)
 {
 }
 
@@ -100,6 +121,7 @@ operator=(const Function &aFunction)
 {
     // BASE CLASS
     Object::operator=(aFunction);
+    _revision = ++lastRevision;
 
     return(*this);
 }
@@ -161,35 +183,88 @@ evaluateTotalSecondDerivative(double aX,double aDxdt,double aD2xdt2)
 */
 double Function::calcValue(const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcValue(x);
+    return getSimTKFunction().calcValue(x);
 }
 
 double Function::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcDerivative(derivComponents, x);
+    return getSimTKFunction().calcDerivative(derivComponents, x);
+}
+
+double Function::calcValue(double x) const
+{
+    return calcValue(Vector(1, x));
+}
+
+double Function::calcDerivative(double x, int order) const
+{
+    return calcDerivative(std::vector<int>(order, 0), Vector(1, x));
+}
+
+void Function::calcValues(const Vector& x, Vector& values) const
+{
+    values.resize(x.size());
+    for (int i = 0; i < x.size(); ++i)
+        values[i] = calcValue(x[i]);
+}
+
+double Function::calcValueNear(double x, int& interval) const
+{
+    return calcValue(x);
+}
+
+SimTK::Vec3 Function::calcValueAndDerivativesNear(double x,
+                                                  int& interval) const
+{
+    const int maxOrder = getMaxDerivativeOrder();
+    return SimTK::Vec3(calcValueNear(x, interval),
+                       maxOrder >= 1 ? calcDerivative(x, 1) : 0.0,
+                       maxOrder >= 2 ? calcDerivative(x, 2) : 0.0);
+}
+
+bool Function::findIntervalNear(const double* xs, int n, double x,
+                                int& interval)
+{
+    if (n < 2) return false;
+    auto contains = [&](int k) {
+        return k >= 0 && k < n - 1 && xs[k] < x && x < xs[k + 1];
+    };
+    if (contains(interval)) return true;
+    if (contains(interval + 1)) {
+        ++interval;
+        return true;
+    }
+    int k = (int)(std::upper_bound(xs, xs + n, x) - xs) - 1;
+    interval = std::min(std::max(k, 0), n - 2);
+    return contains(interval);
 }
 
 int Function::getArgumentSize() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getArgumentSize();
+    return getSimTKFunction().getArgumentSize();
 }
 
 int Function::getMaxDerivativeOrder() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getMaxDerivativeOrder();
+    return getSimTKFunction().getMaxDerivativeOrder();
+}
+
+const SimTK::Function& Function::getSimTKFunction() const
+{
+    SimTK::Function* function = _function.load(std::memory_order_acquire);
+    if (function == NULL) {
+        std::lock_guard<std::mutex> lock(getSimTKFunctionMutex(this));
+        function = _function.load(std::memory_order_relaxed);
+        if (function == NULL) {
+            function = createSimTKFunction();
+            _function.store(function, std::memory_order_release);
+        }
+    }
+    return *function;
 }
 
 void Function::resetFunction()
 {
-    if (_function != NULL)
-        delete _function;
-    _function = NULL;
+    delete _function.exchange(NULL);
+    _revision = ++lastRevision;
 }
@@ -32,6 +32,8 @@
 #include "Object.h"
 #include "SimTKmath.h"
 
+#include <atomic>
+
 
 //=============================================================================
 //=============================================================================
@@ -58,8 +60,14 @@ OpenSim_DECLARE_ABSTRACT_OBJECT(Function, Object);
 // DATA
 //=============================================================================
 protected:
-    // The SimTK::Function object implementing this function.
-    mutable SimTK::Function* _function;
+    // The SimTK::Function object implementing this function. It is created
+    // the first time the function is evaluated, possibly by several threads
+    // at once, so it is only accessed through getSimTKFunction().
+    mutable std::atomic<SimTK::Function*> _function;
+
+private:
+    // See getRevision().
+    long long _revision;
 
 //=============================================================================
 // METHODS
@@ -114,6 +122,64 @@ public:
      * @param x                the Vector of input arguments.  Its size must equal the value returned by getArgumentSize().
      */
     virtual double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    /**
+     * Calculate the value of this function of one argument at x. This avoids
+     * constructing a Vector of arguments, and the functions of one argument
+     * in OpenSim (e.g., SimmSpline, GCVSpline, PiecewiseLinearFunction,
+     * LinearFunction, PolynomialFunction, MultiplierFunction) evaluate it
+     * without allocating memory.
+     */
+    virtual double calcValue(double x) const;
+    /**
+     * Calculate the derivative of the given order of this function of one
+     * argument at x, without constructing the Vector of arguments and the list
+     * of derivative components that calcDerivative() otherwise takes.
+     *
+     * @param x      the argument.
+     * @param order  the order of the derivative; at least 1 and at most the
+     *               value returned by getMaxDerivativeOrder().
+     */
+    virtual double calcDerivative(double x, int order) const;
+    /**
+     * Calculate the values of this function of one argument at each of the
+     * elements of x. The results are those of calcValue(x[i]).
+     *
+     * @param x       the arguments.
+     * @param values  the values of the function. It is resized to the size of
+     *                x, so no memory is allocated if it already has that size.
+     */
+    virtual void calcValues(const SimTK::Vector& x, SimTK::Vector& values) const;
+    /**
+     * Calculate the value of this function of one argument at x, as
+     * calcValue(x) does, given the interval between the points of the
+     * function (e.g., the knots of a SimmSpline) that contained the argument
+     * of a previous call. When the arguments change little from one call to
+     * the next (e.g., the times of a simulation), the interval of x is then
+     * usually found without searching all the points. The functions with
+     * points in OpenSim (SimmSpline, PiecewiseLinearFunction,
+     * PiecewiseConstantFunction) make use of the interval; other functions
+     * ignore it.
+     *
+     * @param x         the argument.
+     * @param interval  the interval to try first, updated to the interval of
+     *                  x. Any value is accepted, e.g., 0 for the first call.
+     */
+    virtual double calcValueNear(double x, int& interval) const;
+    /**
+     * Calculate the value of this function of one argument at x and its
+     * first and second derivatives there, given the interval of a previous
+     * call as calcValueNear() does. SimmSpline finds the interval of x once
+     * for all three. A derivative of an order greater than
+     * getMaxDerivativeOrder() is 0 (e.g., the second derivative of a
+     * PiecewiseLinearFunction).
+     *
+     * @param x         the argument.
+     * @param interval  the interval to try first, updated to the interval of
+     *                  x.
+     * @return the value, first derivative and second derivative.
+     */
+    virtual SimTK::Vec3 calcValueAndDerivativesNear(double x,
+                                                    int& interval) const;
     /**
      * Get the number of components expected in the input vector.
      */
@@ -127,13 +193,37 @@ public:
      * underlying SimTK::System and its elements.
      */
     virtual SimTK::Function* createSimTKFunction() const = 0;
+    /**
+     * A number that identifies the current definition of this function. It
+     * changes whenever the function is modified (see resetFunction()), and no
+     * two Function objects share one, so objects that keep values computed
+     * from functions (e.g., GCVSplineSet) can tell when to compute them
+     * again.
+     */
+    long long getRevision() const { return _revision; }
 
 protected:
     /**
      * This should be called whenever this object has been modified.  It clears 
-     * the internal SimTK::Function object used to evaluate it.
+     * the internal SimTK::Function object used to evaluate it, and gives the
+     * function a new revision.
      */
     void resetFunction();
+    /**
+     * Get the SimTK::Function implementing this function, creating it if
+     * necessary.
+     */
+    const SimTK::Function& getSimTKFunction() const;
+    /**
+     * For a function with n points at the increasing abscissae xs, find the
+     * interval (xs[interval], xs[interval+1]) that strictly contains x. The
+     * given interval and the next one are tried before searching all the
+     * points. Returns false, after setting interval to the nearest interval,
+     * if x is not strictly inside any interval (e.g., it is on a point or out
+     * of range).
+     */
+    static bool findIntervalNear(const double* xs, int n, double x,
+                                 int& interval);
 
 //=============================================================================
 };  // END class Function
@@ -52,6 +52,10 @@ double FunctionAdapter::calcDerivative(const std::vector<int>& derivComponents,
 }
 
 double FunctionAdapter::calcDerivative(const SimTK::Array_<int>& derivComponents, const SimTK::Vector& x) const{
+    // The derivative of a function of one argument is only a matter of
+    // order, which avoids copying the components.
+    if (x.size() == 1)
+        return _function.calcDerivative(x[0], (int)derivComponents.size());
     std::vector<int> dcs(derivComponents.begin(), derivComponents.end());
     return _function.calcDerivative(dcs, x);
 }
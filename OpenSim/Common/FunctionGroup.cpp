@@ -0,0 +1,93 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  FunctionGroup.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "FunctionGroup.h"
+#include "Function.h"
+
+using namespace OpenSim;
+
+namespace {
+// A SimTK::Function of one argument evaluated through a FunctionGroup.
+class GroupedFunction : public SimTK::Function {
+public:
+    GroupedFunction(std::shared_ptr<const FunctionGroup> group, int index,
+                    double scale)
+        : _group(std::move(group)), _index(index), _scale(scale) {}
+
+    double calcValue(const SimTK::Vector& x) const override {
+        return _scale*_group->calcValueAndDerivatives(_index, x[0])[0];
+    }
+    double calcDerivative(const std::vector<int>& derivComponents,
+                          const SimTK::Vector& x) const {
+        return calcDerivative(SimTK::ArrayViewConst_<int>(derivComponents), x);
+    }
+    double calcDerivative(const SimTK::Array_<int>& derivComponents,
+                          const SimTK::Vector& x) const override {
+        const int order = (int)derivComponents.size();
+        if (order < 1 || order > 2) return 0;
+        return _scale*_group->calcValueAndDerivatives(_index, x[0])[order];
+    }
+    int getArgumentSize() const override { return 1; }
+    int getMaxDerivativeOrder() const override { return 2; }
+
+private:
+    std::shared_ptr<const FunctionGroup> _group;
+    int _index;
+    double _scale;
+};
+}
+
+int FunctionGroup::addFunction(const Function& function)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _functions.push_back(&function);
+    _revisions.push_back(-1);
+    _intervals.push_back(0);
+    _results.push_back(SimTK::Vec3(SimTK::NaN));
+    _x = SimTK::NaN;
+    return getNumFunctions() - 1;
+}
+
+SimTK::Vec3 FunctionGroup::calcValueAndDerivatives(int index, double x) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const int n = getNumFunctions();
+    bool current = (x == _x);
+    for (int i = 0; current && i < n; ++i)
+        current = (_functions[i]->getRevision() == _revisions[i]);
+    if (!current) {
+        for (int i = 0; i < n; ++i) {
+            _results[i] =
+                _functions[i]->calcValueAndDerivativesNear(x, _intervals[i]);
+            _revisions[i] = _functions[i]->getRevision();
+        }
+        _x = x;
+    }
+    return _results[index];
+}
+
+SimTK::Function* FunctionGroup::createSimTKFunction(
+        const std::shared_ptr<const FunctionGroup>& group, int index,
+        double scale)
+{
+    return new GroupedFunction(group, index, scale);
+}
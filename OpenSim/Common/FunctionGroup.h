@@ -0,0 +1,91 @@
+#ifndef OPENSIM_FUNCTION_GROUP_H_
+#define OPENSIM_FUNCTION_GROUP_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  FunctionGroup.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "osimCommonDLL.h"
+#include "SimTKcommon/SmallMatrix.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace SimTK { class Function; }
+
+namespace OpenSim {
+
+class Function;
+
+/** Functions of one argument that are always evaluated at the same argument
+(e.g., the coupler functions of the coordinates that follow one knee angle),
+so that the values and first and second derivatives of all of them are
+computed together and kept until the argument changes.
+
+The first request for a result at an argument computes the results of all
+the functions there, each function finding its interval near the one of the
+previous argument (see Function::calcValueAndDerivativesNear()). Later
+requests at the same argument, for any of the functions and any derivative,
+use the kept results, as long as none of the functions has been modified
+since.
+
+The functions are not owned and must outlive the group. A group may be
+shared by SimTK::Functions made by createSimTKFunction() and evaluated from
+several threads. */
+class OSIMCOMMON_API FunctionGroup {
+public:
+    FunctionGroup() = default;
+    FunctionGroup(const FunctionGroup&) = delete;
+    FunctionGroup& operator=(const FunctionGroup&) = delete;
+
+    /** Add a function of one argument to the group.
+    @return the index of the function in the group. */
+    int addFunction(const Function& function);
+    /** The number of functions in the group. */
+    int getNumFunctions() const { return (int)_functions.size(); }
+
+    /** The value, first derivative and second derivative of the function
+    with the given index at x. */
+    SimTK::Vec3 calcValueAndDerivatives(int index, double x) const;
+
+    /** A SimTK::Function of one argument that evaluates the function with the
+    given index through the group, scaled by scale, and shares ownership of
+    the group. The caller takes ownership of it. */
+    static SimTK::Function* createSimTKFunction(
+            const std::shared_ptr<const FunctionGroup>& group, int index,
+            double scale = 1.0);
+
+private:
+    std::vector<const Function*> _functions;
+
+    // The argument of the kept results, the revisions of the functions they
+    // were computed with, the intervals of the argument and the results.
+    mutable std::mutex _mutex;
+    mutable double _x = SimTK::NaN;
+    mutable std::vector<long long> _revisions;
+    mutable std::vector<int> _intervals;
+    mutable std::vector<SimTK::Vec3> _results;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_FUNCTION_GROUP_H_
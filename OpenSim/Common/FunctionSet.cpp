@@ -154,3 +154,29 @@ evaluate(Array<double> &rValues,int aDerivOrder,double aX) const
         }
     }
 }
+//_____________________________________________________________________________
+/**
+ * Evaluate all the functions in the function set and their first and second
+ * derivatives.
+ *
+ * @param aX Value of the independent variable.
+ * @param rValues Values of the functions.
+ * @param rFirstDerivatives First derivatives of the functions.
+ * @param rSecondDerivatives Second derivatives of the functions.
+ */
+void FunctionSet::
+evaluateWithDerivatives(double aX,SimTK::Vector &rValues,
+    SimTK::Vector &rFirstDerivatives,SimTK::Vector &rSecondDerivatives) const
+{
+    int size = getSize();
+    rValues.resize(size);
+    rFirstDerivatives.resize(size);
+    rSecondDerivatives.resize(size);
+
+    for(int i=0;i<size;i++) {
+        const Function& func = get(i);
+        rValues[i] = func.calcValue(aX);
+        rFirstDerivatives[i] = func.calcDerivative(aX,1);
+        rSecondDerivatives[i] = func.calcDerivative(aX,2);
+    }
+}
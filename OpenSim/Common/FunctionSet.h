@@ -75,6 +75,16 @@ public:
     virtual void
         evaluate(Array<double> &rValues,int aDerivOrder,
         double aX=0.0) const;
+    /**
+     * Evaluate all the functions in the set, which must be functions of one
+     * argument, and their first and second derivatives at aX (e.g., the
+     * generalized coordinates, speeds and accelerations of a model at a
+     * time). The vectors are resized to the size of the set.
+     */
+    virtual void
+        evaluateWithDerivatives(double aX,SimTK::Vector &rValues,
+        SimTK::Vector &rFirstDerivatives,
+        SimTK::Vector &rSecondDerivatives) const;
 
 //=============================================================================
 };  // END class FunctionSet
@@ -340,6 +340,7 @@ operator=(const GCVSpline &aSpline)
 
     // DATA
     setEqual(aSpline);
+    resetFunction();
 
     return(*this);
 }
@@ -437,6 +438,8 @@ getYValues() const
 const Array<double>& GCVSpline::
 getCoefficients() const
 {
+    // The coefficients are computed when the spline is fit.
+    getSimTKFunction();
     return(_coefficients);
 }
 
@@ -489,6 +492,23 @@ setY(int aIndex, double aValue)
     }
 }
 
+void GCVSpline::
+setPoints(int aN, const double *aX, const double *aF)
+{
+    if (aN < getOrder())
+        throw Exception("GCVSpline::setPoints(): there must be " +
+            std::to_string(getOrder()) + " or more data points.");
+
+    _x.setSize(0);
+    _x.append(aN,aX);
+    _y.setSize(0);
+    _y.append(aN,aF);
+    _weights.setSize(aN);
+    for (int i = 0; i < aN; ++i) _weights[i] = 1.0;
+    _coefficients.setSize(aN);
+    resetFunction();
+}
+
 //-----------------------------------------------------------------------------
 // MIN AND MAX X
 //-----------------------------------------------------------------------------
@@ -580,6 +600,17 @@ addPoint(double aX, double aY)
     return i;
 }
 
+double GCVSpline::calcValue(double x) const
+{
+    return static_cast<const SimTK::Spline&>(getSimTKFunction()).calcValue(x);
+}
+
+double GCVSpline::calcDerivative(double x, int order) const
+{
+    return static_cast<const SimTK::Spline&>(getSimTKFunction())
+        .calcDerivative(order, x);
+}
+
 SimTK::Function* GCVSpline::createSimTKFunction() const {
     int degree = _halfOrder*2-1;
     Vector x(_x.getSize());
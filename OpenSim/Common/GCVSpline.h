@@ -197,7 +197,8 @@ public:
      */
     virtual const double* getYValues() const;
     /**
-     * Get the array of coefficients for the spline.
+     * Get the array of coefficients for the spline, fitting the spline to its
+     * data points first if it has not been fit since they last changed.
      *
      * @return Pointer to the coefficients.
      */
@@ -228,11 +229,23 @@ public:
     virtual bool deletePoint(int aIndex);
     virtual bool deletePoints(const Array<int>& indices);
     virtual int addPoint(double aX, double aY);
+    /**
+     * Replace the data points, keeping the degree and error variance, so that
+     * the spline is fit again to the new points. Those referring to this
+     * spline (e.g., tracking tasks) then see the new fit.
+     *
+     * @param aN Number of data points; at least getOrder().
+     * @param aX %Array of independent values- should be aN long.
+     * @param aF %Array of function values- should be aN long.
+     */
+    void setPoints(int aN, const double *aX, const double *aF);
     SimTK::Function* createSimTKFunction() const override;
 
     //--------------------------------------------------------------------------
     // EVALUATION
     //--------------------------------------------------------------------------
+    double calcValue(double x) const override;
+    double calcDerivative(double x, int order) const override;
 
 //=============================================================================
 };  // END class GCVSpline
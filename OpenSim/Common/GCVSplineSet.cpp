@@ -30,15 +30,175 @@
 #include "GCVSplineSet.h"
 #include "GCVSpline.h"
 #include "Storage.h"
+#include "gcvspl.h"
+#include "ThreadPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+
+using namespace OpenSim;
 
 //=============================================================================
-// DESTRUCTOR AND CONSTRUCTORS
+// BATCH LAYOUT
 //=============================================================================
-//_____________________________________________________________________________
+/* The splines of a set laid out for evaluating all of them at once. */
+class GCVSplineSet::BatchLayout {
+public:
+    // The functions of the set when the layout was made, and their revisions.
+    std::vector<const Function*> functions;
+    std::vector<long long> revisions;
+
+    // Splines with the same half order and knots. Row k of the coefficients
+    // holds coefficient k of each spline of the group.
+    struct Group {
+        int halfOrder;
+        std::vector<double> knots;
+        std::vector<int> indices;
+        std::vector<double> coefficients;
+    };
+    std::vector<Group> groups;
+
+    // The indices of the functions that are evaluated on their own.
+    std::vector<int> others;
+};
+
+namespace {
+    // Number of rows that constructStorage() evaluates into a buffer before
+    // appending them, which bounds the memory it uses.
+    const int ROW_BLOCK_SIZE = 1024;
+
+    // Fit the splines, on several threads if aNumThreads is not 1 (0 for as
+    // many as ThreadPool allows).
+    void fitSplines(const std::vector<GCVSpline*>& splines, int aNumThreads)
+    {
+        ThreadPool::parallelFor((int)splines.size(), aNumThreads,
+            [&](int i) { splines[i]->getCoefficients(); });
+    }
 
+    // Evaluate the derivative of order aDerivOrder (0 for the value) at aX of
+    // the aNumSplines splines of half order aM whose aN coefficients are laid
+    // out in the rows of aC, one column per spline. This is the recurrence of
+    // splder() in gcvspl.c, with each entry of its tableau replaced by a row
+    // of aWork (2*aM rows), so that the interval of aX, aL, is searched for
+    // only once.
+    void splderSplines(int aDerivOrder,int aM,int aN,double aX,
+        const double* aKnots,const double* aC,int aNumSplines,int aL,
+        double* aWork,double* rValues)
+    {
+        const int nc = aNumSplines;
+        auto row = [&](int i) { return aWork + i*nc; };
+
+        int m2 = 2*aM;
+        int k = m2-aDerivOrder;
+        if(k<1) {
+            std::fill(rValues,rValues+nc,0.0);
+            return;
+        }
 
-using namespace OpenSim;
+        int mp1 = aM+1, npm = aN+aM, m2m1 = m2-1, k1 = k-1, nk = aN-k;
+        int lk1 = aL-k+1, jl = aL+1, ju = aL+m2, ii = aN-m2, ml = -aL;
+
+        for(int j=jl;j<=ju;j++) {
+            double* q = row(j+ml-1);
+            if(j>=mp1 && j<=npm) std::copy(aC+(j-aM-1)*nc,aC+(j-aM)*nc,q);
+            else std::fill(q,q+nc,0.0);
+        }
+
+        // DIFFERENCES OF THE COEFFICIENTS
+        if(aDerivOrder>0) {
+            jl -= m2;
+            ml += m2;
+            for(int i=1;i<=aDerivOrder;i++) {
+                jl++;
+                ii++;
+                int j1 = std::max(1,jl);
+                int j2 = std::min(aL,ii);
+                int mi = m2-i;
+                int j = j2+1;
+                for(int jin=j1;jin<=j2;jin++) {
+                    j--;
+                    int jm = ml+j;
+                    double* q = row(jm-1);
+                    const double* qPrev = row(jm-2);
+                    double dx = aKnots[j+mi-1]-aKnots[j-1];
+                    for(int c=0;c<nc;c++) q[c] = (q[c]-qPrev[c])/dx;
+                }
+                if(jl<1) {
+                    j = ml+1;
+                    for(int jin=i+1;jin<=ml;jin++) {
+                        j--;
+                        double* q = row(j-1);
+                        const double* qPrev = row(j-2);
+                        for(int c=0;c<nc;c++) q[c] = -qPrev[c];
+                    }
+                }
+            }
+            for(int j=1;j<=k;j++)
+                std::copy(row(j+aDerivOrder-1),row(j+aDerivOrder),row(j-1));
+        }
+
+        // LOWER HALF OF THE EVALUATION TABLEAU
+        for(int i=1;i<=k1;i++) {
+            int nki = nk+i;
+            int ir = k;
+            int jj = aL;
+            int ki = k-i;
+
+            // Right hand splines
+            for(int j=nki+1;j<=aL;j++) {
+                double* q = row(ir-1);
+                const double* qPrev = row(ir-2);
+                double dt = aX-aKnots[jj-1];
+                for(int c=0;c<nc;c++) q[c] = qPrev[c]+dt*q[c];
+                jj--;
+                ir--;
+            }
+
+            // Middle B-splines
+            int lk1i = lk1+i;
+            int j1 = std::max(1,lk1i);
+            int j2 = std::min(aL,nki);
+            for(int j=j1;j<=j2;j++) {
+                double xjki = aKnots[jj+ki-1];
+                double* q = row(ir-1);
+                const double* qPrev = row(ir-2);
+                double a = xjki-aX, b = xjki-aKnots[jj-1];
+                for(int c=0;c<nc;c++) q[c] = q[c]+a*(qPrev[c]-q[c])/b;
+                ir--;
+                jj--;
+            }
+
+            // Left hand B-splines
+            if(lk1i<=0) {
+                jj = ki;
+                for(int j=1;j<=1-lk1i;j++) {
+                    double* q = row(ir-1);
+                    const double* qPrev = row(ir-2);
+                    double dt = aKnots[jj-1]-aX;
+                    for(int c=0;c<nc;c++) q[c] = q[c]+dt*qPrev[c];
+                    jj--;
+                    ir--;
+                }
+            }
+        }
+
+        // RESULT, MULTIPLIED BY THE FACTORIAL FOR DERIVATIVES
+        const double* q = row(k-1);
+        for(int c=0;c<nc;c++) {
+            double z = q[c];
+            if(aDerivOrder>0)
+                for(int j=k;j<=m2m1;j++) z *= j;
+            rValues[c] = z;
+        }
+    }
+}
+
+//=============================================================================
+// DESTRUCTOR AND CONSTRUCTORS
+//=============================================================================
+//_____________________________________________________________________________
 /**
  * Destructor.
  */
@@ -86,11 +246,15 @@ GCVSplineSet(const char *aFileName) :
  * the error variance assumed for each column in the Storage.  If different
  * variances should be set for the various columns, you will need to
  * construct each GCVSpline individually.
+ * @param aNumThreads Number of threads on which the splines are fit, since
+ * the columns are fit independently; 0 (the default) for one per hardware
+ * thread.
  * @see Storage
  * @see GCVSpline
  */
 GCVSplineSet::
-GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance)
+GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance,
+             int aNumThreads)
 {
     setNull();
     if(aStore==NULL) return;
@@ -102,7 +266,7 @@ GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance)
     ensureCapacity(2*vec->getSize());
 
     // CONSTRUCT
-    construct(aDegree,aStore,aErrorVariance);
+    construct(aDegree,aStore,aErrorVariance,aNumThreads);
 }
 
 
@@ -125,9 +289,11 @@ setNull()
  * @param aDegree Degree of the constructed splines (1, 3, 5, or 7).
  * @param aStore Storage object.
  * @param aErrorVariance Error variance for the data.
+ * @param aNumThreads Number of threads on which to fit the splines.
  */
 void GCVSplineSet::
-construct(int aDegree,const Storage *aStore,double aErrorVariance)
+construct(int aDegree,const Storage *aStore,double aErrorVariance,
+          int aNumThreads)
 {
     if(aStore==NULL) return;
 
@@ -143,6 +309,7 @@ construct(int aDegree,const Storage *aStore,double aErrorVariance)
     int nTime=1,nData=1;
     double *times=NULL,*data=NULL;
     GCVSpline *spline;
+    std::vector<GCVSpline*> splines;
     //printf("GCVSplineSet.construct:  constructing splines...\n");
     for(int i=0;nData>0;i++) {
 
@@ -170,14 +337,17 @@ construct(int aDegree,const Storage *aStore,double aErrorVariance)
         // CONSTRUCT SPLINE
         //printf("%s\t",name);
         spline = new GCVSpline(aDegree,nData,times,data,name,aErrorVariance);
-        SimTK::Function* fp = spline->createSimTKFunction();
-        delete fp;  
 
         // ADD SPLINE
         adoptAndAppend(spline);
+        splines.push_back(spline);
     }
     //printf("\n%d splines constructed.\n\n",i);
 
+    // FIT THE SPLINES
+    // The columns are independent, so they are fit concurrently.
+    fitSplines(splines,aNumThreads);
+
     // CLEANUP
     if(times!=NULL) delete[] times;
     if(data!=NULL) delete[] data;
@@ -275,16 +445,11 @@ constructStorage(int aDerivOrder,double aDX)
     }
     store->setColumnLabels(labels);
 
-    // SET STATES
-    Array<double> y(0.0,n);
-
-    // LOOP THROUGH THE DATA
+    // INDEPENDENT VARIABLE
+    std::vector<double> xs;
     // constant increments
     if(aDX>0.0) {
-        for(double x=getMinX(); x<=getMaxX(); x+=aDX) {
-            evaluate(y,aDerivOrder,x);
-            store->append(x,n,&y[0]);
-        }
+        for(double x=getMinX(); x<=getMaxX(); x+=aDX) xs.push_back(x);
 
     // original independent variable increments
     } else {
@@ -296,13 +461,90 @@ constructStorage(int aDerivOrder,double aDX)
             if(xOrig[ix]<getMinX()) continue;
             if(xOrig[ix]>getMaxX()) break;
 
-            evaluate(y,aDerivOrder,xOrig[ix]);
-            store->append(xOrig[ix],n,&y[0]);
+            xs.push_back(xOrig[ix]);
         }
     }
 
+    // SET STATES
+    // Blocks of rows are evaluated on as many threads as ThreadPool allows
+    // and appended in order.
+    getBatchLayout();
+    const int nx = (int)xs.size();
+    const int numBlocks = (nx+ROW_BLOCK_SIZE-1)/ROW_BLOCK_SIZE;
+    const int numThreads = std::min(numBlocks,
+        ThreadPool::getMaxNumThreads());
+    std::vector<double> rows((size_t)numThreads*ROW_BLOCK_SIZE*n);
+    for(int first=0;first<numBlocks;first+=numThreads) {
+        int nb = std::min(numThreads,numBlocks-first);
+        ThreadPool::parallelFor(nb,nb,[&](int b) {
+            Array<double> y(0.0,n);
+            int begin = (first+b)*ROW_BLOCK_SIZE;
+            int end = std::min(nx,begin+ROW_BLOCK_SIZE);
+            double *row = rows.data()+(size_t)b*ROW_BLOCK_SIZE*n;
+            for(int ix=begin;ix<end;ix++,row+=n) {
+                evaluate(y,aDerivOrder,xs[ix]);
+                std::copy(&y[0],&y[0]+n,row);
+            }
+        });
+
+        int end = std::min(nx,(first+nb)*ROW_BLOCK_SIZE);
+        const double *row = rows.data();
+        for(int ix=first*ROW_BLOCK_SIZE;ix<end;ix++,row+=n)
+            store->append(xs[ix],n,row);
+    }
+
     return(store);
 }
+//_____________________________________________________________________________
+/**
+ * Fit each spline in this set again to the rows of a storage whose times are
+ * in a window [aTI,aTF], for example the latest frames of data streamed into
+ * the storage. The splines are updated in place, so that those already
+ * referring to them (e.g., the tasks of a CMC controller) track the new data.
+ *
+ * Each spline is fit to the column of the storage with the same name.
+ *
+ * @param aStore Storage holding the data.
+ * @param aTI First time of the window.
+ * @param aTF Last time of the window.
+ * @throws Exception if a spline has no column in the storage or there are
+ * fewer data points in the window than the order of a spline.
+ */
+void GCVSplineSet::
+fitWindow(const Storage& aStore,double aTI,double aTF)
+{
+    // ROWS IN THE WINDOW
+    int size = aStore.getSize();
+    int first = size>0 ? aStore.findIndex(aTI) : 0;
+    if(first<size && aStore.getStateVector(first)->getTime()<aTI) first++;
+    int last = first;
+    while(last<size && aStore.getStateVector(last)->getTime()<=aTF) last++;
+    int n = last - first;
+
+    std::vector<double> times(n),data(n);
+    for(int j=0;j<n;j++) times[j] = aStore.getStateVector(first+j)->getTime();
+
+    // FIT
+    std::vector<GCVSpline*> splines;
+    for(int i=0;i<getSize();i++) {
+        GCVSpline& spline = *getGCVSpline(i);
+        int column = aStore.getStateIndex(spline.getName());
+        OPENSIM_THROW_IF(column<0, Exception,
+            "GCVSplineSet::fitWindow: no column for spline '" +
+            spline.getName() + "'.");
+        OPENSIM_THROW_IF(n<spline.getOrder(), Exception,
+            "GCVSplineSet::fitWindow: only " + std::to_string(n) +
+            " data points between " + std::to_string(aTI) + " and " +
+            std::to_string(aTF) + ".");
+        for(int j=0;j<n;j++) {
+            data[j] = SimTK::NaN;
+            aStore.getStateVector(first+j)->getDataValue(column,data[j]);
+        }
+        spline.setPoints(n,&times[0],&data[0]);
+        splines.push_back(&spline);
+    }
+    fitSplines(splines,0);
+}
 
 double GCVSplineSet::getMinX() const
 {
@@ -329,3 +571,159 @@ double GCVSplineSet::getMaxX() const
 
     return max;
 }
+
+
+//=============================================================================
+// EVALUATION
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Get the layout of the splines for evaluating all of them at once. The
+ * layout is made again when a function of the set has been replaced or
+ * modified since it was made.
+ */
+std::shared_ptr<const GCVSplineSet::BatchLayout> GCVSplineSet::
+getBatchLayout() const
+{
+    int size = getSize();
+    std::shared_ptr<const BatchLayout> layout = std::atomic_load(&_batchLayout);
+    if(layout && (int)layout->functions.size()==size) {
+        bool current = true;
+        for(int i=0;current && i<size;i++) {
+            const Function& func = get(i);
+            current = &func==layout->functions[i] &&
+                      func.getRevision()==layout->revisions[i];
+        }
+        if(current) return layout;
+    }
+
+    auto newLayout = std::make_shared<BatchLayout>();
+    for(int i=0;i<size;i++) {
+        const Function& func = get(i);
+        newLayout->functions.push_back(&func);
+
+        const GCVSpline* spline = dynamic_cast<const GCVSpline*>(&func);
+        int n = spline ? spline->getSize() : 0;
+        if(!spline || n<spline->getOrder() ||
+           spline->getCoefficients().getSize()!=n) {
+            newLayout->others.push_back(i);
+            newLayout->revisions.push_back(func.getRevision());
+            continue;
+        }
+
+        // GROUP OF SPLINES WITH THE SAME KNOTS
+        const Array<double>& knots = spline->getX();
+        BatchLayout::Group* group = nullptr;
+        for(auto& candidate : newLayout->groups) {
+            if(candidate.halfOrder==spline->getHalfOrder() &&
+               (int)candidate.knots.size()==n &&
+               std::equal(candidate.knots.begin(),candidate.knots.end(),
+                          &knots[0])) {
+                group = &candidate;
+                break;
+            }
+        }
+        if(group==nullptr) {
+            newLayout->groups.emplace_back();
+            group = &newLayout->groups.back();
+            group->halfOrder = spline->getHalfOrder();
+            group->knots.assign(&knots[0],&knots[0]+n);
+        }
+        group->indices.push_back(i);
+        newLayout->revisions.push_back(func.getRevision());
+    }
+
+    // COEFFICIENTS, ONE ROW PER KNOT
+    for(auto& group : newLayout->groups) {
+        int n = (int)group.knots.size();
+        int nc = (int)group.indices.size();
+        group.coefficients.resize(n*nc);
+        for(int c=0;c<nc;c++) {
+            const Array<double>& coefficients =
+                ((const GCVSpline&)get(group.indices[c])).getCoefficients();
+            for(int k=0;k<n;k++) group.coefficients[k*nc+c] = coefficients[k];
+        }
+    }
+
+    layout = newLayout;
+    std::atomic_store(&_batchLayout,layout);
+    return layout;
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate all the functions in the set or their derivatives. The splines fit
+ * to the same knots are evaluated together.
+ *
+ * @param rValues Array containing the values of the functions.
+ * @param aDerivOrder Order of the derivative to evaluate.
+ * @param aX Value of the independent variable.
+ */
+void GCVSplineSet::
+evaluate(Array<double> &rValues,int aDerivOrder,double aX) const
+{
+    if(aDerivOrder<0) {
+        FunctionSet::evaluate(rValues,aDerivOrder,aX);
+        return;
+    }
+    rValues.setSize(getSize());
+
+    std::shared_ptr<const BatchLayout> layout = getBatchLayout();
+    std::vector<double> work,values;
+    for(const auto& group : layout->groups) {
+        int n = (int)group.knots.size();
+        int nc = (int)group.indices.size();
+        int l = 1;
+        search(n,const_cast<double*>(group.knots.data()),aX,&l);
+        work.resize(2*group.halfOrder*nc);
+        values.resize(nc);
+        splderSplines(aDerivOrder,group.halfOrder,n,aX,group.knots.data(),
+            group.coefficients.data(),nc,l,work.data(),values.data());
+        for(int c=0;c<nc;c++) rValues[group.indices[c]] = values[c];
+    }
+    for(int i : layout->others)
+        rValues[i] = FunctionSet::evaluate(i,aDerivOrder,aX);
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate all the functions in the set and their first and second
+ * derivatives. The splines fit to the same knots are evaluated together,
+ * with one search for the interval of aX.
+ *
+ * @param aX Value of the independent variable.
+ * @param rValues Values of the functions.
+ * @param rFirstDerivatives First derivatives of the functions.
+ * @param rSecondDerivatives Second derivatives of the functions.
+ */
+void GCVSplineSet::
+evaluateWithDerivatives(double aX,SimTK::Vector &rValues,
+    SimTK::Vector &rFirstDerivatives,SimTK::Vector &rSecondDerivatives) const
+{
+    int size = getSize();
+    rValues.resize(size);
+    rFirstDerivatives.resize(size);
+    rSecondDerivatives.resize(size);
+    SimTK::Vector* results[3] = {&rValues,&rFirstDerivatives,
+                                 &rSecondDerivatives};
+
+    std::shared_ptr<const BatchLayout> layout = getBatchLayout();
+    std::vector<double> work,values;
+    for(const auto& group : layout->groups) {
+        int n = (int)group.knots.size();
+        int nc = (int)group.indices.size();
+        int l = 1;
+        search(n,const_cast<double*>(group.knots.data()),aX,&l);
+        work.resize(2*group.halfOrder*nc);
+        values.resize(nc);
+        for(int order=0;order<=2;order++) {
+            splderSplines(order,group.halfOrder,n,aX,group.knots.data(),
+                group.coefficients.data(),nc,l,work.data(),values.data());
+            for(int c=0;c<nc;c++) (*results[order])[group.indices[c]] = values[c];
+        }
+    }
+    for(int i : layout->others) {
+        const Function& func = get(i);
+        rValues[i] = func.calcValue(aX);
+        rFirstDerivatives[i] = func.calcDerivative(aX,1);
+        rSecondDerivatives[i] = func.calcDerivative(aX,2);
+    }
+}
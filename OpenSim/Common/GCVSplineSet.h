@@ -32,6 +32,7 @@
 #include "Object.h"
 #include "FunctionSet.h"
 
+#include <memory>
 
 
 //=============================================================================
@@ -44,6 +45,15 @@ class Storage;
 /**
  * A class for holding a set of generalized cross-validated splines.
  *
+ * The splines are usually fit to the columns of a Storage, all at the same
+ * times. When the whole set is evaluated (evaluate() of all the functions and
+ * evaluateWithDerivatives()), the splines of the same degree fit to the same
+ * knots are evaluated together: their coefficients are laid out side by side
+ * for each knot, the interval of the argument is searched for once, and the
+ * B-spline recurrence runs on all their coefficients at once. The layout is
+ * made again from the splines whenever the functions of the set, or the
+ * splines themselves, have changed.
+ *
  * @see GCVSpline
  * @author Frank C. Anderson
  */
@@ -53,7 +63,11 @@ OpenSim_DECLARE_CONCRETE_OBJECT(GCVSplineSet, FunctionSet);
 //=============================================================================
 // DATA
 //=============================================================================
-protected:
+private:
+    class BatchLayout;
+    // The layout of the splines for evaluating all of them at once, made the
+    // first time the set is evaluated after the splines change.
+    mutable std::shared_ptr<const BatchLayout> _batchLayout;
 
 //=============================================================================
 // METHODS
@@ -64,12 +78,17 @@ public:
     //--------------------------------------------------------------------------
     GCVSplineSet();
     GCVSplineSet(const char *aFileName);
-    GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance=0.0);
+    GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance=0.0,
+                 int aNumThreads=0);
     virtual ~GCVSplineSet();
 
 private:
     void setNull();
-    void construct(int aDegree,const Storage *aStore,double aErrorVariance);
+    void construct(int aDegree,const Storage *aStore,double aErrorVariance,
+                   int aNumThreads);
+    // Get the layout of the splines for the current functions of the set,
+    // making it again if they have changed.
+    std::shared_ptr<const BatchLayout> getBatchLayout() const;
 
     //--------------------------------------------------------------------------
     // SET AND GET
@@ -79,10 +98,23 @@ public:
     double getMinX() const;
     double getMaxX() const;
 
+    //--------------------------------------------------------------------------
+    // EVALUATION
+    //--------------------------------------------------------------------------
+    using FunctionSet::evaluate;
+    void evaluate(Array<double> &rValues,int aDerivOrder,
+                  double aX=0.0) const override;
+    void evaluateWithDerivatives(double aX,SimTK::Vector &rValues,
+                                 SimTK::Vector &rFirstDerivatives,
+                                 SimTK::Vector &rSecondDerivatives) const
+                                 override;
+
     //--------------------------------------------------------------------------
     // UTILITY
     //--------------------------------------------------------------------------
     Storage* constructStorage(int aDerivOrder,double aDX=-1);
+    /** Fit the splines again to the data in a window of a storage. */
+    void fitWindow(const Storage& aStore,double aTI,double aTF);
 
 //=============================================================================
 };  // END class GCVSplineSet
@@ -31,6 +31,8 @@
 #include <math.h>
 #include <string>
 #include <climits>
+#include <cctype>
+#include <cstdlib>
 
 #include "IO.h"
 #if defined(__linux__) || defined(__APPLE__)
@@ -645,3 +647,22 @@ Uppercase(const std::string &aStr)
     for(unsigned int i=0; i<aStr.size(); i++) result[i] = toupper(result[i]);
     return result;
 }
+
+bool IO::
+ParseDoubles(const std::string &aStr, std::vector<double> &rValues)
+{
+    const size_t initialSize = rValues.size();
+    const char* p = aStr.c_str();
+    while(true) {
+        while(isspace((unsigned char)*p)) ++p;
+        if(*p == '\0') return true;
+        char* end = nullptr;
+        const double value = strtod(p, &end);
+        if(end == p || (*end != '\0' && !isspace((unsigned char)*end))) {
+            rValues.resize(initialSize);
+            return false;
+        }
+        rValues.push_back(value);
+        p = end;
+    }
+}
@@ -31,6 +31,7 @@
 // INCLUDES
 #include "osimCommonDLL.h"
 #include <fstream>
+#include <vector>
 
 // DEFINES
 const int IO_STRLEN = 2048;
@@ -118,6 +119,12 @@ public:
     static void TrimWhitespace(std::string &rStr) { TrimLeadingWhitespace(rStr); TrimTrailingWhitespace(rStr); }
     static std::string Lowercase(const std::string &aStr);
     static std::string Uppercase(const std::string &aStr);
+    /** Parse the whitespace-separated numbers of a string, such as the value
+    of an array property, appending them to rValues. NaN and Inf are accepted
+    in any case. Returns false, and leaves rValues as it was, if a token is
+    not a number. */
+    static bool ParseDoubles(const std::string &aStr,
+                             std::vector<double> &rValues);
 //=============================================================================
 };  // END CLASS IO
 
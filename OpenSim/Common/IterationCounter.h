@@ -0,0 +1,59 @@
+#ifndef OPENSIM_ITERATION_COUNTER_H_
+#define OPENSIM_ITERATION_COUNTER_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  IterationCounter.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <atomic>
+
+namespace OpenSim {
+
+/** A count of the iterations of a solver of a component (e.g., the Newton
+iterations of a muscle's equilibrium, or those of a wrap object's search for
+its tangent points), to see why a simulation got slow. The count may be
+increased from several threads at once, e.g., by the paths of a model
+computed in parallel, and from const methods.
+
+A copy of a component (or a component assigned another) starts counting
+from zero, as its solver has not done any iterations yet. Components expose
+their counts as Outputs whose names end in "_iterations"; Manager sums their
+increase over an integration (see Manager::getIntegrationStatistics()). */
+class IterationCounter {
+public:
+    IterationCounter() = default;
+    IterationCounter(const IterationCounter&) {}
+    IterationCounter& operator=(const IterationCounter&)
+    {   reset(); return *this; }
+
+    /** Count the given number of iterations. */
+    void add(long long numIterations) const
+    {   _count.fetch_add(numIterations, std::memory_order_relaxed); }
+    /** The number of iterations counted so far. */
+    long long get() const { return _count.load(std::memory_order_relaxed); }
+    void reset() const { _count.store(0, std::memory_order_relaxed); }
+
+private:
+    mutable std::atomic<long long> _count{0};
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_ITERATION_COUNTER_H_
@@ -169,6 +169,21 @@ LinearFunction& LinearFunction::operator=(const LinearFunction &aLinearFunction)
 //=============================================================================
 // UTILITY
 //=============================================================================
+double LinearFunction::calcValue(double x) const
+{
+    // A function of more than one argument is evaluated by Function.
+    if (_coefficients.getSize() != 2)
+        return Function::calcValue(x);
+    return _coefficients[0]*x + _coefficients[1];
+}
+
+double LinearFunction::calcDerivative(double x, int order) const
+{
+    if (_coefficients.getSize() != 2)
+        return Function::calcDerivative(x, order);
+    return order == 1 ? _coefficients[0] : 0.0;
+}
+
 SimTK::Function* LinearFunction::createSimTKFunction() const 
 {
     SimTK::Vector coeffs(_coefficients.getSize(), &_coefficients[0]);
@@ -101,6 +101,8 @@ public:
     //--------------------------------------------------------------------------
     // EVALUATION
     //--------------------------------------------------------------------------
+    double calcValue(double x) const override;
+    double calcDerivative(double x, int order) const override;
     SimTK::Function* createSimTKFunction() const override;
 
 //=============================================================================
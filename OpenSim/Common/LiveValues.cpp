@@ -0,0 +1,86 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  LiveValues.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "LiveValues.h"
+#include "Exception.h"
+
+#include <string>
+#include <thread>
+
+using namespace OpenSim;
+
+// The values are written and read as atomics so that a read that overlaps a
+// write is not a data race; the sequence number tells the reader to discard
+// such a read and try again.
+
+LiveValues::LiveValues(int size) :
+    _size(size), _sequence(0), _time(SimTK::NaN),
+    _values(new std::atomic<double>[size > 0 ? size : 0])
+{
+    OPENSIM_THROW_IF(size < 0, Exception,
+        "Expected a nonnegative number of values, but got " +
+        std::to_string(size) + ".");
+    for (int i = 0; i < _size; ++i)
+        _values[i].store(SimTK::NaN, std::memory_order_relaxed);
+}
+
+void LiveValues::write(double time, const SimTK::Vector& values)
+{
+    OPENSIM_THROW_IF(values.size() != _size, Exception,
+        "Expected " + std::to_string(_size) + " values, but got " +
+        std::to_string(values.size()) + ".");
+    const long long sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _time.store(time, std::memory_order_relaxed);
+    for (int i = 0; i < _size; ++i)
+        _values[i].store(values[i], std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool LiveValues::read(double& time, SimTK::Vector& values) const
+{
+    SimTK::Vector copy(_size);
+    double copyTime;
+    while (true) {
+        const long long before = _sequence.load(std::memory_order_acquire);
+        if (before == 0) return false;
+        if (before % 2 == 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        copyTime = _time.load(std::memory_order_relaxed);
+        for (int i = 0; i < _size; ++i)
+            copy[i] = _values[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    time = copyTime;
+    values = copy;
+    return true;
+}
+
+long long LiveValues::getNumWrites() const
+{
+    return _sequence.load(std::memory_order_acquire)/2;
+}
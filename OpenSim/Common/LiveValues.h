@@ -0,0 +1,92 @@
+#ifndef OPENSIM_LIVE_VALUES_H_
+#define OPENSIM_LIVE_VALUES_H_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  LiveValues.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "osimCommonDLL.h"
+#include "SimTKcommon/basics.h"
+#include "SimTKcommon/internal/BigMatrix.h"
+
+#include <atomic>
+#include <memory>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * The latest values of a fixed number of signals and the time at which they
+ * were written, shared between threads without locks: e.g., the controls
+ * that a hardware interface writes for a simulation running in real time,
+ * or the states that the simulation writes for the hardware.
+ *
+ * One thread at a time writes the values, and never waits for the readers.
+ * Any number of threads read them, each getting all the values of one write;
+ * a reader that overlaps a write tries again, so it waits at most for the
+ * copy of the values.
+ *
+ * @code
+ * LiveValues sensors(model.getNumStateVariables());
+ * // On the simulation thread, after each step:
+ * sensors.write(state.getTime(), model.getStateVariableValues(state));
+ * // On the hardware thread:
+ * double time; SimTK::Vector values;
+ * if (sensors.read(time, values)) send(values);
+ * @endcode
+ */
+class OSIMCOMMON_API LiveValues {
+public:
+    /** Values of the given number of signals, none written yet. */
+    explicit LiveValues(int size = 0);
+
+    LiveValues(const LiveValues&) = delete;
+    LiveValues& operator=(const LiveValues&) = delete;
+
+    /** The number of signals. */
+    int getSize() const { return _size; }
+
+    /** Replace the values with those given, written at the given time.
+    @throws Exception if the number of values is not getSize(). */
+    void write(double time, const SimTK::Vector& values);
+
+    /** Copy the values of the latest write into `values` (resized to
+    getSize()) and its time into `time`.
+    @returns false, leaving the arguments unchanged, if nothing has been
+    written yet. */
+    bool read(double& time, SimTK::Vector& values) const;
+
+    /** The number of writes so far, e.g., to tell whether there are values
+    that have not been read yet. */
+    long long getNumWrites() const;
+
+private:
+    int _size;
+    // Odd while a write is in progress; twice the number of writes otherwise.
+    std::atomic<long long> _sequence;
+    std::atomic<double> _time;
+    std::unique_ptr<std::atomic<double>[]> _values;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_LIVE_VALUES_H_
@@ -0,0 +1,215 @@
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  Logger.cpp                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Logger.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace OpenSim;
+
+namespace {
+
+std::atomic<int> logLevel{static_cast<int>(Logger::Level::Info)};
+std::atomic<int> maxMessagesPerSecond{10};
+std::atomic<bool> asynchronous{true};
+
+long long currentProcessId() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
+void write(Logger::Level level, const std::string& message) {
+    std::ostream& out = level <= Logger::Level::Warn ? std::cerr : std::cout;
+    out << message << std::endl;
+}
+
+// Writes queued messages on a thread of its own. The thread is started by
+// the first message, and stopped (after writing the queue) when the library
+// is unloaded.
+class Writer {
+public:
+    Writer() : _processId(currentProcessId()),
+               _thread(&Writer::run, this) {}
+
+    ~Writer() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done = true;
+            _changed.notify_all();
+        }
+        if (_thread.joinable()) _thread.join();
+    }
+
+    // Queue the message, or drop it if the queue is full; never waits for
+    // the output.
+    void push(Logger::Level level, std::string message) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_messages.size() >= MaxQueuedMessages) {
+            ++_dropped;
+            return;
+        }
+        _messages.emplace_back(level, std::move(message));
+        _changed.notify_all();
+    }
+
+    void flush() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this] { return _messages.empty() && !_busy; });
+    }
+
+    // A child of a process that forked has a copy of this object but not
+    // its thread; in it, the Writer (and its mutex) must not be used.
+    bool isUsable() const { return currentProcessId() == _processId; }
+
+private:
+    static const std::size_t MaxQueuedMessages = 10000;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _changed.wait(lock, [this]
+                { return !_messages.empty() || _dropped || _done; });
+            if (_messages.empty() && !_dropped) break;
+            std::deque<std::pair<Logger::Level, std::string>> messages;
+            messages.swap(_messages);
+            const long long dropped = _dropped;
+            _dropped = 0;
+            _busy = true;
+            lock.unlock();
+            for (const auto& message : messages)
+                write(message.first, message.second);
+            if (dropped)
+                write(Logger::Level::Warn, "Logger: " +
+                      std::to_string(dropped) +
+                      " messages dropped because the log queue was full.");
+            lock.lock();
+            _busy = false;
+            _changed.notify_all();
+        }
+    }
+
+    const long long _processId;
+    std::deque<std::pair<Logger::Level, std::string>> _messages;
+    long long _dropped = 0;
+    bool _busy = false;
+    bool _done = false;
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    std::thread _thread;
+};
+
+Writer& getWriter() {
+    static Writer writer;
+    return writer;
+}
+
+std::atomic<bool> writerStarted{false};
+
+} // anonymous namespace
+
+void Logger::setLevel(Level level) {
+    logLevel = static_cast<int>(level);
+}
+
+Logger::Level Logger::getLevel() {
+    return static_cast<Level>(logLevel.load());
+}
+
+bool Logger::shouldLog(Level level) {
+    return level != Level::Off &&
+           static_cast<int>(level) <= logLevel.load(std::memory_order_relaxed);
+}
+
+void Logger::setMaxMessagesPerSecond(int max) {
+    maxMessagesPerSecond = max;
+}
+
+int Logger::getMaxMessagesPerSecond() {
+    return maxMessagesPerSecond;
+}
+
+void Logger::setAsynchronous(bool async) {
+    if (!async) flush();
+    asynchronous = async;
+}
+
+bool Logger::getAsynchronous() {
+    return asynchronous;
+}
+
+void Logger::flush() {
+    if (writerStarted && getWriter().isUsable()) getWriter().flush();
+}
+
+bool Logger::admit(Site& site) {
+    const int max = maxMessagesPerSecond.load(std::memory_order_relaxed);
+    if (max < 1) return true;
+
+    const long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    long long windowStart = site._windowStart.load(std::memory_order_relaxed);
+    // Start a new window if a second has passed. If several threads get
+    // here at once, one of them resets the count.
+    if (now - windowStart >= 1000000000LL &&
+            site._windowStart.compare_exchange_strong(windowStart, now))
+        site._count = 0;
+
+    const int count = ++site._count;
+    if (count <= max) return true;
+    ++site._suppressed;
+    return false;
+}
+
+void Logger::log(Level level, Site& site, const std::string& message) {
+    std::string text = message;
+    const int suppressed = site._suppressed.exchange(0);
+    if (suppressed) {
+        text += " (" + std::to_string(suppressed) + " similar message" +
+                (suppressed == 1 ? "" : "s") + " from " + site._file + ":" +
+                std::to_string(site._line) + " suppressed)";
+    }
+
+    if (asynchronous.load(std::memory_order_relaxed)) {
+        writerStarted = true;
+        Writer& writer = getWriter();
+        if (writer.isUsable()) {
+            writer.push(level, std::move(text));
+            return;
+        }
+    }
+    write(level, text);
+}
@@ -0,0 +1,135 @@
+#ifndef OPENSIM_LOGGER_H_
+#define OPENSIM_LOGGER_H_
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  Logger.h                              *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+
+#include <atomic>
+#include <sstream>
+#include <string>
+
+namespace OpenSim {
+
+/** Messages from code that may run at every time step of a simulation (e.g.,
+warnings from muscles, analyses and per-frame progress of the Tools). Log
+messages with the OPENSIM_LOG macro (or OPENSIM_WARN, OPENSIM_INFO), which
+formats a message only if it is written:
+
+@code
+OPENSIM_WARN("MuscleAnalysis::record() unable to evaluate muscle length at "
+             "time " << s.getTime() << ".");
+@endcode
+
+Each place in the code that logs (a message site) writes at most
+getMaxMessagesPerSecond() messages per second; further messages from that
+site are counted and dropped, and the count is reported with the site's next
+message. A model that warns at every step therefore does not slow the
+simulation down to the speed of the terminal or log file.
+
+Messages are written to std::cout (Info, Debug) or std::cerr (Error, Warn),
+and so also to the LogManager's callbacks, by a background thread, so that
+logging does not wait for the output. Messages are queued without waiting
+for the writer; if the queue is full, messages are dropped and the number
+dropped is reported. Call flush() to wait until the queued messages are
+written (e.g., before printing directly to std::cout). In a process created
+with fork() by a process that had already logged, messages are written
+directly. */
+class OSIMCOMMON_API Logger {
+public:
+    enum class Level {
+        Off   = 0,
+        Error = 1,
+        Warn  = 2,
+        Info  = 3,
+        Debug = 4
+    };
+
+    /// @cond
+    // The state of one message site, used by OPENSIM_LOG.
+    class Site {
+    public:
+        Site(const char* file, int line) : _file(file), _line(line) {}
+    private:
+        friend class Logger;
+        const char* _file;
+        const int _line;
+        std::atomic<long long> _windowStart{0};
+        std::atomic<int> _count{0};
+        std::atomic<int> _suppressed{0};
+    };
+    /// @endcond
+
+    /** Messages of a level above this one are not formatted or written. The
+    default is Info. */
+    static void setLevel(Level level);
+    static Level getLevel();
+    static bool shouldLog(Level level);
+
+    /** The number of messages each site may write per second; the default
+    is 10. A value less than 1 disables rate limiting. */
+    static void setMaxMessagesPerSecond(int max);
+    static int getMaxMessagesPerSecond();
+
+    /** Write messages on a background thread (the default) or, if false,
+    in the thread that logs them (after flushing the queue). */
+    static void setAsynchronous(bool asynchronous);
+    static bool getAsynchronous();
+
+    /** Wait until all queued messages are written. */
+    static void flush();
+
+    /// @cond
+    // Used by OPENSIM_LOG. admit() applies the site's rate limit.
+    static bool admit(Site& site);
+    static void log(Level level, Site& site, const std::string& message);
+    /// @endcond
+};
+
+} // namespace OpenSim
+
+/** Log a message, given as a sequence of `<<` operands, at the given
+OpenSim::Logger::Level. The message is formatted only if it is written. */
+#define OPENSIM_LOG(LEVEL, MESSAGE)                                          \
+    do {                                                                     \
+        if (OpenSim::Logger::shouldLog(LEVEL)) {                             \
+            static OpenSim::Logger::Site opensim_log_site_(__FILE__,         \
+                                                           __LINE__);        \
+            if (OpenSim::Logger::admit(opensim_log_site_)) {                 \
+                std::ostringstream opensim_log_stream_;                      \
+                opensim_log_stream_ << MESSAGE;                              \
+                OpenSim::Logger::log(LEVEL, opensim_log_site_,               \
+                                     opensim_log_stream_.str());             \
+            }                                                                \
+        }                                                                    \
+    } while (false)
+
+#define OPENSIM_ERROR(MESSAGE) \
+    OPENSIM_LOG(OpenSim::Logger::Level::Error, MESSAGE)
+#define OPENSIM_WARN(MESSAGE) \
+    OPENSIM_LOG(OpenSim::Logger::Level::Warn, MESSAGE)
+#define OPENSIM_INFO(MESSAGE) \
+    OPENSIM_LOG(OpenSim::Logger::Level::Info, MESSAGE)
+#define OPENSIM_DEBUG(MESSAGE) \
+    OPENSIM_LOG(OpenSim::Logger::Level::Debug, MESSAGE)
+
+#endif // OPENSIM_LOGGER_H_
@@ -32,8 +32,12 @@
 #include "SimmIO.h"
 #include "SimmMacros.h"
 #include "Storage.h"
+#include "TRCFileAdapter.h"
 #include "OpenSim/Auxiliary/auxiliaryTestFunctions.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -51,6 +55,7 @@ using SimTK::Vec3;
 MarkerData::MarkerData() :
     _numFrames(0),
     _numMarkers(0),
+    _firstFrameNumber(1),
     _markerNames("")
 {
 }
@@ -62,6 +67,7 @@ MarkerData::MarkerData() :
 MarkerData::MarkerData(const string& aFileName) :
     _numFrames(0),
     _numMarkers(0),
+    _firstFrameNumber(1),
     _markerNames("")
 {
 
@@ -92,6 +98,21 @@ MarkerData::MarkerData(const string& aFileName) :
     cout << "Loaded marker file " << _fileName << " (" << _numMarkers << " markers, " << _numFrames << " frames)" << endl;
 }
 
+//_____________________________________________________________________________
+/**
+ * Constructor from a table of marker locations. Frames are numbered from 1.
+ */
+MarkerData::MarkerData(const TimeSeriesTable_<SimTK::Vec3>& aTable,
+                       const string& aFileName) :
+    _numFrames(0),
+    _numMarkers(0),
+    _firstFrameNumber(1),
+    _fileName(aFileName),
+    _markerNames("")
+{
+    setFromTable(aTable);
+}
+
 //_____________________________________________________________________________
 /**
  * Destructor.
@@ -121,6 +142,34 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
     if (aFileName.empty())
         throw Exception("MarkerData.readTRCFile: ERROR- Marker file name is empty",__FILE__,__LINE__);
 
+    /* Parse the file with TRCFileAdapter. Files it does not accept (e.g.,
+     * PathFileType 3, or rows with extra or missing coordinates) are read
+     * line by line below, as they always have been.
+     */
+    try {
+        aSMD.setFromTable(TRCFileAdapter::read(aFileName));
+
+        /* The adapter drops the frame numbers; only the first is needed
+         * since frames are numbered contiguously. It is on the first line
+         * of data, after the 5 lines of header.
+         */
+        ifstream first(aFileName.c_str());
+        for (int i = 0; i < 5 && getline(first, line); i++) {}
+        while (getline(first, line) && findFirstNonWhiteSpace(line) == -1) {}
+        if (readIntegerFromString(line, &frameNum))
+            aSMD._firstFrameNumber = frameNum;
+        return;
+    }
+    catch (const std::exception&) {
+        aSMD._markerNames.setSize(0);
+        aSMD._times.clear();
+        aSMD._locations.clear();
+        aSMD._frames.clear();
+        aSMD._numFrames = 0;
+        aSMD._numMarkers = 0;
+        aSMD._firstFrameNumber = 1;
+    }
+
    in.open(aFileName.c_str());
 
     if (!in.good())
@@ -139,7 +188,7 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
       if (findFirstNonWhiteSpace(line) == -1)
          continue;
 
-        if (aSMD._frames.getSize() == aSMD._numFrames)
+        if ((int)aSMD._times.size() == aSMD._numFrames)
         {
 #if 0
             if (gUseGlobalMessages)
@@ -172,7 +221,12 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 #endif
       }
 
-        MarkerFrame *frame = new MarkerFrame(aSMD._numMarkers, frameNum, time, aSMD._units);
+        if (aSMD._times.empty())
+            aSMD._firstFrameNumber = frameNum;
+        aSMD._times.push_back(time);
+        /* Coordinates missing at the end of the row are NaN. */
+        const size_t frameStart = aSMD._locations.size();
+        aSMD._locations.resize(frameStart + aSMD._numMarkers, Vec3(SimTK::NaN));
 
       /* keep reading sets of coordinates until the end of the line is
        * reached. If more coordinates were read than there are markers,
@@ -197,7 +251,7 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 #endif
          }
          if (coordsRead < aSMD._numMarkers)
-                frame->addMarker(coords);
+                aSMD._locations[frameStart + coordsRead] = coords;
          coordsRead++;
       }
 
@@ -213,10 +267,9 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
          goto cleanup;
 #endif
       }
-        aSMD._frames.append(frame);
    }
 
-   if (aSMD._frames.getSize() < aSMD._numFrames)
+   if ((int)aSMD._times.size() < aSMD._numFrames)
    {
 #if 0
       if (gUseGlobalMessages)
@@ -225,20 +278,13 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
       rc = smFileError;
       goto cleanup;
 #endif
-        aSMD._numFrames = aSMD._frames.getSize();
+        aSMD._numFrames = (int)aSMD._times.size();
    }
 
-   /* If the user-defined frame numbers are not contiguous from the first frame to the
-    * last, reset them to a contiguous array. This is necessary because the user-defined
-    * numbers are used to index the array of frames.
+   /* Frames are numbered contiguously from the number of the first frame,
+    * whether or not the user-defined numbers are. This is necessary because
+    * the numbers are used to index the array of frames.
     */
-    if (aSMD._frames[aSMD._numFrames-1]->getFrameNumber() - aSMD._frames[0]->getFrameNumber() !=
-         aSMD._numFrames - 1)
-   {
-        int firstIndex = aSMD._frames[0]->getFrameNumber();
-      for (int i = 1; i < aSMD._numFrames; i++)
-            aSMD._frames[i]->setFrameNumber(firstIndex + i);
-   }
 
 #if 0
    if (gUseGlobalMessages)
@@ -521,22 +567,67 @@ void MarkerData::readStoFile(const string& aFileName)
     _fileName = aFileName;
     _units = Units(Units::Meters);
 
-    double time;
     int sz = store.getSize();
+    _times.resize(sz);
+    _locations.resize((size_t)sz*_numMarkers);
     for (int i=0; i < sz; i++){
         StateVector* nextRow = store.getStateVector(i);
-        time = nextRow->getTime();
-        int frameNum = i+1;
-        MarkerFrame *frame = new MarkerFrame(_numMarkers, frameNum, time, _units);
+        _times[i] = nextRow->getTime();
         const Array<double>& rowData = nextRow->getData();
         // Cycle through map and add Marker coordinates to the frame. Same order as header.
+        size_t k = (size_t)i*_numMarkers;
         for (iter = markerIndices.begin(); iter != markerIndices.end(); iter++) {
             int startIndex = iter->first; // startIndex includes time but data doesn't!
-            frame->addMarker(SimTK::Vec3(rowData[startIndex-1], rowData[startIndex], rowData[startIndex+1]));
+            _locations[k++] = SimTK::Vec3(rowData[startIndex-1], rowData[startIndex], rowData[startIndex+1]);
         }
-        _frames.append(frame);
    }
 }
+
+//_____________________________________________________________________________
+/**
+ * Set the frames, marker names and header values from a table of marker
+ * locations. Header values missing from the table's metadata are given the
+ * values that readStoFile() gives them.
+ *
+ * @param aTable table of marker locations.
+ */
+void MarkerData::setFromTable(const TimeSeriesTable_<SimTK::Vec3>& aTable)
+{
+    const auto& metaData = aTable.getTableMetaData();
+    auto getNumber = [&](const std::string& key, double defaultValue) {
+        if (!metaData.hasKey(key))
+            return defaultValue;
+        const std::string& str =
+            metaData.getValueForKey(key).getValue<std::string>();
+        char* end = nullptr;
+        const double value = std::strtod(str.c_str(), &end);
+        return end == str.c_str() ? defaultValue : value;
+    };
+
+    _numMarkers = (int)aTable.getNumColumns();
+    _numFrames = (int)aTable.getNumRows();
+    _firstFrameNumber = 1;
+    _dataRate = getNumber("DataRate", 250);
+    _cameraRate = getNumber("CameraRate", _dataRate);
+    _originalDataRate = getNumber("OrigDataRate", _dataRate);
+    _originalStartFrame = (int)getNumber("OrigDataStartFrame", 1);
+    _originalNumFrames = (int)getNumber("OrigNumFrames", _numFrames);
+    _units = metaData.hasKey("Units") ?
+        Units(metaData.getValueForKey("Units").getValue<std::string>()) :
+        Units(Units::Meters);
+
+    _markerNames.setSize(0);
+    for (const auto& label : aTable.getColumnLabels())
+        _markerNames.append(label);
+
+    _times = aTable.getIndependentColumn();
+    _locations.resize((size_t)_numFrames*_numMarkers);
+    const auto& matrix = aTable.getMatrix();
+    for (int i = 0; i < _numFrames; i++)
+        for (int j = 0; j < _numMarkers; j++)
+            _locations[(size_t)i*_numMarkers + j] = matrix(i, j);
+    _frames.clear();
+}
 /**
  * Helper function to check column labels of passed in Storage for possibly being a MarkerName, and if true
  * add the start index and corresponding name to the passed in std::map
@@ -590,7 +681,7 @@ void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartF
 
     for (i = _numFrames - 1; i >= 0 ; i--)
     {
-        if (_frames[i]->getFrameTime() <= aStartTime)
+        if (_times[i] <= aStartTime)
         {
             rStartFrame = i;
             break;
@@ -599,7 +690,7 @@ void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartF
 
     for (i = rStartFrame; i < _numFrames; i++)
     {
-        if (_frames[i]->getFrameTime() >= aEndTime - SimTK::Zero)
+        if (_times[i] >= aEndTime - SimTK::Zero)
         {
             rEndFrame = i;
             break;
@@ -618,7 +709,7 @@ double MarkerData::getStartFrameTime() const
     if (_numFrames<=0)
         return SimTK::NaN;
 
-    return(_frames[0]->getFrameTime());
+    return(_times[0]);
 
 }
 /**
@@ -631,7 +722,7 @@ double MarkerData::getLastFrameTime() const
     if (_numFrames<=0)
         return SimTK::NaN;
 
-    return(_frames[_numFrames-1]->getFrameTime());
+    return(_times[_numFrames-1]);
 }
 
 //_____________________________________________________________________________
@@ -655,122 +746,80 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
         return;
 
     int startIndex = 0, endIndex = 1;
-    double *minX = NULL, *minY = NULL, *minZ = NULL, *maxX = NULL, *maxY = NULL, *maxZ = NULL;
-
     findFrameRange(aStartTime, aEndTime, startIndex, endIndex);
-    MarkerFrame *averagedFrame = new MarkerFrame(*_frames[startIndex]);
 
-    /* If aThreshold is greater than zero, then calculate
-     * the movement of each marker so you can check if it
-     * is greater than aThreshold.
+    /* Sum the locations of each marker over the frames to be averaged,
+     * skipping the frames in which it is missing (NaN), and keep track of
+     * the min/max XYZ of each marker so you can compare it to aThreshold
+     * when you're done. The frames are visited in the order they are stored.
      */
-    if (aThreshold > 0.0)
+    vector<Vec3> sum(_numMarkers, Vec3(0));
+    vector<int> count(_numMarkers, 0);
+    vector<Vec3> minPt(_numMarkers, Vec3(SimTK::Infinity));
+    vector<Vec3> maxPt(_numMarkers, Vec3(-SimTK::Infinity));
+    for (int j = startIndex; j <= endIndex; j++)
     {
-        minX = new double [_numMarkers];
-        minY = new double [_numMarkers];
-        minZ = new double [_numMarkers];
-        maxX = new double [_numMarkers];
-        maxY = new double [_numMarkers];
-        maxZ = new double [_numMarkers];
+        const Vec3* pts = &_locations[(size_t)j*_numMarkers];
         for (int i = 0; i < _numMarkers; i++)
         {
-            minX[i] = minY[i] = minZ[i] =  SimTK::Infinity;
-            maxX[i] = maxY[i] = maxZ[i] = -SimTK::Infinity;
-        }
-    }
-
-    /* Initialize all the averaged marker locations to 0,0,0. Then
-     * loop through the frames to be averaged, adding each marker location
-     * to averagedFrame. Keep track of the min/max XYZ for each marker
-     * so you can compare it to aThreshold when you're done.
-     */
-    for (int i = 0; i < _numMarkers; i++)
-    {
-        int numFrames = 0;
-        Vec3& avePt = averagedFrame->updMarker(i);
-        avePt = Vec3(0);
-
-        for (int j = startIndex; j <= endIndex; j++)
-        {
-            Vec3& pt = _frames[j]->updMarker(i);
-            if (!pt.isNaN())
+            const Vec3& pt = pts[i];
+            if (pt.isNaN())
+                continue;
+            sum[i] += pt;
+            count[i]++;
+            for (int k = 0; k < 3; k++)
             {
-                Vec3& coords = pt; //.get();
-                avePt += coords;
-                numFrames++;
-                if (aThreshold > 0.0)
-                {
-                    if (coords[0] < minX[i])
-                        minX[i] = coords[0];
-                    if (coords[0] > maxX[i])
-                        maxX[i] = coords[0];
-                    if (coords[1] < minY[i])
-                        minY[i] = coords[1];
-                    if (coords[1] > maxY[i])
-                        maxY[i] = coords[1];
-                    if (coords[2] < minZ[i])
-                        minZ[i] = coords[2];
-                    if (coords[2] > maxZ[i])
-                        maxZ[i] = coords[2];
-                }
+                minPt[i][k] = std::min(minPt[i][k], pt[k]);
+                maxPt[i][k] = std::max(maxPt[i][k], pt[k]);
             }
         }
-
-        /* Now divide by the number of frames to get the average. */
-        if (numFrames > 0)
-            avePt /= (double)numFrames;
-        else
-            avePt = Vec3(SimTK::NaN) ;//(SimTK::NaN, SimTK::NaN, SimTK::NaN);
     }
 
+    /* Now divide by the number of frames to get the average. */
+    vector<Vec3> averaged(_numMarkers);
+    for (int i = 0; i < _numMarkers; i++)
+        averaged[i] = count[i] > 0 ? sum[i] / (double)count[i] : Vec3(SimTK::NaN);
+
     /* Store the indices from the file of the first frame and
      * last frame that were averaged, so you can report them later.
      */
-    int startUserIndex = _frames[startIndex]->getFrameNumber();
-    int endUserIndex = _frames[endIndex]->getFrameNumber();
-
-    /* Now delete all the existing frames and insert the averaged one. */
-    _frames.clearAndDestroy();
-    _frames.append(averagedFrame);
+    int startUserIndex = _firstFrameNumber + startIndex;
+    int endUserIndex = _firstFrameNumber + endIndex;
+
+    /* Now replace all the existing frames with the averaged one, which has
+     * the time and frame number of the first frame averaged. */
+    const double startTime = _times[startIndex];
+    _times.assign(1, startTime);
+    _locations.swap(averaged);
+    _frames.clear();
     _numFrames = 1;
-    _firstFrameNumber = _frames[0]->getFrameNumber();
+    _firstFrameNumber = startUserIndex;
 
     if (aThreshold > 0.0)
     {
         for (int i = 0; i < _numMarkers; i++)
         {
-            Vec3& pt = _frames[0]->updMarker(i);
+            const Vec3& pt = _locations[i];
 
             if (pt.isNaN())
             {
                 cout << "___WARNING___: marker " << _markerNames[i] << " is missing in frames " << startUserIndex
                       << " to " << endUserIndex << ". Coordinates will be set to NAN." << endl;
             }
-            else if (maxX[i] - minX[i] > aThreshold ||
-                      maxY[i] - minY[i] > aThreshold ||
-                      maxZ[i] - minZ[i] > aThreshold)
+            else
             {
-                double maxDim = maxX[i] - minX[i];
-                maxDim = MAX(maxDim, (maxY[i] - minY[i]));
-                maxDim = MAX(maxDim, (maxZ[i] - minZ[i]));
-                cout << "___WARNING___: movement of marker " << _markerNames[i] << " in " << _fileName
-                      << " is " << maxDim << " (threshold = " << aThreshold << ")" << endl;
+                double maxDim = maxPt[i][0] - minPt[i][0];
+                maxDim = MAX(maxDim, (maxPt[i][1] - minPt[i][1]));
+                maxDim = MAX(maxDim, (maxPt[i][2] - minPt[i][2]));
+                if (maxDim > aThreshold)
+                    cout << "___WARNING___: movement of marker " << _markerNames[i] << " in " << _fileName
+                          << " is " << maxDim << " (threshold = " << aThreshold << ")" << endl;
             }
         }
     }
 
     cout << "Averaged frames from time " << aStartTime << " to " << aEndTime << " in " << _fileName
           << " (frames " << startUserIndex << " to " << endUserIndex << ")" << endl;
-
-    if (aThreshold > 0.0)
-    {
-        delete [] minX;
-        delete [] minY;
-        delete [] minZ;
-        delete [] maxX;
-        delete [] maxY;
-        delete [] maxZ;
-    }
 }
 
 //_____________________________________________________________________________
@@ -804,13 +853,13 @@ void MarkerData::makeRdStorage(Storage& rStorage)
 
     for (int i = 0; i < _numFrames; i++)
     {
+        const Vec3* markers = &_locations[(size_t)i*_numMarkers];
         for (int j = 0, index = 0; j < _numMarkers; j++)
         {
-            SimTK::Vec3& marker = _frames[i]->updMarker(j);
             for (int k = 0; k < 3; k++)
-                row[index++] = marker[k];
+                row[index++] = markers[j][k];
         }
-        rStorage.append(_frames[i]->getFrameTime(), numColumns, row);
+        rStorage.append(_times[i], numColumns, row);
     }
 
     delete [] row;
@@ -831,8 +880,9 @@ void MarkerData::convertToUnits(const Units& aUnits)
     if (!SimTK::isNaN(scaleFactor))
     {
         /* Scale all marker locations by the conversion factor. */
-        for (int i = 0; i < _frames.getSize(); i++)
-            _frames[i]->scale(scaleFactor);
+        for (Vec3& location : _locations)
+            location *= scaleFactor;
+        _frames.clear();
 
         /* Change the units for this object to the new ones. */
         _units = aUnits;
@@ -856,9 +906,54 @@ const MarkerFrame& MarkerData::getFrame(int aIndex) const
     if (aIndex < 0 || aIndex >= _numFrames)
         throw Exception("MarkerData::getFrame() invalid frame index.");
 
+    if ((int)_frames.size() != _numFrames)
+        _frames.assign(_numFrames, nullptr);
+    if (!_frames[aIndex])
+    {
+        Units units = _units;
+        auto frame = std::make_shared<MarkerFrame>(_numMarkers,
+            _firstFrameNumber + aIndex, _times[aIndex], units);
+        const Vec3* markers = &_locations[(size_t)aIndex*_numMarkers];
+        for (int j = 0; j < _numMarkers; j++)
+            frame->addMarker(markers[j]);
+        _frames[aIndex] = frame;
+    }
     return *_frames[aIndex];
 }
 
+//_____________________________________________________________________________
+/**
+ * Get the location of a marker in a frame.
+ *
+ * @param aFrameIndex index of the frame.
+ * @param aMarkerIndex index of the marker.
+ * @return Location of the marker.
+ */
+const Vec3& MarkerData::getMarker(int aFrameIndex, int aMarkerIndex) const
+{
+    if (aFrameIndex < 0 || aFrameIndex >= _numFrames)
+        throw Exception("MarkerData::getMarker() invalid frame index.");
+    if (aMarkerIndex < 0 || aMarkerIndex >= _numMarkers)
+        throw Exception("MarkerData::getMarker() invalid marker index.");
+
+    return _locations[(size_t)aFrameIndex*_numMarkers + aMarkerIndex];
+}
+
+//_____________________________________________________________________________
+/**
+ * Get the time of a frame.
+ *
+ * @param aFrameIndex index of the frame.
+ * @return Time of the frame.
+ */
+double MarkerData::getFrameTime(int aFrameIndex) const
+{
+    if (aFrameIndex < 0 || aFrameIndex >= _numFrames)
+        throw Exception("MarkerData::getFrameTime() invalid frame index.");
+
+    return _times[aFrameIndex];
+}
+
 //_____________________________________________________________________________
 /**
  * Get the index of a marker, given its name.
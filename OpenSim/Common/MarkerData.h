@@ -26,11 +26,13 @@
 
 // INCLUDE
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 #include "Array.h"
-#include "ArrayPtrs.h"
 #include "MarkerFrame.h"
 #include "Object.h"
+#include "TimeSeriesTable.h"
 #include "Units.h"
 
 namespace OpenSim {
@@ -42,6 +44,10 @@ class Storage;
 /**
  * A class implementing a sequence of marker frames from a TRC/TRB file.
  *
+ * The marker locations of all frames are held in one contiguous block, frame
+ * after frame. A MarkerFrame is only made for the frames asked for with
+ * getFrame().
+ *
  * @author Peter Loan
  * @version 1.0
  */
@@ -63,7 +69,12 @@ private:
     std::string _fileName;
     Units _units;
     Array<std::string> _markerNames;
-    ArrayPtrs<MarkerFrame> _frames;
+    // Time of each frame.
+    std::vector<double> _times;
+    // Location of marker j in frame i at index i*_numMarkers + j.
+    std::vector<SimTK::Vec3> _locations;
+    // Frames made by getFrame(), by index; emptied when the data change.
+    mutable std::vector<std::shared_ptr<MarkerFrame>> _frames;
 
 //=============================================================================
 // METHODS
@@ -74,6 +85,11 @@ private:
 public:
     MarkerData();
     explicit MarkerData(const std::string& aFileName) SWIG_DECLARE_EXCEPTION;
+    /** Construct from a table of marker locations, such as the one read from
+        a TRC file by TRCFileAdapter. The units, data rate and camera rate are
+        taken from the table's metadata when present. */
+    MarkerData(const TimeSeriesTable_<SimTK::Vec3>& aTable,
+               const std::string& aFileName = "");
     virtual ~MarkerData();
 
     void findFrameRange(double aStartTime, double aEndTime, int& rStartFrame, int& rEndFrame) const;
@@ -81,6 +97,9 @@ public:
     const std::string& getFileName() const { return _fileName; }
     void makeRdStorage(Storage& rStorage);
     const MarkerFrame& getFrame(int aIndex) const;
+    /** The location of a marker in a frame, without making a MarkerFrame. */
+    const SimTK::Vec3& getMarker(int aFrameIndex, int aMarkerIndex) const;
+    double getFrameTime(int aFrameIndex) const;
     int getMarkerIndex(const std::string& aName) const;
     const Units& getUnits() const { return _units; }
     void convertToUnits(const Units& aUnits);
@@ -98,6 +117,7 @@ private:
     void readTRBFile(const std::string& aFileName, MarkerData& aSMD);
     void readStoFile(const std::string& aFileName);
     void buildMarkerMap(const Storage& storageToReadFrom, std::map<int, std::string>& markerNames);
+    void setFromTable(const TimeSeriesTable_<SimTK::Vec3>& aTable);
 
 //=============================================================================
 };  // END of class MarkerData
@@ -36,8 +36,15 @@
 #include "Property_Deprecated.h"
 #include "PropertyTransform.h"
 #include "IO.h"
+#include "ThreadPool.h"
+#include "XMLWriter.h"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 using namespace OpenSim;
 using namespace std;
@@ -47,14 +54,58 @@ using SimTK::Transform;
 //=============================================================================
 // STATICS
 //=============================================================================
-ArrayPtrs<Object>           Object::_registeredTypes;
-std::map<string,Object*>    Object::_mapTypesToDefaultObjects;
 std::map<string,string>     Object::_renamedTypesMap;
 
 bool                        Object::_serializeAllDefaults=false;
+int                         Object::_numDeserializationThreads=1;
 const string                Object::DEFAULT_NAME(ObjectDEFAULT_NAME);
 int                         Object::_debugLevel = 0;
 
+namespace {
+    // A registered object type. Its default object is either given when the
+    // type is registered or created by the factory when first needed.
+    struct RegisteredType {
+        std::function<Object*()> factory;
+        std::atomic<Object*> defaultObject{nullptr};
+        ~RegisteredType() { delete defaultObject.load(); }
+    };
+
+    // The registered object types, by concrete class name. Renamed types are
+    // not normally entered here.
+    std::map<string, std::unique_ptr<RegisteredType>>& registeredTypes() {
+        static std::map<string, std::unique_ptr<RegisteredType>> types;
+        return types;
+    }
+
+    // The names of the registered types, in the order in which they were first
+    // registered.
+    std::vector<string>& registeredTypeNames() {
+        static std::vector<string> names;
+        return names;
+    }
+
+    // Guards the registration of types and the creation of default objects,
+    // which may happen on several threads at once (e.g., while the objects of
+    // a Set are read in parallel).
+    std::recursive_mutex& registryMutex() {
+        static std::recursive_mutex mutex;
+        return mutex;
+    }
+
+    // The default object of the registered type, created if need be.
+    Object* getDefaultObject(RegisteredType& type) {
+        if (Object* defaultObject = type.defaultObject.load())
+            return defaultObject;
+        std::lock_guard<std::recursive_mutex> lock(registryMutex());
+        if (Object* defaultObject = type.defaultObject.load())
+            return defaultObject;
+        Object* defaultObject = type.factory();
+        defaultObject->setName(Object::DEFAULT_NAME);
+        type.defaultObject = defaultObject;
+        return defaultObject;
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S)
 //=============================================================================
@@ -487,28 +538,47 @@ registerType(const Object& aObject)
         cout << "Object.registerType: " << type << " .\n";
     }
 
+    Object* defaultObj = aObject.clone();
+    defaultObj->setName(DEFAULT_NAME);
+    addRegisteredType(type, nullptr, defaultObj);
+}
+
+/*static*/ void Object::
+addRegisteredType(const std::string& type,
+                  const std::function<Object*()>& factory,
+                  Object* defaultObject)
+{
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+
     // REPLACE IF A MATCHING TYPE IS ALREADY REGISTERED
-    for(int i=0; i <_registeredTypes.size(); ++i) {
-        Object *object = _registeredTypes.get(i);
-        if(object->getConcreteClassName() == type) {
-            if(_debugLevel>=2) {
-                cout<<"Object.registerType: replacing registered object of type ";
-                cout<<type;
-                cout<<"\n\twith a new default object of the same type."<<endl;
-            }
-            Object* defaultObj = aObject.clone();
-            defaultObj->setName(DEFAULT_NAME);
-            _registeredTypes.set(i,defaultObj);
-            _mapTypesToDefaultObjects[type]= defaultObj;
-            return;
-        } 
+    auto p = registeredTypes().find(type);
+    if (p != registeredTypes().end()) {
+        if(_debugLevel>=2) {
+            cout<<"Object.registerType: replacing registered object of type ";
+            cout<<type;
+            cout<<"\n\twith a new default object of the same type."<<endl;
+        }
+        p->second->factory = factory;
+        delete p->second->defaultObject.exchange(defaultObject);
+        return;
     }
 
     // REGISTERING FOR THE FIRST TIME -- APPEND
-    Object* defaultObj = aObject.clone();
-    defaultObj->setName(DEFAULT_NAME);
-    _registeredTypes.append(defaultObj);
-    _mapTypesToDefaultObjects[type]= defaultObj;
+    std::unique_ptr<RegisteredType> registered(new RegisteredType());
+    registered->factory = factory;
+    registered->defaultObject = defaultObject;
+    registeredTypes()[type] = std::move(registered);
+    registeredTypeNames().push_back(type);
+}
+
+/*static*/ std::vector<Object*> Object::
+getRegisteredObjects()
+{
+    std::lock_guard<std::recursive_mutex> lock(registryMutex());
+    std::vector<Object*> objects;
+    for (const auto& type : registeredTypeNames())
+        objects.push_back(getDefaultObject(*registeredTypes().at(type)));
+    return objects;
 }
 
 /*static*/ void Object::
@@ -517,10 +587,7 @@ renameType(const std::string& oldTypeName, const std::string& newTypeName)
     if(oldTypeName == newTypeName)
         return; 
 
-    std::map<std::string,Object*>::const_iterator p = 
-        _mapTypesToDefaultObjects.find(newTypeName);
-
-    if (p == _mapTypesToDefaultObjects.end())
+    if (registeredTypes().count(newTypeName) == 0)
         throw OpenSim::Exception(
             "Object::renameType(): illegal attempt to rename object type "
             + oldTypeName + " to " + newTypeName + " which is unregistered.",
@@ -556,10 +623,10 @@ getDefaultInstanceOfType(const std::string& objectTypeTag) {
     }
 
     // Look up the "actualName" default object and return it.
-    std::map<std::string,Object*>::const_iterator p = 
-        _mapTypesToDefaultObjects.find(actualName);
-    if (p != _mapTypesToDefaultObjects.end())
-        return p->second;
+    // Its default object is created the first time it is asked for.
+    const auto p = registeredTypes().find(actualName);
+    if (p != registeredTypes().end())
+        return getDefaultObject(*p->second);
 
     // The requested object was not registered. That's OK normally but is
     // a bug if we went through the rename table since you are only allowed
@@ -603,10 +670,8 @@ newInstanceOfType(const std::string& objectTypeTag)
 /*static*/ void Object::
 getRegisteredTypenames(Array<std::string>& rTypeNames)
 {
-    std::map<string,Object*>::const_iterator p = 
-        _mapTypesToDefaultObjects.begin();
-    for (; p != _mapTypesToDefaultObjects.end(); ++p)
-        rTypeNames.append(p->first);
+    for (const auto& type : registeredTypes())
+        rTypeNames.append(type.first);
     // Renamed type names don't appear in the registeredTypes map, unless
     // they were separately registered.
 }
@@ -653,6 +718,90 @@ UpdateFromXMLNodeArrayProperty(Property_Deprecated* aProperty,
     aProperty->setValueIsDefault(false);
 }
 
+// Arrays of doubles, such as the knots of a spline, can be long; parse them
+// without a stream, falling back to one for text strtod() does not accept.
+template<> void 
+UpdateFromXMLNodeArrayProperty<double>(Property_Deprecated* aProperty, 
+                                       SimTK::Xml::Element& aNode, 
+                                       const string&        aName)
+{
+    aProperty->setValueIsDefault(true);
+
+    SimTK::Xml::element_iterator iter = aNode.element_begin(aName);
+    if (iter == aNode.element_end()) return;    // Not found
+
+    std::vector<double> value;
+    if (!IO::ParseDoubles(iter->getValue(), value)) {
+        SimTK::Array_<double> streamed;
+        iter->getValueAs(streamed);
+        value.assign(streamed.begin(), streamed.end());
+    }
+
+    OpenSim::Array<double> osimValue;
+    osimValue.setSize((int)value.size());
+    std::copy(value.begin(), value.end(), osimValue.get());
+    aProperty->setValue(osimValue);
+    aProperty->setValueIsDefault(false);
+}
+
+// Whether an element, and the elements within it, can be read into an Object
+// by a thread other than the calling one: reading an object from a file
+// changes the working directory, and reading default objects registers them.
+static bool
+CanReadInParallel(SimTK::Xml::Element& aElement)
+{
+    if (aElement.hasAttribute("file")) return false;
+    for (SimTK::Xml::element_iterator iter = aElement.element_begin();
+            iter != aElement.element_end(); ++iter) {
+        if (iter->getElementTag() == "defaults" || !CanReadInParallel(*iter))
+            return false;
+    }
+    return true;
+}
+
+// Set on the threads reading the objects of an array, so that the arrays
+// within those objects are read serially.
+static thread_local bool ReadingObjectsInParallel = false;
+
+// Read Objects, already created, from their elements. Large arrays are split
+// into contiguous ranges that are read by separate threads; see
+// Object::setNumDeserializationThreads().
+static void
+ReadObjectsFromXMLElements(
+        std::vector<std::pair<Object*, SimTK::Xml::Element>>& aObjects,
+        int versionNumber)
+{
+    const int MinObjectsPerThread = 16;
+    const int numThreads = std::min(Object::getNumDeserializationThreads(),
+                                    (int)aObjects.size()/MinObjectsPerThread);
+    bool parallel = numThreads > 1 && !ReadingObjectsInParallel;
+    for (size_t i = 0; parallel && i < aObjects.size(); ++i)
+        parallel = CanReadInParallel(aObjects[i].second);
+
+    if (!parallel) {
+        for (auto& objectAndElement : aObjects)
+            objectAndElement.first->updateFromXMLNode(objectAndElement.second,
+                                                      versionNumber);
+        return;
+    }
+
+    ThreadPool::parallelForRanges((int)aObjects.size(), numThreads,
+        [&aObjects, versionNumber](int, int begin, int end) {
+            // The thread may read other objects later, so restore the flag.
+            const bool reading = ReadingObjectsInParallel;
+            ReadingObjectsInParallel = true;
+            try {
+                for (int i = begin; i < end; ++i)
+                    aObjects[i].first->updateFromXMLNode(aObjects[i].second,
+                                                         versionNumber);
+            } catch (...) {
+                ReadingObjectsInParallel = reading;
+                throw;
+            }
+            ReadingObjectsInParallel = reading;
+        });
+}
+
 //------------------------------------------------------------------------------
 // OBJECT XML METHODS
 //------------------------------------------------------------------------------
@@ -755,6 +904,36 @@ UpdateXMLNodeTransform(const Property_Deprecated*   aProperty,
     } 
 }
 
+// The streamed counterparts of the above write the value text the Xml
+// element would hold.
+template<class T> static void 
+WriteXMLStreamSimpleProperty(const Property_Deprecated*  aProperty, 
+                             XMLWriter&                  aWriter)
+{
+    if(!aProperty->getValueIsDefault()||Object::getSerializeAllDefaults())
+        aWriter.writeTextElement(aProperty->getName(),
+                                 SimTK::String(aProperty->getValue<T>()));
+}
+
+template<class T> static void 
+WriteXMLStreamArrayProperty(const Property_Deprecated*   aProperty,  
+                            XMLWriter&                   aWriter)
+{
+    if(!aProperty->getValueIsDefault()||Object::getSerializeAllDefaults())
+        aWriter.writeTextElement(aProperty->getName(),
+                                 SimTK::String(aProperty->getValueArray<T>()));
+}
+
+static void 
+WriteXMLStreamTransform(const Property_Deprecated*   aProperty, 
+                        XMLWriter&                   aWriter)
+{
+    OpenSim::Array<double> arr(0, 6);
+    ((PropertyTransform *)aProperty)->getRotationsAndTranslationsAsArray6(&arr[0]);
+    if(!aProperty->getValueIsDefault()||Object::getSerializeAllDefaults())
+        aWriter.writeTextElement(aProperty->getName(), SimTK::String(arr));
+}
+
 
 //-----------------------------------------------------------------------------
 // UPDATE OBJECT
@@ -818,6 +997,16 @@ try {
             iter= aNode.element_begin(name);
             if (iter == aNode.element_end()) continue;  // Not found
             iter->getValueAs(valueString); // special values
+            {
+                // The usual case, a number, is parsed directly.
+                std::vector<double> parsed;
+                if (IO::ParseDoubles(valueString, parsed) &&
+                        parsed.size() == 1) {
+                    property->setValue(parsed[0]);
+                    property->setValueIsDefault(false);
+                    break;
+                }
+            }
             lowerCaseValueString = valueString.toLower();
             if (lowerCaseValueString=="infinity" || lowerCaseValueString=="inf")
                 property->setValue(SimTK::Infinity);
@@ -912,9 +1101,11 @@ try {
 
             // LOOP THROUGH PROPERTY ELEMENT'S CHILD ELEMENTS
             // Each element is expected to be an Object of some type given
-            // by the element's tag.
+            // by the element's tag. The objects of an array are created here
+            // and read afterwards, possibly by several threads.
             Object *object =NULL;
             int objectsFound = 0;
+            std::vector<std::pair<Object*, SimTK::Xml::Element>> toRead;
             SimTK::Xml::element_iterator iter = propElementIter->element_begin();
             while(iter != propElementIter->element_end()){
                 // Create an Object of the element tag's type.
@@ -937,9 +1128,10 @@ try {
                 } else {
                     property->appendValue(object);
                 }
-                object->updateFromXMLNode(*iter, versionNumber);
+                toRead.push_back(std::make_pair(object, *iter));
                 iter++;
             }
+            ReadObjectsFromXMLElements(toRead, versionNumber);
                 
             break; }
 
@@ -1208,6 +1400,138 @@ updateXMLNode(SimTK::Xml::Element& aParent) const
     }
 }
 
+//_____________________________________________________________________________
+/**
+ * Write the object as updateXMLNode() would append it to the current element
+ * of the writer, node for node.
+ */
+void Object::
+writeToXMLStream(XMLWriter& aWriter) const
+{
+    // Handle non-inlined object
+    if(!getInlined()) {
+        string offlineFileName = getDocumentFileName();
+        if(IO::GetPrintOfflineDocuments()) {
+            _inlined=true;
+            print(offlineFileName);
+            _inlined=false;
+            aWriter.startElement(getConcreteClassName());
+            aWriter.writeAttribute("file", offlineFileName);
+            aWriter.endElement();
+        }
+        return;
+    }
+
+    aWriter.startElement(getConcreteClassName());
+    if (!getName().empty())
+        aWriter.writeAttribute("name", getName());
+
+    // DEFAULT OBJECTS
+    if (_document) _document->writeDefaultObjects(aWriter);
+
+    // LOOP THROUGH PROPERTIES
+    bool wroteAnyProperties = false;
+    for(int i=0; i < _propertyTable.getNumProperties(); ++i) {
+        const AbstractProperty& prop = _propertyTable.getAbstractPropertyByIndex(i);
+        if (!prop.getValueIsDefault() || Object::getSerializeAllDefaults()) {
+            prop.writeToXMLStream(aWriter);
+            wroteAnyProperties = true;
+        }
+    }
+
+    // LOOP THROUGH DEPRECATED PROPERTIES
+    for(int i=0;i<_propertySet.getSize();i++) {
+
+        const Property_Deprecated *prop = _propertySet.get(i);
+        if (prop->getValueIsDefault() && !Object::getSerializeAllDefaults())
+            continue;
+
+        wroteAnyProperties = true;
+
+        if (!prop->getComment().empty())
+            aWriter.writeComment(prop->getComment());
+
+        Property_Deprecated::PropertyType type = prop->getType();
+        switch(type) {
+
+        case(Property_Deprecated::Bool) :
+            WriteXMLStreamSimpleProperty<bool>(prop, aWriter);
+            break;
+        case(Property_Deprecated::Int) :
+            WriteXMLStreamSimpleProperty<int>(prop, aWriter);
+            break;
+        case(Property_Deprecated::Dbl) :
+            if (SimTK::isFinite(prop->getValueDbl()))
+                WriteXMLStreamSimpleProperty<double>(prop, aWriter);
+            else {
+                string stringValue="";
+                if (prop->getValueDbl() == SimTK::Infinity)
+                    stringValue="Inf";
+                else if (prop->getValueDbl() == -SimTK::Infinity)
+                    stringValue="-Inf";
+                else if (SimTK::isNaN(prop->getValueDbl()))
+                    stringValue="NaN";
+                if(!prop->getValueIsDefault())
+                    aWriter.writeTextElement(prop->getName(), stringValue);
+            } 
+            break;
+        case(Property_Deprecated::Str) :
+            WriteXMLStreamSimpleProperty<string>(prop, aWriter);
+            break;
+        case(Property_Deprecated::BoolArray) : {
+                string stringValue = "";
+                const Array<bool> &valueBs = prop->getValueArray<bool>();
+                for (int i=0; i<valueBs.size(); ++i) 
+                    stringValue += (valueBs[i]?"true ":"false ");
+                aWriter.writeTextElement(prop->getName(), stringValue);
+            }
+            break;
+        case(Property_Deprecated::IntArray) :
+            WriteXMLStreamArrayProperty<int>(prop, aWriter);
+            break;
+        case(Property_Deprecated::DblArray) :
+        case(Property_Deprecated::DblVec) :
+            WriteXMLStreamArrayProperty<double>(prop, aWriter);
+            break;
+        case(Property_Deprecated::Transform) :
+            WriteXMLStreamTransform(prop, aWriter);
+            break;
+        case(Property_Deprecated::StrArray) :
+            WriteXMLStreamArrayProperty<string>(prop, aWriter);
+            break;
+
+        case(Property_Deprecated::Obj) :
+            prop->getValueObj().writeToXMLStream(aWriter);
+            break;
+
+        case(Property_Deprecated::ObjArray) :
+            aWriter.startElement(prop->getName());
+            for(int j=0;j<prop->getArraySize();j++)
+                prop->getValueObjPtr(j)->writeToXMLStream(aWriter);
+            aWriter.endElement();
+            break;
+        case(Property_Deprecated::ObjPtr) : {
+                const Object *object = prop->getValueObjPtr();
+                aWriter.startElement(prop->getName());
+                if(object)
+                    object->writeToXMLStream(aWriter);
+                aWriter.endElement();
+            }
+            break;
+
+        default :
+            cout<<"Object.UpdateObject: WARN- unrecognized property type."<<endl;
+            break;
+        }
+    }
+
+    if (!wroteAnyProperties) {
+        aWriter.writeComment(
+            "All properties of this object have their default values.");
+    }
+    aWriter.endElement();
+}
+
 //_____________________________________________________________________________
 /**
  * Update the XML node for defaults object.
@@ -1247,6 +1571,15 @@ getDocumentFileName() const
     return _document ? _document->getFileName() : "";
 }
 
+void Object::
+releaseDocumentElements()
+{
+    if (_document == NULL) return;
+    SimTK::Xml::Element root = _document->getRootElement();
+    while (root.node_begin() != root.node_end())
+        root.eraseNode(root.node_begin());
+}
+
 
 //-----------------------------------------------------------------------------
 // GENERATE XML DOCUMENT
@@ -1322,6 +1655,16 @@ setAllPropertiesUseDefault(bool aUseDefault)
 bool Object::
 print(const string &aFileName) const
 {
+    // A file is written as the object is traversed, rather than from an
+    // XML document built first; its name is relative to the current
+    // directory. Standard out still gets the document.
+    std::ofstream file;
+    if (!aFileName.empty()) {
+        file.open(aFileName.c_str());
+        OPENSIM_THROW_IF(!file.good(), Exception,
+            "Object: Cannot open file " + aFileName + " for writing.");
+    }
+
     // Temporarily change current directory so that inlined files are written to correct relative directory
     std::string savedCwd = IO::getCwd();
     IO::chDir(IO::getParentDirectory(aFileName));
@@ -1336,8 +1679,20 @@ print(const string &aFileName) const
             delete oldDoc;
             oldDoc = 0;
         }
-        SimTK::Xml::Element e = _document->getRootElement(); 
-        updateXMLNode(e);
+        if (aFileName.empty()) {
+            SimTK::Xml::Element e = _document->getRootElement(); 
+            updateXMLNode(e);
+        } else {
+            // The document only keeps the default objects.
+            XMLWriter writer(file);
+            writer.writeDeclaration();
+            writer.startElement("OpenSimDocument");
+            writer.writeAttribute("Version",
+                std::to_string(XMLDocument::getLatestVersion()));
+            writeToXMLStream(writer);
+            writer.endElement();
+            writer.flush();
+        }
     } catch (const Exception &ex) {
         // Important to catch exceptions here so we can restore current working directory...
         // And then we can re-throw the exception
@@ -1346,7 +1701,7 @@ print(const string &aFileName) const
     }
     IO::chDir(savedCwd);
     if(_document==NULL) return false;
-    _document->print(aFileName);
+    if (aFileName.empty()) _document->print(aFileName);
     return true;
 }
 
@@ -1384,14 +1739,11 @@ PrintPropertyInfo(ostream &aOStream,
 {
     if(aClassName=="") {
         // NO CLASS
-        int size = _registeredTypes.getSize();
-        aOStream<<"REGISTERED CLASSES ("<<size<<")\n";
-        Object *obj;
-        for(int i=0;i<size;i++) {
-            obj = _registeredTypes.get(i);
-            if(obj==NULL) continue;
-            aOStream<<obj->getConcreteClassName()<<endl;
-        }
+        // The names suffice; the default objects are not created.
+        const std::vector<string>& names = registeredTypeNames();
+        aOStream<<"REGISTERED CLASSES ("<<names.size()<<")\n";
+        for(const auto& name : names)
+            aOStream<<name<<endl;
         if (printFlagInfo) {
             aOStream<<"\n\nUse '-PropertyInfo ClassName' to list the properties of a particular class.\n\n";
         }
@@ -42,6 +42,8 @@
 
 #include <cstring>
 #include <cassert>
+#include <functional>
+#include <vector>
 
 // DISABLES MULTIPLE INSTANTIATION WARNINGS
 
@@ -165,7 +167,11 @@ what kind of %Object to create when it encounters a specific XML tag. This
 associates the concrete object's class name (object type tag) with a default 
 instance of that object. The registration process is normally done during 
 dynamic library (DLL) loading, that is, as part of the static initializer
-execution that occurs before program execution.
+execution that occurs before program execution. A library registers its
+types with Object::registerType<T>(), which keeps only how to construct the
+default instance; the default instance of a type is created when it is first
+needed (e.g., when an object of that type is first read from XML), so that
+loading a library does not construct its hundreds of types.
 
 For backwards compatibility, we support a renaming mechanism in which 
 now-deprecated class names can be mapped to their current equivalents. This
@@ -408,6 +414,16 @@ public:
     XML file). **/
     static void registerType(const Object& defaultObject);
 
+    /** Register the concrete class T, whose default instance is a
+    default-constructed T that is created only when it is first needed (e.g.,
+    by getDefaultInstanceOfType() or newInstanceOfType()). If the class is
+    already registered it will be replaced. Libraries register their types
+    this way so that loading them is quick. **/
+    template <class T> static void registerType() {
+        addRegisteredType(T::getClassName(),
+                          []() -> Object* { return new T(); }, nullptr);
+    }
+
     /** Support versioning by associating the current %Object type with an 
     old name. This is only allowed if \a newTypeName has already been 
     registered with registerType(). Renaming is applied first prior to lookup
@@ -465,13 +481,15 @@ public:
     /** Return an array of pointers to the default instances of all registered
     (concrete) %Object types that derive from a given %Object-derived type 
     that does not have to be concrete. This is useful, for example, to find 
-    all Joints, Constraints, ModelComponents, Analyses, etc. **/
+    all Joints, Constraints, ModelComponents, Analyses, etc. The default
+    instances of all registered types are created if they have not been
+    yet. **/
     template<class T> static void 
     getRegisteredObjectsOfGivenType(ArrayPtrs<T>& rArray) {
         rArray.setSize(0);
         rArray.setMemoryOwner(false);
-        for(int i=0; i<_registeredTypes.getSize(); i++) {
-            T* obj = dynamic_cast<T*>(_registeredTypes[i]);
+        for (Object* registered : getRegisteredObjects()) {
+            T* obj = dynamic_cast<T*>(registered);
             if (obj) rArray.append(obj);
         }
     }
@@ -522,6 +540,13 @@ public:
     **/
     virtual void updateXMLNode(SimTK::Xml::Element& parent) const;
 
+    /** Serialize this object, as updateXMLNode() would append it to the
+    element being written, directly to the given XMLWriter; this is how
+    print() writes a file without building the XML document in memory. A
+    class that overrides updateXMLNode() must override this method to write
+    the same XML. **/
+    virtual void writeToXMLStream(XMLWriter& writer) const;
+
     /** Inlined means an in-memory Object that is not associated with
     an XMLDocument. **/
     bool getInlined() const;
@@ -573,12 +598,20 @@ public:
     /** If there is a document associated with this object then return the
     file name maintained by the document. Otherwise return an empty string. **/
     std::string getDocumentFileName() const;
+    /** Free the XML elements kept in the document (if any) of an object read
+    from a file; for a large Model these can take as much memory as the Model
+    itself. The document's file name, version and default objects are kept,
+    so the object can still be printed and files named relative to its own
+    can still be found. **/
+    void releaseDocumentElements();
     void setAllPropertiesUseDefault(bool aUseDefault);
 
     /** Write this %Object into an XML file of the given name; conventionally
     the suffix to use is ".osim". This is useful for writing out a Model that
     has been created programmatically, and also very useful for testing and
-    debugging. **/
+    debugging. The file is written through an XMLWriter as the object is
+    traversed, without building the XML document in memory first; it is the
+    same XML that updateXMLNode() generates. **/
     bool print(const std::string& fileName) const;
 
     /** dump the XML representation of this %Object into an std::string and return it.
@@ -616,6 +649,25 @@ public:
         return _serializeAllDefaults;
     }
 
+    /** Static function to set the number of threads with which the objects
+    of a large Set, such as the muscles of a model's ForceSet, are read from an
+    XML file. The objects are created from their tags, in order, on the
+    calling thread; their properties are then read by up to this many threads,
+    each reading a contiguous range of the objects. The default, 1, reads
+    them serially. Sets whose objects are read from separate files, or that
+    define default objects, are always read serially, as are the Sets within
+    an object being read by another thread. Connections are resolved later
+    as before, when the model is finalized. **/
+    static void setNumDeserializationThreads(int numThreads)
+    {
+        _numDeserializationThreads = numThreads < 1 ? 1 : numThreads;
+    }
+    /** Report the number of threads with which Sets are read from XML. **/
+    static int getNumDeserializationThreads()
+    {
+        return _numDeserializationThreads;
+    }
+
     /** Returns true if the passed-in string is "Object"; each %Object-derived
     class defines a method of this name for its own class name. **/
     static bool isKindOf(const char *type) 
@@ -806,17 +858,19 @@ protected:
     PropertySet _propertySet;
 
 private:
-    // Array holding a default value for each of the registered object types. 
-    // Each object type only appears once in this array. Renamed types usually
-    // do not have separate registered objects; they are just used to locate 
-    // one of the current ones.
-    static ArrayPtrs<Object>                    _registeredTypes;
-
-    // Map from concrete object class name string to a default object of that 
-    // type kept in the above array of registered types. Renamed types are *not* 
-    // normally entered here; the names are mapped separately using the map 
-    // below.
-    static std::map<std::string,Object*>        _mapTypesToDefaultObjects;
+    // Register the type with the given concrete class name, or replace its
+    // registration, with either the default object (which is taken over) or
+    // the factory that creates it when first needed. The registered types are
+    // kept in Object.cpp. Renamed types are *not* normally registered; the
+    // names are mapped separately using the map below.
+    static void addRegisteredType(const std::string& type,
+                                  const std::function<Object*()>& factory,
+                                  Object* defaultObject);
+
+    // The default objects of all registered types, in the order in which the
+    // types were first registered. Each type appears once. The default objects
+    // that have not been created yet are created.
+    static std::vector<Object*> getRegisteredObjects();
 
     // Map types that have been renamed to their new names, which can
     // then be used to find them in the default object map. This lets us 
@@ -831,6 +885,9 @@ private:
     // a "defaults" section.
     static bool _serializeAllDefaults;
 
+    // Number of threads with which the objects of a Set are read from XML.
+    static int _numDeserializationThreads;
+
     // Debug level: 
     //  0: Hides non fatal warnings 
     //  1: Shows illegal tags 
@@ -1320,6 +1377,15 @@ ObjectProperty<T>::writeToXMLElement
         (objects[i])->updateXMLNode(propertyElement);
 }
 
+template <class T> inline void 
+ObjectProperty<T>::writeElementToXMLStream(XMLWriter& writer) const 
+{
+    writer.startElement(this->getName());
+    for (int i=0; i < objects.size(); ++i)
+        (objects[i])->writeToXMLStream(writer);
+    writer.endElement();
+}
+
 
 template <class T> inline void 
 ObjectProperty<T>::setValueAsObject(const Object& obj, int index) {
@@ -26,6 +26,8 @@
 //=============================================================================
 #include "ObjectGroup.h"
 
+#include <unordered_map>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -218,8 +220,18 @@ void ObjectGroup::replace(const Object* aOldObject, const Object* aNewObject)
 void ObjectGroup::setupGroup(ArrayPtrs<Object>& aObjects)
 {
     _memberObjects.setSize(0); // clear existing contents
+
+    // Look the members up by name in a hash table rather than searching
+    // aObjects for each member name; emplace() keeps the first object with
+    // each name, as ArrayPtrs::getIndex() would find.
+    std::unordered_map<std::string, int> indices;
+    indices.reserve(aObjects.getSize());
+    for (int i=0; i<aObjects.getSize(); i++)
+        indices.emplace(aObjects[i]->getName(), i);
+
     for (int i=0; i<_memberNames.getSize();) {
-        int index = aObjects.getIndex(_memberNames.get(i));
+        auto it = indices.find(_memberNames.get(i));
+        int index = it == indices.end() ? -1 : it->second;
         if (index > -1) {
             _memberObjects.insert(i, aObjects.get(index));
             i++;
@@ -31,6 +31,10 @@
 //=============================================================================
 #include <stdio.h>
 #include "OptimizationTarget.h"
+#include <simmath/LinearAlgebra.h>
+
+#include <cmath>
+#include <vector>
 
 //=============================================================================
 // EXPORTED STATIC CONSTANTS
@@ -309,3 +313,95 @@ ForwardDifferences(const OptimizationTarget *aTarget,
 
     return(status);
 }
+
+//=============================================================================
+// QUADRATIC PROGRAMS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Solve a quadratic program with a diagonal cost. In terms of the scaled
+ * parameters y[i] = sqrt(weights[i])*x[i], the cost is the squared norm of y.
+ * With the parameters at the active bounds fixed, the free parameters are the
+ * minimum-norm solution of the constraints, and the constraint multipliers
+ * give the gradient of the Lagrangian with respect to the fixed parameters.
+ * A bound is released when its multiplier has the wrong sign and added when
+ * a free parameter violates it, until the active set no longer changes.
+ */
+bool OptimizationTarget::
+SolveQuadraticProgram(const Vector& weights, const Matrix& A, const Vector& b,
+        const Vector& lowerBounds, const Vector& upperBounds,
+        Array<int>& activeBounds, Vector& x)
+{
+    const int np = A.ncol();
+    const int nc = A.nrow();
+    const double tol = 1e-10;
+
+    Vector scale(np), lower(np), upper(np);
+    Matrix scaledA(nc, np);
+    for(int i=0; i<np; i++) {
+        if(!(weights[i] > 0)) return false;
+        scale[i] = 1.0/std::sqrt(weights[i]);
+        lower[i] = lowerBounds[i]/scale[i];
+        upper[i] = upperBounds[i]/scale[i];
+        scaledA.col(i) = A.col(i)*scale[i];
+    }
+
+    Array<int> active(0, np);
+    if(activeBounds.getSize() == np) active = activeBounds;
+
+    Vector y(np), lambda(nc), g(np);
+    const int maxIterations = 2*np + 10;
+    for(int iter=0; iter<maxIterations; iter++) {
+        // Fix the parameters at their active bounds.
+        std::vector<int> free;
+        Vector r = -b;
+        for(int i=0; i<np; i++) {
+            if(active[i] == 0) {
+                free.push_back(i);
+                continue;
+            }
+            y[i] = active[i] < 0 ? lower[i] : upper[i];
+            r -= scaledA.col(i)*y[i];
+        }
+        const int nf = (int)free.size();
+        if(nf == 0) return false;
+
+        // Minimum-norm free parameters that satisfy the constraints.
+        Matrix freeA(nc, nf);
+        for(int j=0; j<nf; j++) freeA.col(j) = scaledA.col(free[j]);
+        Vector yFree(nf);
+        SimTK::FactorQTZ(freeA).solve(r, yFree);
+        if((freeA*yFree - r).normRMS() > tol*(1 + r.normRMS()))
+            return false;
+        for(int j=0; j<nf; j++) y[free[j]] = yFree[j];
+
+        // Multipliers of the constraints, from the stationarity of the
+        // Lagrangian with respect to the free parameters.
+        Matrix freeATranspose = ~freeA;
+        SimTK::FactorQTZ(freeATranspose).solve(-2*yFree, lambda);
+        g = 2*y + ~scaledA*lambda;
+
+        bool changed = false;
+        for(int i=0; i<np; i++) {
+            int bound = 0;
+            if(active[i] < 0) bound = g[i] > -tol ? -1 : 0;
+            else if(active[i] > 0) bound = g[i] < tol ? 1 : 0;
+            else if(y[i] < lower[i] - tol) bound = -1;
+            else if(y[i] > upper[i] + tol) bound = 1;
+            if(bound != active[i]) {
+                active[i] = bound;
+                changed = true;
+            }
+        }
+
+        if(!changed) {
+            for(int i=0; i<np; i++) {
+                x[i] = SimTK::clamp(lowerBounds[i], scale[i]*y[i],
+                                    upperBounds[i]);
+            }
+            activeBounds = active;
+            return true;
+        }
+    }
+    return false;
+}
@@ -88,6 +88,20 @@ public:
         ForwardDifferences(const OptimizationTarget *aTarget,
         double *dx,const SimTK::Vector &x,SimTK::Vector &dpdx);
 
+    /** Solve the quadratic program that minimizes the sum of weights[i]*x[i]^2
+    subject to the linear equality constraints A*x + b = 0 and the bounds on
+    x, with a primal-dual active set method. The active bounds are -1 at the
+    lower bound, 1 at the upper bound and 0 for free parameters; those given
+    (e.g., from a previous solution) are the first guess, and they are
+    updated on success. The weights must be positive.
+    @return false, leaving x and activeBounds unchanged, if no solution
+    satisfying the optimality conditions was found */
+    static bool
+        SolveQuadraticProgram(const SimTK::Vector& weights,
+        const SimTK::Matrix& A, const SimTK::Vector& b,
+        const SimTK::Vector& lowerBounds, const SimTK::Vector& upperBounds,
+        Array<int>& activeBounds, SimTK::Vector& x);
+
 };
 
 }; //namespace
@@ -39,7 +39,9 @@ using namespace std;
 
 Path::Path(const char separator, const std::string invalidChars) :
     _separator(separator), _invalidChars(invalidChars), _isAbsolute(false)
-{}
+{
+    updateHash();
+}
 
 Path::Path(const std::string path,
            const char separator,
@@ -47,7 +49,10 @@ Path::Path(const std::string path,
     _separator(separator), _invalidChars(invalidChars), _isAbsolute(false)
 {
     // check if path is empty
-    if (path.empty()) return;
+    if (path.empty()) {
+        updateHash();
+        return;
+    }
 
     // check if this is an absolute path
     char firstChar = path.at(0);
@@ -67,6 +72,7 @@ Path::Path(const std::string path,
     }
 
     cleanPath();
+    updateHash();
 }
 
 Path::Path(const std::vector<std::string> pathVec,
@@ -76,8 +82,8 @@ Path::Path(const std::vector<std::string> pathVec,
     _path(pathVec), _separator(separator), _invalidChars(invalidChars),
     _isAbsolute(isAbsolute)
 {
-    if (_path.empty()) return;
-    cleanPath();
+    if (!_path.empty()) cleanPath();
+    updateHash();
 }
 
 std::string Path::toString() const
@@ -236,3 +242,13 @@ void Path::appendPathElement(const std::string& pathElement)
 
     _path.push_back(pathElement);
 }
+
+void Path::updateHash()
+{
+    std::hash<std::string> hashElement;
+    size_t hash = _isAbsolute ? 1 : 0;
+    for (const auto& pathElement : _path)
+        hash ^= hashElement(pathElement) + 0x9e3779b9 + (hash << 6) +
+                (hash >> 2);
+    _hash = hash;
+}
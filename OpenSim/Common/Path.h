@@ -84,11 +84,17 @@ public:
     /// Return the number of levels (or elements) in the Path
     size_t getNumPathLevels() const { return _path.size(); };
 
+    /// Return a hash of the pathElements and of whether the path is absolute.
+    /// It is computed when the Path is constructed or changed, so hashing
+    /// and comparing Paths does not require forming their strings.
+    size_t getHash() const { return _hash; }
+
     /// Push a string to the back of a path (i.e. the end). First checks if the
     /// pathElement is valid. This function does not alter whether this path is
     /// absolute or relative.
     void pushBack(const std::string& pathElement) {
         appendPathElement(pathElement);
+        updateHash();
     }
 
     /// Pure virtual function that returns a char for the designated separator.
@@ -121,6 +127,16 @@ protected:
     /// Return the last pathElement as a string.
     std::string getPathName() const { return _path[getNumPathLevels() - 1]; };
 
+    /// Return true if this Path and otherPath have the same pathElements
+    /// and are both absolute or both relative. The hashes are compared
+    /// first, so Paths that differ are usually told apart right away.
+    bool isEqual(const Path& otherPath) const
+    {
+        return _hash == otherPath._hash &&
+               _isAbsolute == otherPath._isAbsolute &&
+               _path == otherPath._path;
+    }
+
 private:
     /// Insert a pathElement at the specified position. Note that this could
     /// cause a path to become illegal (e.g., adding ".." to the front of 
@@ -156,11 +172,15 @@ private:
     /// of _invalidChars
     bool isLegalPathElement(const std::string& pathElement) const;
 
+    /// Recompute _hash from the pathElements.
+    void updateHash();
+
     // Path variables
     std::vector<std::string> _path;
     char _separator;
     std::string _invalidChars;
     bool _isAbsolute;
+    size_t _hash;
 }; // end class Path
 
 } // end of namespace OpenSim
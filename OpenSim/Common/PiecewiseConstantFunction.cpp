@@ -398,9 +398,13 @@ int PiecewiseConstantFunction::addPoint(double aX, double aY)
 }
 
 double PiecewiseConstantFunction::calcValue(const Vector& x) const
+{
+    return calcValue(x[0]);
+}
+
+double PiecewiseConstantFunction::calcValue(double aX) const
 {
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0] || EQUAL_WITHIN_ERROR(aX,_x[0]))
         return _y[0];
@@ -424,11 +428,26 @@ double PiecewiseConstantFunction::calcValue(const Vector& x) const
     return _y[k];
 }
 
+double PiecewiseConstantFunction::calcValueNear(double aX, int& interval) const
+{
+    int n = _x.getSize();
+    if (!findIntervalNear(&_x[0], n, aX, interval) ||
+        EQUAL_WITHIN_ERROR(aX,_x[0]) || EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return calcValue(aX);
+
+    return _y[interval];
+}
+
 double PiecewiseConstantFunction::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
     return 0.0;
 }
 
+double PiecewiseConstantFunction::calcDerivative(double x, int order) const
+{
+    return 0.0;
+}
+
 int PiecewiseConstantFunction::getArgumentSize() const
 {
     return 1;
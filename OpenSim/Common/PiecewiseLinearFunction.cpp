@@ -425,9 +425,13 @@ void PiecewiseLinearFunction::calcCoefficients()
 }
 
 double PiecewiseLinearFunction::calcValue(const Vector& x) const
+{
+    return calcValue(x[0]);
+}
+
+double PiecewiseLinearFunction::calcValue(double aX) const
 {
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0])
         return _y[0] + (aX - _x[0]) * _b[0];
@@ -460,15 +464,29 @@ double PiecewiseLinearFunction::calcValue(const Vector& x) const
     return _y[k] + (aX - _x[k]) * _b[k];
 }
 
+double PiecewiseLinearFunction::calcValueNear(double aX, int& interval) const
+{
+    int n = _x.getSize();
+    if (!findIntervalNear(&_x[0], n, aX, interval) ||
+        EQUAL_WITHIN_ERROR(aX,_x[0]) || EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return calcValue(aX);
+
+    return _y[interval] + (aX - _x[interval]) * _b[interval];
+}
+
 double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
-    if (derivComponents.size() == 0)
+    return calcDerivative(x[0], (int)derivComponents.size());
+}
+
+double PiecewiseLinearFunction::calcDerivative(double aX, int order) const
+{
+    if (order < 1)
         return SimTK::NaN;
-    if (derivComponents.size() > 1)
+    if (order > 1)
         return 0.0;
 
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0]) {
         return _b[0];
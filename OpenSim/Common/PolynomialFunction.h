@@ -91,6 +91,32 @@ public:
     //--------------------------------------------------------------------------
     // EVALUATION
     //--------------------------------------------------------------------------
+    double calcValue(double x) const override
+    {
+        // Horner's scheme, from the highest order coefficient.
+        const SimTK::Vector& coefficients = get_coefficients();
+        double value = 0;
+        for (int i = 0; i < coefficients.size(); ++i)
+            value = value*x + coefficients[i];
+        return value;
+    }
+
+    double calcDerivative(double x, int order) const override
+    {
+        // Horner's scheme applied to the coefficients of the derivative: the
+        // term of power p contributes p!/(p-order)! x^(p-order).
+        const SimTK::Vector& coefficients = get_coefficients();
+        const int n = coefficients.size();
+        double value = 0;
+        for (int i = 0; i < n - order; ++i) {
+            const int p = n - 1 - i;
+            double factor = 1;
+            for (int j = 0; j < order; ++j) factor *= p - j;
+            value = value*x + factor*coefficients[i];
+        }
+        return value;
+    }
+
     /** Return the underlying SimTK::Function::Polynomial for direct use
      *   at the SimTK::System level 
      * @return   Pointer to the underlying SimTK::Function
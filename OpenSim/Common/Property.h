@@ -26,6 +26,8 @@
 // INCLUDES
 #include "AbstractProperty.h"
 #include "Exception.h"
+#include "IO.h"
+#include "XMLWriter.h"
 
 #include "SimTKcommon/SmallMatrix.h"
 #include "SimTKcommon/internal/BigMatrix.h"
@@ -33,6 +35,8 @@
 #include "SimTKcommon/internal/Array.h"
 #include "SimTKcommon/internal/ClonePtr.h"
 
+#include <memory>
+
 namespace OpenSim {
 
 template <class T> class SimpleProperty;
@@ -439,7 +443,16 @@ public:
     /** Return a const reference to the selected value from this property's 
     value list. If the property is at most single valued then the \a index is 
     optional and we'll behave as though index=0 were supplied. You can use
-    the square bracket operator property[index] instead. **/
+    the square bracket operator property[index] instead.
+
+    A simple (non-Object) property with a long list of values shares them
+    with its copies (and so with clones of its Object) until either changes
+    them. The values of such a property are then copied when it is changed,
+    so a reference obtained before the change no longer follows the values
+    of this property, and is valid only as long as one of the copies that
+    share the old values exists. Take a reference again after changing the
+    property. Properties with few values, including all single-valued ones,
+    are not shared and their references remain valid as before. **/
     const T& getValue(int index=-1) const {
         if (index < 0) {
             if (getMaxListSize()==1) index = 0;
@@ -708,7 +721,20 @@ public:
         if (isOneValue) this->setAllowableListSize(1); 
     }
 
-    // Default destructor, copy constructor, copy assignment.
+    // Copies share the values until either is changed; see updValues().
+    SimpleProperty(const SimpleProperty& source) :
+        Property<T>(source), valuesPtr(source.shareValues()) {}
+
+    SimpleProperty& operator=(const SimpleProperty& source) {
+        if (&source != this) {
+            Property<T>::operator=(source);
+            valuesPtr = source.shareValues();
+            valuesExposed = false;
+        }
+        return *this;
+    }
+
+    // Default destructor.
 
     SimpleProperty* clone() const override final 
     {   return new SimpleProperty(*this); }
@@ -726,8 +752,11 @@ public:
     bool isAcceptableObjectTag(const std::string&) const override final 
     {   return false; }
 
-    int getNumValues() const override final {return values.size(); }
-    void clearValues() override final {values.clear();}
+    int getNumValues() const override final {return getValues().size(); }
+    size_t estimateValueMemory() const override final {
+        return getValues().capacity()*sizeof(T) / valuesPtr.use_count();
+    }
+    void clearValues() override final {updValues().clear();}
 
     bool isEqualTo(const AbstractProperty& other) const override final {
         // Check here rather than in base class because the old
@@ -736,8 +765,11 @@ public:
             return false;
         assert(this->size() == other.size()); // base class checked
         const SimpleProperty& otherS = SimpleProperty::getAs(other);
+        if (valuesPtr == otherS.valuesPtr) return true; // shared
+        const SimTK::Array_<T,int>& values = getValues();
         for (int i=0; i<values.size(); ++i)
-            if (!Property<T>::TypeHelper::isEqual(values[i], otherS.values[i]))
+            if (!Property<T>::TypeHelper::isEqual(values[i], 
+                                                  otherS.getValues()[i]))
                 return false;
         return true;
     }
@@ -748,28 +780,29 @@ public:
     void readFromXMLElement
        (SimTK::Xml::Element& propertyElement,
         int                  versionNumber) override final {
-        std::istringstream valstream(propertyElement.getValue());
-        if (!readSimplePropertyFromStream(valstream)) {
+        const std::string text = propertyElement.getValue();
+        if (!readSimplePropertyFromString(text)) {
             std::cerr << "Failed to read " << SimTK::NiceTypeName<T>::name()
             << " property " << this->getName() << "; input='" 
-            << valstream.str().substr(0,50) // limit displayed length
+            << text.substr(0,50) // limit displayed length
             << "'.\n";
         }
-        if (values.size() < this->getMinListSize()) {
+        const int numValues = getValues().size();
+        if (numValues < this->getMinListSize()) {
             std::cerr << "Not enough values for " 
             << SimTK::NiceTypeName<T>::name() << " property " << this->getName() 
-            << "; input='" << valstream.str().substr(0,50) // limit displayed length 
+            << "; input='" << text.substr(0,50) // limit displayed length 
             << "'. Expected " << this->getMinListSize()
-            << ", got " << values.size() << ".\n";
+            << ", got " << numValues << ".\n";
         }
-        if (values.size() > this->getMaxListSize()) {
+        if (numValues > this->getMaxListSize()) {
             std::cerr << "Too many values for " 
             << SimTK::NiceTypeName<T>::name() << " property " << this->getName() 
-            << "; input='" << valstream.str().substr(0,50) // limit displayed length 
+            << "; input='" << text.substr(0,50) // limit displayed length 
             << "'. Expected " << this->getMaxListSize()
-            << ", got " << values.size() << ". Ignoring extras.\n";
+            << ", got " << numValues << ". Ignoring extras.\n";
 
-            values.resize(this->getMaxListSize());
+            updValues().resize(this->getMaxListSize());
         }
     }
 
@@ -783,6 +816,13 @@ public:
         propertyElement.setValue(valstream.str()); 
     } 
 
+    // The same text, formatted without a stream for doubles.
+    void writeElementToXMLStream(XMLWriter& writer) const override final {
+        std::string& text = writer.updTextBuffer();
+        XMLWriter::appendValues(text, getValues());
+        writer.writeTextElement(this->getName(), text);
+    }
+
 
     const Object& getValueAsObject(int index=-1) const override final {
         throw OpenSim::Exception(
@@ -834,39 +874,88 @@ private:
     // This is the Property<T> interface implementation.
     // Base class checks the index.
     const T& getValueVirtual(int index) const   override final 
-    {   return values[index]; }
+    {   return getValues()[index]; }
+    // The caller may keep the reference and write through it later, so these
+    // values must no longer be shared with copies.
     T& updValueVirtual(int index)               override final 
-    {   return values[index]; }
+    {   SimTK::Array_<T,int>& values = updValues();
+        valuesExposed = true;
+        return values[index]; }
     void setValueVirtual(int index, const T& value) override final
-    {   values[index] = value; }
+    {   updValues()[index] = value; }
     int appendValueVirtual(const T& value)     override final
-    {   values.push_back(value); return values.size()-1; }
+    {   updValues().push_back(value); return getValues().size()-1; }
     // Adopting a simple property just means we have to delete the one that
     // gets passed in because the caller thinks we took over ownership.
     int adoptAndAppendValueVirtual(T* valuep)     override final
-    {   values.push_back(*valuep); // make a copy
+    {   updValues().push_back(*valuep); // make a copy
         delete valuep; // throw out the old one
-        return values.size()-1; }
+        return getValues().size()-1; }
+
+    const SimTK::Array_<T,int>& getValues() const { return *valuesPtr; }
+    // Get the values for writing, first copying them if they are shared.
+    SimTK::Array_<T,int>& updValues() {
+        if (valuesPtr.use_count() > 1)
+            valuesPtr = std::make_shared<SimTK::Array_<T,int>>(*valuesPtr);
+        return *valuesPtr;
+    }
+    // The values for a copy of this property: the same values, unless there
+    // are only a few, whose references keep following this property (see
+    // getValue()), or a reference to them has been handed out by
+    // updValueVirtual().
+    std::shared_ptr<SimTK::Array_<T,int>> shareValues() const {
+        if (valuesExposed || valuesPtr->size() < MinNumSharedValues)
+            return std::make_shared<SimTK::Array_<T,int>>(*valuesPtr);
+        return valuesPtr;
+    }
+    // The least number of values that copies share.
+    static const int MinNumSharedValues = 64;
 
     // This is the default implementation; specialization is required if
     // the Simbody default behavior is different than OpenSim's; e.g. for
     // Transform serialization.
     bool readSimplePropertyFromStream(std::istream& in) {
-        return SimTK::readUnformatted(in, values);
+        return SimTK::readUnformatted(in, updValues());
+    }
+
+    // Read the values from the text of a property element. Specializations
+    // may parse the text directly, without a stream.
+    bool readSimplePropertyFromString(const std::string& text) {
+        std::istringstream in(text);
+        return readSimplePropertyFromStream(in);
     }
 
     // This is the default implementation; specialization is required if
     // the Simbody default behavior is different than OpenSim's; e.g. for
     // Transform serialization.
     void writeSimplePropertyToStream(std::ostream& o) const {
-        SimTK::writeUnformatted(o, values);
+        SimTK::writeUnformatted(o, getValues());
     }
 
     // This is like an std::vector<T> although with an int index rather
-    // than unsigned.
-    SimTK::Array_<T,int> values;
+    // than unsigned. A long list is shared, copy-on-write, between a property
+    // and its copies, which makes cloning an Object with long lists of values
+    // cheap.
+    std::shared_ptr<SimTK::Array_<T,int>> valuesPtr = 
+        std::make_shared<SimTK::Array_<T,int>>();
+    // Whether a writable reference to the values has been handed out.
+    bool valuesExposed = false;
 };
 
+// Lists of doubles, such as the knots of a spline, can be long; parse them
+// without a stream, falling back to one for text strtod() does not accept.
+template <> inline bool SimpleProperty<double>::
+readSimplePropertyFromString(const std::string& text)
+{
+    std::vector<double> parsed;
+    if (IO::ParseDoubles(text, parsed)) {
+        updValues().assign(parsed.begin(), parsed.end());
+        return true;
+    }
+    std::istringstream in(text);
+    return readSimplePropertyFromStream(in);
+}
+
 // We have to provide specializations for Transform because read/write
 // unformatted would not know to convert to X-Y-Z body fixed Euler angles
 // followed by the position vector.
@@ -876,6 +965,7 @@ readSimplePropertyFromStream(std::istream& in)
 {   
     // Read in an array of Vec6 objects.
     SimTK::Array_<SimTK::Vec6,int> rotTrans;
+    SimTK::Array_<SimTK::Transform,int>& values = updValues();
     values.clear();
     if (!SimTK::readUnformatted(in, rotTrans)) return false;
 
@@ -896,6 +986,7 @@ writeSimplePropertyToStream(std::ostream& o) const
 {   
     // Convert array of Transform objects to an array of Vec6 objects.
     SimTK::Array_<SimTK::Vec6> rotTrans;
+    const SimTK::Array_<SimTK::Transform,int>& values = getValues();
     for (int i=0; i<values.size(); ++i) {
         SimTK::Vec6 X6;
         SimTK::Vec3& angles = X6.updSubVec<3>(0);
@@ -916,12 +1007,13 @@ readSimplePropertyFromStream(std::istream& in)
     if(this->getMaxListSize()==1)
     {
         std::istringstream& instream = (std::istringstream&)(in);
+        SimTK::Array_<std::string,int>& values = updValues();
         values.clear();
         values.push_back(instream.str());
         return true;
    }
    else
-       return SimTK::readUnformatted(in, values);
+       return SimTK::readUnformatted(in, updValues());
 }
 
 
@@ -974,6 +1066,7 @@ public:
         int                  versionNumber) override final;
     void writeToXMLElement
        (SimTK::Xml::Element& propertyElement) const override final;
+    void writeElementToXMLStream(XMLWriter& writer) const override final;
     void setValueAsObject(const Object& obj, int index=-1) override final;
 
     bool isUnnamedProperty() const override final {return isUnnamed;}
@@ -44,6 +44,8 @@
 #include "ObjectGroup.h"
 
 #include "Reporter.h"
+#include "TableFileReporter.h"
+#include "SharedMemoryReporter.h"
 #include "TableSource.h"
 
 #include "ModelDisplayHints.h"
@@ -66,33 +68,36 @@ OSIMCOMMON_API void RegisterTypes_osimCommon()
   try {
 
     //SimTK::Xml::setXmlCondenseWhiteSpace(false);
-    Object::registerType( FunctionSet() );
-    Object::registerType( GCVSplineSet() );
-    Object::registerType( ScaleSet() );
-
-    Object::registerType( GCVSpline() );
-
-    Object::registerType( Scale() );
-    Object::registerType( SimmSpline() );
-    Object::registerType( Constant() );
-    Object::registerType( Sine() );
-    Object::registerType( StepFunction() );
-    Object::registerType( LinearFunction() );
-    Object::registerType( PiecewiseLinearFunction() );
-    Object::registerType( PiecewiseConstantFunction() );
-    Object::registerType( MultiplierFunction() );
-    Object::registerType(PolynomialFunction());
-    Object::registerType( ObjectGroup() );
+    Object::registerType<FunctionSet>();
+    Object::registerType<GCVSplineSet>();
+    Object::registerType<ScaleSet>();
+
+    Object::registerType<GCVSpline>();
+
+    Object::registerType<Scale>();
+    Object::registerType<SimmSpline>();
+    Object::registerType<Constant>();
+    Object::registerType<Sine>();
+    Object::registerType<StepFunction>();
+    Object::registerType<LinearFunction>();
+    Object::registerType<PiecewiseLinearFunction>();
+    Object::registerType<PiecewiseConstantFunction>();
+    Object::registerType<MultiplierFunction>();
+    Object::registerType<PolynomialFunction>();
+    Object::registerType<ObjectGroup>();
     
-    Object::registerType( TableSource() );
-    Object::registerType( TableSourceVec3() );
-    Object::registerType( TableReporter() );
-    Object::registerType( TableReporterVec3() );
-    Object::registerType( TableReporterVector() );
-    Object::registerType( ConsoleReporter() );
-    Object::registerType( ConsoleReporterVec3() );
-
-    Object::registerType( ModelDisplayHints());
+    Object::registerType<TableSource>();
+    Object::registerType<TableSourceVec3>();
+    Object::registerType<TableReporter>();
+    Object::registerType<TableReporterVec3>();
+    Object::registerType<TableReporterVector>();
+    Object::registerType<TableFileReporter>();
+    Object::registerType<TableFileReporterVec3>();
+    Object::registerType<ConsoleReporter>();
+    Object::registerType<ConsoleReporterVec3>();
+    Object::registerType<SharedMemoryReporter>();
+
+    Object::registerType<ModelDisplayHints>();
 
     // TODO: temporarily map old NaturalCubicSpline (which wasn't a
     // natural cubic spline) to renamed SimmSpline class. Later we
@@ -196,19 +196,38 @@ public:
         _outputTable.setColumnLabels(columnLabels);
     }
 
+    /** Reserve room in the table for the given number of rows, so that they
+    are reported without reallocating the table (see
+    DataTable_::reserve()).                                                   */
+    void reserve(size_t numRows) {
+        _outputTable.reserve(numRows);
+    }
+
+    /** Reserve room in the table for the rows reported over a simulation of
+    the given duration (s), one per report_time_interval. Does nothing if the
+    interval is 0, since the values are then reported at every step.          */
+    void reserveForDuration(double duration) {
+        const double interval = this->get_report_time_interval();
+        if (interval > 0 && duration > 0)
+            reserve(_outputTable.getNumRows() +
+                    static_cast<size_t>(duration / interval) + 1);
+    }
+
 protected:
     void implementReport(const SimTK::State& state) const override {
         const auto& input = this->template getInput<InputT>("inputs");
-        SimTK::RowVector_<ValueT> result(int(input.getNumConnectees()));
-
-        for (auto idx = 0u; idx < input.getNumConnectees(); ++idx) {
-              const auto& chan = input.getChannel(idx);
-              const auto& value = chan.getValue(state);
-              result[idx] = value;
-        }
+        // The values are gathered in the row kept for this purpose, and
+        // copied into the room that the table keeps for its next row.
+        SimTK::RowVector_<ValueT>& row = const_cast<Self*>(this)->_row;
+        if (row.size() != int(input.getNumConnectees()))
+            row.resize(int(input.getNumConnectees()));
+
+        int idx = 0;
+        for (const auto& chan : input.getChannels())
+            row[idx++] = chan->getValue(state);
         try {
             const_cast<Self*>(this)->_outputTable.appendRow(state.getTime(),
-                                                            result);
+                                                            row);
         } catch(const InvalidTimestamp& exception) {
             OPENSIM_THROW(Exception,
                           "Attempting to update reporter with rows having "
@@ -229,6 +248,7 @@ protected:
             labels.push_back( input.getLabel(idx) );
         }
         const_cast<Self*>(this)->_outputTable.setColumnLabels(labels);
+        _row.resize(int(labels.size()));
     }
 
 private:
@@ -237,6 +257,8 @@ private:
     // We write to this table in const methods, but only because we ensure
     // those const methods are never called with trial integrator states.
     TimeSeriesTable_<ValueT> _outputTable;
+    // The values of the row being reported.
+    SimTK::RowVector_<ValueT> _row;
 };
 
 /** A reporter that simply prints quantities to the console
@@ -339,7 +361,7 @@ inline void TableReporter_<SimTK::Vector, SimTK::Real>::
     }
 
     const_cast<Self*>(this)->_outputTable.appendRow(state.getTime(), 
-                                                    (~result).getAsRowVector());
+                                                    (~result).getAsRowVectorView());
 }
 
 /** @name Commonly used concrete TableReporters */
@@ -29,6 +29,7 @@
 // INCLUDES
 #include <float.h>
 #include <math.h>
+#include <vector>
 #include "RootSolver.h"
 
 
@@ -81,143 +82,122 @@ setNull()
 /**
  * Solve for the roots.
  *
- * 
+ * Brent's method is run for all N functions in lockstep: each iteration
+ * steps every lane that has not yet converged, and then evaluates the
+ * function once for all of them. Lanes that have converged are no longer
+ * stepped, and are masked out of the evaluation so that a function that
+ * can skip them does. The solve returns as soon as the last lane has
+ * converged, without evaluating the function again.
+ *
+ * @param s State at which to evaluate the function.
+ * @param ax Lower ends of the brackets of the roots.
+ * @param bx Upper ends of the brackets of the roots.
+ * @param tol Tolerances on the roots.
+ * @return The roots.
  */
 Array<double> RootSolver::
 solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
         const Array<double> &tol)
 {
-    int i;
     int N = _function->getNX();
 
-    Array<double> a(0.0,N),b(0.0,N),c(0.0,N);
-    Array<double> fa(0.0,N),fb(0.0,N),fc(0.0,N);
-    Array<double> prev_step(0.0,N);
-    Array<double> tol_act(0.0,N);
-    Array<double> p(0.0,N);
-    Array<double> q(0.0,N);
-    Array<double> new_step(0.0,N);
-
-    bool finished = false;
-    Array<int>   converged(0,N);
+    Array<double> b(0.0,N),fb(0.0,N);
+    Array<double> a(0.0,N),fa(0.0,N);
+    std::vector<double> c(N),fc(N);
 
+    // Active lanes, both as a mask for the function and as a list of
+    // indices over which to step.
+    Array<bool> active(true,N);
+    std::vector<int> lanes(N);
+    for(int i=0;i<N;i++) lanes[i] = i;
 
     // INITIALIZATIONS
     a = ax;
     b = bx;
     _function->evaluate(s,a,fa);
     _function->evaluate(s,b,fb);
-    c = a;
-    fc = fa;
-
+    for(int i=0;i<N;i++) {
+        c[i] = a[i];
+        fc[i] = fa[i];
+    }
 
     // ITERATION LOOP
-    int iter;
-    for(iter=0;!finished;iter++) {
+    while(!lanes.empty()) {
 
         // ABSCISSAE MANIPULATION LOOP
-        for(i=0;i<N;i++) {
+        int numActive = 0;
+        for(int i : lanes) {
 
-            // Continue?
-            // If a function is already converged no need to do any manipulation.
-            if(converged[i]) continue;
-   
             // Make c on opposite side of b.
-            // (was down at very bottom)
-             if( (fb[i]>0.0 && fc[i]>0.0) || (fb[i]<0.0 && fc[i]<0.0) ) {
+            if( (fb[i]>0.0 && fc[i]>0.0) || (fb[i]<0.0 && fc[i]<0.0) ) {
                 c[i] = a[i];
                 fc[i] = fa[i];
-             }
+            }
 
             // Record previous step
-            prev_step[i] = b[i] - a[i];
+            double prev_step = b[i] - a[i];
 
             // Swap data for b to be the best approximation.
             if( fabs(fc[i]) < fabs(fb[i]) ) {
                 a[i] = b[i];  b[i] = c[i];  c[i] = a[i];
                 fa[i]= fb[i]; fb[i]= fc[i]; fc[i]= fa[i];
             }
-            tol_act[i] = 2.0*DBL_EPSILON*fabs(b[i]) + 0.5*tol[i];
-            new_step[i] = 0.5 * (c[i]-b[i]);
+            double tol_act = 2.0*DBL_EPSILON*fabs(b[i]) + 0.5*tol[i];
+            double new_step = 0.5 * (c[i]-b[i]);
 
             // Converged?
-            // Original convergence test:
-            if(fabs(new_step[i])<=tol_act[i] || fb[i]==(double)0.0 ) {
-                converged[i] = iter;
+            if(fabs(new_step)<=tol_act || fb[i]==(double)0.0 ) {
+                active[i] = false;
                 continue;
             }
 
             // Interpolate if prev_step was large enough and in true direction
-            if( fabs(prev_step[i])>=tol_act[i] && fabs(fa[i])>fabs(fb[i]) ) {
-                double t1,cb,t2;
+            if( fabs(prev_step)>=tol_act && fabs(fa[i])>fabs(fb[i]) ) {
+                double t1,cb,t2,p,q;
                 cb = c[i]-b[i];
 
                 // Only two distinct roots, must use linear interpolation.
                 if(a[i]==c[i]) {
                     t1 = fb[i]/fa[i];
-                    p[i] = cb*t1;
-                    q[i] = 1.0 - t1;
+                    p = cb*t1;
+                    q = 1.0 - t1;
 
                 // Quadratic interpolation
                 } else {
-                    q[i] = fa[i]/fc[i];  t1 = fb[i]/fc[i];  t2 = fb[i]/fa[i];
-                    p[i] = t2 * ( cb*q[i]*(q[i]-t1) - (b[i]-a[i])*(t1-1.0) );
-                    q[i] = (q[i]-1.0) * (t1-1.0) * (t2-1.0);
+                    q = fa[i]/fc[i];  t1 = fb[i]/fc[i];  t2 = fb[i]/fa[i];
+                    p = t2 * ( cb*q*(q-t1) - (b[i]-a[i])*(t1-1.0) );
+                    q = (q-1.0) * (t1-1.0) * (t2-1.0);
                 }
 
                 // Change sign of q or p?
-                if( p[i]>(double)0.0 ) {
-                    q[i] = -q[i];
+                if( p>(double)0.0 ) {
+                    q = -q;
                 } else {
-                    p[i] = -p[i];
+                    p = -p;
                 }
 
                 // If the interpolate is bad, use bisection.
-                if( p[i]<(0.75*cb*q[i] - 0.5*fabs(tol_act[i]*q[i])) && p[i]<fabs(0.5*prev_step[i]*q[i]) )
-                    new_step[i] = p[i]/q[i];
+                if( p<(0.75*cb*q - 0.5*fabs(tol_act*q)) && p<fabs(0.5*prev_step*q) )
+                    new_step = p/q;
             }
 
             // Adjust step to be not less than tolerance.
-            if( fabs(new_step[i]) < tol_act[i] ) {
-                if( new_step[i] > (double)0.0 ) {
-                    new_step[i] = tol_act[i];
-                }
-                else {
-                    new_step[i] = -tol_act[i];
-                }
+            if( fabs(new_step) < tol_act ) {
+                new_step = (new_step > (double)0.0) ? tol_act : -tol_act;
             }
 
             // Save previous approximation.
             a[i] = b[i];  fa[i] = fb[i];
+            b[i] += new_step;
 
+            lanes[numActive++] = i;
 
-            b[i] += new_step[i];
-             
         } // END ABSCISSAE LOOP
-     
+        lanes.resize(numActive);
 
         // NEW FUNCTION EVALUATION
-        _function->evaluate(s, b,fb);
-
-
-        // FINISHED?
-        for(i=0;i<N;i++) {
-            finished = true;
-            if(!converged[i]) {
-                finished = false;
-                break;
-            }
-        }
+        if(!lanes.empty()) _function->evaluate(s,b,fb,active);
     }
 
-    // PRINT
-    //cout<<"\n\nRootSolver:  found solution in "<<iter<<" iterations.\n";
-    //cout<<"converged array:\n";
-    //cout<<converged<<endl<<endl;
-    //cout<<"roots:\n";
-    //cout<<b<<endl<<endl;
-    //cout<<"errors:\n";
-    //cout<<fb<<endl;
-    
     return(b);
 }
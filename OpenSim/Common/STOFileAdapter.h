@@ -131,6 +131,25 @@ public:
     static
     TimeSeriesTable_<T> read(const std::string& fileName);
 
+    /** Read only the selected columns of a STO file: the columns with the
+    given labels (in the given order), or the columns whose labels match a
+    regular expression (see ColumnSelection).
+
+    \throws KeyNotFound If the file has no column with one of the labels.   */
+    static
+    TimeSeriesTable_<T> readColumns(const std::string& fileName,
+                                    const ColumnSelection& selection);
+
+    /** Read the rows of a STO file with times in [startTime, endTime], and
+    only the selected columns (all by default). Rows before the range are
+    skipped without being parsed and reading stops after the range, so the
+    cost depends mostly on where the range is in the file rather than on the
+    size of the file.                                                         */
+    static
+    TimeSeriesTable_<T> readTimeRange(const std::string& fileName,
+                                      double startTime, double endTime,
+                           const ColumnSelection& selection = ColumnSelection{});
+
     /** Write a STO file.                                                     */
     static
     void write(const TimeSeriesTable_<T>& table, const std::string& fileName);
@@ -159,6 +178,28 @@ STOFileAdapter_<T>::read(const std::string& fileName) {
     return static_cast<TimeSeriesTable_<T>&>(*abs_table);
 }
 
+template<typename T>
+TimeSeriesTable_<T>
+STOFileAdapter_<T>::readColumns(const std::string& fileName,
+                                const ColumnSelection& selection) {
+    auto abs_table = STOFileAdapter_{}.
+                     extendReadColumns(fileName, selection).
+                     at(DelimFileAdapter<T>::tableString());
+    return static_cast<TimeSeriesTable_<T>&>(*abs_table);
+}
+
+template<typename T>
+TimeSeriesTable_<T>
+STOFileAdapter_<T>::readTimeRange(const std::string& fileName,
+                                  double startTime, double endTime,
+                                  const ColumnSelection& selection) {
+    auto abs_table = STOFileAdapter_{}.
+                     extendReadColumns(fileName, selection,
+                                       startTime, endTime).
+                     at(DelimFileAdapter<T>::tableString());
+    return static_cast<TimeSeriesTable_<T>&>(*abs_table);
+}
+
 template<typename T>
 void 
 STOFileAdapter_<T>::write(const TimeSeriesTable_<T>& table, 
@@ -0,0 +1,87 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ScratchArena.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace OpenSim;
+
+namespace {
+// Smallest block worth allocating, in bytes.
+const std::size_t MinBlockSize = 4096;
+}
+
+ScratchArena::ScratchArena(std::size_t initialCapacity) :
+    _initialCapacity(initialCapacity) {}
+
+void* ScratchArena::allocateBytes(std::size_t size, std::size_t alignment) {
+    while (_block < _blocks.size()) {
+        Block& block = _blocks[_block];
+        const std::uintptr_t base =
+                reinterpret_cast<std::uintptr_t>(block.data.get());
+        const std::size_t start =
+                (base + _offset + alignment - 1) / alignment * alignment - base;
+        if (start + size <= block.size) {
+            _offset = start + size;
+            return block.data.get() + start;
+        }
+        // Go on to the next block, if it has been allocated already.
+        if (_block + 1 == _blocks.size()) break;
+        ++_block;
+        _offset = 0;
+    }
+    // The blocks double in size, so that a step needs only a few of them.
+    const std::size_t blockSize = std::max({size + alignment,
+            2 * getCapacity(), _initialCapacity, MinBlockSize});
+    _blocks.push_back({std::unique_ptr<unsigned char[]>(
+                               new unsigned char[blockSize]), blockSize});
+    _block = _blocks.size() - 1;
+    _offset = 0;
+    return allocateBytes(size, alignment);
+}
+
+void ScratchArena::reset() {
+    if (_blocks.size() > 1) {
+        const std::size_t capacity = getCapacity();
+        _blocks.clear();
+        _blocks.push_back({std::unique_ptr<unsigned char[]>(
+                                   new unsigned char[capacity]), capacity});
+    }
+    _block = 0;
+    _offset = 0;
+}
+
+std::size_t ScratchArena::getNumBytesInUse() const {
+    std::size_t numBytes = _offset;
+    for (std::size_t i = 0; i < _block && i < _blocks.size(); ++i)
+        numBytes += _blocks[i].size;
+    return numBytes;
+}
+
+std::size_t ScratchArena::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const Block& block : _blocks) capacity += block.size;
+    return capacity;
+}
@@ -0,0 +1,131 @@
+#ifndef OPENSIM_SCRATCH_ARENA_H_
+#define OPENSIM_SCRATCH_ARENA_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ScratchArena.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include "osimCommonDLL.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace OpenSim {
+
+/** Memory for the temporaries of a computation that is repeated many times
+(e.g., the rows of values an Analysis records at each step), handed out by
+moving a pointer forward through a block, and released all at once.
+
+Nothing is freed until reset(), after which the memory is handed out again
+from the start. When the memory handed out since the last reset() did not fit
+in one block, more blocks were allocated along the way; reset() replaces them
+with a single block large enough for all of it, so that once the largest
+step has been seen, no step allocates from the heap.
+
+Only types that need no destructor (numbers, SimTK::Vec3, pointers) can be
+allocated, since the arena never destroys what it holds. Memory can also be
+released back to a mark with a Scope:
+
+@code
+ScratchArena::Scope scope(arena);
+double* values = arena.allocate<double>(n);
+SimTK::Vector row(n, values, true); // shares the arena's memory
+@endcode
+
+An arena is not thread-safe. */
+class OSIMCOMMON_API ScratchArena {
+public:
+    /** The first block, allocated when memory is first requested, holds at
+    least initialCapacity bytes. */
+    explicit ScratchArena(std::size_t initialCapacity = 0);
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /** Memory for n default-initialized objects of type T (so numbers are
+    left uninitialized), valid until reset() or until the Scope in which it
+    was allocated ends. */
+    template <class T>
+    T* allocate(int n) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                "The arena does not destroy the objects it holds.");
+        T* data = static_cast<T*>(allocateBytes(
+                sizeof(T) * std::size_t(n > 0 ? n : 0), alignof(T)));
+        for (int i = 0; i < n; ++i) new (data + i) T;
+        return data;
+    }
+    /** Memory for n copies of value. */
+    template <class T>
+    T* allocate(int n, const T& value) {
+        T* data = allocate<T>(n);
+        for (int i = 0; i < n; ++i) data[i] = value;
+        return data;
+    }
+
+    /** Release all memory handed out, to be handed out again. */
+    void reset();
+
+    /** The number of bytes handed out (including padding for alignment)
+    since the last reset(). */
+    std::size_t getNumBytesInUse() const;
+    /** The number of bytes in all blocks. */
+    std::size_t getCapacity() const;
+    /** The number of blocks, which is 1 after reset() once memory has been
+    requested. */
+    int getNumBlocks() const { return (int)_blocks.size(); }
+
+    /** Releases the memory handed out by the arena during the lifetime of the
+    scope when the scope ends. Scopes must end in the reverse order of their
+    beginning, and before the arena is reset(). */
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena) :
+            _arena(arena), _block(arena._block), _offset(arena._offset) {}
+        ~Scope() { _arena._block = _block; _arena._offset = _offset; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        ScratchArena& _arena;
+        std::size_t _block;
+        std::size_t _offset;
+    };
+
+private:
+    void* allocateBytes(std::size_t size, std::size_t alignment);
+
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+    std::vector<Block> _blocks;
+    // The block memory is handed out from, and the number of bytes of it
+    // handed out.
+    std::size_t _block = 0;
+    std::size_t _offset = 0;
+    std::size_t _initialCapacity;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_SCRATCH_ARENA_H_
@@ -35,6 +35,9 @@
 #include "ObjectGroup.h"
 #include "PropertyObjArray.h"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace OpenSim { 
 
 //=============================================================================
@@ -66,6 +69,21 @@ PropertyObjArray<ObjectGroup> _propObjectGroups;
 ArrayPtrs<T> &_objects;
 ArrayPtrs<ObjectGroup> &_objectGroups;
 
+private:
+// NAME INDEX
+/** Index of the first object with each name, built on demand by
+getIndex(const std::string&) so that looking up an object by name does not
+scan the whole set. The index is rebuilt whenever this Set is modified, and
+an entry is only used if the object at its index still has that name, so
+objects that are renamed, or modified without going through this Set, are
+still found, only more slowly. */
+mutable std::unordered_map<std::string, int> _nameIndex;
+/** Size of the set when _nameIndex was built, or -1 if it needs rebuilding. */
+mutable int _nameIndexSize = -1;
+/** Lookups may happen concurrently (e.g., from analyses that evaluate a
+model on multiple threads), so access to _nameIndex is serialized. */
+mutable std::mutex _nameIndexMutex;
+
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // METHODS
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -193,6 +211,7 @@ Set<T>& operator=(const Set<T> &aSet)
     Super::operator=(aSet);
     _objects = aSet._objects;
     _objectGroups = aSet._objectGroups;
+    invalidateNameIndex();
 
     return(*this);
 }
@@ -395,6 +414,7 @@ int getCapacityIncrement() const
  */
 virtual bool setSize(int aSize)
 {
+    invalidateNameIndex();
     return( _objects.setSize(aSize) );
 }
 //_____________________________________________________________________________
@@ -439,6 +459,10 @@ virtual int getIndex(const T *aObject,int aStartIndex=0) const
  */
 virtual int getIndex(const std::string &aName,int aStartIndex=0) const
 {
+    // A search that starts from the beginning finds the first object with
+    // the name, which is what the name index holds.
+    if(aStartIndex<=0 || aStartIndex>=_objects.getSize())
+        return( findIndexByName(aName) );
     return( _objects.getIndex(aName,aStartIndex) );
 }
 //_____________________________________________________________________________
@@ -466,6 +490,7 @@ void getGroupNamesContaining(const std::string &aObjectName, Array<std::string>
  */
 virtual bool adoptAndAppend(T *aObject)
 {
+    invalidateNameIndex();
     return( _objects.append(aObject) );
 }
 
@@ -504,6 +529,7 @@ virtual bool cloneAndAppend(const T& aObject)
  */
 virtual bool insert(int aIndex,T *aObject)
 {
+    invalidateNameIndex();
     return( _objects.insert(aIndex,aObject) );
 }
 #ifndef SWIG
@@ -553,6 +579,7 @@ virtual bool remove(int aIndex)
     for (i=0; i<_objectGroups.getSize(); i++)
         _objectGroups.get(i)->remove(_objects.get(aIndex));
 
+    invalidateNameIndex();
     return( _objects.remove(aIndex) );
 }
 //_____________________________________________________________________________
@@ -574,11 +601,13 @@ virtual bool remove(const T* aObject)
     for (i=0; i<_objectGroups.getSize(); i++)
         _objectGroups.get(i)->remove(aObject);
 
+    invalidateNameIndex();
     return( _objects.remove(aObject) );
 }
 
 virtual void clearAndDestroy()
 {
+    invalidateNameIndex();
     _objects.clearAndDestroy();
     _objectGroups.clearAndDestroy();
 }
@@ -603,6 +632,7 @@ virtual void clearAndDestroy()
  */
 virtual bool set(int aIndex, T *aObject, bool preserveGroups = false)
 {
+    invalidateNameIndex();
     if (!preserveGroups)
         return( _objects.set(aIndex,aObject) );
     if (aObject != NULL && aIndex >= 0 && aIndex < _objects.getSize())
@@ -668,12 +698,12 @@ virtual T& get(int aIndex) const
  */
 T& get(const std::string &aName)
 {
-    return( *_objects.get(aName) );
+    return( *_objects.get(getIndexOrThrow(aName)) );
 }
 #ifndef SWIG
 const T& get(const std::string &aName) const
 {
-    return( *_objects.get(aName) );
+    return( *_objects.get(getIndexOrThrow(aName)) );
 }
 #endif
 //_____________________________________________________________________________
@@ -685,7 +715,7 @@ const T& get(const std::string &aName) const
  */
 bool contains(const std::string &aName) const
 {
-    return( _objects.getIndex(aName) != -1 );
+    return( getIndex(aName) != -1 );
 }//_____________________________________________________________________________
 /**
  * Get names of objects in the set.
@@ -808,7 +838,7 @@ void renameGroup(const std::string& oldGroupName, const std::string& newGroupNam
 void addObjectToGroup(const std::string& aGroupName, const std::string& aObjectName)
 {
     ObjectGroup* group = _objectGroups.get(aGroupName);
-    Object* object = _objects.get(aObjectName);
+    Object* object = &get(aObjectName);
     if (group && object)
         group->add(object);
 }
@@ -841,6 +871,65 @@ const ObjectGroup* getGroup(int aIndex) const
     return _objectGroups.get(aIndex);
 }
 
+//=============================================================================
+// NAME INDEX
+//=============================================================================
+private:
+//_____________________________________________________________________________
+/**
+ * Mark the name index as out of date, so that it is rebuilt by the next
+ * lookup by name.
+ */
+void invalidateNameIndex() const
+{
+    std::lock_guard<std::mutex> lock(_nameIndexMutex);
+    _nameIndexSize = -1;
+}
+//_____________________________________________________________________________
+/**
+ * Find the index of the first object with the specified name, using the name
+ * index. If the index has no valid entry for the name, the set is searched
+ * and, if the object is found that way, the index is marked to be rebuilt.
+ *
+ * @return Index of the object named aName, or -1 if there is no such object.
+ */
+int findIndexByName(const std::string &aName) const
+{
+    std::lock_guard<std::mutex> lock(_nameIndexMutex);
+    const int size = _objects.getSize();
+    if(_nameIndexSize != size) {
+        _nameIndex.clear();
+        _nameIndex.reserve(size);
+        // emplace() keeps the first object with each name.
+        for(int i=0;i<size;i++)
+            _nameIndex.emplace(_objects[i]->getName(), i);
+        _nameIndexSize = size;
+    }
+    auto it = _nameIndex.find(aName);
+    if(it != _nameIndex.end() && _objects[it->second]->getName() == aName)
+        return( it->second );
+
+    // The objects were renamed or replaced since the index was built.
+    int index = _objects.getIndex(aName);
+    if(index != -1) _nameIndexSize = -1;
+    return( index );
+}
+//_____________________________________________________________________________
+/**
+ * Same as getIndex(), but throws the same exception as ArrayPtrs::get() if
+ * there is no object with the specified name.
+ */
+int getIndexOrThrow(const std::string &aName) const
+{
+    int index = getIndex(aName);
+    if(index==-1) {
+        std::string msg = "ArrayPtrs.get(aName): No object with name ";
+        msg += aName;
+        throw( Exception(msg,__FILE__,__LINE__) );
+    }
+    return( index );
+}
+
 //=============================================================================
 };  // END class Set
 
@@ -0,0 +1,127 @@
+#ifndef OPENSIM_SHARED_MEMORY_REPORTER_H_
+#define OPENSIM_SHARED_MEMORY_REPORTER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  SharedMemoryReporter.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Reporter.h"
+#include "SharedMemoryRingBuffer.h"
+
+namespace OpenSim {
+
+/** A reporter that publishes the reported values, as the simulation runs, to
+a ring buffer in shared memory, from which other processes (e.g., a live plot
+or a controller) read them. See SharedMemoryRingBuffer for the layout of the
+shared memory and how to read it; the labels of the buffer are the labels of
+the inputs.
+
+Each report writes one record of the time and values directly into the
+shared memory, and never waits for the readers: once capacity records have
+been written, each report overwrites the oldest one. Readers that fall more
+than capacity records behind miss records, without slowing the simulation.
+
+The shared memory is created by the first report, replacing any shared
+memory of the same name, and removed by closeSharedMemory() or when the
+reporter is destroyed. The next report after closeSharedMemory() creates it
+again, empty.
+
+@code
+auto* reporter = new SharedMemoryReporter();
+reporter->set_shared_memory_name("opensim_live");
+reporter->set_report_time_interval(0.001);
+reporter->addToReport(coordinate.getOutput("value"));
+model.addComponent(reporter);
+// In another process:
+auto buffer = SharedMemoryRingBuffer::open("opensim_live");
+@endcode
+@ingroup reporters */
+class SharedMemoryReporter : public Reporter<SimTK::Real> {
+    OpenSim_DECLARE_CONCRETE_OBJECT(SharedMemoryReporter,
+                                    Reporter<SimTK::Real>);
+public:
+    OpenSim_DECLARE_PROPERTY(shared_memory_name, std::string,
+        "Name of the shared memory the reported values are written to.");
+    OpenSim_DECLARE_PROPERTY(capacity, int,
+        "Number of reports kept in the ring buffer before the oldest is "
+        "overwritten (default: 4096).");
+
+    SharedMemoryReporter() { constructProperties(); }
+
+    /** Remove the shared memory, if any.                                    */
+    void closeSharedMemory() { _buffer.reset(); }
+
+    /** The ring buffer written by the reports, or nullptr if nothing was
+    reported since the shared memory was last closed.                        */
+    const SharedMemoryRingBuffer* getRingBuffer() const
+    {   return _buffer.get(); }
+
+protected:
+    void implementReport(const SimTK::State& state) const override {
+        const auto& input = getInput<SimTK::Real>("inputs");
+
+        if (!_buffer) {
+            OPENSIM_THROW_IF_FRMOBJ(get_shared_memory_name().empty(),
+                Exception, "Property shared_memory_name is empty.");
+            const_cast<Self*>(this)->_buffer.reset(
+                    SharedMemoryRingBuffer::create(get_shared_memory_name(),
+                        _labels, get_capacity()).release());
+        }
+
+        double* values = _buffer->beginWrite(state.getTime());
+        int idx = 0;
+        for (const auto& chan : input.getChannels())
+            values[idx++] = chan->getValue(state);
+        _buffer->endWrite();
+    }
+
+    void extendFinalizeFromProperties() override {
+        Super::extendFinalizeFromProperties();
+        OPENSIM_THROW_IF_FRMOBJ(get_capacity() < 1, Exception,
+            "Property capacity must be at least 1, but it is " +
+            std::to_string(get_capacity()) + ".");
+    }
+
+    void extendConnect(Component& root) override {
+        Super::extendConnect(root);
+
+        const auto& input = getInput<SimTK::Real>("inputs");
+        _labels.clear();
+        for (auto idx = 0u; idx < input.getNumConnectees(); ++idx)
+            _labels.push_back(input.getLabel(idx));
+        // The records of an existing buffer no longer match the inputs.
+        if (_buffer && _buffer->getLabels() != _labels) _buffer.reset();
+    }
+
+private:
+    void constructProperties() {
+        constructProperty_shared_memory_name("");
+        constructProperty_capacity(4096);
+    }
+
+    std::vector<std::string> _labels;
+    // Written to by the first report, which is const, but reports are never
+    // made with trial integrator states.
+    SimTK::ResetOnCopy<std::unique_ptr<SharedMemoryRingBuffer>> _buffer;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_SHARED_MEMORY_REPORTER_H_
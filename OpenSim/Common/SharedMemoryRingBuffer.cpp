@@ -0,0 +1,341 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  SharedMemoryRingBuffer.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "SharedMemoryRingBuffer.h"
+#include "Exception.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace OpenSim;
+
+namespace {
+const char MAGIC[8] = "OSIMSHM";
+const std::uint32_t VERSION = 1;
+const std::uint64_t ALIGNMENT = 64;
+
+// The header at the start of the segment; see the layout in the header file.
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t numValues;
+    std::uint64_t capacity;
+    std::uint64_t recordSize;
+    std::uint64_t labelsOffset;
+    std::uint64_t labelsSize;
+    std::uint64_t recordsOffset;
+    std::atomic<std::uint64_t> numRecordsWritten;
+};
+static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t),
+    "The counters of the shared memory must be plain 64-bit integers.");
+static_assert(sizeof(Header) == 64, "Unexpected size of the header.");
+
+std::uint64_t roundUp(std::uint64_t size)
+{
+    return (size + ALIGNMENT - 1)/ALIGNMENT*ALIGNMENT;
+}
+
+std::atomic<std::uint64_t>& sequenceOf(char* record)
+{
+    return *reinterpret_cast<std::atomic<std::uint64_t>*>(record);
+}
+}
+
+//=============================================================================
+// SEGMENT
+//=============================================================================
+// A named segment of shared memory mapped into this process.
+struct SharedMemoryRingBuffer::Segment {
+    std::string name;
+    bool owner = false;
+    char* data = nullptr;
+    std::uint64_t size = 0;
+#ifdef _WIN32
+    HANDLE handle = nullptr;
+
+    static std::string getSystemName(const std::string& name)
+    {   return name; }
+
+    ~Segment()
+    {
+        if (data) UnmapViewOfFile(data);
+        if (handle) CloseHandle(handle);
+    }
+
+    void create(std::uint64_t aSize)
+    {
+        handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr,
+            PAGE_READWRITE, DWORD(aSize >> 32), DWORD(aSize & 0xFFFFFFFF),
+            name.c_str());
+        OPENSIM_THROW_IF(!handle, Exception,
+            "Could not create shared memory '" + name + "'.");
+        owner = true;
+        map(aSize, FILE_MAP_ALL_ACCESS);
+    }
+
+    bool open()
+    {
+        handle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+        if (!handle) return false;
+        // The size is read from the header once it is mapped.
+        map(0, FILE_MAP_READ);
+        return true;
+    }
+
+    void map(std::uint64_t aSize, DWORD access)
+    {
+        data = static_cast<char*>(
+                MapViewOfFile(handle, access, 0, 0, SIZE_T(aSize)));
+        OPENSIM_THROW_IF(!data, Exception,
+            "Could not map shared memory '" + name + "'.");
+        size = aSize;
+    }
+#else
+    int fd = -1;
+
+    static std::string getSystemName(const std::string& name)
+    {   return name.empty() || name[0] != '/' ? "/" + name : name; }
+
+    ~Segment()
+    {
+        if (data) munmap(data, size);
+        if (fd >= 0) close(fd);
+        if (owner) shm_unlink(name.c_str());
+    }
+
+    void create(std::uint64_t aSize)
+    {
+        // Replace a segment left by a process that did not remove it.
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        OPENSIM_THROW_IF(fd < 0, Exception,
+            "Could not create shared memory '" + name + "': " +
+            std::strerror(errno) + ".");
+        owner = true;
+        OPENSIM_THROW_IF(ftruncate(fd, off_t(aSize)) != 0, Exception,
+            "Could not allocate " + std::to_string(aSize) + " bytes of "
+            "shared memory '" + name + "': " + std::strerror(errno) + ".");
+        map(aSize, PROT_READ | PROT_WRITE);
+    }
+
+    bool open()
+    {
+        fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat info;
+        OPENSIM_THROW_IF(fstat(fd, &info) != 0, Exception,
+            "Could not get the size of shared memory '" + name + "'.");
+        map(std::uint64_t(info.st_size), PROT_READ);
+        return true;
+    }
+
+    void map(std::uint64_t aSize, int protection)
+    {
+        void* address = mmap(nullptr, aSize, protection, MAP_SHARED, fd, 0);
+        OPENSIM_THROW_IF(address == MAP_FAILED, Exception,
+            "Could not map shared memory '" + name + "': " +
+            std::strerror(errno) + ".");
+        data = static_cast<char*>(address);
+        size = aSize;
+    }
+#endif
+
+    Header& getHeader() const { return *reinterpret_cast<Header*>(data); }
+};
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::create(
+        const std::string& name, const std::vector<std::string>& labels,
+        std::uint64_t capacity)
+{
+    OPENSIM_THROW_IF(name.empty(), Exception,
+        "Expected a name for the shared memory.");
+    OPENSIM_THROW_IF(capacity < 1, Exception,
+        "Expected a capacity of at least 1 record.");
+
+    std::string labelText;
+    for (const auto& label : labels) {
+        OPENSIM_THROW_IF(label.find('\n') != std::string::npos, Exception,
+            "Label '" + label + "' contains a newline.");
+        labelText += label + '\n';
+    }
+    const std::uint64_t recordSize = sizeof(double)*(labels.size() + 2);
+    const std::uint64_t recordsOffset =
+            roundUp(sizeof(Header) + labelText.size());
+
+    std::unique_ptr<Segment> segment(new Segment());
+    segment->name = Segment::getSystemName(name);
+    segment->create(roundUp(recordsOffset + capacity*recordSize));
+
+    // The memory of a new segment is zero, so that no record is valid.
+    Header& header = segment->getHeader();
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.numValues = std::uint32_t(labels.size());
+    header.capacity = capacity;
+    header.recordSize = recordSize;
+    header.labelsOffset = sizeof(Header);
+    header.labelsSize = labelText.size();
+    header.recordsOffset = recordsOffset;
+    std::memcpy(segment->data + header.labelsOffset, labelText.data(),
+                labelText.size());
+    header.numRecordsWritten.store(0, std::memory_order_release);
+
+    return std::unique_ptr<SharedMemoryRingBuffer>(
+            new SharedMemoryRingBuffer(std::move(segment), true));
+}
+
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::open(
+        const std::string& name)
+{
+    std::unique_ptr<Segment> segment(new Segment());
+    segment->name = Segment::getSystemName(name);
+    OPENSIM_THROW_IF(!segment->open(), Exception,
+        "No shared memory named '" + name + "'.");
+
+    OPENSIM_THROW_IF(
+        (segment->size != 0 && segment->size < sizeof(Header)) ||
+        std::memcmp(segment->getHeader().magic, MAGIC, sizeof(MAGIC)) != 0,
+        Exception,
+        "Shared memory '" + name + "' is not a ring buffer of records.");
+    const Header& header = segment->getHeader();
+    OPENSIM_THROW_IF(header.version != VERSION, Exception,
+        "Shared memory '" + name + "' has version " +
+        std::to_string(header.version) + " of the layout, but version " +
+        std::to_string(VERSION) + " was expected.");
+    OPENSIM_THROW_IF(segment->size != 0 && segment->size <
+        header.recordsOffset + header.capacity*header.recordSize, Exception,
+        "Shared memory '" + name + "' is smaller than its records.");
+
+    return std::unique_ptr<SharedMemoryRingBuffer>(
+            new SharedMemoryRingBuffer(std::move(segment), false));
+}
+
+SharedMemoryRingBuffer::SharedMemoryRingBuffer(
+        std::unique_ptr<Segment> segment, bool owner) :
+    _segment(std::move(segment)), _name(_segment->name), _owner(owner)
+{
+    const Header& header = _segment->getHeader();
+    _numValues = header.numValues;
+    _capacity = header.capacity;
+    _recordSize = header.recordSize;
+    _records = _segment->data + header.recordsOffset;
+    _nextRecord = header.numRecordsWritten.load(std::memory_order_acquire);
+}
+
+SharedMemoryRingBuffer::~SharedMemoryRingBuffer() = default;
+
+//=============================================================================
+// ACCESS
+//=============================================================================
+std::vector<std::string> SharedMemoryRingBuffer::getLabels() const
+{
+    const Header& header = _segment->getHeader();
+    const char* text = _segment->data + header.labelsOffset;
+    std::vector<std::string> labels;
+    std::uint64_t begin = 0;
+    for (std::uint64_t i = 0; i < header.labelsSize; ++i) {
+        if (text[i] != '\n') continue;
+        labels.emplace_back(text + begin, text + i);
+        begin = i + 1;
+    }
+    return labels;
+}
+
+std::uint64_t SharedMemoryRingBuffer::getNumRecordsWritten() const
+{
+    return _segment->getHeader().numRecordsWritten.load(
+            std::memory_order_acquire);
+}
+
+char* SharedMemoryRingBuffer::getRecord(std::uint64_t k) const
+{
+    return _records + (k % _capacity)*_recordSize;
+}
+
+//=============================================================================
+// WRITING
+//=============================================================================
+double* SharedMemoryRingBuffer::beginWrite(double time)
+{
+    OPENSIM_THROW_IF(!_owner, Exception,
+        "Shared memory '" + _name + "' was opened for reading only.");
+    char* record = getRecord(_nextRecord);
+    sequenceOf(record).store(2*_nextRecord + 1, std::memory_order_relaxed);
+    // The values must not become visible before the odd sequence.
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(record + sizeof(std::uint64_t), &time, sizeof(double));
+    return reinterpret_cast<double*>(
+            record + sizeof(std::uint64_t) + sizeof(double));
+}
+
+void SharedMemoryRingBuffer::endWrite()
+{
+    sequenceOf(getRecord(_nextRecord)).store(2*_nextRecord + 2,
+                                             std::memory_order_release);
+    ++_nextRecord;
+    _segment->getHeader().numRecordsWritten.store(_nextRecord,
+                                                  std::memory_order_release);
+}
+
+void SharedMemoryRingBuffer::write(double time, const double* values)
+{
+    double* record = beginWrite(time);
+    if (_numValues > 0)
+        std::memcpy(record, values, _numValues*sizeof(double));
+    endWrite();
+}
+
+//=============================================================================
+// READING
+//=============================================================================
+bool SharedMemoryRingBuffer::read(std::uint64_t k, double& time,
+                                  double* values) const
+{
+    char* record = getRecord(k);
+    const std::uint64_t expected = 2*k + 2;
+    if (sequenceOf(record).load(std::memory_order_acquire) != expected)
+        return false;
+    const char* data = record + sizeof(std::uint64_t);
+    std::memcpy(&time, data, sizeof(double));
+    if (_numValues > 0)
+        std::memcpy(values, data + sizeof(double), _numValues*sizeof(double));
+    // The copy must be complete before the sequence is checked again.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequenceOf(record).load(std::memory_order_relaxed) == expected;
+}
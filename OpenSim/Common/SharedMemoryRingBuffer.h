@@ -0,0 +1,146 @@
+#ifndef OPENSIM_SHARED_MEMORY_RING_BUFFER_H_
+#define OPENSIM_SHARED_MEMORY_RING_BUFFER_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  SharedMemoryRingBuffer.h                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+/** A ring buffer of records of a fixed number of values, in a named segment
+of shared memory, written by one process and read by any number of others.
+
+The writer never waits for the readers: it overwrites the oldest record once
+the ring is full, and a reader that falls more than a ring behind loses
+records instead of slowing the writer. A reader detects a record that was
+overwritten while it was being copied, and discards it.
+
+### Layout
+All numbers are in the native byte order of the machine; the segment is
+only meant to be shared between processes of the same machine.
+
+| Offset           | Type        | Contents                                   |
+|------------------|-------------|--------------------------------------------|
+| 0                | char[8]     | Magic "OSIMSHM" with a terminating null.   |
+| 8                | uint32      | Version of the layout (1).                 |
+| 12               | uint32      | Number of values n of each record.         |
+| 16               | uint64      | Capacity c: the number of records.         |
+| 24               | uint64      | Size of a record in bytes: 8*(n+2).        |
+| 32               | uint64      | Offset of the labels.                      |
+| 40               | uint64      | Size of the labels in bytes.               |
+| 48               | uint64      | Offset of the first record.                |
+| 56               | uint64      | Number of records written so far, w.       |
+| labels offset    | char[]      | The n labels, each followed by a newline.  |
+| records offset   | record[c]   | The ring of records.                       |
+
+Record k (counting from 0) is in slot k % c of the ring, and holds
+| Offset | Type      | Contents                                            |
+|--------|-----------|-----------------------------------------------------|
+| 0      | uint64    | Sequence: 2k+1 while being written, 2k+2 after.     |
+| 8      | double    | Time.                                               |
+| 16     | double[n] | Values.                                             |
+
+The records offset and the size of the segment are multiples of 64 bytes.
+The counter w and the sequences are updated atomically (the writer stores
+them with release semantics): the writer stores the odd sequence 2k+1, then
+the time and values, then the even sequence 2k+2, then w = k+1. A reader
+copies record k if w > k and w - k <= c: it loads the sequence (acquire),
+copies the time and values, and loads the sequence again; the copy is valid
+if the sequence was 2k+2 both times. Each record is available to the
+readers, without copying, as long as the writer has not come back to its
+slot.
+
+On POSIX systems, the segment is created with shm_open(); on Windows, it is
+a named file mapping backed by the paging file. The creator removes the
+segment when it is destroyed; processes that still have it open keep it
+until they close it.                                                        */
+class OSIMCOMMON_API SharedMemoryRingBuffer {
+public:
+    /** Create the named segment, replacing any segment of the same name, for
+    records of the values with the given labels. On POSIX systems, the name
+    is prefixed with '/' if it does not start with one.
+    \throws Exception If the segment cannot be created.                      */
+    static std::unique_ptr<SharedMemoryRingBuffer> create(
+            const std::string& name, const std::vector<std::string>& labels,
+            std::uint64_t capacity);
+
+    /** Open an existing segment to read it.
+    \throws Exception If the segment does not exist or is not a ring buffer
+    of this version.                                                         */
+    static std::unique_ptr<SharedMemoryRingBuffer> open(
+            const std::string& name);
+
+    SharedMemoryRingBuffer(const SharedMemoryRingBuffer&) = delete;
+    SharedMemoryRingBuffer& operator=(const SharedMemoryRingBuffer&) = delete;
+
+    /** Unmap the segment; the creator also removes it.                     */
+    ~SharedMemoryRingBuffer();
+
+    const std::string& getName() const { return _name; }
+    /** Whether this buffer created the segment and may write to it.        */
+    bool isWriter() const { return _owner; }
+    int getNumValues() const { return (int)_numValues; }
+    std::uint64_t getCapacity() const { return _capacity; }
+    /** The labels of the values, as given to create().                     */
+    std::vector<std::string> getLabels() const;
+
+    /** The number of records written so far.                               */
+    std::uint64_t getNumRecordsWritten() const;
+
+    /** Start writing the next record, returning the getNumValues() values to
+    fill in place; the record is not visible to the readers until
+    endWrite(). Only the creator writes.                                    */
+    double* beginWrite(double time);
+    /** Publish the record started by beginWrite().                         */
+    void endWrite();
+    /** Write a record of getNumValues() values.                            */
+    void write(double time, const double* values);
+
+    /** Copy record k, which must be one of the getCapacity() records written
+    last, into time and values (room for getNumValues() values).
+    @return false if the record is not (or no longer) available.            */
+    bool read(std::uint64_t k, double& time, double* values) const;
+
+private:
+    struct Segment;
+    SharedMemoryRingBuffer(std::unique_ptr<Segment> segment, bool owner);
+
+    char* getRecord(std::uint64_t k) const;
+
+    std::unique_ptr<Segment> _segment;
+    std::string _name;
+    bool _owner;
+    std::uint32_t _numValues;
+    std::uint64_t _capacity;
+    std::uint64_t _recordSize;
+    char* _records;
+    std::uint64_t _nextRecord;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_SHARED_MEMORY_RING_BUFFER_H_
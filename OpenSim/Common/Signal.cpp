@@ -30,6 +30,8 @@
 #include <math.h>
 #include "Signal.h"
 #include "Array.h"
+#include "TimeSeriesTable.h"
+#include "ThreadPool.h"
 #include "SimTKcommon/Constants.h"
 #include "SimTKcommon/Orientation.h"
 #include "SimTKcommon/Scalar.h"
@@ -37,9 +39,105 @@
 #include "simmath/internal/Spline.h"
 #include "simmath/internal/SplineFitter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
 using namespace OpenSim;
 using namespace std;
 
+namespace {
+    // Call aFilter for each of aNumColumns columns, on several threads if
+    // aNumThreads is not 1 (0 for as many as ThreadPool allows). Return -1
+    // if aFilter did for any column, 0 otherwise.
+    int filterColumns(int aNumColumns,int aNumThreads,
+        const std::function<int(int)>& aFilter)
+    {
+        std::atomic<int> status(0);
+        ThreadPool::parallelFor(aNumColumns,aNumThreads,[&](int i) {
+            if(aFilter(i)!=0) status = -1;
+        });
+        return status;
+    }
+
+    // The 2M+1 coefficients of the lowpass FIR filter, for k=-M,...,M, and
+    // their sum (accumulated in that order).
+    void calcLowpassFIRCoefficients(int M,double T,double f,
+        std::vector<double>& rCoef,double& rSumCoef)
+    {
+        // CALCULATE THE ANGULAR CUTOFF FREQUENCY
+        double w = 2.0*SimTK_PI*f;
+
+        rCoef.resize(2*M+1);
+        rSumCoef = 0.0;
+        for(int k=-M;k<=M;k++) {
+            double x = (double)k*w*T; // k*T = time (seconds) and w scales sinc input argument using filter cutoff
+            // scale lowpass sinc amplitude by 2*f*T = T*w/pi
+            rCoef[M+k] = (Signal::sinc(x)*T*w/SimTK_PI)*Signal::hamming(k,M);
+            rSumCoef = rSumCoef + rCoef[M+k];
+        }
+    }
+
+    // Apply the lowpass FIR filter of order M with coefficients aCoef to sig.
+    // It is permissible for sig and sigf to be the same array or overlap.
+    int lowpassFIR(int M,const std::vector<double>& aCoef,double aSumCoef,
+        int N,const double *sig,double *sigf)
+    {
+        // PAD THE SIGNAL SO FILTERING CAN BEGIN AT THE FIRST DATA POINT
+        double *s = Signal::Pad(M,N,sig);
+        if(s==NULL) return(-1);
+
+        // FILTER THE DATA
+        // s[M+n-k] for k=-M,...,M runs forward through s from s[n].
+        const double *coef = aCoef.data();
+        for(int n=0;n<N;n++) {
+            const double *sn = s + n + 2*M;
+            double sum = 0.0;
+            for(int k=0;k<=2*M;k++)
+                sum = sum + coef[k]*sn[-k];
+            sigf[n] = sum / aSumCoef; // normalize for unity gain at DC
+        }
+
+        // CLEANUP
+        delete[] s;
+        return(0);
+    }
+
+    // Check that the times of a table are equally spaced and return the step.
+    double getUniformTimeStep(const TimeSeriesTable& aTable)
+    {
+        const auto& times = aTable.getIndependentColumn();
+        OPENSIM_THROW_IF(times.size()<2, Exception,
+            "Table has too few rows to be filtered.");
+        double dt = (times.back()-times.front()) / (times.size()-1);
+        for(size_t i=1;i<times.size();i++) {
+            OPENSIM_THROW_IF(std::abs(times[i]-times[i-1]-dt) > 1e-3*dt,
+                Exception, "Table must be sampled at equal time steps to be "
+                "filtered; the step at row " + std::to_string(i) + " is " +
+                std::to_string(times[i]-times[i-1]) + " rather than " +
+                std::to_string(dt) + ".");
+        }
+        return dt;
+    }
+
+    // Filter the columns of a table in place, through a contiguous copy of
+    // them.
+    void filterTable(TimeSeriesTable& rTable,
+        const std::function<int(int,int,double*)>& aFilterBlock)
+    {
+        auto matrix = rTable.updMatrix();
+        const int N = matrix.nrow(), nc = matrix.ncol();
+        std::vector<double> block((size_t)N*nc);
+        for(int j=0;j<nc;j++)
+            for(int i=0;i<N;i++) block[(size_t)j*N+i] = matrix(i,j);
+        OPENSIM_THROW_IF(aFilterBlock(N,nc,block.data())!=0, Exception,
+            "Failed to filter the columns of the table.");
+        for(int j=0;j<nc;j++)
+            for(int i=0;i<N;i++) matrix(i,j) = block[(size_t)j*N+i];
+    }
+}
+
 //=============================================================================
 // FILTERS
 //=============================================================================
@@ -262,9 +360,6 @@ double *sigr;
 int Signal::
 LowpassFIR(int M,double T,double f,int N,double *sig,double *sigf)
 {
-    int n,k;
-    double w,x;
-
     // CHECK THAT M IS NOT TOO LARGE RELATIVE TO N
     if((M+M)>N) {
         printf("rdSingal.lowpassFIR:  ERROR- The number of data points (%d)",N);
@@ -272,53 +367,15 @@ LowpassFIR(int M,double T,double f,int N,double *sig,double *sigf)
         return(-1);
     }
 
-    // PAD THE SIGNAL SO FILTERING CAN BEGIN AT THE FIRST DATA POINT
-    double *s = Pad(M,N,sig);
-    if(s==NULL) return(-1);
-
-    // CALCULATE THE ANGULAR CUTOFF FREQUENCY
-    w = 2.0*SimTK_PI*f;
-
-    // FILTER THE DATA
-    double sum_coef,coef;
-    for(n=0;n<N;n++) {
-        sum_coef = 0.0;
-        sigf[n] = 0.0;
-        for(k=-M;k<=M;k++) {   
-            x = (double)k*w*T; // k*T = time (seconds) and w scales sinc input argument using filter cutoff
-            coef = (sinc(x)*T*w/SimTK_PI)*hamming(k,M); // scale lowpass sinc amplitude by 2*f*T = T*w/pi
-            sigf[n] = sigf[n] + coef*s[M+n-k]; 
-            sum_coef = sum_coef + coef;
-        }
-        sigf[n] = sigf[n] / sum_coef; // normalize for unity gain at DC
-    }
-
-    // Filter check derived from http://www.dspguide.com/CH16.PDF
-    //double sum_coef,coef;
-    //for(n=0;n<N;n++) {
-    //  sum_coef = 0.0;
-    //  sigf[n] = 0.0;
-    //  for(k=-M;k<=M;k++) {
-    //      if(k==0) {
-    //          coef = 2.0*SimTK_PI*f;
-    //      } else {
-    //          coef = sin((double)k*2.0*SimTK_PI*f) / (double)k;
-    //      }
-    //      coef = coef*hamming(k,M);
-    //      sigf[n] = sigf[n] + coef*s[M+n-k];
-    //      sum_coef = sum_coef + coef;
-    //  }
-    //  sigf[n] = sigf[n] / sum_coef;
-    //}
-
-    // CLEANUP
-  delete[] s;
-
-  return(0);
+    // The coefficients do not depend on the data point, so they are
+    // computed once rather than for each point.
+    std::vector<double> coef;
+    double sumCoef;
+    calcLowpassFIRCoefficients(M,T,f,coef,sumCoef);
+    return lowpassFIR(M,coef,sumCoef,N,sig,sigf);
 }
 
 
-
 //_____________________________________________________________________________
 /**
  * BANDPASS FIR NON-RECURSIVE DIGITAL FILTER
@@ -394,6 +451,101 @@ double *s;
   return(0);
 }
 
+//-----------------------------------------------------------------------------
+// MANY SIGNALS
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+/**
+ * Smooth spline each of aNumColumns signals laid out one after the other in
+ * aBlock, in place. See SmoothSpline().
+ *
+ * @return 0 on success, and -1 if any of the signals failed.
+ */
+int Signal::
+SmoothSpline(int degree,double T,double fc,int N,double *times,
+    int aNumColumns,double *aBlock,int aNumThreads)
+{
+    return filterColumns(aNumColumns,aNumThreads,[&](int i) {
+        double *sig = aBlock + (size_t)i*N;
+        return SmoothSpline(degree,T,fc,N,times,sig,sig);
+    });
+}
+//_____________________________________________________________________________
+/**
+ * Lowpass IIR filter each of aNumColumns signals laid out one after the other
+ * in aBlock, in place. See LowpassIIR().
+ *
+ * @return 0 on success, and -1 if any of the signals failed.
+ */
+int Signal::
+LowpassIIR(double T,double fc,int N,int aNumColumns,double *aBlock,
+    int aNumThreads)
+{
+    return filterColumns(aNumColumns,aNumThreads,[&](int i) {
+        // The IIR filter reads its input after writing its output.
+        double *sig = aBlock + (size_t)i*N;
+        std::vector<double> sigf(N);
+        int status = LowpassIIR(T,fc,N,sig,sigf.data());
+        if(status==0) std::copy(sigf.begin(),sigf.end(),sig);
+        return status;
+    });
+}
+//_____________________________________________________________________________
+/**
+ * Lowpass FIR filter each of aNumColumns signals laid out one after the other
+ * in aBlock, in place. See LowpassFIR(). The coefficients of the filter are
+ * computed once for all the signals.
+ *
+ * @return 0 on success, and -1 if any of the signals failed.
+ */
+int Signal::
+LowpassFIR(int M,double T,double f,int N,int aNumColumns,double *aBlock,
+    int aNumThreads)
+{
+    // CHECK THAT M IS NOT TOO LARGE RELATIVE TO N
+    if((M+M)>N) {
+        printf("rdSingal.lowpassFIR:  ERROR- The number of data points (%d)",N);
+        printf(" should be at least twice the order of the filter (%d).\n",M);
+        return(-1);
+    }
+
+    std::vector<double> coef;
+    double sumCoef;
+    calcLowpassFIRCoefficients(M,T,f,coef,sumCoef);
+    return filterColumns(aNumColumns,aNumThreads,[&](int i) {
+        double *sig = aBlock + (size_t)i*N;
+        return lowpassFIR(M,coef,sumCoef,N,sig,sig);
+    });
+}
+//_____________________________________________________________________________
+/**
+ * Lowpass IIR filter the columns of a table in place. See LowpassIIR().
+ */
+void Signal::
+LowpassIIR(TimeSeriesTable& rTable,double fc,int aNumThreads)
+{
+    double T = getUniformTimeStep(rTable);
+    OPENSIM_THROW_IF(rTable.getNumRows()<4, Exception,
+        "Table has too few rows to be filtered.");
+    filterTable(rTable,[&](int N,int nc,double *block) {
+        return LowpassIIR(T,fc,N,nc,block,aNumThreads);
+    });
+}
+//_____________________________________________________________________________
+/**
+ * Lowpass FIR filter the columns of a table in place. See LowpassFIR().
+ */
+void Signal::
+LowpassFIR(TimeSeriesTable& rTable,int M,double f,int aNumThreads)
+{
+    double T = getUniformTimeStep(rTable);
+    OPENSIM_THROW_IF(rTable.getNumRows()<(size_t)(2*M), Exception,
+        "Table has too few rows to be filtered.");
+    filterTable(rTable,[&](int N,int nc,double *block) {
+        return LowpassFIR(M,T,f,N,nc,block,aNumThreads);
+    });
+}
+
 //_____________________________________________________________________________
 /**
  * Pad a signal with a specified number of data points.
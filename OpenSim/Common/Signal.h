@@ -34,6 +34,7 @@
 namespace OpenSim {
 
 template <class T> class Array;
+template <typename ETY> class TimeSeriesTable_;
 
 //=============================================================================
 //=============================================================================
@@ -73,6 +74,38 @@ public:
         double aLowFrequency,double aHighFrequency,
         int aN,double *aSignal,double *aFilteredSignal);
 
+    //--------------------------------------------------------------------------
+    // FILTERS OF MANY SIGNALS
+    //--------------------------------------------------------------------------
+    /** Filter in place aNumColumns signals of aN points each, laid out one
+    after the other in aBlock (as Storage::getDataBlock() does), as the
+    filters above do for one signal. The signals are independent, so they are
+    filtered on aNumThreads threads (0 for as many as ThreadPool allows).
+    @return 0 on success, and -1 if any of the signals failed. */
+    static int
+        SmoothSpline(int aDegree,double aDeltaT,double aCutOffFrequency,
+        int aN,double *aTimes,int aNumColumns,double *aBlock,
+        int aNumThreads=0);
+    static int
+        LowpassIIR(double aDeltaT,double aCutOffFrequency,
+        int aN,int aNumColumns,double *aBlock,int aNumThreads=0);
+    static int
+        LowpassFIR(int aOrder,double aDeltaT,double aCutoffFrequency,
+        int aN,int aNumColumns,double *aBlock,int aNumThreads=0);
+
+    /** Lowpass filter in place the columns of a table whose times are
+    equally spaced (see LowpassIIR()). An Exception is thrown if they are
+    not, or if the table has too few rows to be filtered. */
+    static void
+        LowpassIIR(TimeSeriesTable_<double>& rTable,double aCutOffFrequency,
+        int aNumThreads=0);
+    /** Lowpass filter in place the columns of a table whose times are
+    equally spaced (see LowpassFIR()). An Exception is thrown if they are
+    not, or if the table has too few rows to be filtered. */
+    static void
+        LowpassFIR(TimeSeriesTable_<double>& rTable,int aOrder,
+        double aCutoffFrequency,int aNumThreads=0);
+
     //--------------------------------------------------------------------------
     // PADDING
     //--------------------------------------------------------------------------
@@ -324,6 +324,9 @@ void SimmSpline::calcCoefficients()
     int nm1, nm2, i, j;
    double t;
 
+   // The points have changed (see Function::getRevision()).
+   resetFunction();
+
    if (n < 2)
       return;
 
@@ -509,6 +512,11 @@ int SimmSpline::addPoint(double aX, double aY)
 }
 
 double SimmSpline::calcValue(const Vector& x) const
+{
+    return calcValue(x[0]);
+}
+
+double SimmSpline::calcValue(double aX) const
 {
     // NOT A NUMBER
     if(!_y.getSize()) return(SimTK::NaN);
@@ -516,11 +524,10 @@ double SimmSpline::calcValue(const Vector& x) const
     if(!_c.getSize()) return(SimTK::NaN);
     if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
+    int k;
     double dx;
 
     int n = _x.getSize();
-    double aX = x[0];
 
    /* Check if the abscissa is out of range of the function. If it is,
     * then use the slope of the function at the appropriate end point to
@@ -546,36 +553,18 @@ double SimmSpline::calcValue(const Vector& x) const
    else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
        return _y[n-1];
 
-    if (n < 3)
-    {
-        /* If there are only 2 function points, then set k to zero
-         * (you've already checked to see if the abscissa is out of
-         * range or equal to one of the endpoints).
-         */
-        k = 0;
-    }
-    else
-    {
-        /* Do a binary search to find which two points the abscissa is between. */
-        i = 0;
-        j = n;
-        while (1)
-        {
-            k = (i+j)/2;
-            if (aX < _x[k])
-                j = k;
-            else if (aX > _x[k+1])
-                i = k;
-            else
-                break;
-        }
-    }
+    k = findInterval(aX);
 
    dx = aX - _x[k];
    return _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
 }
 
 double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+{
+    return calcDerivative(x[0], (int)derivComponents.size());
+}
+
+double SimmSpline::calcDerivative(double aX, int aDerivOrder) const
 {
     // NOT A NUMBER
     if(!_y.getSize()) return(SimTK::NaN);
@@ -583,12 +572,10 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
     if(!_c.getSize()) return(SimTK::NaN);
     if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
+    int k;
     double dx;
 
     int n = _x.getSize();
-    double aX = x[0];
-    int aDerivOrder = (int)derivComponents.size();
     if (aDerivOrder < 1 || aDerivOrder > 2)
         throw Exception("SimmSpline::calcDerivative(): derivative order must be 1 or 2.");
 
@@ -636,38 +623,105 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
          return 2.0*_c[n-1];
    }
 
+    k = findInterval(aX);
+
+   dx = aX - _x[k];
+
+   if (aDerivOrder == 1)
+      return (_b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]));
+
+   else
+      return (2.0*_c[k] + 6.0*dx*_d[k]);
+}
+
+void SimmSpline::calcValues(const Vector& x, Vector& values) const
+{
+    values.resize(x.size());
+    int n = _x.getSize();
+    if(!_y.getSize() || !_b.getSize() || !_c.getSize() || !_d.getSize()) {
+        values = SimTK::NaN;
+        return;
+    }
+
+    // Consecutive abscissae are often in the same interval (e.g., when
+    // sampling the spline), so the interval of the previous one is tried
+    // before searching for another. Abscissae out of range, close to the end
+    // points or on a knot are handled by calcValue().
+    int k = 0;
+    for (int m = 0; m < x.size(); ++m) {
+        double aX = x[m];
+        if (aX <= _x[0] || aX >= _x[n-1] ||
+            EQUAL_WITHIN_ERROR(aX,_x[0]) || EQUAL_WITHIN_ERROR(aX,_x[n-1])) {
+            values[m] = calcValue(aX);
+            continue;
+        }
+        if (!(_x[k] < aX && aX < _x[k+1])) {
+            k = findInterval(aX);
+            if (!(_x[k] < aX && aX < _x[k+1])) {
+                values[m] = calcValue(aX);
+                continue;
+            }
+        }
+        double dx = aX - _x[k];
+        values[m] = _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
+    }
+}
+
+double SimmSpline::calcValueNear(double aX, int& interval) const
+{
+    int n = _x.getSize();
+    if(!_y.getSize() || !_b.getSize() || !_c.getSize() || !_d.getSize() ||
+        !findIntervalNear(&_x[0], n, aX, interval) ||
+        EQUAL_WITHIN_ERROR(aX,_x[0]) || EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return calcValue(aX);
+
+    int k = interval;
+    double dx = aX - _x[k];
+    return _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
+}
+
+SimTK::Vec3 SimmSpline::calcValueAndDerivativesNear(double aX,
+                                                    int& interval) const
+{
+    int n = _x.getSize();
+    if(!_y.getSize() || !_b.getSize() || !_c.getSize() || !_d.getSize() ||
+        !findIntervalNear(&_x[0], n, aX, interval) ||
+        EQUAL_WITHIN_ERROR(aX,_x[0]) || EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return SimTK::Vec3(calcValue(aX), calcDerivative(aX, 1),
+                           calcDerivative(aX, 2));
+
+    int k = interval;
+    double dx = aX - _x[k];
+    return SimTK::Vec3(_y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k])),
+                       _b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]),
+                       2.0*_c[k] + 6.0*dx*_d[k]);
+}
+
+int SimmSpline::findInterval(double aX) const
+{
+    int n = _x.getSize();
     if (n < 3)
     {
         /* If there are only 2 function points, then set k to zero
          * (you've already checked to see if the abscissa is out of
          * range or equal to one of the endpoints).
          */
-        k = 0;
+        return 0;
     }
-    else
+
+    /* Do a binary search to find which two points the abscissa is between. */
+    int i = 0, j = n, k;
+    while (1)
     {
-        /* Do a binary search to find which two points the abscissa is between. */
-        i = 0;
-        j = n;
-        while (1)
-        {
-            k = (i+j)/2;
-            if (aX < _x[k])
-                j = k;
-            else if (aX > _x[k+1])
-                i = k;
-            else
-                break;
-        }
+        k = (i+j)/2;
+        if (aX < _x[k])
+            j = k;
+        else if (aX > _x[k+1])
+            i = k;
+        else
+            break;
     }
-
-   dx = aX - _x[k];
-
-   if (aDerivOrder == 1)
-      return (_b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]));
-
-   else
-      return (2.0*_c[k] + 6.0*dx*_d[k]);
+    return k;
 }
 
 int SimmSpline::getArgumentSize() const
@@ -103,6 +103,11 @@ public:
     int getSize() const;
     const Array<double>& getX() const;
     const Array<double>& getY() const;
+    /** The coefficients of the cubic polynomials between the points, such
+    that y = y[i] + dx*(b[i] + dx*(c[i] + dx*d[i])) with dx = x - x[i]. */
+    const Array<double>& getB() const { return _b; }
+    const Array<double>& getC() const { return _c; }
+    const Array<double>& getD() const { return _d; }
     virtual const double* getXValues() const;
     virtual const double* getYValues() const;
     virtual int getNumberOfPoints() const { return _x.getSize(); }
@@ -120,6 +125,12 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const override;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const override;
+    double calcValue(double x) const override;
+    double calcValueNear(double x, int& interval) const override;
+    SimTK::Vec3 calcValueAndDerivativesNear(double x,
+                                            int& interval) const override;
+    double calcDerivative(double x, int order) const override;
+    void calcValues(const SimTK::Vector& x, SimTK::Vector& values) const override;
     int getArgumentSize() const override;
     int getMaxDerivativeOrder() const override;
     SimTK::Function* createSimTKFunction() const override;
@@ -128,6 +139,9 @@ public:
 
 private:
     void calcCoefficients();
+    // The index k of the interval [x[k], x[k+1]] that contains aX, which
+    // must be within the range of the spline.
+    int findInterval(double aX) const;
 //=============================================================================
 };  // END class SimmSpline
 
@@ -128,6 +128,16 @@ public:
         return _amplitude*pow(_omega,n)*sin(_omega*x[0] + _phase + n*SimTK::Pi/2);
     }
 
+    double calcValue(double x) const override
+    {
+        return _amplitude*sin(_omega*x + _phase);
+    }
+
+    double calcDerivative(double x, int order) const override
+    {
+        return _amplitude*pow(_omega,order)*sin(_omega*x + _phase + order*SimTK::Pi/2);
+    }
+
     SimTK::Function* createSimTKFunction() const override {
         return new FunctionAdapter(*this);
     }
@@ -25,6 +25,9 @@
 //=============================================================================
 #include "SmoothSegmentedFunction.h"
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "simmath/internal/SplineFitter.h"
 
 //=============================================================================
@@ -39,6 +42,57 @@ static double UTOL = (double)SimTK::Eps*1e2;
 static double INTTOL = (double)SimTK::Eps*1e2;
 static int MAXITER = 20;
 static int NUM_SAMPLE_PTS = 100;
+static int MAX_TABLE_INTERVALS = 1 << 16;
+
+namespace {
+    // Guards the tables shared by the curves of all the muscles.
+    std::mutex tableRegistryMutex;
+}
+
+//=============================================================================
+// TABLE
+//=============================================================================
+/*The values and first derivatives (scaled by the node spacing h) of the curve
+at uniformly spaced nodes, stored next to each other so that an evaluation
+touches a single cache line. Within an interval, with s in [0,1],
+    y(s) = y0 + s*(m0 + s*(c2 + s*c3))
+    c2   = 3*(y1-y0) - 2*m0 - m1
+    c3   = m0 + m1 - 2*(y1-y0)
+*/
+struct SmoothSegmentedFunction::Table {
+    double x0;
+    double invH;
+    int numIntervals;
+    std::vector<double> data; // y_i, h*dydx_i for each node i
+
+    void locate(double x, int& i, double& s) const {
+        double t = (x - x0)*invH;
+        i = (int)t;
+        if(i >= numIntervals) i = numIntervals-1;
+        if(i < 0) i = 0;
+        s = t - i;
+    }
+
+    double calcValue(double x) const {
+        int i; double s;
+        locate(x, i, s);
+        const double* p = &data[2*i];
+        double d  = p[2] - p[0];
+        double c2 = 3*d - 2*p[1] - p[3];
+        double c3 = p[1] + p[3] - 2*d;
+        return p[0] + s*(p[1] + s*(c2 + s*c3));
+    }
+
+    double calcDerivative(double x) const {
+        int i; double s;
+        locate(x, i, s);
+        const double* p = &data[2*i];
+        double d  = p[2] - p[0];
+        double c2 = 3*d - 2*p[1] - p[3];
+        double c3 = p[1] + p[3] - 2*d;
+        return (p[1] + s*(2*c2 + 3*s*c3))*invH;
+    }
+};
 //=============================================================================
 // UTILITY FUNCTIONS
 //=============================================================================
@@ -95,7 +149,8 @@ SmoothSegmentedFunction::
           double x0, double x1, double y0, double y1,double dydx0, double dydx1,
           bool computeIntegral, bool intx0x1, const std::string& name):
 _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
-     _computeIntegral(computeIntegral),_intx0x1(intx0x1),_name(name)
+     _computeIntegral(computeIntegral),_intx0x1(intx0x1),_name(name),
+     _tabulationTolerance(0)
 {
     
 
@@ -166,7 +221,8 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
  SmoothSegmentedFunction::SmoothSegmentedFunction():
  _x0(SimTK::NaN),_x1(SimTK::NaN),_y0(SimTK::NaN)
      ,_y1(SimTK::NaN),_dydx0(SimTK::NaN),_dydx1(SimTK::NaN),
-     _computeIntegral(false),_intx0x1(false),_name("NOT_YET_SET")
+     _computeIntegral(false),_intx0x1(false),_name("NOT_YET_SET"),
+     _tabulationTolerance(0)
  {
         _arraySplineUX.resize(0);        
         _mXVec.resize(0);
@@ -202,6 +258,7 @@ double SmoothSegmentedFunction::calcValue(double x) const
     double yVal = 0;
     if(x >= _x0 && x <= _x1 )
     {
+        if(_table) return _table->calcValue(x);
         int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
         double u = SegmentedQuinticBezierToolkit::
                  calcU(x,_mXVec[idx], _arraySplineUX[idx], UTOL,MAXITER);
@@ -269,7 +326,9 @@ double SmoothSegmentedFunction::calcDerivative(double x, int order) const
     if(order==0){
                 yVal = calcValue(x);
     }else{
-            if(x >= _x0 && x <= _x1){        
+            if(x >= _x0 && x <= _x1 && _table && order == 1){
+                yVal = _table->calcDerivative(x);
+            }else if(x >= _x0 && x <= _x1){        
                 int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
                 double u = SegmentedQuinticBezierToolkit::
                                 calcU(x,_mXVec[idx], _arraySplineUX[idx], 
@@ -296,6 +355,128 @@ double SmoothSegmentedFunction::calcDerivative(double x, int order) const
 
 
 
+void SmoothSegmentedFunction::calcDerivatives(const SimTK::Vector& x, 
+                                              SimTK::Vector& y, 
+                                              int order) const
+{
+    y.resize(x.size());
+
+    //The Bezier sections are contiguous and increasing in x, so the section
+    //of the previous point is the section calcIndex would find for x(i) if
+    //x(i) is in it and not in the section before it.
+    int idx = 0;
+    for(int i=0; i < x.size(); ++i){
+        const double xi = x[i];
+        if(xi >= _x0 && xi <= _x1 && !_table){
+            const SimTK::Vector& xPts = _mXVec[idx];
+            if(!(xi >= xPts(0) && xi < xPts(5) 
+                 && (idx == 0 || xi >= _mXVec[idx-1](5)))){
+                idx = SegmentedQuinticBezierToolkit::calcIndex(xi,_mXVec);
+            }
+            double u = SegmentedQuinticBezierToolkit::
+                            calcU(xi,_mXVec[idx], _arraySplineUX[idx], 
+                            UTOL,MAXITER);
+            if(order == 0){
+                y[i] = SegmentedQuinticBezierToolkit::
+                            calcQuinticBezierCurveVal(u,_mYVec[idx]);
+            }else{
+                y[i] = SegmentedQuinticBezierToolkit::
+                            calcQuinticBezierCurveDerivDYDX(u, _mXVec[idx], 
+                            _mYVec[idx], order);
+            }
+        }else{
+            y[i] = calcDerivative(xi, order);
+        }
+    }
+}
+
+void SmoothSegmentedFunction::tabulate(double tolerance)
+{
+    SimTK_ERRCHK2_ALWAYS( tolerance >= 0,
+        "SmoothSegmentedFunction::tabulate",
+        "%s: The tolerance must be positive, or 0 to evaluate the curve "
+        "exactly, but %f was entered", _name.c_str(), tolerance);
+
+    _table.reset();
+    _tabulationTolerance = 0;
+    if(tolerance > 0){
+        _table = findOrBuildTable(tolerance);
+        _tabulationTolerance = tolerance;
+    }
+}
+
+double SmoothSegmentedFunction::getTabulationTolerance() const
+{
+    return _tabulationTolerance;
+}
+
+std::shared_ptr<const SmoothSegmentedFunction::Table> 
+    SmoothSegmentedFunction::findOrBuildTable(double tolerance) const
+{
+    //Curves with the same control points and extrapolation are the same
+    //curve, whatever muscle they belong to.
+    std::vector<double> key = {tolerance, _x0, _x1, _y0, _y1, _dydx0, _dydx1};
+    for(int s=0; s < _numBezierSections; s++){
+        for(int i=0; i < _mXVec[s].size(); i++) key.push_back(_mXVec[s](i));
+        for(int i=0; i < _mYVec[s].size(); i++) key.push_back(_mYVec[s](i));
+    }
+
+    static std::map<std::vector<double>, std::weak_ptr<const Table>> registry;
+    std::lock_guard<std::mutex> lock(tableRegistryMutex);
+    auto it = registry.find(key);
+    if(it != registry.end()){
+        if(auto table = it->second.lock()) return table;
+    }
+
+    //Double the number of intervals until the interpolation error is within
+    //the tolerance. Where the fourth derivative of the curve is nearly 
+    //constant over an interval, the error of the value is largest at the 
+    //midpoint and that of the derivative at s = 1/2 -+ sqrt(3)/6. The curve
+    //is evaluated exactly since this curve has no table yet.
+    for(int n = 8*_numBezierSections; n <= MAX_TABLE_INTERVALS; n *= 2){
+        auto table = std::make_shared<Table>();
+        double h = (_x1-_x0)/n;
+        table->x0 = _x0;
+        table->invH = 1.0/h;
+        table->numIntervals = n;
+        table->data.resize(2*(n+1));
+        for(int i=0; i <= n; i++){
+            double xi = (i == n) ? _x1 : _x0 + i*h;
+            table->data[2*i]   = calcValue(xi);
+            table->data[2*i+1] = calcDerivative(xi,1)*h;
+        }
+
+        bool withinTolerance = true;
+        for(int i=0; i < n && withinTolerance; i++){
+            for(double s : {0.2113248654051871, 0.25, 0.5, 0.75, 
+                            0.7886751345948129}){
+                double xi = _x0 + (i+s)*h;
+                if(std::abs(table->calcValue(xi) - calcValue(xi)) > tolerance
+                   || std::abs(table->calcDerivative(xi) - calcDerivative(xi,1)) 
+                        > tolerance){
+                    withinTolerance = false;
+                    break;
+                }
+            }
+        }
+
+        if(withinTolerance){
+            for(auto entry = registry.begin(); entry != registry.end();){
+                if(entry->second.expired()) entry = registry.erase(entry);
+                else ++entry;
+            }
+            registry[key] = table;
+            return table;
+        }
+    }
+
+    SimTK_ERRCHK2_ALWAYS( false,
+        "SmoothSegmentedFunction::tabulate",
+        "%s: A table of %i intervals cannot meet the tolerance of %e; use a "
+        "larger tolerance", _name.c_str(), MAX_TABLE_INTERVALS, tolerance);
+    return nullptr;
+}
+
 double SmoothSegmentedFunction::
     calcDerivative(const SimTK::Array_<int>& derivComponents,
                  const SimTK::Vector& ax) const
@@ -25,6 +25,8 @@
 #include "osimCommonDLL.h"
 #include "SegmentedQuinticBezierToolkit.h"
 
+#include <memory>
+
 namespace OpenSim { 
 
     /**
@@ -122,6 +124,52 @@ namespace OpenSim {
        */
        double calcDerivative(double x, int order) const;       
 
+       /**Calculates the value, or a derivative, of the curve this object 
+       represents at many domain points at once. The results are identical to
+       those of calcDerivative(x(i), order) at each point, but the Bezier 
+       section containing each point is found faster when consecutive points
+       are close to each other (e.g., when sampling the curve or evaluating 
+       the same curve for neighboring states).
+
+       @param x     The domain points of interest.
+
+       @param y     The values of the d^ny/dx^n th derivative evaluated at 
+                    each point of x. It is resized to the size of x.
+
+       @param order The order of the derivative to compute. Calling 0 
+                    computes the values of the curve.
+       */
+       void calcDerivatives(const SimTK::Vector& x, SimTK::Vector& y, 
+                            int order = 0) const;
+
+       /**Evaluates the values and first derivatives of this curve from a 
+       table of cubic Hermite polynomials instead of the Bezier curves, which
+       costs a few flops per evaluation instead of a few hundred. The nodes of
+       the table are uniformly spaced over the curve domain, and there are 
+       enough of them that the tabulated values and first derivatives differ 
+       from those of the Bezier curves by no more than the tolerance at the 
+       points of every interval where the error of the interpolation is 
+       largest. Second derivatives, the integral and the 
+       linear extrapolation outside of the curve domain are still evaluated 
+       exactly.
+
+       Copies of this curve, and curves with identical control points 
+       tabulated with the same tolerance, share one table.
+
+       @param tolerance The largest error allowed in the values and first
+                        derivatives. A tolerance of 0 discards the table, so
+                        that the curve is evaluated exactly again.
+
+       @throws SimTK::Exception
+        -If the tolerance is negative
+        -If the tolerance cannot be met by a table of 2^16 intervals
+       */
+       void tabulate(double tolerance);
+
+       /**@return The tolerance of the table used to evaluate this curve, or 0
+       if the curve is evaluated exactly.*/
+       double getTabulationTolerance() const;
+
        
 
      
@@ -336,6 +384,17 @@ namespace OpenSim {
         bool _intx0x1;
         /**The name of the function**/
         std::string _name;
+
+        /**Cubic Hermite table of the values and first derivatives of the 
+        curve, or null if the curve is evaluated exactly*/
+        struct Table;
+        std::shared_ptr<const Table> _table;
+        /**The tolerance the table was built for*/
+        double _tabulationTolerance;
+
+        /**Build a table that meets the tolerance, or find the table already
+        built for a curve with the same control points*/
+        std::shared_ptr<const Table> findOrBuildTable(double tolerance) const;
             
         /**No human should be constructing a SmoothSegmentedFunction, so the
         constructor is made private so that mere mortals cannot look at it. 
@@ -180,6 +180,24 @@ setStates(double aT, const SimTK::Vector_<double>& data) {
     }
 }
 //_____________________________________________________________________________
+/**
+ * Set the time stamp and the values of the states from an array of aN
+ * values. The memory already held by the state vector is reused when it is
+ * large enough.
+ *
+ * @param aT Time stamp of the state-vector.
+ * @param aN Number of values.
+ * @param aY Array of values to set the state-vector to.
+ */
+void StateVector::
+setStates(double aT, int aN, const double aY[]) {
+    _t = aT;
+    _data.setSize(aN);
+    for(int i = 0; i < aN; ++i) {
+        _data[i] = aY[i];
+    }
+}
+//_____________________________________________________________________________
 /**
  * Get the size of the data vector.
  */
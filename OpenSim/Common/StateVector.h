@@ -98,6 +98,9 @@ public:
     //--------------------------------------------------------------------------
 public:
     void setStates(double aT, const SimTK::Vector_<double>& data);
+#ifndef SWIG
+    void setStates(double aT, int aN, const double aY[]);
+#endif
     int getSize() const;
     void setTime(double aT);
     double  getTime() const;
@@ -27,6 +27,11 @@
 
 
 // INCLUDES
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <exception>
+#include <functional>
 #include <iostream>
 #include "IO.h"
 #include "Signal.h"
@@ -36,6 +41,7 @@
 #include "SimTKcommon.h"
 #include "GCVSpline.h"
 #include "StateVector.h"
+#include "ThreadPool.h"
 
 using namespace OpenSim;
 using namespace std;
@@ -54,6 +60,147 @@ using namespace std;
 const char* Storage::DEFAULT_HEADER_TOKEN = "endheader";
 const char* Storage::DEFAULT_HEADER_SEPARATOR = " \t\r\n";
 const int Storage::MAX_RESAMPLE_SIZE = 100000;
+
+namespace {
+    // Number of rows formatted into each buffer handed to fwrite().
+    const int PRINT_BLOCK_SIZE = 1024;
+    // Number of rows that resampleLinear() and integrate() compute into a
+    // buffer before appending them, which bounds the memory they use.
+    const int ROW_BLOCK_SIZE = 1024;
+    // Fewest columns worth integrating on a thread of their own.
+    const int MIN_COLUMNS_PER_THREAD = 16;
+
+    // Append aValue to rOut, formatted with the printf format aFormat.
+    void appendDouble(string& rOut,const char *aFormat,double aValue)
+    {
+        char buffer[64];
+        int n = snprintf(buffer,sizeof(buffer),aFormat,aValue);
+        if(n<0) return;
+        if(n<(int)sizeof(buffer)) {
+            rOut.append(buffer,n);
+            return;
+        }
+        // Large values in fixed notation do not fit the buffer.
+        size_t size = rOut.size();
+        rOut.resize(size+n+1);
+        snprintf(&rOut[size],n+1,aFormat,aValue);
+        rOut.resize(size+n);
+    }
+
+    // Append a row of the file to rOut, formatted as StateVector::print().
+    void appendRow(string& rOut,const char *aFormat,double aTime,
+        const double *aData,int aN)
+    {
+        appendDouble(rOut,aFormat,aTime);
+        for(int i=0;i<aN;i++) {
+            rOut += '\t';
+            appendDouble(rOut,aFormat,aData[i]);
+        }
+        rOut += '\n';
+    }
+
+    // Write aNumRows rows to rFP. aFormat appends the rows in [begin,end) to
+    // a string; blocks of rows are formatted on as many threads as
+    // ThreadPool allows, and each block is written with a single fwrite().
+    // Return the number of characters written, or -1 on a write error.
+    long long printRows(FILE *rFP,int aNumRows,
+        const std::function<void(int,int,string&)>& aFormat)
+    {
+        const int numBlocks = (aNumRows+PRINT_BLOCK_SIZE-1)/PRINT_BLOCK_SIZE;
+        const int numThreads = std::min(numBlocks,
+            ThreadPool::getMaxNumThreads());
+
+        // Format numThreads blocks at a time so that memory use stays
+        // bounded, and write them in order.
+        vector<string> buffers(numThreads);
+        long long nTotal = 0;
+        for(int first=0;first<numBlocks;first+=numThreads) {
+            int n = std::min(numThreads,numBlocks-first);
+            ThreadPool::parallelFor(n,n,[&](int t) {
+                buffers[t].clear();
+                int begin = (first+t)*PRINT_BLOCK_SIZE;
+                int end = std::min(aNumRows,begin+PRINT_BLOCK_SIZE);
+                aFormat(begin,end,buffers[t]);
+            });
+
+            for(int t=0;t<n;t++) {
+                const string& buffer = buffers[t];
+                if(fwrite(buffer.data(),1,buffer.size(),rFP)!=buffer.size())
+                    return -1;
+                nTotal += buffer.size();
+            }
+        }
+        return nTotal;
+    }
+
+    // Apply aOp(y,x) to each value y in the rows of rStorage, where x is the
+    // value in the same column of aStorage at the time of the row. A row of
+    // aStorage at that very time is used as is; otherwise aStorage is
+    // interpolated linearly. The times of both storages increase, so a cursor
+    // walks through aStorage once instead of searching it for every row.
+    template <class Op>
+    void combineRows(Storage& rStorage,const Storage& aStorage,Op aOp)
+    {
+        Storage::Cursor cursor;
+        vector<double> interpolated;
+        for(int i=0;i<rStorage.getSize();i++) {
+            Array<double>& y = rStorage.getStateVector(i)->getData();
+            double t = rStorage.getStateVector(i)->getTime();
+
+            int j = aStorage.findIndex(t,cursor);
+            if(j<0) return;
+            const StateVector *row = aStorage.getStateVector(j);
+            const double *x = row->getData().get();
+            int N = row->getSize();
+            if(row->getTime()!=t) {
+                interpolated.resize(N);
+                N = aStorage.getDataAtTime(t,N,interpolated.data(),cursor);
+                x = interpolated.data();
+            }
+
+            int n = std::min(y.getSize(),N);
+            for(int k=0;k<n;k++) aOp(y[k],x[k]);
+        }
+    }
+
+    // Add the areas under the first aN columns of aStorage between rows aI1
+    // and aI2 to rArea, by the trapezoidal rule, and append the running areas
+    // at rows aI1+1 to aI2 to rStorage if it is not NULL. The columns are
+    // split across as many threads as ThreadPool allows, a block of rows at a
+    // time, and each column is summed in the order of its rows.
+    void integrateRows(const Storage& aStorage,int aI1,int aI2,int aN,
+        double *rArea,Storage *rStorage)
+    {
+        const int numRanges = std::max(1,std::min(
+            ThreadPool::getMaxNumThreads(),aN/MIN_COLUMNS_PER_THREAD));
+        vector<double> areas(rStorage ? (size_t)ROW_BLOCK_SIZE*aN : 0);
+        for(int first=aI1;first<aI2;first+=ROW_BLOCK_SIZE) {
+            int last = std::min(aI2,first+ROW_BLOCK_SIZE);
+            ThreadPool::parallelForRanges(aN,numRanges,
+                [&](int,int begin,int end) {
+                for(int I=first;I<last;I++) {
+                    const StateVector *vi = aStorage.getStateVector(I);
+                    const StateVector *vf = aStorage.getStateVector(I+1);
+                    const double dt = vf->getTime()-vi->getTime();
+                    const double *yi = vi->getData().get();
+                    const double *yf = vf->getData().get();
+                    for(int i=begin;i<end;i++)
+                        rArea[i] += 0.5*(yf[i]+yi[i])*dt;
+                    if(rStorage) {
+                        double *a = areas.data()+(size_t)(I-first)*aN;
+                        std::copy(rArea+begin,rArea+end,a+begin);
+                    }
+                }
+            });
+            if(rStorage) {
+                for(int I=first;I<last;I++) {
+                    rStorage->append(aStorage.getStateVector(I+1)->getTime(),
+                        aN,areas.data()+(size_t)(I-first)*aN);
+                }
+            }
+        }
+    }
+}
 //============================================================================
 // STATICS
 //============================================================================
@@ -116,6 +263,47 @@ Storage::Storage(int aCapacity,const string &aName) :
 Storage::Storage(const string &aFileName, bool readHeadersOnly) :
     StorageInterface(aFileName),
     _storage(StateVector())
+{
+    readFile(aFileName, readHeadersOnly, ColumnSelection{});
+}
+//_____________________________________________________________________________
+/**
+ * Construct an Storage instance from the selected columns of a file.
+ *
+ * @param aFileName Name of the file from which the Storage is to be
+ * constructed.
+ * @param aSelection Columns, other than time, to be read.
+ */
+Storage::Storage(const string &aFileName, const ColumnSelection& aSelection) :
+    StorageInterface(aFileName),
+    _storage(StateVector())
+{
+    readFile(aFileName, false, aSelection);
+}
+//_____________________________________________________________________________
+/**
+ * Construct an Storage instance from the rows of a file in a time range.
+ *
+ * @param aFileName Name of the file from which the Storage is to be
+ * constructed.
+ * @param aStartTime Time of the first row to be read.
+ * @param aEndTime Time of the last row to be read.
+ * @param aSelection Columns, other than time, to be read.
+ */
+Storage::Storage(const string &aFileName, double aStartTime, double aEndTime,
+    const ColumnSelection& aSelection) :
+    StorageInterface(aFileName),
+    _storage(StateVector())
+{
+    readFile(aFileName, false, aSelection, aStartTime, aEndTime);
+}
+//_____________________________________________________________________________
+/**
+ * Read the file for one of the constructors from file.
+ */
+void Storage::
+readFile(const string &aFileName, bool readHeadersOnly,
+    const ColumnSelection& aSelection, double aStartTime, double aEndTime)
 {
     // SET NULL STATES
     setNull();
@@ -152,7 +340,8 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
             << _columnLabels.getSize() << " were found" << std::endl;
     }
     // CAPACITY
-    _storage.ensureCapacity(nr);
+    if(aStartTime==-SimTK::Infinity && aEndTime==SimTK::Infinity)
+        _storage.ensureCapacity(nr);
     _storage.setCapacityIncrement(-1);
 
     // There are situations where we don't want to read the whole file in advance just header
@@ -165,6 +354,42 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
     int indexRange = currentLabels.findIndex("range");
 
 
+    // SELECTED COLUMNS
+    if(!aSelection.selectsAll()) {
+        OPENSIM_THROW_IF(indexTime != 0, Exception,
+            "Storage: a selection of the columns of file " + aFileName +
+            " can only be read if its first column is time.");
+        OPENSIM_THROW_IF(currentLabels.getSize() != nc, Exception,
+            "Storage: a selection of the columns of file " + aFileName +
+            " can only be read if its header gives the number of labels.");
+        vector<string> dataLabels;
+        for(int i=1;i<currentLabels.getSize();i++)
+            dataLabels.push_back(currentLabels[i]);
+        const vector<size_t> columns = aSelection.findColumns(dataLabels);
+
+        Array<std::string> labels("", 0, (int)columns.size()+1);
+        labels.append("time");
+        for(size_t c : columns) labels.append(dataLabels[c]);
+        setColumnLabels(labels);
+
+        // Every value is still extracted from the file, but only those of
+        // the selected columns are stored.
+        int ny = nc-1;
+        double time;
+        vector<double> y(ny), selected(columns.size());
+        for(int r=0;r<nr;r++) {
+                (*fp)>>time;
+                for(int i=0;i<ny;i++)
+                    (*fp)>>y[i];
+                if(time<aStartTime) continue;
+                if(time>aEndTime) break;
+                for(size_t i=0;i<columns.size();i++)
+                    selected[i] = y[columns[i]];
+                append(time,(int)selected.size(),selected.data());
+        }
+        return;
+    }
+
     // DATA 
     if(indexTime != -1 || indexRange != -1){ //MM edit
         int ny = nc-1;
@@ -174,6 +399,8 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
                 (*fp)>>time;
                 for(int i=0;i<ny;i++)
                     (*fp)>>y[i];
+                if(time<aStartTime) continue;
+                if(time>aEndTime) break;
                 append(time,ny,y);
         }
         delete[] y;
@@ -187,6 +414,8 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
                 time=(double)r;
                 for(int i=0;i<ny;i++)
                     (*fp)>>y[i];
+                if(time<aStartTime) continue;
+                if(time>aEndTime) break;
                 append(time,ny,y);
         }
         delete[] y;
@@ -227,6 +456,56 @@ Storage::Storage(const Storage &aStorage,bool aCopyData) :
     if(aCopyData) copyData(aStorage);
 }
 //_____________________________________________________________________________
+/**
+ * Construct a storage from a TimeSeriesTable. The rows are allocated at once
+ * and each value of the table is copied directly into its StateVector.
+ *
+ * @param aTable Table to be copied.
+ */
+Storage::Storage(const TimeSeriesTable& aTable) :
+    StorageInterface("UNKNOWN"),
+    _storage(StateVector())
+{
+    // SET NULL STATES
+    setNull();
+    _fileVersion = Storage::LatestVersion;
+
+    // HEADER INFORMATION
+    setName(aTable.hasTableMetaDataKey("header") ?
+        aTable.getTableMetaData<std::string>("header") : "UNKNOWN");
+    if(aTable.hasTableMetaDataKey("description"))
+        setDescription(aTable.getTableMetaData<std::string>("description"));
+    if(aTable.hasTableMetaDataKey("inDegrees"))
+        setInDegrees(
+            aTable.getTableMetaData<std::string>("inDegrees") == "yes");
+
+    // COLUMN LABELS
+    const int nc = (int)aTable.getNumColumns();
+    Array<std::string> labels("", 0, nc+1);
+    labels.append("time");
+    if(aTable.hasColumnLabels()) {
+        for(const auto& label : aTable.getColumnLabels())
+            labels.append(label);
+    } else {
+        for(int j=0;j<nc;j++) labels.append("state_" + std::to_string(j));
+    }
+    setColumnLabels(labels);
+
+    // DATA
+    const int nr = (int)aTable.getNumRows();
+    const auto& times = aTable.getIndependentColumn();
+    const SimTK::Matrix& matrix = aTable.getMatrix();
+    _storage.setCapacityIncrement(-1);
+    _storage.setSize(nr);
+    for(int i=0;i<nr;i++) {
+        StateVector& vec = _storage[i];
+        vec.setTime(times[i]);
+        Array<double>& data = vec.getData();
+        data.setSize(nc);
+        for(int j=0;j<nc;j++) data[j] = matrix(i,j);
+    }
+}
+//_____________________________________________________________________________
 /**
  * Construct a copy of a specified storage taking only a subset of the states.
  *
@@ -310,7 +589,6 @@ setNull()
     _writeSIMMHeader = false;
     setHeaderToken(DEFAULT_HEADER_TOKEN);
     _stepInterval = 1;
-    _lastI = 0;
     _fp = 0;
     _inDegrees = false;
 }
@@ -984,9 +1262,27 @@ getData(int aTimeIndex,int aN,SimTK::Vector& v) const
 int Storage::
 getDataAtTime(double aT,int aN,double **rData) const
 {
-
-    // FIND THE CORRECT INTERVAL FOR aT
-    int i = findIndex(_lastI,aT);
+    return interpolateData(findIndex(aT),aT,aN,rData);
+}
+//_____________________________________________________________________________
+/**
+ * Linearly interpolate the first aN states at time aT between the
+ * statevector at index aI and the one following it.
+ *
+ * @param aI Index of the storage element preceding or at time aT, as
+ * returned by findIndex().
+ * @param aT Time at which to get the states.
+ * @param aN Number of states to get.
+ * @param rData Pointer to an array where the returned data will be set.  The
+ * size of *rData is assumed to be at least aN.  If rData comes in as NULL,
+ * memory is allocated.
+ * @return Number of states that were set.
+ */
+int Storage::
+interpolateData(int aI,double aT,int aN,double **rData) const
+{
+    // CHECK THE INTERVAL FOR aT
+    int i = aI;
     if((i<0)||(_storage.getSize()<=0)) {
         *rData = NULL;
         return(0);
@@ -1080,6 +1376,37 @@ getDataAtTime(double aT,int aN,SimTK::Vector& v) const
     return r;
 }
 //_____________________________________________________________________________
+/**
+ * Get the first aN states at a specified time, starting the search for the
+ * enclosing interval from a caller-owned cursor, which is then advanced to
+ * that interval. Lookups at nearby times, as when stepping forward or
+ * backward through the data, are then O(1), and readers that each use
+ * their own cursor can share the same Storage.
+ *
+ * @param aT Time at which to get the states.
+ * @param aN Number of states to get.
+ * @param rData Array where the returned data will be set.  The
+ * size of rData is assumed to be at least aN.
+ * @param rCursor Cursor from a previous lookup in this storage.
+ * @return Number of states that were set.
+ */
+int Storage::
+getDataAtTime(double aT,int aN,double *rData,Cursor& rCursor) const
+{
+    if(rData==NULL) return(0);
+    return interpolateData(findIndex(aT,rCursor),aT,aN,&rData);
+}
+int Storage::
+getDataAtTime(double aT,int aN,SimTK::Vector& v,Cursor& rCursor) const
+{
+    Array<double> rData;
+    rData.setSize(aN);
+    int r = getDataAtTime(aT,aN,&rData[0],rCursor);
+    for (int i=0; i<r; ++i)
+        v[i] = rData[i];
+    return r;
+}
+//_____________________________________________________________________________
 /**
  * Get the data corresponding to a specified state.  This call is equivalent
  * to getting a column of data from the storage file.
@@ -1180,6 +1507,49 @@ setDataColumn(int aStateIndex,const Array<double> &aData)
         vec->setDataValue(aStateIndex,aData[i]);
     }
 }
+//_____________________________________________________________________________
+/**
+ * Copy the first aN states of every statevector into one contiguous block
+ * in column-major order, so that column j occupies the getSize() values
+ * starting at rBlock[j*getSize()]. The statevectors are visited once, which
+ * is much cheaper than extracting the columns one at a time when operating
+ * on all of them.
+ *
+ * @param aN Number of states (columns) to copy. It must not exceed
+ * getSmallestNumberOfStates().
+ * @param rBlock Resized to hold getSize()*aN values.
+ */
+void Storage::
+getDataBlock(int aN,std::vector<double>& rBlock) const
+{
+    int n = _storage.getSize();
+    rBlock.resize((size_t)n*aN);
+    for(int i=0;i<n;i++) {
+        const Array<double> &y = _storage[i].getData();
+        for(int j=0;j<aN;j++) rBlock[(size_t)j*n+i] = y[j];
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Set the first aN states of every statevector from a contiguous block in
+ * column-major order, as returned by getDataBlock().
+ *
+ * @param aN Number of states (columns) to set.
+ * @param aBlock Block of getSize()*aN values.
+ */
+void Storage::
+setDataBlock(int aN,const std::vector<double>& aBlock)
+{
+    int n = _storage.getSize();
+    if(aBlock.size()!=(size_t)n*aN) {
+        cout<<"Storage.setDataBlock: ERR- sizes don't match." << endl;
+        return;
+    }
+    for(int i=0;i<n;i++) {
+        Array<double> &y = _storage[i].getData();
+        for(int j=0;j<aN;j++) y[j] = aBlock[(size_t)j*n+i];
+    }
+}
 /**
  * set values in the column specified by columnName to newValue
  */
@@ -1245,10 +1615,21 @@ void Storage::getDataForIdentifier(const std::string& identifier, Array<Array<do
     int off = _columnLabels.getSize()-nd;
 
 
-    for(int i=0; i<found.getSize(); ++i){
-        Array<double> data{};
-        getDataColumn(found[i]-off, data);
-        rData.append(data);
+    // Gather all of the columns in a single pass over the statevectors.
+    int n = _storage.getSize();
+    int nc = found.getSize();
+    int first = rData.getSize();
+    rData.setSize(first+nc);
+    for(int j=0; j<nc; ++j){
+        rData[first+j].setSize(0);
+        rData[first+j].ensureCapacity(n);
+    }
+    for(int i=0; i<n; ++i){
+        const Array<double>& y = _storage[i].getData();
+        for(int j=0; j<nc; ++j){
+            int k = found[j]-off;
+            if(k>=0 && k<y.getSize()) rData[first+j].append(y[k]);
+        }
     }
 }
 /**
@@ -1288,12 +1669,15 @@ TimeSeriesTable Storage::getAsTimeSeriesTable() const {
     table.setColumnLabels(_columnLabels.get() + 1, 
                           _columnLabels.get() + _columnLabels.getSize());
 
+    table.reserve(_storage.getSize());
     for(int i = 0; i < _storage.getSize(); ++i) {
         const auto& row = getStateVector(i)->getData();
         const auto time = getStateVector(i)->getTime();
-        // Exclude the first column. It is 'time'. Time is a separate column in
-        // TimeSeriesTable.
-        table.appendRow(time, row.get(), row.get() + row.getSize());
+        // Append a view of the data of the StateVector, rather than a
+        // temporary copy of it, so that each value is copied once. Time is a
+        // separate column in TimeSeriesTable.
+        const SimTK::RowVector view(row.getSize(), row.get(), true);
+        table.appendRow(time, view);
     }
 
     return table;
@@ -1427,16 +1811,21 @@ append(double aT,int aN,const double *aY,bool aCheckForDuplicateTime)
     if(aY==NULL) return(_storage.getSize());
     if(aN<0) return(_storage.getSize());
 
-    // APPEND
-    StateVector vec(aT, SimTK::Vector_<double>(aN, aY));
-    append(vec,aCheckForDuplicateTime);
+    // APPEND IN PLACE
+    // The data are copied directly into the next element, which reuses the
+    // memory of elements that were allocated ahead of time by the capacity
+    // rather than making temporary copies of the statevector.
     // TODO: use some tolerance when checking for duplicate time?
-    /*
-    if(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==vec.getTime())
-        _storage.getLast() = vec;
-    else
-        _storage.append(vec);
-    */
+    if(!(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==aT)) {
+        if(!_storage.setSize(_storage.getSize()+1)) return(_storage.getSize());
+    }
+    StateVector &vec = _storage.updLast();
+    vec.setStates(aT,aN,aY);
+
+    if (_fp!=0){
+        vec.print(_fp);
+        fflush(_fp);
+    }
     return(_storage.getSize());
 }
 //_____________________________________________________________________________
@@ -1592,34 +1981,17 @@ add(StateVector *aStateVector)
  * Linear interpolation or extrapolation is used to get the values of the
  * states that correspond in time to the states held in this storage
  * instance.
+ * Rows at the same times are combined directly, and aStorage is traversed
+ * once, so storages with the same time column are combined in linear time.
  *
  * @param aStorage Storage to add to this storage.
-s */
+ */
 void Storage::
 add(Storage *aStorage)
 {
     if(aStorage==NULL) return;
 
-    int n,N=0,nN;
-    double t,*Y=NULL;
-    for(int i=0;i<_storage.getSize();i++) {
-
-        // GET INFO ON THIS STORAGE INSTANCE
-        n = getStateVector(i)->getSize();
-        t = getStateVector(i)->getTime();
-
-        // GET DATA FROM ARGUMENT
-        N = aStorage->getDataAtTime(t,N,&Y);
-
-        // SET SIZE TO SMALLER
-        nN = (n<N) ? n : N;
-
-        // ADD
-        _storage[i].add(SimTK::Vector_<double>(nN, Y));
-    }
-
-    // CLEANUP
-    if(Y!=NULL) delete[] Y;
+    combineRows(*this,*aStorage,[](double& y,double x) { y += x; });
 }
 
 //-----------------------------------------------------------------------------
@@ -1674,34 +2046,17 @@ subtract(StateVector *aStateVector)
  * Linear interpolation or extrapolation is used to get the values of the
  * states that correspond in time to the states held in this storage
  * instance.
+ * Rows at the same times are combined directly, and aStorage is traversed
+ * once, so storages with the same time column are combined in linear time.
  *
  * @param aStorage Storage to subtract from this storage.
-s */
+ */
 void Storage::
 subtract(Storage *aStorage)
 {
     if(aStorage==NULL) return;
 
-    int n,N=0,nN;
-    double t,*Y=NULL;
-    for(int i=0;i<_storage.getSize();i++) {
-
-        // GET INFO ON THIS STORAGE INSTANCE
-        n = getStateVector(i)->getSize();
-        t = getStateVector(i)->getTime();
-
-        // GET DATA FROM ARGUMENT
-        N = aStorage->getDataAtTime(t,N,&Y);
-
-        // SET SIZE TO SMALLER
-        nN = (n<N) ? n : N;
-
-        // SUBTRACT
-        _storage[i].subtract(SimTK::Vector_<double>(nN, Y));
-    }
-
-    // CLEANUP
-    if(Y!=NULL) delete[] Y;
+    combineRows(*this,*aStorage,[](double& y,double x) { y -= x; });
 }
 
 //-----------------------------------------------------------------------------
@@ -1757,34 +2112,17 @@ multiply(StateVector *aStateVector)
  * Linear interpolation or extrapolation is used to get the values of the
  * states that correspond in time to the states held in this storage
  * instance.
+ * Rows at the same times are combined directly, and aStorage is traversed
+ * once, so storages with the same time column are combined in linear time.
  *
  * @param aStorage Storage instance by which to multiply.
-s */
+ */
 void Storage::
 multiply(Storage *aStorage)
 {
     if(aStorage==NULL) return;
 
-    int n,N=0,nN;
-    double t,*Y=NULL;
-    for(int i=0;i<_storage.getSize();i++) {
-
-        // GET INFO ON THIS STORAGE INSTANCE
-        n = getStateVector(i)->getSize();
-        t = getStateVector(i)->getTime();
-
-        // GET DATA FROM ARGUMENT
-        N = aStorage->getDataAtTime(t,N,&Y);
-
-        // SET SIZE TO SMALLER
-        nN = (n<N) ? n : N;
-
-        // MULTIPLY
-        _storage[i].multiply(SimTK::Vector_<double>(nN, Y));
-    }
-
-    // CLEANUP
-    if(Y!=NULL) delete[] Y;
+    combineRows(*this,*aStorage,[](double& y,double x) { y *= x; });
 }
 //_____________________________________________________________________________
 /**
@@ -1853,35 +2191,20 @@ divide(StateVector *aStateVector)
  * Linear interpolation or extrapolation is used to get the values of the
  * states that correspond in time to the states held in this storage
  * instance.
+ * Rows at the same times are combined directly, and aStorage is traversed
+ * once, so storages with the same time column are combined in linear time.
  *
  * @param aStorage Storage instance by which to divide.
-s */
+ */
 void Storage::
 divide(Storage *aStorage)
 {
     if(aStorage==NULL) return;
 
-    int i;
-    int n,N=0,nN;
-    double t,*Y=NULL;
-    for(i=0;i<_storage.getSize();i++) {
-
-        // GET INFO ON THIS STORAGE INSTANCE
-        n = getStateVector(i)->getSize();
-        t = getStateVector(i)->getTime();
-
-        // GET DATA FROM ARGUMENT
-        N = aStorage->getDataAtTime(t,N,&Y);
-
-        // SET SIZE TO SMALLER
-        nN = (n<N) ? n : N;
-
-        // DIVIDE
-        _storage[i].divide(SimTK::Vector_<double>(nN, Y));
-    }
-
-    // CLEANUP
-    if(Y!=NULL) delete[] Y;
+    combineRows(*this,*aStorage,[](double& y,double x) {
+        if(x==0.0) y = SimTK::NaN;
+        else y /= x;
+    });
 }
 
 //=============================================================================
@@ -1984,10 +2307,6 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
     if(aI1<0) aI1 = 0;
     if(aI2<0) aI2 = _storage.getSize()-1;
 
-    // WORKING MEMORY
-    double ti,tf;
-    double *yi=NULL,*yf=NULL;
-
     bool functionAllocatedArea = false;
     if(!rArea) {
         rArea = new double [n];
@@ -1998,30 +2317,10 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
     for(int i=0;i<n;i++) rArea[i]=0.0;
 
     // RECORD FIRST STATE
-    if(rStorage) {
-        ti = getStateVector(aI1)->getTime();
-        rStorage->append(ti,n,rArea);
-    }
+    if(rStorage) rStorage->append(getStateVector(aI1)->getTime(),n,rArea);
 
     // INTEGRATE
-    for(int I=aI1;I<aI2;I++) {
-
-        // INITIAL
-        ti = getStateVector(I)->getTime();
-        yi = getStateVector(I)->getData().get();
-
-        // FINAL
-        tf = getStateVector(I+1)->getTime();
-        yf = getStateVector(I+1)->getData().get();
-
-        // AREA
-        for(int i=0;i<n;i++) {
-            rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
-        }
-
-        // APPEND
-        if(rStorage) rStorage->append(tf,n,rArea);
-    }
+    integrateRows(*this,aI1,aI2,n,rArea,rStorage);
 
     // CLEANUP
     if(functionAllocatedArea) delete[] rArea;
@@ -2113,16 +2412,7 @@ integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
         if(rStorage) rStorage->append(tf,n,rArea);
 
         // INTERVALS
-        for(int I=II;I<FF;I++) {
-            ti = getStateVector(I)->getTime();
-            yi = getStateVector(I)->getData().get();
-            tf = getStateVector(I+1)->getTime();
-            yf = getStateVector(I+1)->getData().get();
-            for(int i=0;i<n;i++) {
-                rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
-            }
-            if(rStorage) rStorage->append(tf,n,rArea);
-        }
+        integrateRows(*this,II,FF,n,rArea,rStorage);
 
         // LAST SLICE
         ti = getStateVector(FF)->getTime();
@@ -2268,27 +2558,28 @@ pad(int aPadSize)
     Signal::Pad(aPadSize,paddedTime);
     int newSize = paddedTime.getSize();
 
-    // PAD EACH COLUMN
+    // PAD EACH COLUMN OF A CONTIGUOUS COPY OF THE DATA
     int nc = getSmallestNumberOfStates();
+    std::vector<double> block;
+    getDataBlock(nc,block);
+    std::vector<double> paddedBlock((size_t)newSize*nc);
     Array<double> paddedSignal(0.0,size);
-    StateVector *vecs = new StateVector[newSize];
-    for(int j=0;j<newSize;j++) {
-        vecs[j].getData().setSize(nc);
-        vecs[j].setTime(paddedTime[j]);
-    }
     for(int i=0;i<nc;i++) {
-        getDataColumn(i,paddedSignal);
+        paddedSignal.setSize(size);
+        std::copy(block.begin()+(size_t)i*size,
+                  block.begin()+(size_t)(i+1)*size, &paddedSignal[0]);
         Signal::Pad(aPadSize,paddedSignal);
-        for(int j=0;j<newSize;j++)
-            vecs[j].setDataValue(i,paddedSignal[j]);
+        std::copy(&paddedSignal[0], &paddedSignal[0]+newSize,
+                  paddedBlock.begin()+(size_t)i*newSize);
     }
 
-    // APPEND THE STATEVECTORS
-    _storage.setSize(0);
-    for(int i=0;i<newSize;i++) _storage.append(vecs[i]);
-
-    // CLEANUP
-    delete[] vecs;
+    // REWRITE THE STATEVECTORS IN PLACE
+    _storage.setSize(newSize);
+    std::vector<double> row(nc);
+    for(int j=0;j<newSize;j++) {
+        for(int i=0;i<nc;i++) row[i] = paddedBlock[(size_t)i*newSize+j];
+        _storage[j].setStates(paddedTime[j],nc,row.data());
+    }
 }
 
 //_____________________________________________________________________________
@@ -2318,21 +2609,18 @@ smoothSpline(int aOrder,double aCutoffFrequency)
         return;
     }
 
-    // LOOP OVER COLUMNS
+    // FILTER THE COLUMNS OF A CONTIGUOUS COPY OF THE DATA CONCURRENTLY
     double *times=NULL;
     int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
+    std::vector<double> block;
+    getDataBlock(nc,block);
     getTimeColumn(times,0);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,signal,&filt[0]);
-        setDataColumn(i,filt);
-    }
+    Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,
+        nc,block.data());
+    setDataBlock(nc,block);
 
     // CLEANUP
     delete[] times;
-    delete[] signal;
 }
 
 
@@ -2363,18 +2651,12 @@ lowpassIIR(double aCutoffFrequency)
         return;
     }
 
-    // LOOP OVER COLUMNS
+    // FILTER THE COLUMNS OF A CONTIGUOUS COPY OF THE DATA CONCURRENTLY
     int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::LowpassIIR(dtmin,aCutoffFrequency,size,signal,&filt[0]);
-        setDataColumn(i,filt);
-    }
-
-    // CLEANUP
-    delete[] signal;
+    std::vector<double> block;
+    getDataBlock(nc,block);
+    Signal::LowpassIIR(dtmin,aCutoffFrequency,size,nc,block.data());
+    setDataBlock(nc,block);
 }
 
 
@@ -2405,18 +2687,12 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
         return;
     }
 
-    // LOOP OVER COLUMNS
+    // FILTER THE COLUMNS OF A CONTIGUOUS COPY OF THE DATA CONCURRENTLY
     int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,signal,&filt[0]);
-        setDataColumn(i,filt);
-    }
-
-    // CLEANUP
-    delete[] signal;
+    std::vector<double> block;
+    getDataBlock(nc,block);
+    Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,nc,block.data());
+    setDataBlock(nc,block);
 }
 
 
@@ -2428,10 +2704,9 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
  * Find the index of the storage element that occurred immediately before
  * or at time aT ( aT <= getTime(index) ).
  *
- * This method can be much more efficient than findIndex(aT) if a good guess
- * is made for aI.
- * If aI corresponds to a state which occurred later than aT, an exhaustive
- * search is performed by calling findIndex(aT).
+ * This method can be more efficient than findIndex(aT) if a good guess
+ * is made for aI: the element at aI and the two following it are checked
+ * before falling back to a binary search on the side of aI that contains aT.
  *
  * @param aI Index at which to start searching.
  * @param aT Time.
@@ -2442,27 +2717,26 @@ int Storage::
 findIndex(int aI,double aT) const
 {
     // MAKE SURE aI IS VALID
-    if(_storage.getSize()<=0) return(-1);
-    if((aI>=_storage.getSize())||(aI<0)) aI=0;
-    if(getStateVector(aI)->getTime()>aT) aI=0;
+    int n = _storage.getSize();
+    if(n<=0) return(-1);
+    if((aI>=n)||(aI<0)) aI=0;
 
     // SEARCH
-    //cout << "Storage.findIndex: starting at " << aI << endl;
-    int i;
-    for(i=aI;i<_storage.getSize();i++) {
-        if(aT<getStateVector(i)->getTime()) break;
+    if(_storage[aI].getTime()<=aT) {
+        if((aI+1==n)||(aT<_storage[aI+1].getTime())) return(aI);
+        if((aI+2==n)||(aT<_storage[aI+2].getTime())) return(aI+1);
+        return(findIndexInRange(aI+2,n,aT));
     }
-    _lastI = i-1;
-    if(_lastI<0) _lastI=0;
-    return(_lastI);
+    return(findIndexInRange(0,aI,aT));
 }
 //_____________________________________________________________________________
 /**
  * Find the index of the storage element that occurred immediately before
  * or at a specified time ( getTime(index) <= aT ).
  *
- * This method is not very efficient because it always starts its search
- * with the first stored state.
+ * The search is a binary search over the stored times, which are assumed to
+ * be monotonically increasing. This method does not modify the storage, so
+ * it is safe to call from several threads at once.
  *
  * @param aT Time.
  * @return Index preceding or at time aT.  If aT is less than the earliest
@@ -2472,13 +2746,43 @@ int Storage::
 findIndex(double aT) const
 {
     if(_storage.getSize()<=0) return(-1);
-    int i;
-    for(i=0;i<_storage.getSize();i++) {
-        if(aT<getStateVector(i)->getTime()) break;
+    return(findIndexInRange(0,_storage.getSize(),aT));
+}
+//_____________________________________________________________________________
+/**
+ * Find the index of the storage element that occurred immediately before
+ * or at time aT, starting from a caller-owned cursor. The cursor is updated
+ * to the index found so that the next search at a nearby time is O(1).
+ *
+ * @param aT Time.
+ * @param rCursor Cursor from a previous search in this storage.
+ * @return Index preceding or at time aT.  If aT is less than the earliest
+ * time, 0 is returned.
+ */
+int Storage::
+findIndex(double aT,Cursor& rCursor) const
+{
+    int i = findIndex(rCursor._index,aT);
+    if(i>=0) rCursor._index = i;
+    return(i);
+}
+//_____________________________________________________________________________
+/**
+ * Binary search for the last element in the index range [aLo,aHi) whose
+ * time is less than or equal to aT. The element preceding aLo, if any, must
+ * have a time less than or equal to aT.
+ *
+ * @return Index preceding or at time aT, or 0 if there is none.
+ */
+int Storage::
+findIndexInRange(int aLo,int aHi,double aT) const
+{
+    while(aLo<aHi) {
+        int mid = aLo + (aHi-aLo)/2;
+        if(aT<_storage[mid].getTime()) aHi = mid;
+        else aLo = mid+1;
     }
-    _lastI = i-1;
-    if(_lastI<0) _lastI=0;
-    return(_lastI);
+    return((aLo>0) ? aLo-1 : 0);
 }
 //_____________________________________________________________________________
 /** 
@@ -2564,21 +2868,35 @@ resampleLinear(double aDT)
 
     Storage *newStorage = new Storage(nr);
 
-    // LOOP THROUGH THE DATA
-    int ny=0;
-    double *y=NULL;
-    StateVector vec;
-    for(int i=0; i<nr; i++) {
-        double t = ti+aDT*(double)i;
-        // INTERPOLATE THE STATES
-        ny = getDataAtTime(t,ny,&y);
-        newStorage->append(t,ny,y);
+    // INTERPOLATE THE STATES
+    // Blocks of rows are interpolated on as many threads as ThreadPool
+    // allows, each following the data with its own cursor, and appended in
+    // order.
+    int ny = getSmallestNumberOfStates();
+    const int numBlocks = (nr+ROW_BLOCK_SIZE-1)/ROW_BLOCK_SIZE;
+    const int numThreads = std::min(numBlocks,
+        ThreadPool::getMaxNumThreads());
+    vector<double> rows((size_t)numThreads*ROW_BLOCK_SIZE*ny);
+    for(int first=0;first<numBlocks;first+=numThreads) {
+        int n = std::min(numThreads,numBlocks-first);
+        ThreadPool::parallelFor(n,n,[&](int b) {
+            Cursor cursor;
+            int begin = (first+b)*ROW_BLOCK_SIZE;
+            int end = std::min(nr,begin+ROW_BLOCK_SIZE);
+            double *y = rows.data()+(size_t)b*ROW_BLOCK_SIZE*ny;
+            for(int i=begin;i<end;i++,y+=ny)
+                getDataAtTime(ti+aDT*(double)i,ny,y,cursor);
+        });
+
+        int end = std::min(nr,(first+n)*ROW_BLOCK_SIZE);
+        const double *y = rows.data();
+        for(int i=first*ROW_BLOCK_SIZE;i<end;i++,y+=ny)
+            newStorage->append(ti+aDT*(double)i,ny,y);
     }
 
     copyData(*newStorage);
 
     delete newStorage;
-    delete[] y;
 
     return aDT;
 }
@@ -2665,7 +2983,7 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
     if(fp==NULL) return(false);
 
     // WRITE THE HEADER
-    int n=0,nTotal=0;
+    int n=0;
     n = writeHeader(fp);
     if(n<0) {
         cout << "Storage.print(const string&,const string&): failed to" << endl
@@ -2703,19 +3021,25 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
 //std::cout << aFileName << endl;
 
     // VECTORS
-    for(int i=0;i<_storage.getSize();i++) {
-        n = getStateVector(i)->print(fp);
-        if(n<0) {
-            cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
-            return(false);
-        }
-        nTotal += n;        
+    const char *format = IO::GetDoubleOutputFormat();
+    long long nRows = printRows(fp,_storage.getSize(),
+        [&](int begin,int end,string& rOut) {
+            for(int i=begin;i<end;i++) {
+                const StateVector& vec = _storage[i];
+                appendRow(rOut,format,vec.getTime(),
+                    vec.getData().get(),vec.getSize());
+            }
+        });
+    if(nRows<0) {
+        cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
+        fclose(fp);
+        return(false);
     }
 
     // CLOSE
     fclose(fp);
 
-    return(nTotal!=0);
+    return(nRows!=0);
 }
 //_____________________________________________________________________________
 /**
@@ -2750,7 +3074,7 @@ print(const string &aFileName,double aDT,const string &aMode) const
 //std::cout << aFileName << endl;
 
     // WRITE THE HEADER
-    int n,nTotal=0;
+    int n;
     n = writeHeader(fp,aDT);
     if(n<0) {
         cout << "Storage.print(const string&,const string&,double): failed to" << endl
@@ -2784,30 +3108,34 @@ print(const string &aFileName,double aDT,const string &aMode) const
         return(n);
     }
 
-    // LOOP THROUGH THE DATA
-    int i,ny=0;
-    double t,*y=NULL;
-    StateVector vec;
-    for(t=ti,i=0;i<nr;i++,t=ti+aDT*(double)i) {
-
-        // INTERPOLATE THE STATES
-        ny = getDataAtTime(t,ny,&y);
-        vec.setStates(t, SimTK::Vector_<double>(ny, y));
+    // NUMBER OF STATES, AS INTERPOLATED AT THE FIRST TIME
+    double *y=NULL;
+    int ny = (nr>0) ? getDataAtTime(ti,0,&y) : 0;
+    if(y!=NULL) { delete[] y;  y=NULL; }
 
-        // PRINT
-        n = vec.print(fp);
-        if(n<0) {
-            cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
-            return(n);
-        }
-        nTotal += n;        
+    // LOOP THROUGH THE DATA
+    // Each block of rows interpolates with its own cursor and buffer.
+    const char *format = IO::GetDoubleOutputFormat();
+    long long nRows = printRows(fp,nr,
+        [&](int begin,int end,string& rOut) {
+            Cursor cursor;
+            vector<double> data(std::max(ny,1));
+            for(int i=begin;i<end;i++) {
+                double t = ti+aDT*(double)i;
+                int n = getDataAtTime(t,ny,data.data(),cursor);
+                appendRow(rOut,format,t,data.data(),n);
+            }
+        });
+    if(nRows<0) {
+        cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
+        fclose(fp);
+        return(-1);
     }
 
     // CLEANUP
     fclose(fp);
-    if(y!=NULL) { delete[] y;  y=NULL; }
 
-    return(nTotal);
+    return (int)std::min<long long>(nRows,INT_MAX);
 }
 
 void Storage::
@@ -31,6 +31,7 @@
 #include "Units.h"
 #include "StorageInterface.h"
 #include "TimeSeriesTable.h"
+#include "FileAdapter.h"
 
 const int Storage_DEFAULT_CAPACITY = 256;
 //=============================================================================
@@ -58,6 +59,11 @@ typedef std::map<std::string, std::string, std::less<std::string> > MapKeysToVal
  * TimeIndex, and a particular state (or column) is indexed by the
  * StateIndex.
  *
+ * Searches by time are binary searches and do not modify the storage, so a
+ * const Storage may be read from several threads at once. Callers that make
+ * many lookups at nearby times can keep a Storage::Cursor to make each
+ * lookup O(1).
+ *
  * @version 1.0
  * @author Frank C. Anderson
  */
@@ -85,8 +91,6 @@ protected:
     /** Step interval at which states in a simulation are stored. See
     store(). */
     int _stepInterval;
-    /** Last index at which a search was started. */
-    mutable int _lastI;
     /** Flag for whether or not to insert a SIMM style header. */
     bool _writeSIMMHeader;
     /** Units in which the data is represented. */
@@ -109,13 +113,47 @@ protected:
 // METHODS
 //=============================================================================
 public:
+#ifndef SWIG
+    /** Caller-owned position of the last row found by a search by time.
+    Passing the same cursor to successive searches makes lookups at nearby
+    times O(1), in either direction, without modifying the Storage. Each
+    reader should use its own cursor. */
+    class Cursor {
+    public:
+        Cursor() : _index(0) {}
+        /** Index of the row found by the last search. */
+        int getIndex() const { return _index; }
+        void reset() { _index = 0; }
+    private:
+        friend class Storage;
+        int _index;
+    };
+#endif
+
     // make this constructor explicit so you don't get implicit casting of int to Storage
     explicit Storage(int aCapacity=Storage_DEFAULT_CAPACITY,
         const std::string &aName="UNKNOWN");
     Storage(const std::string &aFileName, bool readHeadersOnly=false) SWIG_DECLARE_EXCEPTION;
+#ifndef SWIG
+    /** Construct a Storage from the selected columns of a file (see
+    ColumnSelection), keeping the time column. The values of the other
+    columns are skipped as the file is read and are not stored. The file must
+    have a time column.                                                       */
+    Storage(const std::string &aFileName,const ColumnSelection& aSelection);
+    /** Construct a Storage from the rows of a file with times in [aStartTime,
+    aEndTime], and only the selected columns (all by default). Rows before the
+    range are not stored and reading stops at the first row after it.         */
+    Storage(const std::string &aFileName,double aStartTime,double aEndTime,
+        const ColumnSelection& aSelection=ColumnSelection{});
+#endif
     Storage(const Storage &aStorage,bool aCopyData=true);
     Storage(const Storage &aStorage,int aStateIndex,int aN,
         const char *aDelimiter="\t");
+    /** Construct a Storage holding the rows of a TimeSeriesTable, with its
+    column labels (preceded by "time") and its "header", "description" and
+    "inDegrees" metadata. Each value is copied once. This is the inverse of
+    getAsTimeSeriesTable().                                                   */
+    explicit Storage(const TimeSeriesTable& aTable);
     virtual ~Storage();
 
 #ifndef SWIG
@@ -141,6 +179,9 @@ private:
     void copyData(const Storage &aStorage);
     void parseColumnLabels(const char *aLabels);
     bool parseHeaders(std::ifstream& aStream, int& rNumRows, int& rNumColumns);
+    void readFile(const std::string& aFileName,bool aReadHeadersOnly,
+        const ColumnSelection& aSelection,
+        double aStartTime=-SimTK::Infinity,double aEndTime=SimTK::Infinity);
     bool isSimmReservedToken(const std::string& aToken);
     void postProcessSIMMMotion();
     void exchangeTimeColumnWith(int aColumnIndex);
@@ -183,6 +224,10 @@ public:
     int getDataAtTime(double aTime,int aN,double *rData) const;
     int getDataAtTime(double aTime,int aN,Array<double> &rData) const override;
     int getDataAtTime(double aTime,int aN,SimTK::Vector& v) const;
+#ifndef SWIG
+    int getDataAtTime(double aTime,int aN,double *rData,Cursor& rCursor) const;
+    int getDataAtTime(double aTime,int aN,SimTK::Vector& v,Cursor& rCursor) const;
+#endif
     int getDataColumn(int aStateIndex,double *&rData) const;
     int getDataColumn(int aStateIndex,Array<double> &rData) const;
     // Set entries in a column of the storage to a fixed value, 
@@ -190,8 +235,13 @@ public:
     void setDataColumn(int aStateIndex,const Array<double> &aData);
     int getDataColumn(const std::string& columnName,double *&rData) const;
     void getDataColumn(const std::string& columnName, Array<double>& data, double startTime=0.0) override;
+#ifndef SWIG
+    void getDataBlock(int aN,std::vector<double>& rBlock) const;
+    void setDataBlock(int aN,const std::vector<double>& aBlock);
+#endif
 
-    /** Get a TimeSeriesTable out of the Storage.                             */
+    /** Get a TimeSeriesTable out of the Storage, with its column labels and
+    header information as table metadata. Each value is copied once.          */
     TimeSeriesTable getAsTimeSeriesTable() const;
 
 #ifndef SWIG
@@ -293,6 +343,9 @@ public:
     //--------------------------------------------------------------------------
     int findIndex(double aT) const override;
     int findIndex(int aI,double aT) const override;
+#ifndef SWIG
+    int findIndex(double aT,Cursor& rCursor) const;
+#endif
     void findFrameRange(double aStartTime, double aEndTime, int& oStartFrame, int& oEndFrame) const;
     double resample(double aDT, int aDegree);
     double resampleLinear(double aDT);
@@ -330,6 +383,8 @@ private:
     int writeColumnLabels(FILE *rFP) const;
     int integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const;
     int integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const;
+    int interpolateData(int aI,double aT,int aN,double **rData) const;
+    int findIndexInRange(int aLo,int aHi,double aT) const;
 
 //=============================================================================
 };  // END of class Storage
@@ -0,0 +1,161 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  StreamingSavitzkyGolayFilter.cpp                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "StreamingSavitzkyGolayFilter.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+using namespace OpenSim;
+
+namespace {
+// Solve A*X = B in place (B becomes X) by Gaussian elimination with partial
+// pivoting; A is small and well conditioned.
+void solveInPlace(SimTK::Matrix A, SimTK::Matrix& B) {
+    const int n = A.nrow();
+    for (int k = 0; k < n; ++k) {
+        int pivot = k;
+        for (int i = k + 1; i < n; ++i)
+            if (std::abs(A(i, k)) > std::abs(A(pivot, k))) pivot = i;
+        if (pivot != k) {
+            for (int j = 0; j < n; ++j) std::swap(A(k, j), A(pivot, j));
+            for (int j = 0; j < B.ncol(); ++j) std::swap(B(k, j), B(pivot, j));
+        }
+        for (int i = k + 1; i < n; ++i) {
+            const double f = A(i, k)/A(k, k);
+            for (int j = k; j < n; ++j) A(i, j) -= f*A(k, j);
+            for (int j = 0; j < B.ncol(); ++j) B(i, j) -= f*B(k, j);
+        }
+    }
+    for (int k = n - 1; k >= 0; --k) {
+        for (int j = 0; j < B.ncol(); ++j) {
+            double b = B(k, j);
+            for (int i = k + 1; i < n; ++i) b -= A(k, i)*B(i, j);
+            B(k, j) = b/A(k, k);
+        }
+    }
+}
+}
+
+StreamingSavitzkyGolayFilter::StreamingSavitzkyGolayFilter(int numSignals,
+        double sampleInterval, int windowSize, int polynomialOrder, int lag) :
+    _numSignals(numSignals), _sampleInterval(sampleInterval),
+    _windowSize(windowSize), _polynomialOrder(polynomialOrder), _lag(lag),
+    _newest(-1), _numSamples(0), _newestTime(SimTK::NaN) {
+    OPENSIM_THROW_IF(numSignals < 0, Exception,
+            "Expected a nonnegative number of signals, but got " +
+            std::to_string(numSignals) + ".");
+    OPENSIM_THROW_IF(!(sampleInterval > 0), Exception,
+            "Expected a positive sample interval, but got " +
+            std::to_string(sampleInterval) + ".");
+    OPENSIM_THROW_IF(polynomialOrder < 0 || polynomialOrder >= windowSize,
+            Exception,
+            "Expected a polynomial order from 0 to the window size minus 1 (" +
+            std::to_string(windowSize - 1) + "), but got " +
+            std::to_string(polynomialOrder) + ".");
+    OPENSIM_THROW_IF(lag < 0 || lag >= windowSize, Exception,
+            "Expected a lag from 0 to the window size minus 1 (" +
+            std::to_string(windowSize - 1) + "), but got " +
+            std::to_string(lag) + ".");
+
+    // The least-squares fit of the coefficients c of the polynomial to the
+    // samples y of the window, c = (V^T*V)^-1*V^T*y, where V holds the powers
+    // of the positions of the samples, in samples from the newest.
+    const int n = polynomialOrder + 1;
+    SimTK::Matrix V(windowSize, n);
+    for (int j = 0; j < windowSize; ++j) {
+        const double x = j - (windowSize - 1);
+        double power = 1;
+        for (int k = 0; k < n; ++k, power *= x) V(j, k) = power;
+    }
+    SimTK::Matrix fit = ~V;
+    solveInPlace(~V*V, fit);
+
+    // The polynomial and its derivatives at the output, lag samples before
+    // the newest, scaled from samples to seconds.
+    _weights.resize(3, windowSize);
+    _weights.setToZero();
+    const double x0 = -lag;
+    for (int d = 0; d < 3; ++d) {
+        const double scale = std::pow(sampleInterval, -d);
+        for (int k = d; k < n; ++k) {
+            double factor = scale*std::pow(x0, k - d);
+            for (int m = k; m > k - d; --m) factor *= m;
+            for (int j = 0; j < windowSize; ++j)
+                _weights(d, j) += factor*fit(k, j);
+        }
+    }
+
+    _samples.resize(numSignals, windowSize);
+}
+
+void StreamingSavitzkyGolayFilter::putSample(double time,
+        const SimTK::Vector& values) {
+    OPENSIM_THROW_IF(values.size() != _numSignals, Exception,
+            "Expected " + std::to_string(_numSignals) + " values, but got " +
+            std::to_string(values.size()) + ".");
+    if (_numSamples > 0) {
+        OPENSIM_THROW_IF(!(time > _newestTime), Exception,
+                "Expected the time of the sample to be later than " +
+                std::to_string(_newestTime) + ", but got " +
+                std::to_string(time) + ".");
+        if (std::abs(time - _newestTime - _sampleInterval) >
+                0.5*_sampleInterval)
+            _numSamples = 0;
+    }
+    _newest = (_newest + 1) % _windowSize;
+    _samples(_newest) = values;
+    _newestTime = time;
+    _numSamples = std::min(_numSamples + 1, _windowSize);
+}
+
+void StreamingSavitzkyGolayFilter::reset() {
+    _newest = -1;
+    _numSamples = 0;
+    _newestTime = SimTK::NaN;
+}
+
+double StreamingSavitzkyGolayFilter::getOutputTime() const {
+    return _newestTime - getLatency();
+}
+
+void StreamingSavitzkyGolayFilter::calcOutput(int derivativeOrder,
+        SimTK::Vector& output) const {
+    OPENSIM_THROW_IF(derivativeOrder < 0 || derivativeOrder > 2, Exception,
+            "Expected a derivative order from 0 to 2, but got " +
+            std::to_string(derivativeOrder) + ".");
+    OPENSIM_THROW_IF(!isReady(), Exception,
+            "The window of samples is not full.");
+    output.resize(_numSignals);
+    output.setToZero();
+    // The oldest sample follows the newest in the ring.
+    for (int j = 0; j < _windowSize; ++j) {
+        const double w = _weights(derivativeOrder, j);
+        if (w == 0) continue;
+        const int c = (_newest + 1 + j) % _windowSize;
+        for (int i = 0; i < _numSignals; ++i) output[i] += w*_samples(i, c);
+    }
+}
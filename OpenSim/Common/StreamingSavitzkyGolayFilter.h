@@ -0,0 +1,112 @@
+#ifndef OPENSIM_STREAMING_SAVITZKY_GOLAY_FILTER_H_
+#define OPENSIM_STREAMING_SAVITZKY_GOLAY_FILTER_H_
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  StreamingSavitzkyGolayFilter.h                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "osimCommonDLL.h"
+#include "SimTKcommon/SmallMatrix.h"
+#include "SimTKcommon/internal/BigMatrix.h"
+
+namespace OpenSim {
+
+/** Smooth and differentiate signals sampled at a fixed interval as the
+samples arrive, e.g., for online use, where the filters of Signal, which need
+the whole signal, cannot be used.
+
+Each time a sample is added, a polynomial of the given order is fit, by least
+squares, to the last windowSize samples of each signal, and evaluated, with
+its first and second derivatives, lag samples before the newest sample. The
+output thus lags the input by a fixed latency of lag sample intervals: with
+no lag, the filter is causal; with a lag of (windowSize - 1)/2, it is the
+usual centered Savitzky-Golay filter, which smooths and differentiates best.
+The fit is a fixed weighted sum of the samples in the window, whose weights
+are computed once, so each output costs windowSize multiplications per
+signal.
+
+Samples must be added in order of time, one sample interval apart. A sample
+that comes more than half an interval early or late (e.g., after frames were
+dropped) starts a new window, and the filter has no output until the window
+is full again.
+
+@code
+StreamingSavitzkyGolayFilter filter(nq, 0.01, 9, 3, 2);
+filter.putSample(time, q);
+if (filter.isReady()) {
+    filter.calcOutput(1, qdot); // at filter.getOutputTime()
+}
+@endcode
+
+A filter is not thread-safe. */
+class OSIMCOMMON_API StreamingSavitzkyGolayFilter {
+public:
+    /** Filter numSignals signals sampled every sampleInterval seconds.
+    @throws Exception unless 0 <= polynomialOrder < windowSize and
+    0 <= lag < windowSize. */
+    StreamingSavitzkyGolayFilter(int numSignals, double sampleInterval,
+            int windowSize = 9, int polynomialOrder = 3, int lag = 2);
+
+    int getNumSignals() const { return _numSignals; }
+    double getSampleInterval() const { return _sampleInterval; }
+    int getWindowSize() const { return _windowSize; }
+    int getPolynomialOrder() const { return _polynomialOrder; }
+    int getLag() const { return _lag; }
+    /** The delay (in seconds) of the output behind the newest sample. */
+    double getLatency() const { return _lag*_sampleInterval; }
+
+    /** Add the sample of all signals at the given time. */
+    void putSample(double time, const SimTK::Vector& values);
+    /** Forget all samples. */
+    void reset();
+
+    /** Whether the window is full, so that there is an output. */
+    bool isReady() const { return _numSamples == _windowSize; }
+    /** The time of the output: that of the newest sample minus the
+    latency. */
+    double getOutputTime() const;
+    /** The smoothed signals (derivativeOrder 0), or their first or second
+    derivatives with respect to time, at the output time.
+    @throws Exception if the filter is not ready. */
+    void calcOutput(int derivativeOrder, SimTK::Vector& output) const;
+
+private:
+    int _numSignals;
+    double _sampleInterval;
+    int _windowSize;
+    int _polynomialOrder;
+    int _lag;
+
+    // The weights of the samples for each derivative order (row), from the
+    // oldest sample of the window to the newest (column).
+    SimTK::Matrix _weights;
+
+    // The ring of the samples of the window, one column per sample;
+    // _newest is the column of the newest of _numSamples samples.
+    SimTK::Matrix _samples;
+    int _newest;
+    int _numSamples;
+    double _newestTime;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_STREAMING_SAVITZKY_GOLAY_FILTER_H_
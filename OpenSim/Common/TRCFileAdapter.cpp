@@ -1,4 +1,5 @@
 #include "TRCFileAdapter.h"
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 
@@ -30,6 +31,26 @@ TRCFileAdapter::read(const std::string& fileName) {
     return static_cast<TimeSeriesTableVec3&>(*abs_table);
 }
 
+TimeSeriesTableVec3
+TRCFileAdapter::readColumns(const std::string& fileName,
+                            const ColumnSelection& selection) {
+    auto abs_table = TRCFileAdapter{}.
+                     extendReadColumns(fileName, selection).
+                     at(_markers);
+    return static_cast<TimeSeriesTableVec3&>(*abs_table);
+}
+
+TimeSeriesTableVec3
+TRCFileAdapter::readTimeRange(const std::string& fileName,
+                              double startTime, double endTime,
+                              const ColumnSelection& selection) {
+    auto abs_table = TRCFileAdapter{}.
+                     extendReadColumns(fileName, selection,
+                                       startTime, endTime).
+                     at(_markers);
+    return static_cast<TimeSeriesTableVec3&>(*abs_table);
+}
+
 void 
 TRCFileAdapter::write(const TimeSeriesTableVec3& table, 
                       const std::string& fileName) {
@@ -40,6 +61,14 @@ TRCFileAdapter::write(const TimeSeriesTableVec3& table,
 
 TRCFileAdapter::OutputTables
 TRCFileAdapter::extendRead(const std::string& fileName) const {
+    return extendReadColumns(fileName, ColumnSelection{});
+}
+
+TRCFileAdapter::OutputTables
+TRCFileAdapter::extendReadColumns(const std::string& fileName,
+                                  const ColumnSelection& selection,
+                                  double startTime,
+                                  double endTime) const {
     OPENSIM_THROW_IF(fileName.empty(),
                      EmptyFileName);
 
@@ -145,39 +174,82 @@ TRCFileAdapter::extendRead(const std::string& fileName) const {
         }
     }
 
+    // Indices of the markers to read; the others are skipped.
+    const auto columns = selection.findColumns(column_labels);
+    if(!selection.selectsAll()) {
+        table->updTableMetaData().removeValueForKey(_numMarkersLabel);
+        table->updTableMetaData().setValueForKey(_numMarkersLabel,
+                                               std::to_string(columns.size()));
+    }
+
     // Read the rows one at a time and fill up the time column container and
-    // the data container.
+    // the data container. The numbers are parsed straight out of the line
+    // and the buffers are reused from one row to the next.
     std::size_t line_num{_dataStartsAtLine - 1};
-    auto row = nextLine();
-    while(!row.empty()) {
+    const size_t expected{column_labels.size() * 3 + 2};
+    // The header tells how many frames to expect, but it is not trusted
+    // beyond reserving memory for them, and only if all of them are read.
+    const bool all_times{startTime == -SimTK::Infinity &&
+                         endTime == SimTK::Infinity};
+    if(all_times) {
+        try {
+            table->reserve(std::stoul(table->
+                                      getTableMetaData().
+                                      getValueForKey(_numFramesLabel).
+                                      template getValue<std::string>()));
+        } catch(const std::exception&) {
+            // No usable frame count. Rows are appended without reserving.
+        }
+    }
+    std::string line{};
+    std::vector<double> data{};
+    std::vector<unsigned> num_comps{};
+    TimeSeriesTableVec3::RowVector 
+        row_vector{static_cast<int>(columns.size())};
+    while(getNextLine(in_stream, _delimitersRead, line)) {
         ++line_num;
-        size_t expected{column_labels.size() * 3 + 2};
-        OPENSIM_THROW_IF(row.size() != expected,
+        // Frames are in increasing time. Look at the time (column 1) alone
+        // to skip the frames before the range and to stop after it.
+        if(!all_times) {
+            char* end{};
+            std::strtod(line.c_str(), &end);
+            const double time{std::strtod(end, nullptr)};
+            if(time < startTime)
+                continue;
+            if(time > endTime)
+                break;
+        }
+        parseNumbers(line, _delimitersRead, "", data, num_comps);
+        if(data.empty())
+            continue;
+        OPENSIM_THROW_IF(data.size() != expected,
                          RowLengthMismatch,
                          fileName,
                          line_num,
                          expected,
-                         row.size());
+                         data.size());
 
         // Columns 2 till the end are data.
-        TimeSeriesTableVec3::RowVector 
-            row_vector{static_cast<int>(num_markers_expected)};
-        int ind{0};
-        for(std::size_t c = 2; c < column_labels.size() * 3 + 2; c += 3)
-            row_vector[ind++] = SimTK::Vec3{std::stod(row.at(c)),
-                                            std::stod(row.at(c+1)),
-                                            std::stod(row.at(c+2))};
+        for(int ind = 0; ind < row_vector.size(); ++ind) {
+            const double* xyz = data.data() + 2 + 3 * columns[ind];
+            row_vector[ind] = SimTK::Vec3{xyz[0], xyz[1], xyz[2]};
+        }
 
         // Column 1 is time.
-        table->appendRow(std::stod(row.at(1)), std::move(row_vector));
-
-        row = nextLine();
+        table->appendRow(data[1], row_vector);
+    }
+    table->shrinkToFit();
+    if(!all_times) {
+        table->updTableMetaData().removeValueForKey(_numFramesLabel);
+        table->updTableMetaData().setValueForKey(_numFramesLabel,
+                                        std::to_string(table->getNumRows()));
     }
 
     // Set the column labels of the table.
     ValueArray<std::string> value_array{};
-    for(const auto& cl : column_labels)
-        value_array.upd().push_back(SimTK::Value<std::string>{cl});
+    for(auto c : columns)
+        value_array.upd().push_back(SimTK::Value<std::string>{
+                column_labels[c]});
     TimeSeriesTableVec3::DependentsMetaData dep_metadata{};
     dep_metadata.setValueArrayForKey("labels", value_array);
     table->setDependentsMetaData(dep_metadata);
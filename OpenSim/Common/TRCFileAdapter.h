@@ -123,6 +123,26 @@ public:
     static
     TimeSeriesTableVec3 read(const std::string& filename);
 
+    /** Read only the selected markers of a given TRC file: the markers with
+    the given names (in the given order), or the markers whose names match a
+    regular expression (see ColumnSelection). The metadata "NumMarkers" of the
+    table returned is the number of markers read.
+
+    \throws KeyNotFound If the file has no marker with one of the names.    */
+    static
+    TimeSeriesTableVec3 readColumns(const std::string& filename,
+                                    const ColumnSelection& selection);
+
+    /** Read the frames of a given TRC file with times in [startTime,
+    endTime], and only the selected markers (all by default). Frames before
+    the range are skipped without being parsed and reading stops after the
+    range. The metadata "NumFrames" of the table returned is the number of
+    frames read.                                                              */
+    static
+    TimeSeriesTableVec3 readTimeRange(const std::string& filename,
+                                      double startTime, double endTime,
+                           const ColumnSelection& selection = ColumnSelection{});
+
     /** Write a table to a TRC file. The filename provided need not contain 
     ".trc".                                                                   */
     static
@@ -135,6 +155,13 @@ protected:
     /** Implementation of the read functionality.                             */
     OutputTables extendRead(const std::string& filename) const override;
 
+    /** Read the selected markers of the frames with times in [startTime,
+    endTime] from the file.                                                   */
+    OutputTables extendReadColumns(const std::string& filename,
+                                   const ColumnSelection& selection,
+                                   double startTime = -SimTK::Infinity,
+                                   double endTime = SimTK::Infinity) const;
+
     /** Implementation of the write functionality.                            */
     void extendWrite(const InputTables& tables, 
                      const std::string& filename) const override;
@@ -0,0 +1,171 @@
+#ifndef OPENSIM_TABLE_FILE_REPORTER_H_
+#define OPENSIM_TABLE_FILE_REPORTER_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  TableFileReporter.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Reporter.h"
+#include "BackgroundFileWriter.h"
+#include "STOFileAdapter.h"
+
+namespace OpenSim {
+
+/** A reporter that writes the reported values to an STO file as the
+simulation runs, instead of keeping them in memory like TableReporter_.
+
+The rows are collected in chunks of rows_per_chunk rows; each full chunk is
+formatted and written to the file on a separate thread (see
+BackgroundFileWriter) while the simulation continues. The memory used is
+therefore bounded by a few chunks, however long the simulation is. The file
+has the same contents as writing the table of a TableReporter_ with
+STOFileAdapter_.
+
+The file is created by the first report. It is complete after closeFile() is
+called or the reporter is destroyed; the next report after closeFile()
+creates the file again. Call closeFile() between simulations run in a loop,
+and use a different file_name for each if all of them are to be kept.
+@ingroup reporters */
+template<typename InputT = SimTK::Real, typename ValueT = InputT>
+class TableFileReporter_ : public Reporter<InputT> {
+    OpenSim_DECLARE_CONCRETE_OBJECT_T(TableFileReporter_, InputT,
+                                      Reporter<InputT>);
+public:
+    OpenSim_DECLARE_PROPERTY(file_name, std::string,
+        "Name of the STO file the reported values are written to.");
+    OpenSim_DECLARE_PROPERTY(rows_per_chunk, int,
+        "Number of rows written to the file at a time (default: 256).");
+
+    TableFileReporter_() { constructProperties(); }
+
+    /** Write the remaining rows and close the file, ignoring any errors. */
+    virtual ~TableFileReporter_() {
+        try { closeFile(); }
+        catch (const std::exception&) {}
+    }
+
+    /** Write the rows not yet written and close the file. This waits for the
+    file to be written and rethrows the error, if any, that occurred while
+    writing it. Nothing is done if the file is not open.                     */
+    void closeFile() {
+        if (!_writer) return;
+        writeChunk();
+        std::unique_ptr<BackgroundFileWriter> writer(_writer.release());
+        writer->close();
+    }
+
+    /** Whether a file is being written (i.e., values were reported since it
+    was last closed).                                                         */
+    bool isFileOpen() const { return (bool)_writer; }
+
+protected:
+    void implementReport(const SimTK::State& state) const override {
+        const auto& input = this->template getInput<InputT>("inputs");
+        SimTK::RowVector_<ValueT> result(int(input.getNumConnectees()));
+
+        for (auto idx = 0u; idx < input.getNumConnectees(); ++idx)
+            result[idx] = input.getChannel(idx).getValue(state);
+
+        Self* self = const_cast<Self*>(this);
+        if (!_writer) {
+            OPENSIM_THROW_IF_FRMOBJ(get_file_name().empty(), Exception,
+                                    "Property file_name is empty.");
+            self->_writer.reset(new BackgroundFileWriter(get_file_name()));
+            self->_headerWritten = false;
+        } else {
+            OPENSIM_THROW_IF_FRMOBJ(state.getTime() < _lastTime, Exception,
+                "Attempting to report a time earlier than the last time "
+                "reported. Hint: If running simulation in a loop, use "
+                "closeFile() between simulations.");
+        }
+        self->_chunk.appendRow(state.getTime(), result);
+        self->_lastTime = state.getTime();
+        if ((int)_chunk.getNumRows() >= get_rows_per_chunk())
+            self->writeChunk();
+    }
+
+    void extendFinalizeFromProperties() override {
+        Super::extendFinalizeFromProperties();
+        OPENSIM_THROW_IF_FRMOBJ(get_rows_per_chunk() < 1, Exception,
+            "Property rows_per_chunk must be at least 1, but it is " +
+            std::to_string(get_rows_per_chunk()) + ".");
+    }
+
+    void extendConnect(Component& root) override {
+        Super::extendConnect(root);
+
+        const auto& input = this->template getInput<InputT>("inputs");
+
+        std::vector<std::string> labels;
+        for (auto idx = 0u; idx < input.getNumConnectees(); ++idx)
+            labels.push_back(input.getLabel(idx));
+        _chunk.setColumnLabels(labels);
+    }
+
+private:
+    void constructProperties() {
+        constructProperty_file_name("");
+        constructProperty_rows_per_chunk(256);
+    }
+
+    // Hand the collected rows over to the writer thread and start a new
+    // chunk. The header is written with the first chunk, even if empty.
+    void writeChunk() {
+        if (_headerWritten && _chunk.getNumRows() == 0) return;
+        std::shared_ptr<const TimeSeriesTable_<ValueT>> chunk(
+                new TimeSeriesTable_<ValueT>(std::move(_chunk)));
+        const bool writeHeader = !_headerWritten;
+        _writer->write([chunk, writeHeader](std::ostream& stream) {
+            STOFileAdapter_<ValueT> adapter;
+            if (writeHeader) adapter.writeHeader(stream, *chunk);
+            adapter.writeRows(stream, *chunk);
+        });
+        _headerWritten = true;
+        _chunk = TimeSeriesTable_<ValueT>{};
+        _chunk.setColumnLabels(chunk->getColumnLabels());
+    }
+
+    // The rows not yet handed over to the writer. We write to these members
+    // in const methods, but only because we ensure those const methods are
+    // never called with trial integrator states.
+    TimeSeriesTable_<ValueT> _chunk;
+    SimTK::ResetOnCopy<std::unique_ptr<BackgroundFileWriter>> _writer;
+    bool _headerWritten = false;
+    double _lastTime = SimTK::NaN;
+};
+
+/** @name Commonly used concrete TableFileReporters */
+/// @{
+/** Writes doubles to a file, e.g., muscle activations or coordinate values.
+@relates TableFileReporter_
+@ingroup reporters
+*/
+typedef TableFileReporter_<SimTK::Real> TableFileReporter;
+/** Writes SimTK::Vec3%s to a file, e.g., positions, velocities or
+accelerations.
+@relates TableFileReporter_
+@ingroup reporters
+*/
+typedef TableFileReporter_<SimTK::Vec3> TableFileReporterVec3;
+/// @}
+
+} // namespace OpenSim
+
+#endif // OPENSIM_TABLE_FILE_REPORTER_H_
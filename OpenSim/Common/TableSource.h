@@ -166,7 +166,9 @@ protected:
 
     /** Retrieve value of a column at a given time(implicit in the State 
     provided). Linear interpolation is performed if the TimeSeriesTable_ does
-    not contain an entry for the time mentioned by the state.
+    not contain an entry for the time mentioned by the state. The row at the
+    time is computed once and cached in the State, so the channels of the
+    list output share it.
 
     \throws EmptyTable If the TimeSeriesTable_ this TableSource_ holds is 
                        currently empty.
@@ -176,42 +178,13 @@ protected:
     \throws KeyNotFound If TimeSeriesTable_ does not have column-labels.      */
     ET getColumnAtTime(const SimTK::State& state, 
                        const std::string& columnLabel) const {
-        OPENSIM_THROW_IF(_table.getNumRows() == 0, EmptyTable);
-        const auto& timeCol = _table.getIndependentColumn();
-        const auto time = state.getTime();
-        OPENSIM_THROW_IF(time < timeCol.front() ||
-                         time > timeCol.back(),
-                         TimeOutOfRange, 
-                         time, timeCol.front(), timeCol.back());
-
-        const auto colInd = 
-            static_cast<int>(_table.getColumnIndex(columnLabel));
-        auto lb = std::lower_bound(timeCol.begin(), timeCol.end(), time);
-        if(lb == timeCol.begin())
-            return _table.getMatrix().getElt(0, colInd);
-        else if(lb == timeCol.end())
-            return _table.
-                   getMatrix().
-                   getElt(static_cast<int>(timeCol.size() - 1), colInd);
-        else if(*lb == time)
-            return _table.
-                   getMatrix().
-                   getElt(static_cast<int>(lb - timeCol.begin()), colInd);
-        else {
-            auto prevTime = *(lb - 1);
-            auto nextTime = *lb;
-            auto prevElt = _table.
-                           getMatrix().
-                           getElt(static_cast<int>(lb - 1 - timeCol.begin()),
-                                  colInd);
-            auto nextElt = _table.
-                           getMatrix().
-                           getElt(static_cast<int>(lb - timeCol.begin()), 
-                                  colInd);
-            auto elt = ((time - prevTime) / (nextTime - prevTime)) * 
-                       (nextElt - prevElt) + prevElt;
-            return elt;
+        if(isRowCached(state)) {
+            const Vector& row = getCachedRow(state);
+            return row[static_cast<int>(_table.getColumnIndex(columnLabel))];
         }
+        Vector row;
+        interpolateRow(state.getTime(), row);
+        return row[static_cast<int>(_table.getColumnIndex(columnLabel))];
     }
 
     /** Retrieve a row of the TimeSeriesTable_ at a given time (specified by the
@@ -224,30 +197,16 @@ protected:
                            than the smallest timestamp or greater than the 
                            largest timestamp in the TimeSeriesTable_.         */
     Vector getRowAtTime(const SimTK::State& state) const {
-        OPENSIM_THROW_IF(_table.getNumRows() == 0, EmptyTable);
-        const auto& timeCol = _table.getIndependentColumn();
-        const auto time = state.getTime();
-        OPENSIM_THROW_IF(time < timeCol.front() ||
-                         time > timeCol.back(),
-                         TimeOutOfRange, 
-                         time, timeCol.front(), timeCol.back());
+        if(isRowCached(state))
+            return getCachedRow(state);
+        Vector row;
+        interpolateRow(state.getTime(), row);
+        return row;
+    }
 
-        auto lb = std::lower_bound(timeCol.begin(), timeCol.end(), time);
-        if(lb == timeCol.begin())
-            return _table.getRowAtIndex(0).getAsVector();
-        else if(lb == timeCol.end())
-            return _table.getRowAtIndex(timeCol.size() - 1).getAsVector();
-        else if(*lb == time)
-            return _table.getRowAtIndex(lb - timeCol.begin()).getAsVector();
-        else {
-            auto prevTime = *(lb - 1);
-            auto nextTime = *lb;
-            auto prevRow = _table.getRowAtIndex(lb - 1 - timeCol.begin());
-            auto nextRow = _table.getRowAtIndex(lb - timeCol.begin());
-            auto row = ((time - prevTime) / (nextTime - prevTime)) * 
-                       (nextRow - prevRow) + prevRow;
-            return row.getAsVector();
-        }
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override {
+        Super::extendAddToSystem(system);
+        _rowCV = addCacheVariable("row", Vector{}, SimTK::Stage::Time);
     }
 
 private:
@@ -268,7 +227,59 @@ private:
             columnOutput.addChannel(columnLabel);
     }
 
+    // Whether the row at the time of the state can be kept in the cache: the
+    // cache variable exists and the state has been realized to Stage::Time.
+    bool isRowCached(const SimTK::State& state) const {
+        return _rowCV.isAllocated() &&
+               state.getSystemStage() >= SimTK::Stage::Time;
+    }
+
+    // The row at the time of the state, interpolated the first time it is
+    // needed at that time.
+    const Vector& getCachedRow(const SimTK::State& state) const {
+        if(!_rowCV.isValid(state)) {
+            interpolateRow(state.getTime(), _rowCV.updValue(state));
+            _rowCV.markValid(state);
+        }
+        return _rowCV.getValue(state);
+    }
+
+    // Interpolate the row of the table at the given time into row, with one
+    // search of the time column for all columns.
+    void interpolateRow(double time, Vector& row) const {
+        OPENSIM_THROW_IF(_table.getNumRows() == 0, EmptyTable);
+        const auto& timeCol = _table.getIndependentColumn();
+        OPENSIM_THROW_IF(time < timeCol.front() ||
+                         time > timeCol.back(),
+                         TimeOutOfRange, 
+                         time, timeCol.front(), timeCol.back());
+
+        const auto& matrix = _table.getMatrix();
+        const int ncol = static_cast<int>(_table.getNumColumns());
+        row.resize(ncol);
+        auto lb = std::lower_bound(timeCol.begin(), timeCol.end(), time);
+        if(lb == timeCol.begin() || lb == timeCol.end() || *lb == time) {
+            int index = static_cast<int>(lb - timeCol.begin());
+            if(lb == timeCol.end())
+                index = static_cast<int>(timeCol.size() - 1);
+            for(int c = 0; c < ncol; ++c)
+                row[c] = matrix.getElt(index, c);
+        } else {
+            const int next = static_cast<int>(lb - timeCol.begin());
+            const auto prevTime = *(lb - 1);
+            const auto nextTime = *lb;
+            const auto fraction = (time - prevTime) / (nextTime - prevTime);
+            for(int c = 0; c < ncol; ++c) {
+                const auto& prevElt = matrix.getElt(next - 1, c);
+                row[c] = fraction * (matrix.getElt(next, c) - prevElt) +
+                         prevElt;
+            }
+        }
+    }
+
     Table _table;
+    // The row at the time of the state.
+    mutable SimTK::ResetOnCopy<CacheVariable<Vector>> _rowCV;
 }; // class TableSource_
 
 
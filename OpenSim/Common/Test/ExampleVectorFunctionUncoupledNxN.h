@@ -144,6 +144,32 @@ public:
         const Array<int> &aDerivWRT) override {
             std::cout<<"\nExampleVectorFunctionUncoupledNxN.evalute(x,y,derivWRT): not implemented.\n";
     }
+    void evaluate(const SimTK::State& s, const Array<double> &aX,
+        Array<double> &rF) override {
+        calcValue(aX, rF);
+        ++_numEvaluations;
+        _numEntriesEvaluated += getNX();
+    }
+    void evaluate(const SimTK::State& s, const Array<double> &aX,
+        Array<double> &rF, const Array<bool> &aActive) override {
+        // Evaluate all entries, but keep the values of the inactive ones.
+        Array<double> f(0.0, getNX());
+        calcValue(aX, f);
+        ++_numEvaluations;
+        for(int i=0;i<getNX();i++) {
+            if(!aActive[i]) continue;
+            rF[i] = f[i];
+            ++_numEntriesEvaluated;
+        }
+    }
+    /** The number of calls to evaluate(), and the number of entries they
+    evaluated. */
+    int getNumEvaluations() const { return _numEvaluations; }
+    int getNumEntriesEvaluated() const { return _numEntriesEvaluated; }
+
+private:
+    int _numEvaluations = 0;
+    int _numEntriesEvaluated = 0;
 
     //=============================================================================
 };
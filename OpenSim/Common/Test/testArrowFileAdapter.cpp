@@ -0,0 +1,106 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testArrowFileAdapter.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "OpenSim/Common/Adapters.h"
+
+#include <arrow/api.h>
+
+#include <cmath>
+#include <cstdio>
+
+void compareTables(const OpenSim::TimeSeriesTable& expected,
+                   const OpenSim::TimeSeriesTable& found) {
+    using namespace OpenSim;
+
+    if(expected.getColumnLabels() != found.getColumnLabels())
+        throw Exception{"Column labels do not match."};
+    if(expected.getIndependentColumn() != found.getIndependentColumn())
+        throw Exception{"Time columns do not match."};
+    for(size_t r = 0; r < expected.getNumRows(); ++r)
+        for(size_t c = 0; c < expected.getNumColumns(); ++c)
+            if(expected.getMatrix()(int(r), int(c)) !=
+               found.getMatrix()(int(r), int(c)))
+                throw Exception{"Data do not match at row " +
+                                std::to_string(r) + ", column " +
+                                std::to_string(c) + "."};
+}
+
+int main() {
+    using namespace OpenSim;
+
+    std::cout << "Testing ArrowFileAdapter with a .mot file" << std::endl;
+    {
+        const std::string filename{"std_subject01_walk1_ik.mot"};
+        auto table = STOFileAdapter_<double>::read(filename);
+        table.addTableMetaData("source", std::string{"ik"});
+        for(const std::string arrowfile : {"testArrowFileAdapter_ik.arrow",
+                                           "testArrowFileAdapter_ik.feather"}) {
+            FileAdapter::writeFile({{"table", &table}}, arrowfile);
+            auto found = ArrowFileAdapter::read(arrowfile);
+            compareTables(table, found);
+            if(found.getTableMetaData<std::string>("source") != "ik")
+                throw Exception{"Metadata do not match."};
+            std::remove(arrowfile.c_str());
+        }
+
+        try {
+            ArrowFileAdapter::read(filename);
+            throw Exception{"Expected IOError."};
+        } catch(const IOError&) {}
+    }
+
+    std::cout << "Testing ArrowFileAdapter with record batches" << std::endl;
+    {
+        TimeSeriesTable table{};
+        table.setColumnLabels({"a", "b"});
+        table.addTableMetaData("DataRate", std::string{"100"});
+        for(int i = 0; i < 10; ++i)
+            table.appendRow(0.01 * i, SimTK::RowVector{2, double(i)});
+        const auto batch = ArrowFileAdapter::toRecordBatch(table);
+        if(batch->num_rows() != 10 || batch->num_columns() != 3 ||
+           batch->schema()->field(0)->name() != "time")
+            throw Exception{"Unexpected record batch."};
+        compareTables(table, ArrowFileAdapter::fromRecordBatch(*batch));
+
+        // Null entries are read as NaN.
+        arrow::DoubleBuilder builder{};
+        std::shared_ptr<arrow::Array> time{}, values{};
+        if(!builder.AppendValues(std::vector<double>{0, 1}).ok() ||
+           !builder.Finish(&time).ok() ||
+           !builder.Append(2.).ok() || !builder.AppendNull().ok() ||
+           !builder.Finish(&values).ok())
+            throw Exception{"Could not build arrays."};
+        const auto withNull = arrow::RecordBatch::Make(
+            arrow::schema({arrow::field("t", arrow::float64()),
+                           arrow::field("x", arrow::float64())}),
+            2, {time, values});
+        const auto found = ArrowFileAdapter::fromRecordBatch(*withNull);
+        if(found.getMatrix()(0, 0) != 2. ||
+           !std::isnan(found.getMatrix()(1, 0)))
+            throw Exception{"Null entries not read as NaN."};
+    }
+
+    std::cout << "\nAll tests passed!" << std::endl;
+
+    return 0;
+}
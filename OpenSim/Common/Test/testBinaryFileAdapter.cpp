@@ -0,0 +1,299 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testBinaryFileAdapter.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "OpenSim/Common/Adapters.h"
+#include "OpenSim/Common/DiskBackedStorage.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+template<typename T>
+void compareTables(const OpenSim::TimeSeriesTable_<T>& expected,
+                   const OpenSim::TimeSeriesTable_<T>& found) {
+    using namespace OpenSim;
+
+    if(expected.getColumnLabels() != found.getColumnLabels())
+        throw Exception{"Column labels do not match."};
+    if(expected.getIndependentColumn() != found.getIndependentColumn())
+        throw Exception{"Time columns do not match."};
+    for(size_t r = 0; r < expected.getNumRows(); ++r)
+        for(size_t c = 0; c < expected.getNumColumns(); ++c)
+            if(expected.getMatrix()(int(r), int(c)) != 
+               found.getMatrix()(int(r), int(c)))
+                throw Exception{"Data do not match at row " +
+                                std::to_string(r) + ", column " +
+                                std::to_string(c) + "."};
+}
+
+template<typename T>
+T createElem(double v);
+
+template<>
+double createElem<double>(double v) {
+    return v;
+}
+
+template<>
+float createElem<float>(double v) {
+    return static_cast<float>(v);
+}
+
+template<>
+SimTK::Vec3 createElem<SimTK::Vec3>(double v) {
+    return {v, -v, 1. / 3 * v};
+}
+
+template<>
+SimTK::Quaternion createElem<SimTK::Quaternion>(double v) {
+    return SimTK::Quaternion{SimTK::Rotation{v, SimTK::ZAxis}};
+}
+
+template<>
+SimTK::SpatialVec createElem<SimTK::SpatialVec>(double v) {
+    return {{v, 2 * v, 3 * v}, {-v, -2 * v, -3 * v}};
+}
+
+template<typename T>
+void testReadingWriting() {
+    using namespace OpenSim;
+
+    const std::string filename{"testBinaryFileAdapter.otb"};
+    TimeSeriesTable_<T> table{};
+    table.setColumnLabels({"c0", "c1", "c2"});
+    table.updTableMetaData().setValueForKey("DataRate", std::string{"100"});
+    for(int i = 0; i < 20; ++i) {
+        const double t{0.01 * i};
+        table.appendRow(t, {createElem<T>(t), createElem<T>(0.1 + t),
+                            createElem<T>(SimTK::Pi * t)});
+    }
+
+    BinaryFileAdapter::write(table, filename);
+    auto table_copy = BinaryFileAdapter::read<T>(filename);
+    compareTables(table, table_copy);
+    if(table_copy.template getTableMetaData<std::string>("DataRate") != "100")
+        throw Exception{"Table metadata was not read back."};
+
+    // The generic interface dispatches on the extension.
+    auto abs_table = FileAdapter::readFile(filename).at("table");
+    compareTables(table,
+                  dynamic_cast<TimeSeriesTable_<T>&>(*abs_table));
+
+    // Read a subset of the columns, in a different order.
+    if(BinaryFileAdapter::readColumnLabels(filename) !=
+       table.getColumnLabels())
+        throw Exception{"Column labels read without data do not match."};
+    auto subset = BinaryFileAdapter::readColumns<T>(filename, {"c2", "c0"});
+    if(subset.getColumnLabels() != std::vector<std::string>{"c2", "c0"})
+        throw Exception{"Unexpected column labels when reading a subset."};
+    for(size_t r = 0; r < table.getNumRows(); ++r) {
+        if(subset.getMatrix()(int(r), 0) != table.getMatrix()(int(r), 2) ||
+           subset.getMatrix()(int(r), 1) != table.getMatrix()(int(r), 0))
+            throw Exception{"Subset of columns read incorrectly."};
+    }
+
+    try {
+        BinaryFileAdapter::readColumns<T>(filename, {"c0", "not_a_column"});
+        throw Exception{"Expected KeyNotFound for a missing column."};
+    } catch(const KeyNotFound&) {}
+
+    // Read the rows in a time range, of one of the columns.
+    auto window = BinaryFileAdapter::readTimeRange<T>(filename, 0.045, 0.125,
+                                                      {"c1"});
+    if(window.getNumRows() != 8 || window.getNumColumns() != 1)
+        throw Exception{"Unexpected size of the rows read in a time range."};
+    for(size_t r = 0; r < window.getNumRows(); ++r) {
+        if(window.getIndependentColumn()[r] !=
+                table.getIndependentColumn()[r + 5] ||
+           window.getMatrix()(int(r), 0) != table.getMatrix()(int(r + 5), 1))
+            throw Exception{"Rows in a time range read incorrectly."};
+    }
+    if(BinaryFileAdapter::readTimeRange<T>(filename, 1, 2).getNumRows() != 0)
+        throw Exception{"Expected no rows after the end of the file."};
+
+    std::remove(filename.c_str());
+}
+
+// Looking up data through a DiskBackedStorage, with few small chunks so that
+// chunks are dropped and read again, gives the values of a Storage of the
+// same data.
+void testDiskBackedStorage() {
+    using namespace OpenSim;
+
+    const std::string filename{"std_subject01_walk1_ik.mot"};
+    const std::string binfile{"testDiskBackedStorage.otb"};
+    BinaryFileAdapter::write(STOFileAdapter_<double>::read(filename),
+                             binfile);
+    {
+        Storage storage(filename);
+        const DiskBackedStorage onDisk(binfile, 7, 2);
+        const int nc = storage.getColumnLabels().getSize() - 1;
+        if(onDisk.getSize() != storage.getSize() ||
+           !(onDisk.getColumnLabels() == storage.getColumnLabels()))
+            throw Exception{"Size or labels of a DiskBackedStorage differ."};
+
+        auto near = [](double a, double b) {
+            return std::abs(a - b) <= 1e-10 * (1 + std::abs(b));
+        };
+        Array<double> expected(0.0, nc), found(0.0, nc);
+        const double t0 = storage.getFirstTime() - 0.1;
+        const double t1 = storage.getLastTime() + 0.1;
+        for(double t = t0; t < t1; t += 0.0123) {
+            storage.getDataAtTime(t, nc, expected);
+            if(onDisk.getDataAtTime(t, nc, found) != nc)
+                throw Exception{"Unexpected number of values at a time."};
+            for(int j = 0; j < nc; ++j)
+                if(!near(found[j], expected[j]))
+                    throw Exception{"Values at time " + std::to_string(t) +
+                                    " differ."};
+        }
+        if(onDisk.getNumResidentChunks() > 2)
+            throw Exception{"More chunks are resident than allowed."};
+
+        const std::string label = storage.getColumnLabels()[3];
+        storage.getDataColumn(label, expected);
+        onDisk.getDataColumn(label, found);
+        if(found.getSize() != expected.getSize())
+            throw Exception{"Columns have different sizes."};
+        for(int i = 0; i < found.getSize(); ++i)
+            if(!near(found[i], expected[i]))
+                throw Exception{"Columns differ."};
+
+        const double mid = 0.5 * (storage.getFirstTime() +
+                                  storage.getLastTime());
+        const Storage window = onDisk.getWindow(mid, storage.getLastTime());
+        if(window.getSize() == 0 || window.getFirstTime() < mid ||
+           window.getLastTime() != storage.getLastTime())
+            throw Exception{"Window of rows read incorrectly."};
+    }
+    std::remove(binfile.c_str());
+}
+
+// A table kept and written in single precision holds the values of the
+// table in double precision, rounded, in half the space.
+void testSinglePrecision() {
+    using namespace OpenSim;
+
+    const std::string filename{"std_subject01_walk1_ik.mot"};
+    const std::string doubleFile{"testSinglePrecision_double.otb"};
+    const std::string floatFile{"testSinglePrecision_float.otb"};
+    const auto table = STOFileAdapter_<double>::read(filename);
+    const TimeSeriesTableFloat single = toSinglePrecision(table);
+    const std::string& key = getPrecisionMetaDataKey();
+    if(table.hasTableMetaDataKey(key) ||
+       single.getTableMetaData<std::string>(key) != "single")
+        throw Exception{"Rounded table is not marked."};
+    if(single.getColumnLabels() != table.getColumnLabels() ||
+       single.getIndependentColumn() != table.getIndependentColumn())
+        throw Exception{"Labels or times of the rounded table differ."};
+
+    auto near = [](double a, double b) {
+        return std::abs(a - b) <= 1e-6 * (1 + std::abs(b));
+    };
+    BinaryFileAdapter::write(table, doubleFile);
+    BinaryFileAdapter::write(single, floatFile);
+    if(BinaryFileAdapter::readDataType(floatFile) != "float")
+        throw Exception{"Unexpected data type."};
+    const auto layout = BinaryFileAdapter::readLayout(floatFile);
+    if(layout.scalarSize != sizeof(float))
+        throw Exception{"Unexpected size of the stored values."};
+    {
+        std::ifstream doubles(doubleFile, std::ios::binary | std::ios::ate);
+        std::ifstream floats(floatFile, std::ios::binary | std::ios::ate);
+        const size_t dataSize = table.getNumRows() * table.getNumColumns();
+        if(size_t(doubles.tellg()) - size_t(floats.tellg()) <
+           dataSize * (sizeof(double) - sizeof(float)))
+            throw Exception{"Values were not stored in single precision."};
+    }
+
+    const auto copy = BinaryFileAdapter::read<float>(floatFile);
+    compareTables(single, copy);
+    const TimeSeriesTable restored = toDoublePrecision(copy);
+    if(restored.getTableMetaData<std::string>(key) != "single")
+        throw Exception{"Restored table is not marked."};
+    for(size_t r = 0; r < table.getNumRows(); ++r)
+        for(size_t c = 0; c < table.getNumColumns(); ++c)
+            if(!near(restored.getMatrix()(int(r), int(c)),
+                     table.getMatrix()(int(r), int(c))))
+                throw Exception{"Rounded values differ."};
+
+    // The average row is summed in double precision.
+    const double t0 = table.getIndependentColumn().front();
+    const double t1 = table.getIndependentColumn().back();
+    const auto expected = table.averageRow(t0, t1);
+    const auto found = single.averageRow(t0, t1);
+    for(int c = 0; c < expected.size(); ++c)
+        if(!near(found[c], expected[c]))
+            throw Exception{"Average rows differ."};
+
+    std::remove(doubleFile.c_str());
+    std::remove(floatFile.c_str());
+}
+
+int main() {
+    using namespace OpenSim;
+
+    std::cout << "Testing BinaryFileAdapter with a .mot file" << std::endl;
+    {
+        const std::string filename{"std_subject01_walk1_ik.mot"};
+        const std::string binfile{"testBinaryFileAdapter_ik.otb"};
+        auto table = STOFileAdapter_<double>::read(filename);
+        BinaryFileAdapter::write(table, binfile);
+        compareTables(table, BinaryFileAdapter::read<double>(binfile));
+        if(BinaryFileAdapter::readDataType(binfile) != "double")
+            throw Exception{"Unexpected data type."};
+
+        try {
+            BinaryFileAdapter::read<SimTK::Vec3>(binfile);
+            throw Exception{"Expected IncorrectTableType."};
+        } catch(const IncorrectTableType&) {}
+        try {
+            BinaryFileAdapter::read<double>(filename);
+            throw Exception{"Expected NotABinaryTableFile."};
+        } catch(const NotABinaryTableFile&) {}
+
+        std::remove(binfile.c_str());
+    }
+
+    std::cout << "Testing BinaryFileAdapter with double" << std::endl;
+    testReadingWriting<double>();
+    std::cout << "Testing BinaryFileAdapter with float" << std::endl;
+    testReadingWriting<float>();
+    std::cout << "Testing BinaryFileAdapter with SimTK::Vec3" << std::endl;
+    testReadingWriting<SimTK::Vec3>();
+    std::cout << "Testing BinaryFileAdapter with SimTK::Quaternion"
+              << std::endl;
+    testReadingWriting<SimTK::Quaternion>();
+    std::cout << "Testing BinaryFileAdapter with SimTK::SpatialVec"
+              << std::endl;
+    testReadingWriting<SimTK::SpatialVec>();
+
+    std::cout << "Testing single precision" << std::endl;
+    testSinglePrecision();
+
+    std::cout << "Testing DiskBackedStorage" << std::endl;
+    testDiskBackedStorage();
+
+    std::cout << "\nAll tests passed!" << std::endl;
+
+    return 0;
+}
@@ -345,6 +345,21 @@ private:
 
 // Create 2nd level derived class to verify that Component interface
 // holds up.
+// A component that caches a value through a CacheVariable handle.
+class CacheHolder : public Component {
+    OpenSim_DECLARE_CONCRETE_OBJECT(CacheHolder, Component);
+public:
+    CacheHolder() = default;
+    const CacheVariable<double>& getEnergyCV() const { return _energyCV; }
+protected:
+    void extendAddToSystem(MultibodySystem& system) const override {
+        Super::extendAddToSystem(system);
+        _energyCV = addCacheVariable("energy", 0.0, Stage::Position);
+    }
+private:
+    mutable SimTK::ResetOnCopy<CacheVariable<double>> _energyCV;
+}; // End of class CacheHolder
+
 class CompoundFoo : public Foo {
     OpenSim_DECLARE_CONCRETE_OBJECT(CompoundFoo, Foo);
 public:
@@ -1572,6 +1587,23 @@ void testTableSource() {
     tableReporter->report(s);
     assertEqual(table.getRowAtIndex(3)  , report.getRowAtIndex(6));
 
+    // Once the state is realized to Stage::Time, the row at its time is
+    // cached, and computed again when the time changes.
+    system.realizeModel(s);
+    for (double time : {0.6, 0.1}) {
+        s.setTime(time);
+        system.realize(s, Stage::Time);
+        tableReporter->report(s);
+        row = RowVector_<double>{4, 4*time};
+        assertEqual(row.getAsRowVectorView(),
+                    report.getRowAtIndex(report.getNumRows() - 1));
+        const auto allColumns =
+            tableSource->getOutputValue<Vector>(s, "all_columns");
+        ASSERT(allColumns.size() == 4);
+        for (int i = 0; i < 4; ++i)
+            ASSERT_EQUAL(4*time, allColumns[i], 1e-10);
+    }
+
     std::cout << "Report: " << std::endl;
     std::cout << report << std::endl;
 }
@@ -1926,6 +1958,335 @@ void testAliasesAndLabels() {
     SimTK_TEST(foo->getInput("listInput1").getLabel(1) == "thud");
 }
 
+void testCacheVariableHandle() {
+    MultibodySystem system;
+    TheWorld theWorld;
+    theWorld.setName("World");
+
+    CacheHolder* holder = new CacheHolder();
+    holder->setName("holder");
+    theWorld.add(holder);
+
+    // The handle is empty until the component is added to a system.
+    SimTK::State sBlank;
+    SimTK_TEST(!holder->getEnergyCV().isAllocated());
+    ASSERT_THROW(OpenSim::Exception, holder->getEnergyCV().getValue(sBlank));
+
+    theWorld.buildUpSystem(system);
+    State s = system.realizeTopology();
+    system.realize(s, Stage::Position);
+    const CacheVariable<double>& energyCV = holder->getEnergyCV();
+    SimTK_TEST(energyCV.isAllocated());
+
+    // The handle and the string-keyed accessors refer to the same entry.
+    SimTK_TEST(!energyCV.isValid(s));
+    energyCV.setValue(s, 3.5);
+    SimTK_TEST(energyCV.isValid(s));
+    SimTK_TEST(holder->isCacheVariableValid(s, "energy"));
+    SimTK_TEST(holder->getCacheVariableValue<double>(s, "energy") == 3.5);
+
+    holder->setCacheVariableValue(s, "energy", 7.0);
+    SimTK_TEST(energyCV.getValue(s) == 7.0);
+    energyCV.updValue(s) = 8.0;
+    SimTK_TEST(holder->getCacheVariableValue<double>(s, "energy") == 8.0);
+
+    energyCV.markInvalid(s);
+    SimTK_TEST(!holder->isCacheVariableValid(s, "energy"));
+    energyCV.markValid(s);
+    SimTK_TEST(energyCV.isValid(s));
+
+    // Invalidating the stage the entry depends on invalidates the entry.
+    s.invalidateAll(Stage::Position);
+    SimTK_TEST(!energyCV.isValid(s));
+
+    // A copy of the component does not refer to the original's cache.
+    CacheHolder copy(*holder);
+    SimTK_TEST(!copy.getEnergyCV().isAllocated());
+}
+
+void testOutputValueCaching() {
+    class Costly : public Component {
+        OpenSim_DECLARE_CONCRETE_OBJECT(Costly, Component);
+    public:
+        OpenSim_DECLARE_OUTPUT(time_squared, double, calcTimeSquared,
+                               SimTK::Stage::Time);
+        OpenSim_DECLARE_OUTPUT(time_cubed, double, calcTimeCubed,
+                               SimTK::Stage::Time);
+        OpenSim_DECLARE_LIST_OUTPUT(powers, double, calcPower,
+                                    SimTK::Stage::Time);
+        double calcTimeSquared(const SimTK::State& s) const {
+            ++numCalls;
+            return s.getTime() * s.getTime();
+        }
+        double calcTimeCubed(const SimTK::State& s) const {
+            ++numCalls;
+            return s.getTime() * s.getTime() * s.getTime();
+        }
+        double calcPower(const SimTK::State& s,
+                         const std::string& channel) const {
+            return std::pow(s.getTime(), std::stod(channel));
+        }
+        mutable int numCalls = 0;
+    };
+    class Reader : public Component {
+        OpenSim_DECLARE_CONCRETE_OBJECT(Reader, Component);
+    public:
+        OpenSim_DECLARE_INPUT(in, double, SimTK::Stage::Time, "");
+    };
+
+    TheWorld world;
+    Costly* costly = new Costly(); costly->setName("costly");
+    world.add(costly);
+    Reader* readers[3];
+    for (int i = 0; i < 3; ++i) {
+        readers[i] = new Reader(); readers[i]->setName("r" + std::to_string(i));
+        world.add(readers[i]);
+        readers[i]->updInput("in").connect(costly->getOutput("time_squared"));
+    }
+    costly->updOutput("time_squared").setValueCaching(true);
+    SimTK_TEST(costly->getOutput("time_squared").getValueCaching());
+    SimTK_TEST(!costly->getOutput("time_cubed").getValueCaching());
+
+    MultibodySystem system;
+    world.connect();
+    world.buildUpSystem(system);
+    State s = system.realizeTopology();
+    s.setTime(2.0);
+    system.realize(s, Stage::Time);
+
+    // The cached Output is computed once however many times it is read.
+    const auto& squared =
+            Output<double>::downcast(costly->getOutput("time_squared"));
+    for (int i = 0; i < 3; ++i)
+        SimTK_TEST(readers[i]->getInput<double>("in").getValue(s) == 4.0);
+    SimTK_TEST(squared.getValue(s) == 4.0);
+    SimTK_TEST(costly->numCalls == 1);
+
+    // Other Outputs are computed at each read.
+    const auto& cubed =
+            Output<double>::downcast(costly->getOutput("time_cubed"));
+    SimTK_TEST(cubed.getValue(s) == 8.0);
+    SimTK_TEST(cubed.getValue(s) == 8.0);
+    SimTK_TEST(costly->numCalls == 3);
+
+    // Changing the time invalidates the cached value.
+    s.setTime(3.0);
+    system.realize(s, Stage::Time);
+    SimTK_TEST(squared.getValue(s) == 9.0);
+    SimTK_TEST(readers[0]->getInput<double>("in").getValue(s) == 9.0);
+    SimTK_TEST(costly->numCalls == 4);
+
+    // Copies also cache the value once they are added to a system.
+    Costly copy(*costly);
+    SimTK_TEST(copy.getOutput("time_squared").getValueCaching());
+
+    // List Outputs cannot cache their values.
+    SimTK_TEST_MUST_THROW_EXC(
+            costly->updOutput("powers").setValueCaching(true),
+            OpenSim::Exception);
+}
+
+void testStateVariableHandle() {
+    MultibodySystem system;
+    TheWorld theWorld;
+    theWorld.setName("World");
+    theWorld.finalizeFromProperties();
+
+    ASSERT_THROW(ComponentHasNoSystem,
+        theWorld.getStateVariableHandle("internalSub/subState"));
+
+    theWorld.buildUpSystem(system);
+    State s = system.realizeTopology();
+
+    const auto handle = theWorld.getStateVariableHandle("internalSub/subState");
+    SimTK_TEST(handle.isValid());
+    SimTK_TEST(handle.getName() == "subState");
+    SimTK_TEST(&handle.getOwner() ==
+               &theWorld.getComponent<Sub>("internalSub"));
+    ASSERT_THROW(OpenSim::Exception,
+        theWorld.getStateVariableHandle("internalSub/waldo"));
+    ASSERT_THROW(OpenSim::Exception,
+        Component::StateVariableHandle().getValue(s));
+
+    // The handle and the name-based accessors refer to the same variable.
+    handle.setValue(s, 2.5);
+    SimTK_TEST(theWorld.getStateVariableValue(s, "internalSub/subState") == 2.5);
+    theWorld.setStateVariableValue(s, "internalSub/subState", -1.0);
+    SimTK_TEST(handle.getValue(s) == -1.0);
+
+    // The bulk accessors use the same order as getStateVariableNames().
+    const Array<std::string> names = theWorld.getStateVariableNames();
+    SimTK::Vector values = theWorld.getStateVariableValues(s);
+    SimTK_TEST(values.size() == names.getSize());
+    for (int i = 0; i < names.getSize(); ++i) {
+        SimTK_TEST(values[i] ==
+            theWorld.getStateVariableHandle(names[i]).getValue(s));
+        values[i] = 10.0 + i;
+    }
+    theWorld.setStateVariableValues(s, values);
+    for (int i = 0; i < names.getSize(); ++i)
+        SimTK_TEST(theWorld.getStateVariableValue(s, names[i]) == 10.0 + i);
+
+    system.realize(s, Stage::Acceleration);
+    SimTK_TEST_EQ(handle.getDerivative(s), exp(-2.0*s.getTime()));
+
+    // The bulk accessors follow the component to a new System.
+    MultibodySystem system2;
+    theWorld.finalizeFromProperties();
+    theWorld.buildUpSystem(system2);
+    State s2 = system2.realizeTopology();
+    theWorld.setStateVariableValues(s2, values);
+    SimTK_TEST_EQ(theWorld.getStateVariableValues(s2), values);
+}
+
+void testStateVariableValuesInY() {
+    MultibodySystem system;
+    TheWorld theWorld;
+    theWorld.setName("World");
+    theWorld.finalizeFromProperties();
+    theWorld.buildUpSystem(system);
+    State s = system.realizeTopology();
+
+    // The names are collected once, and kept.
+    const Array<std::string> names = theWorld.getStateVariableNames();
+    SimTK_TEST(theWorld.getStateVariableNames() == names);
+
+    // The values are gathered from Y, into the given Vector, which is not
+    // reallocated once it has the right size.
+    SimTK::Vector values;
+    theWorld.getStateVariableValues(s, values);
+    SimTK_TEST(values.size() == names.getSize());
+    const double* data = &values[0];
+    for (int i = 0; i < names.getSize(); ++i)
+        theWorld.setStateVariableValue(s, names[i], 0.5*i - 1.0);
+    theWorld.getStateVariableValues(s, values);
+    SimTK_TEST(&values[0] == data);
+    for (int i = 0; i < names.getSize(); ++i)
+        SimTK_TEST(values[i] == 0.5*i - 1.0);
+
+    // They are scattered to Y, and setting only z's keeps the state realized
+    // to Stage::Velocity.
+    system.realize(s, Stage::Velocity);
+    for (int i = 0; i < names.getSize(); ++i)
+        values[i] = 3.0 + i;
+    theWorld.setStateVariableValues(s, values);
+    SimTK_TEST(s.getSystemStage() == Stage::Velocity);
+    for (int i = 0; i < names.getSize(); ++i)
+        SimTK_TEST(theWorld.getStateVariableHandle(names[i]).getValue(s) ==
+                   3.0 + i);
+}
+
+template <typename T>
+std::vector<const T*> collect(const ComponentList<const T>& list) {
+    std::vector<const T*> components;
+    for (const T& comp : list)
+        components.push_back(&comp);
+    return components;
+}
+
+void testComponentRegistry() {
+    TheWorld top;
+    top.setName("top");
+    TheWorld* A = new TheWorld();
+    A->setName("A");
+    TheWorld* B = new TheWorld();
+    B->setName("B");
+    Foo* foo1 = new Foo();
+    foo1->setName("foo1");
+    Foo* foo2 = new Foo();
+    foo2->setName("foo2");
+    Bar* bar = new Bar();
+    bar->setName("bar");
+    top.add(A);
+    A->add(foo1);
+    A->add(B);
+    B->add(foo2);
+    top.add(bar);
+
+    // Until the root builds the registry, lists of subtrees walk the tree.
+    const auto walked = collect(A->getComponentList());
+    const auto walkedFoos = collect(A->getComponentList<Foo>());
+
+    const auto foos = collect(top.getComponentList<Foo>());
+    SimTK_TEST(foos.size() == 2 && foos[0] == foo1 && foos[1] == foo2);
+    SimTK_TEST(collect(A->getComponentList()) == walked);
+    SimTK_TEST(collect(A->getComponentList<Foo>()) == walkedFoos);
+    SimTK_TEST(walkedFoos == foos);
+    // A list does not include its own root.
+    const auto underB = collect(B->getComponentList<TheWorld>());
+    SimTK_TEST(underB.empty());
+    SimTK_TEST(collect(B->getComponentList<Foo>()).size() == 1);
+
+    // Filters apply on top of the type.
+    ComponentList<const Component> list = top.getComponentList();
+    list.setFilter(ComponentFilterAbsolutePathNameContainsString("foo2"));
+    SimTK_TEST(collect(list).size() ==
+               1 + collect(foo2->getComponentList()).size());
+
+    // Paths are looked up in the registry.
+    SimTK_TEST(&top.getComponent("/top/A/B/foo2") == foo2);
+    SimTK_TEST(&top.getComponent<Foo>("A/B/foo2") == foo2);
+    SimTK_TEST(&B->getComponent("../foo1") == foo1);
+    SimTK_TEST(&foo2->getComponent("../../../bar") == bar);
+    SimTK_TEST(!top.hasComponent<Bar>("A/B/foo2"));
+    SimTK_TEST(!top.hasComponent("foo2"));
+
+    // Renamed components are found by their new names.
+    foo2->setName("waldo");
+    SimTK_TEST(!top.hasComponent("A/B/foo2"));
+    SimTK_TEST(&top.getComponent<Foo>("A/B/waldo") == foo2);
+    foo2->setName("foo2");
+
+    // The registry follows changes to the tree.
+    Foo* foo3 = new Foo();
+    foo3->setName("foo3");
+    B->add(foo3);
+    SimTK_TEST(collect(top.getComponentList<Foo>()).size() == 3);
+    SimTK_TEST(collect(A->getComponentList<Foo>()).back() == foo3);
+    SimTK_TEST(&A->getComponent("B/foo3") == foo3);
+
+    // A copy has its own registry.
+    TheWorld copy(top);
+    copy.finalizeFromProperties();
+    const auto copyFoos = collect(copy.getComponentList<Foo>());
+    SimTK_TEST(copyFoos.size() == 3 && copyFoos[0] != foo1);
+    SimTK_TEST(&copy.getComponent("A/B/foo3") == copyFoos[2]);
+}
+
+void testMemoryFootprint() {
+    TheWorld top;
+    top.setName("top");
+    Foo* foo = new Foo();
+    foo->setName("foo");
+    top.add(foo);
+    top.finalizeFromProperties();
+
+    const auto footprint = foo->estimateMemoryFootprint();
+    SimTK_TEST(footprint.object > 0);
+    SimTK_TEST(footprint.properties > 0);
+    SimTK_TEST(footprint.connectors > 0);
+    SimTK_TEST(footprint.document == 0);
+
+    // A longer description is accounted for.
+    const size_t strings = footprint.strings;
+    foo->setDescription(std::string(1000, 'x'));
+    SimTK_TEST(foo->estimateMemoryFootprint().strings >= strings + 1000);
+
+    // The total covers the root and all subcomponents.
+    SimTK_TEST(top.printMemoryFootprint() >=
+               top.estimateMemoryFootprint().total() +
+               foo->estimateMemoryFootprint().total());
+
+    // Releasing the elements of a document frees its memory.
+    top.print("testMemoryFootprint.xml");
+    TheWorld loaded("testMemoryFootprint.xml");
+    loaded.finalizeFromProperties();
+    SimTK_TEST(loaded.estimateMemoryFootprint().document > 0);
+    loaded.releaseDocumentElements();
+    SimTK_TEST(loaded.estimateMemoryFootprint().document == 0);
+    SimTK_TEST(!loaded.getDocumentFileName().empty());
+}
+
 int main() {
 
     //Register new types for testing deserialization
@@ -1946,6 +2307,12 @@ int main() {
         SimTK_SUBTEST(testExceptionsOutputNameExistsAlready);
         SimTK_SUBTEST(testTableSource);
         SimTK_SUBTEST(testAliasesAndLabels);
+        SimTK_SUBTEST(testCacheVariableHandle);
+        SimTK_SUBTEST(testOutputValueCaching);
+        SimTK_SUBTEST(testStateVariableHandle);
+        SimTK_SUBTEST(testStateVariableValuesInY);
+        SimTK_SUBTEST(testComponentRegistry);
+        SimTK_SUBTEST(testMemoryFootprint);
     
         writeTimeSeriesTableForInputConnecteeSerialization();
         SimTK_SUBTEST(testListInputConnecteeSerialization);
@@ -61,6 +61,10 @@ int main() {
         
         ASSERT(table.getColumnLabel(0) == "zero");
         ASSERT(table.getColumnLabel(2) == "two");
+        // The index of labels follows the labels.
+        ASSERT(table.hasColumn("zero"));
+        ASSERT(!table.hasColumn("0"));
+        ASSERT(table.getColumnIndex("two") == 2);
 
         table.setColumnLabel(0, "0");
         table.setColumnLabel(2, "2");
@@ -84,6 +88,7 @@ int main() {
 
     table.setDependentsMetaData(dep_metadata);
     table.setIndependentMetaData(ind_metadata);
+    ASSERT(table.getColumnIndex("5") == 4);
 
     SimTK::RowVector_<double> row{5, double{0}};
 
@@ -679,5 +684,44 @@ int main() {
         std::cout << tableSVec << std::endl;
     }
 
+    // Append many rows, reserve capacity and remove rows.
+    {
+        std::cout << "Test DataTable row capacity." << std::endl;
+        DataTable growing{};
+        growing.setColumnLabels({"0", "1", "2"});
+        growing.reserve(10);
+        ASSERT(growing.getRowCapacity() >= 10);
+        ASSERT(growing.getNumRows() == 0);
+
+        const unsigned numRows = 1000;
+        for(unsigned r = 0; r < numRows; ++r)
+            growing.appendRow(r, {double(r), 2. * r, 3. * r});
+        ASSERT(growing.getNumRows() == numRows);
+        ASSERT(growing.getRowCapacity() >= numRows);
+        ASSERT(growing.getMatrix().nrow() == int(numRows));
+        ASSERT(growing.getDependentColumnAtIndex(1).size() == int(numRows));
+        ASSERT(growing.updDependentColumn("2").size() == int(numRows));
+        for(unsigned r = 0; r < numRows; ++r) {
+            ASSERT(growing.getIndependentColumn()[r] == r);
+            ASSERT(growing.getRowAtIndex(r)[2] == 3. * r);
+        }
+
+        growing.shrinkToFit();
+        ASSERT(growing.getRowCapacity() == numRows);
+        ASSERT(growing.getRowAtIndex(numRows - 1)[1] == 2. * (numRows - 1));
+
+        // Removing a row shifts all the rows after it.
+        growing.removeRowAtIndex(1);
+        ASSERT(growing.getNumRows() == numRows - 1);
+        ASSERT(growing.getMatrix().nrow() == int(numRows - 1));
+        ASSERT(growing.getIndependentColumn()[1] == 2);
+        ASSERT(growing.getRowAtIndex(1)[0] == 2.);
+        ASSERT(growing.getRowAtIndex(2)[0] == 3.);
+        ASSERT(growing.getRowAtIndex(numRows - 2)[0] == numRows - 1.);
+        growing.appendRow(numRows, {-1., -2., -3.});
+        ASSERT(growing.getNumRows() == numRows);
+        ASSERT(growing.getRowAtIndex(numRows - 1)[2] == -3.);
+    }
+
     return 0;
 }
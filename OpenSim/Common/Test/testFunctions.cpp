@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testFunctions.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// testFunctions verifies that the evaluation of Functions of one argument from
+// a double, at many arguments at once, and from the interval of a previous
+// argument, matches their evaluation from a Vector of arguments, and that a
+// FunctionGroup evaluates its functions as they are evaluated alone.
+//=============================================================================
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/FunctionGroup.h>
+#include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Common/MultiplierFunction.h>
+#include <OpenSim/Common/PiecewiseConstantFunction.h>
+#include <OpenSim/Common/PiecewiseLinearFunction.h>
+#include <OpenSim/Common/PolynomialFunction.h>
+#include <OpenSim/Common/SimmSpline.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+// Compare calcValue(double), calcDerivative(double, int) and calcValues() to
+// calcValue() and calcDerivative() with Vectors, inside and outside of the
+// range of the data points, on the data points, and at increasing and
+// decreasing arguments.
+void testScalarEvaluation(const Function& f, int maxDerivativeOrder)
+{
+    SimTK::Vector x(61);
+    for (int i = 0; i < 41; ++i) x[i] = -1.0 + 0.3*i;
+    for (int i = 41; i < 61; ++i) x[i] = 11.0 - 0.55*(i - 41);
+    x[10] = 2.0; x[11] = 5.0; x[50] = 0.0;
+
+    SimTK::Vector values;
+    f.calcValues(x, values);
+    ASSERT(values.size() == x.size(), __FILE__, __LINE__,
+        f.getConcreteClassName() + ": calcValues() has the wrong size.");
+
+    for (int i = 0; i < x.size(); ++i) {
+        const SimTK::Vector xvec(1, x[i]);
+        const double expected = f.calcValue(xvec);
+        ASSERT_EQUAL(expected, f.calcValue(x[i]), 1e-12, __FILE__, __LINE__,
+            f.getConcreteClassName() + ": calcValue(double) differs.");
+        ASSERT_EQUAL(expected, values[i], 1e-12, __FILE__, __LINE__,
+            f.getConcreteClassName() + ": calcValues() differs.");
+        for (int order = 1; order <= maxDerivativeOrder; ++order) {
+            ASSERT_EQUAL(f.calcDerivative(vector<int>(order, 0), xvec),
+                f.calcDerivative(x[i], order), 1e-9, __FILE__, __LINE__,
+                f.getConcreteClassName() + ": calcDerivative(double, int) "
+                "differs.");
+        }
+    }
+}
+
+// Compare calcValueNear() to calcValue(), with one interval kept across
+// increasing and decreasing arguments, and with invalid initial intervals.
+void testIntervalEvaluation(const Function& f)
+{
+    SimTK::Vector x(61);
+    for (int i = 0; i < 41; ++i) x[i] = -1.0 + 0.3*i;
+    for (int i = 41; i < 61; ++i) x[i] = 11.0 - 0.55*(i - 41);
+    x[10] = 2.0; x[11] = 5.0; x[50] = 0.0;
+
+    for (int initial : {0, -5, 100}) {
+        int interval = initial;
+        for (int i = 0; i < x.size(); ++i) {
+            ASSERT_EQUAL(f.calcValue(x[i]), f.calcValueNear(x[i], interval),
+                1e-12, __FILE__, __LINE__,
+                f.getConcreteClassName() + ": calcValueNear() differs.");
+        }
+        interval = initial;
+        for (int i = 0; i < x.size(); ++i) {
+            const SimTK::Vec3 found =
+                f.calcValueAndDerivativesNear(x[i], interval);
+            ASSERT_EQUAL(f.calcValue(x[i]), found[0], 1e-12, __FILE__,
+                __LINE__, f.getConcreteClassName() +
+                ": calcValueAndDerivativesNear() differs.");
+            for (int order = 1; order <= 2; ++order) {
+                if (order > f.getMaxDerivativeOrder()) continue;
+                ASSERT_EQUAL(f.calcDerivative(x[i], order), found[order],
+                    1e-9, __FILE__, __LINE__, f.getConcreteClassName() +
+                    ": calcValueAndDerivativesNear() differs.");
+            }
+        }
+    }
+}
+
+// Compare the values and derivatives of the functions of a FunctionGroup,
+// requested in any order and through SimTK::Functions, to those of the
+// functions alone, also after one of them is modified.
+void testFunctionGroup(SimmSpline& simm, const Function& other)
+{
+    auto group = std::make_shared<FunctionGroup>();
+    ASSERT(group->addFunction(simm) == 0, __FILE__, __LINE__,
+        "Expected the first function at index 0.");
+    ASSERT(group->addFunction(other) == 1, __FILE__, __LINE__,
+        "Expected the second function at index 1.");
+    std::unique_ptr<SimTK::Function> scaled(
+        FunctionGroup::createSimTKFunction(group, 1, -2.0));
+
+    const auto compare = [&](double x) {
+        for (int index : {1, 0}) {
+            const Function& f = index == 0 ? (const Function&)simm : other;
+            const SimTK::Vec3 found = group->calcValueAndDerivatives(index, x);
+            ASSERT_EQUAL(f.calcValue(x), found[0], 1e-12, __FILE__, __LINE__,
+                "FunctionGroup: value differs.");
+            ASSERT_EQUAL(f.calcDerivative(x, 1), found[1], 1e-9, __FILE__,
+                __LINE__, "FunctionGroup: first derivative differs.");
+            ASSERT_EQUAL(f.calcDerivative(x, 2), found[2], 1e-9, __FILE__,
+                __LINE__, "FunctionGroup: second derivative differs.");
+        }
+        const SimTK::Vector xvec(1, x);
+        ASSERT_EQUAL(-2.0*other.calcValue(x), scaled->calcValue(xvec), 1e-12,
+            __FILE__, __LINE__, "FunctionGroup: SimTK::Function differs.");
+        ASSERT_EQUAL(-2.0*other.calcDerivative(x, 2),
+            scaled->calcDerivative(SimTK::Array_<int>(2, 0), xvec), 1e-9,
+            __FILE__, __LINE__, "FunctionGroup: SimTK::Function differs.");
+    };
+    for (double x : {-1.0, 0.3, 0.3, 2.2, 2.0, 6.1, 11.0})
+        compare(x);
+
+    // The kept results are not used once a function is modified.
+    simm.setY(3, 1.5);
+    compare(6.1);
+}
+
+int main()
+{
+    try {
+        double x[] = {0.0, 1.0, 2.0, 2.5, 5.0, 7.0, 10.0};
+        double y[] = {0.5, 0.7, 2.0, -1.0, 0.5, 0.3, 0.1};
+
+        SimmSpline simm(7, x, y);
+        testScalarEvaluation(simm, 2);
+        testScalarEvaluation(SimmSpline(2, x, y), 2);
+        testScalarEvaluation(GCVSpline(5, 7, x, y), 2);
+        testScalarEvaluation(PiecewiseLinearFunction(7, x, y), 1);
+        testScalarEvaluation(LinearFunction(-0.7, 2.5), 2);
+        double coefficients[] = {0.1, -1.0, 3.0, 2.0};
+        testScalarEvaluation(
+            PolynomialFunction(SimTK::Vector(4, coefficients)), 4);
+        testScalarEvaluation(Constant(3.5), 2);
+        testScalarEvaluation(MultiplierFunction(simm.clone(), -2.0), 2);
+
+        testIntervalEvaluation(simm);
+        testIntervalEvaluation(SimmSpline(2, x, y));
+        testIntervalEvaluation(PiecewiseLinearFunction(7, x, y));
+        testIntervalEvaluation(PiecewiseConstantFunction(7, x, y));
+        testIntervalEvaluation(GCVSpline(5, 7, x, y));
+        testIntervalEvaluation(LinearFunction(-0.7, 2.5));
+
+        testFunctionGroup(simm, GCVSpline(5, 7, x, y));
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -20,14 +20,145 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/Storage.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
 using namespace std;
 
+// Fit a set of splines to successive windows of data appended to a Storage.
+void testFitWindow() {
+    Storage store;
+    Array<string> labels;
+    labels.append("time");
+    labels.append("sin");
+    labels.append("cos");
+    store.setColumnLabels(labels);
+    const double dt = 0.01;
+    for (int i = 0; i <= 50; ++i) {
+        double y[2] = { sin(dt*i), cos(dt*i) };
+        store.append(dt*i, 2, y);
+    }
+
+    GCVSplineSet splines(5, &store);
+    const Function* sinSpline = &splines.get("sin");
+
+    // Stream more data and fit the splines to the latest frames only.
+    for (int i = 51; i <= 200; ++i) {
+        double y[2] = { sin(dt*i), cos(dt*i) };
+        store.append(dt*i, 2, y);
+    }
+    splines.fitWindow(store, 1.495, 2.005);
+    ASSERT(&splines.get("sin") == sinSpline, __FILE__, __LINE__,
+        "Expected the splines to be fit again in place.");
+    ASSERT_EQUAL(1.5, splines.getMinX(), 1e-10, __FILE__, __LINE__);
+    ASSERT_EQUAL(2.0, splines.getMaxX(), 1e-10, __FILE__, __LINE__);
+    for (double t = 1.5; t <= 2.0; t += 0.005) {
+        SimTK::Vector x(1, t);
+        ASSERT_EQUAL(sin(t), splines.get("sin").calcValue(x), 1e-4,
+            __FILE__, __LINE__);
+        ASSERT_EQUAL(cos(t), splines.get("cos").calcValue(x), 1e-4,
+            __FILE__, __LINE__);
+    }
+
+    // There must be enough frames in the window for the degree.
+    ASSERT_THROW(OpenSim::Exception, splines.fitWindow(store, 1.495, 1.525));
+
+    // Assigning a spline also replaces the fit.
+    GCVSpline copy = *splines.getGCVSpline(0);
+    copy.calcValue(SimTK::Vector(1, 1.75));
+    const double xs[6] = { 0, 1, 2, 3, 4, 5 };
+    const double ys[6] = { 1, 1, 1, 1, 1, 1 };
+    copy = GCVSpline(5, 6, xs, ys);
+    ASSERT_EQUAL(1.0, copy.calcValue(SimTK::Vector(1, 0.0)), 1e-10,
+        __FILE__, __LINE__);
+}
+
+// Compare the evaluation of a whole set to that of each of its functions.
+void compareSetToFunctions(const GCVSplineSet& splines) {
+    Array<double> values;
+    SimTK::Vector q, u, udot;
+    for (double t = -0.2; t <= 2.3; t += 0.0173) {
+        for (int order = 0; order <= 3; ++order) {
+            splines.evaluate(values, order, t);
+            ASSERT(values.getSize() == splines.getSize(), __FILE__, __LINE__);
+            for (int i = 0; i < splines.getSize(); ++i) {
+                ASSERT_EQUAL(splines.evaluate(i, order, t), values[i], 1e-9,
+                    __FILE__, __LINE__, "evaluate() of the set differs.");
+            }
+        }
+        splines.evaluateWithDerivatives(t, q, u, udot);
+        for (int i = 0; i < splines.getSize(); ++i) {
+            ASSERT_EQUAL(splines.evaluate(i, 0, t), q[i], 1e-9,
+                __FILE__, __LINE__);
+            ASSERT_EQUAL(splines.evaluate(i, 1, t), u[i], 1e-9,
+                __FILE__, __LINE__);
+            ASSERT_EQUAL(splines.evaluate(i, 2, t), udot[i], 1e-9,
+                __FILE__, __LINE__);
+        }
+    }
+}
+
+// Evaluate all the splines of a set at once, as the set changes.
+void testBatchEvaluation() {
+    Storage store;
+    Array<string> labels;
+    labels.append("time");
+    for (int j = 0; j < 6; ++j) labels.append("q" + to_string(j));
+    store.setColumnLabels(labels);
+    const double dt = 0.01;
+    for (int i = 0; i <= 200; ++i) {
+        double y[6];
+        for (int j = 0; j < 6; ++j) y[j] = sin((j + 1)*dt*i) + 0.1*j;
+        store.append(dt*i, 6, y);
+    }
+
+    // Fitting on several threads gives the same splines.
+    GCVSplineSet splines(5, &store, 0.0, 3);
+    GCVSplineSet serialSplines(5, &store, 0.0, 1);
+    for (int i = 0; i < splines.getSize(); ++i) {
+        ASSERT_EQUAL(serialSplines.evaluate(i, 0, 0.503),
+            splines.evaluate(i, 0, 0.503), 1e-15, __FILE__, __LINE__);
+    }
+    compareSetToFunctions(splines);
+
+    // Splines of another degree or with other knots, and other functions.
+    const int n = 30;
+    double x[n], y[n];
+    for (int i = 0; i < n; ++i) {
+        x[i] = 0.07*i;
+        y[i] = cos(x[i]);
+    }
+    splines.adoptAndAppend(new GCVSpline(3, n, x, y, "cubic"));
+    splines.adoptAndAppend(new GCVSpline(5, n, x, y, "other_knots"));
+    splines.adoptAndAppend(new Constant(0.25));
+    compareSetToFunctions(splines);
+
+    // Changes to the splines themselves.
+    splines.fitWindow(store, 0.5, 1.5);
+    compareSetToFunctions(splines);
+    const double xs[6] = { 0, 1, 2, 3, 4, 5 };
+    const double ys[6] = { 1, 2, 1, 2, 1, 2 };
+    splines.getGCVSpline(2)->setPoints(6, xs, ys);
+    compareSetToFunctions(splines);
+    splines.remove(0);
+    compareSetToFunctions(splines);
+
+    // A copy of the set evaluates its own splines.
+    GCVSplineSet copy(splines);
+    copy.getGCVSpline(0)->setPoints(6, xs, ys);
+    compareSetToFunctions(copy);
+    compareSetToFunctions(splines);
+}
+
 int main() {
     try {
+        testFitWindow();
+        testBatchEvaluation();
+
         const int size = 100;
         double x[size], y[size];
         for (int i = 0; i < size; ++i) {
@@ -0,0 +1,114 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  testLogger.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/LogManager.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace OpenSim;
+
+// Collects the lines written to a LogBuffer.
+class CollectingLogCallback : public LogCallback {
+public:
+    void log(const std::string& str) override { lines.push_back(str); }
+    std::vector<std::string> lines;
+};
+
+int countContaining(const std::vector<std::string>& lines,
+                    const std::string& text) {
+    int count = 0;
+    for (const auto& line : lines)
+        if (line.find(text) != std::string::npos) ++count;
+    return count;
+}
+
+void warnRepeatedly() {
+    for (int i = 0; i < 1000; ++i)
+        OPENSIM_WARN("testRateLimit warning " << i);
+}
+
+void testRateLimit() {
+    auto* err = new CollectingLogCallback();
+    LogManager::err.addLogCallback(err);
+
+    Logger::setMaxMessagesPerSecond(5);
+    warnRepeatedly();
+    Logger::flush();
+    ASSERT(countContaining(err->lines, "testRateLimit warning") == 5);
+    ASSERT(countContaining(err->lines, "testRateLimit warning 4") == 1);
+
+    // Each site has its own limit.
+    OPENSIM_WARN("testRateLimit other site");
+    Logger::flush();
+    ASSERT(countContaining(err->lines, "testRateLimit other site") == 1);
+
+    // After a second, the site may write again, and reports the number of
+    // messages that were dropped.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    warnRepeatedly();
+    Logger::flush();
+    ASSERT(countContaining(err->lines, "testRateLimit warning") == 10);
+    ASSERT(countContaining(err->lines, "995 similar messages") == 1);
+
+    Logger::setMaxMessagesPerSecond(10);
+    LogManager::err.removeLogCallback(err);
+    delete err;
+}
+
+void testLevels() {
+    auto* out = new CollectingLogCallback();
+    LogManager::out.addLogCallback(out);
+
+    int formatted = 0;
+    auto format = [&formatted]() { ++formatted; return "x"; };
+
+    Logger::setLevel(Logger::Level::Warn);
+    OPENSIM_INFO("testLevels info " << format());
+    Logger::setLevel(Logger::Level::Info);
+    OPENSIM_DEBUG("testLevels debug " << format());
+    OPENSIM_INFO("testLevels info " << format());
+    Logger::flush();
+    // Messages that are not written are not formatted.
+    ASSERT(formatted == 1);
+    ASSERT(countContaining(out->lines, "testLevels info") == 1);
+
+    // Synchronous messages are written before log() returns.
+    Logger::setAsynchronous(false);
+    OPENSIM_INFO("testLevels synchronous");
+    ASSERT(countContaining(out->lines, "testLevels synchronous") == 1);
+    Logger::setAsynchronous(true);
+
+    LogManager::out.removeLogCallback(out);
+    delete out;
+}
+
+int main() {
+    SimTK_START_TEST("testLogger");
+        SimTK_SUBTEST(testRateLimit);
+        SimTK_SUBTEST(testLevels);
+    SimTK_END_TEST();
+}
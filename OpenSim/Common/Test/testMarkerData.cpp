@@ -55,6 +55,49 @@ void testSTOFileAdapterWithMarkerData() {
     std::remove(filename.c_str());
 }
 
+// Make MarkerData from a table in memory, and average its frames, skipping
+// frames in which a marker is missing.
+void testMarkerDataFromTable() {
+    TimeSeriesTable_<SimTK::Vec3> table{};
+    table.setColumnLabels({"m0", "m1"});
+    const SimTK::Vec3 nan{SimTK::NaN};
+    table.appendRow(0.0, {SimTK::Vec3{1, 2, 3}, nan});
+    table.appendRow(0.1, {SimTK::Vec3{3, 2, 1}, SimTK::Vec3{4, 4, 4}});
+    table.appendRow(0.2, {SimTK::Vec3{2, 2, 2}, SimTK::Vec3{6, 6, 6}});
+    table.updTableMetaData().setValueForKey("DataRate", std::string{"10"});
+    table.updTableMetaData().setValueForKey("Units", std::string{"mm"});
+
+    MarkerData md{table};
+    ASSERT(md.getNumFrames() == 3, __FILE__, __LINE__);
+    ASSERT(md.getNumMarkers() == 2, __FILE__, __LINE__);
+    ASSERT(md.getDataRate() == 10., __FILE__, __LINE__);
+    ASSERT(md.getFrameTime(2) == 0.2, __FILE__, __LINE__);
+    ASSERT(md.getUnits().getType() == Units::Millimeters, __FILE__, __LINE__);
+    for(int f = 0; f < md.getNumFrames(); ++f)
+        for(int m = 0; m < md.getNumMarkers(); ++m) {
+            const SimTK::Vec3& location = md.getMarker(f, m);
+            const SimTK::Vec3& expected = table.getRowAtIndex(f)[m];
+            ASSERT(location.isNaN() ? expected.isNaN() : location == expected,
+                   __FILE__, __LINE__);
+            ASSERT(md.getFrame(f).getMarker(m) == location ||
+                   location.isNaN(), __FILE__, __LINE__);
+        }
+
+    md.averageFrames();
+    ASSERT(md.getNumFrames() == 1, __FILE__, __LINE__);
+    ASSERT(md.getStartFrameTime() == 0.0, __FILE__, __LINE__);
+    ASSERT((md.getMarker(0, 0) - SimTK::Vec3{2, 2, 2}).norm() < 1e-12,
+           __FILE__, __LINE__);
+    ASSERT((md.getMarker(0, 1) - SimTK::Vec3{5, 5, 5}).norm() < 1e-12,
+           __FILE__, __LINE__);
+    ASSERT(md.getFrame(0).getMarker(1) == md.getMarker(0, 1),
+           __FILE__, __LINE__);
+
+    md.convertToUnits(Units(Units::Meters));
+    ASSERT((md.getMarker(0, 1) - SimTK::Vec3{0.005}).norm() < 1e-12,
+           __FILE__, __LINE__);
+}
+
 int main() {
     // Create a storage from a std file "std_storage.sto"
     try {
@@ -110,6 +153,7 @@ int main() {
         ASSERT(diff.norm() < 1e-7, __FILE__, __LINE__);
 
         testSTOFileAdapterWithMarkerData();
+        testMarkerDataFromTable();
     }
     catch(const Exception& e) {
         e.print(cerr);
@@ -24,6 +24,8 @@
 #include <OpenSim/Common/ComponentPath.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
+#include <unordered_set>
+
 /* The purpose of this test is strictly to check that classes derived from
  * the Path class work outside of the objects/components they are meant to 
  * service (i.e. check that the path logic works).
@@ -139,6 +141,16 @@ void testComponentPath() {
     // now it should match absPath1 ("/a/b/c/d")
     ASSERT(path1 == absPath1);
 
+    /* Test that equal paths, however they were formed, have equal hashes and
+     * can be found in an unordered container. */
+    ASSERT(path1.getHash() == absPath1.getHash());
+    ASSERT(oddPath1.getHash() == absPath3.getHash());
+    ASSERT(ComponentPath("a/b").getHash() != ComponentPath("/a/b").getHash());
+    std::unordered_set<ComponentPath> paths{absPath1, absPath3, relPath1};
+    ASSERT(paths.count(path1) == 1);
+    ASSERT(paths.count(oddPath2) == 1);
+    ASSERT(paths.count(ComponentPath("/c/d")) == 0);
+
     /* Test invalid characters in pushBack(). Unlike the invalid
      * character test above, "/" should be considered invalid since
      * pushBack() cannot add multiple levels at once. It is also 
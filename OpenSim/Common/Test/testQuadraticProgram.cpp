@@ -0,0 +1,170 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testQuadraticProgram.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Tests OptimizationTarget::SolveQuadraticProgram(), which minimizes
+// sum(weights[i]*x[i]^2) subject to A*x + b = 0 and bounds on x.
+
+#include <OpenSim/Common/OptimizationTarget.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <vector>
+
+using namespace OpenSim;
+using SimTK::Matrix;
+using SimTK::Vector;
+
+namespace {
+const double Tol = 1e-10;
+
+void assertSolution(const Vector& expected, const Vector& x) {
+    ASSERT(x.size() == expected.size());
+    for (int i = 0; i < x.size(); ++i)
+        ASSERT_EQUAL(expected[i], x[i], Tol);
+}
+
+void assertActiveBounds(const std::vector<int>& expected,
+                        const Array<int>& active) {
+    ASSERT(active.getSize() == (int)expected.size());
+    for (int i = 0; i < active.getSize(); ++i)
+        ASSERT(active[i] == expected[i]);
+}
+}
+
+// With inactive bounds, the solution is the weighted minimum-norm solution
+// of the constraints: x[i] proportional to 1/weights[i].
+void testUnconstrainedMinimumNorm() {
+    const double w[] = {1, 2, 4};
+    const double a[] = {1, 1, 1};
+    Vector weights(3, w), b(1, -3.0), x(3, 0.0);
+    Matrix A(1, 3, a);
+    Vector lower(3, -10.0), upper(3, 10.0);
+    Array<int> active;
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, A, b,
+                lower, upper, active, x));
+    const double expected[] = {12./7, 6./7, 3./7};
+    assertSolution(Vector(3, expected), x);
+    assertActiveBounds({0, 0, 0}, active);
+}
+
+// The minimum-norm solution (1, 1, 1) violates the lower bound of x[0] and
+// the upper bound of x[2]; the multipliers of both bounds have the right
+// sign at (1.5, 1, 0.5).
+void testActiveBounds() {
+    const double a[] = {1, 1, 1};
+    const double l[] = {1.5, -10, -10};
+    const double u[] = {10, 10, 0.5};
+    Vector weights(3, 1.0), b(1, -3.0), x(3, 0.0);
+    Matrix A(1, 3, a);
+    Vector lower(3, l), upper(3, u);
+    Array<int> active;
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, A, b,
+                lower, upper, active, x));
+    const double expected[] = {1.5, 1, 0.5};
+    assertSolution(Vector(3, expected), x);
+    assertActiveBounds({-1, 0, 1}, active);
+
+    // Starting from the solution, it is found again.
+    Vector xWarm(3, 0.0);
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, A, b,
+                lower, upper, active, xWarm));
+    assertSolution(Vector(3, expected), xWarm);
+    assertActiveBounds({-1, 0, 1}, active);
+
+    // A wrong first guess is corrected.
+    Array<int> wrong(0, 3);
+    wrong[0] = 1;
+    wrong[1] = 1;
+    Vector xWrong(3, 0.0);
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, A, b,
+                lower, upper, wrong, xWrong));
+    assertSolution(Vector(3, expected), xWrong);
+    assertActiveBounds({-1, 0, 1}, wrong);
+
+    // A first guess of the wrong size is ignored.
+    Array<int> wrongSize(1, 2);
+    Vector xWrongSize(3, 0.0);
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, A, b,
+                lower, upper, wrongSize, xWrongSize));
+    assertSolution(Vector(3, expected), xWrongSize);
+    assertActiveBounds({-1, 0, 1}, wrongSize);
+}
+
+// Without a solution, false is returned and neither x nor the active bounds
+// are changed.
+void testInfeasible() {
+    const double a[] = {1, 1};
+    Vector weights(2, 1.0), x(2, 7.0);
+    Matrix A(1, 2, a);
+    Array<int> active(0, 2);
+    active[1] = -1;
+
+    // The bounds do not allow x[0] + x[1] = 5.
+    ASSERT(!OptimizationTarget::SolveQuadraticProgram(weights, A,
+                Vector(1, -5.0), Vector(2, 0.0), Vector(2, 1.0), active, x));
+    assertSolution(Vector(2, 7.0), x);
+    assertActiveBounds({0, -1}, active);
+
+    // The constraints contradict each other.
+    const double a2[] = {1, 1,
+                         1, 1};
+    const double b2[] = {-1, -2};
+    ASSERT(!OptimizationTarget::SolveQuadraticProgram(weights, Matrix(2, 2, a2),
+                Vector(2, b2), Vector(2, -10.0), Vector(2, 10.0), active, x));
+    assertSolution(Vector(2, 7.0), x);
+    assertActiveBounds({0, -1}, active);
+
+    // The weights must be positive.
+    const double w[] = {1, 0};
+    ASSERT(!OptimizationTarget::SolveQuadraticProgram(Vector(2, w), A,
+                Vector(1, -1.0), Vector(2, -10.0), Vector(2, 10.0), active, x));
+    assertSolution(Vector(2, 7.0), x);
+}
+
+// Redundant constraints (A of rank 1) have the same solution as one of them.
+void testRankDeficient() {
+    const double a[] = {1, 1,
+                        2, 2};
+    const double b[] = {-1, -2};
+    Vector weights(2, 1.0), x(2, 0.0);
+    Array<int> active;
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, Matrix(2, 2, a),
+                Vector(2, b), Vector(2, -10.0), Vector(2, 10.0), active, x));
+    assertSolution(Vector(2, 0.5), x);
+    assertActiveBounds({0, 0}, active);
+
+    // Also with a bound active.
+    const double u[] = {10, 0.25};
+    ASSERT(OptimizationTarget::SolveQuadraticProgram(weights, Matrix(2, 2, a),
+                Vector(2, b), Vector(2, -10.0), Vector(2, u), active, x));
+    const double expected[] = {0.75, 0.25};
+    assertSolution(Vector(2, expected), x);
+    assertActiveBounds({0, 1}, active);
+}
+
+int main() {
+    SimTK_START_TEST("testQuadraticProgram");
+        SimTK_SUBTEST(testUnconstrainedMinimumNorm);
+        SimTK_SUBTEST(testActiveBounds);
+        SimTK_SUBTEST(testInfeasible);
+        SimTK_SUBTEST(testRankDeficient);
+    SimTK_END_TEST();
+}
@@ -62,13 +62,22 @@ int main()
         Array<double> a(-1.0,N), b(1.0,N), tol(1.0e-6,N);
         Array<double> roots(0.0,N);
         RootSolver solver(&function);
-        //roots = solver.solve(a,b,tol);  NOTE: JACKM need to pass in state or change CMC 
+        SimTK::State s;
+        roots = solver.solve(s,a,b,tol);
         cout<<endl<<endl<<"-------------"<<endl;
         cout<<"roots:\n";
         cout<<roots<<endl<<endl;
         for (int i=0; i <= 100; i++){
-            //ASSERT_EQUAL(i*0.01, roots[i], 1e-6);
+            ASSERT_EQUAL(i*0.01, roots[i], 1e-5);
         }
+
+        // Roots are found in different numbers of iterations; those found
+        // are no longer evaluated.
+        cout << "evaluations: " << function.getNumEvaluations()
+             << ", entries evaluated: " << function.getNumEntriesEvaluated()
+             << endl;
+        ASSERT(function.getNumEntriesEvaluated() <
+               N*function.getNumEvaluations());
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -25,6 +25,7 @@
 #include <unordered_set>
 #include <fstream>
 #include <cstdio>
+#include <cmath>
 
 std::string getNextToken(std::istream& stream, 
                          const std::string& delims) {
@@ -184,6 +185,97 @@ void testReadingWriting() {
     std::remove(fileB.c_str());
 }
 
+void testParsingRows() {
+    using namespace OpenSim;
+
+    std::string filename{"testSTOFileAdapter_rows.sto"};
+    TimeSeriesTable_<SimTK::Vec3> table{};
+    table.setColumnLabels({"c0", "c1"});
+    for(int i = 0; i < 5; ++i) {
+        const double t{0.5 * i};
+        table.appendRow(t, {SimTK::Vec3{t, -t, 1e-3 * t},
+                            SimTK::Vec3{2 * t, 3.25, -1.5e2}});
+    }
+    STOFileAdapter_<SimTK::Vec3>::write(table, filename);
+
+    auto table_copy = STOFileAdapter_<SimTK::Vec3>::read(filename);
+    if(table_copy.getNumRows() != table.getNumRows() ||
+       table_copy.getNumColumns() != table.getNumColumns())
+        throw Exception{"Table read from file has the wrong number of "
+                        "rows/columns."};
+    for(size_t r = 0; r < table.getNumRows(); ++r) {
+        if(table_copy.getIndependentColumn()[r] !=
+           table.getIndependentColumn()[r])
+            throw Exception{"Incorrect time read from file."};
+        for(int c = 0; c < 2; ++c)
+            for(int k = 0; k < 3; ++k)
+                if(std::abs(table_copy.getRowAtIndex(r)[c][k] -
+                            table.getRowAtIndex(r)[c][k]) > 1e-6)
+                    throw Exception{"Incorrect element read from file."};
+    }
+
+    // Append a row with an element that is missing a component.
+    {
+        std::ofstream out{filename, std::ios_base::app};
+        out << "3\t1,2\t4,5,6\n";
+    }
+    try {
+        STOFileAdapter_<SimTK::Vec3>::read(filename);
+        throw Exception{"Expected IncorrectNumTokens for a malformed row."};
+    } catch(IncorrectNumTokens&) {}
+
+    std::remove(filename.c_str());
+}
+
+void testReadingColumns() {
+    using namespace OpenSim;
+
+    std::string filename{"testSTOFileAdapter_columns.sto"};
+    TimeSeriesTable_<SimTK::Vec3> table{};
+    table.setColumnLabels({"r_knee", "l_knee", "r_hip", "l_hip"});
+    for(int i = 0; i < 5; ++i)
+        table.appendRow(0.1 * i, {SimTK::Vec3{i, 0, 0}, SimTK::Vec3{0, i, 0},
+                                  SimTK::Vec3{0, 0, i}, SimTK::Vec3{i, i, i}});
+    STOFileAdapter_<SimTK::Vec3>::write(table, filename);
+
+    // By labels, in the given order.
+    auto subset = STOFileAdapter_<SimTK::Vec3>::readColumns(filename,
+                                                    {"r_hip", "r_knee"});
+    if(subset.getColumnLabels() != 
+            std::vector<std::string>{"r_hip", "r_knee"} ||
+       subset.getNumRows() != table.getNumRows())
+        throw Exception{"Unexpected columns when reading a selection."};
+    for(size_t r = 0; r < table.getNumRows(); ++r)
+        if(subset.getRowAtIndex(r)[0] != table.getRowAtIndex(r)[2] ||
+           subset.getRowAtIndex(r)[1] != table.getRowAtIndex(r)[0])
+            throw Exception{"Incorrect element read for a selection."};
+
+    // By regular expression, in the order of the file.
+    auto left = STOFileAdapter_<SimTK::Vec3>::readColumns(filename,
+                                        ColumnSelection::matching("l_.*"));
+    if(left.getColumnLabels() != std::vector<std::string>{"l_knee", "l_hip"})
+        throw Exception{"Unexpected columns when reading a pattern."};
+    for(size_t r = 0; r < table.getNumRows(); ++r)
+        if(left.getRowAtIndex(r)[1] != table.getRowAtIndex(r)[3])
+            throw Exception{"Incorrect element read for a pattern."};
+
+    try {
+        STOFileAdapter_<SimTK::Vec3>::readColumns(filename, {"r_ankle"});
+        throw Exception{"Expected KeyNotFound for a missing column."};
+    } catch(KeyNotFound&) {}
+
+    // Rows in a time range, of some of the columns.
+    auto window = STOFileAdapter_<SimTK::Vec3>::readTimeRange(filename,
+                                                0.15, 0.35, {"l_hip"});
+    if(window.getNumRows() != 2 || window.getNumColumns() != 1)
+        throw Exception{"Unexpected size of the rows read in a time range."};
+    for(size_t r = 0; r < window.getNumRows(); ++r)
+        if(window.getRowAtIndex(r)[0] != table.getRowAtIndex(r + 2)[3])
+            throw Exception{"Incorrect element read in a time range."};
+
+    std::remove(filename.c_str());
+}
+
 int main() {
     using namespace OpenSim;
 
@@ -218,6 +310,25 @@ int main() {
         compareFiles(filename, tmpfile);
     }
 
+    std::cout << "Testing FileAdapter::readFileAsync()" << std::endl;
+    {
+        std::vector<std::future<DataAdapter::OutputTables>> futures{};
+        for(const auto& filename : filenames)
+            futures.push_back(FileAdapter::readFileAsync(filename));
+        for(size_t i = 0; i < filenames.size(); ++i) {
+            std::cout << "  " << filenames[i] << std::endl;
+            auto table = futures[i].get().at("table");
+            DataAdapter::InputTables tables{};
+            tables.emplace(std::string{"table"}, table.get());
+            FileAdapter::writeFile(tables, tmpfile);
+            compareFiles(filenames[i], tmpfile);
+        }
+        try {
+            FileAdapter::readFileAsync("no_such_file.sto").get();
+            throw Exception{"Expected an error reading a missing file."};
+        } catch(const FileDoesNotExist&) {}
+    }
+
     std::cout << "Testing TimeSeriesTable and STOFileAdapter::write()"
               << std::endl;
     for(const auto& filename : filenames) {
@@ -253,6 +364,11 @@ int main() {
     std::cout << "Testing reading/writing STOFileAdapter_<SimTK::SpatialVec>"
               << std::endl;
     testReadingWriting<SimTK::SpatialVec>();
+    std::cout << "Testing parsing of rows by STOFileAdapter_<SimTK::Vec3>"
+              << std::endl;
+    testParsingRows();
+    std::cout << "Testing reading a selection of the columns" << std::endl;
+    testReadingColumns();
     std::cout << "\nAll tests passed!" << std::endl;
 
 
@@ -0,0 +1,91 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testScratchArena.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Common/ScratchArena.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <cstdint>
+
+using namespace OpenSim;
+
+void testAllocate() {
+    ScratchArena arena;
+    ASSERT(arena.getCapacity() == 0);
+    ASSERT(arena.getNumBytesInUse() == 0);
+
+    double* values = arena.allocate<double>(10, 1.5);
+    for (int i = 0; i < 10; ++i) ASSERT(values[i] == 1.5);
+    ASSERT(reinterpret_cast<std::uintptr_t>(values) % alignof(double) == 0);
+    char* letters = arena.allocate<char>(3);
+    int* counts = arena.allocate<int>(5, 7);
+    ASSERT(reinterpret_cast<std::uintptr_t>(counts) % alignof(int) == 0);
+    // The earlier allocations are left untouched.
+    for (int i = 0; i < 10; ++i) ASSERT(values[i] == 1.5);
+    ASSERT(letters + 3 <= reinterpret_cast<char*>(counts));
+    ASSERT(arena.getNumBytesInUse() >= 10*sizeof(double) + 3 + 5*sizeof(int));
+
+    // After a reset, the same memory is handed out again.
+    arena.reset();
+    ASSERT(arena.getNumBytesInUse() == 0);
+    ASSERT(arena.allocate<double>(10) == values);
+}
+
+void testGrowth() {
+    ScratchArena arena;
+    arena.allocate<double>(100);
+    const std::size_t first = arena.getCapacity();
+    // Requests that do not fit in the first block go to new blocks.
+    while (arena.getNumBlocks() < 3) arena.allocate<double>(100);
+    const std::size_t capacity = arena.getCapacity();
+    const std::size_t inUse = arena.getNumBytesInUse();
+    ASSERT(capacity > first);
+
+    // The blocks are replaced by one that holds all of them, in which the
+    // same requests fit.
+    arena.reset();
+    ASSERT(arena.getNumBlocks() == 1);
+    ASSERT(arena.getCapacity() == capacity);
+    while (arena.getNumBytesInUse() < inUse) arena.allocate<double>(100);
+    ASSERT(arena.getNumBlocks() == 1);
+}
+
+void testScope() {
+    ScratchArena arena;
+    double* outer = arena.allocate<double>(4);
+    const std::size_t inUse = arena.getNumBytesInUse();
+    {
+        ScratchArena::Scope scope(arena);
+        arena.allocate<double>(1000);
+        ASSERT(arena.getNumBytesInUse() > inUse);
+    }
+    ASSERT(arena.getNumBytesInUse() == inUse);
+    ASSERT(arena.allocate<double>(4) == outer + 4);
+}
+
+int main() {
+    SimTK_START_TEST("testScratchArena");
+        SimTK_SUBTEST(testAllocate);
+        SimTK_SUBTEST(testGrowth);
+        SimTK_SUBTEST(testScope);
+    SimTK_END_TEST();
+}
@@ -32,11 +32,15 @@
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/Set.h>
+#include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/Common/XMLWriter.h>
 
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include "SimTKcommon.h"
 
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include "SerializableObject.h"
@@ -63,6 +67,15 @@ public:
         constructProperty_list_SerializableObject();
     }
 };
+// Counts how many times it is default-constructed.
+class CountedObject : public Object {
+    OpenSim_DECLARE_CONCRETE_OBJECT(CountedObject, Object);
+public:
+    static int numConstructed;
+    CountedObject() { ++numConstructed; }
+};
+int CountedObject::numConstructed = 0;
+
 // Recursively dump out contents of an object and its properties.
 static void dumpObj(const Object& obj, int nSpaces) {
     indent(nSpaces);
@@ -81,6 +94,26 @@ static void dumpObj(const Object& obj, int nSpaces) {
     }
 }
 
+static std::string readFile(const std::string& fileName) {
+    std::ifstream file(fileName.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Object::print() streams the file; it must hold exactly the document that
+// updateXMLNode() builds.
+static void checkPrintMatchesDocument(const Object& obj,
+                                      const std::string& fileName) {
+    obj.print(fileName);
+    XMLDocument doc;
+    SimTK::Xml::Element root = doc.getRootElement();
+    obj.updateXMLNode(root);
+    doc.print(fileName + ".dom");
+    ASSERT(readFile(fileName) == readFile(fileName + ".dom"), __FILE__,
+           __LINE__, fileName + " differs from the XML document.");
+}
+
 int main()
 {
     stringstream ss(" hell there 1.234e5  -infinity");
@@ -111,6 +144,16 @@ int main()
    
 
     try {
+        // Array properties of doubles are parsed without a stream.
+        std::vector<double> parsed;
+        ASSERT(IO::ParseDoubles(" 1.234e5\t-Infinity\n0.5 NaN ", parsed),
+               __FILE__, __LINE__, "ParseDoubles");
+        ASSERT(parsed.size() == 4 && parsed[0] == 1.234e5 &&
+               parsed[1] == -SimTK::Infinity && parsed[2] == 0.5 &&
+               SimTK::isNaN(parsed[3]), __FILE__, __LINE__, "ParseDoubles");
+        ASSERT(!IO::ParseDoubles("1 2,3", parsed) && parsed.size() == 4,
+               __FILE__, __LINE__, "ParseDoubles should reject '2,3'");
+
         // TYPE REGISTRATION
         Object::registerType(SerializableObject());
         Object::registerType(SerializableObject2());
@@ -152,6 +195,29 @@ int main()
         //std::cout << (*p2) << std::endl;
         Object::setSerializeAllDefaults(true);
         obj3.print("roundtripDefaults.xml");
+        checkPrintMatchesDocument(obj3, "roundtripDefaultsStreamed.xml");
+        checkPrintMatchesDocument(obj1, "obj1Streamed.xml");
+        checkPrintMatchesDocument(obj1copy, "obj1copyStreamed.xml");
+
+        // Text is escaped, and doubles formatted without a stream, as in
+        // the XML document.
+        SerializableObject special(obj1);
+        special.setName("a&b <c> \"d\" 'e' &#x41;");
+        special.set_Test_Str_2("line 1\nline 2\t&amp;");
+        special.set_Test_Dbl_2(-0.0);
+        const double values[] = {0.1, -2.5e-310, 1e15, 123456789012345.,
+            -7, 1.0/3, 6.02214076e23, SimTK::NaN, -SimTK::Infinity};
+        for (double value : values) special.append_Test_DblArray_2(value);
+        special.set_Test_DblVec3_2(SimTK::Vec3(1, -0.5, 1e-7));
+        checkPrintMatchesDocument(special, "special.xml");
+        for (double value : values) {
+            std::ostringstream expected;
+            writeUnformatted(expected, value);
+            std::string text;
+            XMLWriter::appendDouble(text, value);
+            ASSERT(text == expected.str(), __FILE__, __LINE__,
+                   "Formatted " + expected.str() + " as " + text + ".");
+        }
 
         // Now compare object properties to make sure we're not reading and writing the file as just text!
         int numProperties1 = obj1.getPropertySet().getSize();
@@ -229,6 +295,89 @@ int main()
         ASSERT(loc == 1);
         int notFound = objWithListProp.getProperty_list_SerializableObject().findIndexForName("Third");
         ASSERT(notFound == -1);
+
+        // Copies share the values of simple properties until they change.
+        SerializableObject original;
+        for (int i = 0; i < 1000; ++i) original.append_Test_DblArray_2(i);
+        const double initial = original.get_Test_DblArray_2(0);
+        std::unique_ptr<SerializableObject> copy(original.clone());
+        ASSERT(*copy == original, __FILE__, __LINE__, "Clone differs.");
+        copy->set_Test_DblArray_2(0, initial - 1);
+        ASSERT(original.get_Test_DblArray_2(0) == initial, __FILE__, __LINE__,
+               "Changing a clone changed the original.");
+        ASSERT(copy->get_Test_DblArray_2(0) == initial - 1, __FILE__,
+               __LINE__, "Clone was not changed.");
+        ASSERT(!(*copy == original), __FILE__, __LINE__,
+               "Changed clone equals the original.");
+        // A reference from upd_ must not be able to change later copies.
+        double& first = original.upd_Test_DblArray_2(0);
+        std::unique_ptr<SerializableObject> copy2(original.clone());
+        first = initial + 1;
+        ASSERT(copy2->get_Test_DblArray_2(0) == initial, __FILE__, __LINE__,
+               "Writing through a reference changed a clone.");
+        ASSERT(original.get_Test_DblArray_2(0) == initial + 1, __FILE__,
+               __LINE__, "Writing through a reference failed.");
+        // Short lists are not shared, so their references keep following
+        // the property and outlive the clones.
+        SerializableObject few;
+        const double& dbl = few.get_Test_Dbl_2();
+        std::unique_ptr<SerializableObject> fewCopy(few.clone());
+        few.set_Test_Dbl_2(dbl + 1);
+        const double changed = few.get_Test_Dbl_2();
+        fewCopy.reset();
+        ASSERT(&dbl == &few.get_Test_Dbl_2() && dbl == changed, __FILE__,
+               __LINE__, "A reference to a single value did not follow it.");
+
+        // The objects of a large Set are read by several threads, in order.
+        Object::registerType(ObjSet());
+        ObjSet largeSet;
+        for (int i = 0; i < 100; ++i) {
+            SerializableObject obj;
+            obj.setName("Object" + std::to_string(i));
+            obj.set_Test_Int_2(i);
+            largeSet.cloneAndAppend(obj);
+        }
+        checkPrintMatchesDocument(largeSet, "largeSet.xml");
+        std::unique_ptr<Object> serial(
+                Object::makeObjectFromFile("largeSet.xml"));
+        Object::setNumDeserializationThreads(4);
+        std::unique_ptr<Object> parallel(
+                Object::makeObjectFromFile("largeSet.xml"));
+        Object::setNumDeserializationThreads(1);
+        const ObjSet& serialSet = dynamic_cast<const ObjSet&>(*serial);
+        const ObjSet& parallelSet = dynamic_cast<const ObjSet&>(*parallel);
+        ASSERT(parallelSet.getSize() == 100, __FILE__, __LINE__,
+               "Objects were lost reading a Set in parallel.");
+        for (int i = 0; i < 100; ++i) {
+            ASSERT(parallelSet.get(i).getName() == largeSet.get(i).getName(),
+                   __FILE__, __LINE__, "Objects read out of order.");
+            ASSERT(parallelSet.get(i) == serialSet.get(i), __FILE__, __LINE__,
+                   "Objects read in parallel differ.");
+        }
+
+        // The default object of a type registered by class is created when
+        // it is first needed.
+        Object::registerType<CountedObject>();
+        Object::renameType("OldCountedObject", "CountedObject");
+        Array<std::string> typeNames;
+        Object::getRegisteredTypenames(typeNames);
+        ASSERT(typeNames.findIndex("CountedObject") >= 0, __FILE__, __LINE__,
+               "CountedObject is not registered.");
+        ASSERT(CountedObject::numConstructed == 0, __FILE__, __LINE__,
+               "Registering a type created its default object.");
+        const Object* defaultObject =
+            Object::getDefaultInstanceOfType("OldCountedObject");
+        ASSERT(defaultObject != nullptr &&
+               defaultObject->getName() == Object::DEFAULT_NAME &&
+               CountedObject::numConstructed == 1, __FILE__, __LINE__,
+               "The default object was not created.");
+        ASSERT(Object::getDefaultInstanceOfType("CountedObject") ==
+               defaultObject && CountedObject::numConstructed == 1,
+               __FILE__, __LINE__, "The default object was created again.");
+        std::unique_ptr<Object> instance(
+            Object::newInstanceOfType("CountedObject"));
+        ASSERT(dynamic_cast<CountedObject*>(instance.get()) != nullptr,
+               __FILE__, __LINE__, "Wrong type of new instance.");
     }
     catch(const std::exception& e) {
         cerr << "EXCEPTION: " << e.what() << endl;
@@ -0,0 +1,124 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  testSet.cpp                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Check that looking up the members of a Set by name stays correct as the
+ * Set is modified and its members are renamed. */
+
+#include <OpenSim/Common/Set.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+Constant* makeConstant(const string& name, double value) {
+    Constant* c = new Constant(value);
+    c->setName(name);
+    return c;
+}
+
+void testLookupByName() {
+    Set<Function> set;
+    const int n = 100;
+    for (int i = 0; i < n; ++i)
+        set.adoptAndAppend(makeConstant("f" + to_string(i), i));
+
+    for (int i = 0; i < n; ++i) {
+        ASSERT(set.getIndex("f" + to_string(i)) == i);
+        ASSERT(set.contains("f" + to_string(i)));
+    }
+    ASSERT(set.getIndex("waldo") == -1);
+    ASSERT(!set.contains("waldo"));
+    ASSERT_THROW(OpenSim::Exception, set.get("waldo"));
+    ASSERT(set.get("f42").calcValue(SimTK::Vector(1, 0.0)) == 42);
+
+    // Removing and inserting shifts the indices of the other members.
+    set.remove(0);
+    ASSERT(set.getIndex("f0") == -1);
+    ASSERT(set.getIndex("f1") == 0);
+    set.insert(10, makeConstant("g", -1));
+    ASSERT(set.getIndex("g") == 10);
+    ASSERT(set.getIndex("f10") == 9);
+    ASSERT(set.getIndex("f11") == 11);
+
+    // Same size, different contents.
+    set.remove(set.getIndex("g"));
+    set.adoptAndAppend(makeConstant("h", -2));
+    ASSERT(set.getIndex("h") == n - 1);
+    ASSERT(set.getIndex("f11") == 10);
+
+    // Members renamed behind the Set's back are still found.
+    set.get(5).setName("renamed");
+    ASSERT(set.getIndex("renamed") == 5);
+    ASSERT(set.getIndex("f6") == -1);
+    set.get("renamed").setName("f6");
+    ASSERT(set.getIndex("f6") == 5);
+    ASSERT(set.getIndex("renamed") == -1);
+
+    // Duplicate names resolve to the first member with the name.
+    set.adoptAndAppend(makeConstant("f7", -3));
+    ASSERT(set.getIndex("f7") == 6);
+    ASSERT(set.getIndex("f7", 7) == set.getSize() - 1);
+
+    // Copies have their own index.
+    Set<Function> copy(set);
+    copy.remove(0);
+    ASSERT(copy.getIndex("f7") == 5);
+    ASSERT(set.getIndex("f7") == 6);
+    copy = set;
+    ASSERT(copy.getIndex("f7") == 6);
+
+    set.clearAndDestroy();
+    ASSERT(set.getIndex("f7") == -1);
+}
+
+void testGroups() {
+    Set<Function> set;
+    for (int i = 0; i < 10; ++i)
+        set.adoptAndAppend(makeConstant("f" + to_string(i), i));
+    set.addGroup("odd");
+    for (int i = 1; i < 10; i += 2)
+        set.addObjectToGroup("odd", "f" + to_string(i));
+
+    const ObjectGroup* odd = set.getGroup("odd");
+    ASSERT(odd->contains("f3"));
+    ASSERT(!odd->contains("f4"));
+
+    Array<string> groups;
+    set.getGroupNamesContaining("f5", groups);
+    ASSERT(groups.getSize() == 1 && groups[0] == "odd");
+
+    // setupGroups() matches the member names to the objects of the set.
+    Set<Function> copy(set);
+    copy.setupGroups();
+    ASSERT(copy.getGroup("odd")->getMembers().getSize() == 5);
+    ASSERT(copy.getGroup("odd")->getMembers()[0] == &copy.get("f1"));
+}
+
+int main() {
+    SimTK_START_TEST("testSet");
+        SimTK_SUBTEST(testLookupByName);
+        SimTK_SUBTEST(testGroups);
+    SimTK_END_TEST();
+
+    return 0;
+}
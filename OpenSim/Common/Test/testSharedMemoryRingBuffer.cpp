@@ -0,0 +1,114 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  testSharedMemoryRingBuffer.cpp                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Common/SharedMemoryRingBuffer.h>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace OpenSim;
+
+void testLayout() {
+    auto writer = SharedMemoryRingBuffer::create("testSharedMemoryLayout",
+                                                 {"a", "b/value"}, 8);
+    ASSERT(writer->isWriter());
+    auto reader = SharedMemoryRingBuffer::open("testSharedMemoryLayout");
+    ASSERT(!reader->isWriter());
+    ASSERT(reader->getNumValues() == 2);
+    ASSERT(reader->getCapacity() == 8);
+    ASSERT(reader->getLabels() ==
+           std::vector<std::string>({"a", "b/value"}));
+    ASSERT(reader->getNumRecordsWritten() == 0);
+
+    // Nothing has been written yet.
+    double time;
+    std::vector<double> values(2);
+    ASSERT(!reader->read(0, time, values.data()));
+
+    // The oldest records are overwritten once the ring is full.
+    for (int k = 0; k < 20; ++k) {
+        const double row[2] = {double(k), -double(k)};
+        writer->write(0.1*k, row);
+    }
+    ASSERT(reader->getNumRecordsWritten() == 20);
+    ASSERT(!reader->read(11, time, values.data()));
+    for (int k = 12; k < 20; ++k) {
+        ASSERT(reader->read(k, time, values.data()));
+        ASSERT_EQUAL(0.1*k, time, 1e-15);
+        ASSERT(values == std::vector<double>({double(k), -double(k)}));
+    }
+
+    // Only the creator writes.
+    ASSERT_THROW(Exception, reader->write(0, values.data()));
+
+    // The creator removes the shared memory.
+    writer.reset();
+    ASSERT_THROW(Exception,
+                 SharedMemoryRingBuffer::open("testSharedMemoryLayout"));
+    ASSERT_THROW(Exception, SharedMemoryRingBuffer::create("", {"a"}, 8));
+    ASSERT_THROW(Exception,
+                 SharedMemoryRingBuffer::create("testSharedMemory", {}, 0));
+}
+
+void testConcurrentReader() {
+    const int numRecords = 100000;
+    auto writer = SharedMemoryRingBuffer::create("testSharedMemoryConcurrent",
+                                                 {"x", "2x", "3x"}, 16);
+    auto reader = SharedMemoryRingBuffer::open("testSharedMemoryConcurrent");
+
+    // A reader polling the latest record never sees one written halfway.
+    std::atomic<bool> done(false);
+    int numRead = 0;
+    bool consistent = true;
+    std::thread thread([&] {
+        double time;
+        double values[3];
+        while (!done || numRead == 0) {
+            const auto n = reader->getNumRecordsWritten();
+            if (n == 0 || !reader->read(n - 1, time, values)) continue;
+            ++numRead;
+            consistent = consistent && values[0] == time &&
+                         values[1] == 2*time && values[2] == 3*time;
+        }
+    });
+    for (int k = 0; k < numRecords; ++k) {
+        double* values = writer->beginWrite(k);
+        for (int i = 0; i < 3; ++i) values[i] = (i + 1)*double(k);
+        writer->endWrite();
+    }
+    done = true;
+    thread.join();
+    ASSERT(consistent);
+    ASSERT(numRead > 0);
+    ASSERT(reader->getNumRecordsWritten() == numRecords);
+}
+
+int main() {
+    SimTK_START_TEST("testSharedMemoryRingBuffer");
+        SimTK_SUBTEST(testLayout);
+        SimTK_SUBTEST(testConcurrentReader);
+    SimTK_END_TEST();
+}
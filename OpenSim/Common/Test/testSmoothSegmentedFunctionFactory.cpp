@@ -1132,6 +1132,40 @@ void testMonotonicity(SimTK::Matrix mcfSample)
     cout << endl;
 }
 
+/*
+ 5. Evaluating the curve at many points at once gives exactly the same
+    values and derivatives as evaluating it at each point.
+*/
+void testMuscleCurveBatchEvaluation(SmoothSegmentedFunction mcf)
+{
+    cout << "   TEST: Batch Evaluation " << endl;
+    SimTK::Vec2 domain = mcf.getCurveDomain();
+    double range = domain(1) - domain(0);
+
+    //Sweep past both ends of the curve, then jump back and forth so that
+    //consecutive points fall in different sections.
+    int n = 200;
+    SimTK::Vector x(n + 4);
+    for(int i=0; i<n; ++i){
+        x(i) = domain(0) - 0.1*range + 1.2*range*i/(n-1);
+    }
+    x(n)   = domain(1);
+    x(n+1) = domain(0);
+    x(n+2) = domain(0) + 0.9*range;
+    x(n+3) = domain(0) + 0.1*range;
+
+    for(int order=0; order <= 2; ++order){
+        SimTK::Vector y;
+        mcf.calcDerivatives(x, y, order);
+        SimTK_TEST(y.size() == x.size());
+        for(int i=0; i<x.size(); ++i){
+            SimTK_TEST(y(i) == mcf.calcDerivative(x(i), order));
+        }
+    }
+    cout << "   passed: batch evaluation matches scalar evaluation" << endl;
+    cout << endl;
+}
+
 //______________________________________________________________________________
 /**
  * Create a muscle bench marking system. The bench mark consists of a single muscle 
@@ -1219,6 +1253,8 @@ int main(int argc, char* argv[])
             testMuscleCurveC2Continuity(tendonCurve,tendonCurveSample);
         //4. Test for monotonicity where appropriate
             testMonotonicity(tendonCurveSample);
+        //5. Test the batch evaluation against the scalar one
+            testMuscleCurveBatchEvaluation(tendonCurve);
 
         //5. Testing Exceptions
             cout << endl;
@@ -1842,6 +1878,8 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberfalCurve,fiberfalCurveSample);
+        //   and check that the batch evaluation matches the scalar one.
+            testMuscleCurveBatchEvaluation(fiberfalCurve);
 
             //fiberfalCurve.MuscleCurveToCSVFile("C:/mjhmilla/Stanford/dev");
        
@@ -21,7 +21,11 @@
  * -------------------------------------------------------------------------- */
 
 #include <fstream>
+#include <memory>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/Signal.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Common/STOFileAdapter.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -72,6 +76,244 @@ int main() {
         ASSERT(fabs(diff) < 1E-7);
 
         delete st;
+
+        // Read only some of the columns of a file.
+        Storage stSelected("test.sto", ColumnSelection{"v2"});
+        ASSERT(stSelected.getSize() == 2);
+        ASSERT(stSelected.getColumnLabels().getSize() == 2);
+        ASSERT(stSelected.getColumnLabels()[1] == "v2");
+        for (int j = 0; j < stSelected.getSize(); ++j) {
+            ASSERT(stSelected.getStateVector(j)->getSize() == 1);
+            ASSERT(stSelected.getStateVector(j)->getData()[0] ==
+                   stSelected.getStateVector(j)->getTime()*20.0);
+        }
+
+        // Test searches by time, with and without a cursor, in both
+        // directions and outside the stored time range.
+        Storage st3;
+        for (int j = 0; j < 100; ++j) {
+            double y = 2.0*j;
+            st3.append(0.1*j, 1, &y);
+        }
+        ASSERT(st3.findIndex(-1.0) == 0);
+        ASSERT(st3.findIndex(0.0) == 0);
+        ASSERT(st3.findIndex(0.55) == 5);
+        ASSERT(st3.findIndex(100.0) == 99);
+        ASSERT(st3.findIndex(50, 0.55) == 5);
+        ASSERT(st3.findIndex(5, 9.05) == 90);
+        Storage::Cursor cursor;
+        double value;
+        for (int j = 0; j < 99; ++j) {
+            st3.getDataAtTime(0.1*j + 0.05, 1, &value, cursor);
+            ASSERT_EQUAL(2.0*j + 1.0, value, 1e-9);
+            ASSERT(cursor.getIndex() == j);
+        }
+        for (int j = 98; j >= 0; --j) {
+            st3.getDataAtTime(0.1*j + 0.05, 1, &value, cursor);
+            ASSERT_EQUAL(2.0*j + 1.0, value, 1e-9);
+            ASSERT(cursor.getIndex() == j);
+        }
+
+        // Padding reflects and negates the data about the end points, so a
+        // linear signal remains linear in time.
+        Storage st4(st3);
+        st4.pad(10);
+        ASSERT(st4.getSize() == 120);
+        for (int j = 0; j < st4.getSize(); ++j) {
+            double t, y;
+            st4.getTime(j, t);
+            st4.getData(j, 0, y);
+            ASSERT_EQUAL(20.0*t, y, 1e-9);
+        }
+
+        // Filtering the columns of a Storage or a TimeSeriesTable together,
+        // on several threads, gives what filtering each signal alone does.
+        const int nr = 200, nc = 5;
+        const double dt = 0.001;
+        Storage st5;
+        TimeSeriesTable table;
+        vector<string> labels;
+        for (int i = 0; i < nc; ++i) labels.push_back("c" + to_string(i));
+        table.setColumnLabels(labels);
+        vector<vector<double>> signals(nc, vector<double>(nr));
+        for (int j = 0; j < nr; ++j) {
+            SimTK::RowVector row(nc);
+            for (int i = 0; i < nc; ++i) {
+                signals[i][j] = sin(2*SimTK::Pi*(i+1)*j*dt)
+                              + 0.1*sin(2*SimTK::Pi*200*j*dt);
+                row[i] = signals[i][j];
+            }
+            st5.append(j*dt, nc, &row[0]);
+            table.appendRow(j*dt, row);
+        }
+        // Storage resamples before filtering; filter the resampled data
+        // signal by signal for reference.
+        Storage resampled(st5);
+        const double dtr = resampled.resample(resampled.getMinTimeStep(), 5);
+        const int nrr = resampled.getSize();
+        Storage st6(st5);
+        TimeSeriesTable table2(table);
+        st5.lowpassIIR(20.0);
+        st6.lowpassFIR(30, 20.0);
+        Signal::LowpassIIR(table, 20.0, 3);
+        Signal::LowpassFIR(table2, 30, 20.0, 3);
+        ASSERT(st5.getSize() == nrr && st6.getSize() == nrr);
+        for (int i = 0; i < nc; ++i) {
+            vector<double> iir(nr), fir(nr);
+            Signal::LowpassIIR(dt, 20.0, nr, &signals[i][0], &iir[0]);
+            Signal::LowpassFIR(30, dt, 20.0, nr, &signals[i][0], &fir[0]);
+            for (int j = 0; j < nr; ++j) {
+                ASSERT_EQUAL(iir[j], table.getMatrix()(j, i), 1e-12);
+                ASSERT_EQUAL(fir[j], table2.getMatrix()(j, i), 1e-12);
+            }
+
+            Array<double> column;
+            resampled.getDataColumn(i, column);
+            vector<double> iirr(nrr), firr(nrr);
+            Signal::LowpassIIR(dtr, 20.0, nrr, &column[0], &iirr[0]);
+            Signal::LowpassFIR(30, dtr, 20.0, nrr, &column[0], &firr[0]);
+            for (int j = 0; j < nrr; ++j) {
+                double y;
+                st5.getData(j, i, y);
+                ASSERT_EQUAL(iirr[j], y, 1e-12);
+                st6.getData(j, i, y);
+                ASSERT_EQUAL(firr[j], y, 1e-12);
+            }
+        }
+
+        // Tables must be sampled uniformly to be filtered.
+        TimeSeriesTable uneven;
+        uneven.setColumnLabels(vector<string>{"c0"});
+        for (int j = 0; j < 10; ++j)
+            uneven.appendRow(j*j*dt, SimTK::RowVector(1, 1.0));
+        ASSERT_THROW(OpenSim::Exception, Signal::LowpassIIR(uneven, 20.0));
+
+        // Large files are written in blocks of rows formatted on several
+        // threads; the rows must come back in order.
+        const int nrLarge = 5000;
+        Storage st7;
+        Array<string> labels7;
+        labels7.append("time"); labels7.append("a"); labels7.append("b");
+        st7.setColumnLabels(labels7);
+        TimeSeriesTable table3;
+        table3.setColumnLabels(vector<string>{"a", "b"});
+        for (int j = 0; j < nrLarge; ++j) {
+            SimTK::RowVector row(2);
+            row[0] = sin(0.01*j);
+            row[1] = -1000.0*j;
+            st7.append(j*dt, 2, &row[0]);
+            table3.appendRow(j*dt, row);
+        }
+        st7.print("testStorage_large.sto");
+        Storage st8("testStorage_large.sto");
+        ASSERT(st8.getSize() == nrLarge);
+        Storage stWindow("testStorage_large.sto", 1.0, 1.5);
+        ASSERT(stWindow.getSize() == 501);
+        ASSERT_EQUAL(1.0, stWindow.getFirstTime(), 1e-8);
+        ASSERT_EQUAL(1.5, stWindow.getLastTime(), 1e-8);
+        for (int j = 0; j < nrLarge; ++j) {
+            double t, a, b;
+            st8.getTime(j, t);
+            st8.getData(j, 0, a);
+            st8.getData(j, 1, b);
+            ASSERT_EQUAL(j*dt, t, 1e-8);
+            ASSERT_EQUAL(sin(0.01*j), a, 1e-8);
+            ASSERT_EQUAL(-1000.0*j, b, 1e-8);
+        }
+        ASSERT(st7.print("testStorage_large_dt.sto", 2*dt) > 0);
+        Storage st9("testStorage_large_dt.sto");
+        ASSERT(st9.getSize() >= nrLarge/2);
+        for (int j = 0; j < nrLarge/2; ++j) {
+            double a;
+            st9.getData(j, 0, a);
+            ASSERT_EQUAL(sin(0.02*j), a, 1e-8);
+        }
+
+        STOFileAdapter_<double>::write(table3, "testStorage_large_table.sto");
+        TimeSeriesTable table4("testStorage_large_table.sto");
+        ASSERT(table4.getNumRows() == (size_t)nrLarge);
+        for (int j = 0; j < nrLarge; ++j) {
+            ASSERT_EQUAL(j*dt, table4.getIndependentColumn()[j], 1e-12);
+            ASSERT_EQUAL(sin(0.01*j), table4.getMatrix()(j, 0), 1e-12);
+            ASSERT_EQUAL(-1000.0*j, table4.getMatrix()(j, 1), 1e-6);
+        }
+
+        // Storage and TimeSeriesTable convert into each other, with labels
+        // and header information.
+        table3.addTableMetaData("header", std::string("large"));
+        table3.addTableMetaData("inDegrees", std::string("yes"));
+        Storage st10(table3);
+        ASSERT(st10.getName() == "large");
+        ASSERT(st10.isInDegrees());
+        ASSERT(st10.getColumnLabels().getSize() == 3);
+        ASSERT(st10.getColumnLabels()[0] == "time");
+        ASSERT(st10.getColumnLabels()[2] == "b");
+        ASSERT(st10.getSize() == nrLarge);
+        TimeSeriesTable table5 = st10.getAsTimeSeriesTable();
+        ASSERT(table5.getColumnLabels() == table3.getColumnLabels());
+        ASSERT(table5.getIndependentColumn() ==
+               table3.getIndependentColumn());
+        for (int j = 0; j < nrLarge; ++j)
+            for (int i = 0; i < 2; ++i)
+                ASSERT(table5.getMatrix()(j, i) == table3.getMatrix()(j, i));
+        ASSERT(table5.getTableMetaData<string>("header") == "large");
+        ASSERT(table5.getTableMetaData<string>("inDegrees") == "yes");
+
+        // Arithmetic between storages, at the same times and at times that
+        // must be interpolated (or extrapolated, past the last row).
+        Storage st11(st3);
+        st11.subtract(&st3);
+        for (int j = 0; j < st11.getSize(); ++j)
+            ASSERT(st11.getStateVector(j)->getData()[0] == 0.0);
+        Storage coarse;
+        for (int k = 0; k < 50; ++k) {
+            double y = 4.0*k;
+            coarse.append(0.2*k, 1, &y);
+        }
+        Storage st12(st3), st13(st3);
+        st12.multiply(&coarse);
+        st13.add(&coarse);
+        st13.divide(&coarse);
+        for (int j = 0; j < st12.getSize(); ++j) {
+            const double y = 2.0*j;
+            ASSERT_EQUAL(y*y, st12.getStateVector(j)->getData()[0], 1e-9);
+            const double q = st13.getStateVector(j)->getData()[0];
+            if (j == 0) ASSERT(SimTK::isNaN(q));
+            else ASSERT_EQUAL(2.0, q, 1e-12);
+        }
+
+        // Resampling and integration split larger storages into blocks of
+        // rows and ranges of columns; columns linear in time are resampled
+        // and integrated exactly.
+        const int nrWide = 3000, ncWide = 40;
+        Storage wide;
+        for (int j = 0; j < nrWide; ++j) {
+            vector<double> row(ncWide);
+            for (int i = 0; i < ncWide; ++i) row[i] = i*j*dt;
+            wide.append(j*dt, ncWide, row.data());
+        }
+        vector<double> area(ncWide);
+        ASSERT(wide.computeArea(ncWide, area.data()) == ncWide);
+        const double tLast = (nrWide - 1)*dt;
+        for (int i = 0; i < ncWide; ++i)
+            ASSERT_EQUAL(0.5*i*tLast*tLast, area[i], 1e-9);
+        std::unique_ptr<Storage> integrated(wide.integrate());
+        ASSERT(integrated->getSize() == nrWide);
+        for (int j = 0; j < nrWide; j += 97) {
+            const StateVector& row = *integrated->getStateVector(j);
+            ASSERT_EQUAL(j*dt, row.getTime(), 1e-12);
+            for (int i = 0; i < ncWide; ++i)
+                ASSERT_EQUAL(0.5*i*(j*dt)*(j*dt), row.getData()[i], 1e-9);
+        }
+        Storage wideResampled(wide);
+        wideResampled.resampleLinear(0.25*dt);
+        ASSERT(wideResampled.getSize() > 3*nrWide);
+        for (int j = 0; j < wideResampled.getSize(); j += 101) {
+            const StateVector& row = *wideResampled.getStateVector(j);
+            ASSERT(row.getSize() == ncWide);
+            for (int i = 0; i < ncWide; ++i)
+                ASSERT_EQUAL(i*row.getTime(), row.getData()[i], 1e-9);
+        }
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -0,0 +1,119 @@
+/* -------------------------------------------------------------------------- *
+ *               OpenSim:  testStreamingSavitzkyGolayFilter.cpp               *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <OpenSim/Common/StreamingSavitzkyGolayFilter.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <cmath>
+#include <random>
+
+using namespace OpenSim;
+
+// A cubic and its derivatives, which a filter of order 3 reproduces exactly.
+double cubic(double t) { return 0.1 + 0.5*t - 0.3*t*t + 0.2*t*t*t; }
+double cubicRate(double t) { return 0.5 - 0.6*t + 0.6*t*t; }
+double cubicAcceleration(double t) { return -0.6 + 1.2*t; }
+
+void testPolynomial() {
+    const double dt = 0.01;
+    for (int lag : {0, 2, 4}) {
+        StreamingSavitzkyGolayFilter filter(2, dt, 9, 3, lag);
+        ASSERT_EQUAL(lag*dt, filter.getLatency(), 1e-15);
+        SimTK::Vector sample(2), output;
+        for (int i = 0; i < 20; ++i) {
+            const double t = i*dt;
+            sample[0] = cubic(t);
+            sample[1] = -2*cubic(t);
+            filter.putSample(t, sample);
+            ASSERT(filter.isReady() == (i >= 8));
+            if (!filter.isReady()) {
+                ASSERT_THROW(Exception, filter.calcOutput(0, output));
+                continue;
+            }
+            const double to = filter.getOutputTime();
+            ASSERT_EQUAL(t - lag*dt, to, 1e-12);
+            filter.calcOutput(0, output);
+            ASSERT_EQUAL(cubic(to), output[0], 1e-9);
+            ASSERT_EQUAL(-2*cubic(to), output[1], 1e-9);
+            filter.calcOutput(1, output);
+            ASSERT_EQUAL(cubicRate(to), output[0], 1e-6);
+            filter.calcOutput(2, output);
+            ASSERT_EQUAL(cubicAcceleration(to), output[0], 1e-4);
+        }
+    }
+}
+
+void testSmoothing() {
+    // The centered filter attenuates noise on a slow sine.
+    const double dt = 0.01;
+    StreamingSavitzkyGolayFilter filter(1, dt, 11, 2, 5);
+    std::mt19937 gen(0);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    SimTK::Vector sample(1), output;
+    double sumSquaredNoise = 0, sumSquaredError = 0;
+    int n = 0;
+    for (int i = 0; i < 200; ++i) {
+        const double t = i*dt;
+        const double e = noise(gen);
+        sample[0] = std::sin(2*t) + e;
+        filter.putSample(t, sample);
+        if (!filter.isReady()) continue;
+        filter.calcOutput(0, output);
+        const double error = output[0] - std::sin(2*filter.getOutputTime());
+        sumSquaredNoise += e*e;
+        sumSquaredError += error*error;
+        ++n;
+    }
+    ASSERT(n == 190);
+    ASSERT(sumSquaredError < 0.5*sumSquaredNoise);
+}
+
+void testGapsAndErrors() {
+    const double dt = 0.01;
+    StreamingSavitzkyGolayFilter filter(1, dt, 5, 2, 0);
+    SimTK::Vector sample(1, 1.0);
+    for (int i = 0; i < 5; ++i) filter.putSample(i*dt, sample);
+    ASSERT(filter.isReady());
+    // A dropped frame starts a new window.
+    filter.putSample(6*dt, sample);
+    ASSERT(!filter.isReady());
+    for (int i = 7; i < 11; ++i) filter.putSample(i*dt, sample);
+    ASSERT(filter.isReady());
+    ASSERT_THROW(Exception, filter.putSample(10*dt, sample));
+    ASSERT_THROW(Exception, filter.putSample(11*dt, SimTK::Vector(2, 0.0)));
+    filter.reset();
+    ASSERT(!filter.isReady());
+
+    ASSERT_THROW(Exception, StreamingSavitzkyGolayFilter(1, dt, 5, 5, 0));
+    ASSERT_THROW(Exception, StreamingSavitzkyGolayFilter(1, dt, 5, 2, 5));
+    ASSERT_THROW(Exception, StreamingSavitzkyGolayFilter(1, 0.0, 5, 2, 0));
+}
+
+int main() {
+    SimTK_START_TEST("testStreamingSavitzkyGolayFilter");
+        SimTK_SUBTEST(testPolynomial);
+        SimTK_SUBTEST(testSmoothing);
+        SimTK_SUBTEST(testGapsAndErrors);
+    SimTK_END_TEST();
+}
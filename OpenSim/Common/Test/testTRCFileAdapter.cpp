@@ -128,6 +128,29 @@ int main() {
         compareFiles(filename, tmpfile);
     }
 
+    std::cout << "Testing TRCFileAdapter::readColumns()" << std::endl;
+    {
+        auto table = TRCFileAdapter::read(filenames.back());
+        const auto labels = table.getColumnLabels();
+        auto subset = TRCFileAdapter::readColumns(filenames.back(),
+                                                  {labels[2], labels[0]});
+        if(subset.getNumColumns() != 2 ||
+           subset.getNumRows() != table.getNumRows() ||
+           subset.getTableMetaData<std::string>("NumMarkers") != "2")
+            throw Exception{"Unexpected table when reading some markers."};
+        for(size_t r = 0; r < table.getNumRows(); ++r)
+            for(int k = 0; k < 3; ++k)
+                if(subset.getRowAtIndex(r)[0][k] != 
+                        table.getRowAtIndex(r)[2][k] ||
+                   subset.getRowAtIndex(r)[1][k] != 
+                        table.getRowAtIndex(r)[0][k])
+                    throw Exception{"Incorrect marker read from file."};
+        // Writing the subset gives a valid TRC file.
+        TRCFileAdapter::write(subset, tmpfile);
+        if(TRCFileAdapter::read(tmpfile).getNumColumns() != 2)
+            throw Exception{"Could not read back a subset of the markers."};
+    }
+
     std::remove(tmpfile.c_str());
 
     std::cout << "\nAll tests passed!" << std::endl;
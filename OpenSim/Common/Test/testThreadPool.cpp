@@ -0,0 +1,149 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testThreadPool.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Common/ThreadPool.h>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace OpenSim;
+
+void testLimit() {
+    ThreadPool::setMaxNumThreads(3);
+    ASSERT(ThreadPool::getMaxNumThreads() == 3);
+    ASSERT(ThreadPool::getNumThreads(0) == 3);
+    ASSERT(ThreadPool::getNumThreads(2) == 2);
+    ASSERT(ThreadPool::getNumThreads(8) == 3);
+
+    // At most 3 tasks run at once, however many threads are asked for.
+    std::atomic<int> numRunning(0), maxNumRunning(0);
+    ThreadPool::parallelFor(24, 8, [&](int) {
+        const int n = ++numRunning;
+        int max = maxNumRunning;
+        while (n > max && !maxNumRunning.compare_exchange_weak(max, n)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --numRunning;
+    });
+    ASSERT(maxNumRunning >= 1 && maxNumRunning <= 3);
+
+    ThreadPool::setMaxNumThreads(0);
+    ASSERT(ThreadPool::getMaxNumThreads() >= 1);
+}
+
+void testLoops() {
+    ThreadPool::setMaxNumThreads(4);
+
+    // Each task is done once.
+    std::vector<std::atomic<int>> counts(1000);
+    for (auto& count : counts) count = 0;
+    ThreadPool::parallelFor(1000, 0, [&](int i) { ++counts[i]; });
+    for (const auto& count : counts) ASSERT(count == 1);
+
+    // The ranges cover the items in order.
+    std::vector<int> begins(3), ends(3);
+    ThreadPool::parallelForRanges(10, 3, [&](int range, int begin, int end) {
+        begins[range] = begin;
+        ends[range] = end;
+    });
+    ASSERT(begins == std::vector<int>({0, 3, 6}));
+    ASSERT(ends == std::vector<int>({3, 6, 10}));
+    int numRanges = 0;
+    ThreadPool::parallelForRanges(2, 5, [&](int, int, int) { ++numRanges; });
+    ASSERT(numRanges == 2);
+    ThreadPool::parallelForRanges(0, 5, [&](int, int, int) { ++numRanges; });
+    ASSERT(numRanges == 2);
+
+    // Loops within loops finish, even with every worker busy.
+    std::atomic<int> sum(0);
+    ThreadPool::parallelFor(8, 0, [&](int) {
+        ThreadPool::parallelFor(100, 0, [&](int i) { sum += i; });
+    });
+    ASSERT(sum == 8*4950);
+
+    // The first error is rethrown, and the pool can still be used.
+    ASSERT_THROW(Exception,
+        ThreadPool::parallelFor(100, 0, [](int i) {
+            if (i == 50) throw Exception("Task failed.");
+        }));
+    std::atomic<int> numDone(0);
+    ThreadPool::parallelFor(100, 0, [&](int) { ++numDone; });
+    ASSERT(numDone == 100);
+
+    ThreadPool::setMaxNumThreads(0);
+}
+
+void testDeterministic() {
+    ThreadPool::setMaxNumThreads(8);
+    ThreadPool::setDeterministic(false);
+    ASSERT(ThreadPool::getNumRanges(100, 3) == 3);
+    ASSERT(ThreadPool::getNumRanges(2, 3) == 2);
+
+    ThreadPool::setDeterministic(true);
+    ThreadPool::setNumDeterministicRanges(5);
+    ASSERT(ThreadPool::getDeterministic());
+    ASSERT(ThreadPool::getNumRanges(100, 1) == 5);
+    ASSERT(ThreadPool::getNumRanges(100, 8) == 5);
+    ASSERT(ThreadPool::getNumRanges(3, 8) == 3);
+
+    // Sums over ranges, added in the order of the ranges, do not depend on
+    // the number of threads.
+    const int n = 1000;
+    std::vector<double> items(n);
+    for (int i = 0; i < n; ++i) items[i] = 1.0/(i + 1) - 1e-3*(i%7);
+    const auto sum = [&](int numThreads) {
+        const int numRanges = ThreadPool::getNumRanges(n, numThreads);
+        std::vector<double> partSums(numRanges, 0.0);
+        ThreadPool::parallelForRanges(n, numRanges, numThreads,
+            [&](int range, int begin, int end) {
+                for (int i = begin; i < end; ++i) partSums[range] += items[i];
+            });
+        double total = 0;
+        for (double partSum : partSums) total += partSum;
+        return total;
+    };
+    const double sum1 = sum(1);
+    for (int numThreads : {2, 3, 4, 8}) ASSERT(sum(numThreads) == sum1);
+
+    ThreadPool::setNumDeterministicRanges(0);
+    ASSERT(ThreadPool::getNumDeterministicRanges() >= 1);
+    ThreadPool::setDeterministic(false);
+
+    // The seeds of the tasks depend only on the seed and the task.
+    ASSERT(ThreadPool::getTaskSeed(42, 3) == ThreadPool::getTaskSeed(42, 3));
+    ASSERT(ThreadPool::getTaskSeed(42, 3) != ThreadPool::getTaskSeed(42, 4));
+    ASSERT(ThreadPool::getTaskSeed(42, 3) != ThreadPool::getTaskSeed(43, 3));
+
+    ThreadPool::setMaxNumThreads(0);
+}
+
+int main() {
+    SimTK_START_TEST("testThreadPool");
+        SimTK_SUBTEST(testLimit);
+        SimTK_SUBTEST(testLoops);
+        SimTK_SUBTEST(testDeterministic);
+    SimTK_END_TEST();
+}
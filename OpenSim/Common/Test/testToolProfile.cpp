@@ -0,0 +1,143 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testToolProfile.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Common/ToolProfile.h>
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace OpenSim;
+
+std::string readFile(const std::string& fileName) {
+    std::ifstream in(fileName);
+    ASSERT(in.good(), __FILE__, __LINE__, "Could not read " + fileName);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+void testPhases() {
+    ToolProfile profile("InverseKinematicsTool walk 1");
+    profile.beginPhase("load model");
+    profile.endPhase();
+    {
+        ToolProfile::Scope solve(profile, "solve frames");
+        ToolProfile::Scope frame(profile, "assemble");
+        // Phases that have not ended are not reported.
+        ASSERT(profile.getPhases().size() == 1);
+    }
+    ASSERT_THROW(Exception, profile.endPhase());
+
+    const auto phases = profile.getPhases();
+    ASSERT(phases.size() == 3);
+    ASSERT(phases[0].name == "load model" && phases[0].depth == 0);
+    ASSERT(phases[1].name == "solve frames" && phases[1].depth == 0);
+    ASSERT(phases[2].name == "assemble" && phases[2].depth == 1);
+    for (const auto& phase : phases) {
+        ASSERT(phase.start >= 0 && phase.wallTime >= 0);
+    }
+    ASSERT(phases[1].start >= phases[0].start);
+    ASSERT(phases[2].start >= phases[1].start);
+    ASSERT(phases[2].wallTime <= phases[1].wallTime);
+
+    // A phase ends when an exception leaves its scope.
+    try {
+        ToolProfile::Scope phase(profile, "write outputs");
+        throw Exception("Could not write.");
+    } catch (const Exception&) {}
+    ASSERT(profile.getPhases().size() == 4);
+}
+
+void testDistributions() {
+    ToolProfile profile("AnalyzeTool");
+    ASSERT(profile.getDistribution("frame").count == 0);
+    for (int i = 100; i >= 1; --i) profile.addSample("frame", 0.01 * i);
+    profile.addSample("pass", 2);
+
+    ASSERT(profile.getStepNames() == std::vector<std::string>({"frame", "pass"}));
+    const auto frame = profile.getDistribution("frame");
+    ASSERT(frame.count == 100);
+    ASSERT_EQUAL(50.5, frame.total, 1e-10);
+    ASSERT_EQUAL(0.01, frame.min, 1e-12);
+    ASSERT_EQUAL(0.50, frame.median, 1e-12);
+    ASSERT_EQUAL(0.99, frame.p99, 1e-12);
+    ASSERT_EQUAL(1.00, frame.max, 1e-12);
+
+    const auto pass = profile.getDistribution("pass");
+    ASSERT(pass.count == 1 && pass.median == 2 && pass.p99 == 2);
+
+    // Counters are summed.
+    profile.addCount("iterations", 3);
+    profile.addCount("iterations", 4);
+    ASSERT(profile.getCounterNames() ==
+           std::vector<std::string>({"iterations"}));
+    ASSERT(profile.getCount("iterations") == 7);
+    ASSERT(profile.getCount("steps") == 0);
+}
+
+void testReports() {
+    ToolProfile profile("ForwardTool \"arm\"");
+    profile.beginPhase("integrate");
+    profile.endPhase();
+    profile.addSample("step", 0.5);
+    profile.addCount("integrator steps", 12);
+
+    profile.printJSON("testToolProfile_profile.json");
+    const std::string json = readFile("testToolProfile_profile.json");
+    ASSERT(json.find("\"name\": \"ForwardTool \\\"arm\\\"\"") !=
+           std::string::npos);
+    ASSERT(json.find("\"name\": \"integrate\", \"depth\": 0") !=
+           std::string::npos);
+    ASSERT(json.find("\"step\": {\"count\": 1") != std::string::npos);
+    ASSERT(json.find("\"counters\": {\n    \"integrator steps\": 12") !=
+           std::string::npos);
+
+    profile.printChromeTrace("testToolProfile_trace.json");
+    const std::string trace = readFile("testToolProfile_trace.json");
+    ASSERT(trace.find("\"traceEvents\"") != std::string::npos);
+    ASSERT(trace.find("\"ph\": \"X\"") != std::string::npos);
+
+    // Reports are written only when enabled.
+    ToolProfile reported("ScaleTool subject 01");
+    reported.printReports("testToolProfile_reports");
+    ASSERT(!std::ifstream("testToolProfile_reports/"
+                          "ScaleTool_subject_01_profile.json").good());
+    ToolProfile::setReportsEnabled(true);
+    ToolProfile::setChromeTraceEnabled(true);
+    reported.printReports("testToolProfile_reports");
+    ToolProfile::setReportsEnabled(false);
+    ToolProfile::setChromeTraceEnabled(false);
+    readFile("testToolProfile_reports/ScaleTool_subject_01_profile.json");
+    readFile("testToolProfile_reports/ScaleTool_subject_01_trace.json");
+}
+
+int main() {
+    SimTK_START_TEST("testToolProfile");
+        SimTK_SUBTEST(testPhases);
+        SimTK_SUBTEST(testDistributions);
+        SimTK_SUBTEST(testReports);
+    SimTK_END_TEST();
+}
@@ -0,0 +1,295 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ThreadPool.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace OpenSim;
+
+namespace {
+
+int getDefaultMaxNumThreads() {
+    if (const char* value = std::getenv("OPENSIM_NUM_THREADS")) {
+        const int numThreads = std::atoi(value);
+        if (numThreads >= 1) return numThreads;
+    }
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+std::atomic<int>& maxNumThreads() {
+    static std::atomic<int> value{getDefaultMaxNumThreads()};
+    return value;
+}
+
+// OPENSIM_DETERMINISTIC turns on deterministic mode if it is positive, and
+// also sets the number of ranges if it is greater than 1.
+int getDeterministicEnvironmentValue() {
+    if (const char* value = std::getenv("OPENSIM_DETERMINISTIC"))
+        return std::max(0, std::atoi(value));
+    return 0;
+}
+
+int getDefaultNumDeterministicRanges() {
+    const int value = getDeterministicEnvironmentValue();
+    return value > 1 ? value : 8;
+}
+
+std::atomic<bool>& deterministic() {
+    static std::atomic<bool> value{getDeterministicEnvironmentValue() > 0};
+    return value;
+}
+
+std::atomic<int>& numDeterministicRanges() {
+    static std::atomic<int> value{getDefaultNumDeterministicRanges()};
+    return value;
+}
+
+long long currentProcessId() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
+// One call of parallelFor(). Its tasks are taken in order by the calling
+// thread and by the workers that join it.
+class Loop {
+public:
+    Loop(int numTasks, const std::function<void(int)>& task) :
+        _numTasks(numTasks), _task(&task) {}
+
+    // Do the tasks that are left, one at a time.
+    void work() {
+        int numDone = 0;
+        for (int i = _next++; i < _numTasks; i = _next++) {
+            if (!_failed) {
+                try {
+                    (*_task)(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!_exception) _exception = std::current_exception();
+                    _failed = true;
+                }
+            }
+            ++numDone;
+        }
+        if (numDone == 0) return;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _numDone += numDone;
+        if (_numDone == _numTasks) _finished.notify_all();
+    }
+
+    // Wait until all tasks are done, and rethrow the first error, if any.
+    void wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this] { return _numDone == _numTasks; });
+        if (_exception) std::rethrow_exception(_exception);
+    }
+
+private:
+    const int _numTasks;
+    // Owned by the caller of parallelFor(), which returns only once all
+    // tasks are taken; a worker that joins later does not use it.
+    const std::function<void(int)>* _task;
+    std::atomic<int> _next{0};
+    std::atomic<bool> _failed{false};
+    // Guards the members below.
+    std::mutex _mutex;
+    std::condition_variable _finished;
+    int _numDone = 0;
+    std::exception_ptr _exception;
+};
+
+// The worker threads of the process, started as loops need them. Each takes
+// the next loop that asked for a worker, while fewer than the limit are
+// busy.
+class Workers {
+public:
+    Workers() : _processId(currentProcessId()) {}
+
+    long long getProcessId() const { return _processId; }
+
+    // Ask for up to numWorkers workers to join the loop.
+    void submit(const std::shared_ptr<Loop>& loop, int numWorkers) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int i = 0; i < numWorkers; ++i) _loops.push_back(loop);
+        const int numWanted = std::min(_numBusy + (int)_loops.size(),
+                                       ThreadPool::getMaxNumThreads() - 1);
+        while ((int)_threads.size() < numWanted)
+            _threads.emplace_back(&Workers::run, this);
+        _changed.notify_all();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _changed.wait(lock, [this] {
+                return !_loops.empty() &&
+                       _numBusy < ThreadPool::getMaxNumThreads() - 1;
+            });
+            std::shared_ptr<Loop> loop = std::move(_loops.front());
+            _loops.pop_front();
+            ++_numBusy;
+            lock.unlock();
+            loop->work();
+            loop.reset();
+            lock.lock();
+            --_numBusy;
+            _changed.notify_all();
+        }
+    }
+
+    const long long _processId;
+    std::vector<std::thread> _threads;
+    // Guards the members below.
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    std::deque<std::shared_ptr<Loop>> _loops;
+    int _numBusy = 0;
+};
+
+// The workers live until the process ends; they are never destroyed, since
+// threads cannot be joined safely while a library is unloaded.
+std::atomic<Workers*> workers{nullptr};
+
+Workers& getWorkers() {
+    Workers* current = workers.load();
+    if (current && current->getProcessId() == currentProcessId())
+        return *current;
+    // First use, or first use in a child of a process that forked, which has
+    // a copy of the workers of its parent but not their threads (and whose
+    // mutex may be locked); start over.
+    Workers* created = new Workers();
+    if (workers.compare_exchange_strong(current, created)) return *created;
+    // Another thread got there first.
+    delete created;
+    return *current;
+}
+
+} // anonymous namespace
+
+void ThreadPool::setMaxNumThreads(int maxNumThreads)
+{
+    ::maxNumThreads() =
+        maxNumThreads >= 1 ? maxNumThreads : getDefaultMaxNumThreads();
+}
+
+int ThreadPool::getMaxNumThreads()
+{
+    return ::maxNumThreads();
+}
+
+int ThreadPool::getNumThreads(int numThreads)
+{
+    const int max = getMaxNumThreads();
+    return numThreads >= 1 ? std::min(numThreads, max) : max;
+}
+
+void ThreadPool::setDeterministic(bool value)
+{
+    ::deterministic() = value;
+}
+
+bool ThreadPool::getDeterministic()
+{
+    return ::deterministic();
+}
+
+void ThreadPool::setNumDeterministicRanges(int numRanges)
+{
+    ::numDeterministicRanges() =
+        numRanges >= 1 ? numRanges : getDefaultNumDeterministicRanges();
+}
+
+int ThreadPool::getNumDeterministicRanges()
+{
+    return ::numDeterministicRanges();
+}
+
+int ThreadPool::getNumRanges(int numItems, int numThreads)
+{
+    const int numRanges = getDeterministic() ? getNumDeterministicRanges()
+                                             : getNumThreads(numThreads);
+    return std::max(1, std::min(numRanges, numItems));
+}
+
+unsigned long long ThreadPool::getTaskSeed(unsigned long long seed,
+                                           int taskIndex)
+{
+    // The SplitMix64 generator, at position taskIndex + 1 of the sequence
+    // that starts at seed.
+    unsigned long long z =
+        seed + 0x9E3779B97F4A7C15ull*((unsigned long long)taskIndex + 1);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void ThreadPool::parallelFor(int numTasks, int numThreads,
+                             const std::function<void(int)>& task)
+{
+    numThreads = std::min(getNumThreads(numThreads), numTasks);
+    if (numThreads <= 1) {
+        for (int i = 0; i < numTasks; ++i) task(i);
+        return;
+    }
+    auto loop = std::make_shared<Loop>(numTasks, task);
+    getWorkers().submit(loop, numThreads - 1);
+    loop->work();
+    loop->wait();
+}
+
+void ThreadPool::parallelForRanges(int numItems, int numRanges,
+        const std::function<void(int, int, int)>& task)
+{
+    parallelForRanges(numItems, numRanges, numRanges, task);
+}
+
+void ThreadPool::parallelForRanges(int numItems, int numRanges, int numThreads,
+        const std::function<void(int, int, int)>& task)
+{
+    if (numItems <= 0) return;
+    numRanges = std::max(1, std::min(numRanges, numItems));
+    parallelFor(numRanges, numThreads, [&](int range) {
+        task(range, int((long long)numItems*range/numRanges),
+             int((long long)numItems*(range + 1)/numRanges));
+    });
+}
@@ -0,0 +1,145 @@
+#ifndef OPENSIM_THREAD_POOL_H_
+#define OPENSIM_THREAD_POOL_H_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  ThreadPool.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "osimCommonDLL.h"
+
+#include <functional>
+
+namespace OpenSim {
+
+/** The threads on which OpenSim computes in parallel (e.g., the frames of
+the Tools, the columns of a Storage being filtered, the paths of a Model),
+shared by the whole process.
+
+Work is handed to the pool as a loop of independent tasks. The calling thread
+takes part in its loop, and the workers that are free join it; each takes the
+next task that has not been taken until there are none left, so that threads
+that finish early take more of the work. A task may itself run a loop, which
+its thread then runs with whatever workers are free.
+
+The number of threads that compute at once is limited for the whole process,
+so that several tools or analyses running in one process (e.g., in
+`opensim-cmd run-batch`) do not oversubscribe the machine: the workers never
+number more than getMaxNumThreads() - 1, and a loop runs on at most
+getMaxNumThreads() threads, counting the calling thread. The limit is the
+number of hardware threads unless set with setMaxNumThreads(), with the
+environment variable OPENSIM_NUM_THREADS, or with the `--threads` option of
+`opensim-cmd`. The settings of the classes that compute in parallel (e.g.,
+InverseKinematicsTool::setNumThreads()) ask for a number of threads up to
+this limit.
+
+@code
+// Solve the frames in numChunks contiguous chunks, each with its own model.
+ThreadPool::parallelForRanges(numFrames, numChunks,
+    [&](int chunk, int begin, int end) {
+        for (int i = begin; i < end; ++i) solveFrame(*models[chunk], i);
+    });
+@endcode
+
+In a child of a process that forked, the pool starts new workers when it is
+first used.
+
+<h3>Deterministic mode</h3>
+The tasks of a loop are independent, so the threads they run on and the order
+they run in do not change their results. The results of a computation that is
+split into ranges may still depend on the number of threads, though, when
+there is a range per thread: each range of frames of a tool starts solving
+from its own first frame rather than from the solution of the frame before,
+and sums over the items of a range are added to the sums over the other
+ranges. In deterministic mode (setDeterministic(), the environment variable
+OPENSIM_DETERMINISTIC, or the `--deterministic` option of `opensim-cmd`),
+such computations ask getNumRanges() how many ranges to split into, which is
+then getNumDeterministicRanges() whatever the number of threads; the ranges
+are combined in their order, and sums over items are added in the order of
+the items. The results are then the same, bit for bit, for any number of
+threads. This costs little: at most a copy of a model per range that is not
+used by a thread of its own, and a buffer of the terms of a sum.
+
+Streams of random numbers for the tasks of a loop (e.g., the runs of a Monte
+Carlo ensemble) are seeded with getTaskSeed(), so that each task gets the
+same stream whatever thread it runs on. */
+class OSIMCOMMON_API ThreadPool {
+public:
+    /** %Set the largest number of threads that compute at once, counting the
+    calling thread. Values less than 1 restore the default. */
+    static void setMaxNumThreads(int maxNumThreads);
+    static int getMaxNumThreads();
+
+    /** The number of threads to use for a request of `numThreads`: at most
+    getMaxNumThreads(), which is also the number for requests less than 1
+    (e.g., 0 for "as many as possible"). */
+    static int getNumThreads(int numThreads);
+
+    /** %Set whether computations that are split into ranges must give the
+    same results for any number of threads; see "Deterministic mode" above.
+    The default is false, unless the environment variable
+    OPENSIM_DETERMINISTIC is set to a positive integer. */
+    static void setDeterministic(bool deterministic);
+    static bool getDeterministic();
+
+    /** %Set the number of ranges that computations are split into in
+    deterministic mode, whatever the number of threads (default 8, or the
+    value of OPENSIM_DETERMINISTIC if it is greater than 1). Values less
+    than 1 restore the default. */
+    static void setNumDeterministicRanges(int numRanges);
+    static int getNumDeterministicRanges();
+
+    /** The number of ranges into which to split numItems items whose results
+    depend on the other items of their range, for a request of `numThreads`
+    threads: getNumThreads(numThreads), or getNumDeterministicRanges() in
+    deterministic mode; in either case at least 1 and at most numItems. */
+    static int getNumRanges(int numItems, int numThreads);
+
+    /** A seed for the stream of random numbers of task `taskIndex` of a loop
+    whose streams are all derived from `seed`. The seeds of different tasks
+    are well mixed, so that their streams are independent, and depend only
+    on `seed` and `taskIndex`. */
+    static unsigned long long getTaskSeed(unsigned long long seed,
+                                          int taskIndex);
+
+    /** Call task(i) for each i in [0, numTasks), on up to numThreads threads
+    (see getNumThreads()), in no particular order. Returns once all tasks are
+    done. If a task throws, the tasks that have not started yet are skipped
+    and the first exception is rethrown. */
+    static void parallelFor(int numTasks, int numThreads,
+                            const std::function<void(int)>& task);
+
+    /** Split [0, numItems) into numRanges contiguous ranges of about the same
+    size and call task(range, begin, end) for each, as by parallelFor() with
+    numRanges threads. The ranges are in order: range r covers
+    [numItems*r/numRanges, numItems*(r+1)/numRanges). */
+    static void parallelForRanges(int numItems, int numRanges,
+            const std::function<void(int, int, int)>& task);
+
+    /** As above, on up to numThreads threads (see getNumThreads()), which
+    take the ranges in turn if there are more ranges than threads (e.g., in
+    deterministic mode; see getNumRanges()). */
+    static void parallelForRanges(int numItems, int numRanges, int numThreads,
+            const std::function<void(int, int, int)>& task);
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_THREAD_POOL_H_
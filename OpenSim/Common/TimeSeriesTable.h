@@ -325,17 +325,27 @@ public:
                          TimeOutOfRange,
                          timeCol.front(), timeCol.back(), endTime);
 
+        // The values of a table of floats are summed in double precision.
+        using Sum = typename std::conditional<std::is_same<ETY, float>::value,
+                                              double, ETY>::type;
+        const int numColumns{static_cast<int>(DT::getNumColumns())};
         std::vector<double> comps(DT::numComponentsPerElement(), 0);
-        RowVector row{static_cast<int>(DT::getNumColumns()),
-                      DT::makeElement(comps.begin(), comps.end())};
+        SimTK::RowVector_<Sum> sum{numColumns,
+                              Sum(DT::makeElement(comps.begin(), comps.end()))};
         unsigned numRowsInRange{};
         for(unsigned r = 0; r < DT::getNumRows(); ++r) {
             if(timeCol[r] >= beginTime && timeCol[r] <= endTime) {
-                row += DT::getRowAtIndex(r);
+                const auto rowInRange = DT::getRowAtIndex(r);
+                for(int c = 0; c < numColumns; ++c)
+                    sum[c] += rowInRange[c];
                 ++numRowsInRange;
             }
         }
-        row /= numRowsInRange;
+        RowVector row{numColumns};
+        for(int c = 0; c < numColumns; ++c) {
+            sum[c] /= numRowsInRange;
+            row[c] = static_cast<ETY>(sum[c]);
+        }
 
         return row;
     }
@@ -372,6 +382,72 @@ typedef TimeSeriesTable_<SimTK::Real> TimeSeriesTable;
 
 /** See TimeSeriesTable_ for details on the interface.                        */
 typedef TimeSeriesTable_<SimTK::Vec3> TimeSeriesTableVec3;
+
+/** A TimeSeriesTable_ whose values are stored in single precision, in half the
+memory of a TimeSeriesTable (the time column remains double). Use it to keep
+or archive large data sets (e.g., marker data, EMG, muscle outputs) whose
+values do not need double precision, and convert it to a TimeSeriesTable with
+toDoublePrecision() to filter, interpolate or otherwise compute with them.
+A TableReporter_<SimTK::Real, float> reports outputs of type double into such
+a table, and BinaryFileAdapter writes its values as 4-byte floats.
+
+See TimeSeriesTable_ for details on the interface.                        */
+typedef TimeSeriesTable_<float> TimeSeriesTableFloat;
+
+/** Key of the table metadata that marks a table whose values were rounded to
+single precision, with the value "single". The mark is kept when the table is
+converted back to double precision and when it is written to a file, so that
+the precision lost stays known.                                           */
+inline const std::string& getPrecisionMetaDataKey() {
+    static const std::string key{"precision"};
+    return key;
+}
+
+#ifndef SWIG
+namespace internal {
+// Copy the metadata and the rows of a table into a table of another element
+// type, converting each value, and mark the copy as rounded to single
+// precision.
+template<typename ToETY, typename FromETY>
+TimeSeriesTable_<ToETY> convertPrecision(
+        const TimeSeriesTable_<FromETY>& table) {
+    TimeSeriesTable_<ToETY> result{};
+    result.updTableMetaData() = table.getTableMetaData();
+    result.setIndependentMetaData(table.getIndependentMetaData());
+    if(table.hasColumnLabels())
+        result.setDependentsMetaData(table.getDependentsMetaData());
+    if(result.hasTableMetaDataKey(getPrecisionMetaDataKey()))
+        result.removeTableMetaDataKey(getPrecisionMetaDataKey());
+    result.addTableMetaData(getPrecisionMetaDataKey(), std::string{"single"});
+
+    const int numColumns{static_cast<int>(table.getNumColumns())};
+    const auto& times = table.getIndependentColumn();
+    result.reserve(table.getNumRows());
+    SimTK::RowVector_<ToETY> row{numColumns};
+    for(size_t r = 0; r < table.getNumRows(); ++r) {
+        const auto values = table.getRowAtIndex(r);
+        for(int c = 0; c < numColumns; ++c)
+            row[c] = static_cast<ToETY>(values[c]);
+        result.appendRow(times[r], row);
+    }
+    return result;
+}
+} // namespace internal
+
+/** Round the values of a table to single precision (see
+TimeSeriesTableFloat). The metadata are copied, and the table is marked with
+getPrecisionMetaDataKey().                                                 */
+inline TimeSeriesTableFloat toSinglePrecision(const TimeSeriesTable& table) {
+    return internal::convertPrecision<float>(table);
+}
+
+/** Convert a table of single-precision values to a TimeSeriesTable to
+compute with. The metadata are copied, and the table is marked with
+getPrecisionMetaDataKey() since its values carry only single precision. */
+inline TimeSeriesTable toDoublePrecision(const TimeSeriesTableFloat& table) {
+    return internal::convertPrecision<double>(table);
+}
+#endif
 } // namespace OpenSim
 
 #endif // OPENSIM_TIME_SERIES_DATA_TABLE_H_
@@ -0,0 +1,253 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ToolProfile.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ToolProfile.h"
+#include "Exception.h"
+#include "IO.h"
+
+#include "SimTKcommon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace OpenSim {
+
+bool ToolProfile::_reportsEnabled = false;
+bool ToolProfile::_chromeTraceEnabled = false;
+
+namespace {
+    // Quote a string for JSON.
+    std::string quoteJSON(const std::string& str)
+    {
+        std::ostringstream quoted;
+        quoted << '"';
+        for (const char c : str) {
+            if (c == '"' || c == '\\')
+                quoted << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                quoted << "\\u" << std::hex << std::setw(4)
+                       << std::setfill('0') << (int)c << std::dec;
+            else
+                quoted << c;
+        }
+        quoted << '"';
+        return quoted.str();
+    }
+
+    // The sample with the given nearest rank, for p in (0, 1].
+    double nearestRank(const std::vector<double>& sorted, double p)
+    {
+        const size_t rank = (size_t)std::ceil(p * sorted.size());
+        return sorted[std::max(rank, (size_t)1) - 1];
+    }
+
+    void openReport(std::ofstream& out, const std::string& fileName)
+    {
+        out.open(fileName);
+        OPENSIM_THROW_IF(!out, Exception,
+                         "Could not write profile '" + fileName + "'.");
+        out << std::setprecision(9);
+    }
+}
+
+ToolProfile::ToolProfile(const std::string& name) :
+    _name(name), _origin(SimTK::realTime()) {}
+
+void ToolProfile::beginPhase(const std::string& name)
+{
+    const double wallStart = SimTK::realTime();
+    _phases.push_back({name, (int)_open.size(), wallStart - _origin, 0, 0});
+    _open.push_back({_phases.size() - 1, wallStart, SimTK::cpuTime()});
+}
+
+void ToolProfile::endPhase()
+{
+    OPENSIM_THROW_IF(_open.empty(), Exception,
+                     "ToolProfile '" + _name + "' has no open phase.");
+    const OpenPhase& open = _open.back();
+    Phase& phase = _phases[open.index];
+    phase.wallTime = SimTK::realTime() - open.wallStart;
+    phase.cpuTime = SimTK::cpuTime() - open.cpuStart;
+    _open.pop_back();
+}
+
+void ToolProfile::addSample(const std::string& step, double seconds)
+{
+    _samples[step].push_back(seconds);
+}
+
+void ToolProfile::addCount(const std::string& counter, double count)
+{
+    _counts[counter] += count;
+}
+
+std::vector<ToolProfile::Phase> ToolProfile::getPhases() const
+{
+    std::vector<Phase> ended;
+    for (size_t i = 0; i < _phases.size(); ++i) {
+        const bool isOpen = std::any_of(_open.begin(), _open.end(),
+                [i](const OpenPhase& open) { return open.index == i; });
+        if (!isOpen) ended.push_back(_phases[i]);
+    }
+    return ended;
+}
+
+std::vector<std::string> ToolProfile::getStepNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& samples : _samples)
+        names.push_back(samples.first);
+    return names;
+}
+
+ToolProfile::Distribution
+ToolProfile::getDistribution(const std::string& step) const
+{
+    Distribution distribution;
+    const auto found = _samples.find(step);
+    if (found == _samples.end() || found->second.empty())
+        return distribution;
+    std::vector<double> sorted(found->second);
+    std::sort(sorted.begin(), sorted.end());
+    distribution.count = sorted.size();
+    for (const double sample : sorted)
+        distribution.total += sample;
+    distribution.min = sorted.front();
+    distribution.median = nearestRank(sorted, 0.5);
+    distribution.p99 = nearestRank(sorted, 0.99);
+    distribution.max = sorted.back();
+    return distribution;
+}
+
+std::vector<std::string> ToolProfile::getCounterNames() const
+{
+    std::vector<std::string> names;
+    for (const auto& count : _counts)
+        names.push_back(count.first);
+    return names;
+}
+
+double ToolProfile::getCount(const std::string& counter) const
+{
+    const auto found = _counts.find(counter);
+    return found == _counts.end() ? 0 : found->second;
+}
+
+void ToolProfile::printJSON(const std::string& fileName) const
+{
+    std::ofstream out;
+    openReport(out, fileName);
+    out << "{\n  \"name\": " << quoteJSON(_name) << ",\n  \"phases\": [";
+    const std::vector<Phase> phases = getPhases();
+    for (size_t i = 0; i < phases.size(); ++i) {
+        const Phase& phase = phases[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": " << quoteJSON(phase.name)
+            << ", \"depth\": " << phase.depth
+            << ", \"start\": " << phase.start
+            << ", \"wall_time\": " << phase.wallTime
+            << ", \"cpu_time\": " << phase.cpuTime << "}";
+    }
+    out << "\n  ],\n  \"steps\": {";
+    bool first = true;
+    for (const auto& step : getStepNames()) {
+        const Distribution d = getDistribution(step);
+        out << (first ? "\n" : ",\n")
+            << "    " << quoteJSON(step) << ": {\"count\": " << d.count
+            << ", \"total\": " << d.total << ", \"min\": " << d.min
+            << ", \"median\": " << d.median << ", \"p99\": " << d.p99
+            << ", \"max\": " << d.max << "}";
+        first = false;
+    }
+    out << "\n  },\n  \"counters\": {";
+    first = true;
+    for (const auto& count : _counts) {
+        out << (first ? "\n" : ",\n")
+            << "    " << quoteJSON(count.first) << ": " << count.second;
+        first = false;
+    }
+    out << "\n  }\n}\n";
+}
+
+void ToolProfile::printChromeTrace(const std::string& fileName) const
+{
+    // Complete ("X") events, with times in microseconds.
+    std::ofstream out;
+    openReport(out, fileName);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    const std::vector<Phase> phases = getPhases();
+    for (size_t i = 0; i < phases.size(); ++i) {
+        const Phase& phase = phases[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "  {\"name\": " << quoteJSON(phase.name)
+            << ", \"cat\": " << quoteJSON(_name)
+            << ", \"ph\": \"X\", \"pid\": 1, \"tid\": 1"
+            << ", \"ts\": " << 1e6 * phase.start
+            << ", \"dur\": " << 1e6 * phase.wallTime
+            << ", \"args\": {\"cpu_time\": " << phase.cpuTime << "}}";
+    }
+    out << "\n]}\n";
+}
+
+void ToolProfile::printReports(const std::string& directory) const
+{
+    if (!_reportsEnabled) return;
+    std::string prefix = directory;
+    if (!prefix.empty() && prefix.back() != '/' && prefix.back() != '\\')
+        prefix += "/";
+    IO::makeDir(prefix.empty() ? "." : prefix);
+    std::string name = _name;
+    std::replace(name.begin(), name.end(), ' ', '_');
+    prefix += name;
+    printJSON(prefix + "_profile.json");
+    if (_chromeTraceEnabled)
+        printChromeTrace(prefix + "_trace.json");
+    cout << "Wrote profile of " << _name << " to '" << prefix
+         << "_profile.json'." << endl;
+}
+
+void ToolProfile::setReportsEnabled(bool enabled)
+{
+    _reportsEnabled = enabled;
+}
+
+bool ToolProfile::getReportsEnabled()
+{
+    return _reportsEnabled;
+}
+
+void ToolProfile::setChromeTraceEnabled(bool enabled)
+{
+    _chromeTraceEnabled = enabled;
+}
+
+bool ToolProfile::getChromeTraceEnabled()
+{
+    return _chromeTraceEnabled;
+}
+
+} // namespace OpenSim
@@ -0,0 +1,167 @@
+#ifndef OPENSIM_TOOL_PROFILE_H_
+#define OPENSIM_TOOL_PROFILE_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ToolProfile.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A record of the wall-clock and CPU time spent in the phases of a run of a
+ * Tool (e.g., loading the model, initializing the system, reading inputs,
+ * solving and writing outputs), of the distribution of the times taken by
+ * repeated steps such as solving each frame, and of counters of the work done
+ * (e.g., the iterations of the solvers).
+ *
+ * Phases may be nested; a phase begun while another is open is part of it.
+ * The tools keep a profile of each run, and write it as a JSON file next to
+ * their results if setReportsEnabled() has been called (e.g., by
+ * `opensim-cmd run-tool --profile`), optionally along with a trace that can be
+ * opened in Chrome's chrome://tracing or in Perfetto.
+ *
+ * @code
+ * ToolProfile profile("InverseKinematicsTool walk1");
+ * {
+ *     ToolProfile::Scope phase(profile, "load model");
+ *     ...
+ * }
+ * for (...) {
+ *     const double start = SimTK::realTime();
+ *     ...
+ *     profile.addSample("solve frame", SimTK::realTime() - start);
+ * }
+ * profile.printReports(resultsDirectory);
+ * @endcode
+ */
+class OSIMCOMMON_API ToolProfile {
+public:
+    /** A phase that has ended. Times are in seconds; start is measured from
+    the construction of the profile. */
+    struct Phase {
+        std::string name;
+        int depth;
+        double start;
+        double wallTime;
+        double cpuTime;
+    };
+
+    /** Summary of the samples of a repeated step, in seconds. The median and
+    99th percentile are those of the nearest rank. */
+    struct Distribution {
+        size_t count = 0;
+        double total = 0;
+        double min = 0;
+        double median = 0;
+        double p99 = 0;
+        double max = 0;
+    };
+
+    /** Begins a phase on construction and ends it on destruction, including
+    when an exception is thrown. */
+    class Scope {
+    public:
+        Scope(ToolProfile& profile, const std::string& name) :
+            _profile(profile) { _profile.beginPhase(name); }
+        ~Scope() { _profile.endPhase(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        ToolProfile& _profile;
+    };
+
+    /** The name, e.g., the class and name of the Tool, identifies the profile
+    in its reports and names their files. */
+    explicit ToolProfile(const std::string& name);
+
+    const std::string& getName() const { return _name; }
+
+    /** Begin a phase, within any phase that is still open. */
+    void beginPhase(const std::string& name);
+    /** End the phase begun most recently that has not ended yet. */
+    void endPhase();
+
+    /** Record the time, in seconds, taken by one repetition of the step with
+    the given name. */
+    void addSample(const std::string& step, double seconds);
+
+    /** Add to the counter with the given name, e.g., the iterations of a
+    solver or the steps of an integrator, summed over the run. */
+    void addCount(const std::string& counter, double count);
+
+    /** The phases that have ended, in the order in which they began. */
+    std::vector<Phase> getPhases() const;
+    /** The names of the steps for which samples were recorded. */
+    std::vector<std::string> getStepNames() const;
+    /** Summary of the samples of the given step; empty if there are none. */
+    Distribution getDistribution(const std::string& step) const;
+    /** The names of the counters that were added to. */
+    std::vector<std::string> getCounterNames() const;
+    /** The total of the given counter; 0 if nothing was added to it. */
+    double getCount(const std::string& counter) const;
+
+    /** Write the phases, the distributions of the steps and the counters as
+    JSON. */
+    void printJSON(const std::string& fileName) const;
+    /** Write the phases in the Trace Event Format read by chrome://tracing. */
+    void printChromeTrace(const std::string& fileName) const;
+    /** If reports are enabled, write the JSON report, and the trace if traces
+    are enabled, to the given directory, named after the profile with the
+    suffixes _profile.json and _trace.json. */
+    void printReports(const std::string& directory) const;
+
+    /** Whether the tools write reports of their profiles. Off by default. */
+    static void setReportsEnabled(bool enabled);
+    static bool getReportsEnabled();
+    /** Whether the reports include a Chrome trace. Off by default. */
+    static void setChromeTraceEnabled(bool enabled);
+    static bool getChromeTraceEnabled();
+
+private:
+    struct OpenPhase {
+        size_t index;
+        double wallStart;
+        double cpuStart;
+    };
+
+    std::string _name;
+    double _origin;
+    // Phases in the order in which they began; those still open are also
+    // on the stack.
+    std::vector<Phase> _phases;
+    std::vector<OpenPhase> _open;
+    std::map<std::string, std::vector<double>> _samples;
+    std::map<std::string, double> _counts;
+
+    static bool _reportsEnabled;
+    static bool _chromeTraceEnabled;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_TOOL_PROFILE_H_
@@ -105,6 +105,14 @@ public:
     virtual void evaluate( const SimTK::State& s, const Array<double> &aX, Array<double> &rF, const Array<int> &aDerivWRT){
         std::cout << "VectorFunctionUncoupledNxN UNIMPLEMENTED: evaluate( const SimTK::State&, const Array<double>&a, Array<double>&, const Array<int>&)" << std::endl;
     }
+    /** Evaluate only the entries i for which aActive[i] is true, e.g., those
+    of the roots a RootSolver has not yet found. Because the entries are
+    uncoupled, the others need not be computed; they may be left unchanged
+    or set to their values at aX. By default, all entries are evaluated;
+    override this if computing fewer entries is cheaper. */
+    virtual void evaluate( const SimTK::State& s, const Array<double> &aX, Array<double> &rF, const Array<bool> &aActive){
+        evaluate(s, aX, rF);
+    }
 
 //=============================================================================
 };  // END class VectorFunctionUncoupledNxN
@@ -31,6 +31,7 @@
 //-----------------------------------------------------------------------------
 #include "XMLDocument.h"
 #include "Object.h"
+#include "XMLWriter.h"
 
 
 using namespace OpenSim;
@@ -273,6 +274,15 @@ void XMLDocument::writeDefaultObjects(SimTK::Xml::Element& elmt)
         _defaultObjects.get(i)->updateXMLNode(defaultsElement);
     }
 }
+void XMLDocument::writeDefaultObjects(XMLWriter& writer) const
+{
+    if (_defaultObjects.getSize()==0) return;
+    writer.startElement("defaults");
+    for(int i=0; i < _defaultObjects.getSize(); i++){
+        _defaultObjects.get(i)->writeToXMLStream(writer);
+    }
+    writer.endElement();
+}
 
 void XMLDocument::copyDefaultObjects(const XMLDocument &aDocument){
         _defaultObjects.setSize(0);
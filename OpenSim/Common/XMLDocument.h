@@ -55,6 +55,7 @@ namespace OpenSim {
 #endif
 
 class Object;
+class XMLWriter;
 
 class OSIMCOMMON_API XMLDocument  : public SimTK::Xml::Document {
 
@@ -83,6 +84,7 @@ public:
     XMLDocument(const XMLDocument &aDocument);
     void copyDefaultObjects(const XMLDocument &aDocument);
     void writeDefaultObjects(SimTK::Xml::Element& elmt);
+    void writeDefaultObjects(XMLWriter& writer) const;
     //--------------------------------------------------------------------------
     // VERSIONING /BACKWARD COMPATIBILITY SUPPORT
     //--------------------------------------------------------------------------    
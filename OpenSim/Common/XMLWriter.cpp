@@ -0,0 +1,268 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  XMLWriter.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "XMLWriter.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+using namespace OpenSim;
+
+namespace {
+// The buffer is written to the stream once it holds this many characters.
+const std::string::size_type BufferSize = 1 << 16;
+}
+
+XMLWriter::XMLWriter(std::ostream& out, const std::string& indentString) :
+    _out(out), _indentString(indentString), _startTagIsOpen(false) {
+    _buffer.reserve(BufferSize + 1024);
+}
+
+XMLWriter::~XMLWriter() {
+    flush();
+}
+
+void XMLWriter::writeDeclaration() {
+    beginChild();
+    _buffer += "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>";
+    endChild();
+}
+
+void XMLWriter::startElement(const std::string& tag) {
+    beginChild();
+    _buffer += '<';
+    _buffer += tag;
+    _openElements.emplace_back(tag, false);
+    _startTagIsOpen = true;
+}
+
+void XMLWriter::writeAttribute(const std::string& name,
+                               const std::string& value) {
+    assert(_startTagIsOpen);
+    _buffer += ' ';
+    appendEscaped(name);
+    // As in the Xml document, a value with a double quote is single-quoted.
+    const char quote = value.find('"') == std::string::npos ? '"' : '\'';
+    _buffer += '=';
+    _buffer += quote;
+    appendEscaped(value);
+    _buffer += quote;
+}
+
+void XMLWriter::endElement() {
+    assert(!_openElements.empty());
+    const std::pair<std::string, bool> element = _openElements.back();
+    _openElements.pop_back();
+    if (!element.second) {
+        _buffer += " />";
+    } else {
+        _buffer += '\n';
+        for (size_t i = 0; i < _openElements.size(); ++i)
+            _buffer += _indentString;
+        _buffer += "</";
+        _buffer += element.first;
+        _buffer += '>';
+    }
+    _startTagIsOpen = false;
+    endChild();
+}
+
+void XMLWriter::writeTextElement(const std::string& tag,
+                                 const std::string& text) {
+    beginChild();
+    _buffer += '<';
+    _buffer += tag;
+    _buffer += '>';
+    appendEscaped(text);
+    _buffer += "</";
+    _buffer += tag;
+    _buffer += '>';
+    endChild();
+}
+
+void XMLWriter::writeComment(const std::string& text) {
+    beginChild();
+    _buffer += "<!--";
+    _buffer += text;
+    _buffer += "-->";
+    endChild();
+}
+
+void XMLWriter::writeElement(SimTK::Xml::Element element) {
+    startElement(element.getElementTag());
+    for (SimTK::Xml::attribute_iterator it = element.attribute_begin();
+            it != element.attribute_end(); ++it)
+        writeAttribute(it->getName(), it->getValue());
+
+    int numChildren = 0;
+    for (SimTK::Xml::node_iterator it = element.node_begin();
+            it != element.node_end(); ++it)
+        ++numChildren;
+
+    // An element whose only child is text is written on one line.
+    if (numChildren == 1 &&
+            element.node_begin()->getNodeType() == SimTK::Xml::TextNode) {
+        _buffer += '>';
+        appendEscaped(element.node_begin()->getNodeText());
+        _buffer += "</";
+        _buffer += element.getElementTag();
+        _buffer += '>';
+        _openElements.pop_back();
+        _startTagIsOpen = false;
+        endChild();
+        return;
+    }
+
+    for (SimTK::Xml::node_iterator it = element.node_begin();
+            it != element.node_end(); ++it) {
+        switch (it->getNodeType()) {
+        case SimTK::Xml::ElementNode:
+            writeElement(SimTK::Xml::Element::getAs(*it));
+            break;
+        case SimTK::Xml::CommentNode:
+            writeComment(it->getNodeText());
+            break;
+        case SimTK::Xml::TextNode:
+            // Text among other nodes continues the line it is on.
+            if (_startTagIsOpen) {
+                _buffer += '>';
+                _startTagIsOpen = false;
+            }
+            _openElements.back().second = true;
+            appendEscaped(it->getNodeText());
+            break;
+        default:
+            beginChild();
+            _buffer += '<';
+            _buffer += it->getNodeText();
+            _buffer += '>';
+            endChild();
+            break;
+        }
+    }
+    endElement();
+}
+
+void XMLWriter::flush() {
+    _out.write(_buffer.data(), _buffer.size());
+    _buffer.clear();
+    _out.flush();
+}
+
+void XMLWriter::appendDouble(std::string& text, double value) {
+    if (SimTK::isNaN(value)) { text += "NaN"; return; }
+    if (SimTK::isInf(value)) { text += value > 0 ? "Inf" : "-Inf"; return; }
+
+    // Whole numbers, common in models, are written digit by digit; "%.17g"
+    // writes them the same way, without an exponent, below 1e15.
+    if (std::abs(value) < 1e15 && value == std::floor(value) &&
+            !(value == 0 && std::signbit(value))) {
+        const bool negative = value < 0;
+        unsigned long long n =
+            (unsigned long long)(negative ? -value : value);
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        do {
+            *--p = char('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        if (negative) *--p = '-';
+        text.append(p, end);
+        return;
+    }
+
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    text.append(buffer, length);
+}
+
+void XMLWriter::appendValues(std::string& text,
+                             const SimTK::Array_<double,int>& values) {
+    for (int i = 0; i < values.size(); ++i) {
+        if (i != 0) text += ' ';
+        appendDouble(text, values[i]);
+    }
+}
+
+void XMLWriter::beginChild() {
+    // Nodes at the top level of the document each start their own line.
+    if (_openElements.empty()) return;
+    if (_startTagIsOpen) {
+        _buffer += '>';
+        _startTagIsOpen = false;
+    }
+    _openElements.back().second = true;
+    _buffer += '\n';
+    for (size_t i = 0; i < _openElements.size(); ++i)
+        _buffer += _indentString;
+}
+
+void XMLWriter::endChild() {
+    if (_openElements.empty()) _buffer += '\n';
+    flushIfFull();
+}
+
+// The same escapes as the Xml document: the five predefined entities,
+// control characters as hexadecimal references, and hexadecimal references
+// already in the text passed through unchanged.
+void XMLWriter::appendEscaped(const std::string& text) {
+    const int length = (int)text.size();
+    int i = 0;
+    while (i < length) {
+        const unsigned char c = (unsigned char)text[i];
+        if (c == '&' && i < length - 2 &&
+                text[i + 1] == '#' && text[i + 2] == 'x') {
+            while (i < length - 1) {
+                _buffer += text[i];
+                ++i;
+                if (text[i] == ';') break;
+            }
+            continue;
+        }
+        switch (c) {
+        case '&':  _buffer += "&amp;"; break;
+        case '<':  _buffer += "&lt;"; break;
+        case '>':  _buffer += "&gt;"; break;
+        case '"':  _buffer += "&quot;"; break;
+        case '\'': _buffer += "&apos;"; break;
+        default:
+            if (c < 32) {
+                char reference[8];
+                std::snprintf(reference, sizeof(reference), "&#x%02X;",
+                              (unsigned)c);
+                _buffer += reference;
+            } else {
+                _buffer += (char)c;
+            }
+        }
+        ++i;
+    }
+}
+
+void XMLWriter::flushIfFull() {
+    if (_buffer.size() < BufferSize) return;
+    _out.write(_buffer.data(), _buffer.size());
+    _buffer.clear();
+}
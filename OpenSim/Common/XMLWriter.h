@@ -0,0 +1,156 @@
+#ifndef OPENSIM_XML_WRITER_H_
+#define OPENSIM_XML_WRITER_H_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  XMLWriter.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "osimCommonDLL.h"
+#include "SimTKcommon/SmallMatrix.h"
+#include "SimTKcommon/internal/Array.h"
+#include "SimTKcommon/internal/Serialize.h"
+#include "SimTKcommon/internal/Xml.h"
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OpenSim {
+
+/** Write an XML document to a stream as it is generated, rather than
+building it in memory as a SimTK::Xml::Document first. Object::print() uses
+it to write an Object, its properties and the objects they contain while
+traversing them, so that writing a large Model or a Set with much data
+needs no more memory than the Object itself.
+
+The output is laid out exactly as SimTK::Xml::Document::writeToFile() lays
+out the same nodes: each element, comment and value element on its own line,
+indented by one indent string per level; a value element (whose only child
+is text) on one line; an element without children as \<tag /\>; and the same
+escapes in text and attribute values. The text is collected in a buffer
+that is written to the stream in large blocks.
+
+@code
+std::ofstream file("setup.xml");
+XMLWriter writer(file);
+writer.writeDeclaration();
+writer.startElement("OpenSimDocument");
+writer.writeAttribute("Version", "30512");
+writer.writeTextElement("results_directory", "./Results");
+writer.endElement();
+writer.flush();
+@endcode
+
+A writer is not thread-safe. */
+class OSIMCOMMON_API XMLWriter {
+public:
+    /** Write to the given stream, which must outlive the writer, indenting
+    each level of elements by the given string. */
+    explicit XMLWriter(std::ostream& out,
+            const std::string& indentString = "\t");
+    /** Flush what is left in the buffer. */
+    ~XMLWriter();
+
+    XMLWriter(const XMLWriter&) = delete;
+    XMLWriter& operator=(const XMLWriter&) = delete;
+
+    /** Write the XML declaration; this must come first, if at all. */
+    void writeDeclaration();
+    /** Start an element with the given tag. Its attributes must follow
+    before its children, if any, and it must be ended by endElement(). */
+    void startElement(const std::string& tag);
+    /** Add an attribute to the element just started. */
+    void writeAttribute(const std::string& name, const std::string& value);
+    /** End the innermost element that was started. */
+    void endElement();
+    /** Write an element whose only child is the given text, which is
+    escaped. */
+    void writeTextElement(const std::string& tag, const std::string& text);
+    /** Write a comment, which is not escaped. */
+    void writeComment(const std::string& text);
+    /** Write an element already in a SimTK::Xml document, with all of its
+    attributes and child nodes. */
+    void writeElement(SimTK::Xml::Element element);
+
+    /** The number of elements started but not yet ended. */
+    int getDepth() const { return (int)_openElements.size(); }
+    /** Write the buffer to the stream and flush the stream. */
+    void flush();
+
+    /** A string that may be used to build the text of a value element
+    without allocating memory each time; it is cleared here. */
+    std::string& updTextBuffer() { _text.clear(); return _text; }
+
+    /** Append a double to the text just as SimTK::writeUnformatted() writes
+    it to a stream ("%.17g", or NaN, Inf or -Inf), but without the stream
+    or a temporary string. */
+    static void appendDouble(std::string& text, double value);
+
+    /** Append the values, separated by blanks, to the text just as
+    SimTK::writeUnformatted() writes them to a stream. Doubles, and Vecs of
+    them, are formatted by appendDouble(); values of other types through a
+    stream. */
+    template <class T>
+    static void appendValues(std::string& text,
+                             const SimTK::Array_<T,int>& values) {
+        std::ostringstream out;
+        SimTK::writeUnformatted(out, values);
+        text += out.str();
+    }
+    static void appendValues(std::string& text,
+                             const SimTK::Array_<double,int>& values);
+    template <int M>
+    static void appendValues(std::string& text,
+                             const SimTK::Array_<SimTK::Vec<M>,int>& values) {
+        for (int i = 0; i < values.size(); ++i) {
+            for (int j = 0; j < M; ++j) {
+                if (i != 0 || j != 0) text += ' ';
+                appendDouble(text, values[i][j]);
+            }
+        }
+    }
+
+private:
+    // Close the start tag of the parent element, if still open, and start
+    // the line of a new child node.
+    void beginChild();
+    // End a node at the top level of the document with a new line.
+    void endChild();
+    void appendEscaped(const std::string& text);
+    void flushIfFull();
+
+    std::ostream& _out;
+    std::string _indentString;
+    std::string _buffer;
+    std::string _text;
+
+    // The tags of the elements started but not yet ended, and whether each
+    // has children yet.
+    std::vector<std::pair<std::string, bool>> _openElements;
+    // Whether the start tag of the innermost element lacks its '>'.
+    bool _startTagIsOpen;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_XML_WRITER_H_
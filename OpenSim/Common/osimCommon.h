@@ -53,10 +53,18 @@
 #include "TimeSeriesTable.h"
 
 #include "Adapters.h"
+#include "DiskBackedStorage.h"
+#include "ToolProfile.h"
+#include "Logger.h"
+#include "ThreadPool.h"
+#include "ComponentProfiler.h"
+#include "LiveValues.h"
 
 #include "TableSource.h"
 
 #include "Reporter.h"
+#include "TableFileReporter.h"
+#include "SharedMemoryReporter.h"
 
 #include "ModelDisplayHints.h"
 
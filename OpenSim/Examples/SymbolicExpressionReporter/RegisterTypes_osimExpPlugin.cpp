@@ -40,7 +40,7 @@ static dllPluginObjectInstantiator dInstantiator;
 OSIMEXPPLUGIN_API void RegisterTypes_osimPlugin()
 {
     //Object::registerType( MyAnalysis() );
-    Object::registerType( SymbolicExpressionReporter() );
+    Object::registerType<SymbolicExpressionReporter>();
 }
 
 dllPluginObjectInstantiator::dllPluginObjectInstantiator() 
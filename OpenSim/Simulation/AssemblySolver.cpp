@@ -44,6 +44,13 @@ AssemblySolver::AssemblySolver
     _assembler = NULL;
     
     _constraintWeight = constraintWeight;
+    _goalsConstraintWeight = SimTK::NaN;
+
+    _trackDeadline = SimTK::Infinity;
+    _lastTrackDuration = 0;
+    _numDeadlineMisses = 0;
+    _numIterations = 0;
+    _totalNumIterations = 0;
 
     // default accuracy
     _accuracy = 1e-4;
@@ -94,6 +101,11 @@ void AssemblySolver::setupGoals(SimTK::State &s)
 
     // clear any old coordinate goals
     _coordinateAssemblyConditions.clear();
+    _coordinateGoalIndices.clear();
+    _coordinateGoalWeights.clear();
+    _lockedCoordinates.clear();
+    _clampedCoordinates.clear();
+    _goalsConstraintWeight = _constraintWeight;
 
     // Get model coordinates
     const CoordinateSet& modelCoordSet = getModel().getCoordinateSet();
@@ -101,48 +113,74 @@ void AssemblySolver::setupGoals(SimTK::State &s)
     // Restrict solution to set range of any of the coordinates that are clamped
     for(int i=0; i<modelCoordSet.getSize(); ++i){
         const Coordinate& coord = modelCoordSet[i];
-        if(coord.getClamped(s)){
+        _clampedCoordinates.push_back(coord.getClamped(s));
+        if(_clampedCoordinates.back()){
             _assembler->restrictQ(coord.getBodyIndex(), 
                 MobilizerQIndex(coord.getMobilizerQIndex()),
                 coord.getRangeMin(), coord.getRangeMax());
         }
     }
 
-    SimTK::Array_<CoordinateReference>::iterator p;
-
-    // Cycle through coordinate references
-    for(p = _coordinateReferencesp.begin(); 
-        p != _coordinateReferencesp.end(); p++) {
-        if(p){
-            CoordinateReference *coordRef = p;
-            const Coordinate &coord = modelCoordSet.get(coordRef->getName());
-            if(coord.getLocked(s)){
-                //cout << "AssemblySolver: coordinate " << coord.getName() << " is locked/prescribed and will be excluded." << endl;
-                _assembler->lockQ(coord.getBodyIndex(), SimTK::MobilizerQIndex(coord.getMobilizerQIndex()));
-                //No longer need the lock on
-                coord.setLocked(s, false);
-                
-                //Get rid of the corresponding reference too
-                _coordinateReferencesp.erase(p);
-                p--; //decrement since erase automatically points to next in the list
-            }
-            else if(!(coord.get_is_free_to_satisfy_constraints())) {
-                // Make this reference and its current value a goal of the Assembler
-                SimTK::QValue *coordGoal = new SimTK::QValue(coord.getBodyIndex(), SimTK::MobilizerQIndex(coord.getMobilizerQIndex()),
-                                                         coordRef->getValue(s) );
-                // keep a handle to the goal so we can update
-                _coordinateAssemblyConditions.push_back(coordGoal);
-                // Add coordinate matching goal to the ik objective
-                _assembler->adoptAssemblyGoal(coordGoal, coordRef->getWeight(s));
-            }
+    // Cycle through coordinate references. The references of locked
+    // coordinates are kept, without a goal, so that the goals can be set up
+    // again if the coordinates are unlocked.
+    for(unsigned int i=0; i<_coordinateReferencesp.size(); ++i){
+        const CoordinateReference& coordRef = _coordinateReferencesp[i];
+        const Coordinate &coord = modelCoordSet.get(coordRef.getName());
+        SimTK::QValue *coordGoal = nullptr;
+        SimTK::AssemblyConditionIndex goalIndex;
+        _lockedCoordinates.push_back(coord.getLocked(s));
+        if(_lockedCoordinates.back()){
+            //cout << "AssemblySolver: coordinate " << coord.getName() << " is locked/prescribed and will be excluded." << endl;
+            _assembler->lockQ(coord.getBodyIndex(), SimTK::MobilizerQIndex(coord.getMobilizerQIndex()));
+        }
+        else if(!(coord.get_is_free_to_satisfy_constraints())) {
+            // Make this reference and its current value a goal of the Assembler
+            coordGoal = new SimTK::QValue(coord.getBodyIndex(), SimTK::MobilizerQIndex(coord.getMobilizerQIndex()),
+                                          coordRef.getValue(s) );
+            // Add coordinate matching goal to the ik objective
+            goalIndex = _assembler->adoptAssemblyGoal(coordGoal, coordRef.getWeight(s));
         }
+        // keep a handle to the goal so we can update
+        _coordinateAssemblyConditions.push_back(coordGoal);
+        _coordinateGoalIndices.push_back(goalIndex);
+        _coordinateGoalWeights.push_back(coordRef.getWeight(s));
     }
+    //No longer need the locks on
+    unlockCoordinates(s);
+}
+
+bool AssemblySolver::canReuseGoals(const SimTK::State& s) const
+{
+    if(!_assembler || _goalsConstraintWeight != _constraintWeight)
+        return false;
+
+    const CoordinateSet& modelCoordSet = getModel().getCoordinateSet();
+    if(_clampedCoordinates.size() != (unsigned)modelCoordSet.getSize() ||
+            _lockedCoordinates.size() != _coordinateReferencesp.size())
+        return false;
 
-    unsigned int nqrefs  = _coordinateReferencesp.size(), 
-                 nqgoals = _coordinateAssemblyConditions.size();
-    //Should have a one-to-one matched arrays
-    if(nqrefs != nqgoals)
-        throw Exception("AsemblySolver::setupGoals() has a mismatch between number of references and goals.");
+    for(int i=0; i<modelCoordSet.getSize(); ++i){
+        if(modelCoordSet[i].getClamped(s) != _clampedCoordinates[i])
+            return false;
+    }
+    for(unsigned int i=0; i<_coordinateReferencesp.size(); ++i){
+        const Coordinate& coord =
+            modelCoordSet.get(_coordinateReferencesp[i].getName());
+        if(coord.getLocked(s) != _lockedCoordinates[i])
+            return false;
+    }
+    return true;
+}
+
+void AssemblySolver::unlockCoordinates(SimTK::State& s) const
+{
+    const CoordinateSet& modelCoordSet = getModel().getCoordinateSet();
+    for(unsigned int i=0; i<_lockedCoordinates.size(); ++i){
+        if(_lockedCoordinates[i])
+            modelCoordSet.get(_coordinateReferencesp[i].getName())
+                .setLocked(s, false);
+    }
 }
 
 /* Once a set of coordinates has been specified its target value can
@@ -155,7 +193,13 @@ void AssemblySolver::updateCoordinateReference(const std::string &coordName, dou
     for(p = _coordinateReferencesp.begin(); 
         p != _coordinateReferencesp.end(); p++) {
         if(p->getName() == coordName){
-            p->setValueFunction(*new Constant(value));
+            // Reuse the Constant rather than allocate a new one each time.
+            Constant* constant = dynamic_cast<Constant*>(
+                    &p->updValueFunction());
+            if(constant)
+                constant->setValue(value);
+            else
+                p->setValueFunction(Constant(value));
             p->setWeight(weight);
             return;
         }
@@ -169,10 +213,19 @@ void AssemblySolver::updateGoals(const SimTK::State &s)
 {
     unsigned int nqrefs = _coordinateReferencesp.size();
     for(unsigned int i=0; i<nqrefs; i++){
+        if(!_coordinateAssemblyConditions[i])
+            continue;
         //update goal values from reference.
         _coordinateAssemblyConditions[i]->setValue
            ((_coordinateReferencesp)[i].getValue(s));
-        //_assembler->setAssemblyConditionWeight(_coordinateAssemblyConditions[i]->
+        // Changing a weight uninitializes the Assembler, so only do so when
+        // the weight is in fact different.
+        const double weight = _coordinateReferencesp[i].getWeight(s);
+        if(weight != _coordinateGoalWeights[i]){
+            _assembler->setAssemblyConditionWeight(
+                _coordinateGoalIndices[i], weight);
+            _coordinateGoalWeights[i] = weight;
+        }
     }
 }
 
@@ -190,8 +243,14 @@ void AssemblySolver::assemble(SimTK::State &state)
     // constraints the user expects
     SimTK::State s = state;
     
-    // Make sure goals are up-to-date.
-    setupGoals(s);
+    // Make sure goals are up-to-date. Build them only if the locked and
+    // clamped coordinates have changed since they were last set up.
+    if(canReuseGoals(s)){
+        unlockCoordinates(s);
+        updateGoals(s);
+    }
+    else
+        setupGoals(s);
 
     // Let assembler perform some internal setup
     _assembler->initialize(s);
@@ -204,9 +263,11 @@ void AssemblySolver::assemble(SimTK::State &state)
     cout << "Model numQs: " << _assembler->getInternalState().getNQ() 
         << " Assembler num freeQs: " << _assembler->getNumFreeQs() << endl;
     */
+    const int numStepsBefore = _assembler->getNumAssemblySteps();
     try{
         // Now do the assembly and return the updated state.
         _assembler->assemble();
+        countIterations(numStepsBefore);
         // Update the q's in the state passed in
         _assembler->updateFromInternalState(s);
         state.updQ() = s.getQ();
@@ -234,6 +295,7 @@ void AssemblySolver::assemble(SimTK::State &state)
     }
     catch (const std::exception& ex)
     {
+        countIterations(numStepsBefore);
         std::string msg = "AssemblySolver::assemble() Failed: ";
         msg += ex.what();
         throw Exception(msg);
@@ -268,12 +330,19 @@ void AssemblySolver::track(SimTK::State &s)
         << " Assembler num freeQs: " << _assembler->getNumFreeQs() << endl;
     */
 
+    const double start = SimTK::realTime();
+    const int numStepsBefore = _assembler->getNumAssemblySteps();
     try{
-        // Now do the assembly and return the updated state.
+        // Now do the assembly and return the updated state. The Assembler
+        // starts from its previous solution.
         _assembler->track(s.getTime());
+        countIterations(numStepsBefore);
 
         // update the state from the result of the assembler 
         _assembler->updateFromInternalState(s);
+        _lastTrackDuration = SimTK::realTime() - start;
+        if(_lastTrackDuration > _trackDeadline)
+            ++_numDeadlineMisses;
         
         /* TODO: Useful to include through debug message/log in the future
         printf("Tracking: t= %f (acc=%g tol=%g normerr=%g, maxerr=%g, cost=%g)\n", 
@@ -285,11 +354,25 @@ void AssemblySolver::track(SimTK::State &s)
     }
     catch (const std::exception& ex)
     {
+        _lastTrackDuration = SimTK::realTime() - start;
+        countIterations(numStepsBefore);
+        // With a deadline, report the miss and keep the previous solution
+        // rather than stall the caller.
+        if(_trackDeadline < SimTK::Infinity){
+            ++_numDeadlineMisses;
+            return;
+        }
         std::cout << "AssemblySolver::track() attempt Failed: " << ex.what() << std::endl;
         throw Exception("AssemblySolver::track() attempt failed.");
     }
 }
 
+void AssemblySolver::countIterations(int numStepsBefore)
+{
+    _numIterations = _assembler->getNumAssemblySteps() - numStepsBefore;
+    _totalNumIterations += _numIterations;
+}
+
 const SimTK::Assembler& AssemblySolver::getAssembler() const
 {
     OPENSIM_THROW_IF(!_assembler, Exception,
@@ -55,6 +55,11 @@ class Model;
  * then track() is a efficient method for updating the configuration to track
  * the small change to the desired coordinate value.
  *
+ * The underlying SimTK::Assembler and its goals are kept from one call to the
+ * next. assemble() only rebuilds them when the locked or clamped coordinates,
+ * or the constraint weight, differ from when they were built; otherwise the
+ * existing goals are updated with the new reference values and weights.
+ *
  * See SimTK::Assembler for more algorithmic details of the underlying solver.
  *
  * @author Ajay Seth
@@ -90,6 +95,10 @@ public:
         append the constraint errors to the assembly cost which the solver will
         minimize.*/
     void setConstraintWeight(double weight) {_constraintWeight = weight; }
+
+    /** Whether assemble() (or track()) can reuse the goals of the underlying
+        SimTK::Assembler for the given state, rather than set them up anew. */
+    bool canReuseGoals(const SimTK::State& s) const;
     
     /** Specify which coordinates to match, each with a desired value and a
         relative weighting. */
@@ -118,6 +127,27 @@ public:
     /** Read access to the underlying SimTK::Assembler. */
     const SimTK::Assembler& getAssembler() const;
 
+    /** %Set the wall-clock time, in seconds, that a call to track() should
+        take, e.g., to keep up with data streamed in real time. A track() that
+        takes longer is counted as a deadline miss. With a finite deadline, a
+        track() that fails to converge is also counted as a miss and leaves
+        the state at the previous solution, rather than throwing. The default
+        is Infinity (no deadline). */
+    void setTrackDeadline(double seconds) { _trackDeadline = seconds; }
+    double getTrackDeadline() const { return _trackDeadline; }
+    /** The wall-clock time, in seconds, that the last track() took. */
+    double getLastTrackDuration() const { return _lastTrackDuration; }
+    /** The number of calls to track() that missed the deadline. */
+    int getNumDeadlineMisses() const { return _numDeadlineMisses; }
+
+    /** The number of iterations (assembly steps of the SimTK::Assembler)
+        taken by the last call to assemble() or track(), e.g., to see which
+        frames of a trajectory are hard to solve. */
+    int getNumIterations() const { return _numIterations; }
+    /** The number of iterations of all calls to assemble() and track() since
+        this solver was constructed. */
+    long long getTotalNumIterations() const { return _totalNumIterations; }
+
 protected:
     /** Internal method to convert the CoordinateReferences into goals of the 
         assembly solver. Subclasses, can add and override to include other goals  
@@ -126,13 +156,17 @@ protected:
     virtual void setupGoals(SimTK::State &s);
     /** Internal method to update the time, reference values and/or their 
         weights that define the goals, based on the passed in state. This method
-        is called at the end of setupGoals() and beginning of track()*/
+        is called at the end of setupGoals(), at the beginning of track() and
+        by assemble() when the goals are reused. */
     virtual void updateGoals(const SimTK::State &s);
 
     /** Write access to the underlying SimTK::Assembler. */
     SimTK::Assembler& updAssembler();
 
 private:
+    // Unlock the locked coordinates of the (working copy of the) state. The
+    // Assembler holds their values fixed instead (see setupGoals()).
+    void unlockCoordinates(SimTK::State& s) const;
 
     // The assembly solution accuracy
     double _accuracy;
@@ -146,7 +180,31 @@ private:
     // Underlying SimTK::Assembler that will perform the assembly
     SimTK::ResetOnCopy< std::unique_ptr<SimTK::Assembler>> _assembler;
 
+    // The goal of each coordinate reference, and the weight it was given in
+    // the Assembler; null for references of locked coordinates, or of
+    // coordinates that are free to satisfy the constraints.
     SimTK::Array_<SimTK::QValue*> _coordinateAssemblyConditions;
+    SimTK::Array_<SimTK::AssemblyConditionIndex> _coordinateGoalIndices;
+    SimTK::Array_<double> _coordinateGoalWeights;
+
+    // What the goals were set up for: the locked coordinate references, the
+    // clamped coordinates of the model and the constraint weight.
+    SimTK::Array_<bool> _lockedCoordinates;
+    SimTK::Array_<bool> _clampedCoordinates;
+    double _goalsConstraintWeight;
+
+    // Wall-clock time allotted to track(), and how it went.
+    double _trackDeadline;
+    double _lastTrackDuration;
+    int _numDeadlineMisses;
+
+    // Iterations of the last assemble() or track(), and of all of them.
+    int _numIterations;
+    long long _totalNumIterations;
+
+    // Count the iterations the Assembler took since it had taken the given
+    // number of assembly steps.
+    void countIterations(int numStepsBefore);
 //=============================================================================
 };  // END of class AssemblySolver
 //=============================================================================
@@ -28,9 +28,75 @@
 #include <OpenSim/Common/PropertySet.h>
 #include "ControlLinear.h"
 
+#include <algorithm>
+
 using namespace OpenSim;
 using namespace std;
 
+namespace {
+    // Find the index of the last node whose time is not greater than aT, or
+    // -1 if aT is before the first node, as ArrayPtrs::searchBinary() does
+    // given a node at time aT. Unlike a search with _searchNode, this does not
+    // modify the control, so it can be used while the controls of a model are
+    // computed by several threads.
+    int findNodeAtOrBefore(const ArrayPtrs<ControlLinearNode>& aNodes,
+                           double aT)
+    {
+        int lo = 0, hi = aNodes.getSize();
+        while (lo < hi) {
+            const int mid = (lo + hi) / 2;
+            if (aT < aNodes[mid]->getTime())
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        return lo - 1;
+    }
+
+    // Evaluate a control curve at aT given the index i of the last node at or
+    // before aT, as found by findNodeAtOrBefore(). The nodes are accessed
+    // through time(k) and value(k), so that the nodes of a ControlLinear and
+    // of a ControlLinear::Curve are evaluated the same way.
+    template <typename Time, typename Value>
+    double evaluateNodes(int size, int i, double aT, bool useSteps,
+                         bool extrapolate, Time time, Value value)
+    {
+        // BEFORE FIRST
+        if(i<0) {
+            if(!useSteps && extrapolate && size>1)
+                return ControlLinear::Interpolate(time(0),value(0),
+                                                  time(1),value(1),aT);
+            return value(0);
+        }
+
+        // AFTER LAST
+        if(i>=(size-1)) {
+            if(!useSteps && extrapolate && size>1)
+                return ControlLinear::Interpolate(time(size-2),value(size-2),
+                                                  time(size-1),value(size-1),aT);
+            return value(size-1);
+        }
+
+        // LINEAR INTERPOLATION
+        if(!useSteps)
+            return ControlLinear::Interpolate(time(i),value(i),
+                                              time(i+1),value(i+1),aT);
+
+        // STEPS
+        // Eran: Changed semantics of piecewise constant controls so that
+        // the control value stored at time t(i+1) is applied to the time
+        // interval (t(i),t(i+1)] *exclusive* of time t(i).
+        // This was essential to get forward simulation to match cmcgait simulation
+        // much better.  During cmcgait simulation of interval [t1,t2] when the
+        // integrator reaches time t2 it would pick up the control value at t2
+        // because it had yet to compute the piecewise linear control value
+        // at time t3.  During forward simulation, when the integrator reaches t2
+        // the control at t3 is known but for consistency with cmcgait we need to
+        // use the control value at t2.  Hence the (t(i),t(i+1)] choice.
+        if (aT == time(i)) return value(i);
+        return value(i+1);
+    }
+}
 
 //=============================================================================
 // CONSTRUCTOR(S)
@@ -425,56 +491,11 @@ getControlValue(ArrayPtrs<ControlLinearNode> &aNodes,double aT)
     if(size<=0) return(SimTK::NaN);
 
     // GET NODE
-    _searchNode.setTime(aT);
-    int i = aNodes.searchBinary(_searchNode);
+    int i = findNodeAtOrBefore(aNodes, aT);
 
-    // BEFORE FIRST
-    double value;
-    if(i<0) {
-        if(!_useSteps && getExtrapolate()) {
-            value = extrapolateBefore(aNodes, aT);
-        } else {
-            value = aNodes[0]->getValue();
-        }
-
-    // AFTER LAST
-    } else if(i>=(size-1)) {
-        if(!_useSteps && getExtrapolate()) {
-            value = extrapolateAfter(aNodes, aT);
-        } else {
-            value = aNodes.getLast()->getValue();
-        }
-
-    // IN BETWEEN
-    } else {
-
-        // LINEAR INTERPOLATION
-        if(!_useSteps) {
-            double t1,v1,t2,v2;
-            t1 = aNodes[i]->getTime();
-            v1 = aNodes[i]->getValue();
-            t2 = aNodes[i+1]->getTime();
-            v2 = aNodes[i+1]->getValue();
-            value = Interpolate(t1,v1,t2,v2,aT);
-
-        // STEPS
-        } else {
-            // Eran: Changed semantics of piecewise constant controls so that
-            // the control value stored at time t(i+1) is applied to the time
-            // interval (t(i),t(i+1)] *exclusive* of time t(i).
-            // This was essential to get forward simulation to match cmcgait simulation
-            // much better.  During cmcgait simulation of interval [t1,t2] when the
-            // integrator reaches time t2 it would pick up the control value at t2
-            // because it had yet to compute the piecewise linear control value
-            // at time t3.  During forward simulation, when the integrator reaches t2
-            // the control at t3 is known but for consistency with cmcgait we need to
-            // use the control value at t2.  Hence the (t(i),t(i+1)] choice.
-            if (aT == aNodes[i]->getTime()) value = aNodes[i]->getValue();
-            else value = aNodes[i+1]->getValue();
-        }
-    }
-
-    return(value);
+    return evaluateNodes(size, i, aT, _useSteps, getExtrapolate(),
+        [&](int k) { return aNodes[k]->getTime(); },
+        [&](int k) { return aNodes[k]->getValue(); });
 }
 
 double ControlLinear::
@@ -612,6 +633,25 @@ clearControlNodes()
     _xNodes.setSize(0);
 }
 //_____________________________________________________________________________
+void ControlLinear::
+setControlValues(int aN,const double aTimes[],const double aValues[])
+{
+    clearControlNodes();
+    if(aN<=0) return;
+
+    bool increasing = true;
+    for(int i=1;i<aN && increasing;i++)
+        increasing = aTimes[i] > aTimes[i-1];
+    if(!increasing) {
+        for(int i=0;i<aN;i++) setControlValue(aTimes[i],aValues[i]);
+        return;
+    }
+
+    _xNodes.ensureCapacity(aN);
+    for(int i=0;i<aN;i++)
+        _xNodes.append(new ControlLinearNode(aTimes[i],aValues[i]));
+}
+//_____________________________________________________________________________
 const double ControlLinear::getFirstTime() const
 {
     const ControlLinearNode *node=_xNodes.get(0);
@@ -624,6 +664,55 @@ const double ControlLinear::getLastTime() const
     return node->getTime();
 }
 
+//-----------------------------------------------------------------------------
+// CURVE
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+ControlLinear::Curve ControlLinear::
+getControlCurve() const
+{
+    Curve curve;
+    int size = _xNodes.getSize();
+    curve._times.resize(size);
+    curve._values.resize(size);
+    for(int i=0;i<size;i++) {
+        curve._times[i] = _xNodes[i]->getTime();
+        curve._values[i] = _xNodes[i]->getValue();
+    }
+    curve._useSteps = _useSteps;
+    curve._extrapolate = getExtrapolate();
+    return curve;
+}
+//_____________________________________________________________________________
+double ControlLinear::Curve::
+calcValue(double aT, int& rCursor) const
+{
+    int size = (int)_times.size();
+    if(size<=0) return(SimTK::NaN);
+
+    // Whether node k is at or before aT, and whether it is after aT, where
+    // the nodes -1 and size are before and after all times.
+    auto atOrBefore = [&](int k) { return k<0 || _times[k]<=aT; };
+    auto after = [&](int k) { return k>=size || aT<_times[k]; };
+
+    // The node of the previous call, or the next one, is tried before
+    // searching all the nodes.
+    int i = rCursor;
+    if(i<-1 || i>=size || !atOrBefore(i) || !after(i+1)) {
+        if(i>=-1 && i<size-1 && atOrBefore(i+1) && after(i+2)) {
+            ++i;
+        } else {
+            i = (int)(std::upper_bound(_times.begin(),_times.end(),aT)
+                      - _times.begin()) - 1;
+        }
+    }
+    rCursor = i;
+
+    return evaluateNodes(size, i, aT, _useSteps, _extrapolate,
+        [this](int k) { return _times[k]; },
+        [this](int k) { return _values[k]; });
+}
+
 //-----------------------------------------------------------------------------
 // SIMPLIFY
 //-----------------------------------------------------------------------------
@@ -35,6 +35,8 @@
 #include "Control.h"
 #include "ControlLinearNode.h"
 
+#include <vector>
+
 
 //=============================================================================
 //=============================================================================
@@ -302,6 +304,15 @@ public:
     
     // NODE ARRAY
     void clearControlNodes();
+#ifndef SWIG
+    /**
+     * Replace the control value nodes with one node for each of aN samples.
+     * When the times increase, as they do in a file of controls, the nodes
+     * are appended in bulk rather than searched for and inserted one at a
+     * time; otherwise each sample is set by setControlValue().
+     */
+    void setControlValues(int aN,const double aTimes[],const double aValues[]);
+#endif
     ArrayPtrs<ControlLinearNode>& getControlValues() {
         return (_xNodes);
     }
@@ -381,6 +392,55 @@ public:
      */
     static double Interpolate(double aX1,double aY1,double aX2,double aY2,double aX);
 
+#ifndef SWIG
+    //--------------------------------------------------------------------------
+    // CURVE
+    //--------------------------------------------------------------------------
+    /**
+     * The control curve of a ControlLinear, with the times and values of its
+     * nodes copied into contiguous arrays. A caller that evaluates the curve
+     * at times that change little from one call to the next (e.g., the times
+     * of a simulation) keeps a cursor, the index of the node found by the
+     * previous call, from which the node at the next time is usually found
+     * without searching all the nodes.
+     *
+     * A Curve is a copy: it does not change when the nodes of the control
+     * are changed.
+     */
+    class OSIMSIMULATION_API Curve {
+    public:
+        /** A curve without any node, whose value is NaN. */
+        Curve() = default;
+
+        int getNumNodes() const { return (int)_times.size(); }
+
+        /**
+         * Evaluate the curve at time aT, as getControlValue() evaluates the
+         * control the curve was copied from.
+         *
+         * @param aT Time at which to evaluate the curve.
+         * @param rCursor The index of the node found by the previous call,
+         * which is updated to the index of the last node at or before aT (-1
+         * if aT is before the first node). Any value is accepted, e.g., 0 for
+         * the first call.
+         */
+        double calcValue(double aT, int& rCursor) const;
+
+    private:
+        friend class ControlLinear;
+        std::vector<double> _times;
+        std::vector<double> _values;
+        bool _useSteps = false;
+        bool _extrapolate = false;
+    };
+
+    /**
+     * Copy the control nodes (not the min or max nodes) of this control into
+     * a Curve.
+     */
+    Curve getControlCurve() const;
+#endif
+
 private:
     void setControlValue(ArrayPtrs<ControlLinearNode> &aNodes,double aT,double aX);
     double getControlValue(ArrayPtrs<ControlLinearNode> &aNodes,double aT);
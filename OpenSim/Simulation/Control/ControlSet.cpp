@@ -34,6 +34,8 @@
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/XMLDocument.h>
 
+#include <algorithm>
+
 
 using namespace OpenSim;
 using namespace std;
@@ -127,6 +129,33 @@ ControlSet::ControlSet(const Storage& aStorage, int numControls, int startIndex)
 
 }
 
+//_____________________________________________________________________________
+/**
+ * Constructor from a table with a column of control values for each control,
+ * as written by exportToTable(). Each column becomes a ControlLinear with a
+ * node at each time of the table.
+ *
+ * @param aTable Table to get the controls from.
+ */
+ControlSet::ControlSet(const TimeSeriesTable& aTable) :
+    _ptcMap(-1), _ptpMap(-1)
+{
+    setNull();
+    const std::vector<double>& times = aTable.getIndependentColumn();
+    const int nTimes = (int)times.size();
+    std::vector<double> values(nTimes);
+    for(size_t j=0;j<aTable.getNumColumns();j++) {
+        const auto column = aTable.getDependentColumnAtIndex(j);
+        for(int i=0;i<nTimes;i++) values[i] = column[i];
+
+        ControlLinear *control = new ControlLinear;
+        control->setName(aTable.getColumnLabel(j));
+        control->setControlValues(nTimes,times.data(),values.data());
+        adoptAndAppend(control);
+    }
+    generateParameterMaps();
+}
+
 //=============================================================================
 // CONSTRUCTION
 //=============================================================================
@@ -959,6 +988,64 @@ constructStorage(int aN,double aT1,double aT2,bool aForModelControls)
 
     return(store);
 }
+//_____________________________________________________________________________
+/**
+ * Export the values of the controls to a table with a column for each
+ * control. The rows are at the union of the times of the value nodes of the
+ * ControlLinear controls. When these share their node times, as do those
+ * computed by CMC and RRA, constructing a ControlSet from the table
+ * reproduces their value nodes. The minimum and maximum nodes are not
+ * exported.
+ *
+ * @param aForModelControls If true, only model controls are exported.
+ * @return Table of control values.
+ */
+TimeSeriesTable ControlSet::
+exportToTable(bool aForModelControls) const
+{
+    // The value nodes of the ControlLinear controls, by column.
+    std::vector<Control*> controls;
+    std::vector<const ArrayPtrs<ControlLinearNode>*> nodes;
+    std::vector<std::string> labels;
+    std::vector<double> times;
+    const int size = getSize(false);
+    for(int i=0;i<size;i++) {
+        Control& control = get(i);
+        if(aForModelControls && !control.getIsModelControl()) continue;
+        controls.push_back(&control);
+        labels.push_back(control.getName());
+        ControlLinear* linear = dynamic_cast<ControlLinear*>(&control);
+        nodes.push_back(linear ? &linear->getControlValues() : NULL);
+        if(linear == NULL) continue;
+        for(int k=0;k<nodes.back()->getSize();k++)
+            times.push_back((*nodes.back())[k]->getTime());
+    }
+    std::sort(times.begin(),times.end());
+    times.erase(std::unique(times.begin(),times.end()),times.end());
+
+    // A value at the time of one of a control's nodes is the node's value;
+    // others are the control's value at that time.
+    TimeSeriesTable table{};
+    table.setColumnLabels(labels);
+    SimTK::RowVector row((int)labels.size());
+    std::vector<int> next(labels.size(),0);
+    for(double t : times) {
+        for(size_t j=0;j<controls.size();j++) {
+            const ArrayPtrs<ControlLinearNode>* x = nodes[j];
+            if(x != NULL) {
+                while(next[j]<x->getSize() && (*x)[next[j]]->getTime()<t)
+                    next[j]++;
+                if(next[j]<x->getSize() && (*x)[next[j]]->getTime()==t) {
+                    row[(int)j] = (*x)[next[j]]->getValue();
+                    continue;
+                }
+            }
+            row[(int)j] = controls[j]->getControlValue(t);
+        }
+        table.appendRow(t,row);
+    }
+    return table;
+}
 //-----------------------------------------------------------------------------
 // PARAMETER MAPS
 //-----------------------------------------------------------------------------
@@ -1044,8 +1131,6 @@ generateParameterMaps()
 ControlLinear*
 ControlSet::ExtractControl(const Storage& storage,int index)
 {
-    int i;
-
     // cout << "index=" << index << endl;
     // NAME ATTRIBUTE
     const Array<std::string> &columnLabels = storage.getColumnLabels();
@@ -1071,8 +1156,6 @@ ControlSet::ExtractControl(const Storage& storage,int index)
     // APPEND CONTROL ELEMENTS
     int n = nTimes;
     if(n>nValues) n = nValues;
-    for(i=0;i<n;i++) {
-        control->setControlValue(times[i],values[i]);
-    }
+    control->setControlValues(n,times,values);
     return(control);
 }
@@ -31,6 +31,7 @@
 // INCLUDES
 #include "Control.h"
 #include <OpenSim/Common/Set.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
 
 
 //=============================================================================
@@ -75,6 +76,10 @@ public:
     // Constructor from a storage, useful for connecting result files to 
     // analyses that expect ControlSets. Default arguments 
     ControlSet(const Storage& aStorage, int nControlsToConvert=0, int aStartIndex=0);
+    // Constructor from a table of control values, such as one read from an
+    // STO or binary (.otb) file, which is much faster to load than the
+    // equivalent XML file.
+    explicit ControlSet(const TimeSeriesTable& aTable);
 private:
     void setNull();
     void setupProperties();
@@ -141,6 +146,7 @@ public:
     void filter(double aT);
     Storage*
         constructStorage(int aN,double aT1,double aT2,bool aForModelControls);
+    TimeSeriesTable exportToTable(bool aForModelControls=true) const;
     int mapParameterToControl(int aIndex) const;
     int mapParameterToParameter(int aIndex) const;
     void generateParameterMaps();
@@ -162,23 +162,20 @@ void ControlSetController::computeControls(const SimTK::State& s, SimTK::Vector&
 {
     SimTK_ASSERT( _controlSet , "ControlSetController::computeControls controlSet is NULL");
 
-    std::string actName = "";
-    int index = -1;
+    const double time = s.getTime();
+    SimTK::Array_<int>& cursors = _cursorsCV->updValue(s);
 
     int na = getActuatorSet().getSize();
 
     for(int i=0; i< na; ++i){
-        actName = getActuatorSet()[i].getName();
-        index = _controlSet->getIndex(actName);
-        if(index < 0){
-            actName = actName + ".excitation";
-            index = _controlSet->getIndex(actName);
-        }
-
-        if(index >= 0){
-            SimTK::Vector actControls(1, _controlSet->get(index).getControlValue(s.getTime()));
-            getActuatorSet()[i].addInControls(actControls, controls);
-        }
+        int index = _controlIndices->at(i);
+        if(index < 0) continue;
+
+        const ControlLinear::Curve& curve = _controlCurves->at(i);
+        const double control = curve.getNumNodes() > 0
+                ? curve.calcValue(time, cursors[i])
+                : _controlSet->get(index).getControlValue(time);
+        getActuatorSet()[i].addInControl(control, controls);
     }
 }
 
@@ -232,6 +229,9 @@ void ControlSetController::extendFinalizeFromProperties()
         try {
             if (_controlsFileName.rfind(".sto") != std::string::npos)
                 loadedControlSet = new ControlSet(Storage(_controlsFileName));
+            else if (_controlsFileName.rfind(".otb") != std::string::npos)
+                loadedControlSet =
+                    new ControlSet(TimeSeriesTable(_controlsFileName));
             else
                 loadedControlSet = new ControlSet(_controlsFileName);
         }
@@ -274,3 +274,37 @@ void ControlSetController::extendFinalizeFromProperties()
             updProperty_actuator_list().appendValue(actName);
     }
 }
+
+void ControlSetController::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    // Look up the control of each actuator by name once, rather than at each
+    // call to computeControls().
+    int na = getActuatorSet().getSize();
+    _controlIndices->assign(na, -1);
+    _controlCurves->assign(na, ControlLinear::Curve());
+    for(int i=0; _controlSet != nullptr && i < na; ++i){
+        std::string actName = getActuatorSet()[i].getName();
+        int index = _controlSet->getIndex(actName);
+        if(index < 0)
+            index = _controlSet->getIndex(actName + ".excitation");
+        _controlIndices->at(i) = index;
+
+        if(index >= 0){
+            const ControlLinear* control =
+                dynamic_cast<const ControlLinear*>(&_controlSet->get(index));
+            if(control)
+                _controlCurves->at(i) = control->getControlCurve();
+        }
+    }
+}
+
+void ControlSetController::extendAddToSystem(
+        SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    _cursorsCV = addCacheVariable("control_cursors",
+        SimTK::Array_<int>(getActuatorSet().getSize(), 0),
+        SimTK::Stage::Topology);
+}
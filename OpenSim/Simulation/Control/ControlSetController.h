@@ -31,6 +31,7 @@
 // These files contain declarations and definitions of variables and methods
 // that will be used by the Controller class.
 #include "Controller.h"
+#include "ControlLinear.h"
 #include <OpenSim/Common/PropertyStr.h>
 
 //=============================================================================
@@ -110,6 +111,9 @@ protected:
 
     /// read in ControlSet and update Controller's actuator list
     void extendFinalizeFromProperties() override;
+    /// find the control of each actuator and copy the ControlLinear curves
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
 
     //--------------------------------------------------------------------------
     // OPERATORS
@@ -148,6 +152,18 @@ public:
    double getFirstTime() const;
    double getLastTime() const;
 
+private:
+    // The index in the ControlSet of the control of each actuator (-1 if the
+    // actuator has none), found when connecting to the model.
+    SimTK::ResetOnCopy<std::vector<int>> _controlIndices;
+    // The curve of the control of each actuator, if it is a ControlLinear.
+    // The curves are copied when connecting to the model, so changes to the
+    // ControlSet apply after the next Model::initSystem().
+    SimTK::ResetOnCopy<std::vector<ControlLinear::Curve>> _controlCurves;
+    // A cursor per actuator into its curve, kept in the State so that each
+    // State (e.g., one per thread) follows its own time.
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Array_<int>>> _cursorsCV;
+
 //=============================================================================
 };  // END of class ControlSetController
 
@@ -0,0 +1,76 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  LiveController.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "LiveController.h"
+#include <OpenSim/Simulation/Model/Actuator.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+/*
+ * Default constructor.
+ */
+LiveController::LiveController() :
+    Controller()
+{
+}
+
+void LiveController::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    const int n = getActuatorSet().getSize();
+    for (int i = 0; i < n; ++i) {
+        OPENSIM_THROW_IF_FRMOBJ(getActuatorSet()[i].numControls() != 1,
+            Exception, "Expected actuators with one control each, but '" +
+            getActuatorSet()[i].getName() + "' has " +
+            to_string(getActuatorSet()[i].numControls()) + ".");
+    }
+    if (!_liveControls || _liveControls->getSize() != n)
+        _liveControls.reset(new LiveValues(n));
+}
+
+LiveValues& LiveController::getLiveControls() const
+{
+    OPENSIM_THROW_IF_FRMOBJ(!_liveControls, Exception,
+        "The controller is not connected to its model.");
+    return *_liveControls;
+}
+
+// add the latest live control of each actuator
+void LiveController::computeControls(const SimTK::State& s,
+                                     SimTK::Vector& controls) const
+{
+    double time;
+    SimTK::Vector values;
+    if (!_liveControls || !_liveControls->read(time, values)) return;
+
+    for (int i = 0; i < getActuatorSet().getSize(); ++i)
+        getActuatorSet()[i].addInControl(values[i], controls);
+}
@@ -0,0 +1,106 @@
+#ifndef OPENSIM_LIVE_CONTROLLER_H_
+#define OPENSIM_LIVE_CONTROLLER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  LiveController.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "Controller.h"
+#include <OpenSim/Common/LiveValues.h>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * LiveController is a concrete Controller whose controls are written while
+ * the simulation runs, by another thread (e.g., the interface to the
+ * hardware of an exoskeleton whose controller is being tested against the
+ * model in real time; see Manager::setRealTimeStepSize()).
+ *
+ * The controls of its actuators, one per actuator in the order of the
+ * actuator_list property, are written to getLiveControls() with
+ * LiveValues::write() or writeControls(), which never wait for the
+ * simulation. computeControls() adds the latest controls written to those of
+ * the model; until the first write it adds nothing. Other Controllers can
+ * read live signals the same way, from LiveValues of their own.
+ *
+ * Since the controls depend on when they were written rather than on the
+ * State, the controls computed again for a State (e.g., by an analysis
+ * that runs after the integration, or on the output queue of the Manager)
+ * may differ from those used to integrate it.
+ *
+ * @code
+ * LiveController* live = new LiveController();
+ * live->addActuator(model.getComponent<Actuator>("exo_hip_r"));
+ * model.addController(live);
+ * model.initSystem();
+ * // On the hardware thread:
+ * live->writeControls(time, SimTK::Vector(1, torque));
+ * @endcode
+ */
+//=============================================================================
+
+class OSIMSIMULATION_API LiveController : public Controller {
+OpenSim_DECLARE_CONCRETE_OBJECT(LiveController, Controller);
+
+public:
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION AND DESTRUCTION
+    //--------------------------------------------------------------------------
+    /** Default constructor */
+    LiveController();
+
+    //--------------------------------------------------------------------------
+    // CONTROL
+    //--------------------------------------------------------------------------
+    /** Add the latest controls written to those of the model. */
+    void computeControls(const SimTK::State& s,
+                         SimTK::Vector& controls) const override;
+
+    /** The controls of the actuators, one per actuator, written from any
+    one thread at a time. Available once the controller is connected to its
+    model, which sets its size; connect the model before the controls are
+    written. */
+    LiveValues& getLiveControls() const;
+
+    /** Write the controls of the actuators, in the order of the
+    actuator_list property, at the given (e.g., wall-clock) time. */
+    void writeControls(double time, const SimTK::Vector& controls) const
+    {   getLiveControls().write(time, controls); }
+
+protected:
+    /** Model component interface */
+    void extendConnectToModel(Model& model) override;
+
+private:
+    // The controls written last; replaced only if the number of actuators
+    // changes.
+    SimTK::ResetOnCopy<std::unique_ptr<LiveValues>> _liveControls;
+
+//=============================================================================
+};  // END of class LiveController
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif // OPENSIM_LIVE_CONTROLLER_H_
@@ -157,15 +157,25 @@ void PrescribedController::extendConnectToModel(Model& model)
 }
 
 
+void PrescribedController::extendAddToSystem(
+        SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    _intervalsCV = addCacheVariable("control_intervals",
+        SimTK::Array_<int>(getActuatorSet().getSize(), 0),
+        SimTK::Stage::Topology);
+}
+
 // compute the control value for an actuator
 void PrescribedController::computeControls(const SimTK::State& s, SimTK::Vector& controls) const
 {
-    SimTK::Vector actControls(1, 0.0);
-    SimTK::Vector time(1, s.getTime());
+    const double time = s.getTime();
+    SimTK::Array_<int>& intervals = _intervalsCV->updValue(s);
 
     for(int i=0; i<getActuatorSet().getSize(); i++){
-        actControls[0] = get_ControlFunctions()[i].calcValue(time);
-        getActuatorSet()[i].addInControls(actControls, controls);
+        getActuatorSet()[i].addInControl(
+            get_ControlFunctions()[i].calcValueNear(time, intervals[i]),
+            controls);
     }  
 }
 
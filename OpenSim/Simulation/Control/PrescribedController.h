@@ -119,6 +119,7 @@ public:
 protected:
     /** Model component interface */
     void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
 private:
     // construct and initialize properties
     void constructProperties();
@@ -130,6 +131,12 @@ private:
     // This method sets all member variables to default (e.g., NULL) values.
     void setNull();
 
+    // The interval of each control function that contained the time of the
+    // last call to computeControls() (see Function::calcValueNear()), kept in
+    // the State so that each State (e.g., one per thread) follows its own
+    // time.
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Array_<int>>> _intervalsCV;
+
 //=============================================================================
 };  // END of class PrescribedController
 
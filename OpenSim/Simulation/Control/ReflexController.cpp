@@ -0,0 +1,211 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  ReflexController.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ReflexController.h"
+#include <OpenSim/Simulation/Model/Muscle.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+/*
+ * Default constructor.
+ */
+ReflexController::ReflexController()
+{
+    constructProperties();
+}
+
+void ReflexController::constructProperties()
+{
+    constructProperty_length_gains();
+    constructProperty_length_threshold(1.0);
+    constructProperty_velocity_gains();
+    constructProperty_force_gains();
+    constructProperty_delay(0.0);
+    constructProperty_sample_interval(0.001);
+}
+
+SimTK::Vector ReflexController::expandGains(const Property<double>& gains)
+    const
+{
+    const int n = getNumMuscles();
+    OPENSIM_THROW_IF_FRMOBJ(gains.size() > 1 && gains.size() != n, Exception,
+        "Expected no " + gains.getName() + ", one, or one per muscle (" +
+        to_string(n) + "), but got " + to_string(gains.size()) + ".");
+    if (gains.size() == 0) return SimTK::Vector(n, 0.0);
+    if (gains.size() == 1) return SimTK::Vector(n, gains[0]);
+    SimTK::Vector expanded(n);
+    for (int i = 0; i < n; ++i) expanded[i] = gains[i];
+    return expanded;
+}
+
+void ReflexController::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    OPENSIM_THROW_IF_FRMOBJ(get_delay() < 0, Exception,
+        "Expected a nonnegative delay, but got " + to_string(get_delay()) +
+        ".");
+    OPENSIM_THROW_IF_FRMOBJ(get_sample_interval() <= 0, Exception,
+        "Expected a positive sample_interval, but got " +
+        to_string(get_sample_interval()) + ".");
+
+    const Set<const Actuator>& actuators = getActuatorSet();
+    const int n = actuators.getSize();
+    _muscles.clear();
+    _muscles.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const Muscle* muscle = dynamic_cast<const Muscle*>(&actuators[i]);
+        OPENSIM_THROW_IF_FRMOBJ(!muscle, Exception,
+            "Expected muscles only, but '" + actuators[i].getName() +
+            "' is a " + actuators[i].getConcreteClassName() + ".");
+        _muscles.push_back(muscle);
+    }
+
+    _lengthGains = expandGains(getProperty_length_gains());
+    _velocityGains = expandGains(getProperty_velocity_gains());
+    _forceGains = expandGains(getProperty_force_gains());
+    OPENSIM_THROW_IF_FRMOBJ(get_delay() == 0 && n > 0 &&
+                            _forceGains.normInf() != 0, Exception,
+        "The tendon forces can be fed back only with a positive delay.");
+
+    // Just enough samples, at least sample_interval apart, to span the delay.
+    const int capacity = get_delay() > 0 ?
+        int(std::ceil(get_delay()/get_sample_interval())) + 2 : 0;
+    _samples.resize(3*n, capacity);
+    _sampleTimes.resize(capacity);
+    _oldestSample = 0;
+    _numSamples = 0;
+}
+
+void ReflexController::extendRealizeAcceleration(const SimTK::State& s) const
+{
+    Super::extendRealizeAcceleration(s);
+    if (isEnabled() && getNumMuscles() > 0 && _sampleTimes.size() > 0)
+        recordSample(s);
+}
+
+//=============================================================================
+// COMPUTATIONS
+//=============================================================================
+void ReflexController::recordSample(const SimTK::State& s) const
+{
+    const int capacity = _sampleTimes.size();
+    const double t = s.getTime();
+
+    // Forget the samples later than this state, then sample it if it is far
+    // enough from the last sample.
+    while (_numSamples > 0 &&
+           _sampleTimes[(_oldestSample + _numSamples - 1) % capacity] > t)
+        --_numSamples;
+    if (_numSamples > 0 &&
+        t - _sampleTimes[(_oldestSample + _numSamples - 1) % capacity] <
+            get_sample_interval() - SimTK::SignificantReal)
+        return;
+
+    int k;
+    if (_numSamples < capacity) {
+        k = (_oldestSample + _numSamples) % capacity;
+        ++_numSamples;
+    } else {
+        k = _oldestSample;
+        _oldestSample = (_oldestSample + 1) % capacity;
+    }
+
+    const int n = getNumMuscles();
+    double* lengths = &_samples(0, k);
+    double* velocities = lengths + n;
+    double* forces = velocities + n;
+    for (int i = 0; i < n; ++i) {
+        const Muscle& muscle = *_muscles[i];
+        if (muscle.appliesForce(s)) {
+            lengths[i] = muscle.getNormalizedFiberLength(s);
+            velocities[i] = muscle.getNormalizedFiberVelocity(s);
+            forces[i] = muscle.getTendonForce(s)/muscle.getMaxIsometricForce();
+        } else {
+            lengths[i] = velocities[i] = forces[i] = 0;
+        }
+    }
+    _sampleTimes[k] = t;
+}
+
+void ReflexController::computeControls(const SimTK::State& s,
+                                       SimTK::Vector& controls) const
+{
+    const int n = getNumMuscles();
+    const double threshold = get_length_threshold();
+
+    // Without a delay, the signals of the state (but not its tendon forces).
+    if (_sampleTimes.size() == 0) {
+        for (int i = 0; i < n; ++i) {
+            const Muscle& muscle = *_muscles[i];
+            if (!muscle.appliesForce(s)) continue;
+            const double control = _lengthGains[i]*std::max(0.0,
+                    muscle.getNormalizedFiberLength(s) - threshold) +
+                _velocityGains[i]*std::max(0.0,
+                    muscle.getNormalizedFiberVelocity(s));
+            muscle.addInControl(control, controls);
+        }
+        return;
+    }
+
+    if (n == 0 || _numSamples == 0) return;
+    const int capacity = _sampleTimes.size();
+    const double delayedTime = s.getTime() - get_delay();
+    // The first sample later than the delayed time, in order of time; the
+    // signals are interpolated between it and the sample before it.
+    int j = 0;
+    while (j < _numSamples &&
+           _sampleTimes[(_oldestSample + j) % capacity] <= delayedTime)
+        ++j;
+    const int before = (_oldestSample + std::max(j - 1, 0)) % capacity;
+    const int after = j > 0 && j < _numSamples ?
+        (_oldestSample + j) % capacity : before;
+    const double weight = after == before ? 0.0 :
+        (delayedTime - _sampleTimes[before]) /
+        (_sampleTimes[after] - _sampleTimes[before]);
+
+    const double* signals = &_samples(0, before);
+    const double* nextSignals = &_samples(0, after);
+    for (int i = 0; i < n; ++i) {
+        const double length =
+            signals[i] + weight*(nextSignals[i] - signals[i]);
+        const double velocity =
+            signals[n + i] + weight*(nextSignals[n + i] - signals[n + i]);
+        const double force =
+            signals[2*n + i] + weight*(nextSignals[2*n + i] - signals[2*n + i]);
+        const double control =
+            _lengthGains[i]*std::max(0.0, length - threshold) +
+            _velocityGains[i]*std::max(0.0, velocity) +
+            _forceGains[i]*force;
+        _muscles[i]->addInControl(control, controls);
+    }
+}
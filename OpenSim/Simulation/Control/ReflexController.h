@@ -0,0 +1,164 @@
+#ifndef OPENSIM_REFLEX_CONTROLLER_H_
+#define OPENSIM_REFLEX_CONTROLLER_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ReflexController.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Controller.h"
+
+namespace OpenSim {
+
+class Muscle;
+
+//=============================================================================
+//=============================================================================
+/**
+ * ReflexController excites each of its muscles (one reflex loop per muscle)
+ * in proportion to the muscle's own sensory signals, as sensed a delay
+ * earlier: its normalized fiber length (length/optimal fiber length), its
+ * normalized fiber velocity (see Muscle::getNormalizedFiberVelocity()) and
+ * its tendon force normalized by its maximum isometric force. The control
+ * added to that of muscle i is
+ *
+ *     Gl_i*max(0, l_i(t-d) - length_threshold) + Gv_i*max(0, v_i(t-d))
+ *         + Gf_i*f_i(t-d)
+ *
+ * where d is the delay. Each gain property lists no gain (the gain is 0), one
+ * gain for all muscles, or one gain per muscle, in the order of the actuators
+ * of the controller (getActuatorSet()), all of which must be Muscles.
+ *
+ * The muscles are found, and the gains expanded to one per muscle, when the
+ * controller is connected to its model. The signals of all muscles are
+ * gathered in one pass and the gains applied to contiguous arrays.
+ *
+ * With a delay, the signals are sampled when the model is realized to
+ * Stage::Acceleration, at most once per sample_interval, into a circular
+ * buffer allocated when the controller is connected, which holds just the
+ * samples that span the delay. The delayed signals are interpolated linearly
+ * between the samples. A sample later than the time of a realization (e.g.,
+ * of a step that the integrator rejected) is discarded. Until the first
+ * sample, the controller adds no controls, and before the delay has elapsed,
+ * it uses the first sample. Since the controls then depend on the states the
+ * model was realized in before, the controls computed again for a State
+ * (e.g., by an analysis after the simulation) may differ from those used to
+ * integrate it. Without a delay, the signals of the State are used, and the
+ * tendon force, which is not known until the controls are, cannot be fed
+ * back.
+ *
+ * @code
+ * ReflexController* reflexes = new ReflexController();
+ * for (const auto& muscle : model.getComponentList<Muscle>())
+ *     reflexes->addActuator(muscle);
+ * reflexes->append_force_gains(2.0);
+ * reflexes->set_delay(0.02);
+ * model.addController(reflexes);
+ * @endcode
+ */
+class OSIMSIMULATION_API ReflexController : public Controller {
+OpenSim_DECLARE_CONCRETE_OBJECT(ReflexController, Controller);
+
+public:
+//=============================================================================
+// PROPERTIES
+//=============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(length_gains, double,
+        "Gains on the normalized fiber length beyond length_threshold: none, "
+        "one for all muscles, or one per muscle.");
+    OpenSim_DECLARE_PROPERTY(length_threshold, double,
+        "Normalized fiber length above which the length of a muscle is fed "
+        "back (default 1).");
+    OpenSim_DECLARE_LIST_PROPERTY(velocity_gains, double,
+        "Gains on the normalized fiber lengthening velocity: none, one for "
+        "all muscles, or one per muscle.");
+    OpenSim_DECLARE_LIST_PROPERTY(force_gains, double,
+        "Gains on the tendon force normalized by the maximum isometric force: "
+        "none, one for all muscles, or one per muscle. Requires a delay.");
+    OpenSim_DECLARE_PROPERTY(delay, double,
+        "Delay (s) of the sensory signals of all muscles (default 0).");
+    OpenSim_DECLARE_PROPERTY(sample_interval, double,
+        "Minimum interval (s) between the samples of the delayed signals "
+        "(default 0.001).");
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION AND DESTRUCTION
+    //--------------------------------------------------------------------------
+    /** Default constructor. */
+    ReflexController();
+
+    // Uses default (compiler-generated) destructor, copy constructor and copy
+    // assignment operator.
+
+    /** The number of muscles, one per actuator of the controller; available
+    once the controller is connected to its model. */
+    int getNumMuscles() const { return (int)_muscles.size(); }
+
+    /** The number of samples of the delayed signals held, at most the
+    capacity of the buffer. */
+    int getNumSamples() const { return _numSamples; }
+
+    /** Add the reflex controls of the muscles to the model controls.
+     *
+     * @param s         system state
+     * @param controls  writable model controls
+     */
+    void computeControls(const SimTK::State& s,
+                         SimTK::Vector& controls) const override;
+
+protected:
+    /** Model component interface */
+    void extendConnectToModel(Model& model) override;
+    void extendRealizeAcceleration(const SimTK::State& s) const override;
+
+private:
+    void constructProperties();
+
+    // Expand the list property of gains to one gain per muscle.
+    SimTK::Vector expandGains(const Property<double>& gains) const;
+
+    // Sample the signals of the muscles at the time of the state.
+    void recordSample(const SimTK::State& s) const;
+
+    // The muscles, one per actuator, and their gains.
+    SimTK::ResetOnCopy<SimTK::Array_<const Muscle*>> _muscles;
+    SimTK::Vector _lengthGains;
+    SimTK::Vector _velocityGains;
+    SimTK::Vector _forceGains;
+
+    // The circular buffer of samples: each column holds the normalized fiber
+    // lengths, fiber velocities and tendon forces of all muscles, at the
+    // time of the same entry of _sampleTimes. Allocated and emptied when the
+    // controller is connected.
+    mutable SimTK::Matrix _samples;
+    mutable SimTK::Vector _sampleTimes;
+    mutable int _oldestSample = 0;
+    mutable int _numSamples = 0;
+
+//=============================================================================
+};  // END of class ReflexController
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif // OPENSIM_REFLEX_CONTROLLER_H_
@@ -0,0 +1,196 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  TaskSpaceController.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "TaskSpaceController.h"
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/Body.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+TaskSpaceController::TaskSpaceController() : Force()
+{
+    constructProperties();
+}
+
+void TaskSpaceController::constructProperties()
+{
+    constructProperty_bodies();
+    constructProperty_stations();
+    constructProperty_position_gain(0.0);
+    constructProperty_velocity_gain(0.0);
+}
+
+int TaskSpaceController::addStationTask(const std::string& bodyName,
+                                        const SimTK::Vec3& station)
+{
+    append_bodies(bodyName);
+    append_stations(station);
+    _targetLocations.push_back(SimTK::Vec3(0));
+    _targetVelocities.push_back(SimTK::Vec3(0));
+    _targetAccelerations.push_back(SimTK::Vec3(0));
+    return getNumTasks() - 1;
+}
+
+void TaskSpaceController::setTaskTarget(int index,
+        const SimTK::Vec3& location, const SimTK::Vec3& velocity,
+        const SimTK::Vec3& acceleration)
+{
+    OPENSIM_THROW_IF_FRMOBJ(index < 0 || index >= getNumTasks(), Exception,
+        "Task index " + std::to_string(index) + " is out of range.");
+    _targetLocations.resize(getNumTasks(), SimTK::Vec3(0));
+    _targetVelocities.resize(getNumTasks(), SimTK::Vec3(0));
+    _targetAccelerations.resize(getNumTasks(), SimTK::Vec3(0));
+    _targetLocations[index] = location;
+    _targetVelocities[index] = velocity;
+    _targetAccelerations[index] = acceleration;
+}
+
+//=============================================================================
+// Model Component Interface
+//=============================================================================
+void TaskSpaceController::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+
+    OPENSIM_THROW_IF_FRMOBJ(getProperty_stations().size() != getNumTasks(),
+        Exception, "Expected a station for each of the " +
+        std::to_string(getNumTasks()) + " bodies, but got " +
+        std::to_string(getProperty_stations().size()) + ".");
+
+    // Tasks read from a file track the origin until given targets.
+    _targetLocations.resize(getNumTasks(), SimTK::Vec3(0));
+    _targetVelocities.resize(getNumTasks(), SimTK::Vec3(0));
+    _targetAccelerations.resize(getNumTasks(), SimTK::Vec3(0));
+}
+
+void TaskSpaceController::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    const int nt = getNumTasks();
+    _bodies.clear();
+    _bodies.reserve(nt);
+    for (int i = 0; i < nt; ++i) {
+        const string& name = get_bodies(i);
+        OPENSIM_THROW_IF_FRMOBJ(!model.getBodySet().contains(name), Exception,
+            "Invalid body (" + name + ") specified.");
+        _bodies.push_back(&model.getBodySet().get(name));
+    }
+}
+
+//=============================================================================
+// COMPUTATIONS
+//=============================================================================
+SimTK::Vector TaskSpaceController::calcGeneralizedForces(
+        const SimTK::State& s) const
+{
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+
+    // The gravity forces g, on the same side of the equations of motion as
+    // the mass matrix: M*udot + b + g = tau.
+    SimTK::Vector g;
+    matter.multiplyBySystemJacobianTranspose(s,
+        getModel().getGravityForce().getBodyForces(s), g);
+    g = -g;
+
+    const int nt = getNumTasks();
+    if (nt == 0) return g;
+    const int nst = 3*nt;
+
+    SimTK::Array_<SimTK::MobilizedBodyIndex> mobods(nt);
+    SimTK::Array_<SimTK::Vec3> stations(nt);
+    for (int i = 0; i < nt; ++i) {
+        mobods[i] = _bodies[i]->getMobilizedBodyIndex();
+        stations[i] = get_stations(i);
+    }
+
+    // Lambda^-1 = J*M^-1*J^T, a column per scalar task: pick out a column
+    // of J^T with a unit force on one station, then apply M^-1 and J.
+    SimTK::Matrix lambdaInverse(nst, nst);
+    SimTK::Vector_<SimTK::Vec3> unitForces(nt, SimTK::Vec3(0));
+    SimTK::Vector JTcol, MInvJTcol;
+    SimTK::Vector_<SimTK::Vec3> JMInvJTcol;
+    for (int j = 0; j < nst; ++j) {
+        unitForces[j/3][j%3] = 1;
+        matter.multiplyByStationJacobianTranspose(s, mobods, stations,
+            unitForces, JTcol);
+        unitForces[j/3][j%3] = 0;
+        matter.multiplyByMInv(s, JTcol, MInvJTcol);
+        matter.multiplyByStationJacobian(s, mobods, stations, MInvJTcol,
+            JMInvJTcol);
+        for (int i = 0; i < nt; ++i)
+            for (int k = 0; k < 3; ++k)
+                lambdaInverse(3*i + k, j) = JMInvJTcol[i][k];
+    }
+
+    // The Coriolis and gyroscopic forces b, and J*M^-1*b.
+    SimTK::Vector b, MInvb;
+    matter.calcResidualForceIgnoringConstraints(s, SimTK::Vector(0),
+        SimTK::Vector_<SimTK::SpatialVec>(0), SimTK::Vector(0), b);
+    matter.multiplyByMInv(s, b, MInvb);
+    SimTK::Vector_<SimTK::Vec3> JMInvb, JDotu;
+    matter.multiplyByStationJacobian(s, mobods, stations, MInvb, JMInvb);
+    matter.calcBiasForStationJacobian(s, mobods, stations, JDotu);
+
+    // The task accelerations, less the part of J*udot due to the motion and
+    // to b.
+    const double kp = get_position_gain();
+    const double kv = get_velocity_gain();
+    SimTK::Vector rhs(nst);
+    for (int i = 0; i < nt; ++i) {
+        SimTK::Vec3 location, velocity;
+        matter.getMobilizedBody(mobods[i]).findStationLocationAndVelocityInGround(
+            s, stations[i], location, velocity);
+        const SimTK::Vec3 a = _targetAccelerations[i]
+            + kp*(_targetLocations[i] - location)
+            + kv*(_targetVelocities[i] - velocity)
+            - JDotu[i] + JMInvb[i];
+        for (int k = 0; k < 3; ++k) rhs[3*i + k] = a[k];
+    }
+
+    // The task forces Lambda*rhs, and the generalized forces.
+    SimTK::Vector taskForces;
+    SimTK::FactorQTZ(lambdaInverse).solve(rhs, taskForces);
+    SimTK::Vector_<SimTK::Vec3> stationForces(nt);
+    for (int i = 0; i < nt; ++i)
+        stationForces[i] = SimTK::Vec3::getAs(&taskForces[3*i]);
+    SimTK::Vector tau;
+    matter.multiplyByStationJacobianTranspose(s, mobods, stations,
+        stationForces, tau);
+    return tau + g;
+}
+
+void TaskSpaceController::computeForce(const SimTK::State& s,
+                              SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                              SimTK::Vector& generalizedForces) const
+{
+    generalizedForces += calcGeneralizedForces(s);
+}
@@ -0,0 +1,154 @@
+#ifndef OPENSIM_TASK_SPACE_CONTROLLER_H_
+#define OPENSIM_TASK_SPACE_CONTROLLER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  TaskSpaceController.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Simulation/Model/Force.h>
+
+namespace OpenSim {
+
+class Body;
+
+//=============================================================================
+//=============================================================================
+/**
+ * TaskSpaceController is an operational-space controller: it applies the
+ * generalized forces that give stations (points fixed on bodies) the task
+ * accelerations
+ *
+ *   a* = a_target + position_gain*(p_target - p) + velocity_gain*(v_target - v),
+ *
+ * where p and v are the location and velocity of each station in ground, and
+ * compensates for gravity. The forces are
+ *
+ *   tau = J^T*Lambda*(a* - Jdot*u + J*M^-1*b) + g,
+ *
+ * with J the Jacobian of all stations stacked together, M the mass matrix,
+ * Lambda = (J*M^-1*J^T)^-1 the task-space inertia, b the Coriolis and
+ * gyroscopic forces and g the gravity forces. The forces are applied directly
+ * to the mobilities, as a Force, rather than through actuators; add the
+ * controller with Model::addForce().
+ *
+ * J, J^T and M^-1 are applied as operators (multiplyByStationJacobian(),
+ * multiplyByStationJacobianTranspose() and multiplyByMInv() of the
+ * SimbodyMatterSubsystem), each in O(n) time, so no dense Jacobian or mass
+ * matrix is formed. Lambda^-1 is built one column per scalar task, for all
+ * tasks together, and factored once; only the factorization is solved to
+ * apply Lambda. This keeps the cost to roughly 3*(number of tasks) passes
+ * over the multibody tree, which is fast enough to run at 1 kHz for models
+ * of 30 or more degrees of freedom.
+ *
+ * If the tasks are redundant (Lambda^-1 is singular), the task forces are
+ * those of least norm. This class promotes the prototype in
+ * Sandbox/TaskSpace.
+ *
+ * @code
+ * TaskSpaceController* tsc = new TaskSpaceController();
+ * tsc->addStationTask("hand_r", SimTK::Vec3(0, -0.05, 0));
+ * tsc->set_position_gain(100);
+ * tsc->set_velocity_gain(20);
+ * model.addForce(tsc);
+ * model.initSystem();
+ * tsc->setTaskTarget(0, SimTK::Vec3(0.3, 1.2, 0.2));
+ * @endcode
+ */
+class OSIMSIMULATION_API TaskSpaceController : public Force {
+OpenSim_DECLARE_CONCRETE_OBJECT(TaskSpaceController, Force);
+public:
+//=============================================================================
+// PROPERTIES
+//=============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(bodies, std::string,
+        "Names of the bodies to which the stations of the tasks are fixed, "
+        "one per task.");
+    OpenSim_DECLARE_LIST_PROPERTY(stations, SimTK::Vec3,
+        "Locations of the stations of the tasks in their bodies, one per "
+        "task.");
+    OpenSim_DECLARE_PROPERTY(position_gain, double,
+        "Gain on the error in the location of each station (1/s^2). "
+        "Default 0.");
+    OpenSim_DECLARE_PROPERTY(velocity_gain, double,
+        "Gain on the error in the velocity of each station (1/s). Default 0.");
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    /** Default constructor creates a controller without tasks, which only
+    compensates for gravity. */
+    TaskSpaceController();
+
+    // Uses default (compiler-generated) destructor, copy constructor, and copy
+    // assignment operator.
+
+    /** Add a task for the station fixed at the given location in the body
+    with the given name. Its target location, velocity and acceleration are
+    zero until setTaskTarget() is called.
+    @return the index of the task. */
+    int addStationTask(const std::string& bodyName,
+                       const SimTK::Vec3& station);
+
+    /** The number of tasks. */
+    int getNumTasks() const { return getProperty_bodies().size(); }
+
+    /** Set the location, velocity and acceleration, in ground, that the
+    station of a task is to track. */
+    void setTaskTarget(int index, const SimTK::Vec3& location,
+                       const SimTK::Vec3& velocity = SimTK::Vec3(0),
+                       const SimTK::Vec3& acceleration = SimTK::Vec3(0));
+
+    /** The generalized forces that the controller applies, one per mobility.
+    The state must be realized to Stage::Velocity. */
+    SimTK::Vector calcGeneralizedForces(const SimTK::State& s) const;
+
+protected:
+    //--------------------------------------------------------------------------
+    // Model Component Interface
+    //--------------------------------------------------------------------------
+    void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
+
+    //--------------------------------------------------------------------------
+    // Force Interface
+    //--------------------------------------------------------------------------
+    void computeForce(const SimTK::State& s,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& generalizedForces) const override;
+
+private:
+    void constructProperties();
+
+    // Target location, velocity and acceleration of each task.
+    SimTK::Array_<SimTK::Vec3> _targetLocations;
+    SimTK::Array_<SimTK::Vec3> _targetVelocities;
+    SimTK::Array_<SimTK::Vec3> _targetAccelerations;
+    // The bodies of the tasks.
+    SimTK::ResetOnCopy<SimTK::Array_<const Body*>> _bodies;
+//=============================================================================
+};  // END of class TaskSpaceController
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_TASK_SPACE_CONTROLLER_H_
@@ -81,6 +81,10 @@ void ToyReflexController::extendConnectToModel(Model &model)
         }else
             cnt++;
     }
+
+    _muscles.clear();
+    for (int i = 0; i < actuators.getSize(); ++i)
+        _muscles.push_back(static_cast<const Muscle*>(&actuators[i]));
 }
 
 //=============================================================================
@@ -98,9 +102,6 @@ void ToyReflexController::computeControls(const State& s, Vector &controls) cons
     // get time
     s.getTime();
 
-    // get the list of actuators assigned to the reflex controller
-    const Set<const Actuator>& actuators = getActuatorSet();
-
     // muscle lengthening speed
     double speed = 0;
     // max muscle lengthening (stretch) speed
@@ -108,16 +109,14 @@ void ToyReflexController::computeControls(const State& s, Vector &controls) cons
     //reflex control
     double control = 0;
 
-    for(int i=0; i<actuators.getSize(); ++i){
-        const Muscle *musc = dynamic_cast<const Muscle*>(&actuators[i]);
+    for(const Muscle* musc : _muscles){
         speed = musc->getLengtheningSpeed(s);
         // un-normalize muscle's maximum contraction velocity (fib_lengths/sec) 
         max_speed = musc->getOptimalFiberLength()*musc->getMaxContractionVelocity();
         control = 0.5*get_gain()*(fabs(speed)+speed)/max_speed;
 
-        SimTK::Vector actControls(1,control);
         // add reflex controls to whatever controls are already in place.
-        musc->addInControls(actControls, controls);
+        musc->addInControl(control, controls);
     }
 }
 
@@ -32,6 +32,8 @@
 
 namespace OpenSim { 
 
+class Muscle;
+
 //=============================================================================
 //=============================================================================
 /**
@@ -84,6 +86,9 @@ private:
     // ModelComponent interface to connect this component to its model
     void extendConnectToModel(Model& aModel) override;
 
+    // The muscles of the controller, found when it is connected.
+    SimTK::ResetOnCopy<SimTK::Array_<const Muscle*>> _muscles;
+
     //=============================================================================
 };  // END of class ToyReflexController
 
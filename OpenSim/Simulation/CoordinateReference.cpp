@@ -91,9 +91,8 @@ const SimTK::Array_<std::string>& CoordinateReference::getNames() const
 /** get the values of the CoordinateReference */
 void CoordinateReference::getValues(const SimTK::State &s, SimTK::Array_<double> &values) const
 {
-    SimTK::Vector t(1, s.getTime());
     values.resize(getNumRefs());
-    values[0] = _coordinateValueFunction->calcValue(t);
+    values[0] = _coordinateValueFunction->calcValue(s.getTime());
 }
 
 
@@ -108,24 +107,19 @@ void CoordinateReference::getWeights(const SimTK::State &s, SimTK::Array_<double
 /** get the value of the CoordinateReference */
 double CoordinateReference::getValue(const SimTK::State &s) const
 {
-    SimTK::Vector t(1, s.getTime());
-    return _coordinateValueFunction->calcValue(t);
+    return _coordinateValueFunction->calcValue(s.getTime());
 }
 
 /** get the speed value of the CoordinateReference */
 double CoordinateReference::getSpeedValue(const SimTK::State &s) const
 {
-    SimTK::Vector t(1, s.getTime());
-    std::vector<int> order(1, 0);
-    return _coordinateValueFunction->calcDerivative(order, t);
+    return _coordinateValueFunction->calcDerivative(s.getTime(), 1);
 }
 
 /** get the acceleration value of the CoordinateReference */
 double CoordinateReference::getAccelerationValue(const SimTK::State &s) const
 {
-    SimTK::Vector t(1, s.getTime());
-    std::vector<int> order(2, 0);
-    return _coordinateValueFunction->calcDerivative(order, t);
+    return _coordinateValueFunction->calcDerivative(s.getTime(), 2);
 }
 
 /** get the weight of the CoordinateReference */
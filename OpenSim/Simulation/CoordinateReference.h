@@ -114,6 +114,12 @@ public:
     {
         _coordinateValueFunction = function.clone();
     }
+    /** Access the coordinate value as a function of time, for instance to
+        update the value of a Constant in place. */
+    OpenSim::Function& updValueFunction()
+    {
+        return *_coordinateValueFunction;
+    }
 private:
     void copyData(const CoordinateReference& source);
 
@@ -0,0 +1,509 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  GaussNewtonIKSolver.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "GaussNewtonIKSolver.h"
+#include "MarkersReference.h"
+#include "Model/Model.h"
+#include "Model/MarkerSet.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+namespace {
+    // The damping of the first iteration of assemble(), and the bounds of the
+    // damping beyond which the iterations stop.
+    const double InitialDamping = 1e-3;
+    const double MinDamping = 1e-12;
+    const double MaxDamping = 1e10;
+
+    // Factor the symmetric positive definite matrix A into L*L^T, with L in
+    // the lower triangle of F. Returns false if A is not positive definite.
+    bool factorCholesky(const Matrix& A, Matrix& F)
+    {
+        const int n = A.nrow();
+        for(int j = 0; j < n; ++j) {
+            double d = A(j, j);
+            for(int k = 0; k < j; ++k) d -= F(j, k)*F(j, k);
+            if(!(d > 0)) return false;
+            F(j, j) = std::sqrt(d);
+            for(int i = j + 1; i < n; ++i) {
+                double a = A(i, j);
+                for(int k = 0; k < j; ++k) a -= F(i, k)*F(j, k);
+                F(i, j) = a/F(j, j);
+            }
+        }
+        return true;
+    }
+
+    // Solve L*L^T*x = b in place, given the factor of factorCholesky().
+    void solveCholesky(const Matrix& F, Vector& x)
+    {
+        const int n = F.nrow();
+        for(int i = 0; i < n; ++i) {
+            double a = x[i];
+            for(int k = 0; k < i; ++k) a -= F(i, k)*x[k];
+            x[i] = a/F(i, i);
+        }
+        for(int i = n - 1; i >= 0; --i) {
+            double a = x[i];
+            for(int k = i + 1; k < n; ++k) a -= F(k, i)*x[k];
+            x[i] = a/F(i, i);
+        }
+    }
+}
+
+//______________________________________________________________________________
+GaussNewtonIKSolver::GaussNewtonIKSolver(const Model& model,
+        MarkersReference& markersReference,
+        SimTK::Array_<CoordinateReference>& coordinateReferences,
+        double /*constraintWeight*/) : Solver(model),
+        _markersReference(markersReference),
+        _coordinateReferences(coordinateReferences),
+        _accuracy(1e-4), _maxIterations(50), _hasState(false),
+        _damping(InitialDamping), _lastTime(SimTK::NaN),
+        _previousTime(SimTK::NaN), _numSolutions(0), _numIterations(0),
+        _totalNumIterations(0)
+{
+    setupProblem(model.getWorkingState());
+}
+
+void GaussNewtonIKSolver::setAccuracy(double accuracy)
+{
+    OPENSIM_THROW_IF(!(accuracy > 0), Exception,
+        "GaussNewtonIKSolver: expected a positive accuracy, but got " +
+        to_string(accuracy) + ".");
+    _accuracy = accuracy;
+}
+
+void GaussNewtonIKSolver::setMaxIterations(int maxIterations)
+{
+    OPENSIM_THROW_IF(maxIterations < 1, Exception,
+        "GaussNewtonIKSolver: expected a positive number of iterations, but "
+        "got " + to_string(maxIterations) + ".");
+    _maxIterations = maxIterations;
+}
+
+//______________________________________________________________________________
+/* Find the markers of the reference that the model has, the coordinates
+   that can move them or have a reference, and allocate the work space. */
+void GaussNewtonIKSolver::setupProblem(const SimTK::State& s)
+{
+    const Model& model = getModel();
+    const SimbodyMatterSubsystem& matter = model.getMatterSubsystem();
+
+    const ConstraintSet& constraints = model.getConstraintSet();
+    for(int i = 0; i < constraints.getSize(); ++i) {
+        OPENSIM_THROW_IF(constraints[i].isEnforced(s), Exception,
+            "GaussNewtonIKSolver: the model has the enforced constraint '" +
+            constraints[i].getName() + "'; use InverseKinematicsSolver.");
+    }
+    OPENSIM_THROW_IF(s.getNQ() != s.getNU(), Exception,
+        "GaussNewtonIKSolver: the model uses quaternions; use "
+        "InverseKinematicsSolver.");
+
+    // The markers, in the order of the reference.
+    const MarkerSet& modelMarkerSet = model.getMarkerSet();
+    const Array_<std::string>& markerNames = _markersReference.getNames();
+    _markerReferenceIndices.clear();
+    _markerBodies.clear();
+    _markerStations.clear();
+    int index = -1;
+    for(unsigned int i = 0; i < markerNames.size(); ++i) {
+        index = modelMarkerSet.getIndex(markerNames[i], index);
+        if(index < 0) continue;
+        const Marker& marker = modelMarkerSet[index];
+        _markerReferenceIndices.push_back(i);
+        _markerBodies.push_back(
+            marker.getParentFrame().getMobilizedBodyIndex());
+        _markerStations.push_back(
+            marker.getParentFrame().findTransformInBaseFrame()*
+            marker.get_location());
+    }
+    OPENSIM_THROW_IF(_markerBodies.empty(), Exception,
+        "GaussNewtonIKSolver: marker data does not correspond to any model "
+        "markers.");
+
+    // The coordinates that move the markers: those of the bodies that carry
+    // markers and of their ancestors.
+    const int nq = s.getNQ();
+    std::vector<bool> isCandidate(nq, false);
+    for(MobilizedBodyIndex mbx : _markerBodies) {
+        while(mbx != GroundIndex) {
+            const MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+            const int first = mobod.getFirstQIndex(s);
+            for(int k = 0; k < mobod.getNumQ(s); ++k)
+                isCandidate[first + k] = true;
+            mbx = mobod.getParentMobilizedBody().getMobilizedBodyIndex();
+        }
+    }
+
+    // The coordinate references are goals unless their coordinates are
+    // locked; a reference with an infinite weight sets its coordinate.
+    const CoordinateSet& modelCoordSet = model.getCoordinateSet();
+    _coordinateGoals.clear();
+    _coordinateGoalQs.clear();
+    std::vector<bool> isSet(nq, false);
+    for(unsigned int i = 0; i < _coordinateReferences.size(); ++i) {
+        const CoordinateReference& coordRef = _coordinateReferences[i];
+        const Coordinate& coord = modelCoordSet.get(coordRef.getName());
+        if(coord.getLocked(s)) continue;
+        const int q = matter.getMobilizedBody(coord.getBodyIndex())
+            .getFirstQIndex(s) + coord.getMobilizerQIndex();
+        _coordinateGoals.push_back(i);
+        _coordinateGoalQs.push_back(q);
+        if(coordRef.getWeight(s) == SimTK::Infinity) isSet[q] = true;
+        else isCandidate[q] = true;
+    }
+
+    // Locked and prescribed coordinates do not move; clamped ones are kept
+    // within their ranges.
+    std::vector<bool> isFixed(isSet);
+    _clampedQs.clear();
+    _clampMin.clear();
+    _clampMax.clear();
+    for(int i = 0; i < modelCoordSet.getSize(); ++i) {
+        const Coordinate& coord = modelCoordSet[i];
+        const int q = matter.getMobilizedBody(coord.getBodyIndex())
+            .getFirstQIndex(s) + coord.getMobilizerQIndex();
+        if(coord.getLocked(s) || coord.isPrescribed(s)) isFixed[q] = true;
+        else if(coord.getClamped(s) && isCandidate[q]) {
+            _clampedQs.push_back(q);
+            _clampMin.push_back(coord.getRangeMin());
+            _clampMax.push_back(coord.getRangeMax());
+        }
+    }
+
+    _freeQs.clear();
+    _columnOfQ.assign(nq, -1);
+    for(int q = 0; q < nq; ++q) {
+        if(isCandidate[q] && !isFixed[q]) {
+            _columnOfQ[q] = (int)_freeQs.size();
+            _freeQs.push_back(q);
+        }
+    }
+
+    const int nm = getNumMarkers();
+    const int nc = (int)_coordinateGoals.size();
+    const int n = (int)_freeQs.size();
+    _observations.resize(nm);
+    _markerWeights.resize(nm);
+    _sqrtMarkerWeights.resize(nm);
+    _coordinateValues.resize(nc);
+    _sqrtCoordinateWeights.resize(nc);
+    _residuals.resize(3*nm + nc);
+    _stationJacobian.resize(3*nm, s.getNU());
+    _jacobian.resize(3*nm + nc, n);
+    _normal.resize(n, n);
+    _factor.resize(n, n);
+    _gradient.resize(n);
+    _step.resize(n);
+    _unitQ.resize(nq);
+    _nInvColumn.resize(s.getNU());
+    _startQ.resize(nq);
+}
+
+//______________________________________________________________________________
+/* Read the observations and weights of the markers, and the values and
+   weights of the coordinate references, at the time of the internal state. */
+void GaussNewtonIKSolver::updateObservations()
+{
+    const RowVectorView_<Vec3> values =
+        _markersReference.getValuesView(_state);
+    Array_<double> weights;
+    _markersReference.getWeights(_state, weights);
+    for(int i = 0; i < getNumMarkers(); ++i) {
+        const int ref = _markerReferenceIndices[i];
+        _observations[i] = values[ref];
+        _markerWeights[i] = weights[ref];
+        _sqrtMarkerWeights[i] = _observations[i].isNaN() ? 0.0 :
+            std::sqrt(std::max(weights[ref], 0.0));
+    }
+
+    Vector& q = _state.updQ();
+    for(unsigned int j = 0; j < _coordinateGoals.size(); ++j) {
+        const CoordinateReference& coordRef =
+            _coordinateReferences[_coordinateGoals[j]];
+        _coordinateValues[j] = coordRef.getValue(_state);
+        const double weight = coordRef.getWeight(_state);
+        if(_columnOfQ[_coordinateGoalQs[j]] < 0) {
+            // Not solved for: a reference with an infinite weight sets its
+            // coordinate.
+            if(weight == SimTK::Infinity)
+                q[_coordinateGoalQs[j]] = _coordinateValues[j];
+            _sqrtCoordinateWeights[j] = 0.0;
+        }
+        else
+            _sqrtCoordinateWeights[j] = std::sqrt(std::max(weight, 0.0));
+    }
+}
+
+double GaussNewtonIKSolver::calcResiduals()
+{
+    const SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    getModel().getMultibodySystem().realize(_state, Stage::Position);
+
+    for(int i = 0; i < getNumMarkers(); ++i) {
+        if(_sqrtMarkerWeights[i] == 0) {
+            _residuals(3*i, 3).setToZero();
+            continue;
+        }
+        const Vec3 error = _sqrtMarkerWeights[i]*(matter.getMobilizedBody(
+            _markerBodies[i]).findStationLocationInGround(_state,
+                _markerStations[i]) - _observations[i]);
+        for(int k = 0; k < 3; ++k) _residuals[3*i + k] = error[k];
+    }
+    const Vector& q = _state.getQ();
+    const int offset = 3*getNumMarkers();
+    for(unsigned int j = 0; j < _coordinateGoals.size(); ++j) {
+        _residuals[offset + j] = _sqrtCoordinateWeights[j] == 0 ? 0.0 :
+            _sqrtCoordinateWeights[j]*
+            (q[_coordinateGoalQs[j]] - _coordinateValues[j]);
+    }
+    return 0.5*_residuals.normSqr();
+}
+
+void GaussNewtonIKSolver::calcJacobian()
+{
+    const SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    // The Jacobian of the stations with respect to the speeds, mapped to the
+    // coordinates one column at a time: dp/dq = dp/du*N^-1.
+    matter.calcStationJacobian(_state, _markerBodies, _markerStations,
+                               _stationJacobian);
+    const int nm = getNumMarkers();
+    _jacobian.setToZero();
+    _unitQ.setToZero();
+    for(unsigned int c = 0; c < _freeQs.size(); ++c) {
+        _unitQ[_freeQs[c]] = 1;
+        matter.multiplyByNInv(_state, false, _unitQ, _nInvColumn);
+        _unitQ[_freeQs[c]] = 0;
+        for(int i = 0; i < nm; ++i) {
+            if(_sqrtMarkerWeights[i] == 0) continue;
+            for(int k = 0; k < 3; ++k) {
+                const int row = 3*i + k;
+                double d = 0;
+                for(int u = 0; u < _nInvColumn.size(); ++u)
+                    if(_nInvColumn[u] != 0)
+                        d += _stationJacobian(row, u)*_nInvColumn[u];
+                _jacobian(row, c) = _sqrtMarkerWeights[i]*d;
+            }
+        }
+    }
+    for(unsigned int j = 0; j < _coordinateGoals.size(); ++j) {
+        const int c = _columnOfQ[_coordinateGoalQs[j]];
+        if(c >= 0) _jacobian(3*nm + j, c) = _sqrtCoordinateWeights[j];
+    }
+}
+
+void GaussNewtonIKSolver::clampCoordinates()
+{
+    Vector& q = _state.updQ();
+    for(unsigned int i = 0; i < _clampedQs.size(); ++i)
+        q[_clampedQs[i]] = clamp(_clampMin[i], q[_clampedQs[i]], _clampMax[i]);
+}
+
+//______________________________________________________________________________
+/* Take damped Gauss-Newton steps from the coordinates of the internal state
+   until no coordinate changes by more than the accuracy. A step that does
+   not decrease the objective is rejected, and taken again with more
+   damping. */
+void GaussNewtonIKSolver::solve(int maxIterations)
+{
+    _numIterations = 0;
+    const int n = (int)_freeQs.size();
+    if(n == 0) {
+        calcResiduals();
+        return;
+    }
+
+    double cost = calcResiduals();
+    bool needJacobian = true;
+    while(_numIterations < maxIterations) {
+        ++_numIterations;
+        if(needJacobian) {
+            calcJacobian();
+            _normal = ~_jacobian*_jacobian;
+            _gradient = ~_jacobian*_residuals;
+            needJacobian = false;
+        }
+
+        // (J^T*J + damping*diag(J^T*J))*step = -J^T*r
+        _factor = _normal;
+        for(int c = 0; c < n; ++c)
+            _factor(c, c) += _damping*(_normal(c, c) + SimTK::SignificantReal);
+        if(!factorCholesky(_factor, _factor)) {
+            _damping *= 10;
+            if(_damping > MaxDamping) break;
+            continue;
+        }
+        _step = -_gradient;
+        solveCholesky(_factor, _step);
+
+        _startQ = _state.getQ();
+        Vector& q = _state.updQ();
+        for(int c = 0; c < n; ++c) q[_freeQs[c]] += _step[c];
+        clampCoordinates();
+
+        const double newCost = calcResiduals();
+        if(newCost <= cost) {
+            double change = 0;
+            for(int c = 0; c < n; ++c) {
+                change = std::max(change,
+                    std::abs(_state.getQ()[_freeQs[c]] - _startQ[_freeQs[c]]));
+            }
+            cost = newCost;
+            _damping = std::max(_damping/10, MinDamping);
+            needJacobian = true;
+            if(change <= _accuracy) break;
+        }
+        else {
+            _state.updQ() = _startQ;
+            _damping *= 10;
+            if(_damping > MaxDamping) {
+                calcResiduals();
+                break;
+            }
+        }
+    }
+    _totalNumIterations += _numIterations;
+}
+
+//______________________________________________________________________________
+void GaussNewtonIKSolver::assemble(SimTK::State& s)
+{
+    _state = s;
+    _hasState = true;
+    getModel().getMultibodySystem().prescribeQ(_state);
+    updateObservations();
+    clampCoordinates();
+
+    _damping = InitialDamping;
+    solve(20*_maxIterations);
+
+    s.updQ() = _state.getQ();
+    _previousQ = _lastQ;
+    _previousTime = _lastTime;
+    _lastQ = _state.getQ();
+    _lastTime = _state.getTime();
+    _numSolutions = 1;
+}
+
+void GaussNewtonIKSolver::track(SimTK::State& s)
+{
+    OPENSIM_THROW_IF(!_hasState, Exception,
+        "GaussNewtonIKSolver::track(): call assemble() first.");
+
+    _state.setTime(s.getTime());
+    getModel().getMultibodySystem().prescribeQ(_state);
+    updateObservations();
+
+    // Start from the last solution or, if it fits the new observations
+    // better, from its linear extrapolation from the two last frames.
+    if(_numSolutions >= 2 && s.getTime() > _lastTime &&
+            _lastTime > _previousTime) {
+        const double cost = calcResiduals();
+        _startQ = _state.getQ();
+        const double ratio =
+            (s.getTime() - _lastTime)/(_lastTime - _previousTime);
+        Vector& q = _state.updQ();
+        for(int qx : _freeQs)
+            q[qx] = _lastQ[qx] + ratio*(_lastQ[qx] - _previousQ[qx]);
+        clampCoordinates();
+        if(calcResiduals() > cost) _state.updQ() = _startQ;
+    }
+
+    solve(_maxIterations);
+
+    s.updQ() = _state.getQ();
+    _previousQ = _lastQ;
+    _previousTime = _lastTime;
+    _lastQ = _state.getQ();
+    _lastTime = _state.getTime();
+    ++_numSolutions;
+}
+
+//______________________________________________________________________________
+std::string GaussNewtonIKSolver::getMarkerNameForIndex(int markerIndex) const
+{
+    OPENSIM_THROW_IF(markerIndex < 0 || markerIndex >= getNumMarkers(),
+        IndexOutOfRange, markerIndex, 0, getNumMarkers() - 1);
+    return _markersReference.getNames()[_markerReferenceIndices[markerIndex]];
+}
+
+void GaussNewtonIKSolver::updateMarkerWeight(const std::string& markerName,
+                                             double value)
+{
+    const Array_<std::string>& names = _markersReference.getNames();
+    const auto p = std::find(names.begin(), names.end(), markerName);
+    updateMarkerWeight((int)std::distance(names.begin(), p), value);
+}
+
+void GaussNewtonIKSolver::updateMarkerWeight(int markerIndex, double value)
+{
+    if(markerIndex < 0 || markerIndex >= _markersReference.getNumRefs())
+        throw Exception(
+            "GaussNewtonIKSolver::updateMarkerWeight: invalid markerIndex.");
+    // The weights are read from the reference at each frame.
+    const std::string& name = _markersReference.getNames()[markerIndex];
+    Set<MarkerWeight>& markerWeights = _markersReference.updMarkerWeightSet();
+    const int wix = markerWeights.getIndex(name);
+    if(wix >= 0)
+        markerWeights[wix].setWeight(value);
+    else
+        markerWeights.adoptAndAppend(new MarkerWeight(name, value));
+}
+
+void GaussNewtonIKSolver::computeCurrentMarkerLocations(
+        SimTK::Array_<SimTK::Vec3>& markerLocations) const
+{
+    const SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    markerLocations.resize(getNumMarkers());
+    for(int i = 0; i < getNumMarkers(); ++i) {
+        markerLocations[i] = matter.getMobilizedBody(_markerBodies[i])
+            .findStationLocationInGround(_state, _markerStations[i]);
+    }
+}
+
+void GaussNewtonIKSolver::computeCurrentMarkerErrors(
+        SimTK::Array_<double>& markerErrors) const
+{
+    computeCurrentSquaredMarkerErrors(markerErrors);
+    for(double& error : markerErrors) error = std::sqrt(error);
+}
+
+void GaussNewtonIKSolver::computeCurrentSquaredMarkerErrors(
+        SimTK::Array_<double>& markerErrors) const
+{
+    Array_<Vec3> locations;
+    computeCurrentMarkerLocations(locations);
+    markerErrors.resize(getNumMarkers());
+    for(int i = 0; i < getNumMarkers(); ++i) {
+        markerErrors[i] = _observations[i].isNaN() ? 0.0 :
+            (locations[i] - _observations[i]).normSqr();
+    }
+}
+
+} // end of namespace OpenSim
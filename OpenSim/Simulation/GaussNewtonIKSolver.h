@@ -0,0 +1,233 @@
+#ifndef OPENSIM_GAUSS_NEWTON_IK_SOLVER_H_
+#define OPENSIM_GAUSS_NEWTON_IK_SOLVER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  GaussNewtonIKSolver.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Solver.h"
+#include "CoordinateReference.h"
+#include "SimTKcommon/internal/State.h"
+#include "simbody/internal/common.h"
+
+#include <vector>
+
+namespace OpenSim {
+
+class MarkersReference;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Solve the inverse kinematics of markers and coordinates, as does
+ * InverseKinematicsSolver, with a damped Gauss-Newton (Levenberg-Marquardt)
+ * method specialized for this least-squares problem, rather than the general
+ * SimTK::Assembler. It minimizes
+ * \f[
+ *   J = sum(Wm_i*(m_i-md_i)^T*(m_i-md_i)) + sum(Wq_j*(q_j-qd_j)^2)
+ * \f]
+ * over the coordinates q that are not locked or prescribed, and keeps the
+ * clamped coordinates within their ranges. Markers whose observations are
+ * missing (NaN) are ignored.
+ *
+ * Each iteration linearizes the errors with the analytic Jacobians of the
+ * marker stations from the matter subsystem, and solves the normal equations
+ * of the step, damped as needed for the error to decrease, by a Cholesky
+ * factorization. The coordinates solved for, and thus the size and structure
+ * of the normal equations, are found once, when the solver is constructed:
+ * those of the mobilized bodies that carry markers, and their ancestors, and
+ * those with a coordinate reference. track() starts from the solution of the
+ * previous frame, extrapolated linearly from the two previous frames when
+ * that fits the new observations better, and from the damping the previous
+ * frame ended with; a frame close to the previous one then takes one or two
+ * iterations.
+ *
+ * The model must have no enforced Constraint (use InverseKinematicsSolver for
+ * models with constraints) and use Euler angles rather than quaternions for
+ * its rotations, as models do by default. The solver works in its own copy of
+ * the state, made by assemble(), and copies the solved coordinates into the
+ * state it is given.
+ */
+class OSIMSIMULATION_API GaussNewtonIKSolver : public Solver {
+OpenSim_DECLARE_CONCRETE_OBJECT(GaussNewtonIKSolver, Solver);
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+    /** Construct a solver for the given model, which must have been
+    initialized (initSystem()), and references, which must outlive the
+    solver. The constraint weight is accepted for the same signature as
+    InverseKinematicsSolver, but there must be no constraints.
+    @throws Exception if the model has an enforced Constraint, uses
+    quaternions, or has none of the markers of the MarkersReference */
+    GaussNewtonIKSolver(const Model& model,
+            MarkersReference& markersReference,
+            SimTK::Array_<CoordinateReference>& coordinateReferences,
+            double constraintWeight = SimTK::Infinity);
+
+    /** %Set the accuracy of the solution: the iterations stop when no
+    coordinate changes by more than this (in radians or meters). The default
+    is 1e-4. */
+    void setAccuracy(double accuracy);
+    double getAccuracy() const { return _accuracy; }
+
+    /** %Set the maximum number of iterations of each call to track(). The
+    default is 50; assemble() takes up to 20 times as many. */
+    void setMaxIterations(int maxIterations);
+    int getMaxIterations() const { return _maxIterations; }
+
+    /** Solve for the coordinates of the given state, from its coordinates,
+    which need not be close to the solution. This also copies the state, so
+    call it again if anything but the time and coordinates of the state
+    changes (e.g., a coordinate is locked). */
+    void assemble(SimTK::State& s);
+
+    /** Solve for the coordinates of the given state at its time, starting
+    from the solution of the previous frame. assemble() must have been
+    called first. */
+    void track(SimTK::State& s);
+
+    /** The number of iterations taken by the last call to assemble() or
+    track(). */
+    int getNumIterations() const { return _numIterations; }
+    /** The number of iterations of all calls to assemble() and track() since
+    this solver was constructed. */
+    long long getTotalNumIterations() const { return _totalNumIterations; }
+
+    //--------------------------------------------------------------------------
+    // MARKERS
+    //--------------------------------------------------------------------------
+    /** The number of markers tracked: those of the MarkersReference that the
+    model has, in the order of the reference. */
+    int getNumMarkers() const { return (int)_markerBodies.size(); }
+    /** The name of a marker, given its index among the markers tracked. */
+    std::string getMarkerNameForIndex(int markerIndex) const;
+
+    /** Change the weighting of a marker, given the marker's name. Takes effect
+    when assemble() or track() is called next. */
+    void updateMarkerWeight(const std::string& markerName, double value);
+    /** Change the weighting of a marker, given its index in the
+    MarkersReference. Takes effect when assemble() or track() is called
+    next. */
+    void updateMarkerWeight(int markerIndex, double value);
+
+    /** Compute the locations in ground of all markers tracked, at the last
+    solution. */
+    void computeCurrentMarkerLocations(
+            SimTK::Array_<SimTK::Vec3>& markerLocations) const;
+    /** Compute the distances between all markers tracked and their
+    observations, at the last solution; 0 for missing observations. */
+    void computeCurrentMarkerErrors(SimTK::Array_<double>& markerErrors) const;
+    /** Compute the squared distances between all markers tracked and their
+    observations, at the last solution; 0 for missing observations. */
+    void computeCurrentSquaredMarkerErrors(
+            SimTK::Array_<double>& markerErrors) const;
+
+private:
+    // Find the markers, the coordinates solved for and their bounds.
+    void setupProblem(const SimTK::State& s);
+    // Read the observations, reference values and weights at the time of
+    // the internal state.
+    void updateObservations();
+    // Compute the weighted errors at the coordinates of the internal state,
+    // and return the objective.
+    double calcResiduals();
+    // Compute the Jacobian of the weighted errors with respect to the
+    // coordinates solved for.
+    void calcJacobian();
+    // Keep the clamped coordinates of the internal state within their ranges.
+    void clampCoordinates();
+    // Iterate from the coordinates of the internal state.
+    void solve(int maxIterations);
+
+//=============================================================================
+// MEMBER VARIABLES
+//=============================================================================
+    MarkersReference& _markersReference;
+    SimTK::Array_<CoordinateReference>& _coordinateReferences;
+
+    double _accuracy;
+    int _maxIterations;
+
+    // The markers tracked: the index of each in the MarkersReference, the
+    // mobilized body it is on and its station in that body.
+    SimTK::Array_<int> _markerReferenceIndices;
+    SimTK::Array_<SimTK::MobilizedBodyIndex> _markerBodies;
+    SimTK::Array_<SimTK::Vec3> _markerStations;
+    // The coordinate references that are goals, and the index in q of their
+    // coordinates.
+    SimTK::Array_<int> _coordinateGoals;
+    SimTK::Array_<int> _coordinateGoalQs;
+
+    // The coordinates solved for, by index in q, and the column of each q in
+    // the Jacobian, or -1 if it is not solved for.
+    std::vector<int> _freeQs;
+    std::vector<int> _columnOfQ;
+    // The clamped coordinates, by index in q, and their ranges.
+    std::vector<int> _clampedQs;
+    std::vector<double> _clampMin;
+    std::vector<double> _clampMax;
+
+    // The internal state, in which the problem is solved.
+    SimTK::State _state;
+    bool _hasState;
+
+    // The observations, reference values and weights of the current frame,
+    // with the square roots of the weights.
+    SimTK::Array_<SimTK::Vec3> _observations;
+    SimTK::Array_<double> _markerWeights;
+    SimTK::Array_<double> _sqrtMarkerWeights;
+    SimTK::Array_<double> _coordinateValues;
+    SimTK::Array_<double> _sqrtCoordinateWeights;
+
+    // The work space of the iterations, allocated once.
+    SimTK::Vector _residuals;
+    SimTK::Matrix _stationJacobian;
+    SimTK::Matrix _jacobian;
+    SimTK::Matrix _normal;
+    SimTK::Matrix _factor;
+    SimTK::Vector _gradient;
+    SimTK::Vector _step;
+    SimTK::Vector _unitQ;
+    SimTK::Vector _nInvColumn;
+    SimTK::Vector _startQ;
+
+    // The damping the last frame ended with.
+    double _damping;
+    // The solutions of the last two frames, for extrapolation.
+    SimTK::Vector _lastQ;
+    SimTK::Vector _previousQ;
+    double _lastTime;
+    double _previousTime;
+    int _numSolutions;
+
+    int _numIterations;
+    long long _totalNumIterations;
+
+//=============================================================================
+};  // END of class GaussNewtonIKSolver
+//=============================================================================
+} // namespace
+
+#endif // OPENSIM_GAUSS_NEWTON_IK_SOLVER_H_
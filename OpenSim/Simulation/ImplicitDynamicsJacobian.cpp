@@ -0,0 +1,297 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  ImplicitDynamicsJacobian.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ImplicitDynamicsJacobian.h"
+#include "Model/Model.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+//______________________________________________________________________________
+/**
+ * An implementation of the ImplicitDynamicsJacobian
+ *
+ * @param model whose dynamics to differentiate
+ */
+ImplicitDynamicsJacobian::ImplicitDynamicsJacobian(const Model& model)
+    : Solver(model)
+{
+    _stateCopy = model.getWorkingState();
+    model.getMultibodySystem().realize(_stateCopy, Stage::Instance);
+    findSparsity();
+    colorVariables();
+}
+
+//______________________________________________________________________________
+/**
+ * Assemble the dependencies of the residuals from those of the mobilized
+ * bodies and those declared by the components of the model.
+ */
+void ImplicitDynamicsJacobian::findSparsity()
+{
+    const Model& model = getModel();
+    const State& s = _stateCopy;
+    const SimbodyMatterSubsystem& matter = model.getMatterSubsystem();
+    const int nq = s.getNQ();
+    const int nu = s.getNU();
+    const int ny = s.getNY();
+    const int nc = model.getNumControls();
+    // The first variable of the accelerations and of the controls.
+    const int udot0 = ny;
+    const int x0 = ny + nu;
+
+    _sparsity.assign(ny, vector<int>());
+    _colors.assign(ny + nu + nc, -1);
+
+    // The derivatives of the coordinates of a mobilized body depend on its
+    // own coordinates and speeds.
+    for (MobilizedBodyIndex b(1); b < matter.getNumBodies(); ++b) {
+        const MobilizedBody& mobod = matter.getMobilizedBody(b);
+        const int q0 = mobod.getFirstQIndex(s);
+        const int u0 = mobod.getFirstUIndex(s);
+        vector<int> variables;
+        for (int i = 0; i < mobod.getNumQ(s); ++i)
+            variables.push_back(q0 + i);
+        for (int i = 0; i < mobod.getNumU(s); ++i)
+            variables.push_back(nq + u0 + i);
+        for (int i = 0; i < mobod.getNumQ(s); ++i)
+            _sparsity[q0 + i] = variables;
+    }
+
+    // Through the mass matrix and the Coriolis forces, the residual of each
+    // speed depends on all coordinates, speeds and accelerations.
+    for (int i = 0; i < nu; ++i) {
+        vector<int>& row = _sparsity[nq + i];
+        for (int j = 0; j < nq + nu; ++j) row.push_back(j);
+        for (int j = 0; j < nu; ++j) row.push_back(udot0 + j);
+    }
+
+    vector<int> allMobilities(nu);
+    for (int i = 0; i < nu; ++i) allMobilities[i] = i;
+    // All states and controls.
+    vector<int> allVariables;
+    for (int j = 0; j < ny; ++j) allVariables.push_back(j);
+    for (int k = 0; k < nc; ++k) allVariables.push_back(x0 + k);
+
+    // The z's whose derivatives are declared by the component that allocates
+    // them; the others depend on all states and controls.
+    vector<bool> declared(ny, false);
+    for (const ModelComponent& comp :
+            model.getComponentList<ModelComponent>()) {
+        // The z's allocated by this component itself.
+        vector<int> zs;
+        const Array<std::string> names = comp.getStateVariableNames();
+        const Array_<int> yIndices = comp.getStateVariableYIndices(s);
+        for (int i = 0; i < names.getSize(); ++i) {
+            if (yIndices[i] >= nq + nu &&
+                    names[i].find('/') == std::string::npos)
+                zs.push_back(yIndices[i]);
+        }
+        const Force* force = dynamic_cast<const Force*>(&comp);
+        if (zs.empty() && !force) continue;
+
+        vector<int> ys, controls, mobilities;
+        vector<int> variables;
+        if (comp.findDynamicsDependencies(s, ys, controls, mobilities)) {
+            variables = ys;
+            for (int k : controls) variables.push_back(x0 + k);
+            for (int z : zs) declared[z] = true;
+        }
+        else if (zs.empty()) {
+            // A force of the coordinates and speeds.
+            for (int j = 0; j < nq + nu; ++j) variables.push_back(j);
+            mobilities = allMobilities;
+        }
+        else {
+            variables = allVariables;
+            mobilities = allMobilities;
+        }
+
+        for (int z : zs)
+            _sparsity[z].insert(_sparsity[z].end(),
+                                variables.begin(), variables.end());
+        if (force) {
+            for (int i : mobilities)
+                _sparsity[nq + i].insert(_sparsity[nq + i].end(),
+                                         variables.begin(), variables.end());
+        }
+    }
+    for (int z = nq + nu; z < ny; ++z)
+        if (!declared[z]) _sparsity[z] = allVariables;
+
+    for (vector<int>& row : _sparsity) {
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+    }
+}
+
+//______________________________________________________________________________
+/**
+ * Color the variables greedily, in order, so that no residual depends on two
+ * variables of the same color.
+ */
+void ImplicitDynamicsJacobian::colorVariables()
+{
+    const int ny = getNumResiduals();
+    const int nu = _stateCopy.getNU();
+    const int nv = getNumVariables();
+
+    _residualsOfVariable.assign(nv, vector<int>());
+    for (int r = 0; r < ny; ++r)
+        for (int j : _sparsity[r]) _residualsOfVariable[j].push_back(r);
+
+    // For each color, whether a variable of that color perturbs a residual.
+    vector<vector<bool>> perturbed;
+    _variablesOfColor.clear();
+    for (int j = 0; j < nv; ++j) {
+        // The accelerations are not perturbed: their block is the mass
+        // matrix.
+        const vector<int>& residuals = _residualsOfVariable[j];
+        if ((j >= ny && j < ny + nu) || residuals.empty()) continue;
+
+        int color = 0;
+        for (; color < (int)perturbed.size(); ++color) {
+            const vector<bool>& used = perturbed[color];
+            if (std::none_of(residuals.begin(), residuals.end(),
+                             [&](int r) { return bool(used[r]); }))
+                break;
+        }
+        if (color == (int)perturbed.size()) {
+            perturbed.push_back(vector<bool>(ny, false));
+            _variablesOfColor.push_back(vector<int>());
+        }
+        for (int r : residuals) perturbed[color][r] = true;
+        _variablesOfColor[color].push_back(j);
+        _colors[j] = color;
+    }
+}
+
+int ImplicitDynamicsJacobian::getNumNonzeros() const
+{
+    int n = 0;
+    for (const vector<int>& row : _sparsity) n += (int)row.size();
+    return n;
+}
+
+//______________________________________________________________________________
+/**
+ * Evaluate the residuals and their Jacobian.
+ */
+Vector ImplicitDynamicsJacobian::packVariables(const State& s,
+        const Vector& udot, const Vector& controls) const
+{
+    const int ny = getNumResiduals();
+    const int nu = s.getNU();
+    const int nc = getNumVariables() - ny - nu;
+    OPENSIM_THROW_IF(s.getNY() != ny || udot.size() != nu ||
+                     controls.size() != nc, Exception,
+        "Expected a state of " + std::to_string(ny) + " variables, " +
+        std::to_string(nu) + " accelerations and " + std::to_string(nc) +
+        " controls; has the system been recreated?");
+
+    Vector variables(getNumVariables());
+    variables(0, ny) = s.getY();
+    variables(ny, nu) = udot;
+    variables(ny + nu, nc) = controls;
+    return variables;
+}
+
+void ImplicitDynamicsJacobian::evaluate(double time, const Vector& variables,
+                                        Vector& residuals) const
+{
+    const Model& model = getModel();
+    const MultibodySystem& system = model.getMultibodySystem();
+    State& s = _stateCopy;
+    const int nq = s.getNQ();
+    const int nu = s.getNU();
+    const int ny = s.getNY();
+    const int nc = getNumVariables() - ny - nu;
+
+    s.setTime(time);
+    s.updY() = variables(0, ny);
+    system.realize(s, Stage::Velocity);
+    if (nc > 0) model.setControls(s, variables(ny + nu, nc));
+    system.realize(s, Stage::Acceleration);
+
+    // The residuals of the speeds are those of inverse dynamics.
+    Vector residualForces;
+    system.getMatterSubsystem().calcResidualForceIgnoringConstraints(s,
+        system.getMobilityForces(s, Stage::Dynamics),
+        system.getRigidBodyForces(s, Stage::Dynamics),
+        variables(ny, nu), residualForces);
+
+    residuals.resize(ny);
+    residuals(0, nq) = s.getQDot();
+    residuals(nq, nu) = residualForces;
+    residuals(nq + nu, ny - nq - nu) = s.getZDot();
+}
+
+Vector ImplicitDynamicsJacobian::calcResiduals(const State& s,
+        const Vector& udot, const Vector& controls) const
+{
+    Vector residuals;
+    evaluate(s.getTime(), packVariables(s, udot, controls), residuals);
+    return residuals;
+}
+
+Matrix ImplicitDynamicsJacobian::calcJacobian(const State& s,
+        const Vector& udot, const Vector& controls) const
+{
+    const Vector variables = packVariables(s, udot, controls);
+    const int ny = getNumResiduals();
+    const int nq = s.getNQ();
+    const int nu = s.getNU();
+
+    Vector residuals0;
+    evaluate(s.getTime(), variables, residuals0);
+
+    Matrix jacobian(ny, getNumVariables(), 0.0);
+    // The residuals of the speeds are linear in the accelerations.
+    Matrix M;
+    getModel().getMatterSubsystem().calcM(_stateCopy, M);
+    jacobian(nq, ny, nu, nu) = M;
+
+    Vector perturbedVariables = variables;
+    Vector residuals;
+    Vector steps(getNumVariables(), 0.0);
+    for (const vector<int>& colorVariables : _variablesOfColor) {
+        for (int j : colorVariables) {
+            const double v = variables[j];
+            perturbedVariables[j] = v + SqrtEps*std::max(1.0, std::abs(v));
+            // The step that is actually taken, in floating point.
+            steps[j] = perturbedVariables[j] - v;
+        }
+        evaluate(s.getTime(), perturbedVariables, residuals);
+        for (int j : colorVariables) {
+            for (int r : _residualsOfVariable[j])
+                jacobian(r, j) = (residuals[r] - residuals0[r])/steps[j];
+            perturbedVariables[j] = variables[j];
+        }
+    }
+    return jacobian;
+}
+
+} // namespace
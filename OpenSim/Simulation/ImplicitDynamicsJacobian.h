@@ -0,0 +1,148 @@
+#ifndef OPENSIM_IMPLICIT_DYNAMICS_JACOBIAN_H_
+#define OPENSIM_IMPLICIT_DYNAMICS_JACOBIAN_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  ImplicitDynamicsJacobian.h                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Solver.h"
+#include "SimTKcommon/internal/State.h"
+
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Compute the sparse Jacobian of the dynamics of a model, in implicit form,
+ * by finite differences that perturb at once all variables that no residual
+ * shares (a coloring of the columns of the Jacobian). A model whose
+ * components each depend on few of its variables thus takes far fewer
+ * evaluations of its dynamics than it has variables.
+ *
+ * For the states y = [q; u; z], generalized accelerations udot and controls
+ * x, the residuals, one per state variable, are
+ *
+ *     r = [ qdot(q, u);  M(q)*udot + C(q, u) - f(t, y, x);  zdot(t, y, x) ]
+ *
+ * where f are the generalized forces applied by the model (including
+ * gravity); the constraints are ignored, as by InverseDynamicsSolver. The
+ * dynamics are satisfied where the residuals of the speeds are zero. The
+ * variables, i.e., the columns of the Jacobian, are [y; udot; x].
+ *
+ * In this form, the residuals of the speeds depend on the states and controls
+ * of only the forces that act on them, whereas each of the accelerations of
+ * the explicit form, udot = M^-1*(f - C), depends on all of them. The
+ * sparsity is assembled from the dependencies that the components of the
+ * model declare (ModelComponent::findDynamicsDependencies()): e.g., the
+ * residuals of a Muscle depend on its own states, its excitation and the
+ * coordinates that its path spans, and its force acts only on those
+ * coordinates. The residuals of the coordinates of a mobilized body depend on
+ * its own coordinates and speeds. The block of the mass matrix, the Jacobian
+ * with respect to udot, is computed directly.
+ */
+class OSIMSIMULATION_API ImplicitDynamicsJacobian : public Solver {
+OpenSim_DECLARE_CONCRETE_OBJECT(ImplicitDynamicsJacobian, Solver);
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+    /** Find the sparsity of the dynamics of the model, which must have been
+    initialized (initSystem()), and color the variables. Construct it again
+    after the system is recreated. */
+    explicit ImplicitDynamicsJacobian(const Model& model);
+
+    //--------------------------------------------------------------------------
+    // SPARSITY
+    //--------------------------------------------------------------------------
+    /** The number of residuals (rows), one per state variable. */
+    int getNumResiduals() const { return (int)_sparsity.size(); }
+    /** The number of variables (columns): the states, the generalized
+    accelerations and the controls. */
+    int getNumVariables() const { return (int)_colors.size(); }
+    /** For each residual, the variables it may depend on, in increasing
+    order. */
+    const std::vector<std::vector<int>>& getSparsity() const
+    {   return _sparsity; }
+    /** The number of entries of the Jacobian that may be nonzero. */
+    int getNumNonzeros() const;
+    /** The color of each variable. No residual depends on two variables of
+    the same color, so they are perturbed together. Variables that are not
+    perturbed have color -1: the generalized accelerations, and variables that
+    no residual depends on. */
+    const std::vector<int>& getColors() const { return _colors; }
+    /** The number of colors, which is the number of evaluations of the
+    residuals for a Jacobian, besides the one at the unperturbed
+    variables. */
+    int getNumColors() const { return (int)_variablesOfColor.size(); }
+
+    //--------------------------------------------------------------------------
+    // COMPUTATIONS
+    //--------------------------------------------------------------------------
+    /** Compute the residuals for the time and states of the given state,
+    the given generalized accelerations and the given controls, which take the
+    place of those of the model's controllers. */
+    SimTK::Vector calcResiduals(const SimTK::State& s,
+                                const SimTK::Vector& udot,
+                                const SimTK::Vector& controls) const;
+
+    /** Compute the Jacobian of the residuals with respect to the variables
+    [y; udot; x] at the given state, accelerations and controls, by forward
+    differences, with one evaluation of the residuals per color. Entries
+    outside the sparsity are zero. */
+    SimTK::Matrix calcJacobian(const SimTK::State& s,
+                               const SimTK::Vector& udot,
+                               const SimTK::Vector& controls) const;
+
+private:
+    void findSparsity();
+    void colorVariables();
+
+    // Gather the variables [y; udot; x].
+    SimTK::Vector packVariables(const SimTK::State& s,
+                                const SimTK::Vector& udot,
+                                const SimTK::Vector& controls) const;
+    // Compute the residuals at the given time and variables, in _stateCopy.
+    void evaluate(double time, const SimTK::Vector& variables,
+                  SimTK::Vector& residuals) const;
+
+//=============================================================================
+// MEMBER VARIABLES
+//=============================================================================
+    // Local copy of the state, in which the residuals are evaluated.
+    mutable SimTK::State _stateCopy;
+
+    std::vector<std::vector<int>> _sparsity;
+    // The residuals that depend on each variable.
+    std::vector<std::vector<int>> _residualsOfVariable;
+    std::vector<int> _colors;
+    std::vector<std::vector<int>> _variablesOfColor;
+
+//=============================================================================
+};  // END of class ImplicitDynamicsJacobian
+//=============================================================================
+} // namespace
+
+#endif // OPENSIM_IMPLICIT_DYNAMICS_JACOBIAN_H_
@@ -107,17 +107,19 @@ Vector InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, doub
     }
 
     // update the State so we get the correct gravity and Coriolis effects
-    // direct references into the state so no allocation required
+    // direct references into the state
     s.updTime() = time;
     Vector &q = s.updQ();
     Vector &u = s.updU();
     Vector &udot = s.updUDot();
 
-    for(int i=0; i<nq; i++){
-        q[i] = Qs.evaluate(i, 0, time);
-        u[i] = Qs.evaluate(i, 1, time);
-        udot[i] = Qs.evaluate(i, 2, time);
-    }
+    // evaluate all the functions at once, e.g., so that a GCVSplineSet
+    // searches for the time among the knots of its splines only once
+    Vector qs, us, udots;
+    Qs.evaluateWithDerivatives(time, qs, us, udots);
+    q = qs;
+    u = us;
+    udot = udots;
 
     // Perform general inverse dynamics
     return solve(s, udot);
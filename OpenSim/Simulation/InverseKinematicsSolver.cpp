@@ -23,16 +23,33 @@
 
 #include "InverseKinematicsSolver.h"
 #include "MarkersReference.h"
+#include "OrientationsReference.h"
 #include "Model/Model.h"
 #include "Model/MarkerSet.h"
+#include <OpenSim/Common/ThreadPool.h>
 
 #include "simbody/internal/AssemblyCondition_Markers.h"
+#include "simbody/internal/AssemblyCondition_OrientationSensors.h"
+
+#include <algorithm>
+#include <memory>
 
 using namespace std;
 using namespace SimTK;
 
 namespace OpenSim {
 
+namespace {
+    // The model's PhysicalFrame with the given name, or nullptr.
+    const PhysicalFrame* findPhysicalFrame(const Model& model,
+                                           const std::string& name)
+    {
+        for(const auto& frame : model.getComponentList<PhysicalFrame>())
+            if(frame.getName() == name) return &frame;
+        return nullptr;
+    }
+}
+
 //______________________________________________________________________________
 /*
  * An implementation of the InverseKinematicsSolver 
@@ -46,7 +63,28 @@ InverseKinematicsSolver::InverseKinematicsSolver(const Model &model, MarkersRefe
 {
     setAuthors("Ajay Seth");
 
-    // Do some consistency checking for markers
+    checkMarkers();
+}
+
+InverseKinematicsSolver::InverseKinematicsSolver(const Model &model, MarkersReference &markersReference,
+                            OrientationsReference &orientationsReference,
+                            SimTK::Array_<CoordinateReference> &coordinateReferences,
+                            double constraintWeight) : AssemblySolver(model, coordinateReferences, constraintWeight),
+                            _markersReference(markersReference),
+                            _orientationsReference(&orientationsReference)
+{
+    setAuthors("Ajay Seth");
+
+    // Markers are optional when solving for orientations.
+    if(_markersReference.getNumRefs() > 0)
+        checkMarkers();
+    checkOrientations();
+}
+
+/* Check that the markers of the MarkersReference correspond to markers of
+   the model. */
+void InverseKinematicsSolver::checkMarkers() const
+{
     const MarkerSet &modelMarkerSet = getModel().getMarkerSet();
 
     if(modelMarkerSet.getSize() < 1){
@@ -74,7 +112,22 @@ InverseKinematicsSolver::InverseKinematicsSolver(const Model &model, MarkersRefe
     }
     if(cnt < 4)
         cout << "WARNING: InverseKinematicsSolver found only " << cnt << " markers to track." << endl;
+}
+
+/* Check that the orientations of the OrientationsReference correspond to
+   frames of the model. */
+void InverseKinematicsSolver::checkOrientations() const
+{
+    const SimTK::Array_<std::string> &names = _orientationsReference->getNames();
+    OPENSIM_THROW_IF(names.size() < 1, Exception,
+        "InverseKinematicsSolver: No orientations available from data provided.");
 
+    int cnt = 0;
+    for(const auto& name : names)
+        if(findPhysicalFrame(getModel(), name)) cnt++;
+
+    OPENSIM_THROW_IF(cnt < 1, Exception,
+        "InverseKinematicsSolver: Orientation data does not correspond to any model frames.");
 }
 
 /* Change the weighting of a marker to take effect when assemble or track is called next. 
@@ -90,9 +143,9 @@ void InverseKinematicsSolver::updateMarkerWeight(const std::string &markerName,
 /* Update a marker's weight by its index. */
 void InverseKinematicsSolver::updateMarkerWeight(int markerIndex, double value)
 {
-    if(markerIndex >=0 && markerIndex < _markersReference.updMarkerWeightSet().getSize()){
-        _markersReference.updMarkerWeightSet()[markerIndex].setWeight(value);
-        _markerAssemblyCondition->changeMarkerWeight(SimTK::Markers::MarkerIx(markerIndex), value);
+    if(markerIndex >=0 && markerIndex < _markersReference.getNumRefs()){
+        setReferenceMarkerWeight(markerIndex, value);
+        changeGoalMarkerWeight(markerIndex, value);
     }
     else
         throw Exception("InverseKinematicsSolver::updateMarkerWeight: invalid markerIndex.");
@@ -102,24 +155,47 @@ void InverseKinematicsSolver::updateMarkerWeight(int markerIndex, double value)
    construct the solver. */
 void InverseKinematicsSolver::updateMarkerWeights(const SimTK::Array_<double> &weights)
 {
-    if(static_cast<unsigned>(_markersReference.updMarkerWeightSet().getSize()) 
-       == weights.size()){
+    if(static_cast<unsigned>(_markersReference.getNumRefs()) == weights.size()){
         for(unsigned int i=0; i<weights.size(); i++){
-            _markersReference.updMarkerWeightSet()[i].setWeight(weights[i]);
-            _markerAssemblyCondition->changeMarkerWeight(SimTK::Markers::MarkerIx(i), weights[i]);
+            setReferenceMarkerWeight(i, weights[i]);
+            changeGoalMarkerWeight(i, weights[i]);
         }
     }
     else
         throw Exception("InverseKinematicsSolver::updateMarkerWeights: invalid size of weights.");
 }
 
+/* Keep the weight of a marker in the MarkersReference, so that it is used
+   when the goals are set up again. */
+void InverseKinematicsSolver::setReferenceMarkerWeight(int markerIndex, double value)
+{
+    const std::string &name = _markersReference.getNames()[markerIndex];
+    Set<MarkerWeight> &markerWeights = _markersReference.updMarkerWeightSet();
+    const int wix = markerWeights.getIndex(name);
+    if(wix >= 0)
+        markerWeights[wix].setWeight(value);
+    else
+        markerWeights.adoptAndAppend(new MarkerWeight(name, value));
+}
+
+/* Change the weight of a marker of the MarkersReference in the Markers goal,
+   if it is in the goal. */
+void InverseKinematicsSolver::changeGoalMarkerWeight(int markerIndex, double value)
+{
+    if(!_markerAssemblyCondition || 
+            (unsigned)markerIndex >= _markerIxs.size())
+        return;
+    const SimTK::Markers::MarkerIx mx = _markerIxs[markerIndex];
+    if(mx.isValid())
+        _markerAssemblyCondition->changeMarkerWeight(mx, value);
+}
+
 /* Compute and return the spatial location of a marker in ground. */
 SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(const std::string &markerName)
 {
-    const Array_<std::string> &names = _markersReference.getNames();
-    SimTK::Array_<const std::string>::iterator p = std::find(names.begin(), names.end(), markerName);
-    int index = (int)std::distance(names.begin(), p);
-    return computeCurrentMarkerLocation(index);
+    if(!_markerAssemblyCondition)
+        throw Exception("InverseKinematicsSolver::computeCurrentMarkerLocation: the solver has not assembled yet.");
+    return computeCurrentMarkerLocation(_markerAssemblyCondition->getMarkerIx(markerName));
 }
 
 SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(int markerIndex)
@@ -143,10 +219,9 @@ void InverseKinematicsSolver::computeCurrentMarkerLocations(SimTK::Array_<SimTK:
 /* Compute and return the distance error between model marker and observation. */
 double InverseKinematicsSolver::computeCurrentMarkerError(const std::string &markerName)
 {
-    const Array_<std::string> &names = _markersReference.getNames();
-    SimTK::Array_<const std::string>::iterator p = std::find(names.begin(), names.end(), markerName);
-    int index = (int)std::distance(names.begin(), p);
-    return computeCurrentMarkerError(index);
+    if(!_markerAssemblyCondition)
+        throw Exception("InverseKinematicsSolver::computeCurrentMarkerError: the solver has not assembled yet.");
+    return computeCurrentMarkerError(_markerAssemblyCondition->getMarkerIx(markerName));
 }
 
 double InverseKinematicsSolver::computeCurrentMarkerError(int markerIndex)
@@ -170,10 +245,9 @@ void InverseKinematicsSolver::computeCurrentMarkerErrors(SimTK::Array_<double> &
 /* Compute and return the squared-distance error between model marker and observation. */
 double InverseKinematicsSolver::computeCurrentSquaredMarkerError(const std::string &markerName)
 {
-    const Array_<std::string> &names = _markersReference.getNames();
-    SimTK::Array_<const std::string>::iterator p = std::find(names.begin(), names.end(), markerName);
-    int index = (int)std::distance(names.begin(), p);
-    return computeCurrentSquaredMarkerError(index);
+    if(!_markerAssemblyCondition)
+        throw Exception("InverseKinematicsSolver::computeCurrentSquaredMarkerError: the solver has not assembled yet.");
+    return computeCurrentSquaredMarkerError(_markerAssemblyCondition->getMarkerIx(markerName));
 }
 
 double InverseKinematicsSolver::computeCurrentSquaredMarkerError(int markerIndex)
@@ -200,6 +274,81 @@ std::string InverseKinematicsSolver::getMarkerNameForIndex(int markerIndex) cons
 }
 
 
+/* Update an orientation's weight by name. */
+void InverseKinematicsSolver::updateOrientationWeight(const std::string &orientationName, double value)
+{
+    OPENSIM_THROW_IF(!_orientationsReference, Exception,
+        "InverseKinematicsSolver::updateOrientationWeight: the solver has no orientations.");
+    const Array_<std::string> &names = _orientationsReference->getNames();
+    auto p = std::find(names.begin(), names.end(), orientationName);
+    updateOrientationWeight((int)std::distance(names.begin(), p), value);
+}
+
+/* Update an orientation's weight by its index in the OrientationsReference,
+   both in the reference (for when the goals are set up again) and in the
+   goal. */
+void InverseKinematicsSolver::updateOrientationWeight(int orientationIndex, double value)
+{
+    OPENSIM_THROW_IF(!_orientationsReference || orientationIndex < 0 ||
+            orientationIndex >= _orientationsReference->getNumRefs(), Exception,
+        "InverseKinematicsSolver::updateOrientationWeight: invalid orientationIndex.");
+
+    const std::string &name = _orientationsReference->getNames()[orientationIndex];
+    Set<OrientationWeight> &weights = _orientationsReference->updOrientationWeightSet();
+    const int wix = weights.getIndex(name);
+    if(wix >= 0)
+        weights[wix].setWeight(value);
+    else
+        weights.adoptAndAppend(new OrientationWeight(name, value));
+
+    if(_orientationAssemblyCondition &&
+            (unsigned)orientationIndex < _orientationIxs.size() &&
+            _orientationIxs[orientationIndex].isValid())
+        _orientationAssemblyCondition->changeOSensorWeight(
+                _orientationIxs[orientationIndex], value);
+}
+
+/* Update all orientation weights by order in the OrientationsReference. */
+void InverseKinematicsSolver::updateOrientationWeights(const SimTK::Array_<double> &weights)
+{
+    OPENSIM_THROW_IF(!_orientationsReference ||
+            static_cast<unsigned>(_orientationsReference->getNumRefs()) != weights.size(),
+        Exception, "InverseKinematicsSolver::updateOrientationWeights: invalid size of weights.");
+    for(unsigned int i=0; i<weights.size(); i++)
+        updateOrientationWeight(i, weights[i]);
+}
+
+/* Compute and return the orientations in ground of the frames tracked. */
+void InverseKinematicsSolver::computeCurrentSensorOrientations(
+        SimTK::Array_<SimTK::Rotation> &sensorOrientations)
+{
+    OPENSIM_THROW_IF(!_orientationAssemblyCondition, Exception,
+        "InverseKinematicsSolver::computeCurrentSensorOrientations: the solver has no orientations or has not assembled yet.");
+    sensorOrientations.resize(_orientationIxs.size());
+    for(unsigned int i=0; i<_orientationIxs.size(); i++){
+        if(_orientationIxs[i].isValid())
+            sensorOrientations[i] = _orientationAssemblyCondition->
+                findCurrentOSensorOrientation(_orientationIxs[i]);
+        else
+            sensorOrientations[i].setRotationToNaN();
+    }
+}
+
+/* Compute and return the angles between the frames tracked and their
+   observations. */
+void InverseKinematicsSolver::computeCurrentOrientationErrors(
+        SimTK::Array_<double> &orientationErrors)
+{
+    OPENSIM_THROW_IF(!_orientationAssemblyCondition, Exception,
+        "InverseKinematicsSolver::computeCurrentOrientationErrors: the solver has no orientations or has not assembled yet.");
+    orientationErrors.resize(_orientationIxs.size());
+    for(unsigned int i=0; i<_orientationIxs.size(); i++){
+        orientationErrors[i] = _orientationIxs[i].isValid() ?
+            _orientationAssemblyCondition->findCurrentOSensorError(_orientationIxs[i]) :
+            SimTK::NaN;
+    }
+}
+
 /* Internal method to convert the MarkerReferences into additional goals of the 
     of the base assembly solver, that is going to do the assembly.  */
 void InverseKinematicsSolver::setupGoals(SimTK::State &s)
@@ -207,6 +356,17 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
     // Setup coordinates performed by the base class
     AssemblySolver::setupGoals(s);
 
+    if(_orientationsReference)
+        setupOrientationsGoal(s);
+
+    // Markers are optional when orientations are tracked.
+    if(_markersReference.getNumRefs() == 0){
+        _markerAssemblyCondition.clear();
+        _markerIxs.clear();
+        updateGoals(s);
+        return;
+    }
+
     std::unique_ptr<SimTK::Markers> condOwner(new SimTK::Markers());
     _markerAssemblyCondition.reset(condOwner.get());
 
@@ -220,8 +380,12 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
 
     int index = -1;
     SimTK::Transform X_BF;
+    // Fix the index of each marker of the reference in the goal, so that
+    // weights can be changed without looking markers up by name.
+    _markerIxs.clear();
     //Loop through all markers in the reference
     for(unsigned int i=0; i < markerNames.size(); ++i){
+        SimTK::Markers::MarkerIx mx;
         // Check if we have this marker in the model, else ignore it
         index = modelMarkerSet.getIndex(markerNames[i], index);
         if(index >= 0) {
@@ -230,10 +394,11 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
                 marker.getParentFrame().getMobilizedBody();
 
             X_BF = marker.getParentFrame().findTransformInBaseFrame();
-            _markerAssemblyCondition->
+            mx = _markerAssemblyCondition->
                 addMarker(marker.getName(), mobod, X_BF*marker.get_location(),
                           markerWeights[i]);
         }
+        _markerIxs.push_back(mx);
     }
 
     // Add marker goal to the ik objective and transfer ownership of the 
@@ -246,6 +411,35 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
     updateGoals(s);
 }
 
+/* Add the orientations of the OrientationsReference, for the frames the
+   model has, as a goal of the assembly solver. */
+void InverseKinematicsSolver::setupOrientationsGoal(SimTK::State &s)
+{
+    std::unique_ptr<SimTK::OrientationSensors>
+        condOwner(new SimTK::OrientationSensors());
+    _orientationAssemblyCondition.reset(condOwner.get());
+
+    const SimTK::Array_<std::string> &names = _orientationsReference->getNames();
+    SimTK::Array_<double> weights;
+    _orientationsReference->getWeights(s, weights);
+
+    _orientationIxs.clear();
+    for(unsigned int i=0; i < names.size(); ++i){
+        SimTK::OrientationSensors::OSensorIx ox;
+        if(const PhysicalFrame* frame = findPhysicalFrame(getModel(), names[i])){
+            ox = _orientationAssemblyCondition->addOSensor(names[i],
+                frame->getMobilizedBodyIndex(),
+                frame->findTransformInBaseFrame().R(), weights[i]);
+        }
+        _orientationIxs.push_back(ox);
+    }
+
+    updAssembler().adoptAssemblyGoal(condOwner.release());
+    // Observations are given in the order of the reference; those of frames
+    // the model does not have are ignored.
+    _orientationAssemblyCondition->defineObservationOrder(_orientationIxs);
+}
+
 /* Internal method to update the time, reference values and/or their weights based
     on the state */
 void InverseKinematicsSolver::updateGoals(const SimTK::State &s)
@@ -253,9 +447,81 @@ void InverseKinematicsSolver::updateGoals(const SimTK::State &s)
     // update coordinates performed by the base class
     AssemblySolver::updateGoals(s);
 
-    // specify the (initial) observations to be matched
-    _markersReference.getValues(s, _markerValues);
-    _markerAssemblyCondition->moveAllObservations(_markerValues);
+    // specify the (initial) observations to be matched, read directly from
+    // the marker data. Observations that are NaN (missing markers) are
+    // ignored by the Markers goal.
+    if(_markerAssemblyCondition){
+        const auto markerValues = _markersReference.getValuesView(s);
+        _markerValues.resize(markerValues.ncol());
+        for(int i=0; i < markerValues.ncol(); ++i)
+            _markerValues[i] = markerValues[i];
+        _markerAssemblyCondition->moveAllObservations(_markerValues);
+    }
+
+    // Orientations are converted to rotation matrices by the reference when
+    // they are loaded; missing (NaN) ones are ignored by the goal.
+    if(_orientationAssemblyCondition){
+        _orientationsReference->getValues(s, _orientationValues);
+        _orientationAssemblyCondition->moveAllObservations(_orientationValues);
+    }
+}
+
+TimeSeriesTable InverseKinematicsSolver::solve(const Model& model,
+        const MarkersReference& markersReference,
+        const OrientationsReference& orientationsReference,
+        const SimTK::Array_<CoordinateReference>& coordinateReferences,
+        const std::vector<double>& times,
+        double constraintWeight, double accuracy, int numThreads)
+{
+    OPENSIM_THROW_IF(times.empty(), Exception,
+        "InverseKinematicsSolver::solve: no times to solve at.");
+    const int nFrames = int(times.size());
+    const int nChunks = ThreadPool::getNumRanges(nFrames, numThreads);
+    const CoordinateSet& coordinates = model.getCoordinateSet();
+    const int nc = coordinates.getSize();
+
+    // Copies are made on this thread since initSystem() is not guaranteed
+    // to be thread-safe.
+    std::vector<std::unique_ptr<Model>> models;
+    std::vector<std::unique_ptr<MarkersReference>> markersRefs;
+    std::vector<std::unique_ptr<OrientationsReference>> orientationsRefs;
+    std::vector<SimTK::Array_<CoordinateReference>> coordinateRefs(
+            nChunks, coordinateReferences);
+    for(int c = 0; c < nChunks; ++c){
+        models.emplace_back(model.clone());
+        models.back()->initSystem();
+        markersRefs.emplace_back(markersReference.clone());
+        orientationsRefs.emplace_back(orientationsReference.clone());
+    }
+
+    SimTK::Matrix values(nFrames, nc);
+    ThreadPool::parallelForRanges(nFrames, nChunks, numThreads,
+        [&](int c, int first, int last) {
+            Model& chunkModel = *models[c];
+            const CoordinateSet& chunkCoordinates = chunkModel.getCoordinateSet();
+            SimTK::State s = chunkModel.getWorkingState();
+            InverseKinematicsSolver ikSolver(chunkModel, *markersRefs[c],
+                    *orientationsRefs[c], coordinateRefs[c], constraintWeight);
+            ikSolver.setAccuracy(accuracy);
+            s.updTime() = times[first];
+            ikSolver.assemble(s);
+
+            for(int i = first; i < last; ++i){
+                s.updTime() = times[i];
+                ikSolver.track(s);
+                for(int j = 0; j < nc; ++j)
+                    values(i, j) = chunkCoordinates[j].getValue(s);
+            }
+        });
+
+    TimeSeriesTable table;
+    std::vector<std::string> labels;
+    for(int j = 0; j < nc; ++j)
+        labels.push_back(coordinates[j].getName());
+    table.setColumnLabels(labels);
+    for(int i = 0; i < nFrames; ++i)
+        table.appendRow(times[i], values[i]);
+    return table;
 }
 
 } // end of namespace OpenSim
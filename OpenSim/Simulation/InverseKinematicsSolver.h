@@ -24,14 +24,14 @@
  * -------------------------------------------------------------------------- */
 
 #include "AssemblySolver.h"
-
-namespace SimTK {
-class Markers;
-}
+#include "simbody/internal/AssemblyCondition_Markers.h"
+#include "simbody/internal/AssemblyCondition_OrientationSensors.h"
+#include <OpenSim/Common/TimeSeriesTable.h>
 
 namespace OpenSim {
 
 class MarkersReference;
+class OrientationsReference;
 
 //=============================================================================
 //=============================================================================
@@ -52,7 +52,10 @@ class MarkersReference;
  * where m_i and md_i are the model and desired marker locations (Vec3); q_j
  * and qd_j are model and desired joint coordinates. Wm_i and Wq_j are the
  * marker and coordinate weightings, respectively, and Wc is the weighting on
- * constraint errors. When Wc == Infinity, the second term is not included,
+ * constraint errors. If an OrientationsReference is given, the objective
+ * also includes sum(Wo_k*a_k^2), where a_k is the angle between the model
+ * and desired orientations of frame k (e.g., of an IMU) and Wo_k its
+ * weighting. When Wc == Infinity, the second term is not included,
  * but instead q is subject to the constraint equations:
  *      \f[ c_{err} = G(q)-Go = 0 \f]
  *
@@ -79,6 +82,33 @@ public:
     InverseKinematicsSolver(const Model &model, MarkersReference &markersReference,
                             SimTK::Array_<CoordinateReference> &coordinateReferences,
                             double constraintWeight = SimTK::Infinity);
+
+    /** Solve for both marker locations and frame orientations. The
+        MarkersReference may have no markers (e.g., a default-constructed
+        one) to solve for orientations only; frames are the model's
+        PhysicalFrames with the names of the orientations. The references
+        must outlive the solver. */
+    InverseKinematicsSolver(const Model &model, MarkersReference &markersReference,
+                            OrientationsReference &orientationsReference,
+                            SimTK::Array_<CoordinateReference> &coordinateReferences,
+                            double constraintWeight = SimTK::Infinity);
+
+    /** Solve every frame at the given times, and return the values of the
+        model's coordinates (in radians or meters) at each, one column per
+        coordinate, labeled by name. The frames are split into numThreads
+        contiguous chunks (see ThreadPool::getNumRanges() for deterministic
+        mode) solved in parallel, each with its own copy of the
+        model and references; each chunk is assembled at its first frame and
+        tracked from there on, warm starting every frame from the solution of
+        the previous one. Use it to solve long recordings (e.g., the times of
+        an OrientationsReference, OrientationsReference::getTimes()). */
+    static TimeSeriesTable solve(const Model& model,
+            const MarkersReference& markersReference,
+            const OrientationsReference& orientationsReference,
+            const SimTK::Array_<CoordinateReference>& coordinateReferences,
+            const std::vector<double>& times,
+            double constraintWeight = SimTK::Infinity,
+            double accuracy = 1e-4, int numThreads = 1);
     
     /* Assemble a model configuration that meets the InverseKinematics conditions  
         (desired values and constraints) starting from an initial state that  
@@ -144,6 +174,27 @@ public:
         solver. */
     std::string getMarkerNameForIndex(int markerIndex) const;
 
+    /** Change the weighting of an orientation, given its name. Takes effect
+        when assemble() or track() is called next. */
+    void updateOrientationWeight(const std::string &orientationName, double value);
+    /** Change the weighting of an orientation, given its index in the
+        OrientationsReference. Takes effect when assemble() or track() is
+        called next. */
+    void updateOrientationWeight(int orientationIndex, double value);
+    /** Change the weighting of all orientations, in the order of the
+        OrientationsReference. */
+    void updateOrientationWeights(const SimTK::Array_<double> &weights);
+
+    /** Compute and return the orientations in ground of all the frames
+        tracked, in the order of the OrientationsReference; frames the model
+        does not have are NaN. */
+    void computeCurrentSensorOrientations(
+            SimTK::Array_<SimTK::Rotation> &sensorOrientations);
+    /** Compute and return the angle (in radians) between the orientation of
+        each frame tracked and its observation, in the order of the
+        OrientationsReference; NaN for frames the model does not have. */
+    void computeCurrentOrientationErrors(SimTK::Array_<double> &orientationErrors);
+
 protected:
     /** Internal method to convert the CoordinateReferences into goals of the 
         assembly solver. Subclasses can override to include other goals  
@@ -155,6 +206,17 @@ protected:
     void updateGoals(const SimTK::State &s) override;
 
 private:
+    // Keep the weight of a marker of the MarkersReference, given its index,
+    // for when the goals are set up again.
+    void setReferenceMarkerWeight(int markerIndex, double value);
+    // Change the weight of a marker of the MarkersReference, given its index,
+    // in the Markers goal.
+    void changeGoalMarkerWeight(int markerIndex, double value);
+    // Consistency checks of the references against the model.
+    void checkMarkers() const;
+    void checkOrientations() const;
+    void setupOrientationsGoal(SimTK::State &s);
+
     // The marker reference values and weightings
     MarkersReference &_markersReference;
 
@@ -165,6 +227,19 @@ private:
     // and the memory is managed by the Assembler
     SimTK::ReferencePtr<SimTK::Markers> _markerAssemblyCondition;
 
+    // The index in the Markers goal of each marker of the MarkersReference,
+    // in the order of the reference; invalid for markers the model does not
+    // have. Fixed when the goals are set up.
+    SimTK::Array_<SimTK::Markers::MarkerIx> _markerIxs;
+
+    // The orientation reference values and weightings, if any.
+    OrientationsReference *_orientationsReference = nullptr;
+    SimTK::Array_<SimTK::Rotation> _orientationValues;
+    SimTK::ReferencePtr<SimTK::OrientationSensors> _orientationAssemblyCondition;
+    // The index in the OrientationSensors goal of each orientation of the
+    // reference, as for markers.
+    SimTK::Array_<SimTK::OrientationSensors::OSensorIx> _orientationIxs;
+
 //=============================================================================
 };  // END of class InverseKinematicsSolver
 //=============================================================================
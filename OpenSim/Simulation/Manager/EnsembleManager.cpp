@@ -0,0 +1,269 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  EnsembleManager.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "EnsembleManager.h"
+#include "Manager.h"
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+using namespace OpenSim;
+
+//=============================================================================
+// CONSTRUCTOR
+//=============================================================================
+EnsembleManager::EnsembleManager(const Model& model) :
+    _model(model),
+    _numThreads(ThreadPool::getMaxNumThreads()),
+    _accuracy(1e-3),
+    _seed(0),
+    _hasPrefix(false)
+{
+}
+
+//=============================================================================
+// RUNS
+//=============================================================================
+int EnsembleManager::addRun(const SimTK::State& initialState,
+                            double finalTime, ModelModifier modifier)
+{
+    SeededModelModifier seeded;
+    if (modifier)
+        seeded = [modifier](Model& model, unsigned long long) {
+            modifier(model);
+        };
+    return addRun(initialState, finalTime, seeded);
+}
+
+int EnsembleManager::addRun(const SimTK::State& initialState,
+                            double finalTime, SeededModelModifier modifier)
+{
+    Run run;
+    run.initialTime = initialState.getTime();
+    run.finalTime = finalTime;
+    run.q = initialState.getQ();
+    run.u = initialState.getU();
+    run.z = initialState.getZ();
+    run.modifier = modifier;
+    _runs.push_back(std::move(run));
+    return (int)_runs.size() - 1;
+}
+
+void EnsembleManager::setPrefix(const SimTK::State& initialState,
+                                double branchTime)
+{
+    OPENSIM_THROW_IF(branchTime < initialState.getTime(), Exception,
+        "EnsembleManager: the branch time (" + std::to_string(branchTime) +
+        ") precedes the initial time of the prefix (" +
+        std::to_string(initialState.getTime()) + ").");
+    _prefix = Run();
+    _prefix.initialTime = initialState.getTime();
+    _prefix.finalTime = branchTime;
+    _prefix.q = initialState.getQ();
+    _prefix.u = initialState.getU();
+    _prefix.z = initialState.getZ();
+    _hasPrefix = true;
+}
+
+int EnsembleManager::addBranch(double finalTime, ModelModifier modifier)
+{
+    SeededModelModifier seeded;
+    if (modifier)
+        seeded = [modifier](Model& model, unsigned long long) {
+            modifier(model);
+        };
+    return addBranch(finalTime, seeded);
+}
+
+int EnsembleManager::addBranch(double finalTime, SeededModelModifier modifier)
+{
+    OPENSIM_THROW_IF(!_hasPrefix, Exception,
+        "EnsembleManager: call setPrefix() before adding branches.");
+    OPENSIM_THROW_IF(finalTime < _prefix.finalTime, Exception,
+        "EnsembleManager: the final time of a branch (" +
+        std::to_string(finalTime) + ") precedes the branch time (" +
+        std::to_string(_prefix.finalTime) + ").");
+    Run run;
+    run.finalTime = finalTime;
+    run.modifier = modifier;
+    run.branch = true;
+    _runs.push_back(std::move(run));
+    return (int)_runs.size() - 1;
+}
+
+unsigned long long EnsembleManager::getRunSeed(int runIndex) const
+{
+    getRun(runIndex);
+    return ThreadPool::getTaskSeed(_seed, runIndex);
+}
+
+const EnsembleManager::Run& EnsembleManager::getRun(int runIndex) const
+{
+    OPENSIM_THROW_IF(runIndex < 0 || runIndex >= getNumRuns(), IndexOutOfRange,
+                     (size_t)runIndex, 0, (size_t)std::max(getNumRuns() - 1, 0));
+    return _runs[runIndex];
+}
+
+bool EnsembleManager::getSuccess(int runIndex) const
+{
+    return getRun(runIndex).success;
+}
+
+const std::string& EnsembleManager::getErrorMessage(int runIndex) const
+{
+    return getRun(runIndex).errorMessage;
+}
+
+const TimeSeriesTable& EnsembleManager::getStatesTable(int runIndex) const
+{
+    return getRun(runIndex).states;
+}
+
+const TimeSeriesTable& EnsembleManager::getPrefixStatesTable() const
+{
+    OPENSIM_THROW_IF(!_hasPrefix, Exception,
+        "EnsembleManager: no prefix was set.");
+    return _prefix.states;
+}
+
+//=============================================================================
+// EXECUTION
+//=============================================================================
+int EnsembleManager::run()
+{
+    const int numRuns = getNumRuns();
+    const int numThreads =
+        std::max(1, std::min(ThreadPool::getNumThreads(_numThreads), numRuns));
+
+    // Copying and initializing models is not guaranteed to be thread-safe, so
+    // the threads take turns at it. Only the integrations run concurrently.
+    std::mutex setupMutex;
+    std::atomic<int> nextRun(0);
+
+    auto work = [&]() {
+        // The copy of the model shared by all the runs of this thread that do
+        // not modify the model.
+        std::unique_ptr<Model> model;
+        SimTK::State defaultState;
+
+        for (int i = nextRun++; i < numRuns; i = nextRun++) {
+            Run& run = _runs[i];
+            if (run.branch && !_prefix.success) continue;
+            try {
+                if (run.modifier) {
+                    std::unique_ptr<Model> modified;
+                    SimTK::State state;
+                    {
+                        std::lock_guard<std::mutex> lock(setupMutex);
+                        modified.reset(_model.clone());
+                        run.modifier(*modified, getRunSeed(i));
+                        state = modified->initSystem();
+                    }
+                    integrate(*modified, state, run);
+                }
+                else {
+                    if (!model) {
+                        std::lock_guard<std::mutex> lock(setupMutex);
+                        model.reset(_model.clone());
+                        defaultState = model->initSystem();
+                    }
+                    SimTK::State state = defaultState;
+                    integrate(*model, state, run);
+                }
+                run.success = true;
+            }
+            catch (const std::exception& e) {
+                run.success = false;
+                run.errorMessage = e.what();
+            }
+        }
+    };
+
+    for (auto& run : _runs) {
+        run.success = false;
+        run.errorMessage.clear();
+    }
+
+    // The prefix is integrated once, before the branches that continue it.
+    const bool hasBranches = std::any_of(_runs.begin(), _runs.end(),
+            [](const Run& run) { return run.branch; });
+    if (hasBranches) integratePrefix();
+
+    ThreadPool::parallelFor(numThreads, numThreads, [&](int) { work(); });
+
+    return (int)std::count_if(_runs.begin(), _runs.end(),
+                              [](const Run& run) { return run.success; });
+}
+
+void EnsembleManager::integratePrefix()
+{
+    _prefix.success = false;
+    _prefix.errorMessage.clear();
+    try {
+        std::unique_ptr<Model> model(_model.clone());
+        SimTK::State state = model->initSystem();
+        integrate(*model, state, _prefix);
+        _prefix.success = true;
+        for (auto& run : _runs) {
+            if (!run.branch) continue;
+            run.initialTime = state.getTime();
+            run.q = state.getQ();
+            run.u = state.getU();
+            run.z = state.getZ();
+        }
+    }
+    catch (const std::exception& e) {
+        _prefix.errorMessage = e.what();
+        for (auto& run : _runs)
+            if (run.branch)
+                run.errorMessage = "EnsembleManager: the prefix failed: " +
+                                   _prefix.errorMessage;
+    }
+}
+
+void EnsembleManager::integrate(Model& model, SimTK::State& state,
+                                Run& run) const
+{
+    OPENSIM_THROW_IF(run.q.size() != state.getNQ() ||
+                     run.u.size() != state.getNU() ||
+                     run.z.size() != state.getNZ(), Exception,
+        "EnsembleManager: the initial state of the run does not match the "
+        "state variables of the model.");
+    state.setTime(run.initialTime);
+    state.updQ() = run.q;
+    state.updU() = run.u;
+    state.updZ() = run.z;
+
+    Manager manager(model);
+    manager.setPerformAnalyses(false);
+    manager.getIntegrator().setAccuracy(_accuracy);
+    manager.setInitialTime(run.initialTime);
+    manager.setFinalTime(run.finalTime);
+    manager.integrate(state);
+    run.states = manager.getStatesTable();
+}
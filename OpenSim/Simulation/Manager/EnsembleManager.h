@@ -0,0 +1,218 @@
+#ifndef OPENSIM_ENSEMBLE_MANAGER_H_
+#define OPENSIM_ENSEMBLE_MANAGER_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  EnsembleManager.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKcommon/internal/State.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+class Model;
+
+//=============================================================================
+//=============================================================================
+/**
+ * A class that runs an ensemble of forward simulations of one model, for
+ * example for Monte Carlo or sensitivity studies. Each run starts from its own
+ * initial state and may modify its own copy of the model (e.g., to perturb
+ * muscle parameters or body masses) before it is initialized.
+ *
+ * The runs are integrated concurrently by a number of threads. Each thread
+ * works on its own copies of the model, so the model does not need to be
+ * parsed again and a run without a model modifier does not need to initialize
+ * a system. Threads take the next run that has not yet been started as soon as
+ * they finish one, so runs of very different durations still keep all the
+ * threads busy.
+ *
+ * Each run is integrated by a Manager with its default integrator and writes
+ * its states into its own TimeSeriesTable.
+ *
+ * For Monte Carlo studies, a model modifier may also take a seed, from which
+ * it draws the random perturbations of its run. The seed of each run depends
+ * only on the seed of the ensemble (setSeed()) and on the index of the run
+ * (see ThreadPool::getTaskSeed()), so that the ensemble gives the same
+ * results whatever the number of threads and the order in which the runs are
+ * taken:
+ * @code
+ * for (int i = 0; i < numRuns; ++i) {
+ *     ensemble.addRun(state, 1.0, [](Model& m, unsigned long long seed) {
+ *         std::mt19937_64 random(seed);
+ *         std::normal_distribution<double> mass(20.0, 1.0);
+ *         m.updBodySet().get("block").setMass(mass(random));
+ *     });
+ * }
+ * @endcode
+ *
+ * Runs that share the beginning of their motion (e.g., variants of a
+ * controller that only differ after 0.5 s) can branch from a common prefix:
+ * the prefix is integrated once, when the ensemble is run, and each branch
+ * continues from its final state, with its own model modifier. The states of
+ * the prefix are kept once, in getPrefixStatesTable(), and those of each
+ * branch start at the branch time:
+ * @code
+ * ensemble.setPrefix(state, 0.5);
+ * for (double gain : gains) {
+ *     ensemble.addBranch(2.0, [gain](Model& m) {
+ *         m.updComponent<MyController>("controller").set_gain(gain);
+ *     });
+ * }
+ * @endcode
+ *
+ * @code
+ * EnsembleManager ensemble(model);
+ * for (double mass : masses) {
+ *     ensemble.addRun(state, 1.0, [mass](Model& m) {
+ *         m.updBodySet().get("block").setMass(mass);
+ *     });
+ * }
+ * ensemble.run();
+ * for (int i = 0; i < ensemble.getNumRuns(); ++i)
+ *     const TimeSeriesTable& states = ensemble.getStatesTable(i);
+ * @endcode
+ */
+class OSIMSIMULATION_API EnsembleManager {
+public:
+    /** A function that modifies the copy of the model used by one run. It is
+    called before the copy is initialized, so it may change properties. */
+    typedef std::function<void(Model&)> ModelModifier;
+    /** A model modifier that is also given the seed of its run (see
+    getRunSeed()). */
+    typedef std::function<void(Model&, unsigned long long)>
+            SeededModelModifier;
+
+    /** The ensemble keeps a reference to the model, which must outlive it.
+    The model itself is never modified or integrated. */
+    explicit EnsembleManager(const Model& model);
+
+    EnsembleManager(const EnsembleManager&) = delete;
+    EnsembleManager& operator=(const EnsembleManager&) = delete;
+
+    /** Add a run that integrates from the given initial state to the given
+    final time. Only the time and the continuous state variables (q, u and z)
+    of the initial state are used, so the state may come from the system of
+    the model or of any other copy of it. If a model modifier is given, the
+    run is integrated with its own copy of the model, modified and then
+    initialized.
+    @return the index of the run */
+    int addRun(const SimTK::State& initialState, double finalTime,
+               ModelModifier modifier = nullptr);
+    /** As above, with a model modifier that takes the seed of the run. */
+    int addRun(const SimTK::State& initialState, double finalTime,
+               SeededModelModifier modifier);
+
+    /** %Set the prefix shared by the runs added with addBranch(): the
+    integration of the model, unmodified, from the given initial state to the
+    given branch time. As for addRun(), only the time and the continuous
+    state variables of the initial state are used. */
+    void setPrefix(const SimTK::State& initialState, double branchTime);
+    /** Whether a prefix was set with setPrefix(). */
+    bool hasPrefix() const { return _hasPrefix; }
+    /** Add a run that continues the prefix (see setPrefix()) from its final
+    state to the given final time. The branch starts from the time and the
+    continuous state variables at the end of the prefix, with a new
+    integrator, and with its own copy of the model if a model modifier is
+    given (e.g., to replace a controller or override parameters).
+    @return the index of the run */
+    int addBranch(double finalTime, ModelModifier modifier = nullptr);
+    /** As above, with a model modifier that takes the seed of the run. */
+    int addBranch(double finalTime, SeededModelModifier modifier);
+
+    int getNumRuns() const { return (int)_runs.size(); }
+
+    /** %Set the number of threads that integrate the runs, up to
+    ThreadPool::getMaxNumThreads(), which is also the default. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
+    /** %Set the seed from which the seeds of the runs are derived (default
+    0). */
+    void setSeed(unsigned long long seed) { _seed = seed; }
+    unsigned long long getSeed() const { return _seed; }
+    /** The seed given to the model modifier of the given run. */
+    unsigned long long getRunSeed(int runIndex) const;
+
+    /** %Set the accuracy of the integrator used by each run. */
+    void setIntegratorAccuracy(double accuracy) { _accuracy = accuracy; }
+    double getIntegratorAccuracy() const { return _accuracy; }
+
+    /** Integrate all the runs that have been added, after the prefix if any
+    run branches from it. A run that fails does not stop the others; use
+    getSuccess() and getErrorMessage() to find out which runs failed. If the
+    prefix fails, so do all the branches.
+    @return the number of runs that succeeded */
+    int run();
+
+    /** Whether the given run was integrated successfully. */
+    bool getSuccess(int runIndex) const;
+    /** The reason the given run failed, or an empty string. */
+    const std::string& getErrorMessage(int runIndex) const;
+    /** The states of the given run. Those of a branch start at the branch
+    time, with the final state of the prefix. */
+    const TimeSeriesTable& getStatesTable(int runIndex) const;
+    /** The states of the prefix, which end at the branch time. */
+    const TimeSeriesTable& getPrefixStatesTable() const;
+
+private:
+    struct Run {
+        double initialTime;
+        double finalTime;
+        SimTK::Vector q, u, z;
+        SeededModelModifier modifier;
+        // Whether the run continues from the end of the prefix.
+        bool branch = false;
+        bool success = false;
+        std::string errorMessage;
+        TimeSeriesTable states;
+    };
+
+    // Integrate one run with the given model, whose system must match the
+    // initial state of the run.
+    void integrate(Model& model, SimTK::State& state, Run& run) const;
+    // Integrate the prefix and start the branches from its final state, or
+    // fail them if the prefix fails.
+    void integratePrefix();
+
+    const Run& getRun(int runIndex) const;
+
+    const Model& _model;
+    std::vector<Run> _runs;
+    bool _hasPrefix;
+    Run _prefix;
+    int _numThreads;
+    double _accuracy;
+    unsigned long long _seed;
+
+//=============================================================================
+};  // END of class EnsembleManager
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_ENSEMBLE_MANAGER_H_
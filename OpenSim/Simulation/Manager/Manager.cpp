@@ -30,6 +30,20 @@
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/LiveValues.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <regex>
+#include <thread>
 
 
 
@@ -38,13 +52,346 @@ using namespace OpenSim;
 using namespace std;
 
 #define ASSERT(cond) {if (!(cond)) throw(exception());}
+
+namespace {
+// The first multiple of the interval after the initial time that is later
+// than the given time, or the given time if there is no interval.
+double nextRecordingTime(double time, double initialTime, double interval)
+{
+    if (interval <= 0) return time;
+    return initialTime +
+        (std::floor((time - initialTime)/interval + SimTK::SqrtEps) + 1)*
+        interval;
+}
+
+// The values of the Outputs of the components of the model that count the
+// iterations of their solvers (see IterationCounter), by path.
+std::map<std::string, double> getIterationCounts(const Model& model,
+                                                 const SimTK::State& s)
+{
+    static const std::string suffix = "_iterations";
+    std::map<std::string, double> counts;
+    for (const auto& comp : model.getComponentList()) {
+        for (const auto& name : comp.getOutputNames()) {
+            if (name.size() <= suffix.size() ||
+                    name.compare(name.size() - suffix.size(), suffix.size(),
+                                 suffix) != 0)
+                continue;
+            const auto* output =
+                dynamic_cast<const Output<double>*>(&comp.getOutput(name));
+            if (output)
+                counts[comp.getAbsolutePathName() + "|" + name] =
+                        output->getValue(s);
+        }
+    }
+    return counts;
+}
+}
 //=============================================================================
 // STATICS
 //=============================================================================
 std::string Manager::_displayName = "Simulator";
+//=============================================================================
+// OUTPUT QUEUE
+//=============================================================================
+// A bounded queue of the states at the steps of an integration, which a
+// thread takes in order to step the analyses and store the states and
+// controls. States are processed by a single thread because the analyses
+// record their results in the order of the steps.
+class Manager::OutputQueue {
+public:
+    OutputQueue(Manager& manager, int size) :
+        _manager(manager), _size(size), _done(false),
+        _thread(&OutputQueue::run, this) {}
+
+    ~OutputQueue() {
+        close();
+        if (_thread.joinable()) _thread.join();
+    }
+
+    // Queue a copy of the state, waiting while the queue is full.
+    void push(const SimTK::State& s, int step) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this]
+            { return (int)_steps.size() < _size || _error; });
+        if (_error) std::rethrow_exception(_error);
+        _steps.emplace_back(step, s);
+        _notEmpty.notify_one();
+    }
+
+    // Wait for all the queued states to be processed, and rethrow the error
+    // that stopped the processing, if any.
+    void finish() {
+        close();
+        _thread.join();
+        if (_error) std::rethrow_exception(_error);
+    }
+
+private:
+    void close() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+        _notEmpty.notify_one();
+    }
+
+    void run() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notEmpty.wait(lock, [this] { return !_steps.empty() || _done; });
+            if (_steps.empty()) return;
+            // Process the state at the front of the queue in place, so that
+            // the integration waits only for a free slot. The reference is
+            // taken under the lock, as push() may reallocate the map of the
+            // deque; emplace_back() leaves references to its elements valid.
+            auto& entry = _steps.front();
+            lock.unlock();
+            try {
+                _manager.recordStep(entry.second, entry.first);
+            }
+            catch (...) {
+                lock.lock();
+                _error = std::current_exception();
+                _steps.clear();
+                _notFull.notify_one();
+                return;
+            }
+            lock.lock();
+            _steps.pop_front();
+            _notFull.notify_one();
+        }
+    }
+
+    Manager& _manager;
+    const int _size;
+    std::deque<std::pair<int, SimTK::State>> _steps;
+    bool _done;
+    std::exception_ptr _error;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::thread _thread;
+};
+
+//=============================================================================
+// CHECKPOINTS
+//=============================================================================
+// A checkpoint file holds, in the byte order of the machine that wrote it:
+// a magic string, a byte-order mark, the time, the step, the output count,
+// the predicted step size, the continuous state variables and the discrete
+// variables of the supported types, each with its subsystem, index and type.
+namespace {
+    const char CheckpointMagic[8] = {'O','S','I','M','C','K','P','1'};
+    const std::uint32_t CheckpointByteOrderMark = 0x01020304;
+
+    enum CheckpointValueType : std::int32_t {
+        CheckpointDouble = 0,
+        CheckpointInt = 1,
+        CheckpointBool = 2,
+        CheckpointVector = 3
+    };
+
+    struct Checkpoint {
+        double time;
+        int step;
+        int outputCount;
+        double stepSize;
+    };
+
+    template <typename T>
+    void writeBinary(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    T readBinary(std::istream& in, const std::string& fileName) {
+        T value;
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        OPENSIM_THROW_IF(!in, Exception,
+            "Manager: checkpoint file '" + fileName + "' is truncated.");
+        return value;
+    }
+
+    void writeDoubles(std::ostream& out, const SimTK::Vector& values) {
+        writeBinary<std::int32_t>(out, values.size());
+        for (int i = 0; i < values.size(); ++i)
+            writeBinary<double>(out, values[i]);
+    }
+
+    void readDoubles(std::istream& in, const std::string& fileName,
+                     SimTK::Vector& values) {
+        const auto size = readBinary<std::int32_t>(in, fileName);
+        OPENSIM_THROW_IF(size != values.size(), Exception,
+            "Manager: checkpoint file '" + fileName + "' has " +
+            std::to_string(size) + " values where the state has " +
+            std::to_string(values.size()) + ".");
+        for (int i = 0; i < size; ++i)
+            values[i] = readBinary<double>(in, fileName);
+    }
+
+    void writeCheckpointFile(const std::string& fileName,
+                             const SimTK::State& s,
+                             const Checkpoint& checkpoint) {
+        std::ofstream out(fileName, std::ios::binary);
+        OPENSIM_THROW_IF(!out, Exception,
+            "Manager: could not open checkpoint file '" + fileName + "'.");
+        out.write(CheckpointMagic, sizeof(CheckpointMagic));
+        writeBinary(out, CheckpointByteOrderMark);
+        writeBinary<double>(out, checkpoint.time);
+        writeBinary<std::int32_t>(out, checkpoint.step);
+        writeBinary<std::int32_t>(out, checkpoint.outputCount);
+        writeBinary<double>(out, checkpoint.stepSize);
+        writeDoubles(out, s.getY());
+
+        // Count the discrete variables of the supported types first.
+        std::int32_t numDiscrete = 0;
+        for (SimTK::SubsystemIndex sx(0); sx < s.getNumSubsystems(); ++sx) {
+            for (SimTK::DiscreteVariableIndex dx(0);
+                    dx < s.getNDiscreteVars(sx); ++dx) {
+                const auto& value = s.getDiscreteVariable(sx, dx);
+                if (SimTK::Value<double>::isA(value) ||
+                        SimTK::Value<int>::isA(value) ||
+                        SimTK::Value<bool>::isA(value) ||
+                        SimTK::Value<SimTK::Vector>::isA(value))
+                    ++numDiscrete;
+            }
+        }
+        writeBinary(out, numDiscrete);
+        for (SimTK::SubsystemIndex sx(0); sx < s.getNumSubsystems(); ++sx) {
+            for (SimTK::DiscreteVariableIndex dx(0);
+                    dx < s.getNDiscreteVars(sx); ++dx) {
+                const auto& value = s.getDiscreteVariable(sx, dx);
+                std::int32_t type;
+                if (SimTK::Value<double>::isA(value)) type = CheckpointDouble;
+                else if (SimTK::Value<int>::isA(value)) type = CheckpointInt;
+                else if (SimTK::Value<bool>::isA(value)) type = CheckpointBool;
+                else if (SimTK::Value<SimTK::Vector>::isA(value))
+                    type = CheckpointVector;
+                else continue;
+                writeBinary<std::int32_t>(out, sx);
+                writeBinary<std::int32_t>(out, dx);
+                writeBinary(out, type);
+                switch (type) {
+                case CheckpointDouble:
+                    writeBinary<double>(out,
+                        SimTK::Value<double>::downcast(value).get());
+                    break;
+                case CheckpointInt:
+                    writeBinary<std::int32_t>(out,
+                        SimTK::Value<int>::downcast(value).get());
+                    break;
+                case CheckpointBool:
+                    writeBinary<std::int8_t>(out,
+                        SimTK::Value<bool>::downcast(value).get());
+                    break;
+                case CheckpointVector:
+                    writeDoubles(out,
+                        SimTK::Value<SimTK::Vector>::downcast(value).get());
+                    break;
+                }
+            }
+        }
+        OPENSIM_THROW_IF(!out, Exception,
+            "Manager: could not write checkpoint file '" + fileName + "'.");
+    }
+
+    // Read the checkpoint in the given file into the state, which must have
+    // the same state variables as the state the checkpoint was written from.
+    Checkpoint readCheckpoint(const std::string& fileName, SimTK::State& s) {
+        std::ifstream in(fileName, std::ios::binary);
+        OPENSIM_THROW_IF(!in, Exception,
+            "Manager: could not open checkpoint file '" + fileName + "'.");
+        char magic[sizeof(CheckpointMagic)];
+        in.read(magic, sizeof(magic));
+        OPENSIM_THROW_IF(!in ||
+                !std::equal(magic, magic + sizeof(magic), CheckpointMagic),
+            Exception, "Manager: '" + fileName + "' is not a checkpoint file.");
+        OPENSIM_THROW_IF(readBinary<std::uint32_t>(in, fileName) !=
+                CheckpointByteOrderMark, Exception,
+            "Manager: checkpoint file '" + fileName + "' was written on a "
+            "machine with a different byte order.");
+
+        Checkpoint checkpoint;
+        checkpoint.time = readBinary<double>(in, fileName);
+        checkpoint.step = readBinary<std::int32_t>(in, fileName);
+        checkpoint.outputCount = readBinary<std::int32_t>(in, fileName);
+        checkpoint.stepSize = readBinary<double>(in, fileName);
+        readDoubles(in, fileName, s.updY());
+        s.setTime(checkpoint.time);
+
+        const std::string mismatch = "Manager: the discrete variables in "
+            "checkpoint file '" + fileName + "' do not match the state.";
+        const auto numDiscrete = readBinary<std::int32_t>(in, fileName);
+        for (std::int32_t i = 0; i < numDiscrete; ++i) {
+            const SimTK::SubsystemIndex sx(
+                    readBinary<std::int32_t>(in, fileName));
+            const SimTK::DiscreteVariableIndex dx(
+                    readBinary<std::int32_t>(in, fileName));
+            const auto type = readBinary<std::int32_t>(in, fileName);
+            OPENSIM_THROW_IF(sx < 0 || sx >= s.getNumSubsystems() ||
+                             dx < 0 || dx >= s.getNDiscreteVars(sx),
+                             Exception, mismatch);
+            SimTK::AbstractValue& value = s.updDiscreteVariable(sx, dx);
+            switch (type) {
+            case CheckpointDouble:
+                OPENSIM_THROW_IF(!SimTK::Value<double>::isA(value),
+                                 Exception, mismatch);
+                SimTK::Value<double>::updDowncast(value).upd() =
+                    readBinary<double>(in, fileName);
+                break;
+            case CheckpointInt:
+                OPENSIM_THROW_IF(!SimTK::Value<int>::isA(value),
+                                 Exception, mismatch);
+                SimTK::Value<int>::updDowncast(value).upd() =
+                    readBinary<std::int32_t>(in, fileName);
+                break;
+            case CheckpointBool:
+                OPENSIM_THROW_IF(!SimTK::Value<bool>::isA(value),
+                                 Exception, mismatch);
+                SimTK::Value<bool>::updDowncast(value).upd() =
+                    readBinary<std::int8_t>(in, fileName) != 0;
+                break;
+            case CheckpointVector:
+                OPENSIM_THROW_IF(!SimTK::Value<SimTK::Vector>::isA(value),
+                                 Exception, mismatch);
+                readDoubles(in, fileName,
+                    SimTK::Value<SimTK::Vector>::updDowncast(value).upd());
+                break;
+            default:
+                OPENSIM_THROW(Exception, mismatch);
+            }
+        }
+        return checkpoint;
+    }
+}
+
+void Manager::writeCheckpoint(const SimTK::State& s, int step,
+                              int outputCount) const
+{
+    Checkpoint checkpoint;
+    checkpoint.time = s.getTime();
+    checkpoint.step = step;
+    checkpoint.outputCount = outputCount;
+    checkpoint.stepSize = _integ->getPredictedNextStepSize();
+
+    // Write to a temporary file first so that a process stopped while
+    // writing leaves the previous checkpoint intact.
+    const std::string partialFile = _checkpointFile + ".part";
+    writeCheckpointFile(partialFile, s, checkpoint);
+    if (std::rename(partialFile.c_str(), _checkpointFile.c_str()) != 0) {
+        // On Windows, rename() does not replace an existing file.
+        std::remove(_checkpointFile.c_str());
+        OPENSIM_THROW_IF(
+            std::rename(partialFile.c_str(), _checkpointFile.c_str()) != 0,
+            Exception, "Manager: could not write checkpoint file '" +
+            _checkpointFile + "'.");
+    }
+}
+
 //=============================================================================
 // DESTRUCTOR
 //=============================================================================
+Manager::~Manager() = default;
+
 
 
 //=============================================================================
@@ -52,9 +399,7 @@ std::string Manager::_displayName = "Simulator";
 //=============================================================================
 Manager::Manager(Model& model) : Manager(model, true)
 {
-    _defaultInteg.reset(
-            new SimTK::RungeKuttaMersonIntegrator(_model->getMultibodySystem()));
-    _integ = *_defaultInteg;
+    setIntegratorMethod(IntegratorMethod::RungeKuttaMerson);
 }
 
 Manager::Manager(Model& aModel, SimTK::Integrator& integ)
@@ -67,7 +412,10 @@ Manager::Manager(Model& model, bool dummyVar) :
        _model(&model),
        _performAnalyses(true),
        _writeToStorage(true),
-       _controllerSet(&model.updControllerSet())
+       _controllerSet(&model.updControllerSet()),
+       _outputInterval(0),
+       _outputQueueSize(0),
+       _checkpointInterval(0)
 {
     setNull();
 
@@ -78,7 +426,8 @@ Manager::Manager(Model& model, bool dummyVar) :
     setSessionName(_model->getName());
 }
 
-Manager::Manager()
+Manager::Manager() : _outputInterval(0), _outputQueueSize(0),
+        _checkpointInterval(0)
 {
     setNull();
 }
@@ -104,6 +453,16 @@ setNull()
     _writeToStorage=true;
     _tArray.setSize(0);
     _dtArray.setSize(0);
+    _tArrayCursor = 0;
+    _reinitializeTimeStepper = false;
+    _realTimeStepSize = 0;
+    _numRealTimeOverruns = 0;
+    _recordedStatesNeedAllValues = false;
+    _stateRecordingDecimation = 1;
+    _stateRecordingInterval = 0;
+    _numStepsSinceRecordedStates = 0;
+    _lastRecordedStatesTime = -SimTK::Infinity;
+    _nextRecordedStatesTime = -SimTK::Infinity;
 }
 
 //_____________________________________________________________________________
@@ -119,10 +478,47 @@ constructStorage()
     // STATES
     Array<string> stateNames = _model->getStateVariableNames();
     int ny = stateNames.getSize();
+
+    // The state variables selected by name or by pattern, in the order of
+    // the model.
+    _recordedStateIndices.clear();
+    if(!_recordedStatePatterns.empty()) {
+        vector<bool> selected(ny, false);
+        for(const string& pattern : _recordedStatePatterns) {
+            int i = stateNames.findIndex(pattern);
+            if(i >= 0) {
+                selected[i] = true;
+                continue;
+            }
+            std::regex expression;
+            try { expression.assign(pattern); }
+            catch(const std::regex_error& e) {
+                OPENSIM_THROW(Exception,
+                    "Manager::setRecordedStateVariables(): '" + pattern +
+                    "' is neither the name of a state variable "
+                    "nor a regular expression (" + e.what() + ").");
+            }
+            bool found = false;
+            for(i=0;i<ny;i++) {
+                if(std::regex_match(stateNames[i], expression))
+                    selected[i] = found = true;
+            }
+            OPENSIM_THROW_IF(!found, Exception,
+                "Manager::setRecordedStateVariables(): no state variable "
+                "matches '" + pattern + "'.");
+        }
+        for(int i=0;i<ny;i++)
+            if(selected[i]) _recordedStateIndices.push_back(i);
+    }
+
     _stateStore.reset(new Storage(512,"states"));
     columnLabels.setSize(0);
     columnLabels.append("time");
-    for(int i=0;i<ny;i++) columnLabels.append(stateNames[i]);
+    if(_recordedStateIndices.empty()) {
+        for(int i=0;i<ny;i++) columnLabels.append(stateNames[i]);
+    } else {
+        for(int i : _recordedStateIndices) columnLabels.append(stateNames[i]);
+    }
     _stateStore->setColumnLabels(columnLabels);
 
     return(true);
@@ -384,10 +780,38 @@ getTimeArray()
 int Manager::
 getTimeArrayStep(double aTime)
 {
-    int step = _tArray.searchBinary(aTime);
+    int step = findTimeArrayStep(aTime);
     return(step);
 }
 //_____________________________________________________________________________
+/**
+ * Find the step of the time array at or before a specified time. The steps
+ * at and after the step found last are checked first, since an integration
+ * advances through the time array; other times are searched for.
+ *
+ * @param aTime Time of the integration step.
+ * @return Step that occurred prior to or at aTime, as for
+ * Array::searchBinary().
+ */
+int Manager::
+findTimeArrayStep(double aTime)
+{
+    const int size = _tArray.getSize();
+    int step = _tArrayCursor;
+    if(step < size && _tArray[step] <= aTime) {
+        // Unless aTime is past the next step or two, one of them is it.
+        for(int k = 0; k < 2 && step + 1 < size && _tArray[step + 1] <= aTime;
+                ++k) ++step;
+        if(step + 1 >= size || aTime < _tArray[step + 1]) {
+            _tArrayCursor = step;
+            return step;
+        }
+    }
+    step = _tArray.searchBinary(aTime);
+    _tArrayCursor = std::max(step, 0);
+    return step;
+}
+//_____________________________________________________________________________
 /**
  * Get the next time in the time array
  *
@@ -397,7 +821,7 @@ getTimeArrayStep(double aTime)
 double Manager::
 getNextTimeArrayTime(double aTime)
 {
-    return(getTimeArrayTime( _tArray.searchBinary(aTime)+1));
+    return(getTimeArrayTime( findTimeArrayStep(aTime)+1));
 }
 //_____________________________________________________________________________
 //
@@ -529,6 +953,167 @@ setIntegrator(SimTK::Integrator& integrator)
     _defaultInteg.reset();
 }
 
+void Manager::
+setIntegratorMethod(IntegratorMethod method)
+{
+    OPENSIM_THROW_IF(_model == nullptr, Exception,
+        "Manager::setIntegratorMethod(): the Manager has no model.");
+    if (_timeStepper) {
+        OPENSIM_THROW(Exception, "Cannot set a new integrator on this Manager "
+            "after Manager::integrate() has been called at least once.");
+    }
+
+    const SimTK::System& system = _model->getMultibodySystem();
+    std::unique_ptr<SimTK::Integrator> integ;
+    switch (method) {
+    case IntegratorMethod::ExplicitEuler:
+        integ.reset(new SimTK::ExplicitEulerIntegrator(system));
+        break;
+    case IntegratorMethod::RungeKutta2:
+        integ.reset(new SimTK::RungeKutta2Integrator(system));
+        break;
+    case IntegratorMethod::RungeKutta3:
+        integ.reset(new SimTK::RungeKutta3Integrator(system));
+        break;
+    case IntegratorMethod::RungeKuttaFeldberg:
+        integ.reset(new SimTK::RungeKuttaFeldbergIntegrator(system));
+        break;
+    case IntegratorMethod::RungeKuttaMerson:
+        integ.reset(new SimTK::RungeKuttaMersonIntegrator(system));
+        break;
+    case IntegratorMethod::SemiExplicitEuler2:
+        integ.reset(new SimTK::SemiExplicitEuler2Integrator(system));
+        break;
+    case IntegratorMethod::Verlet:
+        integ.reset(new SimTK::VerletIntegrator(system));
+        break;
+    case IntegratorMethod::CPodes:
+        integ.reset(new SimTK::CPodesIntegrator(system, SimTK::CPodes::BDF,
+                                                SimTK::CPodes::Newton));
+        break;
+    }
+
+    _defaultInteg = std::move(integ);
+    _integ = *_defaultInteg;
+}
+
+void Manager::
+setIntegratorAccuracy(double accuracy)
+{
+    OPENSIM_THROW_IF(!_integ, Exception,
+        "Manager::setIntegratorAccuracy(): the Manager has no integrator.");
+    _integ->setAccuracy(accuracy);
+}
+
+void Manager::
+setOutputInterval(double interval)
+{
+    OPENSIM_THROW_IF(interval < 0, Exception,
+        "Manager::setOutputInterval(): the interval must not be negative.");
+    _outputInterval = interval;
+}
+
+void Manager::
+setRecordedStateVariables(const std::vector<std::string>& names)
+{
+    _recordedStatePatterns = names;
+    constructStorage();
+}
+
+void Manager::
+setStateRecordingDecimation(int decimation)
+{
+    OPENSIM_THROW_IF(decimation < 1, Exception,
+        "Manager::setStateRecordingDecimation(): the decimation must be at "
+        "least 1.");
+    _stateRecordingDecimation = decimation;
+}
+
+void Manager::
+setStateRecordingInterval(double interval)
+{
+    OPENSIM_THROW_IF(interval < 0, Exception,
+        "Manager::setStateRecordingInterval(): the interval must not be "
+        "negative.");
+    _stateRecordingInterval = interval;
+}
+
+void Manager::
+setOutputQueueSize(int size)
+{
+    OPENSIM_THROW_IF(size < 0, Exception,
+        "Manager::setOutputQueueSize(): the size must not be negative.");
+    _outputQueueSize = size;
+}
+
+void Manager::
+setRealTimeStepSize(double stepSize)
+{
+    OPENSIM_THROW_IF(stepSize < 0, Exception,
+        "Manager::setRealTimeStepSize(): the step size must not be "
+        "negative.");
+    if(stepSize > 0) {
+        OPENSIM_THROW_IF(_model == nullptr || !_model->hasSystem(),
+            Exception, "Manager::setRealTimeStepSize(): the Model has no "
+            "System; call Model::initSystem() first.");
+        const int numStates = _model->getNumStateVariables();
+        if(!_liveOutputs || _liveOutputs->getSize() != numStates)
+            _liveOutputs.reset(new LiveValues(numStates));
+    }
+    _realTimeStepSize = stepSize;
+}
+
+const LiveValues& Manager::
+getLiveOutputs() const
+{
+    OPENSIM_THROW_IF(!_liveOutputs, Exception,
+        "Manager::getLiveOutputs(): no real-time step size has been set.");
+    return *_liveOutputs;
+}
+
+void Manager::
+printIntegrationStatistics(std::ostream& out) const
+{
+    const IntegrationStatistics& stats = _integrationStatistics;
+    out << "Integration statistics of " << getSessionName() << ":\n"
+        << "  steps taken:                " << stats.numStepsTaken << "\n"
+        << "  steps attempted:            " << stats.numStepsAttempted << "\n"
+        << "  error test failures:        " << stats.numErrorTestFailures
+        << "\n"
+        << "  convergence test failures:  "
+        << stats.numConvergenceTestFailures << "\n"
+        << "  integrator iterations:      " << stats.numIterations << "\n"
+        << "  integrator realizations:    " << stats.numRealizations << "\n"
+        << "  projections:                " << stats.numProjections << "\n"
+        << "  realizations of each stage:\n";
+    for (int level = 0; level < (int)stats.numRealizationsOfStage.size();
+            ++level) {
+        if (stats.numRealizationsOfStage[level] == 0) continue;
+        out << "    " << std::left << std::setw(24)
+            << SimTK::Stage(level).getName() << std::right
+            << stats.numRealizationsOfStage[level] << "\n";
+    }
+    bool first = true;
+    for (const auto& count : stats.componentIterations) {
+        if (count.second == 0) continue;
+        if (first) out << "  iterations of the components:\n";
+        first = false;
+        out << "    " << count.first << "  " << count.second << "\n";
+    }
+    out.flush();
+}
+
+void Manager::
+setCheckpointFile(const std::string& fileName, double interval)
+{
+    OPENSIM_THROW_IF(interval < 0, Exception,
+        "Manager::setCheckpointFile(): the interval must not be negative.");
+    OPENSIM_THROW_IF(interval > 0 && fileName.empty(), Exception,
+        "Manager::setCheckpointFile(): the file name is empty.");
+    _checkpointFile = fileName;
+    _checkpointInterval = interval;
+}
+
 //-----------------------------------------------------------------------------
 // INITIAL AND FINAL TIME
 //-----------------------------------------------------------------------------
@@ -638,12 +1223,59 @@ integrate(SimTK::State& s)
 
     s.setTime( _ti );
 
+    // After a reset(), start from the given state rather than from where
+    // the TimeStepper stopped.
+    if(_timeStepper && _reinitializeTimeStepper) _timeStepper->initialize(s);
+    _reinitializeTimeStepper = false;
+
     // INTEGRATE
     return doIntegration(s, step);
 
 }
 
+//_____________________________________________________________________________
+/**
+ * Prepare to integrate again from the state given to the next integrate(),
+ * reusing the integrator, the TimeStepper and the storages.
+ */
+void Manager::
+reset()
+{
+    if(hasStateStorage()) getStateStorage().purge();
+    if(_controllerSet) _controllerSet->clearControlStorage();
+    _reinitializeTimeStepper = true;
+    clearHalt();
+}
+
+bool Manager::
+integrateFromCheckpoint(SimTK::State& s, const std::string& fileName)
+{
+    const Checkpoint checkpoint = readCheckpoint(fileName, s);
+    OPENSIM_THROW_IF(checkpoint.time < _ti || checkpoint.time > _tf,
+        Exception, "Manager::integrateFromCheckpoint(): the checkpoint in '" +
+        fileName + "' is at time " + std::to_string(checkpoint.time) +
+        ", outside of the integration interval.");
+
+    // The integrator restarts from the state of the checkpoint.
+    if(!_integ) {
+        throw Exception("Manager::integrateFromCheckpoint(): "
+                "Integrator has not been set. Construct the Manager "
+                "with an integrator, or call Manager::setIntegrator().");
+    }
+    if(SimTK::isFinite(checkpoint.stepSize) && checkpoint.stepSize > 0)
+        _integ->setInitialStepSize(checkpoint.stepSize);
+    if(_timeStepper) _timeStepper->initialize(s);
+
+    return integrateFrom(s, checkpoint.time, checkpoint.step,
+                         checkpoint.outputCount);
+}
+
 bool Manager::doIntegration(SimTK::State& s, int step) {
+    return integrateFrom(s, _ti, step, 1);
+}
+
+bool Manager::integrateFrom(SimTK::State& s, double time, int step,
+                            int outputCount) {
 
     if(!_integ) {
         throw Exception("Manager::doIntegration(): "
@@ -655,9 +1287,6 @@ bool Manager::doIntegration(SimTK::State& s, int step) {
     // Halts must arrive during an integration.
     clearHalt();
 
-    double tReal;
-    double time =_ti;
-
     // CHECK SPECIFIED DT STEPPING
     
     if(_specifiedDT) {
@@ -686,45 +1315,89 @@ bool Manager::doIntegration(SimTK::State& s, int step) {
     bool fixedStep = false;
     double fixedStepSize;
     if( _constantDT || _specifiedDT) fixedStep = true;
+    const bool realTime = _realTimeStepSize > 0 && !_specifiedDT;
+    if( realTime ) fixedStep = true;
 
     // Only initialize a TimeStepper if it hasn't been done yet
     if (_timeStepper == NULL) initializeTimeStepper(s);
 
     SimTK::Integrator::SuccessfulStepStatus status;
 
+    // With an output interval, the integrator returns only at the output
+    // times (and at events), interpolating the states at those times.
+    const bool interpolateOutput = !fixedStep && _outputInterval > 0;
     if( !fixedStep ) {
-        _integ->setReturnEveryInternalStep(true); 
+        _integ->setReturnEveryInternalStep(!interpolateOutput);
     }
 
     _model->realizeVelocity(s);
+    resolveRecordedStates(s);
     initializeStorageAndAnalyses(s);
 
+    if(_outputQueueSize > 0)
+        _outputQueue.reset(new OutputQueue(*this, _outputQueueSize));
+
     if( fixedStep){
         s.updTime() = time;
         _model->realizeAcceleration(s);
 
-        if(_performAnalyses)_model->updAnalysisSet().step(s, step);
-        tReal = s.getTime();
-        if( _writeToStorage ) {
-            SimTK::Vector stateValues = _model->getStateVariableValues(s);
-            StateVector vec;
-            vec.setStates(tReal, stateValues);
-            getStateStorage().append(vec);
-            if(_model->isControlled())
-                _controllerSet->storeControls(s,step);
-        }
+        output(s, step);
     }
 
     double stepToTime = _tf;
 
+    // Checkpoints are written at the first step at or after each multiple of
+    // the interval, so they do not limit the steps of the integrator.
+    const bool checkpoint = _checkpointInterval > 0;
+    double checkpointTime = SimTK::Infinity;
+    if( checkpoint ) checkpointTime = _ti +
+        (std::floor((time - _ti)/_checkpointInterval) + 1)*_checkpointInterval;
+
+    // Real-time steps are due when the wall clock has advanced as far from
+    // wallStart as the simulation has from wallStartTime.
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point wallStart = Clock::now();
+    const double wallStartTime = time;
+    if( realTime ) {
+        _realTimeStepDurations.clear();
+        _numRealTimeOverruns = 0;
+    }
+
+    // Counters of the system and the components are totals, so the
+    // statistics of this integration are their increase from here.
+    const SimTK::System& system = _model->getSystem();
+    std::vector<int> realizationsBefore(SimTK::Stage::NValid);
+    for (int level = 0; level < SimTK::Stage::NValid; ++level)
+        realizationsBefore[level] = system.getNumRealizationsOfThisStage(
+                SimTK::Stage(level));
+    const std::map<std::string, double> iterationsBefore =
+            getIterationCounts(*_model, s);
+    const int stepsTakenBefore = _integ->getNumStepsTaken();
+    const int stepsAttemptedBefore = _integ->getNumStepsAttempted();
+    const int errorTestFailuresBefore = _integ->getNumErrorTestFailures();
+    const int convergenceTestFailuresBefore =
+            _integ->getNumConvergenceTestFailures();
+    const int iterationsOfIntegratorBefore = _integ->getNumIterations();
+    const int integratorRealizationsBefore = _integ->getNumRealizations();
+    const int projectionsBefore = _integ->getNumProjections();
+
     // LOOP
     while( time  < _tf ) {
-        if( fixedStep ){
+        const Clock::time_point stepStart = Clock::now();
+        if( realTime ) {
+            fixedStepSize = std::min(_realTimeStepSize, _tf - time);
+            _integ->setFixedStepSize( fixedStepSize );
+            stepToTime = time + fixedStepSize;
+        }
+        else if( fixedStep ){
               fixedStepSize = getNextTimeArrayTime( time ) - time;
              if( fixedStepSize + time  >= _tf )  fixedStepSize = _tf - time;
              _integ->setFixedStepSize( fixedStepSize );
              stepToTime = time + fixedStepSize; 
         }
+        else if( interpolateOutput ) {
+            stepToTime = std::min(_ti + outputCount*_outputInterval, _tf);
+        }
 
         // stepTo() does not return if it fails. However, the final step
         // is returned once as an ordinary return; by the time we get
@@ -733,23 +1406,34 @@ bool Manager::doIntegration(SimTK::State& s, int step) {
         status = _timeStepper->stepTo(stepToTime);
 
         if( status != SimTK::Integrator::EndOfSimulation ) {
-            const SimTK::State& s =  _integ->getState();
-            if(_performAnalyses)_model->updAnalysisSet().step(s,step);
-            tReal = s.getTime();
-            if( _writeToStorage) {
-                SimTK::Vector stateValues = _model->getStateVariableValues(s);
-                StateVector vec;
-                vec.setStates(tReal, stateValues);
-                getStateStorage().append(vec);
-                if(_model->isControlled())
-                    _controllerSet->storeControls(s, step);
-            }
+            output(_integ->getState(), step);
             step++;
         }
         else
             halt();
         
         time = _integ->getState().getTime();
+        if( realTime && status != SimTK::Integrator::EndOfSimulation ) {
+            _model->getStateVariableValues(_integ->getState(), _stateValues);
+            _liveOutputs->write(time, _stateValues);
+            const Clock::time_point stepEnd = Clock::now();
+            _realTimeStepDurations.push_back(
+                std::chrono::duration<double>(stepEnd - stepStart).count());
+            const Clock::time_point deadline = wallStart +
+                std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(time - wallStartTime));
+            if( stepEnd > deadline ) {
+                ++_numRealTimeOverruns;
+                wallStart += stepEnd - deadline;
+            }
+            else std::this_thread::sleep_until(deadline);
+        }
+        if( interpolateOutput && time >= stepToTime ) ++outputCount;
+        if( time >= checkpointTime && time < _tf ) {
+            writeCheckpoint(_integ->getState(), step, outputCount);
+            checkpointTime = _ti + (std::floor((time - _ti)/_checkpointInterval)
+                                    + 1)*_checkpointInterval;
+        }
         // CHECK FOR INTERRUPT
         if(checkHalt()) break;
     }
@@ -759,9 +1443,142 @@ bool Manager::doIntegration(SimTK::State& s, int step) {
     // CLEAR ANY INTERRUPT
     clearHalt();
 
+    IntegrationStatistics& stats = _integrationStatistics;
+    stats.numStepsTaken = _integ->getNumStepsTaken() - stepsTakenBefore;
+    stats.numStepsAttempted =
+            _integ->getNumStepsAttempted() - stepsAttemptedBefore;
+    stats.numErrorTestFailures =
+            _integ->getNumErrorTestFailures() - errorTestFailuresBefore;
+    stats.numConvergenceTestFailures =
+            _integ->getNumConvergenceTestFailures() -
+            convergenceTestFailuresBefore;
+    stats.numIterations =
+            _integ->getNumIterations() - iterationsOfIntegratorBefore;
+    stats.numRealizations =
+            _integ->getNumRealizations() - integratorRealizationsBefore;
+    stats.numProjections = _integ->getNumProjections() - projectionsBefore;
+    stats.numRealizationsOfStage.resize(SimTK::Stage::NValid);
+    for (int level = 0; level < SimTK::Stage::NValid; ++level)
+        stats.numRealizationsOfStage[level] =
+            system.getNumRealizationsOfThisStage(
+                SimTK::Stage(level)) - realizationsBefore[level];
+    stats.componentIterations = getIterationCounts(*_model, s);
+    for (auto& count : stats.componentIterations) {
+        const auto before = iterationsBefore.find(count.first);
+        if (before != iterationsBefore.end()) count.second -= before->second;
+    }
+
+    if(ComponentProfiler::isEnabled()) {
+        cout << "\nComponent profile of " << getSessionName() << ":\n";
+        ComponentProfiler::printReport(cout);
+        ComponentProfiler::reset();
+    }
+
     return true;
 }
 //_____________________________________________________________________________
+/**
+ * Output the results at a step of the integration: queue the state if there
+ * is an output queue, or record the step now otherwise.
+ */
+void Manager::output(const SimTK::State& s, int step)
+{
+    if(_outputQueue) _outputQueue->push(s, step);
+    else recordStep(s, step);
+}
+//_____________________________________________________________________________
+/**
+ * Step the analyses and store the states and controls at a step of the
+ * integration.
+ */
+void Manager::recordStep(const SimTK::State& s, int step)
+{
+    if(_performAnalyses)_model->updAnalysisSet().step(s, step);
+    if( _writeToStorage) {
+        if(isStateRecordingDue(s)) recordStates(s);
+        if(_model->isControlled())
+            _controllerSet->storeControls(s, step);
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Find the index in Y of each stored state variable, once per integration,
+ * and restart the decimation of the stored states.
+ */
+void Manager::resolveRecordedStates(const SimTK::State& s)
+{
+    _recordedStateYIndices.clear();
+    _recordedStatesNeedAllValues = false;
+    if(!_recordedStateIndices.empty()) {
+        const SimTK::Array_<int> yIndices = _model->getStateVariableYIndices(s);
+        OPENSIM_THROW_IF(_recordedStateIndices.back() >= (int)yIndices.size(),
+            Exception, "Manager::resolveRecordedStates(): the model has "
+            "fewer state variables than when the recorded state variables "
+            "were set; call setRecordedStateVariables() again.");
+        for(int i : _recordedStateIndices) {
+            _recordedStateYIndices.push_back(yIndices[i]);
+            if(yIndices[i] < 0) _recordedStatesNeedAllValues = true;
+        }
+        _recordedStateValues.resize((int)_recordedStateIndices.size());
+    }
+
+    _numStepsSinceRecordedStates = 0;
+    _lastRecordedStatesTime = s.getTime();
+    _nextRecordedStatesTime = nextRecordingTime(s.getTime(), _ti,
+                                                _stateRecordingInterval);
+}
+//_____________________________________________________________________________
+/**
+ * Count an output step, and return whether its states are due to be stored
+ * by the decimation and the recording interval.
+ */
+bool Manager::isStateRecordingDue(const SimTK::State& s)
+{
+    ++_numStepsSinceRecordedStates;
+    if(_numStepsSinceRecordedStates < _stateRecordingDecimation) return false;
+    return _stateRecordingInterval <= 0 || s.getTime() >=
+        _nextRecordedStatesTime - SimTK::SqrtEps*_stateRecordingInterval;
+}
+//_____________________________________________________________________________
+/**
+ * Gather the values of the stored state variables into a Vector that is
+ * reused at every step: all of them, or those selected, read straight from Y
+ * where possible.
+ */
+const SimTK::Vector& Manager::gatherRecordedStates(const SimTK::State& s)
+{
+    if(_recordedStateIndices.empty()) {
+        _model->getStateVariableValues(s, _stateValues);
+        return _stateValues;
+    }
+
+    if(_recordedStatesNeedAllValues)
+        _model->getStateVariableValues(s, _stateValues);
+    const SimTK::Vector& y = s.getY();
+    const int n = (int)_recordedStateIndices.size();
+    for(int i=0;i<n;i++) {
+        const int yIndex = _recordedStateYIndices[i];
+        _recordedStateValues[i] = yIndex >= 0 ? y[yIndex]
+                                  : _stateValues[_recordedStateIndices[i]];
+    }
+    return _recordedStateValues;
+}
+//_____________________________________________________________________________
+/**
+ * Append the stored state variables of a step to the state storage.
+ */
+void Manager::recordStates(const SimTK::State& s)
+{
+    StateVector vec;
+    vec.setStates(s.getTime(), gatherRecordedStates(s));
+    getStateStorage().append(vec);
+
+    _numStepsSinceRecordedStates = 0;
+    _lastRecordedStatesTime = s.getTime();
+    _nextRecordedStatesTime = nextRecordingTime(s.getTime(), _ti,
+                                                _stateRecordingInterval);
+}
+//_____________________________________________________________________________
 /**
  * return the step size when the integrator is taking fixed
  * step sizes
@@ -788,8 +1605,6 @@ void Manager::initializeStorageAndAnalyses(SimTK::State& s)
 {
     if( _writeToStorage && _performAnalyses ) { 
 
-        double tReal = s.getTime();
-    
         // STORE STARTING CONTROLS
         if (_model->isControlled()){
             _controllerSet->setModel(*_model);
@@ -799,10 +1614,7 @@ void Manager::initializeStorageAndAnalyses(SimTK::State& s)
         // STORE STARTING STATES
         if(hasStateStorage()) {
             // ONLY IF NO STATES WERE PREVIOUSLY STORED
-            if(getStateStorage().getSize()==0) {
-                SimTK::Vector stateValues = _model->getStateVariableValues(s);
-                getStateStorage().store(0,tReal,stateValues.size(), &stateValues[0]);
-            }
+            if(getStateStorage().getSize()==0) recordStates(s);
         }
 
         // ANALYSES 
@@ -832,6 +1644,18 @@ void Manager::initializeTimeStepper(const SimTK::State& s)
  */
 void Manager::finalize(SimTK::State& s )
 {
+    // Wait for the queued steps to be output first.
+    if(_outputQueue) {
+        std::unique_ptr<OutputQueue> queue(std::move(_outputQueue));
+        queue->finish();
+    }
+
+    // STORE THE FINAL STATES if the decimation skipped them.
+    if( _writeToStorage && hasStateStorage() &&
+        (_stateRecordingDecimation > 1 || _stateRecordingInterval > 0) &&
+        s.getTime() > _lastRecordedStatesTime)
+        recordStates(s);
+
         // ANALYSES 
     if(  _performAnalyses ) { 
         AnalysisSet& analysisSet = _model->updAnalysisSet();
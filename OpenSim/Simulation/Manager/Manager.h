@@ -34,6 +34,11 @@
 #include <OpenSim/Simulation/osimSimulationDLL.h>
 #include <SimTKcommon/internal/ReferencePtr.h>
 
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <vector>
+
 namespace SimTK {
 class Integrator;
 class State;
@@ -46,6 +51,7 @@ namespace OpenSim {
 class Model;
 class Storage;
 class ControllerSet;
+class LiveValues;
 
 //=============================================================================
 //=============================================================================
@@ -53,7 +59,10 @@ class ControllerSet;
  * A class that manages the execution of a simulation. This class uses a
  * SimTK::Integrator and SimTK::TimeStepper to perform the simulation. By
  * default, a Runge-Kutta-Merson integrator is used, but can be changed by
- * using setIntegrator().
+ * using setIntegratorMethod() or setIntegrator(). Models that make the
+ * system stiff (e.g., muscles with compliant tendons) often integrate much
+ * faster with the implicit IntegratorMethod::CPodes, which can take large
+ * steps where the explicit methods are limited to tiny ones.
  * 
  * In order to prevent an inconsistency between the Integrator and TimeStepper,
  * we only create a TimeStepper once, specifically at the first call to
@@ -65,10 +74,83 @@ class ControllerSet;
  * up to the caller to ensure that the state is a legal state if the same
  * Manager is used to integrate again. Integrating a different state for some
  * new arbitrary system has undefined behavior.
+ *
+ * By default, the analyses are stepped and the states and controls are
+ * stored after every step, before the integration proceeds. With
+ * setOutputQueueSize(), a copy of the state at each step is instead queued
+ * for another thread that steps the analyses and stores the results, so
+ * that slow analyses overlap with the integration. The integration waits
+ * when the queue is full, and finalize() waits for the queue to be
+ * emptied. Since the analyses then run concurrently with the integration on
+ * the same Model, they must not modify the Model (e.g., its properties or
+ * its default values) while recording.
+ *
+ * To output the results at regular times without limiting the steps of the
+ * integrator, use setOutputInterval(); the states at those times are then
+ * interpolated by the integrator, as are those given to Reporters whose
+ * report_time_interval is set.
+ *
+ * For models with many state variables, the state storage can be limited to
+ * the state variables of interest with setRecordedStateVariables(), and to
+ * fewer steps with setStateRecordingDecimation() or
+ * setStateRecordingInterval(), without changing the steps at which the
+ * analyses and controls are output.
+ *
+ * Long integrations can be resumed after the process is stopped: with
+ * setCheckpointFile(), the Manager periodically writes a checkpoint of the
+ * integration, from which integrateFromCheckpoint() continues it.
+ *
+ * For hardware in the loop, setRealTimeStepSize() integrates in fixed steps
+ * that keep pace with the wall clock, recording the time each step takes;
+ * the states are published after each step to getLiveOutputs(), and
+ * controls may come from other threads through a LiveController.
  */
 class OSIMSIMULATION_API Manager
 {
 
+public:
+    /** The integrators that setIntegratorMethod() can create. */
+    enum class IntegratorMethod {
+        ExplicitEuler,      ///< SimTK::ExplicitEulerIntegrator
+        RungeKutta2,        ///< SimTK::RungeKutta2Integrator
+        RungeKutta3,        ///< SimTK::RungeKutta3Integrator
+        RungeKuttaFeldberg, ///< SimTK::RungeKuttaFeldbergIntegrator
+        RungeKuttaMerson,   ///< SimTK::RungeKuttaMersonIntegrator (default)
+        SemiExplicitEuler2, ///< SimTK::SemiExplicitEuler2Integrator
+        Verlet,             ///< SimTK::VerletIntegrator
+        /** SimTK::CPodesIntegrator using backward differentiation formulas
+        and Newton iterations, an implicit method for stiff systems. */
+        CPodes
+    };
+
+    /** Counters of the work done by an integration, to find why it got
+    slower, e.g., after a change of the model. */
+    struct IntegrationStatistics {
+        /** Steps taken and attempted by the integrator; the difference is
+        the number of steps it rejected. */
+        int numStepsTaken = 0;
+        int numStepsAttempted = 0;
+        /** Steps rejected because their error was too large, or because the
+        iterations of an implicit integrator did not converge. */
+        int numErrorTestFailures = 0;
+        int numConvergenceTestFailures = 0;
+        /** Iterations of an implicit integrator (0 for explicit ones). */
+        int numIterations = 0;
+        /** Realizations of the system by the integrator, and projections of
+        the state onto the constraint manifold. */
+        int numRealizations = 0;
+        int numProjections = 0;
+        /** The number of times each stage of the system was realized, by
+        anyone (e.g., also by the analyses), indexed by the level of the
+        SimTK::Stage. */
+        std::vector<int> numRealizationsOfStage;
+        /** The iterations of the solvers of the components (e.g., muscle
+        equilibrium or wrapping): the increase of each Output of type double
+        whose name ends in "_iterations", by the absolute path of its
+        component followed by "|" and the name of the Output. */
+        std::map<std::string, double> componentIterations;
+    };
+
 //=============================================================================
 // DATA
 //=============================================================================
@@ -117,6 +199,9 @@ private:
     Array<double> _tArray;
     /** Vector of integration time step deltas. */
     Array<double> _dtArray;
+    /** Step of _tArray found by the last search, from which the next search
+    starts, since an integration searches for increasing times. */
+    int _tArrayCursor;
 
     /** Name to be shown by the UI */
     static std::string _displayName;
@@ -130,6 +215,72 @@ private:
     /** controllerSet used for the integration */
     ControllerSet* _controllerSet;
 
+    /** Time interval at which the integrator interpolates the states that
+    are output, or 0 to output the state at every integrator step. */
+    double _outputInterval;
+
+    /** Number of states that may wait to be output by another thread, or 0
+    to output each step before the integration proceeds. */
+    int _outputQueueSize;
+
+    /** Thread that outputs the queued states during an integration. */
+    class OutputQueue;
+    std::unique_ptr<OutputQueue> _outputQueue;
+
+    /** File to which checkpoints of the integration are written. */
+    std::string _checkpointFile;
+    /** Interval of simulated time between checkpoints, or 0 for none. */
+    double _checkpointInterval;
+
+    /** Flag to reinitialize the TimeStepper with the state given to the
+    next integrate(); see reset(). */
+    bool _reinitializeTimeStepper;
+
+    /** Size of the fixed steps taken in real time, or 0 to integrate as
+    fast as possible. */
+    double _realTimeStepSize;
+    /** Wall-clock time taken by each step of the last real-time
+    integration, in seconds. */
+    std::vector<double> _realTimeStepDurations;
+    /** Number of steps of the last real-time integration that ended after
+    their wall-clock deadline. */
+    int _numRealTimeOverruns;
+    /** The state variable values of the latest step of a real-time
+    integration. */
+    std::unique_ptr<LiveValues> _liveOutputs;
+
+    /** Counters of the work done by the last integration. */
+    IntegrationStatistics _integrationStatistics;
+
+    /** The state variable values of the step being stored, kept so that they
+    are not allocated at every step. */
+    SimTK::Vector _stateValues;
+
+    /** Names or patterns of the state variables to store, or empty to store
+    all of them. */
+    std::vector<std::string> _recordedStatePatterns;
+    /** Indices, in the order of Model::getStateVariableNames(), of the
+    state variables to store, resolved from _recordedStatePatterns when the
+    storage is constructed; empty if all are stored. */
+    std::vector<int> _recordedStateIndices;
+    /** Index in Y of each stored state variable, or -1 if its value is not
+    in Y; resolved at the start of each integration. */
+    std::vector<int> _recordedStateYIndices;
+    /** Whether a stored state variable is not in Y. */
+    bool _recordedStatesNeedAllValues;
+    /** The values of the stored state variables at the step being stored. */
+    SimTK::Vector _recordedStateValues;
+    /** Number of output steps per step whose states are stored. */
+    int _stateRecordingDecimation;
+    /** Interval of simulated time between stored states, or 0. */
+    double _stateRecordingInterval;
+    /** Output steps since the states were last stored. */
+    int _numStepsSinceRecordedStates;
+    /** Time of the last stored states. */
+    double _lastRecordedStatesTime;
+    /** Time at or after which the states are next stored. */
+    double _nextRecordedStatesTime;
+
 
 //=============================================================================
 // METHODS
@@ -155,6 +306,8 @@ public:
     Manager(const Manager&) = delete;
     void operator=(const Manager&) = delete;
 
+    ~Manager();
+
 private:
     void setNull();
     bool constructStorage();
@@ -171,6 +324,103 @@ public:
     { _performAnalyses =  performAnalyses; }
     void setWriteToStorage(bool writeToStorage)
     { _writeToStorage =  writeToStorage; }
+    /** %Set the number of steps whose states may wait in a queue for another
+    thread to step the analyses and store the states and controls, while
+    the integration proceeds. The default, 0, outputs each step before the
+    integration proceeds. */
+    void setOutputQueueSize(int size);
+    int getOutputQueueSize() const { return _outputQueueSize; }
+    /** %Set the time interval at which the analyses are stepped and the
+    states and controls are stored during an integration with variable steps.
+    The integrator still takes the largest steps its accuracy allows, and
+    interpolates the states at the multiples of the interval after the
+    initial time; the states at events are output as well. The default, 0,
+    outputs the state at every step of the integrator. This does not apply
+    to integrations with constant or specified time steps. */
+    void setOutputInterval(double interval);
+    double getOutputInterval() const { return _outputInterval; }
+    /** %Set the state variables whose values are stored during an
+    integration, as names (as returned by Model::getStateVariableNames()) or
+    regular expressions (ECMAScript) that match whole names, e.g.,
+    `".*/value"` for the values of all coordinates. Each must match at least
+    one state variable. The names are resolved to indices here, and again
+    if the model is set, rather than at each step; the state storage is
+    replaced by an empty one with a column for each selected state variable,
+    in the order of getStateVariableNames(). An empty list (the default)
+    stores all state variables. The model's system must have been
+    created (e.g., by Model::initSystem()). */
+    void setRecordedStateVariables(const std::vector<std::string>& names);
+    const std::vector<std::string>& getRecordedStateVariables() const
+    {   return _recordedStatePatterns; }
+    /** %Set the number of output steps (see setOutputInterval()) per step
+    whose states are stored: the states are stored at every
+    `decimation`-th step after the initial state. The default, 1, stores the
+    states at every output step. The analyses and controls are still output
+    at every step. */
+    void setStateRecordingDecimation(int decimation);
+    int getStateRecordingDecimation() const
+    {   return _stateRecordingDecimation; }
+    /** %Set the interval of simulated time at which the states are stored:
+    at the first output step at or after each multiple of the interval after
+    the initial time (and that is also due by the decimation). Unlike
+    setOutputInterval(), this limits only the stored states, which are not
+    interpolated. The default, 0, stores the states at every output step.
+    When the decimation or the interval skips the last step, its states
+    are stored anyway. */
+    void setStateRecordingInterval(double interval);
+    double getStateRecordingInterval() const
+    {   return _stateRecordingInterval; }
+    /** %Set the file to which a checkpoint of the integration is written
+    about every `interval` of simulated time, at the first step at or after
+    each multiple of the interval after the initial time. Each checkpoint
+    replaces the previous one. A checkpoint holds the state (the continuous
+    and discrete state variables of double, int, bool and Vector type), the
+    step size predicted by the integrator and the progress of the output,
+    in a binary file for the machine that wrote it. Use
+    integrateFromCheckpoint() to resume the integration from it, e.g., after
+    the process was stopped. An interval of 0 (the default) writes no
+    checkpoints. */
+    void setCheckpointFile(const std::string& fileName, double interval);
+    const std::string& getCheckpointFile() const { return _checkpointFile; }
+    double getCheckpointInterval() const { return _checkpointInterval; }
+    /** %Set the size of fixed steps that the integration takes in real time
+    (e.g., with hardware in the loop), or 0 (the default) to integrate as
+    fast as possible. Each step is due at the wall-clock time that is as far
+    from the start of the integration as its end is from the initial time:
+    after computing a step and outputting it, the Manager waits until then.
+    A step that is not done by then is an overrun; the deadlines of the
+    later steps then start from the end of that step, so that the
+    integration does not run faster to catch up. Use an integrator with a
+    bounded cost per step, e.g., IntegratorMethod::ExplicitEuler or
+    IntegratorMethod::SemiExplicitEuler2, and an output queue (see
+    setOutputQueueSize()) for slow analyses.
+
+    The state variable values (see Model::getStateVariableValues()) of each
+    step are written to getLiveOutputs(), which other threads read without
+    blocking the integration. This requires the System of the Model, so call
+    this after Model::initSystem(). This does not apply to integrations
+    with specified time steps. */
+    void setRealTimeStepSize(double stepSize);
+    double getRealTimeStepSize() const { return _realTimeStepSize; }
+    /** The wall-clock time, in seconds, that each step of the last
+    real-time integration took to compute and output, not counting the
+    wait for its deadline. */
+    const std::vector<double>& getRealTimeStepDurations() const
+    {   return _realTimeStepDurations; }
+    /** The number of steps of the last real-time integration that were not
+    done by their deadline. */
+    int getNumRealTimeOverruns() const { return _numRealTimeOverruns; }
+    /** The time and state variable values of the latest step of a real-time
+    integration, for other threads to read. */
+    const LiveValues& getLiveOutputs() const;
+
+    /** Counters of the work done by the last integration that returned
+    (including one that was halted). */
+    const IntegrationStatistics& getIntegrationStatistics() const
+    {   return _integrationStatistics; }
+    /** Print getIntegrationStatistics(), for the components only those whose
+    solvers iterated. */
+    void printIntegrationStatistics(std::ostream& out) const;
 
     // Integrator
     SimTK::Integrator& getIntegrator() const;
@@ -178,6 +428,14 @@ public:
      * passed-in integrator.
      */
     void setIntegrator(SimTK::Integrator&);
+    /** %Set the integrator to a new one, owned by this Manager, that uses the
+    given method and default settings, which setIntegratorAccuracy() can
+    then change. Unlike setIntegrator(), this is available from
+    MATLAB/Python. */
+    void setIntegratorMethod(IntegratorMethod method);
+    /** %Set the accuracy of the integrator (see
+    SimTK::Integrator::setAccuracy()). */
+    void setIntegratorAccuracy(double accuracy);
 
     // Initial and final times
     void setInitialTime(double aTI);
@@ -209,6 +467,33 @@ public:
     // EXECUTION
     //--------------------------------------------------------------------------
     bool integrate(SimTK::State& s);
+    /** Prepare this Manager for another integration of the same model, from
+    the state given to the next call to integrate(), instead of constructing
+    a new Manager (e.g., for each run of an ensemble or each iteration of an
+    optimization). The integrator and TimeStepper are kept and reinitialized
+    with that state, and the storages of the states and controls are emptied
+    but keep the memory they had allocated; the analyses restart with the
+    next integration as they do for every integration. The settings of this
+    Manager (e.g., the initial and final times and the output interval) are
+    kept, and may be changed before integrating again. */
+    void reset();
+    /** Resume an integration from the checkpoint in the given file, written
+    by an integration of the same model with the same settings (see
+    setCheckpointFile()). The state must belong to the model (e.g., the
+    state returned by Model::initSystem()); it is set to the state in the
+    checkpoint, and the integration proceeds from there until the final time
+    as if it had not been interrupted, up to the accuracy of the integrator.
+    The integrator's initial step size is set to the step size it predicted
+    when the checkpoint was written. Checkpoints are written again if a
+    checkpoint file is set.
+
+    The results of the analyses, the state storage and the reporters from
+    before the checkpoint are not part of the checkpoint: they restart at the
+    time of the checkpoint. Give file reporters (e.g., TableFileReporter) a
+    different file name for each part of the integration to keep them all.
+    @throws Exception if the file is not a checkpoint or if the checkpoint
+    does not match the state. */
+    bool integrateFromCheckpoint(SimTK::State& s, const std::string& fileName);
     bool doIntegration(SimTK::State& s, int step);
     void finalize(SimTK::State& s);
     double getFixedStepSize(int tArrayStep) const;
@@ -233,10 +518,34 @@ private:
     // Handles common tasks of some of the other constructors.
     Manager(Model& aModel, bool dummyVar);
 
+    // Find the step of _tArray at or before the given time, starting at
+    // _tArrayCursor.
+    int findTimeArrayStep(double time);
+
     // Helper functions during initialization of integration
     void initializeStorageAndAnalyses(SimTK::State& s);
     void initializeTimeStepper(const SimTK::State& s);
 
+    // Step the analyses and store the states and controls at a step,
+    // through the output queue if there is one.
+    void output(const SimTK::State& s, int step);
+    void recordStep(const SimTK::State& s, int step);
+    // Find the index in Y of each stored state variable.
+    void resolveRecordedStates(const SimTK::State& s);
+    // Whether the states are stored at the given output step.
+    bool isStateRecordingDue(const SimTK::State& s);
+    // Gather the values of the stored state variables.
+    const SimTK::Vector& gatherRecordedStates(const SimTK::State& s);
+    // Store the states in the state storage.
+    void recordStates(const SimTK::State& s);
+    // Integrate from the given time, step and number of the next output
+    // time (see setOutputInterval()).
+    bool integrateFrom(SimTK::State& s, double time, int step,
+                       int outputCount);
+    // Write a checkpoint of the given state of the integration.
+    void writeCheckpoint(const SimTK::State& s, int step,
+                         int outputCount) const;
+
 //=============================================================================
 };  // END of class Manager
 
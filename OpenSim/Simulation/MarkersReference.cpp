@@ -101,14 +101,15 @@ populateFromMarkerData(const TimeSeriesTable_<SimTK::Vec3>& markerTable,
     }
     
     const auto& markerNames = markerTable.getColumnLabels();
-    _markerNames.clear();
-    _weights.clear();
-    _markerNames.assign(markerNames.size(), "");
-    _weights.assign(markerNames.size(), get_default_weight());
+    setMarkerNames(SimTK::Array_<std::string>(markerNames.begin(),
+                                              markerNames.end()));
+}
 
-    for(unsigned i = 0; i < markerNames.size(); ++i) {
-        _markerNames[i] = markerNames[i];
-    }
+void
+MarkersReference::setMarkerNames(const SimTK::Array_<std::string>& names) {
+    _markerNames = names;
+    _weights.clear();
+    _weights.assign(names.size(), get_default_weight());
 
     // Names must be assigned before weights can be updated
     updateInternalWeights();
@@ -136,11 +137,15 @@ const SimTK::Array_<std::string>& MarkersReference::getNames() const {
 
 void  MarkersReference::getValues(const SimTK::State& s,
                                   SimTK::Array_<Vec3>& values) const {
-    double time = s.getTime();
-    const auto rowView = _markerTable.getNearestRow(time);
-    values.clear();
+    const auto rowView = getValuesView(s);
+    values.resize(rowView.ncol());
     for(int i = 0; i < rowView.ncol(); ++i)
-        values.push_back(rowView[i]);
+        values[i] = rowView[i];
+}
+
+SimTK::RowVectorView_<Vec3>
+MarkersReference::getValuesView(const SimTK::State& s) const {
+    return _markerTable.getNearestRow(s.getTime());
 }
 
 // void
@@ -198,7 +203,7 @@ MarkersReference::updateInternalWeights() const {
 
 int
 MarkersReference::getNumRefs() const {
-    return static_cast<int>(_markerTable.getNumColumns());
+    return static_cast<int>(_markerNames.size());
 }
 
 double
@@ -136,6 +136,11 @@ public:
     /** get the value of the MarkersReference */
     void getValues(const SimTK::State &s,
         SimTK::Array_<SimTK::Vec3> &values) const override;
+    /** get a view of the values of the MarkersReference, in the same order as
+        names, directly into the marker data rather than a copy of them. The
+        view is valid as long as this MarkersReference is. */
+    virtual SimTK::RowVectorView_<SimTK::Vec3>
+        getValuesView(const SimTK::State &s) const;
     // The following two methods are commented out as they are not implemented
     // and we don't want users to think it *is* implemented when viewing
     // doxygen.
@@ -163,6 +168,11 @@ public:
     void setDefaultWeight(double weight);
     size_t getNumFrames() const;
 
+protected:
+    /** %Set the names of the markers, for References that do not get them
+        from marker data, and reset their weights accordingly. */
+    void setMarkerNames(const SimTK::Array_<std::string>& markerNames);
+
 private:
     void constructProperties();
     void
@@ -30,6 +30,7 @@
 
 #include "ForceSet.h"
 #include "Model.h"
+#include "ModelCache.h"
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include <OpenSim/Simulation/Control/ControlSetController.h>
 using namespace OpenSim;
@@ -392,7 +393,7 @@ loadModel(const string &aToolSetupFileName, ForceSet *rOriginalForceSet )
         Model *model = 0;
 
         try {
-            model = new Model(_modelFile);
+            model = ModelCache::loadToolModel(_modelFile);
             if (rOriginalForceSet!=NULL)
                 *rOriginalForceSet = model->getForceSet();
         } catch(...) { // Properly restore current directory if an exception is thrown
@@ -134,6 +134,30 @@ void Actuator::addInControls(const Vector& actuatorControls, Vector& modelContro
     modelControls(_controlIndex, numControls()) += actuatorControls;
 }
 
+void Actuator::addInControl(double actuatorControl, Vector& modelControls) const
+{
+    SimTK_ASSERT(numControls() > 0, 
+        "Actuator::addInControl, actuator has no controls.\n");
+
+    SimTK_ASSERT(modelControls.size() == _model->getNumControls(), 
+    "Actuator::addInControl, output modelControls size does not match model.getNumControls().\n");
+
+    modelControls[_controlIndex] += actuatorControl;
+}
+
+bool Actuator::findDynamicsDependencies(const SimTK::State& s,
+        std::vector<int>& yIndices, std::vector<int>& controlIndices,
+        std::vector<int>& uIndices) const
+{
+    if (getNumStateVariables() > 0) return false;
+
+    for (int j = 0; j < s.getNQ() + s.getNU(); ++j) yIndices.push_back(j);
+    for (int i = 0; i < numControls(); ++i)
+        controlIndices.push_back(_controlIndex + i);
+    for (int i = 0; i < s.getNU(); ++i) uIndices.push_back(i);
+    return true;
+}
+
 
 
 
@@ -168,8 +192,8 @@ void ScalarActuator::extendAddToSystem(SimTK::MultibodySystem& system) const
     addModelingOption("override_actuation", 1);
 
     // Cache the computed actuation and speed of the scalar valued actuator
-    addCacheVariable<double>("actuation", 0.0, Stage::Velocity);
-    addCacheVariable<double>("speed", 0.0, Stage::Velocity);
+    _actuationCV = addCacheVariable<double>("actuation", 0.0, Stage::Velocity);
+    _speedCV = addCacheVariable<double>("speed", 0.0, Stage::Velocity);
 
     // Discrete state variable is the override actuation value if in override mode
     addDiscreteVariable("override_actuation", Stage::Time);
@@ -193,24 +217,24 @@ double ScalarActuator::getOptimalForce() const
 double ScalarActuator::getActuation(const State &s) const
 {
     if (appliesForce(s))
-        return getCacheVariableValue<double>(s, "actuation");
+        return _actuationCV.getValue(s);
     else
         return 0.0;
 }
 
 void ScalarActuator::setActuation(const State& s, double aActuation) const
 {
-    setCacheVariableValue<double>(s, "actuation", aActuation);
+    _actuationCV.setValue(s, aActuation);
 }
 
 double ScalarActuator::getSpeed(const State& s) const
 {
-    return getCacheVariableValue<double>(s, "speed");
+    return _speedCV.getValue(s);
 }
 
 void ScalarActuator::setSpeed(const State &s, double speed) const
 {
-    setCacheVariableValue<double>(s, "speed", speed);
+    _speedCV.setValue(s, speed);
 }
 
 void ScalarActuator::overrideActuation(SimTK::State& s, bool flag) const
@@ -106,6 +106,11 @@ public:
     virtual void setControls(const SimTK::Vector& actuatorControls, SimTK::Vector& modelControls) const;
     /** add actuator controls to the values already occupying the slot in the system-wide model controls */
     virtual void addInControls(const SimTK::Vector& actuatorControls, SimTK::Vector& modelControls) const;
+    /** add a value to the (first) control of the actuator in the system-wide
+        model controls. Unlike addInControls(), this creates no temporary
+        vectors, so controllers can call it for each actuator at each
+        realization. */
+    void addInControl(double actuatorControl, SimTK::Vector& modelControls) const;
 
     //--------------------------------------------------------------------------
     // COMPUTATIONS
@@ -113,6 +118,14 @@ public:
     virtual double getPower(const SimTK::State& s) const = 0;
     virtual void computeEquilibrium(SimTK::State& s) const { }
 
+    /** An actuator without state variables applies a force that depends on
+    its own controls and on the generalized coordinates and speeds, and that
+    may act on any mobility. Actuators with state variables must declare
+    their own dependencies, or they are taken to depend on all variables. */
+    bool findDynamicsDependencies(const SimTK::State& s,
+            std::vector<int>& yIndices, std::vector<int>& controlIndices,
+            std::vector<int>& uIndices) const override;
+
 //=============================================================================
 };  // END of class Actuator
 //=============================================================================
@@ -250,10 +263,20 @@ protected:
         values.append(getActuation(state));
         return values;
     }
+    int getNumRecordValues() const override { return 1; }
+    void writeRecordValues(const SimTK::State& state,
+                           double* values) const override {
+        values[0] = getActuation(state);
+    }
 
 private:
     void constructProperties();
 
+    // Handles to the cache variables of this actuator, set in
+    // extendAddToSystem().
+    mutable SimTK::ResetOnCopy<CacheVariable<double> > _actuationCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<double> > _speedCV;
+
 //=============================================================================
 };  // END of class ScalarActuator
 //=============================================================================
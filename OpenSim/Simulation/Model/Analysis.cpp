@@ -165,6 +165,7 @@ setNull()
     _inDegrees=true;
     _storageList.setMemoryOwner(false);
     _printResultFiles=true;
+    _scratch = nullptr;
 }
 //_____________________________________________________________________________
 /**
@@ -228,6 +229,21 @@ operator=(const Analysis &aAnalysis)
 
     return(*this);
 }
+
+//=============================================================================
+// SCRATCH
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Scratch arena of the AnalysisSet calling the analysis, or of the analysis.
+ */
+ScratchArena& Analysis::
+updScratch()
+{
+    if (_scratch) return *_scratch;
+    if (!_ownScratch) _ownScratch.reset(new ScratchArena());
+    return *_ownScratch;
+}
 //_____________________________________________________________________________
 /**
  * Return whether or not to proceed with this callback.
@@ -352,6 +368,31 @@ ArrayPtrs<Storage>& Analysis::getStorageList()
     return _storageList;
 }
 
+//_____________________________________________________________________________
+/**
+ * Append the rows of the storages of a copy of this analysis to the storages
+ * of this analysis.
+ */
+void Analysis::merge(Analysis& aAnalysis)
+{
+    ArrayPtrs<Storage>& storages = getStorageList();
+    ArrayPtrs<Storage>& others = aAnalysis.getStorageList();
+    OPENSIM_THROW_IF_FRMOBJ(storages.getSize() != others.getSize(), Exception,
+        "Cannot merge analysis '" + aAnalysis.getName() + "', which has " +
+        std::to_string(others.getSize()) + " storages instead of " +
+        std::to_string(storages.getSize()) + ".");
+    for (int i = 0; i < storages.getSize(); ++i) {
+        if (storages[i] == nullptr || others[i] == nullptr) continue;
+        appendRows(*storages[i], *others[i]);
+    }
+}
+
+void Analysis::appendRows(Storage& aStorage, const Storage& aRows)
+{
+    for (int i = 0; i < aRows.getSize(); ++i)
+        aStorage.append(*aRows.getStateVector(i));
+}
+
 // GET AND SET
 //=============================================================================
 //_____________________________________________________________________________
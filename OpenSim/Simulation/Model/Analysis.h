@@ -36,6 +36,8 @@
 #include <OpenSim/Common/ArrayPtrs.h>
 #include <OpenSim/Common/Array.h>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/ScratchArena.h>
+#include <SimTKcommon/internal/Stage.h>
 
 namespace SimTK {
 class State;
@@ -94,6 +96,12 @@ protected:
     ArrayPtrs<Storage> _storageList;
     bool _printResultFiles;
 
+private:
+    /** Scratch arena of the AnalysisSet during its callbacks, else null. */
+    ScratchArena* _scratch;
+    /** Scratch arena used when the analysis is called on its own. */
+    std::unique_ptr<ScratchArena> _ownScratch;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -191,6 +199,58 @@ public:
 
     virtual bool proceed(int aStep=0);
 
+    // REALIZATION
+    /**
+     * The stage to which the state must be realized to record this analysis.
+     * Callers driving the analyses (e.g., the AnalyzeTool) realize the state
+     * only to the highest stage required by the analyses that are on, so
+     * analyses that do not need forces or accelerations should return a
+     * lower stage. The default is Velocity.
+     */
+    virtual SimTK::Stage getRequiredStage() const
+    {   return SimTK::Stage::Velocity; }
+
+    // MERGING
+    /**
+     * Whether copies of this analysis, each run over a part of the frames
+     * (e.g., by the AnalyzeTool on several threads), can be combined with
+     * merge(). This requires that the results at each frame depend only on
+     * the state at that frame and not on the frames before it (e.g., as an
+     * integral over time would). The default is false.
+     */
+    virtual bool canMerge() const { return false; }
+    /**
+     * Append the results of a copy of this analysis, which was run over the
+     * frames that follow those of this analysis, to the results of this
+     * analysis. The default appends the rows of each Storage in
+     * getStorageList() of the copy to the corresponding Storage of this
+     * analysis.
+     */
+    virtual void merge(Analysis& aAnalysis);
+
+#ifndef SWIG
+    // SCRATCH
+    /**
+     * Memory for the temporaries of record() (e.g., a row of values), which
+     * is released when the AnalysisSet calling the analysis moves on to the
+     * next step, so that recording allocates nothing from the heap once the
+     * arena has grown to the size of a step. Open a ScratchArena::Scope in
+     * record() so that the memory is also released when the analysis is
+     * called on its own.
+     */
+    ScratchArena& updScratch();
+    /**
+     * %Set the scratch arena to be used by updScratch(), or null to use one
+     * of the analysis' own. The AnalysisSet sets its arena for the duration
+     * of each of its callbacks.
+     */
+    void setScratch(ScratchArena* aScratch) { _scratch = aScratch; }
+#endif
+protected:
+    /** Append the rows of a Storage to another, e.g., in merge(). */
+    static void appendRows(Storage& aStorage, const Storage& aRows);
+public:
+
     //--------------------------------------------------------------------------
     // GET AND SET
     //--------------------------------------------------------------------------
@@ -36,6 +36,18 @@ using namespace OpenSim;
 using namespace std;
 
 
+namespace {
+// Lends the scratch arena of the set to an analysis for one callback.
+class ScratchLoan {
+public:
+    ScratchLoan(Analysis& analysis, ScratchArena& scratch) :
+        _analysis(analysis) { _analysis.setScratch(&scratch); }
+    ~ScratchLoan() { _analysis.setScratch(nullptr); }
+private:
+    Analysis& _analysis;
+};
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -184,6 +196,18 @@ getOn() const
     return on;
 }
 
+SimTK::Stage AnalysisSet::
+getRequiredStage() const
+{
+    SimTK::Stage stage = SimTK::Stage::Model;
+    for(int i=0; i<getSize(); i++) {
+        const Analysis& analysis = get(i);
+        if(analysis.getOn() && analysis.getRequiredStage() > stage)
+            stage = analysis.getRequiredStage();
+    }
+    return stage;
+}
+
 
 //=============================================================================
 // CALLBACKS
@@ -202,7 +226,10 @@ begin(SimTK::State& s )
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.begin(s);
+        if (analysis.getOn()) {
+            ScratchLoan loan(analysis, _scratch);
+            analysis.begin(s);
+        }
     }
 }
 //_____________________________________________________________________________
@@ -216,10 +243,15 @@ begin(SimTK::State& s )
 void AnalysisSet::
 step( const SimTK::State& s, int stepNumber )
 {
+    // The temporaries of the previous step are no longer in use.
+    _scratch.reset();
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.step(s, stepNumber);
+        if (analysis.getOn()) {
+            ScratchLoan loan(analysis, _scratch);
+            analysis.step(s, stepNumber);
+        }
     }
 }
 //_____________________________________________________________________________
@@ -236,7 +268,10 @@ end(SimTK::State& s)
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.end(s);
+        if (analysis.getOn()) {
+            ScratchLoan loan(analysis, _scratch);
+            analysis.end(s);
+        }
     }
 }
 
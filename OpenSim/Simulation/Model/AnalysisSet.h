@@ -65,6 +65,10 @@ protected:
     // testing for memory free error
     OpenSim::PropertyBool _enableProp;
     bool &_enable;
+
+private:
+    /** Temporaries of the analyses, released at each step. */
+    ScratchArena _scratch;
 //
 //=============================================================================
 // METHODS
@@ -92,6 +96,9 @@ public:
     void setOn(bool aTrueFalse);
     void setOn(const Array<bool> &aOn);
     Array<bool> getOn() const;
+    /** The highest stage required by the analyses that are on, or Model if
+    none is on. @see Analysis::getRequiredStage() */
+    SimTK::Stage getRequiredStage() const;
 
     //--------------------------------------------------------------------------
     // CALLBACKS
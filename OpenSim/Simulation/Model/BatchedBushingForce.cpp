@@ -0,0 +1,363 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  BatchedBushingForce.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/ThreadPool.h>
+#include "BatchedBushingForce.h"
+#include "PhysicalFrame.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+using namespace SimTK;
+using namespace OpenSim;
+
+namespace {
+// Read the i-th triple of a list property of doubles.
+Vec3 getVec3(const Property<double>& property, int i)
+{
+    return Vec3(property[3*i], property[3*i + 1], property[3*i + 2]);
+}
+
+void appendVec3(Property<double>& property, const Vec3& v)
+{
+    for (int k = 0; k < 3; ++k) property.appendValue(v[k]);
+}
+
+Vec6 makeVec6(const Vec3& rotational, const Vec3& translational)
+{
+    return Vec6(rotational[0], rotational[1], rotational[2],
+                translational[0], translational[1], translational[2]);
+}
+}
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+// Uses default (compiler-generated) destructor, copy constructor, and copy
+// assignment operator.
+
+//_____________________________________________________________________________
+// Default constructor.
+BatchedBushingForce::BatchedBushingForce() : Force()
+{
+    constructProperties();
+}
+
+//_____________________________________________________________________________
+// Allocate and initialize properties.
+void BatchedBushingForce::constructProperties()
+{
+    constructProperty_frame1();
+    constructProperty_frame2();
+    constructProperty_location_in_frame1();
+    constructProperty_orientation_in_frame1();
+    constructProperty_location_in_frame2();
+    constructProperty_orientation_in_frame2();
+    constructProperty_rotational_stiffness();
+    constructProperty_translational_stiffness();
+    constructProperty_rotational_damping();
+    constructProperty_translational_damping();
+}
+
+int BatchedBushingForce::addBushing(
+        const std::string& frame1, const SimTK::Transform& transformInFrame1,
+        const std::string& frame2, const SimTK::Transform& transformInFrame2,
+        const SimTK::Vec3& transStiffness,
+        const SimTK::Vec3& rotStiffness,
+        const SimTK::Vec3& transDamping,
+        const SimTK::Vec3& rotDamping)
+{
+    append_frame1(frame1);
+    append_frame2(frame2);
+    appendVec3(updProperty_location_in_frame1(), transformInFrame1.p());
+    appendVec3(updProperty_orientation_in_frame1(),
+               transformInFrame1.R().convertRotationToBodyFixedXYZ());
+    appendVec3(updProperty_location_in_frame2(), transformInFrame2.p());
+    appendVec3(updProperty_orientation_in_frame2(),
+               transformInFrame2.R().convertRotationToBodyFixedXYZ());
+    appendVec3(updProperty_rotational_stiffness(), rotStiffness);
+    appendVec3(updProperty_translational_stiffness(), transStiffness);
+    appendVec3(updProperty_rotational_damping(), rotDamping);
+    appendVec3(updProperty_translational_damping(), transDamping);
+    return getNumBushings() - 1;
+}
+
+void BatchedBushingForce::setNumThreads(int numThreads)
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(numThreads) + ".");
+    _numThreads = numThreads;
+}
+
+//=============================================================================
+// ModelComponent interface
+//=============================================================================
+void BatchedBushingForce::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+
+    const int n = getNumBushings();
+    OPENSIM_THROW_IF_FRMOBJ(getProperty_frame2().size() != n, Exception,
+        "Expected a second frame for each of the " + std::to_string(n) +
+        " bushings, but got " +
+        std::to_string(getProperty_frame2().size()) + ".");
+    for (const auto* property : {&getProperty_location_in_frame1(),
+                                 &getProperty_orientation_in_frame1(),
+                                 &getProperty_location_in_frame2(),
+                                 &getProperty_orientation_in_frame2(),
+                                 &getProperty_rotational_stiffness(),
+                                 &getProperty_translational_stiffness(),
+                                 &getProperty_rotational_damping(),
+                                 &getProperty_translational_damping()}) {
+        OPENSIM_THROW_IF_FRMOBJ(property->size() != 3*n, Exception,
+            "Expected 3 values of " + property->getName() + " for each of "
+            "the " + std::to_string(n) + " bushings, but got " +
+            std::to_string(property->size()) + ".");
+    }
+
+    _stiffness.resize(n);
+    _damping.resize(n);
+    for (int i = 0; i < n; ++i) {
+        _stiffness[i] = makeVec6(
+                getVec3(getProperty_rotational_stiffness(), i),
+                getVec3(getProperty_translational_stiffness(), i));
+        _damping[i] = makeVec6(
+                getVec3(getProperty_rotational_damping(), i),
+                getVec3(getProperty_translational_damping(), i));
+    }
+}
+
+void BatchedBushingForce::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    // Many bushings share their frames; look each frame up once, by its
+    // absolute path and, if it is unique, by its name.
+    std::unordered_map<std::string, const PhysicalFrame*> byPath, byName;
+    for (const auto& frame : model.getComponentList<PhysicalFrame>()) {
+        byPath[frame.getAbsolutePathName()] = &frame;
+        auto inserted = byName.insert({frame.getName(), &frame});
+        if (!inserted.second) inserted.first->second = nullptr;
+    }
+    const std::string modelPath = model.getAbsolutePathName();
+    auto findFrame = [&](const std::string& name) -> const PhysicalFrame* {
+        auto path = byPath.find(name);
+        if (path != byPath.end()) return path->second;
+        path = byPath.find(modelPath + "/" + name);
+        if (path != byPath.end()) return path->second;
+        auto frame = byName.find(name);
+        OPENSIM_THROW_IF_FRMOBJ(frame == byName.end(), Exception,
+            "No PhysicalFrame '" + name + "' in the model.");
+        OPENSIM_THROW_IF_FRMOBJ(frame->second == nullptr, Exception,
+            "More than one PhysicalFrame is named '" + name + "'; "
+            "give its path instead.");
+        return frame->second;
+    };
+
+    const int n = getNumBushings();
+    _frame1.resize(n);
+    _frame2.resize(n);
+    for (int i = 0; i < n; ++i) {
+        _frame1[i] = findFrame(get_frame1(i));
+        _frame2[i] = findFrame(get_frame2(i));
+    }
+}
+
+void BatchedBushingForce::
+    extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    // The bodies are in the System by now; express each bushing frame in the
+    // mobilized body of its frame.
+    BatchedBushingForce* mutableThis = const_cast<BatchedBushingForce*>(this);
+    const int n = getNumBushings();
+    mutableThis->_body1.resize(n);
+    mutableThis->_body2.resize(n);
+    mutableThis->_X_B1F.resize(n);
+    mutableThis->_X_B2M.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const Transform X_F1F(Rotation(BodyRotationSequence,
+            get_orientation_in_frame1(3*i), XAxis,
+            get_orientation_in_frame1(3*i + 1), YAxis,
+            get_orientation_in_frame1(3*i + 2), ZAxis),
+            getVec3(getProperty_location_in_frame1(), i));
+        const Transform X_F2M(Rotation(BodyRotationSequence,
+            get_orientation_in_frame2(3*i), XAxis,
+            get_orientation_in_frame2(3*i + 1), YAxis,
+            get_orientation_in_frame2(3*i + 2), ZAxis),
+            getVec3(getProperty_location_in_frame2(), i));
+        mutableThis->_body1[i] = _frame1[i]->getMobilizedBodyIndex();
+        mutableThis->_body2[i] = _frame2[i]->getMobilizedBodyIndex();
+        mutableThis->_X_B1F[i] = _frame1[i]->findTransformInBaseFrame()*X_F1F;
+        mutableThis->_X_B2M[i] = _frame2[i]->findTransformInBaseFrame()*X_F2M;
+    }
+}
+
+//=============================================================================
+// COMPUTATION
+//=============================================================================
+// Same as a SimTK::Force::LinearBushing, and as the TwoFrameLinker helpers
+// used by the other bushing forces, for each bushing in turn.
+void BatchedBushingForce::computeBushingForces(int begin, int end,
+        const SimTK::Array_<SimTK::Transform>& X_GB,
+        const SimTK::Array_<SimTK::SpatialVec>& V_GB,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces) const
+{
+    SpatialVec F_B2, F_B1;
+    for (int i = begin; i < end; ++i) {
+        calcBushingForce(i, X_GB, V_GB, F_B2, F_B1);
+        bodyForces[_body2[i]] += F_B2;
+        bodyForces[_body1[i]] -= F_B1;
+    }
+}
+
+void BatchedBushingForce::calcBushingForce(int i,
+        const SimTK::Array_<SimTK::Transform>& X_GB,
+        const SimTK::Array_<SimTK::SpatialVec>& V_GB,
+        SimTK::SpatialVec& F_B2, SimTK::SpatialVec& F_B1) const
+{
+    const MobilizedBodyIndex b1 = _body1[i];
+    const MobilizedBodyIndex b2 = _body2[i];
+    const Transform& X_GB1 = X_GB[b1];
+    const Transform& X_GB2 = X_GB[b2];
+
+    // Deflection of the bushing frame M from F.
+    const Transform X_GF = X_GB1 * _X_B1F[i];
+    const Transform X_GM = X_GB2 * _X_B2M[i];
+    const Transform X_FM = ~X_GF * X_GM;
+    const Vec3 q = X_FM.R().convertRotationToBodyFixedXYZ();
+    const Vec3& p = X_FM.p();
+
+    // Re-express local vectors in the Ground frame.
+    const Vec3 p_B1F_G = X_GB1.R() * _X_B1F[i].p();
+    const Vec3 p_B2M_G = X_GB2.R() * _X_B2M[i].p();
+    const Vec3 p_FM_G = X_GF.R() * p;
+
+    // Rate of deflection, with the derivative taken in F.
+    const SpatialVec& V_GB1 = V_GB[b1];
+    const SpatialVec& V_GB2 = V_GB[b2];
+    const SpatialVec V_GF(V_GB1[0], V_GB1[1] + V_GB1[0] % p_B1F_G);
+    const SpatialVec V_GM(V_GB2[0], V_GB2[1] + V_GB2[0] % p_B2M_G);
+    const SpatialVec V_FM_G = V_GM - V_GF;
+    const Vec3 w_FM = ~X_GF.R() * V_FM_G[0];
+    const Vec3 v_FM = ~X_GF.R() * (V_FM_G[1] - V_GF[0] % p_FM_G);
+    const Mat33 N_FM = Rotation::calcNForBodyXYZInBodyFrame(q);
+    const Vec3 qdot = N_FM * (~X_FM.R() * w_FM);
+
+    // Forces in the basis of the deflection.
+    const Vec6& k = _stiffness[i];
+    const Vec6& c = _damping[i];
+    Vec3 fq, fM_F;
+    for (int j = 0; j < 3; ++j) {
+        fq[j] = -k[j]*q[j] - c[j]*qdot[j];
+        fM_F[j] = -k[3 + j]*p[j] - c[3 + j]*v_FM[j];
+    }
+
+    // Moment and force on body 2 at M, in ground; the opposite force is
+    // applied to body 1 at the same point.
+    const Vec3 mM_G = X_GM.R() * (~N_FM * fq);
+    const Vec3 fM_G = X_GF.R() * fM_F;
+
+    // Shift forces to body origins.
+    F_B2 = SpatialVec(mM_G + p_B2M_G % fM_G, fM_G);
+    F_B1 = SpatialVec(mM_G + (p_B1F_G + p_FM_G) % fM_G, fM_G);
+}
+
+void BatchedBushingForce::computeForce(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const
+{
+    const int n = getNumBushings();
+    if (n == 0) return;
+
+    // Gather the poses and velocities of the bodies once, rather than once
+    // per bushing.
+    const SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    const int nb = matter.getNumBodies();
+    SimTK::Array_<Transform> X_GB(nb);
+    SimTK::Array_<SpatialVec> V_GB(nb);
+    for (MobilizedBodyIndex b(0); b < nb; ++b) {
+        const MobilizedBody& body = matter.getMobilizedBody(b);
+        X_GB[b] = body.getBodyTransform(s);
+        V_GB[b] = body.getBodyVelocity(s);
+    }
+
+    const int numThreads = std::min(ThreadPool::getNumThreads(_numThreads), n);
+    if (numThreads == 1) {
+        computeBushingForces(0, n, X_GB, V_GB, bodyForces);
+        return;
+    }
+
+    if (ThreadPool::getDeterministic()) {
+        // The forces of the bushings are computed in parallel, and then added
+        // to the bodies in the order of the bushings.
+        SimTK::Array_<SpatialVec> F_B2(n), F_B1(n);
+        ThreadPool::parallelForRanges(n, numThreads,
+            [&](int, int begin, int end) {
+                for (int i = begin; i < end; ++i)
+                    calcBushingForce(i, X_GB, V_GB, F_B2[i], F_B1[i]);
+            });
+        for (int i = 0; i < n; ++i) {
+            bodyForces[_body2[i]] += F_B2[i];
+            bodyForces[_body1[i]] -= F_B1[i];
+        }
+        return;
+    }
+
+    // Bushings share bodies, so each range of bushings adds its forces into
+    // its own body forces, which are summed once all are done. The first
+    // range adds into bodyForces.
+    std::vector<Vector_<SpatialVec>> partForces(numThreads - 1,
+            Vector_<SpatialVec>(nb, SpatialVec(Vec3(0), Vec3(0))));
+    ThreadPool::parallelForRanges(n, numThreads,
+        [&](int range, int begin, int end) {
+            computeBushingForces(begin, end, X_GB, V_GB,
+                range == 0 ? bodyForces : partForces[range - 1]);
+        });
+    for (const auto& forces : partForces) bodyForces += forces;
+}
+
+/* Potential energy is the sum of the elastic energies of the bushings. */
+double BatchedBushingForce::computePotentialEnergy(const SimTK::State& s) const
+{
+    const SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    double energy = 0;
+    const int n = getNumBushings();
+    for (int i = 0; i < n; ++i) {
+        const Transform X_GF =
+            matter.getMobilizedBody(_body1[i]).getBodyTransform(s)*_X_B1F[i];
+        const Transform X_GM =
+            matter.getMobilizedBody(_body2[i]).getBodyTransform(s)*_X_B2M[i];
+        const Transform X_FM = ~X_GF * X_GM;
+        const Vec6 q = makeVec6(X_FM.R().convertRotationToBodyFixedXYZ(),
+                                X_FM.p());
+        for (int j = 0; j < 6; ++j) energy += _stiffness[i][j]*square(q[j]);
+    }
+    return 0.5*energy;
+}
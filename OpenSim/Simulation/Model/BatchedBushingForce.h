@@ -0,0 +1,185 @@
+#ifndef OPENSIM_BATCHED_BUSHING_FORCE_H_
+#define OPENSIM_BATCHED_BUSHING_FORCE_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  BatchedBushingForce.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+// INCLUDE
+#include "Force.h"
+
+namespace OpenSim {
+
+class PhysicalFrame;
+
+//==============================================================================
+//                          BATCHED BUSHING FORCE
+//==============================================================================
+/**
+ * A single Force made of any number of linear bushings, each of which behaves
+ * as a BushingForce: 3 linear and 3 torsional spring-dampers between a frame
+ * fixed on a first PhysicalFrame and one fixed on a second, with orientations
+ * measured as uncoupled x-y-z body-fixed Euler angles.
+ *
+ * Models of soft tissue or cartilage may have tens of thousands of bushings.
+ * As BushingForces, each is a Component with its own offset frames, sockets
+ * and properties, and its own Simbody force; building such a model and
+ * evaluating its forces is dominated by these per-component costs. Here, the
+ * bushings are only entries in the lists of a few properties, one or three
+ * values per bushing, and all their forces are computed in one loop over
+ * contiguous arrays, optionally split across threads (see setNumThreads()).
+ *
+ * The frames of a bushing are given by the path of a PhysicalFrame of the
+ * model (e.g., "bodyset/femur"), or by its name if that is unique, and the
+ * bushing frames are offset from them by a location and XYZ body-fixed Euler
+ * angles. Unlike a BushingForce, this Force reports no record values.
+ *
+ * @code
+ * BatchedBushingForce* bushings = new BatchedBushingForce();
+ * bushings->setName("cartilage");
+ * for (...)
+ *     bushings->addBushing("bodyset/femur", X_FemurF, "bodyset/tibia", X_TibiaM,
+ *                          transStiffness, rotStiffness,
+ *                          transDamping, rotDamping);
+ * model.addForce(bushings);
+ * @endcode
+ */
+class OSIMSIMULATION_API BatchedBushingForce : public Force {
+OpenSim_DECLARE_CONCRETE_OBJECT(BatchedBushingForce, Force);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(frame1, std::string,
+        "Path (or unique name) of the first PhysicalFrame of each bushing.");
+    OpenSim_DECLARE_LIST_PROPERTY(frame2, std::string,
+        "Path (or unique name) of the second PhysicalFrame of each bushing.");
+    OpenSim_DECLARE_LIST_PROPERTY(location_in_frame1, double,
+        "Location (x y z) of each bushing in its first frame.");
+    OpenSim_DECLARE_LIST_PROPERTY(orientation_in_frame1, double,
+        "Orientation (XYZ body-fixed Euler angles, rad) of each bushing in "
+        "its first frame.");
+    OpenSim_DECLARE_LIST_PROPERTY(location_in_frame2, double,
+        "Location (x y z) of each bushing in its second frame.");
+    OpenSim_DECLARE_LIST_PROPERTY(orientation_in_frame2, double,
+        "Orientation (XYZ body-fixed Euler angles, rad) of each bushing in "
+        "its second frame.");
+    OpenSim_DECLARE_LIST_PROPERTY(rotational_stiffness, double,
+        "Stiffness (x y z) of each bushing resisting rotational deviation "
+        "(Nm/rad).");
+    OpenSim_DECLARE_LIST_PROPERTY(translational_stiffness, double,
+        "Stiffness (x y z) of each bushing resisting relative translation "
+        "(N/m).");
+    OpenSim_DECLARE_LIST_PROPERTY(rotational_damping, double,
+        "Damping (x y z) of each bushing resisting angular deviation rate "
+        "(Nm/(rad/s)).");
+    OpenSim_DECLARE_LIST_PROPERTY(translational_damping, double,
+        "Damping (x y z) of each bushing resisting relative translational "
+        "velocity (N/(m/s)).");
+//==============================================================================
+// PUBLIC METHODS
+//==============================================================================
+    /** Default constructor creates a Force with no bushings. */
+    BatchedBushingForce();
+
+    // Uses default (compiler-generated) destructor, copy constructor, and copy
+    // assignment operator.
+
+    /** Add a bushing between a frame offset by transformInFrame1 from the
+    PhysicalFrame frame1, and one offset by transformInFrame2 from frame2.
+    @return the index of the bushing. */
+    int addBushing(const std::string& frame1,
+                   const SimTK::Transform& transformInFrame1,
+                   const std::string& frame2,
+                   const SimTK::Transform& transformInFrame2,
+                   const SimTK::Vec3& transStiffness,
+                   const SimTK::Vec3& rotStiffness,
+                   const SimTK::Vec3& transDamping,
+                   const SimTK::Vec3& rotDamping);
+
+    /** The number of bushings. */
+    int getNumBushings() const { return getProperty_frame1().size(); }
+
+    /** %Set the number of threads across which the bushings are split when
+    computing their forces. The default is 1; a few thousand bushings per
+    thread are needed for the threads to pay off. In deterministic mode (see
+    ThreadPool::setDeterministic()), the forces of the bushings are added to
+    the bodies in the order of the bushings, as by one thread. */
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return _numThreads; }
+
+    /** Potential energy is the elastic energy stored in the bushings. */
+    double computePotentialEnergy(const SimTK::State& s) const override;
+
+protected:
+    //--------------------------------------------------------------------------
+    // Implement Force interface.
+    //--------------------------------------------------------------------------
+    void computeForce(const SimTK::State& s,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& generalizedForces) const override;
+
+    //--------------------------------------------------------------------------
+    // Implement ModelComponent interface.
+    //--------------------------------------------------------------------------
+    void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+private:
+    void constructProperties();
+
+    // Add the forces of bushings [begin, end) into bodyForces, given the
+    // transforms and velocities of all mobilized bodies.
+    void computeBushingForces(int begin, int end,
+            const SimTK::Array_<SimTK::Transform>& X_GB,
+            const SimTK::Array_<SimTK::SpatialVec>& V_GB,
+            SimTK::Vector_<SimTK::SpatialVec>& bodyForces) const;
+    // Compute the force of bushing i as the spatial forces to add to body 2
+    // and to subtract from body 1, at their origins.
+    void calcBushingForce(int i,
+            const SimTK::Array_<SimTK::Transform>& X_GB,
+            const SimTK::Array_<SimTK::SpatialVec>& V_GB,
+            SimTK::SpatialVec& F_B2, SimTK::SpatialVec& F_B1) const;
+
+    int _numThreads{1};
+
+    // The bushings, one entry per bushing in each array. Stiffnesses and
+    // damping are (rotational, translational), as for a
+    // SimTK::Force::LinearBushing.
+    SimTK::Array_<SimTK::Vec6> _stiffness;
+    SimTK::Array_<SimTK::Vec6> _damping;
+    SimTK::ResetOnCopy<SimTK::Array_<const PhysicalFrame*>> _frame1;
+    SimTK::ResetOnCopy<SimTK::Array_<const PhysicalFrame*>> _frame2;
+    // The bushing frames F and M in the mobilized bodies B1 and B2 of their
+    // frames; known once the model is added to the System.
+    SimTK::ResetOnCopy<SimTK::Array_<SimTK::MobilizedBodyIndex>> _body1;
+    SimTK::ResetOnCopy<SimTK::Array_<SimTK::MobilizedBodyIndex>> _body2;
+    SimTK::ResetOnCopy<SimTK::Array_<SimTK::Transform>> _X_B1F;
+    SimTK::ResetOnCopy<SimTK::Array_<SimTK::Transform>> _X_B2M;
+//==============================================================================
+};  // END of class BatchedBushingForce
+//==============================================================================
+//==============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_BATCHED_BUSHING_FORCE_H_
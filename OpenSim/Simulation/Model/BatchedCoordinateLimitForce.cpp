@@ -0,0 +1,312 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  BatchedCoordinateLimitForce.cpp                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "BatchedCoordinateLimitForce.h"
+#include "CoordinateLimitForce.h"
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
+
+#include <algorithm>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+// The S curve of SimTK::Function::Step, from 0 at x <= 0 to 1 at x >= 1,
+// without branches.
+inline double stepUp(double x)
+{
+    x = std::min(std::max(x, 0.0), 1.0);
+    return x*x*x*(10.0 + x*(-15.0 + 6.0*x));
+}
+
+// Energy stored in a limit spring deflected by delta >= 0, whose stiffness
+// rises from 0 to K over the transition width trans.
+inline double calcSpringEnergy(double K, double delta, double trans)
+{
+    // Beyond the transition:
+    // = 5/14*K*trans^2 - 1/2*K*trans^2 + 1/2*K*(delta)^2
+    const double beyond = K*((-2.0/14.0)*trans*trans + 0.5*delta*delta);
+    // Within it, the integral of K(x)*x*dx evaluated at x = delta/trans,
+    // where K(x) = K*(10*x^3-15*x^4+6*x^5) is the S curve of stepUp().
+    const double x = std::min(delta/trans, 1.0);
+    const double within = K*x*x*x*(2.0-2.5*x+(6.0/7.0)*x*x) * (delta*delta);
+    return delta < trans ? within : beyond;
+}
+}
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+// Default constructor.
+BatchedCoordinateLimitForce::BatchedCoordinateLimitForce() : Force()
+{
+    constructProperties();
+}
+
+//_____________________________________________________________________________
+// Allocate and initialize properties.
+void BatchedCoordinateLimitForce::constructProperties()
+{
+    constructProperty_coordinates();
+    constructProperty_upper_stiffness();
+    constructProperty_upper_limit();
+    constructProperty_lower_stiffness();
+    constructProperty_lower_limit();
+    constructProperty_damping();
+    constructProperty_transition();
+    constructProperty_compute_dissipation_energy(false);
+}
+
+int BatchedCoordinateLimitForce::addCoordinateLimit(
+        const std::string& coordName, double q_upper, double K_upper,
+        double q_lower, double K_lower, double damping, double dq)
+{
+    append_coordinates(coordName);
+    append_upper_stiffness(K_upper);
+    append_upper_limit(q_upper);
+    append_lower_stiffness(K_lower);
+    append_lower_limit(q_lower);
+    append_damping(damping);
+    append_transition(dq);
+    return getNumCoordinateLimits() - 1;
+}
+
+int BatchedCoordinateLimitForce::addCoordinateLimit(
+        const CoordinateLimitForce& limitForce)
+{
+    return addCoordinateLimit(limitForce.get_coordinate(),
+        limitForce.getUpperLimit(), limitForce.getUpperStiffness(),
+        limitForce.getLowerLimit(), limitForce.getLowerStiffness(),
+        limitForce.getDamping(), limitForce.getTransition());
+}
+
+//=============================================================================
+// Model Component Interface
+//=============================================================================
+void BatchedCoordinateLimitForce::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+
+    const int n = getNumCoordinateLimits();
+    for (const auto* property : {&getProperty_upper_stiffness(),
+                                 &getProperty_upper_limit(),
+                                 &getProperty_lower_stiffness(),
+                                 &getProperty_lower_limit(),
+                                 &getProperty_damping(),
+                                 &getProperty_transition()}) {
+        OPENSIM_THROW_IF_FRMOBJ(property->size() != n, Exception,
+            "Expected a value of " + property->getName() + " for each of "
+            "the " + std::to_string(n) + " coordinates, but got " +
+            std::to_string(property->size()) + ".");
+    }
+    for (int i = 0; i < n; ++i) {
+        OPENSIM_THROW_IF_FRMOBJ(get_transition(i) <= 0, Exception,
+            "Expected a positive transition for coordinate '" +
+            get_coordinates(i) + "', but got " +
+            std::to_string(get_transition(i)) + ".");
+    }
+}
+
+void BatchedCoordinateLimitForce::extendConnectToModel(Model& aModel)
+{
+    Super::extendConnectToModel(aModel);
+
+    const int n = getNumCoordinateLimits();
+    _coords.resize(n);
+    _qup.resize(n);
+    _qlow.resize(n);
+    _Kup.resize(n);
+    _Klow.resize(n);
+    _damp.resize(n);
+    _trans.resize(n);
+    for (int i = 0; i < n; ++i) {
+        const string& coordName = get_coordinates(i);
+        OPENSIM_THROW_IF_FRMOBJ(
+            !aModel.getCoordinateSet().contains(coordName), Exception,
+            "Invalid coordinate (" + coordName + ") specified.");
+        _coords[i] = &aModel.getCoordinateSet().get(coordName);
+
+        // scaling for units
+        const double w =
+            (_coords[i]->getMotionType() == Coordinate::Rotational) ?
+                SimTK_DEGREE_TO_RADIAN : 1.0;
+        _qup[i] = w*get_upper_limit(i);
+        _qlow[i] = w*get_lower_limit(i);
+        _Kup[i] = get_upper_stiffness(i)/w;
+        _Klow[i] = get_lower_stiffness(i)/w;
+        _damp[i] = get_damping(i)/w;
+        _trans[i] = w*get_transition(i);
+    }
+}
+
+void BatchedCoordinateLimitForce::
+    extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    if (get_compute_dissipation_energy())
+        addStateVariable("dissipatedEnergy");
+}
+
+//=============================================================================
+// COMPUTATIONS
+//=============================================================================
+void BatchedCoordinateLimitForce::computeLimitForces(const SimTK::State& s,
+        double* forces, double& limitPower, double& dissipationPower) const
+{
+    const int n = getNumCoordinateLimits();
+
+    // Gather the coordinate values and speeds.
+    SimTK::Array_<double> q(n), qdot(n);
+    for (int i = 0; i < n; ++i) {
+        q[i] = _coords[i]->getValue(s);
+        qdot[i] = _coords[i]->getSpeedValue(s);
+    }
+
+    limitPower = 0;
+    dissipationPower = 0;
+    for (int i = 0; i < n; ++i) {
+        // Fraction of the stiffness (and damping) engaged at each limit.
+        const double up = stepUp((q[i] - _qup[i])/_trans[i]);
+        const double low = stepUp((_qlow[i] - q[i])/_trans[i]);
+
+        const double f_up = -up*_Kup[i]*(q[i] - _qup[i]);
+        const double f_low = low*_Klow[i]*(_qlow[i] - q[i]);
+        const double f_damp = -_damp[i]*(up + low)*qdot[i];
+
+        forces[i] = f_up + f_low + f_damp;
+        limitPower += forces[i]*qdot[i];
+        // dissipative power is negative power but is already implied by
+        // "dissipation" so negate power so that it is a positive number
+        dissipationPower -= f_damp*qdot[i];
+    }
+}
+
+void BatchedCoordinateLimitForce::computeForce(const SimTK::State& s,
+                               SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                               SimTK::Vector& mobilityForces) const
+{
+    const int n = getNumCoordinateLimits();
+    if (n == 0) return;
+    SimTK::Array_<double> forces(n);
+    double limitPower, dissipationPower;
+    computeLimitForces(s, forces.data(), limitPower, dissipationPower);
+    for (int i = 0; i < n; ++i)
+        applyGeneralizedForce(s, *_coords[i], forces[i], mobilityForces);
+}
+
+SimTK::Vector BatchedCoordinateLimitForce::calcLimitForces(
+        const SimTK::State& s) const
+{
+    SimTK::Vector forces(getNumCoordinateLimits());
+    double limitPower, dissipationPower;
+    if (forces.size() > 0)
+        computeLimitForces(s, &forces[0], limitPower, dissipationPower);
+    return forces;
+}
+
+double BatchedCoordinateLimitForce::getLimitPower(const SimTK::State& s) const
+{
+    SimTK::Array_<double> forces(getNumCoordinateLimits());
+    double limitPower = 0, dissipationPower = 0;
+    if (!forces.empty())
+        computeLimitForces(s, forces.data(), limitPower, dissipationPower);
+    return limitPower;
+}
+
+double BatchedCoordinateLimitForce::
+    getPowerDissipation(const SimTK::State& s) const
+{
+    SimTK::Array_<double> forces(getNumCoordinateLimits());
+    double limitPower = 0, dissipationPower = 0;
+    if (!forces.empty())
+        computeLimitForces(s, forces.data(), limitPower, dissipationPower);
+    return dissipationPower;
+}
+
+double BatchedCoordinateLimitForce::
+    getDissipatedEnergy(const SimTK::State& s) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(!get_compute_dissipation_energy(), Exception,
+        "compute_dissipation_energy is set to false.");
+    return getStateVariableValue(s, "dissipatedEnergy");
+}
+
+void BatchedCoordinateLimitForce::
+    computeStateVariableDerivatives(const SimTK::State& s) const
+{
+    if (appliesForce(s) && get_compute_dissipation_energy()) {
+        setStateVariableDerivativeValue(s, "dissipatedEnergy",
+            getPowerDissipation(s));
+    }
+}
+
+// Potential energy stored in the limit springs
+double BatchedCoordinateLimitForce::
+    computePotentialEnergy(const SimTK::State& s) const
+{
+    double energy = 0;
+    const int n = getNumCoordinateLimits();
+    for (int i = 0; i < n; ++i) {
+        const double q = _coords[i]->getValue(s);
+        // At most one of the limits is exceeded.
+        energy += calcSpringEnergy(_Kup[i], std::max(q - _qup[i], 0.0),
+                                   _trans[i])
+                + calcSpringEnergy(_Klow[i], std::max(_qlow[i] - q, 0.0),
+                                   _trans[i]);
+    }
+    return energy;
+}
+
+//=============================================================================
+// REPORTING
+//=============================================================================
+Array<std::string> BatchedCoordinateLimitForce::getRecordLabels() const
+{
+    OpenSim::Array<std::string> labels("");
+    for (int i = 0; i < getNumCoordinateLimits(); ++i)
+        labels.append(getName() + "." + get_coordinates(i));
+    labels.append(getName() + ".PotentialEnergy");
+    return labels;
+}
+
+Array<double> BatchedCoordinateLimitForce::
+    getRecordValues(const SimTK::State& state) const
+{
+    OpenSim::Array<double> values(0.0, getNumRecordValues());
+    writeRecordValues(state, &values[0]);
+    return values;
+}
+
+void BatchedCoordinateLimitForce::writeRecordValues(const SimTK::State& state,
+                                                    double* values) const
+{
+    const int n = getNumCoordinateLimits();
+    double limitPower, dissipationPower;
+    if (n > 0) computeLimitForces(state, values, limitPower, dissipationPower);
+    values[n] = computePotentialEnergy(state);
+}
@@ -0,0 +1,192 @@
+#ifndef OPENSIM_BATCHED_COORDINATE_LIMIT_FORCE_H_
+#define OPENSIM_BATCHED_COORDINATE_LIMIT_FORCE_H_
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  BatchedCoordinateLimitForce.h                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Simulation/Model/Force.h>
+
+//=============================================================================
+//=============================================================================
+namespace OpenSim {
+
+class Coordinate;
+class CoordinateLimitForce;
+
+/**
+ * A single Force that limits the range of motion of any number of
+ * coordinates, each exactly as a CoordinateLimitForce would: a stiffness
+ * phased in over a transition region beyond each limit, with damping phased
+ * in alike, and no force within the limits.
+ *
+ * A full-body model may otherwise carry 30 to 40 CoordinateLimitForces, each
+ * evaluated on its own. Here the parameters of all limits are kept in
+ * contiguous arrays, and the forces are computed in one loop without
+ * branches over the coordinate values and speeds, which are gathered first.
+ * The units of the parameters are those of CoordinateLimitForce (degrees for
+ * rotational coordinates).
+ *
+ * The potential energy, the power of the limit forces and the power
+ * dissipated by their damping are available for all limits together, as
+ * outputs; so is the dissipated energy, if compute_dissipation_energy is
+ * true.
+ */
+class OSIMSIMULATION_API BatchedCoordinateLimitForce : public Force {
+OpenSim_DECLARE_CONCRETE_OBJECT(BatchedCoordinateLimitForce, Force);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(coordinates, std::string,
+        "Coordinates (names) to be limited.");
+    OpenSim_DECLARE_LIST_PROPERTY(upper_stiffness, double,
+        "Stiffness of the passive limit force of each coordinate when it "
+        "exceeds its upper limit. Note, rotational stiffness expected in "
+        "N*m/degree.");
+    OpenSim_DECLARE_LIST_PROPERTY(upper_limit, double,
+        "The upper limit of the range of motion of each coordinate "
+        "(rotations in degrees).");
+    OpenSim_DECLARE_LIST_PROPERTY(lower_stiffness, double,
+        "Stiffness of the passive limit force of each coordinate when it "
+        "exceeds its lower limit. Note, rotational stiffness expected in "
+        "N*m/degree.");
+    OpenSim_DECLARE_LIST_PROPERTY(lower_limit, double,
+        "The lower limit of the range of motion of each coordinate "
+        "(rotations in degrees).");
+    OpenSim_DECLARE_LIST_PROPERTY(damping, double,
+        "Damping factor on the speed of each coordinate applied only when "
+        "a limit is exceeded. For translational has units N/(m/s) and "
+        "rotational has Nm/(degree/s)");
+    OpenSim_DECLARE_LIST_PROPERTY(transition, double,
+        "Transition region width of each coordinate in its units (rotations "
+        "in degrees). Dictates the transition from zero to constant "
+        "stiffness as the coordinate exceeds its limit.");
+    OpenSim_DECLARE_PROPERTY(compute_dissipation_energy, bool,
+        "Option to compute the energy dissipated by the damping of all "
+        "limits. If true the dissipation power is automatically integrated "
+        "to provide energy. Default is false.");
+//==============================================================================
+// OUTPUTS
+//==============================================================================
+    OpenSim_DECLARE_OUTPUT(limit_power, double, getLimitPower,
+                           SimTK::Stage::Velocity);
+    OpenSim_DECLARE_OUTPUT(power_dissipation, double, getPowerDissipation,
+                           SimTK::Stage::Velocity);
+    OpenSim_DECLARE_OUTPUT(dissipated_energy, double, getDissipatedEnergy,
+                           SimTK::Stage::Model);
+//=============================================================================
+// PUBLIC METHODS
+//=============================================================================
+    /** Default constructor limits no coordinates. */
+    BatchedCoordinateLimitForce();
+
+    //use compiler default copy constructor and assignment operator
+
+    /** Limit the range of motion of a coordinate, with the parameters of the
+    convenience constructor of CoordinateLimitForce.
+    @return the index of the limit. */
+    int addCoordinateLimit(const std::string& coordName, double q_upper,
+        double K_upper, double q_lower, double K_lower, double damping,
+        double dq);
+    /** Limit the range of motion of the coordinate of a CoordinateLimitForce
+    as it does, e.g., to replace the CoordinateLimitForces of a model.
+    @return the index of the limit. */
+    int addCoordinateLimit(const CoordinateLimitForce& limitForce);
+
+    /** The number of limited coordinates. */
+    int getNumCoordinateLimits() const
+    {   return getProperty_coordinates().size(); }
+
+    //--------------------------------------------------------------------------
+    // COMPUTATIONS
+    //--------------------------------------------------------------------------
+    /** The limit force on each coordinate, in the order of the coordinates
+    property. */
+    SimTK::Vector calcLimitForces(const SimTK::State& s) const;
+    /** The power of the limit forces on all coordinates, which is negative
+    while they resist motion. */
+    double getLimitPower(const SimTK::State& s) const;
+    /** The power dissipated by the damping of all limits (nonnegative). */
+    double getPowerDissipation(const SimTK::State& s) const;
+    /** The energy dissipated by the damping of all limits over time. Throws
+    if compute_dissipation_energy is false. */
+    double getDissipatedEnergy(const SimTK::State& s) const;
+    /** The potential energy stored in all limit springs. */
+    double computePotentialEnergy(const SimTK::State& s) const override;
+
+    //--------------------------------------------------------------------------
+    // REPORTING
+    //--------------------------------------------------------------------------
+    /** The limit force on each coordinate, then the potential energy of all
+    limits. */
+    Array<std::string> getRecordLabels() const override;
+    Array<double> getRecordValues(const SimTK::State& state) const override;
+    int getNumRecordValues() const override
+    {   return getNumCoordinateLimits() + 1; }
+    void writeRecordValues(const SimTK::State& state,
+                           double* values) const override;
+
+protected:
+    //--------------------------------------------------------------------------
+    // Model Component Interface
+    //--------------------------------------------------------------------------
+    void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& aModel) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+    //--------------------------------------------------------------------------
+    // Force Interface
+    //--------------------------------------------------------------------------
+    void computeForce(const SimTK::State& s,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& mobilityForces) const override;
+
+private:
+    void constructProperties();
+    void computeStateVariableDerivatives(const SimTK::State& s) const override;
+
+    // Compute the limit forces into forces, which has room for one per
+    // coordinate, and their total power and power dissipated by damping.
+    void computeLimitForces(const SimTK::State& s, double* forces,
+            double& limitPower, double& dissipationPower) const;
+
+    // Parameters of each limit, in internal (SI) units: limits (m or rad),
+    // constant stiffnesses (N/m or Nm/rad), damping (N/(m/s) or
+    // Nm/(rad/s)) and transition widths (m or rad).
+    SimTK::Array_<double> _qup;
+    SimTK::Array_<double> _qlow;
+    SimTK::Array_<double> _Kup;
+    SimTK::Array_<double> _Klow;
+    SimTK::Array_<double> _damp;
+    SimTK::Array_<double> _trans;
+    // The limited coordinates.
+    SimTK::ResetOnCopy<SimTK::Array_<const Coordinate*>> _coords;
+//=============================================================================
+};  // END of class BatchedCoordinateLimitForce
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif // #ifndef OPENSIM_BATCHED_COORDINATE_LIMIT_FORCE_H_
@@ -254,6 +254,23 @@ computeProbeInputs(const State& s) const
     Vector EdotOutput(getNumProbeInputs());
     EdotOutput = 0;
 
+    // Read the settings of the probe once rather than for every muscle.
+    const bool activation_rate_on = get_activation_rate_on();
+    const bool enforce_minimum_heat_rate_per_muscle =
+        get_enforce_minimum_heat_rate_per_muscle();
+    const bool forbid_negative_total_power = get_forbid_negative_total_power();
+    const bool include_negative_mechanical_work =
+        get_include_negative_mechanical_work();
+    const bool maintenance_rate_on = get_maintenance_rate_on();
+    const bool mechanical_work_rate_on = get_mechanical_work_rate_on();
+    const double muscle_effort_scaling_factor =
+        get_muscle_effort_scaling_factor();
+    const bool report_total_metabolics_only =
+        get_report_total_metabolics_only();
+    const bool shortening_rate_on = get_shortening_rate_on();
+    const bool use_force_dependent_shortening_prop_constant =
+        get_use_force_dependent_shortening_prop_constant();
+
 
     // BASAL METABOLIC RATE (W) (based on whole body mass, not muscle mass)
     // so do outside of muscle loop.
@@ -267,31 +284,34 @@ computeProbeInputs(const State& s) const
     }
     EdotOutput(0) += Bdot;       // TOTAL metabolic power storage
     
-    if (!get_report_total_metabolics_only())
+    if (!report_total_metabolics_only)
         EdotOutput(1) = Bdot;    // BASAL metabolic power storage
 
 
     // Loop through each muscle in the MetabolicMuscleParameterSet
-    const int nM = 
-        get_Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet()
-        .getSize();
+    const auto& muscleParameters =
+        get_Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet();
+    const int nM = muscleParameters.getSize();
+    const Function& fiberLengthDependence =
+        get_normalized_fiber_length_dependence_on_maintenance_rate();
+    Vector tmp(1);
     for (int i=0; i<nM; i++)
     {
         // Get the current muscle parameters from the MetabolicMuscleParameterSet
         // and the corresponding OpenSim::Muscle pointer from the muscleMap.
-        Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameter& mm = 
-            get_Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet()[i];   
+        Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameter& mm =
+            muscleParameters[i];
         const Muscle* m = mm.getMuscle();
 
         // Get important muscle values at the current time state
         const double max_isometric_force = m->getMaxIsometricForce();
         //const double max_shortening_velocity = m->getMaxContractionVelocity();
-        const double activation = get_muscle_effort_scaling_factor()
+        const double activation = muscle_effort_scaling_factor
                                   * m->getActivation(s);
-        const double excitation = get_muscle_effort_scaling_factor()
+        const double excitation = muscle_effort_scaling_factor
                                   * m->getControl(s);
         const double fiber_force_passive = m->getPassiveFiberForce(s);
-        const double fiber_force_active = get_muscle_effort_scaling_factor()
+        const double fiber_force_active = muscle_effort_scaling_factor
                                           * m->getActiveFiberForce(s);
         const double fiber_force_total = fiber_force_active     // Scaled.
                                          + fiber_force_passive;
@@ -316,7 +336,7 @@ computeProbeInputs(const State& s) const
 
         // ACTIVATION HEAT RATE for muscle i (W)
         // ------------------------------------------
-        if (get_forbid_negative_total_power() || get_activation_rate_on())
+        if (forbid_negative_total_power || activation_rate_on)
         {
             const double decay_function_value = 1.0;    // This value is set to 1.0, as used by Anderson & Pandy (1999), however, in
                                                         // Bhargava et al., (2004) they assume a function here. We will ignore this
@@ -329,10 +349,10 @@ computeProbeInputs(const State& s) const
 
         // MAINTENANCE HEAT RATE for muscle i (W)
         // ------------------------------------------
-        if (get_forbid_negative_total_power() || get_maintenance_rate_on())
+        if (forbid_negative_total_power || maintenance_rate_on)
         {
-            Vector tmp(1, fiber_length_normalized);
-            fiber_length_dependence = get_normalized_fiber_length_dependence_on_maintenance_rate().calcValue(tmp);
+            tmp[0] = fiber_length_normalized;
+            fiber_length_dependence = fiberLengthDependence.calcValue(tmp);
             
             Mdot = mm.getMuscleMass() * fiber_length_dependence * 
                 ( (mm.get_maintenance_constant_slow_twitch() * slow_twitch_excitation) + (mm.get_maintenance_constant_fast_twitch() * fast_twitch_excitation) );
@@ -343,9 +363,9 @@ computeProbeInputs(const State& s) const
         // SHORTENING HEAT RATE for muscle i (W)
         // --> note that we define Vm<0 as shortening and Vm>0 as lengthening
         // -----------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_shortening_rate_on())
+        if (forbid_negative_total_power || shortening_rate_on)
         {
-            if (get_use_force_dependent_shortening_prop_constant())
+            if (use_force_dependent_shortening_prop_constant)
             {
                 if (fiber_velocity <= 0)    // concentric contraction, Vm<0
                     alpha = (0.16 * F_iso) + (0.18 * fiber_force_total);
@@ -367,9 +387,9 @@ computeProbeInputs(const State& s) const
         // MECHANICAL WORK RATE for the contractile element of muscle i (W).
         // --> note that we define Vm<0 as shortening and Vm>0 as lengthening.
         // -------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_mechanical_work_rate_on())
+        if (forbid_negative_total_power || mechanical_work_rate_on)
         {
-            if (get_include_negative_mechanical_work() || fiber_velocity <= 0)
+            if (include_negative_mechanical_work || fiber_velocity <= 0)
                 Wdot = -fiber_force_active*fiber_velocity;
             else
                 Wdot = 0;
@@ -390,7 +410,7 @@ computeProbeInputs(const State& s) const
 
         // If necessary, increase the shortening heat rate so that the total
         // power is non-negative.
-        if (get_forbid_negative_total_power()) {
+        if (forbid_negative_total_power) {
             const double Edot_W_beforeClamp = Adot + Mdot + Sdot + Wdot;
             if (Edot_W_beforeClamp < 0)
                 Sdot -= Edot_W_beforeClamp;
@@ -402,10 +422,10 @@ computeProbeInputs(const State& s) const
         // -----------------------------------------------------------------------
         double totalHeatRate = Adot + Mdot + Sdot;      // (W)
 
-        if(get_enforce_minimum_heat_rate_per_muscle() && totalHeatRate < 1.0 * mm.getMuscleMass()
-            && get_activation_rate_on() 
-            && get_maintenance_rate_on() 
-            && get_shortening_rate_on()) {
+        if(enforce_minimum_heat_rate_per_muscle && totalHeatRate < 1.0 * mm.getMuscleMass()
+            && activation_rate_on 
+            && maintenance_rate_on 
+            && shortening_rate_on) {
                 //cout << "WARNING: " << getName() 
                 //    << "  (t = " << s.getTime() 
                 //    << "), the muscle '" << mm.getName() 
@@ -418,23 +438,23 @@ computeProbeInputs(const State& s) const
         // ------------------------------------------
         double Edot = 0;
 
-        if (get_activation_rate_on() && get_maintenance_rate_on()
-            && get_shortening_rate_on())
+        if (activation_rate_on && maintenance_rate_on
+            && shortening_rate_on)
         {
             Edot += totalHeatRate;      // May have been clamped to 1.0 W/kg.
         } else {
-            if (get_activation_rate_on())
+            if (activation_rate_on)
                 Edot += Adot;
-            if (get_maintenance_rate_on())
+            if (maintenance_rate_on)
                 Edot += Mdot;
-            if (get_shortening_rate_on())
+            if (shortening_rate_on)
                 Edot += Sdot;
         }
-        if (get_mechanical_work_rate_on())
+        if (mechanical_work_rate_on)
             Edot += Wdot;
 
         EdotOutput(0) += Edot;       // Add to TOTAL metabolic power storage
-        if (!get_report_total_metabolics_only()) {
+        if (!report_total_metabolics_only) {
             // Metabolic power storage for muscle i
             EdotOutput(i+2) = Edot;  
         }  
@@ -28,6 +28,7 @@
 #include <OpenSim/Simulation/osimSimulationDLL.h>
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/Object.h>
+#include "SimTKcommon/internal/Stage.h"
 
 namespace SimTK {
 class State;
@@ -90,6 +91,25 @@ public:
      */
     virtual bool calcCondition(const SimTK::State& s) const {return true; };
 
+    /**
+     *  A function of the state that is positive where the condition is true
+     *  and negative where it is false, so that the condition changes where
+     *  the function crosses zero. An integrator localizes those crossings by
+     *  root finding (see ConditionEvent), which is fast and precise if the
+     *  function is continuous, e.g., the height of a foot above the ground
+     *  for its contact. The default, 1 or -1 per calcCondition(), is
+     *  discontinuous: its crossings are localized by bisection.
+     */
+    virtual double calcWitness(const SimTK::State& s) const
+    {   return calcCondition(s) ? 1.0 : -1.0; }
+
+    /**
+     *  The stage to which the state must be realized to compute
+     *  calcWitness(); by default, SimTK::Stage::Acceleration.
+     */
+    virtual SimTK::Stage getWitnessStage() const
+    {   return SimTK::Stage::Acceleration; }
+
 private:
     void setNull();
     void setupProperties();
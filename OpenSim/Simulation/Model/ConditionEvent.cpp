@@ -0,0 +1,132 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ConditionEvent.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ConditionEvent.h"
+#include "Model.h"
+
+using namespace std;
+
+namespace OpenSim {
+
+// The event trigger of a ConditionEvent in the system, which owns it.
+class ConditionEventHandler : public SimTK::TriggeredEventHandler {
+public:
+    explicit ConditionEventHandler(const ConditionEvent& event) :
+        SimTK::TriggeredEventHandler(
+            event.get_condition().getWitnessStage()),
+        _event(event)
+    {
+        SimTK::EventTriggerInfo& info = getTriggerInfo();
+        info.setTriggerOnRisingSignTransition(event.get_trigger_when_true());
+        info.setTriggerOnFallingSignTransition(event.get_trigger_when_false());
+        info.setRequiredLocalizationTimeWindow(
+            event.get_localization_window());
+    }
+
+    SimTK::Real getValue(const SimTK::State& s) const override
+    {   return _event.get_condition().calcWitness(s); }
+
+    void handleEvent(SimTK::State& s, SimTK::Real accuracy,
+                     bool& shouldTerminate) const override
+    {   _event.handleEvent(s, shouldTerminate); }
+
+private:
+    const ConditionEvent& _event;
+};
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+ConditionEvent::ConditionEvent()
+{
+    constructProperties();
+}
+
+ConditionEvent::ConditionEvent(const Condition& condition)
+{
+    constructProperties();
+    set_condition(condition);
+}
+
+void ConditionEvent::constructProperties()
+{
+    constructProperty_condition(Condition());
+    constructProperty_trigger_when_true(true);
+    constructProperty_trigger_when_false(true);
+    constructProperty_localization_window(1e-6);
+    constructProperty_terminate_simulation(false);
+}
+
+//=============================================================================
+// ModelComponent interface
+//=============================================================================
+void ConditionEvent::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+
+    OPENSIM_THROW_IF_FRMOBJ(get_localization_window() <= 0, Exception,
+        "Expected a positive localization_window, but got " +
+        to_string(get_localization_window()) + ".");
+}
+
+void ConditionEvent::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+    upd_condition().connectConditionToModel(model);
+    clearEvents();
+}
+
+void ConditionEvent::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    if (get_condition().isDisabled()) return;
+    if (!get_trigger_when_true() && !get_trigger_when_false()) return;
+    system.updDefaultSubsystem().addEventHandler(
+        new ConditionEventHandler(*this));
+}
+
+//=============================================================================
+// EVENTS
+//=============================================================================
+void ConditionEvent::clearEvents() const
+{
+    _eventTimes.clear();
+    _eventConditions.clear();
+}
+
+void ConditionEvent::handleEvent(SimTK::State& s, bool& shouldTerminate) const
+{
+    // The integrator stops just after the crossing, where the witness has its
+    // new sign.
+    getModel().getMultibodySystem().realize(s,
+        get_condition().getWitnessStage());
+    const bool conditionIsTrue = get_condition().calcWitness(s) > 0;
+    _eventTimes.push_back(s.getTime());
+    _eventConditions.push_back(conditionIsTrue);
+    handleConditionChange(s, conditionIsTrue);
+    shouldTerminate = get_terminate_simulation();
+}
+
+} // end of namespace OpenSim
@@ -0,0 +1,138 @@
+#ifndef OPENSIM_CONDITION_EVENT_H_
+#define OPENSIM_CONDITION_EVENT_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ConditionEvent.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDE
+#include "ModelComponent.h"
+#include "Condition.h"
+
+namespace OpenSim {
+
+//==============================================================================
+//                               CONDITION EVENT
+//==============================================================================
+/**
+ * An event of the simulation at which a Condition changes, e.g., the heel
+ * strike or toe off of a gait model, located by the integrator rather than
+ * polled at each step.
+ *
+ * The ConditionEvent adds to the system an event trigger whose witness is
+ * Condition::calcWitness(). After each step, the integrator checks whether
+ * the witness changed sign and, if so, localizes the crossing by root finding
+ * to within localization_window, and stops there. Steps can thus be as large
+ * as the accuracy allows between events, while the events are still located
+ * precisely. For a condition whose witness is continuous (e.g., the height of
+ * a foot above the ground for its contact), the crossing is found in a few
+ * evaluations; the default witness of a Condition is only 1 or -1, and is
+ * localized by bisection.
+ *
+ * At each event, the time and the new value of the condition are recorded
+ * (getEventTimes()), handleConditionChange() is called with the state at the
+ * event, which subclasses may change (e.g., to switch the phase of a gait
+ * controller), and the simulation ends if terminate_simulation is true. A
+ * disabled condition adds no event.
+ *
+ * @code
+ * // heelContact is a Condition whose witness is the penetration of the heel
+ * // into the ground.
+ * ConditionEvent* heelStrike = new ConditionEvent(heelContact);
+ * heelStrike->setName("heel_strike_r");
+ * heelStrike->set_trigger_when_false(false);
+ * model.addModelComponent(heelStrike);
+ * @endcode
+ */
+class OSIMSIMULATION_API ConditionEvent : public ModelComponent {
+OpenSim_DECLARE_CONCRETE_OBJECT(ConditionEvent, ModelComponent);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_PROPERTY(condition, Condition,
+        "The condition whose changes are events.");
+    OpenSim_DECLARE_PROPERTY(trigger_when_true, bool,
+        "Whether the condition becoming true is an event (default true).");
+    OpenSim_DECLARE_PROPERTY(trigger_when_false, bool,
+        "Whether the condition becoming false is an event (default true).");
+    OpenSim_DECLARE_PROPERTY(localization_window, double,
+        "Width (s) of the time window within which the integrator localizes "
+        "the events (default 1e-6).");
+    OpenSim_DECLARE_PROPERTY(terminate_simulation, bool,
+        "Whether the simulation ends at the first event (default false).");
+
+//==============================================================================
+// PUBLIC METHODS
+//==============================================================================
+    /** Default constructor creates an event of a Condition that is always
+    true, which never occurs. */
+    ConditionEvent();
+
+    /** Create an event at which the given condition changes. */
+    explicit ConditionEvent(const Condition& condition);
+
+    // Uses default (compiler-generated) destructor, copy constructor, and copy
+    // assignment operator.
+
+    /** The times of the events handled since the component was connected to
+    its model or clearEvents() was called, in order. */
+    const SimTK::Array_<double>& getEventTimes() const { return _eventTimes; }
+    /** For each event, whether the condition became true (rather than
+    false). */
+    const SimTK::Array_<bool>& getEventConditions() const
+    {   return _eventConditions; }
+    /** Forget the events handled so far. */
+    void clearEvents() const;
+
+protected:
+    /** Called at each event, after it is recorded, with the state at the
+    event, which may be changed. Does nothing by default.
+    @param s                the state at the event
+    @param conditionIsTrue  whether the condition became true */
+    virtual void handleConditionChange(SimTK::State& s,
+                                       bool conditionIsTrue) const {}
+
+    //--------------------------------------------------------------------------
+    // Implement ModelComponent interface.
+    //--------------------------------------------------------------------------
+    void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+private:
+    friend class ConditionEventHandler;
+
+    void constructProperties();
+
+    // Record the event at the given state and handle it.
+    void handleEvent(SimTK::State& s, bool& shouldTerminate) const;
+
+    // The events handled so far.
+    mutable SimTK::Array_<double> _eventTimes;
+    mutable SimTK::Array_<bool> _eventConditions;
+//==============================================================================
+};  // END of class ConditionEvent
+//==============================================================================
+//==============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_CONDITION_EVENT_H_
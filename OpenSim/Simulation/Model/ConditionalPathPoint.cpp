@@ -108,6 +108,22 @@ const Coordinate& ConditionalPathPoint::getCoordinate() const
 }
 
 
+void ConditionalPathPoint::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+    _coordinate.reset();
+    if (hasCoordinate())
+        _coordinate.reset(&getConnectee<Coordinate>("coordinate"));
+}
+
+void ConditionalPathPoint::
+extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    _isActiveCV = addCacheVariable<bool>("is_active", false,
+        SimTK::Stage::Position);
+}
+
 //_____________________________________________________________________________
 /*
  * Set the range min.
@@ -133,11 +149,15 @@ void ConditionalPathPoint::setRangeMax(double maxVal)
  */
 bool ConditionalPathPoint::isActive(const SimTK::State& s) const
 {
-    if (getSocket<Coordinate>("coordinate").isConnected()) {
-        double value = getConnectee<Coordinate>("coordinate").getValue(s);
-        if (value >= get_range(0) - 1e-5 &&
-             value <= get_range(1) + 1e-5)
-            return true;
+    if (_isActiveCV.isValid(s))
+        return _isActiveCV.getValue(s);
+
+    bool isActive = false;
+    if (!_coordinate.empty()) {
+        double value = _coordinate->getValue(s);
+        isActive = value >= get_range(0) - 1e-5 &&
+                   value <= get_range(1) + 1e-5;
     }
-    return false;
+    _isActiveCV.setValue(s, isActive);
+    return isActive;
 }
@@ -78,6 +78,13 @@ public:
 private:
     void constructProperties();
     void updateFromXMLNode(SimTK::Xml::Element& node, int versionNumber) override;
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+    // Hang on to the Coordinate instead of finding the socket each time.
+    SimTK::ReferencePtr<const Coordinate> _coordinate;
+    // Whether the point is active, which changes only with the Coordinate.
+    mutable SimTK::ResetOnCopy<CacheVariable<bool> > _isActiveCV;
 //=============================================================================
 };  // END of class ConditionalPathPoint
 //=============================================================================
@@ -24,6 +24,7 @@
 #include <fstream>
 #include <OpenSim/Common/IO.h>
 #include "ContactMesh.h"
+#include "MeshCache.h"
 #include "Model.h"
 
 namespace OpenSim {
@@ -49,10 +50,8 @@ ContactMesh::ContactMesh(const std::string& filename,
         if (file.fail())
             throw Exception("Error loading mesh file: "+filename+". The file should exist in same folder with model.\n Model loading is aborted.");
         file.close();
-        SimTK::PolygonalMesh mesh;
-        mesh.loadFile(filename);
-        _geometry.reset(new SimTK::ContactGeometry::TriangleMesh(mesh));
-        _decorativeGeometry.reset(new SimTK::DecorativeMesh(mesh));
+        loadMeshFile(filename);
+        _loadedFilename = filename;
     }
 }
 
@@ -77,8 +76,16 @@ void ContactMesh::constructProperties()
 }
 
 void ContactMesh::extendFinalizeFromProperties() {
+    if (get_filename() != _loadedFilename)
+        resetMesh();
+}
+
+void ContactMesh::resetMesh()
+{
+    _polygons.reset();
     _geometry.reset();
     _decorativeGeometry.reset();
+    _loadedFilename.clear();
 }
 
 const std::string& ContactMesh::getFilename() const
@@ -89,43 +96,43 @@ const std::string& ContactMesh::getFilename() const
 void ContactMesh::setFilename(const std::string& filename)
 {
     set_filename(filename);
-    _geometry.reset();
-    _decorativeGeometry.reset();
+    resetMesh();
 }
 
-SimTK::ContactGeometry::TriangleMesh* ContactMesh::
-    loadMesh(const std::string& filename) const
+void ContactMesh::loadMesh(const std::string& filename) const
 {
-    SimTK::PolygonalMesh mesh;
-    std::ifstream file;
     assert (_model);
-    const std::string& savedCwd = IO::getCwd();
-    bool restoreDirectory = false;
-    if ((_model->getInputFileName()!="")
+    // A relative path is relative to the directory of the model file.
+    std::string path = filename;
+    bool isAbsolutePath; std::string directory, fileName, extension;
+    SimTK::Pathname::deconstructPathname(filename,
+        isAbsolutePath, directory, fileName, extension);
+    if (!isAbsolutePath && (_model->getInputFileName()!="")
             && (_model->getInputFileName()!="Unassigned")) {
-        std::string parentDirectory = IO::getParentDirectory(
-                _model->getInputFileName());
-        IO::chDir(parentDirectory);
-        restoreDirectory=true;
+        path = IO::getParentDirectory(_model->getInputFileName()) + filename;
     }
-    file.open(filename.c_str());
+    std::ifstream file(path.c_str());
     if (file.fail()){
-        if (restoreDirectory) IO::chDir(savedCwd);
         throw Exception("Error loading mesh file: "+filename+". "
                 "The file should exist in same folder with model.\n "
                 "Loading is aborted.");
     }
     file.close();
-    mesh.loadFile(filename);
-    if (restoreDirectory) IO::chDir(savedCwd);
-    _decorativeGeometry.reset(new SimTK::DecorativeMesh(mesh));
-    return new SimTK::ContactGeometry::TriangleMesh(mesh);
+    loadMeshFile(path);
+    _loadedFilename = filename;
+}
+
+void ContactMesh::loadMeshFile(const std::string& path) const
+{
+    _polygons = MeshCache::getPolygonalMesh(path);
+    _geometry = MeshCache::getTriangleMesh(path);
+    _decorativeGeometry = std::make_shared<SimTK::DecorativeMesh>(*_polygons);
 }
 
 SimTK::ContactGeometry ContactMesh::createSimTKContactGeometry() const
 {
     if (!_geometry)
-        _geometry.reset(loadMesh(get_filename()));
+        loadMesh(get_filename());
     return *_geometry;
 }
 
@@ -104,17 +104,26 @@ private:
     void constructProperties();
     void extendFinalizeFromProperties() override;
 
-    /** Load the mesh from a file.
-    @param filename   string containing the file to be loaded
-    @return SimTK::ContactGeometry::TriangleMesh* heap allocated Contact mesh */
-    SimTK::ContactGeometry::TriangleMesh* loadMesh(const std::string& filename) const;
+    /** Load the contact and decorative meshes from a file.
+    @param filename   string containing the file to be loaded */
+    void loadMesh(const std::string& filename) const;
+    /** Get the meshes of the file at the given path from the MeshCache. */
+    void loadMeshFile(const std::string& path) const;
+    /** Discard the loaded meshes so that they are loaded again when needed. */
+    void resetMesh();
 //=============================================================================
 // DATA
 //=============================================================================
-    mutable SimTK::ResetOnCopy<std::unique_ptr<SimTK::ContactGeometry::TriangleMesh>>
+    // The meshes are never modified once loaded, so copies of this
+    // ContactMesh (e.g., in a cloned model) share them rather than copying
+    // the polygons or reading the file again. They come from the MeshCache,
+    // so other models that use the same file share them too.
+    mutable std::shared_ptr<const SimTK::PolygonalMesh> _polygons;
+    mutable std::shared_ptr<const SimTK::ContactGeometry::TriangleMesh>
         _geometry;
-    mutable SimTK::ResetOnCopy<std::unique_ptr<SimTK::DecorativeMesh>>
-        _decorativeGeometry;
+    mutable std::shared_ptr<const SimTK::DecorativeMesh> _decorativeGeometry;
+    // The value of the filename property the meshes were loaded from.
+    mutable std::string _loadedFilename;
 
 //=============================================================================
 };  // END of class ContactMesh
@@ -140,6 +140,11 @@ void ControllerSet::constructStorage()
         
 }
 
+void ControllerSet::clearControlStorage()
+{
+    if (_controlStore) _controlStore->purge();
+}
+
 void ControllerSet::storeControls( const SimTK::State& s, int step  )
 {
     int size = _actuatorSet->getSize();
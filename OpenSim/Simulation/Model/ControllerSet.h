@@ -72,6 +72,9 @@ public:
 #endif
 
     void constructStorage();
+    /** Remove the stored controls, keeping the memory of the storage for
+    the controls of another integration. */
+    void clearControlStorage();
     void storeControls( const SimTK::State& s, int step );
     void printControlStorage( const std::string& fileName) const;
     TimeSeriesTable getControlTable() const;
@@ -91,6 +91,85 @@ void CoordinateSet::getSpeedNames(OpenSim::Array<std::string> &rNames) const {
 }
 
 
+//=============================================================================
+// SETTING A POSE
+//=============================================================================
+void CoordinateSet::setValues(SimTK::State& s, const SimTK::Vector& values,
+                              bool enforceConstraints) const
+{
+    SimTK::Array_<const Coordinate*> coords;
+    for (int i = 0; i < getSize(); ++i)
+        coords.push_back(&get(i));
+    setValuesOfCoordinates(s, coords, values, nullptr, enforceConstraints);
+}
+
+void CoordinateSet::setValues(SimTK::State& s,
+                              const std::vector<std::string>& names,
+                              const SimTK::Vector& values,
+                              bool enforceConstraints) const
+{
+    SimTK::Array_<const Coordinate*> coords;
+    for (const auto& name : names) {
+        const int index = getIndex(name);
+        OPENSIM_THROW_IF_FRMOBJ(index < 0, Exception,
+            "No Coordinate named '" + name + "'.");
+        coords.push_back(&get(index));
+    }
+    setValuesOfCoordinates(s, coords, values, nullptr, enforceConstraints);
+}
+
+void CoordinateSet::setValuesAndSpeeds(SimTK::State& s,
+                                       const SimTK::Vector& values,
+                                       const SimTK::Vector& speeds,
+                                       bool enforceConstraints) const
+{
+    SimTK::Array_<const Coordinate*> coords;
+    for (int i = 0; i < getSize(); ++i)
+        coords.push_back(&get(i));
+    setValuesOfCoordinates(s, coords, values, &speeds, enforceConstraints);
+}
+
+void CoordinateSet::setValuesOfCoordinates(SimTK::State& s,
+        const SimTK::Array_<const Coordinate*>& coords,
+        const SimTK::Vector& values, const SimTK::Vector* speeds,
+        bool enforceConstraints) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(!hasModel(), Exception,
+        "The CoordinateSet is not part of a Model.");
+    OPENSIM_THROW_IF_FRMOBJ(values.size() != (int)coords.size(), Exception,
+        "Expected " + std::to_string(coords.size()) + " values, but got "
+        + std::to_string(values.size()) + ".");
+    OPENSIM_THROW_IF_FRMOBJ(speeds && speeds->size() != (int)coords.size(),
+        Exception, "Expected " + std::to_string(coords.size())
+        + " speeds, but got " + std::to_string(speeds->size()) + ".");
+
+    // Coordinate::setValue() handles the clamped and locked coordinates.
+    bool constrained = getModel().getConstraintSet().getSize() > 0;
+    for (unsigned i = 0; i < coords.size(); ++i) {
+        coords[i]->setValue(s, values[i], false);
+        if (speeds)
+            coords[i]->setSpeedValue(s, (*speeds)[i]);
+        constrained = constrained || coords[i]->isConstrained(s);
+    }
+    if (!enforceConstraints)
+        return;
+
+    const SimTK::MultibodySystem& system = getModel().getMultibodySystem();
+    if (constrained) {
+        // Dependent coordinates are dictated by the others, so their value
+        // does not weigh in the assembly.
+        SimTK::Array_<double> weights;
+        for (const Coordinate* coord : coords)
+            weights.push_back(coord->isDependent(s) ? 0.0 : 10);
+        _model->assemble(s, coords, weights);
+        if (speeds)
+            system.projectU(s, 1e-10);
+    }
+    else
+        system.realize(s, speeds ? SimTK::Stage::Velocity
+                                 : SimTK::Stage::Position);
+}
+
 //=============================================================================
 // OPERATORS
 //=============================================================================
@@ -27,6 +27,9 @@
 #include <OpenSim/Simulation/Model/ModelComponentSet.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
 
+#include <string>
+#include <vector>
+
 
 namespace OpenSim {
 
@@ -57,6 +60,44 @@ public:
      */
     void populate(Model& model);
 
+    /**
+     * %Set the values of all the Coordinates of this %Set, in the order of
+     * the %Set, and enforce the constraints once, after all of them are set.
+     * This costs a single assembly of the model, rather than one per
+     * Coordinate when each is set with Coordinate::setValue(). As with
+     * Coordinate::setValue(), the values of clamped Coordinates are kept
+     * within their range and locked Coordinates keep their value. The value of
+     * a dependent Coordinate (e.g., the one driven by a
+     * CoordinateCouplerConstraint) does not weigh in the assembly.
+     *
+     * @code
+     * SimTK::Vector pose(model.getNumCoordinates(), 0.0);
+     * model.getCoordinateSet().setValues(state, pose);
+     * @endcode
+     */
+    void setValues(SimTK::State& s, const SimTK::Vector& values,
+                   bool enforceConstraints = true) const;
+
+    /**
+     * %Set the values of the Coordinates with the given names, as
+     * setValues(), leaving the other Coordinates where they are. An
+     * Exception is thrown if a name is not that of a Coordinate in this %Set.
+     */
+    void setValues(SimTK::State& s, const std::vector<std::string>& names,
+                   const SimTK::Vector& values,
+                   bool enforceConstraints = true) const;
+
+    /**
+     * %Set the values and the speeds of all the Coordinates of this %Set,
+     * as setValues(). When the constraints are enforced, the speeds are
+     * projected after the assembly so that they satisfy them too; in
+     * particular, locked and prescribed Coordinates keep the speeds the
+     * constraints impose.
+     */
+    void setValuesAndSpeeds(SimTK::State& s, const SimTK::Vector& values,
+                            const SimTK::Vector& speeds,
+                            bool enforceConstraints = true) const;
+
     //--------------------------------------------------------------------------
     // OPERATORS
     //--------------------------------------------------------------------------
@@ -65,6 +106,15 @@ public:
 #endif
     void getSpeedNames(OpenSim::Array<std::string> &rNames) const;
 
+private:
+    // Set the values, and the speeds if not null, of the given Coordinates,
+    // then enforce the constraints once.
+    void setValuesOfCoordinates(SimTK::State& s,
+                                const SimTK::Array_<const Coordinate*>& coords,
+                                const SimTK::Vector& values,
+                                const SimTK::Vector* speeds,
+                                bool enforceConstraints) const;
+
 //=============================================================================
 };  // END of class CoordinateSet
 //=============================================================================
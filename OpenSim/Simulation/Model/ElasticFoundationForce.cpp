@@ -25,9 +25,12 @@
 #include "ContactGeometry.h"
 #include "ContactMesh.h"
 #include "Model.h"
+#include <OpenSim/Common/ThreadPool.h>
 
 #include "simbody/internal/ElasticFoundationForce.h"
 
+#include <algorithm>
+
 namespace OpenSim {
 
 //==============================================================================
@@ -57,8 +60,22 @@ void ElasticFoundationForce::extendAddToSystem(SimTK::MultibodySystem& system) c
 
     SimTK::GeneralContactSubsystem& contacts = system.updContactSubsystem();
     SimTK::ContactSetIndex set = contacts.createContactSet();
-    SimTK::ElasticFoundationForce force(_model->updForceSubsystem(), contacts, set);
-    force.setTransitionVelocity(transitionVelocity);
+
+    // Beyond the const Component keep the contact set and the springs so we
+    // can evaluate them later.
+    ElasticFoundationForce* mutableThis = const_cast<ElasticFoundationForce *>(this);
+    mutableThis->_contactSet = set;
+    mutableThis->_evaluatesSprings = _numThreads > 1;
+    mutableThis->_springs.clear();
+
+    // The springs are evaluated either by Simbody or, through the
+    // SimTK::Force::Custom created by Force, by computeForce().
+    std::unique_ptr<SimTK::ElasticFoundationForce> force;
+    if (!_evaluatesSprings) {
+        force.reset(new SimTK::ElasticFoundationForce(
+            _model->updForceSubsystem(), contacts, set));
+        force->setTransitionVelocity(transitionVelocity);
+    }
     for (int i = 0; i < contactParametersSet.getSize(); ++i)
     {
         ContactParameters& params = contactParametersSet.get(i);
@@ -74,22 +91,50 @@ void ElasticFoundationForce::extendAddToSystem(SimTK::MultibodySystem& system) c
             const auto& X_BF = geom.getFrame().findTransformInBaseFrame();
             const auto& X_FP = geom.getTransform();
             const auto X_BP = X_BF * X_FP;
+            const SimTK::ContactGeometry simtkGeom =
+                geom.createSimTKContactGeometry();
             contacts.addBody(set, geom.getFrame().getMobilizedBody(),
-                    geom.createSimTKContactGeometry(), X_BP);
-            if (dynamic_cast<const ContactMesh*>(&geom) != NULL) {
-                force.setBodyParameters(
-                        SimTK::ContactSurfaceIndex(contacts.getNumBodies(set)-1), 
+                    simtkGeom, X_BP);
+            if (dynamic_cast<const ContactMesh*>(&geom) == NULL)
+                continue;
+            const SimTK::ContactSurfaceIndex surface(
+                    contacts.getNumBodies(set)-1);
+            if (force) {
+                force->setBodyParameters(surface,
                         params.getStiffness(), params.getDissipation(),
                         params.getStaticFriction(),
                         params.getDynamicFriction(),
                         params.getViscousFriction());
+                continue;
+            }
+
+            // As Simbody does, place a spring at the centroid of each face.
+            const auto& mesh =
+                SimTK::ContactGeometry::TriangleMesh::getAs(simtkGeom);
+            mutableThis->_springs.resize(surface + 1);
+            MeshSprings& springs = mutableThis->_springs[surface];
+            const int nf = mesh.getNumFaces();
+            springs.x.resize(nf);
+            springs.y.resize(nf);
+            springs.z.resize(nf);
+            springs.area.resize(nf);
+            for (int f = 0; f < nf; ++f) {
+                const SimTK::Vec3 centroid = mesh.findCentroid(f);
+                springs.x[f] = centroid[0];
+                springs.y[f] = centroid[1];
+                springs.z[f] = centroid[2];
+                springs.area[f] = mesh.getFaceArea(f);
             }
+            springs.stiffness = params.getStiffness();
+            springs.dissipation = params.getDissipation();
+            springs.staticFriction = params.getStaticFriction();
+            springs.dynamicFriction = params.getDynamicFriction();
+            springs.viscousFriction = params.getViscousFriction();
         }
     }
 
     // Beyond the const Component get the index so we can access the SimTK::Force later
-    ElasticFoundationForce* mutableThis = const_cast<ElasticFoundationForce *>(this);
-    mutableThis->_index = force.getForceIndex();
+    if (force) mutableThis->_index = force->getForceIndex();
 }
 
 void ElasticFoundationForce::constructProperties()
@@ -196,6 +241,177 @@ void ElasticFoundationForce::addGeometry(const std::string& name)
     upd_contact_parameters()[0].addGeometry(name);
 }
 
+void ElasticFoundationForce::setNumThreads(int numThreads)
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(numThreads) + ".");
+    _numThreads = numThreads;
+}
+
+//==============================================================================
+//                         SPRINGS EVALUATED IN PARALLEL
+//==============================================================================
+void ElasticFoundationForce::computeForce(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const
+{
+    if (_evaluatesSprings) computeSpringForces(s, &bodyForces);
+}
+
+double ElasticFoundationForce::computePotentialEnergy(
+        const SimTK::State& s) const
+{
+    return _evaluatesSprings ? computeSpringForces(s, nullptr) : 0.0;
+}
+
+double ElasticFoundationForce::computeSpringForces(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>* bodyForces) const
+{
+    const SimTK::GeneralContactSubsystem& contacts =
+        getModel().getMultibodySystem().getContactSubsystem();
+    const auto hasSprings = [&](SimTK::ContactSurfaceIndex surface) {
+        return surface < (int)_springs.size() &&
+               !_springs[surface].area.empty();
+    };
+
+    double energy = 0;
+    for (const SimTK::Contact& contact : contacts.getContacts(s, _contactSet))
+    {
+        const SimTK::ContactSurfaceIndex surface1 = contact.getSurface1();
+        const SimTK::ContactSurfaceIndex surface2 = contact.getSurface2();
+        const bool springs1 = hasSprings(surface1);
+        const bool springs2 = hasSprings(surface2);
+        if (!springs1 && !springs2) continue;
+        // Two meshes in contact each carry half the load.
+        const double areaScale = springs1 && springs2 ? 0.5 : 1.0;
+        const auto& meshContact =
+            static_cast<const SimTK::TriangleMeshContact&>(contact);
+        if (springs1) {
+            energy += computeMeshSpringForces(s, surface1, surface2,
+                meshContact.getSurface1Faces(), areaScale, bodyForces);
+        }
+        if (springs2) {
+            energy += computeMeshSpringForces(s, surface2, surface1,
+                meshContact.getSurface2Faces(), areaScale, bodyForces);
+        }
+    }
+    return energy;
+}
+
+double ElasticFoundationForce::computeMeshSpringForces(const SimTK::State& s,
+        SimTK::ContactSurfaceIndex meshIndex,
+        SimTK::ContactSurfaceIndex otherIndex,
+        const std::set<int>& faces, double areaScale,
+        SimTK::Vector_<SimTK::SpatialVec>* bodyForces) const
+{
+    using SimTK::Vec3;
+
+    const int n = (int)faces.size();
+    if (n == 0) return 0;
+
+    const SimTK::GeneralContactSubsystem& contacts =
+        getModel().getMultibodySystem().getContactSubsystem();
+    const MeshSprings& springs = _springs[meshIndex];
+    const SimTK::ContactGeometry& other =
+        contacts.getBodyGeometry(_contactSet, otherIndex);
+    const SimTK::MobilizedBody& body1 = contacts.getBody(_contactSet, meshIndex);
+    const SimTK::MobilizedBody& body2 =
+        contacts.getBody(_contactSet, otherIndex);
+    // M: the mesh; O: the other surface.
+    const SimTK::Transform X_GM = body1.getBodyTransform(s) *
+        contacts.getBodyTransform(_contactSet, meshIndex);
+    const SimTK::Transform X_GO = body2.getBodyTransform(s) *
+        contacts.getBodyTransform(_contactSet, otherIndex);
+    const SimTK::Transform X_OM = ~X_GO * X_GM;
+    const Vec3& p1 = body1.getBodyOriginLocation(s);
+    const Vec3& p2 = body2.getBodyOriginLocation(s);
+    const SimTK::SpatialVec& V1 = body1.getBodyVelocity(s);
+    const SimTK::SpatialVec& V2 = body2.getBodyVelocity(s);
+    const double transitionVelocity = get_transition_velocity();
+
+    // The force of each spring in contact acts on the mesh at the nearest
+    // point of the other surface, and the opposite force on the other
+    // surface. Each range of faces sums the forces, their moments about the
+    // ground origin, and the energy of the springs.
+    struct Sum {
+        Vec3 force = Vec3(0);
+        Vec3 moment = Vec3(0);
+        double energy = 0;
+    };
+    const std::vector<int> faceList(faces.begin(), faces.end());
+    const auto computeRange = [&](int begin, int end, Sum& sum) {
+        for (int k = begin; k < end; ++k) {
+            const int face = faceList[k];
+            const Vec3 spring_M(springs.x[face], springs.y[face],
+                                springs.z[face]);
+            bool inside;
+            SimTK::UnitVec3 normal;
+            const Vec3 nearest_O =
+                other.findNearestPoint(X_OM*spring_M, inside, normal);
+            if (!inside) continue;
+
+            // Find how much the spring is displaced.
+            const Vec3 nearest = X_GO*nearest_O;
+            const Vec3 displacement = nearest - X_GM*spring_M;
+            const double distance = displacement.norm();
+            if (distance == 0.0) continue;
+            const Vec3 forceDir = displacement/distance;
+
+            // The relative velocity of the two bodies at the contact point.
+            const Vec3 v = (V2[1] + V2[0] % (nearest - p2))
+                         - (V1[1] + V1[0] % (nearest - p1));
+            const double vnormal = dot(v, forceDir);
+            const Vec3 vtangent = v - vnormal*forceDir;
+
+            // The elastic and damping force, then the friction force.
+            const double area = areaScale*springs.area[face];
+            const double f = springs.stiffness*area*distance*
+                             (1 + springs.dissipation*vnormal);
+            Vec3 force = (f > 0 ? f*forceDir : Vec3(0));
+            const double vslip = vtangent.norm();
+            if (f > 0 && vslip != 0) {
+                const double vrel = vslip/transitionVelocity;
+                const double ffriction = f*(std::min(vrel, 1.0)*
+                    (springs.dynamicFriction + 2*(springs.staticFriction -
+                     springs.dynamicFriction)/(1 + vrel*vrel)) +
+                    springs.viscousFriction*vslip);
+                force += ffriction*vtangent/vslip;
+            }
+
+            sum.force += force;
+            sum.moment += nearest % force;
+            sum.energy += 0.5*springs.stiffness*area*distance*distance;
+        }
+    };
+
+    // The sums of the ranges are added in the order of the ranges.
+    const int numRanges = ThreadPool::getNumRanges(n, _numThreads);
+    SimTK::Array_<Sum> sums(numRanges);
+    if (numRanges == 1) {
+        computeRange(0, n, sums[0]);
+    } else {
+        ThreadPool::parallelForRanges(n, numRanges, _numThreads,
+            [&](int range, int begin, int end) {
+                computeRange(begin, end, sums[range]);
+            });
+    }
+    Sum total;
+    for (const Sum& sum : sums) {
+        total.force += sum.force;
+        total.moment += sum.moment;
+        total.energy += sum.energy;
+    }
+
+    if (bodyForces) {
+        (*bodyForces)[body1.getMobilizedBodyIndex()] +=
+            SimTK::SpatialVec(total.moment - p1 % total.force, total.force);
+        (*bodyForces)[body2.getMobilizedBodyIndex()] -=
+            SimTK::SpatialVec(total.moment - p2 % total.force, total.force);
+    }
+    return total.energy;
+}
+
 //==============================================================================
 //               ELASTIC FOUNDATION FORCE :: CONTACT PARAMETERS
 //==============================================================================
@@ -349,16 +565,21 @@ OpenSim::Array<double> ElasticFoundationForce::getRecordValues(const SimTK::Stat
     const ContactParametersSet& contactParametersSet = 
         get_contact_parameters();
 
-    const SimTK::ElasticFoundationForce& simtkForce = 
-        (SimTK::ElasticFoundationForce &)(_model->getForceSubsystem().getForce(_index));
-
     SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
     SimTK::Vector_<SimTK::Vec3> particleForces(0);
     SimTK::Vector mobilityForces(0);
 
     //get the net force added to the system contributed by the Spring
-    simtkForce.calcForceContribution(state, bodyForces, particleForces,
-                                     mobilityForces);
+    if (_evaluatesSprings) {
+        bodyForces.resize(getModel().getMatterSubsystem().getNumBodies());
+        bodyForces.setToZero();
+        computeSpringForces(state, &bodyForces);
+    } else {
+        const SimTK::ElasticFoundationForce& simtkForce =
+            (SimTK::ElasticFoundationForce &)(_model->getForceSubsystem().getForce(_index));
+        simtkForce.calcForceContribution(state, bodyForces, particleForces,
+                                         mobilityForces);
+    }
 
     for (int i = 0; i < contactParametersSet.getSize(); ++i)
     {
@@ -36,6 +36,12 @@ places a spring at the center of each face of each ContactMesh it acts on.
 Those springs interact with all objects (both meshes and other objects) the 
 mesh comes in contact with.
 
+By default the springs are evaluated by Simbody, one after another. For
+meshes with many faces in contact (e.g., cartilage meshes of tens of thousands
+of triangles), setNumThreads() splits the faces in contact of each pair of
+surfaces across threads instead. The centers and areas of the faces are then
+kept in contiguous arrays per mesh.
+
 @author Peter Eastman **/
 class OSIMSIMULATION_API ElasticFoundationForce : public Force {
 OpenSim_DECLARE_CONCRETE_OBJECT(ElasticFoundationForce, Force);
@@ -91,6 +97,21 @@ public:
     void setViscousFriction(double friction);
     void addGeometry(const std::string& name);
 
+    /** %Set the number of threads across which the faces in contact of
+    each pair of surfaces are split when computing their springs. With 1 (the
+    default), the springs are evaluated by Simbody; with more, they are
+    evaluated by this force, to the same forces up to roundoff. A few
+    thousand faces in contact per thread are needed for the threads to pay
+    off. In deterministic mode (see ThreadPool::setDeterministic()), the
+    results do not depend on the number of threads. Takes effect when the
+    system is created (initSystem()). */
+    void setNumThreads(int numThreads);
+    int getNumThreads() const { return _numThreads; }
+
+    /** The potential energy of the springs, when evaluated by this force
+    (see setNumThreads()); otherwise Simbody reports it. */
+    double computePotentialEnergy(const SimTK::State& s) const override;
+
     //-----------------------------------------------------------------------------
     // Reporting
     //-----------------------------------------------------------------------------
@@ -102,10 +123,45 @@ public:
     *  Provide the value(s) to be reported that correspond to the labels
     */
     OpenSim::Array<double> getRecordValues(const SimTK::State& state) const override ;
+protected:
+    void computeForce(const SimTK::State& s,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& generalizedForces) const override;
+
 private:
     // INITIALIZATION
     void constructProperties();
 
+    // The springs of a mesh: the center and area of each face, in the frame
+    // of the mesh, and the parameters of the mesh.
+    struct MeshSprings {
+        SimTK::Array_<double> x, y, z;
+        SimTK::Array_<double> area;
+        double stiffness{0}, dissipation{0};
+        double staticFriction{0}, dynamicFriction{0}, viscousFriction{0};
+    };
+
+    // Add the forces of all the springs in contact to bodyForces (if not
+    // null), and return their potential energy.
+    double computeSpringForces(const SimTK::State& s,
+            SimTK::Vector_<SimTK::SpatialVec>* bodyForces) const;
+    // Same, for the springs of the given faces of one mesh in contact with
+    // another surface; their areas are scaled by areaScale.
+    double computeMeshSpringForces(const SimTK::State& s,
+            SimTK::ContactSurfaceIndex meshIndex,
+            SimTK::ContactSurfaceIndex otherIndex,
+            const std::set<int>& faces, double areaScale,
+            SimTK::Vector_<SimTK::SpatialVec>* bodyForces) const;
+
+    int _numThreads{1};
+    // Whether the springs are evaluated by this force rather than by a
+    // SimTK::ElasticFoundationForce; decided in extendAddToSystem().
+    bool _evaluatesSprings{false};
+    SimTK::ContactSetIndex _contactSet;
+    // The springs of each surface of the contact set; empty for the surfaces
+    // that are not meshes.
+    SimTK::ResetOnCopy<std::vector<MeshSprings>> _springs;
+
 //==============================================================================
 };  // END of class ElasticFoundationForce
 //==============================================================================
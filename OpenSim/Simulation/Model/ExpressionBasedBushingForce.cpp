@@ -24,8 +24,6 @@
 //=============================================================================
 // INCLUDES
 //=============================================================================
-#include <Vendors/lepton/include/Lepton.h>
-
 #include "ExpressionBasedBushingForce.h"
 
 using namespace std;
@@ -33,6 +31,14 @@ using namespace SimTK;
 using namespace OpenSim;
 
 
+// remove the whitespace from an expression
+static std::string removeWhitespace(std::string expression)
+{
+    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
+                        expression.end() );
+    return expression;
+}
+
 // string formatting helper utility
 
 template <typename T>
@@ -158,12 +164,13 @@ void ExpressionBasedBushingForce::extendFinalizeFromProperties()
     Super::extendFinalizeFromProperties(); // base class first
 
     // must initialize the 6 force functions using the user provided expressions
-    setMxExpression(get_Mx_expression());
-    setMyExpression(get_My_expression());
-    setMzExpression(get_Mz_expression());
-    setFxExpression(get_Fx_expression());
-    setFyExpression(get_Fy_expression());
-    setFzExpression(get_Fz_expression());
+    set_Mx_expression(removeWhitespace(get_Mx_expression()));
+    set_My_expression(removeWhitespace(get_My_expression()));
+    set_Mz_expression(removeWhitespace(get_Mz_expression()));
+    set_Fx_expression(removeWhitespace(get_Fx_expression()));
+    set_Fy_expression(removeWhitespace(get_Fy_expression()));
+    set_Fz_expression(removeWhitespace(get_Fz_expression()));
+    compileExpressions();
 
     // fill damping matrix with damping from vector property
     for (int i = 0; i<3; i++) {
@@ -172,59 +179,57 @@ void ExpressionBasedBushingForce::extendFinalizeFromProperties()
     }
 }
 
-/** Set the expression for the Mx function and create it's lepton program */
+void ExpressionBasedBushingForce::compileExpressions()
+{
+    // The six expressions are evaluated together, so that the
+    // subexpressions they share are computed only once.
+    _program = MultiExpressionProgram(
+        { get_Mx_expression(), get_My_expression(), get_Mz_expression(),
+          get_Fx_expression(), get_Fy_expression(), get_Fz_expression() },
+        { "theta_x", "theta_y", "theta_z",
+          "delta_x", "delta_y", "delta_z" });
+}
+
+/** Set the expression for the Mx function and compile the expressions */
 void ExpressionBasedBushingForce::setMxExpression(std::string expression) 
 {
-    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
-                        expression.end() );
-    set_Mx_expression(expression);
-    MxProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    set_Mx_expression(removeWhitespace(expression));
+    compileExpressions();
 }
 
-/** Set the expression for the My function and create it's lepton program */
+/** Set the expression for the My function and compile the expressions */
 void ExpressionBasedBushingForce::setMyExpression(std::string expression) 
 {
-    
-    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
-                        expression.end() );
-    set_My_expression(expression);
-    MyProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    set_My_expression(removeWhitespace(expression));
+    compileExpressions();
 }
 
-/** Set the expression for the Mz function and create it's lepton program */
+/** Set the expression for the Mz function and compile the expressions */
 void ExpressionBasedBushingForce::setMzExpression(std::string expression) 
 {
-    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
-                        expression.end() );
-    set_Mz_expression(expression);
-    MzProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    set_Mz_expression(removeWhitespace(expression));
+    compileExpressions();
 }
 
-/** Set the expression for the Fx function and create it's lepton program */
+/** Set the expression for the Fx function and compile the expressions */
 void ExpressionBasedBushingForce::setFxExpression(std::string expression) 
 {
-    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
-                        expression.end() );
-    set_Fx_expression(expression);
-    FxProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    set_Fx_expression(removeWhitespace(expression));
+    compileExpressions();
 }
 
-/** Set the expression for the Fy function and create it's lepton program */
+/** Set the expression for the Fy function and compile the expressions */
 void ExpressionBasedBushingForce::setFyExpression(std::string expression) 
 {
-    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
-                        expression.end() );
-    set_Fy_expression(expression);
-    FyProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    set_Fy_expression(removeWhitespace(expression));
+    compileExpressions();
 }
 
-/** Set the expression for the Fz function and create it's lepton program */
+/** Set the expression for the Fz function and compile the expressions */
 void ExpressionBasedBushingForce::setFzExpression(std::string expression) 
 {
-    expression.erase( remove_if(expression.begin(), expression.end(), ::isspace), 
-                        expression.end() );
-    set_Fz_expression(expression);
-    FzProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    set_Fz_expression(removeWhitespace(expression));
+    compileExpressions();
 }
 //=============================================================================
 // COMPUTATION
@@ -237,23 +242,10 @@ SimTK::Vec6 ExpressionBasedBushingForce::
     // the deviation of the two frames measured by dq
     Vec6 dq = computeDeflection(s);
 
+    // the deflections are the variables theta_x, theta_y, theta_z, delta_x,
+    // delta_y, delta_z of the expressions, in that order
     Vec6 fk = Vec6(0.0);
-
-    std::map<std::string, double> deflectionVars;
-    deflectionVars["theta_x"] = dq[0];
-    deflectionVars["theta_y"] = dq[1];
-    deflectionVars["theta_z"] = dq[2];
-    deflectionVars["delta_x"] = dq[3];
-    deflectionVars["delta_y"] = dq[4];
-    deflectionVars["delta_z"] = dq[5];
-
-
-    fk[0] = MxProg.evaluate(deflectionVars);
-    fk[1] = MyProg.evaluate(deflectionVars);
-    fk[2] = MzProg.evaluate(deflectionVars);
-    fk[3] = FxProg.evaluate(deflectionVars);
-    fk[4] = FyProg.evaluate(deflectionVars);
-    fk[5] = FzProg.evaluate(deflectionVars);
+    _program.evaluate(&dq[0], &fk[0]);
 
     return -fk;
 }
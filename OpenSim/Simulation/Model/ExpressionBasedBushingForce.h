@@ -27,6 +27,7 @@
 // INCLUDE
 #include "Force.h"
 #include <OpenSim/Simulation/Model/TwoFrameLinker.h>
+#include <OpenSim/Simulation/Model/MultiExpressionProgram.h>
 
 namespace OpenSim {
 
@@ -237,11 +238,13 @@ private:
 
     void setNull();
     void constructProperties();
+    // compile the six expressions into _program
+    void compileExpressions();
 
     SimTK::Mat66 _dampingMatrix{ 0.0 };
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram MxProg, MyProg, MzProg, FxProg, FyProg, FzProg;
+    // parser program for efficiently evaluating the expressions together
+    MultiExpressionProgram _program;
 
 //==============================================================================
 };  // END of class ExpressionBasedBushingForce
@@ -24,7 +24,7 @@
  * -------------------------------------------------------------------------- */
 // INCLUDE
 #include "Force.h"
-#include <Vendors/lepton/include/lepton/ExpressionProgram.h>
+#include "MultiExpressionProgram.h"
 
 namespace OpenSim {
 
@@ -126,8 +126,8 @@ private:
     void setNull();
     void constructProperties();
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram _forceProg;
+    // parser program for efficiently evaluating the expression of q and qdot
+    MultiExpressionProgram _forceProg;
 
     // Corresponding generalized coordinate to which the force
     // is applied.
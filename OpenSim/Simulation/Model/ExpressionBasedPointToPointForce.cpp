@@ -26,8 +26,6 @@
 //=============================================================================
 #include "ExpressionBasedPointToPointForce.h"
 #include <OpenSim/Simulation/Model/Model.h>
-#include <Vendors/lepton/include/lepton/Parser.h>
-#include <Vendors/lepton/include/lepton/ParsedExpression.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -130,7 +128,7 @@ void ExpressionBasedPointToPointForce::extendConnectToModel(Model& model)
             remove_if(expression.begin(), expression.end(), ::isspace), 
                       expression.end() );
     
-    _forceProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    _forceProg = MultiExpressionProgram({ expression }, { "d", "ddot" });
 }
 
 //=============================================================================
@@ -180,11 +178,9 @@ void ExpressionBasedPointToPointForce::computeForce(const SimTK::State& s,
     //speed along the line connecting the two bodies
     const double ddot = dot(vRel, r_G)/d;
 
-    std::map<std::string, double> forceVars;
-    forceVars["d"] = d;
-    forceVars["ddot"] = ddot;
-
-    double forceMag = _forceProg.evaluate(forceVars);
+    const Vec2 forceVars(d, ddot);
+    double forceMag;
+    _forceProg.evaluate(&forceVars[0], &forceMag);
     setCacheVariableValue<double>(s, "force_magnitude", forceMag);
 
     const Vec3 f1_G = (forceMag/d) * r_G;
@@ -24,7 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "Force.h"
-#include <Vendors/lepton/include/lepton/ExpressionProgram.h>
+#include "MultiExpressionProgram.h"
 
 namespace SimTK {
 class MobilizedBody;
@@ -169,8 +169,8 @@ private:
     void setNull();
     void constructProperties();
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram _forceProg;
+    // parser program for efficiently evaluating the expression of d and ddot
+    MultiExpressionProgram _forceProg;
 
     // Temporary solution until implemented with Sockets
     SimTK::ReferencePtr<const PhysicalFrame> _body1;
@@ -138,6 +138,9 @@ void ExternalForce::constructProperties()
 void ExternalForce::setDataSource(const Storage &dataSource)
 { 
     _dataSource = &dataSource;
+    // Fit the functions again even if it is the same Storage, in case its
+    // data were changed.
+    _dataFunctions.reset();
 
     cout << "ExternalForce::" << getName() << endl;
     cout << "Data source being set to " << _dataSource->getName() << endl;
@@ -201,6 +204,27 @@ void ExternalForce::extendConnectToModel(Model& model)
          set_data_source_name(_dataSource->getName());
     }
 
+    // have to apply either a force or a torque
+    if(!_appliesForce && !_appliesTorque)
+        throw(Exception("ExternalForce:"+getName()+" does not apply neither a force nor a torque.")); 
+
+    // if a force is not being applied then specifying a point makes no sense
+    if(!_appliesForce && _specifiesPoint)
+        throw(Exception("ExternalForce:"+getName()+" Point is specified for no applied force.")); 
+
+    // Copies of this force (e.g., in a cloned model) share the functions
+    // already fitted to the same data, so they need not fit them again.
+    if (_dataFunctions && _dataFunctions->dataSource == _dataSource &&
+            _dataFunctions->numTimes == _dataSource->getSize() &&
+            _dataFunctions->forceIdentifier ==
+                (_appliesForce ? get_force_identifier() : "") &&
+            _dataFunctions->pointIdentifier ==
+                (_specifiesPoint ? get_point_identifier() : "") &&
+            _dataFunctions->torqueIdentifier ==
+                (_appliesTorque ? get_torque_identifier() : ""))
+        return;
+    _dataFunctions.reset();
+
     // temporary data arrays
     Array<double> time;
     Array<Array<double> > force;
@@ -213,15 +237,6 @@ void ExternalForce::extendConnectToModel(Model& model)
     if( nt < 1)
         throw(Exception("ExternalForce: No times found in data source: "+_dataSource->getName()));
 
-    // have to apply either a force or a torque
-    if(!_appliesForce && !_appliesTorque)
-        throw(Exception("ExternalForce:"+getName()+" does not apply neither a force nor a torque.")); 
-
-    // if a force is not being applied then specifying a point makes no sense
-    if(!_appliesForce && _specifiesPoint)
-        throw(Exception("ExternalForce:"+getName()+" Point is specified for no applied force.")); 
-
-    
     if(_appliesForce){ // if applying force MUST have 3 components
         _dataSource->getDataForIdentifier(get_force_identifier(), force);
         if(force.getSize() != 3)
@@ -246,63 +261,44 @@ void ExternalForce::extendConnectToModel(Model& model)
             "\n. Please make sure data file contains exactly 3 unique columns with this common prefix."));
     }
 
-    // clear out functions from previous data source
-    _forceFunctions.clearAndDestroy();
-    _pointFunctions.clearAndDestroy();
-    _torqueFunctions.clearAndDestroy();
-
     // Create functions now that we should have good data remaining
+    auto functions = std::make_shared<DataFunctions>();
+    functions->dataSource = _dataSource;
+    functions->numTimes = _dataSource->getSize();
     if(_appliesForce){
-        for(int i=0; i<3; ++i){
-            switch(nt) {
-                case 1 :
-                    _forceFunctions.append(new Constant(force[i][0]));
-                    break;
-                case 2 :
-                    _forceFunctions.append(new PiecewiseLinearFunction(force[i].getSize(), &time[0], &(force[i][0])) );
-                    break;
-                case 3 :
-                    _forceFunctions.append(new PiecewiseLinearFunction(force[i].getSize(), &time[0], &(force[i][0])) );
-                    break;
-                default:
-                    _forceFunctions.append(new GCVSpline( 3, force[i].getSize(), &time[0], &(force[i][0])) );
-            }   
-        }
+        functions->forceIdentifier = get_force_identifier();
+        functions->forceIndex = functions->functions.getSize();
+        for(int i=0; i<3; ++i)
+            functions->functions.adoptAndAppend(createFunction(time, force[i]));
 
         if(_specifiesPoint){
-            for(int i=0; i<3; ++i){
-                switch(nt) {
-                case 1:
-                    _pointFunctions.append(new Constant(point[i][0]));
-                    break;
-                case 2:
-                    _pointFunctions.append(new PiecewiseLinearFunction(point[i].getSize(), &time[0], &(point[i][0])) );
-                    break;
-                case 3:
-                    _pointFunctions.append(new PiecewiseLinearFunction(point[i].getSize(), &time[0], &(point[i][0])) );
-                    break;
-                default:
-                    _pointFunctions.append(new GCVSpline( 3, point[i].getSize(), &time[0], &(point[i][0])) );
-                }
-            }
+            functions->pointIdentifier = get_point_identifier();
+            functions->pointIndex = functions->functions.getSize();
+            for(int i=0; i<3; ++i)
+                functions->functions.adoptAndAppend(
+                    createFunction(time, point[i]));
         }
     }
     if(_appliesTorque){
-        for(int i=0; i<3; ++i){
-            switch(nt) {
-                case 1:
-                    _torqueFunctions.append(new Constant(torque[i][0]));
-                    break;
-                case 2:
-                    _torqueFunctions.append(new PiecewiseLinearFunction(torque[i].getSize(), &time[0], &(torque[i][0])) );
-                    break;
-                case 3:
-                    _torqueFunctions.append(new PiecewiseLinearFunction(torque[i].getSize(), &time[0], &(torque[i][0])) );
-                    break;
-                default:
-                    _torqueFunctions.append(new GCVSpline( 3, torque[i].getSize(), &time[0], &(torque[i][0])) );
-            }
-        }
+        functions->torqueIdentifier = get_torque_identifier();
+        functions->torqueIndex = functions->functions.getSize();
+        for(int i=0; i<3; ++i)
+            functions->functions.adoptAndAppend(createFunction(time, torque[i]));
+    }
+    _dataFunctions = functions;
+}
+
+Function* ExternalForce::createFunction(const Array<double>& time,
+                                        const Array<double>& values)
+{
+    switch(time.getSize()) {
+        case 1 :
+            return new Constant(values[0]);
+        case 2 :
+        case 3 :
+            return new PiecewiseLinearFunction(values.getSize(), &time[0], &values[0]);
+        default:
+            return new GCVSpline( 3, values.getSize(), &time[0], &values[0]);
     }
 }
 
@@ -321,20 +317,21 @@ void ExternalForce::computeForce(const SimTK::State& state,
 
     assert(_appliedToBody!=nullptr);
 
+    // All the components are evaluated together, with one search for the
+    // interval of the time.
+    Vec3 force, point, torque;
+    getDataAtTime(time, force, point, torque);
+
     if (_appliesForce) {
-        Vec3 force = getForceAtTime(time);
         force = _forceExpressedInBody->expressVectorInGround(state, force);
-        Vec3 point(0); // Default is body origin.
         if (_specifiesPoint) {
-            point = getPointAtTime(time);
             point = _pointExpressedInBody->
                 findStationLocationInAnotherFrame(state, point, *_appliedToBody);
-        }
+        } // Otherwise the point is the body origin.
         applyForceToPoint(state, *_appliedToBody, point, force, bodyForces);
     }
 
     if (_appliesTorque) {
-        Vec3 torque = getTorqueAtTime(time);
         torque = _forceExpressedInBody->expressVectorInGround(state, torque);
         applyTorque(state, *_appliedToBody, torque, bodyForces);
     }
@@ -345,47 +342,46 @@ void ExternalForce::computeForce(const SimTK::State& state,
  */
 Vec3 ExternalForce::getForceAtTime(double aTime) const  
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* forceX=NULL;
-    const Function* forceY=NULL;
-    const Function* forceZ=NULL;
-    if (_forceFunctions.size()==3){
-        forceX=_forceFunctions[0];  forceY=_forceFunctions[1];  forceZ=_forceFunctions[2];
-    }
-    Vec3 force(forceX?forceX->calcValue(timeAsVector):0.0, 
-        forceY?forceY->calcValue(timeAsVector):0.0, 
-        forceZ?forceZ->calcValue(timeAsVector):0.0);
-    return force;
+    return getComponentsAtTime(_dataFunctions ? _dataFunctions->forceIndex : -1,
+                               aTime);
 }
 
 Vec3 ExternalForce::getPointAtTime(double aTime) const
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* pointX=NULL;
-    const Function* pointY=NULL;
-    const Function* pointZ=NULL;
-    if (_pointFunctions.size()==3){
-        pointX=_pointFunctions[0];  pointY=_pointFunctions[1];  pointZ=_pointFunctions[2];
-    }
-    Vec3 point(pointX?pointX->calcValue(timeAsVector):0.0, 
-        pointY?pointY->calcValue(timeAsVector):0.0, 
-        pointZ?pointZ->calcValue(timeAsVector):0.0);
-    return point;
+    return getComponentsAtTime(_dataFunctions ? _dataFunctions->pointIndex : -1,
+                               aTime);
 }
 
 Vec3 ExternalForce::getTorqueAtTime(double aTime) const
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* torqueX=NULL;
-    const Function* torqueY=NULL;
-    const Function* torqueZ=NULL;
-    if (_torqueFunctions.size()==3){
-        torqueX=_torqueFunctions[0];    torqueY=_torqueFunctions[1];    torqueZ=_torqueFunctions[2];
-    }
-    Vec3 torque(torqueX?torqueX->calcValue(timeAsVector):0.0, 
-        torqueY?torqueY->calcValue(timeAsVector):0.0, 
-        torqueZ?torqueZ->calcValue(timeAsVector):0.0);
-    return torque;
+    return getComponentsAtTime(
+        _dataFunctions ? _dataFunctions->torqueIndex : -1, aTime);
+}
+
+Vec3 ExternalForce::getComponentsAtTime(int index, double aTime) const
+{
+    if (index < 0) return Vec3(0.0);
+    const GCVSplineSet& functions = _dataFunctions->functions;
+    return Vec3(functions.get(index).calcValue(aTime),
+                functions.get(index+1).calcValue(aTime),
+                functions.get(index+2).calcValue(aTime));
+}
+
+void ExternalForce::getDataAtTime(double aTime, Vec3& rForce, Vec3& rPoint,
+                                  Vec3& rTorque) const
+{
+    rForce = rPoint = rTorque = Vec3(0.0);
+    if (!_dataFunctions) return;
+
+    Array<double> values;
+    _dataFunctions->functions.evaluate(values, 0, aTime);
+    const auto copyComponents = [&values](int index, Vec3& rVec) {
+        if (index >= 0) rVec = Vec3(values[index], values[index+1],
+                                    values[index+2]);
+    };
+    copyComponents(_dataFunctions->forceIndex, rForce);
+    copyComponents(_dataFunctions->pointIndex, rPoint);
+    copyComponents(_dataFunctions->torqueIndex, rTorque);
 }
 
 
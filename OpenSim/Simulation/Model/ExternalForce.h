@@ -24,6 +24,9 @@
  * -------------------------------------------------------------------------- */
 // INCLUDE
 #include "Force.h"
+#include <OpenSim/Common/GCVSplineSet.h>
+
+#include <memory>
 
 namespace OpenSim {
 
@@ -168,6 +171,14 @@ public:
     SimTK::Vec3 getForceAtTime(double aTime) const;
     SimTK::Vec3 getPointAtTime(double aTime) const;
     SimTK::Vec3 getTorqueAtTime(double aTime) const;
+    /**
+     * Get the force, point and torque at a given time together. Their
+     * components are all fit to the times of the data source, so the interval
+     * of aTime is searched for once for all of them. The components that this
+     * force does not apply are set to zero.
+     */
+    void getDataAtTime(double aTime, SimTK::Vec3& rForce, SimTK::Vec3& rPoint,
+                       SimTK::Vec3& rTorque) const;
 
     /**
      * Methods used for reporting.
@@ -223,6 +234,13 @@ private:
     void setNull();
     void constructProperties();
 
+    // Fit a function of time to one component of the data.
+    static Function* createFunction(const Array<double>& time,
+                                    const Array<double>& values);
+    // The x, y and z components of the data starting at the given index of
+    // the functions, or zero if the index is -1.
+    SimTK::Vec3 getComponentsAtTime(int index, double aTime) const;
+
 
 //==============================================================================
 // DATA
@@ -247,10 +265,25 @@ private:
     bool _specifiesPoint;
     bool _appliesTorque;
 
-    /** force data as a function of time used internally */
-    ArrayPtrs<Function> _forceFunctions;
-    ArrayPtrs<Function> _torqueFunctions;
-    ArrayPtrs<Function> _pointFunctions;
+    /** force data as a function of time used internally, along with the
+        data they were fitted to. */
+    struct DataFunctions {
+        const Storage* dataSource;
+        int numTimes;
+        std::string forceIdentifier;
+        std::string pointIdentifier;
+        std::string torqueIdentifier;
+        // The x, y and z components of the force, point and torque, in this
+        // order, evaluated together. The index of the x component of each is
+        // -1 if the force does not have it.
+        GCVSplineSet functions;
+        int forceIndex = -1;
+        int pointIndex = -1;
+        int torqueIndex = -1;
+    };
+    /** The functions are not modified once fitted, so copies of this force
+        share them instead of copying the splines. */
+    std::shared_ptr<const DataFunctions> _dataFunctions;
 
     friend class ExternalLoads;
 //==============================================================================
@@ -132,6 +132,7 @@ void ExternalLoads::copyData(const ExternalLoads &aAbsExternalLoads)
     _dataFileName = aAbsExternalLoads._dataFileName;
     _externalLoadsModelKinematicsFileName = aAbsExternalLoads._externalLoadsModelKinematicsFileName;
     _lowpassCutoffFrequencyForLoadKinematics = aAbsExternalLoads._lowpassCutoffFrequencyForLoadKinematics;
+    _dataSource = aAbsExternalLoads._dataSource;
 }
 
 //_____________________________________________________________________________
@@ -186,9 +187,15 @@ ExternalLoads& ExternalLoads::operator=(const ExternalLoads &otherExternalLoads)
     return(*this);
 }
 
+void ExternalLoads::setDataSource(const Storage& dataSource)
+{
+    _dataSource = std::make_shared<const Storage>(dataSource);
+}
+
 void ExternalLoads::invokeConnectToModel(Model& aModel)
 {
-    Storage *forceData = new Storage(_dataFileName);
+    Storage *forceData = _dataSource ? new Storage(*_dataSource)
+                                     : new Storage(_dataFileName);
 
     for(int i=0; i<getSize(); ++i)
         get(i).setDataSource(*forceData);
@@ -220,34 +227,63 @@ void ExternalLoads::invokeConnectToModel(Model& aModel)
  */
 void ExternalLoads::transformPointsExpressedInGroundToAppliedBodies(const Storage &kinematics, double startTime, double endTime)
 {
+    vector<const ExternalForce*> exForces;
+    for(int i=0; i<getSize(); i++)
+        exForces.push_back(&get(i));
+
+    // Position the model once per instant for all the forces.
+    vector<ExternalForce*> transformedExfs =
+        transformPointsExpressedInGroundToAppliedBodies(exForces, kinematics,
+                                                        startTime, endTime);
     for(int i=0; i<getSize(); i++){
-        ExternalForce *transformedExf = transformPointExpressedInGroundToAppliedBody(get(i), kinematics, startTime, endTime);
-        if(transformedExf){
+        if(transformedExfs[i]){
             // replace the force
-            set(i, transformedExf);
+            set(i, transformedExfs[i]);
         }
     }
 }
 
 ExternalForce* ExternalLoads::transformPointExpressedInGroundToAppliedBody(const ExternalForce &exForce, const Storage &kinematics, double startTime, double endTime)
 {
+    return transformPointsExpressedInGroundToAppliedBodies(
+        vector<const ExternalForce*>(1, &exForce), kinematics,
+        startTime, endTime)[0];
+}
+
+vector<ExternalForce*> ExternalLoads::
+transformPointsExpressedInGroundToAppliedBodies(
+        const vector<const ExternalForce*>& exForces,
+        const Storage &kinematics, double startTime, double endTime)
+{
+    vector<ExternalForce*> transformedExfs(exForces.size(), nullptr);
+    if(exForces.empty())
+        return transformedExfs;
+
     if(!hasModel() || !getModel().isValidSystem()) // no model and no system underneath, cannot proceed
         throw Exception("ExternalLoads::transformPointExpressedInGroundToAppliedBody() requires a model with a valid system."); 
 
-    if(!exForce._specifiesPoint){ // The external force does not apply a force to a point
-        cout << "ExternalLoads: WARNING ExternalForce '"<< exForce.getName() <<"' does not specify a point of application." << endl;
-        return NULL;
-    }
+    // The forces whose point can be transformed.
+    vector<int> transformed;
+    for(int f=0; f<(int)exForces.size(); ++f){
+        const ExternalForce& exForce = *exForces[f];
+        if(!exForce._specifiesPoint){ // The external force does not apply a force to a point
+            cout << "ExternalLoads: WARNING ExternalForce '"<< exForce.getName() <<"' does not specify a point of application." << endl;
+            continue;
+        }
 
-    if (exForce.getPointExpressedInBodyName() != getModel().getGround().getName()){
-        cout << "ExternalLoads: WARNING ExternalForce '"<< exForce.getName() <<"' is not expressed in ground and will not be transformed." << endl;
-        return NULL;
-    }
+        if (exForce.getPointExpressedInBodyName() != getModel().getGround().getName()){
+            cout << "ExternalLoads: WARNING ExternalForce '"<< exForce.getName() <<"' is not expressed in ground and will not be transformed." << endl;
+            continue;
+        }
 
-    if (exForce.getAppliedToBodyName() == getModel().getGround().getName()){
-        cout << "ExternalLoads: WARNING ExternalForce '"<< exForce.getName() <<"' is applied to a point on ground and will not be transformed." << endl;
-        return NULL;
+        if (exForce.getAppliedToBodyName() == getModel().getGround().getName()){
+            cout << "ExternalLoads: WARNING ExternalForce '"<< exForce.getName() <<"' is applied to a point on ground and will not be transformed." << endl;
+            continue;
+        }
+        transformed.push_back(f);
     }
+    if(transformed.empty())
+        return transformedExfs;
 
     int nq = getModel().getNumCoordinates();
     int nt = kinematics.getSize();
@@ -271,44 +307,48 @@ ExternalForce* ExternalLoads::transformPointExpressedInGroundToAppliedBody(const
     else{
         cout << "ExternalLoads: WARNING specified load kinematics contains no coordinate values. " 
             << "Point of force application cannot be transformed." << endl;
-        return NULL;
+        return transformedExfs;
     }
 
     nt = lastIndex-startIndex+1;
 
-    // Construct a new storage to contain the re-expressed point data for the 
-    // new external force.
-    Storage *newDataSource = new Storage(nt);
-    Array<string> labels;
-    labels.append("time");
-
-    const string &forceIdentifier = exForce.getForceIdentifier();
-    const string &pointIdentifier = exForce.getPointIdentifier();
-    const string &torqueIdentifier = exForce.getTorqueIdentifier();
-
-    labels.append(forceIdentifier + ".x");
-    labels.append(forceIdentifier + ".y");
-    labels.append(forceIdentifier + ".z");
-    labels.append(pointIdentifier + ".x");
-    labels.append(pointIdentifier + ".y");
-    labels.append(pointIdentifier + ".z");
-    if(exForce._appliesTorque){
-        labels.append(torqueIdentifier + ".x");
-        labels.append(torqueIdentifier + ".y");
-        labels.append(torqueIdentifier + ".z");
-    }
+    // Construct a new storage to contain the re-expressed point data for
+    // each new external force.
+    vector<Storage*> newDataSources;
+    for(int f : transformed){
+        const ExternalForce& exForce = *exForces[f];
+        Storage *newDataSource = new Storage(nt);
+        Array<string> labels;
+        labels.append("time");
+
+        const string &forceIdentifier = exForce.getForceIdentifier();
+        const string &pointIdentifier = exForce.getPointIdentifier();
+        const string &torqueIdentifier = exForce.getTorqueIdentifier();
+
+        labels.append(forceIdentifier + ".x");
+        labels.append(forceIdentifier + ".y");
+        labels.append(forceIdentifier + ".z");
+        labels.append(pointIdentifier + ".x");
+        labels.append(pointIdentifier + ".y");
+        labels.append(pointIdentifier + ".z");
+        if(exForce._appliesTorque){
+            labels.append(torqueIdentifier + ".x");
+            labels.append(torqueIdentifier + ".y");
+            labels.append(torqueIdentifier + ".z");
+        }
 
-    newDataSource->setColumnLabels(labels);
-    int ncols = labels.getSize()-1; // time treated separately when appended to storage
+        newDataSource->setColumnLabels(labels);
+        newDataSources.push_back(newDataSource);
+    }
 
-    SimTK::Vector datarow(ncols, SimTK::NaN);
+    SimTK::Vector datarow(9, SimTK::NaN);
 
     double time = 0;
-    Array<double> Q(0.0,nq);
+    SimTK::Vector Q(nq, 0.0);
 
-    Vec3 pGround(SimTK::NaN);
     Vec3 pAppliedBody(SimTK::NaN);
     Vec3 force(SimTK::NaN); 
+    Vec3 pGround(SimTK::NaN);
     Vec3 torque(SimTK::NaN);
     
     // Checked that we had a model with a valid system, so get its working state
@@ -316,64 +356,60 @@ ExternalForce* ExternalLoads::transformPointExpressedInGroundToAppliedBody(const
 
     // get from (ground) and to (applied) bodies 
     const Ground& ground = getModel().getGround();
-    const Body& appliedToBody = getModel().getBodySet().get(exForce.getAppliedToBodyName());
-
-    /*std::map<int, int>      coordinatesToColumns;
-    // create a map entry for each coordinate 0 to nq-1, the contents of which would be -1 if not found in the file otherwise Q index
-    for (int qi=0; qi < nq; qi++) coordinatesToColumns[qi] = -1;
-    const Array<string>& kinLabels = kinematics.getColumnLabels();
-
-    for (int qj = 0; qj < nq; qj++) {
-        Coordinate& coord = _model->getCoordinateSet().get(qj);
-        int idx = kinLabels.findIndex(coord.getName());
-        if (idx!= -1) coordinatesToColumns[qj] = idx-1; // Since time is not accounted for
-    }*/
+    vector<const Body*> appliedToBodies;
+    for(int f : transformed)
+        appliedToBodies.push_back(&getModel().getBodySet().get(
+            exForces[f]->getAppliedToBodyName()));
+
     for(int i=startIndex; i<=lastIndex; ++i) {
         // transform data on an instant-by-instant basis
         kinematics.getTime(i, time);
         kinematics.getData(i, nq, &Q[0]);
 
         // Set the coordinates values in the state in order to position the model according to specified kinematics
-        for (int j = 0; j < nq; j++) {
-            Coordinate& coord = getModel().getCoordinateSet().get(j);
-            coord.setValue(s, Q[j], j==nq-1);
-            /*if (coordinatesToColumns[j]!=-1)
-                coord.setValue(s, Q[coordinatesToColumns[j]], j==nq-1);*/
-        }
+        getModel().getCoordinateSet().setValues(s, Q);
+
+        for(int k=0; k<(int)transformed.size(); ++k){
+            const ExternalForce& exForce = *exForces[transformed[k]];
+
+            // get the force data and the untransformed point expressed in
+            // ground in the ExternalForce specified in ground (check made above)
+            exForce.getDataAtTime(time, force, pGround, torque);
+            pAppliedBody = ground.findStationLocationInAnotherFrame(s, pGround,
+                                                        *appliedToBodies[k]);
 
-        // get force data
-        force = exForce.getForceAtTime(time);
-        if(exForce._appliesTorque)
-            torque = exForce.getTorqueAtTime(time);
-        
-        // get the untransformed point expressed in ground in the ExternalForce specified in  ground (check made above)
-        pGround = exForce.getPointAtTime(time);
-        pAppliedBody = ground.findStationLocationInAnotherFrame(s, pGround, appliedToBody);
-
-        // populate the force data for this instant in time
-        for(int j =0; j<3; ++j){
-            datarow[j] = force[j];
-            datarow[j+3] = pAppliedBody[j];
-            if(exForce._appliesTorque)
+            // populate the force data for this instant in time
+            for(int j =0; j<3; ++j){
+                datarow[j] = force[j];
+                datarow[j+3] = pAppliedBody[j];
                 datarow[j+6] = torque[j];
-        }
+            }
 
-        newDataSource->append(time, datarow); 
+            const int ncols = exForce._appliesTorque ? 9 : 6;
+            newDataSources[k]->append(time, ncols, &datarow[0]);
+        }
     }
 
-    // assign a name to the new data source
-    newDataSource->setName(exForce.getDataSourceName() + "_transformedP");
+    for(int k=0; k<(int)transformed.size(); ++k){
+        const ExternalForce& exForce = *exForces[transformed[k]];
+        Storage* newDataSource = newDataSources[k];
 
-    ExternalForce *exF_transformedPoint = exForce.clone();
-    exF_transformedPoint->setName(exForce.getName()+"_transformedP");
-    exF_transformedPoint->setPointExpressedInBodyName(exForce.getAppliedToBodyName());
-    exF_transformedPoint->setDataSource(*newDataSource);
+        // assign a name to the new data source
+        newDataSource->setName(exForce.getDataSourceName() + "_transformedP");
 
-    _storages.append(newDataSource);
+        ExternalForce *exF_transformedPoint = exForce.clone();
+        exF_transformedPoint->setName(exForce.getName()+"_transformedP");
+        exF_transformedPoint->setPointExpressedInBodyName(exForce.getAppliedToBodyName());
+        exF_transformedPoint->setDataSource(*newDataSource);
 
-    newDataSource->print("NewDataSource_TransformedP.sto");
+        _storages.append(newDataSource);
+
+        newDataSource->print("NewDataSource_TransformedP.sto");
+
+        transformedExfs[transformed[k]] = exF_transformedPoint;
+    }
 
-    return exF_transformedPoint;
+    return transformedExfs;
 }
 
 //-----------------------------------------------------------------------------
@@ -30,6 +30,9 @@
 #include "OpenSim/Common/PropertyStr.h"
 #include "OpenSim/Common/PropertyDbl.h"
 
+#include <memory>
+#include <vector>
+
 namespace OpenSim {
 
 class Model;
@@ -86,6 +89,10 @@ private:
        with the transformed point data. Hang-on to them so we can delete them. */
     ArrayPtrs<Storage> _storages;
 
+    /* Data given in memory with setDataSource(), used in place of the data
+       file when set. It is shared by copies of this ExternalLoads. */
+    std::shared_ptr<const Storage> _dataSource;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -111,6 +118,17 @@ public:
     const std::string& getDataFileName() const { return _dataFileName;};
     void setDataFileName(const std::string& aNewFile) { _dataFileName = aNewFile; };
 
+    /** Use the given data for all forces in place of the data file, e.g.,
+        the force plate data of a C3D file converted with
+        Storage(const TimeSeriesTable&) after flattening, without writing it
+        to a file first. A copy of the data is kept. The data file name is
+        ignored until clearDataSource() is called. */
+    void setDataSource(const Storage& dataSource);
+    /** Whether data was given with setDataSource(). */
+    bool hasDataSource() const { return _dataSource != nullptr; }
+    /** Go back to reading the data from the data file. */
+    void clearDataSource() { _dataSource.reset(); }
+
     const std::string &getExternalLoadsModelKinematicsFileName() const { return _externalLoadsModelKinematicsFileName; }
     void setExternalLoadsModelKinematicsFileName(const std::string &aFileName) { _externalLoadsModelKinematicsFileName = aFileName; }
     double getLowpassCutoffFrequencyForLoadKinematics() const { return _lowpassCutoffFrequencyForLoadKinematics; }
@@ -122,6 +140,12 @@ public:
 private:
     void setNull();
     void setupSerializedMembers();
+    // Transform the points of the given forces together, positioning the
+    // model once per instant of the kinematics. Each entry of the result is
+    // the transformed force, or null if its point was not transformed.
+    std::vector<ExternalForce*> transformPointsExpressedInGroundToAppliedBodies(
+        const std::vector<const ExternalForce*>& exForces,
+        const Storage &kinematics, double startTime, double endTime);
     std::string createIdentifier(OpenSim::Array<std::string>&oldFunctionNames, const Array<std::string>& labels);
 
     //--------------------------------------------------------------------------
@@ -25,6 +25,8 @@
 #include "Model.h"
 #include <OpenSim/Simulation/Model/ForceAdapter.h>
 
+#include <algorithm>
+
 
 using namespace SimTK;
 
@@ -148,6 +150,14 @@ bool Force::appliesForce(const SimTK::State& s) const
     return get_appliesForce();
 }
 
+void Force::writeRecordValues(const SimTK::State& state,
+                              double* values) const
+{
+    const Array<double> recordValues = getRecordValues(state);
+    std::copy(recordValues.get(), recordValues.get() + recordValues.getSize(),
+              values);
+}
+
 //-----------------------------------------------------------------------------
 // ABSTRACT METHODS
 //-----------------------------------------------------------------------------
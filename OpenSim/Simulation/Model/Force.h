@@ -99,6 +99,22 @@ public:
     getRecordValues(const SimTK::State& state) const {
         return OpenSim::Array<double>();
     };
+    /**
+     * The number of values reported by getRecordValues(), which must not
+     * change after the model is connected. The default calls
+     * getRecordLabels(); frequently reported Forces override it.
+     */
+    virtual int getNumRecordValues() const {
+        return getRecordLabels().getSize();
+    }
+    /**
+     * Write the values of getRecordValues() to `values`, which has room for
+     * getNumRecordValues() values, e.g., straight into a row of a report.
+     * The default copies the Array returned by getRecordValues(); Forces
+     * that are reported often override it to avoid allocating the Array.
+     */
+    virtual void writeRecordValues(const SimTK::State& state,
+                                   double* values) const;
 
 
     /** Return a flag indicating whether the Force is applied along a Path. If
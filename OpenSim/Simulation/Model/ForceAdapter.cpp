@@ -46,6 +46,7 @@ void ForceAdapter::calcForce(const SimTK::State& state,
     SimTK::Vector_<SimTK::SpatialVec>& bodyForces,SimTK::Vector_<SimTK::Vec3>& particleForces,
     SimTK::Vector& mobilityForces) const
 {
+    ComponentProfiler::Timer timer(_force, ComponentProfiler::ComputeForce);
     _force->computeForce(state, bodyForces, mobilityForces);
 }
 
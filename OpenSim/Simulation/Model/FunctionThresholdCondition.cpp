@@ -88,7 +88,12 @@ FunctionThresholdCondition::FunctionThresholdCondition(const FunctionThresholdCo
 void FunctionThresholdCondition::copyData(const FunctionThresholdCondition &aCondition)
 {
     Condition::copyData(aCondition);
-    _function = aCondition._function;
+    // The property owns its function, so each copy needs its own.
+    if (_function != aCondition._function) {
+        delete _function;
+        _function = aCondition._function ? aCondition._function->clone()
+                                         : nullptr;
+    }
     _threshold = aCondition._threshold;
 }
 
@@ -156,5 +161,16 @@ bool FunctionThresholdCondition::calcCondition(const SimTK::State& s) const
     return (_function->calcValue(SimTK::Vector(1, s.getTime())) > _threshold);
 }
 
+double FunctionThresholdCondition::calcWitness(const SimTK::State& s) const
+{
+    return _function->calcValue(SimTK::Vector(1, s.getTime())) - _threshold;
+}
+
+void FunctionThresholdCondition::setFunction(const Function& function)
+{
+    delete _function;
+    _function = function.clone();
+}
+
 //_____________________________________________________________________________
 
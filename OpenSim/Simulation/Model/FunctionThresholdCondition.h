@@ -84,6 +84,17 @@ public:
      */
     bool calcCondition(const SimTK::State& s) const override;
 
+    /** The function of time minus the threshold. */
+    double calcWitness(const SimTK::State& s) const override;
+    SimTK::Stage getWitnessStage() const override
+    {   return SimTK::Stage::Time; }
+
+    /** Set the function of time, of which a copy is kept. */
+    void setFunction(const Function& function);
+    /** Set the threshold above which the condition is true. */
+    void setThreshold(double threshold) { _threshold = threshold; }
+    double getThreshold() const { return _threshold; }
+
 private:
     void setNull();
     void setupProperties();
@@ -27,6 +27,7 @@
 #include <fstream>
 #include "Frame.h"
 #include "Geometry.h"
+#include "MeshCache.h"
 #include "Model.h"
 //=============================================================================
 // STATICS
@@ -215,86 +216,100 @@ void FrameGeometry::implementCreateDecorativeGeometry(SimTK::Array_<SimTK::Decor
 
 void Mesh::extendFinalizeFromProperties() {
 
-    if (!isObjectUpToDateWithProperties()) {
-        const Component* rootModel = nullptr;
-        if (!hasParent()) {
-            std::cout << "Mesh " << get_mesh_file() << " not connected to model..ignoring\n";
-            return;   // Orphan Mesh not part of a model yet
-        }
-        const Component* parent = &getParent();
-        while (parent != nullptr) {
-            if (dynamic_cast<const Model*>(parent) != nullptr) {
-                rootModel = parent;
-                break;
-            }
-            if (parent->hasParent())
-                parent = &(parent->getParent()); // traverse up Component tree
-            else
-                break; // can't traverse up.
-        }
+    if (cachedMesh && cachedMeshFile == get_mesh_file())
+        return;
+    cachedMesh.reset();
+    cachedMeshFile.clear();
+    // The file is found and loaded when the mesh is first drawn, so that
+    // models that are never visualized (e.g., in batch jobs) do not search
+    // for their mesh files at all.
+    attemptedMeshFile.clear();
+}
 
-        if (rootModel == nullptr) {
-            std::cout << "Mesh " << get_mesh_file() << " not connected to model..ignoring\n";
-            return;   // Orphan Mesh not descendant of a model
-        }
-        // Current interface to Visualizer calls generateDecorations on every frame.
-        // On first time through, load file and create DecorativeMeshFile and cache it
-        // so we don't load files from disk during live drawing/rendering.
-        const std::string& file = get_mesh_file();
-        bool isAbsolutePath; string directory, fileName, extension;
-        SimTK::Pathname::deconstructPathname(file,
-            isAbsolutePath, directory, fileName, extension);
-        const string lowerExtension = SimTK::String::toLower(extension);
-        if (lowerExtension != ".vtp" && lowerExtension != ".obj" && lowerExtension != ".stl") {
-            std::cout << "ModelVisualizer ignoring '" << file
-                << "'; only .vtp .stl and .obj files currently supported.\n";
-            return;
+void Mesh::loadMesh() const {
+    const Component* rootModel = nullptr;
+    if (!hasParent()) {
+        std::cout << "Mesh " << get_mesh_file() << " not connected to model..ignoring\n";
+        return;   // Orphan Mesh not part of a model yet
+    }
+    const Component* parent = &getParent();
+    while (parent != nullptr) {
+        if (dynamic_cast<const Model*>(parent) != nullptr) {
+            rootModel = parent;
+            break;
         }
+        if (parent->hasParent())
+            parent = &(parent->getParent()); // traverse up Component tree
+        else
+            break; // can't traverse up.
+    }
 
-        // File is a .vtp or .obj. See if we can find it.
-        Array_<string> attempts;
-        const Model& model = dynamic_cast<const Model&>(*rootModel);
-        bool foundIt = ModelVisualizer::findGeometryFile(model, file, isAbsolutePath, attempts);
-
-        if (!foundIt) {
-            if (getDebugLevel()==0) { return; }
-
-            std::cout << "ModelVisualizer couldn't find file '" << file
-                << "'; tried\n";
-            for (unsigned i = 0; i < attempts.size(); ++i)
-                std::cout << "  " << attempts[i] << "\n";
-            if (!isAbsolutePath &&
-                !Pathname::environmentVariableExists("OPENSIM_HOME"))
-                std::cout << "Set environment variable OPENSIM_HOME "
-                << "to search $OPENSIM_HOME/Geometry.\n";
-            return;
-        }
+    if (rootModel == nullptr) {
+        std::cout << "Mesh " << get_mesh_file() << " not connected to model..ignoring\n";
+        return;   // Orphan Mesh not descendant of a model
+    }
+    // Current interface to Visualizer calls generateDecorations on every frame.
+    // On first time through, load file and create DecorativeMeshFile and cache it
+    // so we don't load files from disk during live drawing/rendering.
+    const std::string& file = get_mesh_file();
+    bool isAbsolutePath; string directory, fileName, extension;
+    SimTK::Pathname::deconstructPathname(file,
+        isAbsolutePath, directory, fileName, extension);
+    const string lowerExtension = SimTK::String::toLower(extension);
+    if (lowerExtension != ".vtp" && lowerExtension != ".obj" && lowerExtension != ".stl") {
+        std::cout << "ModelVisualizer ignoring '" << file
+            << "'; only .vtp .stl and .obj files currently supported.\n";
+        return;
+    }
 
-        SimTK::PolygonalMesh pmesh;
-        try {
-            std::ifstream objFile;
-            objFile.open(attempts.back().c_str());
-            // objFile closes when destructed
-            // if the file can be opened but had bad contents e.g. binary vtp 
-            // it will be handled downstream 
+    // File is a .vtp or .obj. See if we can find it.
+    Array_<string> attempts;
+    const Model& model = dynamic_cast<const Model&>(*rootModel);
+    bool foundIt = ModelVisualizer::findGeometryFile(model, file, isAbsolutePath, attempts);
+
+    if (!foundIt) {
+        if (getDebugLevel()==0) { return; }
+
+        std::cout << "ModelVisualizer couldn't find file '" << file
+            << "'; tried\n";
+        for (unsigned i = 0; i < attempts.size(); ++i)
+            std::cout << "  " << attempts[i] << "\n";
+        if (!isAbsolutePath &&
+            !Pathname::environmentVariableExists("OPENSIM_HOME"))
+            std::cout << "Set environment variable OPENSIM_HOME "
+            << "to search $OPENSIM_HOME/Geometry.\n";
+        return;
+    }
 
-        }
-        catch (const std::exception& e) {
-            std::cout << "Visualizer couldn't open "
-                << attempts.back() << " because:\n"
-                << e.what() << "\n";
-            return;
-        }
+    SimTK::PolygonalMesh pmesh;
+    try {
+        std::ifstream objFile;
+        objFile.open(attempts.back().c_str());
+        // objFile closes when destructed
+        // if the file can be opened but had bad contents e.g. binary vtp 
+        // it will be handled downstream 
 
-        cachedMesh.reset(new DecorativeMeshFile(attempts.back().c_str()));
     }
-}
+    catch (const std::exception& e) {
+        std::cout << "Visualizer couldn't open "
+            << attempts.back() << " because:\n"
+            << e.what() << "\n";
+        return;
+    }
 
+    cachedMesh = MeshCache::getDecorativeMeshFile(attempts.back());
+    cachedMeshFile = file;
+}
 
 void Mesh::implementCreateDecorativeGeometry(SimTK::Array_<SimTK::DecorativeGeometry>& decoGeoms) const
 {
+    if (!cachedMesh && attemptedMeshFile != get_mesh_file()) {
+        attemptedMeshFile = get_mesh_file();
+        loadMesh();
+    }
     if (cachedMesh.get() != nullptr) {
-        cachedMesh->setScaleFactors(get_scale_factors());
-        decoGeoms.push_back(*cachedMesh);
+        DecorativeMeshFile mesh(*cachedMesh);
+        mesh.setScaleFactors(get_scale_factors());
+        decoGeoms.push_back(mesh);
     }
 }
@@ -590,15 +590,13 @@ public:
 public:
     /// Default constructor
     Mesh() :
-        Geometry(),
-        cachedMesh(nullptr)
+        Geometry()
     {
         constructProperty_mesh_file("");
     }
     /// Constructor that takes a mesh file name
     Mesh(const std::string& geomFile) :
-        Geometry(),
-        cachedMesh(nullptr)
+        Geometry()
     {
         constructProperty_mesh_file("");
         upd_mesh_file() = geomFile;
@@ -619,10 +617,22 @@ protected:
     void implementCreateDecorativeGeometry(
         SimTK::Array_<SimTK::DecorativeGeometry>& decoGeoms) const override;
 private:
+    // Find the mesh file and cache a DecorativeMeshFile for it. This is done
+    // the first time the mesh is drawn.
+    void loadMesh() const;
+
     // We cache the DecorativeMeshFile if we successfully
     // load the mesh from file so we don't try loading from disk every frame.
-    // This is mutable since it is not part of the public interface.
-    mutable SimTK::ResetOnCopy<std::unique_ptr<SimTK::DecorativeMeshFile>> cachedMesh;
+    // The cached mesh is never modified, so copies of this Mesh (e.g., in a
+    // cloned model) share it, and only load the file again if mesh_file was
+    // changed. It comes from the MeshCache, so other models that use the
+    // same file share it too.
+    mutable std::shared_ptr<const SimTK::DecorativeMeshFile> cachedMesh;
+    // The value of mesh_file that cachedMesh was loaded from.
+    mutable std::string cachedMeshFile;
+    // The value of mesh_file that was last looked for, so that a file that
+    // is not found is not looked for again on every frame.
+    mutable std::string attemptedMeshFile;
 };
 
 /**
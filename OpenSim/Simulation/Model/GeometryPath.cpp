@@ -31,6 +31,8 @@
 #include <OpenSim/Simulation/Wrap/PathWrap.h>
 #include "Model.h"
 
+#include <mutex>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -41,6 +43,50 @@ using SimTK::Vec3;
 
 static const Vec3 DefaultDefaultColor(.5,.5,.5); // boring gray 
 
+namespace {
+    // Serializes access to the idle moment-arm solvers of all paths.
+    std::mutex maSolversMutex;
+
+    // Add a force applied at a point given in ground to the body forces, as
+    // MobilizedBody::applyForceToBodyPoint() does for a point given in the
+    // frame of the body.
+    void applyForceToGroundPoint(const SimTK::State& s,
+            const SimTK::MobilizedBody& body, const Vec3& point_G,
+            const Vec3& force_G, Vector_<SpatialVec>& bodyForces)
+    {
+        const Vec3 r_G = point_G - body.getBodyOriginLocation(s);
+        bodyForces[body.getMobilizedBodyIndex()] +=
+            SpatialVec(r_G % force_G, force_G);
+    }
+
+    // Whether two components (path points or path wraps) are alike but for
+    // their names: of the same type, with equal properties, and with their
+    // sockets connected to the same objects.
+    bool haveSameGeometry(const Component& a, const Component& b)
+    {
+        if (a.getConcreteClassName() != b.getConcreteClassName() ||
+                a.getNumProperties() != b.getNumProperties())
+            return false;
+        for (int i = 0; i < a.getNumProperties(); ++i) {
+            const AbstractProperty& property = a.getPropertyByIndex(i);
+            // The connectee names may be relative paths; the connectees
+            // themselves are compared below.
+            if (property.getName().compare(0, 7, "socket_") == 0) continue;
+            if (!(property == b.getPropertyByIndex(i))) return false;
+        }
+        for (const string& name :
+                const_cast<Component&>(a).getSocketNames()) {
+            const AbstractSocket& socket = a.getSocket(name);
+            const AbstractSocket& other = b.getSocket(name);
+            if (!socket.isConnected() || !other.isConnected() ||
+                    &socket.getConnecteeAsObject() !=
+                    &other.getConnecteeAsObject())
+                return false;
+        }
+        return true;
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -66,6 +112,13 @@ void GeometryPath::extendConnectToModel(Model& aModel)
 {
     Super::extendConnectToModel(aModel);
 
+    // The coordinates of the model may have changed; any surrogate of the
+    // length has to be fit again.
+    _lengthSurrogate.reset();
+    // The moment-arm solvers hold states of the System that is about to be
+    // replaced.
+    _maSolvers.clear();
+
     // Name the path points based on the current path
     // (i.e., the set of currently active points is numbered
     // 1, 2, 3, ...).
@@ -83,23 +136,61 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     // Allocate cache entries to save the current length and speed(=d/dt length)
     // of the path in the cache. Length depends only on q's so will be valid
     // after Position stage, speed requires u's also so valid at Velocity stage.
-    addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
-    addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
+    _lengthCV = addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
+    _speedCV = addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
     // Cache the set of points currently defining this path.
     Array<PathPoint *> pathPrototype;
-    addCacheVariable<Array<PathPoint *> >
+    _currentPathCV = addCacheVariable<Array<PathPoint *> >
         ("current_path", pathPrototype, SimTK::Stage::Position);
+    _currentLocationsCV = addCacheVariable<SimTK::Array_<Vec3> >
+        ("current_path_locations", SimTK::Array_<Vec3>(),
+         SimTK::Stage::Position);
 
     // We consider this cache entry valid any time after it has been created
     // and first marked valid, and we won't ever invalidate it.
-    addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
-                                  SimTK::Stage::Topology);
+    _colorCV = addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
+                                             SimTK::Stage::Topology);
+
+    // The points of all paths are connected by now.
+    findSharedPath();
+}
+
+void GeometryPath::findSharedPath() const
+{
+    // That path cannot itself mirror another, which would be identical to
+    // this path too.
+    _sharedPath.clear();
+    for (const auto& path : getModel().getComponentList<GeometryPath>()) {
+        if (&path == this) break;
+        if (isIdenticalTo(path)) {
+            _sharedPath = &path;
+            break;
+        }
+    }
+}
+
+//_____________________________________________________________________________
+/*
+ * Some path points of this path were finalized again within the System.
+ */
+void GeometryPath::extendFinalizeChangesInSystem()
+{
+    Super::extendFinalizeChangesInSystem();
+
+    // The length as a function of the coordinates has changed.
+    _lengthSurrogate.reset();
+    _maSolvers.clear();
+
+    // This path may no longer be identical to the path it mirrors, or to
+    // those that mirror it, so every path looks again for a path to mirror.
+    for (const auto& path : getModel().getComponentList<GeometryPath>())
+        path.findSharedPath();
 }
 
  void GeometryPath::extendInitStateFromProperties(SimTK::State& s) const
 {
     Super::extendInitStateFromProperties(s);
-    markCacheVariableValid(s, "color"); // it is OK at its default value
+    _colorCV.markValid(s); // it is OK at its default value
 }
 
 //------------------------------------------------------------------------------
@@ -125,13 +216,15 @@ generateDecorations(bool fixed, const ModelDisplayHints& hints,
     getModel().realizeDynamics(state);
 
     const Array<PathPoint*>& pathPoints = getCurrentPath(state);
+    const SimTK::Array_<Vec3>& locations = getCurrentPathLocations(state);
+    // The color of the whole path, computed once per frame.
+    const Vec3 color = getColor(state);
 
-    const PathPoint* lastPoint = pathPoints[0];
     MobilizedBodyIndex mbix(0);
 
-    Vec3 lastPos = lastPoint->getLocationInGround(state);
+    Vec3 lastPos = locations[0];
     if (hints.get_show_path_points())
-        DefaultGeometry::drawPathPoint(mbix, lastPos, getColor(state), appendToThis);
+        DefaultGeometry::drawPathPoint(mbix, lastPos, color, appendToThis);
 
     Vec3 pos;
 
@@ -141,7 +234,7 @@ generateDecorations(bool fixed, const ModelDisplayHints& hints,
 
         if (pwp) {
             // A PathWrapPoint provides points on the wrapping surface as Vec3s
-            Array<Vec3>& surfacePoints = pwp->getWrapPath();
+            const Array<Vec3>& surfacePoints = pwp->getWrapPath(state);
             // The surface points are expressed w.r.t. the wrap surface's body frame.
             // Transform the surface points into the ground reference frame to draw
             // the surface point as the wrapping portion of the GeometryPath
@@ -151,24 +244,24 @@ generateDecorations(bool fixed, const ModelDisplayHints& hints,
                 // transform the surface point into the Ground reference frame
                 pos = X_BG*surfacePoints[j];
                 if (hints.get_show_path_points())
-                    DefaultGeometry::drawPathPoint(mbix, pos, getColor(state),
+                    DefaultGeometry::drawPathPoint(mbix, pos, color,
                         appendToThis);
                 // Line segments will be in ground frame
                 appendToThis.push_back(DecorativeLine(lastPos, pos)
                     .setLineThickness(4)
-                    .setColor(getColor(state)).setBodyId(0).setIndexOnBody(j));
+                    .setColor(color).setBodyId(0).setIndexOnBody(j));
                 lastPos = pos;
             }
         } 
         else { // otherwise a regular PathPoint so just draw its location
-            pos = point->getLocationInGround(state);
+            pos = locations[i];
             if (hints.get_show_path_points())
-                DefaultGeometry::drawPathPoint(mbix, pos, getColor(state),
+                DefaultGeometry::drawPathPoint(mbix, pos, color,
                     appendToThis);
             // Line segments will be in ground frame
             appendToThis.push_back(DecorativeLine(lastPos, pos)
                 .setLineThickness(4)
-                .setColor(getColor(state)).setBodyId(0).setIndexOnBody(i));
+                .setColor(color).setBodyId(0).setIndexOnBody(i));
             lastPos = pos;
         }
     }
@@ -219,7 +312,14 @@ const OpenSim::Array <PathPoint*> & GeometryPath::
 getCurrentPath(const SimTK::State& s)  const
 {
     computePath(s);   // compute checks if path needs to be recomputed
-    return getCacheVariableValue< Array<PathPoint*> >(s, "current_path");
+    return _currentPathCV.getValue(s);
+}
+
+const SimTK::Array_<Vec3>& GeometryPath::
+getCurrentPathLocations(const SimTK::State& s) const
+{
+    computePath(s);
+    return _currentLocationsCV.getValue(s);
 }
 
 // get the path as PointForceDirections directions 
@@ -235,13 +335,14 @@ getPointForceDirections(const SimTK::State& s,
     const OpenSim::PhysicalFrame* startBody;
     const OpenSim::PhysicalFrame* endBody;
     const Array<PathPoint*>& currentPath = getCurrentPath(s);
+    const SimTK::Array_<Vec3>& locations = _currentLocationsCV.getValue(s);
 
     int np = currentPath.getSize();
     rPFDs->ensureCapacity(np);
     
     for (i = 0; i < np; i++) {
         PointForceDirection *pfd = 
-            new PointForceDirection(currentPath[i]->getLocation(), 
+            new PointForceDirection(currentPath[i]->getLocation(s), 
                                     currentPath[i]->getBody(), Vec3(0));
         rPFDs->append(pfd);
     }
@@ -254,18 +355,8 @@ getPointForceDirections(const SimTK::State& s,
 
         if (startBody != endBody)
         {
-            Vec3 posStart, posEnd;
-            Vec3 direction(0);
-
-            // Find the positions of start and end in the inertial frame.
-            //engine.getPosition(s, start->getBody(), start->getLocation(), posStart);
-            posStart = start->getLocationInGround(s);
-            
-            //engine.getPosition(s, end->getBody(), end->getLocation(), posEnd);
-            posEnd = end->getLocationInGround(s);
-
             // Form a vector from start to end, in the inertial frame.
-            direction = (posEnd - posStart);
+            Vec3 direction = locations[i+1] - locations[i];
 
             // Check that the two points are not coincident.
             // This can happen due to infeasible wrapping of the path,
@@ -293,11 +384,22 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
     SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
     SimTK::Vector& mobilityForces) const
 {
+    if (isLengthSurrogateInRange(s)) {
+        // The tension does power -tension*~(dL/dq)*qdot = -tension*~(dL/dq)*N*u
+        // so the equivalent mobility forces are -tension*~N*(dL/dq).
+        Vector dLdq(s.getNQ(), 0.0), dLdu;
+        _lengthSurrogate->addInLengthGradient(s, dLdq);
+        getModel().getMatterSubsystem().multiplyByN(s, true, dLdq, dLdu);
+        mobilityForces -= tension*dLdu;
+        return;
+    }
+
     PathPoint* start = NULL;
     PathPoint* end = NULL;
     const SimTK::MobilizedBody* bo = NULL;
     const SimTK::MobilizedBody* bf = NULL;
     const Array<PathPoint*>& currentPath = getCurrentPath(s);
+    const SimTK::Array_<Vec3>& locations = _currentLocationsCV.getValue(s);
     int np = currentPath.getSize();
 
     const SimTK::SimbodyMatterSubsystem& matter = 
@@ -320,8 +422,8 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
 
         if (bo != bf) {
             // Find the positions of start and end in the inertial frame.
-            po = start->getLocationInGround(s);
-            pf = end->getLocationInGround(s);
+            po = locations[i];
+            pf = locations[i+1];
 
             // Form a vector from start to end, in the inertial frame.
             dir = (pf - po);
@@ -340,6 +442,12 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
 
             force = tension*dir;
 
+            // add in the tension point forces to body forces, applied at the
+            // locations of the points in ground, which were computed with the
+            // path, so that the points need not be located again
+            applyForceToGroundPoint(s, *bo, po, force, bodyForces);
+            applyForceToGroundPoint(s, *bf, pf, -force, bodyForces);
+
             const MovingPathPoint* mppo =
                 dynamic_cast<MovingPathPoint *>(start);
 
@@ -347,33 +455,6 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
             const MovingPathPoint* mppf =
                 dynamic_cast<MovingPathPoint *>(end);
 
-            // add in the tension point forces to body forces
-            if (mppo) {// moving path point location is a function of the state
-                // transform of the frame of the point to the base mobilized body
-                auto X_BF = mppo->getParentFrame().findTransformInBaseFrame();
-                bo->applyForceToBodyPoint(s, X_BF*mppo->getLocation(s), force,
-                    bodyForces);
-            }
-            else {
-                // transform of the frame of the point to the base mobilized body
-                auto X_BF = start->getParentFrame().findTransformInBaseFrame();
-                bo->applyForceToBodyPoint(s, X_BF*start->getLocation(), force,
-                    bodyForces);
-            }
-
-            if (mppf) {// moving path point location is a function of the state
-                // transform of the frame of the point to the base mobilized body
-                auto X_BF = mppf->getParentFrame().findTransformInBaseFrame();
-                bf->applyForceToBodyPoint(s, X_BF*mppf->getLocation(s), -force,
-                    bodyForces);
-            }
-            else {
-                // transform of the frame of the point to the base mobilized body
-                auto X_BF = end->getParentFrame().findTransformInBaseFrame();
-                bf->applyForceToBodyPoint(s, X_BF*end->getLocation(), -force,
-                    bodyForces);
-            }
-
             // Now account for the work being done by virtue of the moving
             // path point motion relative to the body it is on
             if(mppo){
@@ -436,23 +517,28 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
  */
 double GeometryPath::getLength( const SimTK::State& s) const
 {
+    if (isLengthSurrogateInRange(s)) {
+        if (!_lengthCV.isValid(s))
+            setLength(s, _lengthSurrogate->calcLength(s));
+        return _lengthCV.getValue(s);
+    }
     computePath(s);  // compute checks if path needs to be recomputed
-    return( getCacheVariableValue<double>(s, "length") );
+    return( _lengthCV.getValue(s) );
 }
 
 void GeometryPath::setLength( const SimTK::State& s, double length ) const
 {
-    setCacheVariableValue<double>(s, "length", length); 
+    _lengthCV.setValue(s, length);
 }
 
 void GeometryPath::setColor(const SimTK::State& s, const SimTK::Vec3& color) const
 {
-    setCacheVariableValue<SimTK::Vec3>(s, "color", color);
+    _colorCV.setValue(s, color);
 }
 
 Vec3 GeometryPath::getColor(const SimTK::State& s) const
 {
-    return getCacheVariableValue<SimTK::Vec3>(s, "color");
+    return _colorCV.getValue(s);
 }
 
 //_____________________________________________________________________________
@@ -464,11 +550,11 @@ Vec3 GeometryPath::getColor(const SimTK::State& s) const
 double GeometryPath::getLengtheningSpeed( const SimTK::State& s) const
 {
     computeLengtheningSpeed(s);
-    return getCacheVariableValue<double>(s, "speed");
+    return _speedCV.getValue(s);
 }
 void GeometryPath::setLengtheningSpeed( const SimTK::State& s, double speed ) const
 {
-    setCacheVariableValue<double>(s, "speed", speed);    
+    _speedCV.setValue(s, speed);
 }
 
 void GeometryPath::setPreScaleLength( const SimTK::State& s, double length ) {
@@ -839,13 +925,17 @@ void GeometryPath::computePath(const SimTK::State& s) const
 {
     //const SimTK::Stage& sg = s.getSystemStage();
     
-    if (isCacheVariableValid(s, "current_path"))  {
+    if (_currentPathCV.isValid(s))  {
+        return;
+    }
+
+    if (_sharedPath) {
+        copySharedPath(s);
         return;
     }
 
     // Clear the current path.
-    Array<PathPoint*>& currentPath = 
-        updCacheVariableValue<Array<PathPoint*> >(s, "current_path");
+    Array<PathPoint*>& currentPath = _currentPathCV.updValue(s);
     currentPath.setSize(0);
 
     // Add the active fixed and moving via points to the path.
@@ -859,7 +949,86 @@ void GeometryPath::computePath(const SimTK::State& s) const
     applyWrapObjects(s, currentPath);
     calcLengthAfterPathComputation(s, currentPath);
 
-    markCacheVariableValid(s, "current_path");
+    _currentPathCV.markValid(s);
+    _currentLocationsCV.markValid(s);
+}
+
+//_____________________________________________________________________________
+/*
+ * Mirror the current path of the identical path this path shares.
+ */
+void GeometryPath::copySharedPath(const SimTK::State& s) const
+{
+    const GeometryPath& shared = *_sharedPath;
+    const Array<PathPoint*>& sharedPath = shared.getCurrentPath(s);
+    const PathPointSet& sharedPoints = shared.get_PathPointSet();
+    const PathWrapSet& sharedWraps = shared.get_PathWrapSet();
+
+    // The points of both paths are in the same order, so each point of the
+    // shared path maps to the point of this path with the same index.
+    Array<PathPoint*>& currentPath = _currentPathCV.updValue(s);
+    currentPath.setSize(0);
+    for (int i = 0; i < sharedPath.getSize(); i++) {
+        const PathPoint* point = sharedPath[i];
+        PathPoint* ownPoint = nullptr;
+        for (int j = 0; !ownPoint && j < sharedPoints.getSize(); j++) {
+            if (&sharedPoints[j] == point)
+                ownPoint = &get_PathPointSet()[j];
+        }
+        // Otherwise it is a wrap point, whose result is copied as well.
+        for (int j = 0; !ownPoint && j < sharedWraps.getSize(); j++) {
+            const PathWrap& wrap = sharedWraps.get(j);
+            PathWrap& ownWrap = get_PathWrapSet().get(j);
+            const PathWrapPoint* wrapPoint = nullptr;
+            if (point == &wrap.getWrapPoint1()) {
+                wrapPoint = &wrap.getWrapPoint1();
+                ownPoint = &ownWrap.updWrapPoint1();
+            } else if (point == &wrap.getWrapPoint2()) {
+                wrapPoint = &wrap.getWrapPoint2();
+                ownPoint = &ownWrap.updWrapPoint2();
+            }
+            if (wrapPoint) {
+                static_cast<PathWrapPoint*>(ownPoint)->setWrapResult(s,
+                    wrapPoint->getLocation(s), wrapPoint->getWrapPath(s),
+                    wrapPoint->getWrapLength(s));
+            }
+        }
+        currentPath.append(ownPoint);
+    }
+
+    _currentLocationsCV.updValue(s) = shared._currentLocationsCV.getValue(s);
+    // The shared path has just set its length from its current path.
+    setLength(s, shared._lengthCV.getValue(s));
+
+    _currentPathCV.markValid(s);
+    _currentLocationsCV.markValid(s);
+}
+
+//_____________________________________________________________________________
+/*
+ * Whether this path would compute the same path as the other one.
+ */
+bool GeometryPath::isIdenticalTo(const GeometryPath& other) const
+{
+    const PathPointSet& points = get_PathPointSet();
+    const PathPointSet& otherPoints = other.get_PathPointSet();
+    const PathWrapSet& wraps = get_PathWrapSet();
+    const PathWrapSet& otherWraps = other.get_PathWrapSet();
+    if (points.getSize() != otherPoints.getSize() ||
+            wraps.getSize() != otherWraps.getSize())
+        return false;
+
+    for (int i = 0; i < points.getSize(); i++) {
+        if (!haveSameGeometry(points[i], otherPoints[i]))
+            return false;
+    }
+    for (int i = 0; i < wraps.getSize(); i++) {
+        // The wrap objects are found by name, not through a socket.
+        if (wraps[i].getWrapObject() != otherWraps[i].getWrapObject() ||
+                !haveSameGeometry(wraps[i], otherWraps[i]))
+            return false;
+    }
+    return true;
 }
 
 //_____________________________________________________________________________
@@ -868,15 +1037,31 @@ void GeometryPath::computePath(const SimTK::State& s) const
  */
 void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
 {
-    if (isCacheVariableValid(s, "speed"))
+    if (_speedCV.isValid(s))
         return;
 
+    if (isLengthSurrogateInRange(s)) {
+        setLengtheningSpeed(s, _lengthSurrogate->calcLengtheningSpeed(s));
+        return;
+    }
+
     const Array<PathPoint*>& currentPath = getCurrentPath(s);
+    const SimTK::Array_<Vec3>& locations = _currentLocationsCV.getValue(s);
 
+    // Sum the rates at which the segments lengthen: the relative velocity
+    // of the ends of each segment projected onto its direction.
     double speed = 0.0;
-    
-    for (int i = 0; i < currentPath.getSize() - 1; i++) {
-        speed += currentPath[i]->calcSpeedBetween(s, *currentPath[i+1]);
+    const int np = currentPath.getSize();
+    if (np > 0) {
+        Vec3 velocity = currentPath[0]->getVelocityInGround(s);
+        for (int i = 0; i < np - 1; i++) {
+            const Vec3 nextVelocity = currentPath[i+1]->getVelocityInGround(s);
+            const Vec3 r = locations[i+1] - locations[i];
+            const Vec3 v = nextVelocity - velocity;
+            const double d = r.norm();
+            speed += d < SimTK::Eps ? v.norm() : dot(v, r)/d;
+            velocity = nextVelocity;
+        }
     }
 
     setLengtheningSpeed(s, speed);
@@ -1013,7 +1198,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                             best_wrap = wr;
                             // Store the best wrap in the pathWrap for possible 
                             // use next time.
-                            ws.setPreviousWrap(wr);
+                            ws.setPreviousWrap(s, wr);
                             break;
                         }  else if (result[i] == WrapObject::wrapped) {
                             // "wrapped" means the path segment was wrapped over
@@ -1027,7 +1212,7 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                                 best_wrap = wr;
                                 // Store the best wrap in the pathWrap for 
                                 // possible use next time
-                                ws.setPreviousWrap(wr);
+                                ws.setPreviousWrap(s, wr);
                                 min_length_change = path_length_change;
                             } else {
                                 // The wrap was not shorter than the current 
@@ -1041,18 +1226,12 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                     }
                 }
 
-                // Deallocate previous wrapping points if necessary.
-                ws.updWrapPoint2().getWrapPath().setSize(0);
-
                 if (best_wrap.wrap_pts.getSize() == 0) {
-                    ws.resetPreviousWrap();
-                    ws.updWrapPoint2().getWrapPath().setSize(0);
+                    ws.resetPreviousWrap(s);
                 } else {
-                    // If wrapping did occur, copy wrap info into the PathStruct.
-                    ws.updWrapPoint1().getWrapPath().setSize(0);
-
-                    Array<SimTK::Vec3>& wrapPath = ws.updWrapPoint2().getWrapPath();
-                    wrapPath = best_wrap.wrap_pts;
+                    // If wrapping did occur, copy wrap info into the wrap
+                    // points. The results are stored in the state, since the
+                    // path may be computed for several states at once.
 
                     // In OpenSim, all conversion to/from the wrap object's 
                     // reference frame will be performed inside 
@@ -1064,11 +1243,10 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                     //            ms->ground_segment);
                     // }
 
-                    ws.updWrapPoint1().setWrapLength(0.0);
-                    ws.updWrapPoint2().setWrapLength(best_wrap.wrap_path_length);
-
-                    ws.updWrapPoint1().setLocation(s,best_wrap.r1);
-                    ws.updWrapPoint2().setLocation(s,best_wrap.r2);
+                    ws.getWrapPoint1().setWrapResult(s, best_wrap.r1,
+                                                     Array<SimTK::Vec3>(), 0.0);
+                    ws.getWrapPoint2().setWrapResult(s, best_wrap.r2,
+                        best_wrap.wrap_pts, best_wrap.wrap_path_length);
 
                     // Now insert the two new wrapping points into mp[] array.
                     path.insert(best_wrap.endPoint, &ws.updWrapPoint1());
@@ -1132,16 +1310,28 @@ calcPathLengthChange(const SimTK::State& s, const WrapObject& wo,
 
 //_____________________________________________________________________________
 /*
- * Compute the total length of the path. This function
- * assumes that the path has already been updated.
+ * Compute the total length of the path, and the locations of its points in
+ * Ground. This function assumes that the path has already been updated.
  */
 double GeometryPath::
 calcLengthAfterPathComputation(const SimTK::State& s, 
                                const Array<PathPoint*>& currentPath) const
 {
+    // Compute the locations directly rather than through the cached
+    // locations of the points, since wrap points move while the path is
+    // computed.
+    SimTK::Array_<Vec3>& locations = _currentLocationsCV.updValue(s);
+    const int np = currentPath.getSize();
+    locations.resize(np);
+    for (int i = 0; i < np; i++) {
+        const PathPoint* p = currentPath[i];
+        locations[i] = p->getParentFrame().getTransformInGround(s)
+                       * p->getLocation(s);
+    }
+
     double length = 0.0;
 
-    for (int i = 0; i < currentPath.getSize() - 1; i++) {
+    for (int i = 0; i < np - 1; i++) {
         const PathPoint* p1 = currentPath[i];
         const PathPoint* p2 = currentPath[i+1];
 
@@ -1154,9 +1344,9 @@ calcLengthAfterPathComputation(const SimTK::State& s,
         {
             const PathWrapPoint* smwp = dynamic_cast<const PathWrapPoint*>(p2);
             if (smwp)
-                length += smwp->getWrapLength();
+                length += smwp->getWrapLength(s);
         } else {
-            length += p1->calcDistanceBetween(s, *p2);
+            length += (locations[i+1] - locations[i]).norm();
         }
     }
 
@@ -1173,10 +1363,278 @@ calcLengthAfterPathComputation(const SimTK::State& s,
 double GeometryPath::
 computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const
 {
-    if (!_maSolver)
-        const_cast<Self*>(this)->_maSolver.reset(new MomentArmSolver(*_model));
+    if (canComputeMomentArmsDirectly(s)) {
+        // Without constraints, the coupling of the coordinate to the
+        // mobilities is one for its own mobility and zero otherwise.
+        const SimTK::MobilizedBody& mobod = getModel().getMatterSubsystem()
+            .getMobilizedBody(aCoord.getBodyIndex());
+        return calcUnitTensionGeneralizedForces(s)
+            [int(mobod.getFirstUIndex(s)) + aCoord.getMobilizerQIndex()];
+    }
+
+    std::unique_ptr<MomentArmSolver> solver;
+    {
+        std::lock_guard<std::mutex> lock(maSolversMutex);
+        if (!_maSolvers.empty()) {
+            solver = std::move(_maSolvers.back());
+            _maSolvers.pop_back();
+        }
+    }
+    if (!solver)
+        solver.reset(new MomentArmSolver(*_model));
+
+    const double ma = solver->solve(s, aCoord,  *this);
+
+    std::lock_guard<std::mutex> lock(maSolversMutex);
+    _maSolvers.push_back(std::move(solver));
+    return ma;
+}
+
+//_____________________________________________________________________________
+/*
+ * Compute the path's moment arms about all coordinates.
+ */
+SimTK::Vector GeometryPath::computeMomentArms(const SimTK::State& s) const
+{
+    const CoordinateSet& coordinates = getModel().getCoordinateSet();
+    SimTK::Vector momentArms(coordinates.getSize());
+    if (!canComputeMomentArmsDirectly(s)) {
+        for (int i = 0; i < coordinates.getSize(); ++i)
+            momentArms[i] = computeMomentArm(s, coordinates[i]);
+        return momentArms;
+    }
+
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+    const SimTK::Vector f = calcUnitTensionGeneralizedForces(s);
+    for (int i = 0; i < coordinates.getSize(); ++i) {
+        const Coordinate& coord = coordinates[i];
+        const SimTK::MobilizedBody& mobod =
+            matter.getMobilizedBody(coord.getBodyIndex());
+        momentArms[i] =
+            f[int(mobod.getFirstUIndex(s)) + coord.getMobilizerQIndex()];
+    }
+    return momentArms;
+}
+
+bool GeometryPath::canComputeMomentArmsDirectly(const SimTK::State& s) const
+{
+    // Locked and prescribed coordinates are also constraints.
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+    for (SimTK::ConstraintIndex cx(0); cx < matter.getNumConstraints(); ++cx) {
+        if (!matter.getConstraint(cx).isDisabled(s))
+            return false;
+    }
+    return true;
+}
+
+//_____________________________________________________________________________
+/*
+ * Find the mobilized bodies that can change the length of the path.
+ */
+SimTK::Array_<SimTK::MobilizedBodyIndex>
+GeometryPath::findMobilizedBodies() const
+{
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+    const int nb = matter.getNumBodies();
+
+    // The bodies of the frames of the points and wrap objects, and those of
+    // the coordinates that move points on their own.
+    SimTK::Array_<SimTK::MobilizedBodyIndex> frames;
+    std::vector<bool> found(nb, false);
+    const PathPointSet& points = getPathPointSet();
+    for (int i = 0; i < points.getSize(); ++i) {
+        const PathPoint& point = points[i];
+        frames.push_back(point.getParentFrame().getMobilizedBodyIndex());
+        if (const auto* mpp = dynamic_cast<const MovingPathPoint*>(&point)) {
+            if (mpp->hasXCoordinate())
+                found[mpp->getXCoordinate().getBodyIndex()] = true;
+            if (mpp->hasYCoordinate())
+                found[mpp->getYCoordinate().getBodyIndex()] = true;
+            if (mpp->hasZCoordinate())
+                found[mpp->getZCoordinate().getBodyIndex()] = true;
+        }
+        else if (const auto* cpp =
+                dynamic_cast<const ConditionalPathPoint*>(&point)) {
+            if (cpp->hasCoordinate())
+                found[cpp->getCoordinate().getBodyIndex()] = true;
+        }
+    }
+    const PathWrapSet& wraps = getWrapSet();
+    for (int i = 0; i < wraps.getSize(); ++i) {
+        if (const WrapObject* wrapObject = wraps[i].getWrapObject())
+            frames.push_back(wrapObject->getFrame().getMobilizedBodyIndex());
+    }
+
+    // The mobilities of the closest common ancestor of the frames, and of
+    // its ancestors, move all of them together, which neither changes the
+    // length nor is resisted by the tension, whose forces cancel.
+    const auto parentOf = [&](SimTK::MobilizedBodyIndex b) {
+        return matter.getMobilizedBody(b).getParentMobilizedBody()
+                   .getMobilizedBodyIndex();
+    };
+    std::vector<int> numFramesBelow(nb, 0);
+    for (SimTK::MobilizedBodyIndex frame : frames) {
+        std::vector<bool> visited(nb, false);
+        for (SimTK::MobilizedBodyIndex b = frame; ; b = parentOf(b)) {
+            if (!visited[b]) { visited[b] = true; ++numFramesBelow[b]; }
+            if (b == SimTK::GroundIndex) break;
+        }
+    }
+    SimTK::MobilizedBodyIndex ancestor = SimTK::GroundIndex;
+    if (!frames.empty()) {
+        ancestor = frames[0];
+        while (numFramesBelow[ancestor] < (int)frames.size())
+            ancestor = parentOf(ancestor);
+    }
+    for (SimTK::MobilizedBodyIndex frame : frames) {
+        for (SimTK::MobilizedBodyIndex b = frame; b != ancestor;
+                b = parentOf(b))
+            found[b] = true;
+    }
+
+    SimTK::Array_<SimTK::MobilizedBodyIndex> bodies;
+    for (SimTK::MobilizedBodyIndex b(1); b < nb; ++b)
+        if (found[b]) bodies.push_back(b);
+    return bodies;
+}
+
+SimTK::Vector GeometryPath::
+calcUnitTensionGeneralizedForces(const SimTK::State& s) const
+{
+    const SimTK::MultibodySystem& system = getModel().getMultibodySystem();
+    if (s.getSystemStage() < SimTK::Stage::Position)
+        system.realize(s, SimTK::Stage::Position);
+
+    // Apply a unit tension along the path and convert the resulting body
+    // forces F to mobility forces f = ~J*F, as a MomentArmSolver does, but
+    // in the given state, where the path has usually been computed already.
+    const SimTK::SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces(matter.getNumBodies(),
+                                                 SimTK::SpatialVec(Vec3(0), Vec3(0)));
+    SimTK::Vector mobilityForces(s.getNU(), 0.0);
+    addInEquivalentForces(s, 1.0, bodyForces, mobilityForces);
+
+    SimTK::Vector f;
+    matter.multiplyBySystemJacobianTranspose(s, bodyForces, f);
+    f += mobilityForces;
+    return f;
+}
+
+//_____________________________________________________________________________
+/*
+ * Fit a surrogate of the length of the path over the coordinates that affect
+ * it. See the header for details.
+ */
+bool GeometryPath::fitLengthSurrogate(const SimTK::State& s, int degree,
+                                      int numSamples, double tolerance,
+                                      int maxCoordinates) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(numSamples < 2, Exception,
+        "fitLengthSurrogate: need at least 2 samples per coordinate.");
+
+    // The exact path is used to sample the length.
+    clearLengthSurrogate();
+
+    const MultibodySystem& system = getModel().getMultibodySystem();
+    State state = s;
+    system.realize(state, Stage::Position);
+    const double length0 = getLength(state);
+
+    // Find the coordinates that change the length of the path by sweeping
+    // each of them over its range.
+    const CoordinateSet& coordinates = getModel().getCoordinateSet();
+    std::vector<const Coordinate*> affecting;
+    const double threshold = SimTK::SqrtEps*(1 + std::abs(length0));
+    for (int i = 0; i < coordinates.getSize(); ++i) {
+        const Coordinate& coord = coordinates[i];
+        if (coord.getLocked(state) ||
+            !(coord.getRangeMax() > coord.getRangeMin()))
+            continue;
+        const double value0 = coord.getValue(state);
+        bool changesLength = false;
+        const int numSweep = 5;
+        for (int k = 0; k < numSweep && !changesLength; ++k) {
+            coord.setValue(state, coord.getRangeMin() +
+                (coord.getRangeMax() - coord.getRangeMin())*k/(numSweep-1),
+                false);
+            system.realize(state, Stage::Position);
+            changesLength = std::abs(getLength(state) - length0) > threshold;
+        }
+        coord.setValue(state, value0, false);
+        if (changesLength)
+            affecting.push_back(&coord);
+    }
+
+    const int n = (int)affecting.size();
+    if (n == 0 || n > maxCoordinates)
+        return false;
+
+    std::vector<SimTK::QIndex> qIndices;
+    Vector lower(n), upper(n);
+    for (int j = 0; j < n; ++j) {
+        const Coordinate& coord = *affecting[j];
+        const MobilizedBody& mobod =
+            getModel().getMatterSubsystem().getMobilizedBody(
+                coord.getBodyIndex());
+        qIndices.push_back(SimTK::QIndex(
+            mobod.getFirstQIndex(state) + coord.getMobilizerQIndex()));
+        lower[j] = coord.getRangeMin();
+        upper[j] = coord.getRangeMax();
+    }
+    std::unique_ptr<PathLengthSurrogate> surrogate(
+        new PathLengthSurrogate(qIndices, lower, upper, degree));
+
+    // Sample the exact length on a tensor grid of Chebyshev nodes (or on the
+    // points between the nodes, for validation).
+    auto sampleGrid = [&](bool between, Matrix& samples, Vector& lengths) {
+        const int numPerCoord = between ? numSamples - 1 : numSamples;
+        int numPoints = 1;
+        for (int j = 0; j < n; ++j) numPoints *= numPerCoord;
+        samples.resize(numPoints, n);
+        lengths.resize(numPoints);
+        std::vector<int> index(n, 0);
+        for (int p = 0; p < numPoints; ++p) {
+            for (int j = 0; j < n; ++j) {
+                const double theta = SimTK::Pi*
+                    (index[j] + (between ? 0.5 : 0.0))/(numSamples - 1);
+                const double value = lower[j] +
+                    0.5*(upper[j] - lower[j])*(1 - std::cos(theta));
+                samples(p, j) = value;
+                affecting[j]->setValue(state, value, false);
+            }
+            system.realize(state, Stage::Position);
+            lengths[p] = getLength(state);
+            // Advance to the next point of the grid.
+            for (int j = 0; j < n && ++index[j] == numPerCoord; ++j)
+                index[j] = 0;
+        }
+    };
+
+    Matrix samples;
+    Vector lengths;
+    sampleGrid(false, samples, lengths);
+    surrogate->fit(samples, lengths);
 
-    return _maSolver->solve(s, aCoord,  *this);
+    double maxError = 0;
+    for (int p = 0; p < lengths.size(); ++p) {
+        maxError = std::max(maxError, std::abs(lengths[p] -
+            surrogate->calcLength(samples[p].transpose().getAsVector())));
+    }
+    sampleGrid(true, samples, lengths);
+    for (int p = 0; p < lengths.size(); ++p) {
+        maxError = std::max(maxError, std::abs(lengths[p] -
+            surrogate->calcLength(samples[p].transpose().getAsVector())));
+    }
+    surrogate->setMaxError(maxError);
+
+    if (maxError > tolerance)
+        return false;
+
+    const_cast<Self*>(this)->_lengthSurrogate.reset(surrogate.release());
+    return true;
 }
 
 void GeometryPath::extendFinalizeFromProperties()
@@ -30,6 +30,7 @@
 #include "PathPointSet.h"
 #include <OpenSim/Simulation/Wrap/PathWrapSet.h>
 #include <OpenSim/Simulation/MomentArmSolver.h>
+#include "PathLengthSurrogate.h"
 
 
 #ifdef SWIG
@@ -80,10 +81,33 @@ private:
     // Pointer to the Object that owns this GeometryPath object.
     SimTK::ReferencePtr<Object> _owner;
 
-    // Solver used to compute moment-arms. The GeometryPath owns this object,
-    // but we cannot simply use a unique_ptr because we want the pointer to be
-    // cleared on copy.
-    SimTK::ResetOnCopy<std::unique_ptr<MomentArmSolver> > _maSolver;
+    // Solvers used to compute moment-arms that are not in use. A solver keeps
+    // its own copy of the state, so each call to computeMomentArm() takes one
+    // from here (or creates one) and returns it when it is done; this lets
+    // several threads compute the moment arms of the same path at once. The
+    // solvers are cleared on copy.
+    mutable SimTK::ResetOnCopy<std::vector<std::unique_ptr<MomentArmSolver> > >
+        _maSolvers;
+
+    // Optional approximation of the length of this path in terms of the
+    // coordinates that affect it. Like the moment-arm solver, it is cleared
+    // on copy and whenever the path is connected to a model.
+    SimTK::ResetOnCopy<std::unique_ptr<PathLengthSurrogate> > _lengthSurrogate;
+
+    // An identical path earlier in the model (same points, frames and wraps)
+    // whose computed path this path mirrors instead of computing its own;
+    // found in extendAddToSystem() (or again when path points change within
+    // the System) and cleared on copy.
+    mutable SimTK::ReferencePtr<const GeometryPath> _sharedPath;
+
+    // Handles to the cache variables of this path, set in extendAddToSystem().
+    mutable SimTK::ResetOnCopy<CacheVariable<double> > _lengthCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<double> > _speedCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<Array<PathPoint*> > > _currentPathCV;
+    // Locations in Ground of the points of the current path, in order.
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Array_<SimTK::Vec3> > >
+        _currentLocationsCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Vec3> > _colorCV;
     
 //=============================================================================
 // METHODS
@@ -149,12 +173,20 @@ public:
     double getPreScaleLength( const SimTK::State& s) const;
     void setPreScaleLength( const SimTK::State& s, double preScaleLength);
     const Array<PathPoint*>& getCurrentPath( const SimTK::State& s) const;
+    /** Get the locations in Ground of the points of the current path, in the
+    same order as getCurrentPath(). They are computed with the path, so they
+    are cheaper to use than asking each point for its location. */
+    const SimTK::Array_<SimTK::Vec3>&
+        getCurrentPathLocations(const SimTK::State& s) const;
 
     double getLengtheningSpeed(const SimTK::State& s) const;
     void setLengtheningSpeed( const SimTK::State& s, double speed ) const;
 
     /** get the path as PointForceDirections directions, which can be used
-        to apply tension to bodies the points are connected to.*/
+        to apply tension to bodies the points are connected to. The
+        PointForceDirections are heap allocated and must be deleted by the
+        caller; to apply a tension along the path, addInEquivalentForces()
+        does so without allocating anything.*/
     void getPointForceDirections(const SimTK::State& s, 
         OpenSim::Array<PointForceDirection*> *rPFDs) const;
 
@@ -174,7 +206,83 @@ public:
     //--------------------------------------------------------------------------
     // COMPUTATIONS
     //--------------------------------------------------------------------------
+    /** Compute the moment arm of the path about the given coordinate. If no
+    constraints are enabled in the model, the moment arm is computed directly
+    from the Jacobian of the points of the path in the given state (which is
+    realized to Stage::Position if needed). Otherwise, the coupling of the
+    coordinates by the constraints is found by a MomentArmSolver. */
     virtual double computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const;
+    /** Compute the moment arms of the path about all the coordinates of the
+    model at once, in the order of Model::getCoordinateSet(). If no
+    constraints are enabled, this costs about as much as computeMomentArm()
+    for a single coordinate. */
+    SimTK::Vector computeMomentArms(const SimTK::State& s) const;
+    /** Find the mobilized bodies whose mobilities can change the length of
+    the path, and on which a tension along the path acts: those between the
+    frames of its points and wrap objects and the closest ancestor common to
+    all of them (which moves the whole path rigidly), and those of the
+    coordinates that move its moving and conditional points. They are in
+    increasing order, without Ground. The system must have been created. */
+    SimTK::Array_<SimTK::MobilizedBodyIndex> findMobilizedBodies() const;
+
+    //--------------------------------------------------------------------------
+    // LENGTH SURROGATE
+    //--------------------------------------------------------------------------
+    /** Fit a polynomial surrogate of the length of this path in terms of the
+    coordinates that change it, so that getLength(), getLengtheningSpeed() and
+    addInEquivalentForces() can skip computing the path (and its wrapping)
+    while the coordinates stay within their ranges. The coordinates that
+    change the length are found by sweeping each unlocked coordinate over its
+    range from the values in the given state. The exact length is then sampled
+    on a grid of `numSamples` Chebyshev nodes per coordinate and the surrogate
+    is checked against the exact length at points between the nodes.
+
+    No surrogate is kept (and false is returned) if more than
+    `maxCoordinates` coordinates change the length of the path, or if the
+    largest error found exceeds `tolerance` (in units of length). Outside the
+    ranges it was fit over, the exact path is computed as usual. The path
+    points returned by getCurrentPath() are always computed exactly. The
+    surrogate must be fit again after the system is recreated (initSystem()).
+
+    @param s             state providing the values of the coordinates that
+                         are not swept
+    @param degree        total degree of the polynomial
+    @param numSamples    number of samples per coordinate
+    @param tolerance     largest acceptable error in the length
+    @param maxCoordinates largest number of coordinates to fit over
+    @return true if the surrogate was fit to within the tolerance */
+    bool fitLengthSurrogate(const SimTK::State& s, int degree = 5,
+                            int numSamples = 9, double tolerance = 1e-5,
+                            int maxCoordinates = 3) const;
+    /** Use the given surrogate for the length of this path (e.g., one fit by
+    MuscleAtlasTool::fitLengthSurrogate()). Its coordinates must include all
+    those that change the length of the path, which is not checked. Like a
+    surrogate fit by fitLengthSurrogate(), it is used only while the
+    coordinates are within its ranges, and must be set again after the
+    system is recreated. */
+    void setLengthSurrogate(const PathLengthSurrogate& surrogate) const
+    {   const_cast<Self*>(this)->_lengthSurrogate.reset(
+            new PathLengthSurrogate(surrogate)); }
+    /** Remove the length surrogate so that the path is always computed. */
+    void clearLengthSurrogate() const
+    {   const_cast<Self*>(this)->_lengthSurrogate.reset(); }
+    /** Get the length surrogate, or nullptr if there is none. */
+    const PathLengthSurrogate* getLengthSurrogate() const
+    {   return _lengthSurrogate.get(); }
+
+    //--------------------------------------------------------------------------
+    // SHARED PATHS
+    //--------------------------------------------------------------------------
+    /** Get the path whose computation this path reuses, or nullptr if it
+    computes its own. When the system is created, a path whose points,
+    frames and wraps are all identical to those of a path earlier in the
+    model (e.g., a head of a muscle duplicated for another muscle or
+    controller) mirrors the current path, point locations and wrapping of
+    that path rather than computing them again; the results are the same.
+    Only whole paths are shared: since the wrapping over each wrap object
+    depends on all the points in its range and on the previous wrap, paths
+    that differ anywhere compute their own. */
+    const GeometryPath* getSharedPath() const { return _sharedPath.get(); }
 
     //--------------------------------------------------------------------------
     // SCALING
@@ -205,10 +313,21 @@ protected:
             override;
 
     void extendFinalizeFromProperties() override;
+    void extendFinalizeChangesInSystem() override;
 
 private:
 
     void computePath(const SimTK::State& s ) const;
+    // Copy the current path of _sharedPath, in terms of the points of this
+    // path, along with its wrapping, locations and length.
+    void copySharedPath(const SimTK::State& s) const;
+    // Whether this path has the same points, frames and wraps as the other.
+    bool isIdenticalTo(const GeometryPath& other) const;
+    // Set _sharedPath to the first identical path in the model, if it is not
+    // this one.
+    void findSharedPath() const;
+    bool isLengthSurrogateInRange(const SimTK::State& s) const
+    {   return _lengthSurrogate && _lengthSurrogate->isInRange(s); }
     void computeLengtheningSpeed(const SimTK::State& s) const;
     void applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path ) const;
     double calcPathLengthChange(const SimTK::State& s, const WrapObject& wo, 
@@ -216,6 +335,13 @@ private:
                                 const Array<PathPoint*>& path) const; 
     double calcLengthAfterPathComputation
        (const SimTK::State& s, const Array<PathPoint*>& currentPath) const;
+    // Whether the moment arms can be read directly from the generalized
+    // forces of a unit tension, i.e., whether no constraints couple the
+    // coordinates.
+    bool canComputeMomentArmsDirectly(const SimTK::State& s) const;
+    // The generalized forces (one per mobility) of a unit tension along the
+    // path in the given state.
+    SimTK::Vector calcUnitTensionGeneralizedForces(const SimTK::State& s) const;
 
     void constructProperties();
     void namePathPoints(int aStartingIndex);
@@ -183,6 +183,17 @@ void JointInternalPowerProbe::extendConnectToModel(Model& aModel)
     // Sanity check. Should never actually happen!
     if (nJ != int(_jointIndex.size()))
         throw (Exception("Size of _jointIndex does not match number of Joints listed in <joint_names>."));
+
+    // Gather the coordinates of the joints.
+    _coordinates.clear();
+    _coordinateJoint.clear();
+    for (int i=0; i<nJ; i++) {
+        const Joint& joint = _model->getJointSet()[_jointIndex[i]];
+        for (int j=0; j<joint.numCoordinates(); j++) {
+            _coordinates.push_back(&joint.get_coordinates(j));
+            _coordinateJoint.push_back(i);
+        }
+    }
 }
 
 
@@ -198,23 +209,33 @@ void JointInternalPowerProbe::extendConnectToModel(Model& aModel)
  */
 SimTK::Vector JointInternalPowerProbe::computeProbeInputs(const State& s) const
 {
-    int nJ = getJointNames().size();
+    const int nJ = getJointNames().size();
     SimTK::Vector TotalP(getNumProbeInputs());
     TotalP = 0;
 
-    // Loop through each joint in the list of joint_names.
-    for (int i=0; i<nJ; ++i)
-    {
-        // Get the "Joint" power from the Joint object.
-        const double jointPower = _model->getJointSet()[_jointIndex[i]].calcPower(s);
-        
-        // Append to output vector.
-        if (getSumPowersTogether())
-            TotalP(0) += std::pow(jointPower, getExponent());
-        else
-            TotalP(i) = std::pow(jointPower, getExponent());
+    // The power of a joint is that of the constraints prescribing the motion
+    // of its coordinates (see Joint::calcPower()). Accumulate the powers of
+    // all joints in one pass over their coordinates.
+    SimTK::Vector jointPowers(nJ, 0.0);
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    for (int k=0; k<(int)_coordinates.size(); ++k) {
+        const Coordinate& coord = *_coordinates[k];
+        if (coord.isPrescribed(s))
+            jointPowers[_coordinateJoint[k]] +=
+                matter.getConstraint(coord._prescribedConstraintIndex)
+                    .calcPower(s);
     }
 
+    // Apply the exponent, then sum or report each joint power.
+    const double exponent = getExponent();
+    if (exponent != 1.0)
+        for (int i=0; i<nJ; ++i)
+            jointPowers[i] = std::pow(jointPowers[i], exponent);
+    if (getSumPowersTogether())
+        TotalP(0) = jointPowers.sum();
+    else
+        TotalP = jointPowers;
+
     return TotalP;
 }
 
@@ -30,6 +30,7 @@
 
 namespace OpenSim {
 
+class Coordinate;
 class Model;
 
 //==============================================================================
@@ -42,6 +43,10 @@ class Model;
  * so by using the JointInternalPowerProbe with the 'integrate' operation, Joint internal
  * work may be computed.
  *
+ * The coordinates of all probed joints are found when the probe is connected
+ * to its model, and the powers of all joints are accumulated in one pass over
+ * them.
+ *
  * @author Tim Dorn
  * @version 1.0
  */
@@ -131,6 +136,10 @@ private:
     // The index inside OpenSim::JointSet that corresponds to each joint
     // being probed.
     SimTK::Array_<int> _jointIndex;
+    // The coordinates of all probed joints, one joint after another, and the
+    // position of the joint of each in joint_names.
+    SimTK::ResetOnCopy<SimTK::Array_<const Coordinate*>> _coordinates;
+    SimTK::ResetOnCopy<SimTK::Array_<int>> _coordinateJoint;
 
     //--------------------------------------------------------------------------
     // ModelComponent Interface
@@ -26,7 +26,6 @@
 //=============================================================================
 #include "Ligament.h"
 #include "GeometryPath.h"
-#include "PointForceDirection.h"
 #include <OpenSim/Common/SimmSpline.h>
 
 //=============================================================================
@@ -279,14 +278,6 @@ void Ligament::computeForce(const SimTK::State& s,
         SimTK::Vector(1, path.getLength(s)/restingLength))* pcsaForce;
     setCacheVariableValue<double>(s, "tension", force);
 
-    OpenSim::Array<PointForceDirection*> PFDs;
-    path.getPointForceDirections(s, &PFDs);
-
-    for (int i=0; i < PFDs.getSize(); i++) {
-        applyForceToPoint(s, PFDs[i]->frame(), PFDs[i]->point(), 
-                          force*PFDs[i]->direction(), bodyForces);
-    }
-    for(int i=0; i < PFDs.getSize(); i++)
-        delete PFDs[i];
+    path.addInEquivalentForces(s, force, bodyForces, generalizedForces);
 }
 
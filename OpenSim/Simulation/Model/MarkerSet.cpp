@@ -26,6 +26,8 @@
 #include "Model.h"
 #include <OpenSim/Common/ScaleSet.h>
 
+#include <unordered_map>
+
 using namespace std;
 using namespace OpenSim;
 using SimTK::Vec3;
@@ -179,3 +181,59 @@ Marker* MarkerSet::addMarker(const string& aName, const SimTK::Vec3& aOffset, Op
 
     return m;
 }
+
+//=============================================================================
+// COMPUTATIONS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Compute the ground locations of all markers, finding the transform of each
+ * parent frame once.
+ */
+void MarkerSet::calcLocationsInGround(const SimTK::State& s,
+        SimTK::Array_<Vec3>& locations) const
+{
+    const int n = getSize();
+    locations.resize(n);
+
+    std::unordered_map<const PhysicalFrame*, SimTK::Transform> X_GF;
+    for (int i = 0; i < n; ++i) {
+        const Marker& marker = get(i);
+        const PhysicalFrame* frame = &marker.getParentFrame();
+        auto it = X_GF.find(frame);
+        if (it == X_GF.end())
+            it = X_GF.emplace(frame, frame->getTransformInGround(s)).first;
+        locations[i] = it->second*marker.get_location();
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Compute the ground velocities of all markers, finding the rotation and
+ * velocity of each parent frame once.
+ */
+void MarkerSet::calcVelocitiesInGround(const SimTK::State& s,
+        SimTK::Array_<Vec3>& velocities) const
+{
+    const int n = getSize();
+    velocities.resize(n);
+
+    struct FrameKinematics {
+        SimTK::Rotation R_GF;
+        SimTK::SpatialVec V_GF;
+    };
+    std::unordered_map<const PhysicalFrame*, FrameKinematics> kinematics;
+    for (int i = 0; i < n; ++i) {
+        const Marker& marker = get(i);
+        const PhysicalFrame* frame = &marker.getParentFrame();
+        auto it = kinematics.find(frame);
+        if (it == kinematics.end()) {
+            it = kinematics.emplace(frame, FrameKinematics{
+                    frame->getTransformInGround(s).R(),
+                    frame->getVelocityInGround(s)}).first;
+        }
+        // v = vF + omegaF x r, with r the marker location expressed in ground
+        const Vec3 r = it->second.R_GF*marker.get_location();
+        velocities[i] = it->second.V_GF[1] + it->second.V_GF[0] % r;
+    }
+}
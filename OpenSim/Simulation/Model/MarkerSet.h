@@ -75,6 +75,23 @@ public:
     void addNamePrefix(const std::string& prefix);
     Marker* addMarker( const std::string& aName, const SimTK::Vec3& aOffset, OpenSim::PhysicalFrame& aPhysicalFrame);
 
+    //--------------------------------------------------------------------------
+    // COMPUTATIONS
+    //--------------------------------------------------------------------------
+    /** Compute the locations in ground of all markers in the set, in the
+    order of the set, into the contiguous array locations (resized to the
+    number of markers). Markers are grouped by parent frame so that the
+    transform of each frame is found only once, which is much cheaper than
+    calling Marker::getLocationInGround() for each marker when many markers
+    share a frame. The state must be realized to Stage::Position. */
+    void calcLocationsInGround(const SimTK::State& s,
+                               SimTK::Array_<SimTK::Vec3>& locations) const;
+    /** Compute the velocities in ground of all markers in the set, as
+    calcLocationsInGround() does their locations. The state must be realized
+    to Stage::Velocity. */
+    void calcVelocitiesInGround(const SimTK::State& s,
+                                SimTK::Array_<SimTK::Vec3>& velocities) const;
+
 //=============================================================================
 };  // END of class MarkerSet
 //=============================================================================
@@ -0,0 +1,157 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  MeshCache.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "MeshCache.h"
+#include <OpenSim/Common/Exception.h>
+
+#include <ctime>
+#include <map>
+#include <mutex>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using namespace OpenSim;
+
+namespace {
+    // The meshes of one file, while they are in use.
+    struct Entry {
+        std::time_t modified = 0;
+        std::weak_ptr<const SimTK::PolygonalMesh> polygons;
+        std::weak_ptr<const SimTK::ContactGeometry::TriangleMesh> triangles;
+        std::weak_ptr<const SimTK::DecorativeMeshFile> decoration;
+
+        bool isInUse() const {
+            return !polygons.expired() || !triangles.expired() ||
+                   !decoration.expired();
+        }
+    };
+
+    std::mutex cacheMutex;
+    std::map<std::string, Entry> cache;
+
+    std::time_t getModificationTime(const std::string& path)
+    {
+#ifdef _MSC_VER
+        struct _stat info;
+        const bool found = _stat(path.c_str(), &info) == 0;
+#else
+        struct stat info;
+        const bool found = stat(path.c_str(), &info) == 0;
+#endif
+        OPENSIM_THROW_IF(!found, Exception,
+            "MeshCache: could not find file '" + path + "'.");
+        return info.st_mtime;
+    }
+
+    // Get the entry of the given file, which is forgotten if the file
+    // changed, and forget the files that are no longer in use. The caller
+    // holds the lock.
+    Entry& getEntry(const std::string& path, std::time_t modified)
+    {
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (it->first != path && !it->second.isInUse())
+                it = cache.erase(it);
+            else
+                ++it;
+        }
+        Entry& entry = cache[path];
+        if (entry.modified != modified) {
+            entry = Entry();
+            entry.modified = modified;
+        }
+        return entry;
+    }
+
+    // Get the cached object in the given member of the entry of the file,
+    // or create and cache one. Objects are created without the lock held so
+    // that files are loaded concurrently; if two threads load the same file,
+    // the first to finish wins.
+    template <typename T, typename Create>
+    std::shared_ptr<const T> getOrCreate(const std::string& fileName,
+            std::weak_ptr<const T> Entry::*member, Create create)
+    {
+        const std::string path = SimTK::Pathname::getAbsolutePathname(fileName);
+        const std::time_t modified = getModificationTime(path);
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            if (auto cached = (getEntry(path, modified).*member).lock())
+                return cached;
+        }
+
+        std::shared_ptr<const T> created = create(path);
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        std::weak_ptr<const T>& slot = getEntry(path, modified).*member;
+        if (auto cached = slot.lock())
+            return cached;
+        slot = created;
+        return created;
+    }
+}
+
+//=============================================================================
+// ACCESS
+//=============================================================================
+std::shared_ptr<const SimTK::PolygonalMesh>
+MeshCache::getPolygonalMesh(const std::string& fileName)
+{
+    return getOrCreate(fileName, &Entry::polygons,
+        [](const std::string& path) {
+            auto mesh = std::make_shared<SimTK::PolygonalMesh>();
+            mesh->loadFile(path);
+            return std::shared_ptr<const SimTK::PolygonalMesh>(mesh);
+        });
+}
+
+std::shared_ptr<const SimTK::ContactGeometry::TriangleMesh>
+MeshCache::getTriangleMesh(const std::string& fileName)
+{
+    return getOrCreate(fileName, &Entry::triangles,
+        [](const std::string& path) {
+            return std::shared_ptr<const SimTK::ContactGeometry::TriangleMesh>(
+                std::make_shared<SimTK::ContactGeometry::TriangleMesh>(
+                    *getPolygonalMesh(path)));
+        });
+}
+
+std::shared_ptr<const SimTK::DecorativeMeshFile>
+MeshCache::getDecorativeMeshFile(const std::string& fileName)
+{
+    return getOrCreate(fileName, &Entry::decoration,
+        [](const std::string& path) {
+            return std::shared_ptr<const SimTK::DecorativeMeshFile>(
+                std::make_shared<SimTK::DecorativeMeshFile>(path));
+        });
+}
+
+int MeshCache::getNumFiles()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    int numFiles = 0;
+    for (const auto& entry : cache)
+        if (entry.second.isInUse()) ++numFiles;
+    return numFiles;
+}
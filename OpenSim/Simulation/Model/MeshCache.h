@@ -0,0 +1,79 @@
+#ifndef OPENSIM_MESH_CACHE_H_
+#define OPENSIM_MESH_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  MeshCache.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKsimbody.h"
+
+#include <memory>
+#include <string>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A process-wide cache of the meshes loaded from files by Mesh and
+ * ContactMesh, so that models that use the same files (e.g., many copies of
+ * one model loaded for an ensemble of simulations) load each file once and
+ * share the meshes in memory.
+ *
+ * Meshes are identified by the absolute path of their file and the time the
+ * file was last modified, so a file that changes is loaded again. The cache
+ * only keeps a mesh while it is in use: once no Mesh or ContactMesh holds
+ * it, the next request loads the file again.
+ *
+ * All the methods may be called concurrently.
+ */
+class OSIMSIMULATION_API MeshCache {
+public:
+    /** Get the polygons in the given .vtp, .obj or .stl file. A relative
+    path is relative to the current working directory.
+    @throws Exception if the file does not exist */
+    static std::shared_ptr<const SimTK::PolygonalMesh>
+        getPolygonalMesh(const std::string& fileName);
+
+    /** Get the contact geometry of the polygons in the given file, which
+    share the polygons returned by getPolygonalMesh(). */
+    static std::shared_ptr<const SimTK::ContactGeometry::TriangleMesh>
+        getTriangleMesh(const std::string& fileName);
+
+    /** Get a decoration that draws the given file. The file itself is only
+    read when the decoration is drawn. */
+    static std::shared_ptr<const SimTK::DecorativeMeshFile>
+        getDecorativeMeshFile(const std::string& fileName);
+
+    /** The number of files with meshes that are currently in use. */
+    static int getNumFiles();
+
+private:
+    MeshCache() = delete;
+
+//=============================================================================
+};  // END of class MeshCache
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MESH_CACHE_H_
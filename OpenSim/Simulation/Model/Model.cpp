@@ -30,6 +30,7 @@
 #include <OpenSim/Common/XMLDocument.h>
 #include <OpenSim/Common/ScaleSet.h>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/ThreadPool.h>
 #include <OpenSim/Simulation/SimbodyEngine/FreeJoint.h>
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include <OpenSim/Simulation/SimbodyEngine/WeldConstraint.h>
@@ -49,10 +50,13 @@
 #include "ControllerSet.h"
 #include "CoordinateSet.h"
 #include "ForceSet.h"
+#include "GeometryPath.h"
 #include "Ligament.h"
 #include "MarkerSet.h"
 #include "ProbeSet.h"
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <string>
 
@@ -62,12 +66,29 @@ using namespace std;
 using namespace OpenSim;
 using namespace SimTK;
 
+namespace {
+// Call evaluate(state, i, results) for each of the states, into a matrix
+// with a row per state, dividing the states into numThreads contiguous
+// ranges that are evaluated on the ThreadPool.
+template <typename Evaluate>
+Matrix evaluateStates(const std::vector<State>& states, int numColumns,
+                      int numThreads, const Evaluate& evaluate)
+{
+    const int n = (int)states.size();
+    Matrix results(n, numColumns);
+    numThreads = ThreadPool::getNumThreads(numThreads);
+    ThreadPool::parallelForRanges(n, numThreads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) evaluate(states[i], i, results);
+    });
+    return results;
+}
+}
+
 
 //=============================================================================
 // STATICS
 //=============================================================================
 
-
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -81,7 +102,8 @@ Model::Model() : ModelComponent(),
     _coordinateSet(CoordinateSet()),
     _workingState(),
     _useVisualizer(false),
-    _allControllersEnabled(true)
+    _allControllersEnabled(true),
+    _numThreadsForPaths(1)
 {
     constructProperties();
     setNull();
@@ -98,7 +120,8 @@ Model::Model(const string &aFileName, const bool finalize) :
     _coordinateSet(CoordinateSet()),
     _workingState(),
     _useVisualizer(false),
-    _allControllersEnabled(true)
+    _allControllersEnabled(true),
+    _numThreadsForPaths(1)
 {   
     constructProperties();
     setNull();
@@ -337,11 +360,30 @@ void Model::constructProperties()
 // Perform some final checks on the Model, wire up all its components, and then
 // build a computational System for it.
 void Model::buildSystem() {
+    // If only components that allow it were edited since the System was
+    // built, finalize just those within the System and keep it.
+    if (hasSystem() && hasVisualizer() == getUseVisualizer()) {
+        const double start = SimTK::realTime();
+        if (finalizeChangesInSystem()) {
+            _initSystemTimes.finalizeFromProperties =
+                SimTK::realTime() - start;
+            _initSystemTimes.finalizeConnections = 0;
+            _initSystemTimes.addToSystem = 0;
+            return;
+        }
+    }
+
+    // The Visualizer belongs to the System that is being replaced, and it
+    // must stop rendering before the Model changes.
+    _modelViz.reset();
+
     // Finish connecting up the Model.
     setup();
 
     // Create the computational System representing this Model.
+    const double start = SimTK::realTime();
     createMultibodySystem();
+    _initSystemTimes.addToSystem = SimTK::realTime() - start;
 
     // Create a Visualizer for this Model if one has been requested. This adds
     // necessary elements to the System. Doesn't initialize geometry yet.
@@ -359,8 +401,11 @@ SimTK::State& Model::initializeState() {
         throw Exception("Model::initializeState(): call buildSystem() first.");
 
     // This tells Simbody to finalize the System.
+    double start = SimTK::realTime();
     getMultibodySystem().invalidateSystemTopologyCache();
     getMultibodySystem().realizeTopology();
+    _initSystemTimes.realizeTopology = SimTK::realTime() - start;
+    start = SimTK::realTime();
 
     // Set the model's operating state (internal member variable) to the 
     // default state that is stored inside the System.
@@ -373,6 +418,11 @@ SimTK::State& Model::initializeState() {
     // Process the modified modeling option.
     getMultibodySystem().realizeModel(_workingState);
 
+    // Collect the names of the state variables and find where their values
+    // are in Y, now that its layout is set, rather than at the first step
+    // stored by a simulation.
+    getStateVariableValues(_workingState);
+
     // Invoke the ModelComponent interface for initializing the state.
     initStateFromProperties(_workingState);
 
@@ -399,6 +449,7 @@ SimTK::State& Model::initializeState() {
     if (getUseVisualizer())
         _modelViz->collectFixedGeometry(_workingState);
 
+    _initSystemTimes.initializeState = SimTK::realTime() - start;
     return _workingState;
 }
 
@@ -423,11 +474,28 @@ const SimTK::State& Model::getWorkingState() const
 
 void Model::assemble(SimTK::State& s, const Coordinate *coord, double weight)
 {
-    
+    SimTK::Array_<const Coordinate*> coords;
+    SimTK::Array_<double> weights;
+    if(coord){
+        coords.push_back(coord);
+        weights.push_back(weight);
+    }
+    assemble(s, coords, weights);
+}
+
+void Model::assemble(SimTK::State& s,
+                     const SimTK::Array_<const Coordinate*>& coords,
+                     const SimTK::Array_<double>& weights)
+{
+    OPENSIM_THROW_IF_FRMOBJ(coords.size() != weights.size(), Exception,
+        "Expected one weight per coordinate, but got "
+        + std::to_string(weights.size()) + " weights for "
+        + std::to_string(coords.size()) + " coordinates.");
+
     bool constrained = false;
-    const CoordinateSet &coords = getCoordinateSet();
-    for(int i=0; i<coords.getSize(); ++i){
-        constrained = constrained || coords[i].isConstrained(s);
+    const CoordinateSet &coordSet = getCoordinateSet();
+    for(int i=0; i<coordSet.getSize(); ++i){
+        constrained = constrained || coordSet[i].isConstrained(s);
     }
 
     // Don't bother assembling if the model has no constraints
@@ -459,8 +527,10 @@ void Model::assemble(SimTK::State& s, const Coordinate *coord, double weight)
         _assemblySolver->updateCoordinateReference(coordName, c.getValue(s));
     }
 
-    if(coord) // use specified weighting for coordinate being set
-        _assemblySolver->updateCoordinateReference(coord->getName(), coord->getValue(s), weight);
+    // use specified weighting for coordinates being set
+    for(unsigned int i=0; i<coords.size(); i++)
+        _assemblySolver->updateCoordinateReference(coords[i]->getName(),
+            coords[i]->getValue(s), weights[i]);
 
 
     try{
@@ -870,6 +940,34 @@ void Model::extendConnectToModel(Model &model)
 
     // TODO: Get rid of the SimbodyEngine
     updSimbodyEngine().connectSimbodyEngineToModel(*this);
+
+    _geometryPaths.clear();
+    for (const auto& path : getComponentList<GeometryPath>())
+        _geometryPaths.push_back(&path);
+    _frames.clear();
+    for (const auto& frame : getComponentList<Frame>())
+        _frames.push_back(&frame);
+    _components.clear();
+    for (const auto& component : getComponentList())
+        _components.push_back(&component);
+    _controllers.clear();
+    for (const auto& controller : getComponentList<Controller>())
+        _controllers.push_back(&controller);
+    _firstOrderActivationMuscles.clear();
+    _minimumActivations.clear();
+    _activationTimeConstants.clear();
+    _deactivationTimeConstants.clear();
+    for (const auto& muscle : getComponentList<Muscle>()) {
+        double minimumActivation, activationTimeConstant,
+            deactivationTimeConstant;
+        if (muscle.getFirstOrderActivationParameters(minimumActivation,
+                activationTimeConstant, deactivationTimeConstant)) {
+            _firstOrderActivationMuscles.push_back(&muscle);
+            _minimumActivations.push_back(minimumActivation);
+            _activationTimeConstants.push_back(activationTimeConstant);
+            _deactivationTimeConstants.push_back(deactivationTimeConstant);
+        }
+    }
 }
 
 
@@ -1030,9 +1128,13 @@ void Model::setup()
 {
     // finalize the model and its subcomponents from its properties
     // automatically marks properties that are Components as subcomponents
+    double start = SimTK::realTime();
     finalizeFromProperties();
+    _initSystemTimes.finalizeFromProperties = SimTK::realTime() - start;
     //now connect the Model and all its subcomponents all up
+    start = SimTK::realTime();
     finalizeConnections(*this);
+    _initSystemTimes.finalizeConnections = SimTK::realTime() - start;
 }
 
 //_____________________________________________________________________________
@@ -1066,6 +1168,21 @@ void Model::extendInitStateFromProperties(SimTK::State& state) const
     controlsCache.updValue(state) = _defaultControls;
 }
 
+void Model::extendRealizeVelocity(const SimTK::State& state) const
+{
+    Super::extendRealizeVelocity(state);
+    // Every subsystem has been realized to Position by now, and none has
+    // yet computed forces from the paths.
+    computePathsInParallel(state);
+}
+
+void Model::extendRealizeAcceleration(const SimTK::State& state) const
+{
+    Super::extendRealizeAcceleration(state);
+    // Before the muscles compute their state derivatives.
+    computeActivationDerivatives(state);
+}
+
 void Model::extendSetPropertiesFromState(const SimTK::State& state)
 {
     Super::extendSetPropertiesFromState(state);
@@ -1077,14 +1194,8 @@ void Model::generateDecorations
         const SimTK::State&                         state,
         SimTK::Array_<SimTK::DecorativeGeometry>&   appendToThis) const
 {
-    ComponentList<const Component> allComps = getComponentList();
-    ComponentList<Component>::const_iterator iter = allComps.begin();
-    while (iter != allComps.end()){
-        //std::string cn = iter->getConcreteClassName();
-        //std::cout << cn << ":" << iter->getName() << std::endl;
-        iter->generateDecorations(fixed, hints, state, appendToThis);
-        iter++;
-    }
+    for (const Component* component : _components)
+        component->generateDecorations(fixed, hints, state, appendToThis);
 }
 
 void Model::equilibrateMuscles(SimTK::State& state)
@@ -1882,9 +1993,9 @@ const Vector& Model::getControls(const SimTK::State &s) const
 /** Compute the controls the model */
 void Model::computeControls(const SimTK::State& s, SimTK::Vector &controls) const
 {
-    for (auto& controller : getComponentList<Controller>()) {
-        if (controller.isEnabled()) {
-            controller.computeControls(s, controls);
+    for (const Controller* controller : _controllers) {
+        if (controller->isEnabled()) {
+            controller->computeControls(s, controls);
         }
     }
 }
@@ -2102,6 +2213,7 @@ void Model::realizeTime(const SimTK::State& state) const
 void Model::realizePosition(const SimTK::State& state) const
 {
     getSystem().realize(state, Stage::Position);
+    computePathsInParallel(state);
 }
 
 void Model::realizeVelocity(const SimTK::State& state) const
@@ -2125,6 +2237,139 @@ void Model::realizeReport(const SimTK::State& state) const
 }
 
 
+void Model::setNumThreadsForPaths(int numThreads)
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 1, Exception,
+        "Expected the number of threads to be at least 1, but got " +
+        std::to_string(numThreads) + ".");
+    _numThreadsForPaths = numThreads;
+}
+
+void Model::computePathsInParallel(const SimTK::State& s) const
+{
+    if (_numThreadsForPaths < 2 || _geometryPaths.size() < 2) return;
+
+    // A path that mirrors another is left for later, since it computes the
+    // other path if needed.
+    size_t numPending = 0;
+    for (const GeometryPath* path : _geometryPaths) {
+        if (!path->getSharedPath() &&
+                !path->isCacheVariableValid(s, "length"))
+            ++numPending;
+    }
+    // A single path is no faster on another thread.
+    if (numPending < 2) return;
+
+    // The transforms of the Frames are computed when first needed, so
+    // compute them here rather than from several paths at once.
+    for (const Frame* frame : _frames) frame->getTransformInGround(s);
+
+    // Each path writes only to its own cache variables and to those of its
+    // PathPoints and PathWraps.
+    const std::function<void(int)> computePath = [&](int i) {
+        if (!_geometryPaths[i]->getSharedPath())
+            _geometryPaths[i]->getLength(s);
+    };
+    ThreadPool::parallelFor((int)_geometryPaths.size(), _numThreadsForPaths,
+                            computePath);
+}
+
+//_____________________________________________________________________________
+/*
+ * Evaluate many states.
+ */
+SimTK::Matrix Model::calcPathLengths(const std::vector<SimTK::State>& states,
+                                     int numThreads) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(numThreads) + ".");
+    return evaluateStates(states, (int)_geometryPaths.size(), numThreads,
+        [this](const State& s, int i, Matrix& lengths) {
+            realizePosition(s);
+            for (int j = 0; j < (int)_geometryPaths.size(); ++j)
+                lengths(i, j) = _geometryPaths[j]->getLength(s);
+        });
+}
+
+SimTK::Matrix Model::calcActuatorForces(
+        const std::vector<SimTK::State>& states, int numThreads) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(numThreads) + ".");
+    std::vector<const ScalarActuator*> actuators;
+    const Set<Actuator>& allActuators = getActuators();
+    for (int j = 0; j < allActuators.getSize(); ++j) {
+        const auto* actuator =
+            dynamic_cast<const ScalarActuator*>(&allActuators.get(j));
+        if (actuator) actuators.push_back(actuator);
+    }
+    return evaluateStates(states, (int)actuators.size(), numThreads,
+        [this, &actuators](const State& s, int i, Matrix& forces) {
+            realizeDynamics(s);
+            for (int j = 0; j < (int)actuators.size(); ++j)
+                forces(i, j) = actuators[j]->getActuation(s);
+        });
+}
+
+SimTK::Matrix Model::calcAccelerations(const std::vector<SimTK::State>& states,
+                                       int numThreads) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(numThreads) + ".");
+    return evaluateStates(states, getNumSpeeds(), numThreads,
+        [this](const State& s, int i, Matrix& udots) {
+            realizeAcceleration(s);
+            udots.updRow(i) = ~s.getUDot();
+        });
+}
+
+void Model::computeActivationDerivatives(const SimTK::State& s) const
+{
+    const int n = (int)_firstOrderActivationMuscles.size();
+    if (n == 0) return;
+
+    // Gather the activations and excitations of the muscles whose
+    // derivatives are not simply zero.
+    SimTK::Array_<int> muscleIndices;
+    SimTK::Array_<double> activations, excitations;
+    muscleIndices.reserve(n);
+    activations.reserve(n);
+    excitations.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const Muscle& muscle = *_firstOrderActivationMuscles[i];
+        if (!muscle.appliesForce(s) || muscle.isActuationOverridden(s))
+            continue;
+        muscleIndices.push_back(i);
+        activations.push_back(muscle.getActivation(s));
+        excitations.push_back(muscle.getExcitation(s));
+    }
+
+    // The derivatives of MuscleFirstOrderActivationDynamicModel, without
+    // branches: both excitation and activation are clamped to
+    // [minimum activation, 1], and the time constant depends on whether the
+    // muscle is activating or deactivating.
+    const int m = (int)muscleIndices.size();
+    SimTK::Array_<double> derivatives(m);
+    for (int j = 0; j < m; ++j) {
+        const int i = muscleIndices[j];
+        const double amin = _minimumActivations[i];
+        const double a = std::min(std::max(activations[j], amin), 1.0);
+        const double u = std::min(std::max(excitations[j], amin), 1.0);
+        const double f = 0.5 + 1.5*a;
+        const double tau = u > a ? _activationTimeConstants[i]*f
+                                 : _deactivationTimeConstants[i]/f;
+        derivatives[j] = (u - a)/tau;
+    }
+
+    for (int j = 0; j < m; ++j) {
+        _firstOrderActivationMuscles[muscleIndices[j]]->
+            _activationDerivativeCV.setValue(s, derivatives[j]);
+    }
+}
+
 /**
  * Compute the derivatives of the generalized coordinates and speeds.
  */
@@ -61,6 +61,7 @@ class Controller;
 class CoordinateSet;
 class Force;
 class Frame;
+class GeometryPath;
 class Muscle;
 class Storage;
 class ScaleSet;
@@ -124,6 +125,23 @@ related objects are maintained in a runtime section of the Model object. You
 can also ask a Model to provide visualization using the setUseVisualizer()
 method, in which case it will allocate an maintain a ModelVisualizer.
 
+Once initSystem() has returned, one Model and its System can be shared by
+several threads, as long as each thread works with its own SimTK::State (e.g.,
+a copy of the state returned by initSystem()). Realizing a state and the const
+methods of the Model and its components that compute quantities from a state
+(forces, controls, muscle and path lengths, wrapping, moment arms, and so on)
+write only to the cache of that state; anything else they compute lazily is
+created at most once and under a lock. This does not extend to:
+ - methods that modify the Model (setting properties, adding components,
+   initSystem(), scaling), which must not run while other threads use it;
+ - the working state of the Model (getWorkingState()) and objects that keep
+   a state of their own, such as solvers, Managers and analyses, which each
+   belong to one thread at a time;
+ - the value of an Output, which is returned by reference to storage in the
+   Output, so the same Output (or an Input connected to it) must not be
+   evaluated by two threads at once;
+ - visualization.
+
 @authors Frank Anderson, Peter Loan, Ayman Habib, Ajay Seth, Michael Sherman
 @see ModelComponent, ModelVisualizer, SimTK::System
 **/
@@ -323,7 +341,15 @@ public:
     this call, you may obtain a writable reference to the System using 
     updMultibodySystem() which you can use to make any additions you want. Then 
     when the System is complete, call initializeState() to finalize it and 
-    obtain an initial State. **/
+    obtain an initial State.
+
+    If the %Model already has a System and the only components edited since
+    it was built allow it (e.g., Stations, Markers and PathPoints that were
+    moved), just those components are finalized and connected again and the
+    System, along with any additions you made to it, is kept; see
+    Component::finalizeChangesInSystem(). Edit them through updComponent(),
+    as editing them through the properties of their owners (e.g.,
+    updForceSet()) marks the owners as edited too. **/
     void buildSystem();
 
     /** After buildSystem() has been called, and any additional modifications
@@ -348,6 +374,28 @@ public:
         return initializeState();
     }
 
+    /** Wall-clock times, in seconds, spent in the phases of the most recent
+    buildSystem() and initializeState() (i.e., of initSystem()). Use these to
+    find out where the startup time of a large model goes. **/
+    struct InitSystemTimes {
+        /// finalizeFromProperties() of the model and its components.
+        double finalizeFromProperties = 0;
+        /// finalizeConnections(): connecting the Sockets and Inputs of all
+        /// components and building the multibody tree.
+        double finalizeConnections = 0;
+        /// Creating the MultibodySystem, i.e., extendAddToSystem() of all
+        /// components.
+        double addToSystem = 0;
+        /// realizeTopology() of the MultibodySystem.
+        double realizeTopology = 0;
+        /// The rest of initializeState(): initializing the state from the
+        /// properties of the components and assembling the model.
+        double initializeState = 0;
+    };
+    /** The times spent in the phases of the most recent initSystem(). **/
+    const InitSystemTimes& getInitSystemTimes() const
+    {   return _initSystemTimes; }
+
 
     /** Convenience method that returns a reference to the model's 'working'
     state. This is just returning the reference that was returned by 
@@ -394,6 +442,17 @@ public:
      * to weight that coordinate value more heavily if specified.
      */
     void assemble(SimTK::State& state, const Coordinate *coord = NULL, double weight = 10);
+#ifndef SWIG
+    /**
+     * Find the kinematic state of the model that satisfies constraints and
+     * coordinate goals, as assemble() does, weighting the values of several
+     * coordinates that were just set (e.g., by CoordinateSet::setValues())
+     * with the given weights, one per coordinate.
+     */
+    void assemble(SimTK::State& state,
+                  const SimTK::Array_<const Coordinate*>& coords,
+                  const SimTK::Array_<double>& weights);
+#endif
 
 
     /**
@@ -489,6 +548,49 @@ public:
     for reporting and cannot affect subsequent simulation behavior. **/
     void realizeReport(const SimTK::State& state) const;
 
+    /** (Advanced) Set the number of threads used to compute the paths of the
+    GeometryPaths in this %Model (e.g., of its muscles and ligaments). With
+    one thread (the default), each path is computed on the thread that first
+    needs its length. With more threads, the paths that have not been
+    computed yet are computed in parallel as soon as the state is realized
+    to Stage::Position by realizePosition(), or on the way to
+    Stage::Velocity by any realization (e.g., during a simulation). This pays
+    off for models with many paths that wrap. The threads are those of the
+    ThreadPool, which may limit their number. */
+    void setNumThreadsForPaths(int numThreads);
+    /** The number of threads used to compute the paths of the GeometryPaths
+    in this %Model. @see setNumThreadsForPaths() */
+    int getNumThreadsForPaths() const { return _numThreadsForPaths; }
+
+    /**@}**/
+
+    /**@name  Evaluate Many States
+    Methods in this section evaluate this %Model at many states at once
+    (e.g., the samples of a Monte Carlo analysis or the perturbed states of
+    finite differences), which must all have been created by this %Model's
+    System. Each row of the returned matrix holds the results for one state,
+    so that each column holds one quantity for all the states contiguously.
+    If `numThreads` is greater than 1, the states are divided into that many
+    contiguous ranges, each realized on its own thread; all threads share
+    this %Model, and each state is realized by one thread only. Each state
+    is realized only as far as needed, and its cache keeps the results. **/
+    /**@{**/
+
+    /** The length of each GeometryPath of this %Model (e.g., of its muscles
+    and ligaments) at each state, in the order of
+    getComponentList<GeometryPath>(). **/
+    SimTK::Matrix calcPathLengths(const std::vector<SimTK::State>& states,
+                                  int numThreads = 1) const;
+    /** The actuation (e.g., the tendon force of a Muscle) of each
+    ScalarActuator of this %Model at each state, in the order of
+    getActuators(), skipping the actuators that are not ScalarActuators. **/
+    SimTK::Matrix calcActuatorForces(const std::vector<SimTK::State>& states,
+                                     int numThreads = 1) const;
+    /** The generalized accelerations (udot) at each state, which result from
+    the forces of all actuators and other forces of this %Model. **/
+    SimTK::Matrix calcAccelerations(const std::vector<SimTK::State>& states,
+                                    int numThreads = 1) const;
+
     /**@}**/
 
     //--------------------------------------------------------------------------
@@ -987,6 +1089,8 @@ public:
     void extendConnectToModel(Model& model)  override;
     void extendAddToSystem(SimTK::MultibodySystem& system) const override; 
     void extendInitStateFromProperties(SimTK::State& state) const override;
+    void extendRealizeVelocity(const SimTK::State& state) const override;
+    void extendRealizeAcceleration(const SimTK::State& state) const override;
     /**@}**/
 
     /**
@@ -1026,6 +1130,15 @@ private:
 
     void createAssemblySolver(const SimTK::State& s);
 
+    // Compute the GeometryPaths that have not been computed yet for the given
+    // state, which is realized to Stage::Position, on the ThreadPool.
+    void computePathsInParallel(const SimTK::State& s) const;
+
+    // Compute the activation derivatives of the muscles with first-order
+    // activation dynamics together, for a state realized to Stage::Dynamics,
+    // into the cache variables the muscles read them from.
+    void computeActivationDerivatives(const SimTK::State& s) const;
+
     // To provide access to private _modelComponents member.
     friend class Component; 
 
@@ -1086,6 +1199,29 @@ private:
     // Global flag used to disable all Controllers.
     bool _allControllersEnabled;
 
+    // Times spent in the phases of the last buildSystem()/initializeState().
+    InitSystemTimes _initSystemTimes;
+
+    // Number of threads used to compute the GeometryPaths.
+    int _numThreadsForPaths;
+    // The GeometryPaths and Frames of the model, collected when it is
+    // connected so that realizations need not search for them.
+    SimTK::ResetOnCopy<std::vector<const GeometryPath*>> _geometryPaths;
+    SimTK::ResetOnCopy<std::vector<const Frame*>> _frames;
+    // All components of the model, in the order of getComponentList(),
+    // collected when it is connected so that each frame drawn need not
+    // search for them.
+    SimTK::ResetOnCopy<std::vector<const Component*>> _components;
+    // The Controllers of the model, collected when it is connected so that
+    // computeControls() need not search for them.
+    SimTK::ResetOnCopy<std::vector<const Controller*>> _controllers;
+    // The Muscles with first-order activation dynamics and the parameters of
+    // their dynamics, one entry per muscle in each array.
+    SimTK::ResetOnCopy<std::vector<const Muscle*>> _firstOrderActivationMuscles;
+    SimTK::Array_<double> _minimumActivations;
+    SimTK::Array_<double> _activationTimeConstants;
+    SimTK::Array_<double> _deactivationTimeConstants;
+
 
     //                      SIMBODY MULTIBODY SYSTEM
     // We dynamically allocate these because they are not available at
@@ -0,0 +1,192 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ModelCache.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ModelCache.h"
+#include "Model.h"
+#include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/version.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace OpenSim;
+
+namespace {
+    // 64-bit FNV-1a, which unlike std::hash gives the same keys in every
+    // process and on every platform.
+    std::uint64_t hashBytes(const char* data, std::size_t size,
+                            std::uint64_t hash = 14695981039346656037ULL)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // The cache from which Tools load their models.
+    std::mutex toolCacheMutex;
+    std::shared_ptr<ModelCache> toolCache;
+}
+
+//=============================================================================
+// CONSTRUCTOR
+//=============================================================================
+ModelCache::ModelCache(const std::string& cacheDirectory) :
+    _cacheDirectory(cacheDirectory)
+{
+}
+
+ModelCache::~ModelCache() = default;
+
+//=============================================================================
+// KEYS
+//=============================================================================
+std::string ModelCache::computeKey(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    OPENSIM_THROW_IF(!file, Exception,
+        "ModelCache: could not open file '" + fileName + "'.");
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string data = contents.str();
+
+    std::ostringstream version;
+    version << GetVersion() << ":" << XMLDocument::getLatestVersion();
+    const std::string versionString = version.str();
+
+    std::uint64_t hash = hashBytes(data.data(), data.size());
+    hash = hashBytes(versionString.data(), versionString.size(), hash);
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+std::string ModelCache::getCacheFileName(const std::string& fileName) const
+{
+    if (_cacheDirectory.empty()) return "";
+    return _cacheDirectory + "/" + computeKey(fileName) + ".osim";
+}
+
+//=============================================================================
+// LOADING
+//=============================================================================
+Model* ModelCache::loadModel(const std::string& fileName)
+{
+    const std::string key = computeKey(fileName);
+    // Files with the same contents in different directories may refer to
+    // different geometry files, so they are cached separately.
+    const std::string path = SimTK::Pathname::getAbsolutePathname(fileName);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _models.find(path + "|" + key);
+    if (it == _models.end()) {
+        it = _models.emplace(path + "|" + key,
+                             readModel(fileName, key)).first;
+    }
+
+    Model* model = it->second->clone();
+    model->setInputFileName(fileName);
+    return model;
+}
+
+std::unique_ptr<Model> ModelCache::readModel(const std::string& fileName,
+                                             const std::string& key) const
+{
+    std::unique_ptr<Model> model;
+    if (_cacheDirectory.empty()) {
+        model.reset(new Model(fileName));
+        return model;
+    }
+
+    const std::string cacheFileName = _cacheDirectory + "/" + key + ".osim";
+    if (std::ifstream(cacheFileName)) {
+        try {
+            // Finalize only once the model knows where its original file is,
+            // so that it finds the files it refers to.
+            model.reset(new Model(cacheFileName, false));
+            model->setInputFileName(fileName);
+            model->finalizeFromProperties();
+            return model;
+        }
+        catch (const std::exception& e) {
+            std::cout << "ModelCache: ignoring '" << cacheFileName
+                      << "' because:\n" << e.what() << std::endl;
+        }
+    }
+
+    model.reset(new Model(fileName));
+    // Write to a temporary file first so that other processes never read a
+    // partially written model.
+    const std::string partialFileName = cacheFileName + ".part";
+    if (!model->print(partialFileName) ||
+            std::rename(partialFileName.c_str(), cacheFileName.c_str()) != 0) {
+        std::remove(partialFileName.c_str());
+        std::cout << "ModelCache: could not write '" << cacheFileName << "'."
+                  << std::endl;
+    }
+    return model;
+}
+
+//=============================================================================
+// ACCESS
+//=============================================================================
+int ModelCache::getNumModels() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int)_models.size();
+}
+
+void ModelCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _models.clear();
+}
+
+//=============================================================================
+// TOOLS
+//=============================================================================
+void ModelCache::setToolCache(std::shared_ptr<ModelCache> cache)
+{
+    std::lock_guard<std::mutex> lock(toolCacheMutex);
+    toolCache = std::move(cache);
+}
+
+std::shared_ptr<ModelCache> ModelCache::getToolCache()
+{
+    std::lock_guard<std::mutex> lock(toolCacheMutex);
+    return toolCache;
+}
+
+Model* ModelCache::loadToolModel(const std::string& fileName)
+{
+    const std::shared_ptr<ModelCache> cache = getToolCache();
+    if (cache) return cache->loadModel(fileName);
+    return new Model(fileName);
+}
@@ -0,0 +1,145 @@
+#ifndef OPENSIM_MODEL_CACHE_H_
+#define OPENSIM_MODEL_CACHE_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ModelCache.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace OpenSim {
+
+class Model;
+
+//=============================================================================
+//=============================================================================
+/**
+ * A cache of the Models loaded from .osim files, for programs (e.g., batch
+ * jobs) that load the same models many times.
+ *
+ * Models are identified by the absolute path of the file and a key computed
+ * from its contents and the version of OpenSim, so a file that changes is
+ * loaded again. The first
+ * time a file is loaded, the Model is read, updated to the latest file
+ * version and finalized. The cache keeps this Model and returns copies of it
+ * when the file is loaded again, which skips reading and parsing the file
+ * altogether. The copies share the meshes already loaded by the Model.
+ *
+ * If a cache directory is given, each loaded Model is also written there,
+ * updated to the latest file version and named by its key. Other caches using
+ * the same directory, including those of other processes, then read that file
+ * instead of the original one, which skips updating files written by older
+ * versions of OpenSim; this is often most of the time spent loading them.
+ * Relative paths in the Model (e.g., to geometry files) are still resolved
+ * relative to the directory of the original file.
+ *
+ * @code
+ * ModelCache cache("/tmp/osim_cache");
+ * for (const auto& trial : trials) {
+ *     std::unique_ptr<Model> model(cache.loadModel("gait2392.osim"));
+ *     ...
+ * }
+ * @endcode
+ *
+ * The Tools that load a model_file (e.g., InverseKinematicsTool,
+ * InverseDynamicsTool, AnalyzeTool and the other tools derived from
+ * AbstractTool, and the GenericModelMaker of ScaleTool) load it through
+ * loadToolModel(). Long-running programs that run many Tools (e.g., a
+ * service that processes one trial per job) can set a process-wide cache for
+ * them with setToolCache(), so that each job after the first copies the
+ * Model instead of reading the file:
+ *
+ * @code
+ * ModelCache::setToolCache(std::make_shared<ModelCache>());
+ * for (const auto& setupFile : jobs)
+ *     InverseKinematicsTool(setupFile).run();
+ * @endcode
+ *
+ * All the methods may be called concurrently.
+ */
+class OSIMSIMULATION_API ModelCache {
+public:
+    /** Create an empty cache. If a directory is given, the cache also reuses
+    and writes the models in this directory, which must exist. */
+    explicit ModelCache(const std::string& cacheDirectory = "");
+
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    ~ModelCache();
+
+    /** Load the Model in the given file, from this cache if possible. The
+    Model has been finalized from its properties but not yet initialized.
+    @return a heap-allocated Model owned by the caller */
+    Model* loadModel(const std::string& fileName);
+
+    /** The key that identifies the contents of the given file to the cache.
+    It is a hexadecimal string that also depends on the version of OpenSim. */
+    static std::string computeKey(const std::string& fileName);
+
+    /** The file in the cache directory that would hold the Model in the given
+    file, or an empty string if there is no cache directory. */
+    std::string getCacheFileName(const std::string& fileName) const;
+
+    const std::string& getCacheDirectory() const { return _cacheDirectory; }
+
+    /** The number of Models held in memory by this cache. */
+    int getNumModels() const;
+
+    /** Forget the Models held in memory. Files in the cache directory are
+    kept. */
+    void clear();
+
+    /** %Set the cache from which Tools load their models (see
+    loadToolModel()), or nullptr (the default) for the Tools to read each
+    model file. The Tools running when the cache is replaced keep using the
+    previous one. */
+    static void setToolCache(std::shared_ptr<ModelCache> cache);
+    /** The cache from which Tools load their models, if any. */
+    static std::shared_ptr<ModelCache> getToolCache();
+
+    /** Load the Model in the given file for a Tool: from the cache set with
+    setToolCache(), or by reading the file if there is none. A relative path
+    is relative to the current working directory.
+    @return a heap-allocated Model owned by the caller */
+    static Model* loadToolModel(const std::string& fileName);
+
+private:
+    // Read the Model in the given file, from the cache directory if possible.
+    std::unique_ptr<Model> readModel(const std::string& fileName,
+                                     const std::string& key) const;
+
+    std::string _cacheDirectory;
+    std::map<std::string, std::unique_ptr<Model>> _models;
+    mutable std::mutex _mutex;
+
+//=============================================================================
+};  // END of class ModelCache
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MODEL_CACHE_H_
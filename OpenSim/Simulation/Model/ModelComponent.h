@@ -108,6 +108,29 @@ public:
      */
     Model& updModel();
 
+    /** (Advanced) Declare which variables the dynamics of this component
+    depend on, so that the Jacobian of the dynamics of the Model can be found
+    with few evaluations (see ImplicitDynamicsJacobian). Append to
+    `yIndices` the indices, in the system's state vector Y = [q; u; z], and
+    to `controlIndices` the indices, in the Model's controls, of the
+    variables on which the derivatives of the state variables of this
+    component, and the forces it applies, depend. Append to `uIndices` the
+    indices of the generalized speeds whose mobilities its forces act on.
+    Indices may be repeated. The state has been realized to
+    Stage::Instance.
+
+    Return false, as this base class does, if the dependencies are not
+    known. The derivatives of the state variables of such a component are
+    then taken to depend on all variables; and a Force without state
+    variables is taken to act on all mobilities with a force that depends
+    only on the generalized coordinates and speeds. A component whose force
+    or derivatives depend on the state variables of another component must
+    declare them. */
+    virtual bool findDynamicsDependencies(const SimTK::State& s,
+            std::vector<int>& yIndices, std::vector<int>& controlIndices,
+            std::vector<int>& uIndices) const
+    {   return false; }
+
 protected:
 template <class T> friend class ModelComponentSet;
     /** @name           ModelComponent Basic Interface
@@ -26,9 +26,12 @@
 #include <OpenSim/version.h>
 #include <OpenSim/Common/ModelDisplayHints.h>
 #include <simbody/internal/Visualizer_InputListener.h>
-#include <simbody/internal/Visualizer_Reporter.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 using std::string;
 #include <iostream>
 using std::cout; using std::cerr; using std::clog; using std::endl;
@@ -127,16 +130,134 @@ void DefaultGeometry::generateDecorations
                                state, geometry);
 }
 
+// This replaces the Visualizer's own Reporter so that the frames shown during
+// a simulation also go through ModelVisualizer::show().
+class ShowReporter : public PeriodicEventReporter {
+public:
+    ShowReporter(const OpenSim::ModelVisualizer& viz, Real interval)
+    :   PeriodicEventReporter(interval), _viz(viz) {}
+    void handleEvent(const State& state) const override {
+        _viz.show(state);
+    }
+private:
+    const OpenSim::ModelVisualizer& _viz;
+};
+
+//==============================================================================
+//                           BACKGROUND RENDERER
+//==============================================================================
+// A thread that draws the latest frame posted to it, at most once per
+// interval. A frame posted before the previous one was drawn replaces it.
+struct ModelVisualizer::BackgroundRenderer {
+    BackgroundRenderer(const ModelVisualizer& viz, const State& state,
+                       double maxFrameRate)
+    :   viz(viz), state(state),
+        interval(std::chrono::duration<double>(1/maxFrameRate)) {
+        thread = std::thread(&BackgroundRenderer::render, this);
+    }
+
+    ~BackgroundRenderer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_one();
+        thread.join();
+    }
+
+    void post(const State& s) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            time = s.getTime();
+            y = s.getY();
+            pending = true;
+        }
+        wake.notify_one();
+    }
+
+private:
+    void render() {
+        auto next = std::chrono::steady_clock::now();
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stop || pending; });
+                // Frames posted while waiting out the interval replace the
+                // pending one.
+                if (wake.wait_until(lock, next, [this] { return stop; }))
+                    return;
+                state.setTime(time);
+                state.updY() = y;
+                pending = false;
+            }
+            next = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        interval);
+            try {
+                viz.draw(state);
+            } catch (const std::exception& e) {
+                cout << "ModelVisualizer: failed to draw frame at time "
+                     << state.getTime() << ": " << e.what() << endl;
+            }
+        }
+    }
+
+    const ModelVisualizer& viz;
+    State state;
+    const std::chrono::duration<double> interval;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stop = false;
+    bool pending = false;
+    double time = 0;
+    Vector y;
+    std::thread thread;
+};
+
 //==============================================================================
 //                            MODEL VISUALIZER
 //==============================================================================
 
+ModelVisualizer::ModelVisualizer(Model& model)
+:   _model(model), _viz(0), _renderInBackground(false), _maxFrameRate(30) {
+    clear();
+    createVisualizer();
+}
+
+ModelVisualizer::~ModelVisualizer() {
+    // Stop drawing before the Visualizer goes away.
+    _renderer.reset();
+    clear();
+}
+
 void ModelVisualizer::show(const SimTK::State& state) const {
+    if (!_renderInBackground) {
+        draw(state);
+        return;
+    }
+    if (!_renderer)
+        _renderer.reset(new BackgroundRenderer(*this, state, _maxFrameRate));
+    _renderer->post(state);
+}
+
+void ModelVisualizer::draw(const SimTK::State& state) const {
     // Make sure we're realized at least through Velocity stage.
     _model.getMultibodySystem().realize(state, SimTK::Stage::Velocity);
     getSimbodyVisualizer().report(state);
 }
 
+void ModelVisualizer::setRenderInBackground(bool inBackground,
+                                            double maxFrameRate) {
+    OPENSIM_THROW_IF(maxFrameRate <= 0, OpenSim::Exception,
+        "Expected a positive frame rate, but got " +
+        std::to_string(maxFrameRate) + ".");
+    // Any render thread finishes the frame it is drawing.
+    _renderer.reset();
+    _renderInBackground = inBackground;
+    _maxFrameRate = maxFrameRate;
+}
+
 // See if we can find the given file. The rules are
 //  - if it is an absolute pathname, we only get one shot, else:
 //  - define "modelDir" to be the absolute pathname of the 
@@ -263,7 +384,7 @@ void ModelVisualizer::createVisualizer() {
     // This is used for regular output of frames during forward dynamics.
     // TODO: allow user control of timing.
     _model.updMultibodySystem().addEventReporter
-        (new SimTK::Visualizer::Reporter(*_viz, 1./30));
+        (new ShowReporter(*this, 1./30));
 }
 
 // We also rummage through the model to find fixed geometry that should be part
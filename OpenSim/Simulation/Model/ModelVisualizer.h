@@ -31,6 +31,8 @@ that uses the OpenSim API. **/
 #include <OpenSim/Simulation/osimSimulationDLL.h>
 #include <simbody/internal/Visualizer.h>
 
+#include <memory>
+
 namespace OpenSim {
 class Model;
 }
@@ -109,14 +111,33 @@ instructions on what to display.
 class OSIMSIMULATION_API ModelVisualizer {
 public:
 
-    ~ModelVisualizer() {clear();}
+    ~ModelVisualizer();
 
     /** @name                Drawing methods
     Currently there is just a single method for generating a frame. **/
     /**@{**/
     /** Evaluate the geometry needed to visualize the given \a state and
-    use it to generate a new image in the Visualizer window. **/
+    use it to generate a new image in the Visualizer window. If frames are
+    rendered in the background (see setRenderInBackground()), this only
+    copies the time and state variables of \a state for the render thread
+    and returns without waiting for the frame to be drawn. **/
     void show(const SimTK::State& state) const;
+
+    /** Render the frames given to show(), including those shown periodically
+    during a simulation, on a separate thread, so that the caller never waits
+    for the geometry to be evaluated and drawn. The render thread draws at
+    most \a maxFrameRate frames per second, always the latest frame given to
+    show(); the frames given in between are dropped. The render thread uses
+    its own copy of the first state given to show(), into which it copies
+    the time and the state variables (q, u and z) of each frame it draws;
+    each frame is realized on that copy while the simulation continues. The
+    %Model creates a new %ModelVisualizer whenever its System is built, so
+    call this after initSystem(). Set \a inBackground to false to draw each
+    frame in show() again. **/
+    void setRenderInBackground(bool inBackground, double maxFrameRate = 30);
+    /** Whether frames are rendered on a separate thread.
+    @see setRenderInBackground() **/
+    bool getRenderInBackground() const {return _renderInBackground;}
     /**@}**/
 
     /** @name       Access to SimTK::Visualizer features
@@ -203,10 +224,7 @@ private:
     // Only Model is permitted to create one of these. Note that
     // this will cause modifications to System that must occur prior to 
     // realizeTopology().
-    ModelVisualizer(Model& model) : _model(model), _viz(0) {
-        clear();
-        createVisualizer();
-    }
+    ModelVisualizer(Model& model);
 
     // Called from Model's initSystem() method; state must be realized 
     // through Instance stage.
@@ -219,6 +237,9 @@ private:
 
     void createVisualizer();
 
+    // Evaluate the geometry for the given state and draw it.
+    void draw(const SimTK::State& state) const;
+
 private:
     Model&                       _model;
     SimTK::Visualizer*           _viz;
@@ -227,6 +248,13 @@ private:
     // This is just a reference -- it is owned by the Simbody Visualizer so 
     // don't delete it!
     SimTK::Visualizer::InputSilo*   _silo;
+
+    // The render thread and the latest frame it has not drawn yet; created by
+    // the first show() after setRenderInBackground(true).
+    struct BackgroundRenderer;
+    bool                                        _renderInBackground;
+    double                                      _maxFrameRate;
+    mutable std::unique_ptr<BackgroundRenderer> _renderer;
 };
 
 
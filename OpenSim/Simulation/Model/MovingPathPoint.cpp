@@ -27,6 +27,8 @@
 #include "MovingPathPoint.h"
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/MultiplierFunction.h>
+#include <OpenSim/Common/SimmMacros.h>
+#include <OpenSim/Common/SimmSpline.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
 
 
@@ -109,6 +111,12 @@ void MovingPathPoint::setZCoordinate(const Coordinate& coordinate)
     connectSocket_z_coordinate(coordinate);
 }
 
+void MovingPathPoint::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+    buildLocationSpline();
+}
+
 void MovingPathPoint::extendConnectToModel(Model& model)
 {
     Super::extendConnectToModel(model);
@@ -146,6 +154,15 @@ void MovingPathPoint::extendConnectToModel(Model& model)
     set_location(SimTK::Vec3(SimTK::NaN));
 }
 
+void MovingPathPoint::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    _localLocationCV = addCacheVariable<Vec3>("local_location", Vec3(0),
+        SimTK::Stage::Position);
+    _dPointdQCV = addCacheVariable<Vec3>("dpoint_dq", Vec3(0),
+        SimTK::Stage::Position);
+}
+
 //_____________________________________________________________________________
 /*
  * Override default implementation by Object to intercept and fix the XML node
@@ -190,103 +207,202 @@ void MovingPathPoint::updateFromXMLNode(SimTK::Xml::Element& aNode, int versionN
 
 SimTK::Vec3 MovingPathPoint::getLocation(const SimTK::State& s) const
 {
-    SimTK::Vec3 pInF(0);
-    if (!_xCoordinate.empty()) {
-        const double xval = SimTK::clamp(_xCoordinate->getRangeMin(),
-            _xCoordinate->getValue(s),
-            _xCoordinate->getRangeMax());
-        pInF[0] = get_x_location().calcValue(SimTK::Vector(1, xval));
-    }
-    else // assume a Constant
-        pInF[0] = get_x_location().calcValue(SimTK::Vector(1, 0.0));
+    realizeLocation(s);
+    return _localLocationCV.getValue(s);
+}
 
-    if (!_yCoordinate.empty()) {
-        const double yval = SimTK::clamp(_yCoordinate->getRangeMin(),
-            _yCoordinate->getValue(s),
-            _yCoordinate->getRangeMax());
-        pInF[1] = get_y_location().calcValue(SimTK::Vector(1, yval));
-    }
-    else // type == Constant
-        pInF[1] = get_y_location().calcValue(SimTK::Vector(1, 0.0));
 
-    if (!_zCoordinate.empty()) {
-        const double zval = SimTK::clamp(_zCoordinate->getRangeMin(),
-            _zCoordinate->getValue(s),
-            _zCoordinate->getRangeMax());
-        pInF[2] = get_z_location().calcValue(SimTK::Vector(1, zval));
-    }
-    else // type == Constant
-        pInF[2] = get_z_location().calcValue(SimTK::Vector(1, 0.0));
+SimTK::Vec3 MovingPathPoint::getVelocity(const SimTK::State& s) const
+{
+    if (_xCoordinate.empty())
+        return Vec3(0);
 
-    return pInF;
+    //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
+    realizeLocation(s);
+    return _dPointdQCV.getValue(s) * _xCoordinate->getSpeedValue(s);
 }
 
-
-SimTK::Vec3 MovingPathPoint::getVelocity(const SimTK::State& s) const
+//_____________________________________________________________________________
+/*
+ * Get the derivative of the point's location in its Frame with respect to
+ * the coordinate.
+ */
+SimTK::Vec3 MovingPathPoint::getdPointdQ(const SimTK::State& s) const
 {
-    std::vector<int> derivComponents;
-    derivComponents.push_back(0);
+    realizeLocation(s);
+    return _dPointdQCV.getValue(s);
+}
 
-    SimTK::Vec3 vInF(0);
+void MovingPathPoint::realizeLocation(const SimTK::State& s) const
+{
+    if (_localLocationCV.isValid(s))
+        return;
 
-    if (!_xCoordinate.empty()){
-        //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        vInF[0] = get_x_location().calcDerivative(
-            derivComponents, SimTK::Vector(1, _xCoordinate->getValue(s)))*
-                _xCoordinate->getSpeedValue(s);
+    Vec3& location = _localLocationCV.updValue(s);
+    Vec3& dPointdQ = _dPointdQCV.updValue(s);
+    if (!_xCoordinate.empty()) {
+        // All the components depend on the same Coordinate. The location is
+        // clamped to the range of the Coordinate but its derivative is not.
+        const double value = _xCoordinate->getValue(s);
+        calcLocation(SimTK::clamp(_xCoordinate->getRangeMin(), value,
+                                  _xCoordinate->getRangeMax()),
+                     value, location, dPointdQ);
     }
-    else
-        vInF[0] = 0.0;
-
-    if (!_yCoordinate.empty()){
-        //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        vInF[1] = get_y_location().calcDerivative(
-            derivComponents, SimTK::Vector(1, _yCoordinate->getValue(s)))*
-                _yCoordinate->getSpeedValue(s);
+    else { // assume Constants
+        calcLocation(0.0, 0.0, location, dPointdQ);
+        dPointdQ = Vec3(0);
     }
-    else
-        vInF[1] = 0.0;
-
-    if (!_zCoordinate.empty()){
-        //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        vInF[2] = get_z_location().calcDerivative(
-            derivComponents, SimTK::Vector(1, _zCoordinate->getValue(s)))*
-                _zCoordinate->getSpeedValue(s);
+    _localLocationCV.markValid(s);
+    _dPointdQCV.markValid(s);
+}
+
+void MovingPathPoint::calcLocation(double value, double derivativeValue,
+        Vec3& location, Vec3& dPointdQ) const
+{
+    if (!_locationSpline.x.empty()) {
+        _locationSpline.calcValue(value, location, dPointdQ);
+        if (derivativeValue != value) {
+            Vec3 unused;
+            _locationSpline.calcValue(derivativeValue, unused, dPointdQ);
+        }
+        return;
     }
-    else
-        vInF[2] = 0.0;
 
-    return vInF;
+    location = Vec3(get_x_location().calcValue(value),
+                    get_y_location().calcValue(value),
+                    get_z_location().calcValue(value));
+
+    dPointdQ = Vec3(get_x_location().calcDerivative(derivativeValue, 1),
+                    get_y_location().calcDerivative(derivativeValue, 1),
+                    get_z_location().calcDerivative(derivativeValue, 1));
 }
 
 //_____________________________________________________________________________
 /*
- * Get the velocity of the point in the body's local reference frame.
+ * The location functions of most models are SimmSplines of the same
+ * coordinate samples, possibly scaled by MultiplierFunctions, along with
+ * Constants and SimmSplines of only 2 points, which are linear. Combine their
+ * coefficients so that all three components are evaluated together, which
+ * gives the same values as evaluating them one by one.
  */
-SimTK::Vec3 MovingPathPoint::getdPointdQ(const SimTK::State& s) const
+void MovingPathPoint::buildLocationSpline()
+{
+    _locationSpline = LocationSpline();
+
+    const Function* functions[3] =
+        { &get_x_location(), &get_y_location(), &get_z_location() };
+    // Each component is either a cubic spline or the line y0 + slope*(x-x0).
+    const SimmSpline* cubics[3] = { nullptr, nullptr, nullptr };
+    double scales[3] = { 1.0, 1.0, 1.0 };
+    double x0[3] = { 0.0, 0.0, 0.0 };
+    double y0[3] = { 0.0, 0.0, 0.0 };
+    double slopes[3] = { 0.0, 0.0, 0.0 };
+    const Array<double>* knots = nullptr;
+    for (int i = 0; i < 3; ++i) {
+        const Function* f = functions[i];
+        while (const auto* mf = dynamic_cast<const MultiplierFunction*>(f)) {
+            if (!mf->getFunction()) return;
+            scales[i] *= mf->getScale();
+            f = mf->getFunction();
+        }
+        if (const auto* constant = dynamic_cast<const Constant*>(f)) {
+            y0[i] = constant->getValue();
+        }
+        else if (const auto* spline = dynamic_cast<const SimmSpline*>(f)) {
+            // SimmSplines with fewer than 2 points evaluate to NaN.
+            if (spline->getSize() < 2 ||
+                    spline->getB().getSize() != spline->getSize())
+                return;
+            if (spline->getSize() == 2) {
+                x0[i] = spline->getX()[0];
+                y0[i] = spline->getY()[0];
+                slopes[i] = spline->getB()[0];
+                continue;
+            }
+            if (knots && !(spline->getX() == *knots))
+                return;
+            knots = &spline->getX();
+            cubics[i] = spline;
+        }
+        else
+            return;
+    }
+
+    LocationSpline& fused = _locationSpline;
+    // Without any cubic spline, the location is linear over [0, 1] and
+    // extrapolated with the same slope.
+    const int n = knots ? knots->getSize() : 2;
+    fused.x.resize(n);
+    fused.y.resize(n);
+    fused.b.resize(n);
+    fused.c.assign(n, Vec3(0));
+    fused.d.assign(n, Vec3(0));
+    for (int k = 0; k < n; ++k) {
+        fused.x[k] = knots ? (*knots)[k] : double(k);
+        for (int i = 0; i < 3; ++i) {
+            if (cubics[i]) {
+                fused.y[k][i] = scales[i] * cubics[i]->getY()[k];
+                fused.b[k][i] = scales[i] * cubics[i]->getB()[k];
+                fused.c[k][i] = scales[i] * cubics[i]->getC()[k];
+                fused.d[k][i] = scales[i] * cubics[i]->getD()[k];
+            }
+            else {
+                fused.y[k][i] =
+                    scales[i] * (y0[i] + (fused.x[k] - x0[i])*slopes[i]);
+                fused.b[k][i] = scales[i] * slopes[i];
+            }
+        }
+    }
+}
+
+// Same evaluation as SimmSpline::calcValue() and calcDerivative().
+void MovingPathPoint::LocationSpline::calcValue(double xval, Vec3& value,
+                                                Vec3& slope) const
 {
-    SimTK::Vec3 dPdq_B(0);
+    const int n = (int)x.size();
 
-    std::vector<int> derivComponents;
-    derivComponents.push_back(0);
+    // Extrapolate with the slope at the end points.
+    if (xval < x[0]) {
+        value = y[0] + (xval - x[0])*b[0];
+        slope = b[0];
+        return;
+    }
+    else if (xval > x[n-1]) {
+        value = y[n-1] + (xval - x[n-1])*b[n-1];
+        slope = b[n-1];
+        return;
+    }
 
-    if (!_xCoordinate.empty()){
-        //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        dPdq_B[0] = get_x_location().calcDerivative(derivComponents, 
-            SimTK::Vector(1, _xCoordinate->getValue(s)));
+    if (EQUAL_WITHIN_ERROR(xval, x[0])) {
+        value = y[0];
+        slope = b[0];
+        return;
     }
-    if (!_yCoordinate.empty()){
-        //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        dPdq_B[1] = get_y_location().calcDerivative(derivComponents,
-            SimTK::Vector(1, _yCoordinate->getValue(s)));
+    else if (EQUAL_WITHIN_ERROR(xval, x[n-1])) {
+        value = y[n-1];
+        slope = b[n-1];
+        return;
     }
-    if (!_zCoordinate.empty()){
-        //Multiply the partial (derivative of point coordinate w.r.t. gencoord) by genspeed
-        dPdq_B[2] = get_z_location().calcDerivative(derivComponents,
-            SimTK::Vector(1, _zCoordinate->getValue(s)));
+
+    int k = 0;
+    if (n >= 3) {
+        // Binary search for the two points xval is between.
+        int i = 0;
+        int j = n;
+        while (true) {
+            k = (i + j)/2;
+            if (xval < x[k])
+                j = k;
+            else if (xval > x[k+1])
+                i = k;
+            else
+                break;
+        }
     }
 
-    return dPdq_B;
+    const double dx = xval - x[k];
+    value = y[k] + dx*(b[k] + dx*(c[k] + dx*d[k]));
+    slope = b[k] + dx*(2.0*c[k] + 3.0*dx*d[k]);
 }
 
 
@@ -332,6 +448,7 @@ void MovingPathPoint::scale(const SimTK::Vec3& aScaleFactors)
         }
     }
 
+    buildLocationSpline();
     updateGeometry();
 }
 
@@ -108,7 +108,7 @@ public:
     bool isActive(const SimTK::State& s) const override { return true; }
 
     /** Get the local location of the MovingPathPoint in its Frame */
-    SimTK::Vec3 getLocation(const SimTK::State& s) const;
+    SimTK::Vec3 getLocation(const SimTK::State& s) const override;
     /** Get the local velocity of the MovingPathPoint w.r.t to and 
         expressed in its Frame. To get the velocity of the point w.r.t.
         and expressed in Ground, call getVelocityInGround(). */
@@ -120,7 +120,18 @@ public:
 
 private:
     void constructProperties();
+    void extendFinalizeFromProperties() override;
     void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+    // Fuse the location functions into _locationSpline, if possible.
+    void buildLocationSpline();
+    // The location at the given value of the coordinate and its derivative
+    // at the (possibly different) given value, from the location functions.
+    void calcLocation(double value, double derivativeValue,
+                      SimTK::Vec3& location, SimTK::Vec3& dPointdQ) const;
+    // Cache the location and its derivative with respect to the coordinate.
+    void realizeLocation(const SimTK::State& s) const;
 
     SimTK::Vec3 calcLocationInGround(const SimTK::State& state) const override;
     SimTK::Vec3 calcVelocityInGround(const SimTK::State& state) const override;
@@ -131,6 +142,20 @@ private:
     SimTK::ReferencePtr<const Coordinate> _yCoordinate;
     SimTK::ReferencePtr<const Coordinate> _zCoordinate;
 
+    // The location functions fused into one spline of Vec3 that shares the
+    // knots of the SimmSplines among them, evaluated with one search for the
+    // segment. Empty if the functions could not be fused.
+    struct LocationSpline {
+        std::vector<double> x;
+        std::vector<SimTK::Vec3> y, b, c, d;
+        void calcValue(double xval, SimTK::Vec3& value,
+                       SimTK::Vec3& slope) const;
+    };
+    LocationSpline _locationSpline;
+
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Vec3> > _localLocationCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Vec3> > _dPointdQCV;
+
 //=============================================================================
 };  // END of class MovingPathPoint
 //=============================================================================
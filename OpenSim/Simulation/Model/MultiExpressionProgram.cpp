@@ -0,0 +1,135 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  MultiExpressionProgram.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <Vendors/lepton/include/Lepton.h>
+
+#include "MultiExpressionProgram.h"
+#include <OpenSim/Common/Exception.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+using namespace std;
+using namespace OpenSim;
+
+namespace {
+    // Assigns a value index to each node of the expressions, after the
+    // variables, and adds the steps that compute them. A node equal to one
+    // already compiled reuses its index.
+    class ProgramBuilder {
+    public:
+        ProgramBuilder(const vector<string>& variables,
+                       vector<double>& initialValues)
+            : _variables(variables), _initialValues(initialValues) {}
+
+        template <typename AddStep>
+        int compile(const Lepton::ExpressionTreeNode& node, AddStep addStep) {
+            const Lepton::Operation& op = node.getOperation();
+            if (op.getId() == Lepton::Operation::VARIABLE) {
+                auto it = find(_variables.begin(), _variables.end(),
+                               op.getName());
+                OPENSIM_THROW_IF(it == _variables.end(), Exception,
+                    "Unknown variable '" + op.getName() + "' in expression.");
+                return (int)(it - _variables.begin());
+            }
+            for (const auto& compiled : _nodes)
+                if (compiled.first == node) return compiled.second;
+
+            vector<int> args;
+            for (const auto& child : node.getChildren())
+                args.push_back(compile(child, addStep));
+
+            const int index =
+                (int)(_variables.size() + _initialValues.size());
+            if (op.getId() == Lepton::Operation::CONSTANT) {
+                _initialValues.push_back(
+                    static_cast<const Lepton::Operation::Constant&>(op)
+                        .getValue());
+            } else {
+                _initialValues.push_back(0);
+                addStep(op, args, index);
+            }
+            _nodes.emplace_back(node, index);
+            return index;
+        }
+
+    private:
+        const vector<string>& _variables;
+        vector<double>& _initialValues;
+        vector<pair<Lepton::ExpressionTreeNode, int>> _nodes;
+    };
+}
+
+MultiExpressionProgram::MultiExpressionProgram(
+        const vector<string>& expressions, const vector<string>& variables)
+    : _numVariables((int)variables.size())
+{
+    auto addStep = [this](const Lepton::Operation& op,
+                          const vector<int>& args, int target) {
+        Step step;
+        step.operation.reset(op.clone());
+        step.args = args;
+        step.target = target;
+        _maxArgs = std::max(_maxArgs, (int)args.size());
+        _steps.push_back(step);
+    };
+    ProgramBuilder builder(variables, _initialValues);
+    for (const auto& expression : expressions) {
+        const Lepton::ParsedExpression parsed =
+            Lepton::Parser::parse(expression).optimize();
+        _resultIndices.push_back(
+            builder.compile(parsed.getRootNode(), addStep));
+    }
+    _numValues = _numVariables + (int)_initialValues.size();
+}
+
+void MultiExpressionProgram::evaluate(const double* variables,
+                                      double* results) const
+{
+    // The values live on the stack of the calling thread, unless there are
+    // too many of them.
+    static const map<string, double> noVariables;
+    const int size = _numValues + _maxArgs;
+    double local[64];
+    vector<double> allocated;
+    double* values = local;
+    if (size > 64) {
+        allocated.resize(size);
+        values = allocated.data();
+    }
+    double* args = values + _numValues;
+
+    std::copy(variables, variables + _numVariables, values);
+    std::copy(_initialValues.begin(), _initialValues.end(),
+              values + _numVariables);
+    for (const auto& step : _steps) {
+        for (int i = 0; i < (int)step.args.size(); ++i)
+            args[i] = values[step.args[i]];
+        values[step.target] = step.operation->evaluate(args, noVariables);
+    }
+    for (int i = 0; i < (int)_resultIndices.size(); ++i)
+        results[i] = values[_resultIndices[i]];
+}
@@ -0,0 +1,102 @@
+#ifndef OPENSIM_MULTI_EXPRESSION_PROGRAM_H_
+#define OPENSIM_MULTI_EXPRESSION_PROGRAM_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  MultiExpressionProgram.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Lepton {
+class Operation;
+}
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Several Lepton expressions of the same variables compiled into one program,
+ * for components that evaluate them together (e.g., the six expressions of an
+ * ExpressionBasedBushingForce).
+ *
+ * The expressions are parsed and optimized by Lepton, and their operations
+ * are laid out in a single array of values that starts with the variables.
+ * Subexpressions that appear more than once, in the same expression or in
+ * different ones, are evaluated only once. The variables are passed by their
+ * index in the list given to the constructor, rather than by name in a map as
+ * Lepton::ExpressionProgram requires.
+ *
+ * @code
+ * MultiExpressionProgram program({"3*q^2", "exp(-q^2)*qdot"}, {"q", "qdot"});
+ * double values[2];
+ * program.evaluate(SimTK::Vec2(q, qdot).getContiguousScalarData(), values);
+ * @endcode
+ *
+ * evaluate() may be called concurrently from several threads.
+ */
+class OSIMSIMULATION_API MultiExpressionProgram {
+public:
+    /** A program without any expression. */
+    MultiExpressionProgram() = default;
+    /** Compile the given expressions. They may only use the given variables,
+    otherwise an Exception is thrown. */
+    MultiExpressionProgram(const std::vector<std::string>& expressions,
+                           const std::vector<std::string>& variables);
+
+    int getNumExpressions() const { return (int)_resultIndices.size(); }
+    int getNumVariables() const { return _numVariables; }
+    /** The number of operations performed by evaluate(); operations shared
+    by several expressions are counted once. */
+    int getNumOperations() const { return (int)_steps.size(); }
+
+    /** Evaluate all the expressions.
+    @param variables  the values of the variables, in the order they were
+                      given to the constructor
+    @param results    filled with the values of the expressions, in the order
+                      they were given to the constructor */
+    void evaluate(const double* variables, double* results) const;
+
+private:
+    // One Operation, computing values[target] from the values at the
+    // indices in args.
+    struct Step {
+        std::shared_ptr<const Lepton::Operation> operation;
+        std::vector<int> args;
+        int target;
+    };
+
+    // The values are the variables, followed by the constants and the
+    // results of the steps, which start as the values in _initialValues.
+    std::vector<Step> _steps;
+    std::vector<double> _initialValues;
+    std::vector<int> _resultIndices;
+    int _numVariables = 0;
+    int _numValues = 0;
+    int _maxArgs = 0;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MULTI_EXPRESSION_PROGRAM_H_
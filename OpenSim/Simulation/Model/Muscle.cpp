@@ -145,6 +145,33 @@ void Muscle::setOptimalFiberLength(double aOptimalFiberLength)
 void Muscle::setTendonSlackLength(double aTendonSlackLength) 
 {   set_tendon_slack_length(aTendonSlackLength); }
 
+void Muscle::setMaxIsometricForce(SimTK::State& s, double maxIsometricForce)
+{
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+    const bool wasUpToDate = isObjectUpToDateWithProperties();
+    setMaxIsometricForce(maxIsometricForce);
+    _maxIsometricForce = maxIsometricForce;
+    invalidateParameterDependents(s, wasUpToDate);
+}
+
+void Muscle::setTendonSlackLength(SimTK::State& s, double tendonSlackLength)
+{
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+    const bool wasUpToDate = isObjectUpToDateWithProperties();
+    setTendonSlackLength(tendonSlackLength);
+    _tendonSlackLength = tendonSlackLength;
+    invalidateParameterDependents(s, wasUpToDate);
+}
+
+void Muscle::invalidateParameterDependents(SimTK::State& s, bool wasUpToDate)
+{
+    // The change has been applied in full, so it does not call for finalizing
+    // the muscle (and re-creating the System) again.
+    if (wasUpToDate)
+        setObjectIsUpToDateWithProperties();
+    s.invalidateAllCacheAtOrAbove(SimTK::Stage::Instance);
+}
+
 void Muscle::setPennationAngleAtOptimalFiberLength(double aPennationAngle)
 {   set_pennation_angle_at_optimal(aPennationAngle); }
 
@@ -182,14 +209,16 @@ void Muscle::extendConnectToModel(Model& aModel)
     //              both the position and velocity of the multibody system and
     //              the muscles path before solving for the fiber length and
     //              velocity in the reduced model.
-    addCacheVariable<Muscle::MuscleLengthInfo>
+    _lengthInfoCV = addCacheVariable<Muscle::MuscleLengthInfo>
        ("lengthInfo", MuscleLengthInfo(), SimTK::Stage::Velocity);
-    addCacheVariable<Muscle::FiberVelocityInfo>
+    _velInfoCV = addCacheVariable<Muscle::FiberVelocityInfo>
        ("velInfo", FiberVelocityInfo(), SimTK::Stage::Velocity);
-    addCacheVariable<Muscle::MuscleDynamicsInfo>
+    _dynamicsInfoCV = addCacheVariable<Muscle::MuscleDynamicsInfo>
        ("dynamicsInfo", MuscleDynamicsInfo(), SimTK::Stage::Dynamics);
-    addCacheVariable<Muscle::MusclePotentialEnergyInfo>
+    _potentialEnergyInfoCV = addCacheVariable<Muscle::MusclePotentialEnergyInfo>
        ("potentialEnergyInfo", MusclePotentialEnergyInfo(), SimTK::Stage::Velocity);
+    _activationDerivativeCV = addCacheVariable<double>
+       ("activationDerivative", 0.0, SimTK::Stage::Dynamics);
  }
 
 void Muscle::extendSetPropertiesFromState(const SimTK::State& state)
@@ -469,79 +498,89 @@ void Muscle::setExcitation(SimTK::State& s, double excitation) const
 /* Access to muscle calculation data structures */
 const Muscle::MuscleLengthInfo& Muscle::getMuscleLengthInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"lengthInfo")){
+    if(!_lengthInfoCV.isValid(s)){
         MuscleLengthInfo &umli = updMuscleLengthInfo(s);
         calcMuscleLengthInfo(s, umli);
-        markCacheVariableValid(s,"lengthInfo");
+        _lengthInfoCV.markValid(s);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return umli;
     }
-    return getCacheVariableValue<MuscleLengthInfo>(s, "lengthInfo");
+    return _lengthInfoCV.getValue(s);
 }
 
 Muscle::MuscleLengthInfo& Muscle::updMuscleLengthInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<MuscleLengthInfo>(s, "lengthInfo");
+    return _lengthInfoCV.updValue(s);
 }
 
 const Muscle::FiberVelocityInfo& Muscle::
 getFiberVelocityInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"velInfo")){
+    if(!_velInfoCV.isValid(s)){
         FiberVelocityInfo& ufvi = updFiberVelocityInfo(s);
         calcFiberVelocityInfo(s, ufvi);
-        markCacheVariableValid(s,"velInfo");
+        _velInfoCV.markValid(s);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return ufvi;
     }
-    return getCacheVariableValue<FiberVelocityInfo>(s, "velInfo");
+    return _velInfoCV.getValue(s);
 }
 
 Muscle::FiberVelocityInfo& Muscle::
 updFiberVelocityInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<FiberVelocityInfo>(s, "velInfo");
+    return _velInfoCV.updValue(s);
 }
 
 const Muscle::MuscleDynamicsInfo& Muscle::
 getMuscleDynamicsInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"dynamicsInfo")){
+    if(!_dynamicsInfoCV.isValid(s)){
         MuscleDynamicsInfo& umdi = updMuscleDynamicsInfo(s);
         calcMuscleDynamicsInfo(s, umdi);
-        markCacheVariableValid(s,"dynamicsInfo");
+        _dynamicsInfoCV.markValid(s);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return umdi;
     }
-    return getCacheVariableValue<MuscleDynamicsInfo>(s, "dynamicsInfo");
+    return _dynamicsInfoCV.getValue(s);
 }
 Muscle::MuscleDynamicsInfo& Muscle::
 updMuscleDynamicsInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<MuscleDynamicsInfo>(s, "dynamicsInfo");
+    return _dynamicsInfoCV.updValue(s);
 }
 
 const Muscle::MusclePotentialEnergyInfo& Muscle::
 getMusclePotentialEnergyInfo(const SimTK::State& s) const
 {
-    if(!isCacheVariableValid(s,"potentialEnergyInfo")){
+    if(!_potentialEnergyInfoCV.isValid(s)){
         MusclePotentialEnergyInfo& umpei = updMusclePotentialEnergyInfo(s);
         calcMusclePotentialEnergyInfo(s, umpei);
-        markCacheVariableValid(s,"potentialEnergyInfo");
+        _potentialEnergyInfoCV.markValid(s);
         // don't bother fishing it out of the cache since 
         // we just calculated it and still have a handle on it
         return umpei;
     }
-    return getCacheVariableValue<MusclePotentialEnergyInfo>(s, "potentialEnergyInfo");
+    return _potentialEnergyInfoCV.getValue(s);
 }
 
 Muscle::MusclePotentialEnergyInfo& Muscle::
 updMusclePotentialEnergyInfo(const SimTK::State& s) const
 {
-    return updCacheVariableValue<MusclePotentialEnergyInfo>(s, "potentialEnergyInfo");
+    return _potentialEnergyInfoCV.updValue(s);
+}
+
+bool Muscle::getBatchedActivationDerivative(const SimTK::State& s,
+                                            double& adot) const
+{
+    if (!_activationDerivativeCV.isAllocated() ||
+            !_activationDerivativeCV.isValid(s))
+        return false;
+    adot = _activationDerivativeCV.getValue(s);
+    return true;
 }
 
 
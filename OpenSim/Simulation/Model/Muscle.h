@@ -194,6 +194,19 @@ public:
     double getTendonSlackLength() const;
     void setTendonSlackLength(double tendonSlackLength);
 
+    /** Change the maximum isometric force or the tendon slack length of a
+    muscle whose System has already been created, without re-creating it with
+    initSystem(). Nothing else is derived from these parameters when the System
+    is created; they enter only the computations of the muscle. So the property
+    is changed in place, and the cache entries of the given state are
+    invalidated from Stage::Instance on, so that the next realization of the
+    state uses the new value. The System and the layout of its states are
+    unchanged. Note that the value is a property of the muscle, so it also
+    applies to any other state of the System once that state is realized
+    again. */
+    void setMaxIsometricForce(SimTK::State& s, double maxIsometricForce);
+    void setTendonSlackLength(SimTK::State& s, double tendonSlackLength);
+
     /** get/set the angle (in radians) between fibers at their optimal fiber length and the tendon */
     double getPennationAngleAtOptimalFiberLength() const;
     void setPennationAngleAtOptimalFiberLength(double pennationAngle);
@@ -287,7 +300,10 @@ public:
     double getTendonForce(const SimTK::State& s) const;
 
     /** get the current fiber stiffness (N/m) defined as the partial derivative
-        of fiber force w.r.t. fiber length */
+        of fiber force w.r.t. fiber length. Muscles whose curves have analytic
+        derivatives (e.g., Millard2012EquilibriumMuscle, Thelen2003Muscle)
+        compute this and the stiffnesses below exactly, so optimizers can use
+        them in place of finite differences of the muscle forces. */
     double getFiberStiffness(const SimTK::State& s) const;
     /**get the stiffness of the fiber (N/m) along the direction of the tendon,
     that is the partial derivative of the fiber force along the tendon with
@@ -320,6 +336,16 @@ public:
     void setExcitation(SimTK::State& s, double excitation) const;
     double getExcitation(const SimTK::State& s) const;
 
+    /** Muscles whose activation derivative is that of a
+    MuscleFirstOrderActivationDynamicModel return true along with the
+    parameters of their activation dynamics. The Model then computes the
+    activation derivatives of all such muscles together, in one loop, when it
+    is realized to Stage::Acceleration. The default returns false. */
+    virtual bool getFirstOrderActivationParameters(double& minimumActivation,
+            double& activationTimeConstant,
+            double& deactivationTimeConstant) const
+    {   return false; }
+
 
     /** DEPRECATED: only for backward compatibility */
     virtual void setActivation(SimTK::State& s, double activation) const = 0;
@@ -372,6 +398,12 @@ protected:
     const MusclePotentialEnergyInfo& getMusclePotentialEnergyInfo(const SimTK::State& s) const;
     MusclePotentialEnergyInfo& updMusclePotentialEnergyInfo(const SimTK::State& s) const;
 
+    /** If the Model has computed the activation derivative of this muscle
+    for the given state, together with those of its other muscles (see
+    getFirstOrderActivationParameters()), set adot to it and return true. */
+    bool getBatchedActivationDerivative(const SimTK::State& s,
+                                        double& adot) const;
+
     //--------------------------------------------------------------------------
     // CALCULATIONS
     //--------------------------------------------------------------------------
@@ -407,7 +439,9 @@ protected:
     velocities. For example, this can produce fiber lengths suited to 
     beginning a forward dynamics simulation. If you are missing any of that 
     information, don't call this method, use 
-    computeFiberEquilibriumAtZeroVelocity(). */
+    computeFiberEquilibriumAtZeroVelocity(). Implementations may use the fiber
+    length in the state (e.g., the solution at the previous time) as the
+    initial guess for the solution. */
     virtual void computeInitialFiberEquilibrium(SimTK::State& s) const = 0;
 
     /** Provide a quick estimate of the fiber length assuming the 
@@ -869,6 +903,24 @@ protected:
     double _pennationAngleAtOptimal;
     double _tendonSlackLength;
 
+private:
+    // Invalidate the results computed in the given state after a parameter
+    // of this muscle changed in place.
+    void invalidateParameterDependents(SimTK::State& s, bool wasUpToDate);
+
+    // Handles to the cache variables of this muscle, set in
+    // extendAddToSystem().
+    mutable SimTK::ResetOnCopy<CacheVariable<MuscleLengthInfo> > _lengthInfoCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<FiberVelocityInfo> > _velInfoCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<MuscleDynamicsInfo> >
+        _dynamicsInfoCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<MusclePotentialEnergyInfo> >
+        _potentialEnergyInfoCV;
+    // Set by the Model, which computes the activation derivatives of its
+    // muscles with first-order activation dynamics together.
+    mutable SimTK::ResetOnCopy<CacheVariable<double> > _activationDerivativeCV;
+    friend class Model;
+
 //=============================================================================
 };  // END of class Muscle
 //=============================================================================
@@ -0,0 +1,179 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  MuscleGroup.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/ThreadPool.h>
+#include "MuscleGroup.h"
+#include "Muscle.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace OpenSim;
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+MuscleGroup::MuscleGroup()
+{
+    constructProperties();
+}
+
+void MuscleGroup::constructProperties()
+{
+    constructProperty_muscles();
+    constructProperty_num_threads(1);
+}
+
+int MuscleGroup::addMuscle(const std::string& muscleName)
+{
+    append_muscles(muscleName);
+    return getNumMuscles() - 1;
+}
+
+const Muscle& MuscleGroup::getMuscle(int i) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(i < 0 || i >= (int)_muscles.size(), Exception,
+        "Muscle index " + std::to_string(i) + " is out of range, or the "
+        "group is not connected to its model.");
+    return *_muscles[i];
+}
+
+std::string MuscleGroup::getMuscleType() const
+{
+    return _muscles.empty() ? "" : _muscles[0]->getConcreteClassName();
+}
+
+//=============================================================================
+// ModelComponent interface
+//=============================================================================
+void MuscleGroup::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+
+    OPENSIM_THROW_IF_FRMOBJ(get_num_threads() < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(get_num_threads()) + ".");
+
+    AbstractOutput& tendonForces = updOutput("tendon_force");
+    tendonForces.clearChannels();
+    for (int i = 0; i < getNumMuscles(); ++i)
+        tendonForces.addChannel(get_muscles(i));
+}
+
+void MuscleGroup::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    const Set<Muscle>& modelMuscles = model.getMuscles();
+    const int n = getNumMuscles();
+    _muscles.clear();
+    _muscles.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const string& name = get_muscles(i);
+        OPENSIM_THROW_IF_FRMOBJ(!modelMuscles.contains(name), Exception,
+            "Invalid muscle (" + name + ") specified.");
+        OPENSIM_THROW_IF_FRMOBJ(
+            getProperty_muscles().findIndex(name) != i, Exception,
+            "Muscle '" + name + "' is in the group more than once.");
+        const Muscle& muscle = modelMuscles.get(name);
+        OPENSIM_THROW_IF_FRMOBJ(!_muscles.empty() &&
+            muscle.getConcreteClassName() != getMuscleType(), Exception,
+            "Expected muscles of type " + getMuscleType() + ", but '" + name +
+            "' is a " + muscle.getConcreteClassName() + ".");
+        _muscles.push_back(&muscle);
+    }
+}
+
+void MuscleGroup::extendRealizeDynamics(const SimTK::State& s) const
+{
+    Super::extendRealizeDynamics(s);
+    // Before any of the muscles computes its force.
+    computeFiberMechanics(s);
+}
+
+//=============================================================================
+// COMPUTATIONS
+//=============================================================================
+void MuscleGroup::computeFiberMechanics(const SimTK::State& s) const
+{
+    const int n = (int)_muscles.size();
+    if (n == 0) return;
+
+    // The paths share the transforms and velocities of the frames of the
+    // model, so compute them one after another.
+    for (const Muscle* muscle : _muscles)
+        if (muscle->appliesForce(s)) muscle->getLengtheningSpeed(s);
+
+    // Each muscle writes only to its own cache variables.
+    const auto compute = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            if (_muscles[i]->appliesForce(s)) _muscles[i]->getFiberVelocity(s);
+    };
+
+    ThreadPool::parallelForRanges(n, std::min(get_num_threads(), n),
+        [&](int, int begin, int end) { compute(begin, end); });
+}
+
+double MuscleGroup::getTendonForce(const SimTK::State& s,
+                                   const std::string& muscleName) const
+{
+    const int index = getProperty_muscles().findIndex(muscleName);
+    OPENSIM_THROW_IF_FRMOBJ(index < 0, Exception,
+        "No muscle named '" + muscleName + "' in the group.");
+    return getMuscle(index).getTendonForce(s);
+}
+
+SimTK::Vector MuscleGroup::calcTendonForces(const SimTK::State& s) const
+{
+    SimTK::Vector forces((int)_muscles.size());
+    for (int i = 0; i < forces.size(); ++i)
+        forces[i] = _muscles[i]->getTendonForce(s);
+    return forces;
+}
+
+SimTK::Vector MuscleGroup::calcActivations(const SimTK::State& s) const
+{
+    SimTK::Vector activations((int)_muscles.size());
+    for (int i = 0; i < activations.size(); ++i)
+        activations[i] = _muscles[i]->getActivation(s);
+    return activations;
+}
+
+SimTK::Vector MuscleGroup::calcFiberLengths(const SimTK::State& s) const
+{
+    SimTK::Vector lengths((int)_muscles.size());
+    for (int i = 0; i < lengths.size(); ++i)
+        lengths[i] = _muscles[i]->getFiberLength(s);
+    return lengths;
+}
+
+SimTK::Vector MuscleGroup::calcFiberVelocities(const SimTK::State& s) const
+{
+    SimTK::Vector velocities((int)_muscles.size());
+    for (int i = 0; i < velocities.size(); ++i)
+        velocities[i] = _muscles[i]->getFiberVelocity(s);
+    return velocities;
+}
@@ -0,0 +1,149 @@
+#ifndef OPENSIM_MUSCLE_GROUP_H_
+#define OPENSIM_MUSCLE_GROUP_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  MuscleGroup.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDE
+#include "ModelComponent.h"
+
+namespace OpenSim {
+
+class Muscle;
+
+//==============================================================================
+//                               MUSCLE GROUP
+//==============================================================================
+/**
+ * A group of muscles of the same type (e.g., all the
+ * Millard2012EquilibriumMuscles of a model) whose fiber mechanics are computed
+ * together, in one pass that may be split across threads.
+ *
+ * Otherwise, each muscle computes its fiber length and velocity when its force
+ * is first needed, one muscle after another. A MuscleGroup computes them for
+ * all of its muscles when the model is realized to Stage::Dynamics, before any
+ * muscle applies its force, and each muscle then finds its results in its
+ * cache. The muscles remain components of the model, so their outputs, and the
+ * reporters and analyses that use them, keep working. The tendon forces,
+ * activations, fiber lengths and fiber velocities of the group are also
+ * available in contiguous arrays, and the tendon forces as a list output with
+ * a channel per muscle.
+ *
+ * The paths of the muscles are computed first, one after another, since they
+ * share the frames of the model; see Model::setNumThreadsForPaths() to compute
+ * them in parallel.
+ *
+ * @code
+ * MuscleGroup* group = new MuscleGroup();
+ * group->setName("leg_muscles");
+ * for (const auto& muscle : model.getComponentList<Millard2012EquilibriumMuscle>())
+ *     group->addMuscle(muscle.getName());
+ * group->set_num_threads(4);
+ * model.addModelComponent(group);
+ * @endcode
+ */
+class OSIMSIMULATION_API MuscleGroup : public ModelComponent {
+OpenSim_DECLARE_CONCRETE_OBJECT(MuscleGroup, ModelComponent);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(muscles, std::string,
+        "Names of the muscles in the group, which must all be of the same "
+        "type.");
+    OpenSim_DECLARE_PROPERTY(num_threads, int,
+        "Number of threads across which the fiber mechanics of the muscles "
+        "are split (default 1).");
+//==============================================================================
+// OUTPUTS
+//==============================================================================
+    OpenSim_DECLARE_LIST_OUTPUT(tendon_force, double, getTendonForce,
+                                SimTK::Stage::Dynamics);
+//==============================================================================
+// PUBLIC METHODS
+//==============================================================================
+    /** Default constructor creates an empty group. */
+    MuscleGroup();
+
+    // Uses default (compiler-generated) destructor, copy constructor, and copy
+    // assignment operator.
+
+    /** Add the muscle of the model with the given name to the group.
+    @return the index of the muscle in the group. */
+    int addMuscle(const std::string& muscleName);
+
+    /** The number of muscles in the group. */
+    int getNumMuscles() const { return getProperty_muscles().size(); }
+
+    /** The i-th muscle of the group; available once the group is connected to
+    its model. */
+    const Muscle& getMuscle(int i) const;
+
+    /** The concrete type of the muscles of the group (e.g.,
+    "Millard2012EquilibriumMuscle"), or an empty string if the group has no
+    muscles or is not connected to its model. */
+    std::string getMuscleType() const;
+
+    //--------------------------------------------------------------------------
+    // COMPUTATIONS
+    //--------------------------------------------------------------------------
+    /** The tendon force of the muscle with the given name. */
+    double getTendonForce(const SimTK::State& s,
+                          const std::string& muscleName) const;
+
+    /** The tendon forces of all muscles, in the order of the muscles
+    property. The state must be realized to Stage::Dynamics. */
+    SimTK::Vector calcTendonForces(const SimTK::State& s) const;
+    /** The activations of all muscles, in the order of the muscles
+    property. */
+    SimTK::Vector calcActivations(const SimTK::State& s) const;
+    /** The fiber lengths of all muscles, in the order of the muscles
+    property. The state must be realized to Stage::Velocity. */
+    SimTK::Vector calcFiberLengths(const SimTK::State& s) const;
+    /** The fiber velocities of all muscles, in the order of the muscles
+    property. The state must be realized to Stage::Velocity. */
+    SimTK::Vector calcFiberVelocities(const SimTK::State& s) const;
+
+protected:
+    //--------------------------------------------------------------------------
+    // Implement ModelComponent interface.
+    //--------------------------------------------------------------------------
+    void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
+    void extendRealizeDynamics(const SimTK::State& s) const override;
+
+private:
+    void constructProperties();
+
+    // Compute the fiber lengths and velocities of all muscles that apply
+    // force, splitting the muscles across num_threads threads.
+    void computeFiberMechanics(const SimTK::State& s) const;
+
+    // The muscles of the group, in the order of the muscles property.
+    SimTK::ResetOnCopy<SimTK::Array_<const Muscle*>> _muscles;
+//==============================================================================
+};  // END of class MuscleGroup
+//==============================================================================
+//==============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MUSCLE_GROUP_H_
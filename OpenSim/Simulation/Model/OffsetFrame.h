@@ -164,6 +164,7 @@ protected:
     /**@{**/
     void extendFinalizeFromProperties() override;
     void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
     /**@}**/
 
     // The transform X_GO for this OffsetFrame, O, in Ground, G.
@@ -183,6 +184,12 @@ private:
 
     // the Offset transform in its parent frame
     SimTK::Transform _offsetTransform;
+
+    // The base frame B of this frame, F, and the transform X_BF composed from
+    // the offsets of the chain of frames between them, so that the
+    // kinematics of F follow from those of B without walking the chain.
+    SimTK::ReferencePtr<const Frame> _baseFrame;
+    SimTK::Transform _transformInBase;
 //=============================================================================
 }; // END of class OffsetFrame
 //=============================================================================
@@ -251,18 +258,26 @@ template <class C>
 SimTK::Transform OffsetFrame<C>::
 calcTransformInGround(const SimTK::State& state) const
 {
-    return this->getParentFrame().getTransformInGround(state)*getOffsetTransform();
+    // Before the frame is added to a System, compose with the parent frame.
+    if (_baseFrame.empty())
+        return this->getParentFrame().getTransformInGround(state)*
+            getOffsetTransform();
+    return _baseFrame->getTransformInGround(state)*_transformInBase;
 }
 
 template <class C>
 SimTK::SpatialVec OffsetFrame<C>::
 calcVelocityInGround(const SimTK::State& state) const
 {
-    // The rigid offset of the OffsetFrame expressed in ground
-    const SimTK::Vec3& r = this->getParentFrame().getTransformInGround(state).R()*
-        getOffsetTransform().p();
+    // The rigid offset of the OffsetFrame from its base (or else parent)
+    // frame, expressed in ground
+    const Frame& base = _baseFrame.empty() ?
+        static_cast<const Frame&>(this->getParentFrame()) : *_baseFrame;
+    const SimTK::Transform& X_BO = _baseFrame.empty() ?
+        getOffsetTransform() : _transformInBase;
+    const SimTK::Vec3& r = base.getTransformInGround(state).R()*X_BO.p();
     // Velocity of the base frame in ground
-    SimTK::SpatialVec V_GF = this->getParentFrame().getVelocityInGround(state);
+    SimTK::SpatialVec V_GF = base.getVelocityInGround(state);
     // translational velocity needs additional omega x r term due to offset 
     V_GF(1) += V_GF(0) % r;
 
@@ -273,13 +288,17 @@ template <class C>
 SimTK::SpatialVec OffsetFrame<C>::
 calcAccelerationInGround(const SimTK::State& state) const
 {
-    // The rigid offset of the OffsetFrame expressed in ground
-    const SimTK::Vec3& r = this->getParentFrame().getTransformInGround(state).R()*
-        getOffsetTransform().p();
-    // Velocity of the parent frame in ground
-    const SimTK::SpatialVec& V_GF = this->getParentFrame().getVelocityInGround(state);
-    // Velocity of the parent frame in ground
-    SimTK::SpatialVec A_GF = getParentFrame().getAccelerationInGround(state);
+    // The rigid offset of the OffsetFrame from its base (or else parent)
+    // frame, expressed in ground
+    const Frame& base = _baseFrame.empty() ?
+        static_cast<const Frame&>(this->getParentFrame()) : *_baseFrame;
+    const SimTK::Transform& X_BO = _baseFrame.empty() ?
+        getOffsetTransform() : _transformInBase;
+    const SimTK::Vec3& r = base.getTransformInGround(state).R()*X_BO.p();
+    // Velocity of the base frame in ground
+    const SimTK::SpatialVec& V_GF = base.getVelocityInGround(state);
+    // Acceleration of the base frame in ground
+    SimTK::SpatialVec A_GF = base.getAccelerationInGround(state);
     A_GF[1] += (A_GF[0] % r + V_GF[0] % (V_GF[0] % r));
 
     return A_GF;
@@ -310,6 +329,10 @@ template <class C>
 void OffsetFrame<C>::setOffsetTransform(const SimTK::Transform& xform)
 {
     _offsetTransform = xform;
+    // Keep the composed transform in the base frame in step, in case the
+    // offset is changed after the frame was added to a System.
+    if (!_baseFrame.empty())
+        _transformInBase = this->findTransformInBaseFrame();
     // Make sure properties are updated in case we either get properties or
     // serialize after this call
     set_translation(xform.p());
@@ -353,6 +376,17 @@ void OffsetFrame<C>::extendConnectToModel(Model& model)
         getConcreteClassName() + " cannot connect to itself!");
 }
 
+template<class C>
+void OffsetFrame<C>::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    // All frames are connected by now; collapse the offsets of offsets
+    // between this frame and its base frame into a single transform.
+    OffsetFrame<C>* mutableThis = const_cast<OffsetFrame<C>*>(this);
+    mutableThis->_baseFrame.reset(&this->findBaseFrame());
+    mutableThis->_transformInBase = this->findTransformInBaseFrame();
+}
+
 } // end of namespace OpenSim
 
 #endif // OPENSIM_OFFSET_FRAME_H_
@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "PathActuator.h"
+#include "Model.h"
 
 using namespace OpenSim;
 using namespace std;
@@ -205,6 +206,38 @@ double PathActuator::computeMomentArm(const SimTK::State& s, Coordinate& aCoord)
     return getGeometryPath().computeMomentArm(s, aCoord);
 }
 
+/**
+ * Find the variables the force (and the derivatives of the states of a
+ * muscle) depend on, and the mobilities on which the force acts.
+ */
+bool PathActuator::findDynamicsDependencies(const SimTK::State& s,
+        std::vector<int>& yIndices, std::vector<int>& controlIndices,
+        std::vector<int>& uIndices) const
+{
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+    const int nq = s.getNQ();
+    for (SimTK::MobilizedBodyIndex b :
+            getGeometryPath().findMobilizedBodies()) {
+        const SimTK::MobilizedBody& mobod = matter.getMobilizedBody(b);
+        for (int i = 0; i < mobod.getNumQ(s); ++i)
+            yIndices.push_back(int(mobod.getFirstQIndex(s)) + i);
+        for (int i = 0; i < mobod.getNumU(s); ++i) {
+            const int u = int(mobod.getFirstUIndex(s)) + i;
+            yIndices.push_back(nq + u);
+            uIndices.push_back(u);
+        }
+    }
+
+    // The states of a muscle (a PathActuator itself has none).
+    for (int y : getStateVariableYIndices(s))
+        if (y >= 0) yIndices.push_back(y);
+
+    for (int i = 0; i < numControls(); ++i)
+        controlIndices.push_back(_controlIndex + i);
+    return true;
+}
+
 //------------------------------------------------------------------------------
 //                            CONNECT TO MODEL
 //------------------------------------------------------------------------------
@@ -107,6 +107,14 @@ public:
     //--------------------------------------------------------------------------
     double computeActuation( const SimTK::State& s) const override;
     virtual double computeMomentArm( const SimTK::State& s, Coordinate& aCoord) const;
+    /** The force of a path actuator, and the derivatives of the states of
+    a muscle, depend on its own states and controls and on the generalized
+    coordinates and speeds of the mobilized bodies that its path spans
+    (GeometryPath::findMobilizedBodies()), on whose mobilities the force
+    acts. */
+    bool findDynamicsDependencies(const SimTK::State& s,
+            std::vector<int>& yIndices, std::vector<int>& controlIndices,
+            std::vector<int>& uIndices) const override;
 
     //--------------------------------------------------------------------------
     // SCALING
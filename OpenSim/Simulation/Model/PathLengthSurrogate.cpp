@@ -0,0 +1,232 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  PathLengthSurrogate.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "PathLengthSurrogate.h"
+#include <OpenSim/Common/Exception.h>
+#include "SimTKmath.h"
+
+using namespace OpenSim;
+using SimTK::Vector;
+using SimTK::Matrix;
+
+namespace {
+    // Append the exponents of all the terms in numCoords variables whose total
+    // degree is at most maxDegree, with the first `fixed` exponents given.
+    void appendTerms(std::vector<int>& current, int fixed, int numCoords,
+                     int remaining, std::vector<int>& exponents)
+    {
+        if (fixed == numCoords) {
+            exponents.insert(exponents.end(), current.begin(), current.end());
+            return;
+        }
+        for (int e = 0; e <= remaining; ++e) {
+            current[fixed] = e;
+            appendTerms(current, fixed + 1, numCoords, remaining - e,
+                        exponents);
+        }
+        current[fixed] = 0;
+    }
+}
+
+//=============================================================================
+// CONSTRUCTOR
+//=============================================================================
+PathLengthSurrogate::PathLengthSurrogate(
+        const std::vector<SimTK::QIndex>& qIndices,
+        const Vector& lower, const Vector& upper, int degree) :
+    _qIndices(qIndices), _lower(lower), _upper(upper), _degree(degree),
+    _maxError(SimTK::NaN)
+{
+    const int n = (int)_qIndices.size();
+    OPENSIM_THROW_IF(lower.size() != n || upper.size() != n, Exception,
+        "PathLengthSurrogate: expected a lower and an upper bound for each "
+        "coordinate.");
+    OPENSIM_THROW_IF(degree < 0, Exception,
+        "PathLengthSurrogate: degree must be non-negative.");
+    for (int j = 0; j < n; ++j) {
+        OPENSIM_THROW_IF(!(upper[j] > lower[j]), Exception,
+            "PathLengthSurrogate: the range of each coordinate must not be "
+            "empty.");
+    }
+
+    std::vector<int> current(n, 0);
+    appendTerms(current, 0, n, _degree, _exponents);
+}
+
+//=============================================================================
+// FITTING
+//=============================================================================
+void PathLengthSurrogate::fit(const Matrix& samples, const Vector& lengths)
+{
+    const int n = (int)_qIndices.size();
+    const int numTerms = n > 0 ? (int)_exponents.size()/n : 1;
+    const int m = samples.nrow();
+    OPENSIM_THROW_IF(samples.ncol() != n || lengths.size() != m, Exception,
+        "PathLengthSurrogate::fit: samples and lengths are inconsistent.");
+    OPENSIM_THROW_IF(m < numTerms, Exception,
+        "PathLengthSurrogate::fit: need at least as many samples as terms.");
+
+    // Each column of A holds one of the basis functions at all the samples.
+    Matrix A(m, numTerms);
+    Vector x(n);
+    std::vector<double> T;
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j)
+            x[j] = samples(i, j);
+        calcChebyshev(n > 0 ? &x[0] : nullptr, T, nullptr);
+        for (int t = 0; t < numTerms; ++t) {
+            double basis = 1;
+            for (int j = 0; j < n; ++j)
+                basis *= T[j*(_degree + 1) + _exponents[t*n + j]];
+            A(i, t) = basis;
+        }
+    }
+
+    SimTK::FactorQTZ qtz(A);
+    Vector coefficients;
+    qtz.solve(lengths, coefficients);
+    _coefficients = coefficients;
+}
+
+//=============================================================================
+// EVALUATION
+//=============================================================================
+bool PathLengthSurrogate::isInRange(const SimTK::State& s) const
+{
+    const Vector& q = s.getQ();
+    for (size_t j = 0; j < _qIndices.size(); ++j) {
+        const double value = q[_qIndices[j]];
+        if (value < _lower[(int)j] || value > _upper[(int)j])
+            return false;
+    }
+    return true;
+}
+
+double PathLengthSurrogate::calcLength(const Vector& values) const
+{
+    return evaluate(values.size() ? &values[0] : nullptr, nullptr);
+}
+
+double PathLengthSurrogate::calcLength(const SimTK::State& s) const
+{
+    const Vector& q = s.getQ();
+    Vector x((int)_qIndices.size());
+    for (size_t j = 0; j < _qIndices.size(); ++j)
+        x[(int)j] = q[_qIndices[j]];
+    return calcLength(x);
+}
+
+void PathLengthSurrogate::addInLengthGradient(const SimTK::State& s,
+                                              Vector& dLdq) const
+{
+    const Vector& q = s.getQ();
+    const int n = (int)_qIndices.size();
+    Vector x(n), gradient(n);
+    for (int j = 0; j < n; ++j)
+        x[j] = q[_qIndices[j]];
+    if (n > 0)
+        evaluate(&x[0], &gradient[0]);
+    for (int j = 0; j < n; ++j)
+        dLdq[_qIndices[j]] += gradient[j];
+}
+
+double PathLengthSurrogate::calcLengtheningSpeed(const SimTK::State& s) const
+{
+    const Vector& q = s.getQ();
+    const Vector& qdot = s.getQDot();
+    const int n = (int)_qIndices.size();
+    Vector x(n), gradient(n);
+    for (int j = 0; j < n; ++j)
+        x[j] = q[_qIndices[j]];
+    if (n > 0)
+        evaluate(&x[0], &gradient[0]);
+    double speed = 0;
+    for (int j = 0; j < n; ++j)
+        speed += gradient[j]*qdot[_qIndices[j]];
+    return speed;
+}
+
+void PathLengthSurrogate::calcChebyshev(const double* x,
+                                        std::vector<double>& T,
+                                        std::vector<double>* dT) const
+{
+    const int n = (int)_qIndices.size();
+    const int stride = _degree + 1;
+    T.resize(n*stride);
+    if (dT) dT->resize(n*stride);
+
+    for (int j = 0; j < n; ++j) {
+        const double scale = 2.0/(_upper[j] - _lower[j]);
+        const double u = scale*(x[j] - _lower[j]) - 1.0;
+        double* Tj = &T[j*stride];
+        Tj[0] = 1.0;
+        if (_degree > 0) Tj[1] = u;
+        for (int k = 1; k < _degree; ++k)
+            Tj[k+1] = 2*u*Tj[k] - Tj[k-1];
+
+        if (dT) {
+            double* dTj = &(*dT)[j*stride];
+            dTj[0] = 0.0;
+            if (_degree > 0) dTj[1] = scale;
+            for (int k = 1; k < _degree; ++k)
+                dTj[k+1] = 2*scale*Tj[k] + 2*u*dTj[k] - dTj[k-1];
+        }
+    }
+}
+
+double PathLengthSurrogate::evaluate(const double* x, double* gradient) const
+{
+    const int n = (int)_qIndices.size();
+    const int numTerms = (int)_coefficients.size();
+    const int stride = _degree + 1;
+
+    // Chebyshev polynomials T_k(u) of each normalized coordinate and their
+    // derivatives with respect to the coordinate itself.
+    std::vector<double> T, dT;
+    calcChebyshev(x, T, gradient ? &dT : nullptr);
+
+    if (gradient)
+        for (int j = 0; j < n; ++j) gradient[j] = 0;
+
+    double value = 0;
+    for (int t = 0; t < numTerms; ++t) {
+        const double c = _coefficients[t];
+        const int* e = n > 0 ? &_exponents[t*n] : nullptr;
+        double term = c;
+        for (int j = 0; j < n; ++j)
+            term *= T[j*stride + e[j]];
+        value += term;
+
+        if (gradient) {
+            for (int j = 0; j < n; ++j) {
+                double partial = c*dT[j*stride + e[j]];
+                for (int k = 0; k < n; ++k)
+                    if (k != j) partial *= T[k*stride + e[k]];
+                gradient[j] += partial;
+            }
+        }
+    }
+    return value;
+}
@@ -0,0 +1,120 @@
+#ifndef OPENSIM_PATH_LENGTH_SURROGATE_H_
+#define OPENSIM_PATH_LENGTH_SURROGATE_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  PathLengthSurrogate.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKcommon.h"
+
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A polynomial approximation of the length of a path as a function of the
+ * generalized coordinates that change it. The polynomial is a sum of products
+ * of Chebyshev polynomials of the coordinates (normalized to [-1, 1] over the
+ * sampled range) up to a given total degree, fit by least squares to sampled
+ * path lengths.
+ *
+ * The surrogate is only valid inside the box of coordinate values it was fit
+ * over (see isInRange()). Its derivatives with respect to the coordinates
+ * give the lengthening speed and the moment arms of the path.
+ *
+ * @see GeometryPath::fitLengthSurrogate()
+ */
+class OSIMSIMULATION_API PathLengthSurrogate {
+public:
+    /** Create a surrogate of the given total degree in the generalized
+    coordinates with the given indices into the system's q vector, valid for
+    coordinate values between `lower` and `upper`. Call fit() before
+    evaluating the surrogate. */
+    PathLengthSurrogate(const std::vector<SimTK::QIndex>& qIndices,
+                        const SimTK::Vector& lower,
+                        const SimTK::Vector& upper,
+                        int degree);
+
+    /** Fit the coefficients of the polynomial to the given samples by least
+    squares. Each row of `samples` holds the values of the coordinates (in the
+    order of the q indices) at which the corresponding entry of `lengths` was
+    computed. */
+    void fit(const SimTK::Matrix& samples, const SimTK::Vector& lengths);
+
+    /** Indices into the system's q vector of the coordinates that the
+    surrogate depends on. */
+    const std::vector<SimTK::QIndex>& getQIndices() const { return _qIndices; }
+
+    /** The largest difference between the surrogate and the exact length
+    found when the surrogate was validated. */
+    double getMaxError() const { return _maxError; }
+    void setMaxError(double maxError) { _maxError = maxError; }
+
+    /** Whether the coordinates in the state lie inside the range that the
+    surrogate was fit over. The surrogate should not be used otherwise. */
+    bool isInRange(const SimTK::State& s) const;
+
+    /** Evaluate the surrogate at the given coordinate values (in the order of
+    the q indices). */
+    double calcLength(const SimTK::Vector& values) const;
+
+    /** Evaluate the surrogate at the coordinates in the state. */
+    double calcLength(const SimTK::State& s) const;
+
+    /** Add the derivative of the length with respect to each coordinate to the
+    corresponding entry of `dLdq`, which must have the size of the system's q
+    vector. */
+    void addInLengthGradient(const SimTK::State& s, SimTK::Vector& dLdq) const;
+
+    /** The rate of change of the length, ~(dL/dq)*qdot. Requires the state to
+    be realized to Stage::Velocity. */
+    double calcLengtheningSpeed(const SimTK::State& s) const;
+
+private:
+    // Evaluate the polynomial and (if gradient is not null) its gradient with
+    // respect to the (unnormalized) coordinate values x.
+    double evaluate(const double* x, double* gradient) const;
+    // Chebyshev polynomials of each coordinate up to the degree of the
+    // surrogate (and optionally their derivatives), coordinate by coordinate.
+    void calcChebyshev(const double* x, std::vector<double>& T,
+                       std::vector<double>* dT) const;
+
+    std::vector<SimTK::QIndex> _qIndices;
+    SimTK::Vector _lower;
+    SimTK::Vector _upper;
+    int _degree;
+
+    // Degree of the Chebyshev polynomial of each coordinate in each term,
+    // stored term by term.
+    std::vector<int> _exponents;
+    SimTK::Vector _coefficients;
+    double _maxError;
+
+//=============================================================================
+};  // END of class PathLengthSurrogate
+//=============================================================================
+//=============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_PATH_LENGTH_SURROGATE_H_
@@ -58,6 +58,11 @@ public:
     const SimTK::Vec3& getLocation() const { return get_location(); }
 #endif
     SimTK::Vec3& getLocation()  { return upd_location(); }
+    /** Get the location of the point in its frame for the given state. This is
+    the location property, except for points whose location depends on the
+    state (e.g., MovingPathPoint and PathWrapPoint). */
+    virtual SimTK::Vec3 getLocation(const SimTK::State& s) const
+    {   return get_location(); }
 
     const double& getLocationCoord(int aXYZ) const {
         assert(aXYZ>=0 && aXYZ<=2); return get_location()[aXYZ];
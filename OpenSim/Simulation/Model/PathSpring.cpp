@@ -26,7 +26,6 @@
 //=============================================================================
 #include "PathSpring.h"
 #include "GeometryPath.h"
-#include "PointForceDirection.h"
 
 //=============================================================================
 // STATICS
@@ -225,14 +224,5 @@ void PathSpring::computeForce(const SimTK::State& s,
     const GeometryPath& path = getGeometryPath();
     const double& tension = getTension(s);
 
-    OpenSim::Array<PointForceDirection*> PFDs;
-    path.getPointForceDirections(s, &PFDs);
-
-    for (int i=0; i < PFDs.getSize(); i++) {
-        applyForceToPoint(s, PFDs[i]->frame(), PFDs[i]->point(), 
-                          tension*PFDs[i]->direction(), bodyForces);
-    }
-
-    for(int i=0; i < PFDs.getSize(); i++)
-        delete PFDs[i];
+    path.addInEquivalentForces(s, tension, bodyForces, generalizedForces);
 }
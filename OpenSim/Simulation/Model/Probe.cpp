@@ -78,15 +78,53 @@ private:
 };
 
 
-template <>
-void ProbeMeasure<double>::Implementation::calcCachedValueVirtual(const State& s, int derivOrder, double& value) const
-{
-    SimTK_ASSERT1_ALWAYS(derivOrder==0,
-        "ProbeMeasure::Implementation::calcCachedValueVirtual():"
-        " derivOrder %d seen but only 0 allowed.", derivOrder);
- 
-    value = m_probe.computeProbeInputs(s)(i);
-}
+//This Measure returns one element of the probe inputs. The inputs are
+//computed once per realization by a ProbeMeasure<Vector> that is shared by the
+//Measures of all the elements, rather than once for each element.
+class ProbeInputMeasure : public SimTK::Measure_<double> {
+public:
+    SimTK_MEASURE_HANDLE_PREAMBLE(ProbeInputMeasure, Measure_<double>);
+
+    ProbeInputMeasure(Subsystem& sub, const Measure_<Vector>& inputs, int index)
+    :   SimTK::Measure_<double>(sub, new Implementation(inputs, index),
+                                AbstractMeasure::SetHandle()) {}
+    SimTK_MEASURE_HANDLE_POSTSCRIPT(ProbeInputMeasure, Measure_<double>);
+};
+
+
+class ProbeInputMeasure::Implementation
+    : public SimTK::Measure_<double>::Implementation {
+public:
+    Implementation(const Measure_<Vector>& inputs, int index)
+    :   SimTK::Measure_<double>::Implementation(1), m_inputs(inputs),
+        m_index(index) {}
+
+    Implementation* cloneVirtual() const override {
+        return new Implementation(*this);
+    }
+
+    int getNumTimeDerivativesVirtual() const override {
+        return 0;
+    }
+
+    Stage getDependsOnStageVirtual(int order) const override {
+        return Stage::Acceleration;
+    }
+
+    void calcCachedValueVirtual(const State& s, int derivOrder, double& value)
+        const override
+    {
+        SimTK_ASSERT1_ALWAYS(derivOrder==0,
+            "ProbeInputMeasure::Implementation::calcCachedValueVirtual():"
+            " derivOrder %d seen but only 0 allowed.", derivOrder);
+
+        value = m_inputs.getValue(s)[m_index];
+    }
+
+private:
+    Measure_<Vector> m_inputs;
+    int m_index;
+};
 
 
 namespace OpenSim {
@@ -155,17 +193,18 @@ void Probe::extendAddToSystem(MultibodySystem& system) const
     // ---------------------------------------------------------------------
     // Create a <double> Measure of the value to be probed (operand).
     // For now, this is scalarized, i.e. a separate Measure is created
-    // for each probe input element in the Vector.
+    // for each probe input element in the Vector. The elements share one
+    // Measure of the whole Vector, so that computeProbeInputs() is called
+    // once per realization.
     // ---------------------------------------------------------------------
-    // save for when we can directly operate on Vector SimTK::Measures
-    //ProbeMeasure<SimTK::Vector> beforeOperationValueVector(system, *this);
+    ProbeMeasure<SimTK::Vector> beforeOperationValueVector(system, *this, 0);
 
     int npi = getNumProbeInputs();
-    SimTK::Array_<ProbeMeasure<double> > beforeOperationValues;
+    SimTK::Array_<ProbeInputMeasure> beforeOperationValues;
     mutableThis->afterOperationValues.resize(npi);
 
     for (int i=0; i<npi; ++i) {
-        ProbeMeasure<double> tmpPM(system, *this, i); 
+        ProbeInputMeasure tmpPM(system, beforeOperationValueVector, i);
         beforeOperationValues.push_back(tmpPM);
     }
 
@@ -413,6 +452,17 @@ void Probe::setGain(double gain)
  * Provide the probe values to be reported that correspond to the probe labels.
  */
 SimTK::Vector Probe::getProbeOutputs(const State& s) const 
+{
+    SimTK::Vector output(getNumProbeInputs());
+    getProbeOutputs(s, output.size() ? &output[0] : nullptr);
+    return output;
+}
+
+//_____________________________________________________________________________
+/**
+ * Write the probe values to be reported to a buffer.
+ */
+void Probe::getProbeOutputs(const State& s, double* values) const
 {
     if (!isEnabled()) {
         stringstream errorMessage;
@@ -422,21 +472,19 @@ SimTK::Vector Probe::getProbeOutputs(const State& s) const
         throw (Exception(errorMessage.str()));
     }
 
-
     // For now, this is scalarized, i.e. compile the result of the separate
-    // Measure for each scalar element of the probe input into a SimTK::Vector
-    // of outputs.
-    SimTK::Vector output(getNumProbeInputs());
-    for (int i=0; i<getNumProbeInputs(); ++i) {
-        if (getOperation() == "integrate")
-            output[i] = getGain() * (afterOperationValues[i].getValue(s) + getInitialConditions()(i));
-        else
-            output[i] = getGain() * afterOperationValues[i].getValue(s);
+    // Measure for each scalar element of the probe input into the outputs.
+    const int npi = getNumProbeInputs();
+    const double gain = getGain();
+    if (getOperation() == "integrate") {
+        for (int i=0; i<npi; ++i)
+            values[i] = gain * (afterOperationValues[i].getValue(s) +
+                                get_initial_conditions_for_integration(i));
+    }
+    else {
+        for (int i=0; i<npi; ++i)
+            values[i] = gain * afterOperationValues[i].getValue(s);
     }
-    
-    return output;
-
-    //return afterOperationValueVector.getValue(s);         // save for when we can directly operate on Vector SimTK::Measures
 }
 
 
@@ -216,6 +216,14 @@ public:
     @return         The SimTK::Vector of probe output values.**/
     SimTK::Vector getProbeOutputs(const SimTK::State& state) const;
 
+    /** Write the values of the probe after the operation has been performed
+    to the getNumProbeInputs() elements starting at values, without
+    allocating a Vector (see ProbeReporter).
+
+    @param  state   System state from which value is computed.
+    @param  values  Where to write the probe output values. **/
+    void getProbeOutputs(const SimTK::State& state, double* values) const;
+
     void updateFromXMLNode(SimTK::Xml::Element& node,
                            int versionNumber) override;
 
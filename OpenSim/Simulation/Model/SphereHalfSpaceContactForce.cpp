@@ -0,0 +1,311 @@
+/* -------------------------------------------------------------------------- *
+ *                OpenSim:  SphereHalfSpaceContactForce.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "SphereHalfSpaceContactForce.h"
+#include "ContactHalfSpace.h"
+#include "ContactSphere.h"
+#include "Model.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSim;
+using SimTK::Vec3;
+
+namespace {
+    // Regularizes the square roots and the min() of the smooth force law.
+    const double smoothingEps = 1e-16;
+}
+
+//==============================================================================
+//                      SPHERE HALF SPACE CONTACT FORCE
+//==============================================================================
+// Uses default (compiler-generated) destructor, copy constructor, copy
+// assignment operator.
+
+SphereHalfSpaceContactForce::SphereHalfSpaceContactForce()
+{
+    constructProperties();
+}
+
+void SphereHalfSpaceContactForce::constructProperties()
+{
+    constructProperty_contact_spheres();
+    constructProperty_contact_half_space("");
+    constructProperty_stiffness(0.0);
+    constructProperty_dissipation(0.0);
+    constructProperty_static_friction(0.0);
+    constructProperty_dynamic_friction(0.0);
+    constructProperty_viscous_friction(0.0);
+    constructProperty_transition_velocity(0.01);
+    constructProperty_use_smooth_force_law(false);
+    constructProperty_hertz_smoothing(300.0);
+    constructProperty_hunt_crossley_smoothing(50.0);
+}
+
+void SphereHalfSpaceContactForce::addContactSphere(const std::string& name)
+{
+    updProperty_contact_spheres().appendValue(name);
+}
+
+void SphereHalfSpaceContactForce::setContactHalfSpace(const std::string& name)
+{
+    set_contact_half_space(name);
+}
+
+void SphereHalfSpaceContactForce::extendFinalizeFromProperties()
+{
+    Super::extendFinalizeFromProperties();
+
+    OPENSIM_THROW_IF_FRMOBJ(get_transition_velocity() <= 0, Exception,
+        "Expected transition_velocity to be positive.");
+    OPENSIM_THROW_IF_FRMOBJ(get_use_smooth_force_law() &&
+        (get_hertz_smoothing() <= 0 || get_hunt_crossley_smoothing() <= 0),
+        Exception, "Expected the smoothing parameters to be positive.");
+
+    AbstractOutput& wrenches = updOutput("sphere_wrenches");
+    wrenches.clearChannels();
+    for (int i = 0; i < getProperty_contact_spheres().size(); ++i)
+        wrenches.addChannel(get_contact_spheres(i));
+}
+
+void SphereHalfSpaceContactForce::
+extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    _forcesCV = addCacheVariable<SimTK::Array_<Vec3>>("sphere_forces",
+        SimTK::Array_<Vec3>(), SimTK::Stage::Velocity);
+    _pointsCV = addCacheVariable<SimTK::Array_<Vec3>>("sphere_points",
+        SimTK::Array_<Vec3>(), SimTK::Stage::Velocity);
+    _potentialEnergyCV = addCacheVariable<double>("potential_energy", 0.0,
+        SimTK::Stage::Velocity);
+
+    // Gather the geometry in the base frames (B) of the bodies, as
+    // HuntCrossleyForce does, so that the force does not depend on the
+    // intermediate frames (F) the geometry is attached to.
+    SphereHalfSpaceContactForce* mutableThis =
+        const_cast<SphereHalfSpaceContactForce*>(this);
+    mutableThis->_sphereBodies.clear();
+    mutableThis->_sphereCenters.clear();
+    mutableThis->_sphereRadii.clear();
+    for (int i = 0; i < getProperty_contact_spheres().size(); ++i) {
+        const ContactSphere& sphere =
+            getModel().getComponent<ContactSphere>(get_contact_spheres(i));
+        const auto& X_BF = sphere.getFrame().findTransformInBaseFrame();
+        mutableThis->_sphereBodies.push_back(
+            sphere.getFrame().getMobilizedBodyIndex());
+        mutableThis->_sphereCenters.push_back(X_BF * sphere.getLocation());
+        mutableThis->_sphereRadii.push_back(sphere.getRadius());
+    }
+
+    const ContactHalfSpace& halfSpace =
+        getModel().getComponent<ContactHalfSpace>(get_contact_half_space());
+    mutableThis->_halfSpaceBody = halfSpace.getFrame().getMobilizedBodyIndex();
+    mutableThis->_halfSpaceTransform =
+        halfSpace.getFrame().findTransformInBaseFrame() *
+        halfSpace.getTransform();
+}
+
+//=============================================================================
+// COMPUTATION
+//=============================================================================
+void SphereHalfSpaceContactForce::realizeContacts(const SimTK::State& s) const
+{
+    if (_forcesCV.isValid(s)) return;
+
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+    const SimTK::MobilizedBody& halfSpaceBody =
+        matter.getMobilizedBody(_halfSpaceBody);
+    const SimTK::Transform& X_GH0 = halfSpaceBody.getBodyTransform(s);
+    const SimTK::Transform X_GH = X_GH0 * _halfSpaceTransform;
+    // Points with x > 0 in the frame of the half space are inside it, so its
+    // outward normal is -x.
+    const Vec3 normal = -X_GH.R().x();
+    const double offset = ~normal * X_GH.p();
+    const Vec3& w_H = halfSpaceBody.getBodyAngularVelocity(s);
+    const Vec3& v_H = halfSpaceBody.getBodyOriginVelocity(s);
+
+    // Both surfaces share the same parameters, which is how Simbody's
+    // HuntCrossleyForce combines them in that case.
+    const double k = 0.5 * std::pow(get_stiffness(), 2.0/3.0);
+    const double c = get_dissipation();
+    const double us = get_static_friction();
+    const double ud = get_dynamic_friction();
+    const double uv = get_viscous_friction();
+    const double vt = get_transition_velocity();
+    const bool smooth = get_use_smooth_force_law();
+    const double bd = get_hertz_smoothing();
+    const double bv = get_hunt_crossley_smoothing();
+
+    const int n = (int)_sphereRadii.size();
+    SimTK::Array_<Vec3>& forces = _forcesCV.updValue(s);
+    SimTK::Array_<Vec3>& points = _pointsCV.updValue(s);
+    forces.resize(n);
+    points.resize(n);
+    double& potentialEnergy = _potentialEnergyCV.updValue(s);
+    potentialEnergy = 0;
+
+    for (int i = 0; i < n; ++i) {
+        const SimTK::MobilizedBody& body =
+            matter.getMobilizedBody(_sphereBodies[i]);
+        const SimTK::Transform& X_GB = body.getBodyTransform(s);
+        const double radius = _sphereRadii[i];
+        const Vec3 center = X_GB * _sphereCenters[i];
+        const double depth = radius - (~normal * center - offset);
+
+        // The contact acts at the middle of the overlap.
+        points[i] = center - (radius - 0.5 * depth) * normal;
+        forces[i] = Vec3(0);
+        if (depth <= 0 && !smooth) continue;
+
+        // Velocity of the sphere relative to the half space at the contact.
+        const Vec3 v = body.getBodyOriginVelocity(s) +
+                       body.getBodyAngularVelocity(s) % (points[i] - X_GB.p())
+                     - v_H - w_H % (points[i] - X_GH0.p());
+        const double depthRate = -(~normal * v);
+        const Vec3 vTangent = v + depthRate * normal;
+
+        double fn, vslip, minvrel;
+        if (smooth) {
+            const double absDepth = std::sqrt(depth*depth + smoothingEps);
+            fn = (4.0/3.0) * k * std::sqrt(radius * k) *
+                 absDepth * std::sqrt(absDepth) *
+                 (0.5 + 0.5 * std::tanh(bd * depth));
+            if (depth > 0) potentialEnergy += 0.4 * fn * depth;
+            fn *= 1 + 1.5 * c * depthRate;
+            if (c > 0)
+                fn *= 0.5 + 0.5 * std::tanh(bv * (depthRate + 2.0/(3.0*c)));
+            vslip = std::sqrt(~vTangent * vTangent + smoothingEps);
+            const double vrel = vslip / vt;
+            minvrel = 0.5 * (vrel + 1 -
+                             std::sqrt((vrel - 1)*(vrel - 1) + smoothingEps));
+        }
+        else {
+            fn = (4.0/3.0) * k * depth * std::sqrt(radius * k * depth);
+            potentialEnergy += 0.4 * fn * depth;
+            fn *= 1 + 1.5 * c * depthRate;
+            if (fn <= 0) continue;
+            vslip = vTangent.norm();
+            minvrel = std::min(vslip / vt, 1.0);
+        }
+
+        forces[i] = fn * normal;
+        if (vslip > 0) {
+            const double vrel = vslip / vt;
+            const double ft = fn * (minvrel * (ud + 2*(us - ud)/(1 + vrel*vrel))
+                                    + uv * vslip);
+            forces[i] -= (ft / vslip) * vTangent;
+        }
+    }
+
+    _forcesCV.markValid(s);
+    _pointsCV.markValid(s);
+    _potentialEnergyCV.markValid(s);
+}
+
+void SphereHalfSpaceContactForce::computeForce(const SimTK::State& s,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const
+{
+    realizeContacts(s);
+    const SimTK::Array_<Vec3>& forces = _forcesCV.getValue(s);
+    const SimTK::Array_<Vec3>& points = _pointsCV.getValue(s);
+
+    const SimTK::SimbodyMatterSubsystem& matter =
+        getModel().getMatterSubsystem();
+    const Vec3& p_GH = matter.getMobilizedBody(_halfSpaceBody)
+                             .getBodyOriginLocation(s);
+    for (int i = 0; i < (int)forces.size(); ++i) {
+        if (forces[i] == Vec3(0)) continue;
+        const Vec3& p_GB = matter.getMobilizedBody(_sphereBodies[i])
+                                 .getBodyOriginLocation(s);
+        bodyForces[_sphereBodies[i]] +=
+            SimTK::SpatialVec((points[i] - p_GB) % forces[i], forces[i]);
+        bodyForces[_halfSpaceBody] -=
+            SimTK::SpatialVec((points[i] - p_GH) % forces[i], forces[i]);
+    }
+}
+
+double SphereHalfSpaceContactForce::
+computePotentialEnergy(const SimTK::State& s) const
+{
+    realizeContacts(s);
+    return _potentialEnergyCV.getValue(s);
+}
+
+SimTK::SpatialVec SphereHalfSpaceContactForce::getSphereWrench(
+        const SimTK::State& s, const std::string& sphereName) const
+{
+    const int index = getProperty_contact_spheres().findIndex(sphereName);
+    OPENSIM_THROW_IF_FRMOBJ(index < 0, Exception,
+        "No ContactSphere named '" + sphereName + "'.");
+    realizeContacts(s);
+    const Vec3& force = _forcesCV.getValue(s)[index];
+    const Vec3& point = _pointsCV.getValue(s)[index];
+    return SimTK::SpatialVec(point % force, force);
+}
+
+SimTK::SpatialVec SphereHalfSpaceContactForce::
+getTotalWrench(const SimTK::State& s) const
+{
+    realizeContacts(s);
+    const SimTK::Array_<Vec3>& forces = _forcesCV.getValue(s);
+    const SimTK::Array_<Vec3>& points = _pointsCV.getValue(s);
+    SimTK::SpatialVec total(Vec3(0), Vec3(0));
+    for (int i = 0; i < (int)forces.size(); ++i)
+        total += SimTK::SpatialVec(points[i] % forces[i], forces[i]);
+    return total;
+}
+
+//=============================================================================
+// Reporting
+//=============================================================================
+OpenSim::Array<std::string> SphereHalfSpaceContactForce::
+getRecordLabels() const
+{
+    OpenSim::Array<std::string> labels("");
+    for (int i = 0; i < getProperty_contact_spheres().size(); ++i) {
+        const std::string prefix = getName() + "." + get_contact_spheres(i);
+        labels.append(prefix + ".force.X");
+        labels.append(prefix + ".force.Y");
+        labels.append(prefix + ".force.Z");
+        labels.append(prefix + ".torque.X");
+        labels.append(prefix + ".torque.Y");
+        labels.append(prefix + ".torque.Z");
+    }
+    return labels;
+}
+
+OpenSim::Array<double> SphereHalfSpaceContactForce::
+getRecordValues(const SimTK::State& state) const
+{
+    OpenSim::Array<double> values(1);
+    for (int i = 0; i < getProperty_contact_spheres().size(); ++i) {
+        const SimTK::SpatialVec wrench =
+            getSphereWrench(state, get_contact_spheres(i));
+        values.append(3, &wrench[1][0]);
+        values.append(3, &wrench[0][0]);
+    }
+    return values;
+}
@@ -0,0 +1,194 @@
+#ifndef OPENSIM_SPHERE_HALF_SPACE_CONTACT_FORCE_H_
+#define OPENSIM_SPHERE_HALF_SPACE_CONTACT_FORCE_H_
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  SphereHalfSpaceContactForce.h                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDE
+#include "Force.h"
+
+namespace OpenSim {
+
+//==============================================================================
+//                      SPHERE HALF SPACE CONTACT FORCE
+//==============================================================================
+/** A Hunt-Crossley contact force between a set of ContactSpheres and a single
+ContactHalfSpace, e.g., the spheres of a foot and the floor.
+
+All the contacts are evaluated together in one loop, without the contact
+subsystem, which makes this force much cheaper than a HuntCrossleyForce with
+the same geometry when there are many spheres. The force law is the one of
+HuntCrossleyForce when the spheres and the half space share the same
+parameters: each sphere of radius R penetrating the half space by a depth d,
+at the rate \f$ \dot d \f$, is pushed away along the normal of the half space
+by
+
+\f[ f_n = \frac{4}{3} \, \bar k \, d \sqrt{R \, \bar k \, d}
+          \, (1 + \frac{3}{2} c \, \dot d),
+    \qquad \bar k = \frac{1}{2} k^{2/3} \f]
+
+and friction opposes its slip velocity \f$ v \f$ with the magnitude
+
+\f[ f_t = f_n \left( \min(v/v_t, 1) \left( \mu_d + \frac{2 (\mu_s -
+          \mu_d)}{1 + (v/v_t)^2} \right) + \mu_v v \right). \f]
+
+The forces act at the middle of the overlap between the sphere and the half
+space. No force is applied when \f$ f_n \f$ would be negative.
+
+When the property use_smooth_force_law is true, the discontinuities of this
+law are replaced by smooth approximations, which gradient-based optimizers
+need: the onset of contact is blended in with
+\f$ \frac{1}{2}(1 + \tanh(b_d \, d)) \f$, the condition \f$ f_n > 0 \f$ with
+\f$ \frac{1}{2}(1 + \tanh(b_v (\dot d + \frac{2}{3c}))) \f$, and the slip
+velocity and the min() are regularized. The larger the smoothing parameters
+\f$ b_d \f$ (hertz_smoothing) and \f$ b_v \f$ (hunt_crossley_smoothing),
+the closer the smooth law is to the original one.
+
+The wrench each sphere receives is available from the sphere_wrenches list
+Output, with one channel per sphere, and their sum from the total_wrench
+Output. The wrenches are expressed in Ground, with their torques about its
+origin.
+
+@code
+auto* force = new SphereHalfSpaceContactForce();
+force->setContactHalfSpace("floor");
+force->addContactSphere("heel");
+force->addContactSphere("toes");
+force->set_stiffness(1e6);
+force->set_dissipation(1.0);
+model.addForce(force);
+@endcode **/
+class OSIMSIMULATION_API SphereHalfSpaceContactForce : public Force {
+OpenSim_DECLARE_CONCRETE_OBJECT(SphereHalfSpaceContactForce, Force);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(contact_spheres, std::string,
+        "Names of the ContactSpheres in contact with the half space.");
+    OpenSim_DECLARE_PROPERTY(contact_half_space, std::string,
+        "Name of the ContactHalfSpace.");
+    OpenSim_DECLARE_PROPERTY(stiffness, double,
+        "Stiffness of the spheres and of the half space (N/m^2).");
+    OpenSim_DECLARE_PROPERTY(dissipation, double,
+        "Dissipation coefficient of the spheres and of the half space (s/m).");
+    OpenSim_DECLARE_PROPERTY(static_friction, double,
+        "Coefficient of static friction.");
+    OpenSim_DECLARE_PROPERTY(dynamic_friction, double,
+        "Coefficient of dynamic friction.");
+    OpenSim_DECLARE_PROPERTY(viscous_friction, double,
+        "Coefficient of viscous friction (s/m).");
+    OpenSim_DECLARE_PROPERTY(transition_velocity, double,
+        "Slip velocity (creep) at which peak static friction occurs.");
+    OpenSim_DECLARE_PROPERTY(use_smooth_force_law, bool,
+        "Whether to use the smooth approximation of the force law "
+        "(default: false).");
+    OpenSim_DECLARE_PROPERTY(hertz_smoothing, double,
+        "Smoothing of the onset of contact by the smooth force law (1/m).");
+    OpenSim_DECLARE_PROPERTY(hunt_crossley_smoothing, double,
+        "Smoothing of the end of contact by the smooth force law (s/m).");
+
+//==============================================================================
+// OUTPUTS
+//==============================================================================
+    OpenSim_DECLARE_LIST_OUTPUT(sphere_wrenches, SimTK::SpatialVec,
+        getSphereWrench, SimTK::Stage::Velocity);
+    OpenSim_DECLARE_OUTPUT(total_wrench, SimTK::SpatialVec,
+        getTotalWrench, SimTK::Stage::Velocity);
+
+//==============================================================================
+// PUBLIC METHODS
+//==============================================================================
+    SphereHalfSpaceContactForce();
+
+    /** Add a ContactSphere, by name, to the spheres in contact with the half
+    space. */
+    void addContactSphere(const std::string& name);
+    /** %Set the name of the ContactHalfSpace. */
+    void setContactHalfSpace(const std::string& name);
+    /** The number of spheres in contact with the half space. */
+    int getNumContactSpheres() const
+    {   return getProperty_contact_spheres().size(); }
+
+    /** The wrench that the half space applies to the sphere with the given
+    name, expressed in Ground and about its origin. */
+    SimTK::SpatialVec getSphereWrench(const SimTK::State& s,
+                                      const std::string& sphereName) const;
+    /** The sum of the wrenches applied to all the spheres, expressed in Ground
+    and about its origin. */
+    SimTK::SpatialVec getTotalWrench(const SimTK::State& s) const;
+
+    //-----------------------------------------------------------------------------
+    // Reporting
+    //-----------------------------------------------------------------------------
+    /**
+     * Provide name(s) of the quantities (column labels) of the force value(s) to be reported
+     */
+    OpenSim::Array<std::string> getRecordLabels() const override;
+    /**
+    *  Provide the value(s) to be reported that correspond to the labels
+    */
+    OpenSim::Array<double> getRecordValues(const SimTK::State& state) const override;
+
+protected:
+    void computeForce(const SimTK::State& s,
+                      SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                      SimTK::Vector& generalizedForces) const override;
+    /** The elastic energy stored in the contacts. */
+    double computePotentialEnergy(const SimTK::State& s) const override;
+
+    void extendFinalizeFromProperties() override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+private:
+    // INITIALIZATION
+    void constructProperties();
+
+    // Compute the force applied to each sphere and the point where it acts,
+    // if they are not already in the cache.
+    void realizeContacts(const SimTK::State& s) const;
+
+    // The geometry of the spheres, one entry per sphere, set in
+    // extendAddToSystem(): the body each sphere is fixed to and the location
+    // of its center in that body.
+    SimTK::ResetOnCopy<std::vector<SimTK::MobilizedBodyIndex>> _sphereBodies;
+    SimTK::ResetOnCopy<std::vector<SimTK::Vec3>> _sphereCenters;
+    SimTK::ResetOnCopy<std::vector<double>> _sphereRadii;
+    // The body the half space is fixed to and its transform in that body.
+    SimTK::MobilizedBodyIndex _halfSpaceBody;
+    SimTK::Transform _halfSpaceTransform;
+
+    // The force applied to each sphere and the point where it acts, in
+    // Ground, and the elastic energy stored in all the contacts.
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Array_<SimTK::Vec3>>>
+        _forcesCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<SimTK::Array_<SimTK::Vec3>>>
+        _pointsCV;
+    mutable SimTK::ResetOnCopy<CacheVariable<double>> _potentialEnergyCV;
+
+//==============================================================================
+};  // END of class SphereHalfSpaceContactForce
+//==============================================================================
+//==============================================================================
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_SPHERE_HALF_SPACE_CONTACT_FORCE_H_
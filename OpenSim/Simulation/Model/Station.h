@@ -75,6 +75,13 @@ public:
     /** Find this Station's location in any Frame */
     SimTK::Vec3 findLocationInFrame(const SimTK::State& s,
                                     const OpenSim::Frame& frame) const;
+
+protected:
+    /** A Station adds the same cache variables to the System whatever its
+    location and frame, so it may be moved or attached to another frame
+    without building the System again. */
+    bool canFinalizeInSystem() const override { return true; }
+
 private:
     /* Calculate the Station's location with respect to and expressed in Ground
     */
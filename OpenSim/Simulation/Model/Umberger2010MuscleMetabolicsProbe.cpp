@@ -239,6 +239,24 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
     Vector EdotOutput(getNumProbeInputs());
     EdotOutput = 0;
 
+    // Read the settings of the probe once rather than for every muscle.
+    const bool activation_maintenance_rate_on =
+        get_activation_maintenance_rate_on();
+    const double aerobic_factor = get_aerobic_factor();
+    const bool enforce_minimum_heat_rate_per_muscle =
+        get_enforce_minimum_heat_rate_per_muscle();
+    const bool forbid_negative_total_power = get_forbid_negative_total_power();
+    const bool include_negative_mechanical_work =
+        get_include_negative_mechanical_work();
+    const bool mechanical_work_rate_on = get_mechanical_work_rate_on();
+    const double muscle_effort_scaling_factor =
+        get_muscle_effort_scaling_factor();
+    const bool report_total_metabolics_only =
+        get_report_total_metabolics_only();
+    const bool shortening_rate_on = get_shortening_rate_on();
+    const bool use_Bhargava_recruitment_model =
+        get_use_Bhargava_recruitment_model();
+
 
     // BASAL METABOLIC RATE (W) (based on whole body mass, not muscle mass)
     // so do outside of muscle loop.
@@ -252,30 +270,30 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
     }
     EdotOutput(0) += Bdot;       // TOTAL metabolic power storage
     
-    if (!get_report_total_metabolics_only())
+    if (!report_total_metabolics_only)
         EdotOutput(1) = Bdot;    // BASAL metabolic power storage
     
 
     // Loop through each muscle in the MetabolicMuscleParameterSet
-    const int nM = 
-        get_Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet()
-        .getSize();
+    const auto& muscleParameters =
+        get_Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet();
+    const int nM = muscleParameters.getSize();
     for (int i=0; i<nM; ++i)
     {
         // Get the current muscle parameters from the MetabolicMuscleParameterSet
         // and the corresponding OpenSim::Muscle pointer from the muscleMap.
-        Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameter& mm = 
-            get_Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet()[i];
+        Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameter& mm =
+            muscleParameters[i];
         const Muscle* m = mm.getMuscle();
 
         // Get some muscle properties at the current time state
         //const double max_isometric_force = m->getMaxIsometricForce();
         const double max_shortening_velocity = m->getMaxContractionVelocity();
-        const double activation = get_muscle_effort_scaling_factor()
+        const double activation = muscle_effort_scaling_factor
                                   * m->getActivation(s);
-        const double excitation = get_muscle_effort_scaling_factor()
+        const double excitation = muscle_effort_scaling_factor
                                   * m->getControl(s);
-        double fiber_force_active = get_muscle_effort_scaling_factor()
+        double fiber_force_active = muscle_effort_scaling_factor
                                     * m->getActiveFiberForce(s);
         const double fiber_length_normalized = m->getNormalizedFiberLength(s);
         const double fiber_velocity = m->getFiberVelocity(s);
@@ -318,22 +336,22 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // --> depends on the normalized fiber length of the contractile element
         // -----------------------------------------------------------------------
         double slowTwitchRatio = mm.get_ratio_slow_twitch_fibers();
-        if (get_use_Bhargava_recruitment_model()) {
+        if (use_Bhargava_recruitment_model) {
             const double uSlow = slowTwitchRatio * sin(0.5*Pi * excitation);
             const double uFast = (1 - slowTwitchRatio)
                                  * (1 - cos(0.5*Pi * excitation));
             slowTwitchRatio = (excitation == 0) ? 1.0 : uSlow / (uSlow + uFast);
         }
 
-        if (get_forbid_negative_total_power() ||
-            get_activation_maintenance_rate_on())
+        if (forbid_negative_total_power ||
+            activation_maintenance_rate_on)
         {
             const double unscaledAMdot = 128*(1 - slowTwitchRatio) + 25;
 
             if (fiber_length_normalized <= 1.0)
-                AMdot = get_aerobic_factor() * std::pow(A, 0.6) * unscaledAMdot;
+                AMdot = aerobic_factor * std::pow(A, 0.6) * unscaledAMdot;
             else
-                AMdot = get_aerobic_factor() * std::pow(A, 0.6) * ((0.4 * unscaledAMdot) + (0.6 * unscaledAMdot * F_iso));
+                AMdot = aerobic_factor * std::pow(A, 0.6) * ((0.4 * unscaledAMdot) + (0.6 * unscaledAMdot * F_iso));
         }
 
 
@@ -342,7 +360,7 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // --> depends on the normalized fiber length of the contractile element
         // --> note that we define Vm<0 as shortening and Vm>0 as lengthening
         // -----------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_shortening_rate_on())
+        if (forbid_negative_total_power || shortening_rate_on)
         {
             const double Vmax_fasttwitch = max_shortening_velocity;
             const double Vmax_slowtwitch = max_shortening_velocity / 2.5;
@@ -366,15 +384,15 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
 
                 tmp_fastTwitch = alpha_shortening_fasttwitch * fiber_velocity_normalized * (1-slowTwitchRatio);
                 unscaledSdot = (tmp_slowTwitch * slowTwitchRatio) - tmp_fastTwitch;   // unscaled shortening heat rate: muscle shortening
-                Sdot = get_aerobic_factor() * std::pow(A, 2.0) * unscaledSdot;                      // scaled shortening heat rate: muscle shortening
+                Sdot = aerobic_factor * std::pow(A, 2.0) * unscaledSdot;                      // scaled shortening heat rate: muscle shortening
             }
 
             else    // eccentric contraction, Vm>0
             {
                 unscaledSdot =
-                    (get_include_negative_mechanical_work() ? 4.0 : 0.3)
+                    (include_negative_mechanical_work ? 4.0 : 0.3)
                     * alpha_shortening_slowtwitch * fiber_velocity_normalized;  // unscaled shortening heat rate: muscle lengthening
-                Sdot = get_aerobic_factor() * A * unscaledSdot;                                // scaled shortening heat rate: muscle lengthening
+                Sdot = aerobic_factor * A * unscaledSdot;                                // scaled shortening heat rate: muscle lengthening
             }
 
 
@@ -396,9 +414,9 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // MECHANICAL WORK RATE for the contractile element of muscle i (W/kg).
         // --> note that we define Vm<0 as shortening and Vm>0 as lengthening.
         // -------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_mechanical_work_rate_on())
+        if (forbid_negative_total_power || mechanical_work_rate_on)
         {
-            if (get_include_negative_mechanical_work() || fiber_velocity <= 0)
+            if (include_negative_mechanical_work || fiber_velocity <= 0)
                 Wdot = -fiber_force_active*fiber_velocity;
             else
                 Wdot = 0;
@@ -409,7 +427,7 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
 
         // If necessary, increase the shortening heat rate so that the total
         // power is non-negative.
-        if (get_forbid_negative_total_power()) {
+        if (forbid_negative_total_power) {
             const double Edot_Wkg_beforeClamp = AMdot + Sdot + Wdot;
             if (Edot_Wkg_beforeClamp < 0)
                 Sdot -= Edot_Wkg_beforeClamp;
@@ -431,9 +449,9 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // -----------------------------------------------------------------------
         double totalHeatRate = AMdot + Sdot;
 
-        if(get_enforce_minimum_heat_rate_per_muscle() && totalHeatRate < 1.0 
-            && get_activation_maintenance_rate_on() 
-            && get_shortening_rate_on()) {
+        if(enforce_minimum_heat_rate_per_muscle && totalHeatRate < 1.0 
+            && activation_maintenance_rate_on 
+            && shortening_rate_on) {
                 //cout << "WARNING: " << getName() 
                 //    << "  (t = " << s.getTime() 
                 //    << "), the muscle '" << mm.getName() 
@@ -447,20 +465,20 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // ------------------------------------------
         double Edot = 0;
 
-        if (get_activation_maintenance_rate_on() && get_shortening_rate_on())
+        if (activation_maintenance_rate_on && shortening_rate_on)
             Edot += totalHeatRate;      // May have been clamped to 1.0 W/kg.
         else {
-            if (get_activation_maintenance_rate_on())
+            if (activation_maintenance_rate_on)
                 Edot += AMdot;
-            if (get_shortening_rate_on())
+            if (shortening_rate_on)
                 Edot += Sdot;
         }
-        if (get_mechanical_work_rate_on())
+        if (mechanical_work_rate_on)
             Edot += Wdot;
         Edot *= mm.getMuscleMass();
 
         EdotOutput(0) += Edot;       // Add to TOTAL metabolic power storage
-        if (!get_report_total_metabolics_only()) {
+        if (!report_total_metabolics_only) {
             // Metabolic power storage for muscle i
             EdotOutput(i+2) = Edot;  
         }                          
@@ -24,6 +24,7 @@
 #include "MomentArmSolver.h"
 #include "Model/PointForceDirection.h"
 #include "Model/Model.h"
+#include "Model/GeometryPath.h"
 
 using namespace std;
 using namespace SimTK;
@@ -132,6 +133,55 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
     return ~_coupling*_generalizedForces;
 }
 
+Matrix MomentArmSolver::solve(const State &state,
+                              const std::vector<const Coordinate*> &coordinates,
+                              const std::vector<const GeometryPath*> &paths) const
+{
+    //Local modifiable copy of the state
+    State& s_ma = _stateCopy;
+    s_ma.updQ() = state.getQ();
+
+    const int nc = (int)coordinates.size();
+    const int np = (int)paths.size();
+    const int nu = s_ma.getNU();
+
+    // The coupling between coordinates due to constraints depends only on the
+    // coordinate of interest, so compute it once for each coordinate.
+    Matrix coupling(nu, nc);
+    for (int i = 0; i < nc; ++i)
+        coupling.updCol(i) = computeCouplingVector(s_ma, *coordinates[i]);
+
+    // set speeds to zero
+    s_ma.updU() = 0;
+    getModel().getMultibodySystem().realize(s_ma, Stage::Position);
+
+    // The generalized forces due to a unit tension along a path do not depend
+    // on the coordinate of interest, so compute them once for each path.
+    Matrix generalizedForces(nu, np);
+    Vector pathDependentMobilityForces(nu);
+    for (int j = 0; j < np; ++j) {
+        // zero out all the forces
+        _bodyForces *= 0;
+        pathDependentMobilityForces = 0;
+
+        // apply a tension of unity to the bodies of the path
+        paths[j]->addInEquivalentForces(s_ma, 1.0, _bodyForces,
+                                        pathDependentMobilityForces);
+
+        // f = ~J(q) * F
+        getModel().getMultibodySystem().getMatterSubsystem()
+            .multiplyBySystemJacobianTranspose(s_ma, _bodyForces,
+                                               _generalizedForces);
+
+        generalizedForces.updCol(j) =
+            _generalizedForces + pathDependentMobilityForces;
+    }
+
+    // Each moment-arm is the effective torque at a coordinate (since tension
+    // is 1) taking into account the coupling to the other coordinates.
+    return ~coupling*generalizedForces;
+}
+
 SimTK::Vector MomentArmSolver::computeCouplingVector(SimTK::State &state, 
         const Coordinate &coordinate) const
 {
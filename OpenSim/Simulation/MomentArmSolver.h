@@ -26,6 +26,8 @@
 #include "Solver.h"
 #include "SimTKcommon/internal/State.h"
 
+#include <vector>
+
 namespace OpenSim {
 
 class GeometryPath;
@@ -83,6 +85,20 @@ public:
     double solve(const SimTK::State& state, const Coordinate &coordinate, 
         const Array<PointForceDirection *> &pfds) const;
 
+    /** Solve for the effective moment-arms of several GeometryPaths about
+        several coordinates at once. The constraint coupling of each coordinate
+        and the generalized forces of each path are computed only once, so this
+        is much cheaper than calling solve() for every coordinate and path.
+    @param  state               current state of the model
+    @param  coordinates         Coordinates about which we want the moment-arms
+    @param  paths               GeometryPaths for which to calculate moment-arms
+    @return ma                  matrix of moment-arms with a row for each
+                                coordinate and a column for each path
+    */
+    SimTK::Matrix solve(const SimTK::State& state,
+        const std::vector<const Coordinate*>& coordinates,
+        const std::vector<const GeometryPath*>& paths) const;
+
 private:
     // Internal state of the solver initialized as a copy of the default state
     mutable SimTK::State _stateCopy;
@@ -0,0 +1,199 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  OrientationsReference.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "OrientationsReference.h"
+#include "MarkersReference.h"
+#include <SimTKcommon/internal/State.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+OrientationsReference::OrientationsReference() :
+    Reference_<SimTK::Rotation>() {
+    constructProperties();
+}
+
+OrientationsReference::OrientationsReference(
+        const std::string& orientationFile) :
+    OrientationsReference() {
+    loadOrientationsFile(orientationFile);
+}
+
+OrientationsReference::OrientationsReference(
+        const TimeSeriesTable_<SimTK::Quaternion>& orientationData,
+        const Set<OrientationWeight>* orientationWeightSet) :
+    OrientationsReference() {
+    if(orientationWeightSet != nullptr)
+        upd_orientation_weights() = *orientationWeightSet;
+    populateFromOrientationData(orientationData);
+}
+
+void OrientationsReference::loadOrientationsFile(
+        const std::string orientationFile) {
+    auto fileExt = FileAdapter::findExtension(orientationFile);
+    OPENSIM_THROW_IF(fileExt != "sto",
+                     UnsupportedFileType,
+                     orientationFile,
+                     "Supported file types are -- STO.");
+
+    populateFromOrientationData(
+            TimeSeriesTable_<SimTK::Quaternion>{orientationFile});
+    upd_orientation_file() = orientationFile;
+}
+
+void OrientationsReference::populateFromOrientationData(
+        const TimeSeriesTable_<SimTK::Quaternion>& orientationData) {
+    _orientationTable = orientationData;
+
+    const auto& names = _orientationTable.getColumnLabels();
+    setOrientationNames(SimTK::Array_<std::string>(names.begin(),
+                                                   names.end()));
+
+    // Convert every quaternion once, rather than at every frame solved.
+    const int nr = getNumRefs();
+    _rotations.resize(_orientationTable.getNumRows()*nr);
+    for(size_t r = 0; r < _orientationTable.getNumRows(); ++r) {
+        const auto row = _orientationTable.getRowAtIndex(r);
+        for(int i = 0; i < nr; ++i)
+            _rotations[r*nr + i] = convertToRotation(row[i]);
+    }
+}
+
+SimTK::Rotation
+OrientationsReference::convertToRotation(const SimTK::Quaternion& q) {
+    SimTK::Rotation R;
+    if(q.isNaN())
+        R.setRotationToNaN();
+    else
+        R.setRotationFromQuaternion(q);
+    return R;
+}
+
+void OrientationsReference::setOrientationNames(
+        const SimTK::Array_<std::string>& names) {
+    _orientationNames = names;
+    _weights.clear();
+    _weights.assign(names.size(), get_default_weight());
+
+    // Names must be assigned before weights can be updated
+    updateInternalWeights();
+}
+
+SimTK::Vec2 OrientationsReference::getValidTimeRange() const {
+    OPENSIM_THROW_IF(_orientationTable.getNumRows() == 0,
+                     Exception,
+                     "Orientation table is empty.");
+
+    return {_orientationTable.getIndependentColumn().front(),
+            _orientationTable.getIndependentColumn().back()};
+}
+
+void OrientationsReference::constructProperties() {
+    constructProperty_orientation_file("");
+    Set<OrientationWeight> orientationWeights;
+    constructProperty_orientation_weights(orientationWeights);
+    constructProperty_default_weight(1.0);
+}
+
+const SimTK::Array_<std::string>& OrientationsReference::getNames() const {
+    return _orientationNames;
+}
+
+void OrientationsReference::getValues(const SimTK::State& s,
+        SimTK::Array_<SimTK::Rotation>& values) const {
+    const auto& times = _orientationTable.getIndependentColumn();
+    OPENSIM_THROW_IF(times.empty(), Exception, "Orientation table is empty.");
+
+    // Index of the frame nearest the time of the state.
+    const double time = s.getTime();
+    auto iter = std::lower_bound(times.begin(), times.end(), time);
+    if(iter == times.end() || (iter != times.begin() &&
+            (*iter - time) > (time - *std::prev(iter))))
+        --iter;
+    const size_t r = std::distance(times.begin(), iter);
+
+    const int nr = getNumRefs();
+    values.resize(nr);
+    for(int i = 0; i < nr; ++i)
+        values[i] = _rotations[r*nr + i];
+}
+
+void OrientationsReference::getWeights(const SimTK::State &s,
+                                       SimTK::Array_<double> &weights) const {
+    updateInternalWeights();
+    weights = _weights;
+}
+
+void OrientationsReference::setOrientationWeightSet(
+        const Set<OrientationWeight>& orientationWeights) {
+    upd_orientation_weights() = orientationWeights;
+}
+
+void OrientationsReference::setDefaultWeight(double weight) {
+    set_default_weight(weight);
+}
+
+void OrientationsReference::updateInternalWeights() const {
+    // if weights are not being changed, do not rebuild list of weights.
+    if (isObjectUpToDateWithProperties())
+        return;
+
+    // Orientations that do not have a weight specified in the
+    // orientation_weights property use the default weight.
+    _weights.assign(getNumRefs(), get_default_weight());
+
+    int wix = -1;
+    int ix = 0;
+    for (const std::string &name : _orientationNames) {
+        wix = get_orientation_weights().getIndex(name, wix);
+        if (wix >= 0)
+            _weights[ix] = get_orientation_weights()[wix].getWeight();
+        ++ix;
+    }
+}
+
+int OrientationsReference::getNumRefs() const {
+    return static_cast<int>(_orientationNames.size());
+}
+
+double OrientationsReference::getSamplingFrequency() const {
+    if(_orientationTable.hasTableMetaDataKey("DataRate")) {
+        auto datarate =
+            _orientationTable.getTableMetaData<std::string>("DataRate");
+        return std::stod(datarate);
+    } else
+        return SimTK::NaN;
+}
+
+const std::vector<double>& OrientationsReference::getTimes() const {
+    return _orientationTable.getIndependentColumn();
+}
+
+size_t OrientationsReference::getNumFrames() const {
+    return _orientationTable.getNumRows();
+}
+
+} // end of namespace OpenSim
@@ -45,9 +45,11 @@
 #include "Model/ContactMesh.h"
 #include "Model/ContactSphere.h"
 #include "Model/CoordinateLimitForce.h"
+#include "Model/BatchedCoordinateLimitForce.h"
 #include "Model/CoordinateSet.h"
 #include "Model/ElasticFoundationForce.h"
 #include "Model/HuntCrossleyForce.h"
+#include "Model/SphereHalfSpaceContactForce.h"
 #include "Model/Ligament.h"
 #include "Model/JointSet.h"
 #include "Model/Marker.h"
@@ -66,8 +68,12 @@
 #include "Model/BushingForce.h"
 #include "Model/FunctionBasedBushingForce.h"
 #include "Model/ExpressionBasedBushingForce.h"
+#include "Model/BatchedBushingForce.h"
 #include "Model/ExternalLoads.h"
 #include "Model/PathActuator.h"
+#include "Model/MuscleGroup.h"
+#include "Model/FunctionThresholdCondition.h"
+#include "Model/ConditionEvent.h"
 #include "Model/ProbeSet.h"
 #include "Model/ActuatorPowerProbe.h"
 #include "Model/ActuatorForceProbe.h"
@@ -84,6 +90,9 @@
 #include "Control/ControlConstant.h"
 #include "Control/ControlLinear.h"
 #include "Control/PrescribedController.h"
+#include "Control/LiveController.h"
+#include "Control/TaskSpaceController.h"
+#include "Control/ReflexController.h"
 #include "Control/ToyReflexController.h"
 
 #include "Wrap/PathWrap.h"
@@ -122,6 +131,7 @@
 #include "SimbodyEngine/SpatialTransform.h"
 
 #include "StatesTrajectoryReporter.h"
+#include "StatesFileReporter.h"
 
 #include <string>
 #include <iostream>
@@ -141,123 +151,134 @@ OSIMSIMULATION_API void RegisterTypes_osimSimulation()
 {
   try {
 
-    Object::registerType( AnalysisSet() );
-    Object::registerType( Model() );
-    Object::registerType( BodyScale() );
-    Object::registerType( BodyScaleSet());
-    Object::registerType( BodySet());
-    Object::registerType( ComponentSet() );
-    Object::registerType( ControllerSet() );
-    Object::registerType( ConstraintSet() );
-    Object::registerType( CoordinateSet() );
-    Object::registerType( ForceSet() );
-    Object::registerType( ExternalLoads() );
-
-    Object::registerType( JointSet() );
-    Object::registerType( Marker() );
-    Object::registerType( Station() );
-    Object::registerType( MarkerSet() );
-    Object::registerType( PathPoint() );
-    Object::registerType( PathPointSet() );
-    Object::registerType( ConditionalPathPoint() );
-    Object::registerType( MovingPathPoint() );
-    Object::registerType( SurfaceProperties());
-    Object::registerType( Appearance());
-    Object::registerType( ModelVisualPreferences());
-
-    Object::registerType( Brick());
-    Object::registerType( Sphere());
-    Object::registerType( Cylinder());
-    Object::registerType( Ellipsoid());
-    Object::registerType( Mesh());
-    Object::registerType( Torus());
-    Object::registerType( Cone());
-    Object::registerType( LineGeometry());
-    Object::registerType( FrameGeometry());
-    Object::registerType( Arrow());
-    Object::registerType( GeometryPath());
-
-    Object::registerType( ControlSet() );
-    Object::registerType( ControlConstant() );
-    Object::registerType( ControlLinear() );
-    Object::registerType( ControlLinearNode() );
-
-    Object::registerType( PathWrap() );
-    Object::registerType( PathWrapSet() );
-    Object::registerType( WrapCylinder() );
-    Object::registerType( WrapEllipsoid() );
-    Object::registerType( WrapSphere() );
-    Object::registerType( WrapTorus() );
-    Object::registerType( WrapObjectSet() );
-    Object::registerType( WrapCylinderObst() );
-    Object::registerType( WrapSphereObst() );
-    Object::registerType( WrapDoubleCylinderObst() );
+    Object::registerType<AnalysisSet>();
+    Object::registerType<Model>();
+    Object::registerType<BodyScale>();
+    Object::registerType<BodyScaleSet>();
+    Object::registerType<BodySet>();
+    Object::registerType<ComponentSet>();
+    Object::registerType<ControllerSet>();
+    Object::registerType<ConstraintSet>();
+    Object::registerType<CoordinateSet>();
+    Object::registerType<ForceSet>();
+    Object::registerType<ExternalLoads>();
+
+    Object::registerType<JointSet>();
+    Object::registerType<Marker>();
+    Object::registerType<Station>();
+    Object::registerType<MarkerSet>();
+    Object::registerType<PathPoint>();
+    Object::registerType<PathPointSet>();
+    Object::registerType<ConditionalPathPoint>();
+    Object::registerType<MovingPathPoint>();
+    Object::registerType<SurfaceProperties>();
+    Object::registerType<Appearance>();
+    Object::registerType<ModelVisualPreferences>();
+
+    Object::registerType<Brick>();
+    Object::registerType<Sphere>();
+    Object::registerType<Cylinder>();
+    Object::registerType<Ellipsoid>();
+    Object::registerType<Mesh>();
+    Object::registerType<Torus>();
+    Object::registerType<Cone>();
+    Object::registerType<LineGeometry>();
+    Object::registerType<FrameGeometry>();
+    Object::registerType<Arrow>();
+    Object::registerType<GeometryPath>();
+
+    Object::registerType<ControlSet>();
+    Object::registerType<ControlConstant>();
+    Object::registerType<ControlLinear>();
+    Object::registerType<ControlLinearNode>();
+
+    Object::registerType<PathWrap>();
+    Object::registerType<PathWrapSet>();
+    Object::registerType<WrapCylinder>();
+    Object::registerType<WrapEllipsoid>();
+    Object::registerType<WrapSphere>();
+    Object::registerType<WrapTorus>();
+    Object::registerType<WrapObjectSet>();
+    Object::registerType<WrapCylinderObst>();
+    Object::registerType<WrapSphereObst>();
+    Object::registerType<WrapDoubleCylinderObst>();
 
     // CURRENT RELEASE
-    Object::registerType( SimbodyEngine() );
-    Object::registerType( OpenSim::Body() );
-    Object::registerType( OpenSim::Ground());
-    Object::registerType( PhysicalOffsetFrame());
-
-    Object::registerType( WeldJoint());
-    Object::registerType( CustomJoint());
-    Object::registerType( EllipsoidJoint() );
-    Object::registerType( FreeJoint() );
-    Object::registerType( BallJoint() );
-    Object::registerType( GimbalJoint() );
-    Object::registerType( UniversalJoint() );
-    Object::registerType( PinJoint() );
-    Object::registerType( SliderJoint() );
-    Object::registerType( PlanarJoint() );
-    Object::registerType( TransformAxis() );
-    Object::registerType( Coordinate() );
-    Object::registerType( SpatialTransform() );
-
-    Object::registerType(WeldConstraint());
-    Object::registerType(PointConstraint());
-    Object::registerType(ConstantDistanceConstraint());
-    Object::registerType(CoordinateCouplerConstraint());
-    Object::registerType(PointOnLineConstraint());
-    Object::registerType(RollingOnSurfaceConstraint());
-
-    Object::registerType( ContactGeometrySet() );
-    Object::registerType( ContactHalfSpace() );
-    Object::registerType( ContactMesh() );
-    Object::registerType( ContactSphere() );
-    Object::registerType( CoordinateLimitForce() );
-    Object::registerType( HuntCrossleyForce() );
-    Object::registerType( ElasticFoundationForce() );
-    Object::registerType( HuntCrossleyForce::ContactParameters() );
-    Object::registerType( HuntCrossleyForce::ContactParametersSet() );
-    Object::registerType( ElasticFoundationForce::ContactParameters() );
-    Object::registerType( ElasticFoundationForce::ContactParametersSet() );
-
-    Object::registerType( Ligament() );
-    Object::registerType( PrescribedForce() );
-    Object::registerType( ExternalForce() );
-    Object::registerType( PointToPointSpring() );
-    Object::registerType( ExpressionBasedPointToPointForce() );
-    Object::registerType( PathSpring() );
-    Object::registerType( BushingForce() );
-    Object::registerType( FunctionBasedBushingForce() );
-    Object::registerType( ExpressionBasedBushingForce() );
-
-    Object::registerType( ControlSetController() );
-    Object::registerType( PrescribedController() );
-    Object::registerType( ToyReflexController() );
-
-    Object::registerType( PathActuator() );
-    Object::registerType( ProbeSet() );
-    Object::registerType( JointInternalPowerProbe() );
-    Object::registerType( SystemEnergyProbe() );
-    Object::registerType( Umberger2010MuscleMetabolicsProbe() );
-    Object::registerType( Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet() );
-    Object::registerType( Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameter() );
-    Object::registerType( Bhargava2004MuscleMetabolicsProbe() );
-    Object::registerType( Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet() );
-    Object::registerType( Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameter() );
-
-    Object::registerType( StatesTrajectoryReporter() );
+    Object::registerType<SimbodyEngine>();
+    Object::registerType<OpenSim::Body>();
+    Object::registerType<OpenSim::Ground>();
+    Object::registerType<PhysicalOffsetFrame>();
+
+    Object::registerType<WeldJoint>();
+    Object::registerType<CustomJoint>();
+    Object::registerType<EllipsoidJoint>();
+    Object::registerType<FreeJoint>();
+    Object::registerType<BallJoint>();
+    Object::registerType<GimbalJoint>();
+    Object::registerType<UniversalJoint>();
+    Object::registerType<PinJoint>();
+    Object::registerType<SliderJoint>();
+    Object::registerType<PlanarJoint>();
+    Object::registerType<TransformAxis>();
+    Object::registerType<Coordinate>();
+    Object::registerType<SpatialTransform>();
+
+    Object::registerType<WeldConstraint>();
+    Object::registerType<PointConstraint>();
+    Object::registerType<ConstantDistanceConstraint>();
+    Object::registerType<CoordinateCouplerConstraint>();
+    Object::registerType<PointOnLineConstraint>();
+    Object::registerType<RollingOnSurfaceConstraint>();
+
+    Object::registerType<ContactGeometrySet>();
+    Object::registerType<ContactHalfSpace>();
+    Object::registerType<ContactMesh>();
+    Object::registerType<ContactSphere>();
+    Object::registerType<CoordinateLimitForce>();
+    Object::registerType<BatchedCoordinateLimitForce>();
+    Object::registerType<HuntCrossleyForce>();
+    Object::registerType<ElasticFoundationForce>();
+    Object::registerType<SphereHalfSpaceContactForce>();
+    Object::registerType<HuntCrossleyForce::ContactParameters>();
+    Object::registerType<HuntCrossleyForce::ContactParametersSet>();
+    Object::registerType<ElasticFoundationForce::ContactParameters>();
+    Object::registerType<ElasticFoundationForce::ContactParametersSet>();
+
+    Object::registerType<Ligament>();
+    Object::registerType<PrescribedForce>();
+    Object::registerType<ExternalForce>();
+    Object::registerType<PointToPointSpring>();
+    Object::registerType<ExpressionBasedPointToPointForce>();
+    Object::registerType<PathSpring>();
+    Object::registerType<BushingForce>();
+    Object::registerType<FunctionBasedBushingForce>();
+    Object::registerType<ExpressionBasedBushingForce>();
+    Object::registerType<BatchedBushingForce>();
+
+    Object::registerType<ControlSetController>();
+    Object::registerType<PrescribedController>();
+    Object::registerType<LiveController>();
+    Object::registerType<TaskSpaceController>();
+    Object::registerType<ReflexController>();
+    Object::registerType<ToyReflexController>();
+
+    Object::registerType<PathActuator>();
+    Object::registerType<MuscleGroup>();
+    Object::registerType<Condition>();
+    Object::registerType<FunctionThresholdCondition>();
+    Object::registerType<ConditionEvent>();
+    Object::registerType<ProbeSet>();
+    Object::registerType<JointInternalPowerProbe>();
+    Object::registerType<SystemEnergyProbe>();
+    Object::registerType<Umberger2010MuscleMetabolicsProbe>();
+    Object::registerType<Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet>();
+    Object::registerType<Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameter>();
+    Object::registerType<Bhargava2004MuscleMetabolicsProbe>();
+    Object::registerType<Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet>();
+    Object::registerType<Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameter>();
+
+    Object::registerType<StatesTrajectoryReporter>();
+    Object::registerType<StatesFileReporter>();
 
     // OLD Versions
     // Associate an instance with old name to help deserialization.
@@ -28,8 +28,11 @@
 #include "CoordinateCouplerConstraint.h"
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/SimbodyEngine/Joint.h>
+#include <OpenSim/Common/FunctionGroup.h>
 #include "simbody/internal/Constraint.h"
 
+#include <algorithm>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -162,6 +165,43 @@ void Coordinate::extendFinalizeFromProperties()
     _lockedWarningGiven=false;
 
     _speedName = getName() + "/speed";
+
+    // The group of prescribed functions is made again for the new system.
+    _prescribedFunctions.reset();
+}
+
+bool Coordinate::hasPrescribedFunctionOfTime() const
+{
+    return !getProperty_prescribed_function().empty() &&
+           get_prescribed_function().getArgumentSize() == 1;
+}
+
+std::shared_ptr<const FunctionGroup>
+Coordinate::findPrescribedFunctionGroup(int& index) const
+{
+    // The coordinates of the model prescribed by functions of time, in order.
+    std::vector<const Coordinate*> coords;
+    const CoordinateSet& coordSet = getModel().getCoordinateSet();
+    for (int i = 0; i < coordSet.getSize(); ++i)
+        if (coordSet[i].hasPrescribedFunctionOfTime())
+            coords.push_back(&coordSet[i]);
+    const auto it = std::find(coords.begin(), coords.end(), this);
+
+    // A coordinate that is not in the CoordinateSet is evaluated alone.
+    if (it == coords.end()) {
+        auto group = std::make_shared<FunctionGroup>();
+        index = group->addFunction(get_prescribed_function());
+        return group;
+    }
+
+    std::shared_ptr<FunctionGroup>& group = coords[0]->_prescribedFunctions;
+    if (!group) {
+        group = std::make_shared<FunctionGroup>();
+        for (const auto* coord : coords)
+            group->addFunction(coord->get_prescribed_function());
+    }
+    index = int(it - coords.begin());
+    return group;
 }
 
 void Coordinate::extendAddToSystem(SimTK::MultibodySystem& system) const
@@ -191,10 +231,22 @@ void Coordinate::extendAddToSystem(SimTK::MultibodySystem& system) const
     mutableThis->_lockedConstraintIndex = lock.getConstraintIndex();
             
     if(!getProperty_prescribed_function().empty()){
+        // Functions of time are evaluated with those of other coordinates.
+        SimTK::Function* prescribedFunction = nullptr;
+        if (hasPrescribedFunctionOfTime()) {
+            int index = 0;
+            std::shared_ptr<const FunctionGroup> group =
+                findPrescribedFunctionGroup(index);
+            prescribedFunction =
+                FunctionGroup::createSimTKFunction(group, index);
+        }
+        else
+            prescribedFunction = get_prescribed_function().createSimTKFunction();
+
         //create prescribed motion constraint automatically
         SimTK::Constraint::PrescribedMotion prescribe( 
                 _model->updMatterSubsystem(), 
-                get_prescribed_function().createSimTKFunction(), 
+                prescribedFunction, 
                 _bodyIndex, 
                 SimTK::MobilizerQIndex(_mobilizerQIndex));
         mutableThis->_prescribedConstraintIndex = prescribe.getConstraintIndex();
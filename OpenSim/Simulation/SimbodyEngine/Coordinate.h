@@ -30,11 +30,14 @@
 #include <OpenSim/Common/Function.h>
 #include <OpenSim/Simulation/Model/ModelComponent.h>
 
+#include <memory>
+
 class ModifiableConstant;
 
 namespace OpenSim {
 
 class Function;
+class FunctionGroup;
 class Joint;
 class Model;
 
@@ -47,6 +50,11 @@ class Model;
  * As a ModelComponent it provides resources to enable a Coordinate to be
  * locked, prescribed, or clamped (limited to a min-to-max range).
  *
+ * The prescribed functions of time of the coordinates of a model are
+ * evaluated together (see FunctionGroup), with their first and second
+ * derivatives, when Simbody first asks one of them for any of these at a
+ * time.
+ *
  * @authors Ajay Seth, Ayman Habib, Michael Sherman 
  */
 class OSIMSIMULATION_API Coordinate : public ModelComponent {
@@ -312,12 +320,25 @@ private:
 
     mutable bool _lockedWarningGiven;
 
+    /* The group of the prescribed functions of time of the coordinates of
+    the model, kept by the first of these coordinates. */
+    mutable SimTK::ResetOnCopy<std::shared_ptr<FunctionGroup>>
+        _prescribedFunctions;
+
     // PRIVATE METHODS implementing the Component interface
     void constructProperties();
     void extendFinalizeFromProperties() override;
 
+    // Whether the prescribed function is a function of time alone.
+    bool hasPrescribedFunctionOfTime() const;
+    // The group of the prescribed functions of time of the coordinates of
+    // the model, and the index of the function of this coordinate in it.
+    std::shared_ptr<const FunctionGroup>
+        findPrescribedFunctionGroup(int& index) const;
+
     friend class CoordinateCouplerConstraint; 
     friend class Joint; 
+    friend class JointInternalPowerProbe;
 
 //=============================================================================
 };  // END of class Coordinate
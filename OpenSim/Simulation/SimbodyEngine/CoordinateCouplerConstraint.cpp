@@ -26,8 +26,11 @@
 //=============================================================================
 #include "CoordinateCouplerConstraint.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/FunctionGroup.h>
 #include "simbody/internal/Constraint.h"
 
+#include <algorithm>
+
 // Helper class to construct functions when user's specify a dependency as qd = f(qi)
 // this function casts as C(q) = 0 = f(qi) - qd;
 
@@ -86,6 +89,50 @@ public:
     }
 };
 
+// The CompoundFunction of the function of one independent coordinate that
+// is evaluated through a FunctionGroup: scale*f(x[0]) - x[1].
+class GroupedCompoundFunction : public SimTK::Function {
+private:
+    std::shared_ptr<const OpenSim::FunctionGroup> group;
+    const int index;
+    const double scale;
+
+public:
+    GroupedCompoundFunction(std::shared_ptr<const OpenSim::FunctionGroup> group,
+                            int index, double scale)
+        : group(std::move(group)), index(index), scale(scale) {
+    }
+
+    double calcValue(const SimTK::Vector& x) const override {
+        return scale*group->calcValueAndDerivatives(index, x[0])[0] - x[1];
+    }
+
+    double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const {
+        return calcDerivative(SimTK::ArrayViewConst_<int>(derivComponents),x);
+    }
+
+    double calcDerivative(const SimTK::Array_<int>& derivComponents, const SimTK::Vector& x) const override {
+        if (derivComponents.size() == 1){
+            if (derivComponents[0]==0)
+                return scale*group->calcValueAndDerivatives(index, x[0])[1];
+            else if (derivComponents[0]==1)
+                return -1;
+        }
+        else if(derivComponents.size() == 2){
+            if (derivComponents[0]==0 && derivComponents[1] == 0)
+                return scale*group->calcValueAndDerivatives(index, x[0])[2];
+        }
+        return 0;
+    }
+
+    int getArgumentSize() const override {
+        return 2;
+    }
+    int getMaxDerivativeOrder() const override {
+        return 2;
+    }
+};
+
 
 //=============================================================================
 // STATICS
@@ -183,6 +230,49 @@ void CoordinateCouplerConstraint::extendConnectToModel(Model& aModel)
         errorMessage += get_dependent_coordinate_name();
         throw (Exception(errorMessage));
     }
+
+    // The group of functions is made again for the new system.
+    _functionGroup.reset();
+}
+
+bool CoordinateCouplerConstraint::followsOneCoordinate() const
+{
+    return getProperty_independent_coordinate_names().size() == 1 &&
+           !getProperty_coupled_coordinates_function().empty() &&
+           get_coupled_coordinates_function().getArgumentSize() == 1;
+}
+
+std::shared_ptr<const FunctionGroup>
+CoordinateCouplerConstraint::findFunctionGroup(int& index) const
+{
+    // The couplers of the model that follow the same coordinate, in order.
+    std::vector<const CoordinateCouplerConstraint*> couplers;
+    const ConstraintSet& constraints = getModel().getConstraintSet();
+    for (int i = 0; i < constraints.getSize(); ++i) {
+        const auto* coupler =
+            dynamic_cast<const CoordinateCouplerConstraint*>(&constraints[i]);
+        if (coupler && coupler->followsOneCoordinate() &&
+            coupler->get_independent_coordinate_names(0) ==
+                get_independent_coordinate_names(0))
+            couplers.push_back(coupler);
+    }
+    const auto it = std::find(couplers.begin(), couplers.end(), this);
+
+    // A coupler that is not in the ConstraintSet is evaluated alone.
+    if (it == couplers.end()) {
+        auto group = std::make_shared<FunctionGroup>();
+        index = group->addFunction(get_coupled_coordinates_function());
+        return group;
+    }
+
+    std::shared_ptr<FunctionGroup>& group = couplers[0]->_functionGroup;
+    if (!group) {
+        group = std::make_shared<FunctionGroup>();
+        for (const auto* coupler : couplers)
+            group->addFunction(coupler->get_coupled_coordinates_function());
+    }
+    index = int(it - couplers.begin());
+    return group;
 }
 
 
@@ -224,7 +314,14 @@ void CoordinateCouplerConstraint::extendAddToSystem(SimTK::MultibodySystem& syst
 
     // Create and set the underlying coupler constraint function;
     const Function& f = get_coupled_coordinates_function();
-    SimTK::Function *simtkCouplerFunction = new CompoundFunction(f.createSimTKFunction(), get_scale_factor());
+    SimTK::Function *simtkCouplerFunction = nullptr;
+    if (followsOneCoordinate()) {
+        int index = 0;
+        std::shared_ptr<const FunctionGroup> group = findFunctionGroup(index);
+        simtkCouplerFunction = new GroupedCompoundFunction(group, index, get_scale_factor());
+    }
+    else
+        simtkCouplerFunction = new CompoundFunction(f.createSimTKFunction(), get_scale_factor());
 
 
     // Now create a Simbody Constraint::CoordinateCoupler
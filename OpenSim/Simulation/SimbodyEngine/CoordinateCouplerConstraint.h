@@ -27,8 +27,11 @@
 #include <OpenSim/Common/Function.h>
 #include "Constraint.h"
 
+#include <memory>
+
 namespace OpenSim {
 
+class FunctionGroup;
 class Model;
 
 //=============================================================================
@@ -45,6 +48,13 @@ class Model;
  * coordinate(s). In reality all coordinates are coupled and at assembly all
  * can be varied to satisfy the constraint function.
  *
+ * The couplers of a model (in its ConstraintSet) whose functions are of the
+ * same single independent coordinate, e.g., the couplers of the patella and
+ * tibia translations of a knee to the knee angle, are evaluated together:
+ * the values and first and second derivatives of all their functions are
+ * computed at once (see FunctionGroup), when Simbody first asks one of them
+ * for any of these at a value of the independent coordinate.
+ *
  * @author Ajay Seth
  * @version 1.0
  */
@@ -126,6 +136,16 @@ protected:
 private:
     void setNull();
     void constructProperties();
+    // Whether the function is of a single independent coordinate, so that it
+    // can be evaluated with those of other couplers of the same coordinate.
+    bool followsOneCoordinate() const;
+    // The group of the functions of the couplers of the model that follow the
+    // same independent coordinate as this one, and the index of the function
+    // of this coupler in it. The first of these couplers keeps the group.
+    std::shared_ptr<const FunctionGroup> findFunctionGroup(int& index) const;
+
+    mutable SimTK::ResetOnCopy<std::shared_ptr<FunctionGroup>> _functionGroup;
+
     friend class SimbodyEngine;
 
 //=============================================================================
@@ -39,6 +39,84 @@ using namespace std;
 using namespace SimTK;
 using namespace OpenSim;
 
+namespace {
+    // The Simbody mobilizers that a CustomJoint may be equivalent to.
+    enum class EquivalentMobilizer { FunctionBased, Pin, Slider, Translation };
+
+    // Whether f(q) = q, the function of a TransformAxis that is a degree of
+    // freedom.
+    bool isIdentity(const OpenSim::Function& f)
+    {
+        const LinearFunction* lf = dynamic_cast<const LinearFunction*>(&f);
+        return lf && lf->getCoefficients().getSize() == 2 &&
+               lf->getSlope() == 1.0 && lf->getIntercept() == 0.0;
+    }
+
+    // Whether f(q) = 0, the function of a TransformAxis that is not used.
+    bool isZero(const OpenSim::Function& f)
+    {
+        const Constant* c = dynamic_cast<const Constant*>(&f);
+        return c && c->getValue() == 0.0;
+    }
+
+    // Find the Simbody mobilizer with kinematics identical to those of the
+    // SpatialTransform, in which the coordinates are the mobilizer's q's in
+    // the same order:
+    //  - Pin: one rotation about any axis; the mobilizer's Z axis.
+    //  - Slider: one translation along any unit axis; the mobilizer's X axis.
+    //  - Translation: three translations along orthonormal, right-handed axes,
+    //    which are the mobilizer's X, Y and Z axes.
+    // Every other TransformAxis must be unused. R_FJ is then the orientation
+    // of the axes of that mobilizer in the joint frames. The other patterns
+    // (including rotations about several axes, whose generalized speeds would
+    // differ in Simbody's mobilizers) need a FunctionBased mobilizer.
+    EquivalentMobilizer findEquivalentMobilizer(
+            const SpatialTransform& transform, int numCoords,
+            SimTK::Rotation& R_FJ)
+    {
+        const double tol = 1e-12;
+        std::vector<int> dofs;
+        for (int i = 0; i < SpatialTransform::NumTransformAxes; ++i) {
+            const TransformAxis& axis = transform[i];
+            if (!axis.hasFunction())
+                return EquivalentMobilizer::FunctionBased;
+            if (axis.getCoordinateNames().size() == 0 &&
+                    isZero(axis.getFunction()))
+                continue;
+            if (axis.getCoordinateNames().size() != 1 ||
+                    !isIdentity(axis.getFunction()))
+                return EquivalentMobilizer::FunctionBased;
+            dofs.push_back(i);
+        }
+        if ((int)dofs.size() != numCoords)
+            return EquivalentMobilizer::FunctionBased;
+        const std::vector<std::vector<int>> coordinateIndices =
+            transform.getCoordinateIndices();
+        for (int i = 0; i < numCoords; ++i)
+            if (coordinateIndices[dofs[i]][0] != i)
+                return EquivalentMobilizer::FunctionBased;
+
+        const std::vector<Vec3> axes = transform.getAxes();
+        if (numCoords == 1 && dofs[0] < 3) {
+            R_FJ = SimTK::Rotation(UnitVec3(axes[dofs[0]]), ZAxis);
+            return EquivalentMobilizer::Pin;
+        }
+        if (numCoords == 1 && std::abs(axes[dofs[0]].norm() - 1) < tol) {
+            R_FJ = SimTK::Rotation(UnitVec3(axes[dofs[0]]), XAxis);
+            return EquivalentMobilizer::Slider;
+        }
+        if (numCoords == 3 && dofs[0] == 3) {
+            Mat33 R;
+            for (int j = 0; j < 3; ++j) R.col(j) = axes[3 + j];
+            if ((~R*R - Mat33(1)).scalarNormSqr() < tol*tol && det(R) > 0) {
+                R_FJ = SimTK::Rotation(R, true);
+                return EquivalentMobilizer::Translation;
+            }
+        }
+        return EquivalentMobilizer::FunctionBased;
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -253,11 +331,6 @@ void CustomJoint::extendAddToSystem(SimTK::MultibodySystem& system) const
 
     // Some initializations
     const int numCoords = numCoordinates();  // Note- should check that all coordinates are used.
-    std::vector<std::vector<int> > coordinateIndices =
-        getSpatialTransform().getCoordinateIndices();
-    std::vector<const SimTK::Function*> functions =
-        getSpatialTransform().getFunctions();
-    std::vector<Vec3> axes = getSpatialTransform().getAxes();
 
     SimTK_ASSERT1(numCoords == coordNames.getSize(),
         "%s list of coordinates does not match number of mobilities.",
@@ -270,6 +343,39 @@ void CustomJoint::extendAddToSystem(SimTK::MultibodySystem& system) const
     SimTK_ASSERT1(numCoords <= 6,
         "%s cannot exceed 6 mobilities (dofs).",
         getConcreteClassName().c_str());
+
+    SimTK::MobilizedBody::Direction dir =
+        SimTK::MobilizedBody::Direction(get_reverse());
+
+    // A joint that is a pin, a slider or a translation uses that mobilizer,
+    // which computes its kinematics in closed form, instead of evaluating the
+    // functions of a FunctionBased mobilizer. The mobilizer frames are those
+    // of the joint rotated so that their axes are those of the mobilizer.
+    SimTK::Rotation R_FJ;
+    const EquivalentMobilizer equivalent =
+        findEquivalentMobilizer(getSpatialTransform(), numCoords, R_FJ);
+    if (equivalent != EquivalentMobilizer::FunctionBased) {
+        const SimTK::Transform inbJ = inbX*SimTK::Transform(R_FJ);
+        const SimTK::Transform outbJ = outbX*SimTK::Transform(R_FJ);
+        SimTK::MobilizedBody simtkBody;
+        if (equivalent == EquivalentMobilizer::Pin)
+            simtkBody = SimTK::MobilizedBody::Pin(inb, inbJ, outb, outbJ, dir);
+        else if (equivalent == EquivalentMobilizer::Slider)
+            simtkBody = SimTK::MobilizedBody::Slider(inb, inbJ, outb, outbJ,
+                                                     dir);
+        else
+            simtkBody = SimTK::MobilizedBody::Translation(inb, inbJ,
+                                                          outb, outbJ, dir);
+        assignSystemIndicesToBodyAndCoordinates(simtkBody, mobilized,
+                                                numCoords, 0);
+        return;
+    }
+
+    std::vector<std::vector<int> > coordinateIndices =
+        getSpatialTransform().getCoordinateIndices();
+    std::vector<const SimTK::Function*> functions =
+        getSpatialTransform().getFunctions();
+    std::vector<Vec3> axes = getSpatialTransform().getAxes();
     assert(functions.size() == 6);
 
     SimTK_ASSERT2(numCoords <= 6,
@@ -282,9 +388,6 @@ void CustomJoint::extendAddToSystem(SimTK::MultibodySystem& system) const
         "%s::%s must specify 6 independent axes to span spatial motion.",
         getConcreteClassName().c_str(), getSpatialTransform().getConcreteClassName().c_str());
 
-    SimTK::MobilizedBody::Direction dir =
-        SimTK::MobilizedBody::Direction(get_reverse());
-
     SimTK::MobilizedBody::FunctionBased
         simtkBody(inb, inbX, 
                   outb, outbX, 
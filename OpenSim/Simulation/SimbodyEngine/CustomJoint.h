@@ -47,6 +47,12 @@ first followed by translations. Subsequently, coupled motion (i.e., describing
 motion of two degrees of freedom as a function of one coordinate) is handled by
 transform axis functions that depend on the same coordinate(s).
 
+A custom joint whose only degrees of freedom are one rotation, one
+translation, or three translations along orthonormal axes, each an identity
+LinearFunction of its own coordinate and listed in the order of the
+coordinates, is implemented by the equivalent SimTK::MobilizedBody::Pin,
+Slider or Translation instead, whose kinematics are cheaper to compute.
+
 @author Ajay Seth, Frank C. Anderson
 */
 class OSIMSIMULATION_API CustomJoint : public Joint {
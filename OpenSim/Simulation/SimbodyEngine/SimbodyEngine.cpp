@@ -798,6 +798,17 @@ void SimbodyEngine::convertQuaternionsToDirectionCosines(double aQ1, double aQ2,
 //--- Private Utility Methods Below Here ---
 
 
+namespace {
+    // The total mass of the bodies of a model, from their properties.
+    double getTotalBodyMass(const Model& model)
+    {
+        double mass = 0;
+        for (int i = 0; i < model.getBodySet().getSize(); i++)
+            mass += model.getBodySet().get(i).getMass();
+        return mass;
+    }
+}
+
 //_____________________________________________________________________________
 /**
  * Scale the dynamics engine
@@ -814,31 +825,24 @@ bool SimbodyEngine::scale(SimTK::State& s, const ScaleSet& aScaleSet, double aFi
     // geometry. If preserve mass distribution is true then the masses are not scaled.
     _model->updBodySet().scale(aScaleSet, !aPreserveMassDist);
 
-    // When bodies are scaled, the properties of the model are changed.
-    // The general rule is that you MUST recreate and initialize the system 
-    // when properties of the model change. We must do that here or
-    // we will be querying a stale system (e.g. wrong body properties!).
-    s = _model->initSystem();
-
     // Now that the masses of the individual bodies have
     // been scaled (if aPreserveMassDist == false), get the
     // total mass and compare it to aFinalMass in order to
     // determine how much to scale the body masses again,
     // so that the total model mass comes out to aFinalMass.
+    // The total mass is the sum of the mass properties of the bodies, so it
+    // does not require a System that reflects the scaled bodies.
     if (aFinalMass > 0.0)
     {
-        double mass = _model->getTotalMass(s);
+        double mass = getTotalBodyMass(*_model);
         if (mass > 0.0)
         {
             double factor = aFinalMass / mass;
             for (int i = 0; i < _model->getBodySet().getSize(); i++){
                 _model->getBodySet().get(i).scaleMass(factor);
             }
-            
-            // recreate system and update state after updating masses
-            s = _model->initSystem();
 
-            double newMass = _model->getTotalMass(s);
+            double newMass = getTotalBodyMass(*_model);
             double normDiffMass = abs(aFinalMass - newMass) / aFinalMass;
 
             // check if the difference in after scale mass and the specified 
@@ -848,7 +852,14 @@ bool SimbodyEngine::scale(SimTK::State& s, const ScaleSet& aScaleSet, double aFi
             }
         }
     }
-    
+
+    // When bodies are scaled, the properties of the model are changed.
+    // The general rule is that you MUST recreate and initialize the system 
+    // when properties of the model change. We must do that here or
+    // we will be querying a stale system (e.g. wrong body properties!).
+    // This is done once, after the masses have been adjusted.
+    s = _model->initSystem();
+
     // Now scale the joints.
     _model->updJointSet().scale(aScaleSet);
 
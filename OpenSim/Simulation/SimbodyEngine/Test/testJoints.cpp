@@ -250,6 +250,7 @@ void testGimbalJointAccessors();
 void testUniversalJointAccessors();
 void testMotionTypesForCustomJointCoordinates();
 void testNonzeroInterceptCustomJointVsPin();
+void testCustomJointEquivalentMobilizers();
 
 // Multibody tree constructions tests
 void testAddedFreeJointForBodyWithoutJoint();
@@ -378,6 +379,14 @@ int main()
         failures.push_back("testNonzeroInterceptCustomJointVsPin");
     }
 
+    // CustomJoints that are pins, sliders or translations use those
+    // mobilizers, with the same kinematics as a FunctionBased mobilizer.
+    try { ++itc; testCustomJointEquivalentMobilizers(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testCustomJointEquivalentMobilizers");
+    }
+
     // Test accessors.
     try { ++itc; testCustomJointAccessors(); }
     catch (const std::exception& e) {
@@ -2701,3 +2710,110 @@ void testNonzeroInterceptCustomJointVsPin()
         "of the coordinate value.");
 
 }
+
+void testCustomJointEquivalentMobilizers()
+{
+    using namespace SimTK;
+
+    cout << endl;
+    cout << "===========================================================" << endl;
+    cout << " CustomJoint Pin, Slider and Translation vs. FunctionBased " << endl;
+    cout << "===========================================================" << endl;
+
+    const Vec3 pinAxis = UnitVec3(0.3, -0.2, 0.9).asVec3();
+    const Vec3 sliderAxis = UnitVec3(-0.1, 0.8, 0.4).asVec3();
+    const SimTK::Rotation translationAxes(BodyRotationSequence,
+        0.3, XAxis, -0.5, YAxis, 0.2, ZAxis);
+
+    // A chain of a pin, a slider and a translation. With identity SimmSplines
+    // instead of identity LinearFunctions, the joints have the same kinematics
+    // but need FunctionBased mobilizers.
+    auto createModel = [&](bool useSplines) {
+        double x[] = {0.0, 1.0};
+        auto identity = [&]() -> OpenSim::Function* {
+            if (useSplines) return new SimmSpline(2, x, x);
+            return new LinearFunction();
+        };
+        Model* model = new Model();
+        const PhysicalFrame* parent = &model->getGround();
+        for (int j = 0; j < 3; ++j) {
+            auto body = new OpenSim::Body("body" + std::to_string(j),
+                femurMass.getMass(), femurMass.getMassCenter(),
+                femurMass.getInertia());
+            model->addBody(body);
+
+            SpatialTransform transform;
+            const int numCoords = (j == 2) ? 3 : 1;
+            for (int i = 0; i < numCoords; ++i) {
+                const int axis = (j == 0) ? 2 : 3 + i;
+                transform[axis].setCoordinateNames(OpenSim::Array<std::string>(
+                    "q" + std::to_string(j) + std::to_string(i), 1, 1));
+                transform[axis].setFunction(identity());
+                if (j == 0) transform[axis].setAxis(pinAxis);
+                if (j == 1) transform[axis].setAxis(sliderAxis);
+                if (j == 2)
+                    transform[axis].setAxis(translationAxes.col(i).asVec3());
+            }
+            model->addJoint(new CustomJoint("joint" + std::to_string(j),
+                *parent, Vec3(0.1, -0.2, 0.05), Vec3(0.2, 0.1, -0.3),
+                *body, Vec3(-0.05, 0.3, 0.1), Vec3(-0.1, 0.4, 0.2),
+                transform));
+            parent = body;
+        }
+        return model;
+    };
+
+    std::unique_ptr<Model> specialized{ createModel(false) };
+    std::unique_ptr<Model> functionBased{ createModel(true) };
+    State& s1 = specialized->initSystem();
+    State& s2 = functionBased->initSystem();
+
+    const SimbodyMatterSubsystem& matter = specialized->getMatterSubsystem();
+    const BodySet& bodies = specialized->getBodySet();
+    ASSERT(MobilizedBody::Pin::isInstanceOf(
+            matter.getMobilizedBody(bodies[0].getMobilizedBodyIndex())) &&
+        MobilizedBody::Slider::isInstanceOf(
+            matter.getMobilizedBody(bodies[1].getMobilizedBodyIndex())) &&
+        MobilizedBody::Translation::isInstanceOf(
+            matter.getMobilizedBody(bodies[2].getMobilizedBodyIndex())),
+        __FILE__, __LINE__,
+        "Expected the CustomJoints to use the equivalent mobilizers.");
+    ASSERT(MobilizedBody::FunctionBased::isInstanceOf(
+        functionBased->getMatterSubsystem().getMobilizedBody(
+            functionBased->getBodySet()[0].getMobilizedBodyIndex())),
+        __FILE__, __LINE__,
+        "Expected a CustomJoint with splines to be FunctionBased.");
+
+    Random::Uniform random(-1.0, 1.0);
+    for (int i = 0; i < specialized->getNumCoordinates(); ++i) {
+        const double q = random.getValue();
+        const double u = random.getValue();
+        specialized->updCoordinateSet()[i].setValue(s1, q);
+        specialized->updCoordinateSet()[i].setSpeedValue(s1, u);
+        functionBased->updCoordinateSet()[i].setValue(s2, q);
+        functionBased->updCoordinateSet()[i].setSpeedValue(s2, u);
+    }
+    specialized->realizeAcceleration(s1);
+    functionBased->realizeAcceleration(s2);
+
+    for (int j = 0; j < bodies.getSize(); ++j) {
+        const OpenSim::Body& b2 = functionBased->getBodySet()[j];
+        const SimTK::Transform X1 = bodies[j].getTransformInGround(s1);
+        const SimTK::Transform X2 = b2.getTransformInGround(s2);
+        ASSERT_EQUAL(X2.p(), X1.p(), 1e-10, __FILE__, __LINE__,
+            "Body positions differ from the FunctionBased mobilizer's.");
+        ASSERT_EQUAL(X2.R().convertRotationToBodyFixedXYZ(),
+            X1.R().convertRotationToBodyFixedXYZ(), 1e-10, __FILE__, __LINE__,
+            "Body orientations differ from the FunctionBased mobilizer's.");
+        ASSERT_EQUAL(b2.getVelocityInGround(s2)[1],
+            bodies[j].getVelocityInGround(s1)[1], 1e-10, __FILE__, __LINE__,
+            "Body velocities differ from the FunctionBased mobilizer's.");
+    }
+    for (int i = 0; i < specialized->getNumCoordinates(); ++i) {
+        ASSERT_EQUAL(
+            functionBased->getCoordinateSet()[i].getAccelerationValue(s2),
+            specialized->getCoordinateSet()[i].getAccelerationValue(s1),
+            1e-8, __FILE__, __LINE__,
+            "Accelerations differ from the FunctionBased mobilizer's.");
+    }
+}
@@ -0,0 +1,97 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  StatesFileReporter.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ * Author(s): Chris Dembia                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+
+#include "StatesFileReporter.h"
+#include <OpenSim/Common/STOFileAdapter.h>
+
+using namespace OpenSim;
+
+StatesFileReporter::StatesFileReporter() {
+    constructProperties();
+}
+
+StatesFileReporter::~StatesFileReporter() {
+    try { closeFile(); }
+    catch (const std::exception&) {}
+}
+
+void StatesFileReporter::constructProperties() {
+    constructProperty_file_name("");
+    constructProperty_rows_per_chunk(256);
+}
+
+void StatesFileReporter::extendFinalizeFromProperties() {
+    Super::extendFinalizeFromProperties();
+    OPENSIM_THROW_IF_FRMOBJ(get_rows_per_chunk() < 1, Exception,
+        "Property rows_per_chunk must be at least 1, but it is " +
+        std::to_string(get_rows_per_chunk()) + ".");
+}
+
+void StatesFileReporter::closeFile() {
+    if (!m_writer) return;
+    writeChunk();
+    std::unique_ptr<BackgroundFileWriter> writer(m_writer.release());
+    writer->close();
+}
+
+void StatesFileReporter::writeChunk() {
+    if (m_headerWritten && m_chunk.getNumRows() == 0) return;
+    std::shared_ptr<const TimeSeriesTable> chunk(
+            new TimeSeriesTable(std::move(m_chunk)));
+    const bool writeHeader = !m_headerWritten;
+    m_writer->write([chunk, writeHeader](std::ostream& stream) {
+        STOFileAdapter_<double> adapter;
+        if (writeHeader) adapter.writeHeader(stream, *chunk);
+        adapter.writeRows(stream, *chunk);
+    });
+    m_headerWritten = true;
+    m_chunk = TimeSeriesTable{};
+    m_chunk.setColumnLabels(chunk->getColumnLabels());
+}
+
+void StatesFileReporter::implementReport(const SimTK::State& state) const {
+    auto* self = const_cast<StatesFileReporter*>(this);
+    if (!m_writer) {
+        OPENSIM_THROW_IF_FRMOBJ(get_file_name().empty(), Exception,
+                                "Property file_name is empty.");
+        // The model may have changed since the last file was written.
+        const auto names = getRoot().getStateVariableNames();
+        std::vector<std::string> labels;
+        for (int i = 0; i < names.getSize(); ++i)
+            labels.push_back(names[i]);
+        self->m_chunk = TimeSeriesTable{};
+        self->m_chunk.setColumnLabels(labels);
+        self->m_chunk.addTableMetaData("inDegrees", std::string("no"));
+        self->m_writer.reset(new BackgroundFileWriter(get_file_name()));
+        self->m_headerWritten = false;
+    } else {
+        OPENSIM_THROW_IF_FRMOBJ(state.getTime() < m_lastTime, Exception,
+            "Attempting to report a time earlier than the last time "
+            "reported. Hint: If running simulation in a loop, use "
+            "closeFile() between simulations.");
+    }
+    self->m_chunk.appendRow(state.getTime(),
+            ~getRoot().getStateVariableValues(state));
+    self->m_lastTime = state.getTime();
+    if ((int)m_chunk.getNumRows() >= get_rows_per_chunk())
+        self->writeChunk();
+}
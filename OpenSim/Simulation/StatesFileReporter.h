@@ -0,0 +1,95 @@
+#ifndef OPENSIM_STATES_FILE_REPORTER_H_
+#define OPENSIM_STATES_FILE_REPORTER_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  StatesFileReporter.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ * Author(s): Chris Dembia                                                    *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+
+#include <OpenSim/Common/Reporter.h>
+#include <OpenSim/Common/BackgroundFileWriter.h>
+
+#include "osimSimulationDLL.h"
+
+namespace OpenSim {
+
+/** Writes the values of all the state variables to an STO file as the
+ * simulation runs, instead of keeping the states in memory like
+ * StatesTrajectoryReporter.
+ *
+ * The file has a column for each state variable of the model, in the order of
+ * Component::getStateVariableNames(), like the states file written by the
+ * Manager. A StatesTrajectory can be created from it with
+ * StatesTrajectory::createFromStatesStorage(). The values of discrete
+ * variables and modeling options are not written.
+ *
+ * The rows are collected in chunks of rows_per_chunk rows; each full chunk is
+ * formatted and written on a separate thread (see BackgroundFileWriter) while
+ * the simulation continues, so the memory used is bounded by a few chunks
+ * however long the simulation is. The file is created by the first report,
+ * and it is complete after closeFile() is called or the reporter is
+ * destroyed.
+ *
+ * @ingroup reporters
+ */
+class OSIMSIMULATION_API StatesFileReporter : public AbstractReporter {
+OpenSim_DECLARE_CONCRETE_OBJECT(StatesFileReporter, AbstractReporter);
+
+public:
+    OpenSim_DECLARE_PROPERTY(file_name, std::string,
+        "Name of the STO file the states are written to.");
+    OpenSim_DECLARE_PROPERTY(rows_per_chunk, int,
+        "Number of states written to the file at a time (default: 256).");
+
+    StatesFileReporter();
+    /** Write the remaining states and close the file, ignoring any errors. */
+    ~StatesFileReporter() override;
+
+    /** Write the states not yet written and close the file. This waits for
+     * the file to be written and rethrows the error, if any, that occurred
+     * while writing it. Nothing is done if the file is not open. The next
+     * report creates the file again. */
+    void closeFile();
+
+    /** Whether a file is being written (i.e., states were reported since it
+     * was last closed). */
+    bool isFileOpen() const { return (bool)m_writer; }
+
+protected:
+    /** Appends the values of the state variables to the file. */
+    void implementReport(const SimTK::State& state) const override;
+
+    void extendFinalizeFromProperties() override;
+
+private:
+    void constructProperties();
+    // Hand the collected rows over to the writer thread.
+    void writeChunk();
+
+    // Mutable because we append during reporting. This is OK to do since
+    // reporting never occurs for trial states.
+    TimeSeriesTable m_chunk;
+    SimTK::ResetOnCopy<std::unique_ptr<BackgroundFileWriter>> m_writer;
+    bool m_headerWritten = false;
+    double m_lastTime = SimTK::NaN;
+};
+
+} // namespace
+
+#endif // OPENSIM_STATES_FILE_REPORTER_H_
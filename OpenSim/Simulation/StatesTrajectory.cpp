@@ -23,35 +23,273 @@
 
 #include "StatesTrajectory.h"
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/ThreadPool.h>
 #include <OpenSim/Simulation/Model/Model.h>
 
+#include <algorithm>
+#include <memory>
+
 using namespace OpenSim;
 
+namespace {
+    // An Output of type double, or one channel of it, to be evaluated.
+    struct DoubleOutput {
+        const Output<double>* output;
+        const Output<double>::Channel* channel;
+        double getValue(const SimTK::State& state) const {
+            return channel ? channel->getValue(state) : output->getValue(state);
+        }
+    };
+
+    // Look up the Outputs of the model with the given paths, and the latest
+    // stage that they depend on.
+    std::vector<DoubleOutput> resolveOutputs(const Model& model,
+            const std::vector<std::string>& outputPaths,
+            SimTK::Stage& stage) {
+        std::vector<DoubleOutput> outputs;
+        stage = SimTK::Stage::Time;
+        for (const auto& path : outputPaths) {
+            OPENSIM_THROW_IF(path.find('|') == std::string::npos, Exception,
+                    "Expected the path of an Output (e.g., "
+                    "'/model/body|linear_velocity'), but got '" + path + "'.");
+            std::string componentPath, outputName, channelName, alias;
+            AbstractSocket::parseConnecteeName(path, componentPath,
+                                               outputName, channelName, alias);
+            const auto& output =
+                    model.getComponent(componentPath).getOutput(outputName);
+            DoubleOutput resolved;
+            resolved.output = dynamic_cast<const Output<double>*>(&output);
+            OPENSIM_THROW_IF(!resolved.output, Exception,
+                    "Output '" + path + "' produces values of type " +
+                    output.getTypeName() + " rather than double.");
+            resolved.channel = nullptr;
+            if (!channelName.empty()) {
+                resolved.channel =
+                        &dynamic_cast<const Output<double>::Channel&>(
+                                output.getChannel(channelName));
+            }
+            outputs.push_back(resolved);
+            stage = std::max(stage, output.getDependsOnStage());
+        }
+        return outputs;
+    }
+
+    // Realize the state once and write the values of the outputs to row.
+    void evaluateOutputs(const Model& model,
+            const std::vector<DoubleOutput>& outputs, SimTK::Stage stage,
+            const SimTK::State& state, double* row) {
+        model.getMultibodySystem().realize(state, stage);
+        for (size_t i = 0; i < outputs.size(); ++i)
+            row[i] = outputs[i].getValue(state);
+    }
+}
+
+StatesTrajectory::StatesTrajectory(const StatesTrajectory& other) {
+    *this = other;
+}
+
+StatesTrajectory::StatesTrajectory(StatesTrajectory&& other) {
+    *this = std::move(other);
+}
+
+StatesTrajectory& StatesTrajectory::operator=(const StatesTrajectory& other) {
+    if (&other == this) return *this;
+    std::lock_guard<std::mutex> lock(other.m_mutex);
+    m_discreteVariables = other.m_discreteVariables;
+    m_times = other.m_times;
+    m_values = other.m_values;
+    m_numValues = other.m_numValues;
+    m_firstState = other.m_firstState;
+    m_holdsStates = other.m_holdsStates;
+    m_states.clear();
+    m_states.reserve(other.m_states.size());
+    for (const auto& state : other.m_states)
+        m_states.emplace_back(state ? new SimTK::State(*state) : nullptr);
+    return *this;
+}
+
+StatesTrajectory& StatesTrajectory::operator=(StatesTrajectory&& other) {
+    if (&other == this) return *this;
+    m_discreteVariables = std::move(other.m_discreteVariables);
+    m_times = std::move(other.m_times);
+    m_values = std::move(other.m_values);
+    m_numValues = other.m_numValues;
+    m_firstState = other.m_firstState;
+    m_holdsStates = other.m_holdsStates;
+    m_states = std::move(other.m_states);
+    other.clear();
+    return *this;
+}
+
 size_t StatesTrajectory::getSize() const {
-    return m_states.size();
+    return m_times.size();
 }
 
 void StatesTrajectory::clear() {
+    m_discreteVariables.clear();
+    m_times.clear();
+    m_values.clear();
+    m_numValues = 0;
+    m_firstState = SimTK::State();
+    m_holdsStates = false;
     m_states.clear();
 }
 
 void StatesTrajectory::append(const SimTK::State& state) {
-    if (!m_states.empty()) {
+    if (!m_times.empty()) {
+        double lastTime;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            lastTime = getTimeLocked(m_times.size() - 1);
+        }
 
-        SimTK_APIARGCHECK2_ALWAYS(m_states.back().getTime() <= state.getTime(),
+        SimTK_APIARGCHECK2_ALWAYS(lastTime <= state.getTime(),
                 "StatesTrajectory", "append", 
                 "New state's time (%f) must be equal to or greater than the "
                 "time for the last state in the trajectory (%f).",
-                state.getTime(), m_states.back().getTime()
+                state.getTime(), lastTime
                 );
 
         // We assume the trajectory (before appending) is already consistent, 
-        // so we only need to check consistency with a single state in the
-        // trajectory.
-        OPENSIM_THROW_IF(!m_states.back().isConsistent(state),
+        // so we only need to check consistency with the first state.
+        OPENSIM_THROW_IF(!m_firstState.isConsistent(state),
           InconsistentState, state.getTime());
+    } else {
+        m_firstState = state;
+
+        // Find the discrete variables whose values can be stored as doubles.
+        // If there are others, a copy of each state is held instead.
+        m_discreteVariables.clear();
+        m_holdsStates = false;
+        for (SimTK::SubsystemIndex sx(0); sx < state.getNumSubsystems();
+                ++sx) {
+            for (SimTK::DiscreteVariableIndex dx(0);
+                    dx < state.getNDiscreteVars(sx); ++dx) {
+                const auto& value = state.getDiscreteVariable(sx, dx);
+                DiscreteVariable var;
+                var.subsystem = sx;
+                var.index = dx;
+                if (SimTK::Value<double>::isA(value))
+                    var.type = DiscreteVariable::Double;
+                else if (SimTK::Value<int>::isA(value))
+                    var.type = DiscreteVariable::Int;
+                else if (SimTK::Value<bool>::isA(value))
+                    var.type = DiscreteVariable::Bool;
+                else {
+                    m_holdsStates = true;
+                    continue;
+                }
+                m_discreteVariables.push_back(var);
+            }
+        }
+        if (m_holdsStates) m_discreteVariables.clear();
+        m_numValues = m_holdsStates ? 0 :
+                state.getNY() + m_discreteVariables.size();
+    }
+
+    m_times.push_back(state.getTime());
+    if (m_holdsStates) {
+        m_states.emplace_back(new SimTK::State(state));
+        return;
+    }
+    m_states.emplace_back();
+    const SimTK::Vector& y = state.getY();
+    for (int i = 0; i < y.size(); ++i) m_values.push_back(y[i]);
+    for (const auto& var : m_discreteVariables) {
+        const auto& value = state.getDiscreteVariable(var.subsystem,
+                                                      var.index);
+        switch (var.type) {
+        case DiscreteVariable::Double:
+            m_values.push_back(SimTK::Value<double>::downcast(value).get());
+            break;
+        case DiscreteVariable::Int:
+            m_values.push_back(SimTK::Value<int>::downcast(value).get());
+            break;
+        case DiscreteVariable::Bool:
+            m_values.push_back(SimTK::Value<bool>::downcast(value).get());
+            break;
+        }
+    }
+}
+
+const SimTK::State& StatesTrajectory::materialize(size_t index) const {
+    // operator[]() does not check the index; beyond the end, just give the
+    // first state rather than writing past the held states.
+    if (index >= m_states.size()) return m_firstState;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& state = m_states[index];
+    if (!state) {
+        state.reset(new SimTK::State(m_firstState));
+        copyStoredValues(index, *state);
+    }
+    return *state;
+}
+
+void StatesTrajectory::copyState(size_t index, SimTK::State& state) const {
+    const SimTK::State* held;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        held = m_states[index].get();
+    }
+    if (!held) {
+        copyStoredValues(index, state);
+        return;
+    }
+    state.updTime() = held->getTime();
+    state.updY() = held->getY();
+    // Discrete variables that invalidate the Model stage (the modeling
+    // options) are left as they are: changing them would require the System
+    // to realize the state again before its Y could be read.
+    for (SimTK::SubsystemIndex sx(0); sx < held->getNumSubsystems(); ++sx) {
+        for (SimTK::DiscreteVariableIndex dx(0);
+                dx < held->getNDiscreteVars(sx); ++dx) {
+            if (held->getDiscreteVarInvalidatesStage(sx, dx) <=
+                    SimTK::Stage::Model)
+                continue;
+            state.updDiscreteVariable(sx, dx) =
+                    held->getDiscreteVariable(sx, dx);
+        }
+    }
+}
+
+void StatesTrajectory::copyStoredValues(size_t index,
+                                        SimTK::State& state) const {
+    state.updTime() = m_times[index];
+    const double* values = &m_values[index * m_numValues];
+    SimTK::Vector& y = state.updY();
+    const int ny = y.size();
+    for (int i = 0; i < ny; ++i) y[i] = values[i];
+
+    // Only modify the discrete variables that differ, since modifying a
+    // discrete variable invalidates the stages that depend on it.
+    for (size_t i = 0; i < m_discreteVariables.size(); ++i) {
+        const auto& var = m_discreteVariables[i];
+        const double value = values[ny + i];
+        const auto& current = state.getDiscreteVariable(var.subsystem,
+                                                        var.index);
+        switch (var.type) {
+        case DiscreteVariable::Double:
+            if (SimTK::Value<double>::downcast(current).get() != value)
+                SimTK::Value<double>::updDowncast(state.updDiscreteVariable(
+                        var.subsystem, var.index)).upd() = value;
+            break;
+        case DiscreteVariable::Int:
+            if (SimTK::Value<int>::downcast(current).get() != (int)value)
+                SimTK::Value<int>::updDowncast(state.updDiscreteVariable(
+                        var.subsystem, var.index)).upd() = (int)value;
+            break;
+        case DiscreteVariable::Bool:
+            if (SimTK::Value<bool>::downcast(current).get() != (value != 0))
+                SimTK::Value<bool>::updDowncast(state.updDiscreteVariable(
+                        var.subsystem, var.index)).upd() = (value != 0);
+            break;
+        }
     }
-    m_states.push_back(state);
+}
+
+double StatesTrajectory::getTimeLocked(size_t index) const {
+    // A state that was accessed may have been modified (e.g., in Python).
+    return m_states[index] ? m_states[index]->getTime() : m_times[index];
 }
 
 bool StatesTrajectory::hasIntegrity() const {
@@ -60,30 +298,23 @@ bool StatesTrajectory::hasIntegrity() const {
 
 bool StatesTrajectory::isNondecreasingInTime() const {
     // An empty or size-1 trajectory necessarily has nondecreasing times.
-    if (getSize() <= 1) return true;
-
-    for (unsigned itime = 1; itime < getSize(); ++itime) {
-
-        if (get(itime).getTime() < get(itime - 1).getTime()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t itime = 1; itime < m_times.size(); ++itime) {
+        if (getTimeLocked(itime) < getTimeLocked(itime - 1)) {
             return false;
         }
-
     }
     return true;
 }
 
 bool StatesTrajectory::isConsistent() const {
-    // An empty or size-1 trajectory is necessarily consistent.
-    if (getSize() <= 1) return true;
-
-    const auto& state0 = operator[](0);
-
-    for (unsigned itime = 1; itime < getSize(); ++itime) {
-
-        if (!state0.isConsistent(operator[](itime))) {
+    // The stored values of the states that were not accessed have the
+    // structure of the first state; the others may have been modified.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& state : m_states) {
+        if (state && !m_firstState.isConsistent(*state)) {
             return false;
         }
-
     }
     return true;
 }
@@ -96,7 +327,7 @@ bool StatesTrajectory::isCompatibleWith(const Model& model) const {
 
     // Since we now know all the states are consistent with each other, we only
     // need to check if the first one is compatible with the model.
-    const auto& state0 = get(0);
+    const auto& state0 = m_firstState;
 
     if (model.getNumStateVariables() != state0.getNY()) {
         return false;
@@ -144,19 +375,28 @@ TimeSeriesTable StatesTrajectory::exportToTable(const Model& model,
     table.setColumnLabels(stateVars);
     size_t numDepColumns = stateVars.size();
     
+    // Resolve the names of the requested state variables once.
+    std::vector<Component::StateVariableHandle> handles;
+    for (const auto& name : requestedStateVars)
+        handles.push_back(model.getStateVariableHandle(name));
+
     // Fill up the table with the data.
+    table.reserve(getSize());
+    SimTK::Vector values;
+    // Read the states into a state of our own rather than keeping each one.
+    SimTK::State state = m_firstState;
     for (size_t itime = 0; itime < getSize(); ++itime) {
-        const auto& state = get(itime);
+        copyState(itime, state);
         TimeSeriesTable::RowVector row(static_cast<int>(numDepColumns));
 
         // Get each state variable's value.
         if (requestedStateVars.empty()) {
             // This is *much* faster than getting the values one-by-one.
-            row = model.getStateVariableValues(state).transpose();
+            model.getStateVariableValues(state, values);
+            row = values.transpose();
         } else {
             for (unsigned icol = 0; icol < numDepColumns; ++icol) {
-                row[static_cast<int>(icol)] = 
-                    model.getStateVariableValue(state, stateVars[icol]);
+                row[static_cast<int>(icol)] = handles[icol].getValue(state);
             }
         }
 
@@ -166,6 +406,82 @@ TimeSeriesTable StatesTrajectory::exportToTable(const Model& model,
     return table;
 }
 
+TimeSeriesTable StatesTrajectory::exportOutputsToTable(const Model& model,
+        const std::vector<std::string>& outputPaths, int numThreads) const {
+
+    OPENSIM_THROW_IF(!isCompatibleWith(model),
+                     StatesTrajectory::IncompatibleModel, model);
+    OPENSIM_THROW_IF(numThreads < 1, Exception,
+            "Expected at least 1 thread, but got " +
+            std::to_string(numThreads) + ".");
+
+    SimTK::Stage stage;
+    const auto outputs = resolveOutputs(model, outputPaths, stage);
+    const size_t numStates = getSize();
+    const size_t numColumns = outputs.size();
+    std::vector<double> values(numStates * numColumns);
+
+    // Each thread evaluates a contiguous range of the states. The first one
+    // uses the given model, the others a copy of it, all created before any
+    // evaluation starts.
+    const size_t numParts = std::max<size_t>(1,
+            std::min<size_t>(ThreadPool::getNumThreads(numThreads),
+                             numStates));
+    struct Part {
+        size_t first, last;
+        std::unique_ptr<Model> model;
+        SimTK::State* state;
+        std::vector<DoubleOutput> outputs;
+    };
+    std::vector<Part> parts(numParts);
+    for (size_t p = 0; p < numParts; ++p) {
+        Part& part = parts[p];
+        part.first = p * numStates / numParts;
+        part.last = (p + 1) * numStates / numParts;
+        if (p == 0) continue;
+        part.model.reset(model.clone());
+        part.state = &part.model->initSystem();
+        SimTK::Stage partStage;
+        part.outputs = resolveOutputs(*part.model, outputPaths, partStage);
+    }
+
+    ThreadPool::parallelFor((int)numParts, (int)numParts, [&](int p) {
+        Part& part = parts[p];
+        // The first part reads the states into a state of its own rather
+        // than keeping each one.
+        SimTK::State firstPartState;
+        if (p == 0) {
+            firstPartState = m_firstState;
+            part.state = &firstPartState;
+        }
+        const Model& partModel = p == 0 ? model : *part.model;
+        const auto& partOutputs = p == 0 ? outputs : part.outputs;
+        for (size_t i = part.first; i < part.last; ++i) {
+            copyState(i, *part.state);
+            evaluateOutputs(partModel, partOutputs, stage, *part.state,
+                            values.data() + i * numColumns);
+        }
+    });
+
+    TimeSeriesTable table;
+    std::vector<std::string> labels;
+    for (const auto& path : outputPaths) {
+        std::string componentPath, outputName, channelName, alias;
+        AbstractSocket::parseConnecteeName(path, componentPath, outputName,
+                                           channelName, alias);
+        labels.push_back(alias.empty() ? path : alias);
+    }
+    table.setColumnLabels(labels);
+    table.reserve(numStates);
+    TimeSeriesTable::RowVector row(static_cast<int>(numColumns));
+    for (size_t itime = 0; itime < numStates; ++itime) {
+        for (size_t icol = 0; icol < numColumns; ++icol)
+            row[static_cast<int>(icol)] = values[itime * numColumns + icol];
+        table.appendRow(m_times[itime], row);
+    }
+    return table;
+}
+
 StatesTrajectory StatesTrajectory::createFromStatesStorage(
         const Model& model,
         const Storage& sto,
@@ -248,7 +564,7 @@ StatesTrajectory StatesTrajectory::createFromStatesStorage(
     // ===================
 
     // Reserve the memory we'll need to fit all the states.
-    states.m_states.reserve(sto.getSize());
+    states.m_times.reserve(sto.getSize());
 
     // Working memory for Storage.
     SimTK::Vector dependentValues(numDependentColumns);
@@ -23,18 +23,18 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <OpenSim/Common/Exception.h>
 #include <OpenSim/Common/TimeSeriesTable.h>
 #include <SimTKcommon/internal/IteratorRange.h>
+#include <SimTKcommon/internal/State.h>
 
 #include "osimSimulationDLL.h"
 
-namespace SimTK {
-class State;
-}
-
 namespace OpenSim {
 
 class Storage;
@@ -54,6 +54,25 @@ class Model;
  * states to it, but users cannot modify the individual states that are already
  * in a trajectory.
  *
+ * ### Storage
+ * To keep long trajectories of large models small, the trajectory does not
+ * hold a copy of each SimTK::State. It stores the time, the continuous state
+ * variables (Y) and the values of the discrete variables of type double, int
+ * and bool of each state in contiguous buffers, along with a single copy of the
+ * first state appended. The first time a state is accessed (with operator[](),
+ * get(), front(), back() or an iterator), it is created from the stored values
+ * and kept until the trajectory is cleared or destroyed, so that:
+ * - the reference remains valid, and refers to a state of its own, as long as
+ *   the trajectory holds the state;
+ * - the state is realized at most through the Instance stage, so realize it
+ *   to the stage needed by the quantities you want to compute;
+ * - the trajectory grows by a full SimTK::State for each state accessed;
+ *   exportToTable() and exportOutputsToTable() do not keep the states they
+ *   read.
+ *
+ * If the states have discrete variables of other types, the trajectory holds
+ * a copy of each SimTK::State instead.
+ *
  * This class was introduced in OpenSim version 4.0, and enables scripting
  * (Python/MATLAB) and C++ users to postprocess their results with greater ease
  * and flexibility than with an Analysis.
@@ -141,6 +160,13 @@ class OSIMSIMULATION_API StatesTrajectory {
 public:
     /** Create an empty trajectory of states. */
     StatesTrajectory() {}
+    /** Copy the trajectory, including the states accessed so far. */
+    StatesTrajectory(const StatesTrajectory& other);
+    StatesTrajectory& operator=(const StatesTrajectory& other);
+#ifndef SWIG
+    StatesTrajectory(StatesTrajectory&& other);
+    StatesTrajectory& operator=(StatesTrajectory&& other);
+#endif
 
     /** The number of SimTK::State%s in the trajectory. */
     size_t getSize() const;
@@ -159,7 +185,7 @@ public:
      * This function does not check if the index is larger than the size of
      * the trajectory; see get() if you want this check. */
     const SimTK::State& operator[](size_t index) const {
-        return m_states[index];
+        return materialize(index);
     }
     /** Get a const reference to the state at a given index in the trajectory.
 
@@ -167,26 +193,55 @@ public:
      *                         trajectory.
      */
     const SimTK::State& get(size_t index) const {
-        try {
-            return m_states.at(index);
-        } catch (const std::out_of_range&) {
-            OPENSIM_THROW(IndexOutOfRange, index, 0, 
-                          static_cast<unsigned>(m_states.size() - 1));
-        }
+        OPENSIM_THROW_IF(index >= getSize(), IndexOutOfRange, index, 0,
+                         static_cast<unsigned>(getSize() - 1));
+        return materialize(index);
     }
     /** Get a const reference to the first state in the trajectory. */
     const SimTK::State& front() const { 
-        return m_states.front();
+        return materialize(0);
     }
     /** Get a const reference to the last state in the trajectory. */
     const SimTK::State& back() const { 
-        return m_states.back();
+        return materialize(getSize() - 1);
     }
     /// @}
     
     /** Iterator type that does not allow modifying the trajectory.
      * Most users do not need to understand what this is. */
-    typedef std::vector<SimTK::State>::const_iterator const_iterator;
+    class const_iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef SimTK::State value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const SimTK::State* pointer;
+        typedef const SimTK::State& reference;
+
+        const_iterator() : m_trajectory(nullptr), m_index(0) {}
+        const_iterator(const StatesTrajectory& trajectory, size_t index) :
+                m_trajectory(&trajectory), m_index(index) {}
+
+        reference operator*() const
+        {   return m_trajectory->materialize(m_index); }
+        pointer operator->() const { return &operator*(); }
+
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int)
+        {   const_iterator it = *this; ++m_index; return it; }
+        const_iterator& operator--() { --m_index; return *this; }
+        const_iterator operator--(int)
+        {   const_iterator it = *this; --m_index; return it; }
+
+        bool operator==(const const_iterator& other) const
+        {   return m_trajectory == other.m_trajectory &&
+                   m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const
+        {   return !operator==(other); }
+
+    private:
+        const StatesTrajectory* m_trajectory;
+        size_t m_index;
+    };
 
     /** A helper type to allow using range for loops over a subset of the
      * trajectory. */
@@ -197,10 +252,10 @@ public:
 
     /** Iterator pointing to first SimTK::State; does not allow modifying the
      * states. Allows using this class in a range for loop. */
-    const_iterator begin() const { return m_states.cbegin(); }
+    const_iterator begin() const { return const_iterator(*this, 0); }
     /** Iterator pointing past the end of the trajectory. Allows using this
      * class in a range for loop. */
-    const_iterator end() const { return m_states.cend(); }
+    const_iterator end() const { return const_iterator(*this, getSize()); }
     /// @}
 
     /// @name Modify the contents of the trajectory
@@ -211,8 +266,8 @@ public:
      * This function ensures that the time in the new SimTK::State is greater
      * than or equal to the time in the last SimTK::State in the trajectory.
      *
-     * The state that ends up in the trajectory is a deep copy of the one
-     * passed in.
+     * The values of the state variables of the state passed in are copied
+     * into the trajectory (see "Storage" above).
      */
     void append(const SimTK::State& state);
     /// @}
@@ -222,9 +277,7 @@ public:
 
     /** Checks isNondecreasingInTime() and isConsistent().
      * The design of this class is such that this method should always return
-     * true. This check may be more useful in Python or MATLAB, in which it's
-     * possible to edit the trajectory such that this method could return
-     * false.  */
+     * true.  */
     // TODO better name?
     bool hasIntegrity() const;
 
@@ -290,9 +343,89 @@ public:
     TimeSeriesTable exportToTable(const Model& model,
             const std::vector<std::string>& stateVars = {}) const;
 
+    /** Evaluate Outputs of the model at each state of the trajectory and
+     * export their values to a data table, with one column per Output and
+     * one row per state. This is much faster than calling getValue() on each
+     * Output for each state: the Outputs are looked up only once, and each
+     * state is realized only once, to the latest stage that the Outputs
+     * depend on.
+     *
+     * The Outputs are given by their paths, in the form used to connect
+     * Inputs (e.g., `/model/soleus_r|fiber_force`). A channel of a list
+     * Output is given as `/model/metabolics|heat_rate:soleus_r`, and an alias
+     * in parentheses at the end of a path (e.g., `|power(soleus_power)`) is
+     * used as the label of the column instead of the path. The Outputs must
+     * produce `double` values.
+     *
+     * @code
+     * auto forces = states.exportOutputsToTable(model,
+     *         {"/model/soleus_r|fiber_force", "/model/gasmed_r|fiber_force"});
+     * @endcode
+     *
+     * If `numThreads` is greater than 1, the states are divided among that
+     * many threads of the ThreadPool (at most ThreadPool::getMaxNumThreads()).
+     * Each additional thread evaluates the Outputs on its own
+     * copy of the model, which is created and initialized before evaluating
+     * any Output; this is only worthwhile for long trajectories or costly
+     * Outputs. The copies have the values of the discrete variables of type
+     * double, int and bool of each state, and their own default values for
+     * the other discrete variables.
+     *
+     * @throws IncompatibleModel Thrown if the Model fails the check
+     *      isCompatibleWith().
+     * @throws Exception Thrown if an Output does not exist or does not
+     *      produce `double` values.
+     */
+    TimeSeriesTable exportOutputsToTable(const Model& model,
+            const std::vector<std::string>& outputPaths,
+            int numThreads = 1) const;
+
 private:
 
-    std::vector<SimTK::State> m_states;
+    /** The state at the given index, created from the stored values the
+     * first time it is accessed. */
+    const SimTK::State& materialize(size_t index) const;
+
+    /** Copy the state at the given index, as held by the trajectory or as
+     * stored, into `state`, which must be consistent with the states of this
+     * trajectory; its modeling options (discrete variables that invalidate
+     * the Model stage) are kept. This does not modify the trajectory, so it
+     * may be called from several threads. */
+    void copyState(size_t index, SimTK::State& state) const;
+
+    /** Copy the stored values of the state at the given index into `state`. */
+    void copyStoredValues(size_t index, SimTK::State& state) const;
+
+    /** The time of the state at the given index; m_mutex must be locked. */
+    double getTimeLocked(size_t index) const;
+
+    /** A discrete variable whose value is stored for each state. */
+    struct DiscreteVariable {
+        enum Type { Double, Int, Bool };
+        SimTK::SubsystemIndex subsystem;
+        SimTK::DiscreteVariableIndex index;
+        Type type;
+    };
+    std::vector<DiscreteVariable> m_discreteVariables;
+
+    /** The time of each state. */
+    std::vector<double> m_times;
+    /** For each state, in turn, its Y followed by the values of
+     * m_discreteVariables. */
+    std::vector<double> m_values;
+    /** The number of values in m_values for each state. */
+    size_t m_numValues = 0;
+
+    /** A copy of the first state appended, from which the states are
+     * created. */
+    SimTK::State m_firstState;
+    /** Whether the states have discrete variables whose values are not
+     * stored, in which case m_states holds a copy of each state. */
+    bool m_holdsStates = false;
+    /** The state at each index, or null if it was not accessed yet. */
+    mutable std::vector<std::unique_ptr<SimTK::State> > m_states;
+    /** Guards the creation of the states in m_states. */
+    mutable std::mutex m_mutex;
 
 public:
 
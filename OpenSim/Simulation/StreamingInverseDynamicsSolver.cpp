@@ -0,0 +1,176 @@
+/* -------------------------------------------------------------------------- *
+ *                OpenSim:  StreamingInverseDynamicsSolver.cpp                *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StreamingInverseDynamicsSolver.h"
+#include "Model/Model.h"
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+StreamingInverseDynamicsSolver::StreamingInverseDynamicsSolver(
+        const Model& model, double sampleInterval, int windowSize,
+        int polynomialOrder, int lag) :
+    InverseDynamicsSolver(model),
+    _filter(model.getWorkingState().getNQ(), sampleInterval, windowSize,
+            polynomialOrder, lag),
+    _frame(model.getWorkingState().getNQ()),
+    _hasFrames(false) {
+    const SimTK::State& s = model.getWorkingState();
+    OPENSIM_THROW_IF(s.getNQ() != s.getNU(), Exception,
+        "StreamingInverseDynamicsSolver: the model uses quaternions, for "
+        "which nq != nu.");
+}
+
+StreamingInverseDynamicsSolver::StreamingInverseDynamicsSolver(
+        const StreamingInverseDynamicsSolver& source) :
+    Super(source), _filter(0, 1.0), _hasFrames(false) {
+    copyData(source);
+}
+
+StreamingInverseDynamicsSolver& StreamingInverseDynamicsSolver::operator=(
+        const StreamingInverseDynamicsSolver& source) {
+    if(&source != this) {
+        Super::operator=(source);
+        copyData(source);
+    }
+    return *this;
+}
+
+void StreamingInverseDynamicsSolver::copyData(
+        const StreamingInverseDynamicsSolver& source) {
+    std::lock_guard<std::mutex> lock(source._mutex);
+    _loadBodies = source._loadBodies;
+    _filter = source._filter;
+    _frame = source._frame;
+    _hasFrames = source._hasFrames;
+}
+
+int StreamingInverseDynamicsSolver::addExternalLoad(
+        const std::string& bodyName) {
+    const BodySet& bodies = getModel().getBodySet();
+    OPENSIM_THROW_IF(!bodies.contains(bodyName), Exception,
+        "StreamingInverseDynamicsSolver: the model has no body '" + bodyName +
+        "'.");
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF(_hasFrames, Exception,
+        "StreamingInverseDynamicsSolver: external loads must be added before "
+        "the first frame.");
+    _loadBodies.push_back(bodies.get(bodyName).getMobilizedBodyIndex());
+    const int nq = getModel().getWorkingState().getNQ();
+    const int numSignals = nq + 6*getNumExternalLoads();
+    _filter = StreamingSavitzkyGolayFilter(numSignals,
+        _filter.getSampleInterval(), _filter.getWindowSize(),
+        _filter.getPolynomialOrder(), _filter.getLag());
+    _frame.resize(numSignals);
+    return getNumExternalLoads() - 1;
+}
+
+void StreamingInverseDynamicsSolver::putFrame(double time,
+        const SimTK::Vector& q) {
+    OPENSIM_THROW_IF(getNumExternalLoads() > 0, Exception,
+        "StreamingInverseDynamicsSolver: expected the frame to have " +
+        to_string(getNumExternalLoads()) + " external loads.");
+    putFrame(time, q, Array_<Vec3>(), Array_<Vec3>(), Array_<Vec3>());
+}
+
+void StreamingInverseDynamicsSolver::putFrame(double time,
+        const SimTK::Vector& q, const SimTK::Array_<SimTK::Vec3>& forces,
+        const SimTK::Array_<SimTK::Vec3>& points,
+        const SimTK::Array_<SimTK::Vec3>& torques) {
+    const int nq = getModel().getWorkingState().getNQ();
+    const int nl = getNumExternalLoads();
+    OPENSIM_THROW_IF(q.size() != nq, Exception,
+        "StreamingInverseDynamicsSolver: expected " + to_string(nq) +
+        " coordinates, but got " + to_string(q.size()) + ".");
+    OPENSIM_THROW_IF((int)forces.size() != nl || (int)points.size() != nl ||
+                     (int)torques.size() != nl, Exception,
+        "StreamingInverseDynamicsSolver: expected " + to_string(nl) +
+        " forces, points and torques.");
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frame(0, nq) = q;
+    for(int i = 0; i < nl; ++i) {
+        // The moment about the ground origin is defined even if the point
+        // of application is not.
+        const Vec3 moment = torques[i] + points[i] % forces[i];
+        for(int k = 0; k < 3; ++k) {
+            _frame[nq + 6*i + k] = moment[k];
+            _frame[nq + 6*i + 3 + k] = forces[i][k];
+        }
+    }
+    _filter.putSample(time, _frame);
+    _hasFrames = true;
+}
+
+void StreamingInverseDynamicsSolver::resetFrames() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _filter.reset();
+}
+
+bool StreamingInverseDynamicsSolver::solveLatest(SimTK::State& s,
+        SimTK::Vector& generalizedForces) {
+    double time;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(!_filter.isReady()) return false;
+        time = _filter.getOutputTime();
+        _filter.calcOutput(0, _values);
+        _filter.calcOutput(1, _rates);
+        _filter.calcOutput(2, _accelerations);
+    }
+
+    const int nq = s.getNQ();
+    s.updTime() = time;
+    s.updQ() = _values(0, nq);
+    s.updU() = _rates(0, nq);
+
+    const MultibodySystem& system = getModel().getMultibodySystem();
+    const SimbodyMatterSubsystem& matter = system.getMatterSubsystem();
+    system.realize(s, Stage::Dynamics);
+    const Vector& appliedMobilityForces =
+        system.getMobilityForces(s, Stage::Dynamics);
+    Vector_<SpatialVec> appliedBodyForces =
+        system.getRigidBodyForces(s, Stage::Dynamics);
+
+    // Shift the moment of each load from the ground origin to the origin of
+    // its body, where the body forces apply.
+    for(int i = 0; i < getNumExternalLoads(); ++i) {
+        Vec3 moment, force;
+        for(int k = 0; k < 3; ++k) {
+            moment[k] = _values[nq + 6*i + k];
+            force[k] = _values[nq + 6*i + 3 + k];
+        }
+        const Vec3 origin = matter.getMobilizedBody(_loadBodies[i])
+            .getBodyOriginLocation(s);
+        appliedBodyForces[_loadBodies[i]] +=
+            SpatialVec(moment - origin % force, force);
+    }
+
+    generalizedForces = solve(s, _accelerations(0, nq),
+        appliedMobilityForces, appliedBodyForces);
+    return true;
+}
+
+} // end of namespace OpenSim
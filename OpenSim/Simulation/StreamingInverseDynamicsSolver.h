@@ -0,0 +1,154 @@
+#ifndef OPENSIM_STREAMING_INVERSE_DYNAMICS_SOLVER_H_
+#define OPENSIM_STREAMING_INVERSE_DYNAMICS_SOLVER_H_
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  StreamingInverseDynamicsSolver.h                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "InverseDynamicsSolver.h"
+#include <OpenSim/Common/StreamingSavitzkyGolayFilter.h>
+#include "simbody/internal/common.h"
+
+#include <mutex>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * An InverseDynamicsSolver for online use, that computes the generalized
+ * forces a fixed latency after the frames of coordinates (e.g., solved by an
+ * InverseKinematicsSolver tracking a StreamingMarkersReference) and of
+ * external loads (e.g., from a live force plate) are pushed, rather than from
+ * complete files as the InverseDynamicsTool does.
+ *
+ * The coordinates and loads of the frames, which must be one sample interval
+ * apart, are smoothed and the coordinates differentiated twice by a
+ * StreamingSavitzkyGolayFilter, which fits a polynomial to the last
+ * windowSize frames and evaluates it lag frames before the newest. The
+ * generalized forces are thus those at the time of the newest frame minus
+ * getLatency(), and there are none until windowSize frames were pushed. The
+ * coordinates and loads are filtered alike, so that they stay in step.
+ *
+ * The forces of the model are applied as by InverseDynamicsSolver::solve()
+ * (disable, e.g., its muscles, and do not model the streamed loads as well).
+ * Each external load is a force and a torque, in ground, applied at a point
+ * in ground (e.g., the center of pressure) to a body of the model; the force
+ * and its moment about the ground origin are filtered, so that the point of
+ * application may move, or be undefined when there is no force.
+ *
+ * Frames may be pushed from another thread than the one that solves:
+ *
+ * @code
+ * StreamingInverseDynamicsSolver idSolver(model, 0.01);
+ * const int rightPlate = idSolver.addExternalLoad("calcn_r");
+ * // ... for each frame, once solved by IK:
+ * idSolver.putFrame(ikState.getTime(), ikState.getQ(),
+ *                   forces, points, torques);
+ * if (idSolver.solveLatest(state, generalizedForces))
+ *     // the generalized forces at state.getTime()
+ * @endcode
+ *
+ * The model must not use quaternions.
+ */
+class OSIMSIMULATION_API StreamingInverseDynamicsSolver
+        : public InverseDynamicsSolver {
+OpenSim_DECLARE_CONCRETE_OBJECT(StreamingInverseDynamicsSolver,
+        InverseDynamicsSolver);
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+    /** Construct a solver for the given model, which must have been
+    initialized (initSystem()), with frames every sampleInterval seconds,
+    filtered as by a StreamingSavitzkyGolayFilter with the given window size,
+    polynomial order and lag (in frames).
+    @throws Exception if the model uses quaternions, or the filter settings
+    are invalid. */
+    StreamingInverseDynamicsSolver(const Model& model, double sampleInterval,
+            int windowSize = 9, int polynomialOrder = 3, int lag = 2);
+
+    StreamingInverseDynamicsSolver(
+            const StreamingInverseDynamicsSolver& source);
+    StreamingInverseDynamicsSolver& operator=(
+            const StreamingInverseDynamicsSolver& source);
+
+    /** Add an external load applied to the body with the given name, and
+    return its index among the loads of the frames. Loads must be added before
+    the first frame is pushed.
+    @throws Exception if the model has no such body. */
+    int addExternalLoad(const std::string& bodyName);
+    /** The number of external loads. */
+    int getNumExternalLoads() const { return (int)_loadBodies.size(); }
+
+    /** The delay (in seconds) of the generalized forces behind the newest
+    frame. */
+    double getLatency() const { return _filter.getLatency(); }
+
+    //--------------------------------------------------------------------------
+    // Streaming
+    //--------------------------------------------------------------------------
+    /** Push the coordinates at the given time, without external loads. */
+    void putFrame(double time, const SimTK::Vector& q);
+    /** Push the coordinates and the external loads at the given time: for
+    each load, in the order they were added, the force, the point at which it
+    is applied and the torque, all in ground. */
+    void putFrame(double time, const SimTK::Vector& q,
+            const SimTK::Array_<SimTK::Vec3>& forces,
+            const SimTK::Array_<SimTK::Vec3>& points,
+            const SimTK::Array_<SimTK::Vec3>& torques);
+    /** Forget the frames pushed so far, e.g., to start a new trial. */
+    void resetFrames();
+
+    /** Solve for the generalized forces at the time of the newest frame minus
+    the latency. The time, coordinates and speeds of the given state are set
+    to the filtered ones at that time.
+    @returns false, leaving the state and forces unchanged, if not enough
+    frames were pushed yet. */
+    bool solveLatest(SimTK::State& s, SimTK::Vector& generalizedForces);
+
+private:
+    void copyData(const StreamingInverseDynamicsSolver& source);
+
+    // The mobilized bodies to which the external loads are applied.
+    SimTK::Array_<SimTK::MobilizedBodyIndex> _loadBodies;
+
+    // Filters the coordinates followed, for each load, by its moment about
+    // the ground origin and its force.
+    StreamingSavitzkyGolayFilter _filter;
+    SimTK::Vector _frame;
+    bool _hasFrames;
+
+    // The filtered values and derivatives of the latest solution.
+    SimTK::Vector _values;
+    SimTK::Vector _rates;
+    SimTK::Vector _accelerations;
+
+    mutable std::mutex _mutex;
+//=============================================================================
+};  // END of class StreamingInverseDynamicsSolver
+//=============================================================================
+} // namespace
+
+#endif // OPENSIM_STREAMING_INVERSE_DYNAMICS_SOLVER_H_
@@ -0,0 +1,145 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  StreamingMarkersReference.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StreamingMarkersReference.h"
+#include <SimTKcommon/internal/State.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+StreamingMarkersReference::StreamingMarkersReference() :
+    MarkersReference() {}
+
+StreamingMarkersReference::StreamingMarkersReference(
+        const SimTK::Array_<std::string>& markerNames,
+        const Set<MarkerWeight>* markerWeightSet,
+        int bufferSize) :
+    StreamingMarkersReference() {
+    OPENSIM_THROW_IF(bufferSize < 1, Exception,
+        "Expected a buffer of at least one frame, but got "
+        + std::to_string(bufferSize) + ".");
+    if(markerWeightSet != nullptr)
+        upd_marker_weights() = *markerWeightSet;
+    setMarkerNames(markerNames);
+    _times.resize(bufferSize);
+    _frames.resize(bufferSize);
+}
+
+StreamingMarkersReference::StreamingMarkersReference(
+        const StreamingMarkersReference& source) :
+    Super(source) {
+    copyData(source);
+}
+
+StreamingMarkersReference& StreamingMarkersReference::operator=(
+        const StreamingMarkersReference& source) {
+    if(&source != this) {
+        Super::operator=(source);
+        copyData(source);
+    }
+    return *this;
+}
+
+void StreamingMarkersReference::copyData(
+        const StreamingMarkersReference& source) {
+    std::lock_guard<std::mutex> lock(source._mutex);
+    _times = source._times;
+    _frames = source._frames;
+    _newest = source._newest;
+    _numFrames = source._numFrames;
+}
+
+void StreamingMarkersReference::putFrame(double time,
+        const SimTK::RowVectorBase<Vec3>& locations) {
+    OPENSIM_THROW_IF_FRMOBJ(locations.size() != getNumRefs(), Exception,
+        "Expected " + std::to_string(getNumRefs()) + " marker locations, "
+        "but got " + std::to_string(locations.size()) + ".");
+    OPENSIM_THROW_IF_FRMOBJ(_frames.empty(), Exception,
+        "The Reference has no buffer for frames.");
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames > 0 && time <= _times[_newest],
+        Exception, "Frame at time " + std::to_string(time) + " is not after "
+        "the latest frame, at time " + std::to_string(_times[_newest]) + ".");
+
+    const int size = (int)_frames.size();
+    _newest = (_newest + 1) % size;
+    _times[_newest] = time;
+    // Assign element-wise so that the buffered row keeps its memory.
+    _frames[_newest].resize(locations.size());
+    for(int i = 0; i < locations.size(); ++i)
+        _frames[_newest][i] = locations[i];
+    _numFrames = std::min(_numFrames + 1, size);
+}
+
+double StreamingMarkersReference::getLatestTime() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames == 0, Exception,
+        "No frame has been pushed.");
+    return _times[_newest];
+}
+
+int StreamingMarkersReference::getNumBufferedFrames() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _numFrames;
+}
+
+SimTK::Vec2 StreamingMarkersReference::getValidTimeRange() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames == 0, Exception,
+        "No frame has been pushed.");
+    const int size = (int)_frames.size();
+    const int oldest = (_newest - _numFrames + 1 + size) % size;
+    return {_times[oldest], _times[_newest]};
+}
+
+SimTK::RowVectorView_<Vec3>
+StreamingMarkersReference::getValuesView(const SimTK::State& s) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames == 0, Exception,
+        "No frame has been pushed.");
+    const RowVector_<Vec3>& frame = _frames[findNearestFrame(s.getTime())];
+    _current.resize(frame.size());
+    for(int i = 0; i < frame.size(); ++i)
+        _current[i] = frame[i];
+    return _current(0, _current.size());
+}
+
+int StreamingMarkersReference::findNearestFrame(double time) const {
+    // Frames are few and the latest is the most likely; search backwards.
+    const int size = (int)_frames.size();
+    int nearest = _newest;
+    for(int k = 1; k < _numFrames; ++k) {
+        const int older = (_newest - k + size) % size;
+        if(std::abs(_times[older] - time) >= std::abs(_times[nearest] - time))
+            break;
+        nearest = older;
+    }
+    return nearest;
+}
+
+} // end of namespace OpenSim
@@ -0,0 +1,128 @@
+#ifndef OPENSIM_STREAMING_MARKERS_REFERENCE_H_
+#define OPENSIM_STREAMING_MARKERS_REFERENCE_H_
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  StreamingMarkersReference.h                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MarkersReference.h"
+
+#include <mutex>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * A MarkersReference whose marker locations are not loaded from a file but
+ * pushed, one frame at a time, as they are captured (e.g., from a live motion
+ * capture system). The most recent frames are kept in a buffer of fixed size;
+ * the values for a State are those of the buffered frame nearest its time.
+ *
+ * Frames may be pushed from another thread than the one that solves, e.g.,
+ * with an InverseKinematicsSolver:
+ *
+ * @code
+ * StreamingMarkersReference markersRef(markerNames);
+ * InverseKinematicsSolver ikSolver(model, markersRef, coordinateReferences);
+ * ikSolver.setTrackDeadline(0.005);
+ * // ... once the first frame is in:
+ * state.updTime() = markersRef.getLatestTime();
+ * ikSolver.assemble(state);
+ * while (streaming) {
+ *     state.updTime() = markersRef.getLatestTime();
+ *     ikSolver.track(state);
+ * }
+ * @endcode
+ *
+ * Marker locations must be expressed in the ground frame and in the units of
+ * the model. Missing markers are given as NaN.
+ */
+class OSIMSIMULATION_API StreamingMarkersReference : public MarkersReference {
+OpenSim_DECLARE_CONCRETE_OBJECT(StreamingMarkersReference, MarkersReference);
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+    StreamingMarkersReference();
+
+    /** Create a Reference for the markers with the given names, in the order
+        of the frames that will be pushed, keeping up to bufferSize frames.
+        The marker weights are associated to markers by name. */
+    explicit StreamingMarkersReference(
+            const SimTK::Array_<std::string>& markerNames,
+            const Set<MarkerWeight>* markerWeightSet = nullptr,
+            int bufferSize = 8);
+
+    StreamingMarkersReference(const StreamingMarkersReference& source);
+    StreamingMarkersReference& operator=(
+            const StreamingMarkersReference& source);
+    virtual ~StreamingMarkersReference() {}
+
+    //--------------------------------------------------------------------------
+    // Streaming
+    //--------------------------------------------------------------------------
+    /** Push the marker locations captured at the given time, in the order of
+        the names of the markers. The oldest frame is dropped if the buffer is
+        full. Times must increase from one frame to the next. */
+    void putFrame(double time,
+                  const SimTK::RowVectorBase<SimTK::Vec3>& locations);
+    /** The time of the most recent frame. Throws if no frame was pushed. */
+    double getLatestTime() const;
+    /** The number of frames currently in the buffer. */
+    int getNumBufferedFrames() const;
+
+    //--------------------------------------------------------------------------
+    // Reference Interface
+    //--------------------------------------------------------------------------
+    /** The time range of the frames in the buffer. */
+    SimTK::Vec2 getValidTimeRange() const override;
+    /** A view of the locations of the buffered frame nearest the time of the
+        State. It is a copy taken from the buffer, so it is not affected by
+        frames pushed afterwards, and is valid until the next call. */
+    SimTK::RowVectorView_<SimTK::Vec3>
+        getValuesView(const SimTK::State &s) const override;
+
+private:
+    // Index in the buffer of the frame nearest the given time. The mutex must
+    // be held.
+    int findNearestFrame(double time) const;
+    void copyData(const StreamingMarkersReference& source);
+
+    // Ring buffer of the most recent frames; _newest is the index of the
+    // most recent of _numFrames frames.
+    SimTK::Array_<double> _times;
+    SimTK::Array_<SimTK::RowVector_<SimTK::Vec3>> _frames;
+    int _newest{-1};
+    int _numFrames{0};
+
+    // The frame last handed out by getValuesView().
+    mutable SimTK::RowVector_<SimTK::Vec3> _current;
+
+    mutable std::mutex _mutex;
+//=============================================================================
+};  // END of class StreamingMarkersReference
+//=============================================================================
+} // namespace
+
+#endif // OPENSIM_STREAMING_MARKERS_REFERENCE_H_
@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------- *
+ *                OpenSim:  StreamingOrientationsReference.cpp                *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StreamingOrientationsReference.h"
+#include <SimTKcommon/internal/State.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace SimTK;
+
+namespace OpenSim {
+
+StreamingOrientationsReference::StreamingOrientationsReference() :
+    OrientationsReference() {}
+
+StreamingOrientationsReference::StreamingOrientationsReference(
+        const SimTK::Array_<std::string>& names,
+        const Set<OrientationWeight>* orientationWeightSet,
+        int bufferSize) :
+    StreamingOrientationsReference() {
+    OPENSIM_THROW_IF(bufferSize < 1, Exception,
+        "Expected a buffer of at least one frame, but got "
+        + std::to_string(bufferSize) + ".");
+    if(orientationWeightSet != nullptr)
+        upd_orientation_weights() = *orientationWeightSet;
+    setOrientationNames(names);
+    _times.resize(bufferSize);
+    _frames.resize(bufferSize);
+}
+
+StreamingOrientationsReference::StreamingOrientationsReference(
+        const StreamingOrientationsReference& source) :
+    Super(source) {
+    copyData(source);
+}
+
+StreamingOrientationsReference& StreamingOrientationsReference::operator=(
+        const StreamingOrientationsReference& source) {
+    if(&source != this) {
+        Super::operator=(source);
+        copyData(source);
+    }
+    return *this;
+}
+
+void StreamingOrientationsReference::copyData(
+        const StreamingOrientationsReference& source) {
+    std::lock_guard<std::mutex> lock(source._mutex);
+    _times = source._times;
+    _frames = source._frames;
+    _newest = source._newest;
+    _numFrames = source._numFrames;
+}
+
+void StreamingOrientationsReference::putFrame(double time,
+        const SimTK::RowVectorBase<Quaternion>& orientations) {
+    OPENSIM_THROW_IF_FRMOBJ(orientations.size() != getNumRefs(), Exception,
+        "Expected " + std::to_string(getNumRefs()) + " orientations, "
+        "but got " + std::to_string(orientations.size()) + ".");
+    OPENSIM_THROW_IF_FRMOBJ(_frames.empty(), Exception,
+        "The Reference has no buffer for frames.");
+
+    // Convert outside of the lock, so as not to hold up the solver.
+    const int nr = orientations.size();
+    SimTK::Array_<Rotation> rotations(nr);
+    for(int i = 0; i < nr; ++i)
+        rotations[i] = convertToRotation(orientations[i]);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames > 0 && time <= _times[_newest],
+        Exception, "Frame at time " + std::to_string(time) + " is not after "
+        "the latest frame, at time " + std::to_string(_times[_newest]) + ".");
+
+    const int size = (int)_frames.size();
+    _newest = (_newest + 1) % size;
+    _times[_newest] = time;
+    _frames[_newest].swap(rotations);
+    _numFrames = std::min(_numFrames + 1, size);
+}
+
+double StreamingOrientationsReference::getLatestTime() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames == 0, Exception,
+        "No frame has been pushed.");
+    return _times[_newest];
+}
+
+int StreamingOrientationsReference::getNumBufferedFrames() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _numFrames;
+}
+
+SimTK::Vec2 StreamingOrientationsReference::getValidTimeRange() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames == 0, Exception,
+        "No frame has been pushed.");
+    const int size = (int)_frames.size();
+    const int oldest = (_newest - _numFrames + 1 + size) % size;
+    return {_times[oldest], _times[_newest]};
+}
+
+void StreamingOrientationsReference::getValues(const SimTK::State& s,
+        SimTK::Array_<Rotation>& values) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    OPENSIM_THROW_IF_FRMOBJ(_numFrames == 0, Exception,
+        "No frame has been pushed.");
+    values = _frames[findNearestFrame(s.getTime())];
+}
+
+int StreamingOrientationsReference::findNearestFrame(double time) const {
+    // Frames are few and the latest is the most likely; search backwards.
+    const int size = (int)_frames.size();
+    int nearest = _newest;
+    for(int k = 1; k < _numFrames; ++k) {
+        const int older = (_newest - k + size) % size;
+        if(std::abs(_times[older] - time) >= std::abs(_times[nearest] - time))
+            break;
+        nearest = older;
+    }
+    return nearest;
+}
+
+} // end of namespace OpenSim
@@ -0,0 +1,128 @@
+#ifndef OPENSIM_STREAMING_ORIENTATIONS_REFERENCE_H_
+#define OPENSIM_STREAMING_ORIENTATIONS_REFERENCE_H_
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  StreamingOrientationsReference.h                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "OrientationsReference.h"
+
+#include <mutex>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * An OrientationsReference whose orientations are not loaded from a file but
+ * pushed, one frame at a time, as they are captured (e.g., from live IMUs).
+ * The most recent frames are kept in a buffer of fixed size; the values for
+ * a State are those of the buffered frame nearest its time. Like
+ * StreamingMarkersReference, frames may be pushed from another thread than
+ * the one that solves, e.g., with an InverseKinematicsSolver:
+ *
+ * @code
+ * MarkersReference noMarkers;
+ * StreamingOrientationsReference imuRef(imuFrameNames);
+ * InverseKinematicsSolver ikSolver(model, noMarkers, imuRef,
+ *                                  coordinateReferences);
+ * // ... once the first frame is in:
+ * state.updTime() = imuRef.getLatestTime();
+ * ikSolver.assemble(state);
+ * while (streaming) {
+ *     state.updTime() = imuRef.getLatestTime();
+ *     ikSolver.track(state);
+ * }
+ * @endcode
+ *
+ * Orientations are expressed in the ground frame. Missing orientations are
+ * given as NaN.
+ */
+class OSIMSIMULATION_API StreamingOrientationsReference
+        : public OrientationsReference {
+OpenSim_DECLARE_CONCRETE_OBJECT(StreamingOrientationsReference,
+                                OrientationsReference);
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+    StreamingOrientationsReference();
+
+    /** Create a Reference for the frames with the given names, in the order
+        of the orientations that will be pushed, keeping up to bufferSize
+        frames. The orientation weights are associated to frames by name. */
+    explicit StreamingOrientationsReference(
+            const SimTK::Array_<std::string>& names,
+            const Set<OrientationWeight>* orientationWeightSet = nullptr,
+            int bufferSize = 8);
+
+    StreamingOrientationsReference(
+            const StreamingOrientationsReference& source);
+    StreamingOrientationsReference& operator=(
+            const StreamingOrientationsReference& source);
+    virtual ~StreamingOrientationsReference() {}
+
+    //--------------------------------------------------------------------------
+    // Streaming
+    //--------------------------------------------------------------------------
+    /** Push the orientations captured at the given time, in the order of the
+        names. The oldest frame is dropped if the buffer is full. Times must
+        increase from one frame to the next. */
+    void putFrame(double time,
+                  const SimTK::RowVectorBase<SimTK::Quaternion>& orientations);
+    /** The time of the most recent frame. Throws if no frame was pushed. */
+    double getLatestTime() const;
+    /** The number of frames currently in the buffer. */
+    int getNumBufferedFrames() const;
+
+    //--------------------------------------------------------------------------
+    // Reference Interface
+    //--------------------------------------------------------------------------
+    /** The time range of the frames in the buffer. */
+    SimTK::Vec2 getValidTimeRange() const override;
+    /** The orientations of the buffered frame nearest the time of the
+        State. */
+    void getValues(const SimTK::State &s,
+        SimTK::Array_<SimTK::Rotation> &values) const override;
+
+private:
+    // Index in the buffer of the frame nearest the given time. The mutex must
+    // be held.
+    int findNearestFrame(double time) const;
+    void copyData(const StreamingOrientationsReference& source);
+
+    // Ring buffer of the most recent frames, converted to rotation matrices
+    // when pushed; _newest is the index of the most recent of _numFrames
+    // frames.
+    SimTK::Array_<double> _times;
+    SimTK::Array_<SimTK::Array_<SimTK::Rotation>> _frames;
+    int _newest{-1};
+    int _numFrames{0};
+
+    mutable std::mutex _mutex;
+//=============================================================================
+};  // END of class StreamingOrientationsReference
+//=============================================================================
+} // namespace
+
+#endif // OPENSIM_STREAMING_ORIENTATIONS_REFERENCE_H_
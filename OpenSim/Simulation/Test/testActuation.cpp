@@ -0,0 +1,90 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testActuation.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/osimActuators.h>
+#include <OpenSim/Analyses/Actuation.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+// Verify that the forces, speeds and powers recorded by an Actuation
+// analysis match those of each actuator, for muscles (whose power is the
+// negative of actuation times speed) and coordinate actuators.
+void testActuation();
+
+int main()
+{
+    SimTK_START_TEST("testActuation");
+        SimTK_SUBTEST(testActuation);
+    SimTK_END_TEST();
+}
+
+void testActuation()
+{
+    Model model("arm26.osim");
+    CoordinateActuator* elbow = new CoordinateActuator("r_elbow_flex");
+    elbow->setName("elbow_actuator");
+    elbow->setOptimalForce(10.0);
+    model.addForce(elbow);
+    // An actuator that does not apply force is not recorded.
+    model.updActuators().get("TRIlong").set_appliesForce(false);
+    SimTK::State& s = model.initSystem();
+
+    Actuation actuation(&model);
+    const int nFrames = 3;
+    for (int i = 0; i < nFrames; ++i) {
+        s.updTime() = 0.1*i;
+        model.getCoordinateSet().get("r_elbow_flex").setValue(s, 0.5*i, false);
+        model.getCoordinateSet().get("r_elbow_flex").setSpeedValue(s, -1.0);
+        model.setControls(s, SimTK::Vector(model.getNumControls(), 0.3));
+        model.equilibrateMuscles(s);
+        model.getMultibodySystem().realize(s, SimTK::Stage::Dynamics);
+        if (i == 0) actuation.begin(s);
+        else actuation.step(s, i);
+
+        const Array<string>& labels =
+            actuation.getForceStorage()->getColumnLabels();
+        ASSERT(labels.getSize() == model.getActuators().getSize(),
+            __FILE__, __LINE__, "Expected a column per actuator that "
+            "applies force, and time.");
+        ASSERT(labels.findIndex("TRIlong") < 0, __FILE__, __LINE__,
+            "Expected no column for an actuator that applies no force.");
+        const Storage* stores[] = {actuation.getForceStorage(),
+                                   actuation.getSpeedStorage(),
+                                   actuation.getPowerStorage()};
+        for (int j = 1; j < labels.getSize(); ++j) {
+            const auto& act = model.getActuators().get(labels[j]);
+            const auto& scalar = dynamic_cast<const ScalarActuator&>(act);
+            const double expected[] = {scalar.getActuation(s),
+                                       scalar.getSpeed(s), act.getPower(s)};
+            for (int k = 0; k < 3; ++k) {
+                const Array<double>& found = stores[k]->getStateVector(
+                    stores[k]->getSize() - 1)->getData();
+                ASSERT_EQUAL(expected[k], found[j - 1],
+                    1e-10*(1 + std::abs(expected[k])), __FILE__, __LINE__,
+                    stores[k]->getName() + ": " + labels[j] + " differs.");
+            }
+        }
+    }
+}
@@ -29,12 +29,15 @@
 #include <OpenSim/Simulation/osimSimulation.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Common/Constant.h>
 
 using namespace OpenSim;
 using namespace std;
 
 void testAssembleModelWithConstraints(string modelFile);
 void testAssemblySatisfiesConstraints(string modelFile);
+void testSetCoordinateValuesTogether(string modelFile);
+void testAssemblySolverReusesGoals(string modelFile);
 double calcLigamentLengthError(const SimTK::State &s, const Model &model);
 
 int main()
@@ -42,6 +45,8 @@ int main()
     try {
         LoadOpenSimLibrary("osimActuators");
         testAssemblySatisfiesConstraints("knee_patella_ligament.osim");
+        testSetCoordinateValuesTogether("knee_patella_ligament.osim");
+        testAssemblySolverReusesGoals("knee_patella_ligament.osim");
         testAssembleModelWithConstraints("PushUpToesOnGroundExactConstraints.osim");
         testAssembleModelWithConstraints("PushUpToesOnGroundLessPreciseConstraints.osim");
         testAssembleModelWithConstraints("PushUpToesOnGroundWithMuscles.osim");
@@ -306,6 +311,104 @@ void testAssemblySatisfiesConstraints(string modelFile)
     }
 }
 
+// Setting the values of several coordinates at once must satisfy the
+// constraints after a single assembly, and leave locked coordinates alone.
+void testSetCoordinateValuesTogether(string modelFile)
+{
+    using namespace SimTK;
+
+    cout << "****************************************************************************" << endl;
+    cout << " testSetCoordinateValuesTogether :: " << modelFile << endl;
+    cout << "****************************************************************************\n" << endl;
+
+    Model model(modelFile);
+    model.set_assembly_accuracy(1e-8);
+    State& state = model.initSystem();
+    const CoordinateSet& coords = model.getCoordinateSet();
+    const int nc = coords.getSize();
+
+    // Only the knee angle, by name.
+    const vector<string> knee(1, coords[0].getName());
+    for (int i = 0; i < 10; ++i) {
+        const double kneeAngle = Pi/18 - i*Pi/15;
+        coords.setValues(state, knee, Vector(1, kneeAngle));
+        ASSERT_EQUAL(0.0, calcLigamentLengthError(state, model),
+            model.get_assembly_accuracy(), __FILE__, __LINE__,
+            "Constraints NOT satisfied after setting the knee angle.");
+    }
+
+    // The whole pose, with the last coordinate locked.
+    const Coordinate& locked = coords[nc-1];
+    locked.setLocked(state, true);
+    const double lockedValue = locked.getValue(state);
+    Vector pose(nc);
+    for (int i = 0; i < nc; ++i)
+        pose[i] = coords[i].getValue(state) + 0.01;
+    Vector speeds(nc, 0.1);
+    coords.setValuesAndSpeeds(state, pose, speeds);
+    ASSERT_EQUAL(lockedValue, locked.getValue(state), 1e-8, __FILE__, __LINE__,
+        "Locked coordinate was moved by setValuesAndSpeeds().");
+    ASSERT_EQUAL(0.0, calcLigamentLengthError(state, model),
+        model.get_assembly_accuracy(), __FILE__, __LINE__,
+        "Constraints NOT satisfied after setting the pose.");
+    locked.setLocked(state, false);
+
+    // One value per coordinate is required.
+    ASSERT_THROW(OpenSim::Exception,
+        coords.setValues(state, Vector(nc+1, 0.0)));
+    ASSERT_THROW(OpenSim::Exception,
+        coords.setValues(state, vector<string>(1, "not_a_coordinate"),
+                         Vector(1, 0.0)));
+}
+
+// Repeated assemblies reuse the goals of the Assembler until a coordinate is
+// locked or unlocked, and satisfy the constraints either way.
+void testAssemblySolverReusesGoals(string modelFile)
+{
+    using namespace SimTK;
+
+    cout << "****************************************************************************" << endl;
+    cout << " testAssemblySolverReusesGoals :: " << modelFile << endl;
+    cout << "****************************************************************************\n" << endl;
+
+    Model model(modelFile);
+    State& state = model.initSystem();
+    const CoordinateSet& coords = model.getCoordinateSet();
+    const string kneeName = coords[0].getName();
+
+    Array_<CoordinateReference> coordRefs;
+    coordRefs.push_back(CoordinateReference(kneeName, Constant(-Pi/6)));
+    AssemblySolver solver(model, coordRefs);
+    solver.setAccuracy(1e-8);
+    ASSERT(!solver.canReuseGoals(state));
+
+    for (int i = 0; i < 5; ++i) {
+        const double kneeAngle = -Pi/6 - i*Pi/12;
+        solver.updateCoordinateReference(kneeName, kneeAngle, 10);
+        solver.assemble(state);
+        ASSERT(solver.canReuseGoals(state));
+        ASSERT_EQUAL(kneeAngle, coords[0].getValue(state), 1e-4,
+            __FILE__, __LINE__, "Knee angle goal NOT met.");
+        ASSERT_EQUAL(0.0, calcLigamentLengthError(state, model), 1e-8,
+            __FILE__, __LINE__, "Constraints NOT satisfied.");
+    }
+
+    // Locking the knee changes the goals; unlocking it restores its goal.
+    coords[0].setLocked(state, true);
+    ASSERT(!solver.canReuseGoals(state));
+    const double lockedAngle = coords[0].getValue(state);
+    solver.updateCoordinateReference(kneeName, 0.0, 10);
+    solver.assemble(state);
+    ASSERT_EQUAL(lockedAngle, coords[0].getValue(state), 1e-8,
+        __FILE__, __LINE__, "Locked knee angle was changed by assembly.");
+
+    coords[0].setLocked(state, false);
+    ASSERT(!solver.canReuseGoals(state));
+    solver.assemble(state);
+    ASSERT_EQUAL(0.0, coords[0].getValue(state), 1e-4,
+        __FILE__, __LINE__, "Knee angle goal NOT met after unlocking.");
+}
+
 double calcLigamentLengthError(const SimTK::State &s, const Model &model)
 {
     using namespace SimTK;
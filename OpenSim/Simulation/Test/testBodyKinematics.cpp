@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testBodyKinematics.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Analyses/BodyKinematics.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+// Verify that the bodies, center of mass and points recorded by a
+// BodyKinematics match those computed one body at a time.
+void testKinematics(bool inLocalFrame);
+// Verify that the values of a row starting at column match a vector.
+void compareRow(const Storage& store, int column, const SimTK::Vec3& expected);
+
+int main()
+{
+    SimTK_START_TEST("testBodyKinematics");
+        SimTK_SUBTEST1(testKinematics, false);
+        SimTK_SUBTEST1(testKinematics, true);
+    SimTK_END_TEST();
+}
+
+void testKinematics(bool inLocalFrame)
+{
+    Model model("double_pendulum.osim");
+    SimTK::State& s = model.initSystem();
+
+    BodyKinematics kin(&model);
+    kin.setInDegrees(false);
+    kin.setExpressResultsInLocalFrame(inLocalFrame);
+    const SimTK::Vec3 tip(0.1, -1.0, 0.05);
+    kin.addPoint("tip", "rod2", tip);
+    kin.addPoint("knob", "rod1", SimTK::Vec3(0, -0.5, 0.2));
+    ASSERT(kin.getNumPoints() == 2, __FILE__, __LINE__,
+        "Expected 2 points.");
+    kin.setModel(model);
+
+    const Ground& ground = model.getGround();
+    const BodySet& bodies = model.getBodySet();
+    const Coordinate& q1 = model.getCoordinateSet().get("q1");
+    const Coordinate& q2 = model.getCoordinateSet().get("q2");
+    const int nFrames = 4;
+    for (int i = 0; i < nFrames; ++i) {
+        s.updTime() = 0.1*i;
+        q1.setValue(s, 0.3*i, false);
+        q2.setValue(s, -0.2*i + 0.1, false);
+        q1.setSpeedValue(s, 1.0 - 0.5*i);
+        q2.setSpeedValue(s, 2.0);
+        model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+        if (i == 0) kin.begin(s);
+        else kin.step(s, i);
+
+        // Bodies.
+        SimTK::Vec3 rP(0), rV(0), rA(0);
+        double mass = 0;
+        for (int b = 0; b < bodies.getSize(); ++b) {
+            const Body& body = bodies[b];
+            const SimTK::Vec3& com = body.get_mass_center();
+            const SimTK::Vec3 p = body.findStationLocationInGround(s, com);
+            SimTK::Vec3 v = body.findStationVelocityInGround(s, com);
+            SimTK::Vec3 a = body.findStationAccelerationInGround(s, com);
+            rP += body.get_mass()*p;
+            rV += body.get_mass()*v;
+            rA += body.get_mass()*a;
+            mass += body.get_mass();
+
+            SimTK::Vec3 w = body.getVelocityInGround(s)[0];
+            SimTK::Vec3 wdot = body.getAccelerationInGround(s)[0];
+            if (inLocalFrame) {
+                v = ground.expressVectorInAnotherFrame(s, v, body);
+                a = ground.expressVectorInAnotherFrame(s, a, body);
+                w = ground.expressVectorInAnotherFrame(s, w, body);
+                wdot = ground.expressVectorInAnotherFrame(s, wdot, body);
+            }
+            compareRow(*kin.getPositionStorage(), 6*b, p);
+            compareRow(*kin.getPositionStorage(), 6*b + 3,
+                body.getTransformInGround(s).R()
+                    .convertRotationToBodyFixedXYZ());
+            compareRow(*kin.getVelocityStorage(), 6*b, v);
+            compareRow(*kin.getVelocityStorage(), 6*b + 3, w);
+            compareRow(*kin.getAccelerationStorage(), 6*b, a);
+            compareRow(*kin.getAccelerationStorage(), 6*b + 3, wdot);
+        }
+
+        // Center of mass, always in ground.
+        int column = 6*bodies.getSize();
+        compareRow(*kin.getPositionStorage(), column, rP/mass);
+        compareRow(*kin.getVelocityStorage(), column, rV/mass);
+        compareRow(*kin.getAccelerationStorage(), column, rA/mass);
+
+        // Points, always in ground.
+        column += 3;
+        const Body& rod2 = bodies.get("rod2");
+        compareRow(*kin.getPositionStorage(), column,
+            rod2.findStationLocationInGround(s, tip));
+        compareRow(*kin.getVelocityStorage(), column,
+            rod2.findStationVelocityInGround(s, tip));
+        compareRow(*kin.getAccelerationStorage(), column,
+            rod2.findStationAccelerationInGround(s, tip));
+    }
+
+    const Array<string>& labels = kin.getPositionStorage()->getColumnLabels();
+    ASSERT(labels[labels.getSize() - 3] == "knob_X", __FILE__, __LINE__,
+        "Expected the columns of the points last.");
+    ASSERT(kin.getPositionStorage()->getSize() == nFrames, __FILE__, __LINE__,
+        "Expected a row per frame.");
+
+    // A point on a body that is not in the model.
+    BodyKinematics bad(&model);
+    bad.addPoint("nowhere", "rod3", SimTK::Vec3(0));
+    ASSERT_THROW(OpenSim::Exception, bad.setModel(model));
+}
+
+void compareRow(const Storage& store, int column, const SimTK::Vec3& expected)
+{
+    const Array<double>& found =
+        store.getStateVector(store.getSize() - 1)->getData();
+    for (int j = 0; j < 3; ++j) {
+        ASSERT_EQUAL(expected[j], found[column + j], 1e-10, __FILE__, __LINE__,
+            store.getName() + ": column " + std::to_string(column + j) +
+            " differs.");
+    }
+}
@@ -44,11 +44,14 @@
 #include <OpenSim/Simulation/Model/ContactSphere.h>
 #include <OpenSim/Simulation/Model/ElasticFoundationForce.h>
 #include <OpenSim/Simulation/Model/HuntCrossleyForce.h>
+#include <OpenSim/Simulation/Model/MeshCache.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/PhysicalOffsetFrame.h>
+#include <OpenSim/Simulation/Model/SphereHalfSpaceContactForce.h>
 #include <OpenSim/Simulation/SimbodyEngine/FreeJoint.h>
 #include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
 #include <OpenSim/Simulation/SimbodyEngine/WeldJoint.h>
+#include <OpenSim/Common/ThreadPool.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include "SimTKsimbody.h"
 
@@ -77,6 +80,15 @@ int testBallToBallContact(bool useElasticFoundation, bool useMesh1, bool useMesh
 void compareHertzAndMeshContactResults();
 template <typename ContactType> // e.g., HuntCrossley.
 void testIntermediateFrames();
+// Verify that ContactMeshes that use the same file share its meshes.
+void testMeshCache();
+// Verify that SphereHalfSpaceContactForce matches HuntCrossleyForce, and that
+// its smooth force law approaches the original one.
+void testSphereHalfSpaceContactForce();
+
+// Verify that an ElasticFoundationForce that splits its springs across
+// threads matches the one evaluated by Simbody.
+void testElasticFoundationThreads();
 
 int main()
 {
@@ -97,6 +109,9 @@ int main()
 
         testIntermediateFrames<OpenSim::HuntCrossleyForce>();
         testIntermediateFrames<OpenSim::ElasticFoundationForce>();
+        testMeshCache();
+        testSphereHalfSpaceContactForce();
+        testElasticFoundationThreads();
     }
     catch (const OpenSim::Exception& e) {
         e.print(cerr);
@@ -597,20 +612,206 @@ void testIntermediateFrames() {
     SimTK_TEST_EQ_TOL(stateWeld.getY(), stateIntermedFrameXY.getY(), 1e-10);
 }
 
+void testMeshCache()
+{
+    const string& file = mesh_files[0];
+    const int numFiles = MeshCache::getNumFiles();
+    {
+        auto triangles = MeshCache::getTriangleMesh(file);
+        ASSERT(MeshCache::getNumFiles() == numFiles + 1);
+        ASSERT(MeshCache::getTriangleMesh(file) == triangles, __FILE__,
+            __LINE__, "Expected the same file to give the same mesh.");
+        // The triangle mesh shares the polygons, which are gone with it.
+        auto polygons = MeshCache::getPolygonalMesh(file);
+        ASSERT(polygons->getNumFaces() > 0);
+        ASSERT(MeshCache::getTriangleMesh(mesh_files[1]) != triangles);
+
+        // ContactMeshes of separately built models hold the cached mesh.
+        Model first, second;
+        for (Model* model : {&first, &second}) {
+            model->addContactGeometry(new ContactMesh(file, Vec3(0), Vec3(0),
+                model->getGround(), "mesh"));
+            model->initSystem();
+        }
+        triangles.reset();
+        polygons.reset();
+        ASSERT(MeshCache::getNumFiles() == numFiles + 1, __FILE__, __LINE__,
+            "Expected the models to keep the mesh in the cache.");
+    }
+    ASSERT(MeshCache::getNumFiles() == numFiles, __FILE__, __LINE__,
+        "Expected the mesh to be released with the models.");
+    ASSERT_THROW(OpenSim::Exception,
+        MeshCache::getPolygonalMesh("missing_mesh_file.obj"));
+}
 
+void testSphereHalfSpaceContactForce()
+{
+    const double stiffness = 1.0e6;
+    const double dissipation = 1.0;
+    const double staticFriction = 0.8;
+    const double dynamicFriction = 0.5;
+    const double viscousFriction = 0.1;
+
+    // A ball sliding on the floor in front of a second sphere, above the
+    // floor, that is fixed to the same body.
+    auto createModel = [&](OpenSim::Force* force) {
+        Model* model = new Model;
+        model->setGravity(gravity_vec);
+        auto* ball = new OpenSim::Body("ball", mass, Vec3(0), Inertia(1.0));
+        model->addBody(ball);
+        model->addJoint(new FreeJoint("free", model->getGround(), Vec3(0),
+            Vec3(0), *ball, Vec3(0), Vec3(0)));
+        model->addContactGeometry(new ContactHalfSpace(Vec3(0),
+            Vec3(0, 0, -0.5*SimTK_PI), model->getGround(), "floor"));
+        model->addContactGeometry(new ContactSphere(radius, Vec3(0), *ball,
+            "heel"));
+        model->addContactGeometry(new ContactSphere(radius,
+            Vec3(0.2, 0.5, 0), *ball, "toes"));
+        model->addForce(force);
+        return model;
+    };
+    auto setState = [](Model& model) -> SimTK::State& {
+        SimTK::State& s = model.initSystem();
+        // The ball is 2 cm into the floor, moving down and forward.
+        s.updQ()[4] = radius - 0.02;
+        s.updU()[3] = 0.5;
+        s.updU()[4] = -0.2;
+        model.realizeAcceleration(s);
+        return s;
+    };
 
+    auto* params = new OpenSim::HuntCrossleyForce::ContactParameters(
+        stiffness, dissipation, staticFriction, dynamicFriction,
+        viscousFriction);
+    params->addGeometry("floor");
+    params->addGeometry("heel");
+    params->addGeometry("toes");
+    unique_ptr<Model> huntCrossley{
+        createModel(new OpenSim::HuntCrossleyForce(params)) };
+
+    auto* spheres = new SphereHalfSpaceContactForce();
+    spheres->setName("contact");
+    spheres->setContactHalfSpace("floor");
+    spheres->addContactSphere("heel");
+    spheres->addContactSphere("toes");
+    spheres->set_stiffness(stiffness);
+    spheres->set_dissipation(dissipation);
+    spheres->set_static_friction(staticFriction);
+    spheres->set_dynamic_friction(dynamicFriction);
+    spheres->set_viscous_friction(viscousFriction);
+    unique_ptr<Model> sphereSet{ createModel(spheres->clone()) };
+    spheres->set_use_smooth_force_law(true);
+    spheres->set_hertz_smoothing(1000);
+    unique_ptr<Model> smooth{ createModel(spheres) };
+
+    // The ball does not spin, so the linear accelerations depend only on the
+    // net contact force.
+    const SimTK::State& sHC = setState(*huntCrossley);
+    const SimTK::State& s = setState(*sphereSet);
+    const SimTK::State& sSmooth = setState(*smooth);
+    const Vec3 accelHC(&sHC.getUDot()[3]);
+    const Vec3 accel(&s.getUDot()[3]);
+    const Vec3 accelSmooth(&sSmooth.getUDot()[3]);
+    ASSERT(accelHC[1] > 0 && accelHC[0] < 0, __FILE__, __LINE__,
+        "Expected the floor to push the ball up and to slow it down.");
+    SimTK_TEST_EQ_TOL(accel, accelHC, 1e-8);
+    SimTK_TEST_EQ_TOL(accelSmooth, accelHC, 1e-3*accelHC.norm());
+
+    // Only the heel is in contact, and the wrenches add up to the force that
+    // accelerates the ball.
+    const auto& force = sphereSet->getComponent<SphereHalfSpaceContactForce>(
+        "contact");
+    const SimTK::SpatialVec heel = force.getSphereWrench(s, "heel");
+    const auto& toes = dynamic_cast<const Output<SimTK::SpatialVec>::Channel&>(
+        force.getOutput("sphere_wrenches").getChannel("toes"));
+    SimTK_TEST_EQ(toes.getValue(s), SimTK::SpatialVec(Vec3(0), Vec3(0)));
+    const SimTK::SpatialVec total =
+        force.getOutputValue<SimTK::SpatialVec>(s, "total_wrench");
+    SimTK_TEST_EQ(total, heel);
+    SimTK_TEST_EQ_TOL(total[1], mass*(accel - gravity_vec), 1e-8);
+    ASSERT(force.getRecordValues(s).size() == 12);
+    ASSERT_THROW(OpenSim::Exception, force.getSphereWrench(s, "waldo"));
+}
 
+void testElasticFoundationThreads()
+{
+    // A mesh ball sliding and spinning into a mesh (or a sphere) on the
+    // ground.
+    auto createModel = [&](bool meshOnGround, int numThreads) {
+        Model* model = new Model;
+        model->setGravity(gravity_vec);
+        auto* ball = new OpenSim::Body("ball", mass, Vec3(0), Inertia(1.0));
+        model->addBody(ball);
+        model->addJoint(new FreeJoint("free", model->getGround(), Vec3(0),
+            Vec3(0), *ball, Vec3(0), Vec3(0)));
+        if (meshOnGround) {
+            model->addContactGeometry(new ContactMesh(mesh_files[0], Vec3(0),
+                Vec3(0), model->getGround(), "base"));
+        } else {
+            model->addContactGeometry(new ContactSphere(radius, Vec3(0),
+                model->getGround(), "base"));
+        }
+        model->addContactGeometry(new ContactMesh(mesh_files[0], Vec3(0),
+            Vec3(0), *ball, "ball"));
+        auto* params = new OpenSim::ElasticFoundationForce::ContactParameters(
+            1.0e6/(2*radius), 0.01, 0.8, 0.5, 0.1);
+        params->addGeometry("base");
+        params->addGeometry("ball");
+        auto* force = new OpenSim::ElasticFoundationForce(params);
+        force->setName("contact");
+        force->setNumThreads(numThreads);
+        model->addForce(force);
+        return model;
+    };
+    auto setState = [](Model& model) -> SimTK::State& {
+        SimTK::State& s = model.initSystem();
+        s.updQ()[0] = 0.3;
+        s.updQ()[3] = 0.05;
+        s.updQ()[4] = 1.6*radius;
+        s.updU()[1] = 2.0;
+        s.updU()[3] = 0.5;
+        s.updU()[4] = -0.2;
+        model.realizeAcceleration(s);
+        return s;
+    };
 
+    OpenSim::ElasticFoundationForce unused;
+    ASSERT_THROW(OpenSim::Exception, unused.setNumThreads(0));
+
+    for (bool meshOnGround : {true, false}) {
+        unique_ptr<Model> simbody{ createModel(meshOnGround, 1) };
+        unique_ptr<Model> threads{ createModel(meshOnGround, 4) };
+        const SimTK::State& s1 = setState(*simbody);
+        const SimTK::State& s4 = setState(*threads);
+        const Vector& udot = s1.getUDot();
+        ASSERT(udot[4] > 0, __FILE__, __LINE__,
+            "Expected the contact to push the ball up.");
+        SimTK_TEST_EQ_TOL(s4.getUDot(), udot, 1e-9*udot.normRMS());
+        SimTK_TEST_EQ_TOL(
+            threads->getMultibodySystem().calcPotentialEnergy(s4),
+            simbody->getMultibodySystem().calcPotentialEnergy(s1), 1e-9);
+        const auto& force =
+            threads->getComponent<OpenSim::ElasticFoundationForce>(
+                "contact");
+        const auto& expected =
+            simbody->getComponent<OpenSim::ElasticFoundationForce>(
+                "contact");
+        const Array<double> values = force.getRecordValues(s4);
+        const Array<double> expectedValues = expected.getRecordValues(s1);
+        ASSERT(values.getSize() == expectedValues.getSize());
+        for (int i = 0; i < values.getSize(); ++i)
+            ASSERT_EQUAL(expectedValues[i], values[i], 1e-6);
+    }
 
-
-
-
-
-
-
-
-
-
-
-
-
+    // In deterministic mode, the number of threads does not matter.
+    const bool deterministic = ThreadPool::getDeterministic();
+    ThreadPool::setDeterministic(true);
+    unique_ptr<Model> two{ createModel(true, 2) };
+    unique_ptr<Model> four{ createModel(true, 4) };
+    const SimTK::State& s2 = setState(*two);
+    const SimTK::State& s4 = setState(*four);
+    for (int i = 0; i < s2.getNU(); ++i)
+        ASSERT(s2.getUDot()[i] == s4.getUDot()[i], __FILE__, __LINE__,
+            "Expected the same accelerations for any number of threads.");
+    ThreadPool::setDeterministic(deterministic);
+}
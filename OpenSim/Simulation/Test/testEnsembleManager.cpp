@@ -0,0 +1,287 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testEnsembleManager.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testEnsembleManager verifies that the runs of an ensemble integrated on
+// multiple threads match the same simulations run one at a time.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <random>
+
+using namespace OpenSim;
+using namespace std;
+
+// Build a simple pendulum.
+Model* constructPendulum();
+// Integrate a single simulation with a Manager.
+TimeSeriesTable simulate(const Model& model, double theta0, double finalTime,
+                         const SimTK::Vec3& gravity);
+// Verify that the ensemble reproduces simulations run one at a time.
+void testEnsembleMatchesSerial();
+// Verify that a failing run does not stop the others.
+void testFailedRun();
+// Verify that runs perturbed from their seeds do not depend on the number of
+// threads.
+void testSeededRuns();
+// Verify that branches continue the prefix as separate simulations would.
+void testBranches();
+
+int main()
+{
+    try {
+        testEnsembleMatchesSerial();
+        testFailedRun();
+        testSeededRuns();
+        testBranches();
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void testEnsembleMatchesSerial()
+{
+    unique_ptr<Model> pendulum{ constructPendulum() };
+    SimTK::State s = pendulum->initSystem();
+    const Coordinate& theta = pendulum->getCoordinateSet()[0];
+    const SimTK::Vec3 gravity = pendulum->getGravity();
+
+    EnsembleManager ensemble(*pendulum);
+    ensemble.setNumThreads(3);
+
+    // Runs of different durations, some from a modified model.
+    const int numRuns = 8;
+    vector<double> theta0(numRuns), finalTimes(numRuns);
+    vector<SimTK::Vec3> gravities(numRuns, gravity);
+    for (int i = 0; i < numRuns; ++i) {
+        theta0[i] = 0.1*(i + 1);
+        finalTimes[i] = 0.5*(1 + i%3);
+        theta.setValue(s, theta0[i]);
+        if (i%2) {
+            gravities[i] = 0.5*gravity;
+            const SimTK::Vec3 g = gravities[i];
+            ensemble.addRun(s, finalTimes[i],
+                [g](Model& model) { model.setGravity(g); });
+        }
+        else
+            ensemble.addRun(s, finalTimes[i]);
+    }
+    ASSERT(ensemble.getNumRuns() == numRuns, __FILE__, __LINE__,
+        "Expected a run for each initial state.");
+    ASSERT(ensemble.run() == numRuns, __FILE__, __LINE__,
+        "Expected all the runs to succeed.");
+
+    for (int i = 0; i < numRuns; ++i) {
+        ASSERT(ensemble.getSuccess(i), __FILE__, __LINE__,
+            "Run " + to_string(i) + " failed: " + ensemble.getErrorMessage(i));
+        const TimeSeriesTable expected =
+            simulate(*pendulum, theta0[i], finalTimes[i], gravities[i]);
+        const TimeSeriesTable& found = ensemble.getStatesTable(i);
+        ASSERT(found.getNumRows() == expected.getNumRows() &&
+               found.getNumColumns() == expected.getNumColumns(),
+            __FILE__, __LINE__, "Run " + to_string(i) + " took different "
+            "steps than the simulation run by itself.");
+        ASSERT_EQUAL(finalTimes[i], found.getIndependentColumn().back(),
+            SimTK::Eps, __FILE__, __LINE__,
+            "Run " + to_string(i) + " did not reach its final time.");
+        const auto expectedRow = expected.getRowAtIndex(expected.getNumRows() - 1);
+        const auto foundRow = found.getRowAtIndex(found.getNumRows() - 1);
+        for (int j = 0; j < expectedRow.ncol(); ++j)
+            ASSERT_EQUAL(expectedRow[j], foundRow[j], 1e-10, __FILE__, __LINE__,
+                "Run " + to_string(i) + " differs from the simulation run by "
+                "itself.");
+    }
+}
+
+void testFailedRun()
+{
+    unique_ptr<Model> pendulum{ constructPendulum() };
+    SimTK::State s = pendulum->initSystem();
+
+    EnsembleManager ensemble(*pendulum);
+    ensemble.setNumThreads(2);
+    ensemble.addRun(s, 0.5);
+    ensemble.addRun(s, 0.5, [](Model&) {
+        throw Exception("Perturbation is not valid.");
+    });
+    ensemble.addRun(s, 0.5);
+
+    ASSERT(ensemble.run() == 2, __FILE__, __LINE__,
+        "Expected exactly one run to fail.");
+    ASSERT(!ensemble.getSuccess(1) && !ensemble.getErrorMessage(1).empty(),
+        __FILE__, __LINE__, "Expected the run with the failing modifier to "
+        "fail with a message.");
+    ASSERT(ensemble.getSuccess(0) && ensemble.getSuccess(2), __FILE__, __LINE__,
+        "Expected the other runs to succeed.");
+    ASSERT_THROW(IndexOutOfRange, ensemble.getStatesTable(3));
+}
+
+void testSeededRuns()
+{
+    unique_ptr<Model> pendulum{ constructPendulum() };
+    SimTK::State s = pendulum->initSystem();
+    pendulum->getCoordinateSet()[0].setValue(s, 0.5);
+
+    const auto runEnsemble = [&](int numThreads) {
+        EnsembleManager ensemble(*pendulum);
+        ensemble.setNumThreads(numThreads);
+        ensemble.setSeed(7);
+        for (int i = 0; i < 6; ++i) {
+            ensemble.addRun(s, 0.5, [](Model& model, unsigned long long seed) {
+                std::mt19937_64 random(seed);
+                std::uniform_real_distribution<double> g(-12.0, -8.0);
+                model.setGravity(SimTK::Vec3(0, g(random), 0));
+            });
+        }
+        ASSERT(ensemble.run() == 6, __FILE__, __LINE__,
+            "Expected all the runs to succeed.");
+        vector<double> finalThetas;
+        for (int i = 0; i < 6; ++i) {
+            const TimeSeriesTable& states = ensemble.getStatesTable(i);
+            finalThetas.push_back(
+                states.getRowAtIndex(states.getNumRows() - 1)[0]);
+        }
+        return finalThetas;
+    };
+
+    const vector<double> serial = runEnsemble(1);
+    ASSERT(serial == runEnsemble(3), __FILE__, __LINE__,
+        "Expected the same results on 1 and 3 threads.");
+    ASSERT(serial[0] != serial[1], __FILE__, __LINE__,
+        "Expected the runs to be perturbed differently.");
+}
+
+void testBranches()
+{
+    unique_ptr<Model> pendulum{ constructPendulum() };
+    SimTK::State s = pendulum->initSystem();
+    pendulum->getCoordinateSet()[0].setValue(s, 0.3);
+    const SimTK::Vec3 gravity = pendulum->getGravity();
+    const double branchTime = 0.5, finalTime = 1.0;
+
+    EnsembleManager ensemble(*pendulum);
+    ensemble.setNumThreads(2);
+    ASSERT_THROW(Exception, ensemble.addBranch(finalTime));
+    ensemble.setPrefix(s, branchTime);
+    ASSERT_THROW(Exception, ensemble.addBranch(0.25));
+    const vector<double> scales{1.0, 0.5, 0.25};
+    for (double scale : scales) {
+        const SimTK::Vec3 g = scale*gravity;
+        ensemble.addBranch(finalTime,
+            [g](Model& model) { model.setGravity(g); });
+    }
+    ensemble.addBranch(finalTime);
+    ASSERT(ensemble.run() == 4, __FILE__, __LINE__,
+        "Expected all the branches to succeed.");
+
+    // The prefix, integrated on its own.
+    unique_ptr<Model> copy{ pendulum->clone() };
+    SimTK::State prefixState = copy->initSystem();
+    prefixState.updQ() = s.getQ();
+    prefixState.updU() = s.getU();
+    Manager prefixManager(*copy);
+    prefixManager.setPerformAnalyses(false);
+    prefixManager.getIntegrator().setAccuracy(1e-3);
+    prefixManager.setInitialTime(0);
+    prefixManager.setFinalTime(branchTime);
+    prefixManager.integrate(prefixState);
+    const TimeSeriesTable& prefix = ensemble.getPrefixStatesTable();
+    ASSERT(prefix.getNumRows() == prefixManager.getStatesTable().getNumRows(),
+        __FILE__, __LINE__, "The prefix took different steps.");
+    ASSERT_EQUAL(branchTime, prefix.getIndependentColumn().back(), SimTK::Eps,
+        __FILE__, __LINE__, "The prefix did not end at the branch time.");
+
+    for (int i = 0; i < ensemble.getNumRuns(); ++i) {
+        const double scale = i < (int)scales.size() ? scales[i] : 1.0;
+        unique_ptr<Model> branch{ pendulum->clone() };
+        branch->setGravity(scale*gravity);
+        SimTK::State state = branch->initSystem();
+        state.setTime(branchTime);
+        state.updQ() = prefixState.getQ();
+        state.updU() = prefixState.getU();
+        Manager manager(*branch);
+        manager.setPerformAnalyses(false);
+        manager.getIntegrator().setAccuracy(1e-3);
+        manager.setInitialTime(branchTime);
+        manager.setFinalTime(finalTime);
+        manager.integrate(state);
+        const TimeSeriesTable expected = manager.getStatesTable();
+
+        // Each branch starts with the final state of the prefix.
+        const TimeSeriesTable& found = ensemble.getStatesTable(i);
+        ASSERT_EQUAL(branchTime, found.getIndependentColumn().front(),
+            SimTK::Eps, __FILE__, __LINE__,
+            "Branch " + to_string(i) + " did not start at the branch time.");
+        const auto first = found.getRowAtIndex(0);
+        const auto last = prefix.getRowAtIndex(prefix.getNumRows() - 1);
+        for (int j = 0; j < first.ncol(); ++j)
+            ASSERT_EQUAL(last[j], first[j], 1e-12, __FILE__, __LINE__,
+                "Branch " + to_string(i) + " did not start from the prefix.");
+        ASSERT(found.getNumRows() == expected.getNumRows(), __FILE__, __LINE__,
+            "Branch " + to_string(i) + " took different steps.");
+        const auto expectedRow = expected.getRowAtIndex(expected.getNumRows() - 1);
+        const auto foundRow = found.getRowAtIndex(found.getNumRows() - 1);
+        for (int j = 0; j < expectedRow.ncol(); ++j)
+            ASSERT_EQUAL(expectedRow[j], foundRow[j], 1e-10, __FILE__, __LINE__,
+                "Branch " + to_string(i) + " differs from its continuation "
+                "run by itself.");
+    }
+}
+
+TimeSeriesTable simulate(const Model& model, double theta0, double finalTime,
+                         const SimTK::Vec3& gravity)
+{
+    unique_ptr<Model> copy{ model.clone() };
+    copy->setGravity(gravity);
+    SimTK::State s = copy->initSystem();
+    copy->getCoordinateSet()[0].setValue(s, theta0);
+
+    Manager manager(*copy);
+    manager.setPerformAnalyses(false);
+    manager.getIntegrator().setAccuracy(1e-3);
+    manager.setInitialTime(0);
+    manager.setFinalTime(finalTime);
+    manager.integrate(s);
+    return manager.getStatesTable();
+}
+
+Model* constructPendulum()
+{
+    Model* pendulum = new Model();
+    pendulum->setName("pendulum");
+    Body* ball =
+        new Body("ball", 1.0, SimTK::Vec3(0), SimTK::Inertia::sphere(0.05));
+    pendulum->addBody(ball);
+
+    PinJoint* hinge = new PinJoint("hinge", pendulum->getGround(),
+        SimTK::Vec3(0, 1.0, 0), SimTK::Vec3(0),
+        *ball, SimTK::Vec3(0, 1.0, 0), SimTK::Vec3(0));
+    hinge->updCoordinate().setName("theta");
+    pendulum->addJoint(hinge);
+
+    return pendulum;
+}
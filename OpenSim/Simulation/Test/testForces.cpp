@@ -33,6 +33,7 @@
 //      7. ExternalForce
 //      8. PathSpring
 //      9. ExpressionBasedPointToPointForce
+//     10. MultiExpressionProgram
 //      
 //     Add tests here as Forces are added to OpenSim
 //
@@ -40,6 +41,7 @@
 #include <ctime>  // clock(), clock_t, CLOCKS_PER_SEC
 #include <OpenSim/Simulation/osimSimulation.h>
 #include <OpenSim/Analyses/osimAnalyses.h>
+#include <OpenSim/Simulation/Model/PointForceDirection.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include "SimTKcommon/internal/Xml.h"
 
@@ -56,6 +58,7 @@ void testPathSpring();
 void testExternalForce();
 void testSpringMass();
 void testBushingForce();
+void testBatchedBushingForce();
 void testFunctionBasedBushingForce();
 void testExpressionBasedBushingForceTranslational();
 void testExpressionBasedBushingForceRotational();
@@ -63,8 +66,10 @@ void testElasticFoundation();
 void testHuntCrossleyForce();
 void testCoordinateLimitForce();
 void testCoordinateLimitForceRotational();
+void testBatchedCoordinateLimitForce();
 void testExpressionBasedPointToPointForce();
 void testExpressionBasedCoordinateForce();
+void testMultiExpressionProgram();
 void testSerializeDeserialize();
 
 int main()
@@ -91,6 +96,12 @@ int main()
         cout << e.what() <<endl; failures.push_back("testBushingForce");
     }
 
+    try { testBatchedBushingForce(); }
+    catch (const std::exception& e){
+        cout << e.what() <<endl;
+        failures.push_back("testBatchedBushingForce");
+    }
+
     try { testFunctionBasedBushingForce(); }
     catch (const std::exception& e){
         cout << e.what() <<endl; 
@@ -130,6 +141,12 @@ int main()
         failures.push_back("testCoordinateLimitForceRotational");
     }
 
+    try { testBatchedCoordinateLimitForce(); }
+    catch (const std::exception& e){
+        cout << e.what() <<endl;
+        failures.push_back("testBatchedCoordinateLimitForce");
+    }
+
     try { testExpressionBasedPointToPointForce(); }
     catch (const std::exception& e){
         cout << e.what() <<endl; 
@@ -142,6 +159,12 @@ int main()
         failures.push_back("testExpressionBasedCoordinateForce");
     }
 
+    try { testMultiExpressionProgram(); }
+    catch (const std::exception& e){
+        cout << e.what() <<endl; 
+        failures.push_back("testMultiExpressionProgram");
+    }
+
     try { testSerializeDeserialize(); }
     catch (const std::exception& e){
         cout << e.what() <<endl; 
@@ -162,6 +185,44 @@ int main()
 // Test Cases
 //==============================================================================
 
+void testMultiExpressionProgram()
+{
+    using SimTK::Vec2;
+    // The first two expressions share exp(-q^2), and the third is q*q.
+    MultiExpressionProgram program(
+        { "3*q^2 + exp(-q^2)", "exp(-q^2)*qdot", "q*q", "2.5" },
+        { "q", "qdot" });
+    ASSERT(program.getNumExpressions() == 4 &&
+           program.getNumVariables() == 2, __FILE__, __LINE__,
+        "MultiExpressionProgram has the wrong number of expressions or "
+        "variables.");
+
+    // The expressions compiled separately need more operations.
+    int numSeparate = 0;
+    for (const std::string& expression :
+            { "3*q^2 + exp(-q^2)", "exp(-q^2)*qdot", "q*q" })
+        numSeparate += MultiExpressionProgram({ expression }, { "q", "qdot" })
+                           .getNumOperations();
+    ASSERT(program.getNumOperations() < numSeparate, __FILE__, __LINE__,
+        "Expected the shared subexpressions to be evaluated once.");
+
+    for (double q : { -1.3, 0.0, 0.7 }) {
+        const double qdot = 2.0 - q;
+        const Vec2 variables(q, qdot);
+        double results[4];
+        program.evaluate(&variables[0], results);
+        ASSERT_EQUAL(3*q*q + exp(-q*q), results[0], 1e-12);
+        ASSERT_EQUAL(exp(-q*q)*qdot, results[1], 1e-12);
+        ASSERT_EQUAL(q*q, results[2], 1e-12);
+        ASSERT_EQUAL(2.5, results[3], 1e-12);
+    }
+
+    const std::vector<std::string> unknownVariable{ "q*x" };
+    const std::vector<std::string> variables{ "q", "qdot" };
+    ASSERT_THROW(OpenSim::Exception,
+        MultiExpressionProgram(unknownVariable, variables));
+}
+
 void testExpressionBasedCoordinateForce()
 {
     using namespace SimTK;
@@ -466,6 +527,31 @@ void testPathSpring()
     // Before exiting lets see if copying the spring works
     PathSpring *copyOfSpring = spring.clone();
     ASSERT(*copyOfSpring == spring);
+
+    // The tension applied along the path gives the same body forces as when
+    // applied through the PointForceDirections of the path.
+    const GeometryPath& path = spring.getGeometryPath();
+    const int nb = osimModel.getMatterSubsystem().getNumBodies();
+    Vector_<SpatialVec> bodyForces(nb, SpatialVec(Vec3(0), Vec3(0)));
+    Vector_<SpatialVec> expectedBodyForces = bodyForces;
+    Vector mobilityForces(osim_state.getNU(), 0.0);
+    path.addInEquivalentForces(osim_state, model_force, bodyForces,
+                               mobilityForces);
+    OpenSim::Array<PointForceDirection*> PFDs;
+    path.getPointForceDirections(osim_state, &PFDs);
+    for (int i = 0; i < PFDs.getSize(); ++i) {
+        const PhysicalFrame& frame = PFDs[i]->frame();
+        frame.getMobilizedBody().applyForceToBodyPoint(osim_state,
+            frame.findTransformInBaseFrame()*PFDs[i]->point(),
+            model_force*PFDs[i]->direction(), expectedBodyForces);
+        delete PFDs[i];
+    }
+    for (int b = 0; b < nb; ++b) {
+        ASSERT_EQUAL(expectedBodyForces[b][0], bodyForces[b][0], 1e-10,
+                     __FILE__, __LINE__);
+        ASSERT_EQUAL(expectedBodyForces[b][1], bodyForces[b][1], 1e-10,
+                     __FILE__, __LINE__);
+    }
     
     osimModel.disownAllComponents();
 }
@@ -556,6 +642,13 @@ void testSpringMass()
         // analytical force corresponds in direction to the force on the ball Y index = 7
         ASSERT_EQUAL(analytical_force, model_force[7], 1e-4);
 
+        // The values written in place match the reported values.
+        ASSERT(spring.getNumRecordValues() == model_force.getSize());
+        std::vector<double> written(spring.getNumRecordValues());
+        spring.writeRecordValues(osim_state, written.data());
+        for (int j = 0; j < model_force.getSize(); ++j)
+            ASSERT_EQUAL(model_force[j], written[j], 0.0);
+
         manager.setInitialTime(dt*i);
     }
 
@@ -681,6 +774,102 @@ void testBushingForce()
     osimModel.disownAllComponents();
 }
 
+// A BatchedBushingForce must apply the same forces as the equivalent
+// BushingForces.
+void testBatchedBushingForce()
+{
+    using namespace SimTK;
+
+    struct Bushing {
+        std::string frame1; Transform X1; std::string frame2; Transform X2;
+        Vec3 transStiffness, rotStiffness, transDamping, rotDamping;
+    };
+    const std::vector<Bushing> bushings{
+        {"ground", Transform(Vec3(0, 0.5, 0)), "b1", Transform(),
+         Vec3(100, 200, 300), Vec3(10, 20, 30), Vec3(1, 2, 3), Vec3(.1)},
+        {"b1", Transform(Rotation(0.3, ZAxis), Vec3(0.1, 0, 0)),
+         "b2", Transform(Rotation(-0.2, XAxis), Vec3(0, 0.05, 0.02)),
+         Vec3(50), Vec3(5, 6, 7), Vec3(0.5), Vec3(0.2, 0.1, 0.3)},
+        {"ground", Transform(Vec3(0.2, 0.3, -0.1)), "b2", Transform(),
+         Vec3(80, 0, 40), Vec3(0), Vec3(0), Vec3(0.3)}};
+
+    // Two free bodies, and either a BushingForce per bushing or a single
+    // BatchedBushingForce.
+    auto createModel = [&](bool batched, int numThreads) {
+        Model* model = new Model();
+        model->setGravity(Vec3(0));
+        for (const std::string name : {"b1", "b2"}) {
+            OpenSim::Body* body = new OpenSim::Body(name, 1.0, Vec3(0),
+                    Inertia(0.1));
+            model->addBody(body);
+            model->addJoint(new FreeJoint(name + "_free",
+                    model->getGround(), Vec3(0), Vec3(0),
+                    *body, Vec3(0), Vec3(0)));
+        }
+        if (batched) {
+            BatchedBushingForce* force = new BatchedBushingForce();
+            force->setName("bushings");
+            force->setNumThreads(numThreads);
+            for (const auto& b : bushings)
+                force->addBushing(b.frame1, b.X1, b.frame2, b.X2,
+                        b.transStiffness, b.rotStiffness,
+                        b.transDamping, b.rotDamping);
+            model->addForce(force);
+        } else {
+            int i = 0;
+            for (const auto& b : bushings)
+                model->addForce(new BushingForce(
+                        "bushing" + std::to_string(i++),
+                        b.frame1, b.X1, b.frame2, b.X2,
+                        b.transStiffness, b.rotStiffness,
+                        b.transDamping, b.rotDamping));
+        }
+        return model;
+    };
+
+    auto computeAccelerations = [](Model& model, double& energy) {
+        SimTK::State& s = model.initSystem();
+        for (int i = 0; i < s.getNQ(); ++i) s.updQ()[i] = 0.05*(i + 1);
+        for (int i = 0; i < s.getNU(); ++i) s.updU()[i] = 0.1*(6 - i);
+        model.realizeAcceleration(s);
+        energy = model.getMultibodySystem().calcPotentialEnergy(s);
+        return Vector(s.getUDot());
+    };
+
+    std::unique_ptr<Model> separate(createModel(false, 1));
+    double separateEnergy;
+    Vector separateUDot = computeAccelerations(*separate, separateEnergy);
+
+    for (int numThreads : {1, 2}) {
+        std::unique_ptr<Model> batched(createModel(true, numThreads));
+        double batchedEnergy;
+        Vector batchedUDot = computeAccelerations(*batched, batchedEnergy);
+        ASSERT_EQUAL(separateEnergy, batchedEnergy, 1e-10);
+        ASSERT(batchedEnergy > 0);
+        for (int i = 0; i < separateUDot.size(); ++i)
+            ASSERT_EQUAL(separateUDot[i], batchedUDot[i], 1e-9);
+    }
+
+    // The bushings survive serialization.
+    std::unique_ptr<Model> batched(createModel(true, 1));
+    batched->print("BatchedBushingForceModel.osim");
+    Model deserialized("BatchedBushingForceModel.osim");
+    const auto& force =
+        deserialized.getComponent<BatchedBushingForce>("bushings");
+    ASSERT(force.getNumBushings() == (int)bushings.size());
+    double deserializedEnergy;
+    Vector deserializedUDot =
+        computeAccelerations(deserialized, deserializedEnergy);
+    ASSERT_EQUAL(separateEnergy, deserializedEnergy, 1e-6);
+
+    // Mismatched lists are rejected.
+    BatchedBushingForce bad;
+    bad.addBushing("ground", Transform(), "b1", Transform(),
+                   Vec3(1), Vec3(1), Vec3(0), Vec3(0));
+    bad.append_translational_stiffness(1.0);
+    ASSERT_THROW(OpenSim::Exception, bad.finalizeFromProperties());
+}
+
 void testFunctionBasedBushingForce()
 {
     using namespace SimTK;
@@ -1465,6 +1654,103 @@ void testCoordinateLimitForceRotational()
     reporter->getForceStorage().print("rotational_limit_forces.mot");
 }
 
+// A BatchedCoordinateLimitForce must apply the same forces as the equivalent
+// CoordinateLimitForces, and conserve energy when its dissipation is counted.
+void testBatchedCoordinateLimitForce()
+{
+    using namespace SimTK;
+
+    // A rotational and a translational coordinate.
+    Model model;
+    model.setGravity(Vec3(0));
+    OpenSim::Body* arm = new OpenSim::Body("arm", 1.0, Vec3(0),
+                                           Inertia::brick(0.1, 0.1, 0.1));
+    OpenSim::Body* slide = new OpenSim::Body("slide", 2.0, Vec3(0),
+                                             Inertia::brick(0.1, 0.1, 0.1));
+    model.addBody(arm);
+    model.addBody(slide);
+    PinJoint* pin = new PinJoint("pin", model.getGround(), Vec3(0), Vec3(0),
+                                 *arm, Vec3(0, -0.2, 0), Vec3(0));
+    pin->updCoordinate().setName("theta");
+    SliderJoint* slider = new SliderJoint("slider", model.getGround(),
+            Vec3(0), Vec3(0), *slide, Vec3(0), Vec3(0));
+    slider->updCoordinate().setName("h");
+    model.addJoint(pin);
+    model.addJoint(slider);
+
+    CoordinateLimitForce* thetaLimit = new CoordinateLimitForce("theta",
+            90, 10, -30, 20, 0.1, 5);
+    CoordinateLimitForce* hLimit = new CoordinateLimitForce("h",
+            0.5, 1000, -0.2, 500, 2, 0.05);
+    model.addForce(thetaLimit);
+    model.addForce(hLimit);
+
+    BatchedCoordinateLimitForce* limits = new BatchedCoordinateLimitForce();
+    limits->setName("limits");
+    limits->addCoordinateLimit(*thetaLimit);
+    limits->addCoordinateLimit(*hLimit);
+    limits->set_compute_dissipation_energy(true);
+    model.addForce(limits);
+
+    SimTK::State& s = model.initSystem();
+    const Coordinate& theta = model.getCoordinateSet().get("theta");
+    const Coordinate& h = model.getCoordinateSet().get("h");
+
+    // Within the limits, in the transitions and beyond them.
+    for (double thetaDeg : {0.0, 92.0, 100.0, -32.0, -40.0}) {
+        for (double hValue : {0.0, 0.52, 0.6, -0.23, -0.3}) {
+            theta.setValue(s, thetaDeg*SimTK_DEGREE_TO_RADIAN);
+            theta.setSpeedValue(s, 0.7);
+            h.setValue(s, hValue);
+            h.setSpeedValue(s, -0.4);
+            model.realizeVelocity(s);
+
+            Vector forces = limits->calcLimitForces(s);
+            ASSERT_EQUAL(thetaLimit->calcLimitForce(s), forces[0], 1e-10);
+            ASSERT_EQUAL(hLimit->calcLimitForce(s), forces[1], 1e-10);
+            ASSERT_EQUAL(thetaLimit->computePotentialEnergy(s) +
+                         hLimit->computePotentialEnergy(s),
+                         limits->computePotentialEnergy(s), 1e-10);
+            ASSERT_EQUAL(forces[0]*0.7 - forces[1]*0.4,
+                         limits->getLimitPower(s), 1e-10);
+
+            model.realizeDynamics(s);
+            ASSERT_EQUAL(thetaLimit->getPowerDissipation(s) +
+                         hLimit->getPowerDissipation(s),
+                         limits->getPowerDissipation(s), 1e-10);
+            ASSERT(limits->getPowerDissipation(s) >= 0);
+        }
+    }
+
+    // With only the batched limits applied, the energy of the system plus
+    // the energy they dissipate is conserved.
+    thetaLimit->setAppliesForce(s, false);
+    hLimit->setAppliesForce(s, false);
+    theta.setValue(s, 95*SimTK_DEGREE_TO_RADIAN);
+    theta.setSpeedValue(s, 0);
+    h.setValue(s, -0.25);
+    h.setSpeedValue(s, 0);
+    model.realizeAcceleration(s);
+    const double eSys0 = model.getMultibodySystem().calcEnergy(s);
+
+    RungeKuttaMersonIntegrator integrator(model.getMultibodySystem());
+    integrator.setAccuracy(1e-8);
+    Manager manager(model, integrator);
+    manager.setInitialTime(0.0);
+    manager.setFinalTime(0.5);
+    manager.integrate(s);
+    model.realizeAcceleration(s);
+    const double eSys = model.getMultibodySystem().calcEnergy(s) +
+                        limits->getDissipatedEnergy(s);
+    ASSERT(limits->getDissipatedEnergy(s) > 0);
+    ASSERT_EQUAL(eSys/eSys0, 1.0, integ_accuracy);
+
+    // The record values are the forces and the potential energy.
+    Array<double> values = limits->getRecordValues(s);
+    ASSERT(values.getSize() == limits->getRecordLabels().getSize());
+    ASSERT_EQUAL(limits->computePotentialEnergy(s), values[2], 1e-12);
+}
+
 
 
 void testExternalForce()
@@ -1675,6 +1961,25 @@ void testExternalForce()
         if(i !=3)
             ASSERT_EQUAL(def, val, 10*accuracy);
     }
+
+    // A copy of the model reuses the functions fitted to the data and applies
+    // the same forces, but fits them again if it changes an identifier.
+    std::unique_ptr<Model> copy{ model.clone() };
+    auto& xf5Copy = dynamic_cast<ExternalForce&>(
+        copy->updForceSet().get(model.getForceSet().getIndex(&xf5)));
+    auto& xf6Copy = dynamic_cast<ExternalForce&>(
+        copy->updForceSet().get(model.getForceSet().getIndex(&xf6)));
+    xf6Copy.setTorqueIdentifier("force");
+    copy->initSystem();
+    for (double t = 0; t <= tf; t += 0.25) {
+        ASSERT_EQUAL(xf5.getForceAtTime(t), xf5Copy.getForceAtTime(t),
+                     SimTK::Eps);
+        ASSERT_EQUAL(xf5.getPointAtTime(t), xf5Copy.getPointAtTime(t),
+                     SimTK::Eps);
+        ASSERT_EQUAL(xf5.getForceAtTime(t), xf6Copy.getTorqueAtTime(t),
+                     SimTK::Eps);
+        ASSERT_EQUAL(torque, xf6.getTorqueAtTime(t), 10*accuracy);
+    }
 }
 
 void testSerializeDeserialize() {
@@ -0,0 +1,172 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  testImplicitDynamicsJacobian.cpp                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testImplicitDynamicsJacobian verifies that the Jacobian of the implicit
+// dynamics of a model found by perturbing the variables of each color
+// together matches the one found by perturbing them one at a time, and that
+// muscles declare the mobilities their paths span.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/osimActuators.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <algorithm>
+
+using namespace OpenSim;
+using namespace std;
+
+// Verify that no residual depends on two variables of the same color.
+void testColoring();
+// Verify the colored Jacobian against perturbing each variable alone.
+void testColoredJacobian();
+// Verify the dependencies declared by a muscle.
+void testMuscleDependencies();
+
+int main()
+{
+    try {
+        testColoring();
+        testColoredJacobian();
+        testMuscleDependencies();
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void testColoring()
+{
+    Model model("gait2354_simbody.osim");
+    const SimTK::State& s = model.initSystem();
+    const int ny = s.getNY();
+    const int nu = s.getNU();
+    const int nc = model.getNumControls();
+
+    ImplicitDynamicsJacobian jacobian(model);
+    ASSERT(jacobian.getNumResiduals() == ny);
+    ASSERT(jacobian.getNumVariables() == ny + nu + nc);
+
+    const vector<int>& colors = jacobian.getColors();
+    for (int j = ny; j < ny + nu; ++j)
+        ASSERT(colors[j] == -1, __FILE__, __LINE__,
+               "Accelerations are not perturbed.");
+    for (const vector<int>& row : jacobian.getSparsity()) {
+        ASSERT(std::is_sorted(row.begin(), row.end()));
+        vector<bool> seen(jacobian.getNumColors(), false);
+        for (int j : row) {
+            if (colors[j] < 0) continue;
+            ASSERT(!seen[colors[j]], __FILE__, __LINE__,
+                   "A residual depends on two variables of the same color.");
+            seen[colors[j]] = true;
+        }
+    }
+
+    // Fewer evaluations than there are states and controls: each coordinate
+    // and speed has a color of its own, but muscles that span different
+    // joints share colors.
+    cout << "Variables: " << ny + nc << ", colors: "
+         << jacobian.getNumColors() << ", nonzeros: "
+         << jacobian.getNumNonzeros() << endl;
+    ASSERT(jacobian.getNumColors() < 3*(ny + nc)/4);
+}
+
+void testColoredJacobian()
+{
+    Model model("gait2354_simbody.osim");
+    SimTK::State s = model.initSystem();
+    // Away from the default pose, and moving.
+    for (int i = 0; i < s.getNQ(); ++i) s.updQ()[i] += 0.02*(i % 5);
+    s.updU() = 0.3;
+    const int ny = s.getNY();
+    const int nu = s.getNU();
+    const int nc = model.getNumControls();
+
+    ImplicitDynamicsJacobian jacobian(model);
+    SimTK::Vector udot(nu, 0.5);
+    SimTK::Vector controls(nc, 0.4);
+    const SimTK::Matrix colored = jacobian.calcJacobian(s, udot, controls);
+
+    // Perturb each variable alone, with the same step.
+    const SimTK::Vector r0 = jacobian.calcResiduals(s, udot, controls);
+    SimTK::State perturbed = s;
+    const auto variable = [&](int j) -> double& {
+        return j < ny ? perturbed.updY()[j]
+             : j < ny + nu ? udot[j - ny] : controls[j - ny - nu];
+    };
+    for (int j = 0; j < jacobian.getNumVariables(); ++j) {
+        const double v = variable(j);
+        variable(j) = v + SimTK::SqrtEps*std::max(1.0, std::abs(v));
+        const double step = variable(j) - v;
+        const SimTK::Vector r =
+            jacobian.calcResiduals(perturbed, udot, controls);
+        variable(j) = v;
+        for (int i = 0; i < ny; ++i) {
+            // Forces that cancel (e.g., of a path on the bodies it does not
+            // span) leave round-off in the residuals.
+            const double dense = (r[i] - r0[i])/step;
+            ASSERT_EQUAL(dense, colored(i, j), 1e-2 + 1e-5*std::abs(dense),
+                __FILE__, __LINE__, "Jacobian differs at residual " +
+                std::to_string(i) + ", variable " + std::to_string(j) + ".");
+        }
+    }
+}
+
+void testMuscleDependencies()
+{
+    Model model("gait2354_simbody.osim");
+    const SimTK::State& s = model.initSystem();
+    model.getMultibodySystem().realize(s, SimTK::Stage::Instance);
+    const SimTK::SimbodyMatterSubsystem& matter = model.getMatterSubsystem();
+    const auto speedIndex = [&](const string& name) {
+        const Coordinate& coord = model.getCoordinateSet().get(name);
+        return int(matter.getMobilizedBody(coord.getBodyIndex())
+                       .getFirstUIndex(s)) + coord.getMobilizerQIndex();
+    };
+
+    // The soleus spans the ankle and subtalar joints, from the tibia to the
+    // calcaneus.
+    const Muscle& soleus = model.getMuscles().get("soleus_r");
+    vector<int> ys, controls, mobilities;
+    ASSERT(soleus.findDynamicsDependencies(s, ys, controls, mobilities));
+    const auto contains = [](const vector<int>& v, int i) {
+        return std::find(v.begin(), v.end(), i) != v.end();
+    };
+    ASSERT(contains(mobilities, speedIndex("ankle_angle_r")));
+    ASSERT(contains(mobilities, speedIndex("subtalar_angle_r")));
+    ASSERT(!contains(mobilities, speedIndex("knee_angle_r")));
+    ASSERT(!contains(mobilities, speedIndex("pelvis_tilt")));
+    ASSERT(!contains(mobilities, speedIndex("ankle_angle_l")));
+    ASSERT(contains(ys, s.getNQ() + speedIndex("ankle_angle_r")));
+    ASSERT(!contains(ys, s.getNQ() + speedIndex("knee_angle_r")));
+
+    // Its own activation and fiber length, and its excitation.
+    for (int y : soleus.getStateVariableYIndices(s))
+        ASSERT(contains(ys, y));
+    ASSERT(controls.size() == 1);
+    SimTK::Vector modelControls(model.getNumControls(), 0.0);
+    soleus.setControls(SimTK::Vector(1, 1.0), modelControls);
+    ASSERT(modelControls[controls[0]] == 1.0);
+}
@@ -24,6 +24,8 @@
 #include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Control/ControlSetController.h>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/PathPoint.h>
+#include <OpenSim/Simulation/SimbodyEngine/Body.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
@@ -43,6 +45,13 @@ void testStates(const string& modelFile);
 //==============================================================================
 void testMemoryUsage(const string& modelFile);
 
+//==============================================================================
+// testFinalizeChangesInSystem tests that moving a path point is applied within
+// the existing System by initSystem(), giving the same path as a Model built
+// anew, and that other edits still build a new System.
+//==============================================================================
+void testFinalizeChangesInSystem(const string& modelFile);
+
 static const int MAX_N_TRIES = 100;
 
 int main()
@@ -52,6 +61,7 @@ int main()
         testStates("arm26.osim");
         testMemoryUsage("arm26.osim");
         testMemoryUsage("PushUpToesOnGroundWithMuscles.osim");
+        testFinalizeChangesInSystem("arm26.osim");
     }
     catch (const Exception& e) {
         cout << "testInitState failed: ";
@@ -171,6 +181,19 @@ void testMemoryUsage(const string& modelFile)
     Model model(modelFile);
     State& state = model.initSystem();
 
+    // Report where the time to initialize the system went.
+    const Model::InitSystemTimes& times = model.getInitSystemTimes();
+    cout << "initSystem() times: finalizeFromProperties "
+        << 1.0e3*times.finalizeFromProperties << "ms, finalizeConnections "
+        << 1.0e3*times.finalizeConnections << "ms, addToSystem "
+        << 1.0e3*times.addToSystem << "ms, realizeTopology "
+        << 1.0e3*times.realizeTopology << "ms, initializeState "
+        << 1.0e3*times.initializeState << "ms" << endl;
+    ASSERT(times.finalizeFromProperties > 0 && times.finalizeConnections > 0
+        && times.addToSystem > 0 && times.realizeTopology > 0
+        && times.initializeState > 0, __FILE__, __LINE__,
+        "testMemoryUsage: expected initSystem() to time each of its phases.");
+
     // also time how long initializing the state takes
     clock_t startTime = clock();
 
@@ -191,3 +214,55 @@ void testMemoryUsage(const string& modelFile)
     ASSERT((leak_percent) < 0.5, __FILE__, __LINE__,
         "testMemoryUsage: state initialization leak > 0.5% of model memory footprint.");
 }
+
+void testFinalizeChangesInSystem(const string& modelFile)
+{
+    using namespace SimTK;
+
+    Model model(modelFile);
+    model.initSystem();
+    const MultibodySystem* system = &model.getMultibodySystem();
+
+    const GeometryPath& firstPath =
+        *model.getComponentList<GeometryPath>().begin();
+    const string pathName = firstPath.getAbsolutePathName();
+    const string pointName =
+        firstPath.getPathPointSet()[0].getAbsolutePathName();
+    const double length0 = model.getComponent<GeometryPath>(pathName)
+        .getLength(model.getWorkingState());
+
+    // Move the first point of the path.
+    PathPoint& point = model.updComponent<PathPoint>(pointName);
+    point.set_location(point.get_location() + Vec3(0.01, -0.02, 0.005));
+    State& state = model.initSystem();
+    ASSERT(&model.getMultibodySystem() == system, __FILE__, __LINE__,
+        "testFinalizeChangesInSystem: expected the System to be kept.");
+    ASSERT(model.getInitSystemTimes().addToSystem == 0, __FILE__, __LINE__,
+        "testFinalizeChangesInSystem: expected no components to be added to "
+        "the System.");
+    const double length =
+        model.getComponent<GeometryPath>(pathName).getLength(state);
+    ASSERT(std::abs(length - length0) > 1e-6, __FILE__, __LINE__,
+        "testFinalizeChangesInSystem: expected the path length to change.");
+
+    // The same path as that of a Model built anew.
+    Model copy(model);
+    State& copyState = copy.initSystem();
+    ASSERT_EQUAL(copy.getComponent<GeometryPath>(pathName)
+        .getLength(copyState), length, 1e-10, __FILE__, __LINE__,
+        "testFinalizeChangesInSystem: the path differs from that of a new "
+        "System.");
+
+    // Without edits, or with edits to components that do not allow it, a
+    // new System is built.
+    model.initSystem();
+    ASSERT(model.getInitSystemTimes().addToSystem > 0, __FILE__, __LINE__,
+        "testFinalizeChangesInSystem: expected a new System without edits.");
+    Body& body = model.updComponent<Body>(
+        model.getComponentList<Body>().begin()->getAbsolutePathName());
+    body.set_mass(2*body.get_mass());
+    model.initSystem();
+    ASSERT(model.getInitSystemTimes().addToSystem > 0, __FILE__, __LINE__,
+        "testFinalizeChangesInSystem: expected a new System after editing "
+        "a Body.");
+}
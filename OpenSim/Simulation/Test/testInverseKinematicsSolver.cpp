@@ -27,10 +27,15 @@
 //=============================================================================
 #include <OpenSim/Simulation/osimSimulation.h>
 #include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/GaussNewtonIKSolver.h>
 #include <OpenSim/Simulation/MarkersReference.h>
+#include <OpenSim/Simulation/StreamingMarkersReference.h>
+#include <OpenSim/Simulation/OrientationsReference.h>
+#include <OpenSim/Simulation/StreamingOrientationsReference.h>
 #include <OpenSim/Common/MarkerData.h>
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <random>
 
 using namespace OpenSim;
@@ -64,6 +69,18 @@ void testUpdateMarkerWeights();
 // Verify that the track() solution is also effected by updating marker
 // weights and marker error is being reduced as its weighting increases.
 void testTrackWithUpdateMarkerWeights();
+// Verify that markers are matched by index to the model's markers when the
+// marker data has markers that the model does not, and missing (NaN) values.
+void testMarkersNotInModel();
+// Verify that track() follows marker frames pushed to a
+// StreamingMarkersReference, and reports the time it took.
+void testTrackStreamingMarkers();
+// Verify that the solver tracks the orientation of a frame without markers,
+// from a table, in parallel chunks, and streamed.
+void testTrackOrientations();
+// Verify that the GaussNewtonIKSolver finds the solutions of the
+// InverseKinematicsSolver on a double pendulum, and rejects constraints.
+void testGaussNewtonSolver();
 
 int main()
 {
@@ -85,6 +102,26 @@ int main()
         cout << e.what() << endl;
         failures.push_back("testTrackWithUpdateMarkerWeights");
     }
+    try { testMarkersNotInModel(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testMarkersNotInModel");
+    }
+    try { testTrackStreamingMarkers(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testTrackStreamingMarkers");
+    }
+    try { testTrackOrientations(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testTrackOrientations");
+    }
+    try { testGaussNewtonSolver(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testGaussNewtonSolver");
+    }
 
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
@@ -456,6 +493,294 @@ void testTrackWithUpdateMarkerWeights()
     }
 }
 
+void testMarkersNotInModel()
+{
+    cout << "\ntestInverseKinematicsSolver::testMarkersNotInModel()" << endl;
+
+    std::unique_ptr<Model> pendulum{ constructPendulumWithMarkers() };
+    Coordinate& coord = pendulum->getCoordinateSet()[0];
+
+    SimTK::State state = pendulum->initSystem();
+    coord.setValue(state, 0.123456789);
+
+    StatesTrajectory states;
+    states.append(state);
+    auto modelMarkerData =
+        generateMarkerDataFromModelAndStates(*pendulum, states, 0.02);
+
+    // Prepend a marker, with no data, that the model does not have.
+    const auto& modelLabels = modelMarkerData.getColumnLabels();
+    vector<std::string> labels{ "X" };
+    labels.insert(labels.end(), modelLabels.begin(), modelLabels.end());
+    TimeSeriesTable_<SimTK::Vec3> markerData;
+    markerData.setColumnLabels(labels);
+    SimTK::RowVector_<SimTK::Vec3> row(int(labels.size()), SimTK::Vec3(SimTK::NaN));
+    for (int j = 1; j < row.size(); ++j)
+        row[j] = modelMarkerData.getRowAtIndex(0)[j-1];
+    markerData.appendRow(0.0, row);
+
+    MarkersReference markersRef(markerData);
+    SimTK::Array_<CoordinateReference> coordRefs;
+    coord.setValue(state, 0.0);
+    InverseKinematicsSolver ikSolver(*pendulum, markersRef, coordRefs);
+    ikSolver.setAccuracy(1.0e-8);
+    ikSolver.assemble(state);
+
+    SimTK::Array_<double> nominalMarkerErrors;
+    ikSolver.computeCurrentMarkerErrors(nominalMarkerErrors);
+    SimTK_ASSERT_ALWAYS(nominalMarkerErrors.size() == modelLabels.size(),
+        "Expected one marker error per marker in the model.");
+    for (unsigned int i = 0; i < nominalMarkerErrors.size(); ++i) {
+        const std::string name = ikSolver.getMarkerNameForIndex(i);
+        SimTK_ASSERT_ALWAYS(
+            ikSolver.computeCurrentMarkerError(name) == nominalMarkerErrors[i],
+            "Marker error by name does not match marker error by index.");
+    }
+
+    // "mL" is the fourth marker of the reference but the third of the model.
+    ikSolver.updateMarkerWeight("mL", 20.0);
+    coord.setValue(state, 0.0);
+    ikSolver.assemble(state);
+    SimTK_ASSERT_ALWAYS(ikSolver.getMarkerNameForIndex(2) == "mL",
+        "Expected 'mL' to be the third marker of the model.");
+    SimTK_ASSERT_ALWAYS(
+        ikSolver.computeCurrentMarkerError("mL") < nominalMarkerErrors[2],
+        "InverseKinematicsSolver failed to lower 'left' marker error when "
+        "marker weight was increased.");
+}
+
+void testTrackStreamingMarkers()
+{
+    cout << "\ntestInverseKinematicsSolver::testTrackStreamingMarkers()"
+        << endl;
+
+    std::unique_ptr<Model> pendulum{ constructPendulumWithMarkers() };
+    Coordinate& coord = pendulum->getCoordinateSet()[0];
+
+    SimTK::State state = pendulum->initSystem();
+
+    StatesTrajectory states;
+    double dt = 0.01;
+    for (int i = 0; i < 51; ++i) {
+        state.updTime() = i*dt;
+        coord.setValue(state, SimTK::Pi/4*std::sin(SimTK::Pi*i*dt));
+        states.append(state);
+    }
+    auto markerData =
+        generateMarkerDataFromModelAndStates(*pendulum, states);
+    const auto& labels = markerData.getColumnLabels();
+
+    StreamingMarkersReference markersRef(
+        SimTK::Array_<std::string>(labels.begin(), labels.end()), nullptr, 4);
+    SimTK::Array_<CoordinateReference> coordRefs;
+    InverseKinematicsSolver ikSolver(*pendulum, markersRef, coordRefs);
+    ikSolver.setAccuracy(1e-6);
+    ikSolver.setTrackDeadline(1.0);
+
+    for (size_t i = 0; i < markerData.getNumRows(); ++i) {
+        markersRef.putFrame(markerData.getIndependentColumn()[i],
+                            markerData.getRowAtIndex(i));
+        state.updTime() = markersRef.getLatestTime();
+        if (i == 0)
+            ikSolver.assemble(state);
+        else
+            ikSolver.track(state);
+
+        ASSERT_EQUAL(coord.getValue(states[i]), coord.getValue(state), 1e-4,
+            __FILE__, __LINE__,
+            "Streaming IK did not follow the pushed marker frames.");
+    }
+    SimTK_ASSERT_ALWAYS(markersRef.getNumBufferedFrames() == 4,
+        "Expected the buffer to hold its last 4 frames.");
+    cout << "Last track() took " << ikSolver.getLastTrackDuration()
+        << "s, with " << ikSolver.getNumDeadlineMisses()
+        << " deadline misses." << endl;
+
+    // Frames must move forward in time.
+    ASSERT_THROW(OpenSim::Exception,
+        markersRef.putFrame(0.0, markerData.getRowAtIndex(0)));
+}
+
+void testTrackOrientations()
+{
+    cout << "\ntestInverseKinematicsSolver::testTrackOrientations()" << endl;
+
+    std::unique_ptr<Model> pendulum{ constructPendulumWithMarkers() };
+    Coordinate& coord = pendulum->getCoordinateSet()[0];
+    const Body& ball = pendulum->getBodySet().get("ball");
+
+    SimTK::State state = pendulum->initSystem();
+
+    // The orientation of the ball, as an IMU on it would measure it.
+    StatesTrajectory states;
+    TimeSeriesTable_<SimTK::Quaternion> orientationData;
+    orientationData.setColumnLabels({ "ball" });
+    double dt = 0.01;
+    for (int i = 0; i < 51; ++i) {
+        state.updTime() = i*dt;
+        coord.setValue(state, SimTK::Pi/4*std::sin(SimTK::Pi*i*dt));
+        states.append(state);
+        pendulum->realizePosition(state);
+        orientationData.appendRow(state.getTime(), { ball.getTransformInGround(
+            state).R().convertRotationToQuaternion() });
+    }
+
+    MarkersReference noMarkers;
+    OrientationsReference orientationsRef(orientationData);
+    SimTK::Array_<CoordinateReference> coordRefs;
+    InverseKinematicsSolver ikSolver(*pendulum, noMarkers, orientationsRef,
+                                     coordRefs);
+    ikSolver.setAccuracy(1e-6);
+    state.updTime() = 0;
+    ikSolver.assemble(state);
+    SimTK::Array_<double> errors;
+    for (size_t i = 0; i < states.getSize(); ++i) {
+        state.updTime() = orientationData.getIndependentColumn()[i];
+        ikSolver.track(state);
+        ASSERT_EQUAL(coord.getValue(states[i]), coord.getValue(state), 1e-4,
+            __FILE__, __LINE__, "IK did not track the orientation.");
+        ikSolver.computeCurrentOrientationErrors(errors);
+        ASSERT(errors.size() == 1 && errors[0] < 1e-4);
+    }
+
+    // The same solution, in parallel chunks.
+    TimeSeriesTable solution = InverseKinematicsSolver::solve(*pendulum,
+        noMarkers, orientationsRef, coordRefs, orientationsRef.getTimes(),
+        SimTK::Infinity, 1e-6, 3);
+    ASSERT(solution.getNumRows() == states.getSize());
+    ASSERT(solution.getColumnLabels()[0] == coord.getName());
+    for (size_t i = 0; i < states.getSize(); ++i) {
+        ASSERT_EQUAL(coord.getValue(states[i]),
+            solution.getRowAtIndex(i)[0], 1e-4, __FILE__, __LINE__,
+            "Parallel IK did not track the orientation.");
+    }
+
+    // Streamed, one frame at a time.
+    StreamingOrientationsReference imuRef(
+        SimTK::Array_<std::string>(1, "ball"), nullptr, 4);
+    InverseKinematicsSolver streamingSolver(*pendulum, noMarkers, imuRef,
+                                            coordRefs);
+    streamingSolver.setAccuracy(1e-6);
+    for (size_t i = 0; i < orientationData.getNumRows(); ++i) {
+        imuRef.putFrame(orientationData.getIndependentColumn()[i],
+                        orientationData.getRowAtIndex(i));
+        state.updTime() = imuRef.getLatestTime();
+        if (i == 0)
+            streamingSolver.assemble(state);
+        else
+            streamingSolver.track(state);
+        ASSERT_EQUAL(coord.getValue(states[i]), coord.getValue(state), 1e-4,
+            __FILE__, __LINE__, "Streaming IK did not track the orientation.");
+    }
+
+    // Orientations must correspond to frames of the model.
+    TimeSeriesTable_<SimTK::Quaternion> unknownData(orientationData);
+    unknownData.setColumnLabels({ "not_a_frame" });
+    OrientationsReference notInModel(unknownData);
+    ASSERT_THROW(OpenSim::Exception,
+        InverseKinematicsSolver solver(*pendulum, noMarkers, notInModel,
+                                       coordRefs));
+}
+
+void testGaussNewtonSolver()
+{
+    cout << "\ntestInverseKinematicsSolver::testGaussNewtonSolver()" << endl;
+
+    // Hang a second link, with its own markers, from the pendulum.
+    std::unique_ptr<Model> model{ constructPendulumWithMarkers() };
+    Body* link = new Body("link", 1.0, SimTK::Vec3(0),
+                          SimTK::Inertia::sphere(0.05));
+    model->addBody(link);
+    PinJoint* elbow = new PinJoint("elbow",
+        model->getBodySet().get("ball"), SimTK::Vec3(0), SimTK::Vec3(0),
+        *link, SimTK::Vec3(0, 0.5, 0), SimTK::Vec3(0));
+    elbow->updCoordinate().setName("phi");
+    model->addJoint(elbow);
+    Marker* l0 = new Marker();
+    l0->setName("l0");
+    l0->setParentFrame(*link);
+    l0->set_location(SimTK::Vec3(0));
+    model->addMarker(l0);
+    Marker* lR = new Marker();
+    lR->setName("lR");
+    lR->setParentFrame(*link);
+    lR->set_location(SimTK::Vec3(0.05, 0.1, 0));
+    model->addMarker(lR);
+
+    SimTK::State state = model->initSystem();
+    const Coordinate& theta = model->getCoordinateSet().get("theta");
+    const Coordinate& phi = model->getCoordinateSet().get("phi");
+
+    const double dt = 0.02;
+    StatesTrajectory states;
+    for (int i = 0; i < 51; ++i) {
+        state.updTime() = i*dt;
+        theta.setValue(state, 0.5*sin(SimTK::Pi*i*dt));
+        phi.setValue(state, 0.8*cos(SimTK::Pi*i*dt));
+        states.append(state);
+    }
+    MarkersReference markersRef(
+        generateMarkerDataFromModelAndStates(*model, states, 0.005));
+    markersRef.setDefaultWeight(1.0);
+
+    SimTK::Array_<CoordinateReference> coordRefs;
+    Constant phiRefFunc(0.5);
+    CoordinateReference phiRef("phi", phiRefFunc);
+    phiRef.setWeight(1e-3);
+    coordRefs.push_back(phiRef);
+
+    SimTK::State ikState = model->getWorkingState();
+    SimTK::State gnState = model->getWorkingState();
+    InverseKinematicsSolver ikSolver(*model, markersRef, coordRefs);
+    ikSolver.setAccuracy(1e-9);
+    GaussNewtonIKSolver gnSolver(*model, markersRef, coordRefs);
+    gnSolver.setAccuracy(1e-9);
+    ASSERT(gnSolver.getNumMarkers() == 5);
+
+    // track() needs a solution to start from.
+    ASSERT_THROW(Exception, gnSolver.track(gnState));
+
+    ikState.updTime() = gnState.updTime() = 0;
+    ikSolver.assemble(ikState);
+    gnSolver.assemble(gnState);
+    SimTK::Array_<double> ikErrors, gnErrors;
+    for (int i = 0; i < 51; ++i) {
+        ikState.updTime() = gnState.updTime() = i*dt;
+        ikSolver.track(ikState);
+        gnSolver.track(gnState);
+        ASSERT_EQUAL(theta.getValue(ikState), theta.getValue(gnState), 1e-6,
+            __FILE__, __LINE__, "theta differs from InverseKinematicsSolver.");
+        ASSERT_EQUAL(phi.getValue(ikState), phi.getValue(gnState), 1e-6,
+            __FILE__, __LINE__, "phi differs from InverseKinematicsSolver.");
+        ikSolver.computeCurrentSquaredMarkerErrors(ikErrors);
+        gnSolver.computeCurrentSquaredMarkerErrors(gnErrors);
+        ASSERT(gnErrors.size() == ikErrors.size());
+        for (unsigned j = 0; j < gnErrors.size(); ++j) {
+            ASSERT(gnSolver.getMarkerNameForIndex(j) ==
+                   ikSolver.getMarkerNameForIndex(j));
+            ASSERT_EQUAL(ikErrors[j], gnErrors[j], 1e-8, __FILE__, __LINE__,
+                "Marker errors differ from InverseKinematicsSolver.");
+        }
+    }
+    cout << "GaussNewtonIKSolver took " << gnSolver.getTotalNumIterations()
+         << " iterations." << endl;
+
+    // Weighting a marker more lowers its error at the next frame.
+    const double nominalError = gnErrors[4];
+    gnSolver.updateMarkerWeight("lR", 100.0);
+    gnSolver.track(gnState);
+    gnSolver.computeCurrentSquaredMarkerErrors(gnErrors);
+    ASSERT(gnErrors[4] < nominalError);
+
+    // Constraints are left to the InverseKinematicsSolver.
+    model->addConstraint(new WeldConstraint("weld",
+        model->getGround(), SimTK::Transform(SimTK::Vec3(0, 0.5, 0)),
+        *link, SimTK::Transform()));
+    model->initSystem();
+    ASSERT_THROW(Exception,
+        GaussNewtonIKSolver constrained(*model, markersRef, coordRefs));
+}
+
 Model* constructPendulumWithMarkers()
 {
     Model* pendulum = new Model();
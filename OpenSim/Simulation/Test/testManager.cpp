@@ -27,16 +27,82 @@ Manager Tests:
 1. Calculate the location, velocity, and acceleration of a Station with the same
 Manager many times. Previously, this would fail as repeated callls of 
 TimeStepper::initialize() would trigger cache validation improperly.
+2. Integrate a pendulum with each of the integrator methods of the Manager.
+3. Localize the events of ConditionEvents, and end a simulation at one.
 
 //=============================================================================*/
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/FreeJoint.h>
 #include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
+#include <OpenSim/Simulation/Model/ConditionEvent.h>
+#include <OpenSim/Simulation/Model/FunctionThresholdCondition.h>
+#include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Actuators/SpringGeneralizedForce.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Simulation/Control/LiveController.h>
+#include <OpenSim/Common/IterationCounter.h>
+#include <OpenSim/Common/LiveValues.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
 using namespace OpenSim;
 using namespace std;
+
+// A force that applies no force, but counts 2 iterations of a solver each
+// time it is computed.
+class IteratingForce : public Force {
+OpenSim_DECLARE_CONCRETE_OBJECT(IteratingForce, Force);
+public:
+    OpenSim_DECLARE_OUTPUT(solver_iterations, double, getSolverIterations,
+                           SimTK::Stage::Model);
+    double getSolverIterations(const SimTK::State&) const
+    {   return (double)_iterations.get(); }
+protected:
+    void computeForce(const SimTK::State&,
+                      SimTK::Vector_<SimTK::SpatialVec>&,
+                      SimTK::Vector&) const override
+    {   _iterations.add(2); }
+private:
+    IterationCounter _iterations;
+};
+
+// True while the first coordinate is above a height; its witness is the
+// height above it.
+class HeightCondition : public Condition {
+OpenSim_DECLARE_CONCRETE_OBJECT(HeightCondition, Condition);
+public:
+    HeightCondition(double height = 0) : _height(height) {}
+    bool calcCondition(const SimTK::State& s) const override
+    {   return calcWitness(s) > 0; }
+    double calcWitness(const SimTK::State& s) const override
+    {   return s.getQ()[0] - _height; }
+    SimTK::Stage getWitnessStage() const override
+    {   return SimTK::Stage::Position; }
+private:
+    double _height;
+};
+
 void testStationCalcWithManager();
+void testIntegratorMethods();
+void testOutputQueue();
+void testOutputInterval();
+void testCheckpoint();
+void testReset();
+void testTimeArrayLookups();
+void testRealTime();
+void testComponentProfiler();
+void testIntegrationStatistics();
+void testConditionEvents();
+void testStateRecording();
 
 int main()
 {
@@ -48,6 +114,72 @@ int main()
         failures.push_back("testStationCalcWithManager");
     }
 
+    try { testIntegratorMethods(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testIntegratorMethods");
+    }
+
+    try { testOutputQueue(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testOutputQueue");
+    }
+
+    try { testOutputInterval(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testOutputInterval");
+    }
+
+    try { testCheckpoint(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testCheckpoint");
+    }
+
+    try { testReset(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testReset");
+    }
+
+    try { testTimeArrayLookups(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testTimeArrayLookups");
+    }
+
+    try { testRealTime(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testRealTime");
+    }
+
+    try { testComponentProfiler(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testComponentProfiler");
+    }
+
+    try { testIntegrationStatistics(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testIntegrationStatistics");
+    }
+
+    try { testConditionEvents(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testConditionEvents");
+    }
+
+    try { testStateRecording(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testStateRecording");
+    }
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -137,3 +269,687 @@ void testStationCalcWithManager()
         SimTK_TEST_EQ(a, ao);
     }
 }
+
+void testIntegratorMethods()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testIntegratorMethods" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    const Coordinate& coord = pin->getCoordinate(PinJoint::Coord::RotationZ);
+
+    SimTK::State& initState = pendulum.initSystem();
+    coord.setValue(initState, 0.5);
+
+    auto simulate = [&](Manager::IntegratorMethod method) {
+        SimTK::State state = initState;
+        Manager manager(pendulum);
+        manager.setIntegratorMethod(method);
+        manager.setIntegratorAccuracy(1e-7);
+        manager.setPerformAnalyses(false);
+        manager.setWriteToStorage(false);
+        manager.setInitialTime(0);
+        manager.setFinalTime(0.5);
+        manager.integrate(state);
+        return coord.getValue(state);
+    };
+
+    const double expected = simulate(Manager::IntegratorMethod::RungeKuttaMerson);
+    ASSERT(std::abs(expected - 0.5) > 0.01, __FILE__, __LINE__,
+           "Expected the pendulum to swing.");
+    for (auto method : {Manager::IntegratorMethod::ExplicitEuler,
+                        Manager::IntegratorMethod::RungeKutta2,
+                        Manager::IntegratorMethod::RungeKutta3,
+                        Manager::IntegratorMethod::RungeKuttaFeldberg,
+                        Manager::IntegratorMethod::SemiExplicitEuler2,
+                        Manager::IntegratorMethod::Verlet,
+                        Manager::IntegratorMethod::CPodes}) {
+        ASSERT_EQUAL(expected, simulate(method), 1e-4, __FILE__, __LINE__,
+            "Integrator method " + std::to_string(int(method)) +
+            " does not match the Runge-Kutta-Merson solution.");
+    }
+
+    // The integrator cannot change once integration has begun.
+    SimTK::State state = initState;
+    Manager manager(pendulum);
+    manager.setWriteToStorage(false);
+    manager.setFinalTime(0.01);
+    manager.integrate(state);
+    ASSERT_THROW(OpenSim::Exception,
+        manager.setIntegratorMethod(Manager::IntegratorMethod::CPodes));
+}
+
+void testOutputQueue()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testOutputQueue" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+
+    SimTK::State& initState = pendulum.initSystem();
+    pin->getCoordinate(PinJoint::Coord::RotationZ).setValue(initState, 0.5);
+
+    auto simulate = [&](int queueSize, bool specifiedDT) {
+        SimTK::State state = initState;
+        Manager manager(pendulum);
+        manager.setOutputQueueSize(queueSize);
+        if (specifiedDT) {
+            manager.setUseSpecifiedDT(true);
+            manager.setDTArray(SimTK::Vector(100, 0.005));
+        }
+        manager.setInitialTime(0);
+        manager.setFinalTime(0.5);
+        manager.integrate(state);
+        return manager.getStatesTable();
+    };
+
+    // The queued states are stored as if they were stored at each step.
+    for (bool specifiedDT : {false, true}) {
+        const TimeSeriesTable expected = simulate(0, specifiedDT);
+        for (int queueSize : {1, 3}) {
+            const TimeSeriesTable queued = simulate(queueSize, specifiedDT);
+            ASSERT(queued.getNumRows() == expected.getNumRows(),
+                __FILE__, __LINE__,
+                "Expected the queued states to all be stored.");
+            for (size_t i = 0; i < expected.getNumRows(); ++i) {
+                ASSERT(queued.getIndependentColumn()[i] ==
+                       expected.getIndependentColumn()[i],
+                       __FILE__, __LINE__,
+                       "Expected the queued states to be stored in order.");
+                ASSERT_EQUAL(expected.getRowAtIndex(i)[0],
+                             queued.getRowAtIndex(i)[0],
+                             SimTK::Eps, __FILE__, __LINE__,
+                             "Expected the same states from queued output.");
+            }
+        }
+    }
+
+    Manager manager(pendulum);
+    ASSERT_THROW(OpenSim::Exception, manager.setOutputQueueSize(-1));
+}
+
+void testOutputInterval()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testOutputInterval" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    const Coordinate& coord = pin->getCoordinate(PinJoint::Coord::RotationZ);
+
+    SimTK::State& initState = pendulum.initSystem();
+    coord.setValue(initState, 0.5);
+
+    auto simulate = [&](double interval, TimeSeriesTable& table) {
+        SimTK::State state = initState;
+        Manager manager(pendulum);
+        manager.setIntegratorAccuracy(1e-7);
+        manager.setOutputInterval(interval);
+        manager.setInitialTime(0.1);
+        manager.setFinalTime(0.6);
+        state.setTime(0.1);
+        manager.integrate(state);
+        table = manager.getStatesTable();
+        return coord.getValue(state);
+    };
+
+    TimeSeriesTable steps, regular;
+    const double expected = simulate(0, steps);
+    const double interpolated = simulate(0.01, regular);
+    ASSERT_EQUAL(expected, interpolated, 1e-6, __FILE__, __LINE__,
+        "Expected interpolated output not to change the integration.");
+
+    // The initial state, then the states at each multiple of the interval.
+    const auto& times = regular.getIndependentColumn();
+    ASSERT(times.size() == 51, __FILE__, __LINE__,
+        "Expected 51 states, got " + std::to_string(times.size()) + ".");
+    for (size_t i = 0; i < times.size(); ++i) {
+        ASSERT_EQUAL(0.1 + 0.01*i, times[i], 1e-12, __FILE__, __LINE__,
+            "Expected the states at the multiples of the interval.");
+    }
+
+    Manager manager(pendulum);
+    ASSERT_THROW(OpenSim::Exception, manager.setOutputInterval(-1));
+}
+
+void testCheckpoint()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testCheckpoint" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    const Coordinate& coord = pin->getCoordinate(PinJoint::Coord::RotationZ);
+
+    SimTK::State& initState = pendulum.initSystem();
+    coord.setValue(initState, 0.5);
+
+    const std::string checkpointFile = "testManager_checkpoint.bin";
+    std::remove(checkpointFile.c_str());
+
+    // Integrate all at once, writing checkpoints.
+    SimTK::State state = initState;
+    Manager manager(pendulum);
+    manager.setIntegratorAccuracy(1e-9);
+    manager.setOutputInterval(0.01);
+    manager.setCheckpointFile(checkpointFile, 0.25);
+    manager.setInitialTime(0);
+    manager.setFinalTime(1.0);
+    manager.integrate(state);
+    const double expected = coord.getValue(state);
+    const int expectedRows = manager.getStateStorage().getSize();
+
+    // Resume from the last checkpoint, as if the integration had stopped
+    // after it.
+    SimTK::State resumed = pendulum.initSystem();
+    Manager resumedManager(pendulum);
+    resumedManager.setIntegratorAccuracy(1e-9);
+    resumedManager.setOutputInterval(0.01);
+    resumedManager.setInitialTime(0);
+    resumedManager.setFinalTime(1.0);
+    resumedManager.integrateFromCheckpoint(resumed, checkpointFile);
+    ASSERT_EQUAL(expected, coord.getValue(resumed), 1e-6, __FILE__, __LINE__,
+        "Expected the resumed integration to reach the same state.");
+
+    // The output continues at the same times, starting at the checkpoint.
+    const auto& times = resumedManager.getStatesTable().getIndependentColumn();
+    ASSERT(times.front() >= 0.75 && times.back() == 1.0, __FILE__, __LINE__,
+        "Expected the output from the last checkpoint to the final time.");
+    ASSERT(times.size() < (size_t)expectedRows, __FILE__, __LINE__,
+        "Expected only the output after the checkpoint.");
+    for (size_t i = 1; i < times.size(); ++i) {
+        ASSERT_EQUAL(0.01*std::round(100*times[i]), times[i], 1e-12,
+            __FILE__, __LINE__,
+            "Expected the states at the multiples of the output interval.");
+    }
+
+    // A checkpoint is rejected by a model with other states.
+    Model other;
+    auto body = new Body("body", 1.0, Vec3(0), SimTK::Inertia(1));
+    other.addBody(body);
+    other.addJoint(new FreeJoint("free", other.getGround(), Vec3(0), Vec3(0),
+        *body, Vec3(0), Vec3(0)));
+    SimTK::State otherState = other.initSystem();
+    Manager otherManager(other);
+    otherManager.setFinalTime(1.0);
+    ASSERT_THROW(OpenSim::Exception,
+        otherManager.integrateFromCheckpoint(otherState, checkpointFile));
+    ASSERT_THROW(OpenSim::Exception, manager.setCheckpointFile("", 1));
+}
+
+void testReset()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testReset" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    const Coordinate& angle = pin->getCoordinate(PinJoint::Coord::RotationZ);
+
+    SimTK::State& initState = pendulum.initSystem();
+
+    // One Manager reused for several runs, each from its own initial angle.
+    Manager reused(pendulum);
+    reused.setInitialTime(0);
+    reused.setFinalTime(0.5);
+    for (double initialAngle : {0.5, -0.2, 1.0}) {
+        SimTK::State state = initState;
+        angle.setValue(state, initialAngle);
+        reused.reset();
+        reused.integrate(state);
+        const TimeSeriesTable found = reused.getStatesTable();
+
+        SimTK::State freshState = initState;
+        angle.setValue(freshState, initialAngle);
+        Manager fresh(pendulum);
+        fresh.setInitialTime(0);
+        fresh.setFinalTime(0.5);
+        fresh.integrate(freshState);
+        const TimeSeriesTable expected = fresh.getStatesTable();
+
+        ASSERT(found.getNumRows() == expected.getNumRows(),
+            __FILE__, __LINE__,
+            "Expected a reset Manager to store only the states of its run.");
+        ASSERT_EQUAL(initialAngle, found.getRowAtIndex(0)[0], SimTK::Eps,
+            __FILE__, __LINE__,
+            "Expected a reset Manager to start from the given state.");
+        for (size_t i = 0; i < expected.getNumRows(); ++i) {
+            ASSERT_EQUAL(expected.getIndependentColumn()[i],
+                         found.getIndependentColumn()[i], 1e-10,
+                         __FILE__, __LINE__,
+                         "Expected the steps of a new Manager.");
+            ASSERT_EQUAL(expected.getRowAtIndex(i)[0],
+                         found.getRowAtIndex(i)[0], 1e-10,
+                         __FILE__, __LINE__,
+                         "Expected the states of a new Manager.");
+        }
+        ASSERT_EQUAL(angle.getValue(freshState), angle.getValue(state), 1e-10,
+            __FILE__, __LINE__, "Expected the final state of a new Manager.");
+    }
+}
+
+void testTimeArrayLookups()
+{
+    cout << "Running testTimeArrayLookups" << endl;
+
+    Manager manager;
+    const int n = 1000;
+    SimTK::Vector dt(n);
+    for (int i = 0; i < n; ++i) dt[i] = 0.001*(1 + i%7);
+    manager.setDTArray(dt, 0.2);
+    const Array<double>& times = manager.getTimeArray();
+
+    // Increasing times, as in an integration, then times in any order; all
+    // must give the steps a binary search gives.
+    std::vector<double> queries;
+    for (int i = 0; i <= n; ++i) {
+        queries.push_back(times[i]);
+        if (i < n) queries.push_back(times[i] + 0.3*dt[i]);
+    }
+    queries.push_back(0.1);
+    queries.push_back(times.getLast() + 1);
+    for (int i = 0; i < 200; ++i) queries.push_back(times[(i*389)%n] + 1e-4);
+
+    for (double time : queries) {
+        const int expected = times.searchBinary(time);
+        ASSERT(manager.getTimeArrayStep(time) == expected, __FILE__,
+            __LINE__, "Expected step " + std::to_string(expected) +
+            " for time " + std::to_string(time) + ".");
+        if (expected >= 0 && expected < n) {
+            ASSERT_EQUAL(times[expected + 1],
+                manager.getNextTimeArrayTime(time), 0.0, __FILE__, __LINE__,
+                "Expected the next time after " + std::to_string(time) + ".");
+        }
+    }
+}
+
+void testRealTime()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testRealTime" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    auto motor = new CoordinateActuator(
+        pin->getCoordinate(PinJoint::Coord::RotationZ).getName());
+    motor->setName("motor");
+    motor->setOptimalForce(1.0);
+    pendulum.addForce(motor);
+    auto live = new LiveController();
+    live->setName("live");
+    live->addActuator(*motor);
+    pendulum.addController(live);
+
+    SimTK::State& initState = pendulum.initSystem();
+
+    // The controls are those written last, and none before the first write.
+    {
+        SimTK::State s = initState;
+        pendulum.realizeVelocity(s);
+        ASSERT_EQUAL(0.0, pendulum.getControls(s)[0], 0.0);
+        live->writeControls(0, SimTK::Vector(1, 2.5));
+        SimTK::State s2 = initState;
+        pendulum.realizeVelocity(s2);
+        ASSERT_EQUAL(2.5, pendulum.getControls(s2)[0], 0.0);
+        ASSERT_THROW(OpenSim::Exception,
+            live->writeControls(0, SimTK::Vector(2, 0.0)));
+    }
+
+    Manager manager(pendulum);
+    manager.setIntegratorMethod(Manager::IntegratorMethod::SemiExplicitEuler2);
+    ASSERT_THROW(OpenSim::Exception, manager.setRealTimeStepSize(-0.01));
+    ASSERT_THROW(OpenSim::Exception, manager.getLiveOutputs());
+    manager.setRealTimeStepSize(0.01);
+    manager.setInitialTime(0);
+    manager.setFinalTime(0.2);
+
+    // Another thread writes the controls and reads the states while the
+    // integration runs.
+    std::atomic<bool> done(false);
+    int numReads = 0;
+    std::thread hardware([&] {
+        const LiveValues& sensors = manager.getLiveOutputs();
+        double time;
+        SimTK::Vector values;
+        for (int i = 0; !done; ++i) {
+            live->writeControls(0.001*i, SimTK::Vector(1, std::sin(0.01*i)));
+            if (sensors.read(time, values)) ++numReads;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    SimTK::State state = initState;
+    const auto start = std::chrono::steady_clock::now();
+    manager.integrate(state);
+    const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    done = true;
+    hardware.join();
+
+    // The steps keep pace with the wall clock.
+    ASSERT(elapsed >= 0.19, __FILE__, __LINE__,
+        "Expected the integration to take 0.2 s, but it took " +
+        std::to_string(elapsed) + " s.");
+    const auto& durations = manager.getRealTimeStepDurations();
+    ASSERT(durations.size() == 20, __FILE__, __LINE__,
+        "Expected 20 steps, got " + std::to_string(durations.size()) + ".");
+    ASSERT(manager.getNumRealTimeOverruns() >= 0 &&
+           manager.getNumRealTimeOverruns() <= 20);
+    for (double duration : durations) ASSERT(duration >= 0);
+
+    // The live outputs hold the last step.
+    double time;
+    SimTK::Vector values;
+    ASSERT(manager.getLiveOutputs().read(time, values));
+    ASSERT_EQUAL(0.2, time, 1e-12);
+    ASSERT(manager.getLiveOutputs().getNumWrites() == 20);
+    SimTK_TEST_EQ(pendulum.getStateVariableValues(state), values);
+    ASSERT(numReads > 0);
+}
+
+void testComponentProfiler()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testComponentProfiler" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    auto spring = new SpringGeneralizedForce(
+        pin->getCoordinate(PinJoint::Coord::RotationZ).getName());
+    spring->setName("spring");
+    spring->setStiffness(10);
+    pendulum.addForce(spring);
+    SimTK::State& initState = pendulum.initSystem();
+
+    // Nothing is recorded unless profiling is enabled.
+    ComponentProfiler::reset();
+    pendulum.realizeAcceleration(initState);
+    ASSERT(ComponentProfiler::getComponentEntries().empty());
+
+    ComponentProfiler::setEnabled(true);
+    SimTK::State state = initState;
+    state.updQ()[0] = 0.1;
+    pendulum.realizeAcceleration(state);
+    spring->getOutputValue<double>(state, "potential_energy");
+    const auto components = ComponentProfiler::getComponentEntries();
+    const auto found = std::find_if(components.begin(), components.end(),
+        [&](const ComponentProfiler::Entry& entry)
+        {   return entry.path == spring->getAbsolutePathName(); });
+    ASSERT(found != components.end(), __FILE__, __LINE__,
+        "Expected the spring to be profiled.");
+    ASSERT(found->type == "SpringGeneralizedForce");
+    ASSERT(found->calls[ComponentProfiler::ComputeForce] == 1);
+    ASSERT(found->calls[ComponentProfiler::RealizeDynamics] == 1);
+    ASSERT(found->calls[ComponentProfiler::ComputeOutput] == 1);
+    ASSERT(found->getTotalSeconds() >= 0);
+
+    const auto types = ComponentProfiler::getTypeEntries();
+    ASSERT(std::any_of(types.begin(), types.end(),
+        [](const ComponentProfiler::Entry& entry)
+        {   return entry.type == "PinJoint" && entry.path.empty(); }));
+
+    // The report is printed, and the profiler reset, after integrating.
+    Manager manager(pendulum);
+    manager.setInitialTime(0);
+    manager.setFinalTime(0.1);
+    manager.integrate(state);
+    ASSERT(ComponentProfiler::getComponentEntries().empty());
+    ComponentProfiler::setEnabled(false);
+
+    std::ostringstream report;
+    ComponentProfiler::record(*spring, ComponentProfiler::ComputeForce, 0.5);
+    ComponentProfiler::printReport(report);
+    ComponentProfiler::reset();
+    ASSERT(report.str().find("SpringGeneralizedForce") != std::string::npos);
+    ASSERT(report.str().find("computeForce (1 calls)") != std::string::npos);
+}
+
+void testIntegrationStatistics()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testIntegrationStatistics" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    auto counter = new IteratingForce();
+    counter->setName("counter");
+    pendulum.addForce(counter);
+    SimTK::State& initState = pendulum.initSystem();
+    initState.updQ()[0] = 0.5;
+
+    SimTK::State state = initState;
+    Manager manager(pendulum);
+    manager.setInitialTime(0);
+    manager.setFinalTime(1.0);
+    manager.integrate(state);
+
+    const Manager::IntegrationStatistics& stats =
+        manager.getIntegrationStatistics();
+    ASSERT(stats.numStepsTaken > 0);
+    ASSERT(stats.numStepsAttempted >= stats.numStepsTaken);
+    ASSERT(stats.numRealizations > 0);
+    ASSERT((int)stats.numRealizationsOfStage.size() == SimTK::Stage::NValid);
+    ASSERT(stats.numRealizationsOfStage[SimTK::Stage::Dynamics] >=
+           stats.numStepsTaken);
+    const std::string outputPath =
+        counter->getAbsolutePathName() + "|solver_iterations";
+    const auto found = stats.componentIterations.find(outputPath);
+    ASSERT(found != stats.componentIterations.end(), __FILE__, __LINE__,
+        "Expected the iterations of the counter.");
+    ASSERT(found->second > 0);
+    ASSERT(found->second <=
+           counter->getOutputValue<double>(state, "solver_iterations"));
+
+    // The statistics are those of the last integration only.
+    const double totalIterations =
+        counter->getOutputValue<double>(state, "solver_iterations");
+    SimTK::State state2 = initState;
+    Manager manager2(pendulum);
+    manager2.setInitialTime(0);
+    manager2.setFinalTime(0.5);
+    manager2.integrate(state2);
+    const auto& stats2 = manager2.getIntegrationStatistics();
+    ASSERT(stats2.componentIterations.at(outputPath) ==
+           counter->getOutputValue<double>(state2, "solver_iterations") -
+           totalIterations);
+
+    std::ostringstream report;
+    manager2.printIntegrationStatistics(report);
+    ASSERT(report.str().find("steps taken") != std::string::npos);
+    ASSERT(report.str().find(outputPath) != std::string::npos);
+}
+
+void testConditionEvents()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testConditionEvents" << endl;
+
+    // A block falling along a slider, from a height of 1 m.
+    Model model;
+    model.setGravity(Vec3(-9.80665, 0, 0));
+    auto block = new Body("block", 1.0, Vec3(0),
+        SimTK::Inertia::brick(0.05, 0.05, 0.05));
+    model.addBody(block);
+    auto slider = new SliderJoint("slider", model.getGround(), Vec3(0),
+        Vec3(0), *block, Vec3(0), Vec3(0));
+    model.addJoint(slider);
+
+    // An event of time, located without limiting the steps.
+    FunctionThresholdCondition clock;
+    clock.setFunction(LinearFunction(1.0, 0.0));
+    clock.setThreshold(0.3);
+    auto timeEvent = new ConditionEvent(clock);
+    timeEvent->setName("time_event");
+    model.addModelComponent(timeEvent);
+    // The block falls through a height of 0.5 m, which ends the simulation.
+    auto heightEvent = new ConditionEvent(HeightCondition(0.5));
+    heightEvent->setName("height_event");
+    heightEvent->set_trigger_when_true(false);
+    heightEvent->set_terminate_simulation(true);
+    model.addModelComponent(heightEvent);
+
+    SimTK::State& initState = model.initSystem();
+    slider->getCoordinate().setValue(initState, 1.0);
+    SimTK::State state = initState;
+    Manager manager(model);
+    manager.setIntegratorAccuracy(1e-6);
+    manager.setInitialTime(0);
+    manager.setFinalTime(1.0);
+    manager.integrate(state);
+
+    ASSERT(timeEvent->getEventTimes().size() == 1, __FILE__, __LINE__,
+        "Expected one event of time.");
+    ASSERT_EQUAL(0.3, timeEvent->getEventTimes()[0], 1e-5, __FILE__,
+        __LINE__, "The event of time was not localized.");
+    ASSERT(timeEvent->getEventConditions()[0], __FILE__, __LINE__,
+        "Expected the condition of time to become true.");
+
+    const double fallTime = std::sqrt(2*0.5/9.80665);
+    ASSERT(heightEvent->getEventTimes().size() == 1, __FILE__, __LINE__,
+        "Expected one event of height.");
+    ASSERT_EQUAL(fallTime, heightEvent->getEventTimes()[0], 1e-5, __FILE__,
+        __LINE__, "The event of height was not localized.");
+    ASSERT(!heightEvent->getEventConditions()[0], __FILE__, __LINE__,
+        "Expected the condition of height to become false.");
+    ASSERT_EQUAL(fallTime, state.getTime(), 1e-5, __FILE__, __LINE__,
+        "Expected the simulation to end at the event of height.");
+    ASSERT_EQUAL(0.5, slider->getCoordinate().getValue(state), 1e-4,
+        __FILE__, __LINE__, "Expected the block at the height of 0.5 m.");
+}
+
+void testStateRecording()
+{
+    using SimTK::Vec3;
+
+    cout << "Running testStateRecording" << endl;
+
+    Model pendulum;
+    auto rod = new Body("rod", 1.0, Vec3(0, -0.5, 0),
+        SimTK::Inertia::cylinderAlongY(0.025, 0.55));
+    pendulum.addBody(rod);
+    auto pin = new PinJoint("pin", pendulum.getGround(), Vec3(0), Vec3(0),
+        *rod, Vec3(0), Vec3(0));
+    pendulum.addJoint(pin);
+    const Coordinate& coord = pin->getCoordinate(PinJoint::Coord::RotationZ);
+
+    SimTK::State& initState = pendulum.initSystem();
+    coord.setValue(initState, 0.5);
+    const Array<std::string> names = pendulum.getStateVariableNames();
+    std::string valueName;
+    for (int i = 0; i < names.getSize(); ++i) {
+        if (names[i].find(coord.getName() + "/value") != std::string::npos)
+            valueName = names[i];
+    }
+    ASSERT(!valueName.empty(), __FILE__, __LINE__,
+        "Expected a state variable for the value of the coordinate.");
+
+    auto simulate = [&](Manager& manager, double outputInterval,
+                        double finalTime) {
+        SimTK::State state = initState;
+        manager.setIntegratorAccuracy(1e-7);
+        manager.setOutputInterval(outputInterval);
+        manager.setInitialTime(0);
+        manager.setFinalTime(finalTime);
+        manager.integrate(state);
+        return manager.getStatesTable();
+    };
+
+    Manager reference(pendulum);
+    const TimeSeriesTable all = simulate(reference, 0.01, 0.5);
+    ASSERT(all.getNumColumns() == 2, __FILE__, __LINE__,
+        "Expected all state variables to be recorded by default.");
+
+    // The coordinate value at every fifth output step.
+    Manager decimated(pendulum);
+    decimated.setRecordedStateVariables({".*/value"});
+    decimated.setStateRecordingDecimation(5);
+    const TimeSeriesTable some = simulate(decimated, 0.01, 0.5);
+    ASSERT(some.getNumColumns() == 1 &&
+           some.getColumnLabels()[0] == valueName, __FILE__, __LINE__,
+        "Expected the coordinate value only.");
+    ASSERT(some.getNumRows() == 11, __FILE__, __LINE__,
+        "Expected 11 states, got " + std::to_string(some.getNumRows()) + ".");
+    const auto& allValues = all.getDependentColumn(valueName);
+    const auto& someValues = some.getDependentColumn(valueName);
+    for (size_t i = 0; i < some.getNumRows(); ++i) {
+        ASSERT_EQUAL(all.getIndependentColumn()[5*i],
+            some.getIndependentColumn()[i], 1e-12, __FILE__, __LINE__,
+            "Expected the states of every fifth output step.");
+        ASSERT_EQUAL(allValues[int(5*i)], someValues[int(i)], 1e-12,
+            __FILE__, __LINE__, "Expected the same coordinate values.");
+    }
+
+    // At the first step after each 0.1 s, and at the final step.
+    Manager intervals(pendulum);
+    intervals.setRecordedStateVariables({valueName});
+    intervals.setStateRecordingInterval(0.1);
+    const TimeSeriesTable sparse = simulate(intervals, 0, 0.55);
+    const auto& times = sparse.getIndependentColumn();
+    ASSERT(times.size() == 7, __FILE__, __LINE__,
+        "Expected 7 states, got " + std::to_string(times.size()) + ".");
+    for (int k = 1; k <= 5; ++k) {
+        ASSERT(times[k] >= 0.1*k - 1e-9 && times[k] < 0.1*k + 0.05,
+            __FILE__, __LINE__, "Expected the states after " +
+            std::to_string(0.1*k) + " s, got them at " +
+            std::to_string(times[k]) + " s.");
+    }
+    ASSERT_EQUAL(0.55, times.back(), 1e-12, __FILE__, __LINE__,
+        "Expected the final states to be recorded.");
+
+    Manager manager(pendulum);
+    ASSERT_THROW(OpenSim::Exception,
+        manager.setRecordedStateVariables({"no_such_state"}));
+    ASSERT_THROW(OpenSim::Exception, manager.setStateRecordingDecimation(0));
+    ASSERT_THROW(OpenSim::Exception, manager.setStateRecordingInterval(-1));
+}
@@ -0,0 +1,193 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testModelCache.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testModelCache verifies that models loaded through a ModelCache, from memory
+// or from a cache directory, match the models loaded from their files.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+// Verify that loading a file again returns copies of the cached model.
+void testLoadFromMemory(const string& filename);
+// Verify that a file that changed is loaded again.
+void testModifiedFile(const string& filename);
+// Verify that models written to a cache directory can be loaded instead.
+void testLoadFromDirectory(const string& filename);
+// Verify that Tools load their models through the tool cache, if set.
+void testToolCache(const string& filename);
+
+int main()
+{
+    try {
+        // arm26.osim predates the latest file version, so it is updated when
+        // it is loaded.
+        testLoadFromMemory("arm26.osim");
+        testModifiedFile("arm26.osim");
+        testLoadFromDirectory("arm26.osim");
+        testToolCache("arm26.osim");
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void testLoadFromMemory(const string& filename)
+{
+    Model expected(filename);
+
+    ModelCache cache;
+    unique_ptr<Model> first{ cache.loadModel(filename) };
+    unique_ptr<Model> second{ cache.loadModel(filename) };
+    ASSERT(cache.getNumModels() == 1, __FILE__, __LINE__,
+        "Expected the second load to use the cached model.");
+    ASSERT(*first == expected && *second == expected, __FILE__, __LINE__,
+        "Expected the cached model to match the model in the file.");
+    ASSERT(second->getInputFileName() == filename, __FILE__, __LINE__,
+        "Expected the copy to know the file it was loaded from.");
+
+    // The copies are independent of each other.
+    dynamic_cast<Muscle&>(first->updForceSet().get("TRIlong"))
+        .setMaxIsometricForce(1.0);
+    ASSERT(*second == expected, __FILE__, __LINE__,
+        "Modifying one copy modified another.");
+    SimTK::State& s = second->initSystem();
+    ASSERT_EQUAL(
+        dynamic_cast<const Muscle&>(expected.getForceSet().get("TRIlong"))
+            .getMaxIsometricForce(),
+        second->getMuscles().get("TRIlong").getMaxIsometricForce(), SimTK::Eps,
+        __FILE__, __LINE__, "Expected the copy to be usable.");
+    ASSERT(s.getNQ() == second->getNumCoordinates(), __FILE__, __LINE__,
+        "Expected the copy to be usable.");
+
+    cache.clear();
+    ASSERT(cache.getNumModels() == 0, __FILE__, __LINE__,
+        "Expected the cache to be empty.");
+}
+
+void testModifiedFile(const string& filename)
+{
+    const string copyFilename = "testModelCache_" + filename;
+    {
+        ifstream source(filename, ios::binary);
+        ofstream copy(copyFilename, ios::binary);
+        copy << source.rdbuf();
+    }
+
+    ModelCache cache;
+    unique_ptr<Model> original{ cache.loadModel(copyFilename) };
+    const string key = ModelCache::computeKey(copyFilename);
+    ASSERT(key == ModelCache::computeKey(filename), __FILE__, __LINE__,
+        "Expected files with the same contents to have the same key.");
+
+    // Rename the model in the file.
+    {
+        Model renamed(copyFilename);
+        renamed.setName("renamed");
+        renamed.print(copyFilename);
+    }
+    ASSERT(ModelCache::computeKey(copyFilename) != key, __FILE__, __LINE__,
+        "Expected the modified file to have a different key.");
+    unique_ptr<Model> modified{ cache.loadModel(copyFilename) };
+    ASSERT(cache.getNumModels() == 2, __FILE__, __LINE__,
+        "Expected the modified file to be loaded again.");
+    ASSERT(modified->getName() == "renamed" &&
+           original->getName() != "renamed", __FILE__, __LINE__,
+        "Expected the modified model to be loaded from the modified file.");
+}
+
+void testLoadFromDirectory(const string& filename)
+{
+    Model expected(filename);
+
+    ModelCache cache(".");
+    const string cacheFilename = cache.getCacheFileName(filename);
+    std::remove(cacheFilename.c_str());
+    unique_ptr<Model> written{ cache.loadModel(filename) };
+    ASSERT(ifstream(cacheFilename).good(), __FILE__, __LINE__,
+        "Expected the model to be written to the cache directory.");
+    {
+        Model cached(cacheFilename);
+        ASSERT(cached.getDocument()->getDocumentVersion() ==
+               XMLDocument::getLatestVersion(), __FILE__, __LINE__,
+            "Expected the cached file to have the latest version.");
+    }
+
+    // Another cache that uses the same directory reads the written model.
+    ModelCache other(".");
+    unique_ptr<Model> read{ other.loadModel(filename) };
+    ASSERT(*read == expected && *written == expected, __FILE__, __LINE__,
+        "Expected the model from the cache directory to match the model in "
+        "the file.");
+    ASSERT(read->getInputFileName() == filename, __FILE__, __LINE__,
+        "Expected the model to refer to the original file.");
+    read->initSystem();
+}
+
+void testToolCache(const string& filename)
+{
+    Model expected(filename);
+
+    ASSERT(!ModelCache::getToolCache(), __FILE__, __LINE__,
+        "Expected no tool cache by default.");
+    unique_ptr<Model> read{ ModelCache::loadToolModel(filename) };
+    ASSERT(*read == expected, __FILE__, __LINE__,
+        "Expected the model in the file.");
+
+    auto cache = make_shared<ModelCache>();
+    ModelCache::setToolCache(cache);
+    unique_ptr<Model> first{ ModelCache::loadToolModel(filename) };
+    unique_ptr<Model> second{ ModelCache::loadToolModel(filename) };
+    ASSERT(cache->getNumModels() == 1, __FILE__, __LINE__,
+        "Expected the tools to share the cached model.");
+    ASSERT(*first == expected && *second == expected, __FILE__, __LINE__,
+        "Expected the cached model to match the model in the file.");
+
+    // The same contents in another file are cached separately, since they may
+    // refer to other geometry files.
+    const string copyFilename = "testModelCache_tool_" + filename;
+    {
+        ifstream source(filename, ios::binary);
+        ofstream copy(copyFilename, ios::binary);
+        copy << source.rdbuf();
+    }
+    unique_ptr<Model> copied{ ModelCache::loadToolModel(copyFilename) };
+    ASSERT(cache->getNumModels() == 2, __FILE__, __LINE__,
+        "Expected another file to be cached separately.");
+    ASSERT(copied->getInputFileName() == copyFilename, __FILE__, __LINE__,
+        "Expected the copy to know the file it was loaded from.");
+
+    ModelCache::setToolCache(nullptr);
+    unique_ptr<Model> reread{ ModelCache::loadToolModel(filename) };
+    ASSERT(cache->getNumModels() == 2 && *reread == expected,
+        __FILE__, __LINE__, "Expected the file to be read without a cache.");
+}
@@ -51,6 +51,27 @@ void testMomentArmDefinitionForModel(const string &filename,
                                      SimTK::Vec2 rom = SimTK::Vec2(-SimTK::Pi/2,0),
                                      double mass = -1.0, string errorMessage = "");
 
+// Verify that the length surrogate of a path reproduces the exact length and
+// moment arms of the path.
+void testLengthSurrogateForModel(const string& filename);
+
+// Verify that solving for the moment arms of all muscles about all coordinates
+// at once matches solving for each muscle and coordinate separately.
+void testBatchMomentArmsForModel(const string& filename);
+
+// Verify that the moment arms computed directly by a path match those of a
+// MomentArmSolver, for a model with and a model without constraints.
+void testDirectMomentArmsForModel(const string& filename);
+
+// Verify that moving path points evaluate their location functions together
+// to the same values as one by one, and that conditional path points are
+// active over their ranges.
+void testPathPointsForModel(const string& filename);
+
+// Verify that a copy of a path with wrapping mirrors the original path, with
+// the same length, speed and moment arms as if it computed its own.
+void testSharedPathsForModel(const string& filename);
+
 int main()
 {
     clock_t startTime = clock();
@@ -119,6 +140,22 @@ int main()
 
         testMomentArmDefinitionForModel("CoupledCoordinatesMPPsMomentArmTest.osim", "foot_angle", "vas_int_r", SimTK::Vec2(-2*SimTK::Pi/3, SimTK::Pi/18), -1.0, "Multiple moving path points: FAILED");
         cout << "Multiple moving path points coupled coordinates test: PASSED\n" << endl;
+
+        testLengthSurrogateForModel("WrapPathCustomJointMomentArmTest.osim");
+        cout << "Length surrogate of path with wrapping: PASSED\n" << endl;
+
+        testBatchMomentArmsForModel("testMomentArmsConstraintB.osim");
+        cout << "Moment arms of all muscles about all coordinates: PASSED\n" << endl;
+
+        testDirectMomentArmsForModel("arm26.osim");
+        testDirectMomentArmsForModel("testMomentArmsConstraintB.osim");
+        cout << "Moment arms computed directly by the path: PASSED\n" << endl;
+
+        testPathPointsForModel("gait2354_simbody.osim");
+        cout << "Locations of moving path points: PASSED\n" << endl;
+
+        testSharedPathsForModel("WrapPathCustomJointMomentArmTest.osim");
+        cout << "Copies of a path share its computation: PASSED\n" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -406,3 +443,251 @@ void testMomentArmDefinitionForModel(const string &filename, const string &coord
     // dL/dTheta definition or is at least dynamically consistent, in which dL/dTheta is not
     ASSERT(passesDefinition || passesDynamicConsistency, __FILE__, __LINE__, errorMessage);
 }
+
+void testLengthSurrogateForModel(const string& filename)
+{
+    using namespace SimTK;
+
+    Model osimModel(filename);
+    State& s = osimModel.initSystem();
+
+    const Muscle& muscle = osimModel.getMuscles()[0];
+    const GeometryPath& path = muscle.getGeometryPath();
+    const Coordinate& coord = osimModel.getCoordinateSet()[0];
+
+    const double tolerance = 1e-3;
+    ASSERT(path.fitLengthSurrogate(s, 8, 17, tolerance), __FILE__, __LINE__,
+        "Could not fit a length surrogate to " + filename);
+    const PathLengthSurrogate* surrogate = path.getLengthSurrogate();
+    ASSERT(surrogate != nullptr && surrogate->getQIndices().size() == 1,
+        __FILE__, __LINE__, "Expected the surrogate to depend on a single "
+        "coordinate.");
+    ASSERT(surrogate->getMaxError() <= tolerance, __FILE__, __LINE__,
+        "Surrogate error exceeds the tolerance.");
+
+    // Evaluate the path with the surrogate, then exactly.
+    const int nsteps = 20;
+    auto evaluate = [&](Vector& lengths, Vector& momentArms) {
+        for (int i = 0; i <= nsteps; ++i) {
+            coord.setValue(s, coord.getRangeMin() +
+                (coord.getRangeMax() - coord.getRangeMin())*i/nsteps);
+            lengths[i] = path.getLength(s);
+            momentArms[i] = path.computeMomentArm(s, coord);
+        }
+    };
+    Vector lengths(nsteps + 1), momentArms(nsteps + 1);
+    evaluate(lengths, momentArms);
+    path.clearLengthSurrogate();
+    Vector exactLengths(nsteps + 1), exactMomentArms(nsteps + 1);
+    evaluate(exactLengths, exactMomentArms);
+
+    for (int i = 0; i <= nsteps; ++i) {
+        ASSERT_EQUAL(exactLengths[i], lengths[i], tolerance, __FILE__, __LINE__,
+            "Surrogate length differs from the exact length.");
+        ASSERT_EQUAL(exactMomentArms[i], momentArms[i], 10*tolerance,
+            __FILE__, __LINE__,
+            "Surrogate moment arm differs from the exact moment arm.");
+    }
+}
+
+void testBatchMomentArmsForModel(const string& filename)
+{
+    Model osimModel(filename);
+    SimTK::State& s = osimModel.initSystem();
+
+    std::vector<const Coordinate*> coordinates;
+    const CoordinateSet& coordSet = osimModel.getCoordinateSet();
+    for (int i = 0; i < coordSet.getSize(); ++i)
+        if (!coordSet[i].getLocked(s))
+            coordinates.push_back(&coordSet[i]);
+    std::vector<const GeometryPath*> paths;
+    const Set<Muscle>& muscles = osimModel.getMuscles();
+    for (int j = 0; j < muscles.getSize(); ++j)
+        paths.push_back(&muscles[j].getGeometryPath());
+
+    // Bend the knee so that the constraints couple the coordinates.
+    const Coordinate& knee = coordSet.get("knee_angle_r");
+    knee.setValue(s, -SimTK::Pi/4);
+
+    MomentArmSolver maSolver(osimModel);
+    const SimTK::Matrix momentArms = maSolver.solve(s, coordinates, paths);
+    ASSERT(momentArms.nrow() == (int)coordinates.size() &&
+           momentArms.ncol() == (int)paths.size(), __FILE__, __LINE__,
+        "Expected a moment arm for each coordinate and path.");
+
+    for (size_t i = 0; i < coordinates.size(); ++i) {
+        for (size_t j = 0; j < paths.size(); ++j) {
+            const double ma = maSolver.solve(s, *coordinates[i], *paths[j]);
+            ASSERT_EQUAL(ma, momentArms(int(i), int(j)), SimTK::SqrtEps,
+                __FILE__, __LINE__, "Moment arm of " + muscles[int(j)].getName() +
+                " about " + coordinates[i]->getName() + " differs from the "
+                "moment arm solved for separately.");
+        }
+    }
+}
+
+void testDirectMomentArmsForModel(const string& filename)
+{
+    Model osimModel(filename);
+    SimTK::State& s = osimModel.initSystem();
+    const CoordinateSet& coordSet = osimModel.getCoordinateSet();
+    const Set<Muscle>& muscles = osimModel.getMuscles();
+    MomentArmSolver maSolver(osimModel);
+
+    double solverTime = 0, directTime = 0;
+    const int nsteps = 5;
+    for (int k = 0; k <= nsteps; ++k) {
+        for (int i = 0; i < coordSet.getSize(); ++i) {
+            const Coordinate& coord = coordSet[i];
+            if (coord.getLocked(s) || coord.getMotionType() !=
+                                      Coordinate::Rotational) continue;
+            coord.setValue(s, coord.getRangeMin() +
+                k*(coord.getRangeMax() - coord.getRangeMin())/nsteps, false);
+        }
+        osimModel.assemble(s);
+        osimModel.realizePosition(s);
+
+        for (int j = 0; j < muscles.getSize(); ++j) {
+            const GeometryPath& path = muscles[j].getGeometryPath();
+            std::clock_t start = std::clock();
+            const SimTK::Vector momentArms = path.computeMomentArms(s);
+            directTime += std::clock() - start;
+            ASSERT(momentArms.size() == coordSet.getSize());
+
+            for (int i = 0; i < coordSet.getSize(); ++i) {
+                if (coordSet[i].getLocked(s)) continue;
+                start = std::clock();
+                const double expected = maSolver.solve(s, coordSet[i], path);
+                solverTime += std::clock() - start;
+                const string message = "Moment arm of " +
+                    muscles[j].getName() + " about " + coordSet[i].getName() +
+                    " differs from that of the MomentArmSolver.";
+                ASSERT_EQUAL(expected, momentArms[i], 1e-8, __FILE__,
+                             __LINE__, message);
+                ASSERT_EQUAL(expected, path.computeMomentArm(s, coordSet[i]),
+                             1e-8, __FILE__, __LINE__, message);
+            }
+        }
+    }
+    cout << filename << ": moment arms of all muscles took "
+         << 1.0e3*solverTime/CLOCKS_PER_SEC << "ms with the MomentArmSolver "
+         << "and " << 1.0e3*directTime/CLOCKS_PER_SEC << "ms from the paths."
+         << endl;
+}
+
+void testPathPointsForModel(const string& filename)
+{
+    Model osimModel(filename);
+    SimTK::State& s = osimModel.initSystem();
+    const std::vector<int> derivComponents(1, 0);
+
+    int numMoving = 0;
+    for (const auto& point : osimModel.getComponentList<MovingPathPoint>()) {
+        const Coordinate& coord = point.getXCoordinate();
+        if (coord.getLocked(s)) continue;
+        ++numMoving;
+        const double min = coord.getRangeMin();
+        const double max = coord.getRangeMax();
+        const int nsteps = 20;
+        for (int k = 0; k <= nsteps; ++k) {
+            // Include values out of the range of the coordinate.
+            const double q = min - 0.2 + k*(max - min + 0.4)/nsteps;
+            coord.setValue(s, q, false);
+            const SimTK::Vector x(1, SimTK::clamp(min, q, max));
+            const SimTK::Vector dx(1, q);
+            const SimTK::Vec3 location(
+                point.get_x_location().calcValue(x),
+                point.get_y_location().calcValue(x),
+                point.get_z_location().calcValue(x));
+            const SimTK::Vec3 dPointdQ(
+                point.get_x_location().calcDerivative(derivComponents, dx),
+                point.get_y_location().calcDerivative(derivComponents, dx),
+                point.get_z_location().calcDerivative(derivComponents, dx));
+            ASSERT_EQUAL(location, point.getLocation(s), 1e-12, __FILE__,
+                __LINE__, "Location of " + point.getName() + " is wrong.");
+            ASSERT_EQUAL(dPointdQ, point.getdPointdQ(s), 1e-12, __FILE__,
+                __LINE__, "Derivative of the location of " +
+                point.getName() + " is wrong.");
+        }
+    }
+    ASSERT(numMoving > 0);
+
+    int numConditional = 0;
+    for (const auto& point :
+            osimModel.getComponentList<ConditionalPathPoint>()) {
+        const Coordinate& coord = point.getCoordinate();
+        if (coord.getLocked(s)) continue;
+        ++numConditional;
+        const double min = point.get_range(0);
+        const double max = point.get_range(1);
+        for (double q : {min - 0.1, min, 0.5*(min + max), max, max + 0.1}) {
+            coord.setValue(s, q, false);
+            ASSERT(point.isActive(s) == (q >= min && q <= max), __FILE__,
+                __LINE__, "Activity of " + point.getName() + " is wrong.");
+        }
+    }
+    ASSERT(numConditional > 0);
+}
+
+void testSharedPathsForModel(const string& filename)
+{
+    // The lengths, speeds and moment arms of the path on its own.
+    Model reference(filename);
+    SimTK::State& sref = reference.initSystem();
+
+    Model osimModel(filename);
+    const Muscle& muscle = osimModel.getMuscles()[0];
+    Muscle* copy = muscle.clone();
+    copy->setName(muscle.getName() + "_copy");
+    osimModel.addForce(copy);
+    SimTK::State& s = osimModel.initSystem();
+
+    const GeometryPath& path = muscle.getGeometryPath();
+    const GeometryPath& copyPath = copy->getGeometryPath();
+    const GeometryPath& refPath = reference.getMuscles()[0].getGeometryPath();
+    ASSERT(path.getSharedPath() == nullptr, __FILE__, __LINE__,
+        "Expected the original path to compute its own path.");
+    ASSERT(copyPath.getSharedPath() == &path, __FILE__, __LINE__,
+        "Expected the copy to mirror the original path.");
+    ASSERT(copyPath.getWrapSet().getSize() > 0, __FILE__, __LINE__,
+        "Expected a path with wrapping.");
+
+    const Coordinate& coord = osimModel.getCoordinateSet()[0];
+    const Coordinate& refCoord = reference.getCoordinateSet()[0];
+    const string copyPathName = copyPath.getAbsolutePathName() + "/";
+    const int nsteps = 20;
+    for (int i = 0; i <= nsteps; ++i) {
+        const double q = coord.getRangeMin() +
+            (coord.getRangeMax() - coord.getRangeMin())*i/nsteps;
+        coord.setValue(s, q);
+        coord.setSpeedValue(s, 1.0);
+        refCoord.setValue(sref, q);
+        refCoord.setSpeedValue(sref, 1.0);
+        osimModel.realizeVelocity(s);
+        reference.realizeVelocity(sref);
+
+        // Ask for the copy first, which computes the original path.
+        const double length = copyPath.getLength(s);
+        ASSERT_EQUAL(refPath.getLength(sref), length, 1e-12, __FILE__,
+            __LINE__, "Length of the copy differs from that of the path.");
+        ASSERT_EQUAL(path.getLength(s), length, 1e-12, __FILE__, __LINE__,
+            "Length of the copy differs from that of the original.");
+        ASSERT_EQUAL(refPath.getLengtheningSpeed(sref),
+            copyPath.getLengtheningSpeed(s), 1e-12, __FILE__, __LINE__,
+            "Lengthening speed of the copy differs from that of the path.");
+        ASSERT_EQUAL(refPath.computeMomentArm(sref, refCoord),
+            copyPath.computeMomentArm(s, coord), 1e-8, __FILE__, __LINE__,
+            "Moment arm of the copy differs from that of the path.");
+
+        // The current path of the copy is made of its own points.
+        const Array<PathPoint*>& currentPath = copyPath.getCurrentPath(s);
+        ASSERT(currentPath.getSize() ==
+               refPath.getCurrentPath(sref).getSize());
+        for (int j = 0; j < currentPath.getSize(); ++j) {
+            ASSERT(currentPath[j]->getAbsolutePathName().compare(
+                       0, copyPathName.size(), copyPathName) == 0,
+                __FILE__, __LINE__,
+                "Expected the current path of the copy to hold its points.");
+        }
+    }
+}
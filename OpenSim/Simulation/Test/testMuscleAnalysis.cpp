@@ -0,0 +1,129 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testMuscleAnalysis.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testMuscleAnalysis verifies that evaluating the muscles of a model on
+// multiple threads records the same results as evaluating them serially.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/osimActuators.h>
+#include <OpenSim/Analyses/MuscleAnalysis.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+// Verify that a MuscleAnalysis with several threads matches a serial one.
+void testParallelMatchesSerial(const string& filename);
+// Verify that two storages hold the same values.
+void compareStorages(const Storage& serial, const Storage& parallel);
+
+int main()
+{
+    try {
+        testParallelMatchesSerial("gait2354_simbody.osim");
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void testParallelMatchesSerial(const string& filename)
+{
+    Model model(filename);
+    SimTK::State& s = model.initSystem();
+
+    MuscleAnalysis serial(&model);
+    MuscleAnalysis parallel(&model);
+    parallel.setNumThreads(4);
+
+    // Sweep the knee and hip so that the muscle paths and forces change.
+    const Coordinate& knee = model.getCoordinateSet().get("knee_angle_r");
+    const Coordinate& hip = model.getCoordinateSet().get("hip_flexion_r");
+    const int nFrames = 5;
+    for (int i = 0; i < nFrames; ++i) {
+        s.updTime() = 0.1*i;
+        knee.setValue(s, -SimTK::Pi/2*i/(nFrames - 1), false);
+        hip.setValue(s, SimTK::Pi/4*i/(nFrames - 1), false);
+        knee.setSpeedValue(s, -1.0);
+        model.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+        // The parallel analysis goes first so that it cannot pick up muscle
+        // quantities cached in the state by the serial analysis.
+        if (i == 0) {
+            parallel.begin(s);
+            serial.begin(s);
+        }
+        else {
+            parallel.step(s, i);
+            serial.step(s, i);
+        }
+    }
+
+    compareStorages(*serial.getMuscleTendonLengthStorage(),
+                    *parallel.getMuscleTendonLengthStorage());
+    compareStorages(*serial.getFiberLengthStorage(),
+                    *parallel.getFiberLengthStorage());
+    compareStorages(*serial.getForceStorage(), *parallel.getForceStorage());
+    compareStorages(*serial.getFiberVelocityStorage(),
+                    *parallel.getFiberVelocityStorage());
+    compareStorages(*serial.getMusclePowerStorage(),
+                    *parallel.getMusclePowerStorage());
+
+    const auto& serialMomentArms = serial.getMomentArmStorageArray();
+    const auto& parallelMomentArms = parallel.getMomentArmStorageArray();
+    ASSERT(serialMomentArms.getSize() == parallelMomentArms.getSize(),
+        __FILE__, __LINE__, "Expected moment arms about the same coordinates.");
+    for (int i = 0; i < serialMomentArms.getSize(); ++i) {
+        compareStorages(*serialMomentArms[i]->momentArmStore,
+                        *parallelMomentArms[i]->momentArmStore);
+        compareStorages(*serialMomentArms[i]->momentStore,
+                        *parallelMomentArms[i]->momentStore);
+    }
+}
+
+void compareStorages(const Storage& serial, const Storage& parallel)
+{
+    ASSERT(serial.getSize() == parallel.getSize(), __FILE__, __LINE__,
+        serial.getName() + ": parallel analysis recorded a different number "
+        "of frames.");
+    for (int i = 0; i < serial.getSize(); ++i) {
+        const Array<double>& expected = serial.getStateVector(i)->getData();
+        const Array<double>& found = parallel.getStateVector(i)->getData();
+        ASSERT(expected.getSize() == found.getSize(), __FILE__, __LINE__,
+            serial.getName() + ": parallel analysis recorded a different "
+            "number of muscles.");
+        for (int j = 0; j < expected.getSize(); ++j) {
+            if (SimTK::isNaN(expected[j])) {
+                ASSERT(SimTK::isNaN(found[j]), __FILE__, __LINE__,
+                    serial.getName() + ": expected NaN.");
+                continue;
+            }
+            ASSERT_EQUAL(expected[j], found[j],
+                1e-8*(1 + std::abs(expected[j])), __FILE__, __LINE__,
+                serial.getName() + ": parallel analysis differs from serial "
+                "analysis.");
+        }
+    }
+}
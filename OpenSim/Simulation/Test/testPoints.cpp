@@ -27,6 +27,7 @@ Tests Include:
     1. Station
     2. Marker
     3. Stations on a Frame computations 
+    4. MarkerSet batched locations and velocities
       
      Add tests here as Points are added to OpenSim
 
@@ -43,6 +44,7 @@ using SimTK::Transform;
 
 void testStationOnBody();
 void testStationOnOffsetFrame();
+void testMarkerSetLocationsInGround();
 
 class OrdinaryOffsetFrame : public OffsetFrame < Frame > {
     OpenSim_DECLARE_CONCRETE_OBJECT(OrdinaryOffsetFrame, OffsetFrame<Frame>);
@@ -70,6 +72,12 @@ int main()
         failures.push_back("testStationOnOffsetFrame");
     }
 
+    try { testMarkerSetLocationsInGround(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testMarkerSetLocationsInGround");
+    }
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -229,3 +237,52 @@ void testStationOnOffsetFrame()
         SimTK_TEST_EQ(a, ao);
     }
 }
+
+void testMarkerSetLocationsInGround()
+{
+    cout << "Running testMarkerSetLocationsInGround" << endl;
+
+    Model pendulum("double_pendulum.osim");
+    const OpenSim::Body& rod1 = pendulum.getBodySet().get("rod1");
+    const OpenSim::Body& rod2 = pendulum.getBodySet().get("rod2");
+
+    PhysicalOffsetFrame* offsetFrame = new PhysicalOffsetFrame("offset", rod2,
+        SimTK::Transform(SimTK::Rotation(0.7, SimTK::XAxis),
+                         SimTK::Vec3(0.1, -0.2, 0.3)));
+    pendulum.addComponent(offsetFrame);
+
+    // Interleave the frames of the markers so that grouping them by frame
+    // must not reorder the results.
+    const PhysicalFrame* frames[] = { &rod1, &rod2, offsetFrame,
+                                      &pendulum.getGround() };
+    for (int i = 0; i < 12; ++i) {
+        Marker* marker = new Marker();
+        marker->setName("m" + std::to_string(i));
+        marker->setParentFrame(*frames[i % 4]);
+        marker->set_location(SimTK::Vec3(0.01*i, -0.02*i, 0.5 - 0.03*i));
+        pendulum.addMarker(marker);
+    }
+
+    SimTK::State& s = pendulum.initSystem();
+    const MarkerSet& markers = pendulum.getMarkerSet();
+    SimTK::Array_<SimTK::Vec3> locations, velocities;
+
+    for (double ang = 0; ang <= 90.0; ang += 30.) {
+        const double radAngle = SimTK::convertDegreesToRadians(ang);
+        pendulum.getCoordinateSet().get("q1").setValue(s, radAngle);
+        pendulum.getCoordinateSet().get("q2").setValue(s, -0.5*radAngle);
+        pendulum.getCoordinateSet().get("q1").setSpeedValue(s, 1.0 + radAngle);
+        pendulum.getCoordinateSet().get("q2").setSpeedValue(s, -2.0);
+        pendulum.realizeVelocity(s);
+
+        markers.calcLocationsInGround(s, locations);
+        markers.calcVelocitiesInGround(s, velocities);
+        ASSERT(int(locations.size()) == markers.getSize());
+        ASSERT(int(velocities.size()) == markers.getSize());
+
+        for (int i = 0; i < markers.getSize(); ++i) {
+            SimTK_TEST_EQ(locations[i], markers[i].getLocationInGround(s));
+            SimTK_TEST_EQ(velocities[i], markers[i].getVelocityInGround(s));
+        }
+    }
+}
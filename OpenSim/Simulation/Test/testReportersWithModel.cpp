@@ -23,9 +23,14 @@
  * -------------------------------------------------------------------------- */
 
 #include <OpenSim/Common/Reporter.h>
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Common/SharedMemoryReporter.h>
+#include <OpenSim/Common/TableFileReporter.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
+#include <OpenSim/Simulation/StatesFileReporter.h>
+#include <OpenSim/Simulation/StatesTrajectoryReporter.h>
 
 using namespace std;
 using namespace SimTK;
@@ -115,9 +120,159 @@ void testTableReporterLabels() {
     SimTK_TEST(headings[1] == "height");
 }
 
+void testFileReporters() {
+    // Create a model consisting of a falling ball.
+    Model model;
+    model.setName("world");
+
+    auto* ball = new OpenSim::Body("ball", 1., Vec3(0), Inertia(0));
+    model.addBody(ball);
+
+    auto* slider = new SliderJoint("slider", model.getGround(), Vec3(0),
+        Vec3(0,0,Pi/2.), *ball, Vec3(0), Vec3(0,0,Pi/2.));
+    model.addJoint(slider);
+
+    // Report the same values in memory and to files, writing the files in
+    // chunks that do not divide the number of rows.
+    auto* reporter = new TableReporter();
+    reporter->set_report_time_interval(0.1);
+    reporter->addToReport(slider->getCoordinate().getOutput("value"));
+    reporter->addToReport(slider->getCoordinate().getOutput("speed"));
+    model.addComponent(reporter);
+
+    auto* fileReporter = new TableFileReporter();
+    fileReporter->setName("file_reporter");
+    fileReporter->set_report_time_interval(0.1);
+    fileReporter->set_file_name("testReporters_values.sto");
+    fileReporter->set_rows_per_chunk(3);
+    fileReporter->addToReport(slider->getCoordinate().getOutput("value"));
+    fileReporter->addToReport(slider->getCoordinate().getOutput("speed"));
+    model.addComponent(fileReporter);
+
+    auto* statesReporter = new StatesTrajectoryReporter();
+    statesReporter->set_report_time_interval(0.1);
+    model.addComponent(statesReporter);
+
+    auto* statesFileReporter = new StatesFileReporter();
+    statesFileReporter->setName("states_file_reporter");
+    statesFileReporter->set_report_time_interval(0.1);
+    statesFileReporter->set_file_name("testReporters_states.sto");
+    statesFileReporter->set_rows_per_chunk(4);
+    model.addComponent(statesFileReporter);
+
+    // Simulate, with room reserved for the rows of the table reporter.
+    State& state = model.initSystem();
+    reporter->reserveForDuration(1.);
+    const size_t capacity = reporter->getTable().getRowCapacity();
+    SimTK_TEST(capacity >= 11);
+    RungeKuttaMersonIntegrator integrator(model.getSystem());
+    Manager manager(model, integrator);
+    manager.setInitialTime(0.); manager.setFinalTime(1.);
+    manager.integrate(state);
+    SimTK_TEST(reporter->getTable().getRowCapacity() == capacity);
+    SimTK_TEST(fileReporter->isFileOpen());
+    fileReporter->closeFile();
+    statesFileReporter->closeFile();
+    SimTK_TEST(!fileReporter->isFileOpen());
+
+    const auto& expected = reporter->getTable();
+    const auto values =
+        STOFileAdapter_<double>::read("testReporters_values.sto");
+    SimTK_TEST(expected.getNumRows() == 11);
+    SimTK_TEST(values.getColumnLabels() == expected.getColumnLabels());
+    for (size_t i = 0; i < expected.getNumRows(); ++i)
+        SimTK_TEST_EQ(values.getIndependentColumn()[i],
+                      expected.getIndependentColumn()[i]);
+    SimTK_TEST_EQ(Matrix(values.getMatrix()), Matrix(expected.getMatrix()));
+
+    const auto& states = statesReporter->getStates();
+    const auto statesTable =
+        STOFileAdapter_<double>::read("testReporters_states.sto");
+    SimTK_TEST(statesTable.getNumRows() == states.getSize());
+    SimTK_TEST(statesTable.getNumColumns() ==
+               (size_t)model.getNumStateVariables());
+    for (size_t i = 0; i < states.getSize(); ++i) {
+        SimTK_TEST_EQ(statesTable.getIndependentColumn()[i],
+                      states[i].getTime());
+        SimTK_TEST_EQ(RowVector(statesTable.getRowAtIndex(i)),
+                      RowVector(~model.getStateVariableValues(states[i])));
+    }
+
+    // Closing the file allows reporting the next simulation from the start.
+    reporter->clearTable();
+    statesReporter->clear();
+    state = model.initSystem();
+    Manager manager2(model, integrator);
+    manager2.setInitialTime(0.); manager2.setFinalTime(0.5);
+    manager2.integrate(state);
+    fileReporter->closeFile();
+    SimTK_TEST(STOFileAdapter_<double>::read("testReporters_values.sto")
+               .getNumRows() == 6);
+}
+
+void testSharedMemoryReporter() {
+    // Create a model consisting of a falling ball.
+    Model model;
+    model.setName("world");
+
+    auto* ball = new OpenSim::Body("ball", 1., Vec3(0), Inertia(0));
+    model.addBody(ball);
+
+    auto* slider = new SliderJoint("slider", model.getGround(), Vec3(0),
+        Vec3(0,0,Pi/2.), *ball, Vec3(0), Vec3(0,0,Pi/2.));
+    model.addJoint(slider);
+
+    // Publish the same values as a table reporter, in a ring too small to
+    // hold all of them.
+    auto* reporter = new TableReporter();
+    reporter->set_report_time_interval(0.1);
+    reporter->addToReport(slider->getCoordinate().getOutput("value"));
+    reporter->addToReport(slider->getCoordinate().getOutput("speed"), "v");
+    model.addComponent(reporter);
+
+    auto* shmReporter = new SharedMemoryReporter();
+    shmReporter->setName("shared_memory_reporter");
+    shmReporter->set_report_time_interval(0.1);
+    shmReporter->set_shared_memory_name("testReporters_shared_memory");
+    shmReporter->set_capacity(4);
+    shmReporter->addToReport(slider->getCoordinate().getOutput("value"));
+    shmReporter->addToReport(slider->getCoordinate().getOutput("speed"), "v");
+    model.addComponent(shmReporter);
+
+    State& state = model.initSystem();
+    SimTK_TEST(shmReporter->getRingBuffer() == nullptr);
+    RungeKuttaMersonIntegrator integrator(model.getSystem());
+    Manager manager(model, integrator);
+    manager.setInitialTime(0.); manager.setFinalTime(1.);
+    manager.integrate(state);
+
+    // Another reader (e.g., in another process) finds the last records.
+    const auto& expected = reporter->getTable();
+    auto reader =
+        SharedMemoryRingBuffer::open("testReporters_shared_memory");
+    SimTK_TEST(reader->getLabels() == expected.getColumnLabels());
+    SimTK_TEST(reader->getNumRecordsWritten() == expected.getNumRows());
+    double time;
+    Vector values(2);
+    SimTK_TEST(!reader->read(6, time, &values[0]));
+    for (size_t k = 7; k < expected.getNumRows(); ++k) {
+        SimTK_TEST(reader->read(k, time, &values[0]));
+        SimTK_TEST_EQ(time, expected.getIndependentColumn()[k]);
+        SimTK_TEST_EQ(values, Vector(~expected.getRowAtIndex(k)));
+    }
+
+    // Closing removes the shared memory.
+    shmReporter->closeSharedMemory();
+    SimTK_TEST_MUST_THROW_EXC(
+        SharedMemoryRingBuffer::open("testReporters_shared_memory"),
+        OpenSim::Exception);
+}
+
 int main() {
     SimTK_START_TEST("testReporters");
         SimTK_SUBTEST(testConsoleReporterLabels);
         SimTK_SUBTEST(testTableReporterLabels);
+        SimTK_SUBTEST(testFileReporters);
+        SimTK_SUBTEST(testSharedMemoryReporter);
     SimTK_END_TEST();
 };
@@ -0,0 +1,250 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testSharedModel.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// testSharedModel verifies that several threads, each with its own state, can
+// evaluate one initialized model at the same time and get the same results as
+// a single thread.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/osimActuators.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <thread>
+
+using namespace OpenSim;
+using namespace std;
+
+// The quantities computed for one configuration of the model.
+struct Results {
+    vector<double> lengths, forces, momentArms;
+    vector<int> numPathPoints;
+};
+
+// Compute the muscle quantities of the model in the given state.
+Results evaluate(const Model& model, SimTK::State& s, double shoulder,
+                 double elbow);
+// Verify that threads sharing the model match a single thread.
+void testThreadsShareModel(const string& filename);
+// Verify that computing the paths in parallel matches computing them lazily.
+void testParallelPaths(const string& filename);
+// Verify that evaluating many states at once matches evaluating each state.
+void testEvaluateManyStates(const string& filename);
+
+int main()
+{
+    try {
+        testThreadsShareModel("arm26.osim");
+        testParallelPaths("arm26.osim");
+        testEvaluateManyStates("arm26.osim");
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void testThreadsShareModel(const string& filename)
+{
+    Model model(filename);
+    const SimTK::State& s0 = model.initSystem();
+
+    // Sweep the elbow so that the paths wrap and unwrap.
+    const int numConfigs = 24;
+    vector<double> shoulder(numConfigs), elbow(numConfigs);
+    for (int i = 0; i < numConfigs; ++i) {
+        shoulder[i] = 0.5*SimTK::Pi*(i%4)/4;
+        elbow[i] = 0.9*SimTK::Pi*i/(numConfigs - 1);
+    }
+
+    vector<Results> expected(numConfigs);
+    for (int i = 0; i < numConfigs; ++i) {
+        SimTK::State s = s0;
+        expected[i] = evaluate(model, s, shoulder[i], elbow[i]);
+    }
+
+    vector<Results> found(numConfigs);
+    const int numThreads = 4;
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < numConfigs; i += numThreads) {
+                SimTK::State s = s0;
+                found[i] = evaluate(model, s, shoulder[i], elbow[i]);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int i = 0; i < numConfigs; ++i) {
+        const string config = "Configuration " + to_string(i);
+        ASSERT(found[i].numPathPoints == expected[i].numPathPoints,
+            __FILE__, __LINE__, config + ": paths wrapped differently.");
+        for (size_t j = 0; j < expected[i].lengths.size(); ++j) {
+            ASSERT_EQUAL(expected[i].lengths[j], found[i].lengths[j], 1e-12,
+                __FILE__, __LINE__, config + ": muscle lengths differ.");
+            ASSERT_EQUAL(expected[i].forces[j], found[i].forces[j],
+                1e-10*(1 + std::abs(expected[i].forces[j])),
+                __FILE__, __LINE__, config + ": muscle forces differ.");
+            // The moment-arm solvers are shared by the threads, so their
+            // solutions may start from different wraps.
+            ASSERT_EQUAL(expected[i].momentArms[j], found[i].momentArms[j],
+                1e-6, __FILE__, __LINE__, config + ": moment arms differ.");
+        }
+    }
+}
+
+void testParallelPaths(const string& filename)
+{
+    Model serial(filename);
+    const SimTK::State& serialState = serial.initSystem();
+
+    Model parallel(filename);
+    ASSERT_THROW(OpenSim::Exception, parallel.setNumThreadsForPaths(0));
+    parallel.setNumThreadsForPaths(3);
+    const SimTK::State& s0 = parallel.initSystem();
+    ASSERT(parallel.getNumThreadsForPaths() == 3);
+
+    // realizePosition() computes all the paths.
+    {
+        SimTK::State s = s0;
+        parallel.getCoordinateSet().get("r_elbow_flex").setValue(s, 1.0,
+                                                                 false);
+        parallel.realizePosition(s);
+        for (const auto& path : parallel.getComponentList<GeometryPath>()) {
+            ASSERT(path.isCacheVariableValid(s, "length"), __FILE__,
+                __LINE__, "Expected the path of " +
+                path.getOwner().getName() + " to be computed.");
+        }
+    }
+
+    const int numConfigs = 12;
+    for (int i = 0; i < numConfigs; ++i) {
+        const double shoulder = 0.5*SimTK::Pi*(i%4)/4;
+        const double elbow = 0.9*SimTK::Pi*i/(numConfigs - 1);
+        SimTK::State s = serialState;
+        const Results expected = evaluate(serial, s, shoulder, elbow);
+        SimTK::State sp = s0;
+        const Results found = evaluate(parallel, sp, shoulder, elbow);
+
+        const string config = "Configuration " + to_string(i);
+        ASSERT(found.numPathPoints == expected.numPathPoints,
+            __FILE__, __LINE__, config + ": paths wrapped differently.");
+        for (size_t j = 0; j < expected.lengths.size(); ++j) {
+            ASSERT_EQUAL(expected.lengths[j], found.lengths[j], 1e-12,
+                __FILE__, __LINE__, config + ": muscle lengths differ.");
+            ASSERT_EQUAL(expected.forces[j], found.forces[j],
+                1e-10*(1 + std::abs(expected.forces[j])),
+                __FILE__, __LINE__, config + ": muscle forces differ.");
+        }
+    }
+
+    // Copies of the model compute their paths with their own threads.
+    unique_ptr<Model> copy(parallel.clone());
+    ASSERT(copy->getNumThreadsForPaths() == 3);
+    SimTK::State& sc = copy->initSystem();
+    copy->realizeDynamics(sc);
+}
+
+void testEvaluateManyStates(const string& filename)
+{
+    Model model(filename);
+    const SimTK::State& s0 = model.initSystem();
+
+    const int numStates = 10;
+    vector<SimTK::State> states(numStates, s0);
+    for (int i = 0; i < numStates; ++i) {
+        model.getCoordinateSet().get("r_shoulder_elev").setValue(states[i],
+            0.5*SimTK::Pi*(i%4)/4, false);
+        model.getCoordinateSet().get("r_elbow_flex").setValue(states[i],
+            0.9*SimTK::Pi*i/(numStates - 1), false);
+        model.getCoordinateSet().get("r_elbow_flex").setSpeedValue(
+            states[i], 1.0);
+    }
+
+    ASSERT_THROW(OpenSim::Exception, model.calcPathLengths(states, 0));
+
+    for (int numThreads : {1, 3}) {
+        vector<SimTK::State> copies = states;
+        const SimTK::Matrix lengths =
+            model.calcPathLengths(copies, numThreads);
+        const SimTK::Matrix forces =
+            model.calcActuatorForces(copies, numThreads);
+        const SimTK::Matrix udots =
+            model.calcAccelerations(copies, numThreads);
+        ASSERT(lengths.nrow() == numStates && forces.nrow() == numStates &&
+               udots.nrow() == numStates);
+        ASSERT(udots.ncol() == model.getNumSpeeds());
+
+        for (int i = 0; i < numStates; ++i) {
+            SimTK::State s = states[i];
+            model.realizeAcceleration(s);
+            int j = 0;
+            for (const auto& path : model.getComponentList<GeometryPath>())
+                ASSERT_EQUAL(path.getLength(s), lengths(i, j++), 1e-12);
+            ASSERT(j == lengths.ncol());
+            j = 0;
+            const Set<Actuator>& actuators = model.getActuators();
+            for (int k = 0; k < actuators.getSize(); ++k) {
+                const auto* actuator =
+                    dynamic_cast<const ScalarActuator*>(&actuators[k]);
+                if (!actuator) continue;
+                ASSERT_EQUAL(actuator->getActuation(s), forces(i, j),
+                             1e-10*(1 + std::abs(forces(i, j))));
+                ++j;
+            }
+            ASSERT(j == forces.ncol());
+            for (j = 0; j < model.getNumSpeeds(); ++j)
+                ASSERT_EQUAL(s.getUDot()[j], udots(i, j),
+                             1e-10*(1 + std::abs(udots(i, j))));
+        }
+    }
+}
+
+Results evaluate(const Model& model, SimTK::State& s, double shoulder,
+                 double elbow)
+{
+    const Coordinate& elbowFlex =
+        model.getCoordinateSet().get("r_elbow_flex");
+    model.getCoordinateSet().get("r_shoulder_elev").setValue(s, shoulder,
+                                                              false);
+    elbowFlex.setValue(s, elbow, false);
+    elbowFlex.setSpeedValue(s, 1.0);
+    model.getMultibodySystem().realize(s, SimTK::Stage::Dynamics);
+
+    Results results;
+    const Set<Muscle>& muscles = model.getMuscles();
+    for (int j = 0; j < muscles.getSize(); ++j) {
+        const Muscle& muscle = muscles[j];
+        results.lengths.push_back(muscle.getLength(s));
+        results.forces.push_back(muscle.getActuation(s));
+        results.momentArms.push_back(
+            muscle.getGeometryPath().computeMomentArm(s, elbowFlex));
+        results.numPathPoints.push_back(
+            muscle.getGeometryPath().getCurrentPath(s).getSize());
+    }
+    return results;
+}
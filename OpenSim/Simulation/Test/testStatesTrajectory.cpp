@@ -26,6 +26,7 @@
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 #include <random>
 #include <cstdio>
+#include <thread>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -566,6 +567,56 @@ void testCopying() {
     }
 }
 
+void testAccessedStates() {
+    Model model("arm26.osim");
+    SimTK::State state = model.initSystem();
+    const Coordinate& coord = model.getCoordinateSet()[0];
+
+    StatesTrajectory states;
+    state.setTime(0.5);
+    states.append(state);
+    coord.setLocked(state, true);
+    state.setTime(0.6);
+    states.append(state);
+    state.setTime(0.7);
+    states.append(state);
+
+    // Each index has a state of its own, which remains valid as states are
+    // accessed and appended.
+    const SimTK::State& state0 = states[0];
+    const SimTK::State& state1 = states[1];
+    SimTK_TEST(&state0 != &state1);
+    SimTK_TEST(state0.getTime() == 0.5);
+    SimTK_TEST(state1.getTime() == 0.6);
+    state.setTime(0.8);
+    states.append(state);
+    SimTK_TEST(&states[1] == &state1);
+    SimTK_TEST(state0.getTime() == 0.5);
+
+    // Discrete variables of types other than double, int and bool (here,
+    // whether Simbody's locking constraint is disabled) keep the values of
+    // each state.
+    SimTK_TEST(!coord.getLocked(states[0]));
+    SimTK_TEST(coord.getLocked(states[2]));
+
+    // Several threads may access the states at once.
+    const size_t numStates = states.getSize();
+    const int numThreads = 4;
+    std::vector<const SimTK::State*> found(numThreads * numStates);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < numStates; ++i)
+                found[t * numStates + i] = &states.get(i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t = 0; t < numThreads; ++t) {
+        for (size_t i = 0; i < numStates; ++i)
+            SimTK_TEST(found[t * numStates + i] == &states[i]);
+    }
+}
+
 void testAppendTimesAreNonDecreasing() {
     Model model("gait2354_simbody.osim");
     auto& state = model.initSystem();
@@ -781,6 +832,50 @@ void testExport() {
             OpenSim::Exception);
 }
 
+void testExportOutputs() {
+    Model gait("gait2354_simbody.osim");
+    gait.initSystem();
+    Storage sto(statesStoFname);
+    auto states = StatesTrajectory::createFromStatesStorage(gait, sto);
+
+    const auto& knee = gait.getCoordinateSet().get("knee_angle_r");
+    const auto& muscle = gait.getMuscles().get(0);
+    std::vector<std::string> paths {
+            gait.getAbsolutePathName() + "|kinetic_energy",
+            knee.getAbsolutePathName() + "|speed",
+            muscle.getAbsolutePathName() + "|fiber_force(force)"};
+
+    // The values match those of the Outputs evaluated one at a time, with
+    // or without threads.
+    for (int numThreads : {1, 3}) {
+        auto table = states.exportOutputsToTable(gait, paths, numThreads);
+        SimTK_TEST(table.getNumRows() == states.getSize());
+        SimTK_TEST(table.getNumColumns() == 3);
+        SimTK_TEST(table.getColumnLabel(0) == paths[0]);
+        SimTK_TEST(table.getColumnLabel(2) == "force");
+        for (size_t itime = 0; itime < states.getSize(); ++itime) {
+            const auto& state = states[itime];
+            gait.realizeDynamics(state);
+            const auto row = table.getRowAtIndex(itime);
+            SimTK_TEST(table.getIndependentColumn()[itime] ==
+                       state.getTime());
+            SimTK_TEST_EQ(row[0], gait.calcKineticEnergy(state));
+            SimTK_TEST_EQ(row[1], knee.getSpeedValue(state));
+            SimTK_TEST_EQ(row[2], muscle.getFiberForce(state));
+        }
+    }
+
+    // Only Outputs of type double can be exported.
+    SimTK_TEST_MUST_THROW_EXC(states.exportOutputsToTable(gait,
+            {gait.getGround().getAbsolutePathName() + "|position"}),
+            OpenSim::Exception);
+    SimTK_TEST_MUST_THROW_EXC(states.exportOutputsToTable(gait,
+            {knee.getAbsolutePathName() + "|not_an_output"}),
+            OpenSim::Exception);
+    SimTK_TEST_MUST_THROW_EXC(states.exportOutputsToTable(gait,
+            {knee.getAbsolutePathName()}), OpenSim::Exception);
+}
+
 int main() {
     SimTK_START_TEST("testStatesTrajectory");
 
@@ -799,6 +894,7 @@ int main() {
         SimTK_SUBTEST(testIntegrityChecks);
         SimTK_SUBTEST(testAppendTimesAreNonDecreasing);
         SimTK_SUBTEST(testCopying);
+        SimTK_SUBTEST(testAccessedStates);
 
         // Test creation of trajectory from a states storage.
         // -------------------------------------------------
@@ -815,6 +911,7 @@ int main() {
 
         // Export to data table.
         SimTK_SUBTEST(testExport);
+        SimTK_SUBTEST(testExportOutputs);
 
     SimTK_END_TEST();
 }
@@ -0,0 +1,127 @@
+/* -------------------------------------------------------------------------- *
+ *              OpenSim:  testStreamingInverseDynamicsSolver.cpp              *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ * Author(s): Carmichael Ong                                                  *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/StreamingInverseDynamicsSolver.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <cmath>
+
+using namespace OpenSim;
+using namespace std;
+
+// The motion of each coordinate is a cubic, which the filter (of order 3)
+// differentiates exactly.
+SimTK::Vec3 cubicMotion(int i, double t)
+{
+    const double a = 0.1*(i + 1);
+    return SimTK::Vec3(a + 0.5*t - 0.3*t*t + 0.2*t*t*t,
+                       0.5 - 0.6*t + 0.6*t*t,
+                       -0.6 + 1.2*t);
+}
+
+// Compare the streamed solution to the InverseDynamicsSolver at the exact
+// state, with a load on the second rod.
+void testTrackCubicMotion()
+{
+    Model model("double_pendulum.osim");
+    SimTK::State& s = model.initSystem();
+    const int nq = s.getNQ();
+    const double dt = 0.01;
+
+    StreamingInverseDynamicsSolver idSolver(model, dt);
+    ASSERT_THROW(Exception, idSolver.addExternalLoad("no_such_body"));
+    ASSERT(idSolver.addExternalLoad("rod2") == 0);
+    ASSERT_EQUAL(2*dt, idSolver.getLatency(), 1e-15);
+
+    const SimTK::Vec3 force(1.0, 2.0, 0.5);
+    const SimTK::Vec3 point(0.1, -0.5, 0.0);
+    const SimTK::Vec3 torque(0.0, 0.0, 0.3);
+    SimTK::Array_<SimTK::Vec3> forces(1, force), points(1, point),
+        torques(1, torque);
+
+    InverseDynamicsSolver exactSolver(model);
+    SimTK::State solved = s;
+    SimTK::State exact = s;
+    SimTK::Vector tau, udot(nq), q(nq);
+    for (int k = 0; k < 30; ++k) {
+        const double t = k*dt;
+        for (int i = 0; i < nq; ++i) q[i] = cubicMotion(i, t)[0];
+        idSolver.putFrame(t, q, forces, points, torques);
+        // The point of application moves, so that the moment changes.
+        points[0][0] += 0.01;
+
+        const bool solvedFrame = idSolver.solveLatest(solved, tau);
+        ASSERT(solvedFrame == (k >= 8));
+        if (!solvedFrame) continue;
+        ASSERT_EQUAL(t - 2*dt, solved.getTime(), 1e-12);
+
+        exact.updTime() = solved.getTime();
+        for (int i = 0; i < nq; ++i) {
+            const SimTK::Vec3 motion = cubicMotion(i, exact.getTime());
+            exact.updQ()[i] = motion[0];
+            exact.updU()[i] = motion[1];
+            udot[i] = motion[2];
+        }
+        for (int i = 0; i < nq; ++i) {
+            ASSERT_EQUAL(exact.getQ()[i], solved.getQ()[i], 1e-9);
+            ASSERT_EQUAL(exact.getU()[i], solved.getU()[i], 1e-6);
+        }
+
+        const SimTK::MultibodySystem& system = model.getMultibodySystem();
+        system.realize(exact, SimTK::Stage::Dynamics);
+        SimTK::Vector_<SimTK::SpatialVec> bodyForces =
+            system.getRigidBodyForces(exact, SimTK::Stage::Dynamics);
+        const SimTK::MobilizedBody& rod2 =
+            model.getBodySet().get("rod2").getMobilizedBody();
+        // The point of application at the time of the solution, 2 frames
+        // before the last one pushed.
+        const SimTK::Vec3 appliedAt = points[0] - SimTK::Vec3(0.03, 0, 0);
+        rod2.applyForceToBodyPoint(exact,
+            rod2.findStationAtGroundPoint(exact, appliedAt), force,
+            bodyForces);
+        rod2.applyBodyTorque(exact, torque, bodyForces);
+        const SimTK::Vector expected = exactSolver.solve(exact, udot,
+            system.getMobilityForces(exact, SimTK::Stage::Dynamics),
+            bodyForces);
+        for (int i = 0; i < nq; ++i)
+            ASSERT_EQUAL(expected[i], tau[i], 1e-4*(1 + abs(expected[i])),
+                __FILE__, __LINE__, "Generalized force differs.");
+    }
+
+    // Loads cannot be added once frames are streamed.
+    ASSERT_THROW(Exception, idSolver.addExternalLoad("rod1"));
+    // Frames must carry the loads.
+    ASSERT_THROW(Exception, idSolver.putFrame(1.0, q));
+
+    // After a reset, there is no solution until the window is full again.
+    idSolver.resetFrames();
+    ASSERT(!idSolver.solveLatest(solved, tau));
+}
+
+int main()
+{
+    SimTK_START_TEST("testStreamingInverseDynamicsSolver");
+        SimTK_SUBTEST(testTrackCubicMotion);
+    SimTK_END_TEST();
+}
@@ -63,7 +63,6 @@ PathWrap::~PathWrap()
  */
 void PathWrap::setNull()
 {
-    resetPreviousWrap();
 }
 
 //_____________________________________________________________________________
@@ -136,25 +135,49 @@ void PathWrap::setEndPoint( const SimTK::State& s, int aIndex)
     }
 }
 
-void PathWrap::resetPreviousWrap()
+void PathWrap::extendAddToSystem(SimTK::MultibodySystem& system) const
 {
-    _previousWrap.startPoint = -1;
-    _previousWrap.endPoint = -1;
+    Super::extendAddToSystem(system);
+    // The previous wrap is carried from one realization of the state to the
+    // next, so it is never marked valid or invalid.
+    _previousWrapCV = addCacheVariable<WrapResult>("previous_wrap",
+        makeResetWrapResult(), SimTK::Stage::Position);
+}
+
+WrapResult PathWrap::makeResetWrapResult()
+{
+    WrapResult wr;
+    wr.startPoint = -1;
+    wr.endPoint = -1;
 
-    _previousWrap.wrap_pts.setSize(0);
-    _previousWrap.wrap_path_length = 0.0;
+    wr.wrap_pts.setSize(0);
+    wr.wrap_path_length = 0.0;
+    wr.c1 = SimTK::Vec3(0);
+    wr.factor = 1.0;
 
     int i;
     for (i = 0; i < 3; i++) {
-        _previousWrap.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
-        _previousWrap.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
-        _previousWrap.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        wr.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        wr.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        wr.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
     }
+    return wr;
+}
+
+const WrapResult& PathWrap::getPreviousWrap(const SimTK::State& s) const
+{
+    return _previousWrapCV.getValue(s);
+}
+
+void PathWrap::resetPreviousWrap(const SimTK::State& s) const
+{
+    _previousWrapCV.updValue(s) = makeResetWrapResult();
 }
 
-void PathWrap::setPreviousWrap(const WrapResult& aWrapResult)
+void PathWrap::setPreviousWrap(const SimTK::State& s,
+                               const WrapResult& aWrapResult) const
 {
-    _previousWrap = aWrapResult;
+    _previousWrapCV.updValue(s) = aWrapResult;
 }
 
 void PathWrap::setWrapObject(WrapObject& aWrapObject)
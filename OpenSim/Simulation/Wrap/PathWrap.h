@@ -111,14 +111,22 @@ public:
     void setMethod(WrapMethod aMethod);
     const std::string& getMethodName() const { return get_method(); }
 
-    const WrapResult& getPreviousWrap() const { return _previousWrap; }
-    void setPreviousWrap(const WrapResult& aWrapResult);
-    void resetPreviousWrap();
+    /** The result of the last wrapping of the path over the wrap object in
+    the given state, which the wrap object may use as a starting point for
+    the next wrapping. It is kept in the cache of the state, so each state
+    (e.g., each thread simulating the model) has its own. */
+    const WrapResult& getPreviousWrap(const SimTK::State& s) const;
+    void setPreviousWrap(const SimTK::State& s,
+                         const WrapResult& aWrapResult) const;
+    void resetPreviousWrap(const SimTK::State& s) const;
 
 private:
     void constructProperties();
     void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
     void setNull();
+    // A WrapResult that holds no wrap.
+    static WrapResult makeResetWrapResult();
 
 private:
     WrapMethod _method;
@@ -126,7 +134,8 @@ private:
     const WrapObject* _wrapObject;
     const GeometryPath* _path;
 
-    WrapResult _previousWrap;  // results from previous wrapping
+    // results from previous wrapping
+    mutable SimTK::ResetOnCopy<CacheVariable<WrapResult> > _previousWrapCV;
 
     MemberSubcomponentIndex _wrapPoint1Ix{
         constructSubcomponent<PathWrapPoint>("pwpt1") };
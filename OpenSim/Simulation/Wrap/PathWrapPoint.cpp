@@ -0,0 +1,96 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  PathWrapPoint.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ * Author(s): Peter Loan                                                      *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "PathWrapPoint.h"
+#include <OpenSim/Simulation/Model/PhysicalFrame.h>
+
+//=============================================================================
+// STATICS
+//=============================================================================
+using namespace OpenSim;
+using SimTK::Vec3;
+
+//=============================================================================
+// WRAP RESULT
+//=============================================================================
+void PathWrapPoint::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    // The result is written while the path is computed, and is kept when the
+    // stage of the state drops so that it can be drawn later.
+    _wrapInfoCV = addCacheVariable<WrapInfo>("wrap_info", WrapInfo(),
+                                             SimTK::Stage::Position);
+}
+
+Vec3 PathWrapPoint::getLocation(const SimTK::State& s) const
+{
+    return _wrapInfoCV.getValue(s).location;
+}
+
+const Array<Vec3>& PathWrapPoint::getWrapPath(const SimTK::State& s) const
+{
+    return _wrapInfoCV.getValue(s).wrapPath;
+}
+
+double PathWrapPoint::getWrapLength(const SimTK::State& s) const
+{
+    return _wrapInfoCV.getValue(s).wrapPathLength;
+}
+
+void PathWrapPoint::setWrapResult(const SimTK::State& s, const Vec3& location,
+                                  const Array<Vec3>& wrapPath,
+                                  double wrapLength) const
+{
+    WrapInfo& info = _wrapInfoCV.updValue(s);
+    info.location = location;
+    info.wrapPath = wrapPath;
+    info.wrapPathLength = wrapLength;
+    _wrapInfoCV.markValid(s);
+}
+
+//=============================================================================
+// KINEMATICS
+//=============================================================================
+// Same as for a Station, but with the location computed for the state.
+Vec3 PathWrapPoint::calcLocationInGround(const SimTK::State& s) const
+{
+    return getParentFrame().getTransformInGround(s)*getLocation(s);
+}
+
+Vec3 PathWrapPoint::calcVelocityInGround(const SimTK::State& s) const
+{
+    const Vec3 r = getParentFrame().getTransformInGround(s).R()*getLocation(s);
+    const SimTK::SpatialVec& V_GF = getParentFrame().getVelocityInGround(s);
+    return V_GF[1] + V_GF[0] % r;
+}
+
+Vec3 PathWrapPoint::calcAccelerationInGround(const SimTK::State& s) const
+{
+    const SimTK::SpatialVec& V_GF = getParentFrame().getVelocityInGround(s);
+    const SimTK::SpatialVec& A_GF = getParentFrame().getAccelerationInGround(s);
+    const Vec3 r = getParentFrame().getTransformInGround(s).R()*getLocation(s);
+    return A_GF[1] + A_GF[0] % r + V_GF[0] % (V_GF[0] % r);
+}
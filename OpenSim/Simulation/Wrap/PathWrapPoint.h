@@ -51,24 +51,57 @@ public:
     PathWrapPoint() {}
     virtual ~PathWrapPoint() {}
 
-    Array<SimTK::Vec3>& getWrapPath() { return _wrapPath; }
-    double getWrapLength() const { return _wrapPathLength; }
-    void setWrapLength(double aLength) { _wrapPathLength = aLength; }
+    /** Get the location of the point in the frame of its wrap object's body,
+    as last computed for the given state by the GeometryPath of the PathWrap
+    that owns the point. */
+    SimTK::Vec3 getLocation(const SimTK::State& s) const override;
+    /** Get the points of the path over the surface of the wrap object that
+    end at this point, expressed in the frame of the wrap object's body. */
+    const Array<SimTK::Vec3>& getWrapPath(const SimTK::State& s) const;
+    /** Get the length of the path over the surface of the wrap object. */
+    double getWrapLength(const SimTK::State& s) const;
+    /** Store the result of wrapping the path in the given state. The result
+    is kept in the cache of the state rather than in the point, so that one
+    model can compute its paths in several states (e.g., on several threads)
+    at the same time. */
+    void setWrapResult(const SimTK::State& s, const SimTK::Vec3& location,
+                       const Array<SimTK::Vec3>& wrapPath,
+                       double wrapLength) const;
+
     const WrapObject* getWrapObject() const override { return _wrapObject.get(); }
     void setWrapObject(const WrapObject* wrapObject) { _wrapObject.reset(wrapObject); }
 
+private:
+    // The result of wrapping, for one state.
+    struct WrapInfo {
+        // location of the point in the frame of its body
+        SimTK::Vec3 location{ SimTK::NaN };
+        // points defining the path on the surface of the wrap object
+        Array<SimTK::Vec3> wrapPath{};
+        // length of wrapPath
+        double wrapPathLength{ 0.0 };
+
+        friend std::ostream& operator<<(std::ostream& o, const WrapInfo& wi) {
+            o << "PathWrapPoint::WrapInfo location=" << wi.location
+              << " wrapPathLength=" << wi.wrapPathLength;
+            return o;
+        }
+    };
+
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+    SimTK::Vec3 calcLocationInGround(const SimTK::State& state) const override;
+    SimTK::Vec3 calcVelocityInGround(const SimTK::State& state) const override;
+    SimTK::Vec3 calcAccelerationInGround(const SimTK::State& state) const override;
+
 //=============================================================================
 // DATA
 //=============================================================================
-private:
-    // points defining muscle path on surface of wrap object
-    Array<SimTK::Vec3> _wrapPath{};
-    // length of _wrapPath TODO this should be a cache variable!
-    double _wrapPathLength{ 0.0 };
-
     // the wrap object this point is on
     SimTK::ReferencePtr<const WrapObject> _wrapObject; 
 
+    mutable SimTK::ResetOnCopy<CacheVariable<WrapInfo> > _wrapInfoCV;
+
 //=============================================================================
 };  // END of class PathWrapPoint
 //=============================================================================
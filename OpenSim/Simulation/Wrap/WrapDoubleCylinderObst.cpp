@@ -23,6 +23,7 @@
 #include "WrapDoubleCylinderObst.h"
 #include <OpenSim/Simulation/Wrap/WrapResult.h>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Common/Logger.h>
 
 //=============================================================================
 // STATICS
@@ -810,7 +811,7 @@ static int double_cylinder(double U[3],double Ru,double V[3],double Rv,double M[
         /*===============================================================*/
     }   T[0]=x[0];  T[1]=x[1];  T[2]=x[2];  /*== APPLY SOLUTION ==*/
     if(count>=MAXCOUNT) {
-        printf("double_cyl: Unable to converge.\n");
+        OPENSIM_WARN("double_cyl: Unable to converge.");
         return(-1);
     }
     /*==================================================================*/
@@ -48,6 +48,45 @@ static const char* wrapTypeName = "ellipsoid";
 #define N_STEPS               16
 #define SV_BOUNDARY_BLEND     0.3
 
+namespace {
+    // The sum of the squares of the residuals of the conditions that
+    // WrapEllipsoid::calcTangentPoint() drives to zero, for a tangent point r1
+    // of the line from p1 in the plane (vs, vs4). All quantities are
+    // normalized.
+    double calcTangentResidual(const Vec3& r1, const Vec3& p1, const Vec3& m,
+                               const Vec3& a, const Vec3& vs, double vs4)
+    {
+        Vec3 nr1;
+        double onSurface = -1.0;
+        for (int i = 0; i < 3; i++) {
+            nr1[i] = 2.0 * (r1[i] - m[i]) / SQR(a[i]);
+            onSurface += SQR((r1[i] - m[i]) / a[i]);
+        }
+        const double inPlane = SimTK::dot(vs, r1) + vs4;
+        const double tangent = SimTK::dot(nr1, p1) - SimTK::dot(nr1, r1);
+        return SQR(inPlane) + SQR(onSurface) + SQR(tangent);
+    }
+
+    // Replace the starting point r1 of the search for a tangent point with
+    // the tangent point of the previous wrap (previousR1), if the path has
+    // moved little enough since that wrap for it to be the better start: it
+    // must be on the same side of the ellipsoid as r1 and satisfy the
+    // tangency conditions in the current plane better than r1 does.
+    void warmStartTangentPoint(const Vec3& previousR1, Vec3& r1,
+                               const Vec3& p1, const Vec3& m, const Vec3& a,
+                               const Vec3& vs, double vs4)
+    {
+        if (!previousR1.isFinite()) return;
+        double sameSide = 0.0;
+        for (int i = 0; i < 3; i++)
+            sameSide += (previousR1[i] - m[i]) * (r1[i] - m[i]) / SQR(a[i]);
+        if (sameSide <= 0.0) return;
+        if (calcTangentResidual(previousR1, p1, m, a, vs, vs4) <
+                calcTangentResidual(r1, p1, m, a, vs, vs4))
+            r1 = previousR1;
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -259,7 +298,7 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
     // In case you need any variables from the previous wrap, copy them from
     // the PathWrap into the WrapResult, re-normalizing the ones that were
     // un-normalized at the end of the previous wrap calculation.
-    const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+    const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
     aWrapResult.factor = previousWrap.factor;
     for (i = 0; i < 3; i++)
     {
@@ -270,6 +309,7 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
     }
 
     aFlag = true;
+    aWrapResult.numIterations = 0;
     aWrapResult.wrap_pts.setSize(0);
 
     // This algorithm works best if the coordinates (aPoint1, aPoint2,
@@ -597,9 +637,28 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
 
     vs4 = - Mtx::DotProduct(3, vs, aWrapResult.c1);
 
-    // find r1 & r2 by starting at c1 moving toward p1 & p2
-    calcTangentPoint(p1e, aWrapResult.r1, p1, m, a, vs, vs4);
-    calcTangentPoint(p2e, aWrapResult.r2, p2, m, a, vs, vs4);
+    // If the previous wrap was of the same segment, its tangent points (which
+    // are in the frame of the wrap object's body) may be closer to r1 & r2
+    // than c1 is, when the path moves continuously from one evaluation to
+    // the next.
+    if (previousWrap.wrap_pts.getSize() > 0 &&
+        previousWrap.startPoint == aWrapResult.startPoint &&
+        previousWrap.endPoint == aWrapResult.endPoint)
+    {
+        warmStartTangentPoint(
+            _pose.shiftBaseStationToFrame(previousWrap.r1) * aWrapResult.factor,
+            aWrapResult.r1, p1, m, a, vs, vs4);
+        warmStartTangentPoint(
+            _pose.shiftBaseStationToFrame(previousWrap.r2) * aWrapResult.factor,
+            aWrapResult.r2, p2, m, a, vs, vs4);
+    }
+
+    // find r1 & r2 by starting at c1 (or the previous tangent points) moving
+    // toward p1 & p2
+    calcTangentPoint(p1e, aWrapResult.r1, p1, m, a, vs, vs4,
+                     aWrapResult.numIterations);
+    calcTangentPoint(p2e, aWrapResult.r2, p2, m, a, vs, vs4,
+                     aWrapResult.numIterations);
 
     // create a series of line segments connecting r1 & r2 along the
     // surface of the ellipsoid.
@@ -668,10 +727,12 @@ calc_wrap_path:
  * @param a Ellipsoid axis
  * @param vs Plane vector
  * @param vs4 Plane coefficient
+ * @param numIterations Incremented by the number of iterations of the search
  * @return '1' if the point was adjusted, '0' otherwise
  */
 int WrapEllipsoid::calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1, SimTK::Vec3& m,
-                                                SimTK::Vec3& a, SimTK::Vec3& vs, double vs4) const
+                                                SimTK::Vec3& a, SimTK::Vec3& vs, double vs4,
+                                                int& numIterations) const
 {
     int i, j, k, nit, nit2, maxit=50, maxit2=1000;
     Vec3 nr1, p1r1, p1m;
@@ -851,6 +912,7 @@ int WrapEllipsoid::calcTangentPoint(double p1e, SimTK::Vec3& r1, SimTK::Vec3& p1
             ssq = SQR(ee[0]) + SQR(ee[1]) + SQR(ee[2]) + SQR(ee[3]);
             ssqo = ssq;     
         }
+        numIterations += nit;
     }   
     return 1;
 
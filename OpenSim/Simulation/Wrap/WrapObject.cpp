@@ -152,10 +152,10 @@ int WrapObject::wrapPathSegment(const SimTK::State& s,
     // Convert the path points from the frames of the bodies they are attached
     // to, to the frame of the wrap object's body
     pt1 = aPoint1.getBody()
-        .findStationLocationInAnotherFrame(s, aPoint1.getLocation(), getFrame());
+        .findStationLocationInAnotherFrame(s, aPoint1.getLocation(s), getFrame());
     
     pt2 = aPoint2.getBody()
-        .findStationLocationInAnotherFrame(s, aPoint2.getLocation(), getFrame());
+        .findStationLocationInAnotherFrame(s, aPoint2.getLocation(s), getFrame());
 
     // Convert the path points from the frame of the wrap object's body
     // into the frame of the wrap object
@@ -163,6 +163,8 @@ int WrapObject::wrapPathSegment(const SimTK::State& s,
     pt2 = _pose.shiftBaseStationToFrame(pt2);
 
     return_code = wrapLine(s, pt1, pt2, aPathWrap, aWrapResult, p_flag);
+    if (aWrapResult.numIterations > 0)
+        _iterations.add(aWrapResult.numIterations);
 
    if (p_flag == true && return_code > 0) {
         // Convert the tangent points from the frame of the wrap object to the
@@ -26,6 +26,7 @@
 // INCLUDE
 #include <OpenSim/Simulation/Model/ModelComponent.h>
 #include <OpenSim/Simulation/Model/Appearance.h>
+#include <OpenSim/Common/IterationCounter.h>
 namespace OpenSim {
 
 class PathPoint;
@@ -66,6 +67,12 @@ public:
         "The name of quadrant over which the wrap object is active. "
         "For example, '+x' or '-y' to set the sidedness of the wrapping.");
 
+//==============================================================================
+// OUTPUTS
+//==============================================================================
+    OpenSim_DECLARE_OUTPUT(wrap_iterations, double, getWrapIterations,
+                           SimTK::Stage::Model);
+
     enum WrapQuadrant
     {
         allQuadrants,
@@ -114,6 +121,14 @@ public:
     // TODO: total SIMM hack!
     virtual std::string getDimensionsString() const { return ""; }
 
+    /** The total number of iterations of the solver of this wrap object
+    (e.g., the search for the tangent points of a WrapEllipsoid) over all the
+    path segments it wrapped since it was constructed or copied; this does
+    not depend on the state. Wrap objects that are solved without iterating
+    report 0. */
+    double getWrapIterations(const SimTK::State& s) const
+    {   return (double)_iterations.get(); }
+
 //=============================================================================
 // WRAPPING
 //=============================================================================
@@ -148,6 +163,9 @@ private:
     void constructProperties();
 
     SimTK::ReferencePtr<const PhysicalFrame> _frame;
+    // Iterations of wrapLine(), over the paths that may be computed in
+    // parallel.
+    IterationCounter _iterations;
 
 protected:
 
@@ -39,7 +39,8 @@ using namespace OpenSim;
 /**
  * Default constructor.
  */
-WrapResult::WrapResult()
+WrapResult::WrapResult() :
+    numIterations(0)
 {
 }
 
@@ -64,6 +65,7 @@ void WrapResult::copyData(const WrapResult& aWrapResult)
 
     startPoint = aWrapResult.startPoint;
     endPoint = aWrapResult.endPoint;
+    numIterations = aWrapResult.numIterations;
 
     int i;
     for (i = 0; i < 3; i++) {
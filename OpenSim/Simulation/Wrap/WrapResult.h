@@ -55,6 +55,7 @@ public:
     SimTK::Vec3 c1;              // intermediate point used by some wrap objects
     SimTK::Vec3 sv;              // intermediate point used by some wrap objects
     double factor;             // scale factor used to normalize parameters
+    int numIterations;         // iterations of the wrap object's solver
 
 //=============================================================================
 // METHODS
@@ -68,6 +69,14 @@ public:
     void copyData(const WrapResult& aWrapResult);
     WrapResult& operator=(const WrapResult& aWrapResult);
 
+    friend std::ostream& operator<<(std::ostream& o, const WrapResult& wr) {
+        o << "WrapResult startPoint=" << wr.startPoint
+          << " endPoint=" << wr.endPoint
+          << " wrap_path_length=" << wr.wrap_path_length
+          << " r1=" << wr.r1 << " r2=" << wr.r2;
+        return o;
+    }
+
 //=============================================================================
 };  // END of class WrapResult
 //=============================================================================
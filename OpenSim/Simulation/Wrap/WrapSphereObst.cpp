@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 #include "WrapSphereObst.h"
 #include <OpenSim/Simulation/Wrap/WrapResult.h>
+#include <OpenSim/Common/Logger.h>
 
 //=============================================================================
 // STATICS
@@ -210,7 +211,7 @@ int WrapSphereObst::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK:
     SimTK::Vec3 aXvec = aPointP;                aXvec = aXvec.normalize();  // X = P
     SimTK::Vec3 aZvec = aPointP % aPointS;
     if(aZvec.norm()<=1.e-7) {
-        printf("WrapSphereObst: P and S are collinear with sphere center (no unique solution)\n");
+        OPENSIM_WARN("WrapSphereObst: P and S are collinear with sphere center (no unique solution)");
         return insideRadius;
     }                                           aZvec = aZvec.normalize();  // Z = P x S
     SimTK::Vec3 aYvec = aZvec % aXvec;          aYvec = aYvec.normalize();  // Y = Z x X
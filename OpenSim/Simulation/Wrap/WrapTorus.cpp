@@ -27,12 +27,15 @@
 #include "WrapTorus.h"
 #include "WrapCylinder.h"
 #include "WrapResult.h"
+#include "PathWrap.h"
 #include <OpenSim/Common/ModelDisplayHints.h>
 #include <OpenSim/Common/SimmMacros.h>
-#include <OpenSim/Common/Lmdif.h>
 #include <OpenSim/Common/Mtx.h>
 #include <OpenSim/Simulation/Model/PhysicalFrame.h>
 
+#include <algorithm>
+#include <cmath>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -44,6 +47,79 @@ static const char* wrapTypeName = "torus";
 
 #define CYL_LENGTH 10000.0
 
+namespace {
+// The line through p1 with unit direction n, and the radius r of the circle,
+// in the terms of the residual of findClosestPoint().
+struct CircleLine {
+    double c2, c3, c4, c5, r;
+};
+
+CircleLine makeCircleLine(const double p1[], const double n[], double r)
+{
+    CircleLine cl;
+    cl.c2 = 2.0 * (p1[0]*n[0] + p1[1]*n[1] + p1[2]*n[2]);
+    cl.c3 = p1[0]*n[0] + p1[1]*n[1];
+    cl.c4 = n[0]*n[0] + n[1]*n[1];
+    cl.c5 = p1[0]*p1[0] + p1[1]*p1[1];
+    cl.r = r;
+    return cl;
+}
+
+// The residual at the point u along the line, whose root findClosestPoint()
+// seeks, and its derivative with respect to u.
+double calcCircleResid(const CircleLine& cl, double u, double& dResid)
+{
+    const double s2 = u * u * cl.c4 + 2.0 * cl.c3 * u + cl.c5;
+    const double s = sqrt(s2);
+    dResid = 2.0 - 4.0 * cl.r * (cl.c4 * cl.c5 - cl.c3 * cl.c3) / (s2 * s);
+    return cl.c2 + 2.0 * u - 4.0 * cl.r * (cl.c4 * u + cl.c3) / s;
+}
+
+// Minimize the square of the residual over u, starting from u, with
+// Levenberg-Marquardt steps using the analytic derivative: Newton steps, damped
+// whenever a step does not reduce the residual. The problem has a single
+// unknown, so a step costs one evaluation of the residual and no allocation.
+// Returns whether the residual reached a root at which its derivative is
+// positive.
+bool solveCircleResid(const CircleLine& cl, double scale, double& u,
+                      int& numIterations)
+{
+    const int maxIterations = 100;
+    const double xtol = 1e-10;
+    double dResid;
+    double resid = calcCircleResid(cl, u, dResid);
+    ++numIterations;
+    if (!SimTK::isFinite(resid))
+        return false;
+
+    double damping = 0.0;
+    for (int i = 0; i < maxIterations; ++i) {
+        const double J2 = dResid * dResid;
+        if (J2 + damping == 0.0)
+            damping = 1e-6;
+        const double step = -resid * dResid / (J2 + damping);
+
+        double dTrial;
+        const double trial = calcCircleResid(cl, u + step, dTrial);
+        ++numIterations;
+        if (SimTK::isFinite(trial) && std::abs(trial) < std::abs(resid)) {
+            u += step;
+            resid = trial;
+            dResid = dTrial;
+            damping *= 0.1;
+            if (std::abs(step) <= xtol * (std::abs(u) + scale))
+                break;
+        } else {
+            // Stop if even a tiny step cannot reduce the residual.
+            if (std::abs(step) <= xtol * (std::abs(u) + scale))
+                break;
+            damping = std::max(10.0 * damping, 1e-3 * J2);
+        }
+    }
+    return std::abs(resid) <= 1e-6 * scale && dResid > 0.0;
+}
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -233,6 +309,26 @@ SimTK::Real WrapTorus::getOuterRadius() const
 {
     return SimTK::Real(_outerRadius);
 }
+//_____________________________________________________________________________
+/**
+ * Set the inner radius of the torus (the radius of its tube)
+ *
+ * @param aRadius The inner radius of the torus
+ */
+void WrapTorus::setInnerRadius(SimTK::Real aRadius)
+{
+    _innerRadius = aRadius;
+}
+//_____________________________________________________________________________
+/**
+ * Set the outer radius of the torus (the radius of the axis of its tube)
+ *
+ * @param aRadius The outer radius of the torus
+ */
+void WrapTorus::setOuterRadius(SimTK::Real aRadius)
+{
+    _outerRadius = aRadius;
+}
 //=============================================================================
 // OPERATORS
 //=============================================================================
@@ -272,9 +368,20 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
     //bool constrained = (bool) (_wrapSign != 0);
     //bool far_side_wrap = false;
     aFlag = true;
+    aWrapResult.numIterations = 0;
 
-    if (findClosestPoint(_outerRadius, &aPoint1[0], &aPoint2[0], &closestPt[0], &closestPt[1], &closestPt[2], _wrapSign, _wrapAxis) == 0)
+    // The closest point of the previous wrap of this path is kept in c1.
+    const SimTK::Vec3& previousPt = aPathWrap.getPreviousWrap(s).c1;
+    const bool hasPreviousPt = previousPt[2] == 0.0 &&
+        std::abs(previousPt[0]*previousPt[0] + previousPt[1]*previousPt[1] -
+                 _outerRadius*_outerRadius) <= 1e-6*_outerRadius*_outerRadius;
+
+    if (findClosestPoint(_outerRadius, &aPoint1[0], &aPoint2[0], &closestPt[0], &closestPt[1], &closestPt[2], _wrapSign, _wrapAxis,
+                         aWrapResult.numIterations,
+                         hasPreviousPt ? &previousPt[0] : NULL) == 0)
         return noWrap;
+    const int numIterations = aWrapResult.numIterations;
+    const SimTK::Vec3 circlePt = closestPt;
 
     // Now put a cylinder at closestPt and call the cylinder wrap code.
     WrapCylinder cyl;//(rot, trans, quadrant, body, radius, length);
@@ -304,6 +411,8 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
     Vec3 p1 = cylinderToTorus.shiftFrameStationToBase(aPoint1);
     Vec3 p2 = cylinderToTorus.shiftFrameStationToBase(aPoint2);
     int return_code = cyl.wrapLine(s, p1, p2, aPathWrap, aWrapResult, aFlag);
+    aWrapResult.numIterations = numIterations;
+    aWrapResult.c1 = circlePt;
    if (aFlag == true && return_code > 0) {
         aWrapResult.r1 = cylinderToTorus.shiftBaseStationToFrame(aWrapResult.r1);
         aWrapResult.r2 = cylinderToTorus.shiftBaseStationToFrame(aWrapResult.r2);
@@ -328,98 +437,66 @@ int WrapTorus::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec3
  * @param zc The Z coordinate of the closest point
  * @param wrap_sign If wrap is constrained to a quadrant, the sign of the relevant axis
  * @param wrap_axis If wrap is constrained to a quadrant, the relevant axis
+ * @param numIterations Incremented by the number of evaluations of the residual
+ * @param previousPt The closest point of the previous wrap, to start from, or NULL
  * @return '1' if a closest point was found, '0' if there was an error while trying to constrain the wrap
  */
 int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
                                           double* xc, double* yc, double* zc,
-                                          int wrap_sign, int wrap_axis) const
+                                          int wrap_sign, int wrap_axis,
+                                          int& numIterations,
+                                          const double* previousPt) const
 {
-   int info;                  // output flag
-   int num_func_calls;        // number of calls to func (nfev)
-   int ldfjac = 1;            // leading dimension of fjac (nres)
-   int numResid = 1;
-   int numQs = 1;
-   double q[2], resid[2], fjac[2];            // m X n array
-   CircleCallback cb;
-   bool constrained = (bool) (wrap_sign != 0);
-   // solution parameters
-   int mode = 1, nprint = 0, max_iter = 500;
-   double ftol = 1e-4, xtol = 1e-4, gtol = 0.0;
-   double epsfcn = 0.0, step_factor = 0.2;
-   // work arrays
-   int ipvt[2];  
-   double diag[2], qtf[2], wa1[2], wa2[2], wa3[2], wa4[2];
    // Circle variables
-   double u, mag, nx, ny, nz, x, y, z, a1[3], a2[3], distance1, distance2, betterPt = 0;
-
-   cb.p1[0] = p1[0];
-   cb.p1[1] = p1[1];
-   cb.p1[2] = p1[2];
-   cb.p2[0] = p2[0];
-   cb.p2[1] = p2[1];
-   cb.p2[2] = p2[2];
-   cb.r = radius;
-
-   q[0] = 0.0;
-
-   lmdif_C(calcCircleResids, numResid, numQs, q, resid,
-           ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
-           nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
-           wa1, wa2, wa3, wa4, (void*)&cb);
-
-   u = q[0];
+   double u, mag, n[3], a1[3], a2[3], distance1, distance2, betterPt = 0;
+   bool constrained = (bool) (wrap_sign != 0);
 
    mag = sqrt((p2[0]-p1[0])*(p2[0]-p1[0]) + (p2[1]-p1[1])*(p2[1]-p1[1]) + (p2[2]-p1[2])*(p2[2]-p1[2]));
+   const double scale = mag + radius;
+
+   n[0] = (p2[0]-p1[0]) / mag;
+   n[1] = (p2[1]-p1[1]) / mag;
+   n[2] = (p2[2]-p1[2]) / mag;
+   const CircleLine line1 = makeCircleLine(p1, n, radius);
+
+   // Start from the point on the line nearest the previous closest point,
+   // if there is one. If the solution is a minimum on the correct half of
+   // the circle, it is the closest point as long as the path moved little
+   // since the previous wrap.
+   if (previousPt) {
+      u = (previousPt[0]-p1[0])*n[0] + (previousPt[1]-p1[1])*n[1] + (previousPt[2]-p1[2])*n[2];
+      if (solveCircleResid(line1, scale, u, numIterations)) {
+         for (int i = 0; i < 3; i++)
+            a1[i] = p1[i] + u * n[i];
+         if (!constrained || DSIGN(a1[wrap_axis]) == wrap_sign) {
+            mag = sqrt(a1[0]*a1[0] + a1[1]*a1[1]);
+            *xc = a1[0] * radius / mag;
+            *yc = a1[1] * radius / mag;
+            *zc = 0.0;
+            return 1;
+         }
+      }
+   }
 
-   nx = (p2[0]-p1[0]) / mag;
-   ny = (p2[1]-p1[1]) / mag;
-   nz = (p2[2]-p1[2]) / mag;
-
-   x = p1[0] + u * nx;
-   y = p1[1] + u * ny;
-   z = p1[2] + u * nz;
-
-   // Store the result from the first pass.
-   a1[0] = x;
-   a1[1] = y;
-   a1[2] = z;
+   // Otherwise, solve starting from each end of the line.
+   u = 0.0;
+   solveCircleResid(line1, scale, u, numIterations);
+   for (int i = 0; i < 3; i++)
+      a1[i] = p1[i] + u * n[i];
 
-   distance1 = sqrt(x*x + y*y + z*z + radius*radius - 2.0 * radius * sqrt(x*x + y*y));
+   distance1 = sqrt(a1[0]*a1[0] + a1[1]*a1[1] + a1[2]*a1[2] + radius*radius - 2.0 * radius * sqrt(a1[0]*a1[0] + a1[1]*a1[1]));
 
    // Perform the second pass, switching the order of the two points.
-   cb.p1[0] = p2[0];
-   cb.p1[1] = p2[1];
-   cb.p1[2] = p2[2];
-   cb.p2[0] = p1[0];
-   cb.p2[1] = p1[1];
-   cb.p2[2] = p1[2];
-   cb.r = radius;
-
-   q[0] = 0.0;
-
-   lmdif_C(calcCircleResids, numResid, numQs, q, resid,
-           ftol, xtol, gtol, max_iter, epsfcn, diag, mode, step_factor,
-           nprint, &info, &num_func_calls, fjac, ldfjac, ipvt, qtf,
-           wa1, wa2, wa3, wa4, (void*)&cb);
-
-   u = q[0];
-
-   mag = sqrt((p2[0]-p1[0])*(p2[0]-p1[0]) + (p2[1]-p1[1])*(p2[1]-p1[1]) + (p2[2]-p1[2])*(p2[2]-p1[2]));
-
-   nx = (p1[0]-p2[0]) / mag;
-   ny = (p1[1]-p2[1]) / mag;
-   nz = (p1[2]-p2[2]) / mag;
+   for (int i = 0; i < 3; i++)
+      n[i] = -n[i];
+   const CircleLine line2 = makeCircleLine(p2, n, radius);
 
-   x = p2[0] + u * nx;
-   y = p2[1] + u * ny;
-   z = p2[2] + u * nz;
+   u = 0.0;
+   solveCircleResid(line2, scale, u, numIterations);
+   for (int i = 0; i < 3; i++)
+      a2[i] = p2[i] + u * n[i];
 
-   // Store the result from the second pass.
-   a2[0] = x;
-   a2[1] = y;
-   a2[2] = z;
-
-   distance2 = sqrt(x*x + y*y + z*z + radius*radius - 2.0 * radius * sqrt(x*x + y*y));
+   distance2 = sqrt(a2[0]*a2[0] + a2[1]*a2[1] + a2[2]*a2[2] + radius*radius - 2.0 * radius * sqrt(a2[0]*a2[0] + a2[1]*a2[1]));
 
    // Now choose the better result from the two passes. If the circle is not
    // constrained, then just choose the one with the shortest distance. If the
@@ -476,44 +553,6 @@ int WrapTorus::findClosestPoint(double radius, double p1[], double p2[],
    return 1;
 }
 
-//_____________________________________________________________________________
-/**
- * A utility function used by findClosestPoint. The single residual that it
- * calculates is the distance between the current point and the circle.
- *
- * @param numResid The number of residuals (1)
- * @param numQs The number of degrees of freedom (1)
- * @param q Array of values of the degrees of freedom
- * @param resid Array of residuals to be calculated
- * @param flag2 A status flag
- * @param ptr Pointer to data structure containing current point and circle radius
- */
-void WrapTorus::calcCircleResids(int numResid, int numQs, double q[],
-                                            double resid[], int *flag2, void *ptr)
-{
-   double mag, nx, ny, nz, u;
-   double c2, c3, c4, c5/*, c6*/;
-   CircleCallback *cb = (CircleCallback*)ptr;
-
-   u = q[0];
-
-   mag = sqrt((cb->p2[0]-cb->p1[0])*(cb->p2[0]-cb->p1[0]) + (cb->p2[1]-cb->p1[1])*(cb->p2[1]-cb->p1[1]) +
-      (cb->p2[2]-cb->p1[2])*(cb->p2[2]-cb->p1[2]));
-
-   nx = (cb->p2[0]-cb->p1[0]) / mag;
-   ny = (cb->p2[1]-cb->p1[1]) / mag;
-   nz = (cb->p2[2]-cb->p1[2]) / mag;
-
-   c2 = 2.0 * (cb->p1[0]*nx + cb->p1[1]*ny + cb->p1[2]*nz);
-   c3 = cb->p1[0]*nx + cb->p1[1]*ny;
-   c4 = nx*nx + ny*ny;
-   c5 = cb->p1[0]*cb->p1[0] + cb->p1[1]*cb->p1[1];
-   //c6 = sqrt (u * u * c4 + 2.0 * c3 * u + c5);
-
-   resid[0] = c2 + 2.0 * u - 2.0 * cb->r * (2.0 * c4 * u + 2.0 * c3) / sqrt (u * u * c4 + 2.0 * c3 * u + c5);
-}
-
-
 // Implement generateDecorations by WrapTorus to replace the previous out of place implementation 
 // in ModelVisualizer, not implemented yet in API visualizer
 void WrapTorus::generateDecorations(bool fixed, const ModelDisplayHints& hints, const SimTK::State& state,
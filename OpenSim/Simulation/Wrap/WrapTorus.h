@@ -46,10 +46,6 @@ class OSIMSIMULATION_API WrapTorus : public WrapObject {
 OpenSim_DECLARE_CONCRETE_OBJECT(WrapTorus, WrapObject);
 
 private:
-    struct CircleCallback {
-        double p1[3], p2[3], r;
-    };
-
 //=============================================================================
 // DATA
 //=============================================================================
@@ -79,6 +75,8 @@ public:
     std::string getDimensionsString() const override;
     SimTK::Real getInnerRadius() const;
     SimTK::Real getOuterRadius() const;
+    void setInnerRadius(SimTK::Real aRadius);
+    void setOuterRadius(SimTK::Real aRadius);
 
     void scale(const SimTK::Vec3& aScaleFactors) override;
     void connectToModelAndBody(Model& aModel, PhysicalFrame& aBody) override;
@@ -94,9 +92,8 @@ private:
     void setNull();
     int findClosestPoint(double radius, double p1[], double p2[],
         double* xc, double* yc, double* zc,
-        int wrap_sign, int wrap_axis) const;
-    static void calcCircleResids(int numResid, int numQs, double q[],
-        double resid[], int *flag2, void *ptr);
+        int wrap_sign, int wrap_axis, int& numIterations,
+        const double* previousPt) const;
 
 //=============================================================================
 };  // END of class WrapTorus
@@ -26,6 +26,8 @@
 #include "Model/AnalysisSet.h"
 #include "Model/Bhargava2004MuscleMetabolicsProbe.h"
 #include "Model/Model.h"
+#include "Model/MeshCache.h"
+#include "Model/ModelCache.h"
 #include "Model/ModelVisualizer.h"
 #include "Model/ForceSet.h"
 #include "Model/BodyScale.h"
@@ -40,6 +42,7 @@
 #include "Model/CoordinateSet.h"
 #include "Model/ElasticFoundationForce.h"
 #include "Model/HuntCrossleyForce.h"
+#include "Model/SphereHalfSpaceContactForce.h"
 #include "Model/Ligament.h"
 #include "Model/JointSet.h"
 #include "Model/Marker.h"
@@ -52,15 +55,21 @@
 #include "Model/GeometryPath.h"
 #include "Model/PrescribedForce.h"
 #include "Model/PointToPointSpring.h"
+#include "Model/MultiExpressionProgram.h"
 #include "Model/ExpressionBasedPointToPointForce.h"
 #include "Model/ExpressionBasedCoordinateForce.h"
 #include "Model/PathSpring.h"
 #include "Model/BushingForce.h"
 #include "Model/FunctionBasedBushingForce.h"
 #include "Model/ExpressionBasedBushingForce.h"
+#include "Model/BatchedBushingForce.h"
 #include "Model/CoordinateLimitForce.h"
+#include "Model/BatchedCoordinateLimitForce.h"
 #include "Model/ExternalLoads.h"
 #include "Model/PathActuator.h"
+#include "Model/MuscleGroup.h"
+#include "Model/FunctionThresholdCondition.h"
+#include "Model/ConditionEvent.h"
 #include "Model/ActuatorPowerProbe.h"
 #include "Model/JointInternalPowerProbe.h"
 #include "Model/MuscleActiveFiberPowerProbe.h"
@@ -71,12 +80,16 @@
 #include "Model/Ground.h"
 
 #include "Manager/Manager.h"
+#include "Manager/EnsembleManager.h"
 
 #include "Control/ControlSet.h"
 #include "Control/ControlSetController.h"
 #include "Control/ControlConstant.h"
 #include "Control/ControlLinear.h"
 #include "Control/PrescribedController.h"
+#include "Control/LiveController.h"
+#include "Control/TaskSpaceController.h"
+#include "Control/ReflexController.h"
 #include "Wrap/PathWrap.h"
 #include "Wrap/PathWrapSet.h"
 #include "Wrap/WrapCylinder.h"
@@ -111,8 +124,10 @@
 #include "SimbodyEngine/SpatialTransform.h"
 
 #include "MomentArmSolver.h"
+#include "ImplicitDynamicsJacobian.h"
 #include "StatesTrajectory.h"
 #include "StatesTrajectoryReporter.h"
+#include "StatesFileReporter.h"
 
 #include "RegisterTypes_osimSimulation.h"   // to expose RegisterTypes_osimSimulation
 
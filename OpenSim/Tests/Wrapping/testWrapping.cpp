@@ -47,6 +47,9 @@ public:
 };
 
 void testWrapCylinder();
+void testWrapEllipsoidWarmStart();
+void testWrapTorusWarmStart();
+void testCurrentPathLocations();
 void simulate(Model& osimModel, State& si, double initialTime, double finalTime);
 void simulateModelWithMusclesNoViz(const string &modelFile, double finalTime, double activation=0.5);
 void simulateModelWithPassiveMuscles(const string &modelFile, double finalTime);
@@ -60,6 +63,9 @@ int main()
 
     try{
         testWrapCylinder();
+        testWrapEllipsoidWarmStart();
+        testWrapTorusWarmStart();
+        testCurrentPathLocations();
         // performance with multiple muscles and wrapping in upper-extremity
         simulateModelWithMusclesNoViz("TestShoulderModel.osim", 0.02);}
     catch (const std::exception& e) {
@@ -396,6 +402,151 @@ void testWrapCylinder()
     }
 }
 
+// The ellipsoid starts its search for the tangent points from the previous
+// wrap, which must give the same path as starting from scratch.
+void testWrapEllipsoidWarmStart()
+{
+    Model model("test_wrapEllipsoid_vasint.osim");
+    SimTK::State& s = model.initSystem();
+    const auto& muscle = model.getMuscles().get("vas_int_r");
+    const auto& pathWrap = muscle.getGeometryPath().getWrapSet().get(0);
+    const auto& coord = model.getCoordinateSet().get("knee_angle_r");
+
+    int numWarmIterations = 0;
+    int numColdIterations = 0;
+    int numWraps = 0;
+    const int nsteps = 100;
+    for (int i = 0; i <= nsteps; ++i) {
+        coord.setValue(s, -2.0 * i / nsteps);
+        SimTK::State cold(s);
+        cold.invalidateAllCacheAtOrAbove(SimTK::Stage::Position);
+        pathWrap.resetPreviousWrap(cold);
+
+        model.realizePosition(s);
+        const double warmLength = muscle.getLength(s);
+        model.realizePosition(cold);
+        const double coldLength = muscle.getLength(cold);
+        ASSERT_EQUAL<double>(coldLength, warmLength, 1e-4);
+
+        if (pathWrap.getPreviousWrap(s).wrap_pts.getSize() > 0) {
+            ++numWraps;
+            numWarmIterations += pathWrap.getPreviousWrap(s).numIterations;
+            numColdIterations += pathWrap.getPreviousWrap(cold).numIterations;
+        }
+    }
+    cout << "Ellipsoid tangent point iterations over " << numWraps
+         << " wraps: " << numWarmIterations << " (from previous wrap), "
+         << numColdIterations << " (from scratch)" << endl;
+    ASSERT(numWraps > 0, __FILE__, __LINE__, "Expected the path to wrap.");
+    ASSERT(numWarmIterations <= numColdIterations, __FILE__, __LINE__,
+        "Expected fewer iterations when starting from the previous wrap.");
+}
+
+// The torus starts its search for the closest point of its circle from the
+// previous wrap, which must give the same path as starting from scratch.
+void testWrapTorusWarmStart()
+{
+    Model model;
+    model.setName("testWrapTorusWarmStart");
+
+    auto& ground = model.updGround();
+    auto body = new OpenSim::Body("body", 1, Vec3(0), Inertia(0.1, 0.1, 0.01));
+    model.addComponent(body);
+
+    // The body turns about the axis of the torus.
+    auto joint = new PinJoint("pin", ground, *body);
+    model.addComponent(joint);
+
+    WrapTorus* torus = new WrapTorus();
+    torus->setName("torus");
+    torus->setInnerRadius(0.05);
+    torus->setOuterRadius(0.2);
+    ground.addWrapObject(torus);
+
+    // The spring passes through the hole of the torus, across its tube.
+    PathSpring* spring = new PathSpring("spring", 1.0, 0.1, 0.01);
+    spring->updGeometryPath().
+        appendNewPathPoint("origin", ground, Vec3(0.1, 0, 0.3));
+    spring->updGeometryPath().
+        appendNewPathPoint("insert", *body, Vec3(0.3, 0, -0.3));
+    spring->updGeometryPath().addPathWrap(*torus);
+    model.addComponent(spring);
+
+    SimTK::State& s = model.initSystem();
+    const auto& pathWrap = spring->getGeometryPath().getWrapSet().get(0);
+    const auto& coord = joint->getCoordinate();
+
+    int numWarmIterations = 0;
+    int numColdIterations = 0;
+    const int nsteps = 50;
+    for (int i = 0; i <= nsteps; ++i) {
+        coord.setValue(s, SimTK::Pi/2 * i / nsteps);
+        SimTK::State cold(s);
+        cold.invalidateAllCacheAtOrAbove(SimTK::Stage::Position);
+        pathWrap.resetPreviousWrap(cold);
+
+        model.realizePosition(s);
+        const double warmLength = spring->getLength(s);
+        model.realizePosition(cold);
+        const double coldLength = spring->getLength(cold);
+        ASSERT_EQUAL<double>(coldLength, warmLength, 1e-8);
+
+        numWarmIterations += pathWrap.getPreviousWrap(s).numIterations;
+        numColdIterations += pathWrap.getPreviousWrap(cold).numIterations;
+    }
+    cout << "Torus closest point iterations over " << nsteps + 1
+         << " wraps: " << numWarmIterations << " (from previous wrap), "
+         << numColdIterations << " (from scratch)" << endl;
+    ASSERT(numWarmIterations < numColdIterations, __FILE__, __LINE__,
+        "Expected fewer iterations when starting from the previous wrap.");
+}
+
+void testCurrentPathLocations()
+{
+    Model model("test_wrapEllipsoid_vasint.osim");
+    SimTK::State& s = model.initSystem();
+    const auto& path = model.getMuscles().get("vas_int_r").getGeometryPath();
+    const auto& coord = model.getCoordinateSet().get("knee_angle_r");
+
+    const double speed = 0.5;
+    const double h = 1e-6;
+    int numWraps = 0;
+    const int nsteps = 20;
+    for (int i = 0; i <= nsteps; ++i) {
+        const double angle = -2.0 * i / nsteps;
+        coord.setValue(s, angle);
+        coord.setSpeedValue(s, speed);
+        model.realizeVelocity(s);
+
+        const Array<PathPoint*>& points = path.getCurrentPath(s);
+        const SimTK::Array_<Vec3>& locations = path.getCurrentPathLocations(s);
+        ASSERT(int(locations.size()) == points.getSize());
+
+        double length = 0;
+        for (int j = 0; j < points.getSize(); ++j) {
+            const PathPoint& point = *points[j];
+            ASSERT_EQUAL(point.getParentFrame().getTransformInGround(s)*
+                         point.getLocation(s), locations[j], 1e-12);
+            if (j == 0) continue;
+            const auto* wrapPoint = dynamic_cast<const PathWrapPoint*>(&point);
+            if (wrapPoint && points[j-1]->getWrapObject() ==
+                             wrapPoint->getWrapObject()) {
+                length += wrapPoint->getWrapLength(s);
+                ++numWraps;
+            }
+            else
+                length += (locations[j] - locations[j-1]).norm();
+        }
+        ASSERT_EQUAL(length, path.getLength(s), 1e-12);
+
+        // The lengthening speed matches the change in length.
+        SimTK::State after(s);
+        coord.setValue(after, angle + h*speed);
+        ASSERT_EQUAL((path.getLength(after) - path.getLength(s))/h,
+                     path.getLengtheningSpeed(s), 1e-4);
+    }
+    ASSERT(numWraps > 0, __FILE__, __LINE__, "Expected the path to wrap.");
+}
 
 void simulateModelWithMusclesNoViz(const string &modelFile, double finalTime, double activation)
 {
@@ -616,15 +767,15 @@ void simulateModelWithCables(const string &modelFile, double finalTime)
             }
             else { // next two path points should be a wrap point
                 for (int k = 0; k < wrapSet.getSize(); ++k) {
-                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap().r1;
-                    if (!wrapStartPointLoc.isInf() && pp->getLocation().isNumericallyEqual(wrapStartPointLoc)) {
+                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap(si).r1;
+                    if (!wrapStartPointLoc.isInf() && pp->getLocation(si).isNumericallyEqual(wrapStartPointLoc)) {
                         ObstacleInfo* obs = wrapObs[k];
                         obs->isActive = true;
                         // pp and next pp are wrap points
                         Transform X_SB = obs->X_BS.invert();
                         PathPoint* pp_next = activePathPoints[++i]; // increment to next pp
-                        obs->P_S = X_SB*pp->getLocation();
-                        obs->Q_S = X_SB*pp_next->getLocation();
+                        obs->P_S = X_SB*pp->getLocation(si);
+                        obs->Q_S = X_SB*pp_next->getLocation(si);
                         cableInfo.obstacles.insert(obsIdx++, *obs);
                         break;
                     }
@@ -139,16 +139,20 @@ prepareToOptimize(SimTK::State& s, double *x)
     // i.e. assume we're solving
     //   min || _accelPerformanceMatrix * x + _accelPerformanceVector ||^2 + || _forcePerformanceMatrix * x + _forcePerformanceVector || ^2
     f = 0;
-    computePerformanceVectors(s, f, _accelPerformanceVector, _forcePerformanceVector);
+    // The actuators stay overridden for all the columns, so that only the
+    // forces and accelerations are realized again for each of them.
+    setActuatorsOverridden(s, true);
+    computePerformanceVectors(s, f, _accelPerformanceVector, _forcePerformanceVector, false);
 
 
     for(int j=0; j<nf; j++) {
         f[j] = 1;
-        computePerformanceVectors(s, f, accelVec, forceVec);
+        computePerformanceVectors(s, f, accelVec, forceVec, false);
         for(int i=0; i<nacc; i++) _accelPerformanceMatrix(i,j) = (accelVec[i] - _accelPerformanceVector[i]);
         for(int i=0; i<nf; i++) _forcePerformanceMatrix(i,j) = (forceVec[i] - _forcePerformanceVector[i]);
         f[j] = 0;
     }
+    setActuatorsOverridden(s, false);
 
 #ifdef USE_LAPACK_DIRECT_SOLVE
     // 
@@ -226,14 +230,15 @@ prepareToOptimize(SimTK::State& s, double *x)
 }
 
 void ActuatorForceTarget::
-computePerformanceVectors(SimTK::State& s, const Vector &aF, Vector &rAccelPerformanceVector, Vector &rForcePerformanceVector)
+computePerformanceVectors(SimTK::State& s, const Vector &aF, Vector &rAccelPerformanceVector, Vector &rForcePerformanceVector,
+                          bool overrideActuators)
 {
     const Set<const Actuator> &fSet = _controller->getActuatorSet();
 
+    if(overrideActuators) setActuatorsOverridden(s, true);
     for(int i=0;i<fSet.getSize();i++) {
         auto act = dynamic_cast<const ScalarActuator*>(&fSet[i]);
         act->setOverrideActuation(s, aF[i]);
-        act->overrideActuation(s, true);
     }
 
     _controller->getModel().getMultibodySystem().realize(s, SimTK::Stage::Acceleration );
@@ -255,9 +260,19 @@ computePerformanceVectors(SimTK::State& s, const Vector &aF, Vector &rAccelPerfo
     for(int i=0;i<nacc;i++) rAccelPerformanceVector[i] = sqrt(w[i]) * (a[i] - aDes[i]);
 
     // reset the actuator control
+    if(overrideActuators) setActuatorsOverridden(s, false);
+}
+//______________________________________________________________________________
+/**
+ * Turn overriding the actuation of all the actuators on or off.
+ */
+void ActuatorForceTarget::
+setActuatorsOverridden(SimTK::State& s, bool flag) const
+{
+    const Set<const Actuator> &fSet = _controller->getActuatorSet();
     for(int i=0;i<fSet.getSize();i++) {
         auto act = dynamic_cast<const ScalarActuator*>(&fSet[i]);
-        act->overrideActuation(s, false);
+        act->overrideActuation(s, flag);
     }
 }
 
@@ -118,7 +118,12 @@ public:
     int gradientFunc(const SimTK::Vector &x, bool new_coefficients, SimTK::Vector &gradient ) const override;
 
 private:
-    void computePerformanceVectors(SimTK::State& s, const SimTK::Vector &aF, SimTK::Vector &rAccelPerformanceVector, SimTK::Vector &rForcePerformanceVector);
+    /** Compute the performance vectors for the forces aF. Unless
+    overrideActuators is false, in which case the actuators must already be
+    overridden, the actuators are overridden for this computation only. */
+    void computePerformanceVectors(SimTK::State& s, const SimTK::Vector &aF, SimTK::Vector &rAccelPerformanceVector, SimTK::Vector &rForcePerformanceVector,
+                                   bool overrideActuators=true);
+    void setActuatorsOverridden(SimTK::State& s, bool flag) const;
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 };  // END class ActuatorForceTarget
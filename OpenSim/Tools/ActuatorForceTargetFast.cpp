@@ -129,14 +129,19 @@ prepareToOptimize(SimTK::State& s, double *x)
     // Build linear constraint matrix and constant constraint vector
     f = 0;
 
-    computeConstraintVector(s, f, _constraintVector);
+    // The actuators stay overridden for all the columns, so that only the
+    // forces and accelerations are realized again for each of them.
+    setActuatorsOverridden(s, true);
+    computeConstraintVector(s, f, _constraintVector, false);
 
     for(int j=0; j<nf; j++) {
         f[j] = 1;
-        computeConstraintVector(s, f, c);
+        computeConstraintVector(s, f, c, false);
         _constraintMatrix(j) = (c - _constraintVector);
         f[j] = 0;
     }
+    setActuatorsOverridden(s, false);
+    _controller->getModel().getMultibodySystem().realizeModel(s);
 #endif
 
     // use temporary copy of state because computeIsokineticForceAssumingInfinitelyStiffTendon
@@ -167,7 +172,33 @@ prepareToOptimize(SimTK::State& s, double *x)
 
         _recipOptForceSquared[i] = 1.0 / (fOpt*fOpt);   
     }
-    
+
+#ifdef USE_LINEAR_CONSTRAINT_MATRIX
+    // Unless states are tracked, the cost is a weighted sum of the squared
+    // forces, so the problem is a quadratic program that can be solved
+    // directly.
+    bool trackingStates = false;
+    const CMC_TaskSet& tset = _controller->getTaskSet();
+    for(int t=0; t<tset.getSize(); t++)
+        if(dynamic_cast<StateTrackingTask*>(&tset.get(t))) trackingStates = true;
+
+    if(!trackingStates && getHasLimits()) {
+        Vector weights(nf);
+        for(int i=0; i<nf; i++) {
+            const bool isMuscle = dynamic_cast<const Muscle*>(&fSet[i]) != NULL;
+            weights[i] = isMuscle ? _recipOptForceSquared[i]
+                                  : _recipAreaSquared[i];
+        }
+        double *lower, *upper;
+        getParameterLimits(&lower, &upper);
+        Vector forces(nf, x, true);
+        if(SolveQuadraticProgram(weights, _constraintMatrix, _constraintVector,
+                Vector(nf, lower, true), Vector(nf, upper, true),
+                _activeBounds, forces))
+            return true;
+    }
+#endif
+
     // return false to indicate that we still need to proceed with optimization (did not do a lapack direct solve)
     return false;
 }
@@ -294,7 +325,8 @@ constraintFunc(const SimTK::Vector &x, const bool new_coefficients, SimTK::Vecto
  * Compute all constraints given x.
  */
 void ActuatorForceTargetFast::
-computeConstraintVector(SimTK::State& s, const Vector &x,Vector &c) const
+computeConstraintVector(SimTK::State& s, const Vector &x,Vector &c,
+                        bool overrideActuators) const
 {
     CMC_TaskSet&  taskSet = _controller->updTaskSet();
     const Set<const Actuator>& fSet = _controller->getActuatorSet();
@@ -304,9 +336,9 @@ computeConstraintVector(SimTK::State& s, const Vector &x,Vector &c) const
     // Now override the actuator forces with computed active force
     // (from static optimization) but also include the passive force
     // contribution of muscles when applying forces to the model
+    if(overrideActuators) setActuatorsOverridden(s, true);
     for(int i=0;i<nf;i++) {
         auto act = dynamic_cast<const ScalarActuator*>(&fSet[i]);
-        act->overrideActuation(s, true);
         act->setOverrideActuation(s, x[i]);
     }
     _controller->getModel().getMultibodySystem().realize(s, SimTK::Stage::Acceleration );
@@ -321,12 +353,23 @@ computeConstraintVector(SimTK::State& s, const Vector &x,Vector &c) const
         c[i]=w[i]*(aDes[i]-a[i]);
 
     // reset the actuator control 
+    if(overrideActuators) {
+        setActuatorsOverridden(s, false);
+        _controller->getModel().getMultibodySystem().realizeModel(s);
+    }
+}
+//______________________________________________________________________________
+/**
+ * Turn overriding the actuation of all the actuators on or off.
+ */
+void ActuatorForceTargetFast::
+setActuatorsOverridden(SimTK::State& s, bool flag) const
+{
+    const Set<const Actuator>& fSet = _controller->getActuatorSet();
     for(int i=0;i<fSet.getSize();i++) {
         auto act = dynamic_cast<const ScalarActuator*>(&fSet[i]);
-        act->overrideActuation(s, false);
+        act->overrideActuation(s, flag);
     }
-
-    _controller->getModel().getMultibodySystem().realizeModel(s);
 }
 //______________________________________________________________________________
 /**
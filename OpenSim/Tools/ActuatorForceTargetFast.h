@@ -90,6 +90,8 @@ private:
 
     SimTK::Matrix _constraintMatrix;
     SimTK::Vector _constraintVector;
+    /** Bounds active at the last direct solution, for the next one. */
+    Array<int> _activeBounds;
     
     // Save a (copy) of the state for state tracking purposes
     SimTK::State    _saveState;
@@ -119,7 +121,12 @@ public:
     int constraintJacobian(const SimTK::Vector &x, bool new_coefficients, SimTK::Matrix &jac) const override;
     CMC* getController() {return (_controller); }
 private:
-    void computeConstraintVector(SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c) const;
+    /** Compute the constraints for the forces x. Unless overrideActuators is
+    false, in which case the actuators must already be overridden, the
+    actuators are overridden for this computation only. */
+    void computeConstraintVector(SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c,
+                                 bool overrideActuators=true) const;
+    void setActuatorsOverridden(SimTK::State& s, bool flag) const;
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 };  // END class ActuatorForceTargetFast
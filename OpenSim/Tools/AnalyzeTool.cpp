@@ -23,6 +23,8 @@
 #include "AnalyzeTool.h"
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/ToolProfile.h>
+#include <OpenSim/Common/ThreadPool.h>
 
 #include <OpenSim/Simulation/Control/ControlLinear.h>
 #include <OpenSim/Simulation/Control/ControlSet.h>
@@ -35,6 +37,11 @@
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Actuators/Thelen2003Muscle.h>
 
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <vector>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -196,6 +203,7 @@ setNull()
 
     _printResultFiles = true;
     _replaceForceSet = false;
+    _numThreads = 1;
 }
 //_____________________________________________________________________________
 /**
@@ -261,6 +269,7 @@ operator=(const AnalyzeTool &aTool)
     _lowpassCutoffFrequency= aTool._lowpassCutoffFrequency;
     _statesStore = aTool._statesStore;
     _printResultFiles = aTool._printResultFiles;
+    _numThreads = aTool._numThreads;
     return(*this);
 }
 
@@ -477,6 +486,13 @@ setPrintResultFiles(bool aToWrite)
     _printResultFiles=aToWrite;
 }
 
+void AnalyzeTool::setNumThreads(int aNumThreads)
+{
+    OPENSIM_THROW_IF_FRMOBJ(aNumThreads < 1, Exception,
+        "The number of threads must be at least 1.");
+    _numThreads = aNumThreads;
+}
+
 void AnalyzeTool::
 disableIntegrationOnlyProbes()
 {
@@ -513,7 +529,11 @@ bool AnalyzeTool::run(bool plotting)
         throw(Exception(msg,__FILE__,__LINE__));
     }
 
+    // The model was loaded when the tool was constructed.
+    ToolProfile profile(getConcreteClassName() + " " + getName());
+
     // Use the Dynamics Tool API to handle external loads instead of outdated AbstractTool
+    profile.beginPhase("initialize system");
     /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model);
 
 //printf("\nbefore AnalyzeTool.run() initSystem \n");
@@ -522,8 +542,10 @@ bool AnalyzeTool::run(bool plotting)
 
     _model->getMultibodySystem().realize(s, SimTK::Stage::Position );
 //printf("after AnalyzeTool.run() initSystem \n\n");
+    profile.endPhase();
 
     if(_loadModelAndInput) {
+        ToolProfile::Scope phase(profile, "read inputs");
         loadStatesFromFile(s);
     }
 
@@ -568,7 +590,9 @@ bool AnalyzeTool::run(bool plotting)
     //}
 
     cout<<"Executing the analyses from "<<ti<<" to "<<tf<<"..."<<endl;
-    run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates);
+    ToolProfile::Scope phase(profile, "analyze frames");
+    run(s, *_model, iInitial, iFinal, *_statesStore,
+        _solveForEquilibriumForAuxiliaryStates, _numThreads);
     _model->getMultibodySystem().realize(s, SimTK::Stage::Position );
     } catch (const Exception& x) {
         x.print(cout);
@@ -579,9 +603,12 @@ bool AnalyzeTool::run(bool plotting)
 
     // PRINT RESULTS
     // TODO: give option to write partial results if not completed
-    if (completed && _printResultFiles)
+    if (completed && _printResultFiles) {
+        ToolProfile::Scope phase(profile, "write outputs");
         printResults(getName(),getResultsDir()); // this will create results directory if necessary
+    }
 
+    profile.printReports(getResultsDir());
     IO::chDir(saveWorkingDirectory);
 
     return completed;
@@ -642,6 +669,8 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
     // model defaults.
     SimTK::Vector stateValues = aModel.getStateVariableValues(s);
 
+    const SimTK::Stage requiredStage = analysisSet.getRequiredStage();
+
     for(int i=iInitial;i<=iFinal;i++) {
         // tPrev = t;
         aStatesStore.getTime(i,s.updTime()); // time
@@ -667,6 +696,10 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
                 // muscle length is shorter than the tendon slack-length.
                 // the muscle will throw an Exception in this case.
                 aModel.equilibrateMuscles(s);
+                // Muscle states that are not in the storage start from this
+                // frame's solution at the next frame, which is much closer to
+                // the next solution than their default values.
+                stateValues = aModel.getStateVariableValues(s);
             }
             catch (const std::exception& e) {
                 cout << "WARNING- AnalyzeTool::run() unable to equilibrate muscles ";
@@ -674,8 +707,9 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
                 cout << "Reason: " << e.what() << endl;
             }
         }
-        // Make sure model is at least ready to provide kinematics
-        aModel.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+        // Realize only as far as the analyses need, so that kinematic
+        // analyses do not pay for computing forces
+        aModel.getMultibodySystem().realize(s, requiredStage);
 
         if(i==iInitial) {
             analysisSet.begin(s);
@@ -687,3 +721,80 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         }
     }
 }
+
+void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
+                      const Storage &aStatesStore, bool aSolveForEquilibrium,
+                      int aNumThreads)
+{
+    AnalysisSet& analysisSet = aModel.updAnalysisSet();
+    bool canMerge = true;
+    for(int i=0;i<analysisSet.getSize();i++) {
+        const Analysis& analysis = analysisSet.get(i);
+        if(analysis.getOn() && !analysis.canMerge()) {
+            if(aNumThreads > 1)
+                cout << "AnalyzeTool: analysis '" << analysis.getName()
+                     << "' depends on the previous frames, so the frames are "
+                     << "analyzed on one thread." << endl;
+            canMerge = false;
+        }
+    }
+
+    // Each part has at least two frames, at which its analyses begin and end.
+    const int numFrames = iFinal - iInitial + 1;
+    const int numParts =
+        std::min(ThreadPool::getNumRanges(numFrames, aNumThreads),
+                 numFrames/2);
+    if(!canMerge || numParts <= 1) {
+        run(s, aModel, iInitial, iFinal, aStatesStore, aSolveForEquilibrium);
+        return;
+    }
+
+    // The first part is analyzed with the given model and analyses, and the
+    // others with copies of them, which are created here since initializing
+    // models concurrently is not safe.
+    struct Part {
+        int first;
+        int last;
+        std::unique_ptr<Model> model;
+        SimTK::State state;
+    };
+    std::vector<Part> parts(numParts);
+    for(int p=0;p<numParts;p++) {
+        Part& part = parts[p];
+        part.first = iInitial + p*numFrames/numParts;
+        part.last = iInitial + (p+1)*numFrames/numParts - 1;
+        if(p == 0) continue;
+        part.model.reset(aModel.clone());
+        for(int i=0;i<analysisSet.getSize();i++) {
+            if(analysisSet.get(i).getOn())
+                part.model->addAnalysis(analysisSet.get(i).clone());
+        }
+        part.state = part.model->initSystem();
+        part.model->updAnalysisSet().setModel(*part.model);
+    }
+
+    ThreadPool::parallelFor(numParts, aNumThreads, [&](int p) {
+        Part& part = parts[p];
+        if(p == 0)
+            run(s, aModel, part.first, part.last, aStatesStore,
+                aSolveForEquilibrium);
+        else
+            run(part.state, *part.model, part.first, part.last,
+                aStatesStore, aSolveForEquilibrium);
+    });
+
+    // Append the results of the copies in the order of the frames, and leave
+    // the state at the last frame, as when the frames are analyzed in order.
+    for(int p=1;p<numParts;p++) {
+        AnalysisSet& copies = parts[p].model->updAnalysisSet();
+        int k = 0;
+        for(int i=0;i<analysisSet.getSize();i++) {
+            if(analysisSet.get(i).getOn())
+                analysisSet.get(i).merge(copies.get(k++));
+        }
+    }
+    const Part& last = parts.back();
+    s.setTime(last.state.getTime());
+    aModel.setStateVariableValues(s,
+        last.model->getStateVariableValues(last.state));
+}
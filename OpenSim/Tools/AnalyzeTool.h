@@ -77,6 +77,9 @@ private:
 
     /** Whether the model and states should be loaded from input files */
     bool _loadModelAndInput;
+
+    /** Number of threads over which the frames are analyzed. */
+    int _numThreads;
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -129,6 +132,20 @@ public:
     void loadStatesFromFile(SimTK::State& s ) SWIG_DECLARE_EXCEPTION;
     void verifyControlsStates();
     void setPrintResultFiles(bool aToWrite);
+    /** %Set the number of threads over which run() divides the frames, each
+    thread analyzing consecutive frames with its own copy of the model and
+    of the analyses. The default, 1, analyzes the frames in order on the
+    calling thread. Frames are analyzed in parallel only if every analysis
+    that is on can merge the results of its copies (see
+    Analysis::canMerge()); analyses integrating over time cannot.
+
+    The copies of the model are initialized by Model::initSystem(), so only
+    the state variables in the states storage are carried over to them.
+    When solving for the equilibrium of the auxiliary states, each thread
+    starts its first frame from the default values of these states rather
+    than from the solution at the previous frame. */
+    void setNumThreads(int aNumThreads);
+    int getNumThreads() const { return _numThreads; }
     void disableIntegrationOnlyProbes();
     //--------------------------------------------------------------------------
     // INTERFACE
@@ -141,6 +158,11 @@ public:
     //--------------------------------------------------------------------------
 #ifndef SWIG
     static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium);
+    /** Analyze the frames from iInitial to iFinal over the given number of
+    threads (see setNumThreads()). */
+    static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
+                    const Storage &aStatesStore, bool aSolveForEquilibrium,
+                    int aNumThreads);
 #endif
 //=============================================================================
 };  // END of class AnalyzeTool
@@ -1063,10 +1063,10 @@ void CMC::computeControls(const SimTK::State& s, SimTK::Vector& controls)  const
     SimTK_ASSERT( _controlSet.getSize() == getActuatorSet().getSize() , 
         "CMC::computeControls number of controls does not match number of actuators.");
     
-    SimTK::Vector actControls(1, 0.0);
     for(int i=0; i<getActuatorSet().getSize(); i++){
-        actControls[0] = _controlSet[_controlSetIndices[i]].getControlValue(s.getTime());
-        getActuatorSet()[i].addInControls(actControls, controls);
+        getActuatorSet()[i].addInControl(
+            _controlSet[_controlSetIndices[i]].getControlValue(s.getTime()),
+            controls);
     }
 
     // double *val = &controls[0];
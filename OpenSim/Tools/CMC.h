@@ -57,6 +57,16 @@ class CMC_TaskSet;
  * is the musculoskeletal system (human or animal), hence the name
  * Computed Muscle Control.
  *
+ * CMC only needs the desired kinematics over the current target interval,
+ * so it can also track kinematics that arrive while it runs (e.g., from an
+ * inverse kinematics stream). Append the incoming frames to a Storage, give
+ * the tasks (and the actuator force predictor) the functions of a
+ * GCVSplineSet, and before computing the controls of each interval call
+ * GCVSplineSet::fitWindow() over the frames from a short history up to the
+ * end of the interval. The splines are fit again in place, so the cost of
+ * each interval depends on the length of the window rather than that of the
+ * trial.
+ *
  * For a complete description of the CMC algorithm consult the following
  * references:
  *
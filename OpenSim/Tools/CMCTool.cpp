@@ -28,6 +28,7 @@
 #include "VectorFunctionForActuators.h"
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/ToolProfile.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Model/CMCActuatorSubsystem.h>
@@ -403,6 +404,10 @@ bool CMCTool::run()
     // SET OUTPUT PRECISION
     IO::SetPrecision(_outputPrecision);
 
+    // The model was loaded when the tool was constructed.
+    ToolProfile profile(getConcreteClassName() + " " + getName());
+
+    profile.beginPhase("initialize system");
     /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model);
 
     CMC_TaskSet taskSet(_taskSetFileName);           
@@ -428,6 +433,10 @@ bool CMCTool::run()
     _model->getMultibodySystem().realize(s, Stage::Position );
      taskSet.setModel(*_model);
     _model->equilibrateMuscles(s);
+    profile.endPhase();
+
+    // Reading the desired kinematics and setting up the controller.
+    profile.beginPhase("read inputs");
   
     // ---- INPUT ----
     // DESIRED POINTS AND KINEMATICS
@@ -829,7 +838,9 @@ bool CMCTool::run()
     // Set output file names so that files are flushed regularly in case we fail
     IO::makeDir(getResultsDir());   // Create directory for output in case it doesn't exist
     manager.getStateStorage().setOutputFileName(getResultsDir() + "/" + getName() + "_states.sto");
+    profile.endPhase();
     try {
+        ToolProfile::Scope phase(profile, "track kinematics");
         manager.integrate(s);
     }
     catch(const Exception& x) {
@@ -863,6 +874,7 @@ bool CMCTool::run()
     cout<<"================================================================\n\n\n";
 
     // ---- RESULTS -----
+    profile.beginPhase("write outputs");
     printResults(getName(),getResultsDir()); // this will create results directory if necessary
     controller->updControlSet().print(getResultsDir() + "/" + getName() + "_controls.xml");
     _model->printControlStorage(getResultsDir() + "/" + getName() + "_controls.sto");
@@ -874,6 +886,8 @@ bool CMCTool::run()
     statesDegrees.print(getResultsDir() + "/" + getName() + "_states_degrees.mot");
     */
     controller->getPositionErrorStorage()->print(getResultsDir() + "/" + getName() + "_pErr.sto");
+    profile.endPhase();
+    profile.printReports(getResultsDir());
 
     //_model->removeController(controller); // So that if this model is from GUI it doesn't double-delete it.
 
@@ -123,6 +123,7 @@ setNull()
     _vErr[0] = _vErr[1] = _vErr[2] = 0.0;
     _aDes[0] = _aDes[1] = _aDes[2] = 0.0;
     _a[0] = _a[1] = _a[2] = 0.0;
+    clearTaskKinematics();
     _j = NULL;
     _m = NULL;
 }
@@ -219,6 +220,8 @@ copyData(const CMC_Task &aTask)
     aTask.getDirection_1(_r1);
     aTask.getDirection_2(_r2);
 
+    clearTaskKinematics();
+
     // FUNCTIONS
     const Function *func;
     for(i=0;i<3;i++) {
@@ -679,6 +682,7 @@ getTaskPosition(int aWhich,double aT) const
         string msg = "CMC_Task: ERR- Invalid task.";
         throw( Exception(msg,__FILE__,__LINE__) );
     }
+    if(aT==_tPV) return(_pTrkValue[aWhich]);
     double position = _pTrk[aWhich]->calcValue(SimTK::Vector(1,aT));
     return(position);
 }
@@ -699,6 +703,8 @@ getTaskVelocity(int aWhich,double aT) const
         throw( Exception(msg,__FILE__,__LINE__) );
     }
 
+    if(aT==_tPV) return(_vTrkValue[aWhich]);
+
     double velocity;
     if(_vTrk[aWhich]!=NULL) {
         velocity = _vTrk[aWhich]->calcValue(SimTK::Vector(1,aT));
@@ -726,6 +732,8 @@ getTaskAcceleration(int aWhich,double aT) const
         throw( Exception(msg,__FILE__,__LINE__) );
     }
 
+    if(aT==_tA) return(_aTrkValue[aWhich]);
+
     double acceleration;
     if(_aTrk[aWhich]!=NULL) {
         acceleration = _aTrk[aWhich]->calcValue(SimTK::Vector(1,aT));
@@ -738,6 +746,40 @@ getTaskAcceleration(int aWhich,double aT) const
 
     return( acceleration );
 }
+//_____________________________________________________________________________
+/**
+ * Set the task positions and velocities at one time and the task
+ * accelerations at another, evaluated together for all tasks by the task
+ * set. getTaskPosition(), getTaskVelocity() and getTaskAcceleration() return
+ * them when called at those times, instead of evaluating the task
+ * functions, until clearTaskKinematics() is called.
+ *
+ * @param aTI Time of the task positions and velocities (in real time units).
+ * @param aP Task positions.
+ * @param aV Task velocities.
+ * @param aTF Time of the task accelerations (in real time units).
+ * @param aA Task accelerations.
+ */
+void CMC_Task::
+setTaskKinematics(double aTI,const SimTK::Vec3& aP,const SimTK::Vec3& aV,
+    double aTF,const SimTK::Vec3& aA)
+{
+    _tPV = aTI;
+    _pTrkValue = aP;
+    _vTrkValue = aV;
+    _tA = aTF;
+    _aTrkValue = aA;
+}
+//_____________________________________________________________________________
+/**
+ * Clear the task kinematics set by setTaskKinematics(), so that the task
+ * functions are evaluated again.
+ */
+void CMC_Task::
+clearTaskKinematics()
+{
+    _tPV = _tA = SimTK::NaN;
+}
 
 
 //-----------------------------------------------------------------------------
@@ -117,6 +117,18 @@ protected:
     SimTK::Vec3 _aDes;
     /** Accelerations. */
     SimTK::Vec3 _a;
+    /** Time at which the task positions and velocities were evaluated by
+    the task set (NaN if they were not). */
+    double _tPV;
+    /** Task positions evaluated by the task set. */
+    SimTK::Vec3 _pTrkValue;
+    /** Task velocities evaluated by the task set. */
+    SimTK::Vec3 _vTrkValue;
+    /** Time at which the task accelerations were evaluated by the task set
+    (NaN if they were not). */
+    double _tA;
+    /** Task accelerations evaluated by the task set. */
+    SimTK::Vec3 _aTrkValue;
     /** Jacobian. */
     double *_j;
     /** Effective mass matrix. */
@@ -192,6 +204,9 @@ public:
     double getTaskPosition(int aWhich,double aT) const;
     double getTaskVelocity(int aWhich,double aT) const;
     double getTaskAcceleration(int aWhich,double aT) const;
+    void setTaskKinematics(double aTI,const SimTK::Vec3& aP,
+        const SimTK::Vec3& aV,double aTF,const SimTK::Vec3& aA);
+    void clearTaskKinematics();
     // LAST ERRORS
     void setPositionErrorLast(double aE0,double aE1=0.0,double aE2=0.0);
     double getPositionErrorLast(int aWhich) const;
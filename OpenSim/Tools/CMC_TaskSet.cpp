@@ -127,6 +127,7 @@ setNull()
     _w.setSize(0);
     _aDes.setSize(0);
     _a.setSize(0);
+    _taskFunctions.setMemoryOwner(false);
 }
 //_____________________________________________________________________________
 /**
@@ -781,6 +782,87 @@ recordErrorsAsLastErrors()
     }
 }
 //_____________________________________________________________________________
+/**
+ * Evaluate the task functions of all tasks together and give each task its
+ * positions and velocities at aTI and accelerations at aTF. The functions are
+ * usually splines fit to the same times, so the interval of each time is
+ * searched for once for all of them, and the value and first two derivatives
+ * of each spline come from the same pass.
+ *
+ * @param aTI Time of the task positions and velocities in real time units.
+ * @param aTF Time of the task accelerations in real time units.
+ */
+void CMC_TaskSet::
+evaluateTaskFunctions(double aTI,double aTF)
+{
+    // GATHER THE FUNCTIONS
+    // Index in _taskFunctions of the position, velocity and acceleration
+    // functions of each task goal, or -1.
+    _taskFunctions.setMemoryOwner(false);
+    _taskFunctions.setSize(0);
+    int size = getSize();
+    std::vector<int> index(9*size,-1);
+    auto add = [&](Function *aF) {
+        if(aF==NULL) return -1;
+        _taskFunctions.adoptAndAppend(aF);
+        return _taskFunctions.getSize()-1;
+    };
+    int i,j;
+    for(i=0;i<size;i++) {
+        CMC_Task *task = dynamic_cast<CMC_Task*>(&get(i));
+        if(task==NULL) continue;
+        for(j=0;j<task->getNumTaskFunctions();j++) {
+            if(task->getTaskFunction(j)==NULL) break;
+            index[9*i+3*j] = add(task->getTaskFunction(j));
+            index[9*i+3*j+1] = add(task->getTaskFunctionForVelocity(j));
+            index[9*i+3*j+2] = add(task->getTaskFunctionForAcceleration(j));
+        }
+    }
+    if(_taskFunctions.getSize()==0) return;
+
+    // EVALUATE
+    SimTK::Vector valuesI,firstI,secondI,valuesF,firstF,secondF;
+    _taskFunctions.evaluateWithDerivatives(aTI,valuesI,firstI,secondI);
+    if(aTF!=aTI) {
+        _taskFunctions.evaluateWithDerivatives(aTF,valuesF,firstF,secondF);
+    } else {
+        valuesF = valuesI;
+        secondF = secondI;
+    }
+
+    // SET THE TASK KINEMATICS
+    for(i=0;i<size;i++) {
+        CMC_Task *task = dynamic_cast<CMC_Task*>(&get(i));
+        if(task==NULL) continue;
+        if(index[9*i]<0) continue;
+        SimTK::Vec3 p(0.0),v(0.0),a(0.0);
+        for(j=0;j<task->getNumTaskFunctions();j++) {
+            int iP = index[9*i+3*j];
+            if(iP<0) break;
+            int iV = index[9*i+3*j+1];
+            int iA = index[9*i+3*j+2];
+            p[j] = valuesI[iP];
+            v[j] = (iV<0) ? firstI[iP] : valuesI[iV];
+            a[j] = (iA<0) ? secondF[iP] : valuesF[iA];
+        }
+        task->setTaskKinematics(aTI,p,v,aTF,a);
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Clear the task kinematics given to the tasks by evaluateTaskFunctions(),
+ * and release the task functions, which belong to the tasks.
+ */
+void CMC_TaskSet::
+clearTaskKinematics()
+{
+    for(int i=0;i<getSize();i++) {
+        CMC_Task *task = dynamic_cast<CMC_Task*>(&get(i));
+        if(task!=NULL) task->clearTaskKinematics();
+    }
+    _taskFunctions.setSize(0);
+}
+//_____________________________________________________________________________
 /**
  * Compute the errors for all tasks.
  *
@@ -792,6 +874,8 @@ computeErrors(const SimTK::State& s, double aT)
     _pErr.setSize(0);
     _vErr.setSize(0);
 
+    evaluateTaskFunctions(aT,aT);
+
     int i,j;
     for(i=0;i<getSize();i++) {
 
@@ -814,6 +898,8 @@ computeErrors(const SimTK::State& s, double aT)
             _vErr.append(task.getVelocityError(j));
         }
     }
+
+    clearTaskKinematics();
 }
 //_____________________________________________________________________________
 /**
@@ -828,6 +914,8 @@ computeDesiredAccelerations(const SimTK::State& s, double aT)
     _w.setSize(0);
     _aDes.setSize(0);
 
+    evaluateTaskFunctions(aT,aT);
+
     int i,j;
     for(i=0;i<getSize();i++) {
 
@@ -851,6 +939,8 @@ computeDesiredAccelerations(const SimTK::State& s, double aT)
         }
     }
 
+    clearTaskKinematics();
+
     //printf("CMC_TaskSet.computeDesiredAccelerations: %d ",_aDes.size());
     //printf("track goals are active.\n");
 }
@@ -872,6 +962,8 @@ computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF)
     _w.setSize(0);
     _aDes.setSize(0);
 
+    evaluateTaskFunctions(aTI,aTF);
+
     int i,j;
     for(i=0;i<getSize();i++) {
 
@@ -895,6 +987,8 @@ computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF)
         }
     }
 
+    clearTaskKinematics();
+
     //printf("CMC_TaskSet.computeDesiredAccelerations: %d ",_aDes.size());
     //printf("track goals are active.\n");
 }
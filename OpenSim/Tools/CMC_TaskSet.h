@@ -29,6 +29,7 @@
 
 // INCLUDES
 #include <OpenSim/Common/FunctionSet.h>
+#include <OpenSim/Common/GCVSplineSet.h>
 #include "CMC_Task.h"
 
 namespace OpenSim {
@@ -87,6 +88,9 @@ protected:
 
     FunctionSet  _functions;
 
+    /** The task functions of all tasks (not owned), evaluated together. */
+    GCVSplineSet _taskFunctions;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -110,6 +114,8 @@ public:
 private:
     void setNull();
     void setupProperties();
+    void evaluateTaskFunctions(double aTI,double aTF);
+    void clearTaskKinematics();
 
     //--------------------------------------------------------------------------
     // GET AND SET
@@ -221,16 +221,15 @@ void CorrectionController::computeControls(const SimTK::State& s, SimTK::Vector&
     Array<double> yDesired(0.0,nq+nu);
     getDesiredStatesStorage().getDataAtTime(t, nq+nu,yDesired);
     
-    SimTK::Vector actControls(1, 0.0);
-
     for(int i=0; i< getActuatorSet().getSize(); i++){
         auto act = 
             dynamic_cast<const CoordinateActuator*>(&getActuatorSet().get(i));
         SimTK_ASSERT( act,  "CorrectionController::computeControls dynamic cast failed");
 
         Coordinate *aCoord = act->getCoordinate();
+        double actControl = 0.0;
         if( aCoord->isConstrained(s) ) {
-            actControls =  0.0;
+            actControl =  0.0;
         } 
         else
         {
@@ -243,9 +242,9 @@ void CorrectionController::computeControls(const SimTK::State& s, SimTK::Vector&
             double vErr = uval - yDesired[2*i+1];
             double pErrTerm = _kp*oneOverFmax*pErr;
             double vErrTerm = _kv*oneOverFmax*vErr;
-            actControls = -vErrTerm - pErrTerm;
+            actControl = -vErrTerm - pErrTerm;
         }
-        getActuatorSet()[i].addInControls(actControls, controls);
+        getActuatorSet()[i].addInControl(actControl, controls);
     }
 }
 
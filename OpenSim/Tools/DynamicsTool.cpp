@@ -29,6 +29,8 @@
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/Storage.h>
 
+#include <memory>
+
 using namespace OpenSim;
 using namespace std;
 using namespace SimTK;
@@ -302,3 +304,39 @@ bool DynamicsTool::createExternalLoads( const string& aExternalLoadsFileName, Mo
     IO::chDir(savedCwd);
     return(true);
 }
+
+void DynamicsTool::hashInputs(std::uint64_t& hash) const
+{
+    // The model and the external loads are read from the current directory.
+    if (_model) hashString(_model->dump(true), hash);
+    else hashFile(_modelFileName, hash);
+
+    if (_externalLoadsFileName == "" ||
+            _externalLoadsFileName == "Unassigned")
+        return;
+    hashFile(_externalLoadsFileName, hash);
+
+    // The files it refers to are relative to the external loads file.
+    std::unique_ptr<Object> object(
+            Object::makeObjectFromFile(_externalLoadsFileName));
+    const ExternalLoads* loads = dynamic_cast<ExternalLoads*>(object.get());
+    OPENSIM_THROW_IF_FRMOBJ(!loads, Exception,
+        "File '" + _externalLoadsFileName + "' does not contain an "
+        "ExternalLoads object.");
+    string kinematicsFileName = loads->getExternalLoadsModelKinematicsFileName();
+    IO::TrimLeadingWhitespace(kinematicsFileName);
+
+    std::string savedCwd = IO::getCwd();
+    IO::chDir(IO::getParentDirectory(_externalLoadsFileName));
+    try {
+        if (loads->getDataFileName() != "" &&
+                loads->getDataFileName() != "Unassigned")
+            hashFile(loads->getDataFileName(), hash);
+        if (kinematicsFileName != "" && kinematicsFileName != "Unassigned")
+            hashFile(kinematicsFileName, hash);
+    } catch (...) {
+        IO::chDir(savedCwd);
+        throw;
+    }
+    IO::chDir(savedCwd);
+}
@@ -143,6 +143,10 @@ public:
 
     virtual bool run() override SWIG_DECLARE_EXCEPTION=0;
 
+protected:
+    /** The model (its file, or the model given with setModel()), and the
+    external loads file with the data files it refers to. */
+    void hashInputs(std::uint64_t& hash) const override;
 
 //=============================================================================
 };  // END of class DynamicsTool
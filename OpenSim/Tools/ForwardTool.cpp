@@ -26,6 +26,7 @@
 #include <OpenSim/Common/XMLDocument.h>
 #include "ForwardTool.h"
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/ToolProfile.h>
 
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
@@ -36,6 +37,29 @@ using namespace std;
 using namespace SimTK;
 using namespace OpenSim;
 
+namespace {
+// Add the counters of an integration to the profile of the run.
+void addCounts(ToolProfile& profile,
+               const Manager::IntegrationStatistics& stats)
+{
+    profile.addCount("integrator steps taken", stats.numStepsTaken);
+    profile.addCount("integrator steps attempted", stats.numStepsAttempted);
+    profile.addCount("error test failures", stats.numErrorTestFailures);
+    profile.addCount("convergence test failures",
+                     stats.numConvergenceTestFailures);
+    profile.addCount("integrator iterations", stats.numIterations);
+    profile.addCount("integrator realizations", stats.numRealizations);
+    profile.addCount("projections", stats.numProjections);
+    for (int level = 0; level < (int)stats.numRealizationsOfStage.size();
+            ++level)
+        profile.addCount(std::string("realizations of ") +
+                         Stage(level).getName(),
+                         stats.numRealizationsOfStage[level]);
+    for (const auto& count : stats.componentIterations)
+        profile.addCount(count.first, count.second);
+}
+}
+
 
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
@@ -246,14 +270,21 @@ bool ForwardTool::run()
     string directoryOfSetupFile = IO::getParentDirectory(getDocumentFileName());
     IO::chDir(directoryOfSetupFile);
 
+    // The model was loaded when the tool was constructed.
+    ToolProfile profile(getConcreteClassName() + " " + getName());
+
+    profile.beginPhase("initialize system");
     /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model);
 
 
     // Re create the system with forces above and Realize the topology
     SimTK::State& s = _model->initSystem();
     _model->getMultibodySystem().realize(s, Stage::Position );
+    profile.endPhase();
 
+    profile.beginPhase("read inputs");
     loadStatesStorage(_statesFileName, _yStore);
+    profile.endPhase();
 
     // set the desired states for controllers  
     _model->updControllerSet().setDesiredStates( _yStore );
@@ -309,10 +340,13 @@ bool ForwardTool::run()
 
     try {
         // INTEGRATE
+        ToolProfile::Scope phase(profile, "integrate");
         _model->printDetailedInfo(s, std::cout );
 
         cout<<"\n\nIntegrating from "<<_ti<<" to "<<_tf<<endl;
         manager.integrate(s);
+        manager.printIntegrationStatistics(cout);
+        addCounts(profile, manager.getIntegrationStatistics());
     } catch(const std::exception& x) {
         cout << "ForwardTool::run() caught exception \n";
         cout << x.what() << endl;
@@ -326,8 +360,13 @@ bool ForwardTool::run()
     }
     // PRINT RESULTS
     string fileName;
-    if(_printResultFiles) printResults();
+    if(_printResultFiles) {
+        ToolProfile::Scope phase(profile, "write outputs");
+        printResults();
+    }
 
+    // The working directory was already restored if integration failed.
+    if (completed) profile.printReports(getResultsDir());
     IO::chDir(saveWorkingDirectory);
 
     removeAnalysisSetFromModel();
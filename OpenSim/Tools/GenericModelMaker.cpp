@@ -26,6 +26,7 @@
 //=============================================================================
 #include "GenericModelMaker.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelCache.h>
 
 //=============================================================================
 // STATICS
@@ -159,7 +160,7 @@ Model* GenericModelMaker::processModel(const string& aPathToSubject) const
 
     try
     {
-        model = new Model(aPathToSubject + _fileName);
+        model = ModelCache::loadToolModel(aPathToSubject + _fileName);
         model->initSystem();
 
         if (!_markerSetFileNameProp.getValueIsDefault() && _markerSetFileName !="Unassigned") {
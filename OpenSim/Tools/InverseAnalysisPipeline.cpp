@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  InverseAnalysisPipeline.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "InverseAnalysisPipeline.h"
+#include "InverseKinematicsTool.h"
+#include "InverseDynamicsTool.h"
+#include "AnalyzeTool.h"
+
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelCache.h>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+// Sets the lowpass cutoff frequencies of the tools for the duration of a
+// scope, and restores them when it is left.
+class CutoffFrequencyOverride {
+public:
+    CutoffFrequencyOverride(InverseDynamicsTool& id, AnalyzeTool& analyze,
+                            double frequency)
+    :   _id(id), _analyze(analyze),
+        _idFrequency(id.getLowpassCutoffFrequency()),
+        _analyzeFrequency(analyze.getLowpassCutoffFrequency()) {
+        _id.setLowpassCutoffFrequency(frequency);
+        _analyze.setLowpassCutoffFrequency(frequency);
+    }
+    ~CutoffFrequencyOverride() {
+        _id.setLowpassCutoffFrequency(_idFrequency);
+        _analyze.setLowpassCutoffFrequency(_analyzeFrequency);
+    }
+private:
+    InverseDynamicsTool& _id;
+    AnalyzeTool& _analyze;
+    const double _idFrequency;
+    const double _analyzeFrequency;
+};
+}
+
+InverseAnalysisPipeline::InverseAnalysisPipeline() = default;
+InverseAnalysisPipeline::~InverseAnalysisPipeline() = default;
+
+void InverseAnalysisPipeline::setModel(const Model& model)
+{
+    _model.reset(model.clone());
+}
+
+const Storage& InverseAnalysisPipeline::getMotion() const
+{
+    OPENSIM_THROW_IF(!_ikTool, Exception,
+        "InverseAnalysisPipeline: no InverseKinematicsTool was given.");
+    return _ikTool->getOutputStorage();
+}
+
+void InverseAnalysisPipeline::run()
+{
+    OPENSIM_THROW_IF(!_ikTool, Exception,
+        "InverseAnalysisPipeline: no InverseKinematicsTool was given.");
+
+    // Parse the model file once; each tool gets its own copy.
+    if (!_model) {
+        OPENSIM_THROW_IF(_ikTool->getModelFileName().empty(), Exception,
+            "InverseAnalysisPipeline: no model was given and the "
+            "InverseKinematicsTool has no model file.");
+        // The model file is relative to the setup file of the tool.
+        const string saveWorkingDirectory = IO::getCwd();
+        const string& setupFile = _ikTool->getDocumentFileName();
+        if (!setupFile.empty()) IO::chDir(IO::getParentDirectory(setupFile));
+        try {
+            _model.reset(
+                ModelCache::loadToolModel(_ikTool->getModelFileName()));
+        } catch (...) {
+            IO::chDir(saveWorkingDirectory);
+            throw;
+        }
+        IO::chDir(saveWorkingDirectory);
+    }
+
+    _ikModel.reset(_model->clone());
+    _ikTool->setModel(*_ikModel);
+    _ikTool->run();
+
+    if (!_idTool && !_analyzeTool) return;
+
+    // The motion is in degrees, as written to the output motion file.
+    Storage motion(_ikTool->getOutputStorage());
+
+    // Both tools pad and lowpass filter the coordinates in the same way, so
+    // if their cutoff frequencies are the same, filter once and let neither
+    // tool filter again.
+    unique_ptr<CutoffFrequencyOverride> noFiltering;
+    if (_idTool && _analyzeTool &&
+            _idTool->getLowpassCutoffFrequency() >= 0 &&
+            _idTool->getLowpassCutoffFrequency() ==
+            _analyzeTool->getLowpassCutoffFrequency()) {
+        cout << "\n\nLow-pass filtering coordinates data with a cutoff "
+            "frequency of " << _idTool->getLowpassCutoffFrequency()
+            << "..." << endl << endl;
+        motion.pad(motion.getSize()/2);
+        motion.lowpassIIR(_idTool->getLowpassCutoffFrequency());
+        noFiltering.reset(
+                new CutoffFrequencyOverride(*_idTool, *_analyzeTool, -1));
+    }
+
+    if (_idTool) {
+        _idModel.reset(_model->clone());
+        _idTool->setModel(*_idModel);
+        _idTool->setCoordinateValues(motion);
+        _idTool->run();
+    }
+
+    if (_analyzeTool) {
+        _analyzeModel.reset(_model->clone());
+        const string& setupFile = _analyzeTool->getDocumentFileName();
+        if (!setupFile.empty())
+            _analyzeTool->updateModelForces(*_analyzeModel, setupFile);
+        _analyzeTool->setModel(*_analyzeModel);
+        _analyzeTool->setLoadModelAndInput(false);
+        SimTK::State& s = _analyzeModel->initSystem();
+        _analyzeTool->setStatesFromMotion(s, motion, motion.isInDegrees());
+        _analyzeTool->run();
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef OPENSIM_INVERSE_ANALYSIS_PIPELINE_H_
+#define OPENSIM_INVERSE_ANALYSIS_PIPELINE_H_
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  InverseAnalysisPipeline.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+
+#include <memory>
+
+namespace OpenSim {
+
+class Model;
+class Storage;
+class InverseKinematicsTool;
+class InverseDynamicsTool;
+class AnalyzeTool;
+
+/** Runs an InverseKinematicsTool and then, on the motion it solves, an
+InverseDynamicsTool and/or an AnalyzeTool (e.g., with a StaticOptimization
+analysis) in one process. Compared to running the tools one after another
+from their setup files, the pipeline
+
+- parses the model file once: each tool runs on its own copy of the model,
+  so that the forces and analyses a tool adds do not affect the others;
+- passes the motion from inverse kinematics to the other tools in memory
+  instead of writing and reading back the .mot file (the tools still write
+  their output files, as given in their setup files); and
+- if the InverseDynamicsTool and the AnalyzeTool filter the coordinates with
+  the same cutoff frequency, filters them once for both.
+
+The tools are given by reference and must outlive run(); they are
+typically constructed from their setup files. Construct the AnalyzeTool
+with `aLoadModelAndInput = false`, so that it neither loads its own model
+nor reads its coordinates or states file:
+
+@code
+InverseKinematicsTool ik("subject01_Setup_IK.xml");
+InverseDynamicsTool id("subject01_Setup_ID.xml", false);
+AnalyzeTool so("subject01_Setup_SO.xml", false);
+InverseAnalysisPipeline pipeline;
+pipeline.setInverseKinematicsTool(ik);
+pipeline.setInverseDynamicsTool(&id);
+pipeline.setAnalyzeTool(&so);
+pipeline.run();
+@endcode
+
+The model is read from the model file of the InverseKinematicsTool (relative
+to its setup file) unless one is given with setModel(). The forces given in
+the setup file of the AnalyzeTool (e.g., reserve actuators) are added to
+its copy of the model. */
+class OSIMTOOLS_API InverseAnalysisPipeline {
+public:
+    InverseAnalysisPipeline();
+    ~InverseAnalysisPipeline();
+
+    InverseAnalysisPipeline(const InverseAnalysisPipeline&) = delete;
+    InverseAnalysisPipeline& operator=(const InverseAnalysisPipeline&) = delete;
+
+    /** Use a copy of this model instead of reading the model file of the
+    InverseKinematicsTool. */
+    void setModel(const Model& model);
+
+    void setInverseKinematicsTool(InverseKinematicsTool& tool)
+    {   _ikTool = &tool; }
+    /** The InverseDynamicsTool to run on the motion, or nullptr (the
+    default) for none. */
+    void setInverseDynamicsTool(InverseDynamicsTool* tool)
+    {   _idTool = tool; }
+    /** The AnalyzeTool to run on the motion, or nullptr (the default) for
+    none. */
+    void setAnalyzeTool(AnalyzeTool* tool)
+    {   _analyzeTool = tool; }
+
+    /** Run the tools in order. The tools keep referring to their copies of
+    the model until the pipeline is destroyed or run again.
+    @throws Exception if no InverseKinematicsTool was given or a tool
+    fails. */
+    void run();
+
+    /** The motion solved by inverse kinematics in the last run(). */
+    const Storage& getMotion() const;
+
+private:
+    InverseKinematicsTool* _ikTool = nullptr;
+    InverseDynamicsTool* _idTool = nullptr;
+    AnalyzeTool* _analyzeTool = nullptr;
+
+    std::unique_ptr<Model> _model;
+    std::unique_ptr<Model> _ikModel;
+    std::unique_ptr<Model> _idModel;
+    std::unique_ptr<Model> _analyzeModel;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_INVERSE_ANALYSIS_PIPELINE_H_
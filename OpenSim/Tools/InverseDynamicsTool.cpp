@@ -26,12 +26,20 @@
 //=============================================================================
 #include "InverseDynamicsTool.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelCache.h>
 #include <OpenSim/Simulation/InverseDynamicsSolver.h>
 #include <OpenSim/Common/XMLDocument.h>
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Common/FunctionSet.h> 
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/ToolProfile.h>
+#include <OpenSim/Common/ThreadPool.h>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <vector>
 
 using namespace OpenSim;
 using namespace std;
@@ -60,7 +68,8 @@ InverseDynamicsTool::InverseDynamicsTool() : DynamicsTool(),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
     _outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
     _jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
 }
@@ -79,7 +88,8 @@ InverseDynamicsTool::InverseDynamicsTool(const string &aFileName, bool aLoadMode
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
     _outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
     _jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     updateFromXMLDocument();
@@ -101,7 +111,8 @@ InverseDynamicsTool::InverseDynamicsTool(const InverseDynamicsTool &aTool) :
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
     _outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
     _jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     *this = aTool;
@@ -148,6 +159,12 @@ void InverseDynamicsTool::setupProperties()
     _outputBodyForcesAtJointsFileNameProp.setName("output_body_forces_file");
     _outputBodyForcesAtJointsFileNameProp.setValue("body_forces_at_joints.sto");
     _propertySet.append(&_outputBodyForcesAtJointsFileNameProp);
+
+    _numThreadsProp.setComment("Number of threads used to solve the time frames. "
+        "With more than one thread, frames are solved in parallel, each thread with its own copy of the model.");
+    _numThreadsProp.setName("number_of_threads");
+    _numThreadsProp.setValue(1);
+    _propertySet.append(&_numThreadsProp);
 }
 
 //_____________________________________________________________________________
@@ -179,6 +196,7 @@ operator=(const InverseDynamicsTool &aTool)
     _lowpassCutoffFrequency = aTool._lowpassCutoffFrequency;
     _outputGenForceFileName = aTool._outputGenForceFileName;
     _outputBodyForcesAtJointsFileName = aTool._outputBodyForcesAtJointsFileName;
+    _numThreads = aTool._numThreads;
     _coordinateValues = NULL;
 
     return(*this);
@@ -235,23 +253,41 @@ bool InverseDynamicsTool::run()
 {
     bool success = false;
     bool modelFromFile=true;
+
+    // Keep the results of the last run if its inputs were the same.
+    string inputHash;
+    if (getUseCachedResults()) {
+        inputHash = computeInputHash();
+        if (findCachedResults(inputHash)) {
+            cout << "Results of tool " << getName() << " are up to date; "
+                 << "not running it again." << endl;
+            return true;
+        }
+    }
+
     try{
+        ToolProfile profile(getConcreteClassName() + " " + getName());
+
         //Load and create the indicated model
+        profile.beginPhase("load model");
         if (!_model) {
             OPENSIM_THROW_IF_FRMOBJ(_modelFileName.empty(), Exception,
                 "No model filename was provided.")
 
-            _model = new Model(_modelFileName);
+            _model = ModelCache::loadToolModel(_modelFileName);
         }
         else
             modelFromFile = false;
+        profile.endPhase();
         _model->printBasicInfo(cout);
 
         cout<<"Running tool " << getName() <<".\n"<<endl;
 
+        profile.beginPhase("initialize system");
         /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model, _coordinateValues);
         // Initialize the model's underlying computational system and get its default state.
         SimTK::State& s = _model->initSystem();
+        profile.endPhase();
 
         // Do the maneuver to change then restore working directory 
         // so that the parsing code behaves properly if called from a different directory.
@@ -264,6 +300,7 @@ bool InverseDynamicsTool::run()
 
         FunctionSet *coordFunctions = NULL;
 
+        profile.beginPhase("read inputs");
         if (loadCoordinateValues()){
             if(_lowpassCutoffFrequency>=0) {
                 cout << "\n\nLow-pass filtering coordinates data with a cutoff frequency of "
@@ -277,7 +314,9 @@ bool InverseDynamicsTool::run()
                 _model->getSimbodyEngine().convertDegreesToRadians(*_coordinateValues);
             }
             // Create differentiable splines of the coordinate data
+            profile.beginPhase("fit splines");
             coordFunctions = new GCVSplineSet(5, _coordinateValues);
+            profile.endPhase();
 
             //Functions must correspond to model coordinates and their order for the solver
             for(int i=0; i<nq; i++){
@@ -301,6 +340,7 @@ bool InverseDynamicsTool::run()
             throw Exception("InverseDynamicsTool: no coordinate file found, "
                 " or setCoordinateValues() was not called.");
         }
+        profile.endPhase();
 
         // Exclude user-specified forces from the dynamics for this analysis
         disableModelForces(*_model, s, _excludedForces);
@@ -329,14 +369,22 @@ bool InverseDynamicsTool::run()
         // Preallocate results
         Array_<Vector> genForceTraj(nt, Vector(nq, 0.0));
 
+        profile.beginPhase("solve frames");
+
         // solve for the trajectory of generalized forces that correspond to the 
-        // coordinate trajectories provided
-        ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+        // coordinate trajectories provided. Analyses must step through the
+        // frames in order, so they are only supported by the serial solve.
+        if (_numThreads > 1 && nt > 1 && _model->getAnalysisSet().getSize() == 0)
+            solveInParallel(*coordFunctions, times, genForceTraj);
+        else
+            ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+        profile.endPhase();
         success = true;
 
         cout << "InverseDynamicsTool: " << nt << " time frames in " 
             << (double)(clock()-start)/CLOCKS_PER_SEC << "s\n" <<endl;
     
+        profile.beginPhase("write outputs");
         JointSet jointsForEquivalentBodyForces;
         getJointsByName(*_model, _jointsForReportingBodyForces, jointsForEquivalentBodyForces);
         int nj = jointsForEquivalentBodyForces.getSize();
@@ -417,17 +465,106 @@ bool InverseDynamicsTool::run()
             Storage::printResult(&bodyForcesResults, _outputBodyForcesAtJointsFileName, getResultsDir(), -1, ".sto");
             IO::chDir(saveWorkingDirectory);
         }
+        profile.endPhase();
 
+        // The results directory is relative to the setup file.
+        IO::chDir(directoryOfSetupFile);
+        profile.printReports(getResultsDir());
+        IO::chDir(saveWorkingDirectory);
+
+        if (!inputHash.empty()) recordCachedResults(inputHash);
     }
     catch (const OpenSim::Exception& ex) {
         std::cout << "InverseDynamicsTool Failed: " << ex.what() << std::endl;
         throw (Exception("InverseDynamicsTool Failed, please see messages window for details..."));
     }
 
-    if (modelFromFile) delete _model;
+    if (modelFromFile) { delete _model; _model = NULL; }
     return success;
 }
 
+void InverseDynamicsTool::hashInputs(std::uint64_t& hash) const
+{
+    Super::hashInputs(hash);
+
+    if (_coordinateValues) {
+        // Given in memory (or read by a previous run).
+        const Array<std::string>& labels = _coordinateValues->getColumnLabels();
+        for (int i = 0; i < labels.getSize(); ++i)
+            hashString(labels[i], hash);
+        const bool inDegrees = _coordinateValues->isInDegrees();
+        hashBytes(&inDegrees, sizeof(inDegrees), hash);
+        for (int i = 0; i < _coordinateValues->getSize(); ++i) {
+            const StateVector& row = *_coordinateValues->getStateVector(i);
+            const double time = row.getTime();
+            hashBytes(&time, sizeof(time), hash);
+            if (row.getSize() > 0)
+                hashBytes(&row.getData()[0], row.getSize()*sizeof(double),
+                          hash);
+        }
+        return;
+    }
+
+    // The coordinates file is relative to the setup file.
+    if (_coordinatesFileName != "" && _coordinatesFileName != "Unassigned") {
+        string saveWorkingDirectory = IO::getCwd();
+        IO::chDir(IO::getParentDirectory(getDocumentFileName()));
+        try {
+            hashFile(_coordinatesFileName, hash);
+        } catch (...) {
+            IO::chDir(saveWorkingDirectory);
+            throw;
+        }
+        IO::chDir(saveWorkingDirectory);
+    }
+}
+
+void InverseDynamicsTool::appendOutputFiles(
+        std::vector<std::string>& fileNames) const
+{
+    // As Storage::printResult() names them.
+    const auto withExtension = [](const string& name) {
+        return name.rfind(".sto") == string::npos ? name + ".sto" : name;
+    };
+    fileNames.push_back(
+            getResultsFilePath(withExtension(_outputGenForceFileName)));
+    if (_jointsForReportingBodyForces.getSize() > 0) {
+        fileNames.push_back(getResultsFilePath(
+                withExtension(_outputBodyForcesAtJointsFileName)));
+    }
+}
+
+void InverseDynamicsTool::solveInParallel(const FunctionSet& coordFunctions,
+    const Array_<double>& times, Array_<Vector>& genForceTrajectory)
+{
+    const int nt = times.size();
+    const int nChunks = std::min(ThreadPool::getNumThreads(_numThreads), nt);
+    genForceTrajectory.resize(nt, Vector(_model->getNumCoordinates()));
+
+    // Every chunk gets its own model, state and copy of the coordinate
+    // functions, since splines keep mutable workspaces for evaluation. The
+    // copies are made on this thread since initSystem() is not guaranteed to
+    // be thread-safe.
+    std::vector<std::unique_ptr<Model>> models;
+    std::vector<SimTK::State> states;
+    std::vector<std::unique_ptr<FunctionSet>> functions;
+    for (int c = 0; c < nChunks; ++c) {
+        models.emplace_back(_model->clone());
+        models.back()->updAnalysisSet().setSize(0);
+        states.push_back(models.back()->initSystem());
+        disableModelForces(*models.back(), states.back(), _excludedForces);
+        functions.emplace_back(coordFunctions.clone());
+    }
+
+    ThreadPool::parallelForRanges(nt, nChunks,
+        [&](int c, int first, int last) {
+            InverseDynamicsSolver ivdSolver(*models[c]);
+            for (int i = first; i < last; ++i)
+                genForceTrajectory[i] =
+                    ivdSolver.solve(states[c], *functions[c], times[i]);
+        });
+}
+
 bool InverseDynamicsTool::loadCoordinateValues()
 {
     if (_coordinateValues!= NULL) // Coordinates has been set from GUI
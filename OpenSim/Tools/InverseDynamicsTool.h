@@ -37,6 +37,7 @@ namespace OpenSim {
 
 class Model;
 class JointSet;
+class FunctionSet;
 
 //=============================================================================
 //=============================================================================
@@ -88,6 +89,10 @@ protected:
     PropertyStr _outputBodyForcesAtJointsFileNameProp;
     std::string &_outputBodyForcesAtJointsFileName;
 
+    /** number of worker threads used to solve the time frames */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -109,12 +114,25 @@ protected:
     /** helper method to get a list of model joints by name */
     void getJointsByName(Model &model, const Array<std::string> &jointNames, JointSet &joints) const;
 
+    /** The inputs of DynamicsTool, and the coordinates (their file, or the
+    values given with setCoordinateValues()). */
+    void hashInputs(std::uint64_t& hash) const override;
+    /** The generalized forces file, and the body forces file if body forces
+    are reported. */
+    void appendOutputFiles(std::vector<std::string>& fileNames) const override;
+
 private:
     void setNull();
     void setupProperties();
     /* If CoordinatesFile property is populated, load data into a live _coordinateValues
     storage object. */
     bool loadCoordinateValues();
+    /* Solve for the generalized forces at the given times by splitting the
+    frames into contiguous chunks, each solved on its own thread with its own
+    copy of the model, State and coordinate functions. */
+    void solveInParallel(const FunctionSet& coordFunctions,
+        const SimTK::Array_<double>& times,
+        SimTK::Array_<SimTK::Vector>& genForceTrajectory);
 
     //--------------------------------------------------------------------------
     // OPERATORS
@@ -156,6 +174,12 @@ public:
     void setLowpassCutoffFrequency(double aFrequency) {
         _lowpassCutoffFrequency = aFrequency;
     }
+    /** %Set the number of threads used to solve the time frames. Frames are
+        independent once the coordinates are splined, so with more than one
+        thread they are solved in parallel and written in time order. Models
+        with analyses are always solved serially. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
     //--------------------------------------------------------------------------
     // INTERFACE
     //--------------------------------------------------------------------------
@@ -25,14 +25,20 @@
 //=============================================================================
 #include "InverseKinematicsTool.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelCache.h>
 #include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/GaussNewtonIKSolver.h>
+#include <OpenSim/Simulation/MarkersReference.h>
 
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/ToolProfile.h>
 #include <OpenSim/Common/FunctionSet.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/Common/ThreadPool.h>
 
 #include <OpenSim/Analyses/Kinematics.h>
 
@@ -40,11 +46,94 @@
 #include "IKCoordinateTask.h"
 #include "IKMarkerTask.h"
 
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <memory>
+#include <vector>
 
 using namespace OpenSim;
 using namespace std;
 using namespace SimTK;
 
+namespace {
+    // Solution of a single frame computed by a worker thread. Frames are
+    // solved out of order but reported in order once all workers finish.
+    struct IKFrameSolution {
+        SimTK::Vector q;
+        SimTK::Array_<double> squaredMarkerErrors;
+        SimTK::Array_<Vec3> markerLocations;
+        int numIterations = 0;
+    };
+
+    // Track the frame at the time of the state, and compute the marker errors
+    // and locations that are reported. Returns the number of iterations.
+    template <typename IKSolverType>
+    int trackFrame(IKSolverType& ikSolver, SimTK::State& s,
+            bool computeErrors, bool computeLocations,
+            SimTK::Array_<double>& squaredMarkerErrors,
+            SimTK::Array_<Vec3>& markerLocations)
+    {
+        ikSolver.track(s);
+        if (computeErrors)
+            ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
+        if (computeLocations)
+            ikSolver.computeCurrentMarkerLocations(markerLocations);
+        return ikSolver.getNumIterations();
+    }
+
+    // Solve all frames by splitting them into contiguous chunks, one per
+    // thread. Each chunk has its own copy of the model, references and solver
+    // so that no mutable state is shared between threads, and starts with a
+    // full assemble() at its first frame before tracking the rest.
+    template <typename IKSolverType>
+    void solveFramesInParallel(const Model& model,
+            const MarkersReference& markersReference,
+            const SimTK::Array_<CoordinateReference>& coordinateReferences,
+            double constraintWeight, double accuracy,
+            double startTime, double dt, int numThreads,
+            bool computeErrors, bool computeLocations,
+            std::vector<IKFrameSolution>& frames)
+    {
+        const int nFrames = int(frames.size());
+        const int nChunks = ThreadPool::getNumRanges(nFrames, numThreads);
+
+        // Copies are made on this thread since initSystem() is not
+        // guaranteed to be thread-safe.
+        std::vector<std::unique_ptr<Model>> models;
+        std::vector<std::unique_ptr<MarkersReference>> markersRefs;
+        std::vector<SimTK::Array_<CoordinateReference>> coordinateRefs(
+                nChunks, coordinateReferences);
+        for (int c = 0; c < nChunks; ++c) {
+            models.emplace_back(model.clone());
+            models.back()->updAnalysisSet().setSize(0);
+            models.back()->initSystem();
+            markersRefs.emplace_back(new MarkersReference(markersReference));
+        }
+
+        ThreadPool::parallelForRanges(nFrames, nChunks, numThreads,
+            [&](int c, int first, int last) {
+                Model& chunkModel = *models[c];
+                SimTK::State s = chunkModel.getWorkingState();
+                IKSolverType ikSolver(chunkModel,
+                        *markersRefs[c], coordinateRefs[c],
+                        constraintWeight);
+                ikSolver.setAccuracy(accuracy);
+                s.updTime() = startTime + first*dt;
+                ikSolver.assemble(s);
+
+                for (int i = first; i < last; ++i) {
+                    s.updTime() = startTime + i*dt;
+                    IKFrameSolution& frame = frames[i];
+                    frame.numIterations = trackFrame(ikSolver, s,
+                            computeErrors, computeLocations,
+                            frame.squaredMarkerErrors, frame.markerLocations);
+                    frame.q = s.getQ();
+                }
+            });
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -70,7 +159,9 @@ InverseKinematicsTool::InverseKinematicsTool() : Tool(),
     _timeRange(_timeRangeProp.getValueDblArray()),
     _reportErrors(_reportErrorsProp.getValueBool()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt()),
+    _solver(_solverProp.getValueStr())
 {
     setNull();
 }
@@ -95,7 +186,9 @@ InverseKinematicsTool::InverseKinematicsTool(const string &aFileName, bool aLoad
     _timeRange(_timeRangeProp.getValueDblArray()),
     _reportErrors(_reportErrorsProp.getValueBool()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt()),
+    _solver(_solverProp.getValueStr())
 {
     setNull();
     updateFromXMLDocument();
@@ -123,7 +216,9 @@ InverseKinematicsTool::InverseKinematicsTool(const InverseKinematicsTool &aTool)
     _timeRange(_timeRangeProp.getValueDblArray()),
     _reportErrors(_reportErrorsProp.getValueBool()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt()),
+    _solver(_solverProp.getValueStr())
 {
     setNull();
     *this = aTool;
@@ -195,6 +290,18 @@ void InverseKinematicsTool::setupProperties()
     _reportMarkerLocationsProp.setValue(false);
     _propertySet.append(&_reportMarkerLocationsProp);
 
+    _numThreadsProp.setComment("Number of threads used to solve the frames in the time range. "
+        "With more than one thread, frames are solved in contiguous chunks, each on its own copy of the model.");
+    _numThreadsProp.setName("number_of_threads");
+    _numThreadsProp.setValue(1);
+    _propertySet.append(&_numThreadsProp);
+
+    _solverProp.setComment("Solver of the frames: 'Assembler' (the default), the general assembler, "
+        "or 'GaussNewton', a faster solver for models without constraints or quaternions.");
+    _solverProp.setName("solver");
+    _solverProp.setValue("Assembler");
+    _propertySet.append(&_solverProp);
+
 }
 
 //_____________________________________________________________________________
@@ -232,6 +339,8 @@ operator=(const InverseKinematicsTool &aTool)
     _reportErrors = aTool._reportErrors;
     _outputMotionFileName = aTool._outputMotionFileName;
     _reportMarkerLocations = aTool._reportMarkerLocations;
+    _numThreads = aTool._numThreads;
+    _solver = aTool._solver;
 
     return(*this);
 }
@@ -252,15 +361,44 @@ bool InverseKinematicsTool::run()
 {
     bool success = false;
     bool modelFromFile=true;
+    ToolProfile profile(getConcreteClassName() + " " + getName());
+    _outputStorage.reset();
+
+    // Keep the results of the last run if its inputs were the same.
+    string inputHash;
+    if (getUseCachedResults()) {
+        inputHash = computeInputHash();
+        if (findCachedResults(inputHash)) {
+            cout << "Results of tool " << getName() << " are up to date; "
+                 << "not running it again." << endl;
+            if (_outputMotionFileName != "" &&
+                    _outputMotionFileName != "Unassigned") {
+                // The output motion file is relative to the setup file.
+                string saveWorkingDirectory = IO::getCwd();
+                IO::chDir(IO::getParentDirectory(getDocumentFileName()));
+                try {
+                    _outputStorage.reset(new Storage(_outputMotionFileName));
+                } catch (...) {
+                    IO::chDir(saveWorkingDirectory);
+                    throw;
+                }
+                IO::chDir(saveWorkingDirectory);
+            }
+            return true;
+        }
+    }
+
     try{
         //Load and create the indicated model
+        profile.beginPhase("load model");
         if (!_model) {
             OPENSIM_THROW_IF_FRMOBJ(_modelFileName.empty(), Exception,
                 "No model filename was provided.");
-            _model = new Model(_modelFileName);
+            _model = ModelCache::loadToolModel(_modelFileName);
         }
         else
             modelFromFile = false;
+        profile.endPhase();
 
         _model->printBasicInfo(cout);
 
@@ -276,6 +414,14 @@ bool InverseKinematicsTool::run()
         kinematicsReporter.setRecordAccelerations(false);
         kinematicsReporter.setInDegrees(true);
         _model->addAnalysis(&kinematicsReporter);
+        // The reporter lives on the stack, so take it out of the model
+        // (without deleting it) however this block is left; the model may
+        // outlive this call if it was given with setModel().
+        struct ReporterRemover {
+            Model& model;
+            Analysis* reporter;
+            ~ReporterRemover() { model.removeAnalysis(reporter, false); }
+        } reporterRemover{*_model, &kinematicsReporter};
 
         cout<<"Running tool "<<getName()<<".\n";
 
@@ -283,13 +429,17 @@ bool InverseKinematicsTool::run()
         string trialName = getName();
 
         // Initialize the model's underlying computational system and get its default state.
+        profile.beginPhase("initialize system");
         SimTK::State& s = _model->initSystem();
+        profile.endPhase();
 
         //Convert old Tasks to references for assembly and tracking
+        profile.beginPhase("read inputs");
         MarkersReference markersReference;
         SimTK::Array_<CoordinateReference> coordinateReferences;
         // populate the references according to the setting of this Tool
         populateReferences(markersReference, coordinateReferences);
+        profile.endPhase();
 
         // Determine the start time, if the provided time range is not specified then use time from marker reference
         // also adjust the time range for the tool if the provided range exceeds that of the marker data
@@ -297,12 +447,41 @@ bool InverseKinematicsTool::run()
         double start_time = (markersValidTimRange[0] > _timeRange[0]) ? markersValidTimRange[0] : _timeRange[0];
         double final_time = (markersValidTimRange[1] < _timeRange[1]) ? markersValidTimRange[1] : _timeRange[1];
 
+        OPENSIM_THROW_IF_FRMOBJ(
+            _solver != "Assembler" && _solver != "GaussNewton", Exception,
+            "Expected solver 'Assembler' or 'GaussNewton', but got '" +
+            _solver + "'.");
+        const bool useGaussNewton = (_solver == "GaussNewton");
+
         // create the solver given the input data
-        InverseKinematicsSolver ikSolver(*_model, markersReference, coordinateReferences, _constraintWeight);
-        ikSolver.setAccuracy(_accuracy);
+        std::unique_ptr<InverseKinematicsSolver> ikSolver;
+        std::unique_ptr<GaussNewtonIKSolver> gaussNewtonSolver;
         s.updTime() = start_time;
-        ikSolver.assemble(s);
+        profile.beginPhase("assemble");
+        int numAssembleIterations;
+        if (useGaussNewton) {
+            gaussNewtonSolver.reset(new GaussNewtonIKSolver(*_model,
+                markersReference, coordinateReferences, _constraintWeight));
+            gaussNewtonSolver->setAccuracy(_accuracy);
+            gaussNewtonSolver->assemble(s);
+            numAssembleIterations = gaussNewtonSolver->getNumIterations();
+        }
+        else {
+            ikSolver.reset(new InverseKinematicsSolver(*_model,
+                markersReference, coordinateReferences, _constraintWeight));
+            ikSolver->setAccuracy(_accuracy);
+            ikSolver->assemble(s);
+            numAssembleIterations = ikSolver->getNumIterations();
+        }
+        profile.endPhase();
+        profile.addCount("assemble iterations", numAssembleIterations);
         kinematicsReporter.begin(s);
+        // The name of a marker tracked, or none for no marker (-1).
+        auto markerName = [&](int j) {
+            if (j < 0) return std::string();
+            return useGaussNewton ? gaussNewtonSolver->getMarkerNameForIndex(j)
+                                  : ikSolver->getMarkerNameForIndex(j);
+        };
 
         const clock_t start = clock();
         double dt = 1.0/markersReference.getSamplingFrequency();
@@ -310,16 +489,57 @@ bool InverseKinematicsTool::run()
         AnalysisSet& analysisSet = _model->updAnalysisSet();
         analysisSet.begin(s);
         // number of markers
-        int nm = markersReference.getNumRefs();
+        int nm = useGaussNewton ? gaussNewtonSolver->getNumMarkers()
+                                : markersReference.getNumRefs();
         SimTK::Array_<double> squaredMarkerErrors(nm, 0.0);
         SimTK::Array_<Vec3> markerLocations(nm, Vec3(0));
         
         Storage *modelMarkerLocations = _reportMarkerLocations ? new Storage(Nframes, "ModelMarkerLocations") : NULL;
         Storage *modelMarkerErrors = _reportErrors ? new Storage(Nframes, "ModelMarkerErrors") : NULL;
 
+        // Solve all frames up front on worker threads if requested, or in
+        // the same chunks whatever the number of threads in deterministic
+        // mode; the solutions are then reported in order below as in the
+        // serial case.
+        profile.beginPhase("solve frames");
+        std::vector<IKFrameSolution> solutions;
+        if ((_numThreads > 1 || ThreadPool::getDeterministic()) &&
+                Nframes > 1) {
+            solutions.resize(Nframes);
+            if (useGaussNewton)
+                solveFramesInParallel<GaussNewtonIKSolver>(*_model,
+                    markersReference, coordinateReferences, _constraintWeight,
+                    _accuracy, start_time, dt, _numThreads, _reportErrors,
+                    _reportMarkerLocations, solutions);
+            else
+                solveFramesInParallel<InverseKinematicsSolver>(*_model,
+                    markersReference, coordinateReferences, _constraintWeight,
+                    _accuracy, start_time, dt, _numThreads, _reportErrors,
+                    _reportMarkerLocations, solutions);
+        }
+
         for (int i = 0; i < Nframes; i++) {
             s.updTime() = start_time + i*dt;
-            ikSolver.track(s);
+            int numIterations;
+            if (solutions.empty()) {
+                const double frameStart = SimTK::realTime();
+                numIterations = useGaussNewton ?
+                    trackFrame(*gaussNewtonSolver, s, _reportErrors,
+                        _reportMarkerLocations, squaredMarkerErrors,
+                        markerLocations) :
+                    trackFrame(*ikSolver, s, _reportErrors,
+                        _reportMarkerLocations, squaredMarkerErrors,
+                        markerLocations);
+                profile.addSample("track frame",
+                                  SimTK::realTime() - frameStart);
+            }
+            else {
+                s.updQ() = solutions[i].q;
+                squaredMarkerErrors.swap(solutions[i].squaredMarkerErrors);
+                markerLocations.swap(solutions[i].markerLocations);
+                numIterations = solutions[i].numIterations;
+            }
+            profile.addCount("track iterations", numIterations);
             
             if(_reportErrors){
                 Array<double> markerErrors(0.0, 3);
@@ -327,7 +547,6 @@ bool InverseKinematicsTool::run()
                 double maxSquaredMarkerError = 0.0;
                 int worst = -1;
 
-                ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
                 for(int j=0; j<nm; ++j){
                     totalSquaredMarkerError += squaredMarkerErrors[j];
                     if(squaredMarkerErrors[j] > maxSquaredMarkerError){
@@ -342,14 +561,15 @@ bool InverseKinematicsTool::run()
                 markerErrors.set(2, sqrt(maxSquaredMarkerError));
                 modelMarkerErrors->append(s.getTime(), 3, &markerErrors[0]);
 
-                cout << "Frame " << i << " (t=" << s.getTime() << "):\t";
-                cout << "total squared error = " << totalSquaredMarkerError;
-                cout << ", marker error: RMS=" << rms;
-                cout << ", max=" << sqrt(maxSquaredMarkerError) << " (" << ikSolver.getMarkerNameForIndex(worst) << ")" << endl;
+                OPENSIM_INFO("Frame " << i << " (t=" << s.getTime() << "):\t"
+                    << "total squared error = " << totalSquaredMarkerError
+                    << ", marker error: RMS=" << rms
+                    << ", max=" << sqrt(maxSquaredMarkerError) << " ("
+                    << markerName(worst) << ")"
+                    << ", iterations=" << numIterations);
             }
 
             if(_reportMarkerLocations){
-                ikSolver.computeCurrentMarkerLocations(markerLocations);
                 Array<double> locations(0.0, 3*nm);
                 for(int j=0; j<nm; ++j){
                     for(int k=0; k<3; ++k)
@@ -363,9 +583,13 @@ bool InverseKinematicsTool::run()
             kinematicsReporter.step(s, i);
             analysisSet.step(s, i);
         }
+        profile.endPhase();
 
         // Do the maneuver to change then restore working directory 
         // so that output files are saved to same folder as setup file.
+        profile.beginPhase("write outputs");
+        _outputStorage.reset(
+                new Storage(*kinematicsReporter.getPositionStorage()));
         if (_outputMotionFileName!= "" && _outputMotionFileName!="Unassigned"){
             kinematicsReporter.getPositionStorage()->print(_outputMotionFileName);
         }
@@ -395,7 +619,7 @@ bool InverseKinematicsTool::run()
 
             for(int j=0; j<nm; ++j){
                 for(int k=0; k<3; ++k)
-                    labels.set(3*j+k+1, ikSolver.getMarkerNameForIndex(j)+XYZ[k]);
+                    labels.set(3*j+k+1, markerName(j)+XYZ[k]);
             }
             modelMarkerLocations->setColumnLabels(labels);
             modelMarkerLocations->setName("Model Marker Locations from IK");
@@ -406,11 +630,16 @@ bool InverseKinematicsTool::run()
 
             delete modelMarkerLocations;
         }
+        profile.endPhase();
+        profile.printReports(getResultsDir());
 
         IO::chDir(saveWorkingDirectory);
 
         success = true;
+        if (!inputHash.empty()) recordCachedResults(inputHash);
 
+        // Write the remaining per-frame messages first.
+        Logger::flush();
         cout << "InverseKinematicsTool completed " << Nframes-1 << " frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n" <<endl;
     }
     catch (const std::exception& ex) {
@@ -418,11 +647,51 @@ bool InverseKinematicsTool::run()
         throw (Exception("InverseKinematicsTool Failed, please see messages window for details..."));
     }
 
-    if (modelFromFile) delete _model;
+    if (modelFromFile) { delete _model; _model = NULL; }
 
     return success;
 }
 
+const Storage& InverseKinematicsTool::getOutputStorage() const
+{
+    OPENSIM_THROW_IF_FRMOBJ(!_outputStorage, Exception,
+        "The tool has not been run.");
+    return *_outputStorage;
+}
+
+void InverseKinematicsTool::hashInputs(std::uint64_t& hash) const
+{
+    // The model is read from the current directory.
+    if (_model) hashString(_model->dump(true), hash);
+    else hashFile(_modelFileName, hash);
+
+    // The data files are relative to the setup file.
+    string saveWorkingDirectory = IO::getCwd();
+    IO::chDir(IO::getParentDirectory(getDocumentFileName()));
+    try {
+        hashFile(_markerFileName, hash);
+        if (_coordinateFileName != "" && _coordinateFileName != "Unassigned")
+            hashFile(_coordinateFileName, hash);
+    } catch (...) {
+        IO::chDir(saveWorkingDirectory);
+        throw;
+    }
+    IO::chDir(saveWorkingDirectory);
+}
+
+void InverseKinematicsTool::appendOutputFiles(
+        std::vector<std::string>& fileNames) const
+{
+    if (_outputMotionFileName != "" && _outputMotionFileName != "Unassigned")
+        fileNames.push_back(_outputMotionFileName);
+    if (_reportErrors)
+        fileNames.push_back(getResultsFilePath(
+                getName() + "_ik_marker_errors.sto"));
+    if (_reportMarkerLocations)
+        fileNames.push_back(getResultsFilePath(
+                getName() + "_ik_model_marker_locations.sto"));
+}
+
 // Handle conversion from older format
 void InverseKinematicsTool::updateFromXMLNode(SimTK::Xml::Element& aNode, int versionNumber)
 {
@@ -520,6 +789,14 @@ void InverseKinematicsTool::updateFromXMLNode(SimTK::Xml::Element& aNode, int ve
 void InverseKinematicsTool::populateReferences(MarkersReference& markersReference,
     SimTK::Array_<CoordinateReference>&coordinateReferences) const
 {
+    // Read the marker file on another thread while the coordinate file is
+    // read and splined on this one. The MarkersReference must not be touched
+    // here until the markers are loaded.
+    std::future<void> markersLoaded = std::async(std::launch::async,
+        [this, &markersReference] {
+            markersReference.loadMarkersFile(_markerFileName);
+        });
+
     FunctionSet *coordFunctions = NULL;
     // Load the coordinate data
     // bool haveCoordinateFile = false;
@@ -573,14 +850,15 @@ void InverseKinematicsTool::populateReferences(MarkersReference& markersReferenc
         }
     }
 
+    // Wait for the markers; this rethrows any error reading the marker file.
+    markersLoaded.get();
+
     // Set the default weight for markers
     markersReference.setDefaultWeight(1.0);
     // Set the weights for markers (markers in the model and the marker file
     // but not assigned a weight in the markerWeightSet will use the default
     // weight
     markersReference.setMarkerWeightSet(markerWeights);
-    //Load the makers
-    markersReference.loadMarkersFile(_markerFileName);
 }
 
 
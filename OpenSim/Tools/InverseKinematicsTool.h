@@ -26,8 +26,11 @@
 #include "osimToolsDLL.h"
 #include <OpenSim/Common/PropertyDbl.h>
 #include <OpenSim/Common/PropertyDblArray.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include "Tool.h"
 
+#include <memory>
+
 #ifdef SWIG
     #ifdef OSIMTOOLS_API
         #undef OSIMTOOLS_API
@@ -38,6 +41,7 @@
 namespace OpenSim {
 
 class Model;
+class Storage;
 class IKTaskSet;
 class MarkersReference;
 class CoordinateReference;
@@ -107,6 +111,17 @@ private:
     PropertyBool _reportMarkerLocationsProp;
     bool &_reportMarkerLocations;
 
+    // number of worker threads used to solve the frames in the time range
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
+    // the solver of the frames: "Assembler" or "GaussNewton"
+    PropertyStr _solverProp;
+    std::string &_solver;
+
+    // the coordinates solved by the last call to run()
+    std::unique_ptr<Storage> _outputStorage;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -126,6 +141,8 @@ public:
 
     //---- Setters and getters for various attributes
     void setModel(Model& aModel) { _model = &aModel; };
+    void setModelFileName(const std::string& aFileName) { _modelFileName = aFileName; };
+    const std::string& getModelFileName() const { return _modelFileName; };
     void setStartTime(double d) { _timeRange[0] = d; };
     double getStartTime() const {return  _timeRange[0]; };
 
@@ -137,8 +154,34 @@ public:
 
     void setCoordinateFileName(const std::string& coordDataFileName) { _coordinateFileName=coordDataFileName;};
     const std::string& getCoordinateFileName() const { return  _coordinateFileName;};
-    
-    //const OpenSim::Storage& getOutputStorage() const;
+
+    /** %Set the number of threads used to solve the frames. With more than
+        one thread, the time range is split into contiguous chunks, each
+        solved on its own copy of the model and assembled at its first frame.
+        Results are reported in frame order, as in the serial case. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; };
+    int getNumThreads() const { return _numThreads; };
+
+    /** %Set the solver of the frames: "Assembler" (the default), the
+        InverseKinematicsSolver, or "GaussNewton", the GaussNewtonIKSolver,
+        which is faster but does not handle constraints or quaternions. */
+    void setSolver(const std::string& solver) { _solver = solver; };
+    const std::string& getSolver() const { return _solver; };
+
+    /** The coordinates (in degrees) solved by the last call to run(), as
+        written to the output motion file. This lets the motion be passed to
+        another tool in memory (see InverseAnalysisPipeline).
+        @throws Exception if run() has not completed. */
+    const Storage& getOutputStorage() const;
+
+protected:
+    /** The model (its file, or the model given with setModel()), and the
+    marker and coordinate files. */
+    void hashInputs(std::uint64_t& hash) const override;
+    /** The output motion file and the marker error and location files that
+    are reported. */
+    void appendOutputFiles(std::vector<std::string>& fileNames) const override;
+
 private:
     void setNull();
     void setupProperties();
@@ -244,6 +244,10 @@ bool MarkerPlacer::processModel(Model* aModel,
     * frames in the user-specified time range.
     */
     TimeSeriesTableVec3 staticPoseTable{aPathToSubject + _markerFileName};
+    // The MarkerData is made from the table rather than by reading the file
+    // again.
+    MarkerData* staticPose =
+        new MarkerData(staticPoseTable, aPathToSubject + _markerFileName);
     const auto& timeCol = staticPoseTable.getIndependentColumn();
     auto numRowsInRange = std::count_if(timeCol.cbegin(),
                                         timeCol.cend(),
@@ -277,7 +281,6 @@ bool MarkerPlacer::processModel(Model* aModel,
                                          staticPoseUnits.getAbbreviation());
     }
     
-    MarkerData* staticPose = new MarkerData(aPathToSubject + _markerFileName);
     staticPose->averageFrames(_maxMarkerMovement, _timeRange[0], _timeRange[1]);
     staticPose->convertToUnits(aModel->getLengthUnits());
 
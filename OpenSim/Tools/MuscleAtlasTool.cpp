@@ -0,0 +1,255 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  MuscleAtlasTool.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "MuscleAtlasTool.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/ThreadPool.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ModelCache.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S)
+//=============================================================================
+MuscleAtlasTool::MuscleAtlasTool()
+{
+    setName("MuscleAtlas");
+    constructProperties();
+}
+
+MuscleAtlasTool::MuscleAtlasTool(const std::string& setupFile) :
+    Object(setupFile, false)
+{
+    constructProperties();
+    updateFromXMLDocument();
+}
+
+void MuscleAtlasTool::constructProperties()
+{
+    constructProperty_model_file("");
+    constructProperty_muscle_list();
+    append_muscle_list("all");
+    constructProperty_coordinates();
+    constructProperty_range_min();
+    constructProperty_range_max();
+    constructProperty_num_points(11);
+    constructProperty_num_threads(1);
+    constructProperty_results_directory(".");
+}
+
+void MuscleAtlasTool::setModel(const Model& model)
+{
+    _model.reset(model.clone());
+}
+
+const SimTK::Matrix& MuscleAtlasTool::getMomentArms(int coordinate) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(
+        coordinate < 0 || coordinate >= (int)_momentArms.size(), Exception,
+        "Coordinate index " + std::to_string(coordinate) + " is out of "
+        "range, or the tool has not been run.");
+    return _momentArms[coordinate];
+}
+
+//=============================================================================
+// RUN
+//=============================================================================
+void MuscleAtlasTool::run()
+{
+    if (!_model) {
+        OPENSIM_THROW_IF_FRMOBJ(get_model_file().empty(), Exception,
+            "No model file was specified.");
+        _model.reset(ModelCache::loadToolModel(get_model_file()));
+    }
+    Model& model = *_model;
+    const SimTK::State& defaultState = model.initSystem();
+
+    // COORDINATES
+    const int nc = getProperty_coordinates().size();
+    const int numPerCoord = get_num_points();
+    OPENSIM_THROW_IF_FRMOBJ(nc == 0, Exception,
+        "Expected at least one coordinate.");
+    OPENSIM_THROW_IF_FRMOBJ(numPerCoord < 2, Exception,
+        "Expected at least 2 points per coordinate, but got " +
+        std::to_string(numPerCoord) + ".");
+    OPENSIM_THROW_IF_FRMOBJ(get_num_threads() < 1, Exception,
+        "Expected at least 1 thread, but got " +
+        std::to_string(get_num_threads()) + ".");
+    for (const auto* property : {&getProperty_range_min(),
+                                 &getProperty_range_max()}) {
+        OPENSIM_THROW_IF_FRMOBJ(
+            property->size() != 0 && property->size() != nc, Exception,
+            "Expected a value of " + property->getName() + " for each of "
+            "the " + std::to_string(nc) + " coordinates, but got " +
+            std::to_string(property->size()) + ".");
+    }
+
+    const CoordinateSet& coordSet = model.getCoordinateSet();
+    std::vector<const Coordinate*> coords;
+    std::vector<int> coordSetIndices;
+    _qIndices.clear();
+    _lower.resize(nc);
+    _upper.resize(nc);
+    for (int j = 0; j < nc; ++j) {
+        const string& name = get_coordinates(j);
+        const int index = coordSet.getIndex(name);
+        OPENSIM_THROW_IF_FRMOBJ(index < 0, Exception,
+            "Invalid coordinate (" + name + ") specified.");
+        const Coordinate& coord = coordSet.get(index);
+        coords.push_back(&coord);
+        coordSetIndices.push_back(index);
+        const SimTK::MobilizedBody& mobod =
+            model.getMatterSubsystem().getMobilizedBody(coord.getBodyIndex());
+        _qIndices.push_back(SimTK::QIndex(
+            mobod.getFirstQIndex(defaultState) + coord.getMobilizerQIndex()));
+        _lower[j] = getProperty_range_min().size() ? get_range_min(j)
+                                                   : coord.getRangeMin();
+        _upper[j] = getProperty_range_max().size() ? get_range_max(j)
+                                                   : coord.getRangeMax();
+    }
+
+    // MUSCLES
+    const Set<Muscle>& muscleSet = model.getMuscles();
+    std::vector<const Muscle*> muscles;
+    _muscleNames.clear();
+    const bool all = getProperty_muscle_list().size() == 1 &&
+                     IO::Lowercase(get_muscle_list(0)) == "all";
+    for (int m = 0; m < muscleSet.getSize(); ++m) {
+        if (all || getProperty_muscle_list().findIndex(
+                       muscleSet[m].getName()) >= 0) {
+            muscles.push_back(&muscleSet[m]);
+            _muscleNames.push_back(muscleSet[m].getName());
+        }
+    }
+    if (!all) {
+        for (int m = 0; m < getProperty_muscle_list().size(); ++m) {
+            OPENSIM_THROW_IF_FRMOBJ(
+                !muscleSet.contains(get_muscle_list(m)), Exception,
+                "Invalid muscle (" + get_muscle_list(m) + ") specified.");
+        }
+    }
+    const int nm = (int)muscles.size();
+
+    // GRID
+    double numPointsReal = std::pow(double(numPerCoord), nc);
+    OPENSIM_THROW_IF_FRMOBJ(numPointsReal > 1e8, Exception,
+        "The grid of " + std::to_string(numPointsReal) + " points is too "
+        "large.");
+    const int np = (int)numPointsReal;
+    _gridPoints.resize(np, nc);
+    std::vector<int> index(nc, 0);
+    for (int p = 0; p < np; ++p) {
+        for (int j = 0; j < nc; ++j) {
+            _gridPoints(p, j) = _lower[j] +
+                (_upper[j] - _lower[j])*index[j]/(numPerCoord - 1);
+        }
+        for (int j = 0; j < nc && ++index[j] == numPerCoord; ++j)
+            index[j] = 0;
+    }
+
+    // SWEEP
+    _lengths.resize(np, nm);
+    _momentArms.assign(nc, SimTK::Matrix(np, nm));
+    const SimTK::MultibodySystem& system = model.getMultibodySystem();
+    // Each thread writes only to its own rows of the results.
+    const auto sweep = [&](SimTK::State& s, int begin, int end) {
+        for (int p = begin; p < end; ++p) {
+            for (int j = 0; j < nc; ++j)
+                coords[j]->setValue(s, _gridPoints(p, j), false);
+            system.realize(s, SimTK::Stage::Position);
+            for (int m = 0; m < nm; ++m) {
+                const GeometryPath& path = muscles[m]->getGeometryPath();
+                _lengths(p, m) = path.getLength(s);
+                const SimTK::Vector momentArms = path.computeMomentArms(s);
+                for (int j = 0; j < nc; ++j)
+                    _momentArms[j](p, m) = momentArms[coordSetIndices[j]];
+            }
+        }
+    };
+
+    const int numThreads = std::min(ThreadPool::getNumThreads(get_num_threads()),
+                                    np);
+    std::vector<SimTK::State> states(numThreads, defaultState);
+    ThreadPool::parallelForRanges(np, numThreads,
+        [&](int range, int begin, int end) {
+            sweep(states[range], begin, end);
+        });
+
+    // TABLES
+    if (get_results_directory().empty()) return;
+    IO::makeDir(get_results_directory());
+    Array<string> labels("");
+    labels.append("point");
+    for (int j = 0; j < nc; ++j) labels.append(get_coordinates(j));
+    for (const auto& name : _muscleNames) labels.append(name);
+    const auto print = [&](const SimTK::Matrix& values,
+                           const string& suffix) {
+        Storage table(np);
+        table.setName(getName() + suffix);
+        table.setColumnLabels(labels);
+        table.setInDegrees(false);
+        SimTK::Vector row(nc + nm);
+        for (int p = 0; p < np; ++p) {
+            for (int j = 0; j < nc; ++j) row[j] = _gridPoints(p, j);
+            for (int m = 0; m < nm; ++m) row[nc + m] = values(p, m);
+            table.append(p, row, false);
+        }
+        table.print(get_results_directory() + "/" + getName() + suffix +
+                    ".sto");
+    };
+    print(_lengths, "_lengths");
+    for (int j = 0; j < nc; ++j)
+        print(_momentArms[j], "_moment_arms_" + get_coordinates(j));
+}
+
+//=============================================================================
+// SURROGATES
+//=============================================================================
+PathLengthSurrogate MuscleAtlasTool::fitLengthSurrogate(int muscle,
+                                                        int degree) const
+{
+    OPENSIM_THROW_IF_FRMOBJ(muscle < 0 || muscle >= _lengths.ncol(),
+        Exception, "Muscle index " + std::to_string(muscle) + " is out of "
+        "range, or the tool has not been run.");
+    PathLengthSurrogate surrogate(_qIndices, _lower, _upper, degree);
+    const SimTK::Vector lengths(_lengths(muscle));
+    surrogate.fit(_gridPoints, lengths);
+
+    double maxError = 0;
+    for (int p = 0; p < lengths.size(); ++p) {
+        maxError = std::max(maxError, std::abs(lengths[p] -
+            surrogate.calcLength(_gridPoints[p].transpose().getAsVector())));
+    }
+    surrogate.setMaxError(maxError);
+    return surrogate;
+}
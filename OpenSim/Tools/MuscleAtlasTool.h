@@ -0,0 +1,158 @@
+#ifndef OPENSIM_MUSCLE_ATLAS_TOOL_H_
+#define OPENSIM_MUSCLE_ATLAS_TOOL_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  MuscleAtlasTool.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/Object.h>
+#include <OpenSim/Simulation/Model/PathLengthSurrogate.h>
+
+#include <memory>
+
+namespace OpenSim {
+
+class Model;
+
+/**
+ * Tabulates the length and moment arms of muscles over a grid of coordinate
+ * values, e.g., to validate a model or to fit surrogates of its paths.
+ *
+ * The grid spans the given coordinates, each sampled at num_points evenly
+ * spaced values over its range (or over range_min to range_max, in the units
+ * of the coordinate: radians for rotations). The grid points are split across
+ * num_threads threads, each with its own copy of the State of one Model, and
+ * the muscles are evaluated at each point: the length of the path and its
+ * moment arms about all the coordinates of the grid in one call (see
+ * GeometryPath::computeMomentArms()). The other coordinates keep their
+ * default values; coordinates coupled to those of the grid by constraints
+ * are not updated, so the moment arms are those about the coordinates on
+ * their own.
+ *
+ * The results are available as matrices, with a row per grid point and a
+ * column per muscle, and are written to results_directory as a table of
+ * lengths (`<name>_lengths.sto`) and a table of moment arms per coordinate
+ * (`<name>_moment_arms_<coordinate>.sto`). Each row holds the index of the
+ * grid point, the values of the coordinates and then the values of the
+ * muscles. The first coordinate varies fastest.
+ *
+ * The lengths of a muscle can be fit with a PathLengthSurrogate
+ * (fitLengthSurrogate()) and given to its GeometryPath
+ * (GeometryPath::setLengthSurrogate()).
+ *
+ * @code
+ * MuscleAtlasTool atlas;
+ * atlas.setModel(model);
+ * atlas.append_coordinates("r_shoulder_elev");
+ * atlas.append_coordinates("r_elbow_flex");
+ * atlas.set_num_points(41);
+ * atlas.set_num_threads(8);
+ * atlas.run();
+ * const SimTK::Matrix& lengths = atlas.getLengths();
+ * @endcode
+ */
+class OSIMTOOLS_API MuscleAtlasTool : public Object {
+OpenSim_DECLARE_CONCRETE_OBJECT(MuscleAtlasTool, Object);
+public:
+//==============================================================================
+// PROPERTIES
+//==============================================================================
+    OpenSim_DECLARE_PROPERTY(model_file, std::string,
+        "Name of the .osim file of the model.");
+    OpenSim_DECLARE_LIST_PROPERTY(muscle_list, std::string,
+        "Names of the muscles to tabulate. Use 'all' (the default) for all "
+        "muscles of the model.");
+    OpenSim_DECLARE_LIST_PROPERTY(coordinates, std::string,
+        "Names of the coordinates that span the grid.");
+    OpenSim_DECLARE_LIST_PROPERTY(range_min, double,
+        "Lowest value of each coordinate on the grid (radians for "
+        "rotations). Leave empty to use the ranges of the coordinates.");
+    OpenSim_DECLARE_LIST_PROPERTY(range_max, double,
+        "Highest value of each coordinate on the grid (radians for "
+        "rotations). Leave empty to use the ranges of the coordinates.");
+    OpenSim_DECLARE_PROPERTY(num_points, int,
+        "Number of evenly spaced values of each coordinate (default 11).");
+    OpenSim_DECLARE_PROPERTY(num_threads, int,
+        "Number of threads across which the grid points are split "
+        "(default 1).");
+    OpenSim_DECLARE_PROPERTY(results_directory, std::string,
+        "Directory to which the tables are written. Leave empty to keep the "
+        "results in memory only.");
+
+//==============================================================================
+// METHODS
+//==============================================================================
+    MuscleAtlasTool();
+    /** Construct the tool from a setup file. */
+    explicit MuscleAtlasTool(const std::string& setupFile);
+
+    /** Tabulate a copy of this model instead of reading model_file. */
+    void setModel(const Model& model);
+
+    /** Sweep the grid and write the tables.
+    @throws Exception if a coordinate or muscle is not in the model, or the
+    grid is invalid. */
+    void run();
+
+    //--------------------------------------------------------------------------
+    // RESULTS
+    //--------------------------------------------------------------------------
+    /** The names of the muscles, in the order of the columns of the results. */
+    const std::vector<std::string>& getMuscleNames() const
+    {   return _muscleNames; }
+    /** The values of the coordinates at each grid point, a row per point and
+    a column per coordinate. */
+    const SimTK::Matrix& getGridPoints() const { return _gridPoints; }
+    /** The length of each muscle at each grid point. */
+    const SimTK::Matrix& getLengths() const { return _lengths; }
+    /** The moment arm of each muscle about the coordinate with the given index
+    (in the coordinates property) at each grid point. */
+    const SimTK::Matrix& getMomentArms(int coordinate) const;
+
+    /** Fit a polynomial of the given total degree to the lengths of a muscle
+    over the grid, in terms of the coordinates of the grid. The largest
+    error over the grid points is recorded in the surrogate. It applies to
+    the model that was tabulated (or one with the same coordinates), and
+    only if no other coordinate changes the length of the path. */
+    PathLengthSurrogate fitLengthSurrogate(int muscle, int degree = 5) const;
+
+private:
+    void constructProperties();
+
+    SimTK::ResetOnCopy<std::unique_ptr<Model>> _model;
+
+    std::vector<std::string> _muscleNames;
+    // The coordinates of the grid, as indices into the q vector, and their
+    // ranges.
+    std::vector<SimTK::QIndex> _qIndices;
+    SimTK::Vector _lower;
+    SimTK::Vector _upper;
+
+    SimTK::Matrix _gridPoints;
+    SimTK::Matrix _lengths;
+    std::vector<SimTK::Matrix> _momentArms;
+//==============================================================================
+};  // END of class MuscleAtlasTool
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MUSCLE_ATLAS_TOOL_H_
@@ -28,6 +28,7 @@
 #include "AnalyzeTool.h"
 #include "VectorFunctionForActuators.h"
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/ToolProfile.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Model/CMCActuatorSubsystem.h>
@@ -35,6 +36,7 @@
 #include <OpenSim/Analyses/InverseDynamics.h>
 #include <OpenSim/Analyses/Actuation.h>
 #include <OpenSim/Common/DebugUtilities.h>
+#include <memory>
 
 
 using namespace std;
@@ -71,6 +73,7 @@ RRATool::RRATool() :
     _finalTimeForCOMAdjustment(_finalTimeForCOMAdjustmentProp.getValueDbl()),
     _adjustedCOMBody(_adjustedCOMBodyProp.getValueStr()),
     _outputModelFile(_outputModelFileProp.getValueStr()),
+    _numberOfPasses(_numberOfPassesProp.getValueInt()),
     _verbose(_verboseProp.getValueBool())
 {
     setNull();
@@ -96,6 +99,7 @@ RRATool::RRATool(const string &aFileName, bool aLoadModel) :
     _finalTimeForCOMAdjustment(_finalTimeForCOMAdjustmentProp.getValueDbl()),
     _adjustedCOMBody(_adjustedCOMBodyProp.getValueStr()),
     _outputModelFile(_outputModelFileProp.getValueStr()),
+    _numberOfPasses(_numberOfPassesProp.getValueInt()),
     _verbose(_verboseProp.getValueBool())
 {
     setNull();
@@ -161,6 +165,7 @@ RRATool(const RRATool &aTool) :
     _finalTimeForCOMAdjustment(_finalTimeForCOMAdjustmentProp.getValueDbl()),
     _adjustedCOMBody(_adjustedCOMBodyProp.getValueStr()),
     _outputModelFile(_outputModelFileProp.getValueStr()),
+    _numberOfPasses(_numberOfPassesProp.getValueInt()),
     _verbose(_verboseProp.getValueBool())
 {
     setNull();
@@ -191,6 +196,7 @@ setNull()
     _initialTimeForCOMAdjustment = -1;
     _finalTimeForCOMAdjustment = -1;
     _outputModelFile = "";
+    _numberOfPasses = 1;
     _adjustKinematicsToReduceResiduals=true;
     _verbose = false;
     _targetDT = .001;
@@ -287,6 +293,14 @@ void RRATool::setupProperties()
     _outputModelFileProp.setName("output_model_file");
     _propertySet.append( &_outputModelFileProp );
 
+    comment = "Number of residual reduction passes to perform. Each pass tracks the "
+                 "kinematics of the previous pass using the model as adjusted by the "
+                 "previous pass. Only the results of the last pass are written under the "
+                 "name of the tool; those of earlier passes have the suffix _pass1, _pass2, etc.";
+    _numberOfPassesProp.setComment(comment);
+    _numberOfPassesProp.setName("number_of_passes");
+    _propertySet.append( &_numberOfPassesProp );
+
     comment = "True-false flag indicating whether or not to turn on verbose printing for cmc.";
     _verboseProp.setComment(comment);
     _verboseProp.setName("use_verbose_printing");
@@ -325,6 +339,7 @@ operator=(const RRATool &aTool)
     _adjustCOMToReduceResiduals = aTool._adjustCOMToReduceResiduals;
     _initialTimeForCOMAdjustment = aTool._initialTimeForCOMAdjustment;
     _finalTimeForCOMAdjustment = aTool._finalTimeForCOMAdjustment;
+    _numberOfPasses = aTool._numberOfPasses;
     _verbose = aTool._verbose;
 
     return(*this);
@@ -374,27 +389,14 @@ bool RRATool::run()
             throw Exception("RRATool: ERROR- Body '"+_adjustedCOMBody+"' specified in "+
                                  _adjustedCOMBodyProp.getName()+" not found",__FILE__,__LINE__);
     }
+    if(_numberOfPasses<1)
+        throw Exception("RRATool: ERROR- "+_numberOfPassesProp.getName()+" must be at least 1",__FILE__,__LINE__);
 
-    /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model);
-
-    CMC_TaskSet taskSet(_taskSetFileName);           
-    cout<<"\n\n taskSet size = "<<taskSet.getSize()<<endl<<endl;         
+    // The model was loaded when the tool was constructed.
+    ToolProfile profile(getConcreteClassName() + " " + getName());
 
-    CMC* controller = new CMC(_model,&taskSet); // Need to make it a pointer since Model takes ownership 
-    controller->setName( "CMC" );
-    controller->setActuators(_model->updActuators());
-    _model->addController(controller );
-    controller->setEnabled(true);
-    controller->setUseCurvatureFilter(false);
-    controller->setTargetDT(.001);
-    controller->setCheckTargetTime(true);
+    /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model);
 
-    //Make sure system is up-to-date with model (i.e. added actuators, etc...)
-    SimTK::State& s = _model->initSystem();
-    _model->getMultibodySystem().realize(s, Stage::Position );
-     taskSet.setModel(*_model);
-    _model->equilibrateMuscles(s);
-  
     // ---- INPUT ----
     // DESIRED POINTS AND KINEMATICS
     if(_desiredPointsFileName=="" && _desiredKinematicsFileName=="") {
@@ -403,24 +405,31 @@ bool RRATool::run()
         return false;
     }
 
-    Storage *desiredPointsStore=NULL;
+    profile.beginPhase("read inputs");
+
+    std::unique_ptr<Storage> desiredPointsStore;
     bool desiredPointsFlag = false;
     if(_desiredPointsFileName=="") {
         cout<<"\n\nWARN- a desired points file was not specified.\n\n";
     } else {
         cout<<"\n\nLoading desired points from file "<<_desiredPointsFileName<<" ...\n";
-        desiredPointsStore = new Storage(_desiredPointsFileName);
+        desiredPointsStore.reset(new Storage(_desiredPointsFileName));
         desiredPointsFlag = true;
     }
 
-    Storage *desiredKinStore=NULL;
-    bool desiredKinFlag = false;
+    std::unique_ptr<Storage> desiredKinStore;
     if(_desiredKinematicsFileName=="") {
         cout<<"\n\nWARN- a desired kinematics file was not specified.\n\n";
     } else {
         cout<<"\n\nLoading desired kinematics from file "<<_desiredKinematicsFileName<<" ...\n";
-        desiredKinStore = new Storage(_desiredKinematicsFileName);
-        desiredKinFlag = true;
+        desiredKinStore.reset(new Storage(_desiredKinematicsFileName));
+    }
+
+    // TASK SET
+    if(_taskSetFileName=="") {
+        cout<<"ERROR- a task set was not specified\n\n";
+        IO::chDir(saveWorkingDirectory);
+        return false;
     }
 
     // ---- INITIAL AND FINAL TIME ----
@@ -444,6 +453,118 @@ bool RRATool::run()
         }
     }
 
+    // Filter
+    if(desiredPointsFlag) {
+        desiredPointsStore->pad(60);
+        desiredPointsStore->print("desiredPoints_padded.sto");
+        if(_lowpassCutoffFrequency>=0) {
+            int order = 50;
+            cout<<"\n\nLow-pass filtering desired points with a cutoff frequency of ";
+            cout<<_lowpassCutoffFrequency<<"...";
+            desiredPointsStore->lowpassFIR(order,_lowpassCutoffFrequency);
+        } else {
+            cout<<"\n\nNote- not filtering the desired points.\n\n";
+        }
+    }
+    profile.endPhase();
+
+    // ---- PASSES ----
+    // Each pass tracks the kinematics computed by the previous one, using the
+    // model as adjusted by the previous one, as if RRA were run again with
+    // the results of the previous run.
+    string massAdjMsg, residualsMsg;
+    for(int pass=1; pass<=_numberOfPasses; pass++) {
+        if(_numberOfPasses>1)
+            cout<<"\n\nRRA pass "<<pass<<" of "<<_numberOfPasses<<"\n\n";
+        // Only the last pass writes its results under the name of the tool.
+        string name = getName();
+        if(pass<_numberOfPasses) name += "_pass" + std::to_string(pass);
+
+        bool done = false;
+        const double passStart = SimTK::realTime();
+        profile.beginPhase("pass " + std::to_string(pass));
+        if(!runPass(name, desiredPointsStore.get(), desiredKinStore.get(),
+                    massAdjMsg, residualsMsg, done)) {
+            IO::chDir(saveWorkingDirectory);
+            return false;
+        }
+        profile.endPhase();
+        profile.addSample("pass", SimTK::realTime() - passStart);
+        if(done || pass==_numberOfPasses) break;
+
+        // The kinematics of this pass become the desired kinematics of the
+        // next one.
+        AnalysisSet& as = _model->updAnalysisSet();
+        for(int i=0; i<as.getSize(); i++) {
+            if(as.get(i).getConcreteClassName() == "Kinematics" && as.get(i).getPrintResultFiles()) {
+                Kinematics& kin = (Kinematics&)as.get(i);
+                desiredKinStore.reset(new Storage(*kin.getPositionStorage()));
+                break;
+            }
+        }
+
+        // Each pass adds its own CMC controller.
+        int c = _model->updControllerSet().getIndex("CMC");
+        _model->updControllerSet().remove(c);
+    }
+
+    // Write new model file
+    if(_adjustCOMToReduceResiduals) {
+        ToolProfile::Scope phase(profile, "write outputs");
+        writeAdjustedModel();
+    }
+    profile.printReports(getResultsDir());
+
+    cout << massAdjMsg << residualsMsg << endl;
+
+    } catch(const Exception& x) {
+        // TODO: eventually might want to allow writing of partial results
+        x.print(cout);
+        IO::chDir(saveWorkingDirectory);
+        // close open files if we die prematurely (e.g. Opt fail)
+        
+        return false;
+    }
+
+    IO::chDir(saveWorkingDirectory);
+
+    return true;
+}
+
+//_____________________________________________________________________________
+/**
+ * Perform one pass of residual reduction, tracking the given desired points
+ * and kinematics. The kinematics are filtered in place.
+ */
+bool RRATool::runPass(const string& aName, Storage* aDesiredPointsStore,
+                      Storage* aDesiredKinStore, string& rMassAdjMsg,
+                      string& rResidualsMsg, bool& rDone)
+{
+    bool desiredPointsFlag = aDesiredPointsStore!=NULL;
+    bool desiredKinFlag = aDesiredKinStore!=NULL;
+    Storage* desiredPointsStore = aDesiredPointsStore;
+    Storage* desiredKinStore = aDesiredKinStore;
+
+    CMC_TaskSet taskSet(_taskSetFileName);           
+    cout<<"\n\n taskSet size = "<<taskSet.getSize()<<endl<<endl;         
+
+    CMC* controller = new CMC(_model,&taskSet); // Need to make it a pointer since Model takes ownership 
+    controller->setName( "CMC" );
+    controller->setActuators(_model->updActuators());
+    _model->addController(controller );
+    controller->setEnabled(true);
+    controller->setUseCurvatureFilter(false);
+    controller->setTargetDT(.001);
+    controller->setCheckTargetTime(true);
+
+    //Make sure system is up-to-date with model (i.e. added actuators, etc...)
+    SimTK::State& s = _model->initSystem();
+    _model->getMultibodySystem().realize(s, Stage::Position );
+     taskSet.setModel(*_model);
+    _model->equilibrateMuscles(s);
+  
+    // ---- INITIAL AND FINAL TIME ----
+    // NOTE: important to do this before padding (for filtering)
     // Initial Time
     if(desiredKinFlag) {
         double ti = desiredKinStore->getFirstTime();
@@ -467,19 +588,6 @@ bool RRATool::run()
     // Eran: important to filter *before* calling formCompleteStorages because we need the
     // constrained coordinates (e.g. tibia-patella joint angle) to be consistent with the
     // filtered trajectories
-    if(desiredPointsFlag) {
-        desiredPointsStore->pad(60);
-        desiredPointsStore->print("desiredPoints_padded.sto");
-        if(_lowpassCutoffFrequency>=0) {
-            int order = 50;
-            cout<<"\n\nLow-pass filtering desired points with a cutoff frequency of ";
-            cout<<_lowpassCutoffFrequency<<"...";
-            desiredPointsStore->lowpassFIR(order,_lowpassCutoffFrequency);
-        } else {
-            cout<<"\n\nNote- not filtering the desired points.\n\n";
-        }
-    }
-
     if(desiredKinFlag) {
         desiredKinStore->pad(60);
         if (_verbose) desiredKinStore->print("desiredKinematics_padded.sto");
@@ -493,13 +601,6 @@ bool RRATool::run()
         }
     }
 
-     // TASK SET
-    if(_taskSetFileName=="") {           
-        cout<<"ERROR- a task set was not specified\n\n";         
-        IO::chDir(saveWorkingDirectory);         
-        return false;        
-    }
-
     _model->printDetailedInfo(s, cout);
 
     int nq = _model->getNumCoordinates();
@@ -522,19 +623,17 @@ bool RRATool::run()
     }
 
     // Adjust COM to reduce residuals (formerly RRA pass 1) if requested
-    string massAdjMsg;
     if(desiredKinFlag) {
         if(_adjustCOMToReduceResiduals) {
         
-            massAdjMsg = adjustCOMToReduceResiduals(s, *qStore,*uStore);
+            rMassAdjMsg += adjustCOMToReduceResiduals(s, *qStore,*uStore);
 
             // If not adjusting kinematics, we don't proceed with CMC, and just stop here.
             if(!_adjustKinematicsToReduceResiduals) {
                 cout << "No kinematics adjustment requested." << endl;
                 delete qStore;
                 delete uStore;
-                writeAdjustedModel();
-                IO::chDir(saveWorkingDirectory);
+                rDone = true;
                 return true;
             }
         }
@@ -731,7 +830,7 @@ bool RRATool::run()
     
     _model->setAllControllersEnabled( true );
 
-    manager.setSessionName(getName());
+    manager.setSessionName(aName);
     manager.setInitialTime(_ti);
     manager.setFinalTime(_tf-_targetDT-SimTK::Zero);
 
@@ -757,12 +856,10 @@ bool RRATool::run()
         catch(const Exception& x) {
         // TODO: eventually might want to allow writing of partial results
             x.print(cout);
-            IO::chDir(saveWorkingDirectory);
             return false;
         }
         catch(...) {
             // TODO: eventually might want to allow writing of partial results
-            IO::chDir(saveWorkingDirectory);
             // close open files if we die prematurely (e.g. Opt fail)
             return false;
         }
@@ -813,23 +910,21 @@ bool RRATool::run()
 
     // Set output file names so that files are flushed regularly in case we fail
     IO::makeDir(getResultsDir());   // Create directory for output in case it doesn't exist
-    manager.getStateStorage().setOutputFileName(getResultsDir() + "/" + getName() + "_states.sto");
+    manager.getStateStorage().setOutputFileName(getResultsDir() + "/" + aName + "_states.sto");
     try {
         manager.integrate(s);
     }
     catch(const Exception& x) {
         // TODO: eventually might want to allow writing of partial results
         x.print(cout);
-        IO::chDir(saveWorkingDirectory);
         // close open files if we die prematurely (e.g. Opt fail)
-        manager.getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
+        manager.getStateStorage().print(getResultsDir() + "/" + aName + "_states.sto");
         return false;
     }
     catch(...) {
         // TODO: eventually might want to allow writing of partial results
-        IO::chDir(saveWorkingDirectory);
         // close open files if we die prematurely (e.g. Opt fail)
-        manager.getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
+        manager.getStateStorage().print(getResultsDir() + "/" + aName + "_states.sto");
         return false;
     }
     time(&finishTime);
@@ -848,17 +943,17 @@ bool RRATool::run()
     cout<<"================================================================\n\n\n";
 
     // ---- RESULTS -----
-    printResults(getName(),getResultsDir()); // this will create results directory if necessary
-    controller->updControlSet().print(getResultsDir() + "/" + getName() + "_controls.xml");
-    _model->printControlStorage(getResultsDir() + "/" + getName() + "_controls.sto");
-    manager.getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
+    printResults(aName,getResultsDir()); // this will create results directory if necessary
+    controller->updControlSet().print(getResultsDir() + "/" + aName + "_controls.xml");
+    _model->printControlStorage(getResultsDir() + "/" + aName + "_controls.sto");
+    manager.getStateStorage().print(getResultsDir() + "/" + aName + "_states.sto");
     /*
     Storage statesDegrees(manager.getStateStorage());
     _model->getSimbodyEngine().convertRadiansToDegrees(statesDegrees);
     statesDegrees.setWriteSIMMHeader(true);
-    statesDegrees.print(getResultsDir() + "/" + getName() + "_states_degrees.mot");
+    statesDegrees.print(getResultsDir() + "/" + aName + "_states_degrees.mot");
     */
-    controller->getPositionErrorStorage()->print(getResultsDir() + "/" + getName() + "_pErr.sto");
+    controller->getPositionErrorStorage()->print(getResultsDir() + "/" + aName + "_pErr.sto");
 
     stringstream adjQMsg;
     if(_model->getAnalysisSet().getIndex("Actuation") != -1) {
@@ -876,7 +971,7 @@ bool RRATool::run()
         adjQMsg << "************************************************************\n" << endl;
 
         // Write the average residuals (DC offsets) out to a file
-        ofstream residualFile((getResultsDir() + "/" + getName() + "_avgResiduals.txt").c_str());
+        ofstream residualFile((getResultsDir() + "/" + aName + "_avgResiduals.txt").c_str());
         residualFile << "Average Residuals:\n\n";
         residualFile << "FX average = " << FAve[0] << "\n";
         residualFile << "FY average = " << FAve[1] << "\n";
@@ -887,23 +982,7 @@ bool RRATool::run()
         residualFile.close();
     }
 
-    // Write new model file
-    if(_adjustCOMToReduceResiduals) writeAdjustedModel();
-
-    cout << massAdjMsg << adjQMsg.str() << endl;
-
-    //_model->removeController(controller); // So that if this model is from GUI it doesn't double-delete it.
-
-    } catch(const Exception& x) {
-        // TODO: eventually might want to allow writing of partial results
-        x.print(cout);
-        IO::chDir(saveWorkingDirectory);
-        // close open files if we die prematurely (e.g. Opt fail)
-        
-        return false;
-    }
-
-    IO::chDir(saveWorkingDirectory);
+    rResidualsMsg = adjQMsg.str();
 
     return true;
 }
@@ -111,6 +111,10 @@ private:
     adjust_com_to_reduce_residuals is set to true. */
     PropertyStr _outputModelFileProp;
     std::string &_outputModelFile;
+    /** Number of residual reduction passes. Each pass tracks the kinematics
+    of the previous pass, with the model adjusted by the previous pass. */
+    PropertyInt _numberOfPassesProp;
+    int &_numberOfPasses;
 
     /** Flag indicating whether or not to adjust the kinematics in order to reduce residuals. */
     bool _adjustKinematicsToReduceResiduals;
@@ -135,6 +139,9 @@ public:
 private:
     void setNull();
     void setupProperties();
+    bool runPass(const std::string& aName, Storage* aDesiredPointsStore,
+                 Storage* aDesiredKinStore, std::string& rMassAdjMsg,
+                 std::string& rResidualsMsg, bool& rDone);
 
     //--------------------------------------------------------------------------
     // OPERATORS
@@ -170,6 +177,9 @@ public:
     const std::string &getAdjustedCOMBody() { return _adjustedCOMBody; }
     void setAdjustedCOMBody(const std::string &aBody) { _adjustedCOMBody = aBody; }
 
+    int getNumberOfPasses() const { return _numberOfPasses; }
+    void setNumberOfPasses(int aNumberOfPasses) { _numberOfPasses = aNumberOfPasses; }
+
     double getLowpassCutoffFrequency() const { return _lowpassCutoffFrequency; }
     void setLowpassCutoffFrequency(double aLowpassCutoffFrequency) { _lowpassCutoffFrequency = aLowpassCutoffFrequency; }
 
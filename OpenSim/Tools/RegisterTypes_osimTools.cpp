@@ -35,6 +35,7 @@
 #include "AnalyzeTool.h"
 #include "InverseKinematicsTool.h"
 #include "InverseDynamicsTool.h"
+#include "MuscleAtlasTool.h"
 
 #include "GenericModelMaker.h"
 #include "IKCoordinateTask.h"
@@ -72,36 +73,37 @@ OSIMTOOLS_API void RegisterTypes_osimTools()
 {
   try {
 
-    Object::registerType( ScaleTool() );
+    Object::registerType<ScaleTool>();
     //Object::registerType( IKTool() );
-    Object::registerType( CMCTool() );
-    Object::registerType( RRATool() );
-    Object::registerType( ForwardTool() );
-    Object::registerType( AnalyzeTool() );
-
-    Object::registerType( GenericModelMaker() );
-    Object::registerType( IKCoordinateTask() );
-    Object::registerType( IKMarkerTask() );
-    Object::registerType( IKTaskSet() );
+    Object::registerType<CMCTool>();
+    Object::registerType<RRATool>();
+    Object::registerType<ForwardTool>();
+    Object::registerType<AnalyzeTool>();
+
+    Object::registerType<GenericModelMaker>();
+    Object::registerType<IKCoordinateTask>();
+    Object::registerType<IKMarkerTask>();
+    Object::registerType<IKTaskSet>();
     //Object::registerType( IKTrial() );
     //Object::registerType( IKTrialSet() );
-    Object::registerType( MarkerPair() );
-    Object::registerType( MarkerPairSet() );
-    Object::registerType( MarkerPlacer() );
-    Object::registerType( Measurement() );
-    Object::registerType( MeasurementSet() );
-    Object::registerType( ModelScaler() );
-
-    Object::registerType( CorrectionController() );
-    Object::registerType( CMC() );
-    Object::registerType( CMC_Joint() );
-    Object::registerType( CMC_Point() );
-    Object::registerType( MuscleStateTrackingTask() );
-    Object::registerType( CMC_TaskSet() );
-
-    Object::registerType( SMC_Joint() );
-    Object::registerType( InverseKinematicsTool() );
-    Object::registerType( InverseDynamicsTool() );
+    Object::registerType<MarkerPair>();
+    Object::registerType<MarkerPairSet>();
+    Object::registerType<MarkerPlacer>();
+    Object::registerType<Measurement>();
+    Object::registerType<MeasurementSet>();
+    Object::registerType<ModelScaler>();
+
+    Object::registerType<CorrectionController>();
+    Object::registerType<CMC>();
+    Object::registerType<CMC_Joint>();
+    Object::registerType<CMC_Point>();
+    Object::registerType<MuscleStateTrackingTask>();
+    Object::registerType<CMC_TaskSet>();
+
+    Object::registerType<SMC_Joint>();
+    Object::registerType<InverseKinematicsTool>();
+    Object::registerType<InverseDynamicsTool>();
+    Object::registerType<MuscleAtlasTool>();
     // Old versions
     Object::RenameType("rdCMC_Joint",   "CMC_Joint");
     Object::RenameType("rdCMC_Point",   "CMC_Point");
@@ -26,6 +26,7 @@
 //=============================================================================
 #include "ScaleTool.h"
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/ToolProfile.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include "GenericModelMaker.h"
 
@@ -218,7 +219,8 @@ ScaleTool& ScaleTool::operator=(const ScaleTool &aSubject)
 //=============================================================================
 //_____________________________________________________________________________
 /**
- * Create a generic model, using GenericModelMaker::processModel().
+ * Create a generic model, using GenericModelMaker::processModel(), or copy
+ * the one given to setGenericModel().
  *
  * @return Pointer to the Model that is created.
  */
@@ -226,6 +228,13 @@ Model* ScaleTool::createModel() const
 {
     cout << "Processing subject " << getName() << endl;
 
+    if (_genericModel) {
+        Model* model = _genericModel->clone();
+        model->initSystem();
+        model->setName(getName());
+        return model;
+    }
+
     /* Make the generic model. */
     if (!_genericModelMakerProp.getValueIsDefault())
     {
@@ -246,7 +255,11 @@ Model* ScaleTool::createModel() const
 }
 
 bool ScaleTool::run() const {
+    ToolProfile profile(getConcreteClassName() + " " + getName());
+
+    profile.beginPhase("load model");
     std::unique_ptr<Model> model(createModel());
+    profile.endPhase();
 
     if(model == nullptr) { 
         throw Exception("scale: ERROR- No model specified.",__FILE__,__LINE__);
@@ -255,6 +268,7 @@ bool ScaleTool::run() const {
     if (!isDefaultModelScaler() && getModelScaler().getApply())
     {
         const ModelScaler& scaler = getModelScaler();
+        ToolProfile::Scope phase(profile, "scale model");
         if(!scaler.processModel(model.get(), getPathToSubject(), getSubjectMass())) {
             return false;
         }
@@ -267,6 +281,7 @@ bool ScaleTool::run() const {
     if (!isDefaultMarkerPlacer())
     {
         const MarkerPlacer& placer = getMarkerPlacer();
+        ToolProfile::Scope phase(profile, "place markers");
         if(!placer.processModel(model.get(), getPathToSubject())) {
             return false;
         }
@@ -275,5 +290,7 @@ bool ScaleTool::run() const {
     {
         cout << "Marker placement parameters disabled (apply is false) or not set. No markers have been moved." << endl;
     }
+    // The scaled model and markers are written next to the subject.
+    profile.printReports(getPathToSubject());
     return true;
 }
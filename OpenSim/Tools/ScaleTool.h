@@ -81,6 +81,10 @@ protected:
      */
     std::string  _pathToSubject;    
 
+    /** The processed generic model to scale a copy of, if given with
+     * setGenericModel(); not owned. */
+    const Model* _genericModel = nullptr;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -99,6 +103,14 @@ public:
     void copyData(const ScaleTool &aSubject);
 
     Model* createModel() const;
+    /** Make createModel(), and therefore run(), start from a copy of the
+     * given model instead of loading the generic model with the
+     * GenericModelMaker. The model should be one returned by
+     * GenericModelMaker::processModel(), so that it has the generic marker
+     * set, and must outlive the runs of this tool. This lets many subjects
+     * be scaled from a generic model that is parsed once (e.g., by
+     * `opensim-cmd run-batch`). */
+    void setGenericModel(const Model& model) { _genericModel = &model; }
     /* Query the subject for different parameters */
     const GenericModelMaker& getGenericModelMaker() const
     { return _genericModelMaker; }
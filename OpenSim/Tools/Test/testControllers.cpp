@@ -30,6 +30,10 @@
 //  2. Test a PrescribedController on a block with an ideal actuator
 //  3. Test a CorrectionController tracking a block with an ideal actuator
 //  4. Test a PrescribedController on the arm26 model with reserves.
+//  5. Test the evaluation of a ControlLinear::Curve with a cursor
+//  6. Test writing a ControlSet to a binary table file and reading it back
+//  7. Test a TaskSpaceController on a chain of two bodies
+//  8. Test a ReflexController with and without delayed signals
 //     Add tests here as new controller types are added to OpenSim
 //
 //=============================================================================
@@ -46,6 +50,10 @@ void testCorrectionControllerOnBlock();
 void testPrescribedControllerFromFile(const std::string& modelFile,
                                       const std::string& actuatorsFile,
                                       const std::string& controlsFile);
+void testControlLinearCurve();
+void testControlSetFromTable(const std::string& controlsFile);
+void testTaskSpaceController();
+void testReflexController();
 
 int main()
 {
@@ -60,6 +68,14 @@ int main()
         cout << "Testing PrescribedController from File" << endl;
         testPrescribedControllerFromFile("arm26.osim", "arm26_Reserve_Actuators.xml",
                                          "arm26_controls.xml");
+        cout << "Testing ControlLinear::Curve" << endl;
+        testControlLinearCurve();
+        cout << "Testing ControlSet from a table" << endl;
+        testControlSetFromTable("arm26_controls.xml");
+        cout << "Testing TaskSpaceController" << endl;
+        testTaskSpaceController();
+        cout << "Testing ReflexController" << endl;
+        testReflexController();
     }   
     catch (const Exception& e) {
         e.print(cerr);
@@ -418,3 +434,269 @@ void testPrescribedControllerFromFile(const std::string& modelFile,
      
     osimModel.disownAllComponents();
 }
+
+void testControlLinearCurve()
+{
+    // Nodes at irregular times, evaluated before, between, on and after the
+    // nodes, at increasing times, then decreasing ones, then jumping around.
+    double times[] = {0.0, 0.1, 0.15, 0.4, 0.41, 0.7, 1.0};
+    double values[] = {0.2, 0.5, -0.3, 0.8, 0.1, 0.1, 0.6};
+    std::vector<double> queries;
+    for (int i = 0; i <= 60; ++i) queries.push_back(-0.1 + 0.02*i);
+    for (int i = 0; i < 7; ++i) queries.push_back(times[i]);
+    for (int i = 60; i >= 0; --i) queries.push_back(-0.1 + 0.0201*i);
+    for (int i = 0; i <= 20; ++i) queries.push_back(fmod(0.37*i, 1.3) - 0.1);
+
+    for (bool useSteps : {false, true}) {
+        for (bool extrapolate : {false, true}) {
+            ControlLinear control;
+            control.setUseSteps(useSteps);
+            control.setExtrapolate(extrapolate);
+            for (int i = 0; i < 7; ++i)
+                control.setControlValue(times[i], values[i]);
+
+            const ControlLinear::Curve curve = control.getControlCurve();
+            ASSERT(curve.getNumNodes() == 7, __FILE__, __LINE__,
+                "ControlLinear::Curve has the wrong number of nodes.");
+            int cursor = 0;
+            for (double t : queries) {
+                ASSERT_EQUAL(control.getControlValue(t),
+                    curve.calcValue(t, cursor), 1e-15, __FILE__, __LINE__,
+                    "ControlLinear::Curve differs from the ControlLinear.");
+            }
+        }
+    }
+
+    // A curve without nodes, like a ControlLinear without nodes, is NaN.
+    int cursor = 0;
+    ASSERT(SimTK::isNaN(ControlLinear().getControlCurve().calcValue(
+        0.5, cursor)), __FILE__, __LINE__,
+        "ControlLinear::Curve without nodes should be NaN.");
+}
+
+void testControlSetFromTable(const std::string& controlsFile)
+{
+    ControlSet fromXML(controlsFile);
+    const TimeSeriesTable table = fromXML.exportToTable();
+    ASSERT(table.getNumColumns() == (size_t)fromXML.getSize(), __FILE__,
+        __LINE__, "Expected a column for each control.");
+
+    const std::string tableFile = "arm26_controls.otb";
+    BinaryFileAdapter::write(table, tableFile);
+    ControlSet fromTable(TimeSeriesTable{tableFile});
+    ASSERT(fromTable.getSize() == fromXML.getSize(), __FILE__, __LINE__,
+        "Expected a control for each column.");
+
+    for (int i = 0; i < fromXML.getSize(); ++i) {
+        ControlLinear& expected = dynamic_cast<ControlLinear&>(fromXML[i]);
+        ControlLinear& actual = dynamic_cast<ControlLinear&>(fromTable[i]);
+        ASSERT(actual.getName() == expected.getName(), __FILE__, __LINE__,
+            "Control names differ.");
+        const ArrayPtrs<ControlLinearNode>& x = expected.getControlValues();
+        const ArrayPtrs<ControlLinearNode>& y = actual.getControlValues();
+        ASSERT(x.getSize() == y.getSize(), __FILE__, __LINE__,
+            "Controls have different numbers of nodes.");
+        for (int k = 0; k < x.getSize(); ++k) {
+            ASSERT(x[k]->getTime() == y[k]->getTime(), __FILE__, __LINE__,
+                "Control node times differ.");
+            ASSERT(x[k]->getValue() == y[k]->getValue(), __FILE__, __LINE__,
+                "Control node values differ.");
+        }
+    }
+
+    // Nodes set out of order are sorted, as by setControlValue().
+    double times[] = {0.2, 0.0, 0.1};
+    double values[] = {2.0, 0.0, 1.0};
+    ControlLinear control;
+    control.setControlValues(3, times, values);
+    ASSERT(control.getControlValues().getSize() == 3, __FILE__, __LINE__);
+    ASSERT(control.getFirstTime() == 0.0 && control.getLastTime() == 0.2,
+        __FILE__, __LINE__, "Control nodes were not sorted.");
+
+    std::remove(tableFile.c_str());
+}
+
+void testTaskSpaceController()
+{
+    using namespace SimTK;
+
+    // A chain of two rods hanging from ground by ball joints (6 dofs).
+    Model model;
+    model.setName("chain");
+    OpenSim::Body* upper = new OpenSim::Body("upper", 2.0, Vec3(0, -0.25, 0),
+                                             Inertia(0.05, 0.01, 0.05));
+    OpenSim::Body* lower = new OpenSim::Body("lower", 1.0, Vec3(0, -0.25, 0),
+                                             Inertia(0.02, 0.005, 0.02));
+    model.addBody(upper);
+    model.addBody(lower);
+    model.addJoint(new BallJoint("shoulder", model.getGround(), Vec3(0),
+                                 Vec3(0), *upper, Vec3(0), Vec3(0)));
+    model.addJoint(new BallJoint("elbow", *upper, Vec3(0, -0.5, 0), Vec3(0),
+                                 *lower, Vec3(0), Vec3(0)));
+
+    TaskSpaceController* controller = new TaskSpaceController();
+    controller->setName("task_space");
+    const Vec3 hand(0, -0.5, 0);
+    int iHand = controller->addStationTask("lower", hand);
+    model.addForce(controller);
+
+    State& s = model.initSystem();
+    const CoordinateSet& coords = model.getCoordinateSet();
+    for (int i = 0; i < coords.getSize(); ++i) {
+        coords.get(i).setValue(s, 0.1*(i + 1), false);
+        coords.get(i).setSpeedValue(s, -0.2*(i + 1));
+    }
+
+    // With no gains, the hand has the target acceleration, even though the
+    // chain is redundant for a single station.
+    const Vec3 target(0.5, -1.0, 0.2);
+    controller->setTaskTarget(iHand, Vec3(0), Vec3(0), target);
+    model.realizeAcceleration(s);
+    ASSERT_EQUAL(target, lower->findStationAccelerationInGround(s, hand),
+                 1e-8);
+
+    // Two stations fix all 6 dofs; add position and velocity feedback.
+    const Vec3 elbow(0, -0.5, 0);
+    controller->addStationTask("upper", elbow);
+    controller->set_position_gain(100);
+    controller->set_velocity_gain(20);
+    State& s2 = model.initSystem();
+    s2.updQ() = s.getQ();
+    s2.updU() = s.getU();
+    const Vec3 handTarget(0.1, -0.9, 0.1), elbowTarget(0.05, -0.45, 0.1);
+    controller->setTaskTarget(0, handTarget);
+    controller->setTaskTarget(1, elbowTarget);
+    model.realizeAcceleration(s2);
+
+    const Vec3 expectedHand =
+        100*(handTarget - lower->findStationLocationInGround(s2, hand))
+        + 20*(-lower->findStationVelocityInGround(s2, hand));
+    const Vec3 expectedElbow =
+        100*(elbowTarget - upper->findStationLocationInGround(s2, elbow))
+        + 20*(-upper->findStationVelocityInGround(s2, elbow));
+    ASSERT_EQUAL(expectedHand,
+                 lower->findStationAccelerationInGround(s2, hand), 1e-8);
+    ASSERT_EQUAL(expectedElbow,
+                 upper->findStationAccelerationInGround(s2, elbow), 1e-8);
+
+    // Without tasks, the controller holds the chain against gravity.
+    Model empty(model);
+    auto& emptyController = dynamic_cast<TaskSpaceController&>(
+        empty.updForceSet().get("task_space"));
+    emptyController.updProperty_bodies().clear();
+    emptyController.updProperty_stations().clear();
+    State& s3 = empty.initSystem();
+    s3.updQ() = s.getQ();
+    empty.realizeAcceleration(s3);
+    ASSERT_EQUAL(0.0, s3.getUDot().normInf(), 1e-10);
+}
+
+void testReflexController()
+{
+    using namespace SimTK;
+
+    // A block on a slider, pulled by two muscles from either side.
+    Model model;
+    OpenSim::Body* block = new OpenSim::Body("block", 1.0, Vec3(0),
+                                             Inertia::brick(0.05, 0.05, 0.05));
+    model.addBody(block);
+    SliderJoint* slider = new SliderJoint("slider", model.getGround(), Vec3(0),
+                                          Vec3(0), *block, Vec3(0), Vec3(0));
+    model.addJoint(slider);
+    const Coordinate& coord = slider->getCoordinate();
+    Thelen2003Muscle* left = new Thelen2003Muscle("left", 200., 0.1, 0.2, 0.);
+    left->addNewPathPoint("origin", model.updGround(), Vec3(-0.3, 0, 0));
+    left->addNewPathPoint("insertion", *block, Vec3(0));
+    model.addForce(left);
+    Thelen2003Muscle* right = new Thelen2003Muscle("right", 100., 0.1, 0.2,
+                                                   0.);
+    right->addNewPathPoint("origin", model.updGround(), Vec3(0.3, 0, 0));
+    right->addNewPathPoint("insertion", *block, Vec3(0));
+    model.addForce(right);
+
+    ReflexController* reflexes = new ReflexController();
+    reflexes->setName("reflexes");
+    reflexes->addActuator(*left);
+    reflexes->addActuator(*right);
+    reflexes->append_length_gains(2.0);
+    reflexes->append_length_gains(3.0);
+    reflexes->set_length_threshold(0.5);
+    reflexes->append_velocity_gains(0.5);
+    model.addController(reflexes);
+
+    const Muscle* muscles[2] = {left, right};
+    const double lengthGains[2] = {2.0, 3.0};
+
+    // Without a delay, the signals of the state.
+    State& s = model.initSystem();
+    ASSERT(reflexes->getNumMuscles() == 2, __FILE__, __LINE__,
+           "Expected the controller to find its 2 muscles.");
+    coord.setValue(s, 0.05);
+    coord.setSpeedValue(s, 0.4);
+    model.realizeVelocity(s);
+    for (int i = 0; i < 2; ++i) {
+        const double expected =
+            lengthGains[i]*std::max(0.0,
+                muscles[i]->getNormalizedFiberLength(s) - 0.5) +
+            0.5*std::max(0.0, muscles[i]->getNormalizedFiberVelocity(s));
+        ASSERT_EQUAL(expected, muscles[i]->getControl(s), 1e-12, __FILE__,
+                     __LINE__, "Reflex control without a delay differs.");
+    }
+
+    // Tendon forces need a delay, and the actuators must be muscles.
+    reflexes->append_force_gains(1.5);
+    ASSERT_THROW(OpenSim::Exception, model.initSystem());
+    reflexes->set_delay(0.01);
+    reflexes->set_sample_interval(0.002);
+    State& s2 = model.initSystem();
+
+    // No sample yet, so no control.
+    model.realizeVelocity(s2);
+    ASSERT_EQUAL(0.0, left->getControl(s2), 0.0, __FILE__, __LINE__,
+                 "Expected no reflex control before the first sample.");
+
+    // Sample every 2 ms; the buffer holds ceil(0.01/0.002) + 2 = 7 samples.
+    const int numTimes = 10;
+    Matrix signals(6, numTimes);
+    for (int k = 0; k < numTimes; ++k) {
+        s2.setTime(0.002*k);
+        coord.setValue(s2, 0.01*std::sin(30.*k*0.002));
+        coord.setSpeedValue(s2, 0.3*std::cos(30.*k*0.002));
+        model.realizeAcceleration(s2);
+        for (int i = 0; i < 2; ++i) {
+            signals(i, k) = muscles[i]->getNormalizedFiberLength(s2);
+            signals(2 + i, k) = muscles[i]->getNormalizedFiberVelocity(s2);
+            signals(4 + i, k) = muscles[i]->getTendonForce(s2) /
+                                muscles[i]->getMaxIsometricForce();
+        }
+    }
+    ASSERT(reflexes->getNumSamples() == 7, __FILE__, __LINE__,
+           "Expected a full buffer of 7 samples.");
+
+    // The signals 10 ms earlier lie halfway between the samples at 12 and
+    // 14 ms.
+    s2.setTime(0.023);
+    coord.setValue(s2, 0.02);
+    model.realizeVelocity(s2);
+    for (int i = 0; i < 2; ++i) {
+        const double length = 0.5*(signals(i, 6) + signals(i, 7));
+        const double velocity = 0.5*(signals(2 + i, 6) + signals(2 + i, 7));
+        const double force = 0.5*(signals(4 + i, 6) + signals(4 + i, 7));
+        const double expected = lengthGains[i]*std::max(0.0, length - 0.5) +
+            0.5*std::max(0.0, velocity) + 1.5*force;
+        ASSERT_EQUAL(expected, muscles[i]->getControl(s2), 1e-10, __FILE__,
+                     __LINE__, "Delayed reflex control differs.");
+    }
+
+    // Going back in time discards the later samples.
+    s2.setTime(0.013);
+    model.realizeAcceleration(s2);
+    ASSERT(reflexes->getNumSamples() == 4, __FILE__, __LINE__,
+           "Expected the samples after 13 ms to be discarded.");
+
+    CoordinateActuator* motor = new CoordinateActuator(coord.getName());
+    motor->setName("motor");
+    model.addForce(motor);
+    reflexes->addActuator(*motor);
+    ASSERT_THROW(OpenSim::Exception, model.initSystem());
+}
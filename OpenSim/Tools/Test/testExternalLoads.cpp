@@ -29,11 +29,15 @@ using namespace OpenSim;
 using namespace std;
 
 void testExternalLoad();
+void testExternalForceData();
+void testExternalLoadsDataSource();
 
 int main()
 {
     try {
         testExternalLoad();
+        testExternalForceData();
+        testExternalLoadsDataSource();
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -269,3 +273,105 @@ void testExternalLoad()
     // kinematics should match to within integ accuracy
     ASSERT_EQUAL(0.0, norm_err, integ_accuracy);
 }
+
+// The force, point and torque evaluated together must match the components
+// evaluated one at a time and the splines fit to each column of the data.
+void testExternalForceData()
+{
+    using namespace SimTK;
+
+    Model model("Pendulum.osim");
+    const string bodyName = model.getBodySet().get(0).getName();
+
+    const int nt = 21;
+    Storage dataStore;
+    Array<string> labels;
+    labels.append("time");
+    const string names[3] = {"force", "point", "torque"};
+    for (int k = 0; k < 3; ++k) {
+        labels.append(names[k] + ".x");
+        labels.append(names[k] + ".y");
+        labels.append(names[k] + ".z");
+    }
+    dataStore.setColumnLabels(labels);
+    for (int i = 0; i < nt; ++i) {
+        const double t = 0.05*i;
+        Vector row(9);
+        for (int j = 0; j < 9; ++j)
+            row[j] = (j + 1)*std::sin(3*t + 0.4*j) + 0.1*j;
+        dataStore.append(t, row);
+    }
+    dataStore.setName("test_external_force_data.sto");
+
+    ExternalForce* xf = new ExternalForce(dataStore, "force", "point",
+        "torque", bodyName, "ground", "ground");
+    xf->setName("data");
+    model.addForce(xf);
+    model.initSystem();
+
+    Array<double> time;
+    dataStore.getTimeColumn(time);
+    for (int j = 0; j < 9; ++j) {
+        Array<double> column;
+        dataStore.getDataColumn(labels[j+1], column);
+        GCVSpline spline(3, nt, &time[0], &column[0]);
+        for (double t = -0.02; t < 1.05; t += 0.0137) {
+            Vec3 force, point, torque;
+            xf->getDataAtTime(t, force, point, torque);
+            const Vec3 separate = j < 3 ? xf->getForceAtTime(t)
+                : (j < 6 ? xf->getPointAtTime(t) : xf->getTorqueAtTime(t));
+            const double together = j < 3 ? force[j]
+                : (j < 6 ? point[j-3] : torque[j-6]);
+            ASSERT_EQUAL(spline.calcValue(t), separate[j%3], 1e-12);
+            ASSERT_EQUAL(separate[j%3], together, 1e-12);
+        }
+    }
+}
+
+// Force plate data, laid out as read from a C3D file, applied through
+// ExternalLoads from memory without being written to a data file.
+void testExternalLoadsDataSource()
+{
+    using namespace SimTK;
+
+    Model model("Pendulum.osim");
+    const string bodyName = model.getBodySet().get(0).getName();
+
+    TimeSeriesTableVec3 forcePlates;
+    forcePlates.setColumnLabels({"f1", "m1", "p1"});
+    for (int i = 0; i < 11; ++i) {
+        const double t = 0.1*i;
+        RowVector_<Vec3> row(3);
+        row[0] = Vec3(1 + t, 10*t, -2);
+        row[1] = Vec3(0.5*t, 0, 0.25);
+        row[2] = Vec3(0.1, 0.2*t, 0.3);
+        forcePlates.appendRow(t, row);
+    }
+    const Storage forceData(
+        TimeSeriesTable(forcePlates.flatten({"_x", "_y", "_z"})));
+
+    ExternalForce* xf = new ExternalForce(forceData, "f1_", "p1_", "m1_",
+        bodyName, "ground", "ground");
+    xf->setName("plate1");
+
+    ExternalLoads extLoads(model);
+    extLoads.setDataFileName("no_such_external_loads_data.sto");
+    extLoads.setDataSource(forceData);
+    ASSERT(extLoads.hasDataSource());
+    extLoads.adoptAndAppend(xf);
+    model.finalizeFromProperties();
+    extLoads.invokeConnectToModel(model);
+
+    for (int i = 0; i < 11; ++i) {
+        const double t = 0.1*i;
+        const RowVector_<Vec3>& row = forcePlates.getRowAtIndex(i);
+        const Vec3 force = xf->getForceAtTime(t);
+        const Vec3 point = xf->getPointAtTime(t);
+        const Vec3 torque = xf->getTorqueAtTime(t);
+        for (int k = 0; k < 3; ++k) {
+            ASSERT_EQUAL(row[0][k], force[k], 1e-10);
+            ASSERT_EQUAL(row[1][k], torque[k], 1e-10);
+            ASSERT_EQUAL(row[2][k], point[k], 1e-10);
+        }
+    }
+}
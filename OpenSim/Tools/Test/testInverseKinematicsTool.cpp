@@ -0,0 +1,216 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  testInverseKinematicsTool.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// testInverseKinematicsTool verifies that solving the frames of the time range
+// on multiple threads gives the same solution as the serial tool.
+//=============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Common/TRCFileAdapter.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+// Utility function to build a simple pendulum with markers attached
+Model* constructPendulumWithMarkers();
+// Write a marker file of the pendulum swinging through a known trajectory.
+void writeMarkerFile(const string& fileName);
+// Verify that the parallel tool matches the serial tool frame by frame.
+void testParallelMatchesSerial();
+// Verify that the tool keeps its results while its inputs are unchanged.
+void testCachedResults();
+
+int main()
+{
+    try {
+        testParallelMatchesSerial();
+        testCachedResults();
+    }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+void testParallelMatchesSerial()
+{
+    const string markerFile = "testInverseKinematicsTool_pendulum.trc";
+    writeMarkerFile(markerFile);
+
+    auto runIK = [&markerFile](int numThreads, const string& outputFile) {
+        unique_ptr<Model> model{ constructPendulumWithMarkers() };
+        InverseKinematicsTool ik;
+        ik.setName("pendulum_" + to_string(numThreads));
+        ik.setModel(*model);
+        ik.setMarkerDataFileName(markerFile);
+        ik.setOutputMotionFileName(outputFile);
+        ik.setNumThreads(numThreads);
+        ik.run();
+        return Storage(outputFile);
+    };
+
+    Storage serial = runIK(1, "testInverseKinematicsTool_serial.mot");
+    Storage parallel = runIK(4, "testInverseKinematicsTool_parallel.mot");
+
+    ASSERT(serial.getSize() == parallel.getSize(), __FILE__, __LINE__,
+        "Parallel IK produced a different number of frames than serial IK.");
+
+    Array<double> serialTheta, parallelTheta, serialTime, parallelTime;
+    serial.getDataColumn("theta", serialTheta);
+    parallel.getDataColumn("theta", parallelTheta);
+    serial.getTimeColumn(serialTime);
+    parallel.getTimeColumn(parallelTime);
+    for (int i = 0; i < serial.getSize(); ++i) {
+        ASSERT_EQUAL(serialTime[i], parallelTime[i], SimTK::Eps,
+            __FILE__, __LINE__, "Parallel IK frames are out of order.");
+        ASSERT_EQUAL(serialTheta[i], parallelTheta[i], 1e-3,
+            __FILE__, __LINE__,
+            "Parallel IK solution differs from serial IK solution.");
+    }
+}
+
+void testCachedResults()
+{
+    const string markerFile = "testInverseKinematicsTool_cached.trc";
+    const string outputFile = "testInverseKinematicsTool_cached.mot";
+    writeMarkerFile(markerFile);
+
+    unique_ptr<Model> model{ constructPendulumWithMarkers() };
+    InverseKinematicsTool ik;
+    ik.setName("pendulum_cached");
+    ik.setModel(*model);
+    ik.setMarkerDataFileName(markerFile);
+    ik.setOutputMotionFileName(outputFile);
+    ik.setUseCachedResults(true);
+
+    const string hash = ik.computeInputHash();
+    ASSERT(hash.size() == 16);
+    ik.run();
+    const int numFrames = ik.getOutputStorage().getSize();
+    ASSERT(numFrames == 101);
+    ASSERT(ifstream(ik.getCachedResultsRecordFileName()).good());
+
+    // Whether use_cached_results is set does not change the hash.
+    ik.setUseCachedResults(false);
+    ASSERT(ik.computeInputHash() == hash);
+    ik.setUseCachedResults(true);
+
+    // Replace the output with a single frame. A run with the same inputs
+    // keeps it, which shows that nothing was computed.
+    Storage single(ik.getOutputStorage());
+    single.crop(0.0, 0.0);
+    single.print(outputFile);
+    ik.run();
+    ASSERT(ik.getOutputStorage().getSize() == 1);
+
+    // Different settings are computed again.
+    const double endTime = ik.getEndTime();
+    ik.setEndTime(0.5);
+    ASSERT(ik.computeInputHash() != hash);
+    ik.run();
+    ASSERT(ik.getOutputStorage().getSize() > 1);
+    ASSERT(ik.getOutputStorage().getSize() < numFrames);
+
+    // So are different data.
+    ik.setEndTime(endTime);
+    ik.run();
+    ASSERT(ik.getOutputStorage().getSize() == numFrames);
+    {
+        ofstream data(markerFile, ios::app);
+        data << endl;
+    }
+    ASSERT(ik.computeInputHash() != hash);
+
+    // And a missing output.
+    writeMarkerFile(markerFile);
+    std::remove(outputFile.c_str());
+    ASSERT(ik.computeInputHash() == hash);
+    ik.run();
+    ASSERT(ik.getOutputStorage().getSize() == numFrames);
+}
+
+void writeMarkerFile(const string& fileName)
+{
+    unique_ptr<Model> model{ constructPendulumWithMarkers() };
+    SimTK::State s = model->initSystem();
+    const auto& coord = model->getCoordinateSet()[0];
+    const auto& markers = model->getMarkerSet();
+
+    vector<string> labels;
+    for (int j = 0; j < markers.getSize(); ++j)
+        labels.push_back(markers[j].getName());
+
+    TimeSeriesTable_<SimTK::Vec3> table;
+    table.setColumnLabels(labels);
+
+    const int nFrames = 101;
+    const double dt = 0.01;
+    for (int i = 0; i < nFrames; ++i) {
+        s.updTime() = i*dt;
+        coord.setValue(s, 0.5*sin(SimTK::Pi*s.getTime()));
+        SimTK::RowVector_<SimTK::Vec3> row(markers.getSize());
+        for (int j = 0; j < markers.getSize(); ++j)
+            row[j] = markers[j].getLocationInGround(s);
+        table.appendRow(s.getTime(), row);
+    }
+    table.updTableMetaData().setValueForKey("DataRate",
+        to_string(1.0/dt));
+    table.updTableMetaData().setValueForKey("Units", string("m"));
+
+    TRCFileAdapter::write(table, fileName);
+}
+
+Model* constructPendulumWithMarkers()
+{
+    Model* pendulum = new Model();
+    pendulum->setName("pendulum");
+    Body* ball =
+        new Body("ball", 1.0, SimTK::Vec3(0), SimTK::Inertia::sphere(0.05));
+    pendulum->addBody(ball);
+
+    PinJoint* hinge = new PinJoint("hinge", pendulum->getGround(),
+        SimTK::Vec3(0, 1.0, 0), SimTK::Vec3(0),
+        *ball, SimTK::Vec3(0, 1.0, 0), SimTK::Vec3(0));
+    hinge->updCoordinate().setName("theta");
+    pendulum->addJoint(hinge);
+
+    Marker* m0 = new Marker();
+    m0->setName("m0");
+    m0->setParentFrame(*ball);
+    m0->set_location(SimTK::Vec3(0));
+    pendulum->addMarker(m0);
+
+    Marker* mR = new Marker();
+    mR->setName("mR");
+    mR->setParentFrame(*ball);
+    mR->set_location(SimTK::Vec3(0.01, 0, 0));
+    pendulum->addMarker(mR);
+
+    return pendulum;
+}
@@ -0,0 +1,172 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testMuscleAtlasTool.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <algorithm>
+
+using namespace OpenSim;
+using namespace std;
+
+// Compare the atlas of the arm26 model to lengths and moment arms computed
+// point by point, on one thread and on several.
+void testAtlasOfArm26();
+// Fit a length surrogate to the atlas and give it to the path.
+void testLengthSurrogateFromAtlas();
+
+int main()
+{
+    LoadOpenSimLibrary("osimActuators");
+
+    SimTK::Array_<std::string> failures;
+
+    try { testAtlasOfArm26(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl; failures.push_back("testAtlasOfArm26");
+    }
+    try { testLengthSurrogateFromAtlas(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testLengthSurrogateFromAtlas");
+    }
+
+    if (!failures.empty()) {
+        cout << "Done, with failure(s): " << failures << endl;
+        return 1;
+    }
+
+    cout << "Done. All cases passed." << endl;
+    return 0;
+}
+
+void testAtlasOfArm26()
+{
+    Model model("arm26.osim");
+
+    MuscleAtlasTool atlas;
+    atlas.setName("arm26Atlas");
+    atlas.setModel(model);
+    atlas.append_coordinates("r_shoulder_elev");
+    atlas.append_coordinates("r_elbow_flex");
+    atlas.set_num_points(5);
+    atlas.run();
+
+    const int np = 25;
+    const int nm = model.getMuscles().getSize();
+    ASSERT(atlas.getGridPoints().nrow() == np);
+    ASSERT(atlas.getLengths().nrow() == np);
+    ASSERT(atlas.getLengths().ncol() == nm);
+    ASSERT((int)atlas.getMuscleNames().size() == nm);
+
+    // The first coordinate varies fastest, over the range of the coordinate.
+    const Coordinate& shoulder =
+        model.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    ASSERT_EQUAL(shoulder.getRangeMin(), atlas.getGridPoints()(0, 0), 1e-12);
+    ASSERT_EQUAL(shoulder.getRangeMax(), atlas.getGridPoints()(4, 0), 1e-12);
+    ASSERT_EQUAL(elbow.getRangeMin(), atlas.getGridPoints()(4, 1), 1e-12);
+    ASSERT_EQUAL(elbow.getRangeMax(), atlas.getGridPoints()(24, 1), 1e-12);
+
+    // Each point by itself.
+    SimTK::State& s = model.initSystem();
+    for (int p = 0; p < np; p += 7) {
+        shoulder.setValue(s, atlas.getGridPoints()(p, 0), false);
+        elbow.setValue(s, atlas.getGridPoints()(p, 1), false);
+        model.realizePosition(s);
+        for (int m = 0; m < nm; ++m) {
+            const Muscle& muscle =
+                model.getMuscles().get(atlas.getMuscleNames()[m]);
+            ASSERT_EQUAL(muscle.getLength(s), atlas.getLengths()(p, m),
+                         1e-10);
+            ASSERT_EQUAL(muscle.getGeometryPath().computeMomentArm(s, elbow),
+                         atlas.getMomentArms(1)(p, m), 1e-8);
+            ASSERT_EQUAL(
+                muscle.getGeometryPath().computeMomentArm(s, shoulder),
+                atlas.getMomentArms(0)(p, m), 1e-8);
+        }
+    }
+
+    // The same atlas on several threads.
+    MuscleAtlasTool parallel(atlas);
+    parallel.setModel(model);
+    parallel.set_num_threads(4);
+    parallel.set_results_directory("");
+    parallel.run();
+    ASSERT_EQUAL(0.0,
+        (parallel.getLengths() - atlas.getLengths()).normRMS(), 1e-14);
+    ASSERT_EQUAL(0.0,
+        (parallel.getMomentArms(1) - atlas.getMomentArms(1)).normRMS(),
+        1e-14);
+
+    // The tables written by the first run.
+    Storage lengths("arm26Atlas_lengths.sto");
+    ASSERT(lengths.getSize() == np);
+    ASSERT(lengths.getColumnLabels().getSize() == 1 + 2 + nm);
+    Storage momentArms("arm26Atlas_moment_arms_r_elbow_flex.sto");
+    ASSERT(momentArms.getSize() == np);
+
+    // Only the listed muscles.
+    MuscleAtlasTool some(atlas);
+    some.setModel(model);
+    some.set_muscle_list(0, "BIClong");
+    some.append_muscle_list("TRIlong");
+    some.set_results_directory("");
+    some.run();
+    ASSERT(some.getLengths().ncol() == 2);
+
+    some.append_muscle_list("not_a_muscle");
+    ASSERT_THROW(OpenSim::Exception, some.run());
+}
+
+void testLengthSurrogateFromAtlas()
+{
+    Model model("arm26.osim");
+    MuscleAtlasTool atlas;
+    atlas.setModel(model);
+    atlas.append_coordinates("r_shoulder_elev");
+    atlas.append_coordinates("r_elbow_flex");
+    atlas.set_num_points(9);
+    atlas.set_num_threads(2);
+    atlas.set_results_directory("");
+    atlas.run();
+
+    const auto& names = atlas.getMuscleNames();
+    const int m = (int)(std::find(names.begin(), names.end(), "BIClong")
+                        - names.begin());
+    PathLengthSurrogate surrogate = atlas.fitLengthSurrogate(m, 5);
+    ASSERT(surrogate.getMaxError() < 1e-3);
+
+    // Given to the path, the surrogate stands in for the length.
+    SimTK::State& s = model.initSystem();
+    const GeometryPath& path =
+        model.getMuscles().get("BIClong").getGeometryPath();
+    model.getCoordinateSet().get("r_elbow_flex").setValue(s, 1.0, false);
+    model.realizePosition(s);
+    const double exact = path.getLength(s);
+    path.setLengthSurrogate(surrogate);
+    ASSERT(path.isLengthSurrogateInRange(s));
+    model.getCoordinateSet().get("r_elbow_flex").setValue(s, 1.0, false);
+    model.realizePosition(s);
+    ASSERT_EQUAL(exact, path.getLength(s), 1e-3);
+}
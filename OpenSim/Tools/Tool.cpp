@@ -0,0 +1,137 @@
+/* -------------------------------------------------------------------------- *
+ *                             OpenSim:  Tool.cpp                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "Tool.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/XMLDocument.h>
+#include <OpenSim/version.h>
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CACHED RESULTS
+//=============================================================================
+// 64-bit FNV-1a, as in ModelCache, which unlike std::hash gives the same
+// hashes in every process and on every platform.
+void Tool::hashBytes(const void* data, std::size_t size, std::uint64_t& hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+void Tool::hashString(const std::string& text, std::uint64_t& hash)
+{
+    // Include the length, so that consecutive strings cannot run together.
+    const std::uint64_t size = text.size();
+    hashBytes(&size, sizeof(size), hash);
+    hashBytes(text.data(), text.size(), hash);
+}
+
+void Tool::hashFile(const std::string& fileName, std::uint64_t& hash)
+{
+    ifstream file(fileName, ios::binary);
+    OPENSIM_THROW_IF(!file, Exception,
+        "Tool: could not open input file '" + fileName + "'.");
+    // Read the file in blocks; data files may be large.
+    char buffer[65536];
+    while (file) {
+        file.read(buffer, sizeof(buffer));
+        hashBytes(buffer, (std::size_t)file.gcount(), hash);
+    }
+}
+
+std::string Tool::computeInputHash() const
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    std::ostringstream version;
+    version << GetVersion() << ":" << XMLDocument::getLatestVersion();
+    hashString(version.str(), hash);
+
+    // The settings, without the one that only says whether to use the cache.
+    std::unique_ptr<Tool> settings(clone());
+    settings->setUseCachedResults(false);
+    hashString(settings->getConcreteClassName(), hash);
+    hashString(settings->dump(true), hash);
+
+    hashInputs(hash);
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+std::string Tool::getCachedResultsRecordFileName() const
+{
+    return getResultsFilePath(getName() + "_" + getConcreteClassName() +
+                              ".hash");
+}
+
+bool Tool::findCachedResults(const std::string& inputHash) const
+{
+    // The record and the outputs are relative to the setup file.
+    const string saveWorkingDirectory = IO::getCwd();
+    IO::chDir(IO::getParentDirectory(getDocumentFileName()));
+
+    string recordedHash;
+    ifstream record(getCachedResultsRecordFileName());
+    if (record) record >> recordedHash;
+    bool found = recordedHash == inputHash;
+
+    vector<string> outputFiles;
+    appendOutputFiles(outputFiles);
+    for (const auto& fileName : outputFiles)
+        if (found && !ifstream(fileName)) found = false;
+
+    IO::chDir(saveWorkingDirectory);
+    return found;
+}
+
+void Tool::recordCachedResults(const std::string& inputHash) const
+{
+    const string saveWorkingDirectory = IO::getCwd();
+    IO::chDir(IO::getParentDirectory(getDocumentFileName()));
+
+    IO::makeDir(getResultsDir());
+    ofstream record(getCachedResultsRecordFileName());
+    record << inputHash << endl;
+    const bool written = bool(record);
+
+    IO::chDir(saveWorkingDirectory);
+    if (!written) {
+        cout << "Tool " << getName() << ": could not write "
+             << getCachedResultsRecordFileName() << "." << endl;
+    }
+}
@@ -29,6 +29,9 @@
 #include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyObj.h>
 
+#include <cstdint>
+#include <vector>
+
 
 namespace OpenSim { 
 
@@ -40,6 +43,13 @@ namespace OpenSim {
  * modeling and analysis steps. Its primary duty is to provide an interface
  * for use by the GUI or as a standalone command line executable. It includes
  * common methods for invoking the tool and performing routine I/O.
+ *
+ * A Tool that supports it can skip its computation when its results are
+ * already up to date: if use_cached_results is true, run() first computes a
+ * hash of its inputs (see computeInputHash()) and, if the last successful
+ * run with the same hash left its output files in place, keeps them instead
+ * of computing them again. Rerunning a pipeline of tools then costs only the
+ * tools whose inputs changed.
  * 
  *
  * @author Ajay Seth
@@ -63,6 +73,10 @@ protected:
     /** Directory for writing results (new model, states, etc...) to. */
     PropertyStr _resultsDirProp;
     std::string &_resultsDir;
+
+    /** Whether to keep the results of a previous run with the same inputs. */
+    PropertyBool _useCachedResultsProp;
+    bool &_useCachedResults;
     
     /** How much details to put out while running. */
     VerboseLevel _verboseLevel;
@@ -84,7 +98,8 @@ public:
     * Default constructor.
     */
     Tool() : _inputsDir(_inputsDirProp.getValueStr()),
-        _resultsDir(_resultsDirProp.getValueStr())
+        _resultsDir(_resultsDirProp.getValueStr()),
+        _useCachedResults(_useCachedResultsProp.getValueBool())
         { setNull(); };
     
     /**
@@ -98,7 +113,8 @@ public:
     */
     Tool(const std::string &aFileName, bool aUpdateFromXMLNode = true):
         Object(aFileName, true), _inputsDir(_inputsDirProp.getValueStr()),
-        _resultsDir(_resultsDirProp.getValueStr()) {
+        _resultsDir(_resultsDirProp.getValueStr()),
+        _useCachedResults(_useCachedResultsProp.getValueBool()) {
             setNull();
             if(aUpdateFromXMLNode) updateFromXMLDocument();
         };
@@ -109,7 +125,8 @@ public:
     * @param aTool to be copied.
     */
     Tool(const Tool &aTool) : _inputsDir(_inputsDirProp.getValueStr()),
-        _resultsDir(_resultsDirProp.getValueStr())
+        _resultsDir(_resultsDirProp.getValueStr()),
+        _useCachedResults(_useCachedResultsProp.getValueBool())
         {setNull(); *this = aTool; };
 
 
@@ -121,6 +138,7 @@ private:
         setupProperties();
         _resultsDir = "./"; 
         _inputsDir = "";
+        _useCachedResults = false;
         _verboseLevel = Progress;
     };
     
@@ -139,6 +157,13 @@ private:
         _inputsDirProp.setComment(comment);
         _inputsDirProp.setName("input_directory");
         _propertySet.append( &_inputsDirProp );
+
+        comment = "Skip running the tool if a previous run with the same "
+            "inputs (settings, model and data files, and version of OpenSim) "
+            "left its results in the results directory. Default is false.";
+        _useCachedResultsProp.setComment(comment);
+        _useCachedResultsProp.setName("use_cached_results");
+        _propertySet.append( &_useCachedResultsProp );
     };
     
 
@@ -159,6 +184,7 @@ public:
             Super::operator=(source);   
             _resultsDir   = source._resultsDir; 
             _inputsDir    = source._inputsDir;
+            _useCachedResults = source._useCachedResults;
             _verboseLevel = source._verboseLevel;
         }
         return *this;
@@ -193,12 +219,62 @@ public:
     */
     const std::string& getResultsDir() const { return _resultsDir; }
     void setResultsDir(const std::string& aString) { _resultsDir = aString; }
+    /**
+    * Get/set whether run() keeps the results of a previous run with the same
+    * inputs instead of computing them again.
+    */
+    bool getUseCachedResults() const { return _useCachedResults; }
+    void setUseCachedResults(bool aTrueFalse)
+    {   _useCachedResults = aTrueFalse; }
 
     /**
      * Get/Set verbose level
      */
     const VerboseLevel getVerboseLevel() const { return _verboseLevel; };
     void setVerboseLevel(const VerboseLevel aVerboseLevel) { _verboseLevel = aVerboseLevel; };
+
+    //--------------------------------------------------------------------------
+    // CACHED RESULTS
+    //--------------------------------------------------------------------------
+    /** A hash of everything the results of run() depend on: the version of
+    OpenSim, the settings of the tool (except use_cached_results) and the
+    inputs added by hashInputs(), such as the contents of the model and data
+    files. Call it from the directory that run() is called from. It is a
+    hexadecimal string. */
+    std::string computeInputHash() const;
+
+    /** The file, relative to the directory of the setup file, in which run()
+    records the input hash of its last successful run. */
+    std::string getCachedResultsRecordFileName() const;
+
+protected:
+    /** Add the inputs of run() other than the settings of the tool (e.g., the
+    model and the data files it reads) to `hash`, using hashBytes(),
+    hashString() and hashFile(). It is called from the directory that run()
+    is called from. The default adds nothing. */
+    virtual void hashInputs(std::uint64_t& hash) const {}
+    /** Add the names of the files written by run(), relative to the
+    directory of the setup file, to `fileNames`. Cached results are used only
+    if they all exist. The default adds none. */
+    virtual void appendOutputFiles(std::vector<std::string>& fileNames) const
+    {}
+
+    static void hashBytes(const void* data, std::size_t size,
+                          std::uint64_t& hash);
+    static void hashString(const std::string& text, std::uint64_t& hash);
+    /** Add the contents of a file. Throws if it cannot be read. */
+    static void hashFile(const std::string& fileName, std::uint64_t& hash);
+
+    /** The path of a file with the given name in the results directory, as
+    Storage::printResult() forms it. */
+    std::string getResultsFilePath(const std::string& fileName) const
+    {   return (_resultsDir.empty() ? "." : _resultsDir) + "/" + fileName; }
+
+    /** Whether the last successful run recorded the given input hash and its
+    output files all exist. */
+    bool findCachedResults(const std::string& inputHash) const;
+    /** Record the input hash of a successful run. */
+    void recordCachedResults(const std::string& inputHash) const;
 //=============================================================================
 };  // END of class Tool
 
@@ -29,6 +29,8 @@
 #include "AnalyzeTool.h"
 
 #include "InverseKinematicsTool.h"
+#include "InverseAnalysisPipeline.h"
+#include "MuscleAtlasTool.h"
 #include "GenericModelMaker.h"
 #include "TrackingTask.h"
 #include "MuscleStateTrackingTask.h"